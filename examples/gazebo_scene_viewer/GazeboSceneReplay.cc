@@ -0,0 +1,454 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Records the scene and pose messages of a running gazebo server to a log
+// file, and replays such logs headless against a render engine as fast as
+// possible, reporting frame time percentiles.
+//
+// Usage:
+//   gazebo_scene_replay record <log> [seconds]
+//   gazebo_scene_replay replay <log> [engine] [options]
+//
+// Replay options:
+//   --width <px>      camera image width, default 1280
+//   --height <px>     camera image height, default 720
+//   --warmup <n>      frames rendered before measuring, default 10
+//   --loops <n>       number of times the log is replayed, default 1
+//   --capture         also read back every frame into an image
+//   --json <file>     append the results as one line of json to a file
+
+#include <gazebo/msgs/msgs.hh>
+#include <gazebo/transport/TransportIface.hh>
+#include <gazebo/transport/Node.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ignition/math/Helpers.hh>
+
+#include <ignition/rendering/Camera.hh>
+#include <ignition/rendering/Image.hh>
+#include <ignition/rendering/RenderEngine.hh>
+#include <ignition/rendering/RenderingIface.hh>
+#include <ignition/rendering/Scene.hh>
+#include <ignition/rendering/Visual.hh>
+
+#include "SceneManager.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Magic bytes at the start of a log file, the last one is the
+/// format version
+static const char kLogMagic[8] = {'I', 'G', 'N', 'R', 'L', 'O', 'G', '1'};
+
+/// \brief Kinds of records in a log file
+enum RecordType : uint8_t
+{
+  /// \brief Serialized gazebo::msgs::Scene
+  RECORD_SCENE = 0,
+
+  /// \brief Serialized gazebo::msgs::PosesStamped
+  RECORD_POSES = 1
+};
+
+/// \brief A message read from or written to a log file
+struct Record
+{
+  /// \brief Kind of message
+  RecordType type = RECORD_SCENE;
+
+  /// \brief Serialized message
+  std::string data;
+};
+
+/// \brief Set when recording should stop
+static std::atomic<bool> g_stop(false);
+
+//////////////////////////////////////////////////
+static void OnSignal(int)
+{
+  g_stop = true;
+}
+
+//////////////////////////////////////////////////
+static void WriteRecord(std::ofstream &_out, RecordType _type,
+    const std::string &_data)
+{
+  uint8_t type = _type;
+  uint32_t size = static_cast<uint32_t>(_data.size());
+  _out.write(reinterpret_cast<const char *>(&type), sizeof(type));
+  _out.write(reinterpret_cast<const char *>(&size), sizeof(size));
+  _out.write(_data.data(), size);
+}
+
+//////////////////////////////////////////////////
+static bool ReadLog(const std::string &_filename,
+    std::vector<Record> &_records)
+{
+  std::ifstream in(_filename, std::ios::binary);
+  char magic[sizeof(kLogMagic)];
+  if (!in.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, kLogMagic, sizeof(magic)) != 0)
+  {
+    std::cerr << "[" << _filename << "] is not a scene log" << std::endl;
+    return false;
+  }
+
+  while (true)
+  {
+    uint8_t type = 0u;
+    uint32_t size = 0u;
+    if (!in.read(reinterpret_cast<char *>(&type), sizeof(type)))
+      break;
+    if (!in.read(reinterpret_cast<char *>(&size), sizeof(size)))
+    {
+      std::cerr << "Truncated log" << std::endl;
+      return false;
+    }
+
+    Record record;
+    record.type = static_cast<RecordType>(type);
+    record.data.resize(size);
+    if (!in.read(&record.data[0], size))
+    {
+      std::cerr << "Truncated log" << std::endl;
+      return false;
+    }
+    _records.push_back(std::move(record));
+  }
+
+  if (_records.empty() || _records.front().type != RECORD_SCENE)
+  {
+    std::cerr << "Log does not start with a scene" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+static int RecordLog(const std::string &_filename, double _seconds)
+{
+  std::ofstream out(_filename, std::ios::binary);
+  if (!out)
+  {
+    std::cerr << "Unable to open [" << _filename << "]" << std::endl;
+    return 1;
+  }
+  out.write(kLogMagic, sizeof(kLogMagic));
+
+  gazebo::transport::init();
+  gazebo::transport::run();
+  gazebo::transport::NodePtr node(new gazebo::transport::Node());
+  node->Init();
+
+  std::mutex mutex;
+  std::condition_variable sceneCondition;
+  bool sceneReceived = false;
+  unsigned int poseCount = 0u;
+
+  gazebo::msgs::Request *request = gazebo::msgs::CreateRequest("scene_info");
+  int requestId = request->id();
+
+  // the scene goes first, poses received before it are dropped
+  auto onResponse = [&](ConstResponsePtr &_msg)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (_msg->id() != requestId || sceneReceived)
+      return;
+    WriteRecord(out, RECORD_SCENE, _msg->serialized_data());
+    sceneReceived = true;
+    sceneCondition.notify_all();
+  };
+
+  auto onPoses = [&](ConstPosesStampedPtr &_msg)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!sceneReceived)
+      return;
+    WriteRecord(out, RECORD_POSES, _msg->SerializeAsString());
+    ++poseCount;
+  };
+
+  gazebo::transport::SubscriberPtr responseSub =
+      node->Subscribe<gazebo::msgs::Response>("~/response", onResponse);
+  gazebo::transport::SubscriberPtr poseSub =
+      node->Subscribe<gazebo::msgs::PosesStamped>("~/pose/local/info",
+      onPoses);
+  gazebo::transport::PublisherPtr requestPub =
+      node->Advertise<gazebo::msgs::Request>("~/request");
+  requestPub->WaitForConnection();
+  requestPub->Publish(*request);
+  delete request;
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!sceneCondition.wait_for(lock, std::chrono::seconds(10),
+        [&]() {return sceneReceived;}))
+    {
+      std::cerr << "No scene received from gazebo" << std::endl;
+      gazebo::transport::fini();
+      return 1;
+    }
+  }
+  std::cout << "Recording to [" << _filename << "], press Ctrl-C to stop"
+            << std::endl;
+
+  std::signal(SIGINT, OnSignal);
+  auto start = std::chrono::steady_clock::now();
+  while (!g_stop && (_seconds <= 0.0 ||
+      std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count() < _seconds))
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  poseSub.reset();
+  responseSub.reset();
+  node->Fini();
+  gazebo::transport::fini();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  std::cout << "Recorded " << poseCount << " pose messages" << std::endl;
+  return 0;
+}
+
+//////////////////////////////////////////////////
+static double Percentile(const std::vector<double> &_sorted, double _p)
+{
+  if (_sorted.empty())
+    return 0.0;
+  size_t idx = static_cast<size_t>(_p * (_sorted.size() - 1u) + 0.5);
+  return _sorted[std::min(idx, _sorted.size() - 1u)];
+}
+
+//////////////////////////////////////////////////
+static int ReplayLog(const std::string &_filename,
+    const std::string &_engine, unsigned int _width, unsigned int _height,
+    unsigned int _warmup, unsigned int _loops, bool _capture,
+    const std::string &_json)
+{
+  std::vector<Record> records;
+  if (!ReadLog(_filename, records))
+    return 1;
+
+  RenderEngine *engine = rendering::engine(_engine);
+  if (!engine)
+  {
+    std::cerr << "Engine '" << _engine << "' is not supported" << std::endl;
+    return 1;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  SceneManager *manager = SceneManager::Instance();
+  manager->AddScene(scene);
+
+  CameraPtr camera = scene->CreateCamera("camera");
+  camera->SetLocalPosition(5.0, -5.0, 2.0);
+  camera->SetLocalRotation(0.0, 0.27, 2.36);
+  camera->SetImageWidth(_width);
+  camera->SetImageHeight(_height);
+  camera->SetAspectRatio(static_cast<double>(_width) / _height);
+  camera->SetHFOV(IGN_PI / 2);
+  scene->RootVisual()->AddChild(camera);
+  Image image = camera->CreateImage();
+
+  // build the scene once, looping only replays the poses
+  manager->SetSceneData(records.front().data);
+  manager->UpdateScenes();
+
+  std::vector<double> updateTimes;
+  std::vector<double> renderTimes;
+  std::vector<double> frameTimes;
+  unsigned int frame = 0u;
+  auto replayStart = std::chrono::steady_clock::now();
+  for (unsigned int loop = 0u; loop < _loops; ++loop)
+  {
+    for (const auto &record : records)
+    {
+      if (record.type != RECORD_POSES)
+        continue;
+
+      auto start = std::chrono::steady_clock::now();
+      manager->SetPoseData(record.data);
+      manager->UpdateScenes();
+      auto updated = std::chrono::steady_clock::now();
+
+      if (_capture)
+        camera->Capture(image);
+      else
+        camera->Update();
+      auto rendered = std::chrono::steady_clock::now();
+
+      if (frame++ < _warmup)
+        continue;
+
+      updateTimes.push_back(std::chrono::duration<double, std::milli>(
+          updated - start).count());
+      renderTimes.push_back(std::chrono::duration<double, std::milli>(
+          rendered - updated).count());
+      frameTimes.push_back(std::chrono::duration<double, std::milli>(
+          rendered - start).count());
+    }
+  }
+  double wallSeconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - replayStart).count();
+
+  if (frameTimes.empty())
+  {
+    std::cerr << "No frames measured, the log has " << frame
+              << " pose messages" << std::endl;
+    return 1;
+  }
+
+  struct Summary
+  {
+    const char *name;
+    std::vector<double> times;
+  };
+  std::vector<Summary> summaries = {
+      {"update", updateTimes}, {"render", renderTimes}, {"frame", frameTimes}};
+
+  std::cout << "engine: " << engine->Name() << ", frames: "
+            << frameTimes.size() << ", " << _width << "x" << _height
+            << (_capture ? ", with readback" : "") << std::endl;
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << std::setw(8) << "ms" << std::setw(10) << "mean"
+            << std::setw(10) << "p50" << std::setw(10) << "p90"
+            << std::setw(10) << "p99" << std::setw(10) << "max" << std::endl;
+
+  std::ofstream json;
+  if (!_json.empty())
+  {
+    json.open(_json, std::ios::app);
+    json << "{\"log\": \"" << _filename << "\", \"engine\": \""
+         << engine->Name() << "\", \"width\": " << _width
+         << ", \"height\": " << _height << ", \"capture\": "
+         << (_capture ? "true" : "false") << ", \"frames\": "
+         << frameTimes.size() << ", \"fps\": "
+         << frameTimes.size() / wallSeconds;
+  }
+
+  for (auto &summary : summaries)
+  {
+    std::vector<double> &times = summary.times;
+    std::sort(times.begin(), times.end());
+    double mean = std::accumulate(times.begin(), times.end(), 0.0) /
+        times.size();
+    std::cout << std::setw(8) << summary.name << std::setw(10) << mean
+              << std::setw(10) << Percentile(times, 0.5)
+              << std::setw(10) << Percentile(times, 0.9)
+              << std::setw(10) << Percentile(times, 0.99)
+              << std::setw(10) << times.back() << std::endl;
+    if (json.is_open())
+    {
+      json << ", \"" << summary.name << "\": {\"mean\": " << mean
+           << ", \"p50\": " << Percentile(times, 0.5)
+           << ", \"p90\": " << Percentile(times, 0.9)
+           << ", \"p99\": " << Percentile(times, 0.99)
+           << ", \"max\": " << times.back() << "}";
+    }
+  }
+  if (json.is_open())
+    json << "}" << std::endl;
+
+  manager->RemoveScenes();
+  engine->DestroyScene(scene);
+  return 0;
+}
+
+//////////////////////////////////////////////////
+static void PrintUsage(const char *_name)
+{
+  std::cerr << "Usage:" << std::endl
+            << "  " << _name << " record <log> [seconds]" << std::endl
+            << "  " << _name << " replay <log> [engine] [--width <px>]"
+            << " [--height <px>] [--warmup <n>] [--loops <n>]"
+            << " [--capture] [--json <file>]" << std::endl;
+}
+
+//////////////////////////////////////////////////
+int main(int _argc, char** _argv)
+{
+  if (_argc < 3)
+  {
+    PrintUsage(_argv[0]);
+    return 1;
+  }
+
+  std::string mode = _argv[1];
+  std::string filename = _argv[2];
+  if (mode == "record")
+  {
+    double seconds = _argc > 3 ? std::stod(_argv[3]) : 0.0;
+    return RecordLog(filename, seconds);
+  }
+
+  if (mode != "replay")
+  {
+    PrintUsage(_argv[0]);
+    return 1;
+  }
+
+  std::string engineName = "ogre2";
+  unsigned int width = 1280u;
+  unsigned int height = 720u;
+  unsigned int warmup = 10u;
+  unsigned int loops = 1u;
+  bool capture = false;
+  std::string json;
+  for (int i = 3; i < _argc; ++i)
+  {
+    std::string arg = _argv[i];
+    bool hasValue = i + 1 < _argc;
+    if (arg == "--width" && hasValue)
+      width = std::stoul(_argv[++i]);
+    else if (arg == "--height" && hasValue)
+      height = std::stoul(_argv[++i]);
+    else if (arg == "--warmup" && hasValue)
+      warmup = std::stoul(_argv[++i]);
+    else if (arg == "--loops" && hasValue)
+      loops = std::max(1ul, std::stoul(_argv[++i]));
+    else if (arg == "--json" && hasValue)
+      json = _argv[++i];
+    else if (arg == "--capture")
+      capture = true;
+    else if (arg.compare(0, 2, "--") != 0)
+      engineName = arg;
+    else
+    {
+      PrintUsage(_argv[0]);
+      return 1;
+    }
+  }
+
+  return ReplayLog(filename, engineName, width, height, warmup, loops,
+      capture, json);
+}
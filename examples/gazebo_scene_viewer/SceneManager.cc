@@ -147,6 +147,18 @@ void SceneManager::UpdateScenes()
   this->pimpl->UpdateScenes();
 }
 
+//////////////////////////////////////////////////
+void SceneManager::SetSceneData(const std::string &_data)
+{
+  this->pimpl->SetSceneData(_data);
+}
+
+//////////////////////////////////////////////////
+void SceneManager::SetPoseData(const std::string &_data)
+{
+  this->pimpl->SetPoseData(_data);
+}
+
 //////////////////////////////////////////////////
 SceneManagerPrivate::SceneManagerPrivate() :
   currentSceneManager(new CurrentSceneManager),
@@ -230,7 +242,9 @@ void SceneManagerPrivate::Fini()
   std::lock_guard<std::mutex> generalLock(this->generalMutex);
   std::lock_guard<std::mutex> poseLock(this->poseMutex);
 
-  this->transportNode->Fini();
+  // not initialized when replaying logs
+  if (this->transportNode)
+    this->transportNode->Fini();
 }
 
 //////////////////////////////////////////////////
@@ -376,6 +390,10 @@ void SceneManagerPrivate::UpdateScenes()
 //////////////////////////////////////////////////
 void SceneManagerPrivate::SendSceneRequest()
 {
+  // no server to ask when replaying logs
+  if (!this->requestPub)
+    return;
+
   gazebo::msgs::Request *request = gazebo::msgs::CreateRequest("scene_info");
   this->sceneRequestId = request->id();
   this->requestPub->Publish(*request);
@@ -546,6 +564,33 @@ void SceneManagerPrivate::OnPoseUpdate(::ConstPosesStampedPtr &_posesMsg)
   this->newSceneManager->OnPoseUpdate(_posesMsg);
 }
 
+//////////////////////////////////////////////////
+void SceneManagerPrivate::SetSceneData(const std::string &_data)
+{
+  // block all message receival during update
+  std::lock_guard<std::mutex> generalLock(this->generalMutex);
+  std::lock_guard<std::mutex> poseLock(this->poseMutex);
+
+  this->newSceneManager->SetSceneData(_data);
+  this->promotionNeeded = true;
+  this->sceneRequestId = -1;
+}
+
+//////////////////////////////////////////////////
+void SceneManagerPrivate::SetPoseData(const std::string &_data)
+{
+  boost::shared_ptr<gazebo::msgs::PosesStamped> posesMsg(
+      new gazebo::msgs::PosesStamped);
+  if (!posesMsg->ParseFromString(_data))
+  {
+    ignerr << "Failed to parse poses message" << std::endl;
+    return;
+  }
+
+  ::ConstPosesStampedPtr constPosesMsg = posesMsg;
+  this->OnPoseUpdate(constPosesMsg);
+}
+
 //////////////////////////////////////////////////
 void SceneManagerPrivate::OnRemovalUpdate(const std::string &_name)
 {
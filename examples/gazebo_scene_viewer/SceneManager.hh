@@ -129,6 +129,20 @@ namespace ignition
       /// \brief Update all scenes
       public: void UpdateScenes();
 
+      /// \brief Build the scenes added since the last scene message from a
+      /// serialized gazebo::msgs::Scene, as if it was the response to a
+      /// scene request. This allows scenes to be replayed from a log without
+      /// a running gazebo server, in which case Init does not need to be
+      /// called.
+      /// \param[in] _data Serialized scene message
+      public: void SetSceneData(const std::string &_data);
+
+      /// \brief Queue a serialized gazebo::msgs::PosesStamped, as if it was
+      /// received from a gazebo server. The poses are applied on the next
+      /// call to UpdateScenes.
+      /// \param[in] _data Serialized poses message
+      public: void SetPoseData(const std::string &_data);
+
       /// \brief Private implementation pointer
       private: class SceneManagerPrivate *pimpl;
 
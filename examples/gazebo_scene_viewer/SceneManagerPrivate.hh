@@ -103,6 +103,10 @@ namespace ignition
 
       public: void OnPoseUpdate(::ConstPosesStampedPtr &_posesMsg);
 
+      public: void SetSceneData(const std::string &_data);
+
+      public: void SetPoseData(const std::string &_data);
+
       private: void OnRemovalUpdate(const std::string &_name);
 
       private: void SendSceneRequest();
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_ANTIALIASINGPASS_HH_
+#define IGNITION_RENDERING_ANTIALIASINGPASS_HH_
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/RenderPass.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /* \class AntiAliasingPass AntiAliasingPass.hh \
+     * ignition/rendering/AntiAliasingPass.hh
+     */
+    /// \brief A render pass that smooths the edges in the render target with
+    /// fast approximate anti-aliasing (FXAA). It is a single full screen pass
+    /// over the resolved image, so it costs a small fraction of the memory
+    /// and bandwidth of multisampling, see Camera::SetAntiAliasing, at the
+    /// price of slightly blurrier textures and no subpixel geometry.
+    class IGNITION_RENDERING_VISIBLE AntiAliasingPass
+      : public virtual RenderPass
+    {
+      /// \brief Constructor
+      public: AntiAliasingPass();
+
+      /// \brief Destructor
+      public: virtual ~AntiAliasingPass();
+
+      /// \brief Get the edge threshold
+      /// \return Minimum local contrast, relative to the brightest of the
+      /// neighboring pixels, of the pixels that are smoothed
+      public: virtual double EdgeThreshold() const = 0;
+
+      /// \brief Set the edge threshold. Lower values smooth more edges and
+      /// cost more. Defaults to 0.125.
+      /// \param[in] _threshold Minimum local contrast, relative to the
+      /// brightest of the neighboring pixels, in [0.063, 0.333]
+      public: virtual void SetEdgeThreshold(double _threshold) = 0;
+
+      /// \brief Get the minimum edge threshold
+      /// \return Minimum absolute local contrast of the pixels that are
+      /// smoothed
+      public: virtual double EdgeThresholdMin() const = 0;
+
+      /// \brief Set the minimum edge threshold, which keeps dark areas from
+      /// being smoothed. Defaults to 0.0312.
+      /// \param[in] _threshold Minimum absolute local contrast, in
+      /// [0.0, 0.0833]
+      public: virtual void SetEdgeThresholdMin(double _threshold) = 0;
+
+      /// \brief Get the subpixel quality
+      /// \return Amount of subpixel aliasing removed
+      public: virtual double SubpixelQuality() const = 0;
+
+      /// \brief Set the amount of subpixel aliasing removed. Higher values
+      /// are smoother and blurrier. Defaults to 0.75.
+      /// \param[in] _quality Amount of subpixel aliasing removed, in
+      /// [0.0, 1.0], 0 turns it off
+      public: virtual void SetSubpixelQuality(double _quality) = 0;
+    };
+    }
+  }
+}
+#endif
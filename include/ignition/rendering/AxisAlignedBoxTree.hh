@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_AXISALIGNEDBOXTREE_HH_
+#define IGNITION_RENDERING_AXISALIGNEDBOXTREE_HH_
+
+#include <memory>
+#include <vector>
+
+#include <ignition/common/SuppressWarning.hh>
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Frustum.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declarations
+    class AxisAlignedBoxTreePrivate;
+
+    /// \class AxisAlignedBoxTree AxisAlignedBoxTree.hh
+    /// ignition/rendering/AxisAlignedBoxTree.hh
+    /// \brief Dynamic bounding volume hierarchy over axis aligned boxes
+    /// identified by ids, for region and nearest neighbor queries.
+    ///
+    /// Boxes can be inserted, moved and removed one at a time. The tree
+    /// stores each box enlarged by a margin, so a box that moves by less
+    /// than the margin does not change the structure of the tree. Queries
+    /// are answered with the exact boxes.
+    /// \sa Scene::VisualsInBox
+    class IGNITION_RENDERING_VISIBLE AxisAlignedBoxTree
+    {
+      /// \brief Constructor
+      /// \param[in] _margin Distance boxes are enlarged by in the tree
+      public: explicit AxisAlignedBoxTree(double _margin = 0.1);
+
+      /// \brief Destructor
+      public: ~AxisAlignedBoxTree();
+
+      /// \brief Insert a box, or move the box already stored for an id.
+      /// Empty boxes and boxes that are not finite are removed instead,
+      /// since they can not be located.
+      /// \param[in] _id Id of the box
+      /// \param[in] _box Box in world coordinates
+      public: void Update(unsigned int _id, const math::AxisAlignedBox &_box);
+
+      /// \brief Remove the box of an id. Unknown ids are ignored.
+      /// \param[in] _id Id of the box
+      public: void Remove(unsigned int _id);
+
+      /// \brief Check if a box is stored for an id
+      /// \param[in] _id Id of the box
+      /// \return True if the tree holds a box for the id
+      public: bool Contains(unsigned int _id) const;
+
+      /// \brief Get the box stored for an id
+      /// \param[in] _id Id of the box
+      /// \return The box, empty if the id is unknown
+      public: math::AxisAlignedBox Box(unsigned int _id) const;
+
+      /// \brief Get the number of boxes in the tree
+      /// \return Number of boxes
+      public: unsigned int Size() const;
+
+      /// \brief Remove all the boxes
+      public: void Clear();
+
+      /// \brief Get the ids of the boxes that intersect a box, in no
+      /// particular order. Boxes touching it are included.
+      /// \param[in] _box Query box
+      /// \return Ids of the intersecting boxes
+      public: std::vector<unsigned int> Intersect(
+                  const math::AxisAlignedBox &_box) const;
+
+      /// \brief Get the ids of the boxes that intersect a sphere, in no
+      /// particular order
+      /// \param[in] _center Center of the sphere
+      /// \param[in] _radius Radius of the sphere
+      /// \return Ids of the intersecting boxes
+      public: std::vector<unsigned int> Intersect(
+                  const math::Vector3d &_center, double _radius) const;
+
+      /// \brief Get the ids of the boxes that intersect a frustum, in no
+      /// particular order. Like math::Frustum::Contains, a box is only
+      /// rejected if it is entirely outside one of the planes of the
+      /// frustum, so boxes close to its edges may be reported too.
+      /// \param[in] _frustum Query frustum
+      /// \return Ids of the intersecting boxes
+      public: std::vector<unsigned int> Intersect(
+                  const math::Frustum &_frustum) const;
+
+      /// \brief Get the ids of the boxes closest to a point, sorted from
+      /// the closest to the farthest. The distance to a box is 0 if the
+      /// point is inside it.
+      /// \param[in] _point Query point
+      /// \param[in] _count Maximum number of ids to return
+      /// \return Ids of the closest boxes
+      public: std::vector<unsigned int> Nearest(
+                  const math::Vector3d &_point, unsigned int _count) const;
+
+      /// \brief Get the height of the tree, 0 if it is empty. A balanced
+      /// tree of n boxes has a height close to log2(n) + 1.
+      /// \return Height of the tree
+      public: unsigned int Height() const;
+
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      /// \brief Private data pointer
+      private: std::unique_ptr<AxisAlignedBoxTreePrivate> dataPtr;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+    }
+  }
+}
+#endif
@@ -17,9 +17,12 @@
 #ifndef IGNITION_RENDERING_BOUNDINGBOX_HH_
 #define IGNITION_RENDERING_BOUNDINGBOX_HH_
 
+#include <cstdint>
 #include <memory>
 
 #include <ignition/common/SuppressWarning.hh>
+#include <ignition/math/Quaternion.hh>
+#include <ignition/math/Vector3.hh>
 
 #include "ignition/rendering/config.hh"
 #include "ignition/rendering/Export.hh"
@@ -59,6 +62,55 @@ inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
     /// \return *this
     public: BoundingBox &operator=(const BoundingBox &_box);
 
+    /// \brief Set the center of the box. For 2D boxes this is in image
+    /// coordinates (pixels) and the z component is unused. For 3D boxes this
+    /// is the position in the camera frame.
+    /// \param[in] _center Center of the box
+    public: void SetCenter(const math::Vector3d &_center);
+
+    /// \brief Get the center of the box
+    /// \return Center of the box
+    /// \sa SetCenter
+    public: const math::Vector3d &Center() const;
+
+    /// \brief Set the size of the box. For 2D boxes this is the width and
+    /// height in pixels and the z component is unused.
+    /// \param[in] _size Size of the box
+    public: void SetSize(const math::Vector3d &_size);
+
+    /// \brief Get the size of the box
+    /// \return Size of the box
+    /// \sa SetSize
+    public: const math::Vector3d &Size() const;
+
+    /// \brief Set the orientation of a 3D box in the camera frame
+    /// \param[in] _orientation Orientation of the box
+    public: void SetOrientation(const math::Quaterniond &_orientation);
+
+    /// \brief Get the orientation of a 3D box in the camera frame
+    /// \return Orientation of the box, identity for 2D boxes
+    public: const math::Quaterniond &Orientation() const;
+
+    /// \brief Set the label of the object in the box
+    /// \param[in] _label Label of the object
+    public: void SetLabel(uint32_t _label);
+
+    /// \brief Get the label of the object in the box
+    /// \return Label of the object
+    public: uint32_t Label() const;
+
+    /// \brief Set the fraction of the object that is visible, i.e. the
+    /// number of its visible pixels over the number of pixels it covers in
+    /// the image when no other object occludes it. Parts outside of the
+    /// image are not counted.
+    /// \param[in] _ratio Visible ratio in [0, 1]
+    public: void SetVisibleRatio(double _ratio);
+
+    /// \brief Get the fraction of the object that is visible
+    /// \return Visible ratio in [0, 1], 1 if unknown
+    /// \sa SetVisibleRatio
+    public: double VisibleRatio() const;
+
     /// \internal
     /// \brief Private data
     IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
@@ -17,13 +17,18 @@
 #ifndef IGNITION_RENDERING_CAMERA_HH_
 #define IGNITION_RENDERING_CAMERA_HH_
 
+#include <functional>
 #include <string>
+#include <vector>
 
 #include <ignition/common/Event.hh>
 #include <ignition/math/Matrix4.hh>
+#include <ignition/math/Pose3.hh>
 
 #include "ignition/rendering/config.hh"
 #include "ignition/rendering/Image.hh"
+#include "ignition/rendering/FrameRecorder.hh"
+#include "ignition/rendering/ImagePool.hh"
 #include "ignition/rendering/PixelFormat.hh"
 #include "ignition/rendering/Sensor.hh"
 #include "ignition/rendering/Scene.hh"
@@ -53,6 +58,11 @@ namespace ignition
       public: typedef std::function<void(const void*, unsigned int,
           unsigned int, unsigned int, const std::string&)> NewFrameListener;
 
+      /// \brief Callback function receiving the images of CaptureBatch,
+      /// with the index of the pose each image was rendered from
+      public: typedef std::function<void(unsigned int, const Image &)>
+          CaptureBatchCallback;
+
       /// \brief Destructor
       public: virtual ~Camera() { }
 
@@ -132,6 +142,20 @@ namespace ignition
       /// \param[in] _near Near clipping plane distance
       public: virtual void SetNearClipPlane(const double _near) = 0;
 
+      /// \brief Set the level of detail bias of the camera. Meshes switch
+      /// to their reduced levels of detail at distances scaled by the bias:
+      /// higher values keep more detail, lower values trade detail for
+      /// speed, e.g. for low resolution sensors. Defaults to 1, and to 0.5
+      /// for thermal cameras. ogre2 heightmaps also start one level of
+      /// detail coarser for each halving of the bias below 1.
+      /// \param[in] _bias Level of detail bias, greater than 0
+      public: virtual void SetLodBias(double _bias) = 0;
+
+      /// \brief Get the level of detail bias of the camera
+      /// \return Level of detail bias
+      /// \sa SetLodBias
+      public: virtual double LodBias() const = 0;
+
       /// \brief Renders the current scene using this camera. This function
       /// assumes PreRender() has already been called on the parent Scene,
       /// allowing the camera and the scene itself to prepare for rendering.
@@ -149,6 +173,90 @@ namespace ignition
       public: virtual VisualPtr VisualAt(const ignition::math::Vector2i
                   &_mousePos) = 0;
 
+      /// \brief Get the visuals for a list of mouse positions. This is
+      /// faster than calling VisualAt for each position when querying many
+      /// positions at once.
+      /// \param[in] _mousePos List of mouse positions
+      /// \return Visual for each position, null if no visual was found at
+      /// that position
+      /// \remarks Not all rendering engines support batched queries, the
+      /// default implementation calls VisualAt for each position. ogre2 renders
+      /// the selection buffer only once for all positions.
+      public: virtual std::vector<VisualPtr> VisualsAt(
+                  const std::vector<ignition::math::Vector2i> &_mousePos) = 0;
+
+      /// \brief Set whether VisualAt is answered from object ids that the
+      /// camera writes while rendering its frames, instead of rendering a
+      /// selection buffer. Picks then cost next to nothing, which suits
+      /// hovering, but return what the last rendered frame showed at the
+      /// position. Positions where the object can't be told from its id,
+      /// e.g. unlit or terrain geometry, or materials shared by several
+      /// visuals, still use the selection buffer.
+      /// \param[in] _enabled True to pick from object ids
+      /// \remarks Only ogre2 cameras support object ids, and only with
+      /// OpenGL and without anti-aliasing.
+      public: virtual void SetObjectIdPickingEnabled(bool _enabled) = 0;
+
+      /// \brief Get whether VisualAt is answered from object ids
+      /// \return True if picking from object ids
+      /// \sa SetObjectIdPickingEnabled
+      public: virtual bool ObjectIdPickingEnabled() const = 0;
+
+      /// \brief Set whether the camera keeps the depth of the frames it
+      /// renders, so that DepthAt can answer. screenToScene then resolves
+      /// points from the last rendered frame with a texel read instead of
+      /// a ray query, which suits interactive camera control. Only what the
+      /// camera rendered is seen, i.e. geometry inside of its frustum and
+      /// visibility mask.
+      /// \param[in] _enabled True to keep the depth
+      /// \remarks Only ogre2 cameras support depth picking, and only
+      /// without anti-aliasing.
+      public: virtual void SetDepthPickingEnabled(bool _enabled) = 0;
+
+      /// \brief Get whether the camera keeps the depth of its frames
+      /// \return True if depth picking is enabled
+      /// \sa SetDepthPickingEnabled
+      public: virtual bool DepthPickingEnabled() const = 0;
+
+      /// \brief Get the depth at a position of the last rendered frame
+      /// \param[in] _pos Position in pixels of the camera image
+      /// \param[out] _depth Distance along the view direction of the camera
+      /// to the surface rendered at the position, infinite if nothing was
+      /// rendered there
+      /// \return False if depth picking is not enabled or not supported,
+      /// or no frame has been rendered with it yet
+      /// \sa SetDepthPickingEnabled
+      public: virtual bool DepthAt(const math::Vector2i &_pos,
+                  double &_depth) = 0;
+
+      /// \brief Writes the depth of the last rendered frame to the given
+      /// buffer. The depth is written by the scene pass that renders the
+      /// color image, so color and depth of a frame cost one render and
+      /// one download each instead of a camera and a depth camera.
+      /// \param[out] _depth Buffer of ImageWidth * ImageHeight floats
+      /// receiving the distance along the view direction of the camera to
+      /// the surface rendered at each pixel, infinite if nothing was
+      /// rendered there
+      /// \return False if depth picking is not enabled or not supported,
+      /// or no frame has been rendered with it yet
+      /// \sa SetDepthPickingEnabled
+      public: virtual bool CopyDepth(float *_depth) = 0;
+
+      /// \brief Writes the segmentation labels of the last rendered frame
+      /// to the given buffer. The labels are resolved from the object ids
+      /// written by the scene pass that renders the color image, so color,
+      /// depth and labels of a frame cost one render instead of three
+      /// cameras. Labels are read from the "label" user data of the
+      /// visuals, as in semantic segmentation cameras.
+      /// \param[out] _labels Buffer of ImageWidth * ImageHeight labels
+      /// \param[in] _backgroundLabel Label of the background, of geometry
+      /// without label or object id, e.g. unlit or terrain geometry, and
+      /// of materials shared by visuals of different labels
+      /// \return False if object id picking is not enabled or not
+      /// supported, or no frame has been rendered with it yet
+      /// \sa SetObjectIdPickingEnabled
+      public: virtual bool CopyLabels(int *_labels, int _backgroundLabel) = 0;
+
       /// \brief Renders a new frame.
       /// This is a convenience function for single-camera scenes. It wraps the
       /// pre-render, render, and post-render into a single
@@ -163,6 +271,36 @@ namespace ignition
       /// \return A newly allocated Image for storing this cameras images
       public: virtual Image CreateImage() const = 0;
 
+      /// \brief Set the pool that CreateImage takes image buffers from.
+      /// Buffers of images created while a pool is set are recycled once
+      /// the images are destroyed, instead of allocating a new buffer for
+      /// every image. A pool can be shared by several cameras.
+      /// \param[in] _pool Image pool, or null to allocate a new buffer for
+      /// every image
+      public: virtual void SetImagePool(ImagePoolPtr _pool) = 0;
+
+      /// \brief Get the pool that CreateImage takes image buffers from
+      /// \return Image pool, or null if none is set
+      /// \sa SetImagePool
+      public: virtual ImagePoolPtr ImagePool() const = 0;
+
+      /// \brief Set the texture level of detail bias of the camera. Each
+      /// unit halves the texture resolution the camera needs, e.g. a bias
+      /// of 1 lets a 640x480 camera do with textures of 512x512. Together
+      /// with the resolution of the camera, it bounds the texture mip
+      /// levels kept in memory by scenes that stream textures based on
+      /// their cameras. Low resolution sensors, e.g. thermal or
+      /// segmentation cameras, can use a positive bias to lower the memory
+      /// usage further. Not all render engines support this feature.
+      /// \param[in] _bias Mip bias, 0 by default. Negative values are
+      /// clamped to 0.
+      public: virtual void SetTextureMipBias(double _bias) = 0;
+
+      /// \brief Get the texture level of detail bias of the camera
+      /// \return Mip bias
+      /// \sa SetTextureMipBias
+      public: virtual double TextureMipBias() const = 0;
+
       /// \brief Renders a new frame and writes the results to the given image.
       /// This is a convenience function for single-camera scenes. It wraps the
       /// pre-render, render, post-render, and get-image calls into a single
@@ -178,13 +316,103 @@ namespace ignition
       /// \param[out] _image Output image buffer
       public: virtual void Copy(Image &_image) const = 0;
 
+      /// \brief Writes the last rendered image to the given image buffer as
+      /// planar YUV 4:2:0 (I420), e.g. for video encoders. The image must
+      /// be a PF_L8 image as wide as the camera image and 3/2 as tall.
+      /// \param[out] _image Output image buffer
+      /// \return False if the image is not of the correct size or format
+      /// \sa RenderTarget::CopyI420
+      public: virtual bool CopyI420(Image &_image) = 0;
+
+      /// \brief Renders a new frame of a region of the camera image only and
+      /// writes it to the given image, which defines the size of the region
+      /// and must be of the camera image format. The region is rendered with
+      /// a projection restricted to it, so regions of interest of large
+      /// images are cheaper to render and read back than the full frame.
+      /// Call this once per region. Render passes are not applied to the
+      /// region.
+      /// \param[in] _x Column of the top left pixel of the region
+      /// \param[in] _y Row of the top left pixel of the region
+      /// \param[out] _image Output image buffer
+      /// \return False if the image format does not match or the region is
+      /// not within the camera image
+      public: virtual bool CaptureRegion(unsigned int _x, unsigned int _y,
+                  Image &_image) = 0;
+
+      /// \brief Renders a new frame and queues a copy of it to the given
+      /// image without waiting for the GPU. This lets rendering the next
+      /// frames overlap with downloading the previous ones. The callback is
+      /// called once the image has been written, from a later Capture,
+      /// CaptureAsync, CopyAsync, Update or WaitForAsyncCopies call on this
+      /// camera. The image must stay valid until then.
+      /// \param[out] _image Output image buffer
+      /// \param[in] _callback Function called once the image is written
+      /// \return False if the copy could not be queued, in which case the
+      /// callback is not called
+      /// \sa RenderTarget::CopyAsync
+      public: virtual bool CaptureAsync(Image &_image,
+                  std::function<void()> _callback) = 0;
+
+      /// \brief Queues a copy of the last rendered image to the given image
+      /// buffer without waiting for the GPU. See CaptureAsync.
+      /// \param[out] _image Output image buffer
+      /// \param[in] _callback Function called once the image is written
+      /// \return False if the copy could not be queued, in which case the
+      /// callback is not called
+      /// \sa RenderTarget::CopyAsync
+      public: virtual bool CopyAsync(Image &_image,
+                  std::function<void()> _callback) = 0;
+
+      /// \brief Block until all the copies queued by CaptureAsync and
+      /// CopyAsync are written, calling their callbacks
+      public: virtual void WaitForAsyncCopies() = 0;
+
+      /// \brief Renders a frame from each of the given world poses and
+      /// passes the images to the callback, in order. The frames are
+      /// captured with CaptureAsync into a ring of images, so that
+      /// rendering the next poses overlaps with downloading the previous
+      /// ones, e.g. to generate datasets at the throughput of the GPU. The
+      /// camera is moved back to its pose once all the images are passed
+      /// to the callback.
+      /// \param[in] _poses World poses to render the frames from
+      /// \param[in] _callback Function receiving the index of the pose and
+      /// the image rendered from it. The image is only valid during the
+      /// call.
+      /// \return False if the frame of any pose could not be captured, in
+      /// which case the callback is not called for it
+      public: virtual bool CaptureBatch(const std::vector<math::Pose3d> &_poses,
+                  CaptureBatchCallback _callback) = 0;
+
       /// \brief Writes the previously rendered frame to a file. This function
       /// can be called multiple times after PostRender has been called,
       /// without rendering the scene again. Calling this function before a
       /// single image has been rendered will have undefined behavior.
+      ///
+      /// The frame is read back asynchronously and written by the frame
+      /// recorder of the camera on a background thread, so this returns
+      /// before the file exists. The extension of the name selects the file
+      /// format, see FrameRecorder. Call FrameRecorder()->Flush() to wait
+      /// for the files to be written.
       /// \param[in] _name Name of the output file
+      /// \return False if the image format can not be written to a file of
+      /// this type or the frame could not be queued
+      /// \sa SetFrameRecorder
       public: virtual bool SaveFrame(const std::string &_name) = 0;
 
+      /// \brief Set the recorder that writes the frames saved by SaveFrame.
+      /// A recorder can be shared by several cameras so that they share its
+      /// writer threads. If none is set, a recorder with one writer thread
+      /// is created by the first call to SaveFrame.
+      /// \param[in] _recorder Frame recorder, or null to create a default
+      /// one when needed
+      public: virtual void SetFrameRecorder(FrameRecorderPtr _recorder) = 0;
+
+      /// \brief Get the recorder that writes the frames saved by SaveFrame
+      /// \return Frame recorder, or null if none is set and no frame was
+      /// saved yet
+      /// \sa SetFrameRecorder
+      public: virtual FrameRecorderPtr FrameRecorder() const = 0;
+
       /// \brief Subscribes a new listener to this camera's new frame event
       /// \param[in] _listener New camera listener callback
       public: virtual common::ConnectionPtr ConnectNewImageFrame(
@@ -314,9 +542,24 @@ namespace ignition
       /// \brief Get the OpenGL texture id associated with the render texture
       /// used by this camera. A valid id is returned only if the underlying
       /// render engine is OpenGL based.
+      /// The texture holds the last rendered frame, so other APIs on the
+      /// same GPU, e.g. CUDA through graphics interop, can read the frames
+      /// without copying them to host memory. The frame is complete once
+      /// Render returns, readers in other contexts have to synchronize with
+      /// the rendering thread before reading it and must not write to it.
+      /// Sensors that render to several textures return the texture their
+      /// output is read back from.
       /// \return Texture Id of type GLuint.
       public: virtual unsigned int RenderTextureGLId() const = 0;
 
+      /// \brief Get the Metal texture id associated with the render texture
+      /// used by this camera. A valid id is written only if the underlying
+      /// render engine is Metal based. See RenderTextureGLId.
+      /// \param[out] _textureIdPtr Pointer to an id<MTLTexture> the id is
+      /// written to. It is left unchanged if there is no Metal texture.
+      public: virtual void RenderTextureMetalId(void *_textureIdPtr) const
+                  = 0;
+
       /// \brief Add a render pass to the camera
       /// \param[in] _pass New render pass to add
       public: virtual void AddRenderPass(const RenderPassPtr &_pass) = 0;
@@ -337,6 +580,137 @@ namespace ignition
       /// \internal
       /// \brief Notify that shadows are dirty and need to be regenerated
       public: virtual void SetShadowsDirty() = 0;
+
+      /// \brief Set whether the camera renders shadows. Each camera renders
+      /// the shadow maps of the scene from its own viewpoint, so cameras
+      /// that do not need shadows, e.g. sensors feeding perception
+      /// pipelines, render much faster without them.
+      /// \param[in] _enabled False to render without shadows. Shadows are
+      /// enabled by default.
+      /// \remarks Only ogre2 supports disabling shadows per camera.
+      public: virtual void SetShadowsEnabled(bool _enabled) = 0;
+
+      /// \brief Get whether the camera renders shadows
+      /// \return True if shadows are rendered
+      /// \sa SetShadowsEnabled
+      public: virtual bool ShadowsEnabled() const = 0;
+
+      /// \brief Set the scale of the resolution the camera renders at. The
+      /// scene is rendered at the scaled resolution and upscaled to the
+      /// image size, so images keep their size but lose detail. This lowers
+      /// the GPU cost of the camera roughly by the square of the scale.
+      /// \param[in] _scale Scale of the image width and height, clamped
+      /// between MinResolutionScale and 1
+      /// \remarks Only ogre2 cameras and depth cameras support rendering
+      /// at a lower resolution, other render engines keep rendering at full
+      /// resolution.
+      /// \sa Scene::SetFrameBudget
+      public: virtual void SetResolutionScale(double _scale) = 0;
+
+      /// \brief Get the scale of the resolution the camera renders at
+      /// \return Scale of the image width and height, 1 for full
+      /// resolution
+      /// \sa SetResolutionScale
+      public: virtual double ResolutionScale() const = 0;
+
+      /// \brief Set the lowest resolution scale of the camera. The scene
+      /// frame budget lowers the resolution of cameras down to this scale
+      /// when the scene is over budget.
+      /// \param[in] _scale Lowest scale, between 0 (exclusive) and 1. The
+      /// default of 1 keeps the camera at full resolution.
+      /// \sa Scene::SetFrameBudget
+      public: virtual void SetMinResolutionScale(double _scale) = 0;
+
+      /// \brief Get the lowest resolution scale of the camera
+      /// \return Lowest scale of the image width and height
+      /// \sa SetMinResolutionScale
+      public: virtual double MinResolutionScale() const = 0;
+
+      /// \brief Set how often the camera renders the scene. In between, the
+      /// last rendered frame is reprojected to the current camera pose with
+      /// its depth, which is a lot cheaper than rendering. This suits high
+      /// rate sensors in scenes that change little between frames. Only
+      /// the motion of the camera is taken into account: objects that move
+      /// in between are shown where they were in the last rendered frame,
+      /// and surfaces that the camera motion uncovers are filled with the
+      /// nearest reprojected pixels. Reprojected frames are flagged in
+      /// Sensor::FrameTimings.
+      /// \param[in] _interval Number of frames per rendered frame, e.g. 3
+      /// to render one frame and reproject the next two. 0 and 1 render
+      /// every frame, which is the default.
+      /// \remarks Only ogre2 cameras and depth cameras support
+      /// reprojection. Cameras with views, see SetViewPoses, or a custom
+      /// projection matrix render every frame, and ogre2 cameras also do so
+      /// while they have enabled render passes. Depth cameras read back
+      /// synchronously, with the point cloud data, while reprojecting.
+      public: virtual void SetReprojectionInterval(unsigned int _interval) = 0;
+
+      /// \brief Get how often the camera renders the scene
+      /// \return Number of frames per rendered frame, 1 if every frame is
+      /// rendered
+      /// \sa SetReprojectionInterval
+      public: virtual unsigned int ReprojectionInterval() const = 0;
+
+      /// \brief Set whether Update only renders a new frame when something
+      /// the camera sees may have changed since the last rendered frame.
+      /// When nothing changed, Update returns without rendering and the
+      /// render target keeps the previous frame, so Capture and Copy return
+      /// the previous image and no new frame events are emitted.
+      /// A frame is rendered when the camera pose, image size, projection or
+      /// render passes change, or when the world pose, scale or visibility
+      /// flags of any node in the scene change, or nodes are added or removed.
+      /// Other changes, e.g. to materials, geometries, light properties or
+      /// Visual::SetVisible, are not detected and need a call to
+      /// SetRenderDirty. On demand rendering is off by default.
+      /// \param[in] _enabled True to only render when dirty
+      /// \sa SetRenderDirty
+      public: virtual void SetRenderOnDemand(bool _enabled) = 0;
+
+      /// \brief Get whether Update only renders when something changed
+      /// \return True if on demand rendering is enabled
+      /// \sa SetRenderOnDemand
+      public: virtual bool RenderOnDemand() const = 0;
+
+      /// \brief Force the next Update to render a new frame when on demand
+      /// rendering is enabled. Use this after changes that are not detected
+      /// automatically, see SetRenderOnDemand.
+      public: virtual void SetRenderDirty() = 0;
+
+      /// \brief Render several views of the scene side by side into this
+      /// camera's image, e.g. the two eyes of a stereo pair or the cameras of
+      /// an array. All views are rendered by a single compositor workspace,
+      /// which is much cheaper than creating one camera per view. The views
+      /// are tiled horizontally from left to right, each one ImageWidth() / N
+      /// pixels wide, and use this camera's field of view, clip planes and
+      /// projection. The aspect ratio of each view follows its tile.
+      /// Views that have the same rotation share the shadow maps of the
+      /// first view.
+      /// \param[in] _poses Pose of each view relative to this camera. An
+      /// empty list restores the default single view.
+      /// \remarks Not all rendering engines support multiple views
+      public: virtual void SetViewPoses(
+                  const std::vector<math::Pose3d> &_poses) = 0;
+
+      /// \brief Get the poses of the views rendered by this camera
+      /// \return Pose of each view relative to this camera, empty if this
+      /// camera renders a single view
+      /// \sa SetViewPoses
+      public: virtual std::vector<math::Pose3d> ViewPoses() const = 0;
+
+      /// \brief Set the number of columns of the grid the views are tiled
+      /// in, see SetViewPoses. The views fill the grid row by row from the
+      /// top left, each one ImageWidth() / _columns pixels wide and
+      /// ImageHeight() / rows pixels high, which keeps the image of many
+      /// views within the texture size limits of the GPU.
+      /// \param[in] _columns Number of columns, 0 to tile all views in a
+      /// single row, which is the default
+      /// \remarks Not all rendering engines support multiple views
+      public: virtual void SetViewColumns(unsigned int _columns) = 0;
+
+      /// \brief Get the number of columns of the grid the views are tiled in
+      /// \return Number of columns, 0 if the views are tiled in a single row
+      /// \sa SetViewColumns
+      public: virtual unsigned int ViewColumns() const = 0;
     };
     }
   }
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_CAMERAATLAS_HH_
+#define IGNITION_RENDERING_CAMERAATLAS_HH_
+
+#include <functional>
+#include <memory>
+
+#include <ignition/common/Event.hh>
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/RenderTypes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declarations
+    class CameraAtlasPrivate;
+
+    /// \class CameraAtlas CameraAtlas.hh
+    /// ignition/rendering/CameraAtlas.hh
+    /// \brief Renders many small cameras into the tiles of one shared
+    /// image, e.g. the cameras of a swarm of robots. The atlas renders all
+    /// of them with a single camera whose views, see Camera::SetViewPoses,
+    /// follow the world poses of the added cameras, so all cameras share
+    /// one render target, one compositor workspace, one readback and one
+    /// GPU flush instead of one each. The added cameras only provide their
+    /// poses and settings and are not rendered themselves.
+    ///
+    /// All cameras of an atlas must have the same image size, field of view
+    /// and clip distances, taken from the first camera added. The tiles are
+    /// laid out in a grid of about as many rows as columns, row by row from
+    /// the top left in the order the cameras were added. The atlas image
+    /// is PF_R8G8B8.
+    ///
+    /// Render the atlas with Update, which delivers the tile of every
+    /// camera to the callbacks connected with ConnectNewTile.
+    /// \remarks Only rendering engines that support multiple views, e.g.
+    /// ogre2, can render an atlas.
+    class IGNITION_RENDERING_VISIBLE CameraAtlas
+    {
+      /// \brief Callback receiving the tile of a camera
+      /// \param[in] _camera Camera of the tile
+      /// \param[in] _data First pixel of the tile in the atlas image
+      /// \param[in] _width Width of the tile in pixels
+      /// \param[in] _height Height of the tile in pixels
+      /// \param[in] _stride Number of bytes between two rows of the tile,
+      /// i.e. the size of a row of the atlas image
+      public: typedef std::function<void(const CameraPtr &_camera,
+          const unsigned char *_data, unsigned int _width,
+          unsigned int _height, unsigned int _stride)> NewTileListener;
+
+      /// \brief Constructor
+      /// \param[in] _scene Scene of the cameras. It must outlive the atlas.
+      public: explicit CameraAtlas(Scene *_scene);
+
+      /// \brief Destructor. Destroys the camera rendering the atlas.
+      public: ~CameraAtlas();
+
+      /// \brief Add a camera to render into the atlas
+      /// \param[in] _camera Camera of the scene
+      /// \return False if the camera is not in the scene, already in the
+      /// atlas or its image size, field of view or clip distances differ
+      /// from the ones of the first camera
+      public: bool AddCamera(const CameraPtr &_camera);
+
+      /// \brief Stop rendering a camera into the atlas. The tiles of the
+      /// cameras added after it move one place up.
+      /// \param[in] _camera Camera to remove
+      /// \return False if the camera is not in the atlas
+      public: bool RemoveCamera(const CameraPtr &_camera);
+
+      /// \brief Check if a camera renders into the atlas
+      /// \param[in] _camera Camera to check
+      /// \return True if the camera was added and not removed
+      public: bool HasCamera(const CameraPtr &_camera) const;
+
+      /// \brief Get the number of cameras in the atlas
+      /// \return Number of cameras
+      public: unsigned int CameraCount() const;
+
+      /// \brief Get the byte offset of the tile of a camera in the atlas
+      /// image
+      /// \param[in] _camera Camera of the atlas
+      /// \return Offset of the first pixel of the tile, 0 if the camera is
+      /// not in the atlas
+      public: unsigned int TileOffset(const CameraPtr &_camera) const;
+
+      /// \brief Render all cameras into the atlas image with one scene
+      /// update and one readback, then call the tile listeners for each
+      /// camera. Cameras destroyed in the scene are removed first.
+      /// \return False if the atlas could not be rendered
+      public: bool Update();
+
+      /// \brief Get the image the last Update rendered, holding the tiles
+      /// of all cameras
+      /// \return Atlas image, empty before the first Update
+      public: const Image &AtlasImage() const;
+
+      /// \brief Get the camera that renders the atlas, e.g. to add render
+      /// passes that apply to all tiles
+      /// \return Camera rendering the atlas
+      public: CameraPtr AtlasCamera() const;
+
+      /// \brief Subscribe to the tiles rendered by Update
+      /// \param[in] _listener Callback called for the tile of each camera
+      /// \return Connection, the listener is removed once it is destroyed
+      public: common::ConnectionPtr ConnectNewTile(
+                  NewTileListener _listener);
+
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      /// \brief Private data pointer
+      private: std::unique_ptr<CameraAtlasPrivate> dataPtr;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+    }
+  }
+}
+#endif
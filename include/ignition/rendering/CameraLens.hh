@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_CAMERALENS_HH_
+#define IGNITION_RENDERING_CAMERALENS_HH_
+
+#include <memory>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+namespace rendering
+{
+inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+  class CameraLensPrivate;
+
+  /// \brief Mapping function types of camera lenses
+  enum IGNITION_RENDERING_VISIBLE MappingFunctionType
+  {
+    /// \brief Gnomonical, i.e. the perspective projection of a pinhole
+    MFT_GNOMONICAL = 0,
+
+    /// \brief Stereographic
+    MFT_STEREOGRAPHIC = 1,
+
+    /// \brief Equidistant, the most common fisheye mapping
+    MFT_EQUIDISTANT = 2,
+
+    /// \brief Equisolid angle
+    MFT_EQUISOLID_ANGLE = 3,
+
+    /// \brief Orthographic
+    MFT_ORTHOGRAPHIC = 4,
+
+    /// \brief Custom mapping function, see
+    /// CameraLens::SetCustomMappingFunction
+    MFT_CUSTOM = 5
+  };
+
+  /// \brief Angle functions of the mapping function of camera lenses
+  enum IGNITION_RENDERING_VISIBLE AngleFunctionType
+  {
+    /// \brief f(x) = x
+    AFT_IDENTITY = 0,
+
+    /// \brief f(x) = sin(x)
+    AFT_SIN = 1,
+
+    /// \brief f(x) = tan(x)
+    AFT_TAN = 2
+  };
+
+  /// \brief Describes the projection of a camera lens by its mapping
+  /// function r = c1 * f * fun(theta / c2 + c3), where r is the distance of
+  /// a pixel to the image center, in units of half the image width, and
+  /// theta is the angle between the incoming ray and the optical axis.
+  class IGNITION_RENDERING_VISIBLE CameraLens
+  {
+    /// \brief Constructor. Creates an equidistant lens.
+    public: CameraLens();
+
+    /// \brief Copy constructor
+    /// \param[in] _lens CameraLens to copy.
+    public: CameraLens(const CameraLens &_lens);
+
+    /// \brief Destructor
+    public: virtual ~CameraLens();
+
+    /// \brief Copy Assignment operator.
+    /// \param[in] _lens The camera lens to set values from.
+    /// \return *this
+    public: CameraLens &operator=(const CameraLens &_lens);
+
+    /// \brief Set the mapping function to one of the predefined types.
+    /// Use SetCustomMappingFunction to set a custom one.
+    /// \param[in] _type Mapping function type
+    public: void SetType(MappingFunctionType _type);
+
+    /// \brief Get the mapping function type
+    /// \return Mapping function type, MFT_CUSTOM if the coefficients do not
+    /// match a predefined type
+    public: MappingFunctionType Type() const;
+
+    /// \brief Set a custom mapping function
+    /// \param[in] _c1 Linear scaling constant
+    /// \param[in] _c2 Angle scaling constant
+    /// \param[in] _fun Angle function
+    /// \param[in] _f Focal length of the optical system
+    /// \param[in] _c3 Angle shift constant, usually 0
+    public: void SetCustomMappingFunction(double _c1, double _c2,
+                AngleFunctionType _fun, double _f, double _c3);
+
+    /// \brief Get the linear scaling constant c1
+    /// \return c1
+    public: double C1() const;
+
+    /// \brief Get the angle scaling constant c2
+    /// \return c2
+    public: double C2() const;
+
+    /// \brief Get the angle shift constant c3
+    /// \return c3
+    public: double C3() const;
+
+    /// \brief Get the focal length f
+    /// \return f
+    public: double F() const;
+
+    /// \brief Get the angle function
+    /// \return Angle function
+    public: AngleFunctionType AngleFunction() const;
+
+    /// \brief Get the cut off angle. Pixels whose ray is further from the
+    /// optical axis are black.
+    /// \return Cut off angle in radians
+    public: double CutOffAngle() const;
+
+    /// \brief Set the cut off angle, see CutOffAngle
+    /// \param[in] _angle Cut off angle in radians
+    public: void SetCutOffAngle(double _angle);
+
+    /// \brief Check if the focal length is scaled so that the horizontal
+    /// field of view of the camera spans the image width
+    /// \return True if the focal length is scaled to the field of view
+    public: bool ScaleToHFOV() const;
+
+    /// \brief Set whether the focal length is scaled so that the horizontal
+    /// field of view of the camera spans the image width, in which case F
+    /// is ignored
+    /// \param[in] _scale True to scale the focal length to the fov
+    public: void SetScaleToHFOV(bool _scale);
+
+    /// \brief Get the focal length the lens maps rays with
+    /// \param[in] _hfov Horizontal field of view of the camera in radians
+    /// \return F, or the focal length that maps half of _hfov to the image
+    /// border if the lens is scaled to the field of view
+    public: double EffectiveF(double _hfov) const;
+
+    /// \brief Get the angle between a ray and the optical axis from the
+    /// distance of its pixel to the image center, i.e. the inverse of the
+    /// mapping function
+    /// \param[in] _r Distance to the image center in units of half the
+    /// image width
+    /// \param[in] _f Focal length, see EffectiveF
+    /// \param[out] _theta Angle of the ray in radians
+    /// \return False if no ray maps to _r
+    public: bool Angle(double _r, double _f, double &_theta) const;
+
+    /// \brief Private data pointer.
+    IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+    private: std::unique_ptr<CameraLensPrivate> dataPtr;
+    IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+  };
+}
+}
+}
+#endif
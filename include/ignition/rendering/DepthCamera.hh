@@ -17,6 +17,8 @@
 #ifndef IGNITION_RENDERING_DEPTHCAMERA_HH_
 #define IGNITION_RENDERING_DEPTHCAMERA_HH_
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 #include <ignition/common/Event.hh>
@@ -75,6 +77,138 @@ namespace ignition
           std::function<void(const float *_pointCloud, unsigned int _width,
           unsigned int _height, unsigned int _depth,
           const std::string &_format)> _subscriber) = 0;
+
+      /// \brief Connect to the new depth frame view signal. Unlike
+      /// ConnectNewDepthFrame, the data handed to subscribers is not copied
+      /// into intermediate buffers. It points straight into the memory the
+      /// frame was read back into and is only valid for the duration of the
+      /// callback. Rows may be padded so use the row pitch to step between
+      /// them. If only view subscribers are connected, the buffer returned
+      /// by DepthData is not updated.
+      /// \param[in] _subscriber Subscriber callback function
+      /// The arguments of the callback function are:
+      ///   _data Pointer to the first pixel. Depth is stored in the first
+      ///         channel of each pixel
+      ///   _width Image width
+      ///   _height Image height
+      ///   _channels Number of floats per pixel: 1 when only depth is read
+      ///             back (see SetDepthOnlyReadback), 4 [X, Y, Z, RGBA]
+      ///             otherwise
+      ///   _rowPitch Number of bytes between the start of consecutive rows
+      ///   _format Image format
+      /// \return Pointer to the new Connection. This must be kept in scope
+      public: virtual ignition::common::ConnectionPtr ConnectNewDepthFrameView(
+          std::function<void(const float *_data, unsigned int _width,
+          unsigned int _height, unsigned int _channels,
+          unsigned int _rowPitch, const std::string &_format)>
+          _subscriber) = 0;
+
+      /// \brief Connect to the new rgb point cloud view signal. This is the
+      /// zero-copy counterpart of ConnectNewRgbPointCloud, see
+      /// ConnectNewDepthFrameView for the lifetime and layout rules.
+      /// \param[in] _subscriber Subscriber callback function. The arguments
+      /// are the same as for ConnectNewDepthFrameView, with 4 channels
+      /// [X, Y, Z, RGBA] per pixel
+      /// \return Pointer to the new Connection. This must be kept in scope
+      public: virtual ignition::common::ConnectionPtr
+          ConnectNewRgbPointCloudView(
+          std::function<void(const float *_data, unsigned int _width,
+          unsigned int _height, unsigned int _channels,
+          unsigned int _rowPitch, const std::string &_format)>
+          _subscriber) = 0;
+
+      /// \brief Read back only the depth channel while nobody is connected
+      /// to the rgb point cloud signals. The depth value is extracted on the
+      /// GPU so the full [X, Y, Z, RGBA] data does not need to be copied to
+      /// CPU memory, reducing readback bandwidth by a factor of 4. The
+      /// color of the scene, which is only needed for point clouds, is not
+      /// rendered either, which also skips shadows and the sky. While
+      /// active, DepthData returns one float per pixel.
+      /// \remarks Not all rendering engines support this. ogre2 does.
+      /// \param[in] _enabled True to enable depth only readback
+      public: virtual void SetDepthOnlyReadback(bool _enabled) = 0;
+
+      /// \brief Get whether depth only readback is enabled
+      /// \return True if depth only readback is enabled
+      /// \sa SetDepthOnlyReadback
+      public: virtual bool DepthOnlyReadback() const = 0;
+
+      /// \brief Enable or disable asynchronous readback of depth data.
+      /// When enabled, the GPU to CPU copy of a rendered frame is queued
+      /// instead of waited on. The new depth frame and rgb point cloud
+      /// events for that frame are then emitted during a later PostRender
+      /// call, once the copy has completed. This lets CPU work for one
+      /// frame overlap GPU rendering of the next, at the cost of at least
+      /// one frame of latency.
+      /// \remarks Not all rendering engines support this. ogre and ogre2 do.
+      /// \param[in] _enabled True to enable asynchronous readback
+      /// \sa AsyncReadback
+      public: virtual void SetAsyncReadback(bool _enabled) = 0;
+
+      /// \brief Get whether asynchronous readback is enabled
+      /// \return True if asynchronous readback is enabled
+      /// \sa SetAsyncReadback
+      public: virtual bool AsyncReadback() const = 0;
+
+      /// \brief Set the format depth data is encoded to on the GPU before
+      /// being read back, to shrink both the readback and the data handed
+      /// to ConnectNewEncodedDepthFrame subscribers. Supported formats are:
+      ///   PF_FLOAT32_R: 32 bit float depth in meters (default)
+      ///   PF_FLOAT16_R: 16 bit float depth in meters
+      ///   PF_L16: 16 bit unsigned depth in millimeters. Depth that is not
+      ///           finite, not positive or larger than 65.535 m is 0
+      /// A format other than PF_FLOAT32_R enables depth only readback (see
+      /// SetDepthOnlyReadback). While rgb point cloud subscribers are
+      /// connected, depth is read back as 32 bit float data and encoded on
+      /// the CPU instead. Otherwise the float data returned by DepthData and
+      /// handed to the other depth frame subscribers is decoded from the
+      /// encoded data, so it carries the same quantization.
+      /// \remarks Not all rendering engines support this. ogre2 does.
+      /// \param[in] _format Depth output format
+      /// \return True if the format is supported
+      public: virtual bool SetDepthOutputFormat(PixelFormat _format) = 0;
+
+      /// \brief Get the format depth data is encoded to
+      /// \return Depth output format
+      /// \sa SetDepthOutputFormat
+      public: virtual PixelFormat DepthOutputFormat() const = 0;
+
+      /// \brief Connect to the new encoded depth frame signal, emitted with
+      /// the depth data in the format set by SetDepthOutputFormat. As for
+      /// ConnectNewDepthFrameView, the data is not copied and is only valid
+      /// for the duration of the callback. If only encoded depth frame
+      /// subscribers are connected, the encoded data is not decoded and the
+      /// buffer returned by DepthData is not updated.
+      /// \param[in] _subscriber Subscriber callback function
+      /// The arguments of the callback function are:
+      ///   _data Pointer to the first pixel, one value per pixel
+      ///   _width Image width
+      ///   _height Image height
+      ///   _rowPitch Number of bytes between the start of consecutive rows
+      ///   _format Name of the pixel format of the data, see PixelUtil::Name
+      /// \return Pointer to the new Connection. This must be kept in scope
+      public: virtual ignition::common::ConnectionPtr
+          ConnectNewEncodedDepthFrame(
+          std::function<void(const void *_data, unsigned int _width,
+          unsigned int _height, unsigned int _rowPitch,
+          const std::string &_format)> _subscriber) = 0;
+
+      /// \brief Connect to the new compressed depth frame signal, emitted
+      /// while the depth output format is PF_L16 with the millimeter depth
+      /// losslessly compressed by DepthCompression, e.g. to stream it over
+      /// the network. The data is only valid for the duration of the
+      /// callback.
+      /// \remarks Not all rendering engines support this. ogre2 does.
+      /// \param[in] _subscriber Subscriber callback function
+      /// The arguments of the callback function are:
+      ///   _data Compressed data, see DepthCompression::Decompress
+      ///   _size Size of the compressed data in bytes
+      /// \return Pointer to the new Connection. This must be kept in scope
+      /// \sa SetDepthOutputFormat
+      public: virtual ignition::common::ConnectionPtr
+          ConnectNewCompressedDepthFrame(
+          std::function<void(const uint8_t *_data, size_t _size)>
+          _subscriber) = 0;
     };
   }
   }
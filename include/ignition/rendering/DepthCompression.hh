@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_DEPTHCOMPRESSION_HH_
+#define IGNITION_RENDERING_DEPTHCOMPRESSION_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \class DepthCompression DepthCompression.hh
+    /// ignition/rendering/DepthCompression.hh
+    /// \brief Lossless compression of 16 bit depth images, e.g. the PF_L16
+    /// millimeter depth of a depth camera, for streaming them over the
+    /// network. Depth is run-length encoded with RVL: runs of invalid, zero
+    /// depth are stored as a count, and valid depth as the difference to the
+    /// previous valid value in variable length nibbles, which typically
+    /// shrinks depth images 3 to 5 times.
+    ///
+    /// The image is split in bands of kBandRows rows compressed
+    /// independently, so they can be compressed and decompressed in
+    /// parallel. The data is little endian and starts with kVersion.
+    class IGNITION_RENDERING_VISIBLE DepthCompression
+    {
+      /// \brief Function running a function over a range of items, possibly
+      /// on several threads, e.g. a worker pool. It calls _function with
+      /// disjoint [_begin, _end) ranges covering [0, _count) and returns
+      /// once all calls are done.
+      public: using ParallelFor = std::function<void(unsigned int _count,
+          const std::function<void(unsigned int _begin, unsigned int _end)>
+          &_function)>;
+
+      /// \brief Version of the compressed format, the first byte of the data
+      public: static constexpr uint8_t kVersion = 1u;
+
+      /// \brief Number of image rows compressed together
+      public: static constexpr unsigned int kBandRows = 32u;
+
+      /// \brief Compress a depth image
+      /// \param[in] _data Pointer to the first pixel
+      /// \param[in] _width Image width
+      /// \param[in] _height Image height
+      /// \param[in] _rowPitch Number of bytes between the start of
+      /// consecutive rows
+      /// \param[out] _compressed Compressed data. Its capacity is kept, so
+      /// reusing the vector avoids allocations
+      /// \param[in] _parallelFor Function the bands are compressed with,
+      /// null to compress them on the calling thread
+      public: static void Compress(const uint16_t *_data,
+                  unsigned int _width, unsigned int _height,
+                  unsigned int _rowPitch, std::vector<uint8_t> &_compressed,
+                  const ParallelFor &_parallelFor = nullptr);
+
+      /// \brief Decompress a depth image
+      /// \param[in] _data Compressed data
+      /// \param[in] _size Size of the compressed data in bytes
+      /// \param[out] _depth Depth image, rows are contiguous
+      /// \param[out] _width Image width
+      /// \param[out] _height Image height
+      /// \param[in] _parallelFor Function the bands are decompressed with,
+      /// null to decompress them on the calling thread
+      /// \return False if the data is malformed
+      public: static bool Decompress(const uint8_t *_data, size_t _size,
+                  std::vector<uint16_t> &_depth, unsigned int &_width,
+                  unsigned int &_height,
+                  const ParallelFor &_parallelFor = nullptr);
+    };
+    }
+  }
+}
+#endif
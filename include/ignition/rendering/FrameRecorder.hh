@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_FRAMERECORDER_HH_
+#define IGNITION_RENDERING_FRAMERECORDER_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/Image.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declarations
+    class FrameRecorderPrivate;
+
+    /// \class FrameRecorder FrameRecorder.hh
+    /// ignition/rendering/FrameRecorder.hh
+    /// \brief Writes images to files on a pool of background threads, so
+    /// that encoding and disk access do not stall rendering. Frames wait in
+    /// a bounded queue; when it is full new frames are either dropped or
+    /// the caller blocks until a writer frees a slot, see SetBlockWhenFull.
+    ///
+    /// The file format is chosen by the extension of the file name:
+    /// - ".png": 8 bit formats (PF_L8, PF_R8G8B8, PF_B8G8R8, PF_R8G8B8A8
+    ///   and the bayer formats, which are written as grayscale).
+    /// - ".exr": uncompressed OpenEXR, for the float formats, e.g. depth
+    ///   images.
+    /// - ".npy": NumPy array of shape (height, width) for single channel
+    ///   formats, (height, width, channels) otherwise, for any format.
+    /// - ".raw": the image buffer as is, for any format.
+    ///
+    /// Images share their buffer when copied, so the image passed to Save
+    /// must not be written to until the frame is written, e.g. by taking
+    /// every frame from Camera::CreateImage with an ImagePool set.
+    ///
+    /// This class is thread safe.
+    /// \sa Camera::SaveFrame
+    class IGNITION_RENDERING_VISIBLE FrameRecorder
+    {
+      /// \brief Constructor. Starts the writer threads.
+      /// \param[in] _threadCount Number of writer threads, at least one
+      /// \param[in] _queueSize Maximum number of frames waiting to be
+      /// written, at least one
+      public: explicit FrameRecorder(unsigned int _threadCount = 1u,
+                  unsigned int _queueSize = 8u);
+
+      /// \brief Destructor. Writes the frames already queued, then joins
+      /// the writer threads.
+      public: ~FrameRecorder();
+
+      /// \brief Queue an image to be written to a file
+      /// \param[in] _image Image to write. Its buffer is shared, not copied.
+      /// \param[in] _filename Name of the file, its extension selects the
+      /// file format
+      /// \return False if the format is not supported or the frame was
+      /// dropped because the queue is full
+      public: bool Save(const Image &_image, const std::string &_filename);
+
+      /// \brief Wait until all the queued frames are written
+      public: void Flush();
+
+      /// \brief Set what Save does when the queue is full. Frames are
+      /// dropped by default, which keeps the render loop running at its
+      /// rate when the disk can not keep up.
+      /// \param[in] _block True to block until a slot is free, false to
+      /// drop the frame
+      public: void SetBlockWhenFull(bool _block);
+
+      /// \brief Get whether Save blocks when the queue is full
+      /// \return True if Save blocks, false if it drops frames
+      public: bool BlockWhenFull() const;
+
+      /// \brief Get the maximum number of frames waiting to be written
+      /// \return Queue size
+      public: unsigned int QueueSize() const;
+
+      /// \brief Get the number of frames queued or being written
+      /// \return Number of pending frames
+      public: unsigned int PendingCount() const;
+
+      /// \brief Get the number of frames written so far
+      /// \return Number of written frames
+      public: uint64_t WrittenCount() const;
+
+      /// \brief Get the number of frames dropped so far, because the queue
+      /// was full or the file could not be written
+      /// \return Number of dropped frames
+      public: uint64_t DroppedCount() const;
+
+      /// \brief Check if an image can be written to a file by Write or Save
+      /// \param[in] _format Pixel format of the image
+      /// \param[in] _filename Name of the file, its extension selects the
+      /// file format
+      /// \return True if the format is supported
+      public: static bool IsSupported(PixelFormat _format,
+                  const std::string &_filename);
+
+      /// \brief Write an image to a file on the calling thread
+      /// \param[in] _image Image to write
+      /// \param[in] _filename Name of the file, its extension selects the
+      /// file format
+      /// \return True if the file was written
+      public: static bool Write(const Image &_image,
+                  const std::string &_filename);
+
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      /// \brief Private data pointer
+      private: std::unique_ptr<FrameRecorderPrivate> dataPtr;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+    }
+  }
+}
+#endif
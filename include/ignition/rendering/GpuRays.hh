@@ -18,8 +18,11 @@
 #define IGNITION_RENDERING_GPURAYS_HH_
 
 #include <string>
+#include <vector>
 
 #include <ignition/common/Event.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector2.hh>
 
 #include "ignition/rendering/Image.hh"
 #include "ignition/rendering/Sensor.hh"
@@ -61,6 +64,22 @@ namespace ignition
       // false if data values outside of camera range are returned as +/-inf
       public: virtual bool Clamp() const = 0;
 
+      /// \brief Enable or disable asynchronous readback of gpu rays data.
+      /// When enabled, the GPU to CPU copy of a rendered frame is queued
+      /// instead of waited on, and the new gpu rays frame event for that
+      /// frame is emitted during the next PostRender call. This lets CPU
+      /// work for one frame overlap GPU rendering of the next, at the cost
+      /// of one frame of latency.
+      /// \remarks Not all rendering engines support this. ogre does.
+      /// \param[in] _enabled True to enable asynchronous readback
+      /// \sa AsyncReadback
+      public: virtual void SetAsyncReadback(bool _enabled) = 0;
+
+      /// \brief Get whether asynchronous readback is enabled
+      /// \return True if asynchronous readback is enabled
+      /// \sa SetAsyncReadback
+      public: virtual bool AsyncReadback() const = 0;
+
       /// \brief Connect to a gpu rays frame signal
       /// \param[in] _subscriber Callback that is called when a new image is
       /// generated. The callback function parameters are:
@@ -190,6 +209,190 @@ namespace ignition
       /// \return The vertical resolution.
       /// \sa VerticalRayCount()
       public: virtual double VerticalResolution() const = 0;
+
+      /// \brief Set the ray group of this sensor. Sensors in the same ray
+      /// group share a single 1st pass cubemap, which is rendered once by the
+      /// group leader (the first sensor in the group to be rendered) from its
+      /// own pose. Every other sensor in the group only samples that cubemap
+      /// with its own rays. This is meant for lidars that are rigidly
+      /// attached at (almost) the same position; the relative orientation to
+      /// the leader is sampled when the sensor is first rendered.
+      ///
+      /// Sensors can only join a group if their near and far clip planes, and
+      /// min and max data values, match those of the group leader.
+      /// A group member rendered before its leader in the same frame samples
+      /// the cubemap of the previous frame.
+      /// \remarks Not all rendering engines support this. ogre2 does.
+      /// \param[in] _group Name of the ray group. An empty string (default)
+      /// means the sensor renders its own cubemap.
+      public: virtual void SetRayGroup(const std::string &_group) = 0;
+
+      /// \brief Get the ray group of this sensor
+      /// \return Name of the ray group, empty if the sensor is not in a group
+      /// or ray groups are not supported by the rendering engine.
+      /// \sa SetRayGroup
+      public: virtual std::string RayGroup() const = 0;
+
+      /// \brief Set the format gpu rays data is encoded to on the GPU
+      /// before being read back, to shrink both the readback and the data
+      /// handed to ConnectNewEncodedGpuRaysFrame subscribers. Each reading
+      /// keeps its 3 channels. Supported formats are:
+      ///   PF_FLOAT32_RGB: 32 bit float range and retro (default)
+      ///   PF_FLOAT16_RGB: 16 bit float range and retro
+      ///   PF_UINT16_RGB: 16 bit unsigned range in millimeters and retro
+      ///                  rounded to the nearest integer. Ranges that are
+      ///                  not finite, not positive or larger than 65.535 m
+      ///                  are 0
+      /// The float data returned by Data and handed to ConnectNewGpuRaysFrame
+      /// subscribers is decoded from the encoded data, so it carries the
+      /// same quantization.
+      /// \remarks Not all rendering engines support this. ogre2 does.
+      /// \param[in] _format Output format
+      /// \return True if the format is supported
+      public: virtual bool SetOutputFormat(PixelFormat _format) = 0;
+
+      /// \brief Get the format gpu rays data is encoded to
+      /// \return Output format
+      /// \sa SetOutputFormat
+      public: virtual PixelFormat OutputFormat() const = 0;
+
+      /// \brief Set an explicit elevation angle for each vertical beam,
+      /// instead of spacing VerticalRayCount beams uniformly between
+      /// VerticalAngleMin and VerticalAngleMax. This models sensors with
+      /// non-uniform beam spacing without rendering and reading back
+      /// beams that are thrown away. Row i of the output holds beam i.
+      /// While a beam table is set, VerticalRayCount and VerticalRangeCount
+      /// return the number of beams and VerticalAngleMin and
+      /// VerticalAngleMax the smallest and largest elevation. Like the
+      /// other ray settings, it has to be set before the sensor is first
+      /// rendered.
+      /// \param[in] _elevations Elevation angle of each beam in radians.
+      /// An empty table restores uniform spacing.
+      /// \param[in] _azimuthOffsets Horizontal angle in radians added to all
+      /// rays of each beam, for sensors whose beams are staggered
+      /// horizontally. Either empty or of the same size as _elevations.
+      /// \return True if the table was set, false if the sizes do not match
+      public: virtual bool SetVerticalBeams(
+                  const std::vector<double> &_elevations,
+                  const std::vector<double> &_azimuthOffsets) = 0;
+
+      /// \brief Get the elevation angles of the vertical beams
+      /// \return Elevation of each beam in radians, empty if beams are
+      /// spaced uniformly
+      /// \sa SetVerticalBeams
+      public: virtual std::vector<double> VerticalBeamElevations() const = 0;
+
+      /// \brief Get the horizontal offsets of the vertical beams
+      /// \return Azimuth offset of each beam in radians, empty if there are
+      /// none
+      /// \sa SetVerticalBeams
+      public: virtual std::vector<double> VerticalBeamAzimuthOffsets() const
+                  = 0;
+
+      /// \brief Set an arbitrary pattern of rays, e.g. for lidars with non
+      /// repetitive scan patterns, instead of a grid of rays. The output
+      /// holds one reading per ray, in the order of the pattern, laid out in
+      /// rows of _width rays. While a pattern is set, RayCount and
+      /// RangeCount return the width of the rows, VerticalRayCount and
+      /// VerticalRangeCount the number of rows, and the horizontal and
+      /// vertical angles and the vertical beam table are not used. Like the
+      /// other ray settings, it has to be set before the sensor is first
+      /// rendered.
+      /// \remarks Not all rendering engines support this. ogre2 does.
+      /// \param[in] _rays Azimuth (X) and elevation (Y) of each ray in
+      /// radians. An empty pattern restores the grid of rays.
+      /// \param[in] _width Number of rays in each row of the output. 0 puts
+      /// all rays in a single row.
+      /// \return True if the pattern was set, false if the number of rays
+      /// is not a multiple of _width
+      public: virtual bool SetRayPattern(
+                  const std::vector<math::Vector2d> &_rays,
+                  unsigned int _width = 0u) = 0;
+
+      /// \brief Get the pattern of rays
+      /// \return Azimuth and elevation of each ray in radians, empty if the
+      /// rays form a grid
+      /// \sa SetRayPattern
+      public: virtual std::vector<math::Vector2d> RayPattern() const = 0;
+
+      /// \brief Connect to the new encoded gpu rays frame signal, emitted
+      /// with the data in the format set by SetOutputFormat. The data is not
+      /// copied and is only valid for the duration of the callback.
+      /// \param[in] _subscriber Subscriber callback function
+      /// The arguments of the callback function are:
+      ///   _frame Pointer to the first reading, 3 values per reading
+      ///   _width Number of readings in the horizontal scan
+      ///   _height Number of scans in the vertical direction
+      ///   _rowPitch Number of bytes between the start of consecutive rows
+      ///   _format Name of the pixel format of the data, see PixelUtil::Name
+      /// \return A pointer to the connection. This must be kept in scope.
+      public: virtual common::ConnectionPtr ConnectNewEncodedGpuRaysFrame(
+                  std::function<void(const void *_frame, unsigned int _width,
+                  unsigned int _height, unsigned int _rowPitch,
+                  const std::string &_format)> _subscriber) = 0;
+
+      /// \brief Connect to the gpu rays point cloud signal. The point cloud
+      /// is computed on the GPU from the range and the direction of each
+      /// ray, so it does not need to be computed from the range data.
+      /// \remarks Not all rendering engines support this. ogre2 does, and
+      /// only computes point clouds while there are subscribers. Connecting
+      /// the first subscriber after the sensor was rendered creates the
+      /// textures of the sensor again.
+      /// \param[in] _subscriber Callback that is called when a new point
+      /// cloud is generated. The callback function parameters are:
+      ///   _pointCloud: Array of 4 floats per ray: the x, y, z position of
+      ///             the hit point in the sensor frame (x forward, y left,
+      ///             z up) and the retro value. This matches the layout of a
+      ///             PointCloud2 message with FLOAT32 fields x, y, z and
+      ///             intensity and a point step of 16 bytes. Rays without
+      ///             return have all coordinates set to their range value,
+      ///             e.g. +inf, unless data is clamped.
+      ///   _width:   Number of rays in the horizontal scan
+      ///   _height:  Number of rays in the vertical direction
+      ///   _channels: Number of floats per ray, i.e. 4
+      ///   _format:  Pixel format of the point cloud, i.e. PF_FLOAT32_RGBA
+      /// \return A pointer to the connection. This must be kept in scope.
+      public: virtual common::ConnectionPtr ConnectNewGpuRaysPointCloud(
+                  std::function<void(const float *_pointCloud,
+                  unsigned int _width, unsigned int _height,
+                  unsigned int _channels, const std::string &_format)>
+                  _subscriber) = 0;
+
+      /// \brief Set the number of time segments a scan is rendered in, to
+      /// simulate the motion distortion of a spinning lidar. The rays are
+      /// swept from AngleMin to AngleMax while the sensor moves from the
+      /// scan start pose to its current pose. Each segment covers a range of
+      /// consecutive horizontal rays, which are all sampled at the pose
+      /// interpolated at the middle of the segment. Only the cubemap faces
+      /// sampled by the rays of a segment are rendered for it, so the cost
+      /// grows with the number of segments, but less than rendering that
+      /// many full scans. Sensors in a ray group render a single segment.
+      /// \remarks Not all rendering engines support this. ogre2 does.
+      /// \param[in] _count Number of segments. 1 (default) renders the whole
+      /// scan at the current pose. It is capped at the number of horizontal
+      /// rays.
+      /// \sa SetScanStartPose
+      public: virtual void SetScanSegmentCount(unsigned int _count) = 0;
+
+      /// \brief Get the number of time segments a scan is rendered in
+      /// \return Number of segments
+      /// \sa SetScanSegmentCount
+      public: virtual unsigned int ScanSegmentCount() const = 0;
+
+      /// \brief Set the world pose of the sensor at the start of the scan,
+      /// i.e. when the first horizontal ray is cast. The current world pose
+      /// is the pose at the end of the scan. This is typically set before
+      /// each update, e.g. to the pose of the previous update. Only used if
+      /// the scan is rendered in more than one segment.
+      /// \param[in] _pose World pose of the sensor at the start of the scan
+      /// \sa SetScanSegmentCount
+      public: virtual void SetScanStartPose(const math::Pose3d &_pose) = 0;
+
+      /// \brief Get the world pose of the sensor at the start of the scan
+      /// \return Pose set by SetScanStartPose, or the current world pose if
+      /// none was set
+      /// \sa SetScanStartPose
+      public: virtual math::Pose3d ScanStartPose() const = 0;
     };
   }
   }
@@ -61,6 +61,19 @@ namespace ignition
       /// \brief Get the vertical cell count
       /// \return The vertical cell count.
       public: virtual unsigned int VerticalCellCount() const = 0;
+
+      /// \brief Draw the grid procedurally. The lines of a planar grid are
+      /// then drawn by a shader on a single quad with anti-aliased edges,
+      /// so the cost of the grid does not depend on its cell count.
+      /// Grids with vertical cells, and render engines without support for
+      /// procedural grids, keep drawing their lines as geometry.
+      /// \param[in] _procedural True to draw the grid procedurally
+      public: virtual void SetProcedural(bool _procedural) = 0;
+
+      /// \brief Get whether the grid is drawn procedurally
+      /// \return True if the grid is drawn procedurally
+      /// \sa SetProcedural
+      public: virtual bool Procedural() const = 0;
     };
     }
   }
@@ -210,6 +210,30 @@ inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
     /// \param[in] _use True to use.
     public: void SetUseTerrainPaging(bool _use);
 
+    /// \brief Get the number of samples along each edge of a terrain tile
+    /// when terrain paging is enabled.
+    /// \return Tile size in samples.
+    /// \sa UseTerrainPaging
+    public: unsigned int TileSize() const;
+
+    /// \brief Set the number of samples along each edge of a terrain tile
+    /// when terrain paging is enabled. Must be a power of two. Defaults to
+    /// 256.
+    /// \param[in] _size Tile size in samples.
+    public: void SetTileSize(unsigned int _size);
+
+    /// \brief Get the maximum number of terrain tiles kept loaded at the
+    /// same time when terrain paging is enabled.
+    /// \return Maximum number of resident tiles.
+    public: unsigned int MaxResidentTiles() const;
+
+    /// \brief Set the maximum number of terrain tiles kept loaded at the
+    /// same time when terrain paging is enabled. The tiles closest to the
+    /// cameras are kept, the least recently used ones are unloaded.
+    /// Defaults to 16.
+    /// \param[in] _count Maximum number of resident tiles.
+    public: void SetMaxResidentTiles(unsigned int _count);
+
     /// \brief Get the heightmap's sampling per datum.
     /// \return The heightmap's sampling.
     public: unsigned int Sampling() const;
@@ -17,6 +17,7 @@
 #ifndef IGNITION_RENDERING_IMAGE_HH_
 #define IGNITION_RENDERING_IMAGE_HH_
 
+#include <functional>
 #include <memory>
 
 #include <ignition/common/SuppressWarning.hh>
@@ -36,7 +37,7 @@ namespace ignition
     class IGNITION_RENDERING_VISIBLE Image
     {
       /// \brief Shared pointer to raw image buffer
-      typedef std::shared_ptr<unsigned char> DataPtr;
+      public: typedef std::shared_ptr<unsigned char> DataPtr;
 
       /// \brief Default constructor
       public: Image() = default;
@@ -48,9 +49,61 @@ namespace ignition
       public: Image(unsigned int _width, unsigned int _height,
                   PixelFormat _format);
 
+      /// \brief Constructor that uses an existing buffer, e.g. one from an
+      /// ImagePool. The buffer is shared, not copied.
+      /// \param[in] _width Image width in pixels
+      /// \param[in] _height Image height in pixels
+      /// \param[in] _format Image pixel format
+      /// \param[in] _data Buffer holding at least RowPitch() * Height()
+      /// bytes
+      /// \param[in] _rowPitch Bytes from the start of a row to the start of
+      /// the next one, 0 for rows without padding
+      public: Image(unsigned int _width, unsigned int _height,
+                  PixelFormat _format, DataPtr _data,
+                  unsigned int _rowPitch = 0u);
+
+      /// \brief Constructor that wraps memory owned by the caller, e.g. the
+      /// buffer of an outgoing message, a shared memory segment or pinned
+      /// host memory, so that Camera::Copy writes the frame straight into
+      /// it. The memory is not copied.
+      /// \param[in] _width Image width in pixels
+      /// \param[in] _height Image height in pixels
+      /// \param[in] _format Image pixel format
+      /// \param[in] _data Memory holding at least RowPitch() * Height()
+      /// bytes
+      /// \param[in] _deleter Called with _data once the image and its
+      /// copies are destroyed, null if the caller frees the memory itself
+      /// after that
+      /// \param[in] _rowPitch Bytes from the start of a row to the start of
+      /// the next one, 0 for rows without padding
+      public: Image(unsigned int _width, unsigned int _height,
+                  PixelFormat _format, void *_data,
+                  std::function<void(void *)> _deleter,
+                  unsigned int _rowPitch = 0u);
+
+      /// \brief Copy constructor. The buffer is shared, not copied.
+      /// \param[in] _image Image to copy
+      public: Image(const Image &_image) = default;
+
+      /// \brief Move constructor. The buffer is handed over without
+      /// touching its reference count.
+      /// \param[in] _image Image to move
+      public: Image(Image &&_image) noexcept = default;
+
       /// \brief Destructor
       public: ~Image();
 
+      /// \brief Copy assignment. The buffer is shared, not copied.
+      /// \param[in] _image Image to copy
+      /// \return This image
+      public: Image &operator=(const Image &_image) = default;
+
+      /// \brief Move assignment. The buffer is handed over without
+      /// touching its reference count.
+      /// \param[in] _image Image to move
+      /// \return This image
+      public: Image &operator=(Image &&_image) noexcept = default;
+
       /// \brief Get image width in pixels
       /// \return The image width in pixels
       public: unsigned int Width() const;
@@ -67,10 +120,15 @@ namespace ignition
       /// \return The image channel depth
       public: unsigned int Depth() const;
 
-      /// \brief Get image channel depth
-      /// \return The image channel depth
+      /// \brief Get the size of the pixel data, without row padding
+      /// \return Width() * Height() pixels, in bytes
       public: unsigned int MemorySize() const;
 
+      /// \brief Get the distance between the starts of consecutive rows
+      /// \return Row pitch in bytes, the size of a row unless the buffer
+      /// has padding between rows
+      public: unsigned int RowPitch() const;
+
       /// \brief Get a const pointer to image data
       /// \return The const pointer to image data
       public: const void *Data() const;
@@ -100,6 +158,9 @@ namespace ignition
       /// \brief Image pixel format
       private: PixelFormat format = PF_UNKNOWN;
 
+      /// \brief Row pitch in bytes, 0 for rows without padding
+      private: unsigned int rowPitch = 0;
+
       IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
       /// \brief Pointer to the image data
       private: DataPtr data = nullptr;
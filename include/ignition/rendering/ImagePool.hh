@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_IMAGEPOOL_HH_
+#define IGNITION_RENDERING_IMAGEPOOL_HH_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/PixelFormat.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declarations
+    class ImagePoolPrivate;
+
+    /// \class ImagePool ImagePool.hh ignition/rendering/ImagePool.hh
+    /// \brief Recycles the buffers of images. Images created by the pool
+    /// hand their buffer back to the pool when the last copy of the image
+    /// is destroyed, so that capturing images at a high rate does not
+    /// allocate a new buffer for every frame. Buffers still in use when the
+    /// pool is destroyed are freed when they are released.
+    ///
+    /// By default buffers are allocated with new[]. A custom allocator can
+    /// be set, e.g. one that returns page-locked memory for faster
+    /// transfers with GPU APIs such as CUDA.
+    ///
+    /// This class is thread safe, images can be released on any thread.
+    /// \sa Camera::SetImagePool
+    class IGNITION_RENDERING_VISIBLE ImagePool
+    {
+      /// \brief Function that allocates a buffer of the given size in bytes
+      public: using AllocateFunction = std::function<void *(std::size_t)>;
+
+      /// \brief Function that frees a buffer returned by the matching
+      /// AllocateFunction, given its size in bytes
+      public: using DeallocateFunction =
+          std::function<void(void *, std::size_t)>;
+
+      /// \brief Constructor
+      /// \param[in] _maxFreeBuffers Maximum number of unused buffers kept
+      /// for reuse, see SetMaxFreeBuffers
+      public: explicit ImagePool(unsigned int _maxFreeBuffers = 4u);
+
+      /// \brief Destructor
+      public: ~ImagePool();
+
+      /// \brief Create an image that uses a recycled buffer if one of a
+      /// suitable size is available. The content of the image is undefined.
+      /// \param[in] _width Image width in pixels
+      /// \param[in] _height Image height in pixels
+      /// \param[in] _format Image pixel format
+      /// \return New image
+      public: Image CreateImage(unsigned int _width, unsigned int _height,
+                  PixelFormat _format);
+
+      /// \brief Set the functions used to allocate and free buffers.
+      /// Unused buffers made by the previous allocator are freed, buffers
+      /// in use are freed by it when they are released.
+      /// \param[in] _allocate Allocation function, must not return null
+      /// \param[in] _deallocate Function freeing the allocated buffers
+      public: void SetAllocator(const AllocateFunction &_allocate,
+                  const DeallocateFunction &_deallocate);
+
+      /// \brief Set the maximum number of unused buffers kept for reuse.
+      /// Released buffers beyond this count are freed.
+      /// \param[in] _count Maximum number of unused buffers
+      public: void SetMaxFreeBuffers(unsigned int _count);
+
+      /// \brief Get the maximum number of unused buffers kept for reuse
+      /// \return Maximum number of unused buffers
+      public: unsigned int MaxFreeBuffers() const;
+
+      /// \brief Get the number of unused buffers currently kept for reuse
+      /// \return Number of unused buffers
+      public: unsigned int FreeBufferCount() const;
+
+      /// \brief Get the number of buffers allocated so far. This is a
+      /// measure of how well buffers are being recycled.
+      /// \return Number of allocations
+      public: unsigned int AllocationCount() const;
+
+      /// \brief Free all unused buffers
+      public: void Clear();
+
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      /// \brief Private data pointer. Shared with the buffers handed out so
+      /// they can find their way back after the pool is destroyed.
+      private: std::shared_ptr<ImagePoolPrivate> dataPtr;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_INSTANCEDVISUAL_HH_
+#define IGNITION_RENDERING_INSTANCEDVISUAL_HH_
+
+#include <chrono>
+#include <string>
+
+#include <ignition/math/Color.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Visual.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \class InstancedVisual InstancedVisual.hh
+    /// ignition/rendering/InstancedVisual.hh
+    /// \brief A visual drawing many copies of the same mesh and material,
+    /// e.g. the shelves of a warehouse. The instances are lightweight: they
+    /// are not visuals of their own and only have a pose, scale and color
+    /// relative to the instanced visual. Render engines draw the instances
+    /// together with hardware instancing when supported, ogre2 also the
+    /// instances of different colors.
+    /// \sa Scene::CreateInstancedVisual
+    class IGNITION_RENDERING_VISIBLE InstancedVisual :
+      public virtual Visual
+    {
+      /// \brief Constructor
+      protected: InstancedVisual();
+
+      /// \brief Destructor
+      public: virtual ~InstancedVisual();
+
+      /// \brief Get the number of instances
+      /// \return Number of instances
+      public: virtual unsigned int InstanceCount() const = 0;
+
+      /// \brief Set the pose of an instance relative to this visual
+      /// \param[in] _index Index of the instance
+      /// \param[in] _pose Pose of the instance
+      public: virtual void SetInstancePose(unsigned int _index,
+                  const math::Pose3d &_pose) = 0;
+
+      /// \brief Get the pose of an instance relative to this visual
+      /// \param[in] _index Index of the instance
+      /// \return Pose of the instance, identity if the index is out of range
+      public: virtual math::Pose3d InstancePose(unsigned int _index) const = 0;
+
+      /// \brief Set the scale of an instance
+      /// \param[in] _index Index of the instance
+      /// \param[in] _scale Scale of the instance
+      public: virtual void SetInstanceScale(unsigned int _index,
+                  const math::Vector3d &_scale) = 0;
+
+      /// \brief Get the scale of an instance
+      /// \param[in] _index Index of the instance
+      /// \return Scale of the instance, one if the index is out of range
+      public: virtual math::Vector3d InstanceScale(
+                  unsigned int _index) const = 0;
+
+      /// \brief Set the diffuse color of an instance. Instances default to
+      /// the diffuse color of the material of the instanced visual. Has no
+      /// effect if the instanced visual was created without a material.
+      /// \param[in] _index Index of the instance
+      /// \param[in] _color Diffuse color of the instance
+      public: virtual void SetInstanceColor(unsigned int _index,
+                  const math::Color &_color) = 0;
+
+      /// \brief Get the diffuse color of an instance
+      /// \param[in] _index Index of the instance
+      /// \return Diffuse color of the instance, white if the index is out
+      /// of range
+      public: virtual math::Color InstanceColor(unsigned int _index) const = 0;
+
+      /// \brief Set whether an instance is drawn
+      /// \param[in] _index Index of the instance
+      /// \param[in] _visible True to draw the instance
+      public: virtual void SetInstanceVisible(unsigned int _index,
+                  bool _visible) = 0;
+
+      /// \brief Get whether an instance is drawn
+      /// \param[in] _index Index of the instance
+      /// \return True if the instance is drawn
+      public: virtual bool InstanceVisible(unsigned int _index) const = 0;
+
+      /// \brief Play a skeleton animation of the mesh on an instance, e.g.
+      /// for a crowd of pedestrians. Each animation is evaluated at
+      /// AnimationPhaseCount times spread evenly over its length, and the
+      /// instances take the pose of the time closest to their own, so the
+      /// cost of evaluating the animations does not grow with the number of
+      /// instances. Only the time offsets of the instances are rounded, the
+      /// instances still move smoothly.
+      /// \remarks Not all render engines support this. ogre2 does.
+      /// \param[in] _index Index of the instance
+      /// \param[in] _name Name of the animation, empty to stop animating the
+      /// instance
+      /// \param[in] _timeOffset Time the instance is ahead of the others in
+      /// the animation, so instances playing the same animation do not move
+      /// in lockstep
+      /// \sa UpdateAnimations
+      public: virtual void SetInstanceAnimation(unsigned int _index,
+                  const std::string &_name,
+                  std::chrono::steady_clock::duration _timeOffset =
+                  std::chrono::steady_clock::duration::zero()) = 0;
+
+      /// \brief Get the skeleton animation an instance plays
+      /// \param[in] _index Index of the instance
+      /// \return Name of the animation, empty if none
+      public: virtual std::string InstanceAnimation(
+                  unsigned int _index) const = 0;
+
+      /// \brief Get the time offset of an instance in its animation
+      /// \param[in] _index Index of the instance
+      /// \return Time offset of the instance
+      public: virtual std::chrono::steady_clock::duration
+                  InstanceAnimationTimeOffset(unsigned int _index) const = 0;
+
+      /// \brief Set the number of times each animation is evaluated at.
+      /// More times round the time offsets of the instances less. The
+      /// default is 16.
+      /// \param[in] _count Number of times, at least 1
+      public: virtual void SetAnimationPhaseCount(unsigned int _count) = 0;
+
+      /// \brief Get the number of times each animation is evaluated at
+      /// \return Number of times
+      public: virtual unsigned int AnimationPhaseCount() const = 0;
+
+      /// \brief Set the time of the animations of the instances. The poses
+      /// are updated by the next PreRender call.
+      /// \param[in] _time Time since the start of the animations
+      public: virtual void UpdateAnimations(
+                  std::chrono::steady_clock::duration _time) = 0;
+    };
+    }
+  }
+}
+#endif
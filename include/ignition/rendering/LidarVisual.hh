@@ -76,6 +76,19 @@ namespace ignition
       public: virtual void SetPoints(const std::vector<double> &_points,
                         const std::vector<ignition::math::Color> &_colors) = 0;
 
+      /// \brief Set lidar points to be visualised directly from the range
+      /// data of a GpuRays frame, e.g. the buffer passed to a
+      /// GpuRays::ConnectNewGpuRaysFrame callback. The buffer must hold
+      /// VerticalRayCount() * HorizontalRayCount() samples of _channelCount
+      /// floats each, of which the first one is the range. The data is copied
+      /// so the buffer does not need to outlive this call.
+      /// \param[in] _ranges Range data of the lidar scan
+      /// \param[in] _channelCount Number of floats per sample
+      /// \remarks Not all rendering engines support uploading the ranges
+      /// without conversion. ogre2 does.
+      public: virtual void SetRanges(const float *_ranges,
+                  unsigned int _channelCount = 1u) = 0;
+
       /// \brief Set minimum vertical angle
       /// \param[in] _minVerticalAngle Minimum vertical angle
       public: virtual void SetMinVerticalAngle(
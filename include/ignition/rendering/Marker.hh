@@ -17,6 +17,9 @@
 #ifndef IGNITION_RENDERING_MARKER_HH_
 #define IGNITION_RENDERING_MARKER_HH_
 
+#include <cstddef>
+#include <cstdint>
+
 #include <ignition/common/Time.hh>
 #include <ignition/math/Color.hh>
 #include <ignition/math/Vector3.hh>
@@ -141,6 +144,17 @@ namespace ignition
       /// \param[in] _value The new positional vector of the point
       public: virtual void SetPoint(unsigned int _index,
                   const ignition::math::Vector3d &_value) = 0;
+
+      /// \brief Replace all points of the marker at once. This is much
+      /// faster than adding large point clouds one point at a time.
+      /// \param[in] _xyz Positions of the points, three floats per point
+      /// \param[in] _rgba Colors of the points, four bytes per point, may be
+      /// null to make all points white
+      /// \param[in] _count Number of points
+      /// \remarks ogre2 copies the positions and uploads them in a single
+      /// update, without going through per point ignition::math types.
+      public: virtual void SetPoints(const float *_xyz, const uint8_t *_rgba,
+                  std::size_t _count) = 0;
     };
     }
   }
@@ -102,7 +102,10 @@ namespace ignition
       public: virtual void SetDiffuse(const double _r, const double _g,
                   const double _b, const double _a = 1.0) = 0;
 
-      /// \brief Set the diffuse color
+      /// \brief Set the diffuse color. Changing only the red, green and
+      /// blue values is cheap enough to animate the color every frame,
+      /// while changing the alpha value may change the transparency mode
+      /// and reconfigure the material.
       /// \param[in] _color New diffuse color
       public: virtual void SetDiffuse(const math::Color &_color) = 0;
 
@@ -134,7 +137,8 @@ namespace ignition
       public: virtual void SetEmissive(const double _r, const double _g,
                   const double _b, const double _a = 1.0) = 0;
 
-      /// \brief Set the emissive color
+      /// \brief Set the emissive color. It is cheap enough to animate
+      /// every frame, e.g. to highlight objects.
       /// \param[in] _color New emissive color
       public: virtual void SetEmissive(const math::Color &_color) = 0;
 
@@ -385,7 +389,13 @@ namespace ignition
       /// \return editable parameters
       public: virtual ShaderParamsPtr VertexShaderParams() = 0;
 
-      /// \brief Set the vertex shader
+      /// \brief Set the vertex shader. A vertex shader that deforms the
+      /// geometry, e.g. animated waves, deforms it for the sensors too:
+      /// gpu rays, depth, thermal, segmentation and bounding box cameras
+      /// draw the geometry with their own fragment shaders but keep this
+      /// vertex shader and its current parameters. Thermal heat signature
+      /// textures are the exception, they are mapped onto the undeformed
+      /// geometry.
       /// \param[in] _path path to a file containing a glsl shader
       public: virtual void SetVertexShader(const std::string &_path) = 0;
 
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_MEMORYSTATS_HH_
+#define IGNITION_RENDERING_MEMORYSTATS_HH_
+
+#include <cstdint>
+
+#include "ignition/rendering/config.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Memory held by render engine resources, in bytes, broken
+    /// down by kind of resource. Sizes are computed from the resource
+    /// descriptions, e.g. texture dimensions and formats, so they do not
+    /// include driver overhead, alignment or fragmentation.
+    /// \sa Scene::MemoryStats, RenderEngine::MemoryStats
+    struct MemoryStats
+    {
+      /// \brief Textures loaded from images or created by materials
+      uint64_t textureBytes = 0u;
+
+      /// \brief Textures rendered to, including depth buffers and the
+      /// intermediate targets of compositors, except shadow maps
+      uint64_t renderTargetBytes = 0u;
+
+      /// \brief Shadow maps and shadow atlases
+      uint64_t shadowMapBytes = 0u;
+
+      /// \brief Vertex buffers of meshes
+      uint64_t vertexBufferBytes = 0u;
+
+      /// \brief Index buffers of meshes
+      uint64_t indexBufferBytes = 0u;
+
+      /// \brief Staging buffers used to upload and read back data
+      uint64_t stagingBufferBytes = 0u;
+
+      /// \brief Number of textures, render targets and shadow maps
+      unsigned int textureCount = 0u;
+
+      /// \brief Number of meshes
+      unsigned int meshCount = 0u;
+
+      /// \brief Get the sum of all kinds of memory
+      /// \return Total bytes
+      uint64_t TotalBytes() const
+      {
+        return this->textureBytes + this->renderTargetBytes +
+            this->shadowMapBytes + this->vertexBufferBytes +
+            this->indexBufferBytes + this->stagingBufferBytes;
+      }
+
+      /// \brief Add the memory of another set of resources
+      /// \param[in] _other Memory to add
+      /// \return Reference to this
+      MemoryStats &operator+=(const MemoryStats &_other)
+      {
+        this->textureBytes += _other.textureBytes;
+        this->renderTargetBytes += _other.renderTargetBytes;
+        this->shadowMapBytes += _other.shadowMapBytes;
+        this->vertexBufferBytes += _other.vertexBufferBytes;
+        this->indexBufferBytes += _other.indexBufferBytes;
+        this->stagingBufferBytes += _other.stagingBufferBytes;
+        this->textureCount += _other.textureCount;
+        this->meshCount += _other.meshCount;
+        return *this;
+      }
+    };
+    }
+  }
+}
+#endif
@@ -20,6 +20,7 @@
 #include <map>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <ignition/math/Matrix4.hh>
 #include "ignition/rendering/config.hh"
 #include "ignition/rendering/Geometry.hh"
@@ -95,6 +96,47 @@ namespace ignition
       public: virtual void UpdateSkeletonAnimation(
           std::chrono::steady_clock::duration _time) = 0;
 
+      /// \brief Get the names of the skeleton nodes in the order expected
+      /// by SetSkeletonBoneTransforms
+      /// \return Names of the skeleton nodes, empty if the mesh has no
+      /// skeleton
+      public: virtual std::vector<std::string> SkeletonBoneNames() const = 0;
+
+      /// \brief Set the local transforms of the skeleton nodes by index.
+      /// This is equivalent to SetSkeletonLocalTransforms with all the
+      /// nodes, but avoids looking up every node by name, which adds up
+      /// when many animated meshes are updated every frame.
+      /// \param[in] _tfs Local transformations of the skeleton nodes, in
+      /// the order of SkeletonBoneNames. Extra transforms are ignored.
+      public: virtual void SetSkeletonBoneTransforms(
+            const std::vector<math::Matrix4d> &_tfs) = 0;
+
+      /// \brief Make this mesh use the skeleton of another mesh, so that
+      /// the skeleton animation is evaluated once for both meshes. Both
+      /// meshes must have the same skeleton. Animations and transforms set
+      /// on either mesh then apply to both.
+      /// \param[in] _mesh Mesh to share the skeleton of, null to give this
+      /// mesh a skeleton of its own again
+      /// \return True if the skeleton is shared, or unshared for null
+      public: virtual bool ShareSkeleton(MeshPtr _mesh) = 0;
+
+      /// \brief Replace the positions and normals of the mesh's vertices
+      /// in place, e.g. for a cloth or soft body simulated on the CPU. The
+      /// vertices are written to the existing GPU buffers, so updating a
+      /// mesh every frame does not recreate it. The number and order of the
+      /// vertices, the indices and the texture coordinates stay the same.
+      /// Meshes with a skeleton can not be updated in place.
+      /// \param[in] _positions Positions of all the vertices, 3 floats per
+      /// vertex, in the order of the submeshes of the mesh descriptor
+      /// \param[in] _normals Normals of all the vertices in the same layout
+      /// as the positions, null to keep the current normals
+      /// \param[in] _vertexCount Number of vertices, which must match the
+      /// number of vertices of the mesh
+      /// \return True if the vertices were updated, false if the vertex
+      /// count does not match or the render engine does not support it
+      public: virtual bool UpdateVertices(const float *_positions,
+                  const float *_normals, unsigned int _vertexCount) = 0;
+
       /// \brief Get the sub-mesh count
       /// \return The sub-mesh count
       public: virtual unsigned int SubMeshCount() const = 0;
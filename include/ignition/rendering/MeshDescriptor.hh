@@ -57,7 +57,8 @@ namespace ignition
 
       /// \brief Ensures both the meshName and mesh member variables have been
       /// assigned. If mesh is not null, it will be used to override the value
-      /// of meshName.
+      /// of meshName. This can be called from any thread, the lookups in
+      /// the common::MeshManager are serialized.
       public: void Load();
 
       IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
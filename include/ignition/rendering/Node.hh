@@ -337,6 +337,22 @@ namespace ignition
       /// \param[in] _key Unique key
       /// \return True if node has custom data with the specified key
       public: virtual bool HasUserData(const std::string &_key) const = 0;
+
+      /// \brief Mark the node as changed so that it is updated by the next
+      /// Scene::PreRender call. Scene::PreRender skips the subtrees that
+      /// did not change since the last call and only contain nodes with
+      /// nothing to update unless they change, e.g. visuals with meshes
+      /// using materials without custom shaders. Changes made through the
+      /// node, such as setting its pose, material or geometries, mark it
+      /// automatically. This only needs to be called after changing state
+      /// shared with other objects, e.g. adding custom shaders to a
+      /// material already assigned to a visual.
+      public: virtual void MarkPreRenderDirty() = 0;
+
+      /// \brief Get whether the node or one of its descendants will be
+      /// updated by the next Scene::PreRender call
+      /// \return True if the node will be updated
+      public: virtual bool PreRenderDirty() const = 0;
     };
     }
   }
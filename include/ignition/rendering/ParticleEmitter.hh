@@ -256,6 +256,24 @@ namespace ignition
       /// ratio will only be set to _ratio if _ratio > 0.
       /// \sa ParticleScatterRatio
       public: virtual void SetParticleScatterRatio(float _ratio) = 0;
+
+      /// \brief Simulate the particles on the GPU. Each particle is emitted,
+      /// moved, colored and scaled by a shader from its index and the time
+      /// elapsed since emission started, so large numbers of particles are
+      /// rendered without any per particle work on the CPU, and changes to
+      /// the emitter parameters take effect without recreating the particle
+      /// system. Unlike CPU particles, GPU particles are not depth sorted
+      /// and move along with the emitter. Changing the rate or lifetime
+      /// restarts the emission cycle of the particles in flight.
+      /// Not all render engines support this.
+      /// \param[in] _enabled True to simulate the particles on the GPU
+      /// \sa GpuSimulationEnabled
+      public: virtual void SetGpuSimulationEnabled(bool _enabled) = 0;
+
+      /// \brief Get whether the particles are simulated on the GPU
+      /// \return True if the particles are simulated on the GPU
+      /// \sa SetGpuSimulationEnabled
+      public: virtual bool GpuSimulationEnabled() const = 0;
     };
     }
   }
@@ -57,8 +57,17 @@ namespace ignition
       PF_L16          = 11,
       /// < RGBA, 1-byte per channel
       PF_R8G8B8A8     = 12,
+      // Float16 format one channel
+      PF_FLOAT16_R    = 13,
+      // Float16 format and RGB, 6 bytes per pixel. Render engines without
+      // 3 channel 16 bit textures pad them to 4 channels on the GPU and drop
+      // the padding when copying to an image
+      PF_FLOAT16_RGB  = 14,
+      // 16 bit unsigned integer format and RGB, 6 bytes per pixel. Padded on
+      // the GPU like PF_FLOAT16_RGB
+      PF_UINT16_RGB   = 15,
       /// < Number of pixel format types
-      PF_COUNT        = 13
+      PF_COUNT        = 16
     };
 
     /// \class PixelUtil PixelFormat.hh ignition/rendering/PixelFormat.hh
@@ -117,6 +126,52 @@ namespace ignition
       /// \return The specified PixelFormat enum value
       public: static PixelFormat Enum(const std::string &_name);
 
+      /// \brief Convert an image between two pixel formats. Besides copying
+      /// an image of the same format, this supports the conversions between
+      /// the 8 bit formats L8, R8G8B8, B8G8R8 and R8G8B8A8, except to L8.
+      /// The alpha channel is dropped or set to opaque as needed. The rows
+      /// of the destination are tightly packed.
+      /// \param[in] _src Source pixel data
+      /// \param[in] _srcFormat Pixel format of the source
+      /// \param[out] _dst Destination buffer, it must hold at least
+      /// MemorySize(_dstFormat, _width, _height) bytes
+      /// \param[in] _dstFormat Pixel format of the destination
+      /// \param[in] _width Image width in pixels
+      /// \param[in] _height Image height in pixels
+      /// \param[in] _srcPitch Size of a source row in bytes, 0 if the rows
+      /// of the source are tightly packed
+      /// \return True if the conversion is supported
+      public: static bool Convert(const unsigned char *_src,
+                  PixelFormat _srcFormat, unsigned char *_dst,
+                  PixelFormat _dstFormat, unsigned int _width,
+                  unsigned int _height, unsigned int _srcPitch = 0);
+
+      /// \brief Convert an 8 bit R8G8B8, B8G8R8 or R8G8B8A8 image to planar
+      /// YUV 4:2:0 (I420) with BT.601 limited range coefficients. The full
+      /// resolution Y plane is followed by the U and V planes, which have
+      /// half the width and height of the image. Each chroma sample is the
+      /// average of a 2x2 pixel block.
+      /// \param[in] _src Source pixel data
+      /// \param[in] _srcFormat Pixel format of the source
+      /// \param[out] _dst Destination buffer, it must hold at least
+      /// I420MemorySize(_width, _height) bytes
+      /// \param[in] _width Image width in pixels, must be even
+      /// \param[in] _height Image height in pixels, must be even
+      /// \param[in] _srcPitch Size of a source row in bytes, 0 if the rows
+      /// of the source are tightly packed
+      /// \return True if the conversion is supported
+      public: static bool ConvertToI420(const unsigned char *_src,
+                  PixelFormat _srcFormat, unsigned char *_dst,
+                  unsigned int _width, unsigned int _height,
+                  unsigned int _srcPitch = 0);
+
+      /// \brief Get the memory size in bytes of an I420 image
+      /// \param[in] _width Image width in pixels
+      /// \param[in] _height Image height in pixels
+      /// \return 3/2 times the number of pixels
+      public: static unsigned int I420MemorySize(unsigned int _width,
+                  unsigned int _height);
+
       /// \brief Array of human-readable names for each PixelFormat
       private: static const char *names[PF_COUNT];
 
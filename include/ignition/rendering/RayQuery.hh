@@ -17,7 +17,10 @@
 #ifndef IGNITION_RENDERING_RAYQUERY_HH_
 #define IGNITION_RENDERING_RAYQUERY_HH_
 
+#include <vector>
+
 #include <ignition/common/SuppressWarning.hh>
+#include <ignition/math/Line3.hh>
 #include <ignition/math/Vector3.hh>
 
 #include "ignition/rendering/config.hh"
@@ -91,6 +94,16 @@ namespace ignition
       /// \brief Compute intersections
       /// \return A vector of intersection results
       public: virtual RayQueryResult ClosestPoint() = 0;
+
+      /// \brief Compute the closest intersection of a batch of rays. The
+      /// first point of each line is the ray origin and the ray is cast
+      /// towards the second point. The origin and direction set on this
+      /// ray query are not modified.
+      /// \param[in] _rays Rays to cast
+      /// \return Closest intersection result of each ray, in the same order
+      /// as the input rays
+      public: virtual std::vector<RayQueryResult> ClosestPoints(
+                  const std::vector<math::Line3d> &_rays) = 0;
     };
     }
   }
@@ -20,6 +20,7 @@
 #include <map>
 #include <string>
 #include "ignition/rendering/config.hh"
+#include "ignition/rendering/MemoryStats.hh"
 #include "ignition/rendering/RenderTypes.hh"
 #include "ignition/rendering/Export.hh"
 
@@ -178,6 +179,26 @@ namespace ignition
 
       /// \brief Get the render pass system for this engine.
       public: virtual RenderPassSystemPtr RenderPassSystem() const = 0;
+
+      /// \brief Get the memory held by all resources of the engine. This
+      /// includes resources shared between scenes, and resources that are
+      /// not owned by any scene, which Scene::MemoryStats leaves out.
+      /// \return Memory in bytes per kind of resource
+      public: virtual rendering::MemoryStats MemoryStats() const = 0;
+
+      /// \brief Get the thread that owns this engine, if the engine was
+      /// loaded with the "renderThread" parameter. All calls into the
+      /// engine and its scenes must then be made from tasks posted to this
+      /// thread, except Scene::QueueCommand.
+      /// \return Render thread, or null if the engine is used from the
+      /// thread that loaded it
+      /// \sa RenderEngineManager::Engine
+      public: virtual RenderThreadPtr RenderThread() const = 0;
+
+      /// \brief Set the thread that owns this engine. This is called by
+      /// RenderEngineManager after loading the engine on the thread.
+      /// \param[in] _thread Render thread, or null to clear it
+      public: virtual void SetRenderThread(RenderThreadPtr _thread) = 0;
     };
     }
   }
@@ -17,6 +17,7 @@
 #ifndef IGNITION_RENDERING_RENDERENGINEMANAGER_HH_
 #define IGNITION_RENDERING_RENDERENGINEMANAGER_HH_
 
+#include <future>
 #include <list>
 #include <map>
 #include <memory>
@@ -75,6 +76,10 @@ namespace ignition
       /// \brief Get the render-engine with the given name. If the no
       /// render-engine is registered under the given name, NULL will be
       /// returned.
+      ///
+      /// If _params has a "renderThread" parameter set to "1" or "true"
+      /// and the engine is not loaded yet, the engine is loaded on a new
+      /// thread it then belongs to, see RenderEngine::RenderThread.
       /// \param[in] _name Name of the desired render-engine
       /// \param[in] _params Parameters to be passed to the render engine.
       /// \param[in] _path Another search path for rendering engine plugin.
@@ -93,6 +98,25 @@ namespace ignition
                   const std::map<std::string, std::string> &_params = {},
                   const std::string &_path = "");
 
+      /// \brief Load the plugin of a render-engine on a background thread,
+      /// so that the application can do other setup meanwhile. The plugin
+      /// library is looked up and loaded but the engine is not initialized,
+      /// since graphics contexts are bound to the thread that creates them:
+      /// a later call to Engine initializes it on the calling thread,
+      /// waiting for the preload to finish if needed. If _params has a
+      /// "renderThread" parameter set to "1" or "true", the engine is also
+      /// initialized, on its own render thread.
+      /// \param[in] _name Name of the desired render-engine
+      /// \param[in] _params Parameters to be passed to the render engine.
+      /// \param[in] _path Another search path for rendering engine plugin.
+      /// \return Future set to true once the engine is preloaded, false if
+      /// it couldn't be loaded. The preload must be complete before the
+      /// manager is destroyed.
+      /// \sa Engine
+      public: std::shared_future<bool> PreloadEngine(const std::string &_name,
+                  const std::map<std::string, std::string> &_params = {},
+                  const std::string &_path = "");
+
       /// \brief Unload the render-engine with the given name. If the no
       /// render-engine is registered under the given name, false will be
       /// returned.
@@ -135,6 +159,23 @@ namespace ignition
       /// \param[in] _paths The list of the plugin paths
       public: void SetPluginPaths(const std::list<std::string> &_paths);
 
+      /// \brief Set the file of the plugin manifest. The manifest caches
+      /// the paths the render-engine plugin libraries were found at, so
+      /// that they are not searched for in the plugin paths again by later
+      /// runs, which is slow on network file systems. The manifest is read
+      /// when set and updated when a plugin is found in the plugin paths.
+      /// A path is only reused when searching the same plugin paths, and
+      /// cached paths that no longer exist are searched for again. The
+      /// manifest defaults to the IGN_RENDERING_PLUGIN_MANIFEST environment
+      /// variable, none if it's not set. The paths found are cached in
+      /// memory for the life of the process either way.
+      /// \param[in] _file Path to the manifest file, empty to disable it
+      public: void SetPluginManifest(const std::string &_file);
+
+      /// \brief Get the file of the plugin manifest
+      /// \return Path to the manifest file, empty if disabled
+      public: std::string PluginManifest() const;
+
       IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
       /// \brief private implementation details
       private: std::unique_ptr<RenderEngineManagerPrivate> dataPtr;
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_RENDERSERVER_HH_
+#define IGNITION_RENDERING_RENDERSERVER_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/RenderTypes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declarations
+    class RenderServerPrivate;
+
+    /// \class RenderServer RenderServer.hh
+    /// ignition/rendering/RenderServer.hh
+    /// \brief Applies the scene changes encoded by SceneDelta to a local
+    /// scene and renders the cameras they ask for, e.g. on a GPU node
+    /// serving simulations that run on nodes without one. Each client gets
+    /// a server of its own, with a scene of its own.
+    ///
+    /// The frames of all cameras of a render command are rendered with one
+    /// Scene::RenderSensors call, i.e. one scene update and one GPU flush,
+    /// and returned in a single reply, which ParseReply decodes on the
+    /// client side.
+    class IGNITION_RENDERING_VISIBLE RenderServer
+    {
+      /// \brief A frame of a reply
+      public: struct Frame
+      {
+        /// \brief Id of the camera that rendered the frame
+        uint32_t cameraId = 0u;
+
+        /// \brief Rendered image
+        Image image;
+      };
+
+      /// \brief Constructor
+      /// \param[in] _scene Scene the changes are applied to. It must
+      /// outlive the server.
+      public: explicit RenderServer(Scene *_scene);
+
+      /// \brief Destructor. Destroys the nodes created by the server.
+      public: ~RenderServer();
+
+      /// \brief Apply encoded scene changes and render the cameras they ask
+      /// for. Commands are applied in order, so the ones before an invalid
+      /// command are kept.
+      /// \param[in] _data Data of a SceneDelta
+      /// \param[in] _size Size of the data in bytes
+      /// \param[out] _reply Encoded frames of the cameras rendered, empty
+      /// if no camera was rendered
+      /// \return False if the data is malformed or refers to unknown nodes
+      public: bool Apply(const uint8_t *_data, size_t _size,
+                  std::vector<uint8_t> &_reply);
+
+      /// \brief Get the number of nodes created by the server
+      /// \return Number of nodes
+      public: unsigned int NodeCount() const;
+
+      /// \brief Decode a reply of Apply
+      /// \param[in] _data Reply data
+      /// \param[in] _size Size of the reply in bytes
+      /// \param[out] _frames Frames of the reply, in the order the cameras
+      /// were listed in the render command
+      /// \return False if the reply is malformed
+      public: static bool ParseReply(const uint8_t *_data, size_t _size,
+                  std::vector<Frame> &_frames);
+
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      /// \brief Private data pointer
+      private: std::unique_ptr<RenderServerPrivate> dataPtr;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+    }
+  }
+}
+#endif
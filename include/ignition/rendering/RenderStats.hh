@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_RENDERSTATS_HH_
+#define IGNITION_RENDERING_RENDERSTATS_HH_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ignition/rendering/config.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief GPU time spent in one kind of render pass, e.g. the shadow
+    /// passes or the scene passes of a sensor. Passes of the same kind that
+    /// run more than once per frame are summed up.
+    struct RenderPassStats
+    {
+      /// \brief Name of the pass, e.g. "shadow", "scene", "quad <material>"
+      std::string name;
+
+      /// \brief GPU time of the last measured frame in milliseconds
+      double lastMs = 0.0;
+
+      /// \brief Rolling average of the GPU time in milliseconds
+      double averageMs = 0.0;
+    };
+
+    /// \brief GPU timings of a sensor or a scene.
+    /// \sa Sensor::GpuStats, Scene::GpuStats
+    struct RenderStats
+    {
+      /// \brief Total GPU time of the last measured frame in milliseconds
+      double lastMs = 0.0;
+
+      /// \brief Rolling average of the total GPU time in milliseconds
+      double averageMs = 0.0;
+
+      /// \brief Number of frames the timings were measured over
+      unsigned int frameCount = 0u;
+
+      /// \brief Timings of each kind of pass, in execution order
+      std::vector<RenderPassStats> passes;
+    };
+
+    /// \brief Draw counts of the last frame rendered by a sensor, as
+    /// reported by the render system, e.g. to tell whether a sensor is slow
+    /// because of the number of draw calls or the number of triangles.
+    /// Render engines that do not report a count leave it at 0.
+    /// \sa Sensor::DrawStats
+    struct DrawStats
+    {
+      /// \brief Number of draw calls issued to the graphics API. A draw
+      /// call can draw several batches, e.g. with indirect drawing.
+      uint64_t drawCallCount = 0u;
+
+      /// \brief Number of instanced batches drawn
+      uint64_t batchCount = 0u;
+
+      /// \brief Number of instances drawn by the batches
+      uint64_t instanceCount = 0u;
+
+      /// \brief Number of triangles drawn
+      uint64_t triangleCount = 0u;
+
+      /// \brief Number of vertices drawn
+      uint64_t vertexCount = 0u;
+
+      /// \brief Number of compositor passes, or render target updates for
+      /// render engines without compositor, run for the frame
+      unsigned int passCount = 0u;
+
+      /// \brief Number of frames counted so far
+      unsigned int frameCount = 0u;
+    };
+
+    /// \brief Timestamps of a sensor frame on its way through the render
+    /// engine, from the submission of its render commands to the return of
+    /// the callbacks it was delivered to, plus latency statistics over all
+    /// delivered frames. Timestamps use the steady clock.
+    /// \sa Sensor::FrameTimings
+    struct FrameTimings
+    {
+      /// \brief Clock of the timestamps
+      using Clock = std::chrono::steady_clock;
+
+      /// \brief Sequence number of the frame, starting at 1. 0 if no frame
+      /// has been delivered yet.
+      uint64_t frameId = 0u;
+
+      /// \brief Time the sensor started submitting render commands
+      Clock::time_point submitTime;
+
+      /// \brief Time the sensor found the GPU done with the frame. Render
+      /// engines that read back synchronously wait for the GPU and the
+      /// download together, in which case this is the end of the download.
+      Clock::time_point gpuCompleteTime;
+
+      /// \brief Time the frame data was converted into the sensor output,
+      /// just before the callbacks were called
+      Clock::time_point readbackCompleteTime;
+
+      /// \brief Time the last callback returned
+      Clock::time_point callbackCompleteTime;
+
+      /// \brief True if the frame was not rendered but reprojected from the
+      /// last rendered frame with the motion of the camera since then
+      /// \sa Camera::SetReprojectionInterval
+      bool reprojected = false;
+
+      /// \brief Number of frames delivered so far
+      unsigned int frameCount = 0u;
+
+      /// \brief Rolling average of the latency from submit to callback
+      /// complete in milliseconds
+      double averageLatencyMs = 0.0;
+
+      /// \brief Largest latency from submit to callback complete seen so far
+      /// in milliseconds
+      double maxLatencyMs = 0.0;
+
+      /// \brief Get the latency from submit to callback complete of this
+      /// frame
+      /// \return Latency in milliseconds
+      double LatencyMs() const
+      {
+        return std::chrono::duration<double, std::milli>(
+            this->callbackCompleteTime - this->submitTime).count();
+      }
+    };
+    }
+  }
+}
+#endif
@@ -17,6 +17,7 @@
 #ifndef IGNITION_RENDERING_RENDERTARGET_HH_
 #define IGNITION_RENDERING_RENDERTARGET_HH_
 
+#include <functional>
 #include <string>
 
 #include <ignition/math/Color.hh>
@@ -72,6 +73,40 @@ namespace ignition
       /// \param[out] _image Image to which output will be written
       public: virtual void Copy(Image &_image) const = 0;
 
+      /// \brief Write rendered image to given Image without waiting for the
+      /// GPU to finish rendering it. Same as Copy, except that the data is
+      /// written later: the copy is queued and the callback is called once
+      /// the image has been written, from a later call to Render,
+      /// CopyAsync or WaitForAsyncCopies on this render target. Copies
+      /// complete in the order they were queued. The image must stay valid
+      /// until its callback is called. Render targets that cannot copy
+      /// asynchronously copy right away and call the callback before
+      /// returning.
+      /// \param[out] _image Image to which output will be written
+      /// \param[in] _callback Function called once the image is written
+      /// \return False if the image could not be queued, e.g. because it is
+      /// not of the correct size. The callback is not called in that case.
+      /// \sa WaitForAsyncCopies
+      public: virtual bool CopyAsync(Image &_image,
+                  std::function<void()> _callback) = 0;
+
+      /// \brief Block until all the copies queued by CopyAsync are written,
+      /// calling their callbacks
+      /// \sa CopyAsync
+      public: virtual void WaitForAsyncCopies() = 0;
+
+      /// \brief Write the rendered image to the given image as planar YUV
+      /// 4:2:0 (I420), e.g. for video encoders, see
+      /// PixelUtil::ConvertToI420. The image must be a PF_L8 image as wide
+      /// as the render target and 3/2 as tall, holding the Y plane followed
+      /// by the U and V planes. The render target width and height must be
+      /// even.
+      /// \remarks Ogre2 converts the image on the GPU, so 2.7 times less
+      /// data is read back than with an RGBA8 Copy.
+      /// \param[out] _image Image to which output will be written
+      /// \return False if the image is not of the correct size or format
+      public: virtual bool CopyI420(Image &_image) = 0;
+
       /// \brief Get the background color of the render target.
       /// This should be the same as the scene background color.
       /// \return Render target background color.
@@ -109,6 +144,12 @@ namespace ignition
       /// \brief Returns the OpenGL texture Id. A valid Id is returned only
       // if this is an OpenGL render texture
       public: virtual unsigned int GLId() const = 0;
+
+      /// \brief Gets the Metal texture id. A valid id is written only if
+      /// this is a Metal render texture.
+      /// \param[out] _textureIdPtr Pointer to an id<MTLTexture> the id is
+      /// written to. It is left unchanged if there is no Metal texture.
+      public: virtual void MetalId(void *_textureIdPtr) const = 0;
     };
 
     /* \class RenderWindow RenderWindow.hh \
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_RENDERTHREAD_HH_
+#define IGNITION_RENDERING_RENDERTHREAD_HH_
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declarations
+    class RenderThreadPrivate;
+
+    /// \class RenderThread RenderThread.hh
+    /// ignition/rendering/RenderThread.hh
+    /// \brief A thread that owns a render engine. Render engines are bound
+    /// to the thread that loaded them, since their graphics context is, so
+    /// all calls into the engine and its scenes must be made from that
+    /// thread. Tasks posted from other threads are run on the render thread
+    /// one at a time, in the order they were posted, and their results are
+    /// returned through futures.
+    ///
+    /// A render engine is run on its own thread by passing the
+    /// "renderThread" parameter with a value of "1" or "true" to
+    /// RenderEngineManager::Engine. The engine is then loaded on a new
+    /// thread, which is returned by RenderEngine::RenderThread. Scene
+    /// updates can be queued from any thread with Scene::QueueCommand and
+    /// are applied at the start of the next render, so a simulation thread
+    /// can step while the previous frame renders:
+    ///
+    /// \code
+    /// auto thread = engine->RenderThread();
+    /// scene->QueueCommand([=]() {visual->SetWorldPose(pose);});
+    /// std::future<void> frame = thread->Post([=]() {camera->Update();});
+    /// // ... step the simulation ...
+    /// frame.wait();
+    /// \endcode
+    ///
+    /// This class is thread safe.
+    class IGNITION_RENDERING_VISIBLE RenderThread
+    {
+      /// \brief Constructor. Starts the thread.
+      public: RenderThread();
+
+      /// \brief Destructor. Runs the tasks already posted, then joins the
+      /// thread.
+      public: ~RenderThread();
+
+      /// \brief Post a task to run on the render thread. If called from
+      /// the render thread, the task is run right away, so a task can wait
+      /// on the future of a task it posts without deadlocking.
+      /// \param[in] _task Function to run
+      /// \return Future holding the value returned or the exception thrown
+      /// by the task. If the thread was stopped, the future holds a
+      /// std::future_error with a broken_promise error code.
+      public: template <typename T>
+              std::future<typename std::result_of<T()>::type> Post(T _task)
+      {
+        using Result = typename std::result_of<T()>::type;
+        auto task = std::make_shared<std::packaged_task<Result()>>(
+            std::move(_task));
+        std::future<Result> result = task->get_future();
+        this->PostTask([task]() {(*task)();});
+        return result;
+      }
+
+      /// \brief Post a function to run on the render thread, without a
+      /// future to wait on. This is the non template version of Post.
+      /// \param[in] _task Function to run
+      /// \return False if the thread was stopped and the task discarded
+      public: bool PostTask(std::function<void()> _task);
+
+      /// \brief Run all tasks already posted, then stop the thread. Tasks
+      /// posted afterwards are discarded. Must not be called from the render
+      /// thread.
+      public: void Stop();
+
+      /// \brief Check if the thread is running and accepting tasks
+      /// \return True if the thread has not been stopped
+      public: bool IsRunning() const;
+
+      /// \brief Check if the calling thread is the render thread
+      /// \return True if called from a task run by this thread
+      public: bool IsRenderThread() const;
+
+      /// \brief Get the id of the render thread
+      /// \return Thread id
+      public: std::thread::id Id() const;
+
+      /// \brief Get the number of tasks posted and not run yet
+      /// \return Number of pending tasks
+      public: unsigned int PendingTaskCount() const;
+
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      /// \brief Private data pointer
+      private: std::unique_ptr<RenderThreadPrivate> dataPtr;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+    }
+  }
+}
+#endif
@@ -46,6 +46,7 @@ namespace ignition
     template <class T>
     using shared_ptr = std::shared_ptr<T>;
 
+    class AntiAliasingPass;
     class ArrowVisual;
     class AxisVisual;
     class BoundingBoxCamera;
@@ -55,6 +56,7 @@ namespace ignition
     class DepthCamera;
     class DirectionalLight;
     class DistortionPass;
+    class FrameRecorder;
     class GaussianNoisePass;
     class Geometry;
     class GizmoVisual;
@@ -62,7 +64,9 @@ namespace ignition
     class Grid;
     class Heightmap;
     class Image;
+    class ImagePool;
     class InertiaVisual;
+    class InstancedVisual;
     class Light;
     class LightVisual;
     class JointVisual;
@@ -81,17 +85,20 @@ namespace ignition
     class RenderPass;
     class RenderPassSystem;
     class RenderTarget;
+    class RenderThread;
     class RenderTexture;
     class RenderWindow;
     class Scene;
     class SegmentationCamera;
     class Sensor;
+    class SensorScheduler;
     class ShaderParams;
     class SpotLight;
     class SubMesh;
     class Text;
     class ThermalCamera;
     class Visual;
+    class WideAngleCamera;
     class WireBox;
 
     /// \typedef ArrowVisualPtr
@@ -122,6 +129,10 @@ namespace ignition
     /// \brief Shared pointer to Segmentation Camera
     typedef shared_ptr<SegmentationCamera> SegmentationCameraPtr;
 
+    /// \typedef WideAngleCameraPtr
+    /// \brief Shared pointer to WideAngleCamera
+    typedef shared_ptr<WideAngleCamera> WideAngleCameraPtr;
+
     /// \typedef GpuRaysPtr
     /// \brief Shared pointer to GpuRays
     typedef shared_ptr<GpuRays> GpuRaysPtr;
@@ -130,10 +141,18 @@ namespace ignition
     /// \brief Shared pointer to DirectionalLight
     typedef shared_ptr<DirectionalLight> DirectionalLightPtr;
 
+    /// \typedef AntiAliasingPassPtr
+    /// \brief Shared pointer to AntiAliasingPass
+    typedef shared_ptr<AntiAliasingPass> AntiAliasingPassPtr;
+
     /// \typedef DistortionPassPtr
     /// \brief Shared pointer to DistortionPass
     typedef shared_ptr<DistortionPass> DistortionPassPtr;
 
+    /// \typedef FrameRecorderPtr
+    /// \brief Shared pointer to FrameRecorder
+    typedef shared_ptr<FrameRecorder> FrameRecorderPtr;
+
     /// \typedef GaussianNoisePassPtr
     /// \brief Shared pointer to GaussianNoisePass
     typedef shared_ptr<GaussianNoisePass> GaussianNoisePassPtr;
@@ -166,6 +185,10 @@ namespace ignition
     /// \brief Shared pointer to Image
     typedef shared_ptr<Image> ImagePtr;
 
+    /// \typedef ImagePoolPtr
+    /// \brief Shared pointer to ImagePool
+    typedef shared_ptr<ImagePool> ImagePoolPtr;
+
     /// \typedef InertiaVisualPtr
     /// \def Shared pointer to InertiaVisual
     typedef shared_ptr<InertiaVisual> InertiaVisualPtr;
@@ -182,6 +205,10 @@ namespace ignition
     /// \brief Shared pointer to Light
     typedef shared_ptr<LightVisual> LightVisualPtr;
 
+    /// \typedef InstancedVisualPtr
+    /// \brief Shared pointer to InstancedVisual
+    typedef shared_ptr<InstancedVisual> InstancedVisualPtr;
+
     /// \typedef LidarVisualPtr
     /// \brief Shared pointer to LidarVisual
     typedef shared_ptr<LidarVisual> LidarVisualPtr;
@@ -234,6 +261,10 @@ namespace ignition
     /// \brief Shared pointer to RenderTarget
     typedef shared_ptr<RenderTarget> RenderTargetPtr;
 
+    /// \typedef RenderThreadPtr
+    /// \brief Shared pointer to RenderThread
+    typedef shared_ptr<RenderThread> RenderThreadPtr;
+
     /// \typedef RenderTexturePtr
     /// \brief Shared pointer to RenderTexture
     typedef shared_ptr<RenderTexture> RenderTexturePtr;
@@ -249,6 +280,10 @@ namespace ignition
     /// \brief Shared pointer to Sensor
     typedef shared_ptr<Sensor> SensorPtr;
 
+    /// \typedef SensorSchedulerPtr
+    /// \brief Shared pointer to SensorScheduler
+    typedef shared_ptr<SensorScheduler> SensorSchedulerPtr;
+
     /// \brief Shared pointer to ShaderParams
     typedef shared_ptr<ShaderParams> ShaderParamsPtr;
 
@@ -300,6 +335,10 @@ namespace ignition
     /// \brief Shared pointer to const Segmentation Camera
     typedef shared_ptr<const SegmentationCamera> ConstSegmentationCameraPtr;
 
+    /// \typedef const WideAngleCameraPtr
+    /// \brief Shared pointer to const WideAngleCamera
+    typedef shared_ptr<const WideAngleCamera> ConstWideAngleCameraPtr;
+
     /// \typedef const GpuRaysPtr
     /// \brief Shared pointer to const GpuRays
     typedef shared_ptr<const GpuRays> ConstGpuRaysPtr;
@@ -336,6 +375,10 @@ namespace ignition
     /// \brief Shared pointer to const Light
     typedef shared_ptr<const Light> ConstLightPtr;
 
+    /// \typedef const InstancedVisualPtr
+    /// \brief Shared pointer to const InstancedVisual
+    typedef shared_ptr<const InstancedVisual> ConstInstancedVisualPtr;
+
     /// \typedef const LidarVisualPtr
     /// \brief Shared pointer to const LidarVisual
     typedef shared_ptr<const LidarVisual> ConstLidarVisualPtr;
@@ -17,6 +17,7 @@
 #ifndef IGNITION_RENDERING_RENDERINGIFACE_HH_
 #define IGNITION_RENDERING_RENDERINGIFACE_HH_
 
+#include <future>
 #include <list>
 #include <map>
 #include <string>
@@ -133,6 +134,24 @@ namespace ignition
     IGNITION_RENDERING_VISIBLE
     void setPluginPaths(const std::list<std::string> &_paths);
 
+    /// \brief Set the file of the plugin manifest, which caches the paths
+    /// the render-engine plugin libraries were found at across runs.
+    /// \param[in] _file Path to the manifest file, empty to disable it
+    /// \sa RenderEngineManager::SetPluginManifest
+    IGNITION_RENDERING_VISIBLE
+    void setPluginManifest(const std::string &_file);
+
+    /// \brief Load the plugin of a render-engine on a background thread.
+    /// \param[in] _name Name of the desired render-engine
+    /// \param[in] _params Parameters to be passed to the render engine.
+    /// \param[in] _path Another search path for rendering engine plugin.
+    /// \return Future set to true once the engine is preloaded
+    /// \sa RenderEngineManager::PreloadEngine
+    IGNITION_RENDERING_VISIBLE
+    std::shared_future<bool> preloadEngine(const std::string &_name,
+        const std::map<std::string, std::string> &_params = {},
+        const std::string &_path = "");
+
     /// \brief Most applications will only have one rendering engine loaded
     /// at a time, and only one scene within that. This helper function gets
     /// the first scene that can be found in the first loaded rendering engine.
@@ -18,18 +18,24 @@
 #define IGNITION_RENDERING_SCENE_HH_
 
 #include <array>
+#include <functional>
 #include <string>
 #include <limits>
+#include <vector>
 
 #include <ignition/common/Material.hh>
 #include <ignition/common/Mesh.hh>
 #include <ignition/common/Time.hh>
 
+#include <ignition/math/AxisAlignedBox.hh>
 #include <ignition/math/Color.hh>
+#include <ignition/math/Pose3.hh>
 
 #include "ignition/rendering/config.hh"
 #include "ignition/rendering/HeightmapDescriptor.hh"
+#include "ignition/rendering/MemoryStats.hh"
 #include "ignition/rendering/MeshDescriptor.hh"
+#include "ignition/rendering/RenderStats.hh"
 #include "ignition/rendering/RenderTypes.hh"
 #include "ignition/rendering/Storage.hh"
 #include "ignition/rendering/Export.hh"
@@ -109,6 +115,52 @@ namespace ignition
       public: virtual VisualPtr VisualAt(const CameraPtr &_camera,
                   const math::Vector2i &_mousePos) = 0;
 
+      /// \brief Get the visuals whose world bounding box intersects a box,
+      /// e.g. to find what is near a robot. Only visuals attached to the
+      /// scene graph with a non empty bounding box are considered.
+      /// Since the bounding box of a visual includes its children, the
+      /// ancestors of a visual are returned along with it.
+      ///
+      /// The scene keeps a bounding volume hierarchy over the bounding
+      /// boxes of the visuals, built by the first query and brought up to
+      /// date by the following ones, so a query costs about the logarithm
+      /// of the number of visuals plus the number of visuals that changed
+      /// since the last one.
+      /// \remarks ogre2 only revisits the visuals whose bounding box
+      /// changed. Other engines recompute the bounding box of every visual
+      /// for each query.
+      /// \param[in] _box Box in world coordinates
+      /// \return Visuals intersecting the box, in no particular order
+      /// \sa AxisAlignedBoxTree
+      public: virtual std::vector<VisualPtr> VisualsInBox(
+                  const math::AxisAlignedBox &_box) = 0;
+
+      /// \brief Get the visuals whose world bounding box intersects a
+      /// sphere. See VisualsInBox for the visuals considered.
+      /// \param[in] _center Center of the sphere in world coordinates
+      /// \param[in] _radius Radius of the sphere
+      /// \return Visuals intersecting the sphere, in no particular order
+      public: virtual std::vector<VisualPtr> VisualsInSphere(
+                  const math::Vector3d &_center, double _radius) = 0;
+
+      /// \brief Get the visuals whose world bounding box intersects the
+      /// view frustum of a camera, between its near and far clip planes.
+      /// See VisualsInBox for the visuals considered. Like
+      /// math::Frustum::Contains, visuals close to the edges of the
+      /// frustum may be returned even if they are just outside of it.
+      /// \param[in] _camera Camera
+      /// \return Visuals intersecting the frustum, in no particular order
+      public: virtual std::vector<VisualPtr> VisualsInFrustum(
+                  const CameraPtr &_camera) = 0;
+
+      /// \brief Get the visuals whose world bounding box is closest to a
+      /// point. See VisualsInBox for the visuals considered.
+      /// \param[in] _point Point in world coordinates
+      /// \param[in] _count Maximum number of visuals to return
+      /// \return Closest visuals, sorted from the closest to the farthest
+      public: virtual std::vector<VisualPtr> NearestVisuals(
+                  const math::Vector3d &_point, unsigned int _count) = 0;
+
       /// \brief Get the scene ambient light color
       /// \return The scene ambient light color
       public: virtual math::Color AmbientLight() const = 0;
@@ -253,6 +305,17 @@ namespace ignition
       /// \brief Destroy all nodes manages by this scene.
       public: virtual void DestroyNodes() = 0;
 
+      /// \brief Set the local poses of many nodes at once. This is
+      /// equivalent to calling Node::SetLocalPose on each node, but avoids
+      /// the per-call overhead of looking up and updating every node
+      /// separately. Ids of nodes not managed by this scene are skipped.
+      /// \param[in] _ids IDs of the nodes to update
+      /// \param[in] _poses New local poses, in the same order as _ids
+      /// \return Number of nodes updated
+      public: virtual unsigned int SetLocalPoses(
+                  const std::vector<unsigned int> &_ids,
+                  const std::vector<math::Pose3d> &_poses) = 0;
+
       /// \brief Get the number of lights managed by this scene. Note these
       /// lights may not be directly or indirectly attached to the root light.
       /// \return The number of lights managed by this scene
@@ -737,6 +800,35 @@ namespace ignition
       public: virtual SegmentationCameraPtr CreateSegmentationCamera(
                   unsigned int _id, const std::string &_name) = 0;
 
+      /// \brief Create new wide angle camera. A unique ID and name will
+      /// automatically be assigned to the camera.
+      /// \return The created camera
+      public: virtual WideAngleCameraPtr CreateWideAngleCamera() = 0;
+
+      /// \brief Create new wide angle camera with the given ID.
+      /// A unique name will automatically be assigned to the camera.
+      /// If the given ID is already in use, NULL will be returned.
+      /// \param[in] _id ID of the new camera
+      /// \return The created camera
+      public: virtual WideAngleCameraPtr CreateWideAngleCamera(
+                  unsigned int _id) = 0;
+
+      /// \brief Create new wide angle camera with the given name.
+      /// A unique ID will automatically be assigned to the camera.
+      /// If the given name is already in use, NULL will be returned.
+      /// \param[in] _name Name of the new camera
+      /// \return The created camera
+      public: virtual WideAngleCameraPtr CreateWideAngleCamera(
+                  const std::string &_name) = 0;
+
+      /// \brief Create new wide angle camera with the given name and ID. If
+      /// either the given ID or name is already in use, will return NULL.
+      /// \param[in] _id ID of the new camera
+      /// \param[in] _name Name of the new camera
+      /// \return The created camera
+      public: virtual WideAngleCameraPtr CreateWideAngleCamera(
+                  unsigned int _id, const std::string &_name) = 0;
+
       /// \brief Create new gpu rays caster. A unique ID and name will
       /// automatically be assigned to the gpu rays caster.
       /// \return The created gpu rays caster
@@ -1085,6 +1177,22 @@ namespace ignition
       public: virtual LidarVisualPtr CreateLidarVisual(
                   unsigned int _id, const std::string &_name) = 0;
 
+      /// \brief Create a visual drawing many instances of the same mesh and
+      /// material, e.g. the shelves of a warehouse. Much cheaper than a
+      /// visual per copy: the instances are not visuals of their own and
+      /// render engines draw them with hardware instancing when supported.
+      /// A unique ID and name will automatically be assigned to the visual.
+      /// \param[in] _desc Descriptor of the mesh of the instances
+      /// \param[in] _material Material of the instances, changes to it apply
+      /// to all of them. Null to use the materials of the mesh, in which
+      /// case instance colors are not supported.
+      /// \param[in] _count Number of instances
+      /// \return The created instanced visual, null if not supported by the
+      /// render engine or if the mesh could not be loaded
+      public: virtual InstancedVisualPtr CreateInstancedVisual(
+                  const MeshDescriptor &_desc, MaterialPtr _material,
+                  unsigned int _count) = 0;
+
       /// \brief Create new heightmap geomerty. The rendering::Heightmap will be
       /// created from the given HeightmapDescriptor.
       /// \param[in] _desc Data about the heightmap
@@ -1278,11 +1386,203 @@ namespace ignition
       /// SetCameraPassCountPerGpuFlush
       public: virtual bool LegacyAutoGpuFlush() const = 0;
 
+      /// \brief Render a batch of sensors. This is equivalent to calling
+      /// Camera::Update on every camera sensor in _sensors, except that
+      /// all sensors are rendered first and their data is read back
+      /// afterwards. Sensors that are not cameras are ignored.
+      ///
+      /// This function calls Scene::PreRender and Scene::PostRender
+      /// (the latter only when LegacyAutoGpuFlush is false) so it must not
+      /// be called between a PreRender / PostRender pair.
+      /// \remarks ogre2 records the compositor workspaces of all sensors
+      /// and submits them to the GPU with a single flush, regardless of the
+      /// value set in SetCameraPassCountPerGpuFlush. Memory consumption
+      /// grows with the number of passes in the batch.
+      /// \param[in] _sensors Sensors to render
+      public: virtual void RenderSensors(
+                  const std::vector<SensorPtr> &_sensors) = 0;
+
+      /// \brief Compile the shaders needed by the current scene up front.
+      /// Every sensor of the scene is rendered once, so the shaders of
+      /// the materials, lights and shadows in their view are compiled for
+      /// each kind of sensor, instead of stalling their first update.
+      /// Call it after creating the scene and its sensors, and again after
+      /// adding new kinds of materials or sensors. The frames rendered are
+      /// delivered to the callbacks connected to the sensors like any
+      /// other frame. Like RenderSensors, it must not be called between a
+      /// PreRender / PostRender pair.
+      /// \remarks ogre2 also warms up the selection buffer used by
+      /// Camera::VisualAt, using the first camera of the scene.
+      public: virtual void WarmUp() = 0;
+
+      /// \brief Get the sensor scheduler of the scene, which renders the
+      /// sensors added to it at their own update rates with one
+      /// RenderSensors call per tick
+      /// \return Sensor scheduler of the scene
+      /// \sa SensorScheduler
+      public: virtual SensorSchedulerPtr Scheduler() = 0;
+
+      /// \brief Get the GPU time spent rendering all sensors of the scene.
+      /// Passes with the same name are summed up over the sensors.
+      /// \return GPU timings, empty if not available
+      /// \sa Sensor::GpuStats
+      public: virtual RenderStats GpuStats() const = 0;
+
+      /// \brief Set a GPU time budget for rendering the sensors of the
+      /// scene. When the GPU time of a frame exceeds the budget, the scene
+      /// lowers the resolution of the cameras that allow it, down to their
+      /// Camera::MinResolutionScale, and raises it again once the frames
+      /// are well within budget. Cameras keep full resolution by default.
+      /// The GPU time is measured with GpuStats, so GPU timings must be
+      /// enabled, e.g. with the "gpuTiming" ogre2 engine parameter.
+      /// \param[in] _ms GPU time budget of a frame in milliseconds. 0, the
+      /// default, disables the budget and restores full resolution.
+      /// \sa Camera::SetResolutionScale
+      public: virtual void SetFrameBudget(double _ms) = 0;
+
+      /// \brief Get the GPU time budget for rendering the sensors
+      /// \return GPU time budget of a frame in milliseconds, 0 if disabled
+      /// \sa SetFrameBudget
+      public: virtual double FrameBudget() const = 0;
+
+      /// \brief Get the memory held by the resources of this scene, such as
+      /// the textures of its materials, the buffers of the meshes of its
+      /// visuals and the render targets of its sensors. Resources shared
+      /// with other scenes are counted in each of them.
+      /// \remarks ogre2 shares render targets, shadow maps and staging
+      /// buffers between all scenes, they are only reported by
+      /// RenderEngine::MemoryStats.
+      /// \return Memory in bytes per kind of resource
+      public: virtual rendering::MemoryStats MemoryStats() const = 0;
+
+      /// \brief Queue a command to be run on the render thread. Commands
+      /// are run in the order they were queued, in one batch at the start
+      /// of the next PreRender, before the scene state is used, e.g. to
+      /// update the shadow maps. This can be called from any thread, and
+      /// never waits for the render thread, which makes it the way to
+      /// update the scene from other threads, e.g. to set the poses of
+      /// visuals from a physics or transport thread.
+      /// \param[in] _command Function to run on the render thread
+      /// \sa ProcessCommands
+      public: virtual void QueueCommand(std::function<void()> _command) = 0;
+
+      /// \brief Run all commands queued so far, in the order they were
+      /// queued. Commands queued while processing are run by the next
+      /// call. This is called by PreRender, it only needs to be called
+      /// directly by applications that do not call PreRender. It must be
+      /// called from the render thread.
+      /// \return Number of commands run
+      /// \sa QueueCommand
+      public: virtual unsigned int ProcessCommands() = 0;
+
+      /// \brief Prepare a mesh ahead of the creation of the visuals that
+      /// use it. This can be called from any thread, e.g. from the threads
+      /// of a world loader. A mesh named after a file that is not in the
+      /// common::MeshManager yet is read into it. The CPU side of the mesh
+      /// is prepared on the calling thread, and its GPU resources are
+      /// created on the render thread at the start of the next PreRender,
+      /// before the queued commands run. Objects themselves must still be
+      /// created on the render thread, which loader threads do by queuing
+      /// commands that create them, e.g. a command calling CreateMesh with
+      /// the same descriptor finds the mesh ready.
+      /// \remarks The common::MeshManager is not thread safe, so mesh files
+      /// are read one at a time, under the lock returned by
+      /// meshManagerMutex. ogre2 packs the vertex and index data of the
+      /// mesh on the calling thread, which does scale with the number of
+      /// loader threads. Other engines only read the mesh file.
+      /// \remarks The Create* functions and the allocation of object ids
+      /// are not thread safe, by design. Ogre scene nodes, items and
+      /// datablocks can only be created on the render thread, so locking
+      /// the scene storage would serialize creation without letting it
+      /// scale, and would add a lock to every object lookup of the render
+      /// thread. Creation goes through QueueCommand instead.
+      /// \param[in] _desc Descriptor of the mesh to prepare
+      /// \sa QueueCommand
+      public: virtual void PrepareMesh(const MeshDescriptor &_desc) = 0;
+
       /// \brief Remove and destroy all objects from the scene graph. This does
       /// not completely destroy scene resources, so new objects can be created
       /// and added to the scene afterwards.
       public: virtual void Clear() = 0;
 
+      /// \brief Remove and destroy all objects from the scene graph, like
+      /// Clear, but keep the resources they used loaded, so that objects
+      /// created again afterwards are fast to set up. Meant for workloads
+      /// that rebuild the same scene over and over, e.g. episode resets.
+      /// Resources that are not used again stay loaded until Clear is
+      /// called.
+      /// \remarks ogre2 keeps the meshes of the mesh factory and the
+      /// textures of the destroyed materials. Other engines behave like
+      /// Clear.
+      public: virtual void Reset() = 0;
+
+      /// \brief Create a new scene in the same render engine holding a copy
+      /// of the lights and visuals of this scene, e.g. to run several
+      /// instances of one world side by side. The instance is independent
+      /// of this scene: its objects can be moved, changed or destroyed
+      /// without affecting this scene. Visuals sharing a material here
+      /// share the copy of the material in the instance. Sensors are not
+      /// copied, each instance creates its own. Only mesh geometries are
+      /// copied, including the primitive shapes.
+      /// \remarks ogre2 shares the mesh buffers and textures between the
+      /// scenes of the engine, so an instance only costs its scene graph
+      /// and materials.
+      /// \param[in] _name Name of the new scene
+      /// \return The new scene, null if it could not be created
+      public: virtual ScenePtr CreateInstance(const std::string &_name) = 0;
+
+      /// \brief Save the visuals of the scene to a compact binary file, to
+      /// load the same world again with LoadSnapshot instead of building it
+      /// up object by object, e.g. from SDF. The file holds the hierarchy
+      /// of the visuals, their poses, scales and visibility flags, the
+      /// parameters of their materials, and references to their meshes by
+      /// name in the mesh cache. Like CreateInstance, only mesh geometries,
+      /// including the primitive shapes, are saved. Lights and sensors are
+      /// not saved.
+      /// \param[in] _filename Path of the file to write
+      /// \return True if the file was written
+      public: virtual bool SaveSnapshot(const std::string &_filename) = 0;
+
+      /// \brief Load a file written by SaveSnapshot, adding its visuals to
+      /// the root visual of this scene. The file is read and checked as a
+      /// whole before any object is created, so a corrupt file leaves the
+      /// scene unchanged. Materials that already exist in the scene under
+      /// the same name are reused, and visuals whose name is taken get a
+      /// generated name.
+      /// \param[in] _filename Path of the file to read
+      /// \return False if the file could not be read, or if some of its
+      /// meshes could not be loaded
+      public: virtual bool LoadSnapshot(const std::string &_filename) = 0;
+
+      /// \brief Merge the geometries of static visuals into a few large
+      /// meshes, so that culling and draw submission in every render are
+      /// done per chunk instead of per object. The mesh geometries of the
+      /// visuals and of their descendant visuals, including the primitive
+      /// shapes, are transformed to world coordinates and split into cubic
+      /// chunks by the center of each submesh. Each chunk becomes one mesh
+      /// with a submesh per set of material parameters, so geometries whose
+      /// materials are equal but distinct objects are merged too.
+      ///
+      /// Geometries of visuals with a different "label" user data are
+      /// merged into different meshes, and each baked visual keeps the
+      /// label so that segmentation cameras still classify the geometry.
+      /// Selection and panoptic instance ids then report the baked visual
+      /// of a chunk instead of the original visual.
+      ///
+      /// The baked geometries are removed from their visuals, which are
+      /// kept with their children, lights and sensors. Skinned meshes,
+      /// meshes that are not triangle lists and geometries other than
+      /// meshes are left as they are. Moving the visuals afterwards does not
+      /// move the baked geometry. The merged meshes are added to the mesh
+      /// manager of ignition common.
+      /// \param[in] _visuals Static visuals to bake
+      /// \param[in] _chunkSize Edge length of the chunks in meters
+      /// \return Visual attached to the root visual with a child visual per
+      /// chunk and label, null if no geometry was baked
+      public: virtual VisualPtr BakeStatic(
+                  const std::vector<VisualPtr> &_visuals,
+                  double _chunkSize = 50.0) = 0;
+
       /// \brief Completely destroy the scene an all its resources. Continued
       /// use of this scene after its destruction will result in undefined
       /// behavior.
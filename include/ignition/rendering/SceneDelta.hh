@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_SCENEDELTA_HH_
+#define IGNITION_RENDERING_SCENEDELTA_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/common/SuppressWarning.hh>
+#include <ignition/math/Color.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declarations
+    class SceneDeltaPrivate;
+
+    /// \class SceneDelta SceneDelta.hh ignition/rendering/SceneDelta.hh
+    /// \brief Encodes changes to a scene as compact binary commands, so that
+    /// a process without a GPU can describe its scene to a RenderServer
+    /// running elsewhere, e.g. in a render farm, and ask it to render the
+    /// cameras of the scene. Only the changes since the previous delta are
+    /// sent: a node is created once, and afterwards only its new pose,
+    /// scale, visibility or color is encoded, each in a few dozen bytes.
+    ///
+    /// Nodes are referred to by ids chosen by the caller, unique among the
+    /// nodes of the remote scene. Id 0 is the root visual of the remote
+    /// scene. The data is little endian, whatever the byte order of the
+    /// machines on either end, and carrying it to the server is up to the
+    /// caller.
+    /// \sa RenderServer
+    class IGNITION_RENDERING_VISIBLE SceneDelta
+    {
+      /// \brief Geometries a visual can be given
+      public: enum class Geometry : uint8_t
+      {
+        /// \brief Unit box
+        BOX = 0,
+
+        /// \brief Unit cylinder
+        CYLINDER = 1,
+
+        /// \brief Unit plane
+        PLANE = 2,
+
+        /// \brief Unit sphere
+        SPHERE = 3,
+
+        /// \brief Mesh loaded by name on the server
+        MESH = 4
+      };
+
+      /// \brief Commands of the binary format. The data starts with
+      /// kVersion, followed by commands, each one a byte followed by its
+      /// arguments in the order of the function that encodes it.
+      public: enum class Command : uint8_t
+      {
+        /// \brief \sa CreateVisual
+        CREATE_VISUAL = 1,
+
+        /// \brief \sa AddGeometry
+        ADD_GEOMETRY = 2,
+
+        /// \brief \sa CreateCamera
+        CREATE_CAMERA = 3,
+
+        /// \brief \sa SetPose
+        SET_POSE = 4,
+
+        /// \brief \sa SetScale
+        SET_SCALE = 5,
+
+        /// \brief \sa SetVisible
+        SET_VISIBLE = 6,
+
+        /// \brief \sa SetColor
+        SET_COLOR = 7,
+
+        /// \brief \sa SetBackgroundColor
+        SET_BACKGROUND_COLOR = 8,
+
+        /// \brief \sa Destroy
+        DESTROY = 9,
+
+        /// \brief \sa Render
+        RENDER = 10
+      };
+
+      /// \brief Version of the binary format, the first byte of the data
+      public: static constexpr uint8_t kVersion = 1u;
+
+      /// \brief Constructor
+      public: SceneDelta();
+
+      /// \brief Destructor
+      public: ~SceneDelta();
+
+      /// \brief Create a visual
+      /// \param[in] _id Id of the new visual
+      /// \param[in] _parentId Id of its parent, 0 for the root visual
+      public: void CreateVisual(uint32_t _id, uint32_t _parentId);
+
+      /// \brief Add a geometry to a visual
+      /// \param[in] _id Id of the visual
+      /// \param[in] _geometry Type of geometry
+      /// \param[in] _meshName Name or path of the mesh the server loads, for
+      /// Geometry::MESH
+      public: void AddGeometry(uint32_t _id, Geometry _geometry,
+                  const std::string &_meshName = "");
+
+      /// \brief Create a camera
+      /// \param[in] _id Id of the new camera
+      /// \param[in] _parentId Id of its parent, 0 for the root visual
+      /// \param[in] _width Image width in pixels
+      /// \param[in] _height Image height in pixels
+      /// \param[in] _hfov Horizontal field of view in radians
+      /// \param[in] _near Near clip distance
+      /// \param[in] _far Far clip distance
+      public: void CreateCamera(uint32_t _id, uint32_t _parentId,
+                  uint32_t _width, uint32_t _height, double _hfov,
+                  double _near, double _far);
+
+      /// \brief Set the local pose of a node
+      /// \param[in] _id Id of the node
+      /// \param[in] _pose Pose relative to its parent
+      public: void SetPose(uint32_t _id, const math::Pose3d &_pose);
+
+      /// \brief Set the local scale of a node
+      /// \param[in] _id Id of the node
+      /// \param[in] _scale Scale relative to its parent
+      public: void SetScale(uint32_t _id, const math::Vector3d &_scale);
+
+      /// \brief Show or hide a visual
+      /// \param[in] _id Id of the visual
+      /// \param[in] _visible True to show it
+      public: void SetVisible(uint32_t _id, bool _visible);
+
+      /// \brief Set the color of a visual
+      /// \param[in] _id Id of the visual
+      /// \param[in] _color Diffuse and ambient color
+      public: void SetColor(uint32_t _id, const math::Color &_color);
+
+      /// \brief Set the background color of the scene
+      /// \param[in] _color Background color
+      public: void SetBackgroundColor(const math::Color &_color);
+
+      /// \brief Destroy a node and its children
+      /// \param[in] _id Id of the node
+      public: void Destroy(uint32_t _id);
+
+      /// \brief Render cameras once the changes before this command are
+      /// applied. All cameras of one command are rendered together and
+      /// their frames are returned in a single reply.
+      /// \param[in] _ids Ids of the cameras
+      public: void Render(const std::vector<uint32_t> &_ids);
+
+      /// \brief Get the encoded commands
+      /// \return Binary data to pass to RenderServer::Apply
+      public: const std::vector<uint8_t> &Data() const;
+
+      /// \brief Forget the encoded commands, e.g. once they are sent, to
+      /// encode the next delta
+      public: void Clear();
+
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      /// \brief Private data pointer
+      private: std::unique_ptr<SceneDeltaPrivate> dataPtr;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+    }
+  }
+}
+#endif
@@ -109,12 +109,26 @@ namespace ignition
       /// \brief Convert the colored map stored in the internal buffer to label
       /// IDs map, so users get both the colored map and the corresponding IDs
       /// map. This function must be called before the next render loop and
-      /// the colored map mode must be enabeled
+      /// the colored map mode must be enabeled. Engines may render the IDs
+      /// map together with the colored map, in which case it is copied
+      /// instead of converted
       /// \param[out] _labelBuffer A buffer that is populated with  the label
       /// IDs map data. This output buffer must be allocated with the same size
       /// before calling
       public: virtual void LabelMapFromColoredBuffer(
         uint8_t *_labelBuffer) const = 0;
+
+      /// \brief Get the semantic label IDs map of the last frame, each pixel
+      /// holding the label of its item in all three channels. With
+      /// ST_PANOPTIC, the label is taken from the panoptic label IDs map, so
+      /// a single panoptic camera provides the instance IDs, the semantic
+      /// IDs and, with colored map mode enabled, the colored map of the same
+      /// render. Like LabelMapFromColoredBuffer, this must be called before
+      /// the next render loop.
+      /// \param[out] _labelBuffer A buffer that is populated with the
+      /// semantic label IDs map data. This output buffer must be allocated
+      /// with the same size as the segmentation data before calling
+      public: virtual void SemanticLabelMap(uint8_t *_labelBuffer) const = 0;
     };
   }
   }
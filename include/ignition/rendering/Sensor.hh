@@ -19,6 +19,7 @@
 
 #include "ignition/rendering/config.hh"
 #include "ignition/rendering/Node.hh"
+#include "ignition/rendering/RenderStats.hh"
 
 namespace ignition
 {
@@ -42,6 +43,49 @@ namespace ignition
       /// \brief Get visibility mask
       /// \return visibility mask
       public: virtual uint32_t VisibilityMask() const = 0;
+
+      /// \brief Get the GPU time spent rendering this sensor, per pass,
+      /// for the last measured frame and as rolling averages. Timings are
+      /// only collected by render engines that support them and only when
+      /// enabled, e.g. with the "gpuTiming" ogre2 engine parameter.
+      /// GPU results arrive a few frames late, so they lag slightly behind
+      /// the rendered frames.
+      /// \return GPU timings, empty if not available
+      public: virtual RenderStats GpuStats() const = 0;
+
+      /// \brief Get the draw counts of the last frame rendered by this
+      /// sensor, e.g. draw calls and triangles. Counts are only collected
+      /// by render engines that support them; ogre2 collects them when
+      /// enabled, e.g. with the "drawStats" engine parameter.
+      /// \return Draw counts, with a frameCount of 0 if not available
+      public: virtual rendering::DrawStats DrawStats() const = 0;
+
+      /// \brief Get the timestamps of the last frame delivered to the new
+      /// frame callbacks of this sensor, e.g. ConnectNewDepthFrame, or to
+      /// Camera::Capture. While a callback runs, all timestamps except
+      /// callbackCompleteTime already belong to the frame being delivered,
+      /// so callbacks can compute the latency up to their invocation.
+      /// \return Frame timings, with a frameId of 0 if the render engine
+      /// does not record them
+      public: virtual rendering::FrameTimings FrameTimings() const = 0;
+
+      /// \brief Set how long the sensor may go without rendering before its
+      /// GPU resources, e.g. render textures and compositor workspaces, are
+      /// released. They are allocated again when the sensor next renders,
+      /// which makes that frame slower. Render engines that support it
+      /// also defer allocating them until the sensor first renders, so
+      /// sensors that are never updated use no GPU memory; ogre2 does so
+      /// for depth cameras and gpu rays.
+      /// \param[in] _seconds Time without rendering in seconds, 0 to keep
+      /// the resources until the sensor is destroyed, which is the default
+      /// \sa IdleTimeout
+      public: virtual void SetIdleTimeout(double _seconds) = 0;
+
+      /// \brief Get how long the sensor may go without rendering before its
+      /// GPU resources are released
+      /// \return Time without rendering in seconds, 0 if never released
+      /// \sa SetIdleTimeout
+      public: virtual double IdleTimeout() const = 0;
     };
     }
   }
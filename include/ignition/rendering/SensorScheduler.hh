@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_SENSORSCHEDULER_HH_
+#define IGNITION_RENDERING_SENSORSCHEDULER_HH_
+
+#include <chrono>
+#include <memory>
+
+#include <ignition/common/SuppressWarning.hh>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/Export.hh"
+#include "ignition/rendering/RenderTypes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declarations
+    class SensorSchedulerPrivate;
+
+    /// \class SensorScheduler SensorScheduler.hh
+    /// ignition/rendering/SensorScheduler.hh
+    /// \brief Renders the sensors of a scene at their own update rates.
+    /// Sensors are added with a rate, and every call to Update renders the
+    /// sensors that are due with a single Scene::RenderSensors call, i.e.
+    /// one Scene::PreRender and one GPU flush per tick instead of one per
+    /// sensor, as calling Sensor::Update on each of them would. Sensors of
+    /// the same kind are rendered next to each other, so consecutive
+    /// passes share their shaders and render states. The frames rendered
+    /// are delivered to the callbacks connected to the sensors like any
+    /// other frame.
+    ///
+    /// Only camera sensors, which include gpu rays, can be scheduled.
+    /// Sensors destroyed in the scene are removed on the next Update.
+    ///
+    /// Get the scheduler of a scene with Scene::Scheduler. Like
+    /// RenderSensors, Update must not be called between a PreRender /
+    /// PostRender pair.
+    ///
+    /// A process that also draws a view of the scene, e.g. a GUI rendering
+    /// its user camera every display frame, can bound the sensors rendered
+    /// per Update with SetMaxSensorsPerUpdate and call Update once per
+    /// display frame after rendering the view. A burst of due sensors is
+    /// then spread over the following frames instead of delaying one of
+    /// them, and the view keeps its own cadence.
+    class IGNITION_RENDERING_VISIBLE SensorScheduler
+    {
+      /// \brief Constructor
+      /// \param[in] _scene Scene the sensors belong to. It must outlive
+      /// the scheduler.
+      public: explicit SensorScheduler(Scene *_scene);
+
+      /// \brief Destructor
+      public: ~SensorScheduler();
+
+      /// \brief Add a sensor to render at a rate. A sensor added again
+      /// keeps its place and gets the new rate. It is rendered on the
+      /// next Update.
+      /// \param[in] _sensor Camera sensor of the scene
+      /// \param[in] _rate Update rate in Hz, 0 to render it on every Update
+      /// \return False if the sensor is not a camera of the scene or the
+      /// rate is negative
+      public: bool AddSensor(const SensorPtr &_sensor, double _rate);
+
+      /// \brief Stop rendering a sensor
+      /// \param[in] _sensor Sensor to remove
+      /// \return False if the sensor was not scheduled
+      public: bool RemoveSensor(const SensorPtr &_sensor);
+
+      /// \brief Check if a sensor is scheduled
+      /// \param[in] _sensor Sensor to check
+      /// \return True if the sensor was added and not removed
+      public: bool HasSensor(const SensorPtr &_sensor) const;
+
+      /// \brief Get the number of scheduled sensors
+      /// \return Number of sensors
+      public: unsigned int SensorCount() const;
+
+      /// \brief Get the update rate of a sensor
+      /// \param[in] _sensor Scheduled sensor
+      /// \return Update rate in Hz, 0 if it is rendered on every Update or
+      /// not scheduled
+      public: double UpdateRate(const SensorPtr &_sensor) const;
+
+      /// \brief Set the maximum number of sensors rendered by an Update.
+      /// When more sensors are due, the ones rendered the longest ago are
+      /// rendered and the others stay due for the next Update. A sensor
+      /// deferred this way is late, but keeps its rate: it is not rendered
+      /// twice to catch up.
+      /// \param[in] _count Maximum number of sensors, 0 for no limit, the
+      /// default
+      public: void SetMaxSensorsPerUpdate(unsigned int _count);
+
+      /// \brief Get the maximum number of sensors rendered by an Update
+      /// \return Maximum number of sensors, 0 if there is no limit
+      /// \sa SetMaxSensorsPerUpdate
+      public: unsigned int MaxSensorsPerUpdate() const;
+
+      /// \brief Render the sensors that are due at a time. A sensor is due
+      /// once a period of its rate has passed since it was last due. A
+      /// sensor that fell behind by more than one period skips the missed
+      /// frames instead of catching up. A time earlier than the previous
+      /// one, e.g. after a simulation reset, makes all sensors due.
+      /// \param[in] _time Current time, e.g. the simulation time
+      /// \return Number of sensors rendered
+      /// \sa SetMaxSensorsPerUpdate
+      public: unsigned int Update(
+                  const std::chrono::steady_clock::duration &_time);
+
+      /// \brief Get the earliest time a scheduled sensor is due, e.g. to
+      /// know how long the caller can wait before the next Update
+      /// \return Time of the next Update that renders a sensor, the time
+      /// of the last Update if a sensor renders on every Update, or
+      /// duration::max() if no sensor is scheduled
+      public: std::chrono::steady_clock::duration NextUpdateTime() const;
+
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      /// \brief Private data pointer
+      private: std::unique_ptr<SensorSchedulerPrivate> dataPtr;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+    }
+  }
+}
+#endif
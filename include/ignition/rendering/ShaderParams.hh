@@ -20,6 +20,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <utility>
 
 #include "ignition/rendering/Export.hh"
@@ -120,6 +121,12 @@ namespace ignition
       /// \returns true if the parameters have changed
       public: bool IsDirty() const;
 
+      /// \brief Get the names of the parameters accessed for writing since
+      /// the dirty flag was last reset
+      /// \internal
+      /// \returns Names of the modified parameters
+      public: const std::unordered_set<std::string> &DirtyParams() const;
+
       /// \brief Resets the dirty flag
       /// \internal
       public: void ClearDirty();
@@ -111,6 +111,25 @@ namespace ignition
       /// \sa HeatSourceTemperatureRange
       public: virtual void SetHeatSourceTemperatureRange(float _range) = 0;
 
+      /// \brief Link a camera that renders the same view as this thermal
+      /// camera, e.g. the visible camera of a fused sensor pair. When the
+      /// linked camera was rendered at the same scene time with the same
+      /// pose, projection and image size, its depth buffer is copied into
+      /// this camera's depth buffer before the scene pass so hidden surfaces
+      /// are rejected without being shaded. Otherwise the depth is cleared
+      /// as usual. The linked camera must be updated before this camera and
+      /// must not hide objects that this camera sees. Depth picking is
+      /// enabled on the linked camera, see Camera::SetDepthPickingEnabled.
+      /// Not all render engines support this.
+      /// \param[in] _camera Camera to share the depth of, null to unlink
+      /// \sa LinkedCamera
+      public: virtual void SetLinkedCamera(const CameraPtr &_camera) = 0;
+
+      /// \brief Get the camera linked to this thermal camera
+      /// \return Linked camera or null if none is linked
+      /// \sa SetLinkedCamera
+      public: virtual CameraPtr LinkedCamera() const = 0;
+
       /// \brief Connect to the new thermal image event
       /// \param[in] _subscriber Subscriber callback function. The callback
       /// function arguments are: <thermal data, width, height, depth, format>
@@ -118,6 +137,29 @@ namespace ignition
       public: virtual ignition::common::ConnectionPtr ConnectNewThermalFrame(
           std::function<void(const uint16_t *, unsigned int, unsigned int,
           unsigned int, const std::string &)>  _subscriber) = 0;
+
+      /// \brief Connect to the new thermal image view event. Unlike
+      /// ConnectNewThermalFrame, the data is handed to subscribers in the
+      /// image format of the camera, i.e. one byte per pixel for PF_L8 and
+      /// two for PF_L16, without being copied into an intermediate buffer.
+      /// It points straight into the memory the frame was read back into
+      /// and is only valid for the duration of the callback. Rows may be
+      /// padded so use the row pitch to step between them. If only view
+      /// subscribers are connected, the 16 bit buffer of
+      /// ConnectNewThermalFrame is not updated.
+      /// \param[in] _subscriber Subscriber callback function
+      /// The arguments of the callback function are:
+      ///   _data Pointer to the first pixel
+      ///   _width Image width
+      ///   _height Image height
+      ///   _rowPitch Number of bytes between the start of consecutive rows
+      ///   _format Image format
+      /// \return Pointer to the new Connection. This must be kept in scope
+      public: virtual ignition::common::ConnectionPtr
+          ConnectNewThermalFrameView(
+          std::function<void(const void *_data, unsigned int _width,
+          unsigned int _height, unsigned int _rowPitch,
+          const std::string &_format)> _subscriber) = 0;
     };
   }
   }
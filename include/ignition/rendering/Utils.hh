@@ -17,6 +17,10 @@
 #ifndef IGNITION_RENDERING_UTILS_HH_
 #define IGNITION_RENDERING_UTILS_HH_
 
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
 #include <vector>
 
 #include <ignition/math/Helpers.hh>
@@ -40,7 +44,9 @@ namespace ignition
     inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
     //
     /// \brief Retrieve the first point on a surface in the 3D scene hit by a
-    /// ray cast from the given 2D screen coordinates.
+    /// ray cast from the given 2D screen coordinates. If depth picking is
+    /// enabled on the camera, the point is resolved from the depth of its
+    /// last rendered frame instead, see Camera::SetDepthPickingEnabled.
     /// \param[in] _screenPos 2D coordinates on the screen, in pixels.
     /// \param[in] _camera User camera
     /// \param[in] _rayQuery Ray query for mouse clicks
@@ -54,11 +60,14 @@ namespace ignition
         float _maxDistance = 10.0);
 
     /// \brief Retrieve the first point on a surface in the 3D scene hit by a
-    /// ray cast from the given 2D screen coordinates.
+    /// ray cast from the given 2D screen coordinates. If depth picking is
+    /// enabled on the camera, the point is resolved from the depth of its
+    /// last rendered frame instead, see Camera::SetDepthPickingEnabled.
     /// \param[in] _screenPos 2D coordinates on the screen, in pixels.
     /// \param[in] _camera User camera
     /// \param[in] _rayQuery Ray query for mouse clicks
-    /// \param[inout] _rayResult Ray query result
+    /// \param[inout] _rayResult Ray query result. The object id is not
+    /// set if the point is resolved from the depth of the camera.
     /// \param[in] _maxDistance maximum distance to check the collision
     /// \return 3D coordinates of a point in the 3D scene.
     IGNITION_RENDERING_VISIBLE
@@ -97,6 +106,100 @@ namespace ignition
     ignition::math::AxisAlignedBox transformAxisAlignedBox(
         const ignition::math::AxisAlignedBox &_box,
         const ignition::math::Pose3d &_pose);
+
+    /// \brief Reduce the number of triangles of a triangle list with quadric
+    /// error edge collapses, e.g. to generate the levels of detail of a
+    /// mesh. Vertices are never moved or created: the result indexes the
+    /// same vertices as the input so that all levels of detail can share
+    /// the vertex buffer of the full detail mesh. Vertices at the same
+    /// position are collapsed together so that seams of split normals or
+    /// texture coordinates stay closed, and open borders are preserved.
+    /// \param[in] _positions Positions of the vertices
+    /// \param[in] _indices Triangle list indexing _positions
+    /// \param[in] _targetTriangleCount Number of triangles to reduce the
+    /// list to. The result has more triangles if collapsing further would
+    /// flip some of them.
+    /// \return Triangle list of the simplified mesh, _indices if it is not
+    /// a valid triangle list
+    IGNITION_RENDERING_VISIBLE
+    std::vector<unsigned int> simplifyTriangles(
+        const std::vector<math::Vector3d> &_positions,
+        const std::vector<unsigned int> &_indices,
+        std::size_t _targetTriangleCount);
+
+    /// \brief Reorder the triangles of a triangle list so that consecutive
+    /// triangles reuse the vertices the GPU has just transformed, which
+    /// reduces the number of vertex shader invocations. Triangles are
+    /// emitted as fans around vertices that are still in a simulated post
+    /// transform cache (Tipsify). The corners of each triangle keep their
+    /// winding order.
+    /// \param[in] _indices Triangle list
+    /// \param[in] _vertexCount Number of vertices indexed by the list
+    /// \return Reordered triangle list, _indices if it is not a valid
+    /// triangle list
+    /// \sa optimizeOverdraw
+    IGNITION_RENDERING_VISIBLE
+    std::vector<unsigned int> optimizeVertexCache(
+        const std::vector<unsigned int> &_indices,
+        std::size_t _vertexCount);
+
+    /// \brief Reorder clusters of triangles of a list optimized by
+    /// optimizeVertexCache so that the clusters facing away from the
+    /// center of the mesh are drawn first, which lets the depth test
+    /// reject more of the hidden fragments. Clusters are split where the
+    /// triangle order already misses the vertex cache, so the vertex cache
+    /// efficiency is mostly preserved.
+    /// \param[in] _positions Positions of the vertices
+    /// \param[in] _indices Triangle list indexing _positions
+    /// \return Reordered triangle list, _indices if it is not a valid
+    /// triangle list
+    IGNITION_RENDERING_VISIBLE
+    std::vector<unsigned int> optimizeOverdraw(
+        const std::vector<math::Vector3d> &_positions,
+        const std::vector<unsigned int> &_indices);
+
+    /// \brief Compute a vertex order in which vertices are stored in the
+    /// order the index list first uses them, so that the vertices fetched
+    /// by consecutive primitives are close in memory. Vertices not used by
+    /// the list are placed last, in their original order.
+    /// \param[in] _indices Index list
+    /// \param[in] _vertexCount Number of vertices indexed by the list
+    /// \return New index of each vertex, the identity if the list indexes
+    /// more than _vertexCount vertices
+    IGNITION_RENDERING_VISIBLE
+    std::vector<unsigned int> optimizeVertexFetch(
+        const std::vector<unsigned int> &_indices,
+        std::size_t _vertexCount);
+
+    /// \brief Get the default directory of an on-disk cache,
+    /// ~/.ignition/rendering/<_name>
+    /// \param[in] _name Name of the cache
+    /// \return Path to the directory, which may not exist yet
+    IGNITION_RENDERING_VISIBLE
+    std::string cacheDirectory(const std::string &_name);
+
+    /// \brief Write a file through a temporary file next to it, which is
+    /// then moved over the file, so that processes sharing the file, e.g.
+    /// an on-disk cache, never read a partially written one. The name of
+    /// the temporary file is unique across processes and threads.
+    /// \param[in] _file Path of the file to write
+    /// \param[in] _write Function writing the content to the temporary file
+    /// at the given path. It returns false if the content could not be
+    /// written.
+    /// \return True if the file exists afterwards, written by this or by a
+    /// concurrent process
+    IGNITION_RENDERING_VISIBLE
+    bool writeFileAtomically(const std::string &_file,
+        const std::function<bool(const std::string &)> &_write);
+
+    /// \brief Get the mutex serializing the uses of the
+    /// common::MeshManager singleton, which is not thread safe. Code
+    /// looking up, loading or adding meshes in the mesh manager holds it,
+    /// so that Scene::PrepareMesh can run on loader threads while the
+    /// render thread creates objects.
+    /// \return Mutex shared by all scenes and render engines
+    IGNITION_RENDERING_VISIBLE
+    std::recursive_mutex &meshManagerMutex();
     }
   }
 }
@@ -134,6 +134,20 @@ namespace ignition
       /// \param[in] _flags Visibility flags
       public: virtual void RemoveVisibilityFlags(uint32_t _flags) = 0;
 
+      /// \brief Mark this visual as static, i.e. not expected to move, e.g.
+      /// the buildings and terrain of a world. Render engines may then
+      /// skip updating its transform and bounds every frame. A static visual
+      /// can still be moved, at a higher cost than a dynamic one. Its
+      /// parent should be static too, or not move. Visuals are dynamic by
+      /// default.
+      /// \param[in] _static True to make the visual static
+      public: virtual void SetStatic(bool _static) = 0;
+
+      /// \brief Get whether this visual is static
+      /// \return True if the visual is static
+      /// \sa SetStatic
+      public: virtual bool Static() const = 0;
+
       /// \brief Get the bounding box in world frame coordinates.
       /// \return The axis aligned bounding box
       public: virtual ignition::math::AxisAlignedBox BoundingBox() const = 0;
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_WIDEANGLECAMERA_HH_
+#define IGNITION_RENDERING_WIDEANGLECAMERA_HH_
+
+#include <functional>
+#include <string>
+
+#include <ignition/common/Event.hh>
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/CameraLens.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    /// \class WideAngleCamera WideAngleCamera.hh
+    /// ignition/rendering/WideAngleCamera.hh
+    /// \brief Poseable camera with a wide angle lens, e.g. a fisheye. The
+    /// horizontal field of view may exceed 180 degrees. The image is
+    /// projected with the mapping function of the lens instead of the
+    /// perspective projection of regular cameras.
+    class IGNITION_RENDERING_VISIBLE WideAngleCamera :
+      public virtual Camera
+    {
+      /// \brief Destructor
+      public: virtual ~WideAngleCamera() { }
+
+      /// \brief Set the lens of the camera. The lens may be changed after
+      /// the camera is first rendered.
+      /// \param[in] _lens Camera lens
+      public: virtual void SetLens(const CameraLens &_lens) = 0;
+
+      /// \brief Get the lens of the camera
+      /// \return Camera lens
+      public: virtual const CameraLens &Lens() const = 0;
+
+      /// \brief Connect to the new wide angle image event
+      /// \param[in] _subscriber Subscriber callback function.
+      /// The callback function arguments are:
+      /// <image data, width, height, channels, format>
+      /// \return Pointer to the new Connection. This must be kept in scope
+      public: virtual common::ConnectionPtr ConnectNewWideAngleFrame(
+          std::function<void(const unsigned char *, unsigned int,
+          unsigned int, unsigned int, const std::string &)> _subscriber) = 0;
+    };
+    }
+  }
+}
+#endif
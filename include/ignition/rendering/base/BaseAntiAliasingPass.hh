@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_BASE_BASEANTIALIASINGPASS_HH_
+#define IGNITION_RENDERING_BASE_BASEANTIALIASINGPASS_HH_
+
+#include <ignition/math/Helpers.hh>
+
+#include "ignition/rendering/AntiAliasingPass.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /* \class BaseAntiAliasingPass BaseAntiAliasingPass.hh \
+     * ignition/rendering/base/BaseAntiAliasingPass.hh
+     */
+    /// \brief Base anti-aliasing render pass.
+    template <class T>
+    class BaseAntiAliasingPass :
+      public virtual AntiAliasingPass,
+      public virtual T
+    {
+      /// \brief Constructor
+      protected: BaseAntiAliasingPass();
+
+      /// \brief Destructor
+      public: virtual ~BaseAntiAliasingPass();
+
+      // Documentation inherited.
+      public: double EdgeThreshold() const override;
+
+      // Documentation inherited.
+      public: void SetEdgeThreshold(double _threshold) override;
+
+      // Documentation inherited.
+      public: double EdgeThresholdMin() const override;
+
+      // Documentation inherited.
+      public: void SetEdgeThresholdMin(double _threshold) override;
+
+      // Documentation inherited.
+      public: double SubpixelQuality() const override;
+
+      // Documentation inherited.
+      public: void SetSubpixelQuality(double _quality) override;
+
+      /// \brief Minimum relative local contrast of smoothed pixels
+      protected: double edgeThreshold = 0.125;
+
+      /// \brief Minimum absolute local contrast of smoothed pixels
+      protected: double edgeThresholdMin = 0.0312;
+
+      /// \brief Amount of subpixel aliasing removed
+      protected: double subpixelQuality = 0.75;
+    };
+
+    //////////////////////////////////////////////////
+    // BaseAntiAliasingPass
+    //////////////////////////////////////////////////
+    template <class T>
+    BaseAntiAliasingPass<T>::BaseAntiAliasingPass()
+    {
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    BaseAntiAliasingPass<T>::~BaseAntiAliasingPass()
+    {
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseAntiAliasingPass<T>::EdgeThreshold() const
+    {
+      return this->edgeThreshold;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseAntiAliasingPass<T>::SetEdgeThreshold(double _threshold)
+    {
+      this->edgeThreshold = math::clamp(_threshold, 0.063, 0.333);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseAntiAliasingPass<T>::EdgeThresholdMin() const
+    {
+      return this->edgeThresholdMin;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseAntiAliasingPass<T>::SetEdgeThresholdMin(double _threshold)
+    {
+      this->edgeThresholdMin = math::clamp(_threshold, 0.0, 0.0833);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseAntiAliasingPass<T>::SubpixelQuality() const
+    {
+      return this->subpixelQuality;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseAntiAliasingPass<T>::SetSubpixelQuality(double _quality)
+    {
+      this->subpixelQuality = math::clamp(_quality, 0.0, 1.0);
+    }
+    }
+  }
+}
+#endif
@@ -17,12 +17,14 @@
 #ifndef IGNITION_RENDERING_BASE_BASEARROWVISUAL_HH_
 #define IGNITION_RENDERING_BASE_BASEARROWVISUAL_HH_
 
+#include <mutex>
 #include <string>
 
 #include <ignition/common/MeshManager.hh>
 
 #include "ignition/rendering/ArrowVisual.hh"
 #include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Utils.hh"
 
 namespace ignition
 {
@@ -194,10 +196,13 @@ namespace ignition
       cylinder->SetLocalScale(0.05, 0.05, 0.5);
       this->AddChild(cylinder);
 
-      common::MeshManager *meshMgr = common::MeshManager::Instance();
       std::string rotMeshName = "arrow_rotation";
-      if (!meshMgr->HasMesh(rotMeshName))
-        meshMgr->CreateTube(rotMeshName, 0.070f, 0.075f, 0.01f, 1, 32);
+      {
+        std::lock_guard<std::recursive_mutex> lock(meshManagerMutex());
+        common::MeshManager *meshMgr = common::MeshManager::Instance();
+        if (!meshMgr->HasMesh(rotMeshName))
+          meshMgr->CreateTube(rotMeshName, 0.070f, 0.075f, 0.01f, 1, 32);
+      }
 
       VisualPtr rotationVis = this->Scene()->CreateVisual();
       rotationVis->AddGeometry(this->Scene()->CreateMesh(rotMeshName));
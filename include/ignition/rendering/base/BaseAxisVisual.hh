@@ -17,6 +17,8 @@
 #ifndef IGNITION_RENDERING_BASE_BASEAXISVISUAL_HH_
 #define IGNITION_RENDERING_BASE_BASEAXISVISUAL_HH_
 
+#include <vector>
+
 #include "ignition/rendering/AxisVisual.hh"
 #include "ignition/rendering/ArrowVisual.hh"
 #include "ignition/rendering/Scene.hh"
@@ -56,6 +58,10 @@ namespace ignition
 
       // Documentation inherited.
       public: virtual void SetVisible(bool _visible) override;
+
+      /// \brief Materials cloned for the arrows. They are destroyed with
+      /// this visual.
+      protected: std::vector<MaterialPtr> arrowMaterials;
     };
 
     //////////////////////////////////////////////////
@@ -83,6 +89,13 @@ namespace ignition
           arrow->Destroy();
         }
       }
+
+      if (this->Scene())
+      {
+        for (auto &material : this->arrowMaterials)
+          this->Scene()->DestroyMaterial(material);
+      }
+      this->arrowMaterials.clear();
     }
 
     //////////////////////////////////////////////////
@@ -142,18 +155,21 @@ namespace ignition
       xArrow->SetLocalPosition(0, 0, 0);
       xArrow->SetLocalRotation(0, IGN_PI / 2, 0);
       xArrow->SetMaterial("Default/TransRed");
+      this->arrowMaterials.push_back(xArrow->Material());
       this->AddChild(xArrow);
 
       ArrowVisualPtr yArrow = this->Scene()->CreateArrowVisual();
       yArrow->SetLocalPosition(0, 0, 0);
       yArrow->SetLocalRotation(-IGN_PI / 2, 0, 0);
       yArrow->SetMaterial("Default/TransGreen");
+      this->arrowMaterials.push_back(yArrow->Material());
       this->AddChild(yArrow);
 
       ArrowVisualPtr zArrow = this->Scene()->CreateArrowVisual();
       zArrow->SetLocalPosition(0, 0, 0);
       zArrow->SetLocalRotation(0, 0, 0);
       zArrow->SetMaterial("Default/TransBlue");
+      this->arrowMaterials.push_back(zArrow->Material());
       this->AddChild(zArrow);
     }
 
@@ -17,19 +17,32 @@
 #ifndef IGNITION_RENDERING_BASE_BASECAMERA_HH_
 #define IGNITION_RENDERING_BASE_BASECAMERA_HH_
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <ignition/math/Matrix3.hh>
+#include <ignition/math/Matrix4.hh>
 #include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector2.hh>
 
 #include <ignition/common/Event.hh>
 #include <ignition/common/Console.hh>
 #include <ignition/common/SuppressWarning.hh>
+#include <ignition/common/Profiler.hh>
 
 #include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/FrameRecorder.hh"
 #include "ignition/rendering/Image.hh"
+#include "ignition/rendering/PixelFormat.hh"
 #include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderPass.hh"
 #include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
 #include "ignition/rendering/base/BaseRenderTarget.hh"
 
 namespace ignition
@@ -83,6 +96,12 @@ namespace ignition
 
       public: virtual void SetNearClipPlane(const double _near) override;
 
+      // Documentation inherited.
+      public: virtual void SetLodBias(double _bias) override;
+
+      // Documentation inherited.
+      public: virtual double LodBias() const override;
+
       // Documentation inherited.
       public: virtual void PreRender() override;
 
@@ -93,12 +112,58 @@ namespace ignition
 
       public: virtual Image CreateImage() const override;
 
+      // Documentation inherited.
+      public: virtual void SetImagePool(ImagePoolPtr _pool) override;
+
+      // Documentation inherited.
+      public: virtual ImagePoolPtr ImagePool() const override;
+
+      // Documentation inherited.
+      public: virtual void SetTextureMipBias(double _bias) override;
+
+      // Documentation inherited.
+      public: virtual double TextureMipBias() const override;
+
       public: virtual void Capture(Image &_image) override;
 
       public: virtual void Copy(Image &_image) const override;
 
+      // Documentation inherited.
+      public: virtual bool CaptureAsync(Image &_image,
+                  std::function<void()> _callback) override;
+
+      // Documentation inherited.
+      public: virtual bool CopyAsync(Image &_image,
+                  std::function<void()> _callback) override;
+
+      // Documentation inherited.
+      public: virtual bool CopyI420(Image &_image) override;
+
+      // Documentation inherited.
+      public: virtual bool CaptureRegion(unsigned int _x, unsigned int _y,
+                  Image &_image) override;
+
+      // Documentation inherited.
+      public: virtual void WaitForAsyncCopies() override;
+
+      // Documentation inherited.
+      public: virtual bool CaptureBatch(const std::vector<math::Pose3d> &_poses,
+                  Camera::CaptureBatchCallback _callback) override;
+
       public: virtual bool SaveFrame(const std::string &_name) override;
 
+      // Documentation inherited.
+      public: virtual void SetFrameRecorder(FrameRecorderPtr _recorder)
+                  override;
+
+      // Documentation inherited.
+      public: virtual FrameRecorderPtr FrameRecorder() const override;
+
+      /// \brief Get the frame recorder, creating a default one if none is
+      /// set
+      /// \return Frame recorder
+      protected: FrameRecorderPtr DefaultFrameRecorder();
+
       public: virtual common::ConnectionPtr ConnectNewImageFrame(
                   Camera::NewFrameListener _listener) override;
 
@@ -108,6 +173,35 @@ namespace ignition
       public: virtual VisualPtr VisualAt(const ignition::math::Vector2i
                   &_mousePos) override;
 
+      // Documentation inherited.
+      public: virtual std::vector<VisualPtr> VisualsAt(
+                  const std::vector<ignition::math::Vector2i> &_mousePos)
+                  override;
+
+      // Documentation inherited.
+      public: virtual void SetObjectIdPickingEnabled(bool _enabled)
+                  override;
+
+      // Documentation inherited.
+      public: virtual bool ObjectIdPickingEnabled() const override;
+
+      // Documentation inherited.
+      public: virtual void SetDepthPickingEnabled(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual bool DepthPickingEnabled() const override;
+
+      // Documentation inherited.
+      public: virtual bool DepthAt(const math::Vector2i &_pos,
+                  double &_depth) override;
+
+      // Documentation inherited.
+      public: virtual bool CopyDepth(float *_depth) override;
+
+      // Documentation inherited.
+      public: virtual bool CopyLabels(int *_labels, int _backgroundLabel)
+                  override;
+
       // Documentation inherited.
       public: virtual math::Matrix4d ProjectionMatrix() const override;
 
@@ -179,6 +273,10 @@ namespace ignition
       // Documentation inherited.
       public: virtual unsigned int RenderTextureGLId() const override;
 
+      // Documentation inherited.
+      public: virtual void RenderTextureMetalId(void *_textureIdPtr) const
+                  override;
+
       // Documentation inherited.
       public: virtual void AddRenderPass(const RenderPassPtr &_pass) override;
 
@@ -196,6 +294,78 @@ namespace ignition
       // Documentation inherited.
       public: virtual void SetShadowsDirty() override;
 
+      // Documentation inherited.
+      public: virtual void SetShadowsEnabled(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual bool ShadowsEnabled() const override;
+
+      // Documentation inherited.
+      public: virtual void SetResolutionScale(double _scale) override;
+
+      // Documentation inherited.
+      public: virtual double ResolutionScale() const override;
+
+      // Documentation inherited.
+      public: virtual void SetMinResolutionScale(double _scale) override;
+
+      // Documentation inherited.
+      public: virtual double MinResolutionScale() const override;
+
+      // Documentation inherited.
+      public: virtual void SetReprojectionInterval(unsigned int _interval)
+                  override;
+
+      // Documentation inherited.
+      public: virtual unsigned int ReprojectionInterval() const override;
+
+      // Documentation inherited.
+      public: virtual void SetRenderOnDemand(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual bool RenderOnDemand() const override;
+
+      // Documentation inherited.
+      public: virtual void SetRenderDirty() override;
+
+      // Documentation inherited.
+      public: virtual void SetViewPoses(
+                  const std::vector<math::Pose3d> &_poses) override;
+
+      // Documentation inherited.
+      public: virtual std::vector<math::Pose3d> ViewPoses() const override;
+
+      // Documentation inherited.
+      public: virtual void SetViewColumns(unsigned int _columns) override;
+
+      // Documentation inherited.
+      public: virtual unsigned int ViewColumns() const override;
+
+      /// \brief Check if anything the camera sees may have changed since the
+      /// last call, see SetRenderOnDemand. Updates the stored render state.
+      /// \return True if a new frame needs to be rendered
+      protected: virtual bool RenderStateChanged();
+
+      /// \brief Check that an image can hold a region of the camera image,
+      /// see CaptureRegion
+      /// \param[in] _x Column of the top left pixel of the region
+      /// \param[in] _y Row of the top left pixel of the region
+      /// \param[in] _image Image defining the size of the region
+      /// \return True if the image format matches the camera image format
+      /// and the region is within the camera image
+      protected: bool ValidRegion(unsigned int _x, unsigned int _y,
+                     const Image &_image) const;
+
+      /// \brief Advance the frame counter of the reprojection interval, see
+      /// SetReprojectionInterval. To be called once per frame by render
+      /// engines that support reprojection.
+      /// \param[in] _canReproject False if the next frame can't be
+      /// reprojected, e.g. because no frame has been rendered yet. The
+      /// next frame is then rendered and the interval restarts from it.
+      /// \return True if the next frame is reprojected from the last
+      /// rendered frame, false if it is rendered
+      protected: bool NextFrameReprojected(bool _canReproject);
+
       protected: virtual void *CreateImageBuffer() const;
 
       protected: virtual void Load() override;
@@ -210,12 +380,24 @@ namespace ignition
 
       protected: ImagePtr imageBuffer;
 
+      /// \brief Pool that CreateImage takes image buffers from
+      protected: ImagePoolPtr imagePool;
+
+      /// \brief Recorder writing the frames saved by SaveFrame
+      protected: FrameRecorderPtr frameRecorder;
+
+      /// \brief Texture level of detail bias
+      protected: double textureMipBias = 0.0;
+
       /// \brief Near clipping plane distance
       protected: double nearClip = 0.01;
 
       /// \brief Far clipping plane distance
       protected: double farClip = 1000.0;
 
+      /// \brief Level of detail bias
+      protected: double lodBias = 1.0;
+
       /// \brief Aspect ratio
       protected: double aspect = 1.3333333;
 
@@ -259,6 +441,70 @@ namespace ignition
       /// \brief Camera projection type
       protected: CameraProjectionType projectionType = CPT_PERSPECTIVE;
 
+      /// \brief True if Update only renders when the render state changed
+      protected: bool renderOnDemand = false;
+
+      /// \brief True if the next Update must render a new frame
+      protected: bool renderDirty = true;
+
+      /// \brief True if the camera renders shadows
+      protected: bool shadowsEnabled = true;
+
+      /// \brief Scale of the resolution the camera renders at
+      protected: double resolutionScale = 1.0;
+
+      /// \brief Lowest resolution scale of the camera
+      protected: double minResolutionScale = 1.0;
+
+      /// \brief Number of frames per rendered frame
+      protected: unsigned int reprojectionInterval = 1u;
+
+      /// \brief True if VisualAt is answered from object ids
+      protected: bool objectIdPicking = false;
+
+      /// \brief True if the camera keeps the depth of its frames for
+      /// DepthAt
+      protected: bool depthPicking = false;
+
+      /// \brief Frames since the last rendered frame, modulo the
+      /// reprojection interval
+      protected: unsigned int reprojectionCounter = 0u;
+
+      /// \brief True if the last frame was reprojected instead of rendered
+      protected: bool frameReprojected = false;
+
+      /// \brief State of a node when the last frame was rendered
+      protected: struct RenderedNodeState
+      {
+        /// \brief Node id
+        unsigned int id;
+
+        /// \brief World pose of the node
+        math::Pose3d pose;
+
+        /// \brief World scale of the node
+        math::Vector3d scale;
+
+        /// \brief Visual visibility flags, 0 for other nodes
+        uint32_t visibilityFlags;
+      };
+
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      /// \brief State of the scene nodes when the last frame was rendered,
+      /// in depth first order
+      protected: std::vector<RenderedNodeState> renderedNodes;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+
+      /// \brief View and projection matrix of the last rendered frame
+      protected: math::Matrix4d renderedViewProjection;
+
+      /// \brief Image size of the last rendered frame
+      protected: math::Vector2i renderedImageSize;
+
+      /// \brief Render pass count and enabled render passes of the last
+      /// rendered frame, one bit per pass
+      protected: std::pair<unsigned int, uint64_t> renderedPasses {0u, 0u};
+
       friend class BaseDepthCamera<T>;
     };
 
@@ -330,6 +576,7 @@ namespace ignition
     template <class T>
     void BaseCamera<T>::PreRender()
     {
+      IGN_PROFILE("BaseCamera::PreRender");
       T::PreRender();
 
       this->RenderTarget()->PreRender();
@@ -392,6 +639,7 @@ namespace ignition
     template <class T>
     void BaseCamera<T>::PostRender()
     {
+      IGN_PROFILE("BaseCamera::PostRender");
       this->RenderTarget()->PostRender();
     }
 
@@ -402,13 +650,48 @@ namespace ignition
       PixelFormat format = this->ImageFormat();
       unsigned int width = this->ImageWidth();
       unsigned int height = this->ImageHeight();
+      if (this->imagePool)
+        return this->imagePool->CreateImage(width, height, format);
       return Image(width, height, format);
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetImagePool(ImagePoolPtr _pool)
+    {
+      this->imagePool = std::move(_pool);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    ImagePoolPtr BaseCamera<T>::ImagePool() const
+    {
+      return this->imagePool;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetTextureMipBias(double _bias)
+    {
+      this->textureMipBias = std::max(_bias, 0.0);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseCamera<T>::TextureMipBias() const
+    {
+      return this->textureMipBias;
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseCamera<T>::Update()
     {
+      IGN_PROFILE("BaseCamera::Update");
+      // reuse the previous frame if nothing changed
+      if (this->renderOnDemand && !this->RenderStateChanged())
+        return;
+
       this->Scene()->PreRender();
       this->Render();
       this->PostRender();
@@ -422,22 +705,236 @@ namespace ignition
     template <class T>
     void BaseCamera<T>::Capture(Image &_image)
     {
+      auto submitTime = rendering::FrameTimings::Clock::now();
       this->Update();
+
+      // sensors that submit their frames in Render also record when they
+      // are delivered, the image is only a copy of their render target
+      if (this->lastSubmitTime >= submitTime)
+      {
+        this->Copy(_image);
+        return;
+      }
+
+      this->RecordFrameSubmit(submitTime);
+      // the copy waits for the GPU to finish the frame
       this->Copy(_image);
+      this->RecordFrameGpuComplete(this->frameReprojected);
+      this->RecordFrameDelivered();
     }
 
     //////////////////////////////////////////////////
     template <class T>
     void BaseCamera<T>::Copy(Image &_image) const
     {
+      IGN_PROFILE("BaseCamera::Copy");
       this->RenderTarget()->Copy(_image);
     }
 
     //////////////////////////////////////////////////
     template <class T>
-    bool BaseCamera<T>::SaveFrame(const std::string &/*_name*/)
+    bool BaseCamera<T>::CaptureAsync(Image &_image,
+        std::function<void()> _callback)
     {
-      return false;
+      auto submitTime = rendering::FrameTimings::Clock::now();
+      this->Update();
+
+      // sensors that submit their frames in Render record them already
+      if (this->lastSubmitTime >= submitTime)
+        return this->CopyAsync(_image, std::move(_callback));
+
+      this->RecordFrameSubmit(submitTime);
+      auto callback = [this, reprojected = this->frameReprojected,
+          _callback = std::move(_callback)]()
+      {
+        this->RecordFrameGpuComplete(reprojected);
+        if (_callback)
+          _callback();
+        this->RecordFrameDelivered();
+      };
+      if (!this->CopyAsync(_image, std::move(callback)))
+      {
+        this->RecordFrameDropped();
+        return false;
+      }
+      return true;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::CopyAsync(Image &_image,
+        std::function<void()> _callback)
+    {
+      return this->RenderTarget()->CopyAsync(_image, std::move(_callback));
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::CopyI420(Image &_image)
+    {
+      IGN_PROFILE("BaseCamera::CopyI420");
+      return this->RenderTarget()->CopyI420(_image);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::CaptureRegion(unsigned int _x, unsigned int _y,
+        Image &_image)
+    {
+      if (!this->ValidRegion(_x, _y, _image))
+        return false;
+
+      // render the full frame and crop it
+      Image image = this->CreateImage();
+      this->Capture(image);
+
+      PixelFormat format = this->ImageFormat();
+      unsigned int bpp = PixelUtil::BytesPerPixel(format);
+      unsigned int pitch = this->ImageWidth() * bpp;
+      const unsigned char *src = image.Data<unsigned char>() +
+          _y * pitch + _x * bpp;
+      if (_image.RowPitch() == _image.Width() * bpp)
+      {
+        return PixelUtil::Convert(src, format, _image.Data<unsigned char>(),
+            format, _image.Width(), _image.Height(), pitch);
+      }
+
+      // the region image has padding between rows
+      unsigned char *dst = _image.Data<unsigned char>();
+      for (unsigned int row = 0u; row < _image.Height(); ++row)
+      {
+        if (!PixelUtil::Convert(src + row * pitch, format,
+            dst + row * _image.RowPitch(), format, _image.Width(), 1u, pitch))
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::ValidRegion(unsigned int _x, unsigned int _y,
+        const Image &_image) const
+    {
+      if (_image.Format() != this->ImageFormat())
+      {
+        ignerr << "Region image format does not match the camera image "
+               << "format" << std::endl;
+        return false;
+      }
+
+      if (_image.Width() == 0u || _image.Height() == 0u ||
+          _x + _image.Width() > this->ImageWidth() ||
+          _y + _image.Height() > this->ImageHeight())
+      {
+        ignerr << "Region [" << _x << ", " << _y << ", " << _image.Width()
+               << " x " << _image.Height() << "] is not within the camera "
+               << "image" << std::endl;
+        return false;
+      }
+      return true;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::WaitForAsyncCopies()
+    {
+      this->RenderTarget()->WaitForAsyncCopies();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::CaptureBatch(const std::vector<math::Pose3d> &_poses,
+        Camera::CaptureBatchCallback _callback)
+    {
+      IGN_PROFILE("BaseCamera::CaptureBatch");
+      if (_poses.empty())
+        return true;
+
+      // more images than the render targets keep copies in flight, so a
+      // slot is normally written by the time it is reused
+      const size_t ringSize = std::min<size_t>(_poses.size(), 8u);
+      std::vector<Image> images;
+      images.reserve(ringSize);
+      for (size_t i = 0u; i < ringSize; ++i)
+        images.push_back(this->CreateImage());
+      std::vector<bool> pending(ringSize, false);
+
+      const math::Pose3d pose = this->WorldPose();
+      bool result = true;
+      for (unsigned int i = 0u; i < _poses.size(); ++i)
+      {
+        const size_t slot = i % ringSize;
+        if (pending[slot])
+          this->WaitForAsyncCopies();
+
+        this->SetWorldPose(_poses[i]);
+        pending[slot] = true;
+        Image &image = images[slot];
+        bool queued = this->CaptureAsync(image,
+            [&_callback, &pending, &image, slot, i]()
+            {
+              pending[slot] = false;
+              if (_callback)
+                _callback(i, image);
+            });
+        if (!queued)
+        {
+          pending[slot] = false;
+          result = false;
+        }
+      }
+
+      // the callbacks reference the images of the ring
+      this->WaitForAsyncCopies();
+      this->SetWorldPose(pose);
+      return result;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::SaveFrame(const std::string &_name)
+    {
+      IGN_PROFILE("BaseCamera::SaveFrame");
+      if (!rendering::FrameRecorder::IsSupported(this->ImageFormat(), _name))
+      {
+        ignerr << "Unable to save a " << PixelUtil::Name(this->ImageFormat())
+               << " frame to [" << _name << "]" << std::endl;
+        return false;
+      }
+
+      // the image is handed to the recorder once the readback completes,
+      // so neither the render loop nor the copy wait for the disk
+      FrameRecorderPtr recorder = this->DefaultFrameRecorder();
+      auto image = std::make_shared<Image>(this->CreateImage());
+      return this->CopyAsync(*image, [image, recorder, _name]()
+          {
+            recorder->Save(*image, _name);
+          });
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetFrameRecorder(FrameRecorderPtr _recorder)
+    {
+      this->frameRecorder = std::move(_recorder);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    FrameRecorderPtr BaseCamera<T>::FrameRecorder() const
+    {
+      return this->frameRecorder;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    FrameRecorderPtr BaseCamera<T>::DefaultFrameRecorder()
+    {
+      if (!this->frameRecorder)
+        this->frameRecorder = std::make_shared<rendering::FrameRecorder>();
+      return this->frameRecorder;
     }
 
     //////////////////////////////////////////////////
@@ -634,6 +1131,69 @@ namespace ignition
       return VisualPtr();
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    std::vector<VisualPtr> BaseCamera<T>::VisualsAt(
+        const std::vector<ignition::math::Vector2i> &_mousePos)
+    {
+      std::vector<VisualPtr> result;
+      result.reserve(_mousePos.size());
+      for (const auto &pos : _mousePos)
+        result.push_back(this->VisualAt(pos));
+      return result;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetObjectIdPickingEnabled(bool /*_enabled*/)
+    {
+      // no op, object ids are not supported
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::ObjectIdPickingEnabled() const
+    {
+      return this->objectIdPicking;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetDepthPickingEnabled(bool /*_enabled*/)
+    {
+      // no op, depth picking is not supported
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::DepthPickingEnabled() const
+    {
+      return this->depthPicking;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::DepthAt(const math::Vector2i &/*_pos*/,
+        double &/*_depth*/)
+    {
+      return false;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::CopyDepth(float * /*_depth*/)
+    {
+      return false;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::CopyLabels(int * /*_labels*/,
+        int /*_backgroundLabel*/)
+    {
+      return false;
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseCamera<T>::SetHFOV(const math::Angle &_hfov)
@@ -697,6 +1257,25 @@ namespace ignition
       this->nearClip = _near;
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetLodBias(double _bias)
+    {
+      if (_bias <= 0)
+      {
+        ignerr << "Level of detail bias must be greater than 0" << std::endl;
+        return;
+      }
+      this->lodBias = _bias;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseCamera<T>::LodBias() const
+    {
+      return this->lodBias;
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseCamera<T>::SetTrackTarget(const NodePtr &_target,
@@ -804,6 +1383,14 @@ namespace ignition
       return 0u;
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::RenderTextureMetalId(void */*_textureIdPtr*/) const
+    {
+      ignerr << "RenderTextureMetalId is not supported by current render"
+          << " engine" << std::endl;
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseCamera<T>::AddRenderPass(const RenderPassPtr &_pass)
@@ -838,6 +1425,239 @@ namespace ignition
     {
       // no op
     }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetShadowsEnabled(bool _enabled)
+    {
+      if (this->shadowsEnabled == _enabled)
+        return;
+
+      this->shadowsEnabled = _enabled;
+      this->renderDirty = true;
+      this->SetShadowsDirty();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::ShadowsEnabled() const
+    {
+      return this->shadowsEnabled;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetResolutionScale(double /*_scale*/)
+    {
+      // no op, rendering at a lower resolution is not supported
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseCamera<T>::ResolutionScale() const
+    {
+      return this->resolutionScale;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetMinResolutionScale(double _scale)
+    {
+      if (_scale <= 0.0 || _scale > 1.0)
+      {
+        ignerr << "Minimum resolution scale must be in (0, 1], got: "
+               << _scale << std::endl;
+        return;
+      }
+
+      this->minResolutionScale = _scale;
+      if (this->resolutionScale < _scale)
+        this->SetResolutionScale(_scale);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseCamera<T>::MinResolutionScale() const
+    {
+      return this->minResolutionScale;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetReprojectionInterval(unsigned int /*_interval*/)
+    {
+      // no op, reprojection is not supported
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    unsigned int BaseCamera<T>::ReprojectionInterval() const
+    {
+      return this->reprojectionInterval;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::NextFrameReprojected(bool _canReproject)
+    {
+      if (this->reprojectionInterval <= 1u)
+      {
+        this->reprojectionCounter = 0u;
+        return false;
+      }
+
+      // the frame after a rendered one is the first reprojected one
+      bool reproject = _canReproject && this->reprojectionCounter != 0u;
+      this->reprojectionCounter = reproject ?
+          (this->reprojectionCounter + 1u) % this->reprojectionInterval : 1u;
+      return reproject;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetRenderOnDemand(bool _enabled)
+    {
+      if (_enabled && !this->renderOnDemand)
+        this->renderDirty = true;
+      this->renderOnDemand = _enabled;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::RenderOnDemand() const
+    {
+      return this->renderOnDemand;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetRenderDirty()
+    {
+      this->renderDirty = true;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetViewPoses(const std::vector<math::Pose3d> &_poses)
+    {
+      if (_poses.empty())
+        return;
+
+      ignerr << "SetViewPoses not supported for render engine: "
+             << this->Scene()->Engine()->Name() << std::endl;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    std::vector<math::Pose3d> BaseCamera<T>::ViewPoses() const
+    {
+      return std::vector<math::Pose3d>();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseCamera<T>::SetViewColumns(unsigned int _columns)
+    {
+      if (_columns == 0u)
+        return;
+
+      ignerr << "SetViewColumns not supported for render engine: "
+             << this->Scene()->Engine()->Name() << std::endl;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    unsigned int BaseCamera<T>::ViewColumns() const
+    {
+      return 0u;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseCamera<T>::RenderStateChanged()
+    {
+      bool changed = this->renderDirty;
+      this->renderDirty = false;
+
+      // camera pose and projection
+      math::Matrix4d viewProjection =
+          this->ProjectionMatrix() * this->ViewMatrix();
+      if (viewProjection != this->renderedViewProjection)
+      {
+        this->renderedViewProjection = viewProjection;
+        changed = true;
+      }
+
+      math::Vector2i imageSize(static_cast<int>(this->ImageWidth()),
+          static_cast<int>(this->ImageHeight()));
+      if (imageSize != this->renderedImageSize)
+      {
+        this->renderedImageSize = imageSize;
+        changed = true;
+      }
+
+      // render passes
+      std::pair<unsigned int, uint64_t> passes(this->RenderPassCount(), 0u);
+      for (unsigned int i = 0u; i < passes.first && i < 64u; ++i)
+      {
+        RenderPassPtr pass = this->RenderPassByIndex(i);
+        if (pass && pass->IsEnabled())
+          passes.second |= (uint64_t(1u) << i);
+      }
+      if (passes != this->renderedPasses)
+      {
+        this->renderedPasses = passes;
+        changed = true;
+      }
+
+      // world pose, scale and visibility flags of all nodes. Nodes outside of
+      // the view frustum are included too since they can cast shadows.
+      size_t index = 0u;
+      std::vector<NodePtr> stack;
+      stack.push_back(this->Scene()->RootVisual());
+      while (!stack.empty())
+      {
+        NodePtr node = stack.back();
+        stack.pop_back();
+        if (!node)
+          continue;
+
+        RenderedNodeState state;
+        state.id = node->Id();
+        state.pose = node->WorldPose();
+        state.scale = node->WorldScale();
+        VisualPtr visual = std::dynamic_pointer_cast<Visual>(node);
+        state.visibilityFlags = visual ? visual->VisibilityFlags() : 0u;
+
+        if (index >= this->renderedNodes.size())
+        {
+          this->renderedNodes.push_back(state);
+          changed = true;
+        }
+        else
+        {
+          RenderedNodeState &rendered = this->renderedNodes[index];
+          if (rendered.id != state.id || rendered.pose != state.pose ||
+              rendered.scale != state.scale ||
+              rendered.visibilityFlags != state.visibilityFlags)
+          {
+            rendered = state;
+            changed = true;
+          }
+        }
+        ++index;
+
+        for (unsigned int i = 0u; i < node->ChildCount(); ++i)
+          stack.push_back(node->ChildByIndex(i));
+      }
+      if (index != this->renderedNodes.size())
+      {
+        this->renderedNodes.resize(index);
+        changed = true;
+      }
+
+      return changed;
+    }
     }
   }
 }
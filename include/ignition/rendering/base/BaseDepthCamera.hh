@@ -50,6 +50,50 @@ namespace ignition
       public: virtual ignition::common::ConnectionPtr ConnectNewRGBPointCloud(
           std::function<void(const float *, unsigned int, unsigned int,
           unsigned int, const std::string &)>  _subscriber);
+
+      // Documentation inherited.
+      public: virtual ignition::common::ConnectionPtr ConnectNewDepthFrameView(
+          std::function<void(const float *, unsigned int, unsigned int,
+          unsigned int, unsigned int, const std::string &)> _subscriber)
+          override;
+
+      // Documentation inherited.
+      public: virtual ignition::common::ConnectionPtr
+          ConnectNewRgbPointCloudView(
+          std::function<void(const float *, unsigned int, unsigned int,
+          unsigned int, unsigned int, const std::string &)> _subscriber)
+          override;
+
+      // Documentation inherited.
+      public: virtual void SetDepthOnlyReadback(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual bool DepthOnlyReadback() const override;
+
+      // Documentation inherited.
+      public: virtual void SetAsyncReadback(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual bool AsyncReadback() const override;
+
+      // Documentation inherited.
+      public: virtual bool SetDepthOutputFormat(PixelFormat _format)
+          override;
+
+      // Documentation inherited.
+      public: virtual PixelFormat DepthOutputFormat() const override;
+
+      // Documentation inherited.
+      public: virtual ignition::common::ConnectionPtr
+          ConnectNewEncodedDepthFrame(
+          std::function<void(const void *, unsigned int, unsigned int,
+          unsigned int, const std::string &)> _subscriber) override;
+
+      // Documentation inherited.
+      public: virtual ignition::common::ConnectionPtr
+          ConnectNewCompressedDepthFrame(
+          std::function<void(const uint8_t *, size_t)> _subscriber)
+          override;
     };
 
     //////////////////////////////////////////////////
@@ -94,6 +138,85 @@ namespace ignition
     {
       return nullptr;
     }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    ignition::common::ConnectionPtr
+        BaseDepthCamera<T>::ConnectNewDepthFrameView(
+          std::function<void(const float *, unsigned int, unsigned int,
+          unsigned int, unsigned int, const std::string &)>)
+    {
+      return nullptr;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    ignition::common::ConnectionPtr
+        BaseDepthCamera<T>::ConnectNewRgbPointCloudView(
+          std::function<void(const float *, unsigned int, unsigned int,
+          unsigned int, unsigned int, const std::string &)>)
+    {
+      return nullptr;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseDepthCamera<T>::SetDepthOnlyReadback(bool /*_enabled*/)
+    {
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseDepthCamera<T>::DepthOnlyReadback() const
+    {
+      return false;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseDepthCamera<T>::SetAsyncReadback(bool /*_enabled*/)
+    {
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseDepthCamera<T>::AsyncReadback() const
+    {
+      return false;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseDepthCamera<T>::SetDepthOutputFormat(PixelFormat _format)
+    {
+      return _format == PF_FLOAT32_R;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    PixelFormat BaseDepthCamera<T>::DepthOutputFormat() const
+    {
+      return PF_FLOAT32_R;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    ignition::common::ConnectionPtr
+        BaseDepthCamera<T>::ConnectNewEncodedDepthFrame(
+          std::function<void(const void *, unsigned int, unsigned int,
+          unsigned int, const std::string &)>)
+    {
+      return nullptr;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    ignition::common::ConnectionPtr
+        BaseDepthCamera<T>::ConnectNewCompressedDepthFrame(
+          std::function<void(const uint8_t *, size_t)>)
+    {
+      return nullptr;
+    }
   }
   }
 }
@@ -19,6 +19,7 @@
 #define IGNITION_RENDERING_BASE_BASEGIZMOVISUAL_HH_
 
 #include <map>
+#include <mutex>
 #include <string>
 #include <ignition/common/MeshManager.hh>
 #include <ignition/common/SuppressWarning.hh>
@@ -28,6 +29,7 @@
 #include "ignition/rendering/ArrowVisual.hh"
 #include "ignition/rendering/Camera.hh"
 #include "ignition/rendering/GizmoVisual.hh"
+#include "ignition/rendering/Utils.hh"
 
 namespace ignition
 {
@@ -56,6 +58,10 @@ namespace ignition
       // Documentation inherited
       public: virtual void PreRender() override;
 
+      // Documentation inherited.
+      protected: virtual bool PreRenderStatic() const override
+                 { return false; }
+
       // Documentation inherited
       public: virtual void SetTransformMode(TransformMode _mode) override;
 
@@ -77,9 +83,16 @@ namespace ignition
       /// \brief Reset the gizmo visual state
       public: virtual void Reset();
 
-      /// \brief Create materials used by the gizmo visual
+      /// \brief Create materials used by the gizmo visual. The materials
+      /// are shared by all gizmo visuals of the scene.
       protected: void CreateMaterials();
 
+      /// \brief Show and highlight axes, changing only the visuals whose
+      /// state differs from the one last applied
+      /// \param[in] _shown Bitmask of TransformAxis to show
+      /// \param[in] _active Bitmask of TransformAxis to highlight
+      protected: void UpdateAxes(unsigned int _shown, unsigned int _active);
+
       /// \brief Create gizmo visual for translation
       protected: void CreateTranslationVisual();
 
@@ -108,6 +121,12 @@ namespace ignition
       /// \brief Active axis
       protected: math::Vector3d axis = math::Vector3d::Zero;
 
+      /// \brief Bitmask of the visuals currently shown, keyed as in visuals
+      protected: unsigned int shownAxes = TransformAxis::TA_NONE;
+
+      /// \brief Bitmask of TransformAxis currently highlighted
+      protected: unsigned int activeAxes = TransformAxis::TA_NONE;
+
       /// \brief A map of axis enums to materials
       protected: std::map<unsigned int, MaterialPtr> materials;
       IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
@@ -164,48 +183,7 @@ namespace ignition
     template <class T>
     void BaseGizmoVisual<T>::Reset()
     {
-      this->visuals[TransformAxis::TA_TRANSLATION_X]->SetMaterial(
-          this->materials[AM_X], false);
-      this->visuals[TransformAxis::TA_TRANSLATION_Y]->SetMaterial(
-          this->materials[AM_Y], false);
-      this->visuals[TransformAxis::TA_TRANSLATION_Z]->SetMaterial(
-          this->materials[AM_Z], false);
-      this->visuals[TransformAxis::TA_ROTATION_X]->SetMaterial(
-          this->materials[AM_X], false);
-      this->visuals[TransformAxis::TA_ROTATION_Y]->SetMaterial(
-          this->materials[AM_Y], false);
-      this->visuals[TransformAxis::TA_ROTATION_Z]->SetMaterial(
-          this->materials[AM_Z], false);
-      this->visuals[TransformAxis::TA_SCALE_X]->SetMaterial(
-          this->materials[AM_X], false);
-      this->visuals[TransformAxis::TA_SCALE_Y]->SetMaterial(
-          this->materials[AM_Y], false);
-      this->visuals[TransformAxis::TA_SCALE_Z]->SetMaterial(
-          this->materials[AM_Z], false);
-
-      this->handles[TransformAxis::TA_TRANSLATION_X]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-      this->handles[TransformAxis::TA_TRANSLATION_Y]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-      this->handles[TransformAxis::TA_TRANSLATION_Z]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-
-      this->handles[TransformAxis::TA_ROTATION_X]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-      this->handles[TransformAxis::TA_ROTATION_Y]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-      this->handles[TransformAxis::TA_ROTATION_Z]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-
-      this->handles[TransformAxis::TA_SCALE_X]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-      this->handles[TransformAxis::TA_SCALE_Y]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-      this->handles[TransformAxis::TA_SCALE_Z]->SetMaterial(
-          this->materials[AM_HANDLE], false);
-
-      for (auto v : this->visuals)
-        v.second->SetVisible(false);
+      this->UpdateAxes(TransformAxis::TA_NONE, TransformAxis::TA_NONE);
     }
 
     //////////////////////////////////////////////////
@@ -215,99 +193,97 @@ namespace ignition
       if (!this->modeDirty)
         return;
 
-      this->Reset();
-
-      if (this->mode == TransformMode::TM_NONE)
-      {
-        this->modeDirty = false;
-        return;
-      }
-
+      // the first of translation, rotation and scale in the mode is shown
+      unsigned int shown = TransformAxis::TA_NONE;
       if (this->mode & TransformMode::TM_TRANSLATION)
       {
-        this->visuals[TransformAxis::TA_TRANSLATION_X]->SetVisible(true);
-        this->visuals[TransformAxis::TA_TRANSLATION_Y]->SetVisible(true);
-        this->visuals[TransformAxis::TA_TRANSLATION_Z]->SetVisible(true);
-        this->visuals[TransformAxis::TA_TRANSLATION_Z << 1]->SetVisible(true);
-        if (this->axis.X() > 0)
-        {
-          this->visuals[TransformAxis::TA_TRANSLATION_X]->SetMaterial(
-              this->materials[AM_ACTIVE], false);
-          this->handles[TransformAxis::TA_TRANSLATION_X]->SetMaterial(
-              this->materials[AM_HANDLE], false);
-        }
-        if (this->axis.Y() > 0)
-        {
-          this->visuals[TransformAxis::TA_TRANSLATION_Y]->SetMaterial(
-              this->materials[AM_ACTIVE], false);
-          this->handles[TransformAxis::TA_TRANSLATION_Y]->SetMaterial(
-              this->materials[AM_HANDLE], false);
-        }
-        if (this->axis.Z() > 0)
-        {
-          this->visuals[TransformAxis::TA_TRANSLATION_Z]->SetMaterial(
-              this->materials[AM_ACTIVE], false);
-          this->handles[TransformAxis::TA_TRANSLATION_Z]->SetMaterial(
-              this->materials[AM_HANDLE], false);
-        }
+        shown = TransformAxis::TA_TRANSLATION_X |
+            TransformAxis::TA_TRANSLATION_Y | TransformAxis::TA_TRANSLATION_Z;
       }
       else if (this->mode & TransformMode::TM_ROTATION)
       {
-        this->visuals[TransformAxis::TA_ROTATION_X]->SetVisible(true);
-        this->visuals[TransformAxis::TA_ROTATION_Y]->SetVisible(true);
-        this->visuals[TransformAxis::TA_ROTATION_Z]->SetVisible(true);
-        this->visuals[TransformAxis::TA_ROTATION_Z << 1]->SetVisible(true);
-        if (this->axis.X() > 0)
-        {
-          this->visuals[TransformAxis::TA_ROTATION_X]->SetMaterial(
-              this->materials[AM_ACTIVE], false);
-          this->handles[TransformAxis::TA_ROTATION_X]->SetMaterial(
-              this->materials[AM_HANDLE], false);
-        }
-        if (this->axis.Y() > 0)
-        {
-          this->visuals[TransformAxis::TA_ROTATION_Y]->SetMaterial(
-              this->materials[AM_ACTIVE], false);
-          this->handles[TransformAxis::TA_ROTATION_Y]->SetMaterial(
-              this->materials[AM_HANDLE], false);
-        }
-        if (this->axis.Z() > 0)
-        {
-          this->visuals[TransformAxis::TA_ROTATION_Z]->SetMaterial(
-              this->materials[AM_ACTIVE], false);
-          this->handles[TransformAxis::TA_ROTATION_Z]->SetMaterial(
-              this->materials[AM_HANDLE], false);
-        }
+        shown = TransformAxis::TA_ROTATION_X |
+            TransformAxis::TA_ROTATION_Y | TransformAxis::TA_ROTATION_Z;
       }
       else if (this->mode & TransformMode::TM_SCALE)
       {
-        this->visuals[TransformAxis::TA_SCALE_X]->SetVisible(true);
-        this->visuals[TransformAxis::TA_SCALE_Y]->SetVisible(true);
-        this->visuals[TransformAxis::TA_SCALE_Z]->SetVisible(true);
-        if (this->axis.X() > 0)
-        {
-          this->visuals[TransformAxis::TA_SCALE_X]->SetMaterial(
-              this->materials[AM_ACTIVE], false);
-          this->handles[TransformAxis::TA_SCALE_X]->SetMaterial(
-              this->materials[AM_HANDLE], false);
-        }
-        if (this->axis.Y() > 0)
-        {
-          this->visuals[TransformAxis::TA_SCALE_Y]->SetMaterial(
-              this->materials[AM_ACTIVE], false);
-          this->handles[TransformAxis::TA_SCALE_Y]->SetMaterial(
-              this->materials[AM_HANDLE], false);
-        }
-        if (this->axis.Z() > 0)
+        shown = TransformAxis::TA_SCALE_X |
+            TransformAxis::TA_SCALE_Y | TransformAxis::TA_SCALE_Z;
+      }
+
+      unsigned int active = TransformAxis::TA_NONE;
+      if (this->axis.X() > 0)
+      {
+        active |= TransformAxis::TA_TRANSLATION_X |
+            TransformAxis::TA_ROTATION_X | TransformAxis::TA_SCALE_X;
+      }
+      if (this->axis.Y() > 0)
+      {
+        active |= TransformAxis::TA_TRANSLATION_Y |
+            TransformAxis::TA_ROTATION_Y | TransformAxis::TA_SCALE_Y;
+      }
+      if (this->axis.Z() > 0)
+      {
+        active |= TransformAxis::TA_TRANSLATION_Z |
+            TransformAxis::TA_ROTATION_Z | TransformAxis::TA_SCALE_Z;
+      }
+
+      this->UpdateAxes(shown, active & shown);
+      this->modeDirty = false;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseGizmoVisual<T>::UpdateAxes(unsigned int _shown,
+        unsigned int _active)
+    {
+      // the origins of translation and rotation are keyed by their z axis
+      // shifted by one, and shown along with it
+      _shown |= (_shown & (TransformAxis::TA_TRANSLATION_Z |
+          TransformAxis::TA_ROTATION_Z)) << 1;
+
+      // only touch the visuals whose state changed, so that hovering over
+      // an axis swaps the materials of two visuals at most
+      for (auto &v : this->visuals)
+      {
+        const bool visible = (v.first & _shown) != 0u;
+        if (visible != ((v.first & this->shownAxes) != 0u))
+          v.second->SetVisible(visible);
+
+        auto handle = this->handles.find(v.first);
+        if (handle == this->handles.end())
+          continue;
+
+        const bool active = (v.first & _active) != 0u;
+        if (active == ((v.first & this->activeAxes) != 0u))
+          continue;
+
+        unsigned int mat = AM_ACTIVE;
+        if (!active)
         {
-          this->visuals[TransformAxis::TA_SCALE_Z]->SetMaterial(
-              this->materials[AM_ACTIVE], false);
-          this->handles[TransformAxis::TA_SCALE_Z]->SetMaterial(
-              this->materials[AM_HANDLE], false);
+          if (v.first & (TransformAxis::TA_TRANSLATION_X |
+              TransformAxis::TA_ROTATION_X | TransformAxis::TA_SCALE_X))
+          {
+            mat = AM_X;
+          }
+          else if (v.first & (TransformAxis::TA_TRANSLATION_Y |
+              TransformAxis::TA_ROTATION_Y | TransformAxis::TA_SCALE_Y))
+          {
+            mat = AM_Y;
+          }
+          else
+          {
+            mat = AM_Z;
+          }
         }
+
+        // the material cascades to the handle, which has to stay invisible
+        v.second->SetMaterial(this->materials[mat], false);
+        handle->second->SetMaterial(this->materials[AM_HANDLE], false);
       }
 
-      this->modeDirty = false;
+      this->shownAxes = _shown;
+      this->activeAxes = _active;
     }
 
     //////////////////////////////////////////////////
@@ -367,21 +343,24 @@ namespace ignition
     template <class T>
     void BaseGizmoVisual<T>::CreateMaterials()
     {
-      MaterialPtr xMat = this->Scene()->Material("Default/TransRed")->Clone();
-      MaterialPtr yMat = this->Scene()->Material("Default/TransGreen")->Clone();
-      MaterialPtr zMat = this->Scene()->Material("Default/TransBlue")->Clone();
-      MaterialPtr activeMat =
-          this->Scene()->Material("Default/TransYellow")->Clone();
-
       // disable depth checking and writing, make them overlays
-      xMat->SetDepthWriteEnabled(false);
-      xMat->SetDepthCheckEnabled(false);
-      yMat->SetDepthWriteEnabled(false);
-      yMat->SetDepthCheckEnabled(false);
-      zMat->SetDepthWriteEnabled(false);
-      zMat->SetDepthCheckEnabled(false);
-      activeMat->SetDepthWriteEnabled(false);
-      activeMat->SetDepthCheckEnabled(false);
+      auto overlayMaterial = [this](const std::string &_name,
+          const std::string &_baseName)
+      {
+        MaterialPtr mat = this->Scene()->Material(_name);
+        if (!mat)
+        {
+          mat = this->Scene()->Material(_baseName)->Clone(_name);
+          mat->SetDepthWriteEnabled(false);
+          mat->SetDepthCheckEnabled(false);
+        }
+        return mat;
+      };
+      MaterialPtr xMat = overlayMaterial("GizmoRed", "Default/TransRed");
+      MaterialPtr yMat = overlayMaterial("GizmoGreen", "Default/TransGreen");
+      MaterialPtr zMat = overlayMaterial("GizmoBlue", "Default/TransBlue");
+      MaterialPtr activeMat =
+          overlayMaterial("GizmoYellow", "Default/TransYellow");
 
       MaterialPtr oMat = this->Scene()->Material("GizmoGray");
       if (!oMat)
@@ -530,23 +509,29 @@ namespace ignition
     template <class T>
     void BaseGizmoVisual<T>::CreateRotationVisual()
     {
-      common::MeshManager *meshMgr = common::MeshManager::Instance();
       std::string rotMeshName = "gizmo_rotate";
-      if (!meshMgr->HasMesh(rotMeshName))
-        meshMgr->CreateTube(rotMeshName, 1.0f, 1.02f, 0.02f, 1, 64, IGN_PI);
-
       std::string rotFullMeshName = "gizmo_rotate_full";
-      if (!meshMgr->HasMesh(rotFullMeshName))
-      {
-        meshMgr->CreateTube(rotFullMeshName, 1.0f, 1.02f, 0.02f, 1, 64,
-            2 * IGN_PI);
-      }
-
       std::string rotHandleMeshName = "gizmo_rotate_handle";
-      if (!meshMgr->HasMesh(rotHandleMeshName))
       {
-        meshMgr->CreateTube(rotHandleMeshName, 0.95f, 1.07f, 0.1f, 1, 64,
-            IGN_PI);
+        std::lock_guard<std::recursive_mutex> lock(meshManagerMutex());
+        common::MeshManager *meshMgr = common::MeshManager::Instance();
+        if (!meshMgr->HasMesh(rotMeshName))
+        {
+          meshMgr->CreateTube(rotMeshName, 1.0f, 1.02f, 0.02f, 1, 64,
+              IGN_PI);
+        }
+
+        if (!meshMgr->HasMesh(rotFullMeshName))
+        {
+          meshMgr->CreateTube(rotFullMeshName, 1.0f, 1.02f, 0.02f, 1, 64,
+              2 * IGN_PI);
+        }
+
+        if (!meshMgr->HasMesh(rotHandleMeshName))
+        {
+          meshMgr->CreateTube(rotHandleMeshName, 0.95f, 1.07f, 0.1f, 1, 64,
+              IGN_PI);
+        }
       }
 
       VisualPtr rotVis = this->Scene()->CreateVisual();
@@ -17,7 +17,9 @@
 #ifndef IGNITION_RENDERING_BASE_BASEGPURAYS_HH_
 #define IGNITION_RENDERING_BASE_BASEGPURAYS_HH_
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include <ignition/common/Event.hh>
 #include <ignition/common/Console.hh>
@@ -62,6 +64,12 @@ namespace ignition
       // Documentation inherited.
       public: virtual bool Clamp() const override;
 
+      // Documentation inherited.
+      public: virtual void SetAsyncReadback(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual bool AsyncReadback() const override;
+
       // Documentation inherited.
       public: virtual common::ConnectionPtr ConnectNewGpuRaysFrame(
                   std::function<void(const float *_frame, unsigned int _width,
@@ -151,6 +159,65 @@ namespace ignition
       // Documentation inherited.
       public: virtual double VerticalResolution() const override;
 
+      // Documentation inherited.
+      public: virtual void SetRayGroup(const std::string &_group) override;
+
+      // Documentation inherited.
+      public: virtual std::string RayGroup() const override;
+
+      // Documentation inherited.
+      public: virtual bool SetVerticalBeams(
+                  const std::vector<double> &_elevations,
+                  const std::vector<double> &_azimuthOffsets) override;
+
+      // Documentation inherited.
+      public: virtual std::vector<double> VerticalBeamElevations() const
+                  override;
+
+      // Documentation inherited.
+      public: virtual std::vector<double> VerticalBeamAzimuthOffsets() const
+                  override;
+
+      // Documentation inherited.
+      public: virtual bool SetRayPattern(
+                  const std::vector<math::Vector2d> &_rays,
+                  unsigned int _width) override;
+
+      // Documentation inherited.
+      public: virtual std::vector<math::Vector2d> RayPattern() const
+                  override;
+
+      // Documentation inherited.
+      public: virtual bool SetOutputFormat(PixelFormat _format) override;
+
+      // Documentation inherited.
+      public: virtual PixelFormat OutputFormat() const override;
+
+      // Documentation inherited.
+      public: virtual common::ConnectionPtr ConnectNewEncodedGpuRaysFrame(
+                  std::function<void(const void *, unsigned int,
+                  unsigned int, unsigned int, const std::string &)>
+                  _subscriber) override;
+
+      // Documentation inherited.
+      public: virtual common::ConnectionPtr ConnectNewGpuRaysPointCloud(
+                  std::function<void(const float *, unsigned int,
+                  unsigned int, unsigned int, const std::string &)>
+                  _subscriber) override;
+
+      // Documentation inherited.
+      public: virtual void SetScanSegmentCount(unsigned int _count) override;
+
+      // Documentation inherited.
+      public: virtual unsigned int ScanSegmentCount() const override;
+
+      // Documentation inherited.
+      public: virtual void SetScanStartPose(const math::Pose3d &_pose)
+                  override;
+
+      // Documentation inherited.
+      public: virtual math::Pose3d ScanStartPose() const override;
+
       /// \brief maximum value used for data outside sensor range
       public: float dataMaxVal = ignition::math::INF_D;
 
@@ -200,6 +267,28 @@ namespace ignition
       /// \brief Number of channels used to store the data
       protected: unsigned int channels = 1u;
 
+      /// \brief Elevation of each vertical beam, empty for uniform spacing
+      protected: std::vector<double> beamElevations;
+
+      /// \brief Azimuth offset of each vertical beam, may be empty
+      protected: std::vector<double> beamAzimuthOffsets;
+
+      /// \brief Azimuth and elevation of each ray of a ray pattern, empty
+      /// for a grid of rays
+      protected: std::vector<math::Vector2d> rayPattern;
+
+      /// \brief Number of rays in each row of the ray pattern
+      protected: unsigned int rayPatternWidth = 0u;
+
+      /// \brief Number of time segments a scan is rendered in
+      protected: unsigned int scanSegmentCount = 1u;
+
+      /// \brief World pose of the sensor at the start of the scan
+      protected: math::Pose3d scanStartPose;
+
+      /// \brief True if scanStartPose was set
+      protected: bool scanStartPoseSet = false;
+
       private: friend class OgreScene;
     };
 
@@ -256,6 +345,20 @@ namespace ignition
       return this->clamping;
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseGpuRays<T>::SetAsyncReadback(bool /*_enabled*/)
+    {
+      // no op, asynchronous readback is not supported
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseGpuRays<T>::AsyncReadback() const
+    {
+      return false;
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     ignition::common::ConnectionPtr BaseGpuRays<T>::ConnectNewGpuRaysFrame(
@@ -265,6 +368,46 @@ namespace ignition
       return nullptr;
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    common::ConnectionPtr BaseGpuRays<T>::ConnectNewGpuRaysPointCloud(
+        std::function<void(const float *, unsigned int, unsigned int,
+        unsigned int, const std::string &)>)
+    {
+      return nullptr;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseGpuRays<T>::SetScanSegmentCount(unsigned int _count)
+    {
+      this->scanSegmentCount = std::max(1u, _count);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    unsigned int BaseGpuRays<T>::ScanSegmentCount() const
+    {
+      return this->scanSegmentCount;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseGpuRays<T>::SetScanStartPose(const math::Pose3d &_pose)
+    {
+      this->scanStartPose = _pose;
+      this->scanStartPoseSet = true;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    math::Pose3d BaseGpuRays<T>::ScanStartPose() const
+    {
+      if (this->scanStartPoseSet)
+        return this->scanStartPose;
+      return this->WorldPose();
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseGpuRays<T>::SetIsHorizontal(const bool _horizontal)
@@ -346,6 +489,8 @@ namespace ignition
     //////////////////////////////////////////////////
     int BaseGpuRays<T>::RayCount() const
     {
+      if (!this->rayPattern.empty())
+        return static_cast<int>(this->rayPatternWidth);
       return this->hSamples;
     }
 
@@ -360,6 +505,8 @@ namespace ignition
     //////////////////////////////////////////////////
     int BaseGpuRays<T>::RangeCount() const
     {
+      if (!this->rayPattern.empty())
+        return static_cast<int>(this->rayPatternWidth);
       return static_cast<int>(this->RayCount() * this->hResolution);
     }
 
@@ -367,6 +514,13 @@ namespace ignition
     //////////////////////////////////////////////////
     int BaseGpuRays<T>::VerticalRayCount() const
     {
+      if (!this->rayPattern.empty())
+      {
+        return static_cast<int>(
+            this->rayPattern.size() / this->rayPatternWidth);
+      }
+      if (!this->beamElevations.empty())
+        return static_cast<int>(this->beamElevations.size());
       return this->vSamples;
     }
 
@@ -381,6 +535,11 @@ namespace ignition
     //////////////////////////////////////////////////
     int BaseGpuRays<T>::VerticalRangeCount() const
     {
+      // there is one range per beam of a beam table
+      if (!this->rayPattern.empty())
+        return this->VerticalRayCount();
+      if (!this->beamElevations.empty())
+        return static_cast<int>(this->beamElevations.size());
       return static_cast<int>(this->VerticalRayCount() * this->vResolution);
     }
 
@@ -388,6 +547,11 @@ namespace ignition
     //////////////////////////////////////////////////
     ignition::math::Angle BaseGpuRays<T>::VerticalAngleMin() const
     {
+      if (!this->beamElevations.empty())
+      {
+        return *std::min_element(this->beamElevations.begin(),
+            this->beamElevations.end());
+      }
       return this->vMinAngle;
     }
 
@@ -402,6 +566,11 @@ namespace ignition
     //////////////////////////////////////////////////
     ignition::math::Angle BaseGpuRays<T>::VerticalAngleMax() const
     {
+      if (!this->beamElevations.empty())
+      {
+        return *std::max_element(this->beamElevations.begin(),
+            this->beamElevations.end());
+      }
       return this->vMaxAngle;
     }
 
@@ -446,6 +615,104 @@ namespace ignition
     {
       return this->vResolution;
     }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseGpuRays<T>::SetRayGroup(const std::string &/*_group*/)
+    {
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    std::string BaseGpuRays<T>::RayGroup() const
+    {
+      return std::string();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseGpuRays<T>::SetVerticalBeams(
+        const std::vector<double> &_elevations,
+        const std::vector<double> &_azimuthOffsets)
+    {
+      if (!_azimuthOffsets.empty() &&
+          _azimuthOffsets.size() != _elevations.size())
+      {
+        ignerr << "Number of azimuth offsets [" << _azimuthOffsets.size()
+               << "] does not match the number of vertical beams ["
+               << _elevations.size() << "]" << std::endl;
+        return false;
+      }
+
+      this->beamElevations = _elevations;
+      this->beamAzimuthOffsets =
+          _elevations.empty() ? std::vector<double>() : _azimuthOffsets;
+      return true;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    std::vector<double> BaseGpuRays<T>::VerticalBeamElevations() const
+    {
+      return this->beamElevations;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    std::vector<double> BaseGpuRays<T>::VerticalBeamAzimuthOffsets() const
+    {
+      return this->beamAzimuthOffsets;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseGpuRays<T>::SetRayPattern(
+        const std::vector<math::Vector2d> &_rays, unsigned int _width)
+    {
+      unsigned int width = _width == 0u ?
+          static_cast<unsigned int>(_rays.size()) : _width;
+      if (!_rays.empty() && _rays.size() % width != 0u)
+      {
+        ignerr << "Number of rays in the pattern [" << _rays.size()
+               << "] is not a multiple of its width [" << width << "]"
+               << std::endl;
+        return false;
+      }
+
+      this->rayPattern = _rays;
+      this->rayPatternWidth = _rays.empty() ? 0u : width;
+      return true;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    std::vector<math::Vector2d> BaseGpuRays<T>::RayPattern() const
+    {
+      return this->rayPattern;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseGpuRays<T>::SetOutputFormat(PixelFormat _format)
+    {
+      return _format == PF_FLOAT32_RGB;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    PixelFormat BaseGpuRays<T>::OutputFormat() const
+    {
+      return PF_FLOAT32_RGB;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    common::ConnectionPtr BaseGpuRays<T>::ConnectNewEncodedGpuRaysFrame(
+        std::function<void(const void *, unsigned int, unsigned int,
+        unsigned int, const std::string &)>)
+    {
+      return nullptr;
+    }
     }
   }
 }
@@ -63,6 +63,12 @@ namespace ignition
       // Documentation inherited.
       public: virtual void SetVerticalCellCount(const unsigned int _count);
 
+      // Documentation inherited.
+      public: virtual void SetProcedural(bool _procedural);
+
+      // Documentation inherited.
+      public: virtual bool Procedural() const;
+
       /// \brief Number of cells in grid
       protected: unsigned int cellCount = 10u;
 
@@ -75,6 +81,9 @@ namespace ignition
       /// \brief vertical offset of the XY plane from origin
       protected: double heightOffset = 0.0;
 
+      /// \brief True to draw the grid procedurally
+      protected: bool procedural = false;
+
       /// \brief Flag to indicate grid properties have changed
       protected: bool gridDirty = false;
     };
@@ -138,6 +147,24 @@ namespace ignition
       this->gridDirty = true;
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseGrid<T>::SetProcedural(bool _procedural)
+    {
+      if (this->procedural == _procedural)
+        return;
+
+      this->procedural = _procedural;
+      this->gridDirty = true;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseGrid<T>::Procedural() const
+    {
+      return this->procedural;
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseGrid<T>::PreRender()
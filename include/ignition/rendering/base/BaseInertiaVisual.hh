@@ -48,6 +48,10 @@ namespace ignition
       // Documentation inherited.
       protected: virtual void PreRender() override;
 
+      // Documentation inherited.
+      protected: virtual bool PreRenderStatic() const override
+                 { return false; }
+
       // Documentation inherited.
       public: virtual void SetInertial(
                   const ignition::math::Inertiald &_inertial) override;
@@ -0,0 +1,496 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_BASEINSTANCEDVISUAL_HH_
+#define IGNITION_RENDERING_BASEINSTANCEDVISUAL_HH_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ignition/rendering/InstancedVisual.hh"
+#include "ignition/rendering/Material.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/base/BaseObject.hh"
+#include "ignition/rendering/base/BaseRenderTypes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Base implementation of an instanced visual. Stores the
+    /// instance parameters and hands the modified instances over to the
+    /// render engine in PreRender.
+    template <class T>
+    class BaseInstancedVisual :
+      public virtual InstancedVisual,
+      public virtual T
+    {
+      /// \brief Constructor
+      protected: BaseInstancedVisual();
+
+      /// \brief Destructor
+      public: virtual ~BaseInstancedVisual();
+
+      // Documentation inherited
+      public: virtual void PreRender() override;
+
+      // Documentation inherited
+      public: virtual void Destroy() override;
+
+      // Documentation inherited
+      public: virtual unsigned int InstanceCount() const override;
+
+      // Documentation inherited
+      public: virtual void SetInstancePose(unsigned int _index,
+                  const math::Pose3d &_pose) override;
+
+      // Documentation inherited
+      public: virtual math::Pose3d InstancePose(unsigned int _index) const
+                  override;
+
+      // Documentation inherited
+      public: virtual void SetInstanceScale(unsigned int _index,
+                  const math::Vector3d &_scale) override;
+
+      // Documentation inherited
+      public: virtual math::Vector3d InstanceScale(unsigned int _index) const
+                  override;
+
+      // Documentation inherited
+      public: virtual void SetInstanceColor(unsigned int _index,
+                  const math::Color &_color) override;
+
+      // Documentation inherited
+      public: virtual math::Color InstanceColor(unsigned int _index) const
+                  override;
+
+      // Documentation inherited
+      public: virtual void SetInstanceVisible(unsigned int _index,
+                  bool _visible) override;
+
+      // Documentation inherited
+      public: virtual bool InstanceVisible(unsigned int _index) const
+                  override;
+
+      // Documentation inherited
+      public: virtual void SetInstanceAnimation(unsigned int _index,
+                  const std::string &_name,
+                  std::chrono::steady_clock::duration _timeOffset) override;
+
+      // Documentation inherited
+      public: virtual std::string InstanceAnimation(unsigned int _index) const
+                  override;
+
+      // Documentation inherited
+      public: virtual std::chrono::steady_clock::duration
+                  InstanceAnimationTimeOffset(unsigned int _index) const
+                  override;
+
+      // Documentation inherited
+      public: virtual void SetAnimationPhaseCount(unsigned int _count)
+                  override;
+
+      // Documentation inherited
+      public: virtual unsigned int AnimationPhaseCount() const override;
+
+      // Documentation inherited
+      public: virtual void UpdateAnimations(
+                  std::chrono::steady_clock::duration _time) override;
+
+      /// \brief Allocate the parameters of the instances. All instances
+      /// start at the origin of the visual, with unit scale, and are marked
+      /// for update.
+      /// \param[in] _count Number of instances
+      protected: void InitInstances(unsigned int _count);
+
+      /// \brief Apply the parameters of a modified instance to the render
+      /// engine objects. Called by PreRender.
+      /// \param[in] _index Index of the instance
+      protected: virtual void UpdateInstance(unsigned int _index) = 0;
+
+      /// \brief Apply animationTime to the animations of the instances.
+      /// Called by PreRender after the modified instances are updated, if
+      /// the time changed. Render engines without support for instance
+      /// animations do nothing.
+      protected: virtual void UpdateAnimationTime();
+
+      /// \brief Get the material an instance is drawn with: the material of
+      /// the visual, or a copy of it with the color of the instance.
+      /// Instances of the same color share the same copy.
+      /// \param[in] _index Index of the instance
+      /// \return Material of the instance, null if the visual has none
+      protected: MaterialPtr InstanceMaterial(unsigned int _index);
+
+      /// \brief Mark an instance for update by the next PreRender call
+      /// \param[in] _index Index of the instance
+      private: void MarkInstanceDirty(unsigned int _index);
+
+      /// \brief Destroy the colored copies of the material of the visual
+      private: void DestroyColorMaterials();
+
+      /// \brief Poses of the instances
+      protected: std::vector<math::Pose3d> instancePoses;
+
+      /// \brief Scales of the instances
+      protected: std::vector<math::Vector3d> instanceScales;
+
+      /// \brief Colors of the instances, used if customColors is set
+      protected: std::vector<math::Color> instanceColors;
+
+      /// \brief True for the instances with a color of their own
+      protected: std::vector<bool> customColors;
+
+      /// \brief Visibility of the instances
+      protected: std::vector<bool> instanceVisible;
+
+      /// \brief Skeleton animations played by the instances, empty for none
+      protected: std::vector<std::string> instanceAnimations;
+
+      /// \brief Time offsets of the instances in their animations
+      protected: std::vector<std::chrono::steady_clock::duration>
+                     instanceAnimationOffsets;
+
+      /// \brief Number of times each animation is evaluated at
+      protected: unsigned int animationPhaseCount = 16u;
+
+      /// \brief Time of the animations
+      protected: std::chrono::steady_clock::duration animationTime =
+                     std::chrono::steady_clock::duration::zero();
+
+      /// \brief True if animationTime changed since the last PreRender call
+      private: bool animationTimeDirty = false;
+
+      /// \brief Instances modified since the last PreRender call
+      private: std::vector<unsigned int> dirtyInstances;
+
+      /// \brief True for the instances in dirtyInstances
+      private: std::vector<bool> instanceDirty;
+
+      /// \brief Copies of the material of the visual with the colors of the
+      /// instances. Key: color as RGBA
+      private: std::unordered_map<uint32_t, MaterialPtr> colorMaterials;
+
+      /// \brief Material the color materials were copied from
+      private: MaterialPtr colorMaterialsSource;
+    };
+
+    /////////////////////////////////////////////////
+    // BaseInstancedVisual
+    /////////////////////////////////////////////////
+    template <class T>
+    BaseInstancedVisual<T>::BaseInstancedVisual()
+    {
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    BaseInstancedVisual<T>::~BaseInstancedVisual()
+    {
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::PreRender()
+    {
+      T::PreRender();
+
+      // the colored materials follow the material of the visual, so all
+      // instances are updated when it changes
+      if (this->colorMaterialsSource != this->Material())
+      {
+        this->DestroyColorMaterials();
+        this->colorMaterialsSource = this->Material();
+        this->dirtyInstances.clear();
+        for (unsigned int i = 0; i < this->InstanceCount(); ++i)
+          this->dirtyInstances.push_back(i);
+      }
+
+      for (unsigned int index : this->dirtyInstances)
+      {
+        this->UpdateInstance(index);
+        this->instanceDirty[index] = false;
+      }
+      this->dirtyInstances.clear();
+
+      if (this->animationTimeDirty)
+      {
+        this->UpdateAnimationTime();
+        this->animationTimeDirty = false;
+      }
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::Destroy()
+    {
+      this->DestroyColorMaterials();
+      this->colorMaterialsSource.reset();
+      T::Destroy();
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    unsigned int BaseInstancedVisual<T>::InstanceCount() const
+    {
+      return static_cast<unsigned int>(this->instancePoses.size());
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::SetInstancePose(unsigned int _index,
+        const math::Pose3d &_pose)
+    {
+      if (_index >= this->InstanceCount())
+        return;
+
+      this->instancePoses[_index] = _pose;
+      this->MarkInstanceDirty(_index);
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    math::Pose3d BaseInstancedVisual<T>::InstancePose(
+        unsigned int _index) const
+    {
+      if (_index >= this->InstanceCount())
+        return math::Pose3d::Zero;
+      return this->instancePoses[_index];
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::SetInstanceScale(unsigned int _index,
+        const math::Vector3d &_scale)
+    {
+      if (_index >= this->InstanceCount())
+        return;
+
+      this->instanceScales[_index] = _scale;
+      this->MarkInstanceDirty(_index);
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    math::Vector3d BaseInstancedVisual<T>::InstanceScale(
+        unsigned int _index) const
+    {
+      if (_index >= this->InstanceCount())
+        return math::Vector3d::One;
+      return this->instanceScales[_index];
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::SetInstanceColor(unsigned int _index,
+        const math::Color &_color)
+    {
+      if (_index >= this->InstanceCount())
+        return;
+
+      this->instanceColors[_index] = _color;
+      this->customColors[_index] = true;
+      this->MarkInstanceDirty(_index);
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    math::Color BaseInstancedVisual<T>::InstanceColor(
+        unsigned int _index) const
+    {
+      if (_index >= this->InstanceCount())
+        return math::Color::White;
+
+      if (this->customColors[_index])
+        return this->instanceColors[_index];
+
+      MaterialPtr material = this->Material();
+      return material ? material->Diffuse() : math::Color::White;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::SetInstanceVisible(unsigned int _index,
+        bool _visible)
+    {
+      if (_index >= this->InstanceCount() ||
+          this->instanceVisible[_index] == _visible)
+      {
+        return;
+      }
+
+      this->instanceVisible[_index] = _visible;
+      this->MarkInstanceDirty(_index);
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    bool BaseInstancedVisual<T>::InstanceVisible(unsigned int _index) const
+    {
+      if (_index >= this->InstanceCount())
+        return false;
+      return this->instanceVisible[_index];
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::SetInstanceAnimation(unsigned int _index,
+        const std::string &_name,
+        std::chrono::steady_clock::duration _timeOffset)
+    {
+      if (_index >= this->InstanceCount())
+        return;
+
+      this->instanceAnimations[_index] = _name;
+      this->instanceAnimationOffsets[_index] = _timeOffset;
+      this->MarkInstanceDirty(_index);
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    std::string BaseInstancedVisual<T>::InstanceAnimation(
+        unsigned int _index) const
+    {
+      if (_index >= this->InstanceCount())
+        return std::string();
+      return this->instanceAnimations[_index];
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    std::chrono::steady_clock::duration
+        BaseInstancedVisual<T>::InstanceAnimationTimeOffset(
+        unsigned int _index) const
+    {
+      if (_index >= this->InstanceCount())
+        return std::chrono::steady_clock::duration::zero();
+      return this->instanceAnimationOffsets[_index];
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::SetAnimationPhaseCount(unsigned int _count)
+    {
+      _count = std::max(_count, 1u);
+      if (this->animationPhaseCount == _count)
+        return;
+
+      // the animated instances take the pose of another time
+      this->animationPhaseCount = _count;
+      for (unsigned int i = 0; i < this->InstanceCount(); ++i)
+      {
+        if (!this->instanceAnimations[i].empty())
+          this->MarkInstanceDirty(i);
+      }
+      this->animationTimeDirty = true;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    unsigned int BaseInstancedVisual<T>::AnimationPhaseCount() const
+    {
+      return this->animationPhaseCount;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::UpdateAnimations(
+        std::chrono::steady_clock::duration _time)
+    {
+      this->animationTime = _time;
+      this->animationTimeDirty = true;
+      this->MarkPreRenderDirty();
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::UpdateAnimationTime()
+    {
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::InitInstances(unsigned int _count)
+    {
+      this->instancePoses.assign(_count, math::Pose3d::Zero);
+      this->instanceScales.assign(_count, math::Vector3d::One);
+      this->instanceColors.assign(_count, math::Color::White);
+      this->customColors.assign(_count, false);
+      this->instanceVisible.assign(_count, true);
+      this->instanceAnimations.assign(_count, std::string());
+      this->instanceAnimationOffsets.assign(_count,
+          std::chrono::steady_clock::duration::zero());
+      this->instanceDirty.assign(_count, false);
+      this->dirtyInstances.clear();
+      for (unsigned int i = 0; i < _count; ++i)
+        this->MarkInstanceDirty(i);
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    MaterialPtr BaseInstancedVisual<T>::InstanceMaterial(unsigned int _index)
+    {
+      MaterialPtr material = this->Material();
+      if (!material || _index >= this->InstanceCount() ||
+          !this->customColors[_index])
+      {
+        return material;
+      }
+
+      uint32_t key = this->instanceColors[_index].AsRGBA();
+      auto it = this->colorMaterials.find(key);
+      if (it != this->colorMaterials.end())
+        return it->second;
+
+      MaterialPtr colorMaterial = material->Clone();
+      colorMaterial->SetDiffuse(this->instanceColors[_index]);
+      this->colorMaterials[key] = colorMaterial;
+      return colorMaterial;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::MarkInstanceDirty(unsigned int _index)
+    {
+      if (!this->instanceDirty[_index])
+      {
+        this->instanceDirty[_index] = true;
+        this->dirtyInstances.push_back(_index);
+      }
+      this->MarkPreRenderDirty();
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::DestroyColorMaterials()
+    {
+      ScenePtr scene = this->Scene();
+      for (auto &colorMaterial : this->colorMaterials)
+      {
+        if (scene)
+          scene->DestroyMaterial(colorMaterial.second);
+      }
+      this->colorMaterials.clear();
+    }
+    }
+  }
+}
+#endif
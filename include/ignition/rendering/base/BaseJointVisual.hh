@@ -53,6 +53,10 @@ namespace ignition
       // Documentation inherited.
       protected: virtual void PreRender() override;
 
+      // Documentation inherited.
+      protected: virtual bool PreRenderStatic() const override
+                 { return false; }
+
       // Documentation inherited.
       protected: virtual void Destroy() override;
 
@@ -126,6 +130,10 @@ namespace ignition
       /// JointVisual with its own arrowVisual.
       protected: ArrowVisualPtr arrowVisual = nullptr;
 
+      /// \brief Material cloned for the arrow visual. It is destroyed with
+      /// the arrow visual.
+      protected: MaterialPtr arrowMaterial = nullptr;
+
       /// \brief Second joint visual for hinge2 and universal joints. It is a
       /// simplified visual without an XYZ frame.
       protected: JointVisualPtr parentAxisVis = nullptr;
@@ -248,6 +256,12 @@ namespace ignition
         this->arrowVisual.reset();
       }
 
+      if (this->arrowMaterial != nullptr)
+      {
+        this->Scene()->DestroyMaterial(this->arrowMaterial);
+        this->arrowMaterial.reset();
+      }
+
       if (this->axisVisual != nullptr)
       {
         this->axisVisual->Destroy();
@@ -286,8 +300,15 @@ namespace ignition
         this->arrowVisual.reset();
       }
 
+      if (this->arrowMaterial)
+      {
+        this->Scene()->DestroyMaterial(this->arrowMaterial);
+        this->arrowMaterial.reset();
+      }
+
       this->arrowVisual = this->Scene()->CreateArrowVisual();
       this->arrowVisual->SetMaterial("Default/TransYellow");
+      this->arrowMaterial = this->arrowVisual->Material();
       this->arrowVisual->SetLocalPosition(0, 0, 0);
       this->arrowVisual->SetLocalRotation(0, 0, 0);
       this->AddChild(this->arrowVisual);
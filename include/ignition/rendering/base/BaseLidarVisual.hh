@@ -44,6 +44,10 @@ namespace ignition
       // Documentation inherited
       public: virtual void PreRender() override;
 
+      // Documentation inherited.
+      protected: virtual bool PreRenderStatic() const override
+                 { return false; }
+
       // Documentation inherited
       public: virtual void Destroy() override;
 
@@ -59,6 +63,10 @@ namespace ignition
                             const std::vector<ignition::math::Color> &_colors)
                             override;
 
+      // Documentation inherited
+      public: virtual void SetRanges(const float *_ranges,
+                  unsigned int _channelCount = 1u) override;
+
       // Documentation inherited
       public: virtual void Update() override;
 
@@ -269,6 +277,21 @@ namespace ignition
       // no op
     }
 
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseLidarVisual<T>::SetRanges(const float *_ranges,
+        unsigned int _channelCount)
+    {
+      if (!_ranges || _channelCount == 0u)
+        return;
+
+      unsigned int count = this->verticalCount * this->horizontalCount;
+      std::vector<double> points(count);
+      for (unsigned int i = 0u; i < count; ++i)
+        points[i] = _ranges[i * _channelCount];
+      this->SetPoints(points);
+    }
+
     /////////////////////////////////////////////////
     template <class T>
     void BaseLidarVisual<T>::Init()
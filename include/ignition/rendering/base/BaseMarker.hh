@@ -88,6 +88,10 @@ namespace ignition
       public: virtual void SetPoint(unsigned int _index,
                   const ignition::math::Vector3d &_value) override;
 
+      // Documentation inherited
+      public: virtual void SetPoints(const float *_xyz, const uint8_t *_rgba,
+                  std::size_t _count) override;
+
       /// \brief Life time of a marker
       IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
       protected: std::chrono::steady_clock::duration lifetime =
@@ -227,6 +231,24 @@ namespace ignition
     {
       // no op
     }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseMarker<T>::SetPoints(const float *_xyz, const uint8_t *_rgba,
+                  std::size_t _count)
+    {
+      this->ClearPoints();
+      for (std::size_t i = 0; i < _count; ++i)
+      {
+        ignition::math::Color color = ignition::math::Color::White;
+        if (_rgba)
+        {
+          color.Set(_rgba[i*4] / 255.0f, _rgba[i*4+1] / 255.0f,
+              _rgba[i*4+2] / 255.0f, _rgba[i*4+3] / 255.0f);
+        }
+        this->AddPoint(_xyz[i*3], _xyz[i*3+1], _xyz[i*3+2], color);
+      }
+    }
     }
   }
 }
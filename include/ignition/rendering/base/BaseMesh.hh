@@ -20,6 +20,7 @@
 #include <map>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include "ignition/rendering/Mesh.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/Storage.hh"
@@ -74,6 +75,21 @@ namespace ignition
       public: virtual void UpdateSkeletonAnimation(
             std::chrono::steady_clock::duration _time) override;
 
+      // Documentation inherited.
+      public: virtual std::vector<std::string> SkeletonBoneNames() const
+            override;
+
+      // Documentation inherited.
+      public: virtual void SetSkeletonBoneTransforms(
+            const std::vector<math::Matrix4d> &_tfs) override;
+
+      // Documentation inherited.
+      public: virtual bool ShareSkeleton(MeshPtr _mesh) override;
+
+      // Documentation inherited.
+      public: virtual bool UpdateVertices(const float *_positions,
+                  const float *_normals, unsigned int _vertexCount) override;
+
       public: virtual unsigned int SubMeshCount() const override;
 
       public: virtual bool HasSubMesh(ConstSubMeshPtr _subMesh) const override;
@@ -238,6 +254,36 @@ namespace ignition
     {
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    std::vector<std::string> BaseMesh<T>::SkeletonBoneNames() const
+    {
+      return std::vector<std::string>();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseMesh<T>::SetSkeletonBoneTransforms(
+        const std::vector<math::Matrix4d> &)
+    {
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseMesh<T>::ShareSkeleton(MeshPtr)
+    {
+      return false;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseMesh<T>::UpdateVertices(const float *, const float *,
+        unsigned int)
+    {
+      // no op, in place vertex updates are not supported
+      return false;
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     unsigned int BaseMesh<T>::SubMeshCount() const
@@ -183,8 +183,35 @@ namespace ignition
       // Documentation inherited
       public: virtual bool HasUserData(const std::string &_key) const override;
 
+      // Documentation inherited
+      public: virtual void MarkPreRenderDirty() override;
+
+      // Documentation inherited
+      public: virtual bool PreRenderDirty() const override;
+
       protected: virtual void PreRenderChildren();
 
+      /// \brief Get whether PreRender has nothing to update on this node
+      /// unless the node is marked dirty. Nodes returning false are updated
+      /// by every Scene::PreRender call together with their ancestors.
+      /// Visuals that update something every frame regardless of their
+      /// dirty state, such as particle emitters or visuals that rebuild
+      /// their geometry in PreRender, override this to return false so that
+      /// their parent's PreRender never skips them.
+      /// \return True if the node can be skipped while it is not dirty
+      /// \sa MarkPreRenderDirty
+      protected: virtual bool PreRenderStatic() const;
+
+      /// \brief Mark the cached world pose of this node and of all its
+      /// descendants as outdated. Called when the local pose, the origin or
+      /// the parent of the node changes.
+      protected: void MarkWorldPoseDirty();
+
+      /// \brief Mark the cached world pose of a node and of all its
+      /// descendants as outdated
+      /// \param[in] _node Node to mark, may be null
+      protected: static void MarkWorldPoseDirty(const NodePtr &_node);
+
       protected: virtual math::Pose3d RawLocalPose() const = 0;
 
       protected: virtual void SetRawLocalPose(const math::Pose3d &_pose) = 0;
@@ -212,6 +239,17 @@ namespace ignition
 
       /// \brief A map of custom key value data
       protected: std::map<std::string, Variant> userData;
+
+      /// \brief True if the node or one of its descendants needs to be
+      /// updated by the next PreRender call
+      protected: bool preRenderDirty = true;
+
+      /// \brief World pose computed by the last WorldPose call
+      protected: mutable math::Pose3d worldPose;
+
+      /// \brief True if worldPose is outdated. The world poses of the
+      /// descendants of a node with an outdated world pose are outdated too.
+      protected: mutable bool worldPoseDirty = true;
     };
 
     //////////////////////////////////////////////////
@@ -254,6 +292,11 @@ namespace ignition
       if (this->AttachChild(_child))
       {
         this->Children()->Add(_child);
+        MarkWorldPoseDirty(_child);
+        if (_child->PreRenderDirty())
+          this->MarkPreRenderDirty();
+        else
+          _child->MarkPreRenderDirty();
       }
     }
 
@@ -263,6 +306,7 @@ namespace ignition
     {
       NodePtr child = this->Children()->Remove(_child);
       if (child) this->DetachChild(child);
+      MarkWorldPoseDirty(child);
       return child;
     }
 
@@ -272,6 +316,7 @@ namespace ignition
     {
       NodePtr child = this->Children()->RemoveById(_id);
       if (child) this->DetachChild(child);
+      MarkWorldPoseDirty(child);
       return child;
     }
 
@@ -281,6 +326,7 @@ namespace ignition
     {
       NodePtr child = this->Children()->RemoveByName(_name);
       if (child) this->DetachChild(child);
+      MarkWorldPoseDirty(child);
       return child;
     }
 
@@ -290,6 +336,7 @@ namespace ignition
     {
       NodePtr child = this->Children()->RemoveByIndex(_index);
       if (child) this->DetachChild(child);
+      MarkWorldPoseDirty(child);
       return child;
     }
 
@@ -307,8 +354,14 @@ namespace ignition
     template <class T>
     void BaseNode<T>::PreRender()
     {
+      this->preRenderDirty = false;
       T::PreRender();
       this->PreRenderChildren();
+
+      // nodes that have something to update every frame stay dirty so that
+      // they, and their ancestors, are visited again
+      if (!this->PreRenderStatic())
+        this->preRenderDirty = true;
     }
 
     //////////////////////////////////////////////////
@@ -319,10 +372,77 @@ namespace ignition
 
       for (unsigned int i = 0; i < count; ++i)
       {
-        this->ChildByIndex(i)->PreRender();
+        NodePtr child = this->ChildByIndex(i);
+        if (!child->PreRenderDirty())
+          continue;
+
+        child->PreRender();
+        if (child->PreRenderDirty())
+          this->preRenderDirty = true;
       }
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseNode<T>::MarkPreRenderDirty()
+    {
+      // ancestors of a dirty node are always dirty. This keeps marking many
+      // siblings, e.g. through Scene::SetLocalPoses, from walking up to the
+      // root each time
+      if (this->preRenderDirty)
+        return;
+
+      this->preRenderDirty = true;
+
+      NodePtr parent = this->Parent();
+      if (parent)
+        parent->MarkPreRenderDirty();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseNode<T>::PreRenderDirty() const
+    {
+      return this->preRenderDirty;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseNode<T>::PreRenderStatic() const
+    {
+      return false;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseNode<T>::MarkWorldPoseDirty()
+    {
+      // descendants of a dirty node are always dirty, so marking stops at
+      // nodes that are already dirty. This also keeps the marking done by
+      // SetLocalPose from touching other nodes when they were all marked
+      // beforehand, e.g. by Scene::SetLocalPoses.
+      if (this->worldPoseDirty)
+        return;
+
+      this->worldPoseDirty = true;
+
+      NodeStorePtr children = this->Children();
+      if (!children)
+        return;
+
+      for (unsigned int i = 0; i < children->Size(); ++i)
+        MarkWorldPoseDirty(children->GetByIndex(i));
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseNode<T>::MarkWorldPoseDirty(const NodePtr &_node)
+    {
+      BaseNode<T> *node = dynamic_cast<BaseNode<T> *>(_node.get());
+      if (node)
+        node->MarkWorldPoseDirty();
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     math::Pose3d BaseNode<T>::LocalPose() const
@@ -353,6 +473,8 @@ namespace ignition
       }
 
       this->SetRawLocalPose(pose);
+      this->MarkPreRenderDirty();
+      this->MarkWorldPoseDirty();
     }
 
     //////////////////////////////////////////////////
@@ -420,15 +542,20 @@ namespace ignition
     template <class T>
     math::Pose3d BaseNode<T>::WorldPose() const
     {
+      // the world pose is only recomposed after the node or one of its
+      // ancestors moved
+      if (!this->worldPoseDirty)
+        return this->worldPose;
+
       NodePtr parent = this->Parent();
       math::Pose3d pose = this->LocalPose();
 
-      if (!parent)
-      {
-        return pose;
-      }
+      if (parent)
+        pose = pose + parent->WorldPose();
 
-      return pose + parent->WorldPose();
+      this->worldPose = pose;
+      this->worldPoseDirty = false;
+      return pose;
     }
 
     //////////////////////////////////////////////////
@@ -526,6 +653,8 @@ namespace ignition
     void BaseNode<T>::SetOrigin(const math::Vector3d &_origin)
     {
       this->origin = _origin;
+      this->MarkPreRenderDirty();
+      this->MarkWorldPoseDirty();
     }
 
     //////////////////////////////////////////////////
@@ -50,6 +50,10 @@ namespace ignition
       // Documentation inherited
       public: virtual void PreRender() override;
 
+      // Documentation inherited.
+      protected: virtual bool PreRenderStatic() const override
+                 { return false; }
+
       /// \brief Reset the particle emitter visual state
       public: virtual void Reset();
 
@@ -143,6 +147,12 @@ namespace ignition
       // Documentation inherited.
       public: virtual void SetParticleScatterRatio(float _ratio) override;
 
+      // Documentation inherited.
+      public: virtual void SetGpuSimulationEnabled(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual bool GpuSimulationEnabled() const override;
+
       /// \brief Emitter type.
       protected: EmitterType type = EM_POINT;
 
@@ -197,6 +207,9 @@ namespace ignition
       /// should be > 0.
       protected: float particleScatterRatio = 0.65f;
 
+      /// \brief True if the particles are simulated on the GPU
+      protected: bool gpuSimulation = false;
+
       /// \brief Only the scene can create a particle emitter
       private: friend class BaseScene;
     };
@@ -435,6 +448,20 @@ namespace ignition
       if (_ratio > 0.0f)
         this->particleScatterRatio = _ratio;
     }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseParticleEmitter<T>::SetGpuSimulationEnabled(bool)
+    {
+      // no op, GPU particle simulation is not supported
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    bool BaseParticleEmitter<T>::GpuSimulationEnabled() const
+    {
+      return this->gpuSimulation;
+    }
     }
   }
 }
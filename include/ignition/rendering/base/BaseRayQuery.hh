@@ -17,6 +17,8 @@
 #ifndef IGNITION_RENDERING_BASE_BASERAYQUERY_HH_
 #define IGNITION_RENDERING_BASE_BASERAYQUERY_HH_
 
+#include <vector>
+
 #include <ignition/math/Matrix4.hh>
 #include <ignition/math/Vector3.hh>
 
@@ -62,6 +64,10 @@ namespace ignition
       // Documentation inherited
       public: virtual RayQueryResult ClosestPoint() override;
 
+      // Documentation inherited
+      public: virtual std::vector<RayQueryResult> ClosestPoints(
+                  const std::vector<math::Line3d> &_rays) override;
+
       /// \brief Ray origin
       protected: math::Vector3d origin;
 
@@ -149,6 +155,28 @@ namespace ignition
       result.distance = -1;
       return result;
     }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    std::vector<RayQueryResult> BaseRayQuery<T>::ClosestPoints(
+        const std::vector<math::Line3d> &_rays)
+    {
+      math::Vector3d prevOrigin = this->origin;
+      math::Vector3d prevDirection = this->direction;
+
+      std::vector<RayQueryResult> results;
+      results.reserve(_rays.size());
+      for (const auto &ray : _rays)
+      {
+        this->origin = ray[0];
+        this->direction = ray.Direction();
+        results.push_back(this->ClosestPoint());
+      }
+
+      this->origin = prevOrigin;
+      this->direction = prevDirection;
+      return results;
+    }
     }
   }
 }
@@ -97,6 +97,16 @@ namespace ignition
       // Documentation Inherited
       public: virtual RenderPassSystemPtr RenderPassSystem() const override;
 
+      // Documentation Inherited
+      public: virtual rendering::MemoryStats MemoryStats() const override;
+
+      // Documentation Inherited
+      public: virtual RenderThreadPtr RenderThread() const override;
+
+      // Documentation Inherited
+      public: virtual void SetRenderThread(RenderThreadPtr _thread)
+                  override;
+
       protected: virtual void PrepareScene(ScenePtr _scene);
 
       protected: virtual unsigned int NextSceneId();
@@ -131,6 +141,9 @@ namespace ignition
 
       /// \brief Render pass system for this render engine.
       protected: RenderPassSystemPtr renderPassSystem;
+
+      /// \brief Thread that owns this engine, null if none
+      protected: RenderThreadPtr renderThread;
       IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
     };
     }
@@ -17,9 +17,11 @@
 #ifndef IGNITION_RENDERING_BASE_BASERENDERTARGET_HH_
 #define IGNITION_RENDERING_BASE_BASERENDERTARGET_HH_
 
+#include <functional>
 #include <string>
 #include <vector>
 
+#include "ignition/rendering/PixelFormat.hh"
 #include "ignition/rendering/RenderPass.hh"
 #include "ignition/rendering/RenderTarget.hh"
 #include "ignition/rendering/Scene.hh"
@@ -58,6 +60,16 @@ namespace ignition
 
       public: virtual void SetFormat(PixelFormat _format) override;
 
+      // Documentation inherited
+      public: virtual bool CopyAsync(Image &_image,
+                  std::function<void()> _callback) override;
+
+      // Documentation inherited
+      public: virtual void WaitForAsyncCopies() override;
+
+      // Documentation inherited
+      public: virtual bool CopyI420(Image &_image) override;
+
       // Documentation inherited
       public: virtual math::Color BackgroundColor() const override;
 
@@ -105,6 +117,9 @@ namespace ignition
 
       // Documentation inherited.
       public: virtual unsigned int GLId() const override;
+
+      // Documentation inherited.
+      public: virtual void MetalId(void *_textureIdPtr) const override;
     };
 
     template <class T>
@@ -221,6 +236,56 @@ namespace ignition
       this->targetDirty = true;
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseRenderTarget<T>::CopyAsync(Image &_image,
+        std::function<void()> _callback)
+    {
+      if (_image.Width() != this->Width() || _image.Height() != this->Height())
+      {
+        ignerr << "Invalid image dimensions" << std::endl;
+        return false;
+      }
+
+      this->Copy(_image);
+      if (_callback)
+        _callback();
+      return true;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseRenderTarget<T>::WaitForAsyncCopies()
+    {
+      // copies are synchronous by default
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseRenderTarget<T>::CopyI420(Image &_image)
+    {
+      if (_image.Format() != PF_L8 || _image.Width() != this->Width() ||
+          _image.Height() != this->Height() * 3u / 2u ||
+          this->Width() % 2u != 0u || this->Height() % 2u != 0u)
+      {
+        ignerr << "Invalid I420 image dimensions or format" << std::endl;
+        return false;
+      }
+
+      if (_image.RowPitch() != _image.Width())
+      {
+        ignerr << "I420 images with row padding are not supported"
+               << std::endl;
+        return false;
+      }
+
+      // convert on the CPU by default
+      Image rgb(this->Width(), this->Height(), PF_R8G8B8);
+      this->Copy(rgb);
+      return PixelUtil::ConvertToI420(rgb.Data<unsigned char>(), PF_R8G8B8,
+          _image.Data<unsigned char>(), this->Width(), this->Height());
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     math::Color BaseRenderTarget<T>::BackgroundColor() const
@@ -291,6 +356,12 @@ namespace ignition
       return 0u;
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseRenderTexture<T>::MetalId(void */*_textureIdPtr*/) const
+    {
+    }
+
     //////////////////////////////////////////////////
     // BaseRenderWindow
     //////////////////////////////////////////////////
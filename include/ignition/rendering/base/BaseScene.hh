@@ -18,12 +18,16 @@
 #define IGNITION_RENDERING_BASE_BASESCENE_HH_
 
 #include <array>
+#include <atomic>
+#include <functional>
 #include <set>
 #include <string>
+#include <vector>
 
 #include <ignition/common/Console.hh>
 #include <ignition/common/SuppressWarning.hh>
 
+#include "ignition/rendering/AxisAlignedBoxTree.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/Scene.hh"
 #include "ignition/rendering/base/BaseRenderTypes.hh"
@@ -131,6 +135,11 @@ namespace ignition
 
       public: virtual void DestroyNodes() override;
 
+      // Documentation inherited.
+      public: virtual unsigned int SetLocalPoses(
+                  const std::vector<unsigned int> &_ids,
+                  const std::vector<math::Pose3d> &_poses) override;
+
       public: virtual unsigned int LightCount() const override;
 
       public: virtual bool HasLight(ConstLightPtr _light) const override;
@@ -211,6 +220,22 @@ namespace ignition
       public: virtual VisualPtr VisualAt(const CameraPtr &_camera,
                           const ignition::math::Vector2i &_mousePos) override;
 
+      // Documentation inherited
+      public: virtual std::vector<VisualPtr> VisualsInBox(
+                  const math::AxisAlignedBox &_box) override;
+
+      // Documentation inherited
+      public: virtual std::vector<VisualPtr> VisualsInSphere(
+                  const math::Vector3d &_center, double _radius) override;
+
+      // Documentation inherited
+      public: virtual std::vector<VisualPtr> VisualsInFrustum(
+                  const CameraPtr &_camera) override;
+
+      // Documentation inherited
+      public: virtual std::vector<VisualPtr> NearestVisuals(
+                  const math::Vector3d &_point, unsigned int _count) override;
+
       // Documentation inherited.
       public: virtual void DestroyVisual(VisualPtr _visual,
           bool _recursive = false) override;
@@ -368,6 +393,21 @@ namespace ignition
       public: virtual SegmentationCameraPtr CreateSegmentationCamera(
         const unsigned int _id, const std::string &_name) override;
 
+      // Documentation inherited.
+      public: virtual WideAngleCameraPtr CreateWideAngleCamera() override;
+
+      // Documentation inherited.
+      public: virtual WideAngleCameraPtr CreateWideAngleCamera(
+        const unsigned int _id) override;
+
+      // Documentation inherited.
+      public: virtual WideAngleCameraPtr CreateWideAngleCamera(
+        const std::string &_name) override;
+
+      // Documentation inherited.
+      public: virtual WideAngleCameraPtr CreateWideAngleCamera(
+        const unsigned int _id, const std::string &_name) override;
+
       // Documentation inherited.
       public: virtual GpuRaysPtr CreateGpuRays() override;
 
@@ -527,6 +567,11 @@ namespace ignition
       public: virtual LidarVisualPtr CreateLidarVisual(unsigned int _id,
                                             const std::string &_name) override;
 
+      // Documentation inherited.
+      public: virtual InstancedVisualPtr CreateInstancedVisual(
+                  const MeshDescriptor &_desc, MaterialPtr _material,
+                  unsigned int _count) override;
+
       // Documentation inherited.
       public: virtual HeightmapPtr CreateHeightmap(
           const HeightmapDescriptor &_desc) override;
@@ -575,6 +620,26 @@ namespace ignition
 
       public: virtual void Clear() override;
 
+      // Documentation inherited.
+      public: virtual void Reset() override;
+
+      // Documentation inherited.
+      public: virtual ScenePtr CreateInstance(const std::string &_name)
+                  override;
+
+      // Documentation inherited.
+      public: virtual bool SaveSnapshot(const std::string &_filename)
+                  override;
+
+      // Documentation inherited.
+      public: virtual bool LoadSnapshot(const std::string &_filename)
+                  override;
+
+      // Documentation inherited.
+      public: virtual VisualPtr BakeStatic(
+                  const std::vector<VisualPtr> &_visuals,
+                  double _chunkSize = 50.0) override;
+
       public: virtual void Destroy() override;
 
       // Documentation inherited.
@@ -590,6 +655,39 @@ namespace ignition
       // Documentation inherited.
       public: virtual bool LegacyAutoGpuFlush() const override;
 
+      // Documentation inherited.
+      public: virtual void RenderSensors(
+                  const std::vector<SensorPtr> &_sensors) override;
+
+      // Documentation inherited.
+      public: virtual void WarmUp() override;
+
+      // Documentation inherited.
+      public: virtual SensorSchedulerPtr Scheduler() override;
+
+      // Documentation inherited.
+      public: virtual RenderStats GpuStats() const override;
+
+      // Documentation inherited.
+      public: virtual void SetFrameBudget(double _ms) override;
+
+      // Documentation inherited.
+      public: virtual double FrameBudget() const override;
+
+      // Documentation inherited.
+      public: virtual rendering::MemoryStats MemoryStats() const override;
+
+      // Documentation inherited.
+      public: virtual void QueueCommand(std::function<void()> _command)
+                  override;
+
+      // Documentation inherited.
+      public: virtual unsigned int ProcessCommands() override;
+
+      // Documentation inherited.
+      public: virtual void PrepareMesh(const MeshDescriptor &_desc)
+                  override;
+
       protected: virtual unsigned int CreateObjectId();
 
       protected: virtual std::string CreateObjectName(unsigned int _id,
@@ -661,6 +759,22 @@ namespace ignition
                    return SegmentationCameraPtr();
                  }
 
+      /// \brief Implementation for creating a wide angle camera.
+      /// \param[in] _id Unique id
+      /// \param[in] _name Name of wide angle camera
+      /// \return Pointer to wide angle camera
+      protected: virtual WideAngleCameraPtr CreateWideAngleCameraImpl(
+                     unsigned int _id,
+                     const std::string &_name)
+                 {
+                   // The following two lines will avoid doxygen warnings
+                   (void)_id;
+                   (void)_name;
+                   ignerr << "Wide angle camera not supported by: "
+                          << this->Engine()->Name() << std::endl;
+                   return WideAngleCameraPtr();
+                 }
+
       /// \brief Implementation for creating GpuRays sensor.
       /// \param[in] _id Unique id
       /// \param[in] _name Name of GpuRays sensor
@@ -743,6 +857,28 @@ namespace ignition
       protected: virtual LidarVisualPtr CreateLidarVisualImpl(unsigned int _id,
                      const std::string &_name) = 0;
 
+      /// \brief Implementation for creating an instanced visual
+      /// \param[in] _id Unique object id
+      /// \param[in] _name Unique object name
+      /// \param[in] _desc Descriptor of the mesh of the instances
+      /// \param[in] _material Material of the instances, may be null
+      /// \param[in] _count Number of instances
+      /// \return Pointer to an instanced visual
+      protected: virtual InstancedVisualPtr CreateInstancedVisualImpl(
+                     unsigned int _id, const std::string &_name,
+                     const MeshDescriptor &_desc, MaterialPtr _material,
+                     unsigned int _count)
+                 {
+                   (void)_id;
+                   (void)_name;
+                   (void)_desc;
+                   (void)_material;
+                   (void)_count;
+                   ignerr << "InstancedVisual not supported by: "
+                          << this->Engine()->Name() << std::endl;
+                   return InstancedVisualPtr();
+                 }
+
       /// \brief Implementation for creating a heightmap geometry
       /// \param[in] _id Unique object id.
       /// \param[in] _name Unique object name.
@@ -805,6 +941,31 @@ namespace ignition
 
       protected: virtual MaterialMapPtr Materials() const = 0;
 
+      /// \brief Copy the settings of this scene, such as the ambient light
+      /// and the background, to an instance created by CreateInstance. This
+      /// is called before the lights and visuals are copied.
+      /// \param[in] _instance Scene instance
+      protected: virtual void CopySettings(const ScenePtr &_instance) const;
+
+      /// \brief Bring the visual index up to date before a query. The
+      /// default implementation updates the bounding box of every visual,
+      /// engines that track changes to the bounding boxes can refresh only
+      /// the visuals that changed once visualIndexBuilt is true.
+      protected: virtual void UpdateVisualIndex();
+
+      /// \brief Check if a node is attached to the scene graph, i.e. is a
+      /// descendant of the root visual
+      /// \param[in] _node Node to check
+      /// \return True if the node is below the root visual
+      protected: bool InSceneGraph(const NodePtr &_node) const;
+
+      /// \brief Bounding volume hierarchy over the world bounding boxes of
+      /// the visuals attached to the scene graph, indexed by visual id
+      protected: AxisAlignedBoxTree visualIndex;
+
+      /// \brief True once the first query built the visual index
+      protected: bool visualIndexBuilt = false;
+
       protected: virtual bool LoadImpl() = 0;
 
       protected: virtual bool InitImpl() = 0;
@@ -854,11 +1015,68 @@ namespace ignition
       /// \brief Scene background material.
       protected: MaterialPtr backgroundMaterial;
 
+      /// \brief Get the visuals of ids returned by the visual index. Ids
+      /// of visuals destroyed since they were indexed are removed.
+      /// \param[in] _ids Visual ids
+      /// \return Visuals of the ids
+      private: std::vector<VisualPtr> IndexedVisuals(
+                   const std::vector<unsigned int> &_ids);
+
+      /// \brief Delete all queued commands without running them
+      private: void DiscardCommands();
+
+      /// \brief Adjust the resolution scales of the cameras to the frame
+      /// budget, see SetFrameBudget. Called by PreRender.
+      private: void UpdateResolutionScales();
+
+      /// \brief Set the resolution scale of the cameras that allow a lower
+      /// resolution
+      /// \param[in] _factor Factor to multiply the current scales with
+      private: void ScaleResolutions(double _factor);
+
+      /// \brief GPU time budget of a frame in milliseconds, 0 if disabled
+      private: double frameBudget = 0.0;
+
+      /// \brief Sum of the GPU times of the frames measured since the
+      /// resolution scales last changed
+      private: double frameBudgetTimeSum = 0.0;
+
+      /// \brief Number of frames in frameBudgetTimeSum
+      private: unsigned int frameBudgetSamples = 0u;
+
+      /// \brief Frame count of the GPU stats last added to
+      /// frameBudgetTimeSum
+      private: unsigned int frameBudgetFrameCount = 0u;
+
+      /// \brief True once a missing GPU timing has been reported
+      private: bool frameBudgetWarned = false;
+
+      /// \brief Sensor scheduler, created on first use
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      private: SensorSchedulerPtr scheduler;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+
       private: unsigned int nextObjectId;
 
       IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
       private: NodeStorePtr nodes;
       IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
+
+      /// \brief A queued command, linked to the command queued before it
+      private: struct Command
+      {
+        /// \brief Function to run
+        std::function<void()> function;
+
+        /// \brief Command queued before this one
+        Command *next = nullptr;
+      };
+
+      /// \brief Last queued command. Producers push onto this list with a
+      /// compare and swap, the render thread takes the whole list at once.
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      private: std::atomic<Command *> commands{nullptr};
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
     };
     }
   }
@@ -84,6 +84,10 @@ namespace ignition
       public: void LabelMapFromColoredBuffer(
                   uint8_t *_labelBuffer) const override = 0;
 
+      // Documentation inherited
+      public: void SemanticLabelMap(
+                  uint8_t *_labelBuffer) const override = 0;
+
       /// \brief The buffer that contains segmentation data
       protected: uint8_t *segmentationData {nullptr};
 
@@ -17,6 +17,12 @@
 #ifndef IGNITION_RENDERING_BASE_BASESENSOR_HH_
 #define IGNITION_RENDERING_BASE_BASESENSOR_HH_
 
+#include <algorithm>
+#include <chrono>
+#include <deque>
+
+#include <ignition/common/SuppressWarning.hh>
+
 #include "ignition/rendering/Sensor.hh"
 
 namespace ignition
@@ -40,8 +46,73 @@ namespace ignition
       // Documentation inherited.
       public: virtual uint32_t VisibilityMask() const override;
 
+      // Documentation inherited.
+      public: virtual RenderStats GpuStats() const override;
+
+      // Documentation inherited.
+      public: virtual rendering::DrawStats DrawStats() const override;
+
+      // Documentation inherited.
+      public: virtual rendering::FrameTimings FrameTimings() const override;
+
+      // Documentation inherited.
+      public: virtual void SetIdleTimeout(double _seconds) override;
+
+      // Documentation inherited.
+      public: virtual double IdleTimeout() const override;
+
+      /// \brief Get whether the sensor has not rendered for longer than the
+      /// idle timeout, i.e. whether its GPU resources should be released
+      /// \return True if the resources should be released
+      /// \sa SetIdleTimeout
+      protected: bool IdleTimeoutExpired() const;
+
+      /// \brief Record that the render commands of a new frame are being
+      /// submitted. To be called at the start of Render.
+      /// \param[in] _time Time the frame was submitted
+      protected: void RecordFrameSubmit(
+                     rendering::FrameTimings::Clock::time_point _time =
+                     rendering::FrameTimings::Clock::now());
+
+      /// \brief Record that the oldest submitted frame is done on the GPU.
+      /// To be called once its data is available to the CPU.
+      /// \param[in] _reprojected True if the frame was reprojected from the
+      /// last rendered frame instead of being rendered
+      protected: void RecordFrameGpuComplete(bool _reprojected = false);
+
+      /// \brief Record that the frame data was converted into the sensor
+      /// output. To be called just before the new frame callbacks.
+      protected: void RecordFrameReadback();
+
+      /// \brief Record that the new frame callbacks returned
+      protected: void RecordFrameDelivered();
+
+      /// \brief Record that the oldest submitted frame will not be
+      /// delivered, e.g. because nobody is subscribed to it
+      protected: void RecordFrameDropped();
+
       /// \brief Camera's visibility mask
       protected: uint32_t visibilityMask = IGN_VISIBILITY_ALL;
+
+      /// \brief Time without rendering after which the GPU resources are
+      /// released, in seconds. 0 to never release them.
+      protected: double idleTimeout = 0.0;
+
+      /// \brief Time the last frame was submitted
+      protected: rendering::FrameTimings::Clock::time_point lastSubmitTime;
+
+      /// \brief Timings of the frame being or last delivered
+      protected: rendering::FrameTimings frameTimings;
+
+      /// \brief Draw counts of the last rendered frame, for render engines
+      /// that count them when rendering
+      protected: rendering::DrawStats drawStats;
+
+      IGN_COMMON_WARN_IGNORE__DLL_INTERFACE_MISSING
+      /// \brief Submit times of frames not delivered yet, oldest first
+      protected: std::deque<rendering::FrameTimings::Clock::time_point>
+          frameSubmitTimes;
+      IGN_COMMON_WARN_RESUME__DLL_INTERFACE_MISSING
     };
 
     //////////////////////////////////////////////////
@@ -69,6 +140,121 @@ namespace ignition
     {
       return this->visibilityMask;
     }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    RenderStats BaseSensor<T>::GpuStats() const
+    {
+      return RenderStats();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    rendering::DrawStats BaseSensor<T>::DrawStats() const
+    {
+      return this->drawStats;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    rendering::FrameTimings BaseSensor<T>::FrameTimings() const
+    {
+      return this->frameTimings;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseSensor<T>::SetIdleTimeout(double _seconds)
+    {
+      this->idleTimeout = std::max(_seconds, 0.0);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    double BaseSensor<T>::IdleTimeout() const
+    {
+      return this->idleTimeout;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseSensor<T>::IdleTimeoutExpired() const
+    {
+      if (this->idleTimeout <= 0.0)
+        return false;
+
+      std::chrono::duration<double> idle =
+          rendering::FrameTimings::Clock::now() - this->lastSubmitTime;
+      return idle.count() > this->idleTimeout;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseSensor<T>::RecordFrameSubmit(
+        rendering::FrameTimings::Clock::time_point _time)
+    {
+      this->lastSubmitTime = _time;
+      // frames that are rendered but never read back would pile up
+      const size_t maxPendingFrames = 16u;
+      if (this->frameSubmitTimes.size() >= maxPendingFrames)
+        this->frameSubmitTimes.pop_front();
+      this->frameSubmitTimes.push_back(_time);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseSensor<T>::RecordFrameGpuComplete(bool _reprojected)
+    {
+      auto now = rendering::FrameTimings::Clock::now();
+      this->frameTimings.frameId++;
+      this->frameTimings.reprojected = _reprojected;
+      if (this->frameSubmitTimes.empty())
+      {
+        // read back without rendering, e.g. a copy of the last frame
+        this->frameTimings.submitTime = now;
+      }
+      else
+      {
+        this->frameTimings.submitTime = this->frameSubmitTimes.front();
+        this->frameSubmitTimes.pop_front();
+      }
+      this->frameTimings.gpuCompleteTime = now;
+      this->frameTimings.readbackCompleteTime = now;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseSensor<T>::RecordFrameDropped()
+    {
+      if (!this->frameSubmitTimes.empty())
+        this->frameSubmitTimes.pop_front();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseSensor<T>::RecordFrameReadback()
+    {
+      this->frameTimings.readbackCompleteTime =
+          rendering::FrameTimings::Clock::now();
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseSensor<T>::RecordFrameDelivered()
+    {
+      this->frameTimings.callbackCompleteTime =
+          rendering::FrameTimings::Clock::now();
+
+      // rolling average with the same weight as the gpu timings
+      const double weight = 0.05;
+      double latency = this->frameTimings.LatencyMs();
+      double alpha = this->frameTimings.frameCount == 0u ? 1.0 : weight;
+      this->frameTimings.averageLatencyMs +=
+          alpha * (latency - this->frameTimings.averageLatencyMs);
+      this->frameTimings.maxLatencyMs =
+          std::max(this->frameTimings.maxLatencyMs, latency);
+      this->frameTimings.frameCount++;
+    }
     }
   }
 }
@@ -17,9 +17,11 @@
 #ifndef IGNITION_RENDERING_BASE_BASESTORAGE_HH_
 #define IGNITION_RENDERING_BASE_BASESTORAGE_HH_
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <ignition/common/Console.hh>
@@ -191,7 +193,20 @@ namespace ignition
 
       protected: virtual UIter RemoveConstness(ConstUIter _iter);
 
+      /// \brief Get the position of the given name in orderIndex
+      /// \param[in] _name Name of the item
+      /// \return Iterator to the first entry not ordered before _name
+      protected: typename std::vector<UIter>::iterator OrderIndexIter(
+                     const std::string &_name);
+
       protected: UStore store;
+
+      /// \brief Iterators into store indexed by item id
+      protected: std::unordered_map<unsigned int, UIter> idIndex;
+
+      /// \brief Iterators into store in store order, i.e. sorted by name,
+      /// for constant time access by index
+      protected: std::vector<UIter> orderIndex;
     };
 
     //////////////////////////////////////////////////
@@ -689,6 +704,8 @@ namespace ignition
     void BaseStore<T, U>::RemoveAll()
     {
       this->store.clear();
+      this->idIndex.clear();
+      this->orderIndex.clear();
     }
 
     //////////////////////////////////////////////////
@@ -816,18 +833,14 @@ namespace ignition
     typename BaseStore<T, U>::ConstUIter
     BaseStore<T, U>::ConstIter(ConstTPtr _object) const
     {
-      auto begin = this->store.begin();
-      auto end = this->store.end();
-
-      for (auto iter = begin; iter != end; ++iter)
+      if (!_object)
       {
-        if (iter->second == _object)
-        {
-          return iter;
-        }
+        return this->store.end();
       }
 
-      return end;
+      auto iter = this->ConstIterById(_object->Id());
+      return (this->IsValidIter(iter) && iter->second == _object) ?
+          iter : this->store.end();
     }
 
     //////////////////////////////////////////////////
@@ -835,18 +848,8 @@ namespace ignition
     typename BaseStore<T, U>::ConstUIter
     BaseStore<T, U>::ConstIterById(unsigned int _id) const
     {
-      auto begin = this->store.begin();
-      auto end = this->store.end();
-
-      for (auto iter = begin; iter != end; ++iter)
-      {
-        if (iter->second->Id() == _id)
-        {
-          return iter;
-        }
-      }
-
-      return end;
+      auto iter = this->idIndex.find(_id);
+      return (iter != this->idIndex.end()) ? iter->second : this->store.end();
     }
 
     //////////////////////////////////////////////////
@@ -868,9 +871,7 @@ namespace ignition
         return this->store.end();
       }
 
-      auto iter = this->store.begin();
-      std::advance(iter, _index);
-      return iter;
+      return this->orderIndex[_index];
     }
 
     //////////////////////////////////////////////////
@@ -929,7 +930,9 @@ namespace ignition
         return false;
       }
 
-      this->store[name] = _object;
+      auto iter = this->store.emplace(name, _object).first;
+      this->idIndex[id] = iter;
+      this->orderIndex.insert(this->OrderIndexIter(name), iter);
       return true;
     }
 
@@ -944,6 +947,10 @@ namespace ignition
       }
 
       UPtr result = _iter->second;
+      this->idIndex.erase(result->Id());
+      auto orderIter = this->OrderIndexIter(_iter->first);
+      if (orderIter != this->orderIndex.end() && *orderIter == _iter)
+        this->orderIndex.erase(orderIter);
       this->store.erase(_iter);
       return result;
     }
@@ -972,6 +979,19 @@ namespace ignition
           this->store.erase(_iter, _iter) : this->store.end();
     }
 
+    //////////////////////////////////////////////////
+    template <class T, class U>
+    typename std::vector<typename BaseStore<T, U>::UIter>::iterator
+    BaseStore<T, U>::OrderIndexIter(const std::string &_name)
+    {
+      return std::lower_bound(this->orderIndex.begin(),
+          this->orderIndex.end(), _name,
+          [](const UIter &_iter, const std::string &_key)
+          {
+            return _iter->first < _key;
+          });
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     BaseCompositeStore<T>::BaseCompositeStore()
@@ -17,6 +17,7 @@
 #ifndef IGNITION_RENDERING_BASE_BASETHERMALCAMERA_HH_
 #define IGNITION_RENDERING_BASE_BASETHERMALCAMERA_HH_
 
+#include <memory>
 #include <string>
 
 #include "ignition/rendering/base/BaseCamera.hh"
@@ -77,11 +78,23 @@ namespace ignition
       // Documentation inherited.
       public: virtual void SetHeatSourceTemperatureRange(float _range) override;
 
+      // Documentation inherited.
+      public: virtual void SetLinkedCamera(const CameraPtr &_camera) override;
+
+      // Documentation inherited.
+      public: virtual CameraPtr LinkedCamera() const override;
+
       // Documentation inherted.
       public: virtual ignition::common::ConnectionPtr ConnectNewThermalFrame(
           std::function<void(const uint16_t *, unsigned int, unsigned int,
           unsigned int, const std::string &)>  _subscriber) override;
 
+      // Documentation inherited.
+      public: virtual ignition::common::ConnectionPtr
+          ConnectNewThermalFrameView(
+          std::function<void(const void *, unsigned int, unsigned int,
+          unsigned int, const std::string &)> _subscriber) override;
+
       /// \brief Ambient temperature of the environment
       protected: float ambient = 0.0f;
 
@@ -99,12 +112,17 @@ namespace ignition
 
       /// \brief Range of heat source temperature variation
       protected: float heatSourceTempRange = 0.0f;
+
+      /// \brief Camera to share the depth of
+      protected: std::weak_ptr<Camera> linkedCamera;
     };
 
     //////////////////////////////////////////////////
     template <class T>
     BaseThermalCamera<T>::BaseThermalCamera()
     {
+      // thermal sensors have a low resolution, distant details are lost
+      this->lodBias = 0.5;
     }
 
     //////////////////////////////////////////////////
@@ -190,6 +208,20 @@ namespace ignition
       this->heatSourceTempRange =  _range;
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseThermalCamera<T>::SetLinkedCamera(const CameraPtr &)
+    {
+      // no op, linked cameras are not supported
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    CameraPtr BaseThermalCamera<T>::LinkedCamera() const
+    {
+      return this->linkedCamera.lock();
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     float BaseThermalCamera<T>::HeatSourceTemperatureRange() const
@@ -205,6 +237,15 @@ namespace ignition
     {
       return nullptr;
     }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    common::ConnectionPtr BaseThermalCamera<T>::ConnectNewThermalFrameView(
+          std::function<void(const void *, unsigned int, unsigned int,
+          unsigned int, const std::string &)>)
+    {
+      return nullptr;
+    }
   }
   }
 }
@@ -22,6 +22,7 @@
 
 #include <ignition/math/AxisAlignedBox.hh>
 
+#include "ignition/rendering/Mesh.hh"
 #include "ignition/rendering/Visual.hh"
 #include "ignition/rendering/Storage.hh"
 #include "ignition/rendering/RenderEngine.hh"
@@ -100,6 +101,12 @@ namespace ignition
       // Documentation inherited.
       public: virtual void RemoveVisibilityFlags(uint32_t _flags) override;
 
+      // Documentation inherited.
+      public: virtual void SetStatic(bool _static) override;
+
+      // Documentation inherited.
+      public: virtual bool Static() const override;
+
       // Documentation inherited.
       public: virtual void PreRender() override;
 
@@ -122,6 +129,9 @@ namespace ignition
 
       protected: virtual void PreRenderGeometries();
 
+      // Documentation inherited
+      protected: virtual bool PreRenderStatic() const override;
+
       protected: virtual GeometryStorePtr Geometries() const = 0;
 
       protected: virtual bool AttachGeometry(GeometryPtr _geometry) = 0;
@@ -139,6 +149,9 @@ namespace ignition
 
       /// \brief True if wireframe mode is enabled else false
       protected: bool wireframe = false;
+
+      /// \brief True if the visual is static
+      protected: bool isStatic = false;
     };
 
     //////////////////////////////////////////////////
@@ -179,6 +192,8 @@ namespace ignition
       }
 
       this->SetRawLocalPose(rawPose);
+      this->MarkPreRenderDirty();
+      this->MarkWorldPoseDirty();
     }
 
     //////////////////////////////////////////////////
@@ -209,6 +224,7 @@ namespace ignition
       if (this->AttachGeometry(_geometry))
       {
         this->Geometries()->Add(_geometry);
+        this->MarkPreRenderDirty();
       }
     }
 
@@ -219,6 +235,7 @@ namespace ignition
       if (this->DetachGeometry(_geometry))
       {
         this->Geometries()->Remove(_geometry);
+        this->MarkPreRenderDirty();
       }
       return _geometry;
     }
@@ -293,6 +310,7 @@ namespace ignition
         GeometryPtr geometry = this->GeometryByIndex(i);
         geometry->SetMaterial(_material, false);
       }
+      this->MarkPreRenderDirty();
     }
 
     //////////////////////////////////////////////////
@@ -306,8 +324,8 @@ namespace ignition
     template <class T>
     void BaseVisual<T>::PreRender()
     {
+      // T::PreRender also updates the children
       T::PreRender();
-      this->PreRenderChildren();
       this->PreRenderGeometries();
     }
 
@@ -335,8 +353,40 @@ namespace ignition
       }
       for (auto it = children_->Begin(); it != children_->End(); ++it)
       {
+        if (!it->second->PreRenderDirty())
+          continue;
+
         it->second->PreRender();
+        if (it->second->PreRenderDirty())
+          this->preRenderDirty = true;
+      }
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseVisual<T>::PreRenderStatic() const
+    {
+      // meshes only update the shader parameters of their materials, so
+      // they have nothing to update unless they use custom shaders
+      unsigned int count = this->GeometryCount();
+      for (unsigned int i = 0; i < count; ++i)
+      {
+        MeshPtr mesh = std::dynamic_pointer_cast<Mesh>(
+            this->GeometryByIndex(i));
+        if (!mesh)
+          return false;
+
+        for (unsigned int j = 0; j < mesh->SubMeshCount(); ++j)
+        {
+          MaterialPtr mat = mesh->SubMeshByIndex(j)->Material();
+          if (mat && (!mat->VertexShader().empty() ||
+              !mat->FragmentShader().empty()))
+          {
+            return false;
+          }
+        }
       }
+      return true;
     }
 
     //////////////////////////////////////////////////
@@ -368,6 +418,20 @@ namespace ignition
              << std::endl;
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseVisual<T>::SetStatic(bool _static)
+    {
+      this->isStatic = _static;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    bool BaseVisual<T>::Static() const
+    {
+      return this->isStatic;
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseVisual<T>::SetVisible(bool _visible)
@@ -513,6 +577,7 @@ namespace ignition
       result->SetLocalPose(this->LocalPose());
       result->SetVisibilityFlags(this->VisibilityFlags());
       result->SetWireframe(this->Wireframe());
+      result->SetStatic(this->Static());
 
       // if the visual that was cloned has child visuals, clone those as well
       auto children_ =
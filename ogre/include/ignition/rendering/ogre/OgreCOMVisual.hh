@@ -54,6 +54,9 @@ namespace ignition
       // Documentation inherited.
       public: virtual void PreRender() override;
 
+      // Documentation inherited.
+      public: virtual void Destroy() override;
+
       // Documentation inherited.
       public: Ogre::MovableObject *OgreObject() const;
 
@@ -66,6 +66,9 @@ namespace ignition
       // Documentation inherited.
       public: virtual void SetNearClipPlane(const double _near) override;
 
+      // Documentation inherited.
+      public: virtual void SetLodBias(double _bias) override;
+
       public: virtual math::Color BackgroundColor() const;
 
       public: virtual void SetBackgroundColor(const math::Color &_color);
@@ -122,6 +122,12 @@ namespace ignition
       /// ogre camera has not been created.
       public: double FarClipPlane() const override;
 
+      // Documentation inherited.
+      public: virtual void SetAsyncReadback(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual bool AsyncReadback() const override;
+
       // Documentation inherited
       public: virtual void Destroy() override;
 
@@ -149,6 +155,15 @@ namespace ignition
       /// \brief Create point cloud texture. This stores xyz rgb data
       private: void CreatePointCloudTexture();
 
+      /// \brief Clamp the point cloud data in pcdBuffer, fill the depth
+      /// buffer and emit the new frame events
+      /// \param[in] _outputPoints True if the frame has color data and
+      /// point clouds are emitted
+      private: void ProcessDepthData(bool _outputPoints);
+
+      /// \brief Drop the frames whose asynchronous readback is pending
+      private: void DropPendingReadbacks();
+
       /// \brief Communicates that a frams was rendered
       protected: bool newData = false;
 
@@ -88,7 +88,9 @@ namespace ignition
        /// \param[in] _vertexCount The number of vertices the buffer must hold.
        /// \param[in] _indexCount The number of indices the buffer must hold.
        ///        This parameter is ignored if not using indices.
-      protected: void PrepareHardwareBuffers(size_t _vertexCount,
+       /// \return True if the vertex buffers were reallocated, in which case
+       ///         all vertices have to be written again.
+      protected: bool PrepareHardwareBuffers(size_t _vertexCount,
                                              size_t _indexCount);
 
        /// \brief Fills the hardware vertex and index buffers with data.
@@ -104,6 +106,10 @@ namespace ignition
 
       /// \brief Maximum capacity of the currently allocated index buffer.
       protected: size_t indexBufferCapacity = 0;
+
+      /// \brief Number of consecutive updates in which the vertex count was
+      /// small enough to shrink the vertex buffers
+      protected: unsigned int vertexShrinkCount = 0u;
     };
     }
   }
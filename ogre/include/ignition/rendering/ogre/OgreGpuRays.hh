@@ -55,7 +55,7 @@ namespace ignition
     **/
     /// \brief Gpu Rays used to render depth data into an image buffer
     class IGNITION_RENDERING_OGRE_VISIBLE OgreGpuRays :
-      public BaseGpuRays<OgreSensor>, public Ogre::RenderObjectListener
+      public BaseGpuRays<OgreSensor>, public Ogre::MaterialManager::Listener
     {
       /// \brief Constructor
       protected: OgreGpuRays();
@@ -84,6 +84,12 @@ namespace ignition
       // Documentation inherited.
       public: virtual void Copy(float *_data) override;
 
+      // Documentation inherited.
+      public: virtual void SetAsyncReadback(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual bool AsyncReadback() const override;
+
       // Documentation inherited.
       public: virtual common::ConnectionPtr ConnectNewGpuRaysFrame(
                   std::function<void(const float *_frame, unsigned int _width,
@@ -94,10 +100,12 @@ namespace ignition
       public: virtual RenderTargetPtr RenderTarget() const override;
 
       /// \internal
-      /// \brief Implementation of Ogre::RenderObjectListener
-      public: virtual void notifyRenderSingleObject(Ogre::Renderable *_rend,
-              const Ogre::Pass *_p, const Ogre::AutoParamDataSource *_s,
-              const Ogre::LightList *_ll, bool _supp) override;
+      /// \brief Implementation of Ogre::MaterialManager::Listener that
+      /// renders everything in the first pass with the laser material
+      public: virtual Ogre::Technique *handleSchemeNotFound(
+              uint16_t _schemeIndex, const Ogre::String &_schemeName,
+              Ogre::Material *_originalMaterial, uint16_t _lodIndex,
+              const Ogre::Renderable *_rend) override;
 
       /// \brief Set the number of samples in the width and height for the
       /// first pass texture.
@@ -134,6 +142,9 @@ namespace ignition
       /// \brief Create the texture which is used to render gpu rays data.
       private: virtual void CreateGpuRaysTextures();
 
+      /// \brief Drop the frames whose asynchronous readback is pending
+      private: void DropPendingReadbacks();
+
       /// \brief Builds scaled Orthogonal Matrix from parameters.
       /// \param[in] _left Left clip.
       /// \param[in] _right Right clip.
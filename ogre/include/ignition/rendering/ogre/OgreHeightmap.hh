@@ -114,9 +114,11 @@ namespace ignition
       /// and supports PSSM shadows.
       private: void CreateMaterial();
 
-      /// \brief Initialize all the blend material maps.
-      /// \param[in] _terrain The terrain to initialize the blend maps.
-      private: bool InitBlendMaps(Ogre::Terrain *_terrain);
+      /// \brief Initialize all the blend material maps. The blend values of
+      /// the terrains are computed in parallel.
+      /// \param[in] _terrains The terrains to initialize the blend maps.
+      private: void InitBlendMaps(
+          const std::vector<Ogre::Terrain *> &_terrains);
 
       /// \brief Internal function used to setup shadows for the terrain.
       /// \param[in] _enabled True to enable shadows.
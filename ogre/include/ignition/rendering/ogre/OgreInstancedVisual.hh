@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE_OGREINSTANCEDVISUAL_HH_
+#define IGNITION_RENDERING_OGRE_OGREINSTANCEDVISUAL_HH_
+
+#include <memory>
+
+#include "ignition/rendering/MeshDescriptor.hh"
+#include "ignition/rendering/base/BaseInstancedVisual.hh"
+#include "ignition/rendering/ogre/OgreVisual.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // Forward declaration
+    class OgreInstancedVisualPrivate;
+
+    /// \brief Ogre implementation of an instanced visual. Each instance is
+    /// an ogre entity on a scene node of its own. The entities share the
+    /// mesh and, per color, the material.
+    class IGNITION_RENDERING_OGRE_VISIBLE OgreInstancedVisual :
+      public BaseInstancedVisual<OgreVisual>
+    {
+      /// \brief Constructor
+      protected: OgreInstancedVisual();
+
+      /// \brief Destructor
+      public: virtual ~OgreInstancedVisual();
+
+      // Documentation inherited
+      public: virtual void Destroy() override;
+
+      // Documentation inherited
+      public: virtual void SetVisible(bool _visible) override;
+
+      // Documentation inherited
+      public: virtual void SetVisibilityFlags(uint32_t _flags) override;
+
+      // Documentation inherited
+      protected: virtual void UpdateInstance(unsigned int _index) override;
+
+      /// \brief Create the ogre entities of the instances
+      /// \param[in] _desc Descriptor of the mesh of the instances
+      /// \param[in] _material Material of the instances, may be null
+      /// \param[in] _count Number of instances
+      /// \return True if the mesh was loaded
+      private: bool Create(const MeshDescriptor &_desc,
+                   MaterialPtr _material, unsigned int _count);
+
+      /// \brief Pointer to private data class
+      private: std::unique_ptr<OgreInstancedVisualPrivate> dataPtr;
+
+      /// \brief Only an ogre scene can create an ogre instanced visual
+      private: friend class OgreScene;
+    };
+    }
+  }
+}
+#endif
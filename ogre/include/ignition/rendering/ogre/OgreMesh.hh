@@ -85,6 +85,14 @@ namespace ignition
       public: virtual void UpdateSkeletonAnimation(
             std::chrono::steady_clock::duration _time) override;
 
+      // Documentation inherited.
+      public: virtual std::vector<std::string> SkeletonBoneNames() const
+            override;
+
+      // Documentation inherited.
+      public: virtual void SetSkeletonBoneTransforms(
+            const std::vector<math::Matrix4d> &_tfs) override;
+
       public: virtual Ogre::MovableObject *OgreObject() const override;
 
       protected: virtual SubMeshStorePtr SubMeshes() const override;
@@ -65,6 +65,10 @@ namespace ignition
       /// \brief Vector with the template materials, we keep the pointer to be
       /// able to remove it when nobody is using it.
       protected: std::vector<MaterialPtr> materialCache;
+
+      /// \brief Make instanced visuals our friend so they can create the
+      /// ogre entities of their instances
+      private: friend class OgreInstancedVisual;
     };
 
     class IGNITION_RENDERING_OGRE_VISIBLE OgreSubMeshStoreFactory
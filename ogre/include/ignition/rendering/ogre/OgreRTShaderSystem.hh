@@ -137,6 +137,12 @@ namespace ignition
       /// \return The Ogre PSSM Shadows camera setup.
       public: Ogre::PSSMShadowCameraSetup *PSSMShadowCameraSetup() const;
 
+      /// \brief Get the configuration the shaders of a material are
+      /// generated for, used to skip materials already up to date
+      /// \param[in] _material Material of a submesh
+      /// \return String identifying the configuration
+      private: std::string ShaderConfig(OgreMaterialPtr _material) const;
+
       /// \brief Get paths for the shader system
       /// \param[out] _coreLibsPath Path to the core libraries.
       /// \param[out] _cachePath Path to where the generated shaders are
@@ -18,6 +18,7 @@
 #define IGNITION_RENDERING_OGRE_OGRERAYQUERY_HH_
 
 #include <memory>
+#include <vector>
 
 #include "ignition/rendering/base/BaseRayQuery.hh"
 #include "ignition/rendering/ogre/OgreIncludes.hh"
@@ -52,6 +53,22 @@ namespace ignition
       // Documentation inherited
       public: virtual RayQueryResult ClosestPoint();
 
+      // Documentation inherited
+      public: virtual std::vector<RayQueryResult> ClosestPoints(
+                  const std::vector<math::Line3d> &_rays);
+
+      /// \brief Compute the closest intersection of a ray. The world space
+      /// triangles of every mesh tested are cached until ClearMeshCache()
+      /// is called, so they can be shared by a batch of rays.
+      /// \param[in] _origin Ray origin
+      /// \param[in] _direction Ray direction
+      /// \return Closest intersection result
+      private: RayQueryResult ClosestPointImpl(const math::Vector3d &_origin,
+                   const math::Vector3d &_direction);
+
+      /// \brief Release the mesh triangles cached by ClosestPointImpl()
+      private: void ClearMeshCache();
+
       /// \brief Get the mesh information for the given mesh.
       /// \param[in] _mesh Mesh to get info about.
       /// \param[out] _vertexCount Number of vertices in the mesh.
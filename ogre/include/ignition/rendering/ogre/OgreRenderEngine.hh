@@ -100,6 +100,9 @@ namespace ignition
 
       public: void AddResourcePath(const std::string &_uri) override;
 
+      // Documentation inherited.
+      public: virtual rendering::MemoryStats MemoryStats() const override;
+
       public: virtual Ogre::Root *OgreRoot() const;
 
       public: std::string CreateRenderWindow(const std::string &_handle,
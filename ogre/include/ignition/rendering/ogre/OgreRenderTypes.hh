@@ -39,6 +39,7 @@ namespace ignition
     class OgreGrid;
     class OgreHeightmap;
     class OgreInertiaVisual;
+    class OgreInstancedVisual;
     class OgreJointVisual;
     class OgreLight;
     class OgreLightVisual;
@@ -90,6 +91,7 @@ namespace ignition
     typedef shared_ptr<OgreGrid>                 OgreGridPtr;
     typedef shared_ptr<OgreHeightmap>            OgreHeightmapPtr;
     typedef shared_ptr<OgreInertiaVisual>        OgreInertiaVisualPtr;
+    typedef shared_ptr<OgreInstancedVisual>      OgreInstancedVisualPtr;
     typedef shared_ptr<OgreJointVisual>          OgreJointVisualPtr;
     typedef shared_ptr<OgreLight>                OgreLightPtr;
     typedef shared_ptr<OgreLightVisual>          OgreLightVisualPtr;
@@ -65,12 +65,20 @@ namespace ignition
 
       public: virtual void PreRender() override;
 
+      // Documentation inherited.
+      public: virtual rendering::MemoryStats MemoryStats() const override;
+
       public: virtual void Clear() override;
 
       public: virtual void Destroy() override;
 
       public: virtual Ogre::SceneManager *OgreSceneManager() const;
 
+      /// \internal
+      /// \brief Get the factory that creates the meshes of this scene
+      /// \return Mesh factory
+      public: OgreMeshFactoryPtr MeshFactory() const;
+
       protected: virtual bool LoadImpl() override;
 
       protected: virtual bool InitImpl() override;
@@ -175,6 +183,12 @@ namespace ignition
       protected: virtual LidarVisualPtr CreateLidarVisualImpl(unsigned int _id,
                      const std::string &_name) override;
 
+      // Documentation inherited
+      protected: virtual InstancedVisualPtr CreateInstancedVisualImpl(
+                     unsigned int _id, const std::string &_name,
+                     const MeshDescriptor &_desc, MaterialPtr _material,
+                     unsigned int _count) override;
+
       // Documentation inherited
       protected: virtual WireBoxPtr CreateWireBoxImpl(unsigned int _id,
                      const std::string &_name) override;
@@ -41,9 +41,10 @@ namespace ignition
 
     /// \brief Generates a selection buffer object for a given camera.
     /// The selection buffer is used of entity selection. On setup, a unique
-    /// color is assigned to each entity. Whenever a selection request is made,
-    /// the selection buffer camera renders to a 1x1 sized offscreen buffer.
-    /// The color value of that pixel gives the identity of the entity.
+    /// color is assigned to each entity. The first selection request after
+    /// the camera moved or rendered a new frame renders the whole selection
+    /// buffer and reads it back; later requests are answered from that
+    /// readback. The color value of a pixel gives the identity of the entity.
     class IGNITION_RENDERING_OGRE_VISIBLE OgreSelectionBuffer
     {
       /// \brief Constructor
@@ -69,6 +70,16 @@ namespace ignition
       /// \brief Call this to update the selection buffer contents
       public: void Update();
 
+      /// \brief Mark the cached selection buffer as out of date so the next
+      /// selection request renders it again. The camera calls this whenever
+      /// it renders a new frame.
+      public: void SetDirty();
+
+      /// \brief Render and read back the selection buffer if the cached
+      /// readback is out of date
+      /// \return True if the cached readback is valid
+      private: bool UpdateCache();
+
       /// \brief Delete the render texture
       private: void DeleteRTTBuffer();
 
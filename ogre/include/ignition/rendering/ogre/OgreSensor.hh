@@ -20,6 +20,11 @@
 #include "ignition/rendering/base/BaseSensor.hh"
 #include "ignition/rendering/ogre/OgreNode.hh"
 
+namespace Ogre
+{
+  class RenderTarget;
+}
+
 namespace ignition
 {
   namespace rendering
@@ -32,6 +37,16 @@ namespace ignition
       protected: OgreSensor();
 
       public: virtual ~OgreSensor();
+
+      /// \brief Start counting the draws of a new frame. To be called at
+      /// the start of Render.
+      /// \sa DrawStats
+      protected: void ResetDrawStats();
+
+      /// \brief Add the draws of the last update of a render target to the
+      /// counts of the frame
+      /// \param[in] _target Render target updated by the sensor
+      protected: void AddDrawStats(Ogre::RenderTarget *_target);
     };
     }
   }
@@ -30,6 +30,9 @@ class ignition::rendering::OgreCOMVisualPrivate
 
   /// \brief Sphere visual marking the center of mass
   public: VisualPtr sphereVis = nullptr;
+
+  /// \brief Material cloned for the sphere visual
+  public: MaterialPtr sphereMaterial = nullptr;
 };
 
 using namespace ignition;
@@ -67,6 +70,24 @@ void OgreCOMVisual::Init()
   BaseCOMVisual::Init();
 }
 
+//////////////////////////////////////////////////
+void OgreCOMVisual::Destroy()
+{
+  if (this->dataPtr->sphereVis != nullptr)
+  {
+    this->dataPtr->sphereVis->Destroy();
+    this->dataPtr->sphereVis.reset();
+  }
+
+  if (this->dataPtr->sphereMaterial && this->Scene())
+  {
+    this->Scene()->DestroyMaterial(this->dataPtr->sphereMaterial);
+    this->dataPtr->sphereMaterial.reset();
+  }
+
+  BaseCOMVisual::Destroy();
+}
+
 //////////////////////////////////////////////////
 Ogre::MovableObject *OgreCOMVisual::OgreObject() const
 {
@@ -93,6 +114,7 @@ void OgreCOMVisual::CreateVisual()
     this->dataPtr->sphereVis = this->Scene()->CreateVisual();
     this->dataPtr->sphereVis->AddGeometry(this->Scene()->CreateSphere());
     this->dataPtr->sphereVis->SetMaterial("Default/CoM");
+    this->dataPtr->sphereMaterial = this->dataPtr->sphereVis->Material();
     this->dataPtr->sphereVis->SetInheritScale(false);
     this->AddChild(this->dataPtr->sphereVis);
   }
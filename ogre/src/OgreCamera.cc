@@ -15,6 +15,8 @@
  *
  */
 
+#include <ignition/common/Profiler.hh>
+
 #include "ignition/rendering/ogre/OgreCamera.hh"
 #include "ignition/rendering/ogre/OgreConversions.hh"
 #include "ignition/rendering/ogre/OgreIncludes.hh"
@@ -122,7 +124,14 @@ void OgreCamera::SetMaterial(const MaterialPtr &_material)
 //////////////////////////////////////////////////
 void OgreCamera::Render()
 {
+  IGN_PROFILE("OgreCamera::Render");
+  this->ResetDrawStats();
   this->renderTexture->Render();
+  this->AddDrawStats(this->renderTexture->RenderTarget());
+
+  // the scene may have changed since the selection buffer was read back
+  if (this->selectionBuffer)
+    this->selectionBuffer->SetDirty();
 }
 
 //////////////////////////////////////////////////
@@ -320,6 +329,13 @@ void OgreCamera::SetFarClipPlane(const double _far)
   this->ogreCamera->setFarClipDistance(_far);
 }
 
+//////////////////////////////////////////////////
+void OgreCamera::SetLodBias(double _bias)
+{
+  BaseCamera::SetLodBias(_bias);
+  this->ogreCamera->setLodBias(this->LodBias());
+}
+
 //////////////////////////////////////////////////
 double OgreCamera::NearClip() const
 {
@@ -16,10 +16,12 @@
  */
 
 #include <cmath>
+#include <mutex>
 
 #include <ignition/common/Mesh.hh>
 #include <ignition/common/MeshManager.hh>
 
+#include "ignition/rendering/Utils.hh"
 #include "ignition/rendering/ogre/OgreCapsule.hh"
 #include "ignition/rendering/ogre/OgreMaterial.hh"
 #include "ignition/rendering/ogre/OgreScene.hh"
@@ -91,19 +93,23 @@ void OgreCapsule::Destroy()
 //////////////////////////////////////////////////
 void OgreCapsule::Update()
 {
-  common::MeshManager *meshMgr = common::MeshManager::Instance();
   std::string capsuleMeshName = this->Name() + "_capsule_mesh"
     + "_" + std::to_string(this->radius)
     + "_" + std::to_string(this->length);
 
-  // Create new mesh if needed
-  if (!meshMgr->HasMesh(capsuleMeshName))
+  MeshDescriptor meshDescriptor;
   {
-    meshMgr->CreateCapsule(capsuleMeshName, this->radius, this->length, 32, 32);
-  }
+    std::lock_guard<std::recursive_mutex> lock(meshManagerMutex());
+    common::MeshManager *meshMgr = common::MeshManager::Instance();
 
-  MeshDescriptor meshDescriptor;
-  meshDescriptor.mesh = meshMgr->MeshByName(capsuleMeshName);
+    // Create new mesh if needed
+    if (!meshMgr->HasMesh(capsuleMeshName))
+    {
+      meshMgr->CreateCapsule(capsuleMeshName, this->radius, this->length,
+          32, 32);
+    }
+    meshDescriptor.mesh = meshMgr->MeshByName(capsuleMeshName);
+  }
   if (meshDescriptor.mesh == nullptr)
   {
     ignerr << "Capsule mesh is unavailable in the Mesh Manager" << std::endl;
@@ -45,7 +45,15 @@ const Ogre::PixelFormat OgreConversions::ogrePixelFormats[PF_COUNT] =
       // PF_FLOAT32_RGB
       Ogre::PF_FLOAT32_RGB,
       // PF_L16
-      Ogre::PF_L16
+      Ogre::PF_L16,
+      // PF_R8G8B8A8
+      Ogre::PF_BYTE_RGBA,
+      // PF_FLOAT16_R
+      Ogre::PF_FLOAT16_R,
+      // PF_FLOAT16_RGB
+      Ogre::PF_FLOAT16_RGB,
+      // PF_UINT16_RGB
+      Ogre::PF_SHORT_RGB
     };
 
 //////////////////////////////////////////////////
@@ -22,10 +22,18 @@
   #endif
   #include <windows.h>
 #endif
+
+#include <cstring>
+#include <deque>
+#include <memory>
+
+#include <ignition/common/Profiler.hh>
 #include <ignition/math/Helpers.hh>
 #include "ignition/rendering/ogre/OgreDepthCamera.hh"
 #include "ignition/rendering/ogre/OgreMaterial.hh"
 
+#include "OgrePixelPackBuffer.hh"
+
 /// \internal
 /// \brief Private data for the OgreDepthCamera class
 class ignition::rendering::OgreDepthCameraPrivate
@@ -72,6 +80,37 @@ class ignition::rendering::OgreDepthCameraPrivate
   public: ignition::common::EventT<void(const float *,
               unsigned int, unsigned int, unsigned int,
               const std::string &)> newDepthFrame;
+
+  /// \brief A frame whose asynchronous readback is pending
+  public: struct PendingReadback
+  {
+    /// \brief Index into the pixel buffer rings the frame is downloaded to
+    unsigned int index;
+
+    /// \brief True if the color texture is downloaded too
+    bool outputPoints;
+  };
+
+  /// \brief True to read back depth data asynchronously
+  public: bool asyncReadback = false;
+
+  /// \brief Number of pixel buffers in the readback rings
+  public: static const unsigned int kNumReadbackBuffers = 2u;
+
+  /// \brief Ring of pixel buffers the point cloud texture is downloaded to
+  public: std::unique_ptr<OgrePixelPackBuffer>
+      pcdReadbacks[kNumReadbackBuffers];
+
+  /// \brief Ring of pixel buffers the color texture is downloaded to
+  public: std::unique_ptr<OgrePixelPackBuffer>
+      colorReadbacks[kNumReadbackBuffers];
+
+  /// \brief Frames that have been downloaded but not yet processed,
+  /// oldest first
+  public: std::deque<PendingReadback> pendingReadbacks;
+
+  /// \brief Index of the pixel buffers to use for the next download
+  public: unsigned int nextReadback = 0u;
 };
 
 using namespace ignition;
@@ -92,6 +131,13 @@ OgreDepthCamera::~OgreDepthCamera()
 //////////////////////////////////////////////////
 void OgreDepthCamera::Destroy()
 {
+  this->DropPendingReadbacks();
+  for (unsigned int i = 0u; i < this->dataPtr->kNumReadbackBuffers; ++i)
+  {
+    this->dataPtr->pcdReadbacks[i].reset();
+    this->dataPtr->colorReadbacks[i].reset();
+  }
+
   if (this->dataPtr->depthBuffer)
   {
     delete [] this->dataPtr->depthBuffer;
@@ -256,15 +302,21 @@ void OgreDepthCamera::CreateDepthTexture()
 //////////////////////////////////////////////////
 void OgreDepthCamera::PreRender()
 {
+  IGN_PROFILE("OgreDepthCamera::PreRender");
   if (!this->depthTexture)
     this->CreateDepthTexture();
   if (!this->dataPtr->pcdTexture || !this->dataPtr->colorTexture)
     this->CreatePointCloudTexture();
+
+  this->ogreCamera->setLodBias(this->LodBias());
 }
 
 //////////////////////////////////////////////////
 void OgreDepthCamera::Render()
 {
+  IGN_PROFILE("OgreDepthCamera::Render");
+  this->RecordFrameSubmit();
+  this->ResetDrawStats();
   Ogre::SceneManager *sceneMgr = this->scene->OgreSceneManager();
   Ogre::ShadowTechnique shadowTech = sceneMgr->getShadowTechnique();
 
@@ -278,6 +330,7 @@ void OgreDepthCamera::Render()
   this->UpdateRenderTarget(this->dataPtr->pcdTexture,
       ogreMat->Material().get(), ogreMat->Material()->getName());
   this->dataPtr->pcdTexture->RenderTarget()->update(false);
+  this->AddDrawStats(this->dataPtr->pcdTexture->RenderTarget());
 
   sceneMgr->_suppressRenderStateChanges(false);
   sceneMgr->setShadowTechnique(shadowTech);
@@ -291,6 +344,7 @@ void OgreDepthCamera::Render()
   // color
   this->dataPtr->colorTexture->SetAutoUpdated(false);
   this->dataPtr->colorTexture->Render();
+  this->AddDrawStats(this->dataPtr->colorTexture->RenderTarget());
 }
 
 //////////////////////////////////////////////////
@@ -368,11 +422,10 @@ void OgreDepthCamera::UpdateRenderTarget(OgreRenderTexturePtr _target,
 //////////////////////////////////////////////////
 void OgreDepthCamera::PostRender()
 {
+  IGN_PROFILE("OgreDepthCamera::PostRender");
   unsigned int width = this->ImageWidth();
   unsigned int height = this->ImageHeight();
   unsigned int len = width * height;
-  double farPlane = this->FarClipPlane();
-  double nearPlane = this->NearClipPlane();
 
   // get depth data
   if (!this->dataPtr->depthBuffer)
@@ -381,28 +434,125 @@ void OgreDepthCamera::PostRender()
   unsigned int channelCount = PixelUtil::ChannelCount(format);
   if (!this->dataPtr->pcdBuffer)
     this->dataPtr->pcdBuffer = new float[len * channelCount];
-  this->dataPtr->pcdTexture->Buffer(this->dataPtr->pcdBuffer);
 
   // color data
-  unsigned int colorChannelCount = 3;
-  int bgColorR = static_cast<int>(this->scene->BackgroundColor().R() * 255);
-  int bgColorG = static_cast<int>(this->scene->BackgroundColor().G() * 255);
-  int bgColorB = static_cast<int>(this->scene->BackgroundColor().B() * 255);
-  int bgColorA = static_cast<int>(this->scene->BackgroundColor().A() * 255);
-  if (this->dataPtr->outputPoints)
+  PixelFormat colorFormat = this->dataPtr->colorTexture->Format();
+  unsigned int colorChannelCount = PixelUtil::ChannelCount(colorFormat);
+  if (this->dataPtr->outputPoints && !this->dataPtr->colorBuffer)
+    this->dataPtr->colorBuffer = new unsigned char[len * colorChannelCount];
+
+  if (this->dataPtr->asyncReadback)
   {
-    PixelFormat colorFormat = this->dataPtr->colorTexture->Format();
-    colorChannelCount = PixelUtil::ChannelCount(colorFormat);
+    // resolve the point cloud texture before it is downloaded
+    this->dataPtr->pcdTexture->RenderTarget()->swapBuffers();
+
+    unsigned int idx = this->dataPtr->nextReadback;
+    if (!this->dataPtr->pcdReadbacks[idx])
+    {
+      this->dataPtr->pcdReadbacks[idx].reset(new OgrePixelPackBuffer);
+      this->dataPtr->colorReadbacks[idx].reset(new OgrePixelPackBuffer);
+    }
+
+    bool queued = this->dataPtr->pcdReadbacks[idx]->Download(
+        this->dataPtr->pcdTexture->GLId(), width, height,
+        OgreConversions::Convert(format));
+    if (queued && this->dataPtr->outputPoints)
+    {
+      queued = this->dataPtr->colorReadbacks[idx]->Download(
+          this->dataPtr->colorTexture->GLId(), width, height,
+          OgreConversions::Convert(colorFormat));
+    }
+
+    // fall back to synchronous readback if the download can not be queued
+    if (queued)
+    {
+      this->dataPtr->pendingReadbacks.push_back(
+          {idx, this->dataPtr->outputPoints});
+      this->dataPtr->nextReadback =
+          (idx + 1u) % this->dataPtr->kNumReadbackBuffers;
+
+      // emit data of the previous frame. Its download was queued a frame
+      // ago, so mapping it usually does not stall
+      while (this->dataPtr->pendingReadbacks.size() > 1u)
+      {
+        OgreDepthCameraPrivate::PendingReadback pending =
+            this->dataPtr->pendingReadbacks.front();
+        this->dataPtr->pendingReadbacks.pop_front();
+
+        OgrePixelPackBuffer *pcdReadback =
+            this->dataPtr->pcdReadbacks[pending.index].get();
+        OgrePixelPackBuffer *colorReadback =
+            this->dataPtr->colorReadbacks[pending.index].get();
+
+        // the camera was resized since the frame was queued
+        size_t pcdSize = len * channelCount * sizeof(float);
+        size_t colorSize = len * colorChannelCount;
+        if (pcdReadback->Size() != pcdSize ||
+            (pending.outputPoints && colorReadback->Size() != colorSize))
+        {
+          this->RecordFrameDropped();
+          continue;
+        }
 
-    if (!this->dataPtr->colorBuffer)
-      this->dataPtr->colorBuffer = new unsigned char[len * colorChannelCount];
+        const void *pcdData = pcdReadback->Map();
+        if (!pcdData)
+        {
+          this->RecordFrameDropped();
+          continue;
+        }
+        memcpy(this->dataPtr->pcdBuffer, pcdData, pcdSize);
+        pcdReadback->Unmap();
+        this->RecordFrameGpuComplete();
 
+        if (pending.outputPoints)
+        {
+          const void *colorData = colorReadback->Map();
+          if (!colorData)
+          {
+            this->RecordFrameDropped();
+            continue;
+          }
+          memcpy(this->dataPtr->colorBuffer, colorData, colorSize);
+          colorReadback->Unmap();
+        }
+
+        this->ProcessDepthData(pending.outputPoints);
+      }
+      return;
+    }
+  }
+
+  this->dataPtr->pcdTexture->Buffer(this->dataPtr->pcdBuffer);
+  this->RecordFrameGpuComplete();
+
+  if (this->dataPtr->outputPoints)
+  {
     Ogre::PixelBox ogrePixelBox(width, height, 1,
         OgreConversions::Convert(colorFormat), this->dataPtr->colorBuffer);
     this->dataPtr->colorTexture->RenderTarget()->copyContentsToMemory(
         ogrePixelBox);
   }
 
+  this->ProcessDepthData(this->dataPtr->outputPoints);
+}
+
+//////////////////////////////////////////////////
+void OgreDepthCamera::ProcessDepthData(bool _outputPoints)
+{
+  unsigned int width = this->ImageWidth();
+  unsigned int height = this->ImageHeight();
+  double farPlane = this->FarClipPlane();
+  double nearPlane = this->NearClipPlane();
+  unsigned int channelCount =
+      PixelUtil::ChannelCount(this->dataPtr->pcdTexture->Format());
+  unsigned int colorChannelCount =
+      PixelUtil::ChannelCount(this->dataPtr->colorTexture->Format());
+
+  int bgColorR = static_cast<int>(this->scene->BackgroundColor().R() * 255);
+  int bgColorG = static_cast<int>(this->scene->BackgroundColor().G() * 255);
+  int bgColorB = static_cast<int>(this->scene->BackgroundColor().B() * 255);
+  int bgColorA = static_cast<int>(this->scene->BackgroundColor().A() * 255);
+
   // fill depthBuffer and clamp values
   // \todo(anyone) figure out how to do this in shaders?
   for (unsigned int i = 0; i < height; ++i)
@@ -424,7 +574,7 @@ void OgreDepthCamera::PostRender()
       {
         clamp = true;
         depth = this->dataPtr->dataMaxVal;
-        if (this->dataPtr->outputPoints)
+        if (_outputPoints)
         {
           *x = this->dataPtr->dataMaxVal;
           *y = this->dataPtr->dataMaxVal;
@@ -437,7 +587,7 @@ void OgreDepthCamera::PostRender()
       {
         clamp = true;
         depth = this->dataPtr->dataMinVal;
-        if (this->dataPtr->outputPoints)
+        if (_outputPoints)
         {
           *x = this->dataPtr->dataMinVal;
           *y = this->dataPtr->dataMinVal;
@@ -447,7 +597,7 @@ void OgreDepthCamera::PostRender()
       this->dataPtr->depthBuffer[step + j] = depth;
 
       // color
-      if (this->dataPtr->outputPoints)
+      if (_outputPoints)
       {
         unsigned int colorStep = step * colorChannelCount;
         int r = 0;
@@ -479,15 +629,20 @@ void OgreDepthCamera::PostRender()
     }
   }
 
+  this->RecordFrameReadback();
+  IGN_PROFILE_BEGIN("Dispatch newDepthFrame");
   this->dataPtr->newDepthFrame(
       this->dataPtr->depthBuffer, width, height, 1, "FLOAT32");
+  IGN_PROFILE_END();
 
   // point cloud
-  if (this->dataPtr->outputPoints)
+  if (_outputPoints)
   {
+    IGN_PROFILE_BEGIN("Dispatch newRgbPointCloud");
     this->dataPtr->newRgbPointCloud(
         this->dataPtr->pcdBuffer, width, height, channelCount,
         "PF_FLOAT32_RGBA");
+    IGN_PROFILE_END();
 
     // Uncomment to debug xyz output
     // igndbg << "wxh: " << width << " x " << height << std::endl;
@@ -519,6 +674,7 @@ void OgreDepthCamera::PostRender()
     //   igndbg << std::endl;
     // }
   }
+  this->RecordFrameDelivered();
 }
 
 //////////////////////////////////////////////////
@@ -582,3 +738,31 @@ double OgreDepthCamera::FarClipPlane() const
   else
     return 0;
 }
+
+//////////////////////////////////////////////////
+void OgreDepthCamera::SetAsyncReadback(bool _enabled)
+{
+  if (this->dataPtr->asyncReadback == _enabled)
+    return;
+
+  this->dataPtr->asyncReadback = _enabled;
+
+  // pending frames are dropped when switching back to synchronous mode
+  if (!_enabled)
+    this->DropPendingReadbacks();
+}
+
+//////////////////////////////////////////////////
+bool OgreDepthCamera::AsyncReadback() const
+{
+  return this->dataPtr->asyncReadback;
+}
+
+//////////////////////////////////////////////////
+void OgreDepthCamera::DropPendingReadbacks()
+{
+  for (size_t i = 0u; i < this->dataPtr->pendingReadbacks.size(); ++i)
+    this->RecordFrameDropped();
+  this->dataPtr->pendingReadbacks.clear();
+  this->dataPtr->nextReadback = 0u;
+}
@@ -16,7 +16,9 @@
 */
 #include <math.h>
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <sstream>
 #include <ignition/math/Color.hh>
 
@@ -40,6 +42,23 @@ class ignition::rendering::OgreDynamicLinesPrivate
 
   /// \brief Used to indicate if the lines require an update
   public: bool dirty = false;
+
+  /// \brief Index of the first point modified since the last update
+  public: size_t dirtyStart = std::numeric_limits<size_t>::max();
+
+  /// \brief One past the index of the last point modified since the last
+  /// update
+  public: size_t dirtyEnd = 0u;
+
+  /// \brief Extend the dirty range to include a range of points
+  /// \param[in] _start Index of the first point
+  /// \param[in] _end One past the index of the last point
+  public: void MarkDirty(size_t _start, size_t _end)
+  {
+    this->dirtyStart = std::min(this->dirtyStart, _start);
+    this->dirtyEnd = std::max(this->dirtyEnd, _end);
+    this->dirty = true;
+  }
 };
 
 /////////////////////////////////////////////////
@@ -62,7 +81,8 @@ void OgreDynamicLines::AddPoint(const ignition::math::Vector3d &_pt,
 {
   this->dataPtr->points.push_back(_pt);
   this->dataPtr->colors.push_back(_color);
-  this->dataPtr->dirty = true;
+  this->dataPtr->MarkDirty(this->dataPtr->points.size() - 1u,
+      this->dataPtr->points.size());
 }
 
 /////////////////////////////////////////////////
@@ -84,8 +104,7 @@ void OgreDynamicLines::SetPoint(unsigned int _index,
   }
 
   this->dataPtr->points[_index] = _value;
-
-  this->dataPtr->dirty = true;
+  this->dataPtr->MarkDirty(_index, _index + 1u);
 }
 
 /////////////////////////////////////////////////
@@ -93,7 +112,7 @@ void OgreDynamicLines::SetColor(unsigned int _index,
                             const ignition::math::Color &_color)
 {
   this->dataPtr->colors[_index] = _color;
-  this->dataPtr->dirty = true;
+  this->dataPtr->MarkDirty(_index, _index + 1u);
 }
 
 /////////////////////////////////////////////////
@@ -123,13 +142,18 @@ unsigned int OgreDynamicLines::PointCount() const
 void OgreDynamicLines::Clear()
 {
   this->dataPtr->points.clear();
+  this->dataPtr->colors.clear();
+  this->dataPtr->dirtyStart = std::numeric_limits<size_t>::max();
+  this->dataPtr->dirtyEnd = 0u;
   this->dataPtr->dirty = true;
 }
 
 /////////////////////////////////////////////////
 void OgreDynamicLines::Update()
 {
-  if (this->dataPtr->dirty && this->dataPtr->points.size() > 1)
+  // an emptied list is uploaded too, otherwise the previous points would
+  // still be drawn
+  if (this->dataPtr->dirty && this->dataPtr->points.size() != 1u)
     this->FillHardwareBuffers();
 }
 
@@ -146,22 +170,47 @@ void OgreDynamicLines::CreateVertexDeclaration()
 /////////////////////////////////////////////////
 void OgreDynamicLines::FillHardwareBuffers()
 {
-  int size = this->dataPtr->points.size();
-  this->PrepareHardwareBuffers(size, 0);
+  size_t size = this->dataPtr->points.size();
+  bool reallocated = this->PrepareHardwareBuffers(size, 0);
 
   if (!size)
   {
     this->mBox.setExtents(Ogre::Vector3::ZERO, Ogre::Vector3::ZERO);
     this->dataPtr->dirty = false;
+    return;
   }
 
-  Ogre::HardwareVertexBufferSharedPtr vbuf =
-    this->mRenderOp.vertexData->vertexBufferBinding->getBuffer(0);
+  // new buffers need every point, otherwise only the points modified since
+  // the last update are written
+  size_t start = reallocated ? 0u : this->dataPtr->dirtyStart;
+  size_t end = reallocated ? size : std::min(this->dataPtr->dirtyEnd, size);
+
+  // if most of the points changed, stream the whole buffer with a discard
+  // lock so the driver can hand out fresh storage instead of waiting for
+  // the GPU to finish reading the old content
+  Ogre::HardwareBuffer::LockOptions lockOption =
+      Ogre::HardwareBuffer::HBL_NORMAL;
+  if (start < end && (end - start) * 2u >= size)
+  {
+    start = 0u;
+    end = size;
+    lockOption = Ogre::HardwareBuffer::HBL_DISCARD;
+  }
 
-  Ogre::Real *prPos =
-    static_cast<Ogre::Real*>(vbuf->lock(Ogre::HardwareBuffer::HBL_NORMAL));
+  if (start < end)
   {
-    for (int i = 0; i < size; i++)
+    // a full rewrite recomputes the bounds, so they shrink with the points
+    if (start == 0u && end == size)
+      this->mBox.setNull();
+
+    size_t count = end - start;
+    Ogre::HardwareVertexBufferSharedPtr vbuf =
+      this->mRenderOp.vertexData->vertexBufferBinding->getBuffer(0);
+
+    Ogre::Real *prPos = static_cast<Ogre::Real*>(vbuf->lock(
+        start * vbuf->getVertexSize(), count * vbuf->getVertexSize(),
+        lockOption));
+    for (size_t i = start; i < end; ++i)
     {
       *prPos++ = this->dataPtr->points[i].X();
       *prPos++ = this->dataPtr->points[i].Y();
@@ -169,29 +218,32 @@ void OgreDynamicLines::FillHardwareBuffers()
 
       this->mBox.merge(OgreConversions::Convert(this->dataPtr->points[i]));
     }
-  }
-  vbuf->unlock();
-
-  // Update the colors
-  Ogre::HardwareVertexBufferSharedPtr cbuf =
-    this->mRenderOp.vertexData->vertexBufferBinding->getBuffer(1);
-
-  Ogre::RGBA *colorArrayBuffer =
-        static_cast<Ogre::RGBA *>(
-        cbuf->lock(Ogre::HardwareBuffer::HBL_DISCARD));
-  Ogre::RenderSystem *renderSystemForVertex =
-        Ogre::Root::getSingleton().getRenderSystem();
-  for (int i = 0; i < size; ++i)
-  {
-    Ogre::ColourValue color =
-            OgreConversions::Convert(this->dataPtr->colors[i]);
-    renderSystemForVertex->convertColourValue(color, &colorArrayBuffer[i]);
-  }
-  cbuf->unlock();
+    vbuf->unlock();
+
+    // Update the colors
+    Ogre::HardwareVertexBufferSharedPtr cbuf =
+      this->mRenderOp.vertexData->vertexBufferBinding->getBuffer(1);
+
+    Ogre::RGBA *colorArrayBuffer = static_cast<Ogre::RGBA *>(cbuf->lock(
+        start * cbuf->getVertexSize(), count * cbuf->getVertexSize(),
+        lockOption));
+    Ogre::RenderSystem *renderSystemForVertex =
+          Ogre::Root::getSingleton().getRenderSystem();
+    for (size_t i = start; i < end; ++i)
+    {
+      Ogre::ColourValue color =
+              OgreConversions::Convert(this->dataPtr->colors[i]);
+      renderSystemForVertex->convertColourValue(color,
+          &colorArrayBuffer[i - start]);
+    }
+    cbuf->unlock();
 
-  // need to update after mBox change, otherwise the lines goes in and out
-  // of scope based on old mBox
-  this->getParentSceneNode()->needUpdate();
+    // need to update after mBox change, otherwise the lines goes in and out
+    // of scope based on old mBox
+    this->getParentSceneNode()->needUpdate();
+  }
 
+  this->dataPtr->dirtyStart = std::numeric_limits<size_t>::max();
+  this->dataPtr->dirtyEnd = 0u;
   this->dataPtr->dirty = false;
 }
@@ -21,6 +21,11 @@
 using namespace ignition;
 using namespace rendering;
 
+/// \brief Number of consecutive updates the vertex count has to stay below
+/// a quarter of the capacity before the vertex buffers are shrunk. This
+/// avoids reallocating them when the vertex count fluctuates.
+static const unsigned int kShrinkUpdateCount = 30u;
+
 //////////////////////////////////////////////////
 OgreDynamicRenderable::OgreDynamicRenderable()
 {
@@ -136,7 +141,7 @@ MarkerType OgreDynamicRenderable::OperationType() const
 }
 
 //////////////////////////////////////////////////
-void OgreDynamicRenderable::PrepareHardwareBuffers(size_t vertexCount,
+bool OgreDynamicRenderable::PrepareHardwareBuffers(size_t vertexCount,
                                                size_t indexCount)
 {
   // Prepare vertex buffer
@@ -155,15 +160,27 @@ void OgreDynamicRenderable::PrepareHardwareBuffers(size_t vertexCount,
     // Make capacity the next power of two
     while (newVertCapacity < vertexCount)
       newVertCapacity <<= 1;
+    this->vertexShrinkCount = 0u;
+  }
+  else if (vertexCount < this->vertexBufferCapacity>>2)
+  {
+    // Only shrink if the vertex count stays low for a while
+    if (++this->vertexShrinkCount >= kShrinkUpdateCount)
+    {
+      // Make capacity the smallest power of two that leaves room to grow
+      // back to twice the vertex count
+      while (vertexCount < newVertCapacity>>2)
+        newVertCapacity >>= 1;
+      this->vertexShrinkCount = 0u;
+    }
   }
-  else if (vertexCount < this->vertexBufferCapacity>>1)
+  else
   {
-    // Make capacity the previous power of two
-    while (vertexCount < newVertCapacity>>1)
-      newVertCapacity >>= 1;
+    this->vertexShrinkCount = 0u;
   }
 
-  if (newVertCapacity != this->vertexBufferCapacity)
+  bool reallocated = newVertCapacity != this->vertexBufferCapacity;
+  if (reallocated)
   {
     this->vertexBufferCapacity = newVertCapacity;
 
@@ -180,7 +197,9 @@ void OgreDynamicRenderable::PrepareHardwareBuffers(size_t vertexCount,
         this->vertexBufferCapacity,
         Ogre::HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
 
-    // TODO(anyone): Custom HBU_?
+    // Not HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, subclasses may only update
+    // the modified range, which requires the rest of the content to be
+    // kept. Full rewrites lock with HBL_DISCARD instead.
 
     // Bind buffer
     this->mRenderOp.vertexData->vertexBufferBinding->setBinding(0, vbuf);
@@ -235,6 +254,8 @@ void OgreDynamicRenderable::PrepareHardwareBuffers(size_t vertexCount,
     // Update index count in the render operation
     this->mRenderOp.indexData->indexCount = indexCount;
   }
+
+  return reallocated;
 }
 
 //////////////////////////////////////////////////
@@ -15,18 +15,28 @@
  *
 */
 
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+
 #include <ignition/common/Mesh.hh>
 #include <ignition/common/MeshManager.hh>
 #include <ignition/common/SubMesh.hh>
+#include <ignition/common/Profiler.hh>
 
 #include <ignition/math/Color.hh>
 #include <ignition/math/Helpers.hh>
 #include <ignition/math/Vector3.hh>
 
 #include "ignition/rendering/RenderTypes.hh"
+#include "ignition/rendering/Utils.hh"
 #include "ignition/rendering/ogre/OgreCamera.hh"
 #include "ignition/rendering/ogre/OgreGpuRays.hh"
 
+#include "OgrePixelPackBuffer.hh"
+
 /// \internal
 /// \brief Private data for the OgreGpuRays class
 class ignition::rendering::OgreGpuRaysPrivate
@@ -53,18 +63,12 @@ class ignition::rendering::OgreGpuRaysPrivate
   /// \brief Pointer to Ogre material for the second rendering pass.
   public: Ogre::Material *matSecondPass = nullptr;
 
-  /// \brief Temporary pointer to the current material.
-  public: Ogre::Material *currentMat = nullptr;
-
   /// \brief An array of first pass textures.
   public: Ogre::Texture *firstPassTextures[3];
 
   /// \brief Second pass texture.
   public: Ogre::Texture *secondPassTexture = nullptr;
 
-  /// \brief Temporary pointer to the current render target.
-  public: Ogre::Texture *currentTexture = nullptr;
-
   /// \brief Ogre orthorgraphic camera used in the second pass for
   /// undistortion.
   public: Ogre::Camera *orthoCam = nullptr;
@@ -127,6 +131,26 @@ class ignition::rendering::OgreGpuRaysPrivate
 
   /// \brief Min allowed angle in radians;
   public: const math::Angle kMinAllowedAngle = 1e-4;
+
+  /// \brief Material scheme of the first pass viewports. Every renderable
+  /// is drawn with the first pass material in this scheme
+  public: const std::string kFirstPassScheme = "gpu_rays_first_pass";
+
+  /// \brief True to read back gpu rays data asynchronously
+  public: bool asyncReadback = false;
+
+  /// \brief Number of pixel buffers in the readback ring
+  public: static const unsigned int kNumReadbackBuffers = 2u;
+
+  /// \brief Ring of pixel buffers the second pass texture is downloaded to
+  public: std::unique_ptr<OgrePixelPackBuffer> readbacks[kNumReadbackBuffers];
+
+  /// \brief Indices into readbacks of downloads that have been queued but
+  /// not yet processed, oldest first
+  public: std::deque<unsigned int> pendingReadbacks;
+
+  /// \brief Index of the pixel buffer to use for the next download
+  public: unsigned int nextReadback = 0u;
 };
 
 using namespace ignition;
@@ -161,6 +185,10 @@ void OgreGpuRays::Init()
 //////////////////////////////////////////////////
 void OgreGpuRays::Destroy()
 {
+  this->DropPendingReadbacks();
+  for (auto &readback : this->dataPtr->readbacks)
+    readback.reset();
+
   if (this->dataPtr->gpuRaysBuffer)
   {
     delete [] this->dataPtr->gpuRaysBuffer;
@@ -436,6 +464,7 @@ void OgreGpuRays::CreateGpuRaysTextures()
         Ogre::ColourValue(this->dataMaxVal, 0.0, 1.0));
     vp->setVisibilityMask(IGN_VISIBILITY_ALL &
         ~(IGN_VISIBILITY_GUI | IGN_VISIBILITY_SELECTABLE));
+    vp->setMaterialScheme(this->dataPtr->kFirstPassScheme);
   }
 
   this->dataPtr->matFirstPass = dynamic_cast<Ogre::Material *>(
@@ -586,11 +615,23 @@ void OgreGpuRays::UpdateRenderTarget(Ogre::RenderTarget *_target,
 //////////////////////////////////////////////////
 void OgreGpuRays::Render()
 {
+  IGN_PROFILE("OgreGpuRays::Render");
+  this->RecordFrameSubmit();
+  this->ResetDrawStats();
   Ogre::SceneManager *sceneMgr = this->scene->OgreSceneManager();
 
-  sceneMgr->_suppressRenderStateChanges(true);
-  sceneMgr->addRenderObjectListener(this);
-
+  // the first pass goes through the regular scene traversal. The laser
+  // material technique is picked for every renderable through the first
+  // pass material scheme, so ogre batches the state changes itself
+  Ogre::GpuProgramParametersSharedPtr firstPassParams =
+      this->dataPtr->matFirstPass->getTechnique(0)->getPass(0)->
+      getFragmentProgramParameters();
+  firstPassParams->setNamedConstant("max",
+      static_cast<float>(this->dataMaxVal));
+  firstPassParams->setNamedConstant("min",
+      static_cast<float>(this->dataMinVal));
+
+  Ogre::MaterialManager::getSingleton().addListener(this);
   for (unsigned int i = 0; i < this->dataPtr->textureCount; ++i)
   {
     if (this->dataPtr->textureCount > 1)
@@ -600,20 +641,21 @@ void OgreGpuRays::Render()
       this->Node()->roll(Ogre::Radian(this->dataPtr->cameraYaws[i]));
     }
 
-    this->dataPtr->currentMat = this->dataPtr->matFirstPass;
-    this->dataPtr->currentTexture = this->dataPtr->firstPassTextures[i];
-
-    this->UpdateRenderTarget(
-        this->dataPtr->firstPassTextures[i]->getBuffer()->getRenderTarget(),
-        this->dataPtr->matFirstPass,
-        this->dataPtr->ogreCamera, false);
+    // OgreSceneManager::_render function automatically sets farClip to 0.
+    // Which normally equates to infinite distance. We don't want this. So
+    // we have to set the distance every time.
+    this->dataPtr->ogreCamera->setFarClipDistance(this->FarClipPlane());
+    Ogre::RenderTarget *firstPassTarget =
+        this->dataPtr->firstPassTextures[i]->getBuffer()->getRenderTarget();
+    firstPassTarget->update(false);
+    this->AddDrawStats(firstPassTarget);
   }
+  Ogre::MaterialManager::getSingleton().removeListener(this);
 
   if (this->dataPtr->textureCount > 1)
       this->Node()->roll(Ogre::Radian(this->dataPtr->cameraYaws[3]));
 
-  sceneMgr->removeRenderObjectListener(this);
-
+  sceneMgr->_suppressRenderStateChanges(true);
   this->dataPtr->visual->SetVisible(true);
 
   this->UpdateRenderTarget(
@@ -622,20 +664,23 @@ void OgreGpuRays::Render()
       this->dataPtr->orthoCam, true);
 
   this->dataPtr->visual->SetVisible(false);
-
   sceneMgr->_suppressRenderStateChanges(false);
 }
 
 //////////////////////////////////////////////////
 void OgreGpuRays::PreRender()
 {
+  IGN_PROFILE("OgreGpuRays::PreRender");
   if (this->dataPtr->textureCount == 0)
     this->CreateGpuRaysTextures();
+
+  this->dataPtr->ogreCamera->setLodBias(this->LodBias());
 }
 
 //////////////////////////////////////////////////
 void OgreGpuRays::PostRender()
 {
+  IGN_PROFILE("OgreGpuRays::PostRender");
   for (unsigned int i = 0; i < this->dataPtr->textureCount; ++i)
   {
     auto rt =
@@ -653,6 +698,57 @@ void OgreGpuRays::PostRender()
     width, height, 1, Ogre::PF_FLOAT32_RGB);
   int len = width * height * this->Channels();
 
+  if (this->dataPtr->asyncReadback)
+  {
+    unsigned int idx = this->dataPtr->nextReadback;
+    if (!this->dataPtr->readbacks[idx])
+      this->dataPtr->readbacks[idx].reset(new OgrePixelPackBuffer);
+
+    unsigned int texId = 0u;
+    this->dataPtr->secondPassTexture->getCustomAttribute("GLID", &texId);
+
+    // fall back to synchronous readback if the download can not be queued
+    if (this->dataPtr->readbacks[idx]->Download(texId, width, height,
+        Ogre::PF_FLOAT32_RGB))
+    {
+      this->dataPtr->pendingReadbacks.push_back(idx);
+      this->dataPtr->nextReadback =
+          (idx + 1u) % this->dataPtr->kNumReadbackBuffers;
+
+      if (!this->dataPtr->gpuRaysScan)
+        this->dataPtr->gpuRaysScan = new float[len];
+
+      // emit data of the previous frame. Its download was queued a frame
+      // ago, so mapping it usually does not stall
+      while (this->dataPtr->pendingReadbacks.size() > 1u)
+      {
+        OgrePixelPackBuffer *readback = this->dataPtr->readbacks[
+            this->dataPtr->pendingReadbacks.front()].get();
+        this->dataPtr->pendingReadbacks.pop_front();
+
+        // the frame was rendered before the range count changed
+        const void *data =
+            readback->Size() == size ? readback->Map() : nullptr;
+        if (!data)
+        {
+          this->RecordFrameDropped();
+          continue;
+        }
+        this->RecordFrameGpuComplete();
+        memcpy(this->dataPtr->gpuRaysScan, data, size);
+        readback->Unmap();
+
+        this->RecordFrameReadback();
+        IGN_PROFILE_BEGIN("Dispatch newGpuRaysFrame");
+        this->dataPtr->newGpuRaysFrame(this->dataPtr->gpuRaysScan,
+            width, height, this->Channels(), "PF_FLOAT32_RGB");
+        IGN_PROFILE_END();
+        this->RecordFrameDelivered();
+      }
+      return;
+    }
+  }
+
   if (!this->dataPtr->gpuRaysBuffer)
   {
     this->dataPtr->gpuRaysBuffer = new float[len];
@@ -663,6 +759,7 @@ void OgreGpuRays::PostRender()
 
   auto pixelBuffer = this->dataPtr->secondPassTexture->getBuffer();
   pixelBuffer->blitToMemory(dstBox);
+  this->RecordFrameGpuComplete();
 
   if (!this->dataPtr->gpuRaysScan)
   {
@@ -671,8 +768,12 @@ void OgreGpuRays::PostRender()
 
   memcpy(this->dataPtr->gpuRaysScan, this->dataPtr->gpuRaysBuffer, size);
 
+  this->RecordFrameReadback();
+  IGN_PROFILE_BEGIN("Dispatch newGpuRaysFrame");
   this->dataPtr->newGpuRaysFrame(this->dataPtr->gpuRaysScan,
       width, height, this->Channels(), "PF_FLOAT32_RGB");
+  IGN_PROFILE_END();
+  this->RecordFrameDelivered();
 }
 
 //////////////////////////////////////////////////
@@ -695,6 +796,34 @@ void OgreGpuRays::Copy(float *_dataDest)
   memcpy(_dataDest, this->dataPtr->gpuRaysScan, size);
 }
 
+//////////////////////////////////////////////////
+void OgreGpuRays::SetAsyncReadback(bool _enabled)
+{
+  if (this->dataPtr->asyncReadback == _enabled)
+    return;
+
+  this->dataPtr->asyncReadback = _enabled;
+
+  // pending frames are dropped when switching back to synchronous mode
+  if (!_enabled)
+    this->DropPendingReadbacks();
+}
+
+//////////////////////////////////////////////////
+bool OgreGpuRays::AsyncReadback() const
+{
+  return this->dataPtr->asyncReadback;
+}
+
+//////////////////////////////////////////////////
+void OgreGpuRays::DropPendingReadbacks()
+{
+  for (size_t i = 0u; i < this->dataPtr->pendingReadbacks.size(); ++i)
+    this->RecordFrameDropped();
+  this->dataPtr->pendingReadbacks.clear();
+  this->dataPtr->nextReadback = 0u;
+}
+
 /////////////////////////////////////////////////
 void OgreGpuRays::CreateOrthoCam()
 {
@@ -831,7 +960,15 @@ void OgreGpuRays::CreateMesh()
   for (unsigned int j = 0; j < this->dataPtr->h2nd; ++j)
   {
     double gamma = 0;
-    if (this->dataPtr->h2nd != 1)
+    double azimuthOffset = 0;
+    if (!this->beamElevations.empty())
+    {
+      // rows of a beam table sample exactly the elevation of their beam
+      gamma = this->beamElevations[j];
+      if (!this->beamAzimuthOffsets.empty())
+        azimuthOffset = this->beamAzimuthOffsets[j];
+    }
+    else if (this->dataPtr->h2nd != 1)
     {
       // gamma: current vertical angle w.r.t. camera
       gamma = vstep * j - phi + this->VertHalfAngle();
@@ -840,7 +977,7 @@ void OgreGpuRays::CreateMesh()
     for (unsigned int i = 0; i < this->dataPtr->w2nd; ++i)
     {
       // current horizontal angle from start of gpu rays scan
-      double delta = hstep * i;
+      double delta = std::clamp(hstep * i + azimuthOffset, 0.0, thfov);
 
       // index of texture that contains the depth value
       unsigned int texture = static_cast<unsigned int>(
@@ -887,6 +1024,7 @@ void OgreGpuRays::CreateMesh()
 
   this->dataPtr->undistMesh = mesh;
 
+  std::lock_guard<std::recursive_mutex> lock(meshManagerMutex());
   common::MeshManager::Instance()->AddMesh(this->dataPtr->undistMesh);
 }
 
@@ -926,58 +1064,16 @@ void OgreGpuRays::CreateCanvas()
 }
 
 /////////////////////////////////////////////////
-void OgreGpuRays::notifyRenderSingleObject(Ogre::Renderable *_rend,
-      const Ogre::Pass* /*pass*/, const Ogre::AutoParamDataSource* /*source*/,
-      const Ogre::LightList* /*lights*/, bool /*supp*/)
+Ogre::Technique *OgreGpuRays::handleSchemeNotFound(
+    uint16_t /*_schemeIndex*/, const Ogre::String &_schemeName,
+    Ogre::Material * /*_originalMaterial*/, uint16_t /*_lodIndex*/,
+    const Ogre::Renderable * /*_rend*/)
 {
-  // TODO(anyone): this function sets the retro for each obj
-  // but currently just sets it to 0
-
-  Ogre::Vector4 retro = Ogre::Vector4(0, 0, 0, 0);
-  if (!_rend->hasCustomParameter(1))
-  {
-    _rend->setCustomParameter(1, Ogre::Vector4(0, 0, 0, 0));
-  }
-
-  Ogre::Pass *pass =
-    this->dataPtr->currentMat->getBestTechnique()->getPass(0);
-  Ogre::RenderSystem *renderSys =
-    this->scene->OgreSceneManager()->getDestinationRenderSystem();
+  if (_schemeName != this->dataPtr->kFirstPassScheme)
+    return nullptr;
 
-  Ogre::AutoParamDataSource autoParamDataSource;
-
-  Ogre::RenderTarget *rt =
-    this->dataPtr->currentTexture->getBuffer()->getRenderTarget();
-  Ogre::Viewport *vp = rt->getViewport(0);
-
-  renderSys->_setViewport(vp);
-  autoParamDataSource.setCurrentRenderable(_rend);
-  autoParamDataSource.setCurrentPass(pass);
-  autoParamDataSource.setCurrentViewport(vp);
-  autoParamDataSource.setCurrentRenderTarget(rt);
-  autoParamDataSource.setCurrentSceneManager(this->scene->OgreSceneManager());
-  autoParamDataSource.setCurrentCamera(this->dataPtr->ogreCamera, true);
-
-  pass->_updateAutoParams(&autoParamDataSource,
-      Ogre::GPV_GLOBAL | Ogre::GPV_PER_OBJECT);
-  pass->getFragmentProgramParameters()->setNamedConstant("retro", retro[0]);
-  pass->getFragmentProgramParameters()->setNamedConstant(
-      "max", static_cast<float>(this->dataMaxVal));
-  pass->getFragmentProgramParameters()->setNamedConstant(
-      "min", static_cast<float>(this->dataMinVal));
-  renderSys->bindGpuProgram(
-      pass->getVertexProgram()->_getBindingDelegate());
-
-  renderSys->bindGpuProgramParameters(Ogre::GPT_VERTEX_PROGRAM,
-      pass->getVertexProgramParameters(),
-      Ogre::GPV_GLOBAL | Ogre::GPV_PER_OBJECT);
-
-  renderSys->bindGpuProgram(
-      pass->getFragmentProgram()->_getBindingDelegate());
-
-  renderSys->bindGpuProgramParameters(Ogre::GPT_FRAGMENT_PROGRAM,
-      pass->getFragmentProgramParameters(),
-      (Ogre::GPV_GLOBAL | Ogre::GPV_PER_OBJECT));
+  // not using getBestTechnique() because it leads to infinite recursion here
+  return this->dataPtr->matFirstPass->getSupportedTechnique(0);
 }
 
 //////////////////////////////////////////////////
@@ -15,7 +15,11 @@
  *
 */
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <functional>
+#include <thread>
 
 #include <ignition/common/Console.hh>
 #include <ignition/common/Util.hh>
@@ -388,6 +392,9 @@ class ignition::rendering::OgreHeightmapPrivate
   /// depends on the terrain size.
   public: const double holdRadiusFactor{1.15};
 
+  /// \brief Time Init waits for the terrain pages to load before giving up
+  public: const std::chrono::seconds kLoadTimeout{60};
+
   /// \brief True if the terrain was loaded from the cache.
   public: bool loadedFromCache{false};
 
@@ -414,6 +421,41 @@ Ogre::TerrainGlobalOptions
 using namespace ignition;
 using namespace rendering;
 
+//////////////////////////////////////////////////
+/// \brief Run a function for every index in [0, _count) on a pool of
+/// worker threads and wait for all of them to finish. Indices are handed
+/// out one at a time, so uneven work per index balances across threads.
+/// \param[in] _count Number of indices
+/// \param[in] _func Function to run. Must be safe to call concurrently
+/// for different indices
+static void ParallelFor(size_t _count,
+    const std::function<void(size_t)> &_func)
+{
+  const size_t threadCount = std::min<size_t>(_count,
+      std::max(1u, std::thread::hardware_concurrency()));
+  if (threadCount <= 1u)
+  {
+    for (size_t i = 0u; i < _count; ++i)
+      _func(i);
+    return;
+  }
+
+  std::atomic<size_t> next{0u};
+  auto worker = [&]()
+  {
+    for (size_t i = next++; i < _count; i = next++)
+      _func(i);
+  };
+
+  // the calling thread works too
+  std::vector<std::thread> threads;
+  for (size_t i = 1u; i < threadCount; ++i)
+    threads.emplace_back(worker);
+  worker();
+  for (auto &thread : threads)
+    thread.join();
+}
+
 //////////////////////////////////////////////////
 OgreHeightmap::OgreHeightmap(const HeightmapDescriptor &_desc)
     : BaseHeightmap(_desc), dataPtr(std::make_unique<OgreHeightmapPrivate>())
@@ -668,22 +710,62 @@ void OgreHeightmap::Init()
   // use ignition shaders
   this->CreateMaterial();
 
-  // Sync load since we want everything in place when we start
-  this->dataPtr->terrainGroup->loadAllTerrains(true);
+  // Load asynchronously so Ogre's work queue prepares the pages on its
+  // worker threads. The GPU resources of each page are created here on the
+  // main thread as its response comes back. Still wait for all of them
+  // since we want everything in place when we start
+  this->dataPtr->terrainGroup->loadAllTerrains(false);
+  Ogre::WorkQueue *workQueue = Ogre::Root::getSingleton().getWorkQueue();
+  auto pending = [this]()
+  {
+    auto ti = this->dataPtr->terrainGroup->getTerrainIterator();
+    while (ti.hasMoreElements())
+    {
+      // pages that failed to prepare are deleted and left null
+      auto *t = ti.getNext()->instance;
+      if (t && !t->isLoaded())
+        return true;
+    }
+    return false;
+  };
+  bool loaded = true;
+  while (pending())
+  {
+    if (std::chrono::steady_clock::now() - time >
+        this->dataPtr->kLoadTimeout)
+    {
+      // pages still loading finish in PreRender, without blend maps
+      ignerr << "Heightmap [" << this->descriptor.Name() << "] did not "
+             << "load within " << this->dataPtr->kLoadTimeout.count()
+             << " s, blend maps are only created for the loaded pages"
+             << std::endl;
+      loaded = false;
+      break;
+    }
+    workQueue->processResponses();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
 
-  ignmsg << "Heightmap loaded. Process took "
-        <<  std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::steady_clock::now() - time).count()
-        << " ms." << std::endl;
+  if (loaded)
+  {
+    ignmsg << "Heightmap loaded. Process took "
+          <<  std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::steady_clock::now() - time).count()
+          << " ms." << std::endl;
+  }
 
   // Calculate blend maps
   if (!this->dataPtr->loadedFromCache)
   {
+    std::vector<Ogre::Terrain *> terrains;
     auto ti = this->dataPtr->terrainGroup->getTerrainIterator();
     while (ti.hasMoreElements())
     {
-      this->InitBlendMaps(ti.getNext()->instance);
+      auto *t = ti.getNext()->instance;
+      if (loaded || (t && t->isLoaded()))
+        terrains.push_back(t);
     }
+    this->InitBlendMaps(terrains);
   }
 
   this->dataPtr->terrainGroup->freeTemporaryResources();
@@ -708,8 +790,9 @@ void OgreHeightmap::PreRender()
   auto ti = this->dataPtr->terrainGroup->getTerrainIterator();
   while (ti.hasMoreElements())
   {
+    // pages that failed to prepare are left null
     auto *t = ti.getNext()->instance;
-    if (!t->isLoaded())
+    if (t && !t->isLoaded())
     {
       Ogre::Root::getSingleton().getWorkQueue()->processResponses();
       return;
@@ -897,43 +980,36 @@ void OgreHeightmap::SplitHeights(const std::vector<float> &_heightmap,
     return;
   }
 
-  int count = 0;
-  int width = static_cast<int>(sqrt(_heightmap.size()));
-  int newWidth = static_cast<int>(1 + (width - 1) / sqrt(_n));
+  const int sqrtN = static_cast<int>(std::lround(sqrt(_n)));
+  const int width = static_cast<int>(sqrt(_heightmap.size()));
+  const int newWidth = 1 + (width - 1) / sqrtN;
 
   // Memory allocation
-  _v.resize(_n);
+  _v.assign(_n, std::vector<float>());
 
-  for (int tileR = 0; tileR < sqrt(_n); ++tileR)
+  // Every subterrain reads its own block of rows and columns, so they are
+  // filled in parallel
+  ParallelFor(static_cast<size_t>(_n), [&](size_t _tile)
   {
-    int tileIndex = static_cast<int>(tileR * sqrt(_n));
+    const int tileR = static_cast<int>(_tile) / sqrtN;
+    const int tileC = static_cast<int>(_tile) % sqrtN;
+    std::vector<float> &tile = _v[_tile];
+    tile.resize(static_cast<size_t>(newWidth) * newWidth);
+
     for (int row = 0; row < newWidth - 1; ++row)
     {
-      for (int tileC = 0; tileC < sqrt(_n); ++tileC)
-      {
-        for (int col = 0; col < newWidth - 1; ++col)
-        {
-          _v[tileIndex].push_back(_heightmap[count]);
-          ++count;
-        }
-        // Copy last value into the last column
-        _v[tileIndex].push_back(_v[tileIndex].back());
-
-        tileIndex = static_cast<int>(tileR * sqrt(_n) +
-            (tileIndex + 1) % static_cast<int>(sqrt(_n)));
-      }
-      ++count;
+      auto src = _heightmap.begin() +
+          (tileR * (newWidth - 1) + row) * width + tileC * (newWidth - 1);
+      auto dst = tile.begin() + row * newWidth;
+      std::copy(src, src + newWidth - 1, dst);
+      // Copy last value into the last column
+      dst[newWidth - 1] = dst[newWidth - 2];
     }
+
     // Copy the last row
-    for (int i = 0; i < sqrt(_n); ++i)
-    {
-      tileIndex = static_cast<int>(tileR * sqrt(_n) + i);
-      std::vector<float> lastRow(_v[tileIndex].end() - newWidth,
-          _v[tileIndex].end());
-      _v[tileIndex].insert(_v[tileIndex].end(),
-          lastRow.begin(), lastRow.end());
-    }
-  }
+    std::copy(tile.end() - 2 * newWidth, tile.end() - newWidth,
+        tile.end() - newWidth);
+  });
 }
 
 /////////////////////////////////////////////////
@@ -1057,70 +1133,85 @@ void OgreHeightmap::SetupShadows(bool _enableShadows)
 }
 
 /////////////////////////////////////////////////
-bool OgreHeightmap::InitBlendMaps(Ogre::Terrain *_terrain)
+void OgreHeightmap::InitBlendMaps(
+    const std::vector<Ogre::Terrain *> &_terrains)
 {
-  if (nullptr == _terrain)
-  {
-    ignerr << "Invalid terrain\n";
-    return false;
-  }
-
   // no blending to be done if there's only one texture or no textures at all.
   if (this->descriptor.BlendCount() <= 1u ||
       this->descriptor.TextureCount() <= 1u)
-    return false;
+    return;
 
-  // Bounds check for following loop
-  if (_terrain->getLayerCount() < this->descriptor.BlendCount() + 1)
+  // Create the blend maps. This reads back the blend textures, so it stays
+  // on the main thread
+  std::vector<Ogre::Terrain *> terrains;
+  std::vector<std::vector<Ogre::TerrainLayerBlendMap *>> blendMaps;
+  for (auto terrain : _terrains)
   {
-    ignerr << "Invalid terrain, too few layers ["
-           << unsigned(_terrain->getLayerCount())
-           << "] for the number of blends ["
-           << this->descriptor.BlendCount() << "] to initialize blend map"
-           << std::endl;
-    return false;
-  }
+    if (nullptr == terrain)
+    {
+      ignerr << "Invalid terrain\n";
+      continue;
+    }
 
-  // Create the blend maps
-  std::vector<Ogre::TerrainLayerBlendMap *> blendMaps;
-  std::vector<float*> pBlend;
-  unsigned int i{0u};
+    // Bounds check for following loop
+    if (terrain->getLayerCount() < this->descriptor.BlendCount() + 1)
+    {
+      ignerr << "Invalid terrain, too few layers ["
+             << unsigned(terrain->getLayerCount())
+             << "] for the number of blends ["
+             << this->descriptor.BlendCount() << "] to initialize blend map"
+             << std::endl;
+      continue;
+    }
 
-  for (i = 0; i < this->descriptor.BlendCount(); ++i)
-  {
-    blendMaps.push_back(_terrain->getLayerBlendMap(i+1));
-    pBlend.push_back(blendMaps[i]->getBlendPointer());
+    terrains.push_back(terrain);
+    blendMaps.emplace_back();
+    for (unsigned int i = 0; i < this->descriptor.BlendCount(); ++i)
+      blendMaps.back().push_back(terrain->getLayerBlendMap(i+1));
   }
 
-  // Set the blend values based on the height of the terrain
-  Ogre::Real val, height;
-  for (Ogre::uint16 y = 0; y < _terrain->getLayerBlendMapSize(); ++y)
+  // Set the blend values based on the height of the terrain. This only
+  // touches CPU side data of each page, so pages are filled in parallel
+  ParallelFor(terrains.size(), [&](size_t _index)
   {
-    for (Ogre::uint16 x = 0; x < _terrain->getLayerBlendMapSize(); ++x)
-    {
-      Ogre::Real tx, ty;
+    Ogre::Terrain *terrain = terrains[_index];
+    const auto &maps = blendMaps[_index];
 
-      blendMaps[0]->convertImageToTerrainSpace(x, y, &tx, &ty);
-      height = _terrain->getHeightAtTerrainPosition(tx, ty);
+    std::vector<float*> pBlend;
+    for (auto map : maps)
+      pBlend.push_back(map->getBlendPointer());
 
-      for (i = 0; i < this->descriptor.BlendCount(); ++i)
+    Ogre::Real val, height;
+    for (Ogre::uint16 y = 0; y < terrain->getLayerBlendMapSize(); ++y)
+    {
+      for (Ogre::uint16 x = 0; x < terrain->getLayerBlendMapSize(); ++x)
       {
-        auto blend = this->descriptor.BlendByIndex(i);
-        val = (height - blend->MinHeight()) / blend->FadeDistance();
-        val = Ogre::Math::Clamp(val, (Ogre::Real)0, (Ogre::Real)1);
-        *pBlend[i]++ = val;
+        Ogre::Real tx, ty;
+
+        maps[0]->convertImageToTerrainSpace(x, y, &tx, &ty);
+        height = terrain->getHeightAtTerrainPosition(tx, ty);
+
+        for (unsigned int i = 0; i < this->descriptor.BlendCount(); ++i)
+        {
+          auto blend = this->descriptor.BlendByIndex(i);
+          val = (height - blend->MinHeight()) / blend->FadeDistance();
+          val = Ogre::Math::Clamp(val, (Ogre::Real)0, (Ogre::Real)1);
+          *pBlend[i]++ = val;
+        }
       }
     }
-  }
+  });
 
-  // Make sure the blend maps are properly updated
-  for (auto map : blendMaps)
+  // Make sure the blend maps are properly updated. Uploads to the GPU, so
+  // back on the main thread
+  for (auto &maps : blendMaps)
   {
-    map->dirty();
-    map->update();
+    for (auto map : maps)
+    {
+      map->dirty();
+      map->update();
+    }
   }
-
-  return true;
 }
 
 //////////////////////////////////////////////////
@@ -30,6 +30,9 @@ class ignition::rendering::OgreInertiaVisualPrivate
 
   /// \brief Box visual
   public: VisualPtr boxVis = nullptr;
+
+  /// \brief Material cloned for the box visual
+  public: MaterialPtr boxMaterial = nullptr;
 };
 
 using namespace ignition;
@@ -57,6 +60,24 @@ void OgreInertiaVisual::Init()
   BaseInertiaVisual::Init();
 }
 
+//////////////////////////////////////////////////
+void OgreInertiaVisual::Destroy()
+{
+  if (this->dataPtr->boxVis != nullptr)
+  {
+    this->dataPtr->boxVis->Destroy();
+    this->dataPtr->boxVis.reset();
+  }
+
+  if (this->dataPtr->boxMaterial && this->Scene())
+  {
+    this->Scene()->DestroyMaterial(this->dataPtr->boxMaterial);
+    this->dataPtr->boxMaterial.reset();
+  }
+
+  BaseInertiaVisual::Destroy();
+}
+
 //////////////////////////////////////////////////
 Ogre::MovableObject *OgreInertiaVisual::OgreObject() const
 {
@@ -84,6 +105,7 @@ void OgreInertiaVisual::Load(const ignition::math::Pose3d &_pose,
     this->dataPtr->boxVis = this->Scene()->CreateVisual();
     this->dataPtr->boxVis->AddGeometry(this->Scene()->CreateBox());
     this->dataPtr->boxVis->SetMaterial("Default/TransPurple");
+    this->dataPtr->boxMaterial = this->dataPtr->boxVis->Material();
     this->AddChild(this->dataPtr->boxVis);
   }
 
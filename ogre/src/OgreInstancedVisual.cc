@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/ogre/OgreConversions.hh"
+#include "ignition/rendering/ogre/OgreIncludes.hh"
+#include "ignition/rendering/ogre/OgreInstancedVisual.hh"
+#include "ignition/rendering/ogre/OgreMaterial.hh"
+#include "ignition/rendering/ogre/OgreMeshFactory.hh"
+#include "ignition/rendering/ogre/OgreScene.hh"
+
+/// \brief Private data for the OgreInstancedVisual class
+class ignition::rendering::OgreInstancedVisualPrivate
+{
+  /// \brief Scene nodes of the instances, children of the visual node
+  public: std::vector<Ogre::SceneNode *> nodes;
+
+  /// \brief Ogre entities of the instances
+  public: std::vector<Ogre::Entity *> entities;
+
+  /// \brief Visibility of the visual itself
+  public: bool visible = true;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+OgreInstancedVisual::OgreInstancedVisual()
+  : dataPtr(new OgreInstancedVisualPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+OgreInstancedVisual::~OgreInstancedVisual()
+{
+}
+
+//////////////////////////////////////////////////
+bool OgreInstancedVisual::Create(const MeshDescriptor &_desc,
+    MaterialPtr _material, unsigned int _count)
+{
+  if (!this->ogreNode)
+    return false;
+
+  MeshDescriptor normDesc = _desc;
+  normDesc.Load();
+
+  // the material is shared by all instances, colored instances get copies
+  // of it in InstanceMaterial
+  if (_material)
+    this->SetMaterial(_material, false);
+
+  OgreMeshFactoryPtr meshFactory = this->scene->MeshFactory();
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    Ogre::Entity *entity = meshFactory->OgreEntity(normDesc);
+    if (!entity)
+    {
+      ignerr << "Unable to create the instances of: " << this->Name()
+             << std::endl;
+      return false;
+    }
+
+    // set user data for mouse queries
+    entity->getUserObjectBindings().setUserAny(Ogre::Any(this->Id()));
+    entity->setVisibilityFlags(this->visibilityFlags);
+
+    Ogre::SceneNode *node = this->ogreNode->createChildSceneNode();
+    node->attachObject(entity);
+
+    this->dataPtr->entities.push_back(entity);
+    this->dataPtr->nodes.push_back(node);
+  }
+
+  this->InitInstances(_count);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void OgreInstancedVisual::Destroy()
+{
+  if (this->scene)
+  {
+    Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+    for (Ogre::Entity *entity : this->dataPtr->entities)
+      sceneManager->destroyEntity(entity);
+    for (Ogre::SceneNode *node : this->dataPtr->nodes)
+      sceneManager->destroySceneNode(node);
+  }
+  this->dataPtr->entities.clear();
+  this->dataPtr->nodes.clear();
+
+  BaseInstancedVisual::Destroy();
+}
+
+//////////////////////////////////////////////////
+void OgreInstancedVisual::SetVisible(bool _visible)
+{
+  OgreVisual::SetVisible(_visible);
+  this->dataPtr->visible = _visible;
+
+  // the ogre node cascades visibility to the instance entities, so hidden
+  // instances have to be hidden again
+  for (unsigned int i = 0; i < this->dataPtr->entities.size(); ++i)
+  {
+    this->dataPtr->entities[i]->setVisible(
+        _visible && this->instanceVisible[i]);
+  }
+}
+
+//////////////////////////////////////////////////
+void OgreInstancedVisual::SetVisibilityFlags(uint32_t _flags)
+{
+  OgreVisual::SetVisibilityFlags(_flags);
+
+  for (Ogre::Entity *entity : this->dataPtr->entities)
+    entity->setVisibilityFlags(_flags);
+}
+
+//////////////////////////////////////////////////
+void OgreInstancedVisual::UpdateInstance(unsigned int _index)
+{
+  if (_index >= this->dataPtr->entities.size())
+    return;
+
+  Ogre::SceneNode *node = this->dataPtr->nodes[_index];
+  const math::Pose3d &pose = this->instancePoses[_index];
+  node->setPosition(OgreConversions::Convert(pose.Pos()));
+  node->setOrientation(OgreConversions::Convert(pose.Rot()));
+  node->setScale(OgreConversions::Convert(this->instanceScales[_index]));
+
+  Ogre::Entity *entity = this->dataPtr->entities[_index];
+  entity->setVisible(this->dataPtr->visible && this->instanceVisible[_index]);
+
+  OgreMaterialPtr material =
+      std::dynamic_pointer_cast<OgreMaterial>(this->InstanceMaterial(_index));
+  if (!material)
+    return;
+
+  entity->setMaterial(material->Material());
+  entity->setCastShadows(material->CastShadows());
+}
@@ -15,6 +15,9 @@
  *
  */
 
+#include <memory>
+#include <string>
+
 #include <ignition/common/Console.hh>
 #include "ignition/rendering/ogre/OgreDynamicLines.hh"
 #include "ignition/rendering/ogre/OgreLidarVisual.hh"
@@ -25,28 +28,47 @@
 
 class ignition::rendering::OgreLidarVisualPrivate
 {
-  /// \brief Non Hitting DynamicLines Object to display
-  public: std::vector<std::shared_ptr<OgreDynamicLines>> noHitRayStrips;
-
-  /// \brief Hitting DynamicLines Object to display
-  public: std::vector<std::shared_ptr<OgreDynamicLines>> rayStrips;
-
-  /// \brief Dead Zone Geometry DynamicLines Object to display
-  public: std::vector<std::shared_ptr<OgreDynamicLines>> deadZoneRayFans;
+  /// \brief Create a DynamicLines object and attach it to a node
+  /// \param[in] _type Render operation of the lines
+  /// \param[in] _material Name of the material of the lines
+  /// \param[in] _node Node to attach the lines to
+  /// \return The new DynamicLines object
+  public: std::shared_ptr<OgreDynamicLines> CreateLines(MarkerType _type,
+              const std::string &_material, Ogre::SceneNode *_node);
+
+  /// \brief Append the two triangles a triangle strip draws between two
+  /// consecutive rays, so that all rays fit in a single triangle list
+  /// \param[in] _lines Triangle list to append to
+  /// \param[in] _start0 Start point of the first ray
+  /// \param[in] _end0 End point of the first ray
+  /// \param[in] _start1 Start point of the second ray
+  /// \param[in] _end1 End point of the second ray
+  public: static void AddQuad(OgreDynamicLines &_lines,
+              const math::Vector3d &_start0, const math::Vector3d &_end0,
+              const math::Vector3d &_start1, const math::Vector3d &_end1);
+
+  /// \brief Non Hitting DynamicLines Object to display, a triangle list
+  /// holding the strips of all vertical rays
+  public: std::shared_ptr<OgreDynamicLines> noHitRayStrips;
+
+  /// \brief Hitting DynamicLines Object to display, a triangle list
+  /// holding the strips of all vertical rays
+  public: std::shared_ptr<OgreDynamicLines> rayStrips;
+
+  /// \brief Dead Zone Geometry DynamicLines Object to display, a triangle
+  /// list holding the fans of all vertical rays
+  public: std::shared_ptr<OgreDynamicLines> deadZoneRayFans;
 
   /// \brief Lidar Ray DynamicLines Object to display
-  public: std::vector<std::shared_ptr<OgreDynamicLines>> rayLines;
+  public: std::shared_ptr<OgreDynamicLines> rayLines;
 
   /// \brief Lidar Points DynamicLines Object to display
-  public: std::vector<std::shared_ptr<OgreDynamicLines>> points;
+  public: std::shared_ptr<OgreDynamicLines> points;
 
   /// \brief Lidar visual type
   public: LidarVisualType lidarVisType =
             LidarVisualType::LVT_TRIANGLE_STRIPS;
 
-  /// \brief Current value of DisplayNonHitting parameter
-  public: bool currentDisplayNonHitting = true;
-
   /// \brief The current lidar points data
   public: std::vector<double> lidarPoints;
 
@@ -63,6 +85,35 @@ class ignition::rendering::OgreLidarVisualPrivate
 using namespace ignition;
 using namespace rendering;
 
+//////////////////////////////////////////////////
+std::shared_ptr<OgreDynamicLines> OgreLidarVisualPrivate::CreateLines(
+    MarkerType _type, const std::string &_material, Ogre::SceneNode *_node)
+{
+  auto lines = std::make_shared<OgreDynamicLines>(_type);
+#if (OGRE_VERSION <= ((1 << 16) | (10 << 8) | 7))
+  lines->setMaterial(_material);
+#else
+  lines->setMaterial(
+      Ogre::MaterialManager::getSingleton().getByName(_material));
+#endif
+  _node->attachObject(lines.get());
+  return lines;
+}
+
+//////////////////////////////////////////////////
+void OgreLidarVisualPrivate::AddQuad(OgreDynamicLines &_lines,
+    const math::Vector3d &_start0, const math::Vector3d &_end0,
+    const math::Vector3d &_start1, const math::Vector3d &_end1)
+{
+  // same vertex order and winding as a strip of the four points
+  _lines.AddPoint(_start0);
+  _lines.AddPoint(_end0);
+  _lines.AddPoint(_start1);
+  _lines.AddPoint(_start1);
+  _lines.AddPoint(_end0);
+  _lines.AddPoint(_end1);
+}
+
 //////////////////////////////////////////////////
 OgreLidarVisual::OgreLidarVisual()
   : dataPtr(new OgreLidarVisualPrivate)
@@ -85,36 +136,6 @@ void OgreLidarVisual::PreRender()
 void OgreLidarVisual::Destroy()
 {
   BaseLidarVisual::Destroy();
-  for (auto ray : this->dataPtr->noHitRayStrips)
-  {
-    ray->Clear();
-    ray.reset();
-  }
-
-  for (auto ray : this->dataPtr->rayStrips)
-  {
-    ray->Clear();
-    ray.reset();
-  }
-
-  for (auto ray : this->dataPtr->rayLines)
-  {
-    ray->Clear();
-    ray.reset();
-  }
-
-  for (auto ray : this->dataPtr->deadZoneRayFans)
-  {
-    ray->Clear();
-    ray.reset();
-  }
-
-  for (auto ray : this->dataPtr->points)
-  {
-    ray->Clear();
-    ray.reset();
-  }
-
   this->ClearPoints();
   this->ClearVisualData();
 }
@@ -144,11 +165,11 @@ void OgreLidarVisual::ClearPoints()
 //////////////////////////////////////////////////
 void OgreLidarVisual::ClearVisualData()
 {
-  this->dataPtr->noHitRayStrips.clear();
-  this->dataPtr->deadZoneRayFans.clear();
-  this->dataPtr->rayLines.clear();
-  this->dataPtr->rayStrips.clear();
-  this->dataPtr->points.clear();
+  this->dataPtr->noHitRayStrips.reset();
+  this->dataPtr->deadZoneRayFans.reset();
+  this->dataPtr->rayLines.reset();
+  this->dataPtr->rayStrips.reset();
+  this->dataPtr->points.reset();
 }
 
 //////////////////////////////////////////////////
@@ -194,22 +215,8 @@ void OgreLidarVisual::Update()
     return;
   }
 
-  bool clearVisuals = false;
-
-  if (this->lidarVisualType != this->dataPtr->lidarVisType
-        || !this->displayNonHitting)
-  {
-    clearVisuals = true;
-  }
-
-  if (this->displayNonHitting != this->dataPtr->currentDisplayNonHitting)
-  {
-    clearVisuals = true;
-    this->dataPtr->currentDisplayNonHitting = this->displayNonHitting;
-  }
-
   // if visual type is changed, clear all DynamicLines
-  if (clearVisuals)
+  if (this->lidarVisualType != this->dataPtr->lidarVisType)
   {
     this->ClearVisualData();
   }
@@ -242,124 +249,62 @@ void OgreLidarVisual::Update()
     return;
   }
 
-  #if (!(OGRE_VERSION <= ((1 << 16) | (10 << 8) | 7)))
-  // the Materials are assigned here to avoid repetitive search for materials
-  Ogre::MaterialPtr noHitRayStripsMat =
-                  Ogre::MaterialManager::getSingleton().getByName(
-                                                    "Lidar/LightBlueStrips");
-  Ogre::MaterialPtr rayLineMat =
-                  Ogre::MaterialManager::getSingleton().getByName(
-                                                    "Lidar/BlueRay");
-  Ogre::MaterialPtr hitRayStripsMat =
-                  Ogre::MaterialManager::getSingleton().getByName(
-                                                    "Lidar/BlueStrips");
-  Ogre::MaterialPtr deadZoneMat =
-                  Ogre::MaterialManager::getSingleton().getByName(
-                                                    "Lidar/TransBlack");
-  Ogre::MaterialPtr pointsMat =
-                  Ogre::MaterialManager::getSingleton().getByName(
-                                                    "PointCloudPoint");
-  #endif
-
-  // Process each point from received data
-  // Every line segment, and every triangle is saved separately,
-  // as a pointer to a DynamicLine
-  // This initializes and updates only the selected DynamicLine variables
-  for (unsigned int j = 0; j < this->verticalCount; ++j)
+  bool strips =
+      this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS;
+  bool lines = strips ||
+      this->dataPtr->lidarVisType == LidarVisualType::LVT_RAY_LINES;
+  bool points = this->dataPtr->lidarVisType == LidarVisualType::LVT_POINTS;
+
+  // All vertical rays share one DynamicLines object per visualization type,
+  // so a scan is a single rebuild and a single draw call per type. Clearing
+  // keeps the point and hardware buffer capacity of the previous scan, so
+  // rebuilding does not reallocate once the first scan is drawn.
+  if (lines)
   {
-    horizontalAngle = this->minHorizontalAngle;
-
-    if (this->dataPtr->lidarVisType == LidarVisualType::LVT_RAY_LINES ||
-        this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS)
+    if (!this->dataPtr->rayLines)
     {
-      if (j+1 > this->dataPtr->rayLines.size())
-      {
-        std::shared_ptr<OgreDynamicLines> line =
-                    std::shared_ptr<OgreDynamicLines>(
-                          new OgreDynamicLines(MT_LINE_LIST));
-
-        #if (OGRE_VERSION <= ((1 << 16) | (10 << 8) | 7))
-              line->setMaterial("Lidar/BlueRay");
-        #else
-            line->setMaterial(rayLineMat);
-        #endif
-        std::shared_ptr<Ogre::MovableObject> mv =
-                std::dynamic_pointer_cast<Ogre::MovableObject>(line);
-        this->Node()->attachObject(mv.get());
-        this->dataPtr->rayLines.push_back(line);
-
-        if (this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS)
-        {
-          line = std::shared_ptr<OgreDynamicLines>(
-                    new OgreDynamicLines(MT_TRIANGLE_STRIP));
-
-          #if (OGRE_VERSION <= ((1 << 16) | (10 << 8) | 7))
-            line->setMaterial("Lidar/LightBlueStrips");
-          #else
-            line->setMaterial(noHitRayStripsMat);
-          #endif
-          mv = std::dynamic_pointer_cast<Ogre::MovableObject>(line);
-          this->Node()->attachObject(mv.get());
-          this->dataPtr->noHitRayStrips.push_back(line);
-
-          line = std::shared_ptr<OgreDynamicLines>(
-                      new OgreDynamicLines(MT_TRIANGLE_FAN));
-
-          #if (OGRE_VERSION <= ((1 << 16) | (10 << 8) | 7))
-            line->setMaterial("Lidar/TransBlack");
-          #else
-            line->setMaterial(deadZoneMat);
-          #endif
-          mv = std::dynamic_pointer_cast<Ogre::MovableObject>(line);
-          this->Node()->attachObject(mv.get());
-          this->dataPtr->deadZoneRayFans.push_back(line);
-          this->dataPtr->deadZoneRayFans[j]->AddPoint(
-                      ignition::math::Vector3d::Zero);
-
-          line = std::shared_ptr<OgreDynamicLines>(
-                      new OgreDynamicLines(MT_TRIANGLE_STRIP));
-
-          #if (OGRE_VERSION <= ((1 << 16) | (10 << 8) | 7))
-            line->setMaterial("Lidar/BlueStrips");
-          #else
-            line->setMaterial(hitRayStripsMat);
-          #endif
-          mv = std::dynamic_pointer_cast<Ogre::MovableObject>(line);
-          this->Node()->attachObject(mv.get());
-          this->dataPtr->rayStrips.push_back(line);
-        }
-      }
+      this->dataPtr->rayLines = this->dataPtr->CreateLines(MT_LINE_LIST,
+          "Lidar/BlueRay", this->Node());
     }
-
-    else if (this->dataPtr->lidarVisType ==
-                  LidarVisualType::LVT_POINTS)
+    this->dataPtr->rayLines->Clear();
+  }
+  if (strips)
+  {
+    if (!this->dataPtr->rayStrips)
     {
-      if (j+1 > this->dataPtr->points.size())
-      {
-        std::shared_ptr<OgreDynamicLines> line =
-                  std::shared_ptr<OgreDynamicLines>(
-                              new OgreDynamicLines(MT_POINTS));
-
-        #if (OGRE_VERSION <= ((1 << 16) | (10 << 8) | 7))
-            line->setMaterial("PointCloudPoint");
-        #else
-            line->setMaterial(pointsMat);
-        #endif
-        std::shared_ptr<Ogre::MovableObject> mv =
-                std::dynamic_pointer_cast<Ogre::MovableObject>(line);
-        this->Node()->attachObject(mv.get());
-        this->dataPtr->points.push_back(line);
-      }
+      this->dataPtr->noHitRayStrips = this->dataPtr->CreateLines(
+          MT_TRIANGLE_LIST, "Lidar/LightBlueStrips", this->Node());
+      this->dataPtr->deadZoneRayFans = this->dataPtr->CreateLines(
+          MT_TRIANGLE_LIST, "Lidar/TransBlack", this->Node());
+      this->dataPtr->rayStrips = this->dataPtr->CreateLines(
+          MT_TRIANGLE_LIST, "Lidar/BlueStrips", this->Node());
     }
-
-    if (this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS)
+    this->dataPtr->noHitRayStrips->Clear();
+    this->dataPtr->deadZoneRayFans->Clear();
+    this->dataPtr->rayStrips->Clear();
+  }
+  if (points)
+  {
+    if (!this->dataPtr->points)
     {
-      this->dataPtr->deadZoneRayFans[j]->SetPoint(0, this->offset.Pos());
+      this->dataPtr->points = this->dataPtr->CreateLines(MT_POINTS,
+          "PointCloudPoint", this->Node());
     }
+    this->dataPtr->points->Clear();
+  }
+
+  // Process each point from received data
+  for (unsigned int j = 0; j < this->verticalCount; ++j)
+  {
+    horizontalAngle = this->minHorizontalAngle;
+
+    // points of the previous ray of the scan, to close the strips and fans
+    ignition::math::Vector3d prevStartPt;
+    ignition::math::Vector3d prevHitPt;
+    ignition::math::Vector3d prevNoHitPt;
 
-    unsigned count = this->horizontalCount;
     // Process each ray in current scan
-    for (unsigned int i = 0; i < count; ++i)
+    for (unsigned int i = 0; i < this->horizontalCount; ++i)
     {
       // calculate range of the ray
       double r = this->dataPtr->lidarPoints[ j * this->horizontalCount + i];
@@ -389,108 +334,60 @@ void OgreLidarVisual::Update()
       ignition::math::Vector3d noHitPt =
                   (axis * noHitRange) + this->offset.Pos();
 
-      // Update the lines and strips that represent each simulated ray.
-
-      // For TRIANGLE_STRIPS Lidar Visual to be displayed
-      if (this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS
-        || this->dataPtr->lidarVisType == LidarVisualType::LVT_RAY_LINES)
+      if (lines && (this->displayNonHitting || !inf))
       {
-        if (i >= this->dataPtr->rayLines[j]->PointCount()/2)
-        {
-          if (this->displayNonHitting || !inf)
-          {
-            this->dataPtr->rayLines[j]->AddPoint(startPt);
-            this->dataPtr->rayLines[j]->AddPoint(inf ? noHitPt: pt);
-          }
-
-          if (this->dataPtr->lidarVisType ==
-                LidarVisualType::LVT_TRIANGLE_STRIPS)
-          {
-            this->dataPtr->rayStrips[j]->AddPoint(startPt);
-            this->dataPtr->rayStrips[j]->AddPoint(inf ? startPt : pt);
-
-            this->dataPtr->noHitRayStrips[j]->AddPoint(startPt);
-            this->dataPtr->noHitRayStrips[j]->AddPoint(
-                inf ? (this->displayNonHitting? noHitPt: startPt) : pt);
-          }
-        }
-        else
-        {
-          if (this->displayNonHitting || !inf)
-          {
-            this->dataPtr->rayLines[j]->SetPoint(i*2, startPt);
-            this->dataPtr->rayLines[j]->SetPoint(i*2+1, inf ? noHitPt: pt);
-          }
-
-          if (this->dataPtr->lidarVisType ==
-                LidarVisualType::LVT_TRIANGLE_STRIPS)
-          {
-            this->dataPtr->rayStrips[j]->SetPoint(i*2, startPt);
-            this->dataPtr->rayStrips[j]->SetPoint(i*2+1, inf? startPt : pt);
-
-            this->dataPtr->noHitRayStrips[j]->SetPoint(i*2, startPt);
-            this->dataPtr->noHitRayStrips[j]->SetPoint(i*2+1,
-                inf ? (this->displayNonHitting? noHitPt: startPt) : pt);
-          }
-        }
-        if (this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS)
-        {
-          // Draw the triangle fan that indicates the dead zone.
-          if (i+1 >= this->dataPtr->deadZoneRayFans[j]->PointCount())
-            this->dataPtr->deadZoneRayFans[j]->AddPoint(startPt);
-          else
-            this->dataPtr->deadZoneRayFans[j]->SetPoint(i+1, startPt);
-        }
+        this->dataPtr->rayLines->AddPoint(startPt);
+        this->dataPtr->rayLines->AddPoint(inf ? noHitPt : pt);
       }
 
-      // For POINTS Lidar Visual to be displayed
-      else if (this->dataPtr->lidarVisType ==
-                LidarVisualType::LVT_POINTS)
+      if (strips)
       {
-        if (i >= this->dataPtr->points[j]->PointCount())
-        {
-          if (this->displayNonHitting || !inf)
-          {
-            this->dataPtr->points[j]->AddPoint(inf ? noHitPt: pt,
-                  this->dataPtr->pointColors[j * this->horizontalCount + i]);
-          }
-        }
-        else
+        ignition::math::Vector3d hitPt = inf ? startPt : pt;
+        ignition::math::Vector3d noHitEndPt =
+            inf ? (this->displayNonHitting ? noHitPt : startPt) : pt;
+        if (i > 0)
         {
-          if (this->displayNonHitting || !inf)
-          {
-            this->dataPtr->points[j]->SetPoint(i, inf ? noHitPt: pt);
-          }
+          OgreLidarVisualPrivate::AddQuad(*this->dataPtr->rayStrips,
+              prevStartPt, prevHitPt, startPt, hitPt);
+          OgreLidarVisualPrivate::AddQuad(*this->dataPtr->noHitRayStrips,
+              prevStartPt, prevNoHitPt, startPt, noHitEndPt);
+
+          // Draw the triangle fan that indicates the dead zone.
+          this->dataPtr->deadZoneRayFans->AddPoint(this->offset.Pos());
+          this->dataPtr->deadZoneRayFans->AddPoint(prevStartPt);
+          this->dataPtr->deadZoneRayFans->AddPoint(startPt);
         }
+        prevStartPt = startPt;
+        prevHitPt = hitPt;
+        prevNoHitPt = noHitEndPt;
       }
-      horizontalAngle += this->horizontalAngleStep;
-    }
-
-    // Update the DynamicLines pointers after adding points based on type
-    if (this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS
-      || this->dataPtr->lidarVisType == LidarVisualType::LVT_RAY_LINES)
-    {
-      this->dataPtr->rayLines[j]->Update();
-      if (this->dataPtr->lidarVisType ==
-                      LidarVisualType::LVT_TRIANGLE_STRIPS)
+      else if (points && (this->displayNonHitting || !inf))
       {
-        this->dataPtr->rayStrips[j]->Update();
-        this->dataPtr->noHitRayStrips[j]->Update();
-        this->dataPtr->deadZoneRayFans[j]->Update();
+        this->dataPtr->points->AddPoint(inf ? noHitPt : pt,
+            this->dataPtr->pointColors[j * this->horizontalCount + i]);
       }
-    }
-    else if (this->dataPtr->lidarVisType == LidarVisualType::LVT_POINTS)
-    {
-      this->dataPtr->points[j]->Update();
+      horizontalAngle += this->horizontalAngleStep;
     }
     verticalAngle += this->verticalAngleStep;
   }
 
-  if (this->dataPtr->lidarVisType == LidarVisualType::LVT_POINTS &&
-      !this->dataPtr->points.empty())
+  // Upload each buffer once, after all scans are processed
+  if (lines)
   {
+    this->dataPtr->rayLines->Update();
+  }
+  if (strips)
+  {
+    this->dataPtr->rayStrips->Update();
+    this->dataPtr->noHitRayStrips->Update();
+    this->dataPtr->deadZoneRayFans->Update();
+  }
+  if (points)
+  {
+    this->dataPtr->points->Update();
+
     // get the PointCloudPoint material
-    Ogre::MaterialPtr mat = this->dataPtr->points[0]->getMaterial();
+    Ogre::MaterialPtr mat = this->dataPtr->points->getMaterial();
     auto pass = mat->getTechnique(0)->getPass(0);
     auto params = pass->getVertexProgramParameters();
     params->setNamedConstant("size", static_cast<Ogre::Real>(this->size));
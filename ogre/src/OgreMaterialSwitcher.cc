@@ -16,6 +16,7 @@
 */
 
 #include "ignition/common/Console.hh"
+#include "ignition/common/Profiler.hh"
 #include "ignition/rendering/ogre/OgreIncludes.hh"
 #include "ignition/rendering/ogre/OgreMaterialSwitcher.hh"
 #include "ignition/rendering/RenderTypes.hh"
@@ -145,6 +146,7 @@ Ogre::Technique *OgreMaterialSwitcher::handleSchemeNotFound(
 void OgreMaterialSwitcher::preRenderTargetUpdate(
     const Ogre::RenderTargetEvent &/*_evt*/)
 {
+  IGN_PROFILE("OgreMaterialSwitcher::preRenderTargetUpdate");
   Ogre::MaterialManager::getSingleton().addListener(this);
 }
 
@@ -152,6 +154,7 @@ void OgreMaterialSwitcher::preRenderTargetUpdate(
 void OgreMaterialSwitcher::postRenderTargetUpdate(
     const Ogre::RenderTargetEvent &/*_evt*/)
 {
+  IGN_PROFILE("OgreMaterialSwitcher::postRenderTargetUpdate");
   Ogre::MaterialManager::getSingleton().removeListener(this);
 }
 
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+#include "OgreMemoryStats.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+/// \brief Add the buffers bound to vertex data
+/// \param[in] _data Vertex data, may be null
+/// \param[in, out] _seen Resources counted so far
+/// \param[in, out] _stats Stats to add to
+static void addVertexData(const Ogre::VertexData *_data,
+    std::unordered_set<const void *> &_seen, MemoryStats &_stats)
+{
+  if (!_data || !_data->vertexBufferBinding)
+    return;
+
+  for (const auto &binding : _data->vertexBufferBinding->getBindings())
+  {
+    const Ogre::HardwareVertexBuffer *buffer = binding.second.get();
+    if (buffer && _seen.insert(buffer).second)
+      _stats.vertexBufferBytes += buffer->getSizeInBytes();
+  }
+}
+
+//////////////////////////////////////////////////
+void OgreMemoryStats::AddTexture(const Ogre::Texture *_texture,
+    std::unordered_set<const void *> &_seen, MemoryStats &_stats)
+{
+  if (!_texture || !_texture->isLoaded() || !_seen.insert(_texture).second)
+    return;
+
+  uint64_t bytes = _texture->getSize();
+  _stats.textureCount++;
+
+  if (!(_texture->getUsage() & Ogre::TU_RENDERTARGET))
+  {
+    _stats.textureBytes += bytes;
+    return;
+  }
+
+  // shadow textures are named e.g. Ogre/ShadowTexture0
+  std::string name = _texture->getName();
+  std::transform(name.begin(), name.end(), name.begin(),
+      [](unsigned char _c) {return std::tolower(_c);});
+  if (name.find("shadow") != std::string::npos)
+    _stats.shadowMapBytes += bytes;
+  else
+    _stats.renderTargetBytes += bytes;
+}
+
+//////////////////////////////////////////////////
+void OgreMemoryStats::AddMesh(const Ogre::Mesh *_mesh,
+    std::unordered_set<const void *> &_seen, MemoryStats &_stats)
+{
+  if (!_mesh || !_mesh->isLoaded() || !_seen.insert(_mesh).second)
+    return;
+
+  _stats.meshCount++;
+  addVertexData(_mesh->sharedVertexData, _seen, _stats);
+  for (unsigned int i = 0; i < _mesh->getNumSubMeshes(); ++i)
+  {
+    const Ogre::SubMesh *subMesh = _mesh->getSubMesh(i);
+    if (!subMesh->useSharedVertices)
+      addVertexData(subMesh->vertexData, _seen, _stats);
+
+    if (!subMesh->indexData)
+      continue;
+    const Ogre::HardwareIndexBuffer *buffer =
+        subMesh->indexData->indexBuffer.get();
+    if (buffer && _seen.insert(buffer).second)
+      _stats.indexBufferBytes += buffer->getSizeInBytes();
+  }
+}
+
+//////////////////////////////////////////////////
+void OgreMemoryStats::AddMaterial(const Ogre::Material *_material,
+    std::unordered_set<const void *> &_seen, MemoryStats &_stats)
+{
+  if (!_material || !_seen.insert(_material).second)
+    return;
+
+  for (unsigned short t = 0; t < _material->getNumTechniques(); ++t)
+  {
+    const Ogre::Technique *technique = _material->getTechnique(t);
+    for (unsigned short p = 0; p < technique->getNumPasses(); ++p)
+    {
+      const Ogre::Pass *pass = technique->getPass(p);
+      for (unsigned short u = 0; u < pass->getNumTextureUnitStates(); ++u)
+      {
+        const Ogre::TextureUnitState *unit = pass->getTextureUnitState(u);
+        for (unsigned int f = 0; f < unit->getNumFrames(); ++f)
+          AddTexture(unit->_getTexturePtr(f).get(), _seen, _stats);
+      }
+    }
+  }
+}
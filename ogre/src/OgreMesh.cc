@@ -15,6 +15,8 @@
  *
  */
 
+#include <algorithm>
+
 #include <ignition/common/Console.hh>
 
 #include "ignition/rendering/ogre/OgreConversions.hh"
@@ -138,6 +140,38 @@ void OgreMesh::SetSkeletonLocalTransforms(
   }
 }
 
+//////////////////////////////////////////////////
+std::vector<std::string> OgreMesh::SkeletonBoneNames() const
+{
+  std::vector<std::string> names;
+  if (!this->ogreEntity->hasSkeleton())
+    return names;
+
+  Ogre::SkeletonInstance *skel = this->ogreEntity->getSkeleton();
+  names.reserve(skel->getNumBones());
+  for (unsigned int i = 0; i < skel->getNumBones(); ++i)
+    names.push_back(skel->getBone(i)->getName());
+  return names;
+}
+
+//////////////////////////////////////////////////
+void OgreMesh::SetSkeletonBoneTransforms(
+    const std::vector<math::Matrix4d> &_tfs)
+{
+  if (!this->ogreEntity->hasSkeleton())
+    return;
+
+  Ogre::SkeletonInstance *skel = this->ogreEntity->getSkeleton();
+  std::size_t count = std::min<std::size_t>(_tfs.size(), skel->getNumBones());
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    Ogre::Bone *bone = skel->getBone(static_cast<unsigned short>(i));
+    bone->setManuallyControlled(true);
+    bone->setPosition(OgreConversions::Convert(_tfs[i].Translation()));
+    bone->setOrientation(OgreConversions::Convert(_tfs[i].Rotation()));
+  }
+}
+
 //////////////////////////////////////////////////
 void OgreMesh::SetSkeletonAnimationEnabled(const std::string &_name,
     bool _enabled, bool _loop, float _weight)
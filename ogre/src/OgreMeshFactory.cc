@@ -17,6 +17,7 @@
 
 
 #include <sstream>
+#include <vector>
 
 #include <ignition/common/Console.hh>
 #include <ignition/common/Material.hh>
@@ -34,6 +35,7 @@
 #include "ignition/rendering/ogre/OgreRenderEngine.hh"
 #include "ignition/rendering/ogre/OgreScene.hh"
 #include "ignition/rendering/ogre/OgreStorage.hh"
+#include "ignition/rendering/Utils.hh"
 
 using namespace ignition;
 using namespace rendering;
@@ -404,9 +406,21 @@ bool OgreMeshFactory::LoadImpl(const MeshDescriptor &_desc)
         }
       }
 
-      // Add all the indices
+      // Add all the indices, triangles are reordered for the vertex cache
+      // and overdraw
+      std::vector<unsigned int> subMeshIndices(subMesh.IndexCount());
       for (j = 0; j < subMesh.IndexCount(); j++)
-        *indices++ = subMesh.Index(j);
+        subMeshIndices[j] = subMesh.Index(j);
+      if (subMesh.SubMeshPrimitiveType() == common::SubMesh::TRIANGLES)
+      {
+        std::vector<math::Vector3d> positions(subMesh.VertexCount());
+        for (j = 0; j < subMesh.VertexCount(); j++)
+          positions[j] = subMesh.Vertex(j);
+        subMeshIndices = optimizeOverdraw(positions,
+            optimizeVertexCache(subMeshIndices, positions.size()));
+      }
+      for (unsigned int index : subMeshIndices)
+        *indices++ = index;
 
       common::MaterialPtr material;
       material = _desc.mesh->MaterialByIndex(subMesh.MaterialIndex());
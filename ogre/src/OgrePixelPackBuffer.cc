@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#if !defined(__APPLE__) && !defined(_WIN32)
+# include <GL/glx.h>
+#endif
+
+#include <ignition/common/Console.hh>
+
+#include "OgrePixelPackBuffer.hh"
+
+#ifndef GL_PIXEL_PACK_BUFFER
+# define GL_PIXEL_PACK_BUFFER 0x88EB
+#endif
+#ifndef GL_STREAM_READ
+# define GL_STREAM_READ 0x88E1
+#endif
+#ifndef GL_READ_ONLY
+# define GL_READ_ONLY 0x88B8
+#endif
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief GL buffer object entry points. They are not part of the GL 1.x
+/// headers, so they are looked up at runtime.
+struct GlBufferFunctions
+{
+  void (*genBuffers)(int, unsigned int *) = nullptr;
+  void (*deleteBuffers)(int, const unsigned int *) = nullptr;
+  void (*bindBuffer)(unsigned int, unsigned int) = nullptr;
+  void (*bufferData)(unsigned int, ptrdiff_t, const void *, unsigned int) =
+      nullptr;
+  void *(*mapBuffer)(unsigned int, unsigned int) = nullptr;
+  unsigned char (*unmapBuffer)(unsigned int) = nullptr;
+  bool loaded = false;
+};
+
+//////////////////////////////////////////////////
+static const GlBufferFunctions &glBufferFunctions()
+{
+  static GlBufferFunctions functions = []()
+  {
+    GlBufferFunctions f;
+#if !defined(__APPLE__) && !defined(_WIN32)
+    auto load = [](const char *_name)
+    {
+      return glXGetProcAddressARB(reinterpret_cast<const GLubyte *>(_name));
+    };
+    f.genBuffers = reinterpret_cast<decltype(f.genBuffers)>(
+        load("glGenBuffers"));
+    f.deleteBuffers = reinterpret_cast<decltype(f.deleteBuffers)>(
+        load("glDeleteBuffers"));
+    f.bindBuffer = reinterpret_cast<decltype(f.bindBuffer)>(
+        load("glBindBuffer"));
+    f.bufferData = reinterpret_cast<decltype(f.bufferData)>(
+        load("glBufferData"));
+    f.mapBuffer = reinterpret_cast<decltype(f.mapBuffer)>(
+        load("glMapBuffer"));
+    f.unmapBuffer = reinterpret_cast<decltype(f.unmapBuffer)>(
+        load("glUnmapBuffer"));
+#endif
+    f.loaded = f.genBuffers && f.deleteBuffers && f.bindBuffer &&
+        f.bufferData && f.mapBuffer && f.unmapBuffer;
+    if (!f.loaded)
+    {
+      ignwarn << "GL pixel buffer objects are not available, sensor data "
+              << "is read back synchronously" << std::endl;
+    }
+    return f;
+  }();
+  return functions;
+}
+
+//////////////////////////////////////////////////
+OgrePixelPackBuffer::OgrePixelPackBuffer()
+{
+}
+
+//////////////////////////////////////////////////
+OgrePixelPackBuffer::~OgrePixelPackBuffer()
+{
+  if (this->buffer)
+    glBufferFunctions().deleteBuffers(1, &this->buffer);
+}
+
+//////////////////////////////////////////////////
+bool OgrePixelPackBuffer::Available()
+{
+  return glBufferFunctions().loaded;
+}
+
+//////////////////////////////////////////////////
+bool OgrePixelPackBuffer::Download(unsigned int _textureId,
+    unsigned int _width, unsigned int _height, Ogre::PixelFormat _format)
+{
+  const GlBufferFunctions &gl = glBufferFunctions();
+  if (!gl.loaded || _textureId == 0u)
+    return false;
+
+#if !defined(__APPLE__) && !defined(_WIN32)
+  GLenum glFormat;
+  GLenum glType;
+  switch (_format)
+  {
+    case Ogre::PF_BYTE_RGB:
+      glFormat = GL_RGB;
+      glType = GL_UNSIGNED_BYTE;
+      break;
+    case Ogre::PF_FLOAT32_R:
+      glFormat = GL_RED;
+      glType = GL_FLOAT;
+      break;
+    case Ogre::PF_FLOAT32_RGB:
+      glFormat = GL_RGB;
+      glType = GL_FLOAT;
+      break;
+    case Ogre::PF_FLOAT32_RGBA:
+      glFormat = GL_RGBA;
+      glType = GL_FLOAT;
+      break;
+    default:
+      ignerr << "Unsupported pixel buffer format: "
+             << Ogre::PixelUtil::getFormatName(_format) << std::endl;
+      return false;
+  }
+
+  if (!this->buffer)
+    gl.genBuffers(1, &this->buffer);
+
+  // new storage is allocated for every download so queueing never waits
+  // on the previous content of the buffer
+  this->size = Ogre::PixelUtil::getMemorySize(_width, _height, 1, _format);
+  gl.bindBuffer(GL_PIXEL_PACK_BUFFER, this->buffer);
+  gl.bufferData(GL_PIXEL_PACK_BUFFER, static_cast<ptrdiff_t>(this->size),
+      nullptr, GL_STREAM_READ);
+
+  // ogre caches GL state, so the texture binding is restored afterwards
+  GLint boundTexture = 0;
+  glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+  glBindTexture(GL_TEXTURE_2D, _textureId);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glGetTexImage(GL_TEXTURE_2D, 0, glFormat, glType, nullptr);
+  glPixelStorei(GL_PACK_ALIGNMENT, 4);
+  glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(boundTexture));
+  gl.bindBuffer(GL_PIXEL_PACK_BUFFER, 0u);
+  return true;
+#else
+  (void)_width;
+  (void)_height;
+  (void)_format;
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////
+const void *OgrePixelPackBuffer::Map()
+{
+  const GlBufferFunctions &gl = glBufferFunctions();
+  if (!gl.loaded || !this->buffer)
+    return nullptr;
+
+  gl.bindBuffer(GL_PIXEL_PACK_BUFFER, this->buffer);
+  const void *data = gl.mapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+  gl.bindBuffer(GL_PIXEL_PACK_BUFFER, 0u);
+  return data;
+}
+
+//////////////////////////////////////////////////
+void OgrePixelPackBuffer::Unmap()
+{
+  const GlBufferFunctions &gl = glBufferFunctions();
+  if (!gl.loaded || !this->buffer)
+    return;
+
+  gl.bindBuffer(GL_PIXEL_PACK_BUFFER, this->buffer);
+  gl.unmapBuffer(GL_PIXEL_PACK_BUFFER);
+  gl.bindBuffer(GL_PIXEL_PACK_BUFFER, 0u);
+}
+
+//////////////////////////////////////////////////
+size_t OgrePixelPackBuffer::Size() const
+{
+  return this->size;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE_OGREPIXELPACKBUFFER_HH_
+#define IGNITION_RENDERING_OGRE_OGREPIXELPACKBUFFER_HH_
+
+#include <cstddef>
+
+#include "ignition/rendering/ogre/OgreIncludes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief GL pixel buffer object that textures are downloaded to
+    /// without stalling the CPU. Download only queues the copy on the GPU,
+    /// it is waited on when the buffer is mapped. Sensors keep two of them
+    /// and map the one filled during the previous frame, by which time the
+    /// copy has usually completed.
+    class OgrePixelPackBuffer
+    {
+      /// \brief Constructor
+      public: OgrePixelPackBuffer();
+
+      /// \brief Destructor. The GL context the buffer was created in must
+      /// be current.
+      public: ~OgrePixelPackBuffer();
+
+      /// \brief Check if pixel buffer objects are available
+      /// \return True if textures can be downloaded asynchronously
+      public: static bool Available();
+
+      /// \brief Queue the download of the first mip level of a texture.
+      /// Supported formats are PF_BYTE_RGB, PF_FLOAT32_R, PF_FLOAT32_RGB
+      /// and PF_FLOAT32_RGBA.
+      /// \param[in] _textureId GL id of the texture to download
+      /// \param[in] _width Texture width
+      /// \param[in] _height Texture height
+      /// \param[in] _format Format the data is converted to
+      /// \return False if nothing was queued, e.g. because pixel buffer
+      /// objects are not available or the format is not supported
+      public: bool Download(unsigned int _textureId, unsigned int _width,
+          unsigned int _height, Ogre::PixelFormat _format);
+
+      /// \brief Map the data of the last download, waiting for the copy to
+      /// complete if needed. Rows are tightly packed.
+      /// \return Pointer to the data, or null on failure. It is valid
+      /// until Unmap is called.
+      public: const void *Map();
+
+      /// \brief Unmap the data returned by Map
+      public: void Unmap();
+
+      /// \brief Get the size of the last download
+      /// \return Size in bytes
+      public: size_t Size() const;
+
+      /// \brief GL buffer name, 0 until the first download
+      private: unsigned int buffer = 0u;
+
+      /// \brief Size of the last download in bytes
+      private: size_t size = 0u;
+    };
+    }
+  }
+}
+#endif
@@ -22,6 +22,9 @@
 
 #include <mutex>
 #include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <ignition/common/Console.hh>
@@ -70,6 +73,15 @@ class ignition::rendering::OgreRTShaderSystemPrivate
 
   /// \brief Flag to indicate shadows need to be reapplied
   public: bool resetShadows = false;
+
+  /// \brief Configuration the shaders of each material were last generated
+  /// for. Materials shared by many submeshes are only generated once.
+  /// Key: material name, value: configuration, see ShaderConfig
+  public: std::unordered_map<std::string, std::string> generatedShaders;
+
+  /// \brief Incremented when the scenes or the shadows change, which
+  /// requires the shaders of all materials to be generated again
+  public: unsigned int revision = 0u;
 };
 
 using namespace ignition;
@@ -164,6 +176,7 @@ void OgreRTShaderSystem::Fini()
 #endif
   this->dataPtr->entities.clear();
   this->dataPtr->scenes.clear();
+  this->dataPtr->generatedShaders.clear();
   this->dataPtr->shadowsApplied = false;
   this->dataPtr->initialized = false;
 }
@@ -179,6 +192,7 @@ void OgreRTShaderSystem::AddScene(OgreScenePtr _scene)
   this->dataPtr->shaderGenerator->createScheme(_scene->Name() +
       Ogre::RTShader::ShaderGenerator::DEFAULT_SCHEME_NAME);
   this->dataPtr->scenes.push_back(_scene);
+  this->dataPtr->revision++;
 }
 
 //////////////////////////////////////////////////
@@ -202,6 +216,8 @@ void OgreRTShaderSystem::RemoveScene(OgreScenePtr _scene)
         _scene->OgreSceneManager());
     this->dataPtr->shaderGenerator->removeAllShaderBasedTechniques();
     this->dataPtr->shaderGenerator->flushShaderCache();
+    this->dataPtr->generatedShaders.clear();
+    this->dataPtr->revision++;
   }
 }
 
@@ -293,6 +309,7 @@ void OgreRTShaderSystem::RemoveShaders(OgreSubMesh *_subMesh)
 
   Ogre::SubEntity *curSubEntity = _subMesh->OgreSubEntity();
   const Ogre::String &curMaterialName = curSubEntity->getMaterialName();
+  this->dataPtr->generatedShaders.erase(curMaterialName);
   for (const auto &s : this->dataPtr->scenes)
   {
     try
@@ -373,6 +390,18 @@ void OgreRTShaderSystem::GenerateShaders(OgreSubMesh *subMesh)
   std::string normalMapName = material->NormalMap();
 
   const Ogre::String& curMaterialName = curSubEntity->getMaterialName();
+
+  // submeshes sharing a material share its techniques, skip the material
+  // if its shaders were already generated for the same configuration
+  std::string config = this->ShaderConfig(material);
+  auto generated = this->dataPtr->generatedShaders.find(curMaterialName);
+  if (generated != this->dataPtr->generatedShaders.end() &&
+      generated->second == config)
+  {
+    return;
+  }
+  this->dataPtr->generatedShaders[curMaterialName] = config;
+
   bool success = false;
 
   for (unsigned int s = 0; s < this->dataPtr->scenes.size(); s++)
@@ -473,6 +502,29 @@ void OgreRTShaderSystem::GenerateShaders(OgreSubMesh *subMesh)
   }
 }
 
+//////////////////////////////////////////////////
+std::string OgreRTShaderSystem::ShaderConfig(OgreMaterialPtr _material) const
+{
+  // the texture units of the source technique change the generated
+  // programs, the other material properties are uniforms
+  unsigned int textureUnitCount = 0u;
+  Ogre::MaterialPtr ogreMaterial = _material->Material();
+  if (ogreMaterial->getNumTechniques() > 0u &&
+      ogreMaterial->getTechnique(0)->getNumPasses() > 0u)
+  {
+    textureUnitCount = ogreMaterial->getTechnique(0)->getPass(0)
+        ->getNumTextureUnitStates();
+  }
+
+  std::stringstream config;
+  config << ogreMaterial.get()
+         << " " << ShaderUtil::Name(_material->ShaderType())
+         << " " << _material->NormalMap()
+         << " " << textureUnitCount
+         << " " << this->dataPtr->revision;
+  return config.str();
+}
+
 //////////////////////////////////////////////////
 bool OgreRTShaderSystem::Paths(std::string &coreLibsPath,
     std::string &cachePath)
@@ -510,7 +562,12 @@ bool OgreRTShaderSystem::Paths(std::string &coreLibsPath,
       const char* userEnv = std::getenv("USER");
       if (userEnv)
         user = std::string(userEnv);
-      cachePath = common::joinPaths(tmpDir, user + "-rtshaderlibcache");
+      // generated programs differ between ogre and ign-rendering versions
+      cachePath = common::joinPaths(tmpDir, user + "-rtshaderlibcache",
+          std::to_string(OGRE_VERSION_MAJOR) + "." +
+          std::to_string(OGRE_VERSION_MINOR) + "." +
+          std::to_string(OGRE_VERSION_PATCH) + "-" +
+          IGNITION_RENDERING_VERSION_FULL);
       // Create the directory
       if (!common::createDirectories(cachePath))
       {
@@ -555,6 +612,7 @@ void OgreRTShaderSystem::RemoveShadows(OgreScenePtr _scene)
       Ogre::RTShader::ShaderGenerator::DEFAULT_SCHEME_NAME);
   this->UpdateShaders();
 
+  this->dataPtr->revision++;
   this->dataPtr->shadowsApplied = false;
 }
 
@@ -664,6 +722,7 @@ void OgreRTShaderSystem::ApplyShadows(OgreScenePtr _scene)
 
   this->UpdateShaders();
 
+  this->dataPtr->revision++;
   this->dataPtr->shadowsApplied = true;
 }
 
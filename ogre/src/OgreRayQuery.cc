@@ -16,6 +16,8 @@
  */
 
 #include <typeinfo>
+#include <unordered_map>
+#include <vector>
 
 #include <ignition/common/Console.hh>
 
@@ -25,10 +27,30 @@
 #include "ignition/rendering/ogre/OgreRayQuery.hh"
 #include "ignition/rendering/ogre/OgreScene.hh"
 
+/// \brief World space triangles of an entity's mesh
+struct OgreRayQueryMeshData
+{
+  /// \brief Number of vertices
+  size_t vertexCount = 0u;
+
+  /// \brief Array of vertices in world space
+  Ogre::Vector3 *vertices = nullptr;
+
+  /// \brief Number of indices
+  size_t indexCount = 0u;
+
+  /// \brief Array of triangle indices
+  uint64_t *indices = nullptr;
+};
+
 class ignition::rendering::OgreRayQueryPrivate
 {
   /// \brief Ogre ray scene query object for computing intersection.
   public: Ogre::RaySceneQuery *rayQuery = nullptr;
+
+  /// \brief Mesh triangles retrieved for the rays being queried, indexed
+  /// by entity
+  public: std::unordered_map<Ogre::Entity *, OgreRayQueryMeshData> meshCache;
 };
 
 using namespace ignition;
@@ -61,14 +83,49 @@ void OgreRayQuery::SetFromCamera(const CameraPtr &_camera,
 
 //////////////////////////////////////////////////
 RayQueryResult OgreRayQuery::ClosestPoint()
+{
+  RayQueryResult result = this->ClosestPointImpl(this->origin,
+      this->direction);
+  this->ClearMeshCache();
+  return result;
+}
+
+//////////////////////////////////////////////////
+std::vector<RayQueryResult> OgreRayQuery::ClosestPoints(
+    const std::vector<math::Line3d> &_rays)
+{
+  // the mesh triangles of the entities hit are retrieved once and shared by
+  // all the rays in the batch
+  std::vector<RayQueryResult> results;
+  results.reserve(_rays.size());
+  for (const auto &ray : _rays)
+    results.push_back(this->ClosestPointImpl(ray[0], ray.Direction()));
+  this->ClearMeshCache();
+  return results;
+}
+
+//////////////////////////////////////////////////
+void OgreRayQuery::ClearMeshCache()
+{
+  for (auto &it : this->dataPtr->meshCache)
+  {
+    delete [] it.second.vertices;
+    delete [] it.second.indices;
+  }
+  this->dataPtr->meshCache.clear();
+}
+
+//////////////////////////////////////////////////
+RayQueryResult OgreRayQuery::ClosestPointImpl(const math::Vector3d &_origin,
+    const math::Vector3d &_direction)
 {
   RayQueryResult result;
   OgreScenePtr ogreScene = std::dynamic_pointer_cast<OgreScene>(this->Scene());
   if (!ogreScene)
     return result;
 
-  Ogre::Ray mouseRay(OgreConversions::Convert(this->origin),
-      OgreConversions::Convert(this->direction));
+  Ogre::Ray mouseRay(OgreConversions::Convert(_origin),
+      OgreConversions::Convert(_direction));
 
   if (!this->dataPtr->rayQuery)
   {
@@ -97,21 +154,25 @@ RayQueryResult OgreRayQuery::ClosestPoint()
       {
         Ogre::Entity *ogreEntity = static_cast<Ogre::Entity*>(iter->movable);
 
-        // mesh data to retrieve
-        size_t vertexCount;
-        size_t indexCount;
-        Ogre::Vector3 *vertices;
-        uint64_t *indices;
-
-       // Get the mesh information
-        this->MeshInformation(ogreEntity->getMesh().get(), vertexCount,
-            vertices, indexCount, indices,
-            OgreConversions::Convert(
-              ogreEntity->getParentNode()->_getDerivedPosition()),
-            OgreConversions::Convert(
-            ogreEntity->getParentNode()->_getDerivedOrientation()),
-            OgreConversions::Convert(
-            ogreEntity->getParentNode()->_getDerivedScale()));
+        // Get the mesh information
+        auto meshIt = this->dataPtr->meshCache.find(ogreEntity);
+        if (meshIt == this->dataPtr->meshCache.end())
+        {
+          OgreRayQueryMeshData meshData;
+          this->MeshInformation(ogreEntity->getMesh().get(),
+              meshData.vertexCount, meshData.vertices,
+              meshData.indexCount, meshData.indices,
+              OgreConversions::Convert(
+                ogreEntity->getParentNode()->_getDerivedPosition()),
+              OgreConversions::Convert(
+              ogreEntity->getParentNode()->_getDerivedOrientation()),
+              OgreConversions::Convert(
+              ogreEntity->getParentNode()->_getDerivedScale()));
+          meshIt = this->dataPtr->meshCache.emplace(ogreEntity, meshData).first;
+        }
+        size_t indexCount = meshIt->second.indexCount;
+        const Ogre::Vector3 *vertices = meshIt->second.vertices;
+        const uint64_t *indices = meshIt->second.indices;
 
         for (unsigned int i = 0; i < indexCount; i += 3)
         {
@@ -140,8 +201,6 @@ RayQueryResult OgreRayQuery::ClosestPoint()
             }
           }
         }
-        delete [] vertices;
-        delete [] indices;
       }
     }
   }
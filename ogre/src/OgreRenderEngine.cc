@@ -29,6 +29,7 @@
 #endif
 
 # include <sstream>
+# include <unordered_set>
 
 #include <ignition/plugin/Register.hh>
 
@@ -44,6 +45,8 @@
 #include "ignition/rendering/ogre/OgreScene.hh"
 #include "ignition/rendering/ogre/OgreStorage.hh"
 
+#include "OgreMemoryStats.hh"
+
 class ignition::rendering::OgreRenderEnginePrivate
 {
 #if !defined(__APPLE__) && !defined(_WIN32)
@@ -157,6 +160,36 @@ OgreRenderEngine::OgreRenderPathType
   return this->renderPathType;
 }
 
+//////////////////////////////////////////////////
+rendering::MemoryStats OgreRenderEngine::MemoryStats() const
+{
+  rendering::MemoryStats stats;
+  if (!this->ogreRoot || !Ogre::TextureManager::getSingletonPtr() ||
+      !Ogre::MeshManager::getSingletonPtr())
+  {
+    return stats;
+  }
+
+  // all textures including render targets and shadow textures. Ogre 1.x
+  // uploads directly from system memory so there are no staging buffers.
+  std::unordered_set<const void *> seen;
+  auto textures = Ogre::TextureManager::getSingleton().getResourceIterator();
+  for (auto i = textures.begin(); i != textures.end(); ++i)
+  {
+    OgreMemoryStats::AddTexture(
+        dynamic_cast<Ogre::Texture *>(i->second.get()), seen, stats);
+  }
+
+  auto meshes = Ogre::MeshManager::getSingleton().getResourceIterator();
+  for (auto i = meshes.begin(); i != meshes.end(); ++i)
+  {
+    OgreMemoryStats::AddMesh(
+        dynamic_cast<Ogre::Mesh *>(i->second.get()), seen, stats);
+  }
+
+  return stats;
+}
+
 //////////////////////////////////////////////////
 void OgreRenderEngine::AddResourcePath(const std::string &_uri)
 {
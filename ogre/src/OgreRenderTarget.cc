@@ -32,6 +32,7 @@
 
 
 #include <ignition/common/Console.hh>
+#include <ignition/common/Profiler.hh>
 
 #include "ignition/rendering/Material.hh"
 
@@ -68,6 +69,7 @@ OgreRenderTarget::~OgreRenderTarget()
 //////////////////////////////////////////////////
 void OgreRenderTarget::Copy(Image &_image) const
 {
+  IGN_PROFILE("OgreRenderTarget::Copy");
   if (nullptr == this->RenderTarget())
     return;
 
@@ -83,6 +85,16 @@ void OgreRenderTarget::Copy(Image &_image) const
   void* data = _image.Data();
   Ogre::PixelFormat imageFormat = OgreConversions::Convert(_image.Format());
   Ogre::PixelBox ogrePixelBox(this->width, this->height, 1, imageFormat, data);
+
+  // ogre counts the row pitch in pixels
+  unsigned int bpp = PixelUtil::BytesPerPixel(_image.Format());
+  if (_image.RowPitch() % bpp != 0u)
+  {
+    ignerr << "Image row pitch is not a whole number of pixels" << std::endl;
+    return;
+  }
+  ogrePixelBox.rowPitch = _image.RowPitch() / bpp;
+  ogrePixelBox.slicePitch = ogrePixelBox.rowPitch * this->height;
   this->RenderTarget()->copyContentsToMemory(ogrePixelBox);
 }
 
@@ -148,6 +160,7 @@ void OgreRenderTarget::PostRender()
 //////////////////////////////////////////////////
 void OgreRenderTarget::Render()
 {
+  IGN_PROFILE("OgreRenderTarget::Render");
   if (nullptr == this->RenderTarget())
     return;
 
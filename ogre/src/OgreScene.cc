@@ -15,7 +15,10 @@
  *
  */
 
+#include <unordered_set>
+
 #include <ignition/common/Console.hh>
+#include <ignition/common/Profiler.hh>
 
 #include "ignition/rendering/ogre/OgreArrowVisual.hh"
 #include "ignition/rendering/ogre/OgreAxisVisual.hh"
@@ -31,6 +34,7 @@
 #include "ignition/rendering/ogre/OgreHeightmap.hh"
 #include "ignition/rendering/ogre/OgreIncludes.hh"
 #include "ignition/rendering/ogre/OgreInertiaVisual.hh"
+#include "ignition/rendering/ogre/OgreInstancedVisual.hh"
 #include "ignition/rendering/ogre/OgreJointVisual.hh"
 #include "ignition/rendering/ogre/OgreLidarVisual.hh"
 #include "ignition/rendering/ogre/OgreLightVisual.hh"
@@ -49,6 +53,8 @@
 #include "ignition/rendering/ogre/OgreVisual.hh"
 #include "ignition/rendering/ogre/OgreWireBox.hh"
 
+#include "OgreMemoryStats.hh"
+
 namespace ignition
 {
   namespace rendering
@@ -283,10 +289,43 @@ void OgreScene::RemoveGradientBackgroundColor()
 //////////////////////////////////////////////////
 void OgreScene::PreRender()
 {
+  IGN_PROFILE("OgreScene::PreRender");
   BaseScene::PreRender();
   OgreRTShaderSystem::Instance()->Update();
 }
 
+//////////////////////////////////////////////////
+rendering::MemoryStats OgreScene::MemoryStats() const
+{
+  rendering::MemoryStats stats;
+  if (!this->ogreSceneManager)
+    return stats;
+
+  // meshes and material textures of the entities in this scene
+  std::unordered_set<const void *> seen;
+  auto it = this->ogreSceneManager->getMovableObjectIterator(
+      Ogre::EntityFactory::FACTORY_TYPE_NAME);
+  while (it.hasMoreElements())
+  {
+    Ogre::Entity *entity = static_cast<Ogre::Entity *>(it.getNext());
+    OgreMemoryStats::AddMesh(entity->getMesh().get(), seen, stats);
+    for (unsigned int i = 0; i < entity->getNumSubEntities(); ++i)
+    {
+      OgreMemoryStats::AddMaterial(
+          entity->getSubEntity(i)->getMaterial().get(), seen, stats);
+    }
+  }
+
+  // shadow textures are owned by the scene manager
+  for (size_t i = 0; i < this->ogreSceneManager->getShadowTextureCount(); ++i)
+  {
+    OgreMemoryStats::AddTexture(
+        this->ogreSceneManager->getShadowTexture(i).get(), seen, stats);
+  }
+
+  return stats;
+}
+
 //////////////////////////////////////////////////
 void OgreScene::Clear()
 {
@@ -310,6 +349,12 @@ Ogre::SceneManager *OgreScene::OgreSceneManager() const
   return this->ogreSceneManager;
 }
 
+//////////////////////////////////////////////////
+OgreMeshFactoryPtr OgreScene::MeshFactory() const
+{
+  return this->meshFactory;
+}
+
 //////////////////////////////////////////////////
 bool OgreScene::LoadImpl()
 {
@@ -605,6 +650,24 @@ LidarVisualPtr OgreScene::CreateLidarVisualImpl(unsigned int _id,
   return (result) ? lidar: nullptr;
 }
 
+//////////////////////////////////////////////////
+InstancedVisualPtr OgreScene::CreateInstancedVisualImpl(unsigned int _id,
+    const std::string &_name, const MeshDescriptor &_desc,
+    MaterialPtr _material, unsigned int _count)
+{
+  OgreInstancedVisualPtr visual(new OgreInstancedVisual);
+  bool result = this->InitObject(visual, _id, _name);
+  if (!result)
+    return nullptr;
+
+  if (!visual->Create(_desc, _material, _count))
+  {
+    visual->Destroy();
+    return nullptr;
+  }
+  return visual;
+}
+
 //////////////////////////////////////////////////
 TextPtr OgreScene::CreateTextImpl(unsigned int _id, const std::string &_name)
 {
@@ -19,6 +19,7 @@
 #include <ignition/math/Color.hh>
 
 #include "ignition/common/Console.hh"
+#include "ignition/common/Profiler.hh"
 #include "ignition/rendering/RenderTypes.hh"
 #include "ignition/rendering/ogre/OgreIncludes.hh"
 #include "ignition/rendering/ogre/OgreMaterialSwitcher.hh"
@@ -48,6 +49,12 @@ class ignition::rendering::OgreSelectionBufferPrivate
   /// \brief Ogre texture
   public: Ogre::TexturePtr texture;
 
+  /// \brief Width of the selection buffer texture
+  public: unsigned int width = 1u;
+
+  /// \brief Height of the selection buffer texture
+  public: unsigned int height = 1u;
+
   /// \brief Ogre render texture
   public: Ogre::RenderTexture *renderTexture  = nullptr;
 
@@ -60,6 +67,19 @@ class ignition::rendering::OgreSelectionBufferPrivate
   /// \brief A 2D overlay used for debugging the selection buffer. It
   /// is hidden by default.
   public: Ogre::Overlay *selectionDebugOverlay = nullptr;
+
+  /// \brief True if the data buffer needs to be rendered and read back
+  /// again before it can answer selection requests
+  public: bool dirty = true;
+
+  /// \brief Camera projection matrix the data buffer was rendered with
+  public: Ogre::Matrix4 cachedProjection;
+
+  /// \brief Camera position the data buffer was rendered from
+  public: Ogre::Vector3 cachedPosition;
+
+  /// \brief Camera orientation the data buffer was rendered from
+  public: Ogre::Quaternion cachedOrientation;
 };
 
 /////////////////////////////////////////////////
@@ -90,6 +110,7 @@ OgreSelectionBuffer::~OgreSelectionBuffer()
 /////////////////////////////////////////////////
 void OgreSelectionBuffer::Update()
 {
+  IGN_PROFILE("OgreSelectionBuffer::Update");
   if (!this->dataPtr->renderTexture)
     return;
 
@@ -111,12 +132,23 @@ void OgreSelectionBuffer::Update()
       Ogre::RenderTarget::FB_FRONT);
 }
 
+/////////////////////////////////////////////////
+void OgreSelectionBuffer::SetDirty()
+{
+  this->dataPtr->dirty = true;
+}
+
 /////////////////////////////////////////////////
 void OgreSelectionBuffer::DeleteRTTBuffer()
 {
-  auto &manager = Ogre::TextureManager::getSingleton();
-  manager.unload(this->dataPtr->texture->getName());
-  manager.remove(this->dataPtr->texture->getName());
+  if (!this->dataPtr->texture.isNull())
+  {
+    auto &manager = Ogre::TextureManager::getSingleton();
+    manager.unload(this->dataPtr->texture->getName());
+    manager.remove(this->dataPtr->texture->getName());
+    this->dataPtr->texture.setNull();
+  }
+  this->dataPtr->renderTexture = nullptr;
 
   if (this->dataPtr->buffer)
   {
@@ -124,7 +156,11 @@ void OgreSelectionBuffer::DeleteRTTBuffer()
     this->dataPtr->buffer = nullptr;
   }
   if (this->dataPtr->pixelBox)
+  {
     delete this->dataPtr->pixelBox;
+    this->dataPtr->pixelBox = nullptr;
+  }
+  this->dataPtr->dirty = true;
 }
 
 /////////////////////////////////////////////////
@@ -132,15 +168,11 @@ void OgreSelectionBuffer::CreateRTTBuffer()
 {
   try
   {
-    // 1x1 pixel buffer
-    unsigned int width = 1;
-    unsigned int height = 1;
-
     this->dataPtr->texture = Ogre::TextureManager::getSingleton().createManual(
         "SelectionPassTex",
         Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
-        Ogre::TEX_TYPE_2D, width, height, 0, Ogre::PF_R8G8B8,
-        Ogre::TU_RENDERTARGET);
+        Ogre::TEX_TYPE_2D, this->dataPtr->width, this->dataPtr->height, 0,
+        Ogre::PF_R8G8B8, Ogre::TU_RENDERTARGET);
   }
   catch(...)
   {
@@ -165,78 +197,87 @@ void OgreSelectionBuffer::CreateRTTBuffer()
       IGN_VISIBILITY_SELECTABLE);
   Ogre::HardwarePixelBufferSharedPtr pixelBuffer =
     this->dataPtr->texture->getBuffer();
-  size_t bufferSize = pixelBuffer->getSizeInBytes();
 
+  // read back as packed 32 bit pixels so each color can be looked up with
+  // a single aligned read
+  size_t bufferSize = Ogre::PixelUtil::getMemorySize(pixelBuffer->getWidth(),
+      pixelBuffer->getHeight(), 1u, Ogre::PF_A8R8G8B8);
   this->dataPtr->buffer = new uint8_t[bufferSize];
   this->dataPtr->pixelBox = new Ogre::PixelBox(pixelBuffer->getWidth(),
-      pixelBuffer->getHeight(), pixelBuffer->getDepth(),
-      pixelBuffer->getFormat(), this->dataPtr->buffer);
+      pixelBuffer->getHeight(), 1u, Ogre::PF_A8R8G8B8,
+      this->dataPtr->buffer);
 }
 
 /////////////////////////////////////////////////
-Ogre::Entity *OgreSelectionBuffer::OnSelectionClick(const int _x, const int _y)
+bool OgreSelectionBuffer::UpdateCache()
 {
-  if (!this->dataPtr->renderTexture)
-    return nullptr;
-
   if (!this->dataPtr->camera)
-    return nullptr;
+    return false;
 
   Ogre::Viewport *vp = this->dataPtr->camera->getViewport();
 
   if (!vp)
-    return nullptr;
+    return false;
 
   Ogre::RenderTarget *rt = vp->getTarget();
 
   if (!rt)
-    return nullptr;
+    return false;
 
-  const unsigned int targetWidth = rt->getWidth();
-  const unsigned int targetHeight = rt->getHeight();
+  // the selection buffer is rendered at the resolution of the camera
+  if (this->dataPtr->width != rt->getWidth() ||
+      this->dataPtr->height != rt->getHeight())
+  {
+    this->DeleteRTTBuffer();
+    this->dataPtr->width = rt->getWidth();
+    this->dataPtr->height = rt->getHeight();
+    this->CreateRTTBuffer();
+  }
 
-  if (_x < 0 || _y < 0 || _x >= static_cast<int>(targetWidth)
-      || _y >= static_cast<int>(targetHeight))
-    return nullptr;
+  if (!this->dataPtr->renderTexture || !this->dataPtr->buffer)
+    return false;
+
+  const Ogre::Matrix4 &projection =
+      this->dataPtr->camera->getProjectionMatrix();
+  const Ogre::Vector3 &position = this->dataPtr->camera->getDerivedPosition();
+  const Ogre::Quaternion &orientation =
+      this->dataPtr->camera->getDerivedOrientation();
+
+  // reuse the last readback until the camera moves or renders a new frame
+  if (!this->dataPtr->dirty && projection == this->dataPtr->cachedProjection &&
+      position == this->dataPtr->cachedPosition &&
+      orientation == this->dataPtr->cachedOrientation)
+  {
+    return true;
+  }
+
+  this->dataPtr->selectionCamera->setCustomProjectionMatrix(true, projection);
+  this->dataPtr->selectionCamera->setPosition(position);
+  this->dataPtr->selectionCamera->setOrientation(orientation);
 
-  // 1x1 selection buffer, adapted from rviz
-  // http://docs.ros.org/indigo/api/rviz/html/c++/selection__manager_8cpp.html
-  float width = 1.0f;
-  float height = 1.0f;
-  float x1 = static_cast<float>(_x) /
-      static_cast<float>(targetWidth - 1) - 0.5f;
-  float y1 = static_cast<float>(_y) /
-      static_cast<float>(targetHeight - 1) - 0.5f;
-  float x2 = static_cast<float>(_x+width) /
-      static_cast<float>(targetWidth - 1) - 0.5f;
-  float y2 = static_cast<float>(_y+height) /
-      static_cast<float>(targetHeight - 1) - 0.5f;
-  Ogre::Matrix4 scaleMatrix = Ogre::Matrix4::IDENTITY;
-  Ogre::Matrix4 transMatrix = Ogre::Matrix4::IDENTITY;
-  scaleMatrix[0][0] = 1.0 / (x2-x1);
-  scaleMatrix[1][1] = 1.0 / (y2-y1);
-  transMatrix[0][3] -= x1+x2;
-  transMatrix[1][3] += y1+y2;
-  this->dataPtr->selectionCamera->setCustomProjectionMatrix(true,
-      scaleMatrix * transMatrix * this->dataPtr->camera->getProjectionMatrix());
-  this->dataPtr->selectionCamera->setPosition(
-      this->dataPtr->camera->getDerivedPosition());
-  this->dataPtr->selectionCamera->setOrientation(
-      this->dataPtr->camera->getDerivedOrientation());
-  Ogre::Viewport* renderViewport = this->dataPtr->renderTexture->getViewport(0);
-  renderViewport->setDimensions(0, 0, width, height);
-
-  // update render texture
   this->Update();
 
-  size_t posInStream = 0;
+  this->dataPtr->cachedProjection = projection;
+  this->dataPtr->cachedPosition = position;
+  this->dataPtr->cachedOrientation = orientation;
+  this->dataPtr->dirty = false;
+  return true;
+}
 
-  ignition::math::Color::BGRA color(0);
-  if (!this->dataPtr->buffer)
-  {
-    ignerr << "Selection buffer is null.\n";
+/////////////////////////////////////////////////
+Ogre::Entity *OgreSelectionBuffer::OnSelectionClick(const int _x, const int _y)
+{
+  if (!this->UpdateCache())
     return nullptr;
-  }
+
+  if (_x < 0 || _y < 0 || _x >= static_cast<int>(this->dataPtr->width)
+      || _y >= static_cast<int>(this->dataPtr->height))
+    return nullptr;
+
+  size_t posInStream = (static_cast<size_t>(_y) * this->dataPtr->width +
+      static_cast<size_t>(_x)) * 4u;
+
+  ignition::math::Color::ARGB color(0);
   memcpy(static_cast<void *>(&color), this->dataPtr->buffer + posInStream, 4);
   ignition::math::Color cv;
   cv.SetFromARGB(color);
@@ -244,7 +285,8 @@ Ogre::Entity *OgreSelectionBuffer::OnSelectionClick(const int _x, const int _y)
   const std::string &entName =
     this->dataPtr->materialSwitcher->EntityName(cv);
 
-  if (entName.empty())
+  // the entity may have been destroyed since the readback was cached
+  if (entName.empty() || !this->dataPtr->sceneMgr->hasEntity(entName))
   {
     return 0;
   }
@@ -14,6 +14,7 @@
  * limitations under the License.
  *
  */
+#include "ignition/rendering/ogre/OgreIncludes.hh"
 #include "ignition/rendering/ogre/OgreSensor.hh"
 
 using namespace ignition;
@@ -28,3 +29,26 @@ OgreSensor::OgreSensor()
 OgreSensor::~OgreSensor()
 {
 }
+
+//////////////////////////////////////////////////
+void OgreSensor::ResetDrawStats()
+{
+  unsigned int frameCount = this->drawStats.frameCount + 1u;
+  this->drawStats = rendering::DrawStats();
+  this->drawStats.frameCount = frameCount;
+}
+
+//////////////////////////////////////////////////
+void OgreSensor::AddDrawStats(Ogre::RenderTarget *_target)
+{
+  if (!_target)
+    return;
+
+  // ogre counts the batches of each render target update, one per draw
+  // call
+  const Ogre::RenderTarget::FrameStats &stats = _target->getStatistics();
+  this->drawStats.drawCallCount += stats.batchCount;
+  this->drawStats.batchCount += stats.batchCount;
+  this->drawStats.triangleCount += stats.triangleCount;
+  this->drawStats.passCount++;
+}
@@ -25,6 +25,7 @@
 
 #include <limits>
 
+#include <ignition/common/Profiler.hh>
 #include <ignition/math/Helpers.hh>
 #include "ignition/rendering/ShaderParams.hh"
 #include "ignition/rendering/ogre/OgreThermalCamera.hh"
@@ -170,6 +171,7 @@ OgreThermalCameraMaterialSwitcher::OgreThermalCameraMaterialSwitcher(
 void OgreThermalCameraMaterialSwitcher::preRenderTargetUpdate(
     const Ogre::RenderTargetEvent & /*_evt*/)
 {
+  IGN_PROFILE("OgreThermalCameraMaterialSwitcher::preRenderTargetUpdate");
   Ogre::MaterialManager::getSingleton().addListener(this);
 }
 
@@ -177,6 +179,7 @@ void OgreThermalCameraMaterialSwitcher::preRenderTargetUpdate(
 void OgreThermalCameraMaterialSwitcher::postRenderTargetUpdate(
     const Ogre::RenderTargetEvent & /*_evt*/)
 {
+  IGN_PROFILE("OgreThermalCameraMaterialSwitcher::postRenderTargetUpdate");
   Ogre::MaterialManager::getSingleton().removeListener(this);
 }
 
@@ -492,30 +495,42 @@ void OgreThermalCamera::CreateRenderTexture()
 //////////////////////////////////////////////////
 void OgreThermalCamera::PreRender()
 {
+  IGN_PROFILE("OgreThermalCamera::PreRender");
   BaseCamera::PreRender();
   if (!this->dataPtr->ogreThermalTexture)
     this->CreateThermalTexture();
+
+  this->ogreCamera->setLodBias(this->LodBias());
 }
 
 //////////////////////////////////////////////////
 void OgreThermalCamera::Render()
 {
+  IGN_PROFILE("OgreThermalCamera::Render");
+  this->RecordFrameSubmit();
+  this->ResetDrawStats();
   // render heat source
   Ogre::RenderTarget *heatRt =
       this->dataPtr->ogreHeatSourceTexture->getBuffer()->getRenderTarget();
   heatRt->update();
+  this->AddDrawStats(heatRt);
 
   Ogre::RenderTarget *rt =
       this->dataPtr->ogreThermalTexture->getBuffer()->getRenderTarget();
   rt->setAutoUpdated(false);
   rt->update(false);
+  this->AddDrawStats(rt);
 }
 
 //////////////////////////////////////////////////
 void OgreThermalCamera::PostRender()
 {
+  IGN_PROFILE("OgreThermalCamera::PostRender");
   if (this->dataPtr->newThermalFrame.ConnectionCount() <= 0u)
+  {
+    this->RecordFrameDropped();
     return;
+  }
 
   unsigned int width = this->ImageWidth();
   unsigned int height = this->ImageHeight();
@@ -536,13 +551,18 @@ void OgreThermalCamera::PostRender()
   Ogre::PixelBox ogrePixelBox(width, height, 1,
       OgreConversions::Convert(format), this->dataPtr->thermalBuffer);
   rt->copyContentsToMemory(ogrePixelBox);
+  this->RecordFrameGpuComplete();
 
   // fill thermal data
   memcpy(this->dataPtr->thermalImage, this->dataPtr->thermalBuffer,
       height*width*channelCount*bytesPerChannel);
 
+  this->RecordFrameReadback();
+  IGN_PROFILE_BEGIN("Dispatch newThermalFrame");
   this->dataPtr->newThermalFrame(
       this->dataPtr->thermalBuffer, width, height, 1, "L16");
+  IGN_PROFILE_END();
+  this->RecordFrameDelivered();
 
   // Uncomment to debug thermal output
   // igndbg << "wxh: " << width << " x " << height << std::endl;
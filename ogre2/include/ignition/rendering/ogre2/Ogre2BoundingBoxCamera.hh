@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2BOUNDINGBOXCAMERA_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2BOUNDINGBOXCAMERA_HH_
+
+#ifdef _WIN32
+  // Ensure that Winsock2.h is included before Windows.h, which can get
+  // pulled in by anybody (e.g., Boost).
+  #include <Winsock2.h>
+#endif
+
+#include <memory>
+#include <vector>
+
+#include <ignition/common/Event.hh>
+
+#include "ignition/rendering/base/BaseBoundingBoxCamera.hh"
+#include "ignition/rendering/ogre2/Ogre2Includes.hh"
+#include "ignition/rendering/ogre2/Ogre2Sensor.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // Forward declaration
+    class Ogre2BoundingBoxCameraPrivate;
+
+    /// \brief Bounding box camera that produces the 2D or 3D boxes of the
+    /// labeled visuals in view. Visuals are labeled with an int "label" user
+    /// data. All items below a labeled visual belong to the same object.
+    ///
+    /// Every object is rendered with a unique id color in a single scene pass.
+    /// The visible 2D boxes and visible pixel counts of all objects are then
+    /// found in one pass over the id buffer. Full 2D boxes and 3D boxes are
+    /// computed from the local bounding box of the visible objects.
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2BoundingBoxCamera :
+      public BaseBoundingBoxCamera<Ogre2Sensor>
+    {
+      /// \brief Constructor
+      protected: Ogre2BoundingBoxCamera();
+
+      /// \brief Destructor
+      public: virtual ~Ogre2BoundingBoxCamera();
+
+      // Documentation inherited
+      public: virtual void Init() override;
+
+      // Documentation inherited
+      public: virtual void Destroy() override;
+
+      // Documentation inherited
+      public: virtual void PreRender() override;
+
+      // Documentation inherited
+      public: virtual void PostRender() override;
+
+      // Documentation inherited
+      public: virtual void Render() override;
+
+      // Documentation inherited
+      public: virtual ignition::common::ConnectionPtr ConnectNewBoundingBoxes(
+        std::function<void(const std::vector<BoundingBox> &)> _subscriber)
+        override;
+
+      // Documentation inherited
+      public: virtual void DrawBoundingBox(unsigned char *_data,
+        const math::Color &_color, const BoundingBox &_box) const override;
+
+      /// \brief Get a pointer to the render target.
+      /// \return Pointer to the render target
+      protected: virtual RenderTargetPtr RenderTarget() const override;
+
+      /// \brief Create the camera.
+      protected: void CreateCamera();
+
+      /// \brief Create dummy render texture
+      protected: virtual void CreateRenderTexture();
+
+      /// \brief Create the id texture and compositor workspace
+      protected: virtual void CreateBoundingBoxTexture();
+
+      /// \brief Compute the bounding boxes from the id buffer
+      /// \param[in] _box Id buffer read back from the GPU
+      private: void ComputeBoundingBoxes(const Ogre::TextureBox &_box);
+
+      /// \brief Update the compositor workspace rendering the id buffer
+      private: void UpdateWorkspace();
+
+      /// \brief Render one object alone, without depth testing, and count
+      /// its pixels, i.e. the pixels it would cover if nothing occluded it
+      /// \param[in] _id Id of the object in the id buffer
+      /// \return Number of pixels of the object in the image
+      private: unsigned int UnoccludedPixelCount(uint32_t _id);
+
+      /// \brief Pointer to the ogre camera
+      protected: Ogre::Camera *ogreCamera = nullptr;
+
+      /// \internal
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<Ogre2BoundingBoxCameraPrivate> dataPtr;
+
+      /// \brief Make scene our friend so it can create a camera
+      private: friend class Ogre2Scene;
+    };
+    }
+  }
+}
+#endif
@@ -18,6 +18,7 @@
 #define IGNITION_RENDERING_OGRE2_OGRE2CAMERA_HH_
 
 #include <memory>
+#include <vector>
 
 #include "ignition/rendering/base/BaseCamera.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
@@ -27,6 +28,7 @@
 namespace Ogre
 {
   class Camera;
+  class TextureGpu;
 }
 
 namespace ignition
@@ -70,6 +72,9 @@ namespace ignition
       // Documentation inherited.
       public: virtual void SetNearClipPlane(const double _near) override;
 
+      // Documentation inherited.
+      public: virtual void SetLodBias(double _bias) override;
+
       public: virtual math::Color BackgroundColor() const;
 
       public: virtual void SetBackgroundColor(const math::Color &_color);
@@ -85,6 +90,10 @@ namespace ignition
       // Documentation inherited.
       public: virtual void Render() override;
 
+      // Documentation inherited.
+      public: virtual bool CaptureRegion(unsigned int _x, unsigned int _y,
+                  Image &_image) override;
+
       // Documentation inherited.
       public: virtual RenderWindowPtr CreateRenderWindow() override;
 
@@ -106,6 +115,11 @@ namespace ignition
       public: virtual VisualPtr VisualAt(const ignition::math::Vector2i
                   &_mousePos) override;
 
+      // Documentation inherited
+      public: virtual std::vector<VisualPtr> VisualsAt(
+                  const std::vector<ignition::math::Vector2i> &_mousePos)
+                  override;
+
       // Documentation Inherited.
       // \sa Camera::SetMaterial(const MaterialPtr &)
       public: virtual void SetMaterial(
@@ -114,14 +128,69 @@ namespace ignition
       // Documentation inherited.
       public: virtual unsigned int RenderTextureGLId() const override;
 
+      // Documentation inherited.
+      public: virtual void RenderTextureMetalId(void *_textureIdPtr) const
+                  override;
+
       // Documentation inherited.
       public: void SetShadowsDirty() override;
 
+      // Documentation inherited.
+      public: virtual void SetShadowsEnabled(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual void SetResolutionScale(double _scale) override;
+
+      // Documentation inherited.
+      public: virtual void SetReprojectionInterval(unsigned int _interval)
+                  override;
+
+      // Documentation inherited.
+      public: virtual void SetObjectIdPickingEnabled(bool _enabled)
+                  override;
+
+      // Documentation inherited.
+      public: virtual void SetDepthPickingEnabled(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual bool DepthAt(const math::Vector2i &_pos,
+                  double &_depth) override;
+
+      // Documentation inherited.
+      public: virtual bool CopyDepth(float *_depth) override;
+
+      // Documentation inherited.
+      public: virtual bool CopyLabels(int *_labels, int _backgroundLabel)
+                  override;
+
+      // Documentation inherited.
+      public: virtual void SetViewPoses(
+                  const std::vector<math::Pose3d> &_poses) override;
+
+      // Documentation inherited.
+      public: virtual std::vector<math::Pose3d> ViewPoses() const override;
+
+      // Documentation inherited.
+      public: virtual void SetViewColumns(unsigned int _columns) override;
+
+      // Documentation inherited.
+      public: virtual unsigned int ViewColumns() const override;
+
       // Documentation inherited.
       public: virtual void Destroy() override;
 
       public: Ogre::Camera *OgreCamera() const;
 
+      /// \brief Get the depth texture of the last frame of this camera if
+      /// another camera is about to render the same view, so that it can
+      /// start from this depth instead of rendering it again
+      /// \param[in] _camera Ogre camera about to render
+      /// \return The depth texture, null if depth picking is not enabled
+      /// or the last frame doesn't match the view of the camera
+      /// \sa Ogre2RenderTarget::DepthTextureFor
+      public: Ogre::TextureGpu *DepthTextureFor(
+                  const Ogre::Camera *_camera) const;
+
       // Documentation inherited.
       public: virtual void SetVisibilityMask(uint32_t _mask) override;
 
@@ -145,6 +214,14 @@ namespace ignition
       /// \brief Create internal camera object
       private: void CreateCamera();
 
+      /// \brief Get a render texture for rendering regions of the given
+      /// size, set up like the render texture of the camera
+      /// \param[in] _width Width of the region in pixels
+      /// \param[in] _height Height of the region in pixels
+      /// \return Render texture of the region size
+      private: Ogre2RenderTexturePtr RegionTexture(unsigned int _width,
+                   unsigned int _height);
+
       /// \brief Notifies us that the shadow node definition is about to be
       /// updated. This means our compositor workspace must be destroyed
       /// because the shadow node definition it's using will become a
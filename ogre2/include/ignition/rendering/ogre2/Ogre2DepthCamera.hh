@@ -38,6 +38,7 @@ namespace Ogre
   class Material;
   class RenderTarget;
   class Texture;
+  class TextureGpu;
   class Viewport;
 }
 
@@ -80,6 +81,23 @@ namespace ignition
       // Documentation inherited
       public: virtual void PreRender() override;
 
+      /// \brief Allocate the GPU resources if needed and update the render
+      /// passes. Called by PreRender once the camera has rendered, and by
+      /// Render the first time it renders.
+      private: void PrepareRender();
+
+      /// \brief Create the textures the depth data is rendered to
+      private: void CreateDepthTargets();
+
+      /// \brief Add the final pass back to a single pass workspace, once
+      /// render passes are added
+      private: void DisableSinglePass();
+
+      /// \brief Release the textures, workspaces and readback tickets of an
+      /// idle camera. They are created again when the camera next renders.
+      /// \sa Sensor::SetIdleTimeout
+      private: void ReleaseResources();
+
       /// \brief Render the camera
       public: virtual void PostRender() override;
 
@@ -87,6 +105,16 @@ namespace ignition
       /// \return The z-buffer as a float array
       public: virtual const float *DepthData() const override;
 
+      /// \brief Write the depth image of the last frame delivered to the
+      /// float depth frame subscribers to a file, as one float per pixel in
+      /// meters. The image is written by the frame recorder on a background
+      /// thread.
+      /// \param[in] _name Name of the output file, e.g. with a ".exr" or
+      /// ".npy" extension
+      /// \return False if no depth frame was delivered yet or the frame
+      /// could not be queued
+      public: virtual bool SaveFrame(const std::string &_name) override;
+
       /// \brief Connect a to the new depth image signal
       /// \param[in] _subscriber Subscriber callback function
       /// \return Pointer to the new Connection. This must be kept in scope
@@ -101,6 +129,19 @@ namespace ignition
           std::function<void(const float *, unsigned int, unsigned int,
           unsigned int, const std::string &)>  _subscriber) override;
 
+      // Documentation inherited.
+      public: virtual ignition::common::ConnectionPtr ConnectNewDepthFrameView(
+          std::function<void(const float *, unsigned int, unsigned int,
+          unsigned int, unsigned int, const std::string &)> _subscriber)
+          override;
+
+      // Documentation inherited.
+      public: virtual ignition::common::ConnectionPtr
+          ConnectNewRgbPointCloudView(
+          std::function<void(const float *, unsigned int, unsigned int,
+          unsigned int, unsigned int, const std::string &)> _subscriber)
+          override;
+
       /// \brief Implementation of the render call
       public: virtual void Render() override;
 
@@ -125,9 +166,64 @@ namespace ignition
       // Documentation inherited.
       public: void SetShadowsDirty() override;
 
+      /// \brief Set the scale of the resolution the scene passes render at.
+      /// The depth is upscaled without filtering, so it is not interpolated
+      /// across edges.
+      /// \param[in] _scale Scale of the image width and height
+      /// \remarks Depth only readback, see SetDepthOnlyReadback, always
+      /// renders at full resolution.
+      public: void SetResolutionScale(double _scale) override;
+
+      /// \brief Set how often the camera renders the scene, see
+      /// Camera::SetReprojectionInterval. The points of the last rendered
+      /// frame are transformed to the current camera pose on the CPU.
+      /// \param[in] _interval Number of frames per rendered frame
+      public: void SetReprojectionInterval(unsigned int _interval) override;
+
+      // Documentation inherited.
+      public: void SetDepthOnlyReadback(bool _enabled) override;
+
+      // Documentation inherited.
+      public: bool DepthOnlyReadback() const override;
+
+      // Documentation inherited.
+      public: void SetAsyncReadback(bool _enabled) override;
+
+      // Documentation inherited.
+      public: bool AsyncReadback() const override;
+
+      // Documentation inherited.
+      public: bool SetDepthOutputFormat(PixelFormat _format) override;
+
+      // Documentation inherited.
+      public: PixelFormat DepthOutputFormat() const override;
+
+      // Documentation inherited.
+      public: ignition::common::ConnectionPtr ConnectNewEncodedDepthFrame(
+          std::function<void(const void *, unsigned int, unsigned int,
+          unsigned int, const std::string &)> _subscriber) override;
+
+      // Documentation inherited.
+      public: ignition::common::ConnectionPtr ConnectNewCompressedDepthFrame(
+          std::function<void(const uint8_t *, size_t)> _subscriber)
+          override;
+
       // Documentation inherited.
       public: void AddRenderPass(const RenderPassPtr &_pass) override;
 
+      /// \brief Get the OpenGL id of the texture the depth data is read
+      /// back from: a single channel texture of the depth output format if
+      /// only depth is read back, otherwise a 4 channel float texture with
+      /// the xyz point and the packed rgba color
+      /// \return Texture Id of type GLuint, 0 before the first render
+      /// \sa Camera::RenderTextureGLId
+      public: unsigned int RenderTextureGLId() const override;
+
+      /// \brief Get the Metal id of the texture the depth data is read back
+      /// from, see RenderTextureGLId
+      /// \param[out] _textureIdPtr Pointer to an id<MTLTexture>
+      public: void RenderTextureMetalId(void *_textureIdPtr) const override;
+
       /// \brief Get a pointer to the render target.
       /// \return Pointer to the render target
       protected: virtual RenderTargetPtr RenderTarget() const override;
@@ -148,6 +244,55 @@ namespace ignition
       /// \sa SetShadowsDirty
       private: void SetShadowsNodeDefDirty();
 
+      /// \brief Copy depth data read back from the gpu into the output
+      /// buffers and emit the new depth frame and rgb point cloud events
+      /// \param[in] _data Pointer to the first row of pixel data
+      /// \param[in] _bytesPerRow Number of bytes between consecutive rows
+      /// \param[in] _channelCount Number of channels per pixel, 1 if only
+      /// depth was read back, encoded to the depth output format, 4 floats
+      /// otherwise
+      /// \param[in] _reprojected True if the data was reprojected from the
+      /// last rendered frame instead of being read back
+      private: void ProcessDepthData(const void *_data, size_t _bytesPerRow,
+          unsigned int _channelCount, bool _reprojected);
+
+      /// \brief Warp the points of the last rendered frame to the current
+      /// camera pose and emit them as a new frame. Each pixel is searched
+      /// in the last rendered frame by moving the sampled point until it
+      /// lands on the pixel, so the output has no holes: surfaces that
+      /// were hidden in the last rendered frame get the points of the
+      /// surfaces next to them.
+      private: void ReprojectKeyFrame();
+
+      /// \brief Whether only the depth channel is read back this frame
+      /// \return True if depth only readback is enabled, or depth is
+      /// encoded to a format other than PF_FLOAT32_R, and no one is
+      /// subscribed to the rgb point cloud signals. False while frames are
+      /// reprojected, which needs the points.
+      private: bool ReadDepthOnly() const;
+
+      /// \brief Get the texture the depth data is read back from this frame
+      /// \return The texture, null before the first render
+      private: Ogre::TextureGpu *ReadbackTexture() const;
+
+      /// \brief Create the texture and workspace that extract the depth
+      /// channel from the final depth camera output
+      private: void CreateDepthOnlyWorkspace();
+
+      /// \brief Destroy the texture and workspace created by
+      /// CreateDepthOnlyWorkspace
+      private: void DestroyDepthOnlyWorkspace();
+
+      /// \brief Create the instance of the depth camera workspace that
+      /// skips the color passes, used while only depth is read back
+      private: void CreateNoColorWorkspace();
+
+      /// \brief Destroy the workspace created by CreateNoColorWorkspace
+      private: void DestroyNoColorWorkspace();
+
+      /// \brief Destroy the async readback tickets, if any
+      private: void DestroyReadbackTickets();
+
       /// \brief Pointer to the ogre camera
       protected: Ogre::Camera *ogreCamera;
 
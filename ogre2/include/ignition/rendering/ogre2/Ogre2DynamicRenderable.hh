@@ -89,6 +89,14 @@ namespace ignition
       public: void AddPoint(const double _x, const double _y, const double _z,
             const ignition::math::Color &_color = ignition::math::Color::White);
 
+      /// \brief Replace the point list
+      /// \param[in] _xyz Positions of the points, three floats per point
+      /// \param[in] _rgba Colors of the points, four bytes per point, may be
+      /// null to make all points white
+      /// \param[in] _count Number of points
+      public: void SetPoints(const float *_xyz, const uint8_t *_rgba,
+                             std::size_t _count);
+
       /// \brief Change the location of an existing point in the point list
       /// \param[in] _index Index of the point to set
       /// \param[in] _value Position of the point
@@ -132,10 +140,11 @@ namespace ignition
 
       /// \brief Helper function to generate normals
       /// \param[in] _opType Ogre render operation type
-      /// \param[in] _vertices a list of vertices
-      /// \param[in,out] _vbuffer vertex buffer to be filled
+      /// \param[in] _vertexCount Number of vertices in the vertex buffer
+      /// \param[in,out] _vbuffer vertex buffer with the positions filled in,
+      /// the normals are written to it
       private: void GenerateNormals(Ogre::OperationType _opType,
-          const std::vector<math::Vector3d> &_vertices, float *_vbuffer);
+          unsigned int _vertexCount, float *_vbuffer);
 
       /// \brief Destroy the vertex buffer
       private: void DestroyBuffer();
@@ -51,6 +51,13 @@ namespace ignition
       // Documentation inherited
       public: void CreateRenderPass() override;
 
+      /// \brief Consecutive Gaussian noise passes of the same type are
+      /// fused, up to 3 into one pass. The noise of each one is still
+      /// sampled and clamped separately.
+      /// \param[in] _pass Render pass that follows this one
+      /// \return True if _pass can be applied by this pass
+      public: bool CanFuse(const Ogre2RenderPass &_pass) const override;
+
       /// \brief Pointer to private data class
       private: std::unique_ptr<Ogre2GaussianNoisePassPrivate> dataPtr;
     };
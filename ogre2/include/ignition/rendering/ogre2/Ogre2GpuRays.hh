@@ -18,7 +18,9 @@
 #ifndef IGNITION_RENDERING_OGRE2_OGRE2GPURAYS_HH_
 #define IGNITION_RENDERING_OGRE2_OGRE2GPURAYS_HH_
 
+#include <set>
 #include <string>
+#include <vector>
 #include <memory>
 
 #include "ignition/rendering/RenderTypes.hh"
@@ -83,6 +85,11 @@ namespace ignition
       // Documentation inherited
       public: virtual void PreRender() override;
 
+      /// \brief Allocate the GPU resources if needed and update the shader
+      /// parameters. Called by PreRender once the sensor has rendered, and
+      /// by Render the first time it renders.
+      private: void PrepareRender();
+
       // Documentation inherited
       public: virtual void PostRender() override;
 
@@ -101,8 +108,91 @@ namespace ignition
       // Documentation inherited.
       public: virtual RenderTargetPtr RenderTarget() const override;
 
+      /// \brief Get the OpenGL id of the texture the ray data is read back
+      /// from: a 4 channel float texture with range, retro and a third
+      /// channel, or a single channel texture of the output format with the
+      /// three values of a ray in consecutive texels if the output is packed
+      /// \return Texture Id of type GLuint, 0 before the render texture is
+      /// created
+      /// \sa Camera::RenderTextureGLId
+      public: virtual unsigned int RenderTextureGLId() const override;
+
+      /// \brief Get the Metal id of the texture the ray data is read back
+      /// from, see RenderTextureGLId
+      /// \param[out] _textureIdPtr Pointer to an id<MTLTexture>
+      public: virtual void RenderTextureMetalId(void *_textureIdPtr) const
+                  override;
+
+      // Documentation inherited.
+      public: virtual void SetRayGroup(const std::string &_group) override;
+
+      // Documentation inherited.
+      public: virtual std::string RayGroup() const override;
+
+      /// \brief Set the vertical beam table. Unlike the other ray settings,
+      /// it can be changed after the sensor is first rendered, in which case
+      /// the textures of the sensor are created again.
+      /// \param[in] _elevations Elevation angle of each beam in radians
+      /// \param[in] _azimuthOffsets Horizontal offset of each beam in
+      /// radians, may be empty
+      /// \return True if the table was set
+      /// \sa GpuRays::SetVerticalBeams
+      public: virtual bool SetVerticalBeams(
+                  const std::vector<double> &_elevations,
+                  const std::vector<double> &_azimuthOffsets) override;
+
+      /// \brief Set the pattern of rays. Unlike the other ray settings, it
+      /// can be changed after the sensor is first rendered, in which case the
+      /// textures of the sensor are created again.
+      /// \param[in] _rays Azimuth and elevation of each ray in radians
+      /// \param[in] _width Number of rays in each row of the output
+      /// \return True if the pattern was set
+      /// \sa GpuRays::SetRayPattern
+      public: virtual bool SetRayPattern(
+                  const std::vector<math::Vector2d> &_rays,
+                  unsigned int _width = 0u) override;
+
+      /// \brief Set the number of time segments a scan is rendered in. It
+      /// can be changed after the sensor is first rendered, in which case the
+      /// textures of the sensor are created again.
+      /// \param[in] _count Number of segments
+      /// \sa GpuRays::SetScanSegmentCount
+      public: virtual void SetScanSegmentCount(unsigned int _count) override;
+
+      /// \brief Set the output format. Data is only encoded on the GPU if
+      /// the 2nd pass can write it tightly packed, i.e. if 3 times the
+      /// number of horizontal readings fits in a texture. Otherwise data is
+      /// handed to encoded gpu rays frame subscribers as PF_FLOAT32_RGB.
+      /// \param[in] _format Output format
+      /// \return True if the format is supported
+      /// \sa GpuRays::SetOutputFormat
+      public: virtual bool SetOutputFormat(PixelFormat _format) override;
+
+      // Documentation inherited.
+      public: virtual PixelFormat OutputFormat() const override;
+
+      // Documentation inherited.
+      public: virtual common::ConnectionPtr ConnectNewEncodedGpuRaysFrame(
+                  std::function<void(const void *, unsigned int,
+                  unsigned int, unsigned int, const std::string &)>
+                  _subscriber) override;
+
+      /// \brief Subscribe to point clouds. The point cloud pass and its
+      /// ray direction texture are only created once there is a
+      /// subscriber, so the textures of the sensor are created again on
+      /// the first subscription.
+      /// \param[in] _subscriber Callback that is called when a new point
+      /// cloud is available
+      /// \return A pointer to the connection
+      /// \sa GpuRays::ConnectNewGpuRaysPointCloud
+      public: virtual common::ConnectionPtr ConnectNewGpuRaysPointCloud(
+                  std::function<void(const float *, unsigned int,
+                  unsigned int, unsigned int, const std::string &)>
+                  _subscriber) override;
+
       /// \brief Set the number of samples in the width and height for the
-      /// first pass texture.
+      /// first pass texture. This is the size of the most densely sampled
+      /// cubemap face, see ComputeFaceTextureSizes.
       /// \param[in] _w Number of samples in the horizontal sweep
       /// \param[in] _h Number of samples in the vertical sweep
       private: virtual void Set1stTextureSize(const unsigned int _w,
@@ -137,12 +227,46 @@ namespace ignition
       /// cubemap face index data
       private: void CreateSampleTexture();
 
+      /// \brief Compute the size of the 1st pass texture of each cubemap
+      /// face from the distance between the neighbouring rays sampling it,
+      /// so that faces are not rendered at a higher resolution than their
+      /// rays need in either direction
+      /// \param[in] _samples Data of the sampling texture, see
+      /// CreateSampleTexture
+      private: void ComputeFaceTextureSizes(const float *_samples);
+
       /// \brief Set up 1st pass material, texture, and compositor
       private: void Setup1stPass();
 
       /// \brief Set up 2nd pass material, texture, and compositor
       private: void Setup2ndPass();
 
+      /// \brief Set up the point cloud pass material, texture, and
+      /// compositor. The pass samples the cubemap like the 2nd pass and
+      /// writes the hit point of each ray in the sensor frame
+      private: void SetupPointCloudPass();
+
+      /// \brief Join the ray group set in SetRayGroup, becoming its leader
+      /// if the group does not have one yet
+      private: void JoinRayGroup();
+
+      /// \brief Leave the ray group this sensor is in, if any. If this
+      /// sensor is the group leader, all other members are reset so that
+      /// they elect a new leader the next time they are rendered
+      private: void LeaveRayGroup();
+
+      /// \brief Get the leader of the ray group this sensor is in
+      /// \return Group leader, or nullptr if this sensor is not in a group
+      /// or is the group leader itself, in which case it renders its own
+      /// cubemap
+      private: Ogre2GpuRays *RayGroupLeader() const;
+
+      /// \brief Get the cubemap faces rendered in the 1st pass. These are
+      /// the faces touched by the rays of this sensor, or of all sensors in
+      /// the ray group if this sensor is the group leader
+      /// \return Indices of the cubemap faces to render
+      private: const std::set<unsigned int> &RenderedCubeFaces() const;
+
       /// \brief Helper function to convert a direction vector to the
       /// index number of a cubemap face and texture uv coordinates on that face
       /// \param[in] _v Direction vector
@@ -49,6 +49,9 @@ namespace ignition
       // Documentation inherited.
       public: virtual void Init();
 
+      // Documentation inherited.
+      public: virtual void Destroy();
+
       // Documentation inherited.
       public: virtual Ogre::MovableObject *OgreObject() const;
 
@@ -68,6 +71,13 @@ namespace ignition
       /// \brief Create the grid geometry in ogre
       private: void Create();
 
+      /// \brief Create the quad of a procedural grid
+      private: void CreateProcedural();
+
+      /// \brief Pass the extent and color of the grid to the shader of a
+      /// procedural grid
+      private: void UpdateProceduralMaterial();
+
       /// \brief Grid should only be created by scene.
       private: friend class Ogre2Scene;
 
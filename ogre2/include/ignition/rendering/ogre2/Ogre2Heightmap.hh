@@ -20,6 +20,8 @@
 
 #include <memory>
 
+#include <ignition/math/Angle.hh>
+
 #include "ignition/rendering/base/BaseHeightmap.hh"
 #include "ignition/rendering/ogre2/Ogre2Geometry.hh"
 
@@ -82,8 +84,60 @@ namespace ignition
       public: virtual void SetMaterial(MaterialPtr _material, bool _unique)
           override;
 
+      /// \brief Set how much the direction of the first directional light
+      /// must change before the terrain shadows are recomputed. Useful when
+      /// the sun moves a tiny amount every frame. Defaults to 0, which
+      /// recomputes the shadows on any change.
+      /// \param[in] _angle Angle threshold
+      public: void SetShadowUpdateAngleThreshold(const math::Angle &_angle);
+
+      /// \brief Get the light direction change that triggers a terrain
+      /// shadow update
+      /// \return Angle threshold
+      /// \sa SetShadowUpdateAngleThreshold
+      public: math::Angle ShadowUpdateAngleThreshold() const;
+
+      /// \brief Set the number of renders a terrain shadow update is spread
+      /// across. Each render recomputes the shadows of one band of the
+      /// heightmap, so the cost doesn't spike in a single frame. Defaults
+      /// to 1, which recomputes all shadows at once.
+      /// \param[in] _slices Number of renders per shadow update
+      public: void SetShadowUpdateSlices(unsigned int _slices);
+
+      /// \brief Get the number of renders a terrain shadow update is spread
+      /// across
+      /// \return Number of renders per shadow update
+      /// \sa SetShadowUpdateSlices
+      public: unsigned int ShadowUpdateSlices() const;
+
+      /// \brief Set how much a camera must move or turn before the terrain
+      /// levels of detail and visible cells are rebuilt for it. They are
+      /// kept for each camera, so sensors rendering the terrain in turns
+      /// don't rebuild each other's. Both default to 0, which only reuses
+      /// them for cameras that did not move. Cells are culled against the
+      /// view of the camera, so with larger thresholds cells entering the
+      /// view may appear late.
+      /// \param[in] _distance Distance a camera can move, in meters
+      /// \param[in] _angle Angle a camera can turn
+      public: void SetLodUpdateThreshold(double _distance,
+                  const math::Angle &_angle);
+
+      /// \brief Get the distance a camera can move before the terrain
+      /// levels of detail are rebuilt for it
+      /// \return Distance threshold in meters
+      /// \sa SetLodUpdateThreshold
+      public: double LodUpdateDistanceThreshold() const;
+
+      /// \brief Get the angle a camera can turn before the terrain levels
+      /// of detail are rebuilt for it
+      /// \return Angle threshold
+      /// \sa SetLodUpdateThreshold
+      public: math::Angle LodUpdateAngleThreshold() const;
+
       /// \internal
-      /// \brief Retrieves the internal Terra pointer
+      /// \brief Retrieves the internal Terra pointer. When terrain paging is
+      /// enabled, this is the loaded tile closest to the last camera passed
+      /// to UpdateForRender
       /// \return internal Terra pointer
       public: Ogre::Terra* Terra();
 
@@ -91,7 +145,11 @@ namespace ignition
       /// \brief Must be called before rendering with the camera
       /// that will perform rendering.
       ///
-      /// May update shadows if light direction changed
+      /// May update shadows if light direction changed. Reuses the levels
+      /// of detail last chosen for the camera, see SetLodUpdateThreshold,
+      /// and starts them coarser for cameras with a level of detail bias
+      /// below 1. When terrain paging is enabled, also loads the tiles
+      /// around the camera and unloads the least recently used ones
       /// \param[in] _activeCamera Camera about to be used for rendering
       public: void UpdateForRender(Ogre::Camera *_activeCamera);
 
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2INSTANCEDVISUAL_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2INSTANCEDVISUAL_HH_
+
+#include <memory>
+
+#include "ignition/rendering/MeshDescriptor.hh"
+#include "ignition/rendering/base/BaseInstancedVisual.hh"
+#include "ignition/rendering/ogre2/Ogre2Visual.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // Forward declaration
+    class Ogre2InstancedVisualPrivate;
+
+    /// \brief Ogre 2.x implementation of an instanced visual. Each instance
+    /// is an ogre item on a scene node of its own, without any
+    /// ignition::rendering object. Ogre 2.x has no renderable drawn several
+    /// times: the HLMS merges consecutive items of the same mesh and
+    /// datablock into one instanced draw, whose per instance data are the
+    /// world matrices of the items. The items therefore share the mesh and
+    /// the datablock of the visual, and the colors of the instances are per
+    /// draw values as well, see
+    /// Ogre2MaterialOverride::InstanceColorParameterIndex.
+    /// Instance animations are evaluated by hidden items, one per animation
+    /// and phase, whose bone transforms the animated instances copy.
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2InstancedVisual :
+      public BaseInstancedVisual<Ogre2Visual>
+    {
+      /// \brief Constructor
+      protected: Ogre2InstancedVisual();
+
+      /// \brief Destructor
+      public: virtual ~Ogre2InstancedVisual();
+
+      // Documentation inherited
+      public: virtual void Destroy() override;
+
+      // Documentation inherited
+      public: virtual void SetVisible(bool _visible) override;
+
+      // Documentation inherited
+      public: virtual void SetVisibilityFlags(uint32_t _flags) override;
+
+      // Documentation inherited
+      protected: virtual void UpdateInstance(unsigned int _index) override;
+
+      // Documentation inherited
+      protected: virtual void UpdateAnimationTime() override;
+
+      /// \brief Assign an instance to the hidden item evaluating its
+      /// animation at the phase closest to its time offset
+      /// \param[in] _index Index of the instance
+      private: void UpdateInstanceAnimation(unsigned int _index);
+
+      /// \brief Copy the bone transforms of the hidden item evaluating the
+      /// animation of an instance to the instance
+      /// \param[in] _index Index of the instance
+      private: void CopyAnimationPose(unsigned int _index);
+
+      /// \brief Create the ogre items of the instances
+      /// \param[in] _desc Descriptor of the mesh of the instances
+      /// \param[in] _material Material of the instances, may be null
+      /// \param[in] _count Number of instances
+      /// \return True if the mesh was loaded
+      private: bool Create(const MeshDescriptor &_desc,
+                   MaterialPtr _material, unsigned int _count);
+
+      /// \brief Pointer to private data class
+      private: std::unique_ptr<Ogre2InstancedVisualPrivate> dataPtr;
+
+      /// \brief Only an ogre scene can create an ogre instanced visual
+      private: friend class Ogre2Scene;
+    };
+    }
+  }
+}
+#endif
@@ -59,6 +59,10 @@ namespace ignition
       public: virtual void SetPoints(
               const std::vector<double> &_points) override;
 
+      // Documentation inherited
+      public: virtual void SetRanges(const float *_ranges,
+                  unsigned int _channelCount = 1u) override;
+
       // Documentation inherited
       public: virtual void ClearPoints() override;
 
@@ -74,6 +78,15 @@ namespace ignition
       /// \brief Clear data stored by dynamiclines
       private: void ClearVisualData();
 
+      /// \brief Update the single point cloud that draws all lidar points
+      /// when the visual type is LVT_POINTS. The ray directions are uploaded
+      /// once and only the ranges are uploaded on every update. The points
+      /// are computed in the vertex shader.
+      private: void UpdatePoints();
+
+      /// \brief Destroy the point cloud created by UpdatePoints
+      private: void DestroyPoints();
+
       // Documentation inherited
       public: virtual void SetVisible(bool _visible) override;
 
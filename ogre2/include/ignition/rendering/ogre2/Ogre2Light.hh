@@ -102,6 +102,21 @@ namespace ignition
       // Documentation Inherited
       public: virtual void SetIntensity(double _intensity) override;
 
+      /// \brief Set whether the shadow map of this light is cached. A
+      /// cached shadow map is only re-rendered when the light or a static
+      /// visual moves, or when the scene is told that the shadow casters
+      /// changed, instead of on every camera pass. Use this for lights whose
+      /// shadow casters do not move. Has no effect unless the light casts
+      /// shadows.
+      /// \param[in] _static True to cache the shadow map
+      /// \sa Ogre2Scene::SetStaticShadowsDirty
+      public: void SetStaticShadows(bool _static);
+
+      /// \brief Get whether the shadow map of this light is cached
+      /// \return True if the shadow map is cached
+      /// \sa SetStaticShadows
+      public: bool StaticShadows() const;
+
       /// \brief Get a pointer to ogre light
       public: virtual Ogre::Light *Light() const;
 
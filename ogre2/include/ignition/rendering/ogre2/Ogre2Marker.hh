@@ -68,6 +68,10 @@ namespace ignition
       public: virtual void AddPoint(const ignition::math::Vector3d &_pt,
                            const ignition::math::Color &_color) override;
 
+      // Documentation inherited
+      public: virtual void SetPoints(const float *_xyz, const uint8_t *_rgba,
+                           std::size_t _count) override;
+
       // Documentation inherited
       public: virtual void ClearPoints() override;
 
@@ -80,6 +84,13 @@ namespace ignition
       /// \brief Create the marker geometry in ogre
       private: void Create();
 
+      /// \brief Submit the points of the marker to the marker batcher of
+      /// the scene if marker batching is enabled and the marker type can be
+      /// batched, and hide the dynamic renderable of the marker meanwhile
+      /// \return True if the marker is drawn by the batcher
+      /// \sa Ogre2Scene::SetMarkerBatching
+      private: bool UpdateBatch();
+
       /// \brief Marker should only be created by scene.
       private: friend class Ogre2Scene;
 
@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_set>
 
 #include "ignition/rendering/base/BaseMaterial.hh"
 #include "ignition/rendering/ogre2/Ogre2Object.hh"
@@ -61,6 +62,15 @@ namespace ignition
       // Documentation inherited
       public: virtual void Destroy() override;
 
+      /// \brief Clone the material. If material sharing is enabled in the
+      /// scene, the clone shares its ogre datablock with the other clones
+      /// of identical parameters until it is modified.
+      /// \param[in] _name Name of the cloned material
+      /// \return Cloned material
+      /// \sa Ogre2Scene::SetMaterialSharing
+      public: virtual MaterialPtr Clone(const std::string &_name = "") const
+                  override;
+
       // Documentation inherited
       public: virtual math::Color Diffuse() const override;
 
@@ -209,10 +219,38 @@ namespace ignition
       /// \return Ogre material pointer
       public: virtual Ogre::MaterialPtr Material();
 
-      /// \brief Return ogre Hlms material pbs datablock
+      /// \brief Return ogre Hlms material pbs datablock. The datablock may
+      /// be shared with other materials and must not be modified directly
+      /// if DatablockShared is true.
       /// \return Ogre Hlms pbs datablock
       public: virtual Ogre::HlmsPbsDatablock *Datablock() const;
 
+      /// \brief Get whether the ogre datablock of the material is shared
+      /// with other materials of identical parameters
+      /// \return True if the datablock is shared
+      /// \sa Ogre2Scene::SetMaterialSharing
+      public: bool DatablockShared() const;
+
+      /// \internal
+      /// \brief Give the material its own copy of the shared datablock and
+      /// switch the submeshes using the material to it. Called before the
+      /// datablock is modified, and by renderables that are not registered
+      /// as users of the material.
+      /// \sa DatablockShared
+      public: void UnshareDatablock();
+
+      /// \internal
+      /// \brief Register a submesh whose ogre subitem uses the datablock of
+      /// this material
+      /// \param[in] _subMesh Submesh using the material
+      /// \sa UnshareDatablock
+      public: void RegisterSubMeshUser(Ogre2SubMesh *_subMesh);
+
+      /// \internal
+      /// \brief Unregister a submesh that no longer uses this material
+      /// \param[in] _subMesh Submesh to unregister
+      public: void UnregisterSubMeshUser(Ogre2SubMesh *_subMesh);
+
       /// \brief Return ogre Hlms material unlit datablock
       /// \return Ogre Hlms unlit datablock
       public: virtual Ogre::HlmsUnlitDatablock *UnlitDatablock();
@@ -288,7 +326,8 @@ namespace ignition
       /// \brief bind shader parameters that have changed
       protected: void UpdateShaderParams();
 
-      /// \brief Transfer params from ign-rendering type to ogre type
+      /// \brief Transfer the params modified since the last update from
+      /// ign-rendering type to ogre type
       /// \param[in] _params ignition rendering params
       /// \param[out] _ogreParams ogre type for holding params
       protected: void UpdateShaderParams(ConstShaderParamsPtr _params,
@@ -333,6 +372,41 @@ namespace ignition
       /// \brief Unique id assigned to ogre hlms datablock
       protected: std::string ogreDatablockId;
 
+      /// \brief Apply the material settings that depend on the loaded
+      /// texture of a texture map
+      /// \param[in] _texture Ogre texture of the texture map
+      /// \param[in] _type Type of texture map
+      private: void ApplyTextureMapSettings(Ogre::TextureGpu *_texture,
+          Ogre::PbsTextureTypes _type);
+
+      /// \brief Apply the settings of the texture maps that finished
+      /// loading asynchronously. Called by the scene.
+      /// \return True if some textures are still being loaded
+      /// \sa Ogre2Scene::SetAsyncTextureLoading
+      private: bool UpdatePendingTextures();
+
+      /// \brief Reload the texture maps loaded from the block compressed
+      /// texture cache with a new maximum resolution. Called by the scene.
+      /// \param[in] _maxResolution Maximum width and height of the first
+      /// mip level, 0 for full resolution
+      /// \param[in,out] _replaced Names of the ogre textures the material no
+      /// longer uses
+      /// \param[in,out] _used Names of the ogre textures the material uses
+      /// \return True if the material still uses textures of the cache
+      /// \sa Ogre2Scene::SetTextureResidencyFromCameras
+      private: bool UpdateCachedTextures(unsigned int _maxResolution,
+          std::unordered_set<std::string> &_replaced,
+          std::unordered_set<std::string> &_used);
+
+      /// \brief Replace the datablock of the material with the one shared
+      /// by the materials of identical parameters
+      private: void ShareDatablock();
+
+      /// \brief Get a key identifying the datablock parameters of the
+      /// material
+      /// \return Content key of the datablock
+      private: std::string DatablockKey() const;
+
       /// \brief Pointer to private data class
       private: std::unique_ptr<Ogre2MaterialPrivate> dataPtr;
 
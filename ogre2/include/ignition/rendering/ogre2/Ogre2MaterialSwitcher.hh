@@ -18,6 +18,7 @@
 #ifndef IGNITION_RENDERING_OGRE2_OGRE2MATERIALSWITCHER_HH_
 #define IGNITION_RENDERING_OGRE2_OGRE2MATERIALSWITCHER_HH_
 
+#include <cstdint>
 #include <map>
 #include <string>
 
@@ -59,7 +60,8 @@ namespace ignition
       public: std::string EntityName(
               const ignition::math::Color &_color) const;
 
-      /// \brief Reset the color value incrementor
+      /// \brief Reset the color value incrementor and reassign the colors of
+      /// all items on the next render
       public: void Reset();
 
       /// \brief Ogre's pre render update callback
@@ -80,22 +82,36 @@ namespace ignition
       /// renderable name
       private: std::map<unsigned int, std::string> colorDict;
 
-      /// \brief A map of ogre sub item pointer to their original hlms material
-      private: std::map<Ogre::SubItem *, Ogre::HlmsDatablock *> datablockMap;
+      /// \brief Unique color value of each ogre item. Items keep their color
+      /// until they are destroyed.
+      private: std::map<Ogre::Item *, unsigned int> itemColors;
+
+      /// \brief Custom parameter index of the unique colors of the sub items,
+      /// see Ogre2MaterialOverride
+      private: size_t parameterIndex = 0u;
+
+      /// \brief True if the unique colors have been assigned
+      private: bool assigned = false;
+
+      /// \brief Scene visibility layers revision the colors were assigned for
+      private: uint64_t itemsRevision = 0u;
+
+      /// \brief A map of ogre sub items with low level materials to their
+      /// original material
+      private: std::map<Ogre::SubItem *, Ogre::MaterialPtr> materialMap;
 
       /// \brief Ogre v1 material consisting of a shader that changes the
       /// appearance of item to use a unique color for mouse picking
       private: Ogre::MaterialPtr plainMaterial;
 
-      /// \brief Ogre v1 material consisting of a shader that changes the
-      /// appearance of item to use a unique color for mouse picking. In
-      /// addition, the depth check and depth write properties disabled.
-      private: Ogre::MaterialPtr plainOverlayMaterial;
-
       /// \brief Increment unique color value that will be assigned to the
       /// next renderable
       private: void NextColor();
 
+      /// \brief Assign a unique color to the items created since the last
+      /// assignment and forget the destroyed ones
+      private: void AssignColors();
+
       /// \brief Selection Buffer class that make use of this class for
       /// selecting entitiies
       public: friend class Ogre2SelectionBuffer;
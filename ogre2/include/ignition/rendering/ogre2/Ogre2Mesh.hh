@@ -87,12 +87,32 @@ namespace ignition
       public: virtual void UpdateSkeletonAnimation(
             std::chrono::steady_clock::duration _time) override;
 
+      // Documentation inherited.
+      public: virtual std::vector<std::string> SkeletonBoneNames() const
+            override;
+
+      // Documentation inherited.
+      public: virtual void SetSkeletonBoneTransforms(
+            const std::vector<math::Matrix4d> &_tfs) override;
+
+      // Documentation inherited.
+      public: virtual bool ShareSkeleton(MeshPtr _mesh) override;
+
+      // Documentation inherited.
+      public: virtual bool UpdateVertices(const float *_positions,
+            const float *_normals, unsigned int _vertexCount) override;
+
       // Documentation inherited
       public: virtual Ogre::MovableObject *OgreObject() const override;
 
       /// \brief Get a list of submeshes in this mesh
       protected: virtual SubMeshStorePtr SubMeshes() const override;
 
+      /// \brief Replace the ogre item with one drawn from a private copy
+      /// of the mesh whose vertices can be updated in place
+      /// \return True if the ogre item draws a dynamic mesh
+      private: bool UseDynamicMesh();
+
       /// \brief Store containing all the submeshes
       protected: Ogre2SubMeshStorePtr subMeshes;
 
@@ -142,6 +162,10 @@ namespace ignition
       /// \brief Make scene our friend so it can create an ogre2 mesh
       private: friend class Ogre2Scene;
 
+      /// \brief Make mesh our friend so it can move the submesh to the
+      /// ogre item it updates the vertices of
+      private: friend class Ogre2Mesh;
+
       /// \brief Make submesh factory our friend so it can create an
       /// ogre2 submesh
       private: friend class Ogre2SubMeshStoreFactory;
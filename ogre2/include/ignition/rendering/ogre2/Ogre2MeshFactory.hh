@@ -27,9 +27,20 @@
 #include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
 #include "ignition/rendering/ogre2/Export.hh"
 
+namespace ignition
+{
+  namespace common
+  {
+    class SubMesh;
+  }
+}
+
 namespace Ogre
 {
+  struct Aabb;
   class Item;
+  class Ray;
+  class Vector3;
 }
 
 namespace ignition
@@ -57,10 +68,109 @@ namespace ignition
       /// mesh
       public: virtual Ogre2MeshPtr Create(const MeshDescriptor &_desc);
 
-      /// \brief Cleanup and clear all internal ogre v2 meshes created by this
-      /// factory
+      /// \brief Load a list of meshes ahead of their creation. The vertex
+      /// and index data of the meshes are packed on worker threads, only the
+      /// ogre buffers are created on the calling thread. Meshes that are
+      /// already loaded are skipped.
+      /// \param[in] _descs Descriptors of the meshes to load
+      public: void Preload(const std::vector<MeshDescriptor> &_descs);
+
+      /// \brief Prepare a mesh ahead of its creation. This can be called
+      /// from any thread: the vertex and index data of the mesh are packed
+      /// on the calling thread, and the ogre buffers are created by the
+      /// next call to UploadPreparedMeshes on the render thread. The cache
+      /// path, levels of detail and vertex compression must not change
+      /// while meshes are prepared.
+      /// \param[in] _desc Descriptor of the mesh to prepare
+      /// \sa UploadPreparedMeshes
+      public: void Prepare(const MeshDescriptor &_desc);
+
+      /// \brief Create the ogre meshes of the meshes prepared so far.
+      /// Meshes that were loaded in the meantime are skipped. This must be
+      /// called from the render thread.
+      /// \return Number of meshes created
+      /// \sa Prepare
+      public: unsigned int UploadPreparedMeshes();
+
+      /// \brief Cleanup and clear all internal ogre v2 meshes used by this
+      /// factory. The ogre meshes are shared by the scenes of the engine and
+      /// the ones still used by the factories of other scenes are kept.
       public: virtual void Clear();
 
+      /// \brief Register a user of the ogre mesh of a procedural shape, e.g.
+      /// of a capsule of given dimensions. Meshes created from the same
+      /// descriptor share the ogre mesh, which is generated once. Unlike
+      /// the meshes loaded from files, which are kept until Clear() is
+      /// called, the ogre mesh of a retained descriptor is removed once its
+      /// last user releases it. Only capsules need this: the unit shapes
+      /// share one mesh scaled by the node, and grids and wire boxes are
+      /// dynamic renderables with their own vertex data.
+      /// \param[in] _desc Descriptor of a mesh created by this factory
+      /// \sa ReleaseMesh
+      public: void RetainMesh(const MeshDescriptor &_desc);
+
+      /// \brief Unregister a user of the ogre mesh of a procedural shape.
+      /// The meshes created from the descriptor by this user must have been
+      /// destroyed.
+      /// \param[in] _desc Descriptor passed to RetainMesh
+      public: void ReleaseMesh(const MeshDescriptor &_desc);
+
+      /// \brief Set the directory of the on-disk mesh cache. When set, the
+      /// meshes converted by this factory are saved in the directory, keyed
+      /// by a hash of the source mesh file and the descriptor, and loaded
+      /// from it by later runs instead of being converted again. Meshes that
+      /// are not loaded from a file and skinned meshes are not cached.
+      /// An empty path, the default, disables the cache.
+      /// \param[in] _path Path to the cache directory
+      public: void SetCachePath(const std::string &_path);
+
+      /// \brief Get the directory of the on-disk mesh cache
+      /// \return Path to the cache directory, empty if disabled
+      public: std::string CachePath() const;
+
+      /// \brief Set the number of reduced levels of detail generated when
+      /// loading a mesh. Each level halves the triangle count of the
+      /// previous one with quadric error edge collapses and shares its
+      /// vertex buffers. Meshes with few triangles get no levels of detail.
+      /// Only affects the meshes loaded afterwards. 0, the default,
+      /// disables level of detail generation.
+      /// \param[in] _count Number of reduced levels
+      /// \sa SetLodDistance
+      public: void SetLodLevelCount(unsigned int _count);
+
+      /// \brief Get the number of reduced levels of detail generated when
+      /// loading a mesh
+      /// \return Number of reduced levels
+      public: unsigned int LodLevelCount() const;
+
+      /// \brief Set the distance from the camera at which the first
+      /// reduced level of detail is used. Each following level is used from
+      /// twice the distance of the previous one. Cameras scale the distances
+      /// with their level of detail bias. Only affects the meshes loaded
+      /// afterwards.
+      /// \param[in] _distance Distance in meters
+      /// \sa Camera::SetLodBias
+      public: void SetLodDistance(double _distance);
+
+      /// \brief Get the distance from the camera at which the first
+      /// reduced level of detail is used
+      /// \return Distance in meters
+      public: double LodDistance() const;
+
+      /// \brief Set whether vertex data is compressed. When enabled, the
+      /// positions of a mesh are stored as half floats if their rounding
+      /// error stays below a thousandth of the mesh size, which halves the
+      /// memory of the positions. Normals are always stored as QTangents,
+      /// texture coordinates as half floats, and indices in 16 bits when
+      /// the submesh has few enough vertices. Only affects the meshes
+      /// loaded afterwards. Disabled by default.
+      /// \param[in] _compress True to compress vertex data
+      public: void SetVertexCompression(bool _compress);
+
+      /// \brief Get whether vertex data is compressed
+      /// \return True if vertex data is compressed
+      public: bool VertexCompression() const;
+
       /// \brief Get the ogre item based on the mesh descriptor
       /// \param[in] _desc Descriptor describing the target mesh
       protected: virtual Ogre::Item *OgreItem(
@@ -88,7 +198,80 @@ namespace ignition
       /// \param[in] _desc Mesh descriptor to be validated
       protected: virtual bool Validate(const MeshDescriptor &_desc);
 
-      /// \brief A list of ogre meshes created by this factory
+      /// \brief Get the file of a mesh in the on-disk mesh cache
+      /// \param[in] _desc Mesh descriptor
+      /// \return Path to the cache file, empty if the mesh can't be cached
+      private: std::string CacheFile(const MeshDescriptor &_desc);
+
+      /// \brief Load a mesh from the on-disk mesh cache
+      /// \param[in] _desc Mesh descriptor
+      /// \param[in] _file Path to the cache file
+      /// \return True if the mesh was loaded from the cache
+      private: bool LoadFromCache(const MeshDescriptor &_desc,
+                   const std::string &_file);
+
+      /// \brief Save a loaded mesh to the on-disk mesh cache
+      /// \param[in] _desc Mesh descriptor
+      /// \param[in] _file Path to the cache file
+      private: void SaveToCache(const MeshDescriptor &_desc,
+                   const std::string &_file);
+
+      /// \brief Create the ogre mesh of a mesh whose data may have been
+      /// packed ahead of time, and save it to the on-disk mesh cache
+      /// \param[in] _desc Mesh descriptor
+      /// \param[in] _cacheFile Path to the cache file, empty if the mesh
+      /// can't be cached
+      private: void LoadPacked(const MeshDescriptor &_desc,
+                   const std::string &_cacheFile);
+
+      /// \brief Register this factory as a user of an ogre mesh shared by
+      /// the scenes of the engine
+      /// \param[in] _name Name of the ogre mesh
+      private: void AcquireMesh(const std::string &_name);
+
+      /// \brief Stop using an ogre mesh, which is removed if no other scene
+      /// uses it
+      /// \param[in] _name Name of the ogre mesh
+      private: void RemoveMesh(const std::string &_name);
+
+      /// \brief Create an item drawing a copy of a mesh whose vertex
+      /// positions and normals are kept in updatable vertex buffers. The
+      /// copy is not shared with other items.
+      /// \param[in] _desc Descriptor of the mesh to copy
+      /// \param[in] _name Name of the ogre mesh of the copy
+      /// \return The item or null if the mesh could not be copied
+      /// \sa UpdateDynamicMesh
+      private: Ogre::Item *DynamicOgreItem(const MeshDescriptor &_desc,
+                   const std::string &_name);
+
+      /// \brief Upload new vertex positions and normals to a mesh created
+      /// by DynamicOgreItem. The triangles used by ray queries are rebuilt
+      /// on the next query.
+      /// \param[in] _name Name of the ogre mesh
+      /// \param[in] _positions Positions of all vertices, 3 floats each
+      /// \param[in] _normals Normals of all vertices, 3 floats each, or null
+      /// to keep the current normals
+      /// \param[in] _vertexCount Number of vertices, must be the vertex
+      /// count of the mesh
+      /// \param[out] _bounds Bounding box of the new positions
+      /// \return True if the vertices were updated
+      private: bool UpdateDynamicMesh(const std::string &_name,
+                   const float *_positions, const float *_normals,
+                   unsigned int _vertexCount, Ogre::Aabb &_bounds);
+
+      /// \brief Destroy a mesh created by DynamicOgreItem. Its item must
+      /// have been destroyed.
+      /// \param[in] _name Name of the ogre mesh
+      private: void DestroyDynamicMesh(const std::string &_name);
+
+      /// \brief Create the material of a submesh loaded from a descriptor
+      /// \param[in] _desc Mesh descriptor
+      /// \param[in] _subMesh Submesh using the material
+      /// \return Name of the material
+      private: std::string CreateSubMeshMaterial(const MeshDescriptor &_desc,
+                   const common::SubMesh &_subMesh);
+
+      /// \brief A list of ogre meshes used by this factory
       protected: std::vector<std::string> ogreMeshes;
 
       /// \brief Pointer to the scene object
@@ -97,8 +280,36 @@ namespace ignition
       /// \brief Remove internal material cache for a specific material
       public: void ClearMaterialsCache(const std::string &_name);
 
+      /// \brief Intersect a ray with the triangles of a mesh created by this
+      /// factory. A bounding volume hierarchy over the mesh triangles is
+      /// built in mesh local space on first use and cached until Clear() is
+      /// called, so the ray is expected to be in the mesh's local frame.
+      /// \param[in] _meshName Name of the ogre mesh
+      /// \param[in] _ray Ray in the mesh's local frame
+      /// \param[out] _distance Ray parameter of the closest hit
+      /// \return True if a triangle was hit
+      public: bool Intersect(const std::string &_meshName,
+                  const Ogre::Ray &_ray, double &_distance);
+
+      /// \brief Get the triangles of a mesh created by this factory, in
+      /// the mesh's local frame. They are shared with the hierarchy used by
+      /// Intersect and cached until Clear() is called.
+      /// \param[in] _meshName Name of the ogre mesh
+      /// \return Triangle vertices, three per triangle, or null if the
+      /// triangles of the mesh are not available
+      public: const std::vector<Ogre::Vector3> *Triangles(
+                  const std::string &_meshName);
+
       /// \brief Pointer to private data class
       private: std::unique_ptr<Ogre2MeshFactoryPrivate> dataPtr;
+
+      /// \brief Make instanced visuals our friend so they can create the
+      /// ogre items of their instances
+      private: friend class Ogre2InstancedVisual;
+
+      /// \brief Make meshes our friend so they can switch to a copy whose
+      /// vertices are updated in place
+      private: friend class Ogre2Mesh;
     };
 
     /// \brief Ogre2.x implementation of a submesh store factory class
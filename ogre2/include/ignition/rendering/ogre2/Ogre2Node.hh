@@ -17,6 +17,8 @@
 #ifndef IGNITION_RENDERING_OGRE2_OGRE2NODE_HH_
 #define IGNITION_RENDERING_OGRE2_OGRE2NODE_HH_
 
+#include <cstdint>
+
 #include "ignition/rendering/base/BaseNode.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
 #include "ignition/rendering/ogre2/Ogre2Object.hh"
@@ -55,6 +57,19 @@ namespace ignition
       // Documentation inherited.
       public: virtual void Destroy() override;
 
+      /// \brief Mark the bounding boxes of this node and of its ancestors
+      /// as changed, e.g. after attaching geometry to the node.
+      /// \sa BoundsStamp
+      public: void MarkBoundsDirty();
+
+      /// \brief Get the stamp of the last change affecting the bounding
+      /// boxes of this node: a change in its subtree, or a change of the
+      /// pose, scale or visibility of the node or of one of its ancestors.
+      /// Stamps only increase, so a bounding box computed at a given stamp
+      /// is valid for as long as the stamp stays the same.
+      /// \return Stamp of the last change
+      public: uint64_t BoundsStamp() const;
+
       // Documentation inherited.
       public: virtual math::Vector3d LocalScale() const override;
 
@@ -112,6 +127,15 @@ namespace ignition
       // Documentation inherited.
       protected: virtual void Init() override;
 
+      /// \brief Mark the bounding boxes of the whole subtree of this node as
+      /// changed, e.g. after a change of the pose or scale of the node
+      protected: void MarkSubtreeBoundsDirty();
+
+      /// \brief Tell Ogre that a static node changed, so its transform and
+      /// the bounds of its objects are updated in the next frame. Does
+      /// nothing if the node is dynamic.
+      protected: void NotifyStaticDirty();
+
       /// \brief get a shared pointer to this
       private: Ogre2NodePtr SharedThis();
 
@@ -124,8 +148,23 @@ namespace ignition
       /// \brief A list of child nodes
       protected: Ogre2NodeStorePtr children;
 
+      /// \brief Stamp of the last change in the subtree of this node
+      private: uint64_t subtreeStamp = 0u;
+
+      /// \brief Stamp of the last change of this node affecting its whole
+      /// subtree
+      private: uint64_t inheritedStamp = 0u;
+
+      /// \brief True while Ogre2Scene::SetLocalPoses writes the pose of the
+      /// node from a worker thread. The scene marks the bounds of the node
+      /// beforehand, so the pose setters must not walk up the ancestors.
+      private: bool boundsMarkDeferred = false;
+
       // TODO(anyone): remove the need for a visual friend class
       private: friend class Ogre2Visual;
+
+      /// \brief Only the scene can defer bound marks, see SetLocalPoses
+      private: friend class Ogre2Scene;
     };
     }
   }
@@ -19,9 +19,17 @@
 
 #include <memory>
 #include <string>
+
+#include <ignition/math/AxisAlignedBox.hh>
+
 #include "ignition/rendering/base/BaseParticleEmitter.hh"
 #include "ignition/rendering/ogre2/Ogre2Visual.hh"
 
+namespace Ogre
+{
+  class ParticleSystem;
+}
+
 namespace ignition
 {
   namespace rendering
@@ -86,19 +94,43 @@ namespace ignition
       public: virtual void SetColorRangeImage(const std::string &_image)
           override;
 
+      // Documentation inherited.
+      public: virtual void SetGpuSimulationEnabled(bool _enabled) override;
+
+      // Documentation inherited.
+      public: virtual void PreRender() override;
+
+      /// \brief Get the ogre particle system simulating the particles on
+      /// the CPU
+      /// \return Ogre particle system
+      public: Ogre::ParticleSystem *OgreParticleSystem() const;
+
       /// \brief Particle system visibility flags
       public: static const uint32_t kParticleVisibilityFlags;
 
       // Documentation inherited.
       protected: virtual void Init() override;
 
-      /// \brief Internal pre-render function added to avoid breaking ABI
-      /// compatibility
-      private: void PreRenderImpl();
-
       /// \brief Create the particle system
       private: void CreateParticleSystem();
 
+      /// \brief Update the particles simulated on the GPU for the current
+      /// frame
+      private: void UpdateGpuParticles();
+
+      /// \brief Create the mesh of the particles simulated on the GPU
+      /// \param[in] _capacity Number of particles the mesh has room for
+      private: void CreateGpuParticles(unsigned int _capacity);
+
+      /// \brief Destroy the mesh of the particles simulated on the GPU
+      private: void DestroyGpuParticles();
+
+      /// \brief Get the world bounds of the particles, updated for the
+      /// current frame
+      /// \param[out] _box World bounds of the particles
+      /// \return False if the emitter has no particles
+      private: bool ParticleBounds(math::AxisAlignedBox &_box) const;
+
       /// \brief Only the ogre scene can instanstiate this class
       private: friend class Ogre2Scene;
 
@@ -18,6 +18,7 @@
 #define IGNITION_RENDERING_OGRE2_OGRE2RAYQUERY_HH_
 
 #include <memory>
+#include <vector>
 
 #include "ignition/rendering/base/BaseRayQuery.hh"
 #include "ignition/rendering/ogre2/Ogre2Object.hh"
@@ -51,13 +52,21 @@ namespace ignition
       // Documentation inherited
       public: virtual RayQueryResult ClosestPoint();
 
+      // Documentation inherited
+      public: virtual std::vector<RayQueryResult> ClosestPoints(
+                  const std::vector<math::Line3d> &_rays);
+
       /// \brief Get closest point by selection buffer.
       /// This is executed on the GPU.
       private: RayQueryResult ClosestPointBySelectionBuffer();
 
       /// \brief Get closest point by ray triangle intersection test.
       /// This is executed on the CPU.
-      private: RayQueryResult ClosestPointByIntersection();
+      /// \param[in] _origin Ray origin
+      /// \param[in] _direction Ray direction
+      private: RayQueryResult ClosestPointByIntersection(
+                   const math::Vector3d &_origin,
+                   const math::Vector3d &_direction);
 
       /// \brief Private data pointer
       private: std::unique_ptr<Ogre2RayQueryPrivate> dataPtr;
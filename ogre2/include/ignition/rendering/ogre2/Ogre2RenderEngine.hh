@@ -24,15 +24,25 @@
 
 #include <ignition/common/SingletonT.hh>
 
+#include "ignition/rendering/GraphicsAPI.hh"
 #include "ignition/rendering/RenderEnginePlugin.hh"
 #include "ignition/rendering/base/BaseRenderEngine.hh"
 #include "ignition/rendering/base/BaseRenderTypes.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
 #include "ignition/rendering/ogre2/Export.hh"
 
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreMaterial.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
 namespace Ogre
 {
   class LogManager;
+  class RenderSystem;
   class Root;
   class Window;
   namespace v1
@@ -53,6 +63,10 @@ namespace ignition
     // forward declaration
     class Ogre2RenderEnginePrivate;
     class Ogre2IgnHlmsCustomizations;
+    class Ogre2MaterialOverride;
+    class Ogre2SharedMeshes;
+    class Ogre2TransientTextures;
+    class Ogre2WorkerPool;
 
     /// \brief Plugin for loading ogre render engine
     class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2RenderEnginePlugin :
@@ -76,6 +90,13 @@ namespace ignition
     /// \brief Ogre2 render engine class. A singleton class that manages the
     /// underlying ogre2 render engine, loads its plugins, and creates
     /// resources needed for the engine to run
+    ///
+    /// Ogre only supports one root, and so one GL context, per process. To
+    /// render on several GPUs, run one process per GPU, each selecting its
+    /// device with the "headlessDevice" engine parameter. The processes can
+    /// share the converted meshes and compiled shaders through the on-disk
+    /// caches, see Ogre2Scene::SetMeshCachePath and the "shaderCache" engine
+    /// parameter.
     class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2RenderEngine :
       public virtual BaseRenderEngine,
       public common::SingletonT<Ogre2RenderEngine>
@@ -95,10 +116,23 @@ namespace ignition
       // Documentation Inherited.
       public: virtual std::string Name() const override;
 
-      /// \brief Add path to resource in ogre2's resource manager
+      /// \brief Add path to resource in ogre2's resource manager. Each path
+      /// is registered once. The material scripts in it are only indexed,
+      /// they are parsed when one of their materials is requested with
+      /// OgreMaterial.
       /// \param[in] _uri Resource path in the form of an uri
       public: void AddResourcePath(const std::string &_uri) override;
 
+      /// \brief Get a low level ogre material by name. If the material is
+      /// defined by a material script found by AddResourcePath, the script
+      /// is parsed the first time one of its materials is requested.
+      /// \param[in] _name Name of the material
+      /// \return The material, null if no material has that name
+      public: Ogre::MaterialPtr OgreMaterial(const std::string &_name);
+
+      // Documentation inherited.
+      public: virtual rendering::MemoryStats MemoryStats() const override;
+
       /// \brief return the ogre window
       public: Ogre::Window * OgreWindow() const;
 
@@ -149,6 +183,31 @@ namespace ignition
       /// \brief Register Hlms
       private: void RegisterHlms();
 
+      /// \brief Load the shaders compiled by previous runs from the on-disk
+      /// shader cache, so warm starts skip compiling them. The cache is on
+      /// by default and can be turned off with the "shaderCache" engine
+      /// parameter. It lives in ~/.ignition/rendering/ogre2-shader-cache
+      /// unless the "shaderCachePath" engine parameter is set, with one
+      /// directory per render system, driver and library version.
+      private: void LoadShaderCache();
+
+      /// \brief Save the shaders compiled so far to the on-disk shader cache
+      private: void SaveShaderCache();
+
+      /// \brief Apply the GPU memory engine parameters once the first
+      /// window, and with it the VaoManager, exists:
+      /// - "vaoPoolCpuInaccessibleMB", "vaoPoolCpuAccessibleMB",
+      ///   "vaoPoolPersistentMB" and "vaoPoolPersistentCoherentMB" set the
+      ///   size of the VaoManager pools of each kind of buffer. Pools sized
+      ///   for the whole simulation are not grown while it runs.
+      /// - "textureStagingBudgetMB", "textureWorkerPreloadMB" and
+      ///   "textureWorkerRequestMB" set the texture streaming budgets, 8, 8
+      ///   and 4 MB by default.
+      /// - "preallocateBuffers" allocates the pools and staging buffers
+      ///   while loading, for deterministic frame times from the first
+      ///   frame on.
+      private: void ConfigureGpuMemory();
+
       /// \brief Create ogre root
       private: void CreateRoot();
 
@@ -161,6 +220,12 @@ namespace ignition
       /// \brief Creat the ogre render system
       private: void CreateRenderSystem();
 
+      /// \brief Select the EGL device set with the "headlessDevice" engine
+      /// parameter, either the index of the device or a part of its name,
+      /// e.g. "1" or "/dev/dri/card1". Only used in headless mode.
+      /// \param[in] _renderSys Render system to configure
+      private: void SelectHeadlessDevice(Ogre::RenderSystem *_renderSys);
+
       /// \brief Create dummy 1x1 render window for the main rendering context
       private: void CreateRenderWindow();
 
@@ -178,6 +243,40 @@ namespace ignition
       /// \return Ogre HLMS customizations
       public: Ogre2IgnHlmsCustomizations &HlmsCustomizations();
 
+      /// \internal
+      /// \brief Get the material override that sensors use to draw the
+      /// items of their scene passes with per item values
+      /// \return Material override of the Pbs and Unlit hlms
+      public: Ogre2MaterialOverride &MaterialOverride();
+
+      /// \internal
+      /// \brief Get the pool of render textures that sensors share for
+      /// results that do not outlive an update of their workspace
+      /// \return Transient textures of the engine
+      public: Ogre2TransientTextures &TransientTextures();
+
+      /// \internal
+      /// \brief Get the registry of the ogre meshes shared by the mesh
+      /// factories of all scenes
+      /// \return Shared meshes of the engine
+      public: Ogre2SharedMeshes &SharedMeshes();
+
+      /// \internal
+      /// \brief Register a render target using a compositor workspace
+      /// definition shared by render targets of the same settings
+      /// \param[in] _name Name of the workspace definition
+      /// \sa ReleaseWorkspaceDefinition
+      public: void AcquireWorkspaceDefinition(const std::string &_name);
+
+      /// \internal
+      /// \brief Unregister a render target using a shared compositor
+      /// workspace definition
+      /// \param[in] _name Name of the workspace definition
+      /// \return True if no render target uses the definition anymore and
+      /// it can be removed
+      /// \sa AcquireWorkspaceDefinition
+      public: bool ReleaseWorkspaceDefinition(const std::string &_name);
+
       /// \internal
       /// \brief Get a pointer to the Ogre overlay system.
       /// \return Pointer to the ogre overlay system.
@@ -202,6 +301,113 @@ namespace ignition
       public: Ogre::CompositorWorkspaceListener
           *TerraWorkspaceListener() const;
 
+      /// \brief Enable measuring the GPU time of every compositor pass
+      /// run by sensors, see Sensor::GpuStats. Timestamp queries are
+      /// issued around each pass, so this adds a small overhead and is off
+      /// by default. It can also be enabled with the "gpuTiming" engine
+      /// parameter. Only supported with OpenGL. It applies to sensors
+      /// created afterwards.
+      /// \param[in] _enabled True to enable GPU timing
+      public: void SetGpuTimingEnabled(bool _enabled);
+
+      /// \brief Get whether GPU timing of compositor passes is enabled
+      /// \return True if enabled
+      /// \sa SetGpuTimingEnabled
+      public: bool GpuTimingEnabled() const;
+
+      /// \brief Enable counting the draw calls, batches, instances and
+      /// triangles of every compositor pass run by sensors, see
+      /// Sensor::DrawStats. The render system metrics are read around each
+      /// pass, which adds a small overhead, so this is off by default. It
+      /// can also be enabled with the "drawStats" engine parameter. It
+      /// applies to sensors created afterwards.
+      /// \param[in] _enabled True to enable draw counting
+      public: void SetDrawStatsEnabled(bool _enabled);
+
+      /// \brief Get whether draw counting of compositor passes is enabled
+      /// \return True if enabled
+      /// \sa SetDrawStatsEnabled
+      public: bool DrawStatsEnabled() const;
+
+      /// \brief Get the graphics API the engine renders with, e.g. to know
+      /// how to use the native texture ids of render textures
+      /// \return The graphics API selected when loading the engine
+      public: rendering::GraphicsAPI GraphicsAPI() const;
+
+      /// \brief Enable occlusion culling in the scene passes of sensors.
+      /// Before each scene pass, the large opaque meshes in view are
+      /// rasterized on the CPU into a small depth buffer, and the objects
+      /// hidden behind them are skipped by the pass. This saves draws in
+      /// cluttered scenes at the cost of some CPU time per pass, so it is
+      /// off by default. It can also be enabled with the
+      /// "occlusionCulling" engine parameter. It applies to sensors created
+      /// afterwards.
+      /// \param[in] _enabled True to enable occlusion culling
+      public: void SetOcclusionCullingEnabled(bool _enabled);
+
+      /// \brief Get whether occlusion culling is enabled
+      /// \return True if enabled
+      /// \sa SetOcclusionCullingEnabled
+      public: bool OcclusionCullingEnabled() const;
+
+      /// \brief Set the number of threads the scenes use to update their
+      /// scene graph, i.e. the transforms and bounds of their nodes and the
+      /// frustum culling of each pass, and to write the poses given to
+      /// Scene::SetLocalPoses. It can also be set with the "sceneThreads"
+      /// engine parameter. It applies to scenes created afterwards.
+      /// \param[in] _count Number of threads including the render thread.
+      /// 0, the default, uses one thread per logical core.
+      public: void SetSceneThreadCount(unsigned int _count);
+
+      /// \brief Get the number of threads the scenes use to update their
+      /// scene graph
+      /// \return Number of threads including the render thread, never 0
+      /// \sa SetSceneThreadCount
+      public: unsigned int SceneThreadCount() const;
+
+      /// \brief Set whether the scenes also split the culling of instanced
+      /// entities between their threads. It can also be set with the
+      /// "sceneThreadedCulling" engine parameter. It applies to scenes
+      /// created afterwards with more than one thread.
+      /// \param[in] _enabled True to cull instanced entities in parallel
+      public: void SetSceneThreadedCulling(bool _enabled);
+
+      /// \brief Get whether the scenes split the culling of instanced
+      /// entities between their threads
+      /// \return True if instanced entities are culled in parallel
+      /// \sa SetSceneThreadedCulling
+      public: bool SceneThreadedCulling() const;
+
+      /// \brief Set the logical cores the threads of the scenes may run on,
+      /// e.g. to keep the simulations sharing a host from competing for
+      /// the same cores. It can also be set with the "sceneThreadAffinity"
+      /// engine parameter, as a list of cores and ranges such as "0-7,16".
+      /// It applies to scenes created afterwards, and is only supported on
+      /// Linux.
+      /// \param[in] _cores Indices of the cores, empty to run on any core,
+      /// the default
+      public: void SetSceneThreadAffinity(
+                  const std::vector<unsigned int> &_cores);
+
+      /// \brief Get the logical cores the threads of the scenes may run on
+      /// \return Indices of the cores, empty if they may run on any core
+      /// \sa SetSceneThreadAffinity
+      public: const std::vector<unsigned int> &SceneThreadAffinity() const;
+
+      /// \internal
+      /// \brief Get the worker threads shared by the sensors to convert
+      /// their read back images
+      /// \return Worker pool
+      /// \sa Ogre2Scene::SetPostProcessThreadCount
+      public: Ogre2WorkerPool &WorkerPool();
+
+      /// \internal
+      /// \brief Set the texture streaming budgets of the texture manager
+      /// back to the ones given as engine parameters, e.g. after textures
+      /// are released
+      /// \sa ConfigureGpuMemory
+      public: void ResetTextureBudgets();
+
       /// \brief Pointer to the ogre's overlay system
       private: Ogre::v1::OverlaySystem *ogreOverlaySystem = nullptr;
 
@@ -19,11 +19,17 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "ignition/rendering/base/BaseRenderPass.hh"
 #include "ignition/rendering/ogre2/Export.hh"
 #include "ignition/rendering/ogre2/Ogre2Object.hh"
 
+namespace Ogre
+{
+  class Camera;
+}
+
 namespace ignition
 {
   namespace rendering
@@ -61,6 +67,10 @@ namespace ignition
       // Documentation inherited.
       public: void Destroy() override;
 
+      /// \brief Set the ogre camera that the render pass applies to
+      /// \param[in] _camera Pointer to the ogre camera.
+      public: virtual void SetCamera(Ogre::Camera *_camera);
+
       /// \brief Get the ogre compositor node definition name for this
       /// render pass
       public: std::string OgreCompositorNodeDefinitionName() const;
@@ -68,9 +78,46 @@ namespace ignition
       /// \brief Create the render pass using ogre compositor
       public: virtual void CreateRenderPass();
 
+      /// \brief Check if another render pass that directly follows this one
+      /// in the chain can be applied by this pass's compositor node, which
+      /// saves a full screen pass. See SetFusedPasses.
+      /// \param[in] _pass Render pass that follows this pass or the last
+      /// pass fused into it
+      /// \return True if this pass can apply _pass too. Defaults to false.
+      public: virtual bool CanFuse(const Ogre2RenderPass &_pass) const;
+
+      /// \internal
+      /// \brief Set the render passes that directly follow this one and are
+      /// applied by this pass's compositor node instead of their own. This is
+      /// done by Ogre2RenderTarget when building the render pass chain.
+      /// A render pass that is fused into another must not be connected.
+      /// \param[in] _passes Fused passes, in chain order
+      public: void SetFusedPasses(
+                  const std::vector<std::weak_ptr<Ogre2RenderPass>> &_passes);
+
+      /// \brief Get the render passes applied by this pass's compositor node
+      /// \return Fused passes, in chain order
+      /// \sa SetFusedPasses
+      public: const std::vector<std::weak_ptr<Ogre2RenderPass>> &FusedPasses()
+                  const;
+
+      /// \internal
+      /// \brief Set whether this pass is applied by the compositor node of
+      /// a previous pass
+      /// \param[in] _fused True if this pass is fused into another one
+      public: void SetFused(bool _fused);
+
+      /// \brief Check if this pass is applied by the compositor node of a
+      /// previous pass, in which case its own node is not connected
+      /// \return True if this pass is fused into another one
+      public: bool IsFused() const;
+
       /// \brief Name of the ogre compositor node definition
       protected: std::string ogreCompositorNodeDefName;
 
+      /// \brief Pointer to the ogre camera
+      protected: Ogre::Camera *ogreCamera = nullptr;
+
       /// \brief Pointer to private data class
       private: std::unique_ptr<Ogre2RenderPassPrivate> dataPtr;
     };
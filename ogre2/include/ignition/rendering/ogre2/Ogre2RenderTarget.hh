@@ -17,6 +17,7 @@
 #ifndef IGNITION_RENDERING_OGRE2_OGRE2RENDERTARGET_HH_
 #define IGNITION_RENDERING_OGRE2_OGRE2RENDERTARGET_HH_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -72,6 +73,39 @@ namespace ignition
       /// \param[in] _image Image to copy the data to
       public: virtual void Copy(Image &_image) const override;
 
+      /// \brief Queue a copy of the render target buffer data to an image.
+      /// The data is downloaded to a staging buffer without stalling, and
+      /// written to the image once the download is complete.
+      /// \param[in] _image Image to copy the data to
+      /// \param[in] _callback Function called once the image is written
+      /// \return False if the image has the wrong dimensions
+      public: virtual bool CopyAsync(Image &_image,
+                  std::function<void()> _callback) override;
+
+      // Documentation inherited
+      public: virtual void WaitForAsyncCopies() override;
+
+      /// \brief Convert the render target buffer data to I420 on the GPU
+      /// and copy the result to an image
+      /// \param[in] _image PF_L8 image to copy the data to
+      /// \return False if the image has the wrong dimensions or format
+      /// \sa RenderTarget::CopyI420
+      public: virtual bool CopyI420(Image &_image) override;
+
+      /// \brief Convert the last rendered image to planar YUV 4:2:0 (I420)
+      /// on the GPU without reading it back. The result is written to
+      /// I420Texture, which can be handed to a hardware video encoder
+      /// instead, e.g. through its GL texture id.
+      /// \return False if the render target has not been built or its
+      /// width or height is odd
+      public: bool ConvertToI420();
+
+      /// \brief Get the single channel texture ConvertToI420 writes to. It
+      /// is as wide as the render target and 3/2 as tall, with the layout
+      /// of an I420 image.
+      /// \return The texture, null before the first ConvertToI420 call
+      public: Ogre::TextureGpu *I420Texture() const;
+
       /// \brief Get a pointer to the internal ogre camera
       /// \return Pointer to ogre camera
       public: virtual Ogre::Camera *Camera() const;
@@ -80,6 +114,124 @@ namespace ignition
       /// \param[in] _camera Pointer to ogre camera
       public: virtual void SetCamera(Ogre::Camera *_camera);
 
+      /// \brief Set whether the scene passes of the workspace render shadows
+      /// \param[in] _enabled False to render without the shadow node
+      /// \sa Camera::SetShadowsEnabled
+      public: void SetShadowsEnabled(bool _enabled);
+
+      /// \brief Set the scale of the resolution the scene passes render at.
+      /// The scene is rendered into a smaller texture and upscaled to the
+      /// size of the render target.
+      /// \param[in] _scale Scale of the width and height, 1 for full
+      /// resolution
+      /// \sa Camera::SetResolutionScale
+      public: void SetResolutionScale(double _scale);
+
+      /// \brief Get the scale of the resolution the scene passes render at
+      /// \return Scale of the width and height
+      public: double ResolutionScale() const;
+
+      /// \brief Set whether frames can be reprojected. The scene passes
+      /// then keep their depth buffer in a texture and each rendered frame
+      /// is copied, so Reproject can warp it to a new camera pose.
+      /// \param[in] _enabled True to enable reprojection
+      /// \sa Camera::SetReprojectionInterval
+      public: void SetReprojectionEnabled(bool _enabled);
+
+      /// \brief Check whether Reproject can reproject the last rendered
+      /// frame
+      /// \return False if reprojection is not enabled, no frame has been
+      /// rendered since the workspace was built, or the render target has
+      /// views, render passes or a camera that is not a plain perspective
+      /// one
+      public: bool CanReproject() const;
+
+      /// \brief Reproject the last rendered frame to the current pose of
+      /// the camera instead of rendering the scene. The frame is warped on
+      /// the GPU with its depth, which only takes the camera motion into
+      /// account.
+      /// \return False if the frame was not reprojected, see CanReproject
+      public: bool Reproject();
+
+      /// \brief Set whether the scene passes also write the object id of
+      /// the geometry to a texture of their own, which ObjectIdAt reads.
+      /// Object ids are not written with anti-aliasing.
+      /// \param[in] _enabled True to enable object ids
+      /// \sa Camera::SetObjectIdPickingEnabled
+      public: void SetObjectIdEnabled(bool _enabled);
+
+      /// \brief Get the object id at a pixel of the last rendered frame.
+      /// After each frame the ids around the pixel last passed to this
+      /// function are downloaded asynchronously, so pixels near it are
+      /// answered without waiting for the GPU. Pixels further away are
+      /// downloaded on demand.
+      /// \param[in] _x X coordinate in pixels
+      /// \param[in] _y Y coordinate in pixels
+      /// \param[out] _objectId Object id written at the pixel, 0 for the
+      /// background
+      /// \return False if object ids are not enabled or no frame has been
+      /// rendered with them, or the pixel is outside of the render target
+      public: bool ObjectIdAt(int _x, int _y, uint32_t &_objectId);
+
+      /// \brief Set whether the scene passes keep their depth buffer in a
+      /// texture of their own, which DepthAt reads
+      /// \param[in] _enabled True to enable depth queries
+      /// \sa Camera::SetDepthPickingEnabled
+      public: void SetDepthQueryEnabled(bool _enabled);
+
+      /// \brief Get the depth at a pixel of the last rendered frame. The
+      /// texel is downloaded on demand, which waits for the GPU but costs a
+      /// lot less than querying the scene.
+      /// \param[in] _x X coordinate in pixels
+      /// \param[in] _y Y coordinate in pixels
+      /// \param[out] _depth Distance along the view direction of the camera
+      /// to the surface rendered at the pixel, infinite for the background
+      /// \return False if depth queries are not enabled, no frame has been
+      /// rendered with them by a perspective camera, the render target is
+      /// anti-aliased or the pixel is outside of the render target
+      public: bool DepthAt(int _x, int _y, double &_depth);
+
+      /// \brief Copy the depth of the last rendered frame, waiting for the
+      /// GPU. The depth is written by the scene passes that render the
+      /// color, so it costs a download but no render of its own.
+      /// \param[out] _depth Buffer of width * height floats receiving the
+      /// distance along the view direction of the camera to the surface
+      /// rendered at each pixel, infinite for the background
+      /// \return False under the same conditions as DepthAt
+      public: bool CopyDepth(float *_depth);
+
+      /// \brief Get the depth texture of the last rendered frame if another
+      /// camera is about to render the same view at the same scene time
+      /// \param[in] _camera Ogre camera about to render
+      /// \return The depth texture, null if depth queries are not enabled,
+      /// the render target is anti-aliased or rendered at a lower
+      /// resolution, or the last frame was rendered from another view or at
+      /// another scene time
+      public: Ogre::TextureGpu *DepthTextureFor(
+                  const Ogre::Camera *_camera) const;
+
+      /// \brief Copy the object ids of the last rendered frame, waiting for
+      /// the GPU
+      /// \param[out] _objectIds Buffer of width * height object ids, 0 for
+      /// the background
+      /// \return False if object ids are not enabled or no frame has been
+      /// rendered with them
+      /// \sa ObjectIdAt
+      public: bool CopyObjectIds(uint32_t *_objectIds);
+
+      /// \brief Set the cameras of the views rendered side by side into this
+      /// render target, see Camera::SetViewPoses. The views are rendered by
+      /// the scene passes of a single workspace.
+      /// \param[in] _cameras Ogre camera of each view, from the top left.
+      /// Empty to only render the view of the camera set with SetCamera.
+      /// \param[in] _shareShadows True if all views can reuse the shadow
+      /// maps of the first view
+      /// \param[in] _columns Number of columns of the grid the views are
+      /// tiled in row by row, 0 for a single row, see
+      /// Camera::SetViewColumns
+      public: void SetViewCameras(const std::vector<Ogre::Camera *> &_cameras,
+                  bool _shareShadows, unsigned int _columns = 0u);
+
       // Documentation inherited
       public: virtual math::Color BackgroundColor() const override;
 
@@ -115,6 +267,14 @@ namespace ignition
       /// \see Camera::SetShadowsNodeDefDirty
       public: void SetShadowsNodeDefDirty();
 
+      /// \internal
+      /// \brief Add a listener to the compositor workspace next to the
+      /// built-in ones, e.g. to time the passes on the GPU. It is added
+      /// again whenever the workspace is rebuilt.
+      /// \param[in] _listener Listener, owned by the caller
+      public: void AddWorkspaceListener(
+                  Ogre::CompositorWorkspaceListener *_listener);
+
       /// \brief Returns the FSAA to use based on supported specs by HW
       /// and value specified in Ogre2RenderTarget::AntiAliasing
       /// \return Value in range [1; 256). 1 means no antialiasing.
@@ -136,6 +296,25 @@ namespace ignition
       // Documentation inherited
       public: unsigned int GLIdImpl() const;
 
+      // Documentation inherited
+      public: void MetalIdImpl(void *_textureIdPtr) const;
+
+      /// \brief Get the OpenGL id of an ogre texture
+      /// \param[in] _texture Ogre texture, may be null
+      /// \return Texture Id of type GLuint, 0 if _texture is null or the
+      /// engine does not render with OpenGL
+      /// \sa Camera::RenderTextureGLId
+      public: static unsigned int TextureGLId(Ogre::TextureGpu *_texture);
+
+      /// \brief Get the Metal id of an ogre texture
+      /// \param[in] _texture Ogre texture, may be null
+      /// \param[out] _textureIdPtr Pointer to an id<MTLTexture>. Left
+      /// unchanged if _texture is null or the engine does not render with
+      /// Metal.
+      /// \sa Camera::RenderTextureMetalId
+      public: static void TextureMetalId(Ogre::TextureGpu *_texture,
+                  void *_textureIdPtr);
+
       /// \brief Destroy the render texture
       protected: void DestroyTargetImpl();
 
@@ -168,6 +347,16 @@ namespace ignition
       /// \brief Update the background material
       protected: virtual void UpdateBackgroundMaterial();
 
+      /// \brief Get the name of the sky box material for the environment
+      /// map of the background material
+      /// \return Sky box material name
+      private: std::string SkyboxMaterialName() const;
+
+      /// \brief Check whether the view of the camera is entirely below the
+      /// horizon when the scene culls the sky there, and rebuild the
+      /// compositor without the sky pass or with it again when that changes
+      private: void UpdateSkyVisibility();
+
       /// \brief Update the render pass chain
       protected: virtual void UpdateRenderPassChain();
 
@@ -186,6 +375,66 @@ namespace ignition
       /// \brief Destroy the compositor
       protected: virtual void DestroyCompositor();
 
+      /// \brief Write the copies queued by CopyAsync whose downloads are
+      /// complete to their images, and call their callbacks
+      /// \param[in] _maxQueued Wait for the oldest copies until at most
+      /// this many are still queued, e.g. 0 to wait for all of them
+      protected: void UpdateAsyncCopies(size_t _maxQueued);
+
+      /// \brief Wait for the copies queued by CopyAsync and destroy the
+      /// staging buffers they used
+      protected: void DestroyAsyncCopies();
+
+      /// \brief Destroy the texture and workspace of ConvertToI420
+      private: void DestroyI420();
+
+      /// \brief Copy the frame that was just rendered, and the camera
+      /// parameters it was rendered with, for Reproject
+      private: void SaveKeyFrame();
+
+      /// \brief Destroy the copy of the last rendered frame and the
+      /// workspace of Reproject
+      private: void DestroyReprojection();
+
+      /// \brief Get the texture the scene passes write object ids to
+      /// \return The texture, null if object ids are not written
+      private: Ogre::TextureGpu *ObjectIdTexture() const;
+
+      /// \brief Download the object ids around the pixel last passed to
+      /// ObjectIdAt
+      private: void DownloadObjectIds();
+
+      /// \brief Destroy the staging buffer of the object ids
+      private: void DestroyObjectIds();
+
+      /// \brief Get the texture the scene passes keep their depth in
+      /// \return The texture, null if neither reprojection nor depth
+      /// queries are enabled
+      private: Ogre::TextureGpu *DepthTexture() const;
+
+      /// \brief Destroy the staging buffer of DepthAt
+      private: void DestroyDepthQuery();
+
+      /// \brief Download a texture of 32 bit texels rendered by the scene
+      /// passes, at the size of the render target
+      /// \param[in] _texture Texture to download
+      /// \param[out] _data Buffer of width * height texels
+      /// \return False if the texture is null or not of 32 bit texels
+      private: bool DownloadTexels(Ogre::TextureGpu *_texture,
+                   void *_data) const;
+
+      /// \brief Get the pixel format and box to which the render target data
+      /// is written in an image
+      /// \param[in] _image Image the data is written to
+      /// \param[out] _format Pixel format to write the data as
+      /// \param[out] _padded Buffer the data is written to instead when
+      /// _format is padded compared to the image format, e.g. RGBA16 for
+      /// PF_FLOAT16_RGB. Empty otherwise
+      /// \return Box describing the image memory, or the padded buffer
+      private: Ogre::TextureBox ImageBox(Image &_image,
+                   Ogre::PixelFormatGpu &_format,
+                   std::vector<uint8_t> &_padded) const;
+
       /// \brief Re-initializes render target material to apply a material to
       /// everything in the scene. Does nothing if no material has been set
       /// \sa Ogre2RenderTarget::RebuildImpl()
@@ -253,6 +502,9 @@ namespace ignition
       // Documentation inherited
       public: virtual unsigned int GLId() const override;
 
+      // Documentation inherited
+      public: virtual void MetalId(void *_textureIdPtr) const override;
+
       // Documentation inherited
       // TODO(anyone): this function should be removed.
       // We didn't do it to preserve ABI.
@@ -30,6 +30,7 @@ namespace ignition
     //
     class Ogre2ArrowVisual;
     class Ogre2AxisVisual;
+    class Ogre2BoundingBoxCamera;
     class Ogre2Camera;
     class Ogre2Capsule;
     class Ogre2COMVisual;
@@ -41,6 +42,7 @@ namespace ignition
     class Ogre2Grid;
     class Ogre2Heightmap;
     class Ogre2InertiaVisual;
+    class Ogre2InstancedVisual;
     class Ogre2JointVisual;
     class Ogre2Light;
     class Ogre2LightVisual;
@@ -64,8 +66,10 @@ namespace ignition
     class Ogre2Sensor;
     class Ogre2SpotLight;
     class Ogre2SubMesh;
+    class Ogre2Text;
     class Ogre2ThermalCamera;
     class Ogre2Visual;
+    class Ogre2WideAngleCamera;
     class Ogre2WireBox;
 
     typedef BaseGeometryStore<Ogre2Geometry>      Ogre2GeometryStore;
@@ -80,6 +84,7 @@ namespace ignition
 
     typedef shared_ptr<Ogre2ArrowVisual>          Ogre2ArrowVisualPtr;
     typedef shared_ptr<Ogre2AxisVisual>           Ogre2AxisVisualPtr;
+    typedef shared_ptr<Ogre2BoundingBoxCamera>    Ogre2BoundingBoxCameraPtr;
     typedef shared_ptr<Ogre2Camera>               Ogre2CameraPtr;
     typedef shared_ptr<Ogre2Capsule>              Ogre2CapsulePtr;
     typedef shared_ptr<Ogre2COMVisual>            Ogre2COMVisualPtr;
@@ -91,6 +96,7 @@ namespace ignition
     typedef shared_ptr<Ogre2Grid>                 Ogre2GridPtr;
     typedef shared_ptr<Ogre2Heightmap>            Ogre2HeightmapPtr;
     typedef shared_ptr<Ogre2InertiaVisual>        Ogre2InertiaVisualPtr;
+    typedef shared_ptr<Ogre2InstancedVisual>      Ogre2InstancedVisualPtr;
     typedef shared_ptr<Ogre2JointVisual>          Ogre2JointVisualPtr;
     typedef shared_ptr<Ogre2Light>                Ogre2LightPtr;
     typedef shared_ptr<Ogre2LightVisual>          Ogre2LightVisualPtr;
@@ -114,8 +120,10 @@ namespace ignition
     typedef shared_ptr<Ogre2Sensor>               Ogre2SensorPtr;
     typedef shared_ptr<Ogre2SpotLight>            Ogre2SpotLightPtr;
     typedef shared_ptr<Ogre2SubMesh>              Ogre2SubMeshPtr;
+    typedef shared_ptr<Ogre2Text>                 Ogre2TextPtr;
     typedef shared_ptr<Ogre2ThermalCamera>        Ogre2ThermalCameraPtr;
     typedef shared_ptr<Ogre2Visual>               Ogre2VisualPtr;
+    typedef shared_ptr<Ogre2WideAngleCamera>      Ogre2WideAngleCameraPtr;
     typedef shared_ptr<Ogre2WireBox>              Ogre2WireBoxPtr;
 
     typedef shared_ptr<Ogre2GeometryStore>        Ogre2GeometryStorePtr;
@@ -17,6 +17,7 @@
 #ifndef IGNITION_RENDERING_OGRE2_OGRE2SCENE_HH_
 #define IGNITION_RENDERING_OGRE2_OGRE2SCENE_HH_
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -34,14 +35,19 @@
   #pragma warning(push, 0)
 #endif
 #include <Compositor/OgreCompositorShadowNode.h>
+#include <OgreAxisAlignedBox.h>
 #ifdef _MSC_VER
   #pragma warning(pop)
 #endif
 
 namespace Ogre
 {
+  class CompositorWorkspace;
+  class HlmsPbsDatablock;
+  class Item;
   class Root;
   class SceneManager;
+  class SubItem;
 }
 
 namespace ignition
@@ -52,6 +58,11 @@ namespace ignition
     //
     // forward declaration
     class Ogre2ScenePrivate;
+    class Ogre2LaserRetroSources;
+    class Ogre2GpuRaysGroup;
+    class Ogre2MarkerBatcher;
+    class Ogre2SegmentationLabelColors;
+    class Ogre2ThermalHeatSources;
     //
     /// \brief Ogre2.x implementation of the scene class
     class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2Scene :
@@ -83,9 +94,24 @@ namespace ignition
       // Documentation inherited
       public: virtual void PreRender() override;
 
+      /// \brief Set the local poses of many nodes at once. The poses are
+      /// written on the scene threads, see
+      /// Ogre2RenderEngine::SetSceneThreadCount, while the nodes and their
+      /// ancestors are marked for PreRender and bounds updates up front on
+      /// the calling thread.
+      /// \param[in] _ids IDs of the nodes to update
+      /// \param[in] _poses New local poses, in the same order as _ids
+      /// \return Number of nodes updated
+      public: virtual unsigned int SetLocalPoses(
+                  const std::vector<unsigned int> &_ids,
+                  const std::vector<math::Pose3d> &_poses) override;
+
       // Documentation inherited
       public: virtual void Clear() override;
 
+      // Documentation inherited.
+      public: virtual void Reset() override;
+
       // Documentation inherited
       public: virtual void Destroy() override;
 
@@ -95,6 +121,21 @@ namespace ignition
       // Documentation inherited
       public: virtual bool SkyEnabled() const override;
 
+      /// \brief Set whether cameras skip rendering the sky when their view
+      /// is entirely below the horizon. This assumes that the world has an
+      /// opaque ground hiding everything below the horizon, e.g. a ground
+      /// plane, so that such cameras, like downward facing ones, can't see
+      /// the sky. Cameras rebuild their compositor when the sky comes in or
+      /// out of view. Disabled by default.
+      /// \param[in] _enabled True to enable horizon culling of the sky
+      public: void SetSkyHorizonCulling(bool _enabled);
+
+      /// \brief Get whether cameras skip rendering the sky when their view
+      /// is entirely below the horizon
+      /// \return True if horizon culling of the sky is enabled
+      /// \sa SetSkyHorizonCulling
+      public: bool SkyHorizonCulling() const;
+
       // Documentation inherited.
       public: virtual void SetCameraPassCountPerGpuFlush(
             uint8_t _numPass) override;
@@ -105,10 +146,345 @@ namespace ignition
       // Documentation inherited.
       public: virtual bool LegacyAutoGpuFlush() const override;
 
+      // Documentation inherited.
+      public: virtual void RenderSensors(
+                  const std::vector<SensorPtr> &_sensors) override;
+
+      // Documentation inherited.
+      public: virtual void WarmUp() override;
+
+      // Documentation inherited.
+      public: virtual rendering::MemoryStats MemoryStats() const override;
+
+      /// \brief Load meshes ahead of the creation of the visuals that use
+      /// them. The vertex data of the meshes is packed on worker threads so
+      /// that loading many meshes at startup is not bound to the calling
+      /// thread.
+      /// \param[in] _descs Descriptors of the meshes to load
+      public: void PreloadMeshes(const std::vector<MeshDescriptor> &_descs);
+
+      // Documentation inherited.
+      public: virtual void PrepareMesh(const MeshDescriptor &_desc)
+                  override;
+
+      /// \brief Create the ogre meshes prepared by other threads, then run
+      /// the queued commands, which may create visuals using them.
+      /// \return Number of commands run
+      /// \sa PrepareMesh
+      public: virtual unsigned int ProcessCommands() override;
+
+      /// \brief Set the directory of the on-disk cache of converted meshes.
+      /// Later runs using the same directory load the meshes from the cache
+      /// instead of converting them again. An empty path, the default,
+      /// disables the cache.
+      /// \param[in] _path Path to the cache directory
+      /// \sa Ogre2MeshFactory::SetCachePath
+      public: void SetMeshCachePath(const std::string &_path);
+
+      /// \brief Get the directory of the on-disk mesh cache
+      /// \return Path to the cache directory, empty if disabled
+      public: std::string MeshCachePath() const;
+
+      /// \brief Set the number of reduced levels of detail generated for
+      /// the meshes loaded afterwards, so that distant meshes cost less to
+      /// render in every camera and sensor. Disabled (0) by default.
+      /// \param[in] _count Number of reduced levels
+      /// \sa Ogre2MeshFactory::SetLodLevelCount
+      public: void SetMeshLodLevelCount(unsigned int _count);
+
+      /// \brief Get the number of reduced levels of detail generated for
+      /// the meshes
+      /// \return Number of reduced levels
+      public: unsigned int MeshLodLevelCount() const;
+
+      /// \brief Set the distance from the camera at which meshes switch to
+      /// their first reduced level of detail
+      /// \param[in] _distance Distance in meters
+      /// \sa Ogre2MeshFactory::SetLodDistance
+      public: void SetMeshLodDistance(double _distance);
+
+      /// \brief Get the distance from the camera at which meshes switch to
+      /// their first reduced level of detail
+      /// \return Distance in meters
+      public: double MeshLodDistance() const;
+
+      /// \brief Set whether the vertex data of meshes is compressed
+      /// \param[in] _compress True to compress vertex data
+      /// \sa Ogre2MeshFactory::SetVertexCompression
+      public: void SetMeshVertexCompression(bool _compress);
+
+      /// \brief Get whether the vertex data of meshes is compressed
+      /// \return True if vertex data is compressed
+      public: bool MeshVertexCompression() const;
+
+      /// \brief Set whether material textures are loaded asynchronously.
+      /// When enabled, materials do not wait for their textures to be
+      /// decoded and uploaded. Ogre's texture streaming worker thread loads
+      /// them in the background and the materials render with a fallback
+      /// texture until the textures are resident. Disabled by default.
+      /// \param[in] _async True to load textures asynchronously
+      /// \sa TexturesPending
+      public: void SetAsyncTextureLoading(bool _async);
+
+      /// \brief Get whether material textures are loaded asynchronously
+      /// \return True if textures are loaded asynchronously
+      /// \sa SetAsyncTextureLoading
+      public: bool AsyncTextureLoading() const;
+
+      /// \brief Set the directory of the on-disk cache of block compressed
+      /// textures. When set, the textures of the materials are converted to
+      /// block compressed formats (BC1, BC3 or BC5 depending on their use)
+      /// with a full mip chain the first time they are used, and loaded
+      /// from the cache afterwards, which reduces their GPU memory and
+      /// upload bandwidth by 4 to 8 times at the cost of some quality.
+      /// Later runs using the same directory skip the conversion. An empty
+      /// path, the default, loads the textures uncompressed.
+      /// \param[in] _path Path to the cache directory
+      public: void SetTextureCachePath(const std::string &_path);
+
+      /// \brief Get the directory of the on-disk cache of block compressed
+      /// textures
+      /// \return Path to the cache directory, empty if disabled
+      /// \sa SetTextureCachePath
+      public: std::string TextureCachePath() const;
+
+      /// \brief Set whether the resolution of the textures kept in memory
+      /// follows the cameras of the scene. When enabled, the textures loaded
+      /// from the texture cache, see SetTextureCachePath, drop the mip
+      /// levels larger than the highest resolution any camera needs, i.e.
+      /// the largest image dimension of the camera rounded up to a power of
+      /// two and halved for each unit of its texture mip bias. The textures
+      /// are reloaded when the cameras change. Disabled by default.
+      /// \param[in] _enabled True to bound the texture resolution by the
+      /// cameras
+      /// \sa Camera::SetTextureMipBias
+      public: void SetTextureResidencyFromCameras(bool _enabled);
+
+      /// \brief Get whether the resolution of the textures kept in memory
+      /// follows the cameras of the scene
+      /// \return True if the texture resolution is bound by the cameras
+      /// \sa SetTextureResidencyFromCameras
+      public: bool TextureResidencyFromCameras() const;
+
+      /// \brief Get the maximum resolution of the textures loaded from the
+      /// texture cache, as computed from the cameras at the last PreRender
+      /// \return Maximum width and height of the textures, 0 if not bound
+      /// \sa SetTextureResidencyFromCameras
+      public: unsigned int TextureResolutionCap() const;
+
+      /// \brief Get whether some material textures are still being loaded
+      /// asynchronously
+      /// \return True if textures are still being loaded
+      /// \sa WaitForTextures
+      public: bool TexturesPending();
+
+      /// \brief Block until all the material textures being loaded
+      /// asynchronously are resident, e.g. before rendering data that must
+      /// not contain fallback textures.
+      /// \sa TexturesPending
+      public: void WaitForTextures();
+
+      /// \brief Re-render the cached shadow maps of the lights with static
+      /// shadows on the next frame. Call this after moving or changing the
+      /// objects that cast shadows from these lights, or after moving a
+      /// camera if a directional light has static shadows, as its shadow
+      /// splits follow the camera. Moving the light itself, or moving or
+      /// attaching geometry to a static visual, invalidates the shadow maps
+      /// automatically.
+      /// \sa Ogre2Light::SetStaticShadows
+      public: void SetStaticShadowsDirty();
+
+      /// \brief Set how often the cached shadow maps of the lights with
+      /// static shadows are re-rendered even if they were not marked dirty
+      /// \param[in] _frames Number of frames between updates. 0, the
+      /// default, only updates them when they are marked dirty.
+      /// \sa SetStaticShadowsDirty
+      public: void SetStaticShadowsUpdateInterval(unsigned int _frames);
+
+      /// \brief Get how often the cached shadow maps of the lights with
+      /// static shadows are re-rendered even if they were not marked dirty
+      /// \return Number of frames between updates, 0 if only updated when
+      /// marked dirty
+      /// \sa SetStaticShadowsUpdateInterval
+      public: unsigned int StaticShadowsUpdateInterval() const;
+
+      /// \brief Set the maximum number of shadow maps. A directional light
+      /// uses 3 shadow maps, point and spot lights 1. When the shadow
+      /// casting lights need more, ogre renders the shadows of the lights
+      /// closest to the camera. The default, 25, is a safe limit: the
+      /// shaders generated by ogre fail to compile on some drivers when
+      /// the shadow maps exceed the number of uniforms they support.
+      /// \param[in] _count Maximum number of shadow maps
+      public: void SetMaxShadowMaps(unsigned int _count);
+
+      /// \brief Get the maximum number of shadow maps
+      /// \return Maximum number of shadow maps
+      /// \sa SetMaxShadowMaps
+      public: unsigned int MaxShadowMaps() const;
+
+      /// \brief Set the size of the shadow maps, in pixels. The first split
+      /// of directional lights and the point and spot lights use this size,
+      /// the other splits of directional lights use half of it.
+      /// \param[in] _size Shadow map size, a power of two between 256 and
+      /// 8192. The default is 2048.
+      /// \sa SetShadowResolutionByDistance
+      public: void SetShadowTextureSize(unsigned int _size);
+
+      /// \brief Get the size of the shadow maps
+      /// \return Shadow map size in pixels
+      /// \sa SetShadowTextureSize
+      public: unsigned int ShadowTextureSize() const;
+
+      /// \brief Set whether the shadow maps of point and spot lights get
+      /// smaller with the distance of their lights to the camera. Ogre
+      /// hands the shadow maps out to the closest lights first, so when
+      /// enabled the first quarter of the maps use the full shadow texture
+      /// size, the maps up to the half use half of it and the rest a
+      /// quarter. This saves memory and fill rate in scenes with many
+      /// shadow casting lights. Disabled by default.
+      /// \param[in] _enabled True to reduce the resolution of far lights
+      public: void SetShadowResolutionByDistance(bool _enabled);
+
+      /// \brief Get whether the shadow maps of far point and spot lights
+      /// have a reduced resolution
+      /// \return True if the resolution is reduced with the distance
+      /// \sa SetShadowResolutionByDistance
+      public: bool ShadowResolutionByDistance() const;
+
+      /// \brief Set the number of threads used to convert the images read
+      /// back by the depth, thermal and GPU ray sensors of this scene, e.g.
+      /// to remove row padding or unused channels. The work is shared by a
+      /// pool of worker threads of the engine and the render thread. Images
+      /// smaller than a few hundred kilobytes are always converted on the
+      /// render thread.
+      /// \param[in] _count Number of threads including the render thread.
+      /// 1, the default, converts everything on the render thread. 0 uses
+      /// one thread per hardware core.
+      public: void SetPostProcessThreadCount(unsigned int _count);
+
+      /// \brief Get the number of threads used to convert the images read
+      /// back by the sensors of this scene
+      /// \return Number of threads including the render thread, never 0
+      /// \sa SetPostProcessThreadCount
+      public: unsigned int PostProcessThreadCount() const;
+
+      /// \brief Set whether cloned materials share their ogre datablock.
+      /// When enabled, materials cloned from each other, e.g. by the unique
+      /// SetMaterial calls of visuals and geometries, share one datablock
+      /// per set of identical parameters so that ogre can batch them. A
+      /// material gets its own copy of the datablock the first time it is
+      /// modified. Only affects materials cloned after the call. Disabled by
+      /// default.
+      /// \param[in] _enabled True to share datablocks
+      /// \sa Ogre2Material::DatablockShared
+      public: void SetMaterialSharing(bool _enabled);
+
+      /// \brief Get whether cloned materials share their ogre datablock
+      /// \return True if datablocks are shared
+      /// \sa SetMaterialSharing
+      public: bool MaterialSharing() const;
+
+      /// \brief Get the number of datablocks shared by materials
+      /// \return Number of shared datablocks in use
+      /// \sa SetMaterialSharing
+      public: unsigned int SharedDatablockCount() const;
+
+      /// \brief Set whether point and line markers are batched. When
+      /// enabled, the point, line list and line strip markers whose
+      /// materials have the same parameters are merged into one dynamic
+      /// renderable per material, which takes a single draw call. Their
+      /// points are transformed to world space on the CPU and uploaded
+      /// every frame. Batched markers are not returned by selection
+      /// queries. Disabled by default.
+      /// \param[in] _enabled True to batch markers
+      public: void SetMarkerBatching(bool _enabled);
+
+      /// \brief Get whether point and line markers are batched
+      /// \return True if markers are batched
+      /// \sa SetMarkerBatching
+      public: bool MarkerBatching() const;
+
+      /// \brief Get the number of marker batches drawn
+      /// \return Number of batches of the last frame, 0 if marker batching
+      /// is disabled
+      /// \sa SetMarkerBatching
+      public: unsigned int MarkerBatchCount() const;
+
+      /// \brief Parameters of the Forward+ light clustering. The view
+      /// frustum of each camera is split into a grid of clusters, each
+      /// listing the point and spot lights that reach it.
+      public: struct ForwardClusteringParams
+      {
+        /// \brief Number of clusters across the width of the view
+        unsigned int width = 16u;
+
+        /// \brief Number of clusters across the height of the view
+        unsigned int height = 8u;
+
+        /// \brief Number of depth slices between minDistance and
+        /// maxDistance
+        unsigned int slices = 24u;
+
+        /// \brief Maximum number of lights listed in each cluster, the
+        /// extra lights are ignored
+        unsigned int lightsPerCell = 96u;
+
+        /// \brief Distance to the camera where the first slice starts
+        float minDistance = 1.0f;
+
+        /// \brief Distance to the camera where the last slice ends. Lights
+        /// beyond it are not applied.
+        float maxDistance = 500.0f;
+      };
+
+      /// \brief Set the Forward+ light clustering parameters. Large scenes
+      /// with many lights need more slices, a larger far distance and more
+      /// lights per cell, small scenes render faster with fewer. Changing
+      /// them recompiles the shaders, so set them once when creating the
+      /// scene.
+      /// \param[in] _params Clustering parameters
+      /// \sa SetForwardClusteringAuto
+      public: void SetForwardClustering(const ForwardClusteringParams &_params);
+
+      /// \brief Get the Forward+ light clustering parameters
+      /// \return Clustering parameters as set by SetForwardClustering
+      public: ForwardClusteringParams ForwardClustering() const;
+
+      /// \brief Set whether the Forward+ light clustering adapts to the
+      /// number of point and spot lights of the scene. When enabled,
+      /// clustering is turned off while the scene has no such lights and
+      /// the lights per cell follow the light count, from 8 up to the value
+      /// set with SetForwardClustering. The shaders are recompiled whenever
+      /// the light count crosses a power of two. Disabled by default.
+      /// \param[in] _enabled True to adapt the clustering
+      public: void SetForwardClusteringAuto(bool _enabled);
+
+      /// \brief Get whether the Forward+ light clustering adapts to the
+      /// number of lights
+      /// \return True if the clustering adapts to the lights
+      /// \sa SetForwardClusteringAuto
+      public: bool ForwardClusteringAuto() const;
+
       /// \brief Get a pointer to the ogre scene manager
       /// \return Pointer to the ogre scene manager
       public: virtual Ogre::SceneManager *OgreSceneManager() const;
 
+      /// \internal
+      /// \brief Get a scene node for a new ignition node. Scene nodes
+      /// released by destroyed nodes are reused before new ones are created,
+      /// which saves scene manager allocations when many short lived
+      /// visuals, e.g. markers, are created and destroyed.
+      /// \return Scene node without parent, children or attached objects
+      /// \sa ReleaseSceneNode
+      public: Ogre::SceneNode *AcquireSceneNode();
+
+      /// \internal
+      /// \brief Give back the scene node of a destroyed ignition node. The
+      /// node is detached and reset for reuse by AcquireSceneNode, or
+      /// destroyed if enough nodes are pooled already.
+      /// \param[in] _node Scene node to release
+      public: void ReleaseSceneNode(Ogre::SceneNode *_node);
+
       // Documentation inherited
       public: virtual void PostRender() override;
 
@@ -187,9 +563,233 @@ namespace ignition
       /// \return True if the number of shadow casting lights changed
       /// \sa ShadowsDirty
       public: bool ShadowsDirty() const;
+
+      /// \internal
+      /// \brief Mark the segmentation labels of visuals as changed. This is
+      /// called when the "label" user data of a visual is set, or when a
+      /// node is attached to or detached from a parent, since visuals
+      /// inherit the label of their ancestors. Segmentation and bounding
+      /// box cameras then rebuild their cached label colors
+      /// \sa LabelsRevision
+      public: void MarkLabelsDirty();
+
+      /// \internal
+      /// \brief Get the number of times visual labels have changed
+      /// \return Revision of the labels, incremented by MarkLabelsDirty
+      /// \sa MarkLabelsDirty
+      public: uint64_t LabelsRevision() const;
+
+      /// \internal
+      /// \brief Mark the temperatures of visuals as changed. This is called
+      /// when the "temperature", "minTemp" or "maxTemp" user data of a visual
+      /// is set so that thermal cameras re-resolve their heat sources
+      /// \sa TemperaturesRevision
+      public: void MarkTemperaturesDirty();
+
+      /// \internal
+      /// \brief Get the number of times visual temperatures have changed
+      /// \return Revision of the temperatures, incremented by
+      /// MarkTemperaturesDirty
+      /// \sa MarkTemperaturesDirty
+      public: uint64_t TemperaturesRevision() const;
+
+      /// \internal
+      /// \brief Mark the laser retro values of visuals as changed. This is
+      /// called when the "laser_retro" user data of a visual is set so that
+      /// gpu rays sensors re-resolve the retro values of the items
+      /// \sa LaserRetrosRevision
+      public: void MarkLaserRetrosDirty();
+
+      /// \internal
+      /// \brief Get the number of times visual laser retro values have
+      /// changed
+      /// \return Revision of the laser retro values, incremented by
+      /// MarkLaserRetrosDirty
+      /// \sa MarkLaserRetrosDirty
+      public: uint64_t LaserRetrosRevision() const;
+
+      /// \internal
+      /// \brief Get the laser retro values shared by the gpu rays sensors
+      /// of this scene. The scene only keeps a weak reference, the values
+      /// are released with the last sensor using them
+      /// \return Shared laser retro values, expired if none exist
+      public: std::weak_ptr<Ogre2LaserRetroSources> &LaserRetroSources();
+
+      /// \internal
+      /// \brief Get the groups of co-located gpu rays sensors of this
+      /// scene that share a cubemap, indexed by group name
+      /// \return Ray groups
+      public: std::map<std::string, std::shared_ptr<Ogre2GpuRaysGroup>>
+                  &GpuRaysGroups();
+
+      /// \internal
+      /// \brief Get the batcher of the point and line markers of this scene
+      /// \return Marker batcher, null if marker batching is disabled
+      public: Ogre2MarkerBatcher *MarkerBatcher();
+
+      /// \internal
+      /// \brief Get the segmentation label colors shared by the
+      /// segmentation cameras of this scene, one per set of camera settings.
+      /// The scene only keeps weak references, the colors are released with
+      /// the last camera using them
+      /// \return Shared label colors, expired ones may remain until pruned
+      public: std::vector<std::weak_ptr<Ogre2SegmentationLabelColors>> &
+          SegmentationLabelColors();
+
+      /// \internal
+      /// \brief Get the heat sources shared by the thermal cameras of this
+      /// scene. The scene only keeps a weak reference, the heat sources are
+      /// released with the last camera using them
+      /// \return Shared heat sources, expired if none exist
+      public: std::weak_ptr<Ogre2ThermalHeatSources> &ThermalHeatSources();
+
+      /// \internal
+      /// \brief Mark the bounding box of a node as changed for the visual
+      /// index, along with the boxes of its ancestors, which include it.
+      /// Called by Ogre2Node. Nothing is recorded until a query built the
+      /// index.
+      /// \param[in] _node Node whose bounding box changed
+      /// \param[in] _subtree True if the boxes of all the descendants of
+      /// the node changed too, e.g. after the node moved
+      /// \sa Scene::VisualsInBox
+      public: void MarkVisualIndexDirty(const Ogre2Node *_node,
+                  bool _subtree);
+
+      /// \internal
+      /// \brief Mark the visibility layers as changed. This is called
+      /// whenever an ogre item is created or destroyed, or the visibility
+      /// flags of a visual change
+      /// \sa VisibleItems
+      public: void MarkVisibilityLayersDirty();
+
+      /// \internal
+      /// \brief Get the number of times the visibility layers were marked
+      /// as changed. Caches of per item data can compare it to find out if
+      /// items were created or destroyed
+      /// \return Revision of the visibility layers, incremented by
+      /// MarkVisibilityLayersDirty
+      /// \sa MarkVisibilityLayersDirty
+      public: uint64_t VisibilityLayersRevision() const;
+
+      /// \internal
+      /// \brief Get the ogre items whose visibility flags intersect a
+      /// mask. The items are bucketed per visibility bit, so sensors that
+      /// visit items every frame, e.g. to switch their materials, only go
+      /// through the layers their mask allows instead of every item in the
+      /// scene. The buckets are rebuilt on first use after
+      /// MarkVisibilityLayersDirty.
+      /// \param[in] _mask Visibility mask
+      /// \return Items with any of the bits of the mask set, each listed
+      /// once. The list is valid until the layers are marked dirty.
+      public: const std::vector<Ogre::Item *> &VisibleItems(uint32_t _mask);
+
+      /// \internal
+      /// \brief Mark the sub items drawn with low level materials as
+      /// changed. Called by Ogre2SubMesh when a sub item switches between
+      /// an hlms datablock and a low level material.
+      /// \sa LowLevelSubItems
+      public: void MarkLowLevelSubItemsDirty();
+
+      /// \internal
+      /// \brief Get the ogre sub items drawn with low level materials, e.g.
+      /// custom shaders. Sensors that override materials through the hlms
+      /// can't reach them and switch their materials instead. The list is
+      /// rebuilt on first use after items are created or destroyed or
+      /// MarkLowLevelSubItemsDirty is called.
+      /// \return Sub items with a low level material
+      public: const std::vector<Ogre::SubItem *> &LowLevelSubItems();
+
+      /// \internal
+      /// \brief Register a material as a user of a texture
+      /// \param[in] _texture Name of the texture
+      /// \param[in] _material Material that uses the texture
+      public: void RegisterTextureUser(const std::string &_texture,
+                  Ogre2Material *_material);
+
+      /// \internal
+      /// \brief Unregister a material as a user of a texture
+      /// \param[in] _texture Name of the texture
+      /// \param[in] _material Material that no longer uses the texture
+      public: void UnregisterTextureUser(const std::string &_texture,
+                  Ogre2Material *_material);
+
+      /// \internal
+      /// \brief Notify the scene that a material was destroyed. Memory pools
+      /// are cleaned up at the end of the frame, and the ogre texture is
+      /// destroyed too unless a material still using the texture is in use by
+      /// a renderable.
+      /// \param[in] _texture Name of the texture the material used
+      /// \param[in] _ogreTexture Name of the ogre texture the material used
+      public: void MaterialDestroyed(const std::string &_texture,
+                  const std::string &_ogreTexture);
+
+      /// \internal
+      /// \brief Get the datablock shared by the materials with the given
+      /// parameters, creating it as a copy of _datablock if needed
+      /// \param[in] _key Content key of the material parameters
+      /// \param[in] _datablock Datablock to copy if none is shared yet
+      /// \return Shared datablock
+      /// \sa ReleaseSharedDatablock
+      public: Ogre::HlmsPbsDatablock *AcquireSharedDatablock(
+                  const std::string &_key,
+                  const Ogre::HlmsPbsDatablock *_datablock);
+
+      /// \internal
+      /// \brief Release a datablock acquired with AcquireSharedDatablock.
+      /// The datablock is destroyed at the end of the frame once no material
+      /// or renderable uses it.
+      /// \param[in] _key Content key of the material parameters
+      public: void ReleaseSharedDatablock(const std::string &_key);
+
+      /// \internal
+      /// \brief Register a material whose textures are being loaded
+      /// asynchronously. The material is notified once its textures are
+      /// loaded.
+      /// \param[in] _material Material with pending textures
+      public: void RegisterPendingTextures(Ogre2Material *_material);
+
+      /// \internal
+      /// \brief Unregister a material whose textures are being loaded
+      /// asynchronously
+      /// \param[in] _material Material to unregister
+      public: void UnregisterPendingTextures(Ogre2Material *_material);
+
+      /// \internal
+      /// \brief Register a material using textures of the texture cache.
+      /// The material reloads them when the texture resolution cap changes.
+      /// \param[in] _material Material using cached textures
+      public: void RegisterCachedTextures(Ogre2Material *_material);
+
+      /// \internal
+      /// \brief Unregister a material using textures of the texture cache
+      /// \param[in] _material Material to unregister
+      public: void UnregisterCachedTextures(Ogre2Material *_material);
+
+      /// \internal
+      /// \brief Get the factory that creates the meshes of this scene
+      /// \return Mesh factory
+      public: Ogre2MeshFactoryPtr MeshFactory() const;
+
+      /// \internal
+      /// \brief Tie the lights with static shadows to their shadow maps in
+      /// the shadow node of the given workspace, and mark the shadow maps
+      /// dirty if the static shadows changed since the last call. Called
+      /// before the workspace is updated.
+      /// \param[in] _workspace Workspace about to be rendered
+      /// \param[in,out] _revision Static shadows revision the workspace was
+      /// last updated with. 0 for new workspaces.
+      public: void UpdateStaticShadowMaps(Ogre::CompositorWorkspace *_workspace,
+                  uint64_t &_revision);
       /// \endcond
 
       // Documentation inherited
+      // Documentation inherited
+      protected: virtual void CopySettings(const ScenePtr &_instance) const
+                     override;
+
+      // Documentation inherited
+      protected: virtual void UpdateVisualIndex() override;
+
       protected: virtual bool LoadImpl() override;
 
       // Documentation inherited
@@ -239,6 +839,14 @@ namespace ignition
       protected: virtual SegmentationCameraPtr CreateSegmentationCameraImpl(
                      unsigned int _id, const std::string &_name) override;
 
+      // Documentation inherited
+      protected: virtual WideAngleCameraPtr CreateWideAngleCameraImpl(
+                     unsigned int _id, const std::string &_name) override;
+
+      // Documentation inherited
+      protected: virtual BoundingBoxCameraPtr CreateBoundingBoxCameraImpl(
+                     unsigned int _id, const std::string &_name) override;
+
       // Documentation inherited
       protected: virtual GpuRaysPtr CreateGpuRaysImpl(unsigned int _id,
                      const std::string &_name) override;
@@ -311,6 +919,12 @@ namespace ignition
       protected: virtual LidarVisualPtr CreateLidarVisualImpl(unsigned int _id,
                      const std::string &_name) override;
 
+      // Documentation inherited
+      protected: virtual InstancedVisualPtr CreateInstancedVisualImpl(
+                     unsigned int _id, const std::string &_name,
+                     const MeshDescriptor &_desc, MaterialPtr _material,
+                     unsigned int _count) override;
+
       // Documentation inherited
       protected: virtual WireBoxPtr CreateWireBoxImpl(unsigned int _id,
                      const std::string &_name) override;
@@ -355,10 +969,40 @@ namespace ignition
       public: const std::vector<std::weak_ptr<Ogre2Heightmap>> &Heightmaps()
           const;
 
+      /// \internal
+      /// \brief World bounds and scatter ratio of the particles of an
+      /// emitter
+      public: struct ParticleVolume
+      {
+        /// \brief World bounds of the particles
+        Ogre::AxisAlignedBox box;
+
+        /// \brief Ratio of the particles detected by sensors
+        float scatterRatio = 0.65f;
+      };
+
+      /// \internal
+      /// \brief Get the volumes of the particle emitters that have
+      /// particles. The volumes are evaluated once per frame and shared by
+      /// all the sensors adding particle noise, instead of each sensor
+      /// walking the ogre particle systems when it is rendered.
+      /// \return Particle volumes, in emitter creation order
+      public: const std::vector<ParticleVolume> &ParticleVolumes();
+
       /// \brief Create a compositor shadow node with the same number of shadow
       /// textures as the number of shadow casting lights
       protected: void UpdateShadowNode();
 
+      /// \brief Mark the static shadows dirty if a light with static
+      /// shadows moved, or if the update interval elapsed
+      /// \sa SetStaticShadowsUpdateInterval
+      private: void UpdateStaticShadows();
+
+      /// \brief Configure the Forward+ light clustering of the ogre scene
+      /// manager, adapting it to the lights if enabled
+      /// \sa SetForwardClusteringAuto
+      private: void UpdateForwardClustering();
+
       /// \brief Create ogre compositor shadow node definition. The function
       /// takes a vector of parameters that describe the type, number, and
       /// resolution of textures create. Note that it is not necessary to
@@ -372,10 +1016,14 @@ namespace ignition
       /// \param[in] _shadowNodeName Name of the shadow node definition
       /// \param[in] _shadowParams Parameters containing the shadow type,
       /// texure resolution and position on the texture atlas.
+      /// \param[in] _staticParams Indices of the parameters, in
+      /// _shadowParams, of static shadow maps. Each of them must be alone in
+      /// its atlas so that the atlas is only cleared when it is rendered.
       private: void CreateShadowNodeWithSettings(
           Ogre::CompositorManager2 *_compositorManager,
           const std::string &_shadowNodeName,
-          const Ogre::ShadowNodeHelper::ShadowParamVec &_shadowParams);
+          const Ogre::ShadowNodeHelper::ShadowParamVec &_shadowParams,
+          const std::vector<size_t> &_staticParams = {});
 
       // Documentation inherited
       protected: virtual LightStorePtr Lights() const override;
@@ -389,6 +1037,33 @@ namespace ignition
       // Documentation inherited
       protected: virtual MaterialMapPtr Materials() const override;
 
+      /// \brief Destroy the textures and clean up the memory pools left
+      /// unused by the materials destroyed since the last call
+      /// \sa MaterialDestroyed
+      private: void CleanupDestroyedMaterials();
+
+      /// \brief Notify the materials with pending textures of the textures
+      /// that finished loading
+      /// \sa RegisterPendingTextures
+      private: void UpdatePendingTextures();
+
+      /// \brief Update the texture resolution cap from the cameras and
+      /// reload the cached textures of the materials if it changed
+      /// \sa SetTextureResidencyFromCameras
+      private: void UpdateTextureResidency();
+
+      /// \brief Destroy the scene nodes pooled for reuse
+      /// \sa ReleaseSceneNode
+      private: void DestroySceneNodePool();
+
+      /// \brief Check if sensors drawn with the low level GLSL programs of
+      /// this library can be created with the render system in use. These
+      /// programs have no Vulkan variants, so such sensors are refused when
+      /// rendering with Vulkan.
+      /// \param[in] _type Type of the sensor, for the error message
+      /// \return True if the sensor can be created
+      private: bool SensorSupported(const std::string &_type) const;
+
       /// \brief Create the GL context
       private: void CreateContext();
 
@@ -86,6 +86,10 @@ namespace ignition
       public: void LabelMapFromColoredBuffer(
                   uint8_t * _labelBuffer) const override;
 
+      // Documentation inherited
+      public: void SemanticLabelMap(
+                  uint8_t *_labelBuffer) const override;
+
       /// \brief Create the camera.
       protected: void CreateCamera();
 
@@ -95,6 +99,11 @@ namespace ignition
       // Documentation inherited
       protected: virtual void CreateSegmentationTexture() override;
 
+      /// \brief Destroy the segmentation textures, readback tickets and
+      /// compositor workspace so they can be created again, e.g. when
+      /// switching between colored map and label id map
+      private: void DestroySegmentationTexture();
+
       /// \brief Pointer to the ogre camera
       protected: Ogre::Camera *ogreCamera = nullptr;
 
@@ -17,14 +17,22 @@
 #ifndef IGNITION_RENDERING_OGRE2_OGRE2SELECTIONBUFFER_HH_
 #define IGNITION_RENDERING_OGRE2_OGRE2SELECTIONBUFFER_HH_
 
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ignition/math/Vector2.hh>
+#include <ignition/math/Vector3.hh>
 
 #include "ignition/rendering/config.hh"
 #include "ignition/rendering/ogre2/Export.hh"
 
 namespace Ogre
 {
+  class ColourValue;
+  class CompositorWorkspace;
   class Item;
   class RenderTarget;
   class SceneManager;
@@ -41,9 +49,10 @@ namespace ignition
 
     /// \brief Generates a selection buffer object for a given camera.
     /// The selection buffer is used of entity selection. On setup, a unique
-    /// color is assigned to each entity. Whenever a selection request is made,
-    /// the selection buffer camera renders to a 1x1 sized offscreen buffer.
-    /// The color value of that pixel gives the identity of the entity.
+    /// color is assigned to each entity. The first selection request after
+    /// the camera moved or rendered a new frame renders the whole selection
+    /// buffer and reads it back; later requests are answered from that
+    /// readback. The color value of a pixel gives the identity of the entity.
     class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2SelectionBuffer
     {
       /// \brief Constructor
@@ -75,6 +84,34 @@ namespace ignition
       public: bool ExecuteQuery(const int _x, const int _y, Ogre::Item *&_item,
           math::Vector3d &_point);
 
+      /// \brief Perform selection operations for a list of pixels at once.
+      /// All pixels are looked up in the same cached readback of the
+      /// selection buffer.
+      /// \param[in] _pixels Pixel coordinates to query.
+      /// \param[out] _items Ogre item at each pixel, or null if no item is
+      /// found at the pixel.
+      /// \param[out] _points 3D point of intersection at each pixel.
+      /// \return True if an ogre item is found at any of the pixels
+      public: bool ExecuteQueries(const std::vector<math::Vector2i> &_pixels,
+          std::vector<Ogre::Item *> &_items,
+          std::vector<math::Vector3d> &_points);
+
+      /// \brief Perform selection operations for every pixel in a rectangle
+      /// at once. See ExecuteQueries for a list of pixels.
+      /// \param[in] _x X coordinate of the top left corner in pixels.
+      /// \param[in] _y Y coordinate of the top left corner in pixels.
+      /// \param[in] _width Width of the rectangle in pixels.
+      /// \param[in] _height Height of the rectangle in pixels.
+      /// \param[out] _items Ogre item at each pixel in row major order, or
+      /// null if no item is found at the pixel.
+      /// \param[out] _points 3D point of intersection at each pixel in row
+      /// major order.
+      /// \return True if an ogre item is found at any of the pixels
+      public: bool ExecuteQueries(const int _x, const int _y,
+          unsigned int _width, unsigned int _height,
+          std::vector<Ogre::Item *> &_items,
+          std::vector<math::Vector3d> &_points);
+
       /// \brief Set dimension of the selection buffer
       /// \param[in] _width X dimension in pixels.
       /// \param[in] _height Y dimension in pixels.
@@ -83,6 +120,50 @@ namespace ignition
       /// \brief Call this to update the selection buffer contents
       public: void Update();
 
+      /// \brief Mark the cached selection buffer as out of date so the next
+      /// selection request renders it again. The camera calls this whenever
+      /// it renders a new frame.
+      public: void SetDirty();
+
+      /// \brief Render a selection buffer workspace
+      /// \param[in] _workspace Workspace to render
+      private: void Update(Ogre::CompositorWorkspace *_workspace);
+
+      /// \brief Check if the camera is in a state where selection queries
+      /// can be performed
+      /// \return True if queries can be performed
+      private: bool CanExecuteQuery() const;
+
+      /// \brief Render and read back the full resolution selection buffer if
+      /// the cached readback is out of date
+      private: void UpdateCache();
+
+      /// \brief Get a pixel of the cached selection buffer readback
+      /// \param[in] _x X coordinate in pixels.
+      /// \param[in] _y Y coordinate in pixels.
+      /// \return Pixel value of the selection buffer
+      private: Ogre::ColourValue CachedPixel(const int _x, const int _y) const;
+
+      /// \brief Get the ogre item and point of intersection encoded in a
+      /// selection buffer pixel
+      /// \param[in] _pixel Pixel value of the selection buffer
+      /// \param[out] _item Ogre item encoded in the pixel
+      /// \param[out] _point 3D point of intersection in world frame
+      /// \param[in,out] _itemCache Optional cache of the items found for
+      /// each pixel color, used to avoid looking up the same item repeatedly
+      /// \return True if an ogre item is found, false otherwise
+      private: bool DecodePixel(const Ogre::ColourValue &_pixel,
+          Ogre::Item *&_item, math::Vector3d &_point,
+          std::unordered_map<uint32_t, Ogre::Item *> *_itemCache = nullptr)
+          const;
+
+      /// \brief Create the full resolution render texture that is read back
+      /// into the cache
+      private: void CreateRegionBuffer();
+
+      /// \brief Delete the render texture created by CreateRegionBuffer
+      private: void DeleteRegionBuffer();
+
       /// \brief Delete the render texture
       private: void DeleteRTTBuffer();
 
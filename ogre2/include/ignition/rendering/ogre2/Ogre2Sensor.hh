@@ -17,6 +17,8 @@
 #ifndef IGNITION_RENDERING_OGRE2_OGRE2SENSOR_HH_
 #define IGNITION_RENDERING_OGRE2_OGRE2SENSOR_HH_
 
+#include <memory>
+
 #include "ignition/rendering/base/BaseSensor.hh"
 #include "ignition/rendering/ogre2/Ogre2Node.hh"
 
@@ -26,6 +28,11 @@ namespace ignition
   {
     inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
     //
+    // forward declarations
+    class Ogre2DrawCounter;
+    class Ogre2GpuTimer;
+    class Ogre2OcclusionCuller;
+
     /// \brief Ogre2.x implementation of the sensor classs
     class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2Sensor :
       public BaseSensor<Ogre2Node>
@@ -35,6 +42,65 @@ namespace ignition
 
       /// \brief Destructor
       public: virtual ~Ogre2Sensor();
+
+      // Documentation inherited.
+      public: virtual RenderStats GpuStats() const override;
+
+      // Documentation inherited.
+      public: virtual rendering::DrawStats DrawStats() const override;
+
+      /// \internal
+      /// \brief Get the timer measuring the compositor passes of this
+      /// sensor. Derived classes add it as listener to every compositor
+      /// workspace they create and call its BeginFrame when rendering.
+      /// \return Timer, or null if GPU timing is disabled
+      /// \sa Ogre2RenderEngine::SetGpuTimingEnabled
+      protected: Ogre2GpuTimer *GpuTimer();
+
+      /// \internal
+      /// \brief Get the counter of the draw calls of this sensor. Derived
+      /// classes add it as listener to every compositor workspace they
+      /// create and call its BeginFrame when rendering.
+      /// \return Counter, or null if draw counting is disabled
+      /// \sa Ogre2RenderEngine::SetDrawStatsEnabled
+      protected: Ogre2DrawCounter *DrawCounter();
+
+      /// \internal
+      /// \brief Add the GPU timer and the draw counter, the ones enabled,
+      /// as listeners to a compositor workspace of this sensor
+      /// \param[in] _workspace Compositor workspace
+      protected: void AddPassProfilers(Ogre::CompositorWorkspace *_workspace);
+
+      /// \internal
+      /// \brief Start a new frame of the GPU timer and the draw counter.
+      /// To be called at the start of Render.
+      protected: void BeginPassProfilers();
+
+      /// \internal
+      /// \brief Get the occlusion culler of this sensor. Derived classes
+      /// add it as listener to the compositor workspaces rendering the
+      /// scene.
+      /// \return Culler, or null if occlusion culling is disabled
+      /// \sa Ogre2RenderEngine::SetOcclusionCullingEnabled
+      protected: Ogre2OcclusionCuller *OcclusionCuller();
+
+      /// \brief GPU timer, created on first use
+      private: std::unique_ptr<Ogre2GpuTimer> gpuTimer;
+
+      /// \brief True if the engine was checked for GPU timing
+      private: bool gpuTimerChecked = false;
+
+      /// \brief Draw counter, created on first use
+      private: std::unique_ptr<Ogre2DrawCounter> drawCounter;
+
+      /// \brief True if the engine was checked for draw counting
+      private: bool drawCounterChecked = false;
+
+      /// \brief Occlusion culler, created on first use
+      private: std::unique_ptr<Ogre2OcclusionCuller> occlusionCuller;
+
+      /// \brief True if the engine was checked for occlusion culling
+      private: bool occlusionCullerChecked = false;
     };
     }
   }
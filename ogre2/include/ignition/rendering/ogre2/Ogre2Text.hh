@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2TEXT_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2TEXT_HH_
+
+#include <memory>
+
+#include <ignition/math/AxisAlignedBox.hh>
+
+#include "ignition/rendering/base/BaseText.hh"
+#include "ignition/rendering/ogre2/Ogre2Geometry.hh"
+
+namespace Ogre
+{
+  class MovableObject;
+}
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // Forward declaration
+    class Ogre2TextPrivate;
+
+    /// \brief Ogre 2.x implementation of text geometry. The glyphs are
+    /// textured quads sampling the glyph atlas of the font, which is shared
+    /// by all texts using the font. The quads are only rebuilt when the text
+    /// properties change, the vertex shader turns them to face the camera.
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2Text
+        : public BaseText<Ogre2Geometry>
+    {
+      /// \brief Constructor
+      protected: Ogre2Text();
+
+      /// \brief Destructor
+      public: virtual ~Ogre2Text();
+
+      // Documentation inherited
+      public: virtual void Init() override;
+
+      // Documentation inherited
+      public: virtual void Destroy() override;
+
+      // Documentation inherited
+      public: virtual void PreRender() override;
+
+      // Documentation inherited
+      public: virtual Ogre::MovableObject *OgreObject() const override;
+
+      // Documentation inherited.
+      public: virtual MaterialPtr Material() const override;
+
+      // Documentation inherited.
+      public: virtual void SetMaterial(MaterialPtr _material, bool _unique)
+          override;
+
+      // Documentation inherited.
+      public: virtual ignition::math::AxisAlignedBox AABB() const override;
+
+      /// \brief Lay out the glyphs and upload them to the vertex buffer
+      private: void Update();
+
+      /// \brief Text should only be created by scene.
+      private: friend class Ogre2Scene;
+
+      /// \brief Private data pointer
+      private: std::unique_ptr<Ogre2TextPrivate> dataPtr;
+    };
+    }
+  }
+}
+#endif
@@ -80,9 +80,18 @@ namespace ignition
           std::function<void(const uint16_t *, unsigned int, unsigned int,
           unsigned int, const std::string &)>  _subscriber) override;
 
+      // Documentation inherited.
+      public: virtual ignition::common::ConnectionPtr
+          ConnectNewThermalFrameView(
+          std::function<void(const void *, unsigned int, unsigned int,
+          unsigned int, const std::string &)> _subscriber) override;
+
       /// \brief Implementation of the render call
       public: virtual void Render() override;
 
+      // Documentation inherited.
+      public: virtual void SetLinkedCamera(const CameraPtr &_camera) override;
+
       /// \brief Get a pointer to the render target.
       /// \return Pointer to the render target
       protected: virtual RenderTargetPtr RenderTarget() const override;
@@ -99,6 +108,11 @@ namespace ignition
       /// \brief Pointer to the ogre camera
       protected: Ogre::Camera *ogreCamera = nullptr;
 
+      /// \brief Bind the depth of the linked camera to the depth prepass if
+      /// it was rendered from the same view, or make the prepass clear the
+      /// depth otherwise
+      private: void UpdateDepthPrepass();
+
       /// \internal
       /// \brief Pointer to private data.
       private: std::unique_ptr<Ogre2ThermalCameraPrivate> dataPtr;
@@ -18,6 +18,7 @@
 #define IGNITION_RENDERING_OGRE2_OGRE2VISUAL_HH_
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "ignition/rendering/base/BaseVisual.hh"
@@ -55,6 +56,13 @@ namespace ignition
       // Documentation inherited.
       public: virtual void SetVisibilityFlags(uint32_t _flags) override;
 
+      // Documentation inherited.
+      public: virtual void SetUserData(const std::string &_key,
+                  Variant _value) override;
+
+      // Documentation inherited.
+      public: virtual void SetStatic(bool _static) override;
+
       // Documentation inherited.
       public: virtual ignition::math::AxisAlignedBox BoundingBox()
                   const override;
@@ -73,6 +81,19 @@ namespace ignition
                      ignition::math::AxisAlignedBox &_box, bool _local,
                      const ignition::math::Pose3d &_pose) const;
 
+      /// \brief Get the bounding box from the cache, or compute and cache
+      /// it if the visual or its ancestors changed since it was cached.
+      /// \param[in] _local A flag indicating if the local bounding box is to
+      /// be returned.
+      /// \return The bounding box.
+      private: ignition::math::AxisAlignedBox CachedBounds(bool _local) const;
+
+      /// \brief Check whether the bounding boxes of the objects attached to
+      /// this visual and its descendants only change through the visuals,
+      /// and can thus be cached.
+      /// \return True if the bounding boxes can be cached
+      private: bool BoundsCacheable() const;
+
       /// \brief Wrapper function for BoundsHelper to reduce redundant
       /// world pose access
       /// \param[in,out] _box The bounding box.
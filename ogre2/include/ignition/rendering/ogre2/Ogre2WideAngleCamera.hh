@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2WIDEANGLECAMERA_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2WIDEANGLECAMERA_HH_
+
+#ifdef _WIN32
+  // Ensure that Winsock2.h is included before Windows.h, which can get
+  // pulled in by anybody (e.g., Boost).
+  #include <Winsock2.h>
+#endif
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <ignition/common/Event.hh>
+
+#include "ignition/rendering/base/BaseWideAngleCamera.hh"
+#include "ignition/rendering/ogre2/Ogre2Includes.hh"
+#include "ignition/rendering/ogre2/Ogre2Sensor.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // Forward declaration
+    class Ogre2WideAngleCameraPrivate;
+
+    /// \brief Wide angle camera, e.g. a fisheye, rendered in two passes
+    /// like Ogre2GpuRays:
+    /// 1st Pass: The scene is rendered to the faces of a cubemap by six
+    /// cameras looking in all directions. Only the faces the image samples
+    /// are rendered.
+    /// 2nd Pass: Each pixel of the image samples the cubemap in the
+    /// direction the lens maps it to. The face and uv coordinates of each
+    /// pixel are computed once, when the lens, fov or image size change,
+    /// and looked up in a texture.
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2WideAngleCamera :
+      public BaseWideAngleCamera<Ogre2Sensor>
+    {
+      /// \brief Constructor
+      protected: Ogre2WideAngleCamera();
+
+      /// \brief Destructor
+      public: virtual ~Ogre2WideAngleCamera();
+
+      // Documentation inherited
+      public: virtual void Init() override;
+
+      // Documentation inherited
+      public: virtual void Destroy() override;
+
+      // Documentation inherited
+      public: virtual void PreRender() override;
+
+      // Documentation inherited
+      public: virtual void PostRender() override;
+
+      // Documentation inherited
+      public: virtual void Render() override;
+
+      // Documentation inherited
+      public: virtual void SetLens(const CameraLens &_lens) override;
+
+      /// \brief Copy the last rendered image
+      /// \param[out] _image Image of the size and format of the camera
+      public: virtual void Copy(Image &_image) const override;
+
+      /// \brief Copy the last rendered image. The copy is not asynchronous,
+      /// since the image is already read back by PostRender.
+      /// \param[out] _image Image of the size and format of the camera
+      /// \param[in] _callback Called once the image is copied
+      /// \return True
+      public: virtual bool CopyAsync(Image &_image,
+                  std::function<void()> _callback) override;
+
+      // Documentation inherited
+      public: virtual common::ConnectionPtr ConnectNewWideAngleFrame(
+          std::function<void(const unsigned char *, unsigned int,
+          unsigned int, unsigned int, const std::string &)> _subscriber)
+          override;
+
+      /// \brief Get a pointer to the render target.
+      /// \return Pointer to the render target
+      protected: virtual RenderTargetPtr RenderTarget() const override;
+
+      /// \brief Create the camera.
+      protected: void CreateCamera();
+
+      /// \brief Create a dummy render texture that holds the image size
+      protected: virtual void CreateRenderTexture();
+
+      /// \brief Create the lookup texture, the cubemap face textures and
+      /// the compositor workspaces of both passes
+      private: void CreateWideAngleTextures();
+
+      /// \brief Destroy the textures and workspaces created by
+      /// CreateWideAngleTextures so they can be created again, e.g. when
+      /// the lens changes
+      private: void DestroyWideAngleTextures();
+
+      /// \brief Create the texture that stores the cubemap face and uv
+      /// coordinates each pixel samples
+      private: void CreateSampleTexture();
+
+      /// \brief Pointer to the ogre camera
+      protected: Ogre::Camera *ogreCamera = nullptr;
+
+      /// \internal
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<Ogre2WideAngleCameraPrivate> dataPtr;
+
+      /// \brief Make scene our friend so it can create a camera
+      private: friend class Ogre2Scene;
+    };
+    }
+  }
+}
+#endif
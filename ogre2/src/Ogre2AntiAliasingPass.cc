@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <string>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/RenderPassSystem.hh"
+#include "ignition/rendering/ogre2/Ogre2AntiAliasingPass.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Compositor/OgreCompositorManager2.h>
+#include <Compositor/OgreCompositorNodeDef.h>
+#include <Compositor/Pass/PassQuad/OgreCompositorPassQuadDef.h>
+#include <OgreMaterial.h>
+#include <OgreMaterialManager.h>
+#include <OgrePass.h>
+#include <OgreRoot.h>
+#include <OgreTechnique.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+/// \brief Private data for the Ogre2AntiAliasingPass class
+class ignition::rendering::Ogre2AntiAliasingPassPrivate
+{
+  /// brief Pointer to the anti-aliasing ogre material
+  public: Ogre::Material *antiAliasingMat = nullptr;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+Ogre2AntiAliasingPass::Ogre2AntiAliasingPass()
+  : dataPtr(std::make_unique<Ogre2AntiAliasingPassPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2AntiAliasingPass::~Ogre2AntiAliasingPass()
+{
+}
+
+//////////////////////////////////////////////////
+void Ogre2AntiAliasingPass::PreRender()
+{
+  if (!this->dataPtr->antiAliasingMat)
+    return;
+
+  if (!this->enabled)
+    return;
+
+  // These parameters are declared in
+  // media/materials/scripts/anti_aliasing.material
+  Ogre::Pass *pass =
+      this->dataPtr->antiAliasingMat->getTechnique(0)->getPass(0);
+  Ogre::GpuProgramParametersSharedPtr psParams =
+      pass->getFragmentProgramParameters();
+  psParams->setNamedConstant("edgeThreshold",
+      static_cast<Ogre::Real>(this->edgeThreshold));
+  psParams->setNamedConstant("edgeThresholdMin",
+      static_cast<Ogre::Real>(this->edgeThresholdMin));
+  psParams->setNamedConstant("subpixelQuality",
+      static_cast<Ogre::Real>(this->subpixelQuality));
+}
+
+//////////////////////////////////////////////////
+void Ogre2AntiAliasingPass::CreateRenderPass()
+{
+  static int antiAliasingNodeCounter = 0;
+
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+
+  std::string nodeDefName = "AntiAliasingNode_"
+      + std::to_string(antiAliasingNodeCounter);
+
+  if (ogreCompMgr->hasNodeDefinition(nodeDefName))
+    return;
+
+  // The AntiAliasing material is defined in script (anti_aliasing.material).
+  // clone the material
+  std::string matName = "AntiAliasing";
+  Ogre::MaterialPtr ogreMat =
+      Ogre::MaterialManager::getSingleton().getByName(matName);
+  if (!ogreMat)
+  {
+    ignerr << "Anti-aliasing material not found: '" << matName << "'"
+           << std::endl;
+    return;
+  }
+  if (!ogreMat->isLoaded())
+    ogreMat->load();
+  std::string materialName = matName + "_" +
+      std::to_string(antiAliasingNodeCounter);
+  this->dataPtr->antiAliasingMat = ogreMat->clone(materialName).get();
+
+  // The compositor node definition is equivalent to the following ogre
+  // compositor script:
+  // compositor_node AntiAliasingNode
+  // {
+  //   in 0 rt_input
+  //   in 1 rt_output
+  //
+  //   target rt_output
+  //   {
+  //     pass render_quad
+  //     {
+  //       material AntiAliasing // Use copy instead of original
+  //       input 0 rt_input
+  //     }
+  //   }
+  //   out 0 rt_output
+  //   out 1 rt_input
+  // }
+
+  this->ogreCompositorNodeDefName = nodeDefName;
+  antiAliasingNodeCounter++;
+
+  Ogre::CompositorNodeDef *nodeDef =
+      ogreCompMgr->addNodeDefinition(nodeDefName);
+
+  nodeDef->addTextureSourceName("rt_input", 0,
+      Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+  nodeDef->addTextureSourceName("rt_output", 1,
+      Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+
+  nodeDef->setNumTargetPass(1);
+  Ogre::CompositorTargetDef *outputTargetDef =
+      nodeDef->addTargetPass("rt_output");
+  outputTargetDef->setNumPasses(1);
+  {
+    // quad pass. The edges are searched with bilinear fetches, so the
+    // input is sampled with linear filtering, see anti_aliasing.material
+    Ogre::CompositorPassQuadDef *passQuad =
+        static_cast<Ogre::CompositorPassQuadDef *>(
+        outputTargetDef->addPass(Ogre::PASS_QUAD));
+    passQuad->mMaterialName = materialName;
+    passQuad->addQuadTextureSource(0, "rt_input");
+  }
+  nodeDef->mapOutputChannel(0, "rt_output");
+  nodeDef->mapOutputChannel(1, "rt_input");
+}
+
+IGN_RENDERING_REGISTER_RENDER_PASS(Ogre2AntiAliasingPass, AntiAliasingPass)
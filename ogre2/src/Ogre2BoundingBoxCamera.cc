@@ -0,0 +1,957 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Profiler.hh>
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Pose3.hh>
+
+#include "ignition/rendering/RenderTypes.hh"
+#include "ignition/rendering/ogre2/Ogre2BoundingBoxCamera.hh"
+#include "ignition/rendering/ogre2/Ogre2Conversions.hh"
+#include "ignition/rendering/ogre2/Ogre2Heightmap.hh"
+#include "ignition/rendering/ogre2/Ogre2Includes.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderTarget.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+#include "ignition/rendering/ogre2/Ogre2Visual.hh"
+
+#include "Ogre2VertexDeformation.hh"
+
+namespace ignition
+{
+namespace rendering
+{
+inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+//
+/// \brief Helper class for switching the ogre item's material to a plain
+/// material that renders the id of the labeled object the item belongs to
+class Ogre2BoundingBoxMaterialSwitcher : public Ogre::Camera::Listener
+{
+  /// \brief A labeled object, i.e. a visual with a "label" user data
+  public: struct Object
+  {
+    /// \brief The labeled visual
+    std::weak_ptr<Visual> visual;
+
+    /// \brief Label of the visual
+    uint32_t label = 0u;
+  };
+
+  /// \brief Constructor
+  /// \param[in] _scene The scene to render
+  public: explicit Ogre2BoundingBoxMaterialSwitcher(Ogre2ScenePtr _scene);
+
+  /// \brief Destructor
+  public: ~Ogre2BoundingBoxMaterialSwitcher() = default;
+
+  /// \brief Get the labeled objects. The object at index i is rendered with
+  /// id i + 1, id 0 is the background and unlabeled items.
+  /// \return Labeled objects
+  public: const std::vector<Object> &Objects() const;
+
+  /// \brief Render the items of a single object, without depth testing,
+  /// and hide all other items
+  /// \param[in] _id Id of the object to render alone, 0 to render all
+  /// items
+  public: void SetIsolatedId(uint32_t _id);
+
+  /// \brief Callback when a camera is about to be rendered
+  /// \param[in] _cam Ogre camera pointer which is about to render
+  private: virtual void cameraPreRenderScene(Ogre::Camera *_cam) override;
+
+  /// \brief Callback when a camera is finished being rendered
+  /// \param[in] _cam Ogre camera pointer which has already rendered
+  private: virtual void cameraPostRenderScene(Ogre::Camera *_cam) override;
+
+  /// \brief Check if the cached item ids are out of date, i.e. if items
+  /// were added or removed, or labels or parents changed since they were
+  /// last assigned
+  /// \return True if the item ids need to be reassigned
+  private: bool ItemIdsDirty() const;
+
+  /// \brief Assign the id of its labeled object to every item in the scene
+  private: void AssignItemIds();
+
+  /// \brief Get the visual with a "label" user data that a visual belongs
+  /// to, i.e. the visual itself or its closest labeled ancestor
+  /// \param[in] _visual Visual to get the labeled visual of
+  /// \param[out] _label Label of the labeled visual
+  /// \return The labeled visual or null if the visual is not labeled
+  private: VisualPtr LabeledVisual(VisualPtr _visual, uint32_t &_label) const;
+
+  /// \brief Scene to render
+  private: Ogre2ScenePtr scene;
+
+  /// \brief Material that renders the color in custom parameter 1
+  private: Ogre::MaterialPtr plainMaterial;
+
+  /// \brief Same as plainMaterial but with the depth check and depth write
+  /// properties disabled
+  private: Ogre::MaterialPtr plainOverlayMaterial;
+
+  /// \brief A map of ogre sub item pointer to their original hlms material
+  private: std::unordered_map<Ogre::SubItem *, Ogre::HlmsDatablock *>
+      datablockMap;
+
+  /// \brief Id assigned to an ogre item
+  private: struct ItemId
+  {
+    /// \brief Id of the visual the item belongs to
+    unsigned int visualId = 0u;
+
+    /// \brief Id of the labeled object of the item, 0 if unlabeled
+    uint32_t id = 0u;
+
+    /// \brief Id encoded in a color
+    Ogre::Vector4 color;
+  };
+
+  /// \brief Cached ids of each ogre item that belongs to a visual
+  private: std::unordered_map<Ogre::Item *, ItemId> itemIds;
+
+  /// \brief Id of the object rendered alone, 0 if all items are rendered
+  private: uint32_t isolatedId = 0u;
+
+  /// \brief Items hidden while rendering an object alone, to show again
+  /// after rendering
+  private: std::vector<Ogre::Item *> hiddenItems;
+
+  /// \brief Labeled objects, indexed by id - 1
+  private: std::vector<Object> objects;
+
+  /// \brief True if itemIds has been assigned at least once
+  private: bool itemIdsAssigned = false;
+
+  /// \brief Scene labels revision the item ids were assigned for
+  private: uint64_t labelsRevision = 0u;
+
+  /// \brief Scene visibility layers revision the item ids were assigned
+  /// for
+  private: uint64_t itemsRevision = 0u;
+};
+}
+}
+}
+
+/// \internal
+/// \brief Private data for the Ogre2BoundingBoxCamera class
+class ignition::rendering::Ogre2BoundingBoxCameraPrivate
+{
+  /// \brief Workspace Definition
+  public: std::string ogreCompositorWorkspaceDef;
+
+  /// \brief Final pass compositor node definition
+  public: std::string ogreCompositorNodeDef;
+
+  /// \brief Compositor workspace that renders the id buffer
+  public: Ogre::CompositorWorkspace *ogreCompositorWorkspace {nullptr};
+
+  /// \brief Id buffer texture
+  public: Ogre::TextureGpu *ogreIdTexture {nullptr};
+
+  /// \brief Staging ticket for reading back the id buffer
+  public: Ogre::AsyncTextureTicket *idTicket {nullptr};
+
+  /// \brief Staging ticket for reading back the id buffer of objects
+  /// rendered alone, while idTicket is mapped
+  public: Ogre::AsyncTextureTicket *isolatedTicket {nullptr};
+
+  /// \brief True if the id buffer was downloaded during the last render and
+  /// is waiting to be mapped in PostRender
+  public: bool downloadPending = false;
+
+  /// \brief Dummy render texture
+  public: RenderTexturePtr renderTexture {nullptr};
+
+  /// \brief Material switcher that renders the id of each object
+  public: std::unique_ptr<Ogre2BoundingBoxMaterialSwitcher>
+          materialSwitcher {nullptr};
+
+  /// \brief New bounding boxes event
+  public: ignition::common::EventT<void(const std::vector<BoundingBox> &)>
+          newBoundingBoxes;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+/// \brief Draw a line on an RGB image, clipping pixels outside of the image
+/// \param[in,out] _data Image data
+/// \param[in] _width Image width
+/// \param[in] _height Image height
+/// \param[in] _color Line color
+/// \param[in] _x0 Start x
+/// \param[in] _y0 Start y
+/// \param[in] _x1 End x
+/// \param[in] _y1 End y
+static void DrawLine(unsigned char *_data, int _width, int _height,
+    const math::Color &_color, int _x0, int _y0, int _x1, int _y1)
+{
+  const unsigned char r = static_cast<unsigned char>(_color.R() * 255);
+  const unsigned char g = static_cast<unsigned char>(_color.G() * 255);
+  const unsigned char b = static_cast<unsigned char>(_color.B() * 255);
+
+  // Bresenham's line algorithm
+  int dx = std::abs(_x1 - _x0);
+  int dy = -std::abs(_y1 - _y0);
+  int sx = _x0 < _x1 ? 1 : -1;
+  int sy = _y0 < _y1 ? 1 : -1;
+  int err = dx + dy;
+  while (true)
+  {
+    if (_x0 >= 0 && _x0 < _width && _y0 >= 0 && _y0 < _height)
+    {
+      int idx = (_y0 * _width + _x0) * 3;
+      _data[idx] = r;
+      _data[idx + 1] = g;
+      _data[idx + 2] = b;
+    }
+    if (_x0 == _x1 && _y0 == _y1)
+      break;
+    int e2 = 2 * err;
+    if (e2 >= dy)
+    {
+      err += dy;
+      _x0 += sx;
+    }
+    if (e2 <= dx)
+    {
+      err += dx;
+      _y0 += sy;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+Ogre2BoundingBoxMaterialSwitcher::Ogre2BoundingBoxMaterialSwitcher(
+    Ogre2ScenePtr _scene)
+{
+  this->scene = _scene;
+
+  // plain material to switch item's material
+  Ogre::ResourcePtr res =
+    Ogre::MaterialManager::getSingleton().load("ign-rendering/plain_color",
+        Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+  this->plainMaterial = res.staticCast<Ogre::Material>();
+  this->plainMaterial->load();
+
+  // plain overlay material, shared by all bounding box cameras
+  const std::string overlayName = "BoundingBoxCamera_plain_color_overlay";
+  this->plainOverlayMaterial =
+      Ogre::MaterialManager::getSingleton().getByName(overlayName);
+  if (!this->plainOverlayMaterial)
+  {
+    this->plainOverlayMaterial = this->plainMaterial->clone(overlayName);
+    Ogre::Pass *overlayPass =
+        this->plainOverlayMaterial->getTechnique(0)->getPass(0);
+    Ogre::HlmsMacroblock macroblock(*overlayPass->getMacroblock());
+    macroblock.mDepthCheck = false;
+    macroblock.mDepthWrite = false;
+    overlayPass->setMacroblock(macroblock);
+  }
+}
+
+/////////////////////////////////////////////////
+const std::vector<Ogre2BoundingBoxMaterialSwitcher::Object> &
+    Ogre2BoundingBoxMaterialSwitcher::Objects() const
+{
+  return this->objects;
+}
+
+/////////////////////////////////////////////////
+void Ogre2BoundingBoxMaterialSwitcher::SetIsolatedId(uint32_t _id)
+{
+  this->isolatedId = _id;
+}
+
+/////////////////////////////////////////////////
+VisualPtr Ogre2BoundingBoxMaterialSwitcher::LabeledVisual(VisualPtr _visual,
+    uint32_t &_label) const
+{
+  VisualPtr root = this->scene->RootVisual();
+  VisualPtr p = _visual;
+  while (p && p != root)
+  {
+    Variant labelAny = p->UserData("label");
+    if (auto label = std::get_if<int>(&labelAny))
+    {
+      _label = static_cast<uint32_t>(*label);
+      return p;
+    }
+    p = std::dynamic_pointer_cast<Visual>(p->Parent());
+  }
+  return VisualPtr();
+}
+
+/////////////////////////////////////////////////
+bool Ogre2BoundingBoxMaterialSwitcher::ItemIdsDirty() const
+{
+  // items are created, destroyed and attached to visuals through calls
+  // that bump the visibility layers revision
+  return !this->itemIdsAssigned ||
+      this->labelsRevision != this->scene->LabelsRevision() ||
+      this->itemsRevision != this->scene->VisibilityLayersRevision();
+}
+
+/////////////////////////////////////////////////
+void Ogre2BoundingBoxMaterialSwitcher::AssignItemIds()
+{
+  this->itemIds.clear();
+  this->objects.clear();
+
+  // index of each labeled visual in objects
+  std::unordered_map<unsigned int, uint32_t> objectIndices;
+
+  auto itor = this->scene->OgreSceneManager()->getMovableObjectIterator(
+      Ogre::ItemFactory::FACTORY_TYPE_NAME);
+  while (itor.hasMoreElements())
+  {
+    Ogre::Item *item = static_cast<Ogre::Item *>(itor.getNext());
+    Ogre::Any userAny = item->getUserObjectBindings().getUserAny();
+    if (userAny.isEmpty() || userAny.getType() != typeid(unsigned int))
+      continue;
+
+    auto visualId = Ogre::any_cast<unsigned int>(userAny);
+    VisualPtr visual;
+    try
+    {
+      visual = this->scene->VisualById(visualId);
+    }
+    catch(Ogre::Exception &e)
+    {
+      ignerr << "Ogre Error:" << e.getFullDescription() << "\n";
+    }
+
+    // unlabeled items are rendered with the background id so they still
+    // occlude labeled objects
+    uint32_t id = 0u;
+    uint32_t label = 0u;
+    VisualPtr labeledVisual = this->LabeledVisual(visual, label);
+    if (labeledVisual)
+    {
+      auto it = objectIndices.find(labeledVisual->Id());
+      if (it == objectIndices.end())
+      {
+        Object object;
+        object.visual = labeledVisual;
+        object.label = label;
+        this->objects.push_back(object);
+        it = objectIndices.emplace(labeledVisual->Id(),
+            static_cast<uint32_t>(this->objects.size() - 1u)).first;
+      }
+      id = it->second + 1u;
+    }
+
+    // encode the 24 bit id in the rgb channels
+    ItemId &itemId = this->itemIds[item];
+    itemId.visualId = visualId;
+    itemId.id = id;
+    itemId.color = Ogre::Vector4(
+        (id & 0xFF) / 255.0,
+        ((id >> 8) & 0xFF) / 255.0,
+        ((id >> 16) & 0xFF) / 255.0, 1.0);
+  }
+
+  this->itemIdsAssigned = true;
+  this->labelsRevision = this->scene->LabelsRevision();
+  this->itemsRevision = this->scene->VisibilityLayersRevision();
+}
+
+/////////////////////////////////////////////////
+void Ogre2BoundingBoxMaterialSwitcher::cameraPreRenderScene(
+    Ogre::Camera * /*_cam*/)
+{
+  IGN_PROFILE("Ogre2BoundingBoxMaterialSwitcher::cameraPreRenderScene");
+  // only reassign ids if the scene changed
+  if (this->ItemIdsDirty())
+    this->AssignItemIds();
+
+  this->datablockMap.clear();
+  this->hiddenItems.clear();
+  for (const auto &[item, itemId] : this->itemIds)
+  {
+    // an object rendered alone is not occluded by the other items
+    if (this->isolatedId != 0u && itemId.id != this->isolatedId)
+    {
+      if (item->getVisible())
+      {
+        item->setVisible(false);
+        this->hiddenItems.push_back(item);
+      }
+      continue;
+    }
+
+    for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
+    {
+      // save subitems material
+      Ogre::SubItem *subItem = item->getSubItem(i);
+      Ogre::HlmsDatablock *datablock = subItem->getDatablock();
+      this->datablockMap[subItem] = datablock;
+
+      // switch the material
+      subItem->setCustomParameter(1, itemId.color);
+
+      // check if it's an overlay material by assuming the
+      // depth check and depth write properties are off. Vertices deformed
+      // by a custom vertex shader are drawn deformed. An object rendered
+      // alone needs no depth testing either.
+      if (this->isolatedId != 0u ||
+          (!datablock->getMacroblock()->mDepthWrite &&
+          !datablock->getMacroblock()->mDepthCheck))
+      {
+        subItem->setMaterial(
+            DeformedMaterial(this->plainOverlayMaterial, subItem));
+      }
+      else
+      {
+        subItem->setMaterial(DeformedMaterial(this->plainMaterial, subItem));
+      }
+    }
+  }
+
+  // disable heightmaps since their material can't be switched
+  auto heightmaps = this->scene->Heightmaps();
+  for (auto h : heightmaps)
+  {
+    auto heightmap = h.lock();
+    if (heightmap)
+      heightmap->Parent()->SetVisible(false);
+  }
+}
+
+/////////////////////////////////////////////////
+void Ogre2BoundingBoxMaterialSwitcher::cameraPostRenderScene(
+    Ogre::Camera * /*_cam*/)
+{
+  IGN_PROFILE("Ogre2BoundingBoxMaterialSwitcher::cameraPostRenderScene");
+  // restore item to use pbs hlms material
+  for (const auto &[subItem, dataBlock] : this->datablockMap)
+    subItem->setDatablock(dataBlock);
+
+  for (auto item : this->hiddenItems)
+    item->setVisible(true);
+  this->hiddenItems.clear();
+
+  // re-enable heightmaps
+  auto heightmaps = this->scene->Heightmaps();
+  for (auto h : heightmaps)
+  {
+    auto heightmap = h.lock();
+    if (heightmap)
+      heightmap->Parent()->SetVisible(true);
+  }
+}
+
+/////////////////////////////////////////////////
+Ogre2BoundingBoxCamera::Ogre2BoundingBoxCamera() :
+  dataPtr(new Ogre2BoundingBoxCameraPrivate())
+{
+}
+
+/////////////////////////////////////////////////
+Ogre2BoundingBoxCamera::~Ogre2BoundingBoxCamera()
+{
+  this->Destroy();
+}
+
+/////////////////////////////////////////////////
+void Ogre2BoundingBoxCamera::Init()
+{
+  BaseCamera::Init();
+
+  this->CreateCamera();
+
+  this->CreateRenderTexture();
+
+  this->dataPtr->materialSwitcher.reset(
+      new Ogre2BoundingBoxMaterialSwitcher(this->scene));
+}
+
+/////////////////////////////////////////////////
+void Ogre2BoundingBoxCamera::Destroy()
+{
+  if (!this->ogreCamera)
+    return;
+
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  auto ogreCompMgr = ogreRoot->getCompositorManager2();
+  Ogre::TextureGpuManager *textureMgr =
+    ogreRoot->getRenderSystem()->getTextureGpuManager();
+
+  if (this->dataPtr->ogreCompositorWorkspace)
+  {
+    ogreCompMgr->removeWorkspace(
+        this->dataPtr->ogreCompositorWorkspace);
+    this->dataPtr->ogreCompositorWorkspace = nullptr;
+  }
+
+  if (!this->dataPtr->ogreCompositorWorkspaceDef.empty())
+  {
+    ogreCompMgr->removeWorkspaceDefinition(
+        this->dataPtr->ogreCompositorWorkspaceDef);
+    ogreCompMgr->removeNodeDefinition(
+        this->dataPtr->ogreCompositorNodeDef);
+    this->dataPtr->ogreCompositorWorkspaceDef.clear();
+    this->dataPtr->ogreCompositorNodeDef.clear();
+  }
+
+  if (this->dataPtr->idTicket)
+  {
+    textureMgr->destroyAsyncTextureTicket(this->dataPtr->idTicket);
+    this->dataPtr->idTicket = nullptr;
+  }
+
+  if (this->dataPtr->isolatedTicket)
+  {
+    textureMgr->destroyAsyncTextureTicket(this->dataPtr->isolatedTicket);
+    this->dataPtr->isolatedTicket = nullptr;
+  }
+
+  if (this->dataPtr->ogreIdTexture)
+  {
+    textureMgr->destroyTexture(this->dataPtr->ogreIdTexture);
+    this->dataPtr->ogreIdTexture = nullptr;
+  }
+
+  Ogre::SceneManager *ogreSceneManager = this->scene->OgreSceneManager();
+  if (ogreSceneManager == nullptr)
+  {
+    ignerr << "Scene manager cannot be obtained" << std::endl;
+  }
+  else
+  {
+    if (ogreSceneManager->findCameraNoThrow(this->name) != nullptr)
+    {
+      ogreSceneManager->destroyCamera(this->ogreCamera);
+      this->ogreCamera = nullptr;
+    }
+  }
+
+  this->dataPtr->materialSwitcher.reset();
+}
+
+/////////////////////////////////////////////////
+void Ogre2BoundingBoxCamera::PreRender()
+{
+  IGN_PROFILE("Ogre2BoundingBoxCamera::PreRender");
+  if (!this->dataPtr->ogreIdTexture)
+    this->CreateBoundingBoxTexture();
+
+  this->ogreCamera->setLodBias(this->LodBias());
+}
+
+/////////////////////////////////////////////////
+void Ogre2BoundingBoxCamera::CreateCamera()
+{
+  auto ogreSceneManager = this->scene->OgreSceneManager();
+  if (ogreSceneManager == nullptr)
+  {
+    ignerr << "Scene manager cannot be obtained" << std::endl;
+    return;
+  }
+
+  this->ogreCamera = ogreSceneManager->createCamera(this->Name());
+  if (this->ogreCamera == nullptr)
+  {
+    ignerr << "Ogre camera cannot be created" << std::endl;
+    return;
+  }
+
+  this->ogreCamera->detachFromParent();
+  this->ogreNode->attachObject(this->ogreCamera);
+
+  // rotate to ignition gazebo coord.
+  this->ogreCamera->yaw(Ogre::Degree(-90));
+  this->ogreCamera->roll(Ogre::Degree(-90));
+  this->ogreCamera->setFixedYawAxis(false);
+
+  this->ogreCamera->setAutoAspectRatio(true);
+  this->ogreCamera->setRenderingDistance(100);
+  this->ogreCamera->setProjectionType(Ogre::ProjectionType::PT_PERSPECTIVE);
+  this->ogreCamera->setCustomProjectionMatrix(false);
+}
+
+/////////////////////////////////////////////////
+void Ogre2BoundingBoxCamera::CreateBoundingBoxTexture()
+{
+  // Camera Parameters
+  this->ogreCamera->setNearClipDistance(this->NearClipPlane());
+  this->ogreCamera->setFarClipDistance(this->FarClipPlane());
+  this->ogreCamera->setAspectRatio(this->AspectRatio());
+  double vfov = 2.0 * atan(tan(this->HFOV().Radian() / 2.0) /
+    this->AspectRatio());
+  this->ogreCamera->setFOVy(Ogre::Radian(vfov));
+
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+
+  Ogre::PixelFormatGpu ogrePF = Ogre::PFG_RGBA8_UNORM;
+
+  // id 0 is the background
+  std::string wsDefName = "BoundingBoxCameraWorkspace_" + this->Name();
+  ogreCompMgr->createBasicWorkspaceDef(wsDefName,
+      Ogre::ColourValue(0.0, 0.0, 0.0, 1.0));
+  this->dataPtr->ogreCompositorWorkspaceDef = wsDefName;
+  this->dataPtr->ogreCompositorNodeDef = wsDefName + "/Node";
+
+  Ogre::TextureGpuManager *textureMgr =
+    ogreRoot->getRenderSystem()->getTextureGpuManager();
+  this->dataPtr->ogreIdTexture =
+    textureMgr->createOrRetrieveTexture(this->Name() + "_bounding_box_id",
+      Ogre::GpuPageOutStrategy::SaveToSystemRam,
+      Ogre::TextureFlags::RenderToTexture,
+      Ogre::TextureTypes::Type2D);
+
+  this->dataPtr->ogreIdTexture->setResolution(
+      this->ImageWidth(), this->ImageHeight());
+  this->dataPtr->ogreIdTexture->setNumMipmaps(1u);
+  this->dataPtr->ogreIdTexture->setPixelFormat(ogrePF);
+  this->dataPtr->ogreIdTexture->scheduleTransitionTo(
+    Ogre::GpuResidency::Resident);
+
+  this->dataPtr->idTicket = textureMgr->createAsyncTextureTicket(
+      this->ImageWidth(), this->ImageHeight(), 1u,
+      Ogre::TextureTypes::Type2D, ogrePF);
+  this->dataPtr->isolatedTicket = textureMgr->createAsyncTextureTicket(
+      this->ImageWidth(), this->ImageHeight(), 1u,
+      Ogre::TextureTypes::Type2D, ogrePF);
+
+  // create compositor worksspace
+  this->dataPtr->ogreCompositorWorkspace =
+      ogreCompMgr->addWorkspace(
+        this->scene->OgreSceneManager(),
+        this->dataPtr->ogreIdTexture,
+        this->ogreCamera,
+        wsDefName,
+        false);
+  this->AddPassProfilers(this->dataPtr->ogreCompositorWorkspace);
+
+  this->ogreCamera->addListener(
+    this->dataPtr->materialSwitcher.get());
+}
+
+/////////////////////////////////////////////////
+void Ogre2BoundingBoxCamera::Render()
+{
+  IGN_PROFILE("Ogre2BoundingBoxCamera::Render");
+  this->RecordFrameSubmit();
+  this->BeginPassProfilers();
+
+  // update the compositors
+  this->scene->StartRendering(nullptr);
+  this->UpdateWorkspace();
+
+  // queue the readback right after rendering, it is mapped in PostRender
+  this->dataPtr->idTicket->download(this->dataPtr->ogreIdTexture, 0u, true);
+  this->dataPtr->downloadPending = true;
+
+  this->scene->FlushGpuCommandsAndStartNewFrame(1u, false);
+}
+
+/////////////////////////////////////////////////
+void Ogre2BoundingBoxCamera::UpdateWorkspace()
+{
+  this->dataPtr->ogreCompositorWorkspace->_validateFinalTarget();
+  this->dataPtr->ogreCompositorWorkspace->_beginUpdate(false);
+  this->dataPtr->ogreCompositorWorkspace->_update();
+  this->dataPtr->ogreCompositorWorkspace->_endUpdate(false);
+
+  Ogre::vector<Ogre::TextureGpu*>::type swappedTargets;
+  swappedTargets.reserve(2u);
+  this->dataPtr->ogreCompositorWorkspace->_swapFinalTarget(swappedTargets);
+}
+
+/////////////////////////////////////////////////
+unsigned int Ogre2BoundingBoxCamera::UnoccludedPixelCount(uint32_t _id)
+{
+  IGN_PROFILE("Ogre2BoundingBoxCamera::UnoccludedPixelCount");
+  this->dataPtr->materialSwitcher->SetIsolatedId(_id);
+  this->scene->StartRendering(nullptr);
+  this->UpdateWorkspace();
+  this->dataPtr->materialSwitcher->SetIsolatedId(0u);
+
+  Ogre::AsyncTextureTicket *ticket = this->dataPtr->isolatedTicket;
+  ticket->download(this->dataPtr->ogreIdTexture, 0u, true);
+  this->scene->FlushGpuCommandsAndStartNewFrame(1u, false);
+
+  const int width = static_cast<int>(this->ImageWidth());
+  const int height = static_cast<int>(this->ImageHeight());
+  Ogre::TextureBox box = ticket->map(0u);
+  const uint8_t *data = static_cast<const uint8_t *>(box.data);
+  unsigned int count = 0u;
+  for (int y = 0; y < height; ++y)
+  {
+    const uint8_t *row = data + y * box.bytesPerRow;
+    for (int x = 0; x < width; ++x)
+    {
+      const uint8_t *pixel = row + x * 4;
+      uint32_t id = pixel[0] | (pixel[1] << 8) | (pixel[2] << 16);
+      if (id == _id)
+        ++count;
+    }
+  }
+  ticket->unmap();
+  return count;
+}
+
+/////////////////////////////////////////////////
+void Ogre2BoundingBoxCamera::PostRender()
+{
+  IGN_PROFILE("Ogre2BoundingBoxCamera::PostRender");
+  if (!this->dataPtr->downloadPending)
+  {
+    this->RecordFrameDropped();
+    return;
+  }
+  this->dataPtr->downloadPending = false;
+
+  Ogre::TextureBox box = this->dataPtr->idTicket->map(0u);
+  this->RecordFrameGpuComplete();
+  this->ComputeBoundingBoxes(box);
+  this->dataPtr->idTicket->unmap();
+
+  this->RecordFrameReadback();
+  IGN_PROFILE_BEGIN("Dispatch newBoundingBoxes");
+  this->dataPtr->newBoundingBoxes(this->boundingBoxes);
+  IGN_PROFILE_END();
+  this->RecordFrameDelivered();
+}
+
+/////////////////////////////////////////////////
+void Ogre2BoundingBoxCamera::ComputeBoundingBoxes(
+    const Ogre::TextureBox &_box)
+{
+  this->boundingBoxes.clear();
+
+  const auto &objects = this->dataPtr->materialSwitcher->Objects();
+  const int width = static_cast<int>(this->ImageWidth());
+  const int height = static_cast<int>(this->ImageHeight());
+
+  // visible 2d box and pixel count of each object, found in a single pass
+  // over the id buffer regardless of the number of objects
+  struct ObjectPixels
+  {
+    int minX = std::numeric_limits<int>::max();
+    int minY = std::numeric_limits<int>::max();
+    int maxX = -1;
+    int maxY = -1;
+    unsigned int count = 0u;
+  };
+  std::vector<ObjectPixels> pixels(objects.size());
+
+  const uint8_t *data = static_cast<const uint8_t *>(_box.data);
+  for (int y = 0; y < height; ++y)
+  {
+    const uint8_t *row = data + y * _box.bytesPerRow;
+    for (int x = 0; x < width; ++x)
+    {
+      const uint8_t *pixel = row + x * 4;
+      uint32_t id = pixel[0] | (pixel[1] << 8) | (pixel[2] << 16);
+      if (id == 0u || id > pixels.size())
+        continue;
+
+      ObjectPixels &p = pixels[id - 1u];
+      p.minX = std::min(p.minX, x);
+      p.minY = std::min(p.minY, y);
+      p.maxX = std::max(p.maxX, x);
+      p.maxY = std::max(p.maxY, y);
+      ++p.count;
+    }
+  }
+
+  const math::Pose3d cameraPose = this->WorldPose();
+  const math::Quaterniond cameraRotInv = cameraPose.Rot().Inverse();
+
+  for (size_t i = 0u; i < objects.size(); ++i)
+  {
+    const ObjectPixels &p = pixels[i];
+    if (p.count == 0u)
+      continue;
+
+    VisualPtr visual = objects[i].visual.lock();
+    if (!visual)
+      continue;
+
+    const math::AxisAlignedBox localBox = visual->LocalBoundingBox();
+    const math::Pose3d visualPose = visual->WorldPose();
+
+    BoundingBox boundingBox;
+    boundingBox.SetLabel(objects[i].label);
+
+    // full 2d box from the projected corners of the 3d box. Fall back to the
+    // visible box if part of the object is behind the camera.
+    int fullMinX = p.minX;
+    int fullMinY = p.minY;
+    int fullMaxX = p.maxX;
+    int fullMaxY = p.maxY;
+    bool behind = false;
+    int projMinX = std::numeric_limits<int>::max();
+    int projMinY = std::numeric_limits<int>::max();
+    int projMaxX = std::numeric_limits<int>::min();
+    int projMaxY = std::numeric_limits<int>::min();
+    for (unsigned int c = 0u; c < 8u; ++c)
+    {
+      math::Vector3d corner(
+          (c & 1u) ? localBox.Max().X() : localBox.Min().X(),
+          (c & 2u) ? localBox.Max().Y() : localBox.Min().Y(),
+          (c & 4u) ? localBox.Max().Z() : localBox.Min().Z());
+      math::Vector3d worldCorner =
+          visualPose.Pos() + visualPose.Rot() * corner;
+      math::Vector3d cameraCorner =
+          cameraRotInv * (worldCorner - cameraPose.Pos());
+      if (cameraCorner.X() < this->NearClipPlane())
+      {
+        behind = true;
+        break;
+      }
+      math::Vector2i proj = this->Project(worldCorner);
+      projMinX = std::min(projMinX, proj.X());
+      projMinY = std::min(projMinY, proj.Y());
+      projMaxX = std::max(projMaxX, proj.X());
+      projMaxY = std::max(projMaxY, proj.Y());
+    }
+    if (!behind)
+    {
+      fullMinX = std::max(0, std::min(projMinX, p.minX));
+      fullMinY = std::max(0, std::min(projMinY, p.minY));
+      fullMaxX = std::min(width - 1, std::max(projMaxX, p.maxX));
+      fullMaxY = std::min(height - 1, std::max(projMaxY, p.maxY));
+    }
+
+    // the visible pixels over the pixels the object covers when nothing
+    // occludes it, counted by rendering it alone
+    unsigned int unoccluded = this->UnoccludedPixelCount(
+        static_cast<uint32_t>(i + 1u));
+    boundingBox.SetVisibleRatio(std::min(1.0,
+        static_cast<double>(p.count) / std::max(1u, unoccluded)));
+
+    if (this->type == BoundingBoxType::BBT_VISIBLEBOX2D)
+    {
+      boundingBox.SetCenter(math::Vector3d(
+          (p.minX + p.maxX) * 0.5, (p.minY + p.maxY) * 0.5, 0.0));
+      boundingBox.SetSize(math::Vector3d(
+          p.maxX - p.minX, p.maxY - p.minY, 0.0));
+    }
+    else if (this->type == BoundingBoxType::BBT_FULLBOX2D)
+    {
+      boundingBox.SetCenter(math::Vector3d(
+          (fullMinX + fullMaxX) * 0.5, (fullMinY + fullMaxY) * 0.5, 0.0));
+      boundingBox.SetSize(math::Vector3d(
+          fullMaxX - fullMinX, fullMaxY - fullMinY, 0.0));
+    }
+    else if (this->type == BoundingBoxType::BBT_BOX3D)
+    {
+      math::Vector3d worldCenter =
+          visualPose.Pos() + visualPose.Rot() * localBox.Center();
+      boundingBox.SetCenter(cameraRotInv * (worldCenter - cameraPose.Pos()));
+      boundingBox.SetOrientation(cameraRotInv * visualPose.Rot());
+      boundingBox.SetSize(localBox.Size());
+    }
+
+    this->boundingBoxes.push_back(boundingBox);
+  }
+}
+
+/////////////////////////////////////////////////
+ignition::common::ConnectionPtr
+  Ogre2BoundingBoxCamera::ConnectNewBoundingBoxes(
+  std::function<void(const std::vector<BoundingBox> &)> _subscriber)
+{
+  return this->dataPtr->newBoundingBoxes.Connect(_subscriber);
+}
+
+/////////////////////////////////////////////////
+void Ogre2BoundingBoxCamera::DrawBoundingBox(unsigned char *_data,
+  const math::Color &_color, const BoundingBox &_box) const
+{
+  const int width = static_cast<int>(this->ImageWidth());
+  const int height = static_cast<int>(this->ImageHeight());
+
+  if (this->type == BoundingBoxType::BBT_BOX3D)
+  {
+    // project the corners of the box, which is in the camera frame
+    const math::Pose3d cameraPose = this->WorldPose();
+    math::Vector2i corners[8];
+    for (unsigned int c = 0u; c < 8u; ++c)
+    {
+      math::Vector3d corner(
+          (c & 1u) ? 0.5 : -0.5,
+          (c & 2u) ? 0.5 : -0.5,
+          (c & 4u) ? 0.5 : -0.5);
+      math::Vector3d cameraCorner =
+          _box.Center() + _box.Orientation() * (corner * _box.Size());
+      if (cameraCorner.X() <= 0.0)
+        return;
+      corners[c] = this->Project(
+          cameraPose.Pos() + cameraPose.Rot() * cameraCorner);
+    }
+
+    // edges connect corners that differ in one axis
+    for (unsigned int c = 0u; c < 8u; ++c)
+    {
+      for (unsigned int axis = 1u; axis < 8u; axis <<= 1u)
+      {
+        unsigned int other = c | axis;
+        if (other == c)
+          continue;
+        DrawLine(_data, width, height, _color,
+            corners[c].X(), corners[c].Y(),
+            corners[other].X(), corners[other].Y());
+      }
+    }
+    return;
+  }
+
+  int minX = static_cast<int>(_box.Center().X() - _box.Size().X() * 0.5);
+  int minY = static_cast<int>(_box.Center().Y() - _box.Size().Y() * 0.5);
+  int maxX = static_cast<int>(_box.Center().X() + _box.Size().X() * 0.5);
+  int maxY = static_cast<int>(_box.Center().Y() + _box.Size().Y() * 0.5);
+  DrawLine(_data, width, height, _color, minX, minY, maxX, minY);
+  DrawLine(_data, width, height, _color, maxX, minY, maxX, maxY);
+  DrawLine(_data, width, height, _color, maxX, maxY, minX, maxY);
+  DrawLine(_data, width, height, _color, minX, maxY, minX, minY);
+}
+
+/////////////////////////////////////////////////
+RenderTargetPtr Ogre2BoundingBoxCamera::RenderTarget() const
+{
+  return this->dataPtr->renderTexture;
+}
+
+/////////////////////////////////////////////////
+void Ogre2BoundingBoxCamera::CreateRenderTexture()
+{
+  RenderTexturePtr base = this->scene->CreateRenderTexture();
+  this->dataPtr->renderTexture =
+    std::dynamic_pointer_cast<Ogre2RenderTexture>(base);
+  this->dataPtr->renderTexture->SetWidth(1);
+  this->dataPtr->renderTexture->SetHeight(1);
+}
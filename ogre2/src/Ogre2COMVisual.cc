@@ -35,8 +35,15 @@ class ignition::rendering::Ogre2COMVisualPrivate
   /// \brief Lines that make the cross marking the center of mass.
   public: std::shared_ptr<Ogre2DynamicRenderable> crossLines = nullptr;
 
+  /// \brief True if the material is a copy made for this visual, false if
+  /// it is shared, e.g. the scene's default material
+  public: bool ownsMaterial = false;
+
   /// \brief Sphere visual marking the center of mass
   public: VisualPtr sphereVis = nullptr;
+
+  /// \brief Material cloned for the sphere visual
+  public: MaterialPtr sphereMaterial = nullptr;
 };
 
 using namespace ignition;
@@ -83,17 +90,24 @@ void Ogre2COMVisual::Destroy()
     this->dataPtr->sphereVis.reset();
   }
 
+  if (this->dataPtr->sphereMaterial && this->Scene())
+  {
+    this->Scene()->DestroyMaterial(this->dataPtr->sphereMaterial);
+    this->dataPtr->sphereMaterial.reset();
+  }
+
   if (this->dataPtr->crossLines)
   {
     this->dataPtr->crossLines->Destroy();
     this->dataPtr->crossLines.reset();
   }
 
-  if (this->dataPtr->material && this->Scene())
+  if (this->dataPtr->material && this->dataPtr->ownsMaterial &&
+      this->Scene())
   {
     this->Scene()->DestroyMaterial(this->dataPtr->material);
-    this->dataPtr->material.reset();
   }
+  this->dataPtr->material.reset();
 }
 
 //////////////////////////////////////////////////
@@ -111,6 +125,7 @@ void Ogre2COMVisual::CreateVisual()
     this->dataPtr->sphereVis = this->Scene()->CreateVisual();
     this->dataPtr->sphereVis->AddGeometry(this->Scene()->CreateSphere());
     this->dataPtr->sphereVis->SetMaterial("Default/CoM");
+    this->dataPtr->sphereMaterial = this->dataPtr->sphereVis->Material();
     this->dataPtr->sphereVis->SetInheritScale(false);
     this->AddChild(this->dataPtr->sphereVis);
   }
@@ -135,8 +150,8 @@ void Ogre2COMVisual::CreateVisual()
   if (!this->dataPtr->material)
   {
     MaterialPtr COMVisualMaterial =
-        this->Scene()->Material("Default/TransGreen")->Clone();
-    this->SetMaterial(COMVisualMaterial, false);
+        this->Scene()->Material("Default/TransGreen");
+    this->SetMaterial(COMVisualMaterial, true);
   }
 
   // CoM position indicator
@@ -191,7 +206,14 @@ void Ogre2COMVisual::SetMaterial(MaterialPtr _material, bool _unique)
 
   // Set material for the underlying dynamic renderable
   this->dataPtr->crossLines->SetMaterial(_material, false);
+
+  if (this->dataPtr->material && this->dataPtr->ownsMaterial &&
+      this->dataPtr->material != derived)
+  {
+    this->Scene()->DestroyMaterial(this->dataPtr->material);
+  }
   this->SetMaterialImpl(derived);
+  this->dataPtr->ownsMaterial = _unique;
 }
 
 //////////////////////////////////////////////////
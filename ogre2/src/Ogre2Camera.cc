@@ -15,6 +15,14 @@
  *
  */
 
+#include <algorithm>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ignition/common/Profiler.hh>
+
 #include "ignition/rendering/ogre2/Ogre2Camera.hh"
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTarget.hh"
@@ -22,6 +30,11 @@
 #include "ignition/rendering/ogre2/Ogre2SelectionBuffer.hh"
 #include "ignition/rendering/Utils.hh"
 
+#include "Ogre2DrawCounter.hh"
+#include "Ogre2GpuTimer.hh"
+#include "Ogre2ObjectId.hh"
+#include "Ogre2OcclusionCuller.hh"
+
 #ifdef _MSC_VER
   #pragma warning(push, 0)
 #endif
@@ -35,11 +48,64 @@
 /// \brief Private data for the Ogre2Camera class
 class ignition::rendering::Ogre2CameraPrivate
 {
+  /// \brief Pose of each view relative to the camera
+  public: std::vector<math::Pose3d> viewPoses;
+
+  /// \brief Ogre camera of each view, empty if the camera renders a single
+  /// view
+  public: std::vector<Ogre::Camera *> viewCameras;
+
+  /// \brief True if the views share the shadow maps of the first view
+  public: bool shareViewShadows = false;
+
+  /// \brief Number of columns of the view grid, 0 for a single row
+  public: unsigned int viewColumns = 0u;
+
+  /// \brief Render textures of the recently captured region sizes, most
+  /// recently used first
+  public: std::list<Ogre2RenderTexturePtr> regionTextures;
+
+  /// \brief Maximum number of region render textures kept around
+  public: static constexpr unsigned int kMaxRegionTextures = 4u;
 };
 
 using namespace ignition;
 using namespace rendering;
 
+//////////////////////////////////////////////////
+/// \brief Get the segmentation label of the geometry that wrote an object
+/// id
+/// \param[in] _scene Scene of the geometry
+/// \param[in] _objectId Object id read from a render target
+/// \param[in] _backgroundLabel Label of geometry without label
+/// \return Label of the visuals of the object id, the background label if
+/// they have different labels
+static int ObjectIdLabel(const ScenePtr &_scene, uint32_t _objectId,
+    int _backgroundLabel)
+{
+  std::vector<unsigned int> visualIds;
+  if (!ObjectIdVisuals(_objectId, visualIds))
+    return _backgroundLabel;
+
+  int label = _backgroundLabel;
+  for (size_t i = 0u; i < visualIds.size(); ++i)
+  {
+    int visualLabel = _backgroundLabel;
+    VisualPtr visual = _scene->VisualById(visualIds[i]);
+    if (visual)
+    {
+      Variant labelAny = visual->UserData("label");
+      if (const int *value = std::get_if<int>(&labelAny))
+        visualLabel = *value;
+    }
+
+    if (i > 0u && visualLabel != label)
+      return _backgroundLabel;
+    label = visualLabel;
+  }
+  return label;
+}
+
 //////////////////////////////////////////////////
 Ogre2Camera::Ogre2Camera()
   : dataPtr(std::make_unique<Ogre2CameraPrivate>())
@@ -64,6 +130,14 @@ void Ogre2Camera::Destroy()
   {
     ignerr << "Scene manager cannot be obtained" << std::endl;
   }
+  for (auto viewCamera : this->dataPtr->viewCameras)
+    ogreSceneManager->destroyCamera(viewCamera);
+  this->dataPtr->viewCameras.clear();
+
+  for (auto &regionTexture : this->dataPtr->regionTextures)
+    regionTexture->Destroy();
+  this->dataPtr->regionTextures.clear();
+
   if (ogreSceneManager->findCameraNoThrow(this->name) != nullptr)
   {
     ogreSceneManager->destroyCamera(this->ogreCamera);
@@ -139,9 +213,137 @@ void Ogre2Camera::SetMaterial(const MaterialPtr &_material)
 //////////////////////////////////////////////////
 void Ogre2Camera::Render()
 {
+  IGN_PROFILE("Ogre2Camera::Render");
+  // the scene may have changed since the selection buffer was read back
+  if (this->selectionBuffer)
+    this->selectionBuffer->SetDirty();
+
+  // views use the projection of this camera
+  for (auto viewCamera : this->dataPtr->viewCameras)
+  {
+    viewCamera->setProjectionType(this->ogreCamera->getProjectionType());
+    viewCamera->setNearClipDistance(this->ogreCamera->getNearClipDistance());
+    viewCamera->setFarClipDistance(this->ogreCamera->getFarClipDistance());
+    viewCamera->setLodBias(this->ogreCamera->getLodBias());
+    viewCamera->setFOVy(this->ogreCamera->getFOVy());
+    viewCamera->setCustomProjectionMatrix(
+        this->ogreCamera->isCustomProjectionMatrixEnabled(),
+        this->ogreCamera->getProjectionMatrix());
+  }
+
+  // warp the last rendered frame instead of rendering a new one
+  this->frameReprojected = this->NextFrameReprojected(
+      this->renderTexture->CanReproject());
+  if (this->frameReprojected && this->renderTexture->Reproject())
+    return;
+  this->frameReprojected = false;
+
+  this->BeginPassProfilers();
   this->renderTexture->Render();
 }
 
+//////////////////////////////////////////////////
+bool Ogre2Camera::CaptureRegion(unsigned int _x, unsigned int _y,
+    Image &_image)
+{
+  IGN_PROFILE("Ogre2Camera::CaptureRegion");
+  if (!this->ValidRegion(_x, _y, _image))
+    return false;
+
+  // the views have projections of their own
+  if (!this->dataPtr->viewCameras.empty())
+    return BaseCamera::CaptureRegion(_x, _y, _image);
+
+  this->scene->PreRender();
+
+  Ogre2RenderTexturePtr regionTexture =
+      this->RegionTexture(_image.Width(), _image.Height());
+  regionTexture->PreRender();
+
+  // restrict the frustum to the region, like the selection buffer does for
+  // its single pixel. The region texture would change the aspect ratio of
+  // the camera, so it is restored afterwards
+  bool customProjection = this->ogreCamera->isCustomProjectionMatrixEnabled();
+  Ogre::Real aspectRatio = this->ogreCamera->getAspectRatio();
+  this->ogreCamera->setAspectRatio(static_cast<Ogre::Real>(
+      static_cast<double>(this->ImageWidth()) / this->ImageHeight()));
+  Ogre::Matrix4 projectionMatrix = this->ogreCamera->getProjectionMatrix();
+
+  float width = static_cast<float>(this->ImageWidth());
+  float height = static_cast<float>(this->ImageHeight());
+  float x1 = static_cast<float>(_x) / width - 0.5f;
+  float y1 = static_cast<float>(_y) / height - 0.5f;
+  float x2 = static_cast<float>(_x + _image.Width()) / width - 0.5f;
+  float y2 = static_cast<float>(_y + _image.Height()) / height - 0.5f;
+
+  Ogre::Matrix4 scaleMatrix = Ogre::Matrix4::IDENTITY;
+  Ogre::Matrix4 transMatrix = Ogre::Matrix4::IDENTITY;
+  scaleMatrix[0][0] = 1.0 / (x2-x1);
+  scaleMatrix[1][1] = 1.0 / (y2-y1);
+  transMatrix[0][3] -= x1+x2;
+  transMatrix[1][3] += y1+y2;
+  this->ogreCamera->setCustomProjectionMatrix(true,
+      scaleMatrix * transMatrix * projectionMatrix);
+
+  regionTexture->Render();
+
+  this->ogreCamera->setCustomProjectionMatrix(customProjection,
+      projectionMatrix);
+  this->ogreCamera->setAspectRatio(aspectRatio);
+
+  regionTexture->PostRender();
+  if (!this->scene->LegacyAutoGpuFlush())
+    this->scene->PostRender();
+
+  regionTexture->Copy(_image);
+  return true;
+}
+
+//////////////////////////////////////////////////
+Ogre2RenderTexturePtr Ogre2Camera::RegionTexture(unsigned int _width,
+    unsigned int _height)
+{
+  auto &regionTextures = this->dataPtr->regionTextures;
+  Ogre2RenderTexturePtr regionTexture;
+  for (auto it = regionTextures.begin(); it != regionTextures.end(); ++it)
+  {
+    if ((*it)->Width() == _width && (*it)->Height() == _height)
+    {
+      regionTexture = *it;
+      regionTextures.erase(it);
+      break;
+    }
+  }
+
+  if (!regionTexture)
+  {
+    if (regionTextures.size() >= this->dataPtr->kMaxRegionTextures)
+    {
+      regionTextures.back()->Destroy();
+      regionTextures.pop_back();
+    }
+
+    RenderTexturePtr base = this->scene->CreateRenderTexture();
+    regionTexture = std::dynamic_pointer_cast<Ogre2RenderTexture>(base);
+    regionTexture->SetCamera(this->ogreCamera);
+    regionTexture->SetFormat(PF_R8G8B8);
+    regionTexture->SetWidth(_width);
+    regionTexture->SetHeight(_height);
+  }
+  regionTextures.push_front(regionTexture);
+
+  // follow the settings of the camera render texture
+  if (regionTexture->BackgroundColor() != this->BackgroundColor())
+    regionTexture->SetBackgroundColor(this->BackgroundColor());
+  if (regionTexture->BackgroundMaterial() != this->BackgroundMaterial())
+    regionTexture->SetBackgroundMaterial(this->BackgroundMaterial());
+  if (regionTexture->AntiAliasing() != this->AntiAliasing())
+    regionTexture->SetAntiAliasing(this->AntiAliasing());
+  regionTexture->SetVisibilityMask(this->visibilityMask);
+  regionTexture->SetShadowsEnabled(this->shadowsEnabled);
+  return regionTexture;
+}
+
 //////////////////////////////////////////////////
 RenderTargetPtr Ogre2Camera::RenderTarget() const
 {
@@ -177,6 +379,7 @@ void Ogre2Camera::CreateCamera()
   this->ogreCamera->setAutoAspectRatio(true);
   this->ogreCamera->setProjectionType(Ogre::PT_PERSPECTIVE);
   this->ogreCamera->setCustomProjectionMatrix(false);
+  this->ogreCamera->setLodBias(this->LodBias());
 }
 
 //////////////////////////////////////////////////
@@ -190,6 +393,15 @@ void Ogre2Camera::CreateRenderTexture()
   this->renderTexture->SetHeight(this->ImageHeight());
   this->renderTexture->SetBackgroundColor(this->scene->BackgroundColor());
   this->renderTexture->SetVisibilityMask(this->visibilityMask);
+  this->renderTexture->SetShadowsEnabled(this->shadowsEnabled);
+  this->renderTexture->SetResolutionScale(this->resolutionScale);
+  this->renderTexture->SetReprojectionEnabled(
+      this->reprojectionInterval > 1u);
+  this->renderTexture->SetObjectIdEnabled(this->objectIdPicking);
+  this->renderTexture->SetDepthQueryEnabled(this->depthPicking);
+  this->renderTexture->AddWorkspaceListener(this->GpuTimer());
+  this->renderTexture->AddWorkspaceListener(this->DrawCounter());
+  this->renderTexture->AddWorkspaceListener(this->OcclusionCuller());
 }
 
 //////////////////////////////////////////////////
@@ -207,12 +419,117 @@ unsigned int Ogre2Camera::RenderTextureGLId() const
   return rt->GLId();
 }
 
+//////////////////////////////////////////////////
+void Ogre2Camera::RenderTextureMetalId(void *_textureIdPtr) const
+{
+  if (!this->renderTexture)
+    return;
+
+  Ogre2RenderTexturePtr rt =
+      std::dynamic_pointer_cast<Ogre2RenderTexture>(this->renderTexture);
+
+  if (!rt)
+    return;
+
+  rt->MetalId(_textureIdPtr);
+}
+
 //////////////////////////////////////////////////
 void Ogre2Camera::SetShadowsDirty()
 {
   this->SetShadowsNodeDefDirty();
 }
 
+//////////////////////////////////////////////////
+void Ogre2Camera::SetShadowsEnabled(bool _enabled)
+{
+  BaseCamera::SetShadowsEnabled(_enabled);
+  if (this->renderTexture)
+    this->renderTexture->SetShadowsEnabled(_enabled);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Camera::SetResolutionScale(double _scale)
+{
+  this->resolutionScale = std::clamp(_scale, this->minResolutionScale, 1.0);
+  if (this->renderTexture)
+    this->renderTexture->SetResolutionScale(this->resolutionScale);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Camera::SetReprojectionInterval(unsigned int _interval)
+{
+  this->reprojectionInterval = std::max(_interval, 1u);
+  this->reprojectionCounter = 0u;
+  if (this->renderTexture)
+  {
+    this->renderTexture->SetReprojectionEnabled(
+        this->reprojectionInterval > 1u);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2Camera::SetObjectIdPickingEnabled(bool _enabled)
+{
+  this->objectIdPicking = _enabled;
+  if (this->renderTexture)
+    this->renderTexture->SetObjectIdEnabled(_enabled);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Camera::SetDepthPickingEnabled(bool _enabled)
+{
+  this->depthPicking = _enabled;
+  if (this->renderTexture)
+    this->renderTexture->SetDepthQueryEnabled(_enabled);
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Camera::DepthAt(const math::Vector2i &_pos, double &_depth)
+{
+  if (!this->depthPicking || !this->renderTexture)
+    return false;
+
+  return this->renderTexture->DepthAt(_pos.X(), _pos.Y(), _depth);
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Camera::CopyDepth(float *_depth)
+{
+  if (!this->depthPicking || !this->renderTexture)
+    return false;
+
+  return this->renderTexture->CopyDepth(_depth);
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Camera::CopyLabels(int *_labels, int _backgroundLabel)
+{
+  IGN_PROFILE("Ogre2Camera::CopyLabels");
+  if (!_labels || !this->objectIdPicking || !this->renderTexture)
+    return false;
+
+  std::vector<uint32_t> objectIds(
+      this->ImageWidth() * this->ImageHeight());
+  if (!this->renderTexture->CopyObjectIds(objectIds.data()))
+    return false;
+
+  // a frame shows few distinct objects, resolve the label of each once
+  std::unordered_map<uint32_t, int> labels;
+  labels[0u] = _backgroundLabel;
+  for (size_t i = 0u; i < objectIds.size(); ++i)
+  {
+    auto it = labels.find(objectIds[i]);
+    if (it == labels.end())
+    {
+      it = labels.emplace(objectIds[i], ObjectIdLabel(
+          this->scene, objectIds[i], _backgroundLabel)).first;
+    }
+    _labels[i] = it->second;
+  }
+  return true;
+}
+
 //////////////////////////////////////////////////
 void Ogre2Camera::SetShadowsNodeDefDirty()
 {
@@ -226,6 +543,90 @@ void Ogre2Camera::SetShadowsNodeDefDirty()
     rt->SetShadowsNodeDefDirty();
 }
 
+//////////////////////////////////////////////////
+void Ogre2Camera::SetViewPoses(const std::vector<math::Pose3d> &_poses)
+{
+  // views that all look in the same direction can share the shadow maps
+  bool shareShadows = true;
+  for (const auto &pose : _poses)
+  {
+    if (pose.Rot() != _poses[0].Rot())
+      shareShadows = false;
+  }
+
+  // only move the views if the workspace doesn't change, e.g. for views
+  // that follow moving cameras every frame
+  Ogre::SceneManager *ogreSceneManager = this->scene->OgreSceneManager();
+  const bool rebuild = _poses.size() != this->dataPtr->viewCameras.size() ||
+      shareShadows != this->dataPtr->shareViewShadows;
+  if (rebuild)
+  {
+    for (auto viewCamera : this->dataPtr->viewCameras)
+      ogreSceneManager->destroyCamera(viewCamera);
+    this->dataPtr->viewCameras.clear();
+  }
+  this->dataPtr->viewPoses = _poses;
+  this->dataPtr->shareViewShadows = shareShadows;
+
+  for (unsigned int i = 0u; i < _poses.size(); ++i)
+  {
+    Ogre::Camera *viewCamera = nullptr;
+    if (rebuild)
+    {
+      viewCamera = ogreSceneManager->createCamera(
+          this->name + "_view_" + std::to_string(i));
+      viewCamera->detachFromParent();
+      this->ogreNode->attachObject(viewCamera);
+      viewCamera->setFixedYawAxis(false);
+      viewCamera->setAutoAspectRatio(true);
+      this->dataPtr->viewCameras.push_back(viewCamera);
+    }
+    else
+    {
+      viewCamera = this->dataPtr->viewCameras[i];
+    }
+
+    // apply the view pose on top of the rotation to Gazebo coordinate system
+    viewCamera->setPosition(Ogre2Conversions::Convert(_poses[i].Pos()));
+    viewCamera->setOrientation(Ogre2Conversions::Convert(_poses[i].Rot()) *
+        this->ogreCamera->getOrientation());
+  }
+
+  if (rebuild)
+  {
+    this->renderTexture->SetViewCameras(this->dataPtr->viewCameras,
+        shareShadows, this->dataPtr->viewColumns);
+  }
+  this->SetRenderDirty();
+}
+
+//////////////////////////////////////////////////
+std::vector<math::Pose3d> Ogre2Camera::ViewPoses() const
+{
+  return this->dataPtr->viewPoses;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Camera::SetViewColumns(unsigned int _columns)
+{
+  if (_columns == this->dataPtr->viewColumns)
+    return;
+
+  this->dataPtr->viewColumns = _columns;
+  if (!this->dataPtr->viewCameras.empty())
+  {
+    this->renderTexture->SetViewCameras(this->dataPtr->viewCameras,
+        this->dataPtr->shareViewShadows, _columns);
+  }
+  this->SetRenderDirty();
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2Camera::ViewColumns() const
+{
+  return this->dataPtr->viewColumns;
+}
+
 //////////////////////////////////////////////////
 void Ogre2Camera::SetSelectionBuffer()
 {
@@ -244,6 +645,25 @@ VisualPtr Ogre2Camera::VisualAt(const ignition::math::Vector2i &_mousePos)
 {
   VisualPtr result;
 
+  float ratio = screenScalingFactor();
+  ignition::math::Vector2i mousePos(
+      static_cast<int>(std::rint(ratio * _mousePos.X())),
+      static_cast<int>(std::rint(ratio * _mousePos.Y())));
+
+  // answer from the object ids of the last rendered frame if the object
+  // can be told from its id
+  uint32_t objectId = 0u;
+  if (this->objectIdPicking && this->renderTexture &&
+      this->renderTexture->ObjectIdAt(mousePos.X(), mousePos.Y(), objectId))
+  {
+    if (objectId == 0u)
+      return result;
+
+    unsigned int visualId = 0u;
+    if (ObjectIdVisual(objectId, visualId))
+      return this->scene->VisualById(visualId);
+  }
+
   if (!this->selectionBuffer)
   {
     this->SetSelectionBuffer();
@@ -259,10 +679,6 @@ VisualPtr Ogre2Camera::VisualAt(const ignition::math::Vector2i &_mousePos)
       this->ImageWidth(), this->ImageHeight());
   }
 
-  float ratio = screenScalingFactor();
-  ignition::math::Vector2i mousePos(
-      static_cast<int>(std::rint(ratio * _mousePos.X())),
-      static_cast<int>(std::rint(ratio * _mousePos.Y())));
   Ogre::Item *ogreItem = this->selectionBuffer->OnSelectionClick(
       mousePos.X(), mousePos.Y());
 
@@ -287,6 +703,65 @@ VisualPtr Ogre2Camera::VisualAt(const ignition::math::Vector2i &_mousePos)
   return result;
 }
 
+//////////////////////////////////////////////////
+std::vector<VisualPtr> Ogre2Camera::VisualsAt(
+    const std::vector<ignition::math::Vector2i> &_mousePos)
+{
+  std::vector<VisualPtr> result(_mousePos.size());
+
+  if (!this->selectionBuffer)
+  {
+    this->SetSelectionBuffer();
+
+    if (!this->selectionBuffer)
+    {
+      return result;
+    }
+  }
+  else
+  {
+    this->selectionBuffer->SetDimensions(
+      this->ImageWidth(), this->ImageHeight());
+  }
+
+  float ratio = screenScalingFactor();
+  std::vector<ignition::math::Vector2i> mousePos;
+  mousePos.reserve(_mousePos.size());
+  for (const auto &pos : _mousePos)
+  {
+    mousePos.push_back(ignition::math::Vector2i(
+        static_cast<int>(std::rint(ratio * pos.X())),
+        static_cast<int>(std::rint(ratio * pos.Y()))));
+  }
+
+  std::vector<Ogre::Item *> ogreItems;
+  std::vector<math::Vector3d> points;
+  if (!this->selectionBuffer->ExecuteQueries(mousePos, ogreItems, points))
+    return result;
+
+  for (unsigned int i = 0; i < ogreItems.size(); ++i)
+  {
+    Ogre::Item *ogreItem = ogreItems[i];
+    if (ogreItem &&
+        !ogreItem->getUserObjectBindings().getUserAny().isEmpty() &&
+        ogreItem->getUserObjectBindings().getUserAny().getType() ==
+        typeid(unsigned int))
+    {
+      try
+      {
+        result[i] = this->scene->VisualById(Ogre::any_cast<unsigned int>(
+              ogreItem->getUserObjectBindings().getUserAny()));
+      }
+      catch(Ogre::Exception &e)
+      {
+        ignerr << "Ogre Error:" << e.getFullDescription() << "\n";
+      }
+    }
+  }
+
+  return result;
+}
+
 //////////////////////////////////////////////////
 RenderWindowPtr Ogre2Camera::CreateRenderWindow()
 {
@@ -346,12 +821,29 @@ void Ogre2Camera::SetFarClipPlane(const double _far)
   this->ogreCamera->setFarClipDistance(_far);
 }
 
+//////////////////////////////////////////////////
+void Ogre2Camera::SetLodBias(double _bias)
+{
+  BaseCamera::SetLodBias(_bias);
+  this->ogreCamera->setLodBias(this->LodBias());
+}
+
 //////////////////////////////////////////////////
 Ogre::Camera *Ogre2Camera::OgreCamera() const
 {
   return ogreCamera;
 }
 
+//////////////////////////////////////////////////
+Ogre::TextureGpu *Ogre2Camera::DepthTextureFor(
+    const Ogre::Camera *_camera) const
+{
+  if (!this->depthPicking || !this->renderTexture)
+    return nullptr;
+
+  return this->renderTexture->DepthTextureFor(_camera);
+}
+
 //////////////////////////////////////////////////
 void Ogre2Camera::SetVisibilityMask(uint32_t _mask)
 {
@@ -16,14 +16,17 @@
  */
 
 #include <cmath>
+#include <mutex>
 
 #include <ignition/common/Mesh.hh>
 #include <ignition/common/MeshManager.hh>
 
+#include "ignition/rendering/Utils.hh"
 #include "ignition/rendering/ogre2/Ogre2Capsule.hh"
 #include "ignition/rendering/ogre2/Ogre2Material.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
 #include "ignition/rendering/ogre2/Ogre2Mesh.hh"
+#include "ignition/rendering/ogre2/Ogre2MeshFactory.hh"
 #include "ignition/rendering/ogre2/Ogre2Visual.hh"
 
 class ignition::rendering::Ogre2CapsulePrivate
@@ -33,6 +36,9 @@ class ignition::rendering::Ogre2CapsulePrivate
 
   /// \brief Mesh Object for capsule shape
   public: Ogre2MeshPtr ogreMesh{nullptr};
+
+  /// \brief Descriptor of the mesh, retained in the mesh factory
+  public: MeshDescriptor meshDescriptor;
 };
 
 using namespace ignition;
@@ -79,6 +85,10 @@ void Ogre2Capsule::Destroy()
   {
     this->dataPtr->ogreMesh->Destroy();
     this->dataPtr->ogreMesh.reset();
+
+    auto ogreScene = std::dynamic_pointer_cast<Ogre2Scene>(this->Scene());
+    if (ogreScene && ogreScene->MeshFactory())
+      ogreScene->MeshFactory()->ReleaseMesh(this->dataPtr->meshDescriptor);
   }
 
   if (this->dataPtr->material && this->Scene())
@@ -91,24 +101,44 @@ void Ogre2Capsule::Destroy()
 //////////////////////////////////////////////////
 void Ogre2Capsule::Update()
 {
-  common::MeshManager *meshMgr = common::MeshManager::Instance();
   std::string capsuleMeshName = "capsule_mesh";
   capsuleMeshName += "_" + std::to_string(this->radius)
       + "_" + std::to_string(this->length);
 
-  // Create new mesh if needed
-  if (!meshMgr->HasMesh(capsuleMeshName))
+  // capsules with the same dimensions share their mesh, so the mesh is
+  // only replaced when the dimensions change
+  if (this->dataPtr->ogreMesh &&
+      this->dataPtr->meshDescriptor.meshName == capsuleMeshName)
   {
-    meshMgr->CreateCapsule(capsuleMeshName, this->radius, this->length, 32, 32);
+    return;
   }
 
   MeshDescriptor meshDescriptor;
-  meshDescriptor.mesh = meshMgr->MeshByName(capsuleMeshName);
+  {
+    std::lock_guard<std::recursive_mutex> lock(meshManagerMutex());
+    common::MeshManager *meshMgr = common::MeshManager::Instance();
+
+    // Create new mesh if needed
+    if (!meshMgr->HasMesh(capsuleMeshName))
+    {
+      meshMgr->CreateCapsule(capsuleMeshName, this->radius, this->length,
+          32, 32);
+    }
+    meshDescriptor.mesh = meshMgr->MeshByName(capsuleMeshName);
+  }
   if (meshDescriptor.mesh == nullptr)
   {
     ignerr << "Capsule mesh is unavailable in the Mesh Manager" << std::endl;
     return;
   }
+  meshDescriptor.Load();
+
+  auto ogreScene = std::dynamic_pointer_cast<Ogre2Scene>(this->Scene());
+  Ogre2MeshPtr ogreMesh = std::dynamic_pointer_cast<Ogre2Mesh>(
+      this->Scene()->CreateMesh(meshDescriptor));
+  if (!ogreMesh)
+    return;
+  ogreScene->MeshFactory()->RetainMesh(meshDescriptor);
 
   auto visual = std::dynamic_pointer_cast<Ogre2Visual>(this->Parent());
 
@@ -121,9 +151,10 @@ void Ogre2Capsule::Update()
           std::dynamic_pointer_cast<Geometry>(shared_from_this()));
     }
     this->dataPtr->ogreMesh->Destroy();
+    ogreScene->MeshFactory()->ReleaseMesh(this->dataPtr->meshDescriptor);
   }
-  this->dataPtr->ogreMesh = std::dynamic_pointer_cast<Ogre2Mesh>(
-      this->Scene()->CreateMesh(meshDescriptor));
+  this->dataPtr->ogreMesh = ogreMesh;
+  this->dataPtr->meshDescriptor = meshDescriptor;
   if (this->dataPtr->material != nullptr)
   {
     this->dataPtr->ogreMesh->SetMaterial(this->dataPtr->material, false);
@@ -56,6 +56,13 @@ const Ogre::PixelFormatGpu Ogre2Conversions::ogrePixelFormats[PF_COUNT] =
       Ogre::PFG_R16_UNORM,
       // PF_R8G8B8A8
       Ogre::PFG_RGBA8_UNORM,
+      // PF_FLOAT16_R
+      Ogre::PFG_R16_FLOAT,
+      // PF_FLOAT16_RGB, padded to 4 channels since ogre has no 3 channel
+      // 16 bit formats. Images keep 3 channels, see Ogre2RenderTarget::Copy
+      Ogre::PFG_RGBA16_FLOAT,
+      // PF_UINT16_RGB, padded to 4 channels as above
+      Ogre::PFG_RGBA16_UINT,
     };
 
 //////////////////////////////////////////////////
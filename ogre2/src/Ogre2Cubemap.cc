@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+
+#include "Ogre2Cubemap.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreCamera.h>
+#include <OgreRenderSystem.h>
+#include <OgreRoot.h>
+#include <OgreStagingTexture.h>
+#include <OgreTextureBox.h>
+#include <OgreTextureGpu.h>
+#include <OgreTextureGpuManager.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+namespace ignition
+{
+namespace rendering
+{
+inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+//
+//////////////////////////////////////////////////
+math::Vector2d CubemapFaceUv(const math::Vector3d &_v,
+    unsigned int &_faceIndex)
+{
+  math::Vector3d vAbs = _v.Abs();
+  double ma;
+  math::Vector2d uv;
+  if (vAbs.Z() >= vAbs.X() && vAbs.Z() >= vAbs.Y())
+  {
+    _faceIndex = _v.Z() < 0.0 ? 5.0 : 4.0;
+    ma = 0.5 / vAbs.Z();
+    uv = math::Vector2d(_v.Z() < 0.0 ? -_v.X() : _v.X(), -_v.Y());
+  }
+  else if (vAbs.Y() >= vAbs.X())
+  {
+    _faceIndex = _v.Y() < 0.0 ? 3.0 : 2.0;
+    ma = 0.5 / vAbs.Y();
+    uv = math::Vector2d(_v.X(), _v.Y() < 0.0 ? -_v.Z() : _v.Z());
+  }
+  else
+  {
+    _faceIndex = _v.X() < 0.0 ? 1.0 : 0.0;
+    ma = 0.5 / vAbs.X();
+    uv = math::Vector2d(_v.X() < 0.0 ? _v.Z() : -_v.Z(), -_v.Y());
+  }
+  return uv * ma + 0.5;
+}
+
+//////////////////////////////////////////////////
+void OrientCubemapCamera(Ogre::Camera *_camera, unsigned int _face)
+{
+  _camera->setFOVy(Ogre::Degree(90));
+  _camera->setAspectRatio(1);
+  _camera->setFixedYawAxis(false);
+  _camera->yaw(Ogre::Degree(-90));
+  _camera->roll(Ogre::Degree(-90));
+
+  // orient camera to create cubemap
+  if (_face == 0)
+    _camera->yaw(Ogre::Degree(-90));
+  else if (_face == 1)
+    _camera->yaw(Ogre::Degree(90));
+  else if (_face == 2)
+    _camera->pitch(Ogre::Degree(90));
+  else if (_face == 3)
+    _camera->pitch(Ogre::Degree(-90));
+  else if (_face == 5)
+    _camera->yaw(Ogre::Degree(180));
+}
+
+//////////////////////////////////////////////////
+Ogre::TextureGpu *CreateLookupTexture(const std::string &_name,
+    unsigned int _width, unsigned int _height, float *_data)
+{
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::TextureGpuManager *textureMgr =
+    ogreRoot->getRenderSystem()->getTextureGpuManager();
+  Ogre::TextureGpu *texture =
+    textureMgr->createOrRetrieveTexture(
+      _name,
+      Ogre::GpuPageOutStrategy::SaveToSystemRam,
+      Ogre::TextureFlags::ManualTexture,
+      Ogre::TextureTypes::Type2D,
+      Ogre::BLANKSTRING,
+      0u);
+
+  texture->setTextureType(Ogre::TextureTypes::Type2D);
+  texture->setResolution(_width, _height);
+  texture->setNumMipmaps(1u);
+  texture->setPixelFormat(Ogre::PFG_RGBA32_FLOAT);
+
+  const size_t bytesPerRow = texture->_getSysRamCopyBytesPerRow(0);
+
+  texture->_transitionTo(
+    Ogre::GpuResidency::Resident,
+    reinterpret_cast<Ogre::uint8*>(_data));
+  texture->_setNextResidencyStatus(Ogre::GpuResidency::Resident);
+  // We have to upload the data via a StagingTexture, which acts as an
+  // intermediate stash memory that is both visible to CPU and GPU.
+  Ogre::StagingTexture *stagingTexture = textureMgr->getStagingTexture(
+    texture->getWidth(),
+    texture->getHeight(),
+    texture->getDepth(),
+    texture->getNumSlices(),
+    texture->getPixelFormat());
+  stagingTexture->startMapRegion();
+  // Map region of the staging texture. This function can be called from
+  // any thread after startMapRegion has already been called.
+  Ogre::TextureBox texBox = stagingTexture->mapRegion(
+    texture->getWidth(),
+    texture->getHeight(),
+    texture->getDepth(),
+    texture->getNumSlices(),
+    texture->getPixelFormat());
+
+  texBox.copyFrom(
+    _data,
+    texture->getWidth(),
+    texture->getHeight(),
+    bytesPerRow);
+  stagingTexture->stopMapRegion();
+  stagingTexture->upload(texBox, texture, 0, 0, 0, true);
+  // Tell the TextureGpuManager we're done with this StagingTexture.
+  // Otherwise it will leak.
+  textureMgr->removeStagingTexture(stagingTexture);
+  stagingTexture = 0;
+  // Do not free the pointer if texture's paging strategy is
+  // GpuPageOutStrategy::AlwaysKeepSystemRamCopy
+  texture->notifyDataIsReady();
+  return texture;
+}
+}
+}
+}
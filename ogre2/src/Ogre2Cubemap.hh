@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2CUBEMAP_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2CUBEMAP_HH_
+
+#include <string>
+
+#include <ignition/math/Vector2.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "ignition/rendering/config.hh"
+
+namespace Ogre
+{
+  class Camera;
+  class TextureGpu;
+}
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // Helpers shared by the sensors that render the scene to the faces of a
+    // cubemap in a 1st pass and resample it in a 2nd pass, i.e. gpu rays
+    // and wide angle cameras. The cubemap is constructed using z-up,
+    // x-forward, y-left:
+    // index: face   axis
+    //     0: right  -y
+    //     1: left   +y
+    //     2: top    +z
+    //     3: bottom -z
+    //     4: front  +x
+    //     5: back   -x
+
+    /// \brief Convert a direction to the index of the cubemap face it
+    /// points at and texture uv coordinates on that face
+    /// \param[in] _v Direction in the frame of a standard Y up cubemap,
+    /// i.e. x right, y up, z forward
+    /// \param[out] _faceIndex Index of face to sample
+    /// \return Texture UV coordinates on the face indicated by _faceIndex
+    math::Vector2d CubemapFaceUv(const math::Vector3d &_v,
+        unsigned int &_faceIndex);
+
+    /// \brief Orient a camera attached to a sensor node to render a cubemap
+    /// face, and give it the 90 degree fov of the faces
+    /// \param[in] _camera Camera to orient
+    /// \param[in] _face Index of the face
+    void OrientCubemapCamera(Ogre::Camera *_camera, unsigned int _face);
+
+    /// \brief Create a texture the 2nd pass looks up per pixel sampling
+    /// data in, e.g. the face and uv coordinates to sample the cubemap at
+    /// \param[in] _name Name of the texture
+    /// \param[in] _width Width of the texture
+    /// \param[in] _height Height of the texture
+    /// \param[in] _data RGBA32_FLOAT data of the texture, allocated with
+    /// OGRE_MALLOC_SIMD. The texture takes ownership of it
+    /// \return The texture
+    Ogre::TextureGpu *CreateLookupTexture(const std::string &_name,
+        unsigned int _width, unsigned int _height, float *_data);
+    }
+  }
+}
+#endif
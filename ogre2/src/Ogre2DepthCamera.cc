@@ -33,8 +33,17 @@
 #endif
 
 #include <math.h>
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <vector>
+#include <ignition/common/Profiler.hh>
 #include <ignition/math/Helpers.hh>
+#include <ignition/math/Matrix3.hh>
+#include <ignition/math/Pose3.hh>
 
+#include "ignition/rendering/DepthCompression.hh"
+#include "ignition/rendering/FrameRecorder.hh"
 #include "ignition/rendering/RenderTypes.hh"
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2DepthCamera.hh"
@@ -47,7 +56,9 @@
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
 #include "ignition/rendering/ogre2/Ogre2Sensor.hh"
 
+#include "Ogre2OcclusionCuller.hh"
 #include "Ogre2ParticleNoiseListener.hh"
+#include "Ogre2WorkerPool.hh"
 
 namespace ignition
 {
@@ -112,9 +123,16 @@ class ignition::rendering::Ogre2DepthCameraPrivate
   /// \brief Compositor workspace.
   public: Ogre::CompositorWorkspace *ogreCompositorWorkspace = nullptr;
 
-  /// \brief Output texture with depth and color data
+  /// \brief Output texture with depth and color data. Only the second
+  /// one exists while the workspace is single pass.
   public: Ogre::TextureGpu *ogreDepthTexture[2];
 
+  /// \brief True if the depth material writes straight into
+  /// ogreDepthTexture[1], without the final pass. The depth material
+  /// already clamps to the near and far planes, so the final pass is only
+  /// needed to clamp again after render passes, e.g. noise.
+  public: bool singlePass = false;
+
   /// \brief Dummy render texture for the depth data
   public: RenderTexturePtr depthTexture;
 
@@ -156,6 +174,102 @@ class ignition::rendering::Ogre2DepthCameraPrivate
 
   /// \brief Name of shadow compositor node
   public: const std::string kShadowNodeName = "PbsMaterialsShadowNode";
+
+  /// \brief Static shadows revision the workspace was last updated with
+  /// \sa Ogre2Scene::UpdateStaticShadowMaps
+  public: uint64_t staticShadowsRevision = 0u;
+
+  /// \brief Event used to signal zero-copy depth data views
+  public: ignition::common::EventT<void(const float *,
+              unsigned int, unsigned int, unsigned int, unsigned int,
+              const std::string &)> newDepthFrameView;
+
+  /// \brief Event used to signal zero-copy rgb point cloud data views
+  public: ignition::common::EventT<void(const float *,
+              unsigned int, unsigned int, unsigned int, unsigned int,
+              const std::string &)> newRgbPointCloudView;
+
+  /// \brief True to read back only the depth channel when there are no
+  /// point cloud subscribers
+  public: bool depthOnlyReadback = false;
+
+  /// \brief Single channel texture holding the depth channel extracted
+  /// from ogreDepthTexture[1]
+  public: Ogre::TextureGpu *ogreDepthOnlyTexture = nullptr;
+
+  /// \brief Workspace that extracts the depth channel into
+  /// ogreDepthOnlyTexture
+  public: Ogre::CompositorWorkspace *ogreDepthOnlyWorkspace = nullptr;
+
+  /// \brief Depth only compositor workspace definition
+  public: std::string ogreDepthOnlyWorkspaceDef;
+
+  /// \brief Depth only compositor node definition
+  public: std::string ogreDepthOnlyNodeDef;
+
+  /// \brief Execution mask of the passes rendering the color texture, which
+  /// is only needed for point clouds
+  public: static const uint8_t kColorExecutionMask = 0x02;
+
+  /// \brief Instance of the compositor workspace that skips the color
+  /// passes, and with them the shadow maps and the sky. Used instead of
+  /// ogreCompositorWorkspace while only depth is read back
+  public: Ogre::CompositorWorkspace *ogreNoColorWorkspace = nullptr;
+
+  /// \brief True to read back depth data asynchronously
+  public: bool asyncReadback = false;
+
+  /// \brief Format depth data is encoded to
+  /// \sa DepthCamera::SetDepthOutputFormat
+  public: PixelFormat depthOutputFormat = PF_FLOAT32_R;
+
+  /// \brief Event used to signal encoded depth data
+  public: ignition::common::EventT<void(const void *,
+              unsigned int, unsigned int, unsigned int,
+              const std::string &)> newEncodedDepthFrame;
+
+  /// \brief Event used to signal compressed millimeter depth data
+  public: ignition::common::EventT<void(const uint8_t *, size_t)>
+              newCompressedDepthFrame;
+
+  /// \brief Compressed depth handed to newCompressedDepthFrame subscribers
+  public: std::vector<uint8_t> compressedDepth;
+
+  /// \brief Depth decoded from the encoded depth only texture, or extracted
+  /// from the full output to be encoded on the CPU
+  public: float *decodedDepth = nullptr;
+
+  /// \brief Depth encoded on the CPU while point clouds are read back
+  public: uint16_t *encodedDepth = nullptr;
+
+  /// \brief Pixel format of the texture the async readback tickets were
+  /// created for
+  public: Ogre::PixelFormatGpu readbackTicketsFormat = Ogre::PFG_UNKNOWN;
+
+  /// \brief Number of async readback tickets in the ring buffer
+  public: static const unsigned int kNumReadbackTickets = 2u;
+
+  /// \brief Ring buffer of tickets used to download the final depth
+  /// texture without stalling the CPU
+  public: Ogre::AsyncTextureTicket *readbackTickets[kNumReadbackTickets] =
+      {nullptr, nullptr};
+
+  /// \brief Indices into readbackTickets of downloads that have been
+  /// issued but not yet processed, oldest first
+  public: std::deque<unsigned int> pendingReadbacks;
+
+  /// \brief Index of the ticket to use for the next download
+  public: unsigned int nextReadbackTicket = 0u;
+
+  /// \brief Output of the last rendered frame, 4 floats per pixel, which
+  /// reprojected frames are warped from
+  public: std::vector<float> keyFrame;
+
+  /// \brief World pose of the camera when keyFrame was rendered
+  public: math::Pose3d keyFramePose;
+
+  /// \brief Output of the last reprojected frame
+  public: std::vector<float> reprojectedFrame;
 };
 
 using namespace ignition;
@@ -300,9 +414,25 @@ void Ogre2DepthCamera::Destroy()
     this->dataPtr->pointCloudImage = nullptr;
   }
 
+  if (this->dataPtr->decodedDepth)
+  {
+    delete [] this->dataPtr->decodedDepth;
+    this->dataPtr->decodedDepth = nullptr;
+  }
+
+  if (this->dataPtr->encodedDepth)
+  {
+    delete [] this->dataPtr->encodedDepth;
+    this->dataPtr->encodedDepth = nullptr;
+  }
+
   if (!this->ogreCamera)
     return;
 
+  this->DestroyReadbackTickets();
+  this->DestroyDepthOnlyWorkspace();
+  this->DestroyNoColorWorkspace();
+
   auto engine = Ogre2RenderEngine::Instance();
   auto ogreRoot = engine->OgreRoot();
   Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
@@ -609,6 +739,10 @@ void Ogre2DepthCamera::CreateDepthTexture()
     baseNodeDef->addTextureSourceName(
           "rt1", 1u, Ogre::TextureDefinitionBase::TEXTURE_INPUT);
 
+    // the scene textures are scaled with the resolution scale, the depth
+    // material samples them over the full size of rt0
+    const float scale = static_cast<float>(this->resolutionScale);
+
     Ogre::TextureDefinitionBase::TextureDefinition *depthTexDef =
         baseNodeDef->addTextureDefinition("depthTexture");
     depthTexDef->textureType = Ogre::TextureTypes::Type2D;
@@ -616,8 +750,8 @@ void Ogre2DepthCamera::CreateDepthTexture()
     depthTexDef->height = 0;
     depthTexDef->depthOrSlices = 1;
     depthTexDef->numMipmaps = 0;
-    depthTexDef->widthFactor = 1;
-    depthTexDef->heightFactor = 1;
+    depthTexDef->widthFactor = scale;
+    depthTexDef->heightFactor = scale;
     depthTexDef->format = Ogre::PFG_D32_FLOAT;
     depthTexDef->textureFlags &= ~Ogre::TextureFlags::Uav;
     depthTexDef->depthBufferId = Ogre::DepthBuffer::POOL_DEFAULT;
@@ -635,8 +769,8 @@ void Ogre2DepthCamera::CreateDepthTexture()
     colorTexDef->height = 0;
     colorTexDef->depthOrSlices = 1;
     colorTexDef->numMipmaps = 0;
-    colorTexDef->widthFactor = 1;
-    colorTexDef->heightFactor = 1;
+    colorTexDef->widthFactor = scale;
+    colorTexDef->heightFactor = scale;
     colorTexDef->format = Ogre::PFG_RGBA8_UNORM_SRGB;
     // Note we are using low level materials in quad pass so also had to perform
     // gamma correction in the fragment shaders (depth_camera_fs.glsl)
@@ -657,8 +791,8 @@ void Ogre2DepthCamera::CreateDepthTexture()
     particleTexDef->height = 0;
     particleTexDef->depthOrSlices = 1;
     particleTexDef->numMipmaps = 0;
-    particleTexDef->widthFactor = 0.5;
-    particleTexDef->heightFactor = 0.5;
+    particleTexDef->widthFactor = 0.5f * scale;
+    particleTexDef->heightFactor = 0.5f * scale;
     particleTexDef->format = Ogre::PFG_R8_UNORM;
     particleTexDef->textureFlags &= ~Ogre::TextureFlags::Uav;
     particleTexDef->depthBufferId = Ogre::DepthBuffer::POOL_DEFAULT;
@@ -673,8 +807,8 @@ void Ogre2DepthCamera::CreateDepthTexture()
     particleDepthTexDef->height = 0;
     particleDepthTexDef->depthOrSlices = 1;
     particleDepthTexDef->numMipmaps = 0;
-    particleDepthTexDef->widthFactor = 0.5;
-    particleDepthTexDef->heightFactor = 0.5;
+    particleDepthTexDef->widthFactor = 0.5f * scale;
+    particleDepthTexDef->heightFactor = 0.5f * scale;
     particleDepthTexDef->format = Ogre::PFG_D32_FLOAT;
     particleDepthTexDef->depthBufferId = Ogre::DepthBuffer::POOL_NON_SHAREABLE;
     particleDepthTexDef->depthBufferFormat = Ogre::PFG_UNKNOWN;
@@ -703,11 +837,13 @@ void Ogre2DepthCamera::CreateDepthTexture()
         Ogre::CompositorPassSceneDef *passScene =
             static_cast<Ogre::CompositorPassSceneDef *>(
             colorTargetDef->addPass(Ogre::PASS_SCENE));
-        passScene->mShadowNode = this->dataPtr->kShadowNodeName;
+        if (this->shadowsEnabled)
+          passScene->mShadowNode = this->dataPtr->kShadowNodeName;
         passScene->mVisibilityMask = IGN_VISIBILITY_ALL;
         passScene->mIncludeOverlays = false;
         passScene->mFirstRQ = 0u;
         passScene->mLastRQ = 2u;
+        passScene->mExecutionMask = this->dataPtr->kColorExecutionMask;
         if (!validBackground)
         {
           passScene->setAllLoadActions(Ogre::LoadAction::Clear);
@@ -727,6 +863,7 @@ void Ogre2DepthCamera::CreateDepthTexture()
             + this->Name();
         passQuad->mFrustumCorners =
             Ogre::CompositorPassQuadDef::CAMERA_DIRECTION;
+        passQuad->mExecutionMask = this->dataPtr->kColorExecutionMask;
 
         passQuad->setAllLoadActions(Ogre::LoadAction::Clear);
         passQuad->setAllClearColours(Ogre::ColourValue(
@@ -741,8 +878,10 @@ void Ogre2DepthCamera::CreateDepthTexture()
         passScene->mVisibilityMask = IGN_VISIBILITY_ALL;
         // todo(anyone) PbsMaterialsShadowNode is hardcoded.
         // Although this may be just fine
-        passScene->mShadowNode = this->dataPtr->kShadowNodeName;
+        if (this->shadowsEnabled)
+          passScene->mShadowNode = this->dataPtr->kShadowNodeName;
         passScene->mFirstRQ = 2u;
+        passScene->mExecutionMask = this->dataPtr->kColorExecutionMask;
       }
     }
 
@@ -754,6 +893,8 @@ void Ogre2DepthCamera::CreateDepthTexture()
       Ogre::CompositorPassSceneDef *passScene =
           static_cast<Ogre::CompositorPassSceneDef *>(
           depthTargetDef->addPass(Ogre::PASS_SCENE));
+      // unlit pass, skip building the Forward+ light clusters
+      passScene->mEnableForwardPlus = false;
       passScene->setAllLoadActions(Ogre::LoadAction::Clear);
       passScene->setAllClearColours(Ogre::ColourValue(
         this->FarClipPlane(),
@@ -802,6 +943,8 @@ void Ogre2DepthCamera::CreateDepthTexture()
           Ogre::CompositorPassQuadDef::VIEW_SPACE_CORNERS;
     }
 
+    // rt0 is the readback texture in a single pass workspace, which binds
+    // the same texture to both channels and leaves rt1 unused
     baseNodeDef->mapOutputChannel(0, "rt0");
     baseNodeDef->mapOutputChannel(1, "rt1");
 
@@ -867,12 +1010,17 @@ void Ogre2DepthCamera::CreateDepthTexture()
     //   connect_output DepthCameraFinal 0
     //   connect DepthCamera 0 DepthCameraFinal 1
     // }
+    //
+    // Without render passes, the final node is left out, see
+    // Ogre2DepthCameraPrivate::singlePass
     Ogre::CompositorWorkspaceDef *workDef =
         ogreCompMgr->addWorkspaceDefinition(wsDefName);
 
     workDef->connectExternal(0, baseNodeDefName, 0);
     workDef->connectExternal(1, baseNodeDefName, 1);
-    workDef->connect(baseNodeDefName, finalNodeDefName);
+    this->dataPtr->singlePass = this->dataPtr->renderPasses.empty();
+    if (!this->dataPtr->singlePass)
+      workDef->connect(baseNodeDefName, finalNodeDefName);
   }
   Ogre::CompositorWorkspaceDef *wsDef =
       ogreCompMgr->getWorkspaceDefinition(wsDefName);
@@ -883,11 +1031,25 @@ void Ogre2DepthCamera::CreateDepthTexture()
            << " for " << this->Name();
   }
 
+  this->CreateDepthTargets();
+  CreateWorkspaceInstance();
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::CreateDepthTargets()
+{
+  auto engine = Ogre2RenderEngine::Instance();
   Ogre::TextureGpuManager *textureMgr =
-    ogreRoot->getRenderSystem()->getTextureGpuManager();
+    engine->OgreRoot()->getRenderSystem()->getTextureGpuManager();
   // create render texture - these textures pack the range data
   for (size_t i = 0u; i < 2u; ++i)
   {
+    if (this->dataPtr->ogreDepthTexture[i] ||
+        (i == 0u && this->dataPtr->singlePass))
+    {
+      continue;
+    }
+
     this->dataPtr->ogreDepthTexture[i] =
         textureMgr->createTexture(
           this->Name() + "_depth" + std::to_string(i),
@@ -904,8 +1066,50 @@ void Ogre2DepthCamera::CreateDepthTexture()
       this->dataPtr->ogreDepthTexture[i]->scheduleTransitionTo(
         Ogre::GpuResidency::Resident);
   }
+}
 
-  CreateWorkspaceInstance();
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::DisableSinglePass()
+{
+  this->dataPtr->singlePass = false;
+
+  // the workspaces bind the readback texture to both channels
+  this->DestroyDepthOnlyWorkspace();
+  this->DestroyNoColorWorkspace();
+  this->SetShadowsNodeDefDirty();
+
+  auto engine = Ogre2RenderEngine::Instance();
+  Ogre::CompositorManager2 *ogreCompMgr =
+      engine->OgreRoot()->getCompositorManager2();
+  Ogre::CompositorWorkspaceDef *workDef =
+      ogreCompMgr->getWorkspaceDefinition(
+      this->dataPtr->ogreCompositorWorkspaceDef);
+  workDef->connect(this->dataPtr->ogreCompositorBaseNodeDef,
+      this->dataPtr->ogreCompositorFinalNodeDef);
+  this->dataPtr->renderPassDirty = true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::ReleaseResources()
+{
+  this->DestroyReadbackTickets();
+  this->DestroyDepthOnlyWorkspace();
+  this->DestroyNoColorWorkspace();
+  this->SetShadowsNodeDefDirty();
+
+  auto engine = Ogre2RenderEngine::Instance();
+  Ogre::TextureGpuManager *textureMgr =
+      engine->OgreRoot()->getRenderSystem()->getTextureGpuManager();
+  for (size_t i = 0u; i < 2u; ++i)
+  {
+    if (!this->dataPtr->ogreDepthTexture[i])
+      continue;
+    textureMgr->destroyTexture(this->dataPtr->ogreDepthTexture[i]);
+    this->dataPtr->ogreDepthTexture[i] = nullptr;
+  }
+
+  // the particle noise listener is added again with the render passes
+  this->dataPtr->renderPassDirty = true;
 }
 
 //////////////////////////////////////////////////
@@ -917,7 +1121,9 @@ void Ogre2DepthCamera::CreateWorkspaceInstance()
 
   Ogre::CompositorChannelVec externalTargets(2u);
 
-  externalTargets[0] = this->dataPtr->ogreDepthTexture[0];
+  // a single pass workspace renders straight into the readback texture
+  externalTargets[0] = this->dataPtr->singlePass ?
+      this->dataPtr->ogreDepthTexture[1] : this->dataPtr->ogreDepthTexture[0];
   externalTargets[1] = this->dataPtr->ogreDepthTexture[1];
 
   // create compositor worksspace
@@ -928,9 +1134,16 @@ void Ogre2DepthCamera::CreateWorkspaceInstance()
           this->ogreCamera,
           this->dataPtr->ogreCompositorWorkspaceDef,
           false);
+  this->dataPtr->staticShadowsRevision = 0u;
 
   this->dataPtr->ogreCompositorWorkspace->addListener(
     engine->TerraWorkspaceListener());
+  this->AddPassProfilers(this->dataPtr->ogreCompositorWorkspace);
+  if (this->OcclusionCuller())
+  {
+    this->dataPtr->ogreCompositorWorkspace->addListener(
+        this->OcclusionCuller());
+  }
 
   // add the listener
   Ogre::CompositorNode *node =
@@ -956,6 +1169,21 @@ void Ogre2DepthCamera::CreateWorkspaceInstance()
 //////////////////////////////////////////////////
 void Ogre2DepthCamera::Render()
 {
+  IGN_PROFILE("Ogre2DepthCamera::Render");
+  this->RecordFrameSubmit();
+
+  // reprojected frames are warped from the last rendered one in PostRender
+  size_t frameSize =
+      static_cast<size_t>(this->ImageWidth()) * this->ImageHeight() * 4u;
+  this->frameReprojected =
+      this->NextFrameReprojected(this->dataPtr->keyFrame.size() == frameSize);
+  if (this->frameReprojected)
+    return;
+
+  // the GPU resources are allocated when the camera first renders
+  if (!this->dataPtr->ogreDepthTexture[1])
+    this->PrepareRender();
+
   // GL_DEPTH_CLAMP was disabled in later version of ogre2.2
   // however our shaders rely on clamped values so enable it for this sensor
   auto engine = Ogre2RenderEngine::Instance();
@@ -967,17 +1195,50 @@ void Ogre2DepthCamera::Render()
     glEnable(GL_DEPTH_CLAMP);
 #endif
 
+  this->BeginPassProfilers();
+
   this->scene->StartRendering(this->ogreCamera);
 
+  // the color texture is only read back for point clouds, so skip the color
+  // passes, and with them the shadow maps, when only depth is read back
+  Ogre::CompositorWorkspace *workspace =
+      this->dataPtr->ogreCompositorWorkspace;
+  if (this->ReadDepthOnly())
+  {
+    if (!this->dataPtr->ogreNoColorWorkspace)
+      this->CreateNoColorWorkspace();
+    workspace = this->dataPtr->ogreNoColorWorkspace;
+  }
+  else
+  {
+    this->scene->UpdateStaticShadowMaps(workspace,
+        this->dataPtr->staticShadowsRevision);
+  }
+
   // update the compositors
-  this->dataPtr->ogreCompositorWorkspace->_validateFinalTarget();
-  this->dataPtr->ogreCompositorWorkspace->_beginUpdate(false);
-  this->dataPtr->ogreCompositorWorkspace->_update();
-  this->dataPtr->ogreCompositorWorkspace->_endUpdate(false);
+  workspace->_validateFinalTarget();
+  workspace->_beginUpdate(false);
+  workspace->_update();
+  workspace->_endUpdate(false);
 
   Ogre::vector<Ogre::TextureGpu*>::type swappedTargets;
   swappedTargets.reserve(2u);
-  this->dataPtr->ogreCompositorWorkspace->_swapFinalTarget(swappedTargets);
+  workspace->_swapFinalTarget(swappedTargets);
+
+  // extract the depth channel so only a single channel texture needs to be
+  // read back
+  if (this->ReadDepthOnly())
+  {
+    if (!this->dataPtr->ogreDepthOnlyWorkspace)
+      this->CreateDepthOnlyWorkspace();
+
+    this->dataPtr->ogreDepthOnlyWorkspace->_validateFinalTarget();
+    this->dataPtr->ogreDepthOnlyWorkspace->_beginUpdate(false);
+    this->dataPtr->ogreDepthOnlyWorkspace->_update();
+    this->dataPtr->ogreDepthOnlyWorkspace->_endUpdate(false);
+    swappedTargets.clear();
+    this->dataPtr->ogreDepthOnlyWorkspace->_swapFinalTarget(swappedTargets);
+  }
 
   this->scene->FlushGpuCommandsAndStartNewFrame(1u, false);
 
@@ -990,13 +1251,54 @@ void Ogre2DepthCamera::Render()
 //////////////////////////////////////////////////
 void Ogre2DepthCamera::PreRender()
 {
-  if (!this->dataPtr->ogreDepthTexture[0])
-    this->CreateDepthTexture();
+  IGN_PROFILE("Ogre2DepthCamera::PreRender");
+  // nothing to prepare until the camera renders, see Render
+  if (!this->dataPtr->ogreDepthTexture[1])
+    return;
+
+  if (this->IdleTimeoutExpired())
+  {
+    this->ReleaseResources();
+    return;
+  }
+
+  this->PrepareRender();
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::PrepareRender()
+{
+  // render passes need the final pass, and with it a second texture
+  if (this->dataPtr->singlePass && !this->dataPtr->renderPasses.empty())
+    this->DisableSinglePass();
+
+  if (!this->dataPtr->ogreDepthTexture[1] ||
+      (!this->dataPtr->singlePass && !this->dataPtr->ogreDepthTexture[0]))
+  {
+    // the definitions and material outlive released resources
+    if (this->dataPtr->ogreCompositorWorkspaceDef.empty())
+      this->CreateDepthTexture();
+    else
+      this->CreateDepthTargets();
+  }
 
   if (!this->dataPtr->ogreCompositorWorkspace)
     this->CreateWorkspaceInstance();
 
+  this->ogreCamera->setLodBias(this->LodBias());
+
+  // the instance without color passes is created again from the updated
+  // workspace definition when needed
+  if (this->dataPtr->renderPassDirty)
+    this->DestroyNoColorWorkspace();
+
   // update depth camera render passes
+  for (auto &pass : this->dataPtr->renderPasses)
+  {
+    Ogre2RenderPass *ogre2RenderPass =
+        dynamic_cast<Ogre2RenderPass *>(pass.get());
+    ogre2RenderPass->SetCamera(this->ogreCamera);
+  }
   Ogre2RenderTarget::UpdateRenderPassChain(
       this->dataPtr->ogreCompositorWorkspace,
       this->dataPtr->ogreCompositorWorkspaceDef,
@@ -1040,9 +1342,235 @@ void Ogre2DepthCamera::PreRender()
 
 //////////////////////////////////////////////////
 void Ogre2DepthCamera::PostRender()
+{
+  IGN_PROFILE("Ogre2DepthCamera::PostRender");
+  if (this->frameReprojected)
+  {
+    this->ReprojectKeyFrame();
+    return;
+  }
+
+  Ogre::TextureGpu *readbackTexture = this->ReadbackTexture();
+  if (!readbackTexture)
+    return;
+  bool depthOnly = readbackTexture == this->dataPtr->ogreDepthOnlyTexture;
+  unsigned int channelCount = depthOnly ? 1u : 4u;
+
+  // frames are reprojected from the points of the last rendered frame,
+  // which are read back right away to pair them with the camera pose
+  bool reproject = this->reprojectionInterval > 1u;
+  if (!this->dataPtr->asyncReadback || reproject)
+  {
+    Ogre::Image2 image;
+    image.convertFromTexture(readbackTexture, 0u, 0u);
+    Ogre::TextureBox box = image.getData(0);
+    if (reproject)
+    {
+      unsigned int height = this->ImageHeight();
+      size_t rowBytes = this->ImageWidth() * 4u * sizeof(float);
+      this->dataPtr->keyFrame.resize(rowBytes / sizeof(float) * height);
+      Ogre2ReadbackKernels::CopyRows(box.data, box.bytesPerRow,
+          this->dataPtr->keyFrame.data(), rowBytes, rowBytes, 0u, height);
+      this->dataPtr->keyFramePose = this->WorldPose();
+    }
+    this->ProcessDepthData(box.data, box.bytesPerRow, channelCount, false);
+    return;
+  }
+
+  // pending frames were read back with a different layout, drop them
+  if (this->dataPtr->readbackTickets[0] &&
+      this->dataPtr->readbackTicketsFormat !=
+      readbackTexture->getPixelFormat())
+  {
+    this->DestroyReadbackTickets();
+  }
+
+  auto engine = Ogre2RenderEngine::Instance();
+  Ogre::TextureGpuManager *textureMgr =
+      engine->OgreRoot()->getRenderSystem()->getTextureGpuManager();
+
+  if (!this->dataPtr->readbackTickets[0])
+  {
+    for (unsigned int i = 0u; i < this->dataPtr->kNumReadbackTickets; ++i)
+    {
+      this->dataPtr->readbackTickets[i] =
+          textureMgr->createAsyncTextureTicket(
+          this->ImageWidth(), this->ImageHeight(), 1u,
+          Ogre::TextureTypes::Type2D, readbackTexture->getPixelFormat());
+    }
+    this->dataPtr->readbackTicketsFormat = readbackTexture->getPixelFormat();
+  }
+
+  // if every ticket is still waiting to be processed, the oldest one has to
+  // be consumed (blocking if needed) before it can be reused
+  if (this->dataPtr->pendingReadbacks.size() >=
+      this->dataPtr->kNumReadbackTickets)
+  {
+    Ogre::AsyncTextureTicket *ticket = this->dataPtr->readbackTickets[
+        this->dataPtr->pendingReadbacks.front()];
+    Ogre::TextureBox box = ticket->map(0u);
+    this->ProcessDepthData(box.data, box.bytesPerRow, channelCount, false);
+    ticket->unmap();
+    this->dataPtr->pendingReadbacks.pop_front();
+  }
+
+  // queue the download of the frame that was just rendered
+  unsigned int ticketIdx = this->dataPtr->nextReadbackTicket;
+  this->dataPtr->readbackTickets[ticketIdx]->download(
+      readbackTexture, 0u, true);
+  this->dataPtr->pendingReadbacks.push_back(ticketIdx);
+  this->dataPtr->nextReadbackTicket =
+      (ticketIdx + 1u) % this->dataPtr->kNumReadbackTickets;
+
+  // emit data of previous frames whose download has already completed
+  while (this->dataPtr->pendingReadbacks.size() > 1u)
+  {
+    Ogre::AsyncTextureTicket *ticket = this->dataPtr->readbackTickets[
+        this->dataPtr->pendingReadbacks.front()];
+    if (!ticket->queryIsTransferDone())
+      break;
+    Ogre::TextureBox box = ticket->map(0u);
+    this->ProcessDepthData(box.data, box.bytesPerRow, channelCount, false);
+    ticket->unmap();
+    this->dataPtr->pendingReadbacks.pop_front();
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::ProcessDepthData(const void *_data,
+    size_t _bytesPerRow, unsigned int _channelCount, bool _reprojected)
 {
   unsigned int width = this->ImageWidth();
   unsigned int height = this->ImageHeight();
+  this->RecordFrameGpuComplete(_reprojected);
+
+  Ogre2WorkerPool &workerPool = Ogre2RenderEngine::Instance()->WorkerPool();
+  unsigned int threadCount = this->scene->PostProcessThreadCount();
+  PixelFormat outputFormat = this->dataPtr->depthOutputFormat;
+  const float *depthBufferTmp = static_cast<const float *>(_data);
+  size_t bytesPerRow = _bytesPerRow;
+
+  // millimeter depth is compressed in bands on the worker threads
+  bool compress = outputFormat == PF_L16 &&
+      this->dataPtr->newCompressedDepthFrame.ConnectionCount() > 0u;
+  auto compressDepth = [&](const uint16_t *_depth, size_t _rowPitch)
+  {
+    std::vector<uint8_t> &compressed = this->dataPtr->compressedDepth;
+    DepthCompression::Compress(_depth, width, height,
+        static_cast<unsigned int>(_rowPitch), compressed,
+        [&](unsigned int _count, const Ogre2WorkerPool::RowFunction &_bands)
+        {
+          workerPool.ParallelFor(_count,
+              width * DepthCompression::kBandRows * sizeof(uint16_t),
+              threadCount, _bands);
+        });
+    this->dataPtr->newCompressedDepthFrame(compressed.data(),
+        compressed.size());
+  };
+
+  if (_channelCount == 1u)
+  {
+    // depth was encoded on the GPU, hand it over as is
+    this->dataPtr->newEncodedDepthFrame(_data, width, height,
+        static_cast<unsigned int>(_bytesPerRow),
+        PixelUtil::Name(outputFormat));
+    if (compress)
+      compressDepth(static_cast<const uint16_t *>(_data), _bytesPerRow);
+
+    // decode it for the float subscribers
+    if (outputFormat != PF_FLOAT32_R)
+    {
+      if ((this->dataPtr->newEncodedDepthFrame.ConnectionCount() > 0u ||
+          compress) &&
+          this->dataPtr->newDepthFrame.ConnectionCount() == 0u &&
+          this->dataPtr->newDepthFrameView.ConnectionCount() == 0u)
+      {
+        this->RecordFrameDelivered();
+        return;
+      }
+
+      if (!this->dataPtr->decodedDepth)
+        this->dataPtr->decodedDepth = new float[width * height];
+      float *decodedDepth = this->dataPtr->decodedDepth;
+      const uint16_t *encoded = static_cast<const uint16_t *>(_data);
+      workerPool.ParallelFor(height, width * sizeof(float), threadCount,
+          [&](unsigned int _begin, unsigned int _end)
+          {
+            if (outputFormat == PF_FLOAT16_R)
+            {
+              Ogre2ReadbackKernels::HalfToFloat(encoded, _bytesPerRow,
+                  decodedDepth, width, _begin, _end);
+            }
+            else
+            {
+              Ogre2ReadbackKernels::MillimetersToMeters(encoded,
+                  _bytesPerRow, 1u, decodedDepth, width, _begin, _end);
+            }
+          });
+      depthBufferTmp = decodedDepth;
+      bytesPerRow = width * sizeof(float);
+    }
+  }
+  else if (this->dataPtr->newEncodedDepthFrame.ConnectionCount() > 0u ||
+      compress)
+  {
+    // depth is read back as float for the point clouds, encode it on the
+    // CPU
+    if (!this->dataPtr->decodedDepth)
+      this->dataPtr->decodedDepth = new float[width * height];
+    if (!this->dataPtr->encodedDepth)
+      this->dataPtr->encodedDepth = new uint16_t[width * height];
+    float *decodedDepth = this->dataPtr->decodedDepth;
+    uint16_t *encodedDepth = this->dataPtr->encodedDepth;
+    workerPool.ParallelFor(height, width * sizeof(float), threadCount,
+        [&](unsigned int _begin, unsigned int _end)
+        {
+          Ogre2ReadbackKernels::ExtractFirstChannel(depthBufferTmp,
+              _bytesPerRow, _channelCount, decodedDepth, width, _begin,
+              _end);
+          if (outputFormat == PF_FLOAT16_R)
+          {
+            Ogre2ReadbackKernels::FloatToHalf(decodedDepth, encodedDepth,
+                width, _begin, _end);
+          }
+          else if (outputFormat == PF_L16)
+          {
+            Ogre2ReadbackKernels::MetersToMillimeters(decodedDepth,
+                encodedDepth, width, _begin, _end);
+          }
+        });
+    unsigned int bytesPerPixel = PixelUtil::BytesPerPixel(outputFormat);
+    const void *encoded = outputFormat == PF_FLOAT32_R ?
+        static_cast<const void *>(decodedDepth) :
+        static_cast<const void *>(encodedDepth);
+    this->dataPtr->newEncodedDepthFrame(encoded, width, height,
+        width * bytesPerPixel, PixelUtil::Name(outputFormat));
+    if (compress)
+      compressDepth(encodedDepth, width * sizeof(uint16_t));
+  }
+
+  // zero-copy subscribers get a view of the read back data directly
+  this->dataPtr->newDepthFrameView(depthBufferTmp, width, height,
+      _channelCount, static_cast<unsigned int>(bytesPerRow),
+      _channelCount == 1u ? "FLOAT32" : "PF_FLOAT32_RGBA");
+  if (_channelCount > 1u)
+  {
+    this->dataPtr->newRgbPointCloudView(depthBufferTmp, width, height,
+        _channelCount, static_cast<unsigned int>(bytesPerRow),
+        "PF_FLOAT32_RGBA");
+  }
+
+  // skip the intermediate copies if all subscribers use views
+  bool hasViewSubscribers =
+      this->dataPtr->newDepthFrameView.ConnectionCount() > 0u ||
+      this->dataPtr->newRgbPointCloudView.ConnectionCount() > 0u;
+  if (hasViewSubscribers &&
+      this->dataPtr->newDepthFrame.ConnectionCount() == 0u &&
+      this->dataPtr->newRgbPointCloud.ConnectionCount() == 0u)
+  {
+    this->RecordFrameDelivered();
+    return;
+  }
 
   PixelFormat format = PF_FLOAT32_RGBA;
 
@@ -1050,25 +1578,11 @@ void Ogre2DepthCamera::PostRender()
   unsigned int channelCount = PixelUtil::ChannelCount(format);
   unsigned int bytesPerChannel = PixelUtil::BytesPerChannel(format);
 
-  Ogre::Image2 image;
-  image.convertFromTexture(this->dataPtr->ogreDepthTexture[1], 0u, 0u);
-  Ogre::TextureBox box = image.getData(0);
-  float *depthBufferTmp = static_cast<float *>(box.data);
   if (!this->dataPtr->depthBuffer)
   {
     this->dataPtr->depthBuffer = new float[len * channelCount];
   }
 
-  // copy data row by row. The texture box may not be a contiguous region of
-  // a texture
-  for (unsigned int i = 0; i < height; ++i)
-  {
-    unsigned int rawDataRowIdx = i * box.bytesPerRow / bytesPerChannel;
-    unsigned int rowIdx = i * width * channelCount;
-    memcpy(&this->dataPtr->depthBuffer[rowIdx], &depthBufferTmp[rawDataRowIdx],
-        width * channelCount * bytesPerChannel);
-  }
-
   if (!this->dataPtr->depthImage)
   {
     this->dataPtr->depthImage = new float[len];
@@ -1078,27 +1592,38 @@ void Ogre2DepthCamera::PostRender()
     this->dataPtr->pointCloudImage = new float[len * channelCount];
   }
 
-  // fill depth data
-  for (unsigned int i = 0; i < height; ++i)
-  {
-    unsigned int step = i*width*channelCount;
-    for (unsigned int j = 0; j < width; ++j)
-    {
-      float x = this->dataPtr->depthBuffer[step + j*channelCount];
-      this->dataPtr->depthImage[i*width + j] = x;
-    }
-  }
+  // copy data row by row, the texture box may not be a contiguous region of
+  // a texture, and fill depth data. Rows are split over the post processing
+  // threads of the scene
+  size_t rowBytes = width * _channelCount * bytesPerChannel;
+  float *depthBuffer = this->dataPtr->depthBuffer;
+  float *depthImage = this->dataPtr->depthImage;
+  workerPool.ParallelFor(height, rowBytes + width * sizeof(float),
+      threadCount,
+      [&](unsigned int _begin, unsigned int _end)
+      {
+        Ogre2ReadbackKernels::CopyRows(depthBufferTmp, bytesPerRow,
+            depthBuffer, rowBytes, rowBytes, _begin, _end);
+        Ogre2ReadbackKernels::ExtractFirstChannel(depthBufferTmp,
+            bytesPerRow, _channelCount, depthImage, width, _begin, _end);
+      });
+  this->RecordFrameReadback();
+  IGN_PROFILE_BEGIN("Dispatch newDepthFrame");
   this->dataPtr->newDepthFrame(
         this->dataPtr->depthImage, width, height, 1, "FLOAT32");
+  IGN_PROFILE_END();
 
   // point cloud data
-  if (this->dataPtr->newRgbPointCloud.ConnectionCount() > 0u)
+  if (_channelCount == channelCount &&
+      this->dataPtr->newRgbPointCloud.ConnectionCount() > 0u)
   {
     memcpy(this->dataPtr->pointCloudImage,
       this->dataPtr->depthBuffer, len * channelCount * sizeof(float));
+    IGN_PROFILE_BEGIN("Dispatch newRgbPointCloud");
     this->dataPtr->newRgbPointCloud(
         this->dataPtr->pointCloudImage, width, height, channelCount,
         "PF_FLOAT32_RGBA");
+    IGN_PROFILE_END();
 
     // Uncomment to debug color output
     // for (unsigned int i = 0; i < height; ++i)
@@ -1131,6 +1656,7 @@ void Ogre2DepthCamera::PostRender()
     //   igndbg << std::endl;
     // }
   }
+  this->RecordFrameDelivered();
 
   // Uncomment to debug depth output
   // igndbg << "wxh: " << width << " x " << height << std::endl;
@@ -1150,6 +1676,33 @@ const float *Ogre2DepthCamera::DepthData() const
   return this->dataPtr->depthBuffer;
 }
 
+//////////////////////////////////////////////////
+bool Ogre2DepthCamera::SaveFrame(const std::string &_name)
+{
+  if (!rendering::FrameRecorder::IsSupported(PF_FLOAT32_R, _name))
+  {
+    ignerr << "Unable to save a depth frame to [" << _name << "]"
+           << std::endl;
+    return false;
+  }
+
+  // the depth image is only kept for the float depth frame subscribers
+  if (!this->dataPtr->depthImage)
+  {
+    ignerr << "No depth frame to save to [" << _name << "]" << std::endl;
+    return false;
+  }
+
+  unsigned int width = this->ImageWidth();
+  unsigned int height = this->ImageHeight();
+  Image image = this->imagePool ?
+      this->imagePool->CreateImage(width, height, PF_FLOAT32_R) :
+      Image(width, height, PF_FLOAT32_R);
+  memcpy(image.Data(), this->dataPtr->depthImage,
+      width * height * sizeof(float));
+  return this->DefaultFrameRecorder()->Save(image, _name);
+}
+
 //////////////////////////////////////////////////
 ignition::common::ConnectionPtr Ogre2DepthCamera::ConnectNewDepthFrame(
     std::function<void(const float *, unsigned int, unsigned int,
@@ -1166,6 +1719,22 @@ ignition::common::ConnectionPtr Ogre2DepthCamera::ConnectNewRgbPointCloud(
   return this->dataPtr->newRgbPointCloud.Connect(_subscriber);
 }
 
+//////////////////////////////////////////////////
+ignition::common::ConnectionPtr Ogre2DepthCamera::ConnectNewDepthFrameView(
+    std::function<void(const float *, unsigned int, unsigned int,
+      unsigned int, unsigned int, const std::string &)> _subscriber)
+{
+  return this->dataPtr->newDepthFrameView.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+ignition::common::ConnectionPtr Ogre2DepthCamera::ConnectNewRgbPointCloudView(
+    std::function<void(const float *, unsigned int, unsigned int,
+      unsigned int, unsigned int, const std::string &)> _subscriber)
+{
+  return this->dataPtr->newRgbPointCloudView.Connect(_subscriber);
+}
+
 //////////////////////////////////////////////////
 RenderTargetPtr Ogre2DepthCamera::RenderTarget() const
 {
@@ -1229,6 +1798,452 @@ void Ogre2DepthCamera::SetShadowsNodeDefDirty()
   }
 }
 
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::SetResolutionScale(double _scale)
+{
+  double scale = std::clamp(_scale, this->minResolutionScale, 1.0);
+  if (math::equal(scale, this->resolutionScale))
+    return;
+
+  this->resolutionScale = scale;
+  if (this->dataPtr->ogreCompositorBaseNodeDef.empty())
+    return;
+
+  // update the scene textures of the existing definition, the workspaces
+  // are created again from it in PreRender
+  auto engine = Ogre2RenderEngine::Instance();
+  Ogre::CompositorManager2 *ogreCompMgr =
+      engine->OgreRoot()->getCompositorManager2();
+  Ogre::CompositorNodeDef *baseNodeDef =
+      ogreCompMgr->getNodeDefinitionNonConst(
+      this->dataPtr->ogreCompositorBaseNodeDef);
+  for (auto &texDef : baseNodeDef->getTextureDefinitionsNoConst())
+  {
+    bool particle = texDef.getName() == Ogre::IdString("particleTexture") ||
+        texDef.getName() == Ogre::IdString("particleDepthTexture");
+    texDef.widthFactor = static_cast<float>((particle ? 0.5 : 1.0) * scale);
+    texDef.heightFactor = texDef.widthFactor;
+  }
+
+  this->DestroyNoColorWorkspace();
+  this->SetShadowsNodeDefDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::SetReprojectionInterval(unsigned int _interval)
+{
+  this->reprojectionInterval = std::max(_interval, 1u);
+  this->reprojectionCounter = 0u;
+
+  // key frames are read back synchronously
+  if (this->reprojectionInterval > 1u)
+    this->DestroyReadbackTickets();
+  else
+    std::vector<float>().swap(this->dataPtr->keyFrame);
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::ReprojectKeyFrame()
+{
+  IGN_PROFILE("Ogre2DepthCamera::ReprojectKeyFrame");
+  unsigned int width = this->ImageWidth();
+  unsigned int height = this->ImageHeight();
+  const float *keyFrame = this->dataPtr->keyFrame.data();
+  this->dataPtr->reprojectedFrame.resize(this->dataPtr->keyFrame.size());
+  float *reprojected = this->dataPtr->reprojectedFrame.data();
+
+  // transform from the camera frame of the key frame to the current one
+  const math::Pose3d &keyPose = this->dataPtr->keyFramePose;
+  math::Pose3d pose = this->WorldPose();
+  math::Matrix3d rot(pose.Rot().Inverse() * keyPose.Rot());
+  math::Vector3d trans =
+      pose.Rot().RotateVectorReverse(keyPose.Pos() - pose.Pos());
+
+  // the image spans these tangents of the angles to the optical axis
+  double tanX = std::tan(this->HFOV().Radian() * 0.5);
+  double tanY = tanX / this->aspect;
+
+  double nearPlane = this->NearClipPlane();
+  double farPlane = this->FarClipPlane();
+  float maxVal = this->dataPtr->dataMaxVal;
+  float minVal = this->dataPtr->dataMinVal;
+  const double tolerance = 1e-6;
+  const int kIterations = 4;
+
+  // points out of range were clamped by the shaders
+  auto isReturn = [&](const float *_p)
+  {
+    return std::isfinite(_p[0]) && std::isfinite(_p[1]) &&
+        std::isfinite(_p[2]) && _p[0] != maxVal && _p[0] != minVal;
+  };
+
+  Ogre2WorkerPool &workerPool = Ogre2RenderEngine::Instance()->WorkerPool();
+  workerPool.ParallelFor(height, width * 4u * sizeof(float),
+      this->scene->PostProcessThreadCount(),
+      [&](unsigned int _begin, unsigned int _end)
+      {
+        for (unsigned int i = _begin; i < _end; ++i)
+        {
+          // tangent of the angle of the row above the optical axis, z / x
+          double up = (1.0 - 2.0 * (i + 0.5) / height) * tanY;
+          for (unsigned int j = 0u; j < width; ++j)
+          {
+            // tangent of the angle of the column left of the optical axis,
+            // y / x
+            double left = (1.0 - 2.0 * (j + 0.5) / width) * tanX;
+
+            // start at the same pixel of the key frame and correct it by
+            // how far its point lands from this pixel
+            double keyLeft = left;
+            double keyUp = up;
+            const float *p = nullptr;
+            math::Vector3d point;
+            for (int n = 0; n <= kIterations; ++n)
+            {
+              int col = static_cast<int>(
+                  std::floor((1.0 - keyLeft / tanX) * 0.5 * width));
+              int row = static_cast<int>(
+                  std::floor((1.0 - keyUp / tanY) * 0.5 * height));
+              col = std::clamp(col, 0, static_cast<int>(width) - 1);
+              row = std::clamp(row, 0, static_cast<int>(height) - 1);
+              p = keyFrame + (static_cast<size_t>(row) * width + col) * 4u;
+
+              // pixels without a return move like the far plane
+              math::Vector3d keyPoint = isReturn(p) ?
+                  math::Vector3d(p[0], p[1], p[2]) :
+                  math::Vector3d(1.0, keyLeft, keyUp) * farPlane;
+              point = rot * keyPoint + trans;
+              if (n == kIterations || point.X() <= 0.0)
+                break;
+
+              keyLeft += left - point.Y() / point.X();
+              keyUp += up - point.Z() / point.X();
+            }
+
+            // clamp like the depth camera shaders
+            float *out =
+                reprojected + (static_cast<size_t>(i) * width + j) * 4u;
+            out[0] = static_cast<float>(point.X());
+            out[1] = static_cast<float>(point.Y());
+            out[2] = static_cast<float>(point.Z());
+            out[3] = p[3];
+            bool valid = isReturn(p);
+            if (p[0] == minVal ||
+                (valid && point.X() < nearPlane + tolerance))
+            {
+              out[0] = minVal;
+              if (std::isinf(minVal))
+                out[1] = out[2] = minVal;
+            }
+            else if (!valid || point.Length() > farPlane - tolerance)
+            {
+              out[0] = maxVal;
+              if (std::isinf(maxVal))
+                out[1] = out[2] = maxVal;
+            }
+          }
+        }
+      });
+
+  this->ProcessDepthData(reprojected, width * 4u * sizeof(float), 4u, true);
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::SetDepthOnlyReadback(bool _enabled)
+{
+  this->dataPtr->depthOnlyReadback = _enabled;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2DepthCamera::DepthOnlyReadback() const
+{
+  return this->dataPtr->depthOnlyReadback;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2DepthCamera::SetDepthOutputFormat(PixelFormat _format)
+{
+  if (_format != PF_FLOAT32_R && _format != PF_FLOAT16_R &&
+      _format != PF_L16)
+  {
+    ignerr << "Unsupported depth output format: "
+           << PixelUtil::Name(_format) << std::endl;
+    return false;
+  }
+
+  if (this->dataPtr->depthOutputFormat == _format)
+    return true;
+
+  // the depth only texture is created again with the new format on the
+  // next render
+  this->dataPtr->depthOutputFormat = _format;
+  if (this->ogreCamera)
+    this->DestroyDepthOnlyWorkspace();
+  return true;
+}
+
+//////////////////////////////////////////////////
+PixelFormat Ogre2DepthCamera::DepthOutputFormat() const
+{
+  return this->dataPtr->depthOutputFormat;
+}
+
+//////////////////////////////////////////////////
+ignition::common::ConnectionPtr Ogre2DepthCamera::ConnectNewEncodedDepthFrame(
+    std::function<void(const void *, unsigned int, unsigned int,
+    unsigned int, const std::string &)> _subscriber)
+{
+  return this->dataPtr->newEncodedDepthFrame.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+ignition::common::ConnectionPtr
+    Ogre2DepthCamera::ConnectNewCompressedDepthFrame(
+    std::function<void(const uint8_t *, size_t)> _subscriber)
+{
+  return this->dataPtr->newCompressedDepthFrame.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+bool Ogre2DepthCamera::ReadDepthOnly() const
+{
+  return this->reprojectionInterval <= 1u &&
+      (this->dataPtr->depthOnlyReadback ||
+      this->dataPtr->depthOutputFormat != PF_FLOAT32_R) &&
+      this->dataPtr->newRgbPointCloud.ConnectionCount() == 0u &&
+      this->dataPtr->newRgbPointCloudView.ConnectionCount() == 0u;
+}
+
+//////////////////////////////////////////////////
+Ogre::TextureGpu *Ogre2DepthCamera::ReadbackTexture() const
+{
+  if (this->ReadDepthOnly() && this->dataPtr->ogreDepthOnlyTexture)
+    return this->dataPtr->ogreDepthOnlyTexture;
+  return this->dataPtr->ogreDepthTexture[1];
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2DepthCamera::RenderTextureGLId() const
+{
+  return Ogre2RenderTarget::TextureGLId(this->ReadbackTexture());
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::RenderTextureMetalId(void *_textureIdPtr) const
+{
+  Ogre2RenderTarget::TextureMetalId(this->ReadbackTexture(), _textureIdPtr);
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::CreateDepthOnlyWorkspace()
+{
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+  Ogre::TextureGpuManager *textureMgr =
+      ogreRoot->getRenderSystem()->getTextureGpuManager();
+
+  this->dataPtr->ogreDepthOnlyTexture =
+      textureMgr->createTexture(
+        this->Name() + "_depthOnly",
+        Ogre::GpuPageOutStrategy::Discard,
+        Ogre::TextureFlags::RenderToTexture,
+        Ogre::TextureTypes::Type2D);
+  this->dataPtr->ogreDepthOnlyTexture->setResolution(
+      this->ImageWidth(), this->ImageHeight());
+  this->dataPtr->ogreDepthOnlyTexture->setNumMipmaps(1u);
+  // the depth only pass encodes depth to the output format. Millimeters
+  // are written to a unorm target, which stores them exactly
+  Ogre::PixelFormatGpu depthOnlyFormat = Ogre::PFG_R32_FLOAT;
+  if (this->dataPtr->depthOutputFormat == PF_FLOAT16_R)
+    depthOnlyFormat = Ogre::PFG_R16_FLOAT;
+  else if (this->dataPtr->depthOutputFormat == PF_L16)
+    depthOnlyFormat = Ogre::PFG_R16_UNORM;
+  this->dataPtr->ogreDepthOnlyTexture->setPixelFormat(depthOnlyFormat);
+  this->dataPtr->ogreDepthOnlyTexture->scheduleTransitionTo(
+      Ogre::GpuResidency::Resident);
+
+  // The compositor workspace definition is equivalent to the following:
+  //
+  // compositor_node DepthCameraDepthOnly
+  // {
+  //   in 0 rt_input
+  //   in 1 rt_output
+  //
+  //   target rt_output
+  //   {
+  //     pass render_quad
+  //     {
+  //       material DepthCameraDepthOnly
+  //       input 0 rt_input
+  //     }
+  //   }
+  // }
+  std::string wsDefName = "DepthCameraDepthOnlyWorkspace_" + this->Name();
+  this->dataPtr->ogreDepthOnlyWorkspaceDef = wsDefName;
+  if (!ogreCompMgr->hasWorkspaceDefinition(wsDefName))
+  {
+    std::string nodeDefName = wsDefName + "/Node";
+    this->dataPtr->ogreDepthOnlyNodeDef = nodeDefName;
+    Ogre::CompositorNodeDef *nodeDef =
+        ogreCompMgr->addNodeDefinition(nodeDefName);
+    nodeDef->addTextureSourceName("rt_input", 0,
+        Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+    nodeDef->addTextureSourceName("rt_output", 1,
+        Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+
+    nodeDef->setNumTargetPass(1);
+    Ogre::CompositorTargetDef *targetDef = nodeDef->addTargetPass("rt_output");
+    targetDef->setNumPasses(1);
+    {
+      Ogre::CompositorPassQuadDef *passQuad =
+          static_cast<Ogre::CompositorPassQuadDef *>(
+          targetDef->addPass(Ogre::PASS_QUAD));
+      passQuad->setAllLoadActions(Ogre::LoadAction::DontCare);
+      passQuad->mMaterialName =
+          this->dataPtr->depthOutputFormat == PF_L16 ?
+          "DepthCameraDepthOnlyMillimeters" : "DepthCameraDepthOnly";
+      passQuad->addQuadTextureSource(0, "rt_input");
+    }
+
+    Ogre::CompositorWorkspaceDef *workDef =
+        ogreCompMgr->addWorkspaceDefinition(wsDefName);
+    workDef->connectExternal(0, nodeDefName, 0);
+    workDef->connectExternal(1, nodeDefName, 1);
+  }
+
+  Ogre::CompositorChannelVec externalTargets(2u);
+  externalTargets[0] = this->dataPtr->ogreDepthTexture[1];
+  externalTargets[1] = this->dataPtr->ogreDepthOnlyTexture;
+  this->dataPtr->ogreDepthOnlyWorkspace =
+      ogreCompMgr->addWorkspace(
+          this->scene->OgreSceneManager(),
+          externalTargets,
+          this->ogreCamera,
+          wsDefName,
+          false);
+  this->AddPassProfilers(this->dataPtr->ogreDepthOnlyWorkspace);
+  if (this->OcclusionCuller())
+  {
+    this->dataPtr->ogreDepthOnlyWorkspace->addListener(
+        this->OcclusionCuller());
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::DestroyDepthOnlyWorkspace()
+{
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+
+  if (this->dataPtr->ogreDepthOnlyWorkspace)
+  {
+    ogreCompMgr->removeWorkspace(this->dataPtr->ogreDepthOnlyWorkspace);
+    this->dataPtr->ogreDepthOnlyWorkspace = nullptr;
+  }
+
+  if (!this->dataPtr->ogreDepthOnlyWorkspaceDef.empty() &&
+      ogreCompMgr->hasWorkspaceDefinition(
+      this->dataPtr->ogreDepthOnlyWorkspaceDef))
+  {
+    ogreCompMgr->removeWorkspaceDefinition(
+        this->dataPtr->ogreDepthOnlyWorkspaceDef);
+    ogreCompMgr->removeNodeDefinition(this->dataPtr->ogreDepthOnlyNodeDef);
+  }
+  this->dataPtr->ogreDepthOnlyWorkspaceDef.clear();
+
+  if (this->dataPtr->ogreDepthOnlyTexture)
+  {
+    ogreRoot->getRenderSystem()->getTextureGpuManager()->destroyTexture(
+        this->dataPtr->ogreDepthOnlyTexture);
+    this->dataPtr->ogreDepthOnlyTexture = nullptr;
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::CreateNoColorWorkspace()
+{
+  auto engine = Ogre2RenderEngine::Instance();
+  Ogre::CompositorManager2 *ogreCompMgr =
+      engine->OgreRoot()->getCompositorManager2();
+
+  // same definition and targets as the main instance, but the execution
+  // mask leaves out the color passes
+  const uint8_t executionMask = 0xFF & ~this->dataPtr->kColorExecutionMask;
+  this->dataPtr->ogreNoColorWorkspace =
+      ogreCompMgr->addWorkspace(
+          this->scene->OgreSceneManager(),
+          this->dataPtr->ogreCompositorWorkspace->getExternalRenderTargets(),
+          this->ogreCamera,
+          this->dataPtr->ogreCompositorWorkspaceDef,
+          false, -1, nullptr, nullptr, nullptr, Ogre::Vector4::ZERO, 0x00,
+          executionMask);
+
+  this->AddPassProfilers(this->dataPtr->ogreNoColorWorkspace);
+  if (this->OcclusionCuller())
+  {
+    this->dataPtr->ogreNoColorWorkspace->addListener(
+        this->OcclusionCuller());
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::DestroyNoColorWorkspace()
+{
+  if (!this->dataPtr->ogreNoColorWorkspace)
+    return;
+
+  auto engine = Ogre2RenderEngine::Instance();
+  engine->OgreRoot()->getCompositorManager2()->removeWorkspace(
+      this->dataPtr->ogreNoColorWorkspace);
+  this->dataPtr->ogreNoColorWorkspace = nullptr;
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::SetAsyncReadback(bool _enabled)
+{
+  if (this->dataPtr->asyncReadback == _enabled)
+    return;
+
+  this->dataPtr->asyncReadback = _enabled;
+
+  // pending frames are dropped when switching back to synchronous mode
+  if (!_enabled)
+    this->DestroyReadbackTickets();
+}
+
+//////////////////////////////////////////////////
+bool Ogre2DepthCamera::AsyncReadback() const
+{
+  return this->dataPtr->asyncReadback;
+}
+
+//////////////////////////////////////////////////
+void Ogre2DepthCamera::DestroyReadbackTickets()
+{
+  for (size_t i = 0u; i < this->dataPtr->pendingReadbacks.size(); ++i)
+    this->RecordFrameDropped();
+  this->dataPtr->pendingReadbacks.clear();
+  this->dataPtr->nextReadbackTicket = 0u;
+
+  if (!this->dataPtr->readbackTickets[0])
+    return;
+
+  auto engine = Ogre2RenderEngine::Instance();
+  Ogre::TextureGpuManager *textureMgr =
+      engine->OgreRoot()->getRenderSystem()->getTextureGpuManager();
+  for (unsigned int i = 0u; i < this->dataPtr->kNumReadbackTickets; ++i)
+  {
+    if (this->dataPtr->readbackTickets[i])
+    {
+      textureMgr->destroyAsyncTextureTicket(
+          this->dataPtr->readbackTickets[i]);
+      this->dataPtr->readbackTickets[i] = nullptr;
+    }
+  }
+}
+
 //////////////////////////////////////////////////
 void Ogre2DepthCamera::AddRenderPass(const RenderPassPtr &_pass)
 {
@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cmath>
+#include <string>
+
+#include <ignition/common/Console.hh>
+#include <ignition/math/Helpers.hh>
+
+#include "ignition/rendering/RenderPassSystem.hh"
+#include "ignition/rendering/ogre2/Ogre2DistortionPass.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Compositor/OgreCompositorManager2.h>
+#include <Compositor/OgreCompositorNodeDef.h>
+#include <Compositor/Pass/PassQuad/OgreCompositorPassQuadDef.h>
+#include <OgreCamera.h>
+#include <OgreMaterial.h>
+#include <OgreMaterialManager.h>
+#include <OgrePass.h>
+#include <OgreRoot.h>
+#include <OgreTechnique.h>
+#include <OgreVector2.h>
+#include <OgreVector3.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+/// \brief Private data for the Ogre2DistortionPass class
+class ignition::rendering::Ogre2DistortionPassPrivate
+{
+  /// brief Pointer to the distortion ogre material
+  public: Ogre::Material *distortionMat = nullptr;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Apply the distortion model to a point in texture coordinates
+/// \param[in] _pass Distortion pass with the model coefficients
+/// \param[in] _uv Undistorted point in texture coordinates
+/// \param[in] _invFocal Image size over focal length, per axis
+/// \return Distorted point in texture coordinates
+static math::Vector2d Distort(const DistortionPass &_pass,
+    const math::Vector2d &_uv, const math::Vector2d &_invFocal)
+{
+  const math::Vector2d center = _pass.Center();
+  const double x = (_uv.X() - center.X()) * _invFocal.X();
+  const double y = (_uv.Y() - center.Y()) * _invFocal.Y();
+  const double r2 = x * x + y * y;
+  const double radial = 1.0 + r2 * (_pass.K1() +
+      r2 * (_pass.K2() + r2 * _pass.K3()));
+
+  const double dx = x * radial + _pass.P2() * (r2 + 2.0 * x * x) +
+      2.0 * _pass.P1() * x * y;
+  const double dy = y * radial + _pass.P1() * (r2 + 2.0 * y * y) +
+      2.0 * _pass.P2() * x * y;
+
+  return math::Vector2d(center.X() + dx / _invFocal.X(),
+      center.Y() + dy / _invFocal.Y());
+}
+
+//////////////////////////////////////////////////
+Ogre2DistortionPass::Ogre2DistortionPass()
+  : dataPtr(std::make_unique<Ogre2DistortionPassPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2DistortionPass::~Ogre2DistortionPass()
+{
+}
+
+//////////////////////////////////////////////////
+void Ogre2DistortionPass::PreRender()
+{
+  if (!this->dataPtr->distortionMat || !this->ogreCamera)
+    return;
+
+  if (!this->enabled)
+    return;
+
+  // the focal length follows the camera, whose fov and aspect ratio may
+  // change after the pass is created
+  const double tanHalfFovY =
+      std::tan(this->ogreCamera->getFOVy().valueRadians() * 0.5);
+  const math::Vector2d invFocal(
+      2.0 * tanHalfFovY * this->ogreCamera->getAspectRatio(),
+      2.0 * tanHalfFovY);
+
+  // crop the black borders of barrel distortion by scaling the image up
+  // so that the distorted corners of the undistorted image are the new
+  // corners
+  math::Vector2d scale(1.0, 1.0);
+  if (this->k1 < 0)
+  {
+    math::Vector2d newScale =
+        Distort(*this, math::Vector2d(1.0, 1.0), invFocal) -
+        Distort(*this, math::Vector2d(0.0, 0.0), invFocal);
+    // If the scale is extremely small, don't crop
+    if (newScale.X() < 1e-7 || newScale.Y() < 1e-7)
+    {
+      ignerr << "Distortion model attempted to apply a scale parameter of ("
+             << newScale.X() << ", " << newScale.Y()
+             << "), which is invalid." << std::endl;
+    }
+    else
+    {
+      scale = newScale;
+    }
+  }
+
+  // These calls are setting parameters that are declared in two places:
+  // 1. media/materials/scripts/distortion.material, in
+  //    fragment_program DistortionFS
+  // 2. media/materials/programs/GLSL/distortion_fs.glsl
+  Ogre::Pass *pass =
+      this->dataPtr->distortionMat->getTechnique(0)->getPass(0);
+  Ogre::GpuProgramParametersSharedPtr psParams =
+      pass->getFragmentProgramParameters();
+  psParams->setNamedConstant("radialCoeffs", Ogre::Vector3(
+      static_cast<Ogre::Real>(this->k1),
+      static_cast<Ogre::Real>(this->k2),
+      static_cast<Ogre::Real>(this->k3)));
+  psParams->setNamedConstant("tangentialCoeffs", Ogre::Vector2(
+      static_cast<Ogre::Real>(this->p1),
+      static_cast<Ogre::Real>(this->p2)));
+  psParams->setNamedConstant("center", Ogre::Vector2(
+      static_cast<Ogre::Real>(this->lensCenter.X()),
+      static_cast<Ogre::Real>(this->lensCenter.Y())));
+  psParams->setNamedConstant("invFocal", Ogre::Vector2(
+      static_cast<Ogre::Real>(invFocal.X()),
+      static_cast<Ogre::Real>(invFocal.Y())));
+  psParams->setNamedConstant("scale", Ogre::Vector2(
+      static_cast<Ogre::Real>(scale.X()),
+      static_cast<Ogre::Real>(scale.Y())));
+}
+
+//////////////////////////////////////////////////
+void Ogre2DistortionPass::CreateRenderPass()
+{
+  // If no distortion is required, the pass is not connected
+  if (math::equal(this->k1, 0.0) &&
+      math::equal(this->k2, 0.0) &&
+      math::equal(this->k3, 0.0) &&
+      math::equal(this->p1, 0.0) &&
+      math::equal(this->p2, 0.0))
+  {
+    return;
+  }
+
+  static int distortionNodeCounter = 0;
+
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+
+  if (!this->ogreCompositorNodeDefName.empty() &&
+      ogreCompMgr->hasNodeDefinition(this->ogreCompositorNodeDefName))
+  {
+    return;
+  }
+
+  std::string nodeDefName = "DistortionNode_"
+      + std::to_string(distortionNodeCounter);
+
+  // The Distortion material is defined in script (distortion.material).
+  // clone the material
+  std::string matName = "Distortion";
+  Ogre::MaterialPtr ogreMat =
+      Ogre::MaterialManager::getSingleton().getByName(matName);
+  if (!ogreMat)
+  {
+    ignerr << "Distortion material not found: '" << matName << "'"
+           << std::endl;
+    return;
+  }
+  if (!ogreMat->isLoaded())
+    ogreMat->load();
+  std::string materialName = matName + "_" +
+      std::to_string(distortionNodeCounter);
+  this->dataPtr->distortionMat = ogreMat->clone(materialName).get();
+
+  // create the compostior node definition, equivalent to the script in
+  // Ogre2GaussianNoisePass::CreateRenderPass with the cloned distortion
+  // material
+
+  this->ogreCompositorNodeDefName = nodeDefName;
+  distortionNodeCounter++;
+
+  Ogre::CompositorNodeDef *nodeDef =
+      ogreCompMgr->addNodeDefinition(nodeDefName);
+
+  // Input texture
+  nodeDef->addTextureSourceName("rt_input", 0,
+      Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+  nodeDef->addTextureSourceName("rt_output", 1,
+      Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+
+  // rt_input target
+  nodeDef->setNumTargetPass(1);
+  Ogre::CompositorTargetDef *inputTargetDef =
+      nodeDef->addTargetPass("rt_output");
+  inputTargetDef->setNumPasses(1);
+  {
+    // quad pass
+    Ogre::CompositorPassQuadDef *passQuad =
+        static_cast<Ogre::CompositorPassQuadDef *>(
+        inputTargetDef->addPass(Ogre::PASS_QUAD));
+    passQuad->mMaterialName = materialName;
+    passQuad->addQuadTextureSource(0, "rt_input");
+  }
+  nodeDef->mapOutputChannel(0, "rt_output");
+  nodeDef->mapOutputChannel(1, "rt_input");
+}
+
+IGN_RENDERING_REGISTER_RENDER_PASS(Ogre2DistortionPass, DistortionPass)
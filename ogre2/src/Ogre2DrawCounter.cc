@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cstdint>
+
+#include "Ogre2DrawCounter.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+/// \brief Get the growth of a metric over a pass
+/// \param[in] _start Value before the pass
+/// \param[in] _end Value after the pass
+/// \return Growth, the end value if the metrics were reset in between
+static uint64_t Delta(size_t _start, size_t _end)
+{
+  return _end >= _start ? _end - _start : _end;
+}
+
+//////////////////////////////////////////////////
+Ogre2DrawCounter::Ogre2DrawCounter()
+{
+  Ogre::RenderSystem *renderSystem =
+      Ogre::Root::getSingleton().getRenderSystem();
+  if (renderSystem)
+    renderSystem->setMetricsRecordingEnabled(true);
+}
+
+//////////////////////////////////////////////////
+Ogre2DrawCounter::~Ogre2DrawCounter()
+{
+}
+
+//////////////////////////////////////////////////
+void Ogre2DrawCounter::BeginFrame()
+{
+  this->newFrame = true;
+  this->depth = 0u;
+}
+
+//////////////////////////////////////////////////
+DrawStats Ogre2DrawCounter::Stats() const
+{
+  return this->stats;
+}
+
+//////////////////////////////////////////////////
+void Ogre2DrawCounter::passPreExecute(Ogre::CompositorPass * /*_pass*/)
+{
+  if (this->newFrame)
+  {
+    unsigned int frameCount = this->stats.frameCount + 1u;
+    this->stats = DrawStats();
+    this->stats.frameCount = frameCount;
+    this->newFrame = false;
+  }
+
+  this->stats.passCount++;
+  if (this->depth++ > 0u)
+    return;
+
+  Ogre::RenderSystem *renderSystem =
+      Ogre::Root::getSingleton().getRenderSystem();
+  this->start = renderSystem->getMetrics();
+}
+
+//////////////////////////////////////////////////
+void Ogre2DrawCounter::passPosExecute(Ogre::CompositorPass * /*_pass*/)
+{
+  if (this->depth == 0u || --this->depth > 0u)
+    return;
+
+  Ogre::RenderSystem *renderSystem =
+      Ogre::Root::getSingleton().getRenderSystem();
+  const Ogre::RenderingMetrics &end = renderSystem->getMetrics();
+  this->stats.drawCallCount += Delta(this->start.mDrawCount,
+      end.mDrawCount);
+  this->stats.batchCount += Delta(this->start.mBatchCount, end.mBatchCount);
+  this->stats.instanceCount += Delta(this->start.mInstanceCount,
+      end.mInstanceCount);
+  this->stats.triangleCount += Delta(this->start.mFaceCount,
+      end.mFaceCount);
+  this->stats.vertexCount += Delta(this->start.mVertexCount,
+      end.mVertexCount);
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2DRAWCOUNTER_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2DRAWCOUNTER_HH_
+
+#include "ignition/rendering/RenderStats.hh"
+#include "ignition/rendering/ogre2/Ogre2Includes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Compositor workspace listener that counts the draw calls,
+    /// batches, instances and triangles of the passes of the workspaces it
+    /// is added to, from the metrics of the render system. The metrics are
+    /// read around each pass, so the counts of the passes of other sensors
+    /// or of the scene are left out.
+    class Ogre2DrawCounter : public Ogre::CompositorWorkspaceListener
+    {
+      /// \brief Constructor. Enables the recording of render system
+      /// metrics.
+      public: Ogre2DrawCounter();
+
+      /// \brief Destructor
+      public: virtual ~Ogre2DrawCounter();
+
+      /// \brief Start a new frame. Passes executed until the next call are
+      /// counted as one frame. Frames without passes, e.g. skipped by on
+      /// demand rendering, keep the counts of the last rendered frame.
+      public: void BeginFrame();
+
+      /// \brief Get the counts of the last rendered frame
+      /// \return Draw counts
+      public: DrawStats Stats() const;
+
+      // Documentation inherited.
+      public: virtual void passPreExecute(Ogre::CompositorPass *_pass)
+          override;
+
+      // Documentation inherited.
+      public: virtual void passPosExecute(Ogre::CompositorPass *_pass)
+          override;
+
+      /// \brief Metrics of the render system before the outermost pass
+      /// being executed
+      private: Ogre::RenderingMetrics start;
+
+      /// \brief Number of passes being executed, shadow node passes run
+      /// inside the scene pass that needs them
+      private: unsigned int depth = 0u;
+
+      /// \brief True if the next pass starts a new frame
+      private: bool newFrame = true;
+
+      /// \brief Counts of the frame being or last rendered
+      private: DrawStats stats;
+    };
+    }
+  }
+}
+#endif
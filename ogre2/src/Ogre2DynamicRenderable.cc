@@ -25,12 +25,19 @@
 #pragma warning(pop)
 #endif
 
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <utility>
+#include <vector>
+
 #include "ignition/common/Console.hh"
-#include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2DynamicRenderable.hh"
 #include "ignition/rendering/ogre2/Ogre2Material.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
+#include "ignition/rendering/ogre2/Ogre2Visual.hh"
 
 #ifdef _MSC_VER
   #pragma warning(push, 0)
@@ -48,11 +55,13 @@
 /// \brief Private implementation
 class ignition::rendering::Ogre2DynamicRenderablePrivate
 {
-  /// \brief list of colors at each point
-  public: std::vector<ignition::math::Color> colors;
+  /// \brief list of colors at each point, four bytes (RGBA) per point
+  public: std::vector<uint8_t> colors;
 
-  /// \brief List of vertices for the mesh
-  public: std::vector<ignition::math::Vector3d> vertices;
+  /// \brief Positions of the vertices of the mesh, three floats per vertex.
+  /// Kept in the layout of the vertex buffer so large point lists are
+  /// copied straight into it.
+  public: std::vector<float> positions;
 
   /// \brief Used to indicate if the lines require an update
   public: bool dirty = false;
@@ -78,6 +87,32 @@ class ignition::rendering::Ogre2DynamicRenderablePrivate
   /// \brief Maximum capacity of the currently allocated vertex buffer.
   public: size_t vertexBufferCapacity = 0;
 
+  /// \brief Index of the first vertex modified since the last update
+  public: size_t dirtyStart = std::numeric_limits<size_t>::max();
+
+  /// \brief One past the index of the last vertex modified since the last
+  /// update
+  public: size_t dirtyEnd = 0;
+
+  /// \brief Ranges of vertices, [first, second), modified in each of the
+  /// last updates, one entry per frame. Ogre keeps one copy of a dynamic
+  /// buffer per frame in flight and writes to the next copy every frame the
+  /// buffer is mapped, so a vertex modified once needs to be written in as
+  /// many updates as there are copies.
+  public: std::deque<std::pair<size_t, size_t>> dirtyHistory;
+
+  /// \brief Ogre frame count of the last update
+  public: uint32_t lastUpdateFrame = 0u;
+
+  /// \brief Number of consecutive updates in which the vertex count was
+  /// small enough to shrink the vertex buffer
+  public: unsigned int shrinkCount = 0u;
+
+  /// \brief Number of consecutive updates the vertex count has to stay
+  /// below a quarter of the capacity before the vertex buffer is shrunk.
+  /// This avoids recreating the vao when the vertex count fluctuates.
+  public: const unsigned int kShrinkUpdateCount = 30u;
+
   /// \brief Pointer to the dynamic renderable's material
   public: Ogre2MaterialPtr material;
 
@@ -96,6 +131,18 @@ class ignition::rendering::Ogre2DynamicRenderablePrivate
 using namespace ignition;
 using namespace rendering;
 
+//////////////////////////////////////////////////
+/// \brief Convert a color to four bytes
+/// \param[in] _color Color to convert
+/// \param[out] _rgba Red, green, blue and alpha bytes
+static void ColorToRGBA(const math::Color &_color, uint8_t *_rgba)
+{
+  _rgba[0] = static_cast<uint8_t>(_color.R() * 255.0f);
+  _rgba[1] = static_cast<uint8_t>(_color.G() * 255.0f);
+  _rgba[2] = static_cast<uint8_t>(_color.B() * 255.0f);
+  _rgba[3] = static_cast<uint8_t>(_color.A() * 255.0f);
+}
+
 //////////////////////////////////////////////////
 Ogre2DynamicRenderable::Ogre2DynamicRenderable(
     ScenePtr _scene)
@@ -130,6 +177,8 @@ void Ogre2DynamicRenderable::Destroy()
   // destroy ogre item
   this->dataPtr->sceneManager->destroyItem(this->dataPtr->ogreItem);
   this->dataPtr->ogreItem = nullptr;
+  std::dynamic_pointer_cast<Ogre2Scene>(
+      this->dataPtr->scene)->MarkVisibilityLayersDirty();
 
   // remove mesh from mesh manager
   if (this->dataPtr->subMesh &&
@@ -207,6 +256,8 @@ void Ogre2DynamicRenderable::CreateDynamicMesh()
 
   this->dataPtr->ogreItem =
       this->dataPtr->sceneManager->createItem(mesh, Ogre::SCENE_DYNAMIC);
+  std::dynamic_pointer_cast<Ogre2Scene>(
+      this->dataPtr->scene)->MarkVisibilityLayersDirty();
 }
 
 //////////////////////////////////////////////////
@@ -225,7 +276,7 @@ void Ogre2DynamicRenderable::UpdateBuffer()
   // Prepare vertex buffer
   unsigned int newVertCapacity = this->dataPtr->vertexBufferCapacity;
 
-  unsigned int vertexCount = this->dataPtr->vertices.size();
+  unsigned int vertexCount = this->dataPtr->positions.size() / 3u;
   if ((vertexCount > this->dataPtr->vertexBufferCapacity) ||
       (!this->dataPtr->vertexBufferCapacity))
   {
@@ -239,21 +290,34 @@ void Ogre2DynamicRenderable::UpdateBuffer()
     // Make capacity the next power of two
     while (newVertCapacity < vertexCount)
       newVertCapacity <<= 1;
+    this->dataPtr->shrinkCount = 0u;
   }
-  else if (vertexCount < this->dataPtr->vertexBufferCapacity>>1)
+  else if (vertexCount < this->dataPtr->vertexBufferCapacity>>2)
   {
-    // Make capacity the previous power of two
-    unsigned int newCapacity = newVertCapacity >>1;
-    while (vertexCount < newCapacity)
+    // Only shrink if the vertex count stays low for a while
+    if (++this->dataPtr->shrinkCount >= this->dataPtr->kShrinkUpdateCount)
     {
-      newVertCapacity = newCapacity;
-      newCapacity >>= 1;
+      // Make capacity the smallest power of two that leaves room to grow
+      // back to twice the vertex count
+      unsigned int newCapacity = newVertCapacity >>1;
+      while (vertexCount < newCapacity>>1)
+      {
+        newVertCapacity = newCapacity;
+        newCapacity >>= 1;
+      }
+      this->dataPtr->shrinkCount = 0u;
     }
   }
+  else
+  {
+    this->dataPtr->shrinkCount = 0u;
+  }
 
   // recreate vao if needed
+  bool vaoRecreated = false;
   if (newVertCapacity != this->dataPtr->vertexBufferCapacity)
   {
+    vaoRecreated = true;
     this->dataPtr->vertexBufferCapacity = newVertCapacity;
 
     this->DestroyBuffer();
@@ -289,58 +353,117 @@ void Ogre2DynamicRenderable::UpdateBuffer()
     this->dataPtr->subMesh->mVao[Ogre::VpNormal].push_back(this->dataPtr->vao);
     // Use the same geometry for shadow casting.
     this->dataPtr->subMesh->mVao[Ogre::VpShadow].push_back(this->dataPtr->vao);
-  }
 
-  // map buffer and update the geometry
-  Ogre::Aabb bbox;
-  float * RESTRICT_ALIAS vertices = reinterpret_cast<float * RESTRICT_ALIAS>(
-      this->dataPtr->vertexBuffer->map(
-      0, this->dataPtr->vertexBuffer->getNumElements()));
+    // every copy of the new buffer needs all vertices
+    this->dataPtr->dirtyHistory.assign(
+        vaoManager->getDynamicBufferMultiplier(),
+        std::make_pair(size_t(0u), size_t(vertexCount)));
+  }
 
-  // fill vertices
-  for (unsigned int i = 0; i < vertexCount; ++i)
+  // Normals of triangles depend on neighbouring vertices so upload all
+  // vertices. Otherwise only upload the vertices modified since they were
+  // last written to each buffer region.
+  bool triangles =
+      this->dataPtr->operationType != Ogre::OperationType::OT_POINT_LIST &&
+      this->dataPtr->operationType != Ogre::OperationType::OT_LINE_LIST &&
+      this->dataPtr->operationType != Ogre::OperationType::OT_LINE_STRIP;
+  if (triangles)
+  {
+    this->dataPtr->dirtyStart = 0u;
+    this->dataPtr->dirtyEnd = vertexCount;
+  }
+  auto dirtyRange = std::make_pair(this->dataPtr->dirtyStart,
+      this->dataPtr->dirtyEnd);
+  this->dataPtr->dirtyStart = std::numeric_limits<size_t>::max();
+  this->dataPtr->dirtyEnd = 0u;
+
+  // Ogre only moves on to the next buffer copy once per frame
+  uint32_t frame = vaoManager->getFrameCount();
+  if (vaoRecreated || frame != this->dataPtr->lastUpdateFrame)
+  {
+    this->dataPtr->dirtyHistory.push_back(dirtyRange);
+    while (this->dataPtr->dirtyHistory.size() >
+        vaoManager->getDynamicBufferMultiplier())
+    {
+      this->dataPtr->dirtyHistory.pop_front();
+    }
+  }
+  else
   {
-    unsigned int idx = i*6;
-    Ogre::Vector3 v = Ogre2Conversions::Convert(this->dataPtr->vertices[i]);
-    vertices[idx] = v.x;
-    vertices[idx+1] = v.y;
-    vertices[idx+2] = v.z;
+    auto &last = this->dataPtr->dirtyHistory.back();
+    last.first = std::min(last.first, dirtyRange.first);
+    last.second = std::max(last.second, dirtyRange.second);
+  }
+  this->dataPtr->lastUpdateFrame = frame;
 
-    bbox.merge(v);
+  // upload everything modified since the copy being mapped was last written
+  auto range = std::make_pair(std::numeric_limits<size_t>::max(),
+      size_t(0u));
+  for (const auto &r : this->dataPtr->dirtyHistory)
+  {
+    range.first = std::min(range.first, r.first);
+    range.second = std::max(range.second, r.second);
   }
+  range.second = std::min<size_t>(range.second, vertexCount);
 
-  // fill the rest of the buffer with the position of the last vertex to avoid
-  // the geometry connecting back to 0, 0, 0
-  if (vertexCount > 0 && vertexCount < this->dataPtr->vertexBufferCapacity)
+  // only draw the vertices in use instead of the whole buffer capacity
+  this->dataPtr->vao->setPrimitiveRange(0u, vertexCount);
+
+  // map the dirty range and update the geometry
+  if (range.first < range.second)
   {
-    math::Vector3d lastVertex = this->dataPtr->vertices[vertexCount-1];
-    for (unsigned int i = vertexCount; i < this->dataPtr->vertexBufferCapacity;
-        ++i)
+    float * RESTRICT_ALIAS vertices =
+        reinterpret_cast<float * RESTRICT_ALIAS>(
+        this->dataPtr->vertexBuffer->map(
+        range.first, range.second - range.first));
+
+    // fill vertices
+    const float *positions = this->dataPtr->positions.data();
+    for (size_t i = range.first; i < range.second; ++i)
     {
-      unsigned int idx = i * 6;
-      vertices[idx] = lastVertex.X();
-      vertices[idx+1] = lastVertex.Y();
-      vertices[idx+2] = lastVertex.Z();
-
+      size_t idx = (i - range.first) * 6;
+      vertices[idx] = positions[i*3];
+      vertices[idx+1] = positions[i*3+1];
+      vertices[idx+2] = positions[i*3+2];
       vertices[idx+3] = 0;
       vertices[idx+4] = 0;
-      vertices[idx+5] = 1;
+      vertices[idx+5] = 0;
     }
-  }
 
-  // fill normals
-  this->GenerateNormals(this->dataPtr->operationType, this->dataPtr->vertices,
-      vertices);
+    // fill normals. The mapped range always starts at the first vertex
+    // for triangles
+    this->GenerateNormals(this->dataPtr->operationType,
+        range.second - range.first, vertices);
 
-  // unmap buffer
-  this->dataPtr->vertexBuffer->unmap(Ogre::UO_KEEP_PERSISTENT);
+    // unmap buffer
+    this->dataPtr->vertexBuffer->unmap(Ogre::UO_KEEP_PERSISTENT);
+  }
+
+  Ogre::Aabb bbox;
+  if (vertexCount > 0u)
+  {
+    const float *positions = this->dataPtr->positions.data();
+    Ogre::Vector3 min(positions[0], positions[1], positions[2]);
+    Ogre::Vector3 max = min;
+    for (unsigned int i = 1; i < vertexCount; ++i)
+    {
+      Ogre::Vector3 v(positions[i*3], positions[i*3+1], positions[i*3+2]);
+      min.makeFloor(v);
+      max.makeCeil(v);
+    }
+    bbox = Ogre::Aabb::newFromExtents(min, max);
+  }
 
   // Set the bounds to get frustum culling and LOD to work correctly.
   Ogre::Mesh *mesh = this->dataPtr->subMesh->mParent;
   mesh->_setBounds(bbox, true);
 
   // update item aabb
-  if (this->dataPtr->ogreItem)
+  if (this->dataPtr->ogreItem && !vaoRecreated)
+  {
+    this->dataPtr->ogreItem->setLocalAabb(bbox);
+  }
+  else if (this->dataPtr->ogreItem)
   {
     bool castShadows = this->dataPtr->ogreItem->getCastShadows();
     auto lowLevelMat = this->dataPtr->ogreItem->getSubItem(0)->getMaterial();
@@ -368,6 +491,21 @@ void Ogre2DynamicRenderable::UpdateBuffer()
     }
   }
 
+  // the visual the item is attached to caches its bounding box. Its id is
+  // the user data of the item
+  if (this->dataPtr->ogreItem)
+  {
+    const Ogre::Any &any =
+        this->dataPtr->ogreItem->getUserObjectBindings().getUserAny();
+    if (!any.isEmpty() && any.getType() == typeid(unsigned int))
+    {
+      Ogre2VisualPtr visual = std::dynamic_pointer_cast<Ogre2Visual>(
+          this->dataPtr->scene->VisualById(Ogre::any_cast<unsigned int>(any)));
+      if (visual)
+        visual->MarkBoundsDirty();
+    }
+  }
+
   this->dataPtr->dirty = false;
 }
 
@@ -445,13 +583,20 @@ MarkerType Ogre2DynamicRenderable::OperationType() const
 void Ogre2DynamicRenderable::AddPoint(const ignition::math::Vector3d &_pt,
                                       const ignition::math::Color &_color)
 {
-  this->dataPtr->vertices.push_back(_pt);
+  size_t vertexCount = this->dataPtr->positions.size() / 3u;
+  this->dataPtr->positions.push_back(static_cast<float>(_pt.X()));
+  this->dataPtr->positions.push_back(static_cast<float>(_pt.Y()));
+  this->dataPtr->positions.push_back(static_cast<float>(_pt.Z()));
+  this->dataPtr->dirtyStart = std::min(this->dataPtr->dirtyStart,
+      vertexCount);
+  this->dataPtr->dirtyEnd = vertexCount + 1u;
 
   // todo(anyone)
   // setting material works but vertex coloring does not work yet.
   // It requires using an unlit datablock:
   // https://forums.ogre3d.org/viewtopic.php?t=93627#p539276
-  this->dataPtr->colors.push_back(_color);
+  this->dataPtr->colors.resize(this->dataPtr->colors.size() + 4u);
+  ColorToRGBA(_color, &this->dataPtr->colors[vertexCount * 4u]);
 
   this->dataPtr->dirty = true;
 }
@@ -463,18 +608,46 @@ void Ogre2DynamicRenderable::AddPoint(double _x, double _y, double _z,
   this->AddPoint(ignition::math::Vector3d(_x, _y, _z), _color);
 }
 
+/////////////////////////////////////////////////
+void Ogre2DynamicRenderable::SetPoints(const float *_xyz,
+    const uint8_t *_rgba, std::size_t _count)
+{
+  if (_count == 0u)
+  {
+    this->Clear();
+    return;
+  }
+
+  this->dataPtr->positions.assign(_xyz, _xyz + _count * 3u);
+  if (_rgba)
+    this->dataPtr->colors.assign(_rgba, _rgba + _count * 4u);
+  else
+    this->dataPtr->colors.assign(_count * 4u, 255u);
+
+  this->dataPtr->dirtyStart = 0u;
+  this->dataPtr->dirtyEnd = _count;
+  this->dataPtr->dirty = true;
+}
+
 /////////////////////////////////////////////////
 void Ogre2DynamicRenderable::SetPoint(unsigned int _index,
                                       const ignition::math::Vector3d &_value)
 {
-  if (_index >= this->dataPtr->vertices.size())
+  unsigned int vertexCount = this->PointCount();
+  if (_index >= vertexCount)
   {
     ignerr << "Point index[" << _index << "] is out of bounds[0-"
-           << this->dataPtr->vertices.size()-1 << "]\n";
+           << vertexCount-1 << "]\n";
     return;
   }
 
-  this->dataPtr->vertices[_index] = _value;
+  this->dataPtr->positions[_index*3] = static_cast<float>(_value.X());
+  this->dataPtr->positions[_index*3+1] = static_cast<float>(_value.Y());
+  this->dataPtr->positions[_index*3+2] = static_cast<float>(_value.Z());
+  this->dataPtr->dirtyStart = std::min<size_t>(this->dataPtr->dirtyStart,
+      _index);
+  this->dataPtr->dirtyEnd = std::max<size_t>(this->dataPtr->dirtyEnd,
+      _index + 1u);
 
   this->dataPtr->dirty = true;
 }
@@ -483,10 +656,11 @@ void Ogre2DynamicRenderable::SetPoint(unsigned int _index,
 void Ogre2DynamicRenderable::SetColor(unsigned int _index,
                                       const ignition::math::Color &_color)
 {
-  if (_index >= this->dataPtr->colors.size())
+  unsigned int colorCount = this->dataPtr->colors.size() / 4u;
+  if (_index >= colorCount)
   {
     ignerr << "Point color index[" << _index << "] is out of bounds[0-"
-           << this->dataPtr->colors.size()-1 << "]\n";
+           << colorCount-1 << "]\n";
     return;
   }
 
@@ -494,7 +668,7 @@ void Ogre2DynamicRenderable::SetColor(unsigned int _index,
   // todo(anyone)
   // vertex coloring does not work yet. It requires using an unlit datablock:
   // https://forums.ogre3d.org/viewtopic.php?t=93627#p539276
-  this->dataPtr->colors[_index] = _color;
+  ColorToRGBA(_color, &this->dataPtr->colors[_index*4]);
 
   // uncomment this line when colors are working
   // this->dataPtr->dirty = true;
@@ -504,32 +678,34 @@ void Ogre2DynamicRenderable::SetColor(unsigned int _index,
 ignition::math::Vector3d Ogre2DynamicRenderable::Point(
     const unsigned int _index) const
 {
-  if (_index >= this->dataPtr->vertices.size())
+  unsigned int vertexCount = this->PointCount();
+  if (_index >= vertexCount)
   {
     ignerr << "Point index[" << _index << "] is out of bounds[0-"
-           << this->dataPtr->vertices.size()-1 << "]\n";
+           << vertexCount-1 << "]\n";
 
     return ignition::math::Vector3d(ignition::math::INF_D,
                                     ignition::math::INF_D,
                                     ignition::math::INF_D);
   }
 
-  return this->dataPtr->vertices[_index];
+  const float *position = &this->dataPtr->positions[_index*3];
+  return ignition::math::Vector3d(position[0], position[1], position[2]);
 }
 
 /////////////////////////////////////////////////
 unsigned int Ogre2DynamicRenderable::PointCount() const
 {
-  return this->dataPtr->vertices.size();
+  return this->dataPtr->positions.size() / 3u;
 }
 
 /////////////////////////////////////////////////
 void Ogre2DynamicRenderable::Clear()
 {
-  if (this->dataPtr->vertices.empty() && this->dataPtr->colors.empty())
+  if (this->dataPtr->positions.empty() && this->dataPtr->colors.empty())
     return;
 
-  this->dataPtr->vertices.clear();
+  this->dataPtr->positions.clear();
   this->dataPtr->colors.clear();
   this->dataPtr->dirty = true;
 }
@@ -553,6 +729,10 @@ void Ogre2DynamicRenderable::SetMaterial(MaterialPtr _material, bool _unique)
   if (this->dataPtr->material && this->dataPtr->ownsMaterial)
     this->dataPtr->scene->DestroyMaterial(this->dataPtr->material);
 
+  // the item is not notified when a shared datablock is copied on write so
+  // it keeps a datablock of its own
+  derived->UnshareDatablock();
+
   this->dataPtr->ownsMaterial = _unique;
 
   this->dataPtr->material = derived;
@@ -566,9 +746,12 @@ void Ogre2DynamicRenderable::SetMaterial(MaterialPtr _material, bool _unique)
 
 //////////////////////////////////////////////////
 void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
-  const std::vector<math::Vector3d> &_vertices, float *_vbuffer)
+  unsigned int _vertexCount, float *_vbuffer)
 {
-  unsigned int vertexCount = _vertices.size();
+  auto position = [_vbuffer](unsigned int _i)
+  {
+    return math::Vector3d(_vbuffer[_i*6], _vbuffer[_i*6+1], _vbuffer[_i*6+2]);
+  };
   // Each vertex occupies 6 elements in the vbuffer float array:
   // vbuffer[i]   : position x
   // vbuffer[i+1] : position y
@@ -584,18 +767,18 @@ void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
       return;
     case Ogre::OperationType::OT_TRIANGLE_LIST:
     {
-      if (vertexCount < 3)
+      if (_vertexCount < 3)
         return;
 
-      for (unsigned int i = 0; i < vertexCount / 3; ++i)
+      for (unsigned int i = 0; i < _vertexCount / 3; ++i)
       {
         unsigned int idx = i*3;
         unsigned int idx1 = idx * 6;
         unsigned int idx2 = idx1 + 6;
         unsigned int idx3 = idx2 + 6;
-        math::Vector3d v1 = _vertices[idx];
-        math::Vector3d v2 = _vertices[idx+1];
-        math::Vector3d v3 = _vertices[idx+2];
+        math::Vector3d v1 = position(idx);
+        math::Vector3d v2 = position(idx+1);
+        math::Vector3d v3 = position(idx+2);
         math::Vector3d n = (v1 - v2).Cross((v1 - v3));
 
         _vbuffer[idx1+3] = n.X();
@@ -613,15 +796,15 @@ void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
     }
     case Ogre::OperationType::OT_TRIANGLE_STRIP:
     {
-      if (vertexCount < 3)
+      if (_vertexCount < 3)
         return;
 
       bool even = false;
-      for (unsigned int i = 0; i < vertexCount - 2; ++i)
+      for (unsigned int i = 0; i < _vertexCount - 2; ++i)
       {
         math::Vector3d v1;
         math::Vector3d v2;
-        math::Vector3d v3 = _vertices[i+2];
+        math::Vector3d v3 = position(i+2);
 
         // For odd n, vertices n, n+1, and n+2 define triangle n.
         // For even n, vertices n+1, n, and n+2 define triangle n.
@@ -630,15 +813,15 @@ void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
         unsigned int idx3 = (i+2) * 6;
         if (even)
         {
-          v1 = _vertices[i+1];
-          v2 = _vertices[i];
+          v1 = position(i+1);
+          v2 = position(i);
           idx1 = (i+1) * 6;
           idx2 = i*6;
         }
         else
         {
-          v1 = _vertices[i];
-          v2 = _vertices[i+1];
+          v1 = position(i);
+          v2 = position(i+1);
           idx1 = i*6;
           idx2 = (i+1) * 6;
         }
@@ -671,18 +854,18 @@ void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
     }
     case Ogre::OperationType::OT_TRIANGLE_FAN:
     {
-      if (vertexCount < 3)
+      if (_vertexCount < 3)
         return;
 
       unsigned int idx1 = 0;
-      math::Vector3d v1 = _vertices[0];
+      math::Vector3d v1 = position(0);
 
-      for (unsigned int i = 0; i < vertexCount - 2; ++i)
+      for (unsigned int i = 0; i < _vertexCount - 2; ++i)
       {
         unsigned int idx2 = (i+1) * 6;
         unsigned int idx3 = idx2 + 6;
-        math::Vector3d v2 = _vertices[i+1];
-        math::Vector3d v3 = _vertices[i+2];
+        math::Vector3d v2 = position(i+1);
+        math::Vector3d v3 = position(i+2);
         math::Vector3d n = (v1 - v2).Cross((v1 - v3));
 
         math::Vector3d n1(_vbuffer[idx1+3], _vbuffer[idx1+4], _vbuffer[idx1+5]);
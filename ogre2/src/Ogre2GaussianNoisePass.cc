@@ -15,6 +15,8 @@
  *
  */
 
+#include <string>
+#include <typeinfo>
 
 #include <ignition/common/Console.hh>
 
@@ -48,6 +50,9 @@ class ignition::rendering::Ogre2GaussianNoisePassPrivate
 using namespace ignition;
 using namespace rendering;
 
+/// \brief Maximum number of passes fused into one, see gaussian_noise_fs
+static const unsigned int kMaxFusedPasses = 3u;
+
 //////////////////////////////////////////////////
 Ogre2GaussianNoisePass::Ogre2GaussianNoisePass()
   : dataPtr(std::make_unique<Ogre2GaussianNoisePassPrivate>())
@@ -89,6 +94,43 @@ void Ogre2GaussianNoisePass::PreRender()
   psParams->setNamedConstant("mean", static_cast<Ogre::Real>(this->mean));
   psParams->setNamedConstant("stddev",
       static_cast<Ogre::Real>(this->stdDev));
+
+  // noise of the passes fused into this one. Disabled or destroyed passes
+  // get a zero mean and stddev, which the shader skips.
+  const auto &fusedPasses = this->FusedPasses();
+  for (unsigned int i = 1u; i <= kMaxFusedPasses; ++i)
+  {
+    double fusedMean = 0.0;
+    double fusedStdDev = 0.0;
+    if (i <= fusedPasses.size())
+    {
+      auto fused = std::dynamic_pointer_cast<Ogre2GaussianNoisePass>(
+          fusedPasses[i - 1u].lock());
+      if (fused && fused->IsEnabled())
+      {
+        fusedMean = fused->Mean();
+        fusedStdDev = fused->StdDev();
+      }
+    }
+    Ogre::Vector3 fusedOffsets(ignition::math::Rand::DblUniform(0.0, 1.0),
+                               ignition::math::Rand::DblUniform(0.0, 1.0),
+                               ignition::math::Rand::DblUniform(0.0, 1.0));
+    std::string suffix = std::to_string(i);
+    psParams->setNamedConstant("offsets" + suffix, fusedOffsets);
+    psParams->setNamedConstant("mean" + suffix,
+        static_cast<Ogre::Real>(fusedMean));
+    psParams->setNamedConstant("stddev" + suffix,
+        static_cast<Ogre::Real>(fusedStdDev));
+  }
+}
+
+//////////////////////////////////////////////////
+bool Ogre2GaussianNoisePass::CanFuse(const Ogre2RenderPass &_pass) const
+{
+  // passes of derived types use other materials
+  return typeid(*this) == typeid(Ogre2GaussianNoisePass) &&
+      typeid(_pass) == typeid(*this) &&
+      this->FusedPasses().size() < kMaxFusedPasses;
 }
 
 //////////////////////////////////////////////////
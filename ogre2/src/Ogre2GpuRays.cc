@@ -15,10 +15,22 @@
  *
 */
 
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ignition/math/Pose3.hh>
 #include <ignition/math/Vector2.hh>
 #include <ignition/math/Vector3.hh>
 
 #include <ignition/common/Console.hh>
+#include <ignition/common/Profiler.hh>
 #include <ignition/math/Helpers.hh>
 
 #include "ignition/rendering/ogre2/Ogre2Camera.hh"
@@ -33,8 +45,13 @@
 #include "ignition/rendering/ogre2/Ogre2Sensor.hh"
 #include "ignition/rendering/ogre2/Ogre2Visual.hh"
 
+#include "Ogre2Cubemap.hh"
 #include "Ogre2IgnHlmsCustomizations.hh"
+#include "Ogre2MaterialOverride.hh"
 #include "Ogre2ParticleNoiseListener.hh"
+#include "Ogre2ShaderNoise.hh"
+#include "Ogre2VertexDeformation.hh"
+#include "Ogre2WorkerPool.hh"
 #include "Terra/Hlms/PbsListener/OgreHlmsPbsTerraShadows.h"
 
 #ifdef _MSC_VER
@@ -49,6 +66,7 @@
 #include <OgreRoot.h>
 #include <OgreSceneManager.h>
 #include <OgreTechnique.h>
+#include <OgreViewport.h>
 #ifdef _MSC_VER
   #pragma warning(pop)
 #endif
@@ -59,6 +77,47 @@ namespace rendering
 {
 inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
 //
+/// \brief Laser retro values of the ogre items of a scene. Resolving them
+/// means a visual lookup and parsing the user data of every visual, so they
+/// are resolved once, shared by all gpu rays sensors in the same scene and
+/// only resolved again when items are created or destroyed or a laser retro
+/// value changes. The values are stored in a custom parameter of the sub
+/// items when resolved, so switching to the laser retro material does not
+/// have to set them again for every pass.
+class Ogre2LaserRetroSources
+{
+  /// \brief Get the laser retro values shared by gpu rays of a scene
+  /// \param[in] _scene Scene the values belong to
+  /// \return Laser retro values of the scene, created if none exist yet
+  public: static std::shared_ptr<Ogre2LaserRetroSources> Shared(
+              Ogre2ScenePtr _scene);
+
+  /// \brief Re-resolve the laser retro values if they are out of date
+  /// \param[in] _scene Scene to resolve the values from
+  public: void Update(Ogre2ScenePtr _scene);
+
+  /// \brief Get the laser retro value of a visual from its user data
+  /// \param[in] _visual Visual to get the value of
+  /// \return Laser retro value clamped to [0, 2000], 0 if not set
+  private: static float LaserRetro(const VisualPtr &_visual);
+
+  /// \brief Custom parameter index of laser retro value in an ogre subitem.
+  /// This has to match the custom index specifed in LaserRetroSource
+  /// material script in media/materials/scripts/gpu_rays.material. It
+  /// differs from the index used by thermal cameras, which set their
+  /// custom parameter before every pass.
+  public: static const unsigned int kCustomParamIdx = 11u;
+
+  /// \brief True if the values have been resolved at least once
+  private: bool resolved = false;
+
+  /// \brief Scene visibility layers revision the values were resolved for
+  private: uint64_t itemsRevision = 0u;
+
+  /// \brief Scene laser retro revision the values were resolved for
+  private: uint64_t laserRetrosRevision = 0u;
+};
+
 /// \brief Helper class for switching the ogre item's material to laser retro
 /// source material when a thermal camera is being rendered.
 class Ogre2LaserRetroMaterialSwitcher : public Ogre::Camera::Listener
@@ -83,17 +142,140 @@ class Ogre2LaserRetroMaterialSwitcher : public Ogre::Camera::Listener
   /// \brief Scene manager
   private: Ogre2ScenePtr scene = nullptr;
 
+  /// \brief Laser retro values of the scene, shared with other gpu rays
+  private: std::shared_ptr<Ogre2LaserRetroSources> laserRetroSources;
+
   /// \brief Pointer to the laser retro source material
   private: Ogre::MaterialPtr laserRetroSourceMaterial;
 
-  /// \brief Custom parameter index of laser retro value in an ogre subitem.
-  /// This has to match the custom index specifed in LaserRetroSource material
-  /// script in media/materials/scripts/gpu_rays.material
-  private: const unsigned int customParamIdx = 10u;
+  /// \brief Ogre sub items with low level materials switched to the laser
+  /// retro material and their original material
+  private: std::vector<std::pair<Ogre::SubItem *, Ogre::MaterialPtr>>
+      materials;
+};
+
+/// \brief A group of co-located gpu rays sensors that share the 1st pass
+/// cubemap rendered by the group leader
+class Ogre2GpuRaysGroup
+{
+  /// \brief Sensor that renders the shared cubemap
+  public: Ogre2GpuRays *leader = nullptr;
+
+  /// \brief Cubemap faces sampled by each sensor in the group, including
+  /// the leader
+  public: std::map<Ogre2GpuRays *, std::set<unsigned int>> members;
 
-  /// \brief A map of ogre sub item pointer to their original hlms material
-  private: std::map<Ogre::SubItem *, Ogre::HlmsDatablock *> datablockMap;
+  /// \brief Union of the cubemap faces sampled by all sensors in the group.
+  /// These are the faces rendered by the leader
+  public: std::set<unsigned int> cubeFaceIdx;
+};
+
+/// \brief Range of consecutive columns of a scan rendered in time
+/// segments, see GpuRays::SetScanSegmentCount. The columns are sampled from
+/// cubemap faces rendered at the pose of the sensor in the middle of the
+/// segment
+class Ogre2GpuRaysSegment
+{
+  /// \brief First column of the 2nd pass output in the segment
+  public: unsigned int columnBegin = 0u;
+
+  /// \brief One past the last column of the 2nd pass output in the segment
+  public: unsigned int columnEnd = 0u;
+
+  /// \brief Cubemap faces sampled by the rays of the segment
+  public: std::set<unsigned int> cubeFaceIdx;
+
+  /// \brief 1st pass textures of the sampled cubemap faces
+  public: Ogre::TextureGpu *firstPassTextures[6] = {};
+
+  /// \brief 1st pass compositor workspaces of the sampled cubemap faces
+  public: Ogre::CompositorWorkspace *ogreCompositorWorkspace1st[6] = {};
+
+  /// \brief 2nd pass material sampling the textures of the segment
+  public: Ogre::MaterialPtr matSecondPass;
 };
+
+/// \brief Get a ray group of a scene, creating it if it does not exist
+/// \param[in] _scene Scene of the sensors in the group
+/// \param[in] _name Name of the group
+/// \return Ray group
+static Ogre2GpuRaysGroup &RayGroup(Ogre2ScenePtr _scene,
+    const std::string &_name)
+{
+  auto &group = _scene->GpuRaysGroups()[_name];
+  if (!group)
+    group = std::make_shared<Ogre2GpuRaysGroup>();
+  return *group;
+}
+
+/// \brief Add the definition of a compositor workspace running quad passes
+/// on the 2nd pass output, if it does not exist yet
+/// \param[in] _wsDefName Name of the workspace definition. Its node
+/// definition is named _wsDefName + "/Node"
+/// \param[in] _materialNames Material of each quad pass. The first pass
+/// clears the output, the others draw on top of it
+/// \param[in] _clearColour Colour the output is cleared to
+static void Add2ndPassWorkspaceDefinition(const std::string &_wsDefName,
+    const std::vector<std::string> &_materialNames,
+    const Ogre::ColourValue &_clearColour)
+{
+  Ogre::CompositorManager2 *ogreCompMgr =
+      Ogre2RenderEngine::Instance()->OgreRoot()->getCompositorManager2();
+  if (ogreCompMgr->hasWorkspaceDefinition(_wsDefName))
+    return;
+
+  std::string nodeDefName = _wsDefName + "/Node";
+  Ogre::CompositorNodeDef *nodeDef =
+      ogreCompMgr->addNodeDefinition(nodeDefName);
+  // Input texture
+  nodeDef->addTextureSourceName("rt_input", 0,
+      Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+  nodeDef->setNumTargetPass(1);
+  {
+    Ogre::CompositorTargetDef *inputTargetDef =
+        nodeDef->addTargetPass("rt_input");
+    inputTargetDef->setNumPasses(_materialNames.size());
+
+    for (unsigned int k = 0; k < _materialNames.size(); ++k)
+    {
+      // quad pass - sample from cubemap textures
+      Ogre::CompositorPassQuadDef *passQuad =
+          static_cast<Ogre::CompositorPassQuadDef *>(
+          inputTargetDef->addPass(Ogre::PASS_QUAD));
+      if (k == 0u)
+      {
+        passQuad->setAllLoadActions(Ogre::LoadAction::Clear);
+        passQuad->setAllClearColours(_clearColour);
+      }
+      else
+      {
+        passQuad->setAllLoadActions(Ogre::LoadAction::Load);
+      }
+      passQuad->mMaterialName = _materialNames[k];
+    }
+  }
+  nodeDef->mapOutputChannel(0, "rt_input");
+
+  Ogre::CompositorWorkspaceDef *workDef =
+      ogreCompMgr->addWorkspaceDefinition(_wsDefName);
+  workDef->connectExternal(0, nodeDef->getName(), 0);
+}
+
+/// \brief Round a number up to the next power of 2
+/// \param[in] _v Number to round, must be greater than 0
+/// \return Smallest power of 2 greater than or equal to _v
+static unsigned int RoundUpPowerOfTwo(unsigned int _v)
+{
+  // https://graphics.stanford.edu/~seander/bithacks.html#RoundUpPowerOf2
+  _v--;
+  _v |= _v >> 1;
+  _v |= _v >> 2;
+  _v |= _v >> 4;
+  _v |= _v >> 8;
+  _v |= _v >> 16;
+  _v++;
+  return _v;
+}
 }
 }
 }
@@ -113,12 +295,32 @@ class ignition::rendering::Ogre2GpuRaysPrivate
                unsigned int, unsigned int, unsigned int,
                const std::string &)> newGpuRaysFrame;
 
-  /// \brief Raw buffer of gpu rays data.
-  public: float *gpuRaysBuffer = nullptr;
-
   /// \brief Outgoing gpu rays data, used by newGpuRaysFrame event.
   public: float *gpuRaysScan = nullptr;
 
+  /// \brief Event triggered with the gpu rays data in the output format
+  public: ignition::common::EventT<void(const void *,
+               unsigned int, unsigned int, unsigned int,
+               const std::string &)> newEncodedGpuRaysFrame;
+
+  /// \brief Event triggered when a new point cloud is available
+  public: ignition::common::EventT<void(const float *,
+               unsigned int, unsigned int, unsigned int,
+               const std::string &)> newGpuRaysPointCloud;
+
+  /// \brief Outgoing point cloud, used by newGpuRaysPointCloud if the
+  /// rows of the point cloud texture are padded
+  public: std::vector<float> pointCloud;
+
+  /// \brief Format gpu rays data is encoded to
+  /// \sa GpuRays::SetOutputFormat
+  public: PixelFormat outputFormat = PF_FLOAT32_RGB;
+
+  /// \brief Format of the data written by the 2nd pass. Same as
+  /// outputFormat, unless packed output is not available in which case
+  /// data is not encoded
+  public: PixelFormat secondPassFormat = PF_FLOAT32_RGB;
+
   /// \brief Pointer to Ogre material for the first rendering pass.
   public: Ogre::MaterialPtr matFirstPass;
 
@@ -128,9 +330,34 @@ class ignition::rendering::Ogre2GpuRaysPrivate
   /// \brief Cubemap cameras
   public: Ogre::Camera *cubeCam[6];
 
+  /// \brief Orientation of the cubemap cameras relative to the sensor
+  public: Ogre::Quaternion cubeCamOrientation[6];
+
+  /// \brief Time segments the scan is rendered in. Empty if the whole
+  /// scan is sampled from a single cubemap
+  public: std::vector<Ogre2GpuRaysSegment> segments;
+
   /// \brief Texture packed with cubemap face and uv data
   public: Ogre::TextureGpu *cubeUVTexture = nullptr;
 
+  /// \brief Texture packed with the direction of each ray in the sensor
+  /// frame. Only created if there are point cloud subscribers
+  public: Ogre::TextureGpu *rayDirTexture = nullptr;
+
+  /// \brief Point cloud texture, written by the point cloud pass
+  public: Ogre::TextureGpu *pointCloudTexture = nullptr;
+
+  /// \brief Materials of the point cloud pass, one for each 2nd pass
+  /// material
+  public: std::vector<Ogre::MaterialPtr> matPointCloud;
+
+  /// \brief Point cloud pass compositor workspace definition
+  public: std::string ogreCompositorWorkspaceDefPointCloud;
+
+  /// \brief Point cloud pass compositor workspace
+  public: Ogre::CompositorWorkspace *ogreCompositorWorkspacePointCloud =
+      nullptr;
+
   /// \brief Set of cubemap faces that are needed to generate the final
   /// range data
   public: std::set<unsigned int> cubeFaceIdx;
@@ -159,6 +386,11 @@ class ignition::rendering::Ogre2GpuRaysPrivate
   /// \brief Second pass texture.
   public: Ogre::TextureGpu * secondPassTexture = nullptr;
 
+  /// \brief True if the second pass writes tightly packed RGB data into a
+  /// single channel texture that is 3 times the width of the output.
+  /// False if it writes RGBA data that needs to be repacked on the CPU
+  public: bool packedOutput = false;
+
   /// \brief Pointer to the ogre camera
   public: Ogre::Camera *ogreCamera = nullptr;
 
@@ -168,6 +400,17 @@ class ignition::rendering::Ogre2GpuRaysPrivate
   /// \brief Image height of first pass.
   public: unsigned int h1st = 0u;
 
+  /// \brief Image width of the first pass texture of each cubemap face.
+  /// At most w1st, lower for faces whose rays are sparse horizontally
+  public: unsigned int faceWidth1st[6] = {};
+
+  /// \brief Image height of the first pass texture of each cubemap face.
+  /// At most h1st, lower for faces whose rays are sparse vertically
+  public: unsigned int faceHeight1st[6] = {};
+
+  /// \brief Min number of samples in each direction of a first pass texture
+  public: const unsigned int kMin1stPassSamples = 128u;
+
   /// \brief Image width of second pass.
   public: unsigned int w2nd = 0u;
 
@@ -177,6 +420,9 @@ class ignition::rendering::Ogre2GpuRaysPrivate
   /// \brief Dummy render texture for the gpu rays
   public: RenderTexturePtr renderTexture;
 
+  /// \brief Gaussian noise of the render passes, applied by the 2nd pass
+  public: Ogre2ShaderNoise shaderNoise;
+
   /// \brief Pointer to material switcher
   public: std::unique_ptr<Ogre2LaserRetroMaterialSwitcher>
       laserRetroMaterialSwitcher[6];
@@ -193,6 +439,13 @@ class ignition::rendering::Ogre2GpuRaysPrivate
 
   /// \brief Min allowed angle in radians;
   public: const math::Angle kMinAllowedAngle = 1e-4;
+
+  /// \brief Name of the ray group set by the user
+  public: std::string rayGroup;
+
+  /// \brief Name of the ray group this sensor has joined in the scene's
+  /// ray groups. Empty if this sensor renders its own cubemap
+  public: std::string rayGroupKey;
 };
 
 using namespace ignition;
@@ -200,129 +453,177 @@ using namespace rendering;
 
 
 //////////////////////////////////////////////////
-Ogre2LaserRetroMaterialSwitcher::Ogre2LaserRetroMaterialSwitcher(
+std::shared_ptr<Ogre2LaserRetroSources> Ogre2LaserRetroSources::Shared(
     Ogre2ScenePtr _scene)
 {
-  this->scene = _scene;
-  // plain opaque material
-  Ogre::ResourcePtr res =
-    Ogre::MaterialManager::getSingleton().load("LaserRetroSource",
-        Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
-
-  this->laserRetroSourceMaterial = res.staticCast<Ogre::Material>();
-  this->laserRetroSourceMaterial->load();
+  // the values are released when the last gpu rays of a scene is destroyed
+  auto &weak = _scene->LaserRetroSources();
+  std::shared_ptr<Ogre2LaserRetroSources> sources = weak.lock();
+  if (!sources)
+  {
+    sources = std::make_shared<Ogre2LaserRetroSources>();
+    weak = sources;
+  }
+  return sources;
 }
 
 //////////////////////////////////////////////////
-void Ogre2LaserRetroMaterialSwitcher::cameraPreRenderScene(
-    Ogre::Camera * /*_cam*/)
+void Ogre2LaserRetroSources::Update(Ogre2ScenePtr _scene)
 {
+  if (this->resolved &&
+      this->itemsRevision == _scene->VisibilityLayersRevision() &&
+      this->laserRetrosRevision == _scene->LaserRetrosRevision())
   {
-    auto engine = Ogre2RenderEngine::Instance();
-    Ogre2IgnHlmsCustomizations &hlmsCustomizations =
-        engine->HlmsCustomizations();
-    Ogre::Pass *pass =
-        this->laserRetroSourceMaterial->getBestTechnique()->getPass(0u);
-    pass->getVertexProgramParameters()->setNamedConstant(
-          "ignMinClipDistance", hlmsCustomizations.minDistanceClip );
+    return;
   }
 
-  // swap item to use v1 shader material
-  // Note: keep an eye out for performance impact on switching materials
-  // on the fly. We are not doing this often so should be ok.
-  this->datablockMap.clear();
-  auto itor = this->scene->OgreSceneManager()->getMovableObjectIterator(
+  IGN_PROFILE("Ogre2LaserRetroSources::Update");
+  // visuals usually own several items, parse their user data once
+  std::unordered_map<unsigned int, float> visualRetros;
+  auto itor = _scene->OgreSceneManager()->getMovableObjectIterator(
       Ogre::ItemFactory::FACTORY_TYPE_NAME);
   while (itor.hasMoreElements())
   {
-    Ogre::MovableObject *object = itor.peekNext();
-    Ogre::Item *item = static_cast<Ogre::Item *>(object);
-
-    std::string laserRetroKey = "laser_retro";
+    Ogre::Item *item = static_cast<Ogre::Item *>(itor.getNext());
 
     float retroValue = 0.0f;
-
-    // get visual
     Ogre::Any userAny = item->getUserObjectBindings().getUserAny();
     if (!userAny.isEmpty() && userAny.getType() == typeid(unsigned int))
     {
-      VisualPtr result;
-      try
-      {
-        result = this->scene->VisualById(Ogre::any_cast<unsigned int>(userAny));
-      }
-      catch(Ogre::Exception &e)
+      unsigned int visualId = Ogre::any_cast<unsigned int>(userAny);
+      auto it = visualRetros.find(visualId);
+      if (it == visualRetros.end())
       {
-        ignerr << "Ogre Error:" << e.getFullDescription() << "\n";
-      }
-      Ogre2VisualPtr ogreVisual =
-          std::dynamic_pointer_cast<Ogre2Visual>(result);
-
-      if (ogreVisual->HasUserData(laserRetroKey))
-      {
-        // get laser_retro
-        Variant tempLaserRetro = ogreVisual->UserData(laserRetroKey);
-
+        VisualPtr visual;
         try
         {
-          retroValue = std::get<float>(tempLaserRetro);
+          visual = _scene->VisualById(visualId);
         }
-        catch(...)
+        catch(Ogre::Exception &e)
         {
-          try
-          {
-            retroValue = static_cast<float>(std::get<double>(tempLaserRetro));
-          }
-          catch(...)
-          {
-            try
-            {
-              retroValue = std::get<int>(tempLaserRetro);
-            }
-            catch(std::bad_variant_access &e)
-            {
-              ignerr << "Error casting user data: " << e.what() << "\n";
-            }
-          }
+          ignerr << "Ogre Error:" << e.getFullDescription() << "\n";
         }
+        it = visualRetros.emplace(visualId, LaserRetro(visual)).first;
       }
-
-      // only accept positive laser retro value
-      retroValue = std::max(retroValue, 0.0f);
+      retroValue = it->second;
     }
 
+    float color = retroValue / 2000.0f;
     for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
     {
-      Ogre::SubItem *subItem = item->getSubItem(i);
+      item->getSubItem(i)->setCustomParameter(kCustomParamIdx,
+          Ogre::Vector4(color, color, color, 1.0));
+    }
+  }
 
-      // limit laser retro value to 2000 (as in gazebo)
-      if (retroValue > 2000.0f)
-      {
-        retroValue = 2000.0f;
-      }
-      float color = retroValue / 2000.0f;
-      subItem->setCustomParameter(this->customParamIdx,
-                                  Ogre::Vector4(color, color, color, 1.0));
+  this->resolved = true;
+  this->itemsRevision = _scene->VisibilityLayersRevision();
+  this->laserRetrosRevision = _scene->LaserRetrosRevision();
+}
 
-      Ogre::HlmsDatablock *datablock = subItem->getDatablock();
-      this->datablockMap[subItem] = datablock;
+//////////////////////////////////////////////////
+float Ogre2LaserRetroSources::LaserRetro(const VisualPtr &_visual)
+{
+  const std::string laserRetroKey = "laser_retro";
+  if (!_visual || !_visual->HasUserData(laserRetroKey))
+    return 0.0f;
 
-      subItem->setMaterial(this->laserRetroSourceMaterial);
+  float retroValue = 0.0f;
+  Variant tempLaserRetro = _visual->UserData(laserRetroKey);
+  try
+  {
+    retroValue = std::get<float>(tempLaserRetro);
+  }
+  catch(...)
+  {
+    try
+    {
+      retroValue = static_cast<float>(std::get<double>(tempLaserRetro));
+    }
+    catch(...)
+    {
+      try
+      {
+        retroValue = std::get<int>(tempLaserRetro);
+      }
+      catch(std::bad_variant_access &e)
+      {
+        ignerr << "Error casting user data: " << e.what() << "\n";
+      }
     }
-    itor.moveNext();
   }
+
+  // only accept positive laser retro value, and limit it to 2000 (as in
+  // gazebo)
+  return std::min(std::max(retroValue, 0.0f), 2000.0f);
 }
 
 //////////////////////////////////////////////////
-void Ogre2LaserRetroMaterialSwitcher::cameraPostRenderScene(
+Ogre2LaserRetroMaterialSwitcher::Ogre2LaserRetroMaterialSwitcher(
+    Ogre2ScenePtr _scene)
+{
+  this->scene = _scene;
+  this->laserRetroSources = Ogre2LaserRetroSources::Shared(_scene);
+
+  // plain opaque material
+  Ogre::ResourcePtr res =
+    Ogre::MaterialManager::getSingleton().load("LaserRetroSource",
+        Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+  this->laserRetroSourceMaterial = res.staticCast<Ogre::Material>();
+  this->laserRetroSourceMaterial->load();
+}
+
+//////////////////////////////////////////////////
+void Ogre2LaserRetroMaterialSwitcher::cameraPreRenderScene(
     Ogre::Camera * /*_cam*/)
 {
-  // restore item to use hlms material
-  for (auto it : this->datablockMap)
+  IGN_PROFILE("Ogre2LaserRetroMaterialSwitcher::cameraPreRenderScene");
+  {
+    auto engine = Ogre2RenderEngine::Instance();
+    Ogre2IgnHlmsCustomizations &hlmsCustomizations =
+        engine->HlmsCustomizations();
+    Ogre::Pass *pass =
+        this->laserRetroSourceMaterial->getBestTechnique()->getPass(0u);
+    pass->getVertexProgramParameters()->setNamedConstant(
+          "ignMinClipDistance", hlmsCustomizations.minDistanceClip );
+  }
+
+  // only re-resolve the laser retro values if the scene changed, looking up
+  // the visual and user data of each item is expensive in large scenes
+  this->laserRetroSources->Update(this->scene);
+
+  // the Pbs and Unlit hlms draw their items with the laser retro values
+  // already set on the sub items, so the items keep their materials.
+  // Items without a value are drawn with no retro
+  auto engine = Ogre2RenderEngine::Instance();
+  engine->MaterialOverride().Begin(Ogre2MaterialOverrideMode::SOLID,
+      Ogre2LaserRetroSources::kCustomParamIdx,
+      Ogre::Vector4(0.0, 0.0, 0.0, 1.0));
+
+  // sub items with low level materials, e.g. shaders set by the user, are
+  // not drawn by those hlms and are switched to the laser retro material.
+  // Vertices deformed by a custom vertex shader, e.g. waves, are drawn
+  // deformed so the rays hit the surface the cameras see
+  this->materials.clear();
+  for (Ogre::SubItem *subItem : this->scene->LowLevelSubItems())
   {
-    Ogre::SubItem *subItem = it.first;
-    subItem->setDatablock(it.second);
+    this->materials.emplace_back(subItem, subItem->getMaterial());
+    subItem->setMaterial(
+        DeformedMaterial(this->laserRetroSourceMaterial, subItem));
   }
+}
+
+//////////////////////////////////////////////////
+void Ogre2LaserRetroMaterialSwitcher::cameraPostRenderScene(
+    Ogre::Camera * /*_cam*/)
+{
+  IGN_PROFILE("Ogre2LaserRetroMaterialSwitcher::cameraPostRenderScene");
+  Ogre2RenderEngine::Instance()->MaterialOverride().End();
+
+  // restore the low level materials
+  for (auto &it : this->materials)
+    it.first->setMaterial(it.second);
 
   Ogre::Pass *pass =
       this->laserRetroSourceMaterial->getBestTechnique()->getPass(0u);
@@ -341,6 +642,7 @@ Ogre2GpuRays::Ogre2GpuRays()
   for (unsigned int i = 0; i < 6u; ++i)
   {
     this->dataPtr->cubeCam[i] = nullptr;
+    this->dataPtr->firstPassTextures[i] = nullptr;
     this->dataPtr->ogreCompositorWorkspace1st[i] = nullptr;
     this->dataPtr->laserRetroMaterialSwitcher[i] = nullptr;
   }
@@ -367,11 +669,7 @@ void Ogre2GpuRays::Init()
 //////////////////////////////////////////////////
 void Ogre2GpuRays::Destroy()
 {
-  if (this->dataPtr->gpuRaysBuffer)
-  {
-    delete [] this->dataPtr->gpuRaysBuffer;
-    this->dataPtr->gpuRaysBuffer = nullptr;
-  }
+  this->LeaveRayGroup();
 
   if (this->dataPtr->gpuRaysScan)
   {
@@ -391,8 +689,23 @@ void Ogre2GpuRays::Destroy()
   Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
 
   // remove 1st pass textures, material, compositors
-  for (auto i : this->dataPtr->cubeFaceIdx)
+  for (unsigned int i = 0; i < 6u; ++i)
   {
+    if (this->dataPtr->cubeCam[i])
+    {
+      if (this->dataPtr->laserRetroMaterialSwitcher[i])
+      {
+        this->dataPtr->cubeCam[i]->removeListener(
+            this->dataPtr->laserRetroMaterialSwitcher[i].get());
+        this->dataPtr->laserRetroMaterialSwitcher[i].reset();
+      }
+      if (this->dataPtr->particleNoiseListener[i])
+      {
+        this->dataPtr->cubeCam[i]->removeListener(
+            this->dataPtr->particleNoiseListener[i].get());
+        this->dataPtr->particleNoiseListener[i].reset();
+      }
+    }
     if (this->dataPtr->firstPassTextures[i])
     {
       ogreRoot->getRenderSystem()->getTextureGpuManager()->destroyTexture(
@@ -406,6 +719,19 @@ void Ogre2GpuRays::Destroy()
       this->dataPtr->ogreCompositorWorkspace1st[i] = nullptr;
     }
   }
+  for (auto &segment : this->dataPtr->segments)
+  {
+    for (unsigned int i = 0; i < 6u; ++i)
+    {
+      if (segment.ogreCompositorWorkspace1st[i])
+        ogreCompMgr->removeWorkspace(segment.ogreCompositorWorkspace1st[i]);
+      if (segment.firstPassTextures[i])
+      {
+        ogreRoot->getRenderSystem()->getTextureGpuManager()->destroyTexture(
+            segment.firstPassTextures[i]);
+      }
+    }
+  }
   if (this->dataPtr->matFirstPass)
   {
     Ogre::MaterialManager::getSingleton().remove(
@@ -437,6 +763,45 @@ void Ogre2GpuRays::Destroy()
     this->dataPtr->matSecondPass.reset();
   }
 
+  for (auto &segment : this->dataPtr->segments)
+  {
+    if (segment.matSecondPass)
+    {
+      Ogre::MaterialManager::getSingleton().remove(
+          segment.matSecondPass->getName());
+    }
+  }
+  this->dataPtr->segments.clear();
+
+  // remove point cloud textures, materials, compositor
+  if (this->dataPtr->ogreCompositorWorkspacePointCloud)
+  {
+    ogreCompMgr->removeWorkspace(
+        this->dataPtr->ogreCompositorWorkspacePointCloud);
+    this->dataPtr->ogreCompositorWorkspacePointCloud = nullptr;
+  }
+  if (!this->dataPtr->ogreCompositorWorkspaceDefPointCloud.empty())
+  {
+    ogreCompMgr->removeWorkspaceDefinition(
+        this->dataPtr->ogreCompositorWorkspaceDefPointCloud);
+    ogreCompMgr->removeNodeDefinition(
+        this->dataPtr->ogreCompositorWorkspaceDefPointCloud + "/Node");
+    this->dataPtr->ogreCompositorWorkspaceDefPointCloud.clear();
+  }
+  for (auto &mat : this->dataPtr->matPointCloud)
+    Ogre::MaterialManager::getSingleton().remove(mat->getName());
+  this->dataPtr->matPointCloud.clear();
+  for (Ogre::TextureGpu **texture : {&this->dataPtr->rayDirTexture,
+      &this->dataPtr->pointCloudTexture})
+  {
+    if (*texture)
+    {
+      ogreRoot->getRenderSystem()->getTextureGpuManager()->destroyTexture(
+          *texture);
+      *texture = nullptr;
+    }
+  }
+
   if (!this->dataPtr->ogreCompositorWorkspaceDef2nd.empty())
   {
     ogreCompMgr->removeWorkspace(this->dataPtr->ogreCompositorWorkspace2nd);
@@ -446,6 +811,8 @@ void Ogre2GpuRays::Destroy()
         this->dataPtr->ogreCompositorNodeDef2nd);
     this->dataPtr->ogreCompositorWorkspaceDef2nd.clear();
   }
+
+  this->dataPtr->cubeFaceIdx.clear();
 }
 
 /////////////////////////////////////////////////
@@ -523,17 +890,45 @@ void Ogre2GpuRays::ConfigureCamera()
   unsigned int vs = static_cast<unsigned int>(
       IGN_PI * 0.5 / vfovAngle * this->VerticalRangeCount());
 
-  // get the max number from the two
-  unsigned int v = std::max(hs, vs);
-  // round to next highest power of 2
-  // https://graphics.stanford.edu/~seander/bithacks.html#RoundUpPowerOf2
-  v--;
-  v |= v >> 1;
-  v |= v >> 2;
-  v |= v >> 4;
-  v |= v >> 8;
-  v |= v >> 16;
-  v++;
+  // beams of a beam table need to be resolved at their smallest spacing
+  if (this->beamElevations.size() > 1u)
+  {
+    std::vector<double> elevations = this->beamElevations;
+    std::sort(elevations.begin(), elevations.end());
+    double minSpacing = vfovAngle;
+    for (unsigned int i = 1u; i < elevations.size(); ++i)
+    {
+      double spacing = elevations[i] - elevations[i - 1u];
+      if (spacing > 0.0)
+        minSpacing = std::min(minSpacing, spacing);
+    }
+    minSpacing = std::max(this->dataPtr->kMinAllowedAngle.Radian(),
+        minSpacing);
+    vs = static_cast<unsigned int>(IGN_PI * 0.5 / minSpacing);
+  }
+
+  // rays of a ray pattern need to be resolved at their average spacing
+  // over the area they cover
+  if (!this->rayPattern.empty())
+  {
+    math::Vector2d minRay = this->rayPattern.front();
+    math::Vector2d maxRay = minRay;
+    for (const auto &ray : this->rayPattern)
+    {
+      minRay.Set(std::min(minRay.X(), ray.X()), std::min(minRay.Y(), ray.Y()));
+      maxRay.Set(std::max(maxRay.X(), ray.X()), std::max(maxRay.Y(), ray.Y()));
+    }
+    double minAngle = this->dataPtr->kMinAllowedAngle.Radian();
+    double area = std::max(minAngle, maxRay.X() - minRay.X()) *
+        std::max(minAngle, maxRay.Y() - minRay.Y());
+    double spacing = std::max(minAngle,
+        std::sqrt(area / this->rayPattern.size()));
+    hs = static_cast<unsigned int>(IGN_PI * 0.5 / spacing);
+    vs = hs;
+  }
+
+  // get the max number from the two, rounded to next highest power of 2
+  unsigned int v = RoundUpPowerOfTwo(std::max(std::max(hs, vs), 1u));
 
   // limit min texture size to 128
   // This is needed for large fov with low sample count,
@@ -542,7 +937,7 @@ void Ogre2GpuRays::ConfigureCamera()
   // \todo(anyone) For small fov, we shouldn't need such a high min texture size
   // requirement, e.g. a single ray lidar only needs 1x1 texture. Look for ways
   // to compute the optimal min texture size
-  unsigned int min1stPassSamples = 128u;
+  unsigned int min1stPassSamples = this->dataPtr->kMin1stPassSamples;
 
   // limit max texture size to 1024
   unsigned int max1stPassSamples = 1024u;
@@ -563,28 +958,7 @@ void Ogre2GpuRays::ConfigureCamera()
 math::Vector2d Ogre2GpuRays::SampleCubemap(const math::Vector3d &_v,
     unsigned int &_faceIndex)
 {
-  math::Vector3d vAbs = _v.Abs();
-  double ma;
-  math::Vector2d uv;
-  if (vAbs.Z() >= vAbs.X() && vAbs.Z() >= vAbs.Y())
-  {
-    _faceIndex = _v.Z() < 0.0 ? 5.0 : 4.0;
-    ma = 0.5 / vAbs.Z();
-    uv = math::Vector2d(_v.Z() < 0.0 ? -_v.X() : _v.X(), -_v.Y());
-  }
-  else if (vAbs.Y() >= vAbs.X())
-  {
-    _faceIndex = _v.Y() < 0.0 ? 3.0 : 2.0;
-    ma = 0.5 / vAbs.Y();
-    uv = math::Vector2d(_v.X(), _v.Y() < 0.0 ? -_v.Z() : _v.Z());
-  }
-  else
-  {
-    _faceIndex = _v.X() < 0.0 ? 1.0 : 0.0;
-    ma = 0.5 / vAbs.X();
-    uv = math::Vector2d(_v.X() < 0.0 ? _v.Z() : -_v.Z(), -_v.Y());
-  }
-  return uv * ma + 0.5;
+  return CubemapFaceUv(_v, _faceIndex);
 }
 
 /////////////////////////////////////////////////////////
@@ -599,6 +973,13 @@ void Ogre2GpuRays::CreateSampleTexture()
   double vAngle = std::max(this->dataPtr->kMinAllowedAngle.Radian(),
       vmax - vmin);
 
+  // sensors in a ray group sample the cubemap rendered by the group leader
+  // so the rays need to be expressed in the leader's frame
+  Ogre2GpuRays *leader = this->RayGroupLeader();
+  math::Quaterniond leaderRot = math::Quaterniond::Identity;
+  if (leader)
+    leaderRot = leader->WorldRotation().Inverse() * this->WorldRotation();
+
   double hStep = hAngle / static_cast<double>(this->dataPtr->w2nd-1);
   double vStep = 1.0;
   // non-planar case
@@ -613,56 +994,95 @@ void Ogre2GpuRays::CreateSampleTexture()
   //   B: cubemap face index
   //   A: unused
   // this texture is passed to the 2nd pass fragment shader
-  auto engine = Ogre2RenderEngine::Instance();
-  auto ogreRoot = engine->OgreRoot();
-  Ogre::TextureGpuManager *textureMgr =
-    ogreRoot->getRenderSystem()->getTextureGpuManager();
-  std::string texName = this->Name() + "_samplerTex";
-  this->dataPtr->cubeUVTexture =
-    textureMgr->createOrRetrieveTexture(
-      texName,
-      Ogre::GpuPageOutStrategy::SaveToSystemRam,
-      Ogre::TextureFlags::ManualTexture,
-      Ogre::TextureTypes::Type2D,
-      Ogre::BLANKSTRING,
-      0u);
-
-  this->dataPtr->cubeUVTexture->setTextureType(Ogre::TextureTypes::Type2D);
-  this->dataPtr->cubeUVTexture->setResolution(
-    this->dataPtr->w2nd, this->dataPtr->h2nd);
-  this->dataPtr->cubeUVTexture->setNumMipmaps(1u);
-  this->dataPtr->cubeUVTexture->setPixelFormat(Ogre::PFG_RGBA32_FLOAT);
-
-  const Ogre::uint32 rowAlignment = 1u;
   const size_t dataSize = Ogre::PixelFormatGpuUtils::getSizeBytes(
-    this->dataPtr->cubeUVTexture->getWidth(),
-    this->dataPtr->cubeUVTexture->getHeight(),
-    this->dataPtr->cubeUVTexture->getDepth(),
-    this->dataPtr->cubeUVTexture->getNumSlices(),
-    this->dataPtr->cubeUVTexture->getPixelFormat(),
-    rowAlignment);
-
-  const size_t bytesPerRow =
-    this->dataPtr->cubeUVTexture->_getSysRamCopyBytesPerRow( 0 );
+    this->dataPtr->w2nd, this->dataPtr->h2nd, 1u, 1u,
+    Ogre::PFG_RGBA32_FLOAT, 1u);
   float *pDest = reinterpret_cast<float*>(
     OGRE_MALLOC_SIMD(dataSize, Ogre::MEMCATEGORY_RESOURCE));
 
+  // point clouds are computed from the direction of each ray in the sensor
+  // frame, packed in a texture of the same layout (x, y, z, unused)
+  float *pDir = nullptr;
+  if (this->dataPtr->newGpuRaysPointCloud.ConnectionCount() > 0u)
+  {
+    pDir = reinterpret_cast<float*>(
+      OGRE_MALLOC_SIMD(dataSize, Ogre::MEMCATEGORY_RESOURCE));
+  }
+
+  // split the columns into time segments. Sensors in a ray group sample a
+  // cubemap rendered at a single pose, and the columns of a ray pattern are
+  // not ordered in time
+  this->dataPtr->segments.clear();
+  if (this->ScanSegmentCount() > 1u && this->dataPtr->rayGroupKey.empty() &&
+      this->rayPattern.empty())
+  {
+    unsigned int segmentCount =
+        std::min(this->ScanSegmentCount(), this->dataPtr->w2nd);
+    this->dataPtr->segments.resize(segmentCount);
+    for (unsigned int k = 0; k < segmentCount; ++k)
+    {
+      this->dataPtr->segments[k].columnBegin =
+          k * this->dataPtr->w2nd / segmentCount;
+      this->dataPtr->segments[k].columnEnd =
+          (k + 1u) * this->dataPtr->w2nd / segmentCount;
+    }
+  }
+
   double v = vmin;
   int index = 0;
   for (unsigned int i = 0; i < this->dataPtr->h2nd; ++i)
   {
+    unsigned int segmentIdx = 0u;
+    // rows of a beam table sample exactly the elevation of their beam
     double h = min;
+    if (!this->beamElevations.empty())
+    {
+      v = this->beamElevations[i];
+      if (!this->beamAzimuthOffsets.empty())
+        h += this->beamAzimuthOffsets[i];
+    }
     for (unsigned int j = 0; j < this->dataPtr->w2nd; ++j)
     {
       // set up dir vector to sample from a standard Y up cubemap
       math::Vector3d ray(0, 0, 1);
       ray.Normalize();
-      math::Quaterniond pitch(math::Vector3d(1, 0, 0), -v);
-      math::Quaterniond yaw(math::Vector3d(0, 1, 0), -h);
+      double rayH = h;
+      double rayV = v;
+      if (!this->rayPattern.empty())
+      {
+        const math::Vector2d &patternRay =
+            this->rayPattern[i * this->dataPtr->w2nd + j];
+        rayH = patternRay.X();
+        rayV = patternRay.Y();
+      }
+      math::Quaterniond pitch(math::Vector3d(1, 0, 0), -rayV);
+      math::Quaterniond yaw(math::Vector3d(0, 1, 0), -rayH);
       math::Vector3d dir = yaw * pitch * ray;
+      if (pDir)
+      {
+        // cubemap frame (x right, y up, z forward) to sensor frame
+        pDir[index] = dir.Z();
+        pDir[index + 1] = -dir.X();
+        pDir[index + 2] = dir.Y();
+        pDir[index + 3] = 0.0;
+      }
+      if (leader)
+      {
+        // cubemap frame (x right, y up, z forward) to sensor frame
+        // (x forward, y left, z up) and back
+        math::Vector3d sensorDir = leaderRot *
+            math::Vector3d(dir.Z(), -dir.X(), dir.Y());
+        dir.Set(-sensorDir.Y(), sensorDir.Z(), sensorDir.X());
+      }
       unsigned int faceIdx;
       math::Vector2d uv = this->SampleCubemap(dir, faceIdx);
       this->dataPtr->cubeFaceIdx.insert(faceIdx);
+      if (!this->dataPtr->segments.empty())
+      {
+        while (j >= this->dataPtr->segments[segmentIdx].columnEnd)
+          ++segmentIdx;
+        this->dataPtr->segments[segmentIdx].cubeFaceIdx.insert(faceIdx);
+      }
       // igndbg << "p(" << pitch << ") y(" << yaw << "): " << dir << " | "
       //       << uv << " | " << faceIdx << std::endl;
       // u
@@ -677,51 +1097,87 @@ void Ogre2GpuRays::CreateSampleTexture()
     }
     v += vStep;
   }
-  this->dataPtr->cubeUVTexture->_transitionTo(
-    Ogre::GpuResidency::Resident,
-    reinterpret_cast<Ogre::uint8*>(pDest) );
-  this->dataPtr->cubeUVTexture->_setNextResidencyStatus(
-    Ogre::GpuResidency::Resident);
-  // We have to upload the data via a StagingTexture, which acts as an
-  // intermediate stash memory that is both visible to CPU and GPU.
-  Ogre::StagingTexture *stagingTexture = textureMgr->getStagingTexture(
-    this->dataPtr->cubeUVTexture->getWidth(),
-    this->dataPtr->cubeUVTexture->getHeight(),
-    this->dataPtr->cubeUVTexture->getDepth(),
-    this->dataPtr->cubeUVTexture->getNumSlices(),
-    this->dataPtr->cubeUVTexture->getPixelFormat() );
-  stagingTexture->startMapRegion();
-  // Map region of the staging texture. This function can be called from
-  // any thread after startMapRegion has already been called.
-  Ogre::TextureBox texBox = stagingTexture->mapRegion(
-    this->dataPtr->cubeUVTexture->getWidth(),
-    this->dataPtr->cubeUVTexture->getHeight(),
-    this->dataPtr->cubeUVTexture->getDepth(),
-    this->dataPtr->cubeUVTexture->getNumSlices(),
-    this->dataPtr->cubeUVTexture->getPixelFormat());
-
-  texBox.copyFrom(
-    pDest,
-    this->dataPtr->cubeUVTexture->getWidth(),
-    this->dataPtr->cubeUVTexture->getHeight(),
-    bytesPerRow);
-  stagingTexture->stopMapRegion();
-  stagingTexture->upload(texBox, this->dataPtr->cubeUVTexture, 0, 0, 0, true);
-  // Tell the TextureGpuManager we're done with this StagingTexture.
-  // Otherwise it will leak.
-  textureMgr->removeStagingTexture(stagingTexture);
-  stagingTexture = 0;
-  // Do not free the pointer if texture's paging strategy is
-  // GpuPageOutStrategy::AlwaysKeepSystemRamCopy
-  this->dataPtr->cubeUVTexture->notifyDataIsReady();
+  this->ComputeFaceTextureSizes(pDest);
+
+  this->dataPtr->cubeUVTexture = CreateLookupTexture(
+      this->Name() + "_samplerTex", this->dataPtr->w2nd, this->dataPtr->h2nd,
+      pDest);
+  if (pDir)
+  {
+    this->dataPtr->rayDirTexture = CreateLookupTexture(
+        this->Name() + "_rayDirTex", this->dataPtr->w2nd,
+        this->dataPtr->h2nd, pDir);
+  }
 }
 
 /////////////////////////////////////////////////////////
-void Ogre2GpuRays::Setup1stPass()
+void Ogre2GpuRays::ComputeFaceTextureSizes(const float *_samples)
 {
-  // Load 1st pass material
-  // The GpuRaysScan1st material is defined in script (gpu_rays.material).
-  // We need to clone it since we are going to modify its uniform variables
+  for (unsigned int i = 0; i < 6u; ++i)
+  {
+    this->dataPtr->faceWidth1st[i] = this->dataPtr->w1st;
+    this->dataPtr->faceHeight1st[i] = this->dataPtr->h1st;
+  }
+
+  // a ray group leader renders the cubemap for the rays of all sensors in
+  // the group, including the ones joining later. Neighbouring rays of a ray
+  // pattern are not necessarily close to each other
+  if (!this->dataPtr->rayGroupKey.empty() || !this->rayPattern.empty())
+    return;
+
+  // smallest uv distance between neighbouring rays on each face. Each face
+  // only needs to resolve the rays that sample it, in each direction, e.g.
+  // the top and bottom faces of a lidar with dense horizontal and sparse
+  // vertical rays need fewer rows than the side faces
+  double minDu[6] = {1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+  double minDv[6] = {1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+  unsigned int width = this->dataPtr->w2nd;
+  unsigned int height = this->dataPtr->h2nd;
+  for (unsigned int i = 0; i < height; ++i)
+  {
+    for (unsigned int j = 0; j < width; ++j)
+    {
+      // each sample packs u, v, face index and an unused value
+      const float *sample = _samples + 4u * (i * width + j);
+      unsigned int face = static_cast<unsigned int>(sample[2]);
+      const float *neighbors[2] = {
+          j + 1u < width ? sample + 4u : nullptr,
+          i + 1u < height ? sample + 4u * width : nullptr};
+      for (const float *neighbor : neighbors)
+      {
+        if (!neighbor || neighbor[2] != sample[2])
+          continue;
+        double du = std::abs(neighbor[0] - sample[0]);
+        double dv = std::abs(neighbor[1] - sample[1]);
+        if (du >= dv && du > 0.0)
+          minDu[face] = std::min(minDu[face], du);
+        else if (dv > du)
+          minDv[face] = std::min(minDv[face], dv);
+      }
+    }
+  }
+
+  for (unsigned int i = 0; i < 6u; ++i)
+  {
+    unsigned int w = RoundUpPowerOfTwo(static_cast<unsigned int>(std::min(
+        std::ceil(1.0 / minDu[i]), static_cast<double>(this->dataPtr->w1st))));
+    unsigned int h = RoundUpPowerOfTwo(static_cast<unsigned int>(std::min(
+        std::ceil(1.0 / minDv[i]), static_cast<double>(this->dataPtr->h1st))));
+    this->dataPtr->faceWidth1st[i] = std::clamp(w,
+        std::min(this->dataPtr->kMin1stPassSamples, this->dataPtr->w1st),
+        this->dataPtr->w1st);
+    this->dataPtr->faceHeight1st[i] = std::clamp(h,
+        std::min(this->dataPtr->kMin1stPassSamples, this->dataPtr->h1st),
+        this->dataPtr->h1st);
+  }
+}
+
+/////////////////////////////////////////////////////////
+void Ogre2GpuRays::Setup1stPass()
+{
+  // Load 1st pass material
+  // The GpuRaysScan1st material is defined in script (gpu_rays.material).
+  // We need to clone it since we are going to modify its uniform variables
   std::string mat1stName = "GpuRaysScan1st";
   Ogre::MaterialPtr mat1st =
       Ogre::MaterialManager::getSingleton().getByName(mat1stName);
@@ -905,6 +1361,8 @@ void Ogre2GpuRays::Setup1stPass()
       Ogre::CompositorPassSceneDef *passScene =
           static_cast<Ogre::CompositorPassSceneDef *>(
           colorTargetDef->addPass(Ogre::PASS_SCENE));
+      // unlit pass, skip building the Forward+ light clusters
+      passScene->mEnableForwardPlus = false;
       passScene->setAllLoadActions(Ogre::LoadAction::Clear);
       passScene->setAllClearColours(Ogre::ColourValue(0, 0, 0));
       // set camera custom visibility mask when rendering laser retro
@@ -962,67 +1420,89 @@ void Ogre2GpuRays::Setup1stPass()
            << " for " << this->Name();
   }
 
-  // create cubemap cameras and render to texture using 1st pass compositor
-  Ogre::SceneManager *ogreSceneManager = this->scene->OgreSceneManager();
-  for (auto i : this->dataPtr->cubeFaceIdx)
+  // A ray group leader renders all faces since other sensors may join the
+  // group later and sample a different set of faces
+  std::set<unsigned int> faces = this->dataPtr->cubeFaceIdx;
+  if (!this->dataPtr->rayGroupKey.empty())
+    faces = {0u, 1u, 2u, 3u, 4u, 5u};
+
+  // create a render texture of a cubemap face and the compositor workspace
+  // rendering it. These textures pack the range data that will be used in
+  // the 2nd pass
+  Ogre::TextureGpuManager *textureMgr =
+    ogreRoot->getRenderSystem()->getTextureGpuManager();
+  auto createTarget = [&](unsigned int _face, const std::string &_texName,
+      Ogre::TextureGpu *&_texture, Ogre::CompositorWorkspace *&_workspace)
   {
-    this->dataPtr->cubeCam[i] = ogreSceneManager->createCamera(
-        this->Name() + "_env" + std::to_string(i));
-    this->dataPtr->cubeCam[i]->detachFromParent();
-    this->ogreNode->attachObject(this->dataPtr->cubeCam[i]);
-    this->dataPtr->cubeCam[i]->setFOVy(Ogre::Degree(90));
-    this->dataPtr->cubeCam[i]->setAspectRatio(1);
-    this->dataPtr->cubeCam[i]->setNearClipDistance(this->dataPtr->nearClipCube);
-    this->dataPtr->cubeCam[i]->setFarClipDistance(this->FarClipPlane());
-    this->dataPtr->cubeCam[i]->setFixedYawAxis(false);
-    this->dataPtr->cubeCam[i]->yaw(Ogre::Degree(-90));
-    this->dataPtr->cubeCam[i]->roll(Ogre::Degree(-90));
-
-    // orient camera to create cubemap
-    if (i == 0)
-      this->dataPtr->cubeCam[i]->yaw(Ogre::Degree(-90));
-    else if (i == 1)
-      this->dataPtr->cubeCam[i]->yaw(Ogre::Degree(90));
-    else if (i == 2)
-      this->dataPtr->cubeCam[i]->pitch(Ogre::Degree(90));
-    else if (i == 3)
-      this->dataPtr->cubeCam[i]->pitch(Ogre::Degree(-90));
-    else if (i == 5)
-      this->dataPtr->cubeCam[i]->yaw(Ogre::Degree(180));
-
-    // create render texture - these textures pack the range data
-    // that will be used in the 2nd pass
-    Ogre::TextureGpuManager *textureMgr =
-      ogreRoot->getRenderSystem()->getTextureGpuManager();
-    std::stringstream texName;
-    texName << this->Name() << "_first_pass_" << i;
-    this->dataPtr->firstPassTextures[i] =
-      textureMgr->createOrRetrieveTexture(
-        texName.str(),
+    _texture = textureMgr->createOrRetrieveTexture(
+        _texName,
         Ogre::GpuPageOutStrategy::SaveToSystemRam,
         Ogre::TextureFlags::RenderToTexture,
         Ogre::TextureTypes::Type2D);
 
-    this->dataPtr->firstPassTextures[i]->setResolution(
-      this->dataPtr->w1st, this->dataPtr->h1st);
-    this->dataPtr->firstPassTextures[i]->setNumMipmaps(1u);
-    this->dataPtr->firstPassTextures[i]->setPixelFormat(
-      Ogre::PFG_RG32_FLOAT);
+    _texture->setResolution(this->dataPtr->faceWidth1st[_face],
+        this->dataPtr->faceHeight1st[_face]);
+    _texture->setNumMipmaps(1u);
+    _texture->setPixelFormat(Ogre::PFG_RG32_FLOAT);
 
-    this->dataPtr->firstPassTextures[i]->scheduleTransitionTo(
-      Ogre::GpuResidency::Resident);
+    _texture->scheduleTransitionTo(Ogre::GpuResidency::Resident);
 
     // create compositor workspace
-    this->dataPtr->ogreCompositorWorkspace1st[i] =
-        ogreCompMgr->addWorkspace(
-          this->scene->OgreSceneManager(),
-          this->dataPtr->firstPassTextures[i],
-          this->dataPtr->cubeCam[i],
-          wsDefName,
-          false);
-
-    Ogre::CompositorNode *node =
-        this->dataPtr->ogreCompositorWorkspace1st[i]->getNodeSequence()[0];
+    _workspace = ogreCompMgr->addWorkspace(
+        this->scene->OgreSceneManager(),
+        _texture,
+        this->dataPtr->cubeCam[_face],
+        wsDefName,
+        false);
+    this->AddPassProfilers(_workspace);
+  };
+
+  // create cubemap cameras and render to texture using 1st pass compositor
+  Ogre::SceneManager *ogreSceneManager = this->scene->OgreSceneManager();
+  for (auto i : faces)
+  {
+    // cameras are kept when the textures are recreated, e.g. when changing
+    // ray groups
+    if (!this->dataPtr->cubeCam[i])
+    {
+      this->dataPtr->cubeCam[i] = ogreSceneManager->createCamera(
+          this->Name() + "_env" + std::to_string(i));
+      this->dataPtr->cubeCam[i]->detachFromParent();
+      this->ogreNode->attachObject(this->dataPtr->cubeCam[i]);
+      OrientCubemapCamera(this->dataPtr->cubeCam[i], i);
+      this->dataPtr->cubeCamOrientation[i] =
+          this->dataPtr->cubeCam[i]->getOrientation();
+    }
+    this->dataPtr->cubeCam[i]->setNearClipDistance(
+        this->dataPtr->nearClipCube);
+    this->dataPtr->cubeCam[i]->setFarClipDistance(this->FarClipPlane());
+
+    std::stringstream texName;
+    texName << this->Name() << "_first_pass_" << i;
+    Ogre::CompositorWorkspace *workspace = nullptr;
+    if (this->dataPtr->segments.empty())
+    {
+      createTarget(i, texName.str(), this->dataPtr->firstPassTextures[i],
+          this->dataPtr->ogreCompositorWorkspace1st[i]);
+      workspace = this->dataPtr->ogreCompositorWorkspace1st[i];
+    }
+    else
+    {
+      // each time segment renders the faces it samples to textures of
+      // its own
+      for (unsigned int k = 0; k < this->dataPtr->segments.size(); ++k)
+      {
+        Ogre2GpuRaysSegment &segment = this->dataPtr->segments[k];
+        if (segment.cubeFaceIdx.count(i) == 0u)
+          continue;
+        createTarget(i, texName.str() + "_" + std::to_string(k),
+            segment.firstPassTextures[i],
+            segment.ogreCompositorWorkspace1st[i]);
+        workspace = segment.ogreCompositorWorkspace1st[i];
+      }
+    }
+
+    Ogre::CompositorNode *node = workspace->getNodeSequence()[0];
     auto channelsTex = node->getLocalTextures();
 
     for (auto c : channelsTex)
@@ -1067,11 +1547,45 @@ void Ogre2GpuRays::Setup2ndPass()
       Ogre::TextureFlags::RenderToTexture,
       Ogre::TextureTypes::Type2D);
 
-  this->dataPtr->secondPassTexture->setResolution(
-    this->dataPtr->w2nd, this->dataPtr->h2nd);
+  // Metal does not support RGB32_FLOAT. To avoid reading back an unused
+  // alpha channel and repacking the data on the CPU, the 2nd pass writes
+  // each of the 3 output channels to its own texel of a single channel
+  // texture so that the texture layout matches PF_FLOAT32_RGB.
+  // Fall back to RGBA if the packed texture would be too wide
+  unsigned int packedWidth = this->dataPtr->w2nd * this->Channels();
+  this->dataPtr->packedOutput = packedWidth <=
+      ogreRoot->getRenderSystem()->getCapabilities()->getMaximumResolution2D();
+  this->dataPtr->secondPassFormat = PF_FLOAT32_RGB;
+  if (this->dataPtr->packedOutput)
+  {
+    // the 2nd pass encodes data to the output format. Millimeters are
+    // written to a unorm target, which stores them exactly
+    Ogre::PixelFormatGpu packedFormat = Ogre::PFG_R32_FLOAT;
+    if (this->dataPtr->outputFormat == PF_FLOAT16_RGB)
+      packedFormat = Ogre::PFG_R16_FLOAT;
+    else if (this->dataPtr->outputFormat == PF_UINT16_RGB)
+      packedFormat = Ogre::PFG_R16_UNORM;
+    this->dataPtr->secondPassFormat = this->dataPtr->outputFormat;
+
+    this->dataPtr->secondPassTexture->setResolution(
+      packedWidth, this->dataPtr->h2nd);
+    this->dataPtr->secondPassTexture->setPixelFormat(packedFormat);
+  }
+  else
+  {
+    if (this->dataPtr->outputFormat != PF_FLOAT32_RGB)
+    {
+      ignwarn << "Gpu rays [" << this->Name() << "] output is too wide to "
+              << "be encoded to "
+              << PixelUtil::Name(this->dataPtr->outputFormat)
+              << ", using FLOAT32_RGB instead" << std::endl;
+    }
+    this->dataPtr->secondPassTexture->setResolution(
+      this->dataPtr->w2nd, this->dataPtr->h2nd);
+    this->dataPtr->secondPassTexture->setPixelFormat(
+      Ogre::PFG_RGBA32_FLOAT);
+  }
   this->dataPtr->secondPassTexture->setNumMipmaps(1u);
-  this->dataPtr->secondPassTexture->setPixelFormat(
-    Ogre::PFG_RGBA32_FLOAT);
 
   this->dataPtr->secondPassTexture->scheduleTransitionTo(
     Ogre::GpuResidency::Resident);
@@ -1086,6 +1600,10 @@ void Ogre2GpuRays::Setup2ndPass()
       this->Name() + "_" + mat2ndName);
   this->dataPtr->matSecondPass->load();
   Ogre::Pass *pass = this->dataPtr->matSecondPass->getTechnique(0)->getPass(0);
+  pass->getFragmentProgramParameters()->setNamedConstant("packRgb",
+      this->dataPtr->packedOutput ? 1.0f : 0.0f);
+  pass->getFragmentProgramParameters()->setNamedConstant("encodeMillimeters",
+      this->dataPtr->secondPassFormat == PF_UINT16_RGB ? 1.0f : 0.0f);
 
   // Connect cubeUVTexture to the GpuRaysScan2nd material's texture unit state
   // The texture unit index (0) must match the one specified in the script
@@ -1093,15 +1611,42 @@ void Ogre2GpuRays::Setup2ndPass()
   pass->getTextureUnitState(0)->setTexture(this->dataPtr->cubeUVTexture);
 
   // connect all cubemap textures to the corresponding texture unit states
-  // defined in the GpuRaysScan2nd material
+  // defined in the GpuRaysScan2nd material. Sensors in a ray group sample
+  // the cubemap of the group leader
+  Ogre2GpuRays *leader = this->RayGroupLeader();
+  Ogre::TextureGpu **firstPassTextures = leader ?
+      leader->dataPtr->firstPassTextures : this->dataPtr->firstPassTextures;
   Ogre::TextureUnitState *texUnit = nullptr;
-  for (auto i : this->dataPtr->cubeFaceIdx)
+  if (this->dataPtr->segments.empty())
   {
-    // texIndex need to match how the texture units are defined in the
-    // gpu_rays.material script
-    unsigned int texIndex = 1 + i;
-    texUnit = pass->getTextureUnitState(texIndex);
-    texUnit->setTexture(this->dataPtr->firstPassTextures[i]);
+    for (auto i : this->dataPtr->cubeFaceIdx)
+    {
+      // texIndex need to match how the texture units are defined in the
+      // gpu_rays.material script
+      unsigned int texIndex = 1 + i;
+      texUnit = pass->getTextureUnitState(texIndex);
+      texUnit->setTexture(firstPassTextures[i]);
+    }
+  }
+
+  // each time segment samples its own textures and only writes its columns
+  for (unsigned int k = 0; k < this->dataPtr->segments.size(); ++k)
+  {
+    Ogre2GpuRaysSegment &segment = this->dataPtr->segments[k];
+    segment.matSecondPass = this->dataPtr->matSecondPass->clone(
+        this->dataPtr->matSecondPass->getName() + "_" + std::to_string(k));
+    segment.matSecondPass->load();
+    Ogre::Pass *segmentPass =
+        segment.matSecondPass->getTechnique(0)->getPass(0);
+    float width = static_cast<float>(this->dataPtr->w2nd);
+    segmentPass->getFragmentProgramParameters()->setNamedConstant(
+        "columnRange", Ogre::Vector2(segment.columnBegin / width,
+        segment.columnEnd / width));
+    for (auto i : segment.cubeFaceIdx)
+    {
+      texUnit = segmentPass->getTextureUnitState(1 + i);
+      texUnit->setTexture(segment.firstPassTextures[i]);
+    }
   }
 
   // create 2nd pass compositor
@@ -1130,36 +1675,17 @@ void Ogre2GpuRays::Setup2ndPass()
   // }
   std::string wsDefName = "GpuRays2ndPassWorkspace_" + this->Name();
   this->dataPtr->ogreCompositorWorkspaceDef2nd = wsDefName;
-  if (!ogreCompMgr->hasWorkspaceDefinition(wsDefName))
-  {
-    std::string nodeDefName = wsDefName + "/Node";
-    this->dataPtr->ogreCompositorNodeDef2nd = nodeDefName;
-    Ogre::CompositorNodeDef *nodeDef =
-        ogreCompMgr->addNodeDefinition(nodeDefName);
-    // Input texture
-    nodeDef->addTextureSourceName("rt_input", 0,
-        Ogre::TextureDefinitionBase::TEXTURE_INPUT);
-    nodeDef->setNumTargetPass(1);
-    {
-      Ogre::CompositorTargetDef *inputTargetDef =
-          nodeDef->addTargetPass("rt_input");
-      inputTargetDef->setNumPasses(1);
-
-      // quad pass - sample from cubemap textures
-      Ogre::CompositorPassQuadDef *passQuad =
-          static_cast<Ogre::CompositorPassQuadDef *>(
-          inputTargetDef->addPass(Ogre::PASS_QUAD));
-      passQuad->setAllLoadActions(Ogre::LoadAction::Clear);
-      passQuad->setAllClearColours(Ogre::ColourValue(
-                                     this->dataMaxVal, 0, 1.0));
-      passQuad->mMaterialName = this->dataPtr->matSecondPass->getName();
-    }
-    nodeDef->mapOutputChannel(0, "rt_input");
-
-    Ogre::CompositorWorkspaceDef *workDef =
-        ogreCompMgr->addWorkspaceDefinition(wsDefName);
-    workDef->connectExternal(0, nodeDef->getName(), 0);
-  }
+  this->dataPtr->ogreCompositorNodeDef2nd = wsDefName + "/Node";
+
+  // a scan rendered in time segments has one quad pass per segment, each
+  // writing the columns of its segment
+  std::vector<std::string> materialNames;
+  for (auto &segment : this->dataPtr->segments)
+    materialNames.push_back(segment.matSecondPass->getName());
+  if (materialNames.empty())
+    materialNames.push_back(this->dataPtr->matSecondPass->getName());
+  Add2ndPassWorkspaceDefinition(wsDefName, materialNames,
+      Ogre::ColourValue(this->dataMaxVal, 0, 1.0));
   Ogre::CompositorWorkspaceDef *wsDef =
       ogreCompMgr->getWorkspaceDefinition(wsDefName);
   if (!wsDef)
@@ -1176,6 +1702,77 @@ void Ogre2GpuRays::Setup2ndPass()
         this->dataPtr->ogreCamera,
         wsDefName,
         false);
+  this->AddPassProfilers(this->dataPtr->ogreCompositorWorkspace2nd);
+}
+
+/////////////////////////////////////////////////////////
+void Ogre2GpuRays::SetupPointCloudPass()
+{
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::TextureGpuManager *textureMgr =
+    ogreRoot->getRenderSystem()->getTextureGpuManager();
+
+  // the point cloud pass writes the hit point and retro value of each ray
+  // as RGBA, which is already the layout of the point cloud
+  this->dataPtr->pointCloudTexture =
+    textureMgr->createOrRetrieveTexture(
+      this->Name() + "_point_cloud",
+      Ogre::GpuPageOutStrategy::SaveToSystemRam,
+      Ogre::TextureFlags::RenderToTexture,
+      Ogre::TextureTypes::Type2D);
+  this->dataPtr->pointCloudTexture->setResolution(
+    this->dataPtr->w2nd, this->dataPtr->h2nd);
+  this->dataPtr->pointCloudTexture->setNumMipmaps(1u);
+  this->dataPtr->pointCloudTexture->setPixelFormat(Ogre::PFG_RGBA32_FLOAT);
+  this->dataPtr->pointCloudTexture->scheduleTransitionTo(
+    Ogre::GpuResidency::Resident);
+
+  // the point cloud pass samples the cubemap in the same way as the 2nd
+  // pass, so its materials are copies of the 2nd pass materials
+  std::vector<Ogre::MaterialPtr> materials;
+  for (auto &segment : this->dataPtr->segments)
+    materials.push_back(segment.matSecondPass);
+  if (materials.empty())
+    materials.push_back(this->dataPtr->matSecondPass);
+
+  std::vector<std::string> materialNames;
+  for (unsigned int k = 0; k < materials.size(); ++k)
+  {
+    Ogre::MaterialPtr mat = materials[k]->clone(
+        this->Name() + "_GpuRaysPointCloud_" + std::to_string(k));
+    mat->load();
+    Ogre::Pass *pass = mat->getTechnique(0)->getPass(0);
+    Ogre::GpuProgramParametersSharedPtr psParams =
+        pass->getFragmentProgramParameters();
+    psParams->setNamedConstant("outputPoints", 1.0f);
+    psParams->setNamedConstant("packRgb", 0.0f);
+    psParams->setNamedConstant("encodeMillimeters", 0.0f);
+
+    // The texture unit index (7) must match the one specified in the
+    // GpuRaysScan2nd script
+    pass->getTextureUnitState(7)->setTexture(this->dataPtr->rayDirTexture);
+
+    this->dataPtr->matPointCloud.push_back(mat);
+    materialNames.push_back(mat->getName());
+  }
+
+  std::string wsDefName = "GpuRaysPointCloudWorkspace_" + this->Name();
+  this->dataPtr->ogreCompositorWorkspaceDefPointCloud = wsDefName;
+  float maxVal = this->dataMaxVal;
+  Add2ndPassWorkspaceDefinition(wsDefName, materialNames,
+      Ogre::ColourValue(maxVal, maxVal, maxVal, 0.0));
+
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+  this->dataPtr->ogreCompositorWorkspacePointCloud =
+      ogreCompMgr->addWorkspace(
+        this->scene->OgreSceneManager(),
+        this->dataPtr->pointCloudTexture,
+        this->dataPtr->ogreCamera,
+        wsDefName,
+        false);
+  this->AddPassProfilers(
+      this->dataPtr->ogreCompositorWorkspacePointCloud);
 }
 
 /////////////////////////////////////////////////////////
@@ -1191,9 +1788,27 @@ void Ogre2GpuRays::CreateGpuRaysTextures()
   this->dataPtr->nearClipCube = boxSize * 0.5;
 
   this->ConfigureCamera();
+  this->JoinRayGroup();
   this->CreateSampleTexture();
-  this->Setup1stPass();
+
+  if (!this->dataPtr->rayGroupKey.empty())
+  {
+    Ogre2GpuRaysGroup &group =
+        RayGroup(this->scene, this->dataPtr->rayGroupKey);
+    group.members[this] = this->dataPtr->cubeFaceIdx;
+    group.cubeFaceIdx.insert(this->dataPtr->cubeFaceIdx.begin(),
+        this->dataPtr->cubeFaceIdx.end());
+  }
+
+  // only sensors that are not sampling a ray group leader's cubemap need
+  // to render their own
+  if (!this->RayGroupLeader())
+    this->Setup1stPass();
   this->Setup2ndPass();
+
+  // the ray direction texture is only created for point cloud subscribers
+  if (this->dataPtr->rayDirTexture)
+    this->SetupPointCloudPass();
 }
 
 /////////////////////////////////////////////////
@@ -1202,41 +1817,107 @@ void Ogre2GpuRays::UpdateRenderTarget1stPass()
   Ogre::vector<Ogre::TextureGpu *>::type swappedTargets;
   swappedTargets.reserve(2u);
 
-  // update the compositors
-  for (auto i : this->dataPtr->cubeFaceIdx)
+  auto updateWorkspace = [&](unsigned int _face,
+      Ogre::CompositorWorkspace *_workspace)
   {
-    this->scene->UpdateAllHeightmaps(this->dataPtr->cubeCam[i]);
-    this->dataPtr->ogreCompositorWorkspace1st[i]->setEnabled(true);
+    this->scene->UpdateAllHeightmaps(this->dataPtr->cubeCam[_face]);
+    _workspace->setEnabled(true);
 
-    this->dataPtr->ogreCompositorWorkspace1st[i]->_validateFinalTarget();
-    this->dataPtr->ogreCompositorWorkspace1st[i]->_beginUpdate(false);
-    this->dataPtr->ogreCompositorWorkspace1st[i]->_update();
-    this->dataPtr->ogreCompositorWorkspace1st[i]->_endUpdate(false);
+    _workspace->_validateFinalTarget();
+    _workspace->_beginUpdate(false);
+    _workspace->_update();
+    _workspace->_endUpdate(false);
 
     swappedTargets.clear();
-    this->dataPtr->ogreCompositorWorkspace1st[i]->_swapFinalTarget(
-          swappedTargets );
+    _workspace->_swapFinalTarget(swappedTargets);
+
+    _workspace->setEnabled(false);
+  };
+
+  // update the compositors
+  if (this->dataPtr->segments.empty())
+  {
+    for (auto i : this->RenderedCubeFaces())
+      updateWorkspace(i, this->dataPtr->ogreCompositorWorkspace1st[i]);
+    return;
+  }
+
+  // move the cubemap cameras to the pose of the sensor in the middle of
+  // each time segment, assuming the sensor moved linearly from the scan
+  // start pose to its current pose while casting the rays from the first
+  // to the last column
+  math::Pose3d endPose = this->WorldPose();
+  math::Pose3d startPose = this->ScanStartPose();
+  double lastColumn = std::max(1u, this->dataPtr->w2nd - 1u);
+  for (auto &segment : this->dataPtr->segments)
+  {
+    double t = 0.5 * (segment.columnBegin + segment.columnEnd - 1u) /
+        lastColumn;
+    math::Vector3d pos = startPose.Pos() +
+        (endPose.Pos() - startPose.Pos()) * t;
+    math::Quaterniond rot = math::Quaterniond::Slerp(t, startPose.Rot(),
+        endPose.Rot(), true);
+
+    // cameras are attached to the sensor node
+    Ogre::Vector3 camPos = Ogre2Conversions::Convert(
+        endPose.Rot().RotateVectorReverse(pos - endPose.Pos()));
+    Ogre::Quaternion camRot = Ogre2Conversions::Convert(
+        endPose.Rot().Inverse() * rot);
+    for (auto i : segment.cubeFaceIdx)
+    {
+      this->dataPtr->cubeCam[i]->setPosition(camPos);
+      this->dataPtr->cubeCam[i]->setOrientation(
+          camRot * this->dataPtr->cubeCamOrientation[i]);
+      updateWorkspace(i, segment.ogreCompositorWorkspace1st[i]);
+    }
+  }
 
-    this->dataPtr->ogreCompositorWorkspace1st[i]->setEnabled(false);
+  for (auto i : this->dataPtr->cubeFaceIdx)
+  {
+    this->dataPtr->cubeCam[i]->setPosition(Ogre::Vector3::ZERO);
+    this->dataPtr->cubeCam[i]->setOrientation(
+        this->dataPtr->cubeCamOrientation[i]);
   }
 }
 
 /////////////////////////////////////////////////
 void Ogre2GpuRays::UpdateRenderTarget2ndPass()
 {
-  this->dataPtr->ogreCompositorWorkspace2nd->_validateFinalTarget();
-  this->dataPtr->ogreCompositorWorkspace2nd->_beginUpdate(false);
-  this->dataPtr->ogreCompositorWorkspace2nd->_update();
-  this->dataPtr->ogreCompositorWorkspace2nd->_endUpdate(false);
+  std::vector<Ogre::CompositorWorkspace *> workspaces = {
+      this->dataPtr->ogreCompositorWorkspace2nd};
+
+  // point clouds are only computed while there are subscribers
+  if (this->dataPtr->ogreCompositorWorkspacePointCloud &&
+      this->dataPtr->newGpuRaysPointCloud.ConnectionCount() > 0u)
+  {
+    workspaces.push_back(this->dataPtr->ogreCompositorWorkspacePointCloud);
+  }
 
   Ogre::vector<Ogre::TextureGpu *>::type swappedTargets;
   swappedTargets.reserve(2u);
-  this->dataPtr->ogreCompositorWorkspace2nd->_swapFinalTarget(swappedTargets);
+  for (Ogre::CompositorWorkspace *workspace : workspaces)
+  {
+    workspace->_validateFinalTarget();
+    workspace->_beginUpdate(false);
+    workspace->_update();
+    workspace->_endUpdate(false);
+
+    swappedTargets.clear();
+    workspace->_swapFinalTarget(swappedTargets);
+  }
 }
 
 //////////////////////////////////////////////////
 void Ogre2GpuRays::Render()
 {
+  IGN_PROFILE("Ogre2GpuRays::Render");
+  this->RecordFrameSubmit();
+
+  // the GPU resources are allocated when the sensor first renders
+  if (!this->dataPtr->cubeUVTexture)
+    this->PrepareRender();
+  this->BeginPassProfilers();
+
   this->scene->StartRendering(nullptr);
 
   auto engine = Ogre2RenderEngine::Instance();
@@ -1249,52 +1930,114 @@ void Ogre2GpuRays::Render()
   Ogre2IgnHlmsCustomizations &hlmsCustomizations =
       engine->HlmsCustomizations();
 
-#if IGNITION_RENDERING_MAJOR_VERSION < 7
-    // TODO(anyone): Remove this block of code when porting to ign-rendering7
-    //
-    // Set Ogre2IgnHlmsCustomizations, as we don't need terrain shadows
-    auto ogreRoot = engine->OgreRoot();
-    Ogre::Hlms *hlmsPbs = ogreRoot->getHlmsManager()->getHlms(Ogre::HLMS_PBS);
-    hlmsPbs->setListener(&hlmsCustomizations);
-#endif
+  // Forward Pbs to Ogre2IgnHlmsCustomizations, as we don't need terrain
+  // shadows
+  Ogre2MaterialOverride &materialOverride = engine->MaterialOverride();
+  materialOverride.SetListener(Ogre::HLMS_PBS, &hlmsCustomizations);
 
   hlmsCustomizations.minDistanceClip =
       static_cast<float>(this->NearClipPlane());
-  this->UpdateRenderTarget1stPass();
+  // sensors sampling a ray group leader's cubemap only run the 2nd pass
+  bool renderCubemap = !this->RayGroupLeader();
+  uint8_t numPasses = 1u;
+  if (renderCubemap)
+  {
+    this->UpdateRenderTarget1stPass();
+    // only render passes of the cubemap faces the rays actually sample
+    // count towards the gpu flush threshold
+    size_t faceCount = this->RenderedCubeFaces().size();
+    if (!this->dataPtr->segments.empty())
+    {
+      faceCount = 0u;
+      for (auto &segment : this->dataPtr->segments)
+        faceCount += segment.cubeFaceIdx.size();
+    }
+    numPasses = static_cast<uint8_t>(
+        std::clamp<size_t>(faceCount, 1u, 255u));
+  }
   this->UpdateRenderTarget2ndPass();
   hlmsCustomizations.minDistanceClip = -1;
 
-#if IGNITION_RENDERING_MAJOR_VERSION < 7
-  // TODO(anyone): Remove this block of code when porting to ign-rendering7
-  //
   // Restore the terrain shadows listener
-  hlmsPbs->setListener(engine->HlmsPbsTerraShadows());
-#endif
+  materialOverride.SetListener(Ogre::HLMS_PBS,
+      engine->HlmsPbsTerraShadows());
 
-  this->scene->FlushGpuCommandsAndStartNewFrame(6u, false);
+  this->scene->FlushGpuCommandsAndStartNewFrame(numPasses, false);
 }
 
 //////////////////////////////////////////////////
 void Ogre2GpuRays::PreRender()
+{
+  IGN_PROFILE("Ogre2GpuRays::PreRender");
+  // nothing to prepare until the sensor renders, see Render
+  if (!this->dataPtr->cubeUVTexture)
+    return;
+
+  // a ray group leader stays allocated while it renders the cubemap of
+  // other sensors
+  bool groupLeader = false;
+  if (!this->dataPtr->rayGroupKey.empty())
+  {
+    const Ogre2GpuRaysGroup &group =
+        RayGroup(this->scene, this->dataPtr->rayGroupKey);
+    groupLeader = group.leader == this && group.members.size() > 1u;
+  }
+
+  // textures, materials and compositors are created again on the next
+  // render, as they are when the ray group leader leaves
+  if (!groupLeader && this->IdleTimeoutExpired())
+  {
+    this->Destroy();
+    return;
+  }
+
+  this->PrepareRender();
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuRays::PrepareRender()
 {
   if (!this->dataPtr->cubeUVTexture)
     this->CreateGpuRaysTextures();
+
+  // gaussian noise passes are applied by the 2nd pass shader, which samples
+  // new noise each frame
+  this->dataPtr->shaderNoise.Update(*this);
+  std::vector<Ogre::MaterialPtr> materials = this->dataPtr->matPointCloud;
+  materials.push_back(this->dataPtr->matSecondPass);
+  for (auto &segment : this->dataPtr->segments)
+    materials.push_back(segment.matSecondPass);
+  for (auto &mat : materials)
+    this->dataPtr->shaderNoise.Apply(mat->getTechnique(0)->getPass(0));
+
+  for (auto cubeCam : this->dataPtr->cubeCam)
+  {
+    if (cubeCam)
+      cubeCam->setLodBias(this->LodBias());
+  }
 }
 
 //////////////////////////////////////////////////
 void Ogre2GpuRays::PostRender()
 {
+  IGN_PROFILE("Ogre2GpuRays::PostRender");
+  if (!this->dataPtr->secondPassTexture)
+    return;
+
   unsigned int width = this->dataPtr->w2nd;
   unsigned int height = this->dataPtr->h2nd;
 
   PixelFormat format = PF_FLOAT32_RGBA;
-  unsigned int rawChannelCount = PixelUtil::ChannelCount(format);
   unsigned int bytesPerChannel = PixelUtil::BytesPerChannel(format);
-  int rawLen = width * height * rawChannelCount;
 
-  if (!this->dataPtr->gpuRaysBuffer)
+  // Metal does not support RGB32_FLOAT so the internal texture format is
+  // either R32_FLOAT with packed RGB data or RGBA32_FLOAT.
+  // For backward compatibility, output data is kept in RGB
+  // format instead of RGBA
+  int outputLen = width * height * this->Channels();
+  if (!this->dataPtr->gpuRaysScan)
   {
-    this->dataPtr->gpuRaysBuffer = new float[rawLen];
+    this->dataPtr->gpuRaysScan = new float[outputLen];
   }
 
   // blit data from gpu to cpu
@@ -1302,49 +2045,97 @@ void Ogre2GpuRays::PostRender()
   image.convertFromTexture(this->dataPtr->secondPassTexture, 0u, 0u);
   Ogre::TextureBox box = image.getData(0u);
   float *bufferTmp = static_cast<float *>(box.data);
+  this->RecordFrameGpuComplete();
 
-  // copy data row by row. The texture box may not be a contiguous region of
-  // a texture
-  for (unsigned int i = 0; i < height; ++i)
-  {
-    unsigned int rawDataRowIdx = i * box.bytesPerRow / bytesPerChannel;
-    unsigned int rowIdx = i * width * rawChannelCount;
-    memcpy(&this->dataPtr->gpuRaysBuffer[rowIdx], &bufferTmp[rawDataRowIdx],
-        width * rawChannelCount * bytesPerChannel);
-  }
+  // rows are split over the post processing threads of the scene
+  Ogre2WorkerPool &workerPool = Ogre2RenderEngine::Instance()->WorkerPool();
+  unsigned int threadCount = this->scene->PostProcessThreadCount();
+  size_t rowSize = width * this->Channels() * bytesPerChannel;
+  float *gpuRaysScan = this->dataPtr->gpuRaysScan;
 
-  // Metal does not support RGB32_FLOAT so the internal texture format is
-  // RGBA32_FLOAT. For backward compatibility, output data is kept in RGB
-  // format instead of RGBA
-  int outputLen = width * height * this->Channels();
-  if (!this->dataPtr->gpuRaysScan)
+  if (this->dataPtr->ogreCompositorWorkspacePointCloud &&
+      this->dataPtr->newGpuRaysPointCloud.ConnectionCount() > 0u)
   {
-    this->dataPtr->gpuRaysScan = new float[outputLen];
+    Ogre::Image2 pointImage;
+    pointImage.convertFromTexture(this->dataPtr->pointCloudTexture, 0u, 0u);
+    Ogre::TextureBox pointBox = pointImage.getData(0u);
+
+    // the texture data is handed over as is unless its rows are padded
+    size_t pointRowSize = width * 4u * sizeof(float);
+    const float *points = static_cast<const float *>(pointBox.data);
+    if (pointBox.bytesPerRow != pointRowSize)
+    {
+      this->dataPtr->pointCloud.resize(width * height * 4u);
+      float *pointCloud = this->dataPtr->pointCloud.data();
+      workerPool.ParallelFor(height, pointRowSize, threadCount,
+          [&](unsigned int _begin, unsigned int _end)
+          {
+            Ogre2ReadbackKernels::CopyRows(pointBox.data,
+                pointBox.bytesPerRow, pointCloud, pointRowSize,
+                pointRowSize, _begin, _end);
+          });
+      points = pointCloud;
+    }
+    this->dataPtr->newGpuRaysPointCloud(points, width, height, 4u,
+        "PF_FLOAT32_RGBA");
   }
 
-  // copy data from RGBA buffer to RGB buffer
-  for (unsigned int row = 0; row < height; ++row)
+  if (this->dataPtr->packedOutput)
   {
-    // the texture box step size could be larger than our image buffer step
-    // size
-    for (unsigned int column = 0; column < width; ++column)
-    {
-      unsigned int idx = (row * width * this->Channels()) +
-          column * this->Channels();
-      unsigned int rawIdx = (row * width * rawChannelCount) +
-          column * rawChannelCount;
-
-      this->dataPtr->gpuRaysScan[idx] =
-          this->dataPtr->gpuRaysBuffer[rawIdx];
-      this->dataPtr->gpuRaysScan[idx + 1] =
-          this->dataPtr->gpuRaysBuffer[rawIdx + 1];
-      this->dataPtr->gpuRaysScan[idx + 2] =
-          this->dataPtr->gpuRaysBuffer[rawIdx + 2];
-    }
+    PixelFormat secondPassFormat = this->dataPtr->secondPassFormat;
+    this->dataPtr->newEncodedGpuRaysFrame(box.data, width, height,
+        static_cast<unsigned int>(box.bytesPerRow),
+        PixelUtil::Name(secondPassFormat));
+
+    // texture data is already in RGB layout. Copy it in one go unless the
+    // texture box rows are padded, or decode it if it is encoded
+    const uint16_t *encoded = static_cast<const uint16_t *>(box.data);
+    workerPool.ParallelFor(height, rowSize, threadCount,
+        [&](unsigned int _begin, unsigned int _end)
+        {
+          if (secondPassFormat == PF_FLOAT16_RGB)
+          {
+            Ogre2ReadbackKernels::HalfToFloat(encoded, box.bytesPerRow,
+                gpuRaysScan, width * 3u, _begin, _end);
+          }
+          else if (secondPassFormat == PF_UINT16_RGB)
+          {
+            Ogre2ReadbackKernels::MillimetersToMeters(encoded,
+                box.bytesPerRow, 3u, gpuRaysScan, width, _begin, _end);
+          }
+          else
+          {
+            Ogre2ReadbackKernels::CopyRows(bufferTmp, box.bytesPerRow,
+                gpuRaysScan, rowSize, rowSize, _begin, _end);
+          }
+        });
+
+    this->RecordFrameReadback();
+    IGN_PROFILE_BEGIN("Dispatch newGpuRaysFrame");
+    this->dataPtr->newGpuRaysFrame(this->dataPtr->gpuRaysScan,
+        width, height, this->Channels(), "PF_FLOAT32_RGB");
+    IGN_PROFILE_END();
+    this->RecordFrameDelivered();
+    return;
   }
 
+  // copy data from the RGBA texture box to the RGB buffer. The texture box
+  // step size could be larger than our image buffer step size
+  workerPool.ParallelFor(height, rowSize, threadCount,
+      [&](unsigned int _begin, unsigned int _end)
+      {
+        Ogre2ReadbackKernels::RgbaToRgb(bufferTmp, box.bytesPerRow,
+            gpuRaysScan, width, _begin, _end);
+      });
+  this->dataPtr->newEncodedGpuRaysFrame(gpuRaysScan, width, height,
+      static_cast<unsigned int>(rowSize), PixelUtil::Name(PF_FLOAT32_RGB));
+
+  this->RecordFrameReadback();
+  IGN_PROFILE_BEGIN("Dispatch newGpuRaysFrame");
   this->dataPtr->newGpuRaysFrame(this->dataPtr->gpuRaysScan,
       width, height, this->Channels(), "PF_FLOAT32_RGB");
+  IGN_PROFILE_END();
+  this->RecordFrameDelivered();
 
   // Uncomment to debug output
   // std::cerr << "wxh: " << width << " x " << height << std::endl;
@@ -1365,6 +2156,209 @@ void Ogre2GpuRays::PostRender()
   // }
 }
 
+//////////////////////////////////////////////////
+void Ogre2GpuRays::SetRayGroup(const std::string &_group)
+{
+  if (this->dataPtr->rayGroup == _group)
+    return;
+
+  this->dataPtr->rayGroup = _group;
+
+  // textures are recreated on the next PreRender so the sensor joins the
+  // new group
+  if (this->dataPtr->cubeUVTexture)
+    this->Destroy();
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2GpuRays::RayGroup() const
+{
+  return this->dataPtr->rayGroup;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2GpuRays::SetVerticalBeams(const std::vector<double> &_elevations,
+    const std::vector<double> &_azimuthOffsets)
+{
+  if (!BaseGpuRays::SetVerticalBeams(_elevations, _azimuthOffsets))
+    return false;
+
+  // textures are recreated on the next PreRender to sample the new beams
+  if (this->dataPtr->cubeUVTexture)
+    this->Destroy();
+  return true;
+}
+
+//////////////////////////////////////////////////
+common::ConnectionPtr Ogre2GpuRays::ConnectNewGpuRaysPointCloud(
+    std::function<void(const float *, unsigned int, unsigned int,
+    unsigned int, const std::string &)> _subscriber)
+{
+  // textures are recreated on the next PreRender to add the point cloud
+  // pass
+  if (this->dataPtr->cubeUVTexture && !this->dataPtr->rayDirTexture)
+    this->Destroy();
+  return this->dataPtr->newGpuRaysPointCloud.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+bool Ogre2GpuRays::SetRayPattern(const std::vector<math::Vector2d> &_rays,
+    unsigned int _width)
+{
+  if (!BaseGpuRays::SetRayPattern(_rays, _width))
+    return false;
+
+  // textures are recreated on the next PreRender to sample the new rays
+  if (this->dataPtr->cubeUVTexture)
+    this->Destroy();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuRays::SetScanSegmentCount(unsigned int _count)
+{
+  unsigned int count = this->ScanSegmentCount();
+  BaseGpuRays::SetScanSegmentCount(_count);
+
+  // the textures of each segment are created with the sampling texture
+  if (this->ScanSegmentCount() != count && this->dataPtr->cubeUVTexture)
+    this->Destroy();
+}
+
+//////////////////////////////////////////////////
+bool Ogre2GpuRays::SetOutputFormat(PixelFormat _format)
+{
+  if (_format != PF_FLOAT32_RGB && _format != PF_FLOAT16_RGB &&
+      _format != PF_UINT16_RGB)
+  {
+    ignerr << "Unsupported gpu rays output format: "
+           << PixelUtil::Name(_format) << std::endl;
+    return false;
+  }
+
+  if (this->dataPtr->outputFormat == _format)
+    return true;
+
+  this->dataPtr->outputFormat = _format;
+
+  // textures are recreated on the next PreRender with the new format
+  if (this->dataPtr->cubeUVTexture)
+    this->Destroy();
+  return true;
+}
+
+//////////////////////////////////////////////////
+PixelFormat Ogre2GpuRays::OutputFormat() const
+{
+  return this->dataPtr->outputFormat;
+}
+
+//////////////////////////////////////////////////
+common::ConnectionPtr Ogre2GpuRays::ConnectNewEncodedGpuRaysFrame(
+    std::function<void(const void *, unsigned int, unsigned int,
+    unsigned int, const std::string &)> _subscriber)
+{
+  return this->dataPtr->newEncodedGpuRaysFrame.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuRays::JoinRayGroup()
+{
+  if (this->dataPtr->rayGroup.empty())
+    return;
+
+  std::string key = this->dataPtr->rayGroup;
+  Ogre2GpuRaysGroup &group = RayGroup(this->scene, key);
+  if (!group.leader)
+  {
+    group.leader = this;
+  }
+  else
+  {
+    // the 1st pass clamps range data using the leader's parameters
+    Ogre2GpuRays *leader = group.leader;
+    if (!math::equal(leader->NearClipPlane(), this->NearClipPlane()) ||
+        !math::equal(leader->FarClipPlane(), this->FarClipPlane()) ||
+        leader->dataMinVal != this->dataMinVal ||
+        leader->dataMaxVal != this->dataMaxVal)
+    {
+      ignwarn << "Clip planes or data range of GpuRays [" << this->Name()
+              << "] do not match those of ray group ["
+              << this->dataPtr->rayGroup << "] leader [" << leader->Name()
+              << "]. It will render its own cubemap." << std::endl;
+      return;
+    }
+  }
+  this->dataPtr->rayGroupKey = key;
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuRays::LeaveRayGroup()
+{
+  if (this->dataPtr->rayGroupKey.empty())
+    return;
+
+  auto &groups = this->scene->GpuRaysGroups();
+  auto it = groups.find(this->dataPtr->rayGroupKey);
+  this->dataPtr->rayGroupKey.clear();
+  if (it == groups.end())
+    return;
+
+  Ogre2GpuRaysGroup &group = *it->second;
+  group.members.erase(this);
+
+  if (group.leader == this)
+  {
+    // The shared cubemap is about to be destroyed. Reset the remaining
+    // members so they recreate their textures on the next PreRender
+    std::vector<Ogre2GpuRays *> members;
+    for (const auto &member : group.members)
+      members.push_back(member.first);
+    groups.erase(it);
+
+    for (auto member : members)
+    {
+      member->dataPtr->rayGroupKey.clear();
+      member->Destroy();
+    }
+    return;
+  }
+
+  group.cubeFaceIdx.clear();
+  for (const auto &member : group.members)
+  {
+    group.cubeFaceIdx.insert(member.second.begin(), member.second.end());
+  }
+}
+
+//////////////////////////////////////////////////
+const std::set<unsigned int> &Ogre2GpuRays::RenderedCubeFaces() const
+{
+  // a ray group leader renders the faces needed by all sensors in the group
+  if (!this->dataPtr->rayGroupKey.empty())
+  {
+    auto &groups = this->scene->GpuRaysGroups();
+    auto it = groups.find(this->dataPtr->rayGroupKey);
+    if (it != groups.end() && it->second->leader == this)
+      return it->second->cubeFaceIdx;
+  }
+  return this->dataPtr->cubeFaceIdx;
+}
+
+//////////////////////////////////////////////////
+Ogre2GpuRays *Ogre2GpuRays::RayGroupLeader() const
+{
+  if (this->dataPtr->rayGroupKey.empty())
+    return nullptr;
+
+  auto &groups = this->scene->GpuRaysGroups();
+  auto it = groups.find(this->dataPtr->rayGroupKey);
+  if (it == groups.end() || it->second->leader == this)
+    return nullptr;
+
+  return it->second->leader;
+}
+
 //////////////////////////////////////////////////
 const float* Ogre2GpuRays::Data() const
 {
@@ -1411,3 +2405,16 @@ RenderTargetPtr Ogre2GpuRays::RenderTarget() const
 {
   return this->dataPtr->renderTexture;
 }
+
+//////////////////////////////////////////////////
+unsigned int Ogre2GpuRays::RenderTextureGLId() const
+{
+  return Ogre2RenderTarget::TextureGLId(this->dataPtr->secondPassTexture);
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuRays::RenderTextureMetalId(void *_textureIdPtr) const
+{
+  Ogre2RenderTarget::TextureMetalId(this->dataPtr->secondPassTexture,
+      _textureIdPtr);
+}
@@ -0,0 +1,299 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#if !defined(__APPLE__) && !defined(_WIN32)
+# include <GL/glx.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+#include <ignition/common/Console.hh>
+
+#include "Ogre2GpuTimer.hh"
+
+#ifndef GL_QUERY_RESULT
+# define GL_QUERY_RESULT 0x8866
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+# define GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
+#ifndef GL_TIMESTAMP
+# define GL_TIMESTAMP 0x8E28
+#endif
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Weight of the latest frame in the rolling averages
+static const double kAverageWeight = 0.05;
+
+/// \brief Maximum number of frames waiting for results. Older frames are
+/// dropped instead of stalling if the GPU falls behind further.
+static const size_t kMaxPendingFrames = 5u;
+
+/// \brief GL timer query entry points. They are not part of the GL 1.x
+/// headers, so they are looked up at runtime.
+struct GlTimerFunctions
+{
+  void (*genQueries)(int, unsigned int *) = nullptr;
+  void (*deleteQueries)(int, const unsigned int *) = nullptr;
+  void (*queryCounter)(unsigned int, unsigned int) = nullptr;
+  void (*getQueryObjectuiv)(unsigned int, unsigned int, unsigned int *) =
+      nullptr;
+  void (*getQueryObjectui64v)(unsigned int, unsigned int, uint64_t *) =
+      nullptr;
+  bool loaded = false;
+};
+
+//////////////////////////////////////////////////
+static const GlTimerFunctions &glTimerFunctions()
+{
+  static GlTimerFunctions functions = []()
+  {
+    GlTimerFunctions f;
+#if !defined(__APPLE__) && !defined(_WIN32)
+    auto load = [](const char *_name)
+    {
+      return glXGetProcAddressARB(reinterpret_cast<const GLubyte *>(_name));
+    };
+    f.genQueries = reinterpret_cast<decltype(f.genQueries)>(
+        load("glGenQueries"));
+    f.deleteQueries = reinterpret_cast<decltype(f.deleteQueries)>(
+        load("glDeleteQueries"));
+    f.queryCounter = reinterpret_cast<decltype(f.queryCounter)>(
+        load("glQueryCounter"));
+    f.getQueryObjectuiv = reinterpret_cast<decltype(f.getQueryObjectuiv)>(
+        load("glGetQueryObjectuiv"));
+    f.getQueryObjectui64v =
+        reinterpret_cast<decltype(f.getQueryObjectui64v)>(
+        load("glGetQueryObjectui64v"));
+#endif
+    f.loaded = f.genQueries && f.deleteQueries && f.queryCounter &&
+        f.getQueryObjectuiv && f.getQueryObjectui64v;
+    if (!f.loaded)
+      ignwarn << "GPU timer queries are not available" << std::endl;
+    return f;
+  }();
+  return functions;
+}
+
+//////////////////////////////////////////////////
+Ogre2GpuTimer::Ogre2GpuTimer()
+{
+  this->frames.emplace_back();
+}
+
+//////////////////////////////////////////////////
+Ogre2GpuTimer::~Ogre2GpuTimer()
+{
+  if (!this->queries.empty() && Available())
+  {
+    glTimerFunctions().deleteQueries(static_cast<int>(this->queries.size()),
+        this->queries.data());
+  }
+}
+
+//////////////////////////////////////////////////
+bool Ogre2GpuTimer::Available()
+{
+  return glTimerFunctions().loaded;
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuTimer::BeginFrame()
+{
+  // passes left open belong to a broken frame, drop it
+  if (!this->openPasses.empty())
+  {
+    for (const auto &timing : this->frames.back())
+    {
+      this->freeQueries.push_back(timing.begin);
+      this->freeQueries.push_back(timing.end);
+    }
+    this->frames.back().clear();
+    this->openPasses.clear();
+  }
+
+  this->Resolve();
+
+  // reuse the current frame if nothing was rendered, e.g. on demand
+  // rendering skipped it
+  if (!this->frames.back().empty())
+    this->frames.emplace_back();
+}
+
+//////////////////////////////////////////////////
+RenderStats Ogre2GpuTimer::Stats() const
+{
+  return this->stats;
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuTimer::passPreExecute(Ogre::CompositorPass *_pass)
+{
+  if (!Available())
+    return;
+
+  Timing timing;
+  timing.name = PassName(_pass);
+  timing.begin = this->Query();
+  timing.end = this->Query();
+  timing.parent = this->openPasses.empty() ? -1 : this->openPasses.back();
+  glTimerFunctions().queryCounter(timing.begin, GL_TIMESTAMP);
+
+  auto &frame = this->frames.back();
+  this->openPasses.push_back(static_cast<int>(frame.size()));
+  frame.push_back(timing);
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuTimer::passPosExecute(Ogre::CompositorPass * /*_pass*/)
+{
+  if (!Available() || this->openPasses.empty())
+    return;
+
+  const Timing &timing = this->frames.back()[this->openPasses.back()];
+  glTimerFunctions().queryCounter(timing.end, GL_TIMESTAMP);
+  this->openPasses.pop_back();
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2GpuTimer::PassName(Ogre::CompositorPass *_pass)
+{
+  if (dynamic_cast<Ogre::CompositorShadowNode *>(_pass->getParentNode()))
+    return "shadow";
+
+  switch (_pass->getType())
+  {
+    case Ogre::PASS_SCENE:
+      return "scene";
+    case Ogre::PASS_QUAD:
+    {
+      const Ogre::CompositorPassQuadDef *def =
+          static_cast<const Ogre::CompositorPassQuadDef *>(
+          _pass->getDefinition());
+      return def->mMaterialName.empty() ? std::string("quad") :
+          "quad " + def->mMaterialName;
+    }
+    case Ogre::PASS_CLEAR:
+      return "clear";
+    default:
+      return "other";
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2GpuTimer::Query()
+{
+  if (this->freeQueries.empty())
+  {
+    // allocate in blocks to limit GL calls
+    const int blockSize = 16;
+    std::vector<unsigned int> block(blockSize);
+    glTimerFunctions().genQueries(blockSize, block.data());
+    this->queries.insert(this->queries.end(), block.begin(), block.end());
+    this->freeQueries.insert(this->freeQueries.end(), block.begin(),
+        block.end());
+  }
+
+  unsigned int query = this->freeQueries.back();
+  this->freeQueries.pop_back();
+  return query;
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuTimer::Resolve()
+{
+  const auto &gl = glTimerFunctions();
+
+  // the last frame is still being recorded
+  while (this->frames.size() > 1u)
+  {
+    auto &frame = this->frames.front();
+
+    bool ready = true;
+    for (const auto &timing : frame)
+    {
+      unsigned int available = 0u;
+      gl.getQueryObjectuiv(timing.end, GL_QUERY_RESULT_AVAILABLE,
+          &available);
+      if (!available)
+      {
+        ready = false;
+        break;
+      }
+    }
+
+    if (!ready && this->frames.size() <= kMaxPendingFrames)
+      break;
+
+    if (ready)
+    {
+      // exclusive time of each pass, nested passes are subtracted from
+      // their parent
+      std::vector<double> durations(frame.size(), 0.0);
+      for (size_t i = 0; i < frame.size(); ++i)
+      {
+        uint64_t begin = 0u;
+        uint64_t end = 0u;
+        gl.getQueryObjectui64v(frame[i].begin, GL_QUERY_RESULT, &begin);
+        gl.getQueryObjectui64v(frame[i].end, GL_QUERY_RESULT, &end);
+        double ms = end > begin ? (end - begin) * 1e-6 : 0.0;
+        durations[i] += ms;
+        if (frame[i].parent >= 0)
+          durations[frame[i].parent] -= ms;
+      }
+
+      double alpha = this->stats.frameCount == 0u ? 1.0 : kAverageWeight;
+      for (auto &pass : this->stats.passes)
+        pass.lastMs = 0.0;
+
+      double total = 0.0;
+      for (size_t i = 0; i < frame.size(); ++i)
+      {
+        double ms = std::max(durations[i], 0.0);
+        total += ms;
+        auto it = std::find_if(this->stats.passes.begin(),
+            this->stats.passes.end(), [&](const RenderPassStats &_p)
+            {return _p.name == frame[i].name;});
+        if (it == this->stats.passes.end())
+        {
+          RenderPassStats pass;
+          pass.name = frame[i].name;
+          this->stats.passes.push_back(pass);
+          it = std::prev(this->stats.passes.end());
+        }
+        it->lastMs += ms;
+      }
+
+      for (auto &pass : this->stats.passes)
+        pass.averageMs += alpha * (pass.lastMs - pass.averageMs);
+      this->stats.lastMs = total;
+      this->stats.averageMs += alpha * (total - this->stats.averageMs);
+      this->stats.frameCount++;
+    }
+
+    for (const auto &timing : frame)
+    {
+      this->freeQueries.push_back(timing.begin);
+      this->freeQueries.push_back(timing.end);
+    }
+    this->frames.pop_front();
+  }
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2GPUTIMER_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2GPUTIMER_HH_
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "ignition/rendering/RenderStats.hh"
+#include "ignition/rendering/ogre2/Ogre2Includes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Compositor workspace listener that wraps every pass of the
+    /// workspaces it is added to with GPU timestamp queries. Results are
+    /// read back a few frames later, once the GPU has reached them, so
+    /// reading them never stalls the pipeline.
+    ///
+    /// Passes are grouped by kind: passes of a shadow node are "shadow",
+    /// scene passes are "scene" and quad passes are "quad" followed by
+    /// their material name, e.g. noise or sky passes. Shadow passes run
+    /// inside the scene pass that needs them and are subtracted from it.
+    class Ogre2GpuTimer : public Ogre::CompositorWorkspaceListener
+    {
+      /// \brief Constructor
+      public: Ogre2GpuTimer();
+
+      /// \brief Destructor
+      public: virtual ~Ogre2GpuTimer();
+
+      /// \brief Check if GPU timestamp queries are available
+      /// \return True if passes can be timed
+      public: static bool Available();
+
+      /// \brief Start a new frame. Passes executed until the next call are
+      /// summed up as one frame. This also collects results of earlier
+      /// frames that are ready.
+      public: void BeginFrame();
+
+      /// \brief Get the timings collected so far
+      /// \return GPU timings
+      public: RenderStats Stats() const;
+
+      // Documentation inherited.
+      public: virtual void passPreExecute(Ogre::CompositorPass *_pass)
+          override;
+
+      // Documentation inherited.
+      public: virtual void passPosExecute(Ogre::CompositorPass *_pass)
+          override;
+
+      /// \brief Get the name of the group a pass is timed under
+      /// \param[in] _pass Compositor pass
+      /// \return Name of the pass group
+      private: static std::string PassName(Ogre::CompositorPass *_pass);
+
+      /// \brief Get an unused query object, creating one if needed
+      /// \return GL query object name
+      private: unsigned int Query();
+
+      /// \brief Read back and accumulate all frames whose results are ready
+      private: void Resolve();
+
+      /// \brief A timed pass
+      private: struct Timing
+      {
+        /// \brief Pass group name
+        std::string name;
+
+        /// \brief Query holding the timestamp before the pass
+        unsigned int begin = 0u;
+
+        /// \brief Query holding the timestamp after the pass
+        unsigned int end = 0u;
+
+        /// \brief Index of the enclosing pass in the frame, or -1
+        int parent = -1;
+      };
+
+      /// \brief Passes of the frames waiting for GPU results, oldest first.
+      /// The last frame is the one being recorded.
+      private: std::deque<std::vector<Timing>> frames;
+
+      /// \brief Indices of the passes currently executing in the last frame
+      private: std::vector<int> openPasses;
+
+      /// \brief Query objects not in use
+      private: std::vector<unsigned int> freeQueries;
+
+      /// \brief All query objects created by this timer
+      private: std::vector<unsigned int> queries;
+
+      /// \brief Accumulated timings
+      private: RenderStats stats;
+    };
+    }
+  }
+}
+#endif
@@ -17,6 +17,17 @@
 
 #include <ignition/common/Console.hh>
 
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreItem.h>
+#include <OgreMaterialManager.h>
+#include <OgrePass.h>
+#include <OgreTechnique.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
 #include "ignition/rendering/ogre2/Ogre2Grid.hh"
 #include "ignition/rendering/ogre2/Ogre2Material.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
@@ -32,6 +43,13 @@ class ignition::rendering::Ogre2GridPrivate
 
   /// \brief Ogre renderable used to render the grid.
   public: std::shared_ptr<Ogre2DynamicRenderable> grid = nullptr;
+
+  /// \brief Low level material drawing the lines of a procedural grid,
+  /// null until the grid is first drawn procedurally
+  public: Ogre::MaterialPtr proceduralMaterial;
+
+  /// \brief True if the renderable holds the quad of a procedural grid
+  public: bool proceduralActive = false;
 };
 
 //////////////////////////////////////////////////
@@ -53,6 +71,11 @@ void Ogre2Grid::PreRender()
     this->Create();
     this->gridDirty = false;
   }
+  else if (this->dataPtr->proceduralActive)
+  {
+    // the color of the material may have changed
+    this->UpdateProceduralMaterial();
+  }
 }
 
 //////////////////////////////////////////////////
@@ -67,6 +90,18 @@ void Ogre2Grid::Init()
   this->Create();
 }
 
+//////////////////////////////////////////////////
+void Ogre2Grid::Destroy()
+{
+  if (!this->dataPtr->proceduralMaterial.isNull())
+  {
+    Ogre::MaterialManager::getSingleton().remove(
+        this->dataPtr->proceduralMaterial->getHandle());
+    this->dataPtr->proceduralMaterial.setNull();
+  }
+  BaseGrid::Destroy();
+}
+
 //////////////////////////////////////////////////
 void Ogre2Grid::Create()
 {
@@ -79,6 +114,22 @@ void Ogre2Grid::Create()
   this->dataPtr->grid->Clear();
   this->dataPtr->grid->Update();
 
+  // the shader only draws horizontal lines
+  if (this->procedural && this->verticalCellCount == 0u)
+  {
+    this->CreateProcedural();
+    return;
+  }
+
+  // the renderable keeps the low level material of the procedural grid
+  // until it is given a datablock again
+  if (this->dataPtr->proceduralActive)
+  {
+    this->dataPtr->proceduralActive = false;
+    if (this->dataPtr->material)
+      this->dataPtr->grid->SetMaterial(this->dataPtr->material, false);
+  }
+
   this->dataPtr->grid->SetOperationType(MarkerType::MT_LINE_LIST);
   double baseExtent = (this->cellLength *
      static_cast<double>(this->cellCount - this->cellCount % 2))/2;
@@ -149,6 +200,87 @@ void Ogre2Grid::Create()
   this->dataPtr->grid->Update();
 }
 
+//////////////////////////////////////////////////
+void Ogre2Grid::CreateProcedural()
+{
+  if (this->dataPtr->proceduralMaterial.isNull())
+  {
+    Ogre::MaterialManager &materialManager =
+        Ogre::MaterialManager::getSingleton();
+    Ogre::MaterialPtr gridMaterial =
+        materialManager.getByName("ProceduralGrid");
+    if (gridMaterial.isNull())
+    {
+      ignerr << "Procedural grid material not found" << std::endl;
+      return;
+    }
+    this->dataPtr->proceduralMaterial = gridMaterial->clone(
+        this->scene->Name() + "::" + this->Name() + "::ProceduralGrid");
+    this->dataPtr->proceduralMaterial->load();
+  }
+
+  // two triangles covering the grid, with a margin of half a cell so the
+  // outer lines are not cut in half
+  double baseExtent = (this->cellLength *
+     static_cast<double>(this->cellCount - this->cellCount % 2))/2;
+  double extent = baseExtent;
+  if (this->cellCount % 2)
+    extent += this->cellLength;
+  double margin = this->cellLength * 0.5;
+  double minXY = -baseExtent - margin;
+  double maxXY = extent + margin;
+
+  this->dataPtr->grid->SetOperationType(MarkerType::MT_TRIANGLE_LIST);
+  this->dataPtr->grid->AddPoint(minXY, minXY, this->heightOffset);
+  this->dataPtr->grid->AddPoint(maxXY, minXY, this->heightOffset);
+  this->dataPtr->grid->AddPoint(maxXY, maxXY, this->heightOffset);
+  this->dataPtr->grid->AddPoint(minXY, minXY, this->heightOffset);
+  this->dataPtr->grid->AddPoint(maxXY, maxXY, this->heightOffset);
+  this->dataPtr->grid->AddPoint(minXY, maxXY, this->heightOffset);
+  this->dataPtr->grid->Update();
+
+  // set after the update, which gives the item its datablock back if the
+  // vertex buffer was recreated
+  Ogre::Item *item =
+      static_cast<Ogre::Item *>(this->dataPtr->grid->OgreObject());
+  item->getSubItem(0)->setMaterial(this->dataPtr->proceduralMaterial);
+  item->setCastShadows(false);
+  this->dataPtr->proceduralActive = true;
+
+  this->UpdateProceduralMaterial();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Grid::UpdateProceduralMaterial()
+{
+  if (this->dataPtr->proceduralMaterial.isNull())
+    return;
+
+  Ogre::Pass *pass =
+      this->dataPtr->proceduralMaterial->getTechnique(0)->getPass(0);
+  Ogre::GpuProgramParametersSharedPtr params =
+      pass->getFragmentProgramParameters();
+
+  // the shader works in cells, the lines are at whole cells
+  double baseCells = static_cast<double>(this->cellCount -
+      this->cellCount % 2) / 2.0;
+  double cells = baseCells + static_cast<double>(this->cellCount % 2);
+  params->setNamedConstant("cellLength",
+      static_cast<float>(this->cellLength));
+  params->setNamedConstant("bounds", Ogre::Vector4(
+      static_cast<Ogre::Real>(-baseCells), static_cast<Ogre::Real>(-baseCells),
+      static_cast<Ogre::Real>(cells), static_cast<Ogre::Real>(cells)));
+
+  math::Color color = math::Color::White;
+  if (this->dataPtr->material)
+  {
+    color = this->dataPtr->material->Diffuse();
+    color.A(static_cast<float>(1.0 - this->dataPtr->material->Transparency()));
+  }
+  params->setNamedConstant("colour",
+      Ogre::ColourValue(color.R(), color.G(), color.B(), color.A()));
+}
+
 //////////////////////////////////////////////////
 void Ogre2Grid::SetMaterial(MaterialPtr _material, bool _unique)
 {
@@ -165,9 +297,13 @@ void Ogre2Grid::SetMaterial(MaterialPtr _material, bool _unique)
     return;
   }
 
-  // Set material for the underlying dynamic renderable
-  this->dataPtr->grid->SetMaterial(_material, false);
+  // Set material for the underlying dynamic renderable. A procedural grid
+  // only takes the color of the material
+  if (!this->dataPtr->proceduralActive)
+    this->dataPtr->grid->SetMaterial(_material, false);
   this->SetMaterialImpl(derived);
+  if (this->dataPtr->proceduralActive)
+    this->UpdateProceduralMaterial();
 }
 
 //////////////////////////////////////////////////
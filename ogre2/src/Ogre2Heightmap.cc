@@ -15,16 +15,37 @@
  *
 */
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
 
 #include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
 #include <ignition/common/Util.hh>
+#include <ignition/math/Vector2.hh>
 
 #include "ignition/rendering/ogre2/Ogre2Heightmap.hh"
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2Light.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
+#include "ignition/rendering/Utils.hh"
+#include "Ogre2HeightmapTiles.hh"
+#include "Ogre2WorkerPool.hh"
 
 #include "Terra/Terra.h"
 
@@ -37,15 +58,120 @@
 #include <OgreImage2.h>
 #include <OgreRoot.h>
 #include <OgreSceneManager.h>
+#include <OgreSceneNode.h>
 #include "Terra/Hlms/OgreHlmsTerra.h"
 #include "Terra/Hlms/OgreHlmsTerraDatablock.h"
 #ifdef _MSC_VER
   #pragma warning(pop)
 #endif
 
+/// \brief Header of a cached heightmap file. It is followed by
+/// width x width normalized float heights
+struct HeightmapCacheHeader
+{
+  /// \brief File signature and format version
+  char magic[8];
+
+  /// \brief Number of samples along each edge
+  uint32_t width;
+
+  /// \brief Elevation mapped to a normalized height of 0
+  float minElevation;
+
+  /// \brief Elevation mapped to a normalized height of 1
+  float maxElevation;
+
+  /// \brief Keeps the heights 8 byte aligned
+  uint32_t padding;
+};
+
+/// \brief Signature of heightmap cache files. Bump the version whenever
+/// the sampling or normalization done in Ogre2Heightmap::Init changes
+static const char kHeightmapCacheMagic[8] = {
+    'I', 'G', 'N', 'T', 'E', 'R', 'R', '1'};
+
 //////////////////////////////////////////////////
 class ignition::rendering::Ogre2HeightmapPrivate
 {
+  /// \brief A terrain tile loaded when terrain paging is enabled
+  public: class Tile
+  {
+    /// \brief Terra instance rendering this tile
+    public: std::unique_ptr<Ogre::Terra> terra;
+
+    /// \brief Normalized height samples of this tile, including the first
+    /// row and column of its neighbours. See Ogre2HeightmapTiles
+    public: std::vector<float> heights;
+
+    /// \brief Name of the datablock created for this tile
+    public: std::string datablockName;
+
+    /// \brief Value of the update counter when this tile was last needed by
+    /// a camera. Used to unload the least recently used tiles first
+    public: uint64_t lastUsed{0u};
+  };
+
+  /// \brief Create and load a Terra instance
+  /// \param[in] _desc Heightmap descriptor
+  /// \param[in] _sceneManager Ogre scene manager
+  /// \param[in] _heights Normalized height samples, _width x _width.
+  /// Must stay valid while the terra is alive
+  /// \param[in] _width Number of samples along each edge
+  /// \param[in] _center Center of the terra in world coordinates
+  /// \param[in] _size Size of the terra in world coordinates
+  /// \param[in] _name Name of the terra and of its datablock
+  /// \param[in] _uvOffset Offset of the terra's min corner from the min
+  /// corner of the whole heightmap. Used to keep detail textures continuous
+  /// across tiles
+  /// \param[in] _allowBaseTexture Whether the first texture can be used as
+  /// a base texture stretched over the whole terra
+  /// \return The new Terra instance
+  public: std::unique_ptr<Ogre::Terra> CreateTerra(
+      const HeightmapDescriptor &_desc, Ogre::SceneManager *_sceneManager,
+      float *_heights, unsigned int _width,
+      const math::Vector3d &_center, const math::Vector3d &_size,
+      const std::string &_name, const math::Vector2d &_uvOffset,
+      bool _allowBaseTexture);
+
+  /// \brief Destructor
+  public: ~Ogre2HeightmapPrivate();
+
+  /// \brief Map the normalized heights from a heightmap cache file
+  /// \param[in] _path Path to the cache file
+  /// \param[in] _width Expected number of samples along each edge
+  /// \param[out] _minElevation Elevation of a normalized height of 0
+  /// \param[out] _maxElevation Elevation of a normalized height of 1
+  /// \return True if the cache file exists and is valid
+  public: bool LoadCache(const std::string &_path, unsigned int _width,
+      float &_minElevation, float &_maxElevation);
+
+  /// \brief Write the normalized heights to a heightmap cache file
+  /// \param[in] _path Path to the cache file
+  /// \param[in] _minElevation Elevation of a normalized height of 0
+  /// \param[in] _maxElevation Elevation of a normalized height of 1
+  public: void SaveCache(const std::string &_path, float _minElevation,
+      float _maxElevation) const;
+
+  /// \brief Load a terrain tile and attach it to the same node as the
+  /// anchor tile
+  /// \param[in] _desc Heightmap descriptor
+  /// \param[in] _x Tile column
+  /// \param[in] _y Tile row
+  /// \return The loaded tile
+  public: Tile &LoadTile(const HeightmapDescriptor &_desc,
+      unsigned int _x, unsigned int _y);
+
+  /// \brief Unload a terrain tile
+  /// \param[in] _key Key of the tile in the tiles map
+  public: void UnloadTile(uint64_t _key);
+
+  /// \brief Load the tiles around a camera and unload the least recently
+  /// used ones to stay within the resident tile budget
+  /// \param[in] _desc Heightmap descriptor
+  /// \param[in] _camera Camera about to be used for rendering
+  public: void UpdateTiles(const HeightmapDescriptor &_desc,
+      const Ogre::Camera *_camera);
+
   /// \brief Skirt min height. Leave it at -1 for automatic.
   /// Leave it at 0 for maximum skirt size (high performance hit)
   public: float skirtMinHeight{-1};
@@ -54,19 +180,236 @@ class ignition::rendering::Ogre2HeightmapPrivate
   /// so we can use it if skirtMinHeight becomes -1 again
   public: float autoSkirtValue;
 
-  /// \brief The raw height values.
+  /// \brief Light direction change that triggers a terrain shadow update
+  public: math::Angle shadowAngleThreshold{0.0};
+
+  /// \brief Number of renders a terrain shadow update is spread across
+  public: unsigned int shadowSlices{1u};
+
+  /// \brief Distance a camera can move before its terrain LODs are rebuilt
+  public: double lodDistanceThreshold{0.0};
+
+  /// \brief Angle a camera can turn before its terrain LODs are rebuilt
+  public: math::Angle lodAngleThreshold{0.0};
+
+  /// \brief The raw height values. Empty if the heights were mapped
+  /// from the cache
   public: std::vector<float> heights;
 
+  /// \brief Normalized height values, dataSize x dataSize. Points to
+  /// either heights or mappedCache
+  public: float *heightData{nullptr};
+
+  /// \brief Memory mapped heightmap cache file, if any
+  public: void *mappedCache{nullptr};
+
+  /// \brief Size in bytes of mappedCache
+  public: size_t mappedCacheSize{0u};
+
   /// \brief Size of the heightmap data.
   public: unsigned int dataSize{0u};
 
-  /// \brief Pointer to ogre terra object
+  /// \brief Pointer to ogre terra object. When terrain paging is enabled
+  /// this is the anchor tile, which stays loaded and is the object attached
+  /// to the parent visual
   public: std::unique_ptr<Ogre::Terra> terra{nullptr};
+
+  /// \brief Pointer to ogre scene manager
+  public: Ogre::SceneManager *sceneManager{nullptr};
+
+  /// \brief True if the terrain is split in tiles loaded on demand
+  public: bool paged{false};
+
+  /// \brief Number of heightmap samples spanned by each edge of a tile
+  public: unsigned int tileSize{0u};
+
+  /// \brief Number of tiles along each edge of the heightmap
+  public: unsigned int tileCount{0u};
+
+  /// \brief Maximum number of tiles loaded at the same time, including the
+  /// anchor tile
+  public: unsigned int maxResidentTiles{0u};
+
+  /// \brief Key of the anchor tile
+  public: uint64_t anchorKey{0u};
+
+  /// \brief Loaded tiles, indexed by row * tileCount + column
+  public: std::unordered_map<uint64_t, Tile> tiles;
+
+  /// \brief Incremented every time tiles are updated for a camera
+  public: uint64_t updateCount{0u};
+
+  /// \brief Terra instance closest to the last camera used for rendering
+  public: Ogre::Terra *activeTerra{nullptr};
+
+  /// \brief Min corner of the heightmap's xy footprint in world coordinates
+  public: math::Vector2d minCorner;
+
+  /// \brief Size of the heightmap after normalization, heightDiff in z
+  public: math::Vector3d terrainSize;
+
+  /// \brief World z of the centre of the normalized height range
+  public: double centerZ{0.0};
+
+  /// \brief Maximum number of tiles loaded per camera update so streaming
+  /// does not stall a single frame
+  public: static constexpr unsigned int kMaxTileLoadsPerUpdate = 2u;
 };
 
 using namespace ignition;
 using namespace rendering;
 
+//////////////////////////////////////////////////
+/// \brief Get the path of the file caching the normalized heights of a
+/// heightmap. The name is a hash of the source file contents and of the
+/// descriptor parameters that affect sampling.
+/// \param[in] _desc Heightmap descriptor
+/// \return Path to the cache file, empty if the heightmap data is not
+/// backed by a file
+static std::string HeightmapCachePath(const HeightmapDescriptor &_desc)
+{
+  const std::string filename = _desc.Data()->Filename();
+  if (filename.empty() || !common::isFile(filename))
+    return std::string();
+
+  std::ifstream in(filename, std::ios::binary);
+  if (!in)
+    return std::string();
+  std::stringstream buffer;
+  buffer << in.rdbuf();
+
+  std::stringstream key;
+  key << common::sha1<std::string>(buffer.str())
+      << " " << _desc.Sampling()
+      << " " << _desc.Size()
+      << " " << _desc.Data()->Width()
+      << " " << _desc.Data()->Height();
+
+  return common::joinPaths(cacheDirectory("ogre2-terrain-cache"),
+      common::sha1<std::string>(key.str()) + ".bin");
+}
+
+//////////////////////////////////////////////////
+Ogre2HeightmapPrivate::~Ogre2HeightmapPrivate()
+{
+#ifndef _WIN32
+  if (this->mappedCache)
+    munmap(this->mappedCache, this->mappedCacheSize);
+#endif
+}
+
+//////////////////////////////////////////////////
+bool Ogre2HeightmapPrivate::LoadCache(const std::string &_path,
+    unsigned int _width, float &_minElevation, float &_maxElevation)
+{
+  if (_path.empty() || !common::isFile(_path))
+    return false;
+
+  const size_t expectedSize = sizeof(HeightmapCacheHeader) +
+      static_cast<size_t>(_width) * _width * sizeof(float);
+  HeightmapCacheHeader header;
+
+#ifndef _WIN32
+  // Map the file so the heights are uploaded to the GPU straight from the
+  // page cache, without an intermediate copy
+  int fd = open(_path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != expectedSize)
+  {
+    close(fd);
+    return false;
+  }
+
+  void *mapped = mmap(nullptr, expectedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED)
+    return false;
+
+  std::memcpy(&header, mapped, sizeof(header));
+  if (std::memcmp(header.magic, kHeightmapCacheMagic,
+        sizeof(kHeightmapCacheMagic)) != 0 || header.width != _width)
+  {
+    munmap(mapped, expectedSize);
+    return false;
+  }
+
+  this->mappedCache = mapped;
+  this->mappedCacheSize = expectedSize;
+  // The mapping is read only. Image2 and Terra take non-const pointers but
+  // never write to the heights
+  this->heightData = reinterpret_cast<float *>(
+      static_cast<char *>(mapped) + sizeof(HeightmapCacheHeader));
+#else
+  std::ifstream in(_path, std::ios::binary | std::ios::ate);
+  if (!in || static_cast<size_t>(in.tellg()) != expectedSize)
+    return false;
+  in.seekg(0);
+  in.read(reinterpret_cast<char *>(&header), sizeof(header));
+  if (!in || std::memcmp(header.magic, kHeightmapCacheMagic,
+        sizeof(kHeightmapCacheMagic)) != 0 || header.width != _width)
+  {
+    return false;
+  }
+  this->heights.resize(static_cast<size_t>(_width) * _width);
+  in.read(reinterpret_cast<char *>(this->heights.data()),
+      this->heights.size() * sizeof(float));
+  if (!in)
+  {
+    this->heights.clear();
+    return false;
+  }
+  this->heightData = this->heights.data();
+#endif
+
+  _minElevation = header.minElevation;
+  _maxElevation = header.maxElevation;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2HeightmapPrivate::SaveCache(const std::string &_path,
+    float _minElevation, float _maxElevation) const
+{
+  if (_path.empty())
+    return;
+
+  const std::string dir = common::parentPath(_path);
+  if (!common::isDirectory(dir) && !common::createDirectories(dir))
+  {
+    ignwarn << "Unable to create heightmap cache directory [" << dir << "]"
+            << std::endl;
+    return;
+  }
+
+  HeightmapCacheHeader header;
+  std::memcpy(header.magic, kHeightmapCacheMagic,
+      sizeof(kHeightmapCacheMagic));
+  header.width = this->dataSize;
+  header.minElevation = _minElevation;
+  header.maxElevation = _maxElevation;
+  header.padding = 0u;
+
+  // other processes never map a partially written cache
+  bool written = writeFileAtomically(_path,
+      [&](const std::string &_tmpPath)
+  {
+    std::ofstream out(_tmpPath, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(this->heights.data()),
+        this->heights.size() * sizeof(float));
+    out.close();
+    return static_cast<bool>(out);
+  });
+  if (!written)
+  {
+    ignwarn << "Unable to write heightmap cache [" << _path << "]"
+            << std::endl;
+  }
+}
+
 //////////////////////////////////////////////////
 Ogre2Heightmap::Ogre2Heightmap(const HeightmapDescriptor &_desc)
     : BaseHeightmap(_desc), dataPtr(std::make_unique<Ogre2HeightmapPrivate>())
@@ -76,6 +419,17 @@ Ogre2Heightmap::Ogre2Heightmap(const HeightmapDescriptor &_desc)
 //////////////////////////////////////////////////
 Ogre2Heightmap::~Ogre2Heightmap()
 {
+  if (this->dataPtr->paged)
+  {
+    std::vector<uint64_t> keys;
+    for (const auto &tile : this->dataPtr->tiles)
+    {
+      if (tile.first != this->dataPtr->anchorKey)
+        keys.push_back(tile.first);
+    }
+    for (auto key : keys)
+      this->dataPtr->UnloadTile(key);
+  }
 }
 
 //////////////////////////////////////////////////
@@ -139,16 +493,10 @@ void Ogre2Heightmap::Init()
   const unsigned int newWidth =
     math::isPowerOfTwo(srcWidth) ? srcWidth : (srcWidth - 1u);
 
-  math::Vector3d scale;
-  scale.X(this->descriptor.Size().X() / newWidth);
-  scale.Y(this->descriptor.Size().Y() / newWidth);
-  scale.Z(1.0);
+  this->dataPtr->dataSize = newWidth;
 
-  // Construct the heightmap lookup table
-  std::vector<float> lookup;
-  this->descriptor.Data()->FillHeightMap(this->descriptor.Sampling(),
-      srcWidth, this->descriptor.Size(), scale, flipY, lookup);
-  this->dataPtr->heights.reserve(newWidth * newWidth);
+  ignmsg << "Loading heightmap: " << this->descriptor.Name() << std::endl;
+  auto time = std::chrono::steady_clock::now();
 
   // Terra is optimized to work with UNORM heightmaps, therefore it assumes
   // lowest height is 0.
@@ -161,36 +509,165 @@ void Ogre2Heightmap::Init()
   float minElevation = 0.0;
   float maxElevation = 0.0;
 
-  for (unsigned int y = 0; y < newWidth; ++y)
+  // Resampling large heightmaps is slow, reuse the result of a previous
+  // launch if the source data and parameters are unchanged
+  const std::string cachePath = HeightmapCachePath(this->descriptor);
+  if (this->dataPtr->LoadCache(cachePath, newWidth, minElevation,
+        maxElevation))
+  {
+    igndbg << "Loaded heightmap from cache [" << cachePath << "]"
+           << std::endl;
+  }
+  else
   {
-    for (unsigned int x = 0; x < newWidth; ++x)
+    math::Vector3d scale;
+    scale.X(this->descriptor.Size().X() / newWidth);
+    scale.Y(this->descriptor.Size().Y() / newWidth);
+    scale.Z(1.0);
+
+    // Construct the heightmap lookup table
+    std::vector<float> lookup;
+    this->descriptor.Data()->FillHeightMap(this->descriptor.Sampling(),
+        srcWidth, this->descriptor.Size(), scale, flipY, lookup);
+    this->dataPtr->heights.resize(
+        static_cast<size_t>(newWidth) * newWidth);
+
+    // Rows are cropped and reduced on the worker threads of the engine.
+    // Each row keeps its own extremes so that ranges don't share any
+    // state, the loops are simple enough for the compiler to vectorize.
+    auto engine = Ogre2RenderEngine::Instance();
+    Ogre2WorkerPool &workerPool = engine->WorkerPool();
+    const unsigned int threadCount = engine->SceneThreadCount();
+    const size_t rowBytes = newWidth * sizeof(float);
+    float *heights = this->dataPtr->heights.data();
+    std::vector<float> rowMin(newWidth);
+    std::vector<float> rowMax(newWidth);
+    workerPool.ParallelFor(newWidth, rowBytes, threadCount,
+        [&](unsigned int _begin, unsigned int _end)
+        {
+          for (unsigned int y = _begin; y < _end; ++y)
+          {
+            const float *src = lookup.data() + static_cast<size_t>(y) *
+                srcWidth;
+            float *dst = heights + static_cast<size_t>(y) * newWidth;
+            std::copy(src, src + newWidth, dst);
+
+            float rMin = 0.0f;
+            float rMax = 0.0f;
+            for (unsigned int x = 0; x < newWidth; ++x)
+            {
+              rMin = dst[x] < rMin ? dst[x] : rMin;
+              rMax = dst[x] > rMax ? dst[x] : rMax;
+            }
+            rowMin[y] = rMin;
+            rowMax[y] = rMax;
+          }
+        });
+    for (unsigned int y = 0; y < newWidth; ++y)
     {
-      const size_t index = y * srcWidth + x;
-      const float heightVal = lookup[index];
-      minElevation = std::min(minElevation, heightVal);
-      maxElevation = std::max(maxElevation, heightVal);
-      this->dataPtr->heights.push_back(heightVal);
+      minElevation = std::min(minElevation, rowMin[y]);
+      maxElevation = std::max(maxElevation, rowMax[y]);
     }
+
+    // min and max elevations collected. Now normalize
+    const float diff = maxElevation - minElevation;
+    const float invHeightDiff =
+        fabsf( diff ) < 1e-6f ? 1.0f : (1.0f / diff);
+    const float minHeight = minElevation;
+    workerPool.ParallelFor(newWidth, rowBytes, threadCount,
+        [&](unsigned int _begin, unsigned int _end)
+        {
+          float *first = heights + static_cast<size_t>(_begin) * newWidth;
+          float *last = heights + static_cast<size_t>(_end) * newWidth;
+          for (float *h = first; h != last; ++h)
+            *h = (*h - minHeight) * invHeightDiff;
+        });
+
+    if (this->dataPtr->heights.empty())
+    {
+      ignerr << "Failed to load terrain. Heightmap data is empty"
+             << std::endl;
+      return;
+    }
+
+    this->dataPtr->heightData = this->dataPtr->heights.data();
+    this->dataPtr->SaveCache(cachePath, minElevation, maxElevation);
   }
 
-  // min and max elevations collected. Now normalize
   const float heightDiff = maxElevation - minElevation;
-  const float invHeightDiff =
-      fabsf( heightDiff ) < 1e-6f ? 1.0f : (1.0f / heightDiff);
-  for (float &heightVal : this->dataPtr->heights)
+
+  auto ogreScene = std::dynamic_pointer_cast<Ogre2Scene>(this->Scene());
+
+  const math::Vector3d newSize = this->descriptor.Size() *
+                                 math::Vector3d(1.0, 1.0, heightDiff);
+
+  math::Vector3d center(
+      this->descriptor.Position().X(),
+      this->descriptor.Position().Y(),
+      this->descriptor.Position().Z() + newSize.Z() * 0.5 + minElevation);
+
+  this->dataPtr->sceneManager = ogreScene->OgreSceneManager();
+  this->dataPtr->terrainSize = newSize;
+  this->dataPtr->centerZ = center.Z();
+  this->dataPtr->minCorner.Set(center.X() - newSize.X() * 0.5,
+                               center.Y() - newSize.Y() * 0.5);
+
+  if (this->descriptor.UseTerrainPaging())
   {
-    heightVal = (heightVal - minElevation) * invHeightDiff;
-    assert( heightVal >= 0 );
+    const unsigned int tileSize = this->descriptor.TileSize();
+    if (!math::isPowerOfTwo(tileSize))
+    {
+      ignwarn << "Heightmap tile size must satisfy 2^n, got [" << tileSize
+              << "]. Terrain paging is disabled." << std::endl;
+    }
+    else if (tileSize < newWidth)
+    {
+      this->dataPtr->paged = true;
+      this->dataPtr->tileSize = tileSize;
+      this->dataPtr->tileCount = newWidth / tileSize;
+      this->dataPtr->maxResidentTiles =
+          std::max(1u, this->descriptor.MaxResidentTiles());
+    }
   }
 
-  this->dataPtr->dataSize = newWidth;
-
-  if (this->dataPtr->heights.empty())
+  if (this->dataPtr->paged)
   {
-    ignerr << "Failed to load terrain. Heightmap data is empty" << std::endl;
-    return;
+    // Only the tile at the center of the heightmap is loaded now. It is the
+    // object attached to the parent visual and stays loaded, the other tiles
+    // are streamed in around the cameras in UpdateForRender
+    const unsigned int anchor = this->dataPtr->tileCount / 2u;
+    this->dataPtr->anchorKey =
+        static_cast<uint64_t>(anchor) * this->dataPtr->tileCount + anchor;
+    Ogre2HeightmapPrivate::Tile &tile =
+        this->dataPtr->LoadTile(this->descriptor, anchor, anchor);
+    this->dataPtr->terra = std::move(tile.terra);
+    this->dataPtr->activeTerra = this->dataPtr->terra.get();
   }
+  else
+  {
+    this->dataPtr->terra = this->dataPtr->CreateTerra(this->descriptor,
+        this->dataPtr->sceneManager, this->dataPtr->heightData, newWidth,
+        center, newSize, this->descriptor.Name(), math::Vector2d::Zero,
+        true);
+    this->dataPtr->activeTerra = this->dataPtr->terra.get();
+  }
+  this->dataPtr->autoSkirtValue =
+      this->dataPtr->terra->getCustomSkirtMinHeight();
+
+  ignmsg << "Heightmap loaded. Process took "
+        <<  std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - time).count()
+        << " ms." << std::endl;
+}
 
+//////////////////////////////////////////////////
+std::unique_ptr<Ogre::Terra> Ogre2HeightmapPrivate::CreateTerra(
+    const HeightmapDescriptor &_desc, Ogre::SceneManager *_sceneManager,
+    float *_heights, unsigned int _width,
+    const math::Vector3d &_center, const math::Vector3d &_size,
+    const std::string &_name, const math::Vector2d &_uvOffset,
+    bool _allowBaseTexture)
+{
   // Create terrain group, which holds all the individual terrain instances.
   // Param 1: Pointer to the scene manager
   // Param 2: Alignment plane
@@ -198,43 +675,31 @@ void Ogre2Heightmap::Init()
   //          Terrains must be square, with each side a power of 2 in size
   // Param 4: World size of each terrain instance, in meters.
 
-  auto ogreScene = std::dynamic_pointer_cast<Ogre2Scene>(this->Scene());
-
   Ogre::Image2 image;
-  image.loadDynamicImage(this->dataPtr->heights.data(), newWidth, newWidth,
+  image.loadDynamicImage(_heights, _width, _width,
                          1u, Ogre::TextureTypes::Type2D,
                          Ogre::PFG_R32_FLOAT, false);
 
-  const math::Vector3d newSize = this->descriptor.Size() *
-                                 math::Vector3d(1.0, 1.0, heightDiff);
-
-  math::Vector3d center(
-      this->descriptor.Position().X(),
-      this->descriptor.Position().Y(),
-      this->descriptor.Position().Z() + newSize.Z() * 0.5 + minElevation);
-
   Ogre::Root *ogreRoot = Ogre2RenderEngine::Instance()->OgreRoot();
-  Ogre::SceneManager *ogreSceneManager = ogreScene->OgreSceneManager();
   Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
 
-  // TODO(anyone): Gazebo doesn't support SCENE_STATIC scene nodes
-  this->dataPtr->terra =
+  // Created dynamic, the terrain is made static along with the visual it
+  // is attached to, see Visual::SetStatic
+  auto terra =
       std::make_unique<Ogre::Terra>(
         Ogre::Id::generateNewId<Ogre::MovableObject>(),
-        &ogreSceneManager->_getEntityMemoryManager(
+        &_sceneManager->_getEntityMemoryManager(
           Ogre::/*SCENE_STATIC*/SCENE_DYNAMIC),
-        ogreSceneManager, 11u, ogreCompMgr, nullptr, true );
+        _sceneManager, 11u, ogreCompMgr, nullptr, true );
   // Does not cast shadows because it uses a raymarching implementation
   // instead of shadow maps. It does receive shadows from shadow maps though
-  this->dataPtr->terra->setCastShadows(false);
-  this->dataPtr->terra->load(
+  terra->setCastShadows(false);
+  terra->load(
         image,
-        Ogre2Conversions::Convert(center),
-        Ogre2Conversions::Convert(newSize),
-        this->descriptor.Name());
-  this->dataPtr->autoSkirtValue =
-      this->dataPtr->terra->getCustomSkirtMinHeight();
-  this->dataPtr->terra->setDatablock(
+        Ogre2Conversions::Convert(_center),
+        Ogre2Conversions::Convert(_size),
+        _name);
+  terra->setDatablock(
         ogreRoot->getHlmsManager()->
         getHlms(Ogre::HLMS_USER3)->getDefaultDatablock());
 
@@ -245,7 +710,7 @@ void Ogre2Heightmap::Init()
              "HlmsTerra incorrectly setup, memory corrupted, or "
              "HlmsTerra::getType changed while this code is out of sync");
 
-  Ogre::String datablockName = "IGN Terra " + this->name;
+  Ogre::String datablockName = "IGN Terra " + _name;
 
   Ogre::HlmsDatablock *datablockBase = hlmsTerra->createDatablock(
               datablockName, datablockName, Ogre::HlmsMacroblock(),
@@ -262,17 +727,18 @@ void Ogre2Heightmap::Init()
   samplerblock.setFiltering(Ogre::TFO_ANISOTROPIC);
   samplerblock.mMaxAnisotropy = 8u;
 
-  size_t numTextures = static_cast<size_t>(this->descriptor.TextureCount());
+  size_t numTextures = static_cast<size_t>(_desc.TextureCount());
 
   if (numTextures >= 1u)
   {
     bool bCanUseFirstAsBase = false;
 
     using namespace Ogre;
-    const HeightmapTexture *texture0 = this->descriptor.TextureByIndex(0);
-    if (texture0->Normal().empty() &&
-        abs(newSize.X() - texture0->Size()) < 1e-6 &&
-        abs(newSize.Y() - texture0->Size()) < 1e-6 )
+    const HeightmapTexture *texture0 = _desc.TextureByIndex(0);
+    if (_allowBaseTexture &&
+        texture0->Normal().empty() &&
+        abs(_size.X() - texture0->Size()) < 1e-6 &&
+        abs(_size.Y() - texture0->Size()) < 1e-6 )
     {
       bCanUseFirstAsBase = true;
     }
@@ -302,17 +768,24 @@ void Ogre2Heightmap::Init()
                             texture0->Normal(), &samplerblock);
 
       const float sizeX =
-              static_cast<float>(newSize.X() / texture0->Size());
+              static_cast<float>(_size.X() / texture0->Size());
       const float sizeY =
-              static_cast<float>(newSize.Y() / texture0->Size());
+              static_cast<float>(_size.Y() / texture0->Size());
+      const float offsetX =
+              static_cast<float>(_uvOffset.X() / texture0->Size());
+      const float offsetY =
+              static_cast<float>(_uvOffset.Y() / texture0->Size());
       if (!texture0->Diffuse().empty() || !texture0->Normal().empty())
-        datablock->setDetailMapOffsetScale(0, Vector4(0, 0, sizeX, sizeY));
+      {
+        datablock->setDetailMapOffsetScale(0,
+            Vector4(offsetX, offsetY, sizeX, sizeY));
+      }
     }
 
     for (size_t i = 1u; i < numTextures; ++i)
     {
       const size_t idxOffset = bCanUseFirstAsBase ? 1 : 0;
-      const HeightmapTexture *texture = this->descriptor.TextureByIndex(i);
+      const HeightmapTexture *texture = _desc.TextureByIndex(i);
 
       datablock->setTexture(static_cast<TerraTextureTypes>(
                             TERRA_DETAIL0 + i - idxOffset),
@@ -323,19 +796,23 @@ void Ogre2Heightmap::Init()
                             texture->Normal(), &samplerblock);
 
       const float sizeX =
-              static_cast<float>(newSize.X() / texture->Size());
+              static_cast<float>(_size.X() / texture->Size());
       const float sizeY =
-              static_cast<float>(newSize.Y() / texture->Size());
+              static_cast<float>(_size.Y() / texture->Size());
+      const float offsetX =
+              static_cast<float>(_uvOffset.X() / texture->Size());
+      const float offsetY =
+              static_cast<float>(_uvOffset.Y() / texture->Size());
       if (!texture->Diffuse().empty() || !texture->Normal().empty())
       {
           datablock->setDetailMapOffsetScale(
                       static_cast<uint8_t>(i - idxOffset),
-                      Vector4(0, 0, sizeX, sizeY));
+                      Vector4(offsetX, offsetY, sizeX, sizeY));
       }
     }
 
 
-    size_t numBlends = static_cast<size_t>(this->descriptor.BlendCount());
+    size_t numBlends = static_cast<size_t>(_desc.BlendCount());
     if ((numBlends > 3u && !bCanUseFirstAsBase) ||
         (numBlends > 4u && bCanUseFirstAsBase))
     {
@@ -352,7 +829,7 @@ void Ogre2Heightmap::Init()
     for (size_t i = 0; i < numBlends; ++i)
     {
       const size_t idxOffset = bCanUseFirstAsBase ? 0u : 1u;
-      const HeightmapBlend *blend = this->descriptor.BlendByIndex(i);
+      const HeightmapBlend *blend = _desc.BlendByIndex(i);
       minBlendHeights[i + idxOffset] =
               static_cast<Ogre::Real>(blend->MinHeight());
       maxBlendHeights[i + idxOffset] =
@@ -362,36 +839,216 @@ void Ogre2Heightmap::Init()
     datablock->setIgnWeightsHeights(minBlendHeights, maxBlendHeights);
   }
 
-  this->dataPtr->terra->setDatablock(datablock);
+  terra->setDatablock(datablock);
+  return terra;
+}
 
-  ignmsg << "Loading heightmap: " << this->descriptor.Name() << std::endl;
-  auto time = std::chrono::steady_clock::now();
+//////////////////////////////////////////////////
+Ogre2HeightmapPrivate::Tile &Ogre2HeightmapPrivate::LoadTile(
+    const HeightmapDescriptor &_desc, unsigned int _x, unsigned int _y)
+{
+  const uint64_t key = static_cast<uint64_t>(_y) * this->tileCount + _x;
+  Tile &tile = this->tiles[key];
+
+  // Copy the tile's heights out of the full heightmap, including the
+  // first row and column of its neighbours so there are no cracks between
+  // tiles
+  Ogre2HeightmapTiles::CopyHeights(this->heightData, this->dataSize,
+      this->tileSize, _x, _y, tile.heights);
+  const unsigned int samples =
+      Ogre2HeightmapTiles::SampleCount(this->tileSize);
+
+  const math::Vector2d tileWorld(
+      this->terrainSize.X() / this->tileCount,
+      this->terrainSize.Y() / this->tileCount);
+  const math::Vector2d offset(tileWorld.X() * _x, tileWorld.Y() * _y);
+
+  // Keep the heightmap's sample spacing, the extra samples extend the tile
+  // over the edge it shares with its neighbours
+  const double extent = static_cast<double>(samples) / this->tileSize;
+  const math::Vector3d size(tileWorld.X() * extent,
+      tileWorld.Y() * extent, this->terrainSize.Z());
+  const math::Vector3d center(
+      this->minCorner.X() + offset.X() + size.X() * 0.5,
+      this->minCorner.Y() + offset.Y() + size.Y() * 0.5,
+      this->centerZ);
+
+  const std::string name = _desc.Name() + "_tile_" + std::to_string(_x) +
+      "_" + std::to_string(_y);
+  tile.datablockName = "IGN Terra " + name;
+  // A base texture stretched over the whole heightmap can not be shared
+  // between tiles, so all textures are used as detail maps
+  tile.terra = this->CreateTerra(_desc, this->sceneManager,
+      tile.heights.data(), samples, center, size, name, offset, false);
+  tile.lastUsed = this->updateCount;
+
+  // Streamed tiles render with the same node and flags as the anchor tile,
+  // which is the object the parent visual knows about
+  if (this->terra)
+  {
+    tile.terra->getUserObjectBindings().setUserAny(
+        this->terra->getUserObjectBindings().getUserAny());
+    tile.terra->setVisibilityFlags(this->terra->getVisibilityFlags());
+    tile.terra->setName(this->terra->getName() + "_" + name);
+    if (this->terra->getParentSceneNode())
+      this->terra->getParentSceneNode()->attachObject(tile.terra.get());
+  }
 
-  ignmsg << "Heightmap loaded. Process took "
-        <<  std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::steady_clock::now() - time).count()
-        << " ms." << std::endl;
+  return tile;
 }
 
 //////////////////////////////////////////////////
-void Ogre2Heightmap::PreRender()
+void Ogre2HeightmapPrivate::UnloadTile(uint64_t _key)
 {
+  auto it = this->tiles.find(_key);
+  if (it == this->tiles.end())
+    return;
+
+  if (this->activeTerra == it->second.terra.get())
+    this->activeTerra = this->terra.get();
+
+  if (it->second.terra)
+  {
+    if (it->second.terra->getParentSceneNode())
+    {
+      it->second.terra->getParentSceneNode()->detachObject(
+          it->second.terra.get());
+    }
+    it->second.terra.reset();
+  }
+
+  Ogre::Hlms *hlmsTerra = Ogre2RenderEngine::Instance()->OgreRoot()->
+      getHlmsManager()->getHlms(Ogre::HLMS_USER3);
+  hlmsTerra->destroyDatablock(it->second.datablockName);
+
+  this->tiles.erase(it);
 }
 
-///////////////////////////////////////////////////
-void Ogre2Heightmap::UpdateForRender(Ogre::Camera *_activeCamera)
+//////////////////////////////////////////////////
+void Ogre2HeightmapPrivate::UpdateTiles(const HeightmapDescriptor &_desc,
+    const Ogre::Camera *_camera)
 {
-  if (this->dataPtr->skirtMinHeight >= 0)
+  ++this->updateCount;
+  this->tiles[this->anchorKey].lastUsed = this->updateCount;
+
+  // Streamed tiles are attached to the anchor's node. Wait until the
+  // heightmap has been added to a visual
+  if (!this->terra->getParentSceneNode())
+    return;
+
+  const math::Vector3d camPos =
+      Ogre2Conversions::Convert(_camera->getDerivedPosition());
+  const math::Vector2d tileWorld(
+      this->terrainSize.X() / this->tileCount,
+      this->terrainSize.Y() / this->tileCount);
+  const int last = static_cast<int>(this->tileCount) - 1;
+  const int camX = std::clamp(static_cast<int>(std::floor(
+      (camPos.X() - this->minCorner.X()) / tileWorld.X())), 0, last);
+  const int camY = std::clamp(static_cast<int>(std::floor(
+      (camPos.Y() - this->minCorner.Y()) / tileWorld.Y())), 0, last);
+
+  // Only the neighbourhood that can fit in the budget is considered, so the
+  // cost of an update does not depend on the total number of tiles
+  const int radius = static_cast<int>(std::ceil(
+      std::sqrt(static_cast<double>(this->maxResidentTiles)))) / 2 + 1;
+  const double farClip = _camera->getFarClipDistance();
+
+  std::vector<std::pair<double, uint64_t>> wanted;
+  for (int y = std::max(0, camY - radius);
+       y <= std::min(last, camY + radius); ++y)
   {
-    this->dataPtr->terra->setCustomSkirtMinHeight(
-          this->dataPtr->skirtMinHeight);
+    for (int x = std::max(0, camX - radius);
+         x <= std::min(last, camX + radius); ++x)
+    {
+      // distance from the camera to the tile's footprint
+      const double minX = this->minCorner.X() + x * tileWorld.X();
+      const double minY = this->minCorner.Y() + y * tileWorld.Y();
+      const double dx = std::max({minX - camPos.X(), 0.0,
+          camPos.X() - (minX + tileWorld.X())});
+      const double dy = std::max({minY - camPos.Y(), 0.0,
+          camPos.Y() - (minY + tileWorld.Y())});
+      const double sqDist = dx * dx + dy * dy;
+      if (farClip > 0.0 && sqDist > farClip * farClip)
+        continue;
+      wanted.emplace_back(sqDist,
+          static_cast<uint64_t>(y) * this->tileCount + x);
+    }
   }
-  else
+  std::sort(wanted.begin(), wanted.end());
+  if (wanted.size() > this->maxResidentTiles)
+    wanted.resize(this->maxResidentTiles);
+
+  // Mark resident tiles first so they are not unloaded to make room for
+  // the ones that are missing
+  for (const auto &w : wanted)
   {
-    this->dataPtr->terra->setCustomSkirtMinHeight(
-          this->dataPtr->autoSkirtValue);
+    auto it = this->tiles.find(w.second);
+    if (it != this->tiles.end())
+      it->second.lastUsed = this->updateCount;
   }
 
+  unsigned int loads = 0u;
+  for (const auto &w : wanted)
+  {
+    if (loads >= kMaxTileLoadsPerUpdate)
+      break;
+    if (this->tiles.find(w.second) != this->tiles.end())
+      continue;
+
+    if (this->tiles.size() >= this->maxResidentTiles)
+    {
+      // unload the least recently used tile not needed by this camera
+      auto lru = this->tiles.end();
+      for (auto it = this->tiles.begin(); it != this->tiles.end(); ++it)
+      {
+        if (it->second.lastUsed == this->updateCount)
+          continue;
+        if (lru == this->tiles.end() ||
+            it->second.lastUsed < lru->second.lastUsed)
+        {
+          lru = it;
+        }
+      }
+      if (lru == this->tiles.end())
+        break;
+      this->UnloadTile(lru->first);
+    }
+
+    this->LoadTile(_desc,
+        static_cast<unsigned int>(w.second % this->tileCount),
+        static_cast<unsigned int>(w.second / this->tileCount));
+    ++loads;
+  }
+
+  // The closest loaded tile is the one used for terrain shadows
+  this->activeTerra = this->terra.get();
+  for (const auto &w : wanted)
+  {
+    if (w.second == this->anchorKey)
+      break;
+    auto it = this->tiles.find(w.second);
+    if (it != this->tiles.end())
+    {
+      this->activeTerra = it->second.terra.get();
+      break;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2Heightmap::PreRender()
+{
+}
+
+///////////////////////////////////////////////////
+void Ogre2Heightmap::UpdateForRender(Ogre::Camera *_activeCamera)
+{
+  if (!this->dataPtr->terra)
+    return;
+
+  if (this->dataPtr->paged)
+    this->dataPtr->UpdateTiles(this->descriptor, _activeCamera);
+
   // Get the first directional light
   Ogre2DirectionalLightPtr directionalLight;
   for (unsigned int i = 0; i < this->Scene()->LightCount(); ++i)
@@ -405,18 +1062,107 @@ void Ogre2Heightmap::UpdateForRender(Ogre::Camera *_activeCamera)
     }
   }
 
-  this->dataPtr->terra->setCamera(_activeCamera);
-  if (directionalLight)
+  // Terra compares the cosine of the light direction change
+  const float lightEpsilon = std::max(1e-6f, static_cast<float>(
+      1.0 - std::cos(this->dataPtr->shadowAngleThreshold.Radian())));
+
+  // cameras with a level of detail bias below 1, e.g. low resolution
+  // sensors, start one LOD level coarser for each halving of the bias
+  unsigned int lodSkip = 0u;
+  const double lodBias = _activeCamera->getLodBias();
+  if (lodBias > 0.0 && lodBias < 1.0)
   {
-    this->dataPtr->terra->update(
-          Ogre2Conversions::Convert(directionalLight->Direction()));
+    lodSkip = static_cast<unsigned int>(
+        std::floor(std::log2(1.0 / lodBias) + 1e-6));
   }
-  else
+
+  auto updateTerra = [&](Ogre::Terra *_terra)
+  {
+    _terra->setShadowMapUpdateSlices(this->dataPtr->shadowSlices);
+    _terra->setLodSkip(lodSkip);
+    _terra->setLodCacheThreshold(
+        static_cast<Ogre::Real>(this->dataPtr->lodDistanceThreshold),
+        Ogre::Radian(static_cast<Ogre::Real>(
+        this->dataPtr->lodAngleThreshold.Radian())));
+
+    if (this->dataPtr->skirtMinHeight >= 0)
+    {
+      _terra->setCustomSkirtMinHeight(this->dataPtr->skirtMinHeight);
+    }
+    else
+    {
+      _terra->setCustomSkirtMinHeight(this->dataPtr->autoSkirtValue);
+    }
+
+    _terra->setCamera(_activeCamera);
+    if (directionalLight)
+    {
+      _terra->update(
+            Ogre2Conversions::Convert(directionalLight->Direction()),
+            lightEpsilon);
+    }
+    else
+    {
+      _terra->update(Ogre::Vector3::NEGATIVE_UNIT_Y, lightEpsilon);
+    }
+  };
+
+  updateTerra(this->dataPtr->terra.get());
+  for (auto &tile : this->dataPtr->tiles)
   {
-    this->dataPtr->terra->update(Ogre::Vector3::NEGATIVE_UNIT_Y);
+    if (!tile.second.terra)
+      continue;
+    // keep streamed tiles in sync with the parent visual's flags
+    tile.second.terra->setVisibilityFlags(
+        this->dataPtr->terra->getVisibilityFlags());
+    updateTerra(tile.second.terra.get());
   }
 }
 
+//////////////////////////////////////////////////
+void Ogre2Heightmap::SetShadowUpdateAngleThreshold(const math::Angle &_angle)
+{
+  this->dataPtr->shadowAngleThreshold = _angle;
+}
+
+//////////////////////////////////////////////////
+math::Angle Ogre2Heightmap::ShadowUpdateAngleThreshold() const
+{
+  return this->dataPtr->shadowAngleThreshold;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Heightmap::SetShadowUpdateSlices(unsigned int _slices)
+{
+  this->dataPtr->shadowSlices = std::max(1u, _slices);
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2Heightmap::ShadowUpdateSlices() const
+{
+  return this->dataPtr->shadowSlices;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Heightmap::SetLodUpdateThreshold(double _distance,
+    const math::Angle &_angle)
+{
+  this->dataPtr->lodDistanceThreshold = std::max(0.0, _distance);
+  this->dataPtr->lodAngleThreshold = _angle;
+}
+
+//////////////////////////////////////////////////
+double Ogre2Heightmap::LodUpdateDistanceThreshold() const
+{
+  return this->dataPtr->lodDistanceThreshold;
+}
+
+//////////////////////////////////////////////////
+math::Angle Ogre2Heightmap::LodUpdateAngleThreshold() const
+{
+  return this->dataPtr->lodAngleThreshold;
+}
+
 //////////////////////////////////////////////////
 Ogre::MovableObject *Ogre2Heightmap::OgreObject() const
 {
@@ -438,5 +1184,5 @@ MaterialPtr Ogre2Heightmap::Material() const
 //////////////////////////////////////////////////
 Ogre::Terra* Ogre2Heightmap::Terra()
 {
-  return this->dataPtr->terra.get();
+  return this->dataPtr->activeTerra;
 }
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+
+#include "Ogre2HeightmapTiles.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+unsigned int Ogre2HeightmapTiles::SampleCount(unsigned int _tileSize)
+{
+  return _tileSize + 1u;
+}
+
+//////////////////////////////////////////////////
+void Ogre2HeightmapTiles::CopyHeights(const float *_heights,
+    unsigned int _dataSize, unsigned int _tileSize, unsigned int _x,
+    unsigned int _y, std::vector<float> &_tile)
+{
+  const unsigned int samples = SampleCount(_tileSize);
+  _tile.resize(static_cast<size_t>(samples) * samples);
+
+  const size_t last = _dataSize - 1u;
+  const size_t firstX = static_cast<size_t>(_x) * _tileSize;
+  const size_t firstY = static_cast<size_t>(_y) * _tileSize;
+  for (unsigned int row = 0u; row < samples; ++row)
+  {
+    const size_t srcY = std::min(firstY + row, last);
+    const float *src = _heights + srcY * _dataSize;
+    float *dst = _tile.data() + static_cast<size_t>(row) * samples;
+    for (unsigned int col = 0u; col < samples; ++col)
+      dst[col] = src[std::min(firstX + col, last)];
+  }
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2HEIGHTMAPTILES_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2HEIGHTMAPTILES_HH_
+
+#include <vector>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/ogre2/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Splits the heights of a paged heightmap in tiles.
+    ///
+    /// Each tile holds one more row and column of samples than the tile
+    /// size, copied from the first row and column of its neighbours, so
+    /// adjacent tiles share the heights along their common edge and no
+    /// cracks open between them. Tiles on the far edges of the heightmap
+    /// repeat its last row and column instead.
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2HeightmapTiles
+    {
+      /// \brief Get the number of samples along each edge of a tile
+      /// \param[in] _tileSize Number of heightmap samples a tile spans
+      /// \return _tileSize + 1
+      public: static unsigned int SampleCount(unsigned int _tileSize);
+
+      /// \brief Copy the heights of a tile out of the full heightmap
+      /// \param[in] _heights Heights of the full heightmap,
+      /// _dataSize x _dataSize
+      /// \param[in] _dataSize Number of samples along each edge of the
+      /// heightmap
+      /// \param[in] _tileSize Number of heightmap samples a tile spans
+      /// \param[in] _x Tile column
+      /// \param[in] _y Tile row
+      /// \param[out] _tile Heights of the tile, SampleCount(_tileSize)
+      /// samples along each edge
+      public: static void CopyHeights(const float *_heights,
+          unsigned int _dataSize, unsigned int _tileSize, unsigned int _x,
+          unsigned int _y, std::vector<float> &_tile);
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "Ogre2HeightmapTiles.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(Ogre2HeightmapTilesTest, SharedEdges)
+{
+  // 16x16 heightmap split in 4x4 tiles of 4 samples, with a distinct
+  // height for every sample
+  const unsigned int dataSize = 16u;
+  const unsigned int tileSize = 4u;
+  const unsigned int tileCount = dataSize / tileSize;
+  std::vector<float> heights(dataSize * dataSize);
+  for (size_t i = 0u; i < heights.size(); ++i)
+    heights[i] = static_cast<float>(i);
+
+  const unsigned int samples = Ogre2HeightmapTiles::SampleCount(tileSize);
+  EXPECT_EQ(tileSize + 1u, samples);
+
+  std::vector<std::vector<float>> tiles(tileCount * tileCount);
+  for (unsigned int y = 0u; y < tileCount; ++y)
+  {
+    for (unsigned int x = 0u; x < tileCount; ++x)
+    {
+      auto &tile = tiles[y * tileCount + x];
+      Ogre2HeightmapTiles::CopyHeights(heights.data(), dataSize, tileSize,
+          x, y, tile);
+      ASSERT_EQ(samples * samples, tile.size());
+    }
+  }
+
+  for (unsigned int y = 0u; y < tileCount; ++y)
+  {
+    for (unsigned int x = 0u; x < tileCount; ++x)
+    {
+      const auto &tile = tiles[y * tileCount + x];
+
+      // the first sample of each tile is where the tile starts in the
+      // heightmap
+      EXPECT_FLOAT_EQ(heights[(y * tileSize) * dataSize + x * tileSize],
+          tile[0]);
+
+      // the right edge matches the left edge of the next tile
+      if (x + 1u < tileCount)
+      {
+        const auto &right = tiles[y * tileCount + x + 1u];
+        for (unsigned int i = 0u; i < samples; ++i)
+        {
+          EXPECT_FLOAT_EQ(right[i * samples],
+              tile[i * samples + samples - 1u]) << x << " " << y << " " << i;
+        }
+      }
+
+      // the top edge matches the bottom edge of the next row of tiles
+      if (y + 1u < tileCount)
+      {
+        const auto &top = tiles[(y + 1u) * tileCount + x];
+        for (unsigned int i = 0u; i < samples; ++i)
+        {
+          EXPECT_FLOAT_EQ(top[i], tile[(samples - 1u) * samples + i])
+              << x << " " << y << " " << i;
+        }
+      }
+    }
+  }
+
+  // the last tile repeats the last row and column of the heightmap
+  const auto &corner = tiles.back();
+  EXPECT_FLOAT_EQ(heights.back(), corner.back());
+  EXPECT_FLOAT_EQ(heights.back(), corner[samples * samples - 2u]);
+  EXPECT_FLOAT_EQ(heights.back(),
+      corner[(samples - 2u) * samples + samples - 1u]);
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/ImageHeightmap.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/ogre2/Ogre2Heightmap.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include "Terra/Terra.h"
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(Ogre2HeightmapTest, LodUpdateThreshold)
+{
+  common::Console::SetVerbosity(4);
+  Ogre2RenderEngine *engine = Ogre2RenderEngine::Instance();
+  if (!engine->Load(std::map<std::string, std::string>()) || !engine->Init())
+  {
+    igndbg << "Engine 'ogre2' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  VisualPtr root = scene->RootVisual();
+
+  // 17x17 image sampled 8 times, large enough for several levels of detail
+  auto data = std::make_shared<common::ImageHeightmap>();
+  data->Load(common::joinPaths(std::string(PROJECT_SOURCE_PATH),
+      "test", "media", "heightmap_bowl.png"));
+  HeightmapDescriptor desc;
+  desc.SetData(data);
+  desc.SetSize({128, 128, 10});
+  desc.SetSampling(8u);
+
+  Ogre2HeightmapPtr heightmap =
+      std::dynamic_pointer_cast<Ogre2Heightmap>(scene->CreateHeightmap(desc));
+  ASSERT_NE(nullptr, heightmap);
+  EXPECT_DOUBLE_EQ(0.0, heightmap->LodUpdateDistanceThreshold());
+  EXPECT_EQ(math::Angle::Zero, heightmap->LodUpdateAngleThreshold());
+  VisualPtr vis = scene->CreateVisual();
+  vis->AddGeometry(heightmap);
+  root->AddChild(vis);
+
+  // camera above the center of the terrain, looking along it
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(50);
+  camera->SetImageHeight(50);
+  camera->SetLocalPosition(0.0, 0.0, 15.0);
+  root->AddChild(camera);
+
+  // cells the terrain draws after rendering the camera, with their
+  // position, size and level of detail
+  auto renderCells = [&]()
+  {
+    camera->Update();
+    std::vector<std::tuple<int, int, unsigned int, unsigned int>> cells;
+    for (const Ogre::Renderable *renderable : heightmap->Terra()->mRenderables)
+    {
+      auto cell = static_cast<const Ogre::TerrainCell *>(renderable);
+      cells.emplace_back(cell->getGridX(), cell->getGridZ(),
+          cell->getSizeX(), cell->getLodLevel());
+    }
+    return cells;
+  };
+
+  // the cells follow the view of the camera by default
+  auto forward = renderCells();
+  ASSERT_FALSE(forward.empty());
+  camera->SetLocalRotation(0.0, 0.0, IGN_PI / 2.0);
+  auto left = renderCells();
+  EXPECT_NE(forward, left);
+  camera->SetLocalRotation(0.0, 0.0, 0.0);
+  EXPECT_EQ(forward, renderCells());
+
+  // within the thresholds the camera keeps the cells it had
+  heightmap->SetLodUpdateThreshold(1.0, math::Angle(IGN_PI));
+  EXPECT_DOUBLE_EQ(1.0, heightmap->LodUpdateDistanceThreshold());
+  EXPECT_EQ(math::Angle(IGN_PI), heightmap->LodUpdateAngleThreshold());
+  EXPECT_EQ(forward, renderCells());
+  camera->SetLocalRotation(0.0, 0.0, IGN_PI / 2.0);
+  EXPECT_EQ(forward, renderCells());
+  camera->SetLocalPosition(0.5, 0.0, 15.0);
+  EXPECT_EQ(forward, renderCells());
+
+  // moving further rebuilds them for the new view
+  camera->SetLocalPosition(2.0, 0.0, 15.0);
+  EXPECT_NE(forward, renderCells());
+
+  // as does any change to the projection
+  camera->SetLocalRotation(0.0, 0.0, 0.0);
+  camera->SetLocalPosition(0.0, 0.0, 15.0);
+  auto rebuilt = renderCells();
+  camera->SetLocalRotation(0.0, 0.0, IGN_PI / 2.0);
+  camera->SetHFOV(math::Angle(IGN_PI / 4.0));
+  EXPECT_NE(rebuilt, renderCells());
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
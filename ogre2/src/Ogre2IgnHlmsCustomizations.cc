@@ -42,6 +42,11 @@ void Ogre2IgnHlmsCustomizations::preparePassHash(
     Ogre::Hlms *_hlms)
 {
   this->needsWorldPos = false;
+
+  // unlit datablocks have no user value to take the object id from
+  if (!_casterPass && _hlms->getType() == Ogre::HLMS_UNLIT)
+    _hlms->_setProperty("ign_object_id_unknown", 1);
+
   if (!_casterPass && this->MinDistanceClipEnabled())
   {
     const Ogre::int32 numClipPlanes =
@@ -37,8 +37,15 @@ class ignition::rendering::Ogre2InertiaVisualPrivate
   /// \brief Ogre renderable used to render the cross lines.
   public: std::shared_ptr<Ogre2DynamicRenderable> crossLines = nullptr;
 
+  /// \brief True if the material is a copy made for this visual, false if
+  /// it is shared, e.g. the scene's default material
+  public: bool ownsMaterial = false;
+
   /// \brief Box visual
   public: VisualPtr boxVis = nullptr;
+
+  /// \brief Material cloned for the box visual
+  public: MaterialPtr boxMaterial = nullptr;
 };
 
 //////////////////////////////////////////////////
@@ -72,17 +79,24 @@ void Ogre2InertiaVisual::Destroy()
     this->dataPtr->boxVis.reset();
   }
 
+  if (this->dataPtr->boxMaterial && this->Scene())
+  {
+    this->Scene()->DestroyMaterial(this->dataPtr->boxMaterial);
+    this->dataPtr->boxMaterial.reset();
+  }
+
   if (this->dataPtr->crossLines)
   {
     this->dataPtr->crossLines->Destroy();
     this->dataPtr->crossLines.reset();
   }
 
-  if (this->dataPtr->material && this->Scene())
+  if (this->dataPtr->material && this->dataPtr->ownsMaterial &&
+      this->Scene())
   {
     this->Scene()->DestroyMaterial(this->dataPtr->material);
-    this->dataPtr->material.reset();
   }
+  this->dataPtr->material.reset();
 }
 
 //////////////////////////////////////////////////
@@ -101,6 +115,7 @@ void Ogre2InertiaVisual::Load(const ignition::math::Pose3d &_pose,
     this->dataPtr->boxVis = this->Scene()->CreateVisual();
     this->dataPtr->boxVis->AddGeometry(this->Scene()->CreateBox());
     this->dataPtr->boxVis->SetMaterial("Default/TransPurple");
+    this->dataPtr->boxMaterial = this->dataPtr->boxVis->Material();
     this->AddChild(this->dataPtr->boxVis);
   }
 
@@ -111,9 +126,8 @@ void Ogre2InertiaVisual::Load(const ignition::math::Pose3d &_pose,
   this->dataPtr->crossLines->SetOperationType(MarkerType::MT_LINE_LIST);
   if (this->dataPtr->material == nullptr)
   {
-    MaterialPtr defaultMat =
-        this->Scene()->Material("Default/TransGreen")->Clone();
-    this->SetMaterial(defaultMat, false);
+    MaterialPtr defaultMat = this->Scene()->Material("Default/TransGreen");
+    this->SetMaterial(defaultMat, true);
   }
 
   // Inertia position indicator
@@ -173,7 +187,14 @@ void Ogre2InertiaVisual::SetMaterial(MaterialPtr _material, bool _unique)
   }
 
   this->dataPtr->crossLines->SetMaterial(_material, false);
+
+  if (this->dataPtr->material && this->dataPtr->ownsMaterial &&
+      this->dataPtr->material != derived)
+  {
+    this->Scene()->DestroyMaterial(this->dataPtr->material);
+  }
   this->SetMaterialImpl(derived);
+  this->dataPtr->ownsMaterial = _unique;
 }
 
 //////////////////////////////////////////////////
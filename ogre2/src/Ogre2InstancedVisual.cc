@@ -0,0 +1,399 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cmath>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/ogre2/Ogre2Conversions.hh"
+#include "ignition/rendering/ogre2/Ogre2InstancedVisual.hh"
+#include "ignition/rendering/ogre2/Ogre2Material.hh"
+#include "ignition/rendering/ogre2/Ogre2MeshFactory.hh"
+#include "ignition/rendering/ogre2/Ogre2ParticleEmitter.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+
+#include "Ogre2MaterialOverride.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Hlms/Pbs/OgreHlmsPbsDatablock.h>
+#include <Animation/OgreSkeletonAnimation.h>
+#include <Animation/OgreSkeletonInstance.h>
+#include <OgreItem.h>
+#include <OgreSceneManager.h>
+#include <OgreSceneNode.h>
+#include <OgreSubItem.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+namespace
+{
+/// \brief Hidden item evaluating an animation at one phase, whose pose
+/// the instances playing the animation at that phase copy
+struct AnimationPose
+{
+  /// \brief Hidden item
+  Ogre::Item *item = nullptr;
+
+  /// \brief Animation of the skeleton instance of the item
+  Ogre::SkeletonAnimation *animation = nullptr;
+
+  /// \brief Phase, in units of the animation length divided by the phase
+  /// count
+  unsigned int phase = 0u;
+};
+
+//////////////////////////////////////////////////
+/// \brief Evaluate the animation of a pose item
+/// \param[in] _pose Animation pose
+/// \param[in] _time Time of the animations
+/// \param[in] _phaseCount Number of phases of the animations
+void EvaluatePose(AnimationPose &_pose,
+    std::chrono::steady_clock::duration _time, unsigned int _phaseCount)
+{
+  double seconds = std::chrono::duration_cast<std::chrono::milliseconds>(
+      _time).count() / 1000.0;
+  double length = _pose.animation->getDuration();
+  _pose.animation->setTime(static_cast<Ogre::Real>(seconds +
+      length * _pose.phase / _phaseCount));
+  _pose.item->getSkeletonInstance()->update();
+}
+}
+
+/// \brief Private data for the Ogre2InstancedVisual class
+class ignition::rendering::Ogre2InstancedVisualPrivate
+{
+  /// \brief Scene nodes of the instances, children of the visual node
+  public: std::vector<Ogre::SceneNode *> nodes;
+
+  /// \brief Ogre items of the instances
+  public: std::vector<Ogre::Item *> items;
+
+  /// \brief Descriptor of the mesh, to create the items of animation poses
+  public: MeshDescriptor meshDescriptor;
+
+  /// \brief Scene node the items of animation poses are attached to
+  public: Ogre::SceneNode *poseNode = nullptr;
+
+  /// \brief Animation poses. Key: animation name and phase
+  public: std::map<std::pair<std::string, unsigned int>, AnimationPose>
+              animationPoses;
+
+  /// \brief Animation pose each instance copies, null for instances that
+  /// are not animated
+  public: std::vector<AnimationPose *> instancePoses;
+
+  /// \brief Visibility of the visual itself
+  public: bool visible = true;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+Ogre2InstancedVisual::Ogre2InstancedVisual()
+  : dataPtr(new Ogre2InstancedVisualPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2InstancedVisual::~Ogre2InstancedVisual()
+{
+}
+
+//////////////////////////////////////////////////
+bool Ogre2InstancedVisual::Create(const MeshDescriptor &_desc,
+    MaterialPtr _material, unsigned int _count)
+{
+  if (!this->ogreNode)
+    return false;
+
+  MeshDescriptor normDesc = _desc;
+  normDesc.Load();
+
+  // the material is shared by all instances, including the colored ones
+  if (_material)
+    this->SetMaterial(_material, false);
+
+  const size_t colorIndex =
+      Ogre2MaterialOverride::InstanceColorParameterIndex();
+  Ogre2MeshFactoryPtr meshFactory = this->scene->MeshFactory();
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    Ogre::Item *item = meshFactory->OgreItem(normDesc);
+    if (!item)
+    {
+      ignerr << "Unable to create the instances of: " << this->Name()
+             << std::endl;
+      return false;
+    }
+
+    // set user data for mouse queries
+    item->getUserObjectBindings().setUserAny(Ogre::Any(this->Id()));
+    item->setName(this->Name() + "_" + std::to_string(i));
+    item->setVisibilityFlags(this->visibilityFlags
+        & ~Ogre2ParticleEmitter::kParticleVisibilityFlags);
+
+    // the color parameter selects the shader, which is only looked up
+    // again when the datablock is set
+    for (unsigned int s = 0; s < item->getNumSubItems(); ++s)
+    {
+      Ogre::SubItem *subItem = item->getSubItem(s);
+      subItem->setCustomParameter(colorIndex, Ogre::Vector4::ZERO);
+      subItem->setDatablock(subItem->getDatablock());
+    }
+
+    Ogre::SceneNode *node = this->ogreNode->createChildSceneNode();
+    node->attachObject(item);
+
+    this->dataPtr->items.push_back(item);
+    this->dataPtr->nodes.push_back(node);
+  }
+  this->dataPtr->meshDescriptor = normDesc;
+  this->dataPtr->instancePoses.assign(_count, nullptr);
+
+  this->InitInstances(_count);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2InstancedVisual::Destroy()
+{
+  if (this->scene)
+  {
+    Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+    for (Ogre::Item *item : this->dataPtr->items)
+      sceneManager->destroyItem(item);
+    for (Ogre::SceneNode *node : this->dataPtr->nodes)
+      sceneManager->destroySceneNode(node);
+    for (auto &pose : this->dataPtr->animationPoses)
+      sceneManager->destroyItem(pose.second.item);
+    if (this->dataPtr->poseNode)
+      sceneManager->destroySceneNode(this->dataPtr->poseNode);
+    this->scene->MarkVisibilityLayersDirty();
+  }
+  this->dataPtr->items.clear();
+  this->dataPtr->nodes.clear();
+  this->dataPtr->animationPoses.clear();
+  this->dataPtr->instancePoses.clear();
+  this->dataPtr->poseNode = nullptr;
+
+  // the instance items must be gone before the color materials are
+  // destroyed, otherwise ogre fails to unlink them from the datablocks
+  BaseInstancedVisual::Destroy();
+}
+
+//////////////////////////////////////////////////
+void Ogre2InstancedVisual::SetVisible(bool _visible)
+{
+  Ogre2Visual::SetVisible(_visible);
+  this->dataPtr->visible = _visible;
+
+  // the ogre node cascades visibility to the instance items, so hidden
+  // instances have to be hidden again
+  for (unsigned int i = 0; i < this->dataPtr->items.size(); ++i)
+    this->dataPtr->items[i]->setVisible(_visible && this->instanceVisible[i]);
+}
+
+//////////////////////////////////////////////////
+void Ogre2InstancedVisual::SetVisibilityFlags(uint32_t _flags)
+{
+  Ogre2Visual::SetVisibilityFlags(_flags);
+
+  for (Ogre::Item *item : this->dataPtr->items)
+  {
+    item->setVisibilityFlags(_flags
+        & ~Ogre2ParticleEmitter::kParticleVisibilityFlags);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2InstancedVisual::UpdateInstance(unsigned int _index)
+{
+  if (_index >= this->dataPtr->items.size())
+    return;
+
+  Ogre::SceneNode *node = this->dataPtr->nodes[_index];
+  const math::Pose3d &pose = this->instancePoses[_index];
+  node->setPosition(Ogre2Conversions::Convert(pose.Pos()));
+  node->setOrientation(Ogre2Conversions::Convert(pose.Rot()));
+  node->setScale(Ogre2Conversions::Convert(this->instanceScales[_index]));
+
+  Ogre::Item *item = this->dataPtr->items[_index];
+  item->setVisible(this->dataPtr->visible && this->instanceVisible[_index]);
+
+  this->UpdateInstanceAnimation(_index);
+
+  Ogre2MaterialPtr material =
+      std::dynamic_pointer_cast<Ogre2Material>(this->Material());
+  if (!material)
+    return;
+
+  // low level material with custom shaders. They do not read the colors of
+  // the instances, so colored instances get a copy of the material
+  if (!material->FragmentShader().empty() &&
+      !material->VertexShader().empty())
+  {
+    Ogre2MaterialPtr instanceMaterial = std::dynamic_pointer_cast<
+        Ogre2Material>(this->InstanceMaterial(_index));
+    item->setMaterial(instanceMaterial->Material());
+  }
+  // Pbs Hlms material. The items keep a raw pointer to the datablock, so
+  // the material must not switch to a copy of it later on. Setting the
+  // same datablock again would only look up the shaders again.
+  else
+  {
+    material->UnshareDatablock();
+    Ogre::Vector4 color = Ogre::Vector4::ZERO;
+    if (this->customColors[_index])
+    {
+      const math::Color &c = this->instanceColors[_index];
+      color = Ogre::Vector4(c.R(), c.G(), c.B(), 1.0f);
+    }
+
+    const size_t colorIndex =
+        Ogre2MaterialOverride::InstanceColorParameterIndex();
+    Ogre::HlmsDatablock *datablock = material->Datablock();
+    for (unsigned int s = 0; s < item->getNumSubItems(); ++s)
+    {
+      Ogre::SubItem *subItem = item->getSubItem(s);
+      subItem->setCustomParameter(colorIndex, color);
+      if (subItem->getDatablock() != datablock)
+        subItem->setDatablock(datablock);
+    }
+  }
+  item->setCastShadows(material->CastShadows());
+}
+
+//////////////////////////////////////////////////
+void Ogre2InstancedVisual::UpdateInstanceAnimation(unsigned int _index)
+{
+  Ogre::Item *item = this->dataPtr->items[_index];
+  AnimationPose *&instancePose = this->dataPtr->instancePoses[_index];
+  const std::string &name = this->instanceAnimations[_index];
+  if (!item->hasSkeleton())
+    return;
+
+  Ogre::SkeletonInstance *skel = item->getSkeletonInstance();
+  bool animated = !name.empty();
+  if (animated && !skel->hasAnimation(name))
+  {
+    ignerr << "Skeleton animation name not found: " << name << std::endl;
+    animated = false;
+  }
+  if (!animated)
+  {
+    // back to the bind pose
+    if (instancePose)
+    {
+      for (unsigned int i = 0; i < skel->getNumBones(); ++i)
+        skel->setManualBone(skel->getBone(i), false);
+      instancePose = nullptr;
+    }
+    return;
+  }
+
+  // round the time offset to the closest phase
+  unsigned int phaseCount = this->animationPhaseCount;
+  double length = skel->getAnimation(name)->getDuration();
+  double offset = std::chrono::duration_cast<std::chrono::milliseconds>(
+      this->instanceAnimationOffsets[_index]).count() / 1000.0;
+  unsigned int phase = 0u;
+  if (length > 0.0)
+  {
+    double fraction = std::fmod(offset, length) / length;
+    if (fraction < 0.0)
+      fraction += 1.0;
+    phase = static_cast<unsigned int>(std::lround(fraction * phaseCount)) %
+        phaseCount;
+  }
+
+  auto key = std::make_pair(name, phase);
+  auto it = this->dataPtr->animationPoses.find(key);
+  if (it == this->dataPtr->animationPoses.end())
+  {
+    Ogre2MeshFactoryPtr meshFactory = this->scene->MeshFactory();
+    Ogre::Item *poseItem = meshFactory->OgreItem(this->dataPtr->meshDescriptor);
+    if (!poseItem)
+      return;
+
+    // the pose items are never drawn, their skeletons are only evaluated
+    if (!this->dataPtr->poseNode)
+      this->dataPtr->poseNode = this->ogreNode->createChildSceneNode();
+    this->dataPtr->poseNode->attachObject(poseItem);
+    poseItem->setVisible(false);
+    poseItem->setCastShadows(false);
+
+    AnimationPose pose;
+    pose.item = poseItem;
+    pose.animation = poseItem->getSkeletonInstance()->getAnimation(name);
+    pose.animation->setEnabled(true);
+    pose.animation->setLoop(true);
+    pose.phase = phase;
+    EvaluatePose(pose, this->animationTime, phaseCount);
+    it = this->dataPtr->animationPoses.emplace(key, pose).first;
+  }
+
+  if (!instancePose)
+  {
+    for (unsigned int i = 0; i < skel->getNumBones(); ++i)
+      skel->setManualBone(skel->getBone(i), true);
+  }
+  instancePose = &it->second;
+  this->CopyAnimationPose(_index);
+}
+
+//////////////////////////////////////////////////
+void Ogre2InstancedVisual::CopyAnimationPose(unsigned int _index)
+{
+  AnimationPose *pose = this->dataPtr->instancePoses[_index];
+  if (!pose)
+    return;
+
+  Ogre::SkeletonInstance *source = pose->item->getSkeletonInstance();
+  Ogre::SkeletonInstance *skel =
+      this->dataPtr->items[_index]->getSkeletonInstance();
+  for (unsigned int i = 0; i < skel->getNumBones(); ++i)
+  {
+    const Ogre::Bone *sourceBone = source->getBone(i);
+    Ogre::Bone *bone = skel->getBone(i);
+    bone->setPosition(sourceBone->getPosition());
+    bone->setOrientation(sourceBone->getOrientation());
+    bone->setScale(sourceBone->getScale());
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2InstancedVisual::UpdateAnimationTime()
+{
+  if (this->dataPtr->animationPoses.empty())
+    return;
+
+  // evaluate the animation of each pose item once. Its skeleton is
+  // evaluated again when the scene is updated, but it is not drawn
+  for (auto &entry : this->dataPtr->animationPoses)
+    EvaluatePose(entry.second, this->animationTime, this->animationPhaseCount);
+
+  for (unsigned int i = 0; i < this->dataPtr->instancePoses.size(); ++i)
+    this->CopyAnimationPose(i);
+}
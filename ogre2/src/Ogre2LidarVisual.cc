@@ -25,6 +25,11 @@
 #endif
 #endif
 
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
@@ -40,9 +45,14 @@
 #endif
 #include <OgreItem.h>
 #include <OgreMaterialManager.h>
+#include <OgreMesh2.h>
+#include <OgreMeshManager2.h>
 #include <OgreRoot.h>
+#include <OgreSceneManager.h>
 #include <OgreSceneNode.h>
+#include <OgreSubMesh2.h>
 #include <OgreTechnique.h>
+#include <Vao/OgreVaoManager.h>
 #ifdef _MSC_VER
   #pragma warning(pop)
 #endif
@@ -61,8 +71,20 @@ class ignition::rendering::Ogre2LidarVisualPrivate
   /// \brief Lidar Ray DynamicLines Object to display
   public: std::vector<std::shared_ptr<Ogre2DynamicRenderable>> rayLines;
 
-  /// \brief Lidar Points DynamicLines Object to display
-  public: std::vector<std::shared_ptr<Ogre2DynamicRenderable>> points;
+  /// \brief Ogre item that draws all lidar points in a single draw call.
+  /// Used when LidarVisualType = LVT_POINTS.
+  public: Ogre::Item *pointsItem = nullptr;
+
+  /// \brief Ogre submesh holding the lidar points vao
+  public: Ogre::SubMesh *pointsSubMesh = nullptr;
+
+  /// \brief Dynamic vertex buffer holding one range per lidar point
+  public: Ogre::VertexBufferPacked *rangeBuffer = nullptr;
+
+  /// \brief Ray parameters the ray directions in the lidar points vertex
+  /// buffer were computed from. The directions are recomputed when any of
+  /// these change.
+  public: std::vector<double> pointsLayout;
 
   /// \brief Lidar visual type
   public: LidarVisualType lidarVisType =
@@ -80,7 +102,8 @@ class ignition::rendering::Ogre2LidarVisualPrivate
   /// \brief The visibility of the visual
   public: bool visible = true;
 
-  /// \brief Pointer to point cloud material.
+  /// \brief Pointer to the lidar points material. Each visual has its own
+  /// copy as the ray parameters are passed to the vertex shader.
   /// Used when LidarVisualType = LVT_POINTS.
   public: Ogre::MaterialPtr pointsMat;
 };
@@ -134,14 +157,15 @@ void Ogre2LidarVisual::Destroy()
     ray.reset();
   }
 
-  for (auto ray : this->dataPtr->points)
-  {
-    ray->Clear();
-    ray.reset();
-  }
+  this->DestroyPoints();
 
   this->dataPtr->lidarPoints.clear();
-  this->dataPtr->pointsMat.setNull();
+  if (!this->dataPtr->pointsMat.isNull())
+  {
+    Ogre::MaterialManager::getSingleton().remove(
+        this->dataPtr->pointsMat->getName());
+    this->dataPtr->pointsMat.setNull();
+  }
 }
 
 //////////////////////////////////////////////////
@@ -168,9 +192,11 @@ void Ogre2LidarVisual::Create()
 #endif
 #endif
   }
-  this->dataPtr->pointsMat =
-      Ogre::MaterialManager::getSingleton().getByName(
-      "PointCloudPoint");
+  Ogre::MaterialPtr pointsMat =
+      Ogre::MaterialManager::getSingleton().getByName("LidarPoints");
+  this->dataPtr->pointsMat = pointsMat->clone(
+      this->scene->Name() + "::" + this->Name() + "::LidarPoints");
+  this->dataPtr->pointsMat->load();
 
   this->ClearPoints();
   this->dataPtr->receivedData = false;
@@ -191,7 +217,40 @@ void Ogre2LidarVisual::ClearVisualData()
   this->dataPtr->deadZoneRayFans.clear();
   this->dataPtr->rayLines.clear();
   this->dataPtr->rayStrips.clear();
-  this->dataPtr->points.clear();
+  this->DestroyPoints();
+}
+
+//////////////////////////////////////////////////
+void Ogre2LidarVisual::DestroyPoints()
+{
+  if (!this->dataPtr->pointsSubMesh)
+    return;
+
+  Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+  if (this->dataPtr->pointsItem)
+  {
+    sceneManager->destroyItem(this->dataPtr->pointsItem);
+    this->scene->MarkVisibilityLayersDirty();
+    this->dataPtr->pointsItem = nullptr;
+  }
+
+  Ogre::VaoManager *vaoManager =
+      sceneManager->getDestinationRenderSystem()->getVaoManager();
+  if (vaoManager &&
+      !this->dataPtr->pointsSubMesh->mVao[Ogre::VpNormal].empty())
+  {
+    this->dataPtr->pointsSubMesh->destroyVaos(
+        this->dataPtr->pointsSubMesh->mVao[Ogre::VpNormal], vaoManager);
+  }
+  this->dataPtr->pointsSubMesh->mVao[Ogre::VpShadow].clear();
+
+  std::string meshName = this->dataPtr->pointsSubMesh->mParent->getName();
+  if (Ogre::MeshManager::getSingleton().resourceExists(meshName))
+    Ogre::MeshManager::getSingleton().remove(meshName);
+
+  this->dataPtr->pointsSubMesh = nullptr;
+  this->dataPtr->rangeBuffer = nullptr;
+  this->dataPtr->pointsLayout.clear();
 }
 
 //////////////////////////////////////////////////
@@ -201,6 +260,20 @@ void Ogre2LidarVisual::SetPoints(const std::vector<double> &_points)
   this->dataPtr->receivedData = true;
 }
 
+//////////////////////////////////////////////////
+void Ogre2LidarVisual::SetRanges(const float *_ranges,
+    unsigned int _channelCount)
+{
+  if (!_ranges || _channelCount == 0u)
+    return;
+
+  unsigned int count = this->verticalCount * this->horizontalCount;
+  this->dataPtr->lidarPoints.resize(count);
+  for (unsigned int i = 0u; i < count; ++i)
+    this->dataPtr->lidarPoints[i] = _ranges[i * _channelCount];
+  this->dataPtr->receivedData = true;
+}
+
 //////////////////////////////////////////////////
 void Ogre2LidarVisual::Update()
 {
@@ -219,8 +292,11 @@ void Ogre2LidarVisual::Update()
 
   bool clearVisuals = false;
 
+  // The points visual hides non-hitting rays in the vertex shader so it does
+  // not need to be rebuilt
   if (this->lidarVisualType != this->dataPtr->lidarVisType
-        || !this->displayNonHitting)
+        || (!this->displayNonHitting &&
+        this->lidarVisualType != LidarVisualType::LVT_POINTS))
   {
     clearVisuals = true;
   }
@@ -265,6 +341,13 @@ void Ogre2LidarVisual::Update()
     return;
   }
 
+  if (this->dataPtr->lidarVisType == LidarVisualType::LVT_POINTS)
+  {
+    this->UpdatePoints();
+    this->SetVisible(this->dataPtr->visible);
+    return;
+  }
+
   // Process each point from received data
   // Every line segment, and every triangle is saved separately,
   // as a pointer to a DynamicLine
@@ -329,27 +412,6 @@ void Ogre2LidarVisual::Update()
       }
     }
 
-    else if (this->dataPtr->lidarVisType ==
-                  LidarVisualType::LVT_POINTS)
-    {
-      if (j+1 > this->dataPtr->points.size())
-      {
-        std::shared_ptr<Ogre2DynamicRenderable> renderable =
-                        std::shared_ptr<Ogre2DynamicRenderable>(
-                                    new Ogre2DynamicRenderable(this->Scene()));
-
-        renderable->SetOperationType(MT_POINTS);
-
-        // use low level programmable material so we can customize point size
-        Ogre::Item *item = dynamic_cast<Ogre::Item *>(renderable->OgreObject());
-        item->setCastShadows(false);
-        item->getSubItem(0)->setMaterial(this->dataPtr->pointsMat);
-
-        this->ogreNode->attachObject(renderable->OgreObject());
-        this->dataPtr->points.push_back(renderable);
-      }
-    }
-
     if (this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS)
     {
       this->dataPtr->deadZoneRayFans[j]->SetPoint(0, this->offset.Pos());
@@ -440,26 +502,6 @@ void Ogre2LidarVisual::Update()
             this->dataPtr->deadZoneRayFans[j]->SetPoint(i+1, startPt);
         }
       }
-
-      // For POINTS Lidar Visual to be displayed
-      else if (this->dataPtr->lidarVisType ==
-                LidarVisualType::LVT_POINTS)
-      {
-        if (i >= this->dataPtr->points[j]->PointCount())
-        {
-          if (this->displayNonHitting || !inf)
-          {
-            this->dataPtr->points[j]->AddPoint(inf ? noHitPt: pt);
-          }
-        }
-        else
-        {
-          if (this->displayNonHitting || !inf)
-          {
-            this->dataPtr->points[j]->SetPoint(i, inf ? noHitPt: pt);
-          }
-        }
-      }
       horizontalAngle += this->horizontalAngleStep;
     }
 
@@ -476,35 +518,137 @@ void Ogre2LidarVisual::Update()
         this->dataPtr->deadZoneRayFans[j]->Update();
       }
     }
-    else if (this->dataPtr->lidarVisType == LidarVisualType::LVT_POINTS)
-    {
-      this->dataPtr->points[j]->Update();
-    }
     verticalAngle += this->verticalAngleStep;
   }
 
-  if (this->dataPtr->lidarVisType == LidarVisualType::LVT_POINTS &&
-      !this->dataPtr->points.empty())
-  {
-    // point renderables use low level materials
-    // get the material and set size uniform variable
-    auto pass = this->dataPtr->pointsMat->getTechnique(0)->getPass(0);
-    auto vertParams = pass->getVertexProgramParameters();
-    vertParams->setNamedConstant("size", static_cast<Ogre::Real>(this->size));
-
-    // support setting color only from diffuse for now
-    MaterialPtr mat = this->Scene()->Material("Lidar/BlueRay");
-    auto fragParams = pass->getFragmentProgramParameters();
-    fragParams->setNamedConstant("color",
-        Ogre2Conversions::Convert(mat->Diffuse()));
-  }
-
   // The newly created dynamic lines are having default visibility as true.
   // The visibility needs to be set as per the current value after the new
   // renderables are created.
   this->SetVisible(this->dataPtr->visible);
 }
 
+//////////////////////////////////////////////////
+void Ogre2LidarVisual::UpdatePoints()
+{
+  Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+  Ogre::VaoManager *vaoManager =
+      sceneManager->getDestinationRenderSystem()->getVaoManager();
+  if (!vaoManager)
+    return;
+
+  unsigned int count = this->verticalCount * this->horizontalCount;
+  math::Quaterniond offsetRot = this->offset.Rot();
+  std::vector<double> layout = {
+      this->minHorizontalAngle, this->horizontalAngleStep,
+      this->minVerticalAngle, this->verticalAngleStep,
+      static_cast<double>(this->horizontalCount),
+      static_cast<double>(this->verticalCount),
+      offsetRot.W(), offsetRot.X(), offsetRot.Y(), offsetRot.Z()};
+
+  // the ray directions only depend on the ray parameters so they are only
+  // uploaded when these change
+  if (!this->dataPtr->pointsItem || layout != this->dataPtr->pointsLayout)
+  {
+    this->DestroyPoints();
+    this->dataPtr->pointsLayout = layout;
+
+    std::vector<float> directions(count * 3u);
+    double verticalAngle = this->minVerticalAngle;
+    for (unsigned int j = 0; j < this->verticalCount; ++j)
+    {
+      double horizontalAngle = this->minHorizontalAngle;
+      for (unsigned int i = 0; i < this->horizontalCount; ++i)
+      {
+        math::Quaterniond ray(
+            math::Vector3d(0.0, -verticalAngle, horizontalAngle));
+        math::Vector3d axis = offsetRot * ray * math::Vector3d::UnitX;
+        unsigned int idx = (j * this->horizontalCount + i) * 3u;
+        directions[idx] = static_cast<float>(axis.X());
+        directions[idx+1] = static_cast<float>(axis.Y());
+        directions[idx+2] = static_cast<float>(axis.Z());
+        horizontalAngle += this->horizontalAngleStep;
+      }
+      verticalAngle += this->verticalAngleStep;
+    }
+
+    static int lidarPointsId = 0;
+    Ogre::MeshPtr mesh = Ogre::MeshManager::getSingleton().createManual(
+        "lidar_points_" + std::to_string(lidarPointsId++),
+        Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    this->dataPtr->pointsSubMesh = mesh->createSubMesh();
+
+    Ogre::VertexElement2Vec directionElements;
+    directionElements.push_back(
+        Ogre::VertexElement2(Ogre::VET_FLOAT3, Ogre::VES_POSITION));
+    Ogre::VertexBufferPacked *directionBuffer =
+        vaoManager->createVertexBuffer(directionElements, count,
+        Ogre::BT_IMMUTABLE, directions.data(), false);
+
+    Ogre::VertexElement2Vec rangeElements;
+    rangeElements.push_back(Ogre::VertexElement2(Ogre::VET_FLOAT1,
+        Ogre::VES_TEXTURE_COORDINATES));
+    this->dataPtr->rangeBuffer = vaoManager->createVertexBuffer(
+        rangeElements, count, Ogre::BT_DYNAMIC_PERSISTENT, nullptr, false);
+
+    Ogre::VertexBufferPackedVec vertexBuffers;
+    vertexBuffers.push_back(directionBuffer);
+    vertexBuffers.push_back(this->dataPtr->rangeBuffer);
+
+    Ogre::VertexArrayObject *vao = vaoManager->createVertexArrayObject(
+        vertexBuffers, nullptr, Ogre::OT_POINT_LIST);
+    this->dataPtr->pointsSubMesh->mVao[Ogre::VpNormal].push_back(vao);
+    this->dataPtr->pointsSubMesh->mVao[Ogre::VpShadow].push_back(vao);
+
+    // points are at most max range away from the lidar origin
+    Ogre::Aabb bbox = Ogre::Aabb::BOX_INFINITE;
+    if (!std::isinf(this->maxRange))
+    {
+      bbox = Ogre::Aabb(Ogre2Conversions::Convert(this->offset.Pos()),
+          Ogre::Vector3(static_cast<Ogre::Real>(this->maxRange)));
+    }
+    mesh->_setBounds(bbox, true);
+
+    // use low level programmable material so we can customize point size
+    this->dataPtr->pointsItem =
+        sceneManager->createItem(mesh, Ogre::SCENE_DYNAMIC);
+    this->scene->MarkVisibilityLayersDirty();
+    this->dataPtr->pointsItem->setCastShadows(false);
+    this->dataPtr->pointsItem->getSubItem(0)->setMaterial(
+        this->dataPtr->pointsMat);
+    this->ogreNode->attachObject(this->dataPtr->pointsItem);
+  }
+
+  // upload the ranges, the vertex shader turns them into points
+  float * RESTRICT_ALIAS ranges = reinterpret_cast<float * RESTRICT_ALIAS>(
+      this->dataPtr->rangeBuffer->map(0u, count));
+  for (unsigned int i = 0u; i < count; ++i)
+  {
+    float r = static_cast<float>(this->dataPtr->lidarPoints[i]);
+    // the shader treats inf as a non-hitting ray
+    ranges[i] = r >= this->maxRange ? std::numeric_limits<float>::infinity() :
+        r;
+  }
+  this->dataPtr->rangeBuffer->unmap(Ogre::UO_KEEP_PERSISTENT);
+
+  // point renderables use low level materials
+  // get the material and set the uniform variables
+  auto pass = this->dataPtr->pointsMat->getTechnique(0)->getPass(0);
+  auto vertParams = pass->getVertexProgramParameters();
+  vertParams->setNamedConstant("size", static_cast<Ogre::Real>(this->size));
+  vertParams->setNamedConstant("origin",
+      Ogre2Conversions::Convert(this->offset.Pos()));
+  vertParams->setNamedConstant("maxRange",
+      static_cast<Ogre::Real>(this->maxRange));
+  vertParams->setNamedConstant("displayNonHitting",
+      static_cast<Ogre::Real>(this->displayNonHitting ? 1.0 : 0.0));
+
+  // support setting color only from diffuse for now
+  MaterialPtr mat = this->Scene()->Material("Lidar/BlueRay");
+  auto fragParams = pass->getFragmentProgramParameters();
+  fragParams->setNamedConstant("color",
+      Ogre2Conversions::Convert(mat->Diffuse()));
+}
+
 //////////////////////////////////////////////////
 unsigned int Ogre2LidarVisual::PointCount() const
 {
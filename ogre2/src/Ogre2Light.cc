@@ -33,6 +33,8 @@
 /// \brief Private data for the Ogre2Light class
 class ignition::rendering::Ogre2LightPrivate
 {
+  /// \brief True if the shadow map of this light is cached
+  public: bool staticShadows = false;
 };
 
 using namespace ignition;
@@ -155,6 +157,23 @@ void Ogre2Light::SetCastShadows(bool _castShadows)
   this->scene->SetShadowsDirty(true);
 }
 
+//////////////////////////////////////////////////
+void Ogre2Light::SetStaticShadows(bool _static)
+{
+  if (this->dataPtr->staticShadows == _static)
+    return;
+
+  this->dataPtr->staticShadows = _static;
+  if (this->CastShadows())
+    this->scene->SetShadowsDirty(true);
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Light::StaticShadows() const
+{
+  return this->dataPtr->staticShadows;
+}
+
 //////////////////////////////////////////////////
 Ogre::Light *Ogre2Light::Light() const
 {
@@ -164,6 +183,10 @@ Ogre::Light *Ogre2Light::Light() const
 //////////////////////////////////////////////////
 void Ogre2Light::Destroy()
 {
+  // free the shadow map tied to this light
+  if (this->dataPtr->staticShadows && this->CastShadows())
+    this->scene->SetShadowsDirty(true);
+
   BaseLight::Destroy();
   Ogre::SceneManager *ogreSceneManager = this->scene->OgreSceneManager();
   ogreSceneManager->destroySceneNode(this->ogreLight->getParentSceneNode());
@@ -15,38 +15,25 @@
  *
  */
 
-#ifdef __APPLE__
-  #define GL_SILENCE_DEPRECATION
-  #include <OpenGL/gl.h>
-  #include <OpenGL/glext.h>
-#else
-#ifndef _WIN32
-  #include <GL/gl.h>
-#endif
-#endif
-
 #include <ignition/common/Console.hh>
 
 #include <ignition/common/Mesh.hh>
 #include <ignition/common/MeshManager.hh>
 
 #include "ignition/rendering/ogre2/Ogre2Capsule.hh"
-#include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2DynamicRenderable.hh"
 #include "ignition/rendering/ogre2/Ogre2Marker.hh"
 #include "ignition/rendering/ogre2/Ogre2Material.hh"
 #include "ignition/rendering/ogre2/Ogre2Mesh.hh"
-#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
 #include "ignition/rendering/ogre2/Ogre2Visual.hh"
 
+#include "Ogre2MarkerBatcher.hh"
+
 #ifdef _MSC_VER
   #pragma warning(push, 0)
 #endif
-#include <OgreItem.h>
-#include <OgreMaterialManager.h>
-#include <OgreRoot.h>
-#include <OgreTechnique.h>
+#include <OgreMovableObject.h>
 #ifdef _MSC_VER
   #pragma warning(pop)
 #endif
@@ -65,6 +52,14 @@ class ignition::rendering::Ogre2MarkerPrivate
 
   /// \brief DynamicLines Object to display
   public: std::shared_ptr<Ogre2DynamicRenderable> dynamicRenderable;
+
+  /// \brief True if the points are drawn by the marker batcher of the
+  /// scene instead of the dynamic renderable
+  public: bool batched = false;
+
+  /// \brief Visibility flags of the dynamic renderable, which has none
+  /// while the marker is batched
+  public: uint32_t visibilityFlags = 0u;
 };
 
 using namespace ignition;
@@ -85,52 +80,62 @@ Ogre2Marker::~Ogre2Marker()
 //////////////////////////////////////////////////
 void Ogre2Marker::PreRender()
 {
+  if (this->UpdateBatch())
+    return;
+
   if (this->markerType == MarkerType::MT_POINTS &&
       this->dataPtr->dynamicRenderable &&
       this->dataPtr->dynamicRenderable->PointCount() > 0u)
   {
-    Ogre::Item *item = dynamic_cast<Ogre::Item *>(
-        this->dataPtr->dynamicRenderable->OgreObject());
-    if (!item->getSubItem(0)->getMaterial() ||
-        item->getSubItem(0)->getMaterial()->getName() != "PointCloudPoint")
-    {
-      // enable GL_PROGRAM_POINT_SIZE so we can set gl_PointSize in vertex
-      // shader
-      auto engine = Ogre2RenderEngine::Instance();
-      std::string renderSystemName =
-          engine->OgreRoot()->getRenderSystem()->getFriendlyName();
-      if (renderSystemName.find("OpenGL") != std::string::npos)
-      {
-      #ifdef __APPLE__
-        glEnable(GL_VERTEX_PROGRAM_POINT_SIZE);
-      #else
-      #ifndef _WIN32
-        glEnable(GL_PROGRAM_POINT_SIZE);
-      #endif
-      #endif
-      }
-      Ogre::MaterialPtr pointsMat =
-          Ogre::MaterialManager::getSingleton().getByName(
-          "PointCloudPoint");
-      item->getSubItem(0)->setMaterial(pointsMat);
-    }
+    Ogre2MarkerBatcher::SetPointMaterial(
+        this->dataPtr->dynamicRenderable->OgreObject(), this->size,
+        this->dataPtr->material ? this->dataPtr->material->Diffuse() :
+        math::Color::White);
+  }
 
-    // point renderables use low level materials
-    // get the material and set size uniform variable
-    auto pass = item->getSubItem(0)->getMaterial()->getTechnique(0)->getPass(0);
-    auto vertParams = pass->getVertexProgramParameters();
-    vertParams->setNamedConstant("size", static_cast<Ogre::Real>(this->size));
+  this->dataPtr->dynamicRenderable->Update();
+}
 
-    // support setting color only from diffuse for now
-    if (this->dataPtr->material)
+//////////////////////////////////////////////////
+bool Ogre2Marker::UpdateBatch()
+{
+  Ogre::MovableObject *object = this->dataPtr->dynamicRenderable ?
+      this->dataPtr->dynamicRenderable->OgreObject() : nullptr;
+  if (!object)
+    return false;
+
+  auto ogreScene = std::dynamic_pointer_cast<Ogre2Scene>(this->scene);
+  Ogre2MarkerBatcher *batcher =
+      ogreScene ? ogreScene->MarkerBatcher() : nullptr;
+  VisualPtr parent = this->Parent();
+  if (!batcher || !parent || !this->dataPtr->material ||
+      !Ogre2MarkerBatcher::Batchable(this->markerType))
+  {
+    if (this->dataPtr->batched)
     {
-      auto fragParams = pass->getFragmentProgramParameters();
-      fragParams->setNamedConstant("color",
-          Ogre2Conversions::Convert(this->dataPtr->material->Diffuse()));
+      object->setVisibilityFlags(this->dataPtr->visibilityFlags);
+      this->dataPtr->batched = false;
     }
+    return false;
   }
 
-  this->dataPtr->dynamicRenderable->Update();
+  // the dynamic renderable is hidden from all cameras while the batch draws
+  // the points. Flags set by the visual in the meantime are restored when
+  // the marker leaves the batch.
+  if (!this->dataPtr->batched || object->getVisibilityFlags() != 0u)
+  {
+    this->dataPtr->visibilityFlags = object->getVisibilityFlags();
+    object->setVisibilityFlags(0u);
+  }
+  this->dataPtr->batched = true;
+
+  if (object->getVisible())
+  {
+    batcher->Submit(this->markerType, this->dataPtr->material, this->size,
+        this->dataPtr->visibilityFlags, parent->WorldPose(),
+        parent->WorldScale(), *this->dataPtr->dynamicRenderable);
+  }
+  return true;
 }
 
 //////////////////////////////////////////////////
@@ -307,6 +312,13 @@ void Ogre2Marker::AddPoint(const ignition::math::Vector3d &_pt,
   this->dataPtr->dynamicRenderable->AddPoint(_pt, _color);
 }
 
+//////////////////////////////////////////////////
+void Ogre2Marker::SetPoints(const float *_xyz, const uint8_t *_rgba,
+    std::size_t _count)
+{
+  this->dataPtr->dynamicRenderable->SetPoints(_xyz, _rgba, _count);
+}
+
 //////////////////////////////////////////////////
 void Ogre2Marker::ClearPoints()
 {
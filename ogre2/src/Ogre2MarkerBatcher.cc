@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifdef __APPLE__
+  #define GL_SILENCE_DEPRECATION
+  #include <OpenGL/gl.h>
+  #include <OpenGL/glext.h>
+#else
+#ifndef _WIN32
+  #include <GL/gl.h>
+#endif
+#endif
+
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+#include "ignition/rendering/ogre2/Ogre2Conversions.hh"
+#include "ignition/rendering/ogre2/Ogre2DynamicRenderable.hh"
+#include "ignition/rendering/ogre2/Ogre2Material.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+
+#include "Ogre2MarkerBatcher.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreItem.h>
+#include <OgreMaterialManager.h>
+#include <OgreRoot.h>
+#include <OgreSceneManager.h>
+#include <OgreTechnique.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+Ogre2MarkerBatcher::Ogre2MarkerBatcher(Ogre2ScenePtr _scene)
+  : scene(_scene)
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2MarkerBatcher::~Ogre2MarkerBatcher()
+{
+  this->Clear();
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MarkerBatcher::Batchable(MarkerType _type)
+{
+  return _type == MT_POINTS || _type == MT_LINE_LIST ||
+      _type == MT_LINE_STRIP;
+}
+
+//////////////////////////////////////////////////
+void Ogre2MarkerBatcher::Submit(MarkerType _type,
+    Ogre2MaterialPtr _material, double _size, uint32_t _visibilityFlags,
+    const math::Pose3d &_pose, const math::Vector3d &_scale,
+    const Ogre2DynamicRenderable &_points)
+{
+  Ogre2ScenePtr ogreScene = this->scene.lock();
+  unsigned int count = _points.PointCount();
+  if (_type != MT_POINTS)
+    count -= count % 2u;
+  if (!ogreScene || !_material || !Batchable(_type) || count == 0u)
+    return;
+
+  // line strips of different markers can't be joined, they are drawn as
+  // line lists
+  MarkerType batchType = _type == MT_LINE_STRIP ? MT_LINE_LIST : _type;
+  double size = batchType == MT_POINTS ? _size : 0.0;
+  BatchKey key(batchType, MaterialKey(_material), size, _visibilityFlags);
+
+  Batch &batch = this->batches[key];
+  if (!batch.renderable)
+  {
+    batch.renderable = std::make_unique<Ogre2DynamicRenderable>(ogreScene);
+    batch.renderable->SetOperationType(batchType);
+    batch.renderable->SetMaterial(_material, true);
+    batch.type = batchType;
+    batch.size = size;
+    batch.color = _material->Diffuse();
+
+    Ogre::MovableObject *object = batch.renderable->OgreObject();
+    object->setVisibilityFlags(_visibilityFlags);
+    object->setCastShadows(false);
+    ogreScene->OgreSceneManager()->getRootSceneNode()->attachObject(object);
+  }
+
+  auto append = [&](unsigned int _index)
+  {
+    math::Vector3d p = _pose.Pos() +
+        _pose.Rot() * (_scale * _points.Point(_index));
+    batch.positions.push_back(static_cast<float>(p.X()));
+    batch.positions.push_back(static_cast<float>(p.Y()));
+    batch.positions.push_back(static_cast<float>(p.Z()));
+  };
+
+  if (_type == MT_LINE_STRIP)
+  {
+    for (unsigned int i = 1u; i < _points.PointCount(); ++i)
+    {
+      append(i - 1u);
+      append(i);
+    }
+  }
+  else
+  {
+    // a line list drops its last point if it has an odd number of them
+    for (unsigned int i = 0u; i < count; ++i)
+      append(i);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2MarkerBatcher::Flush()
+{
+  for (auto it = this->batches.begin(); it != this->batches.end();)
+  {
+    Batch &batch = it->second;
+    if (batch.positions.empty())
+    {
+      batch.renderable->Destroy();
+      it = this->batches.erase(it);
+      continue;
+    }
+
+    batch.renderable->SetPoints(batch.positions.data(), nullptr,
+        batch.positions.size() / 3u);
+    if (batch.type == MT_POINTS)
+    {
+      SetPointMaterial(batch.renderable->OgreObject(), batch.size,
+          batch.color);
+    }
+    batch.renderable->Update();
+    batch.positions.clear();
+    ++it;
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2MarkerBatcher::BatchCount() const
+{
+  return static_cast<unsigned int>(this->batches.size());
+}
+
+//////////////////////////////////////////////////
+void Ogre2MarkerBatcher::Clear()
+{
+  for (auto &batch : this->batches)
+    batch.second.renderable->Destroy();
+  this->batches.clear();
+}
+
+//////////////////////////////////////////////////
+void Ogre2MarkerBatcher::SetPointMaterial(Ogre::MovableObject *_object,
+    double _size, const math::Color &_color)
+{
+  Ogre::Item *item = dynamic_cast<Ogre::Item *>(_object);
+  if (!item)
+    return;
+
+  if (!item->getSubItem(0)->getMaterial() ||
+      item->getSubItem(0)->getMaterial()->getName() != "PointCloudPoint")
+  {
+    // enable GL_PROGRAM_POINT_SIZE so we can set gl_PointSize in vertex
+    // shader
+    auto engine = Ogre2RenderEngine::Instance();
+    std::string renderSystemName =
+        engine->OgreRoot()->getRenderSystem()->getFriendlyName();
+    if (renderSystemName.find("OpenGL") != std::string::npos)
+    {
+    #ifdef __APPLE__
+      glEnable(GL_VERTEX_PROGRAM_POINT_SIZE);
+    #else
+    #ifndef _WIN32
+      glEnable(GL_PROGRAM_POINT_SIZE);
+    #endif
+    #endif
+    }
+    Ogre::MaterialPtr pointsMat =
+        Ogre::MaterialManager::getSingleton().getByName(
+        "PointCloudPoint");
+    item->getSubItem(0)->setMaterial(pointsMat);
+  }
+
+  // point renderables use low level materials
+  // get the material and set size uniform variable
+  auto pass = item->getSubItem(0)->getMaterial()->getTechnique(0)->getPass(0);
+  auto vertParams = pass->getVertexProgramParameters();
+  vertParams->setNamedConstant("size", static_cast<Ogre::Real>(_size));
+
+  // support setting color only from diffuse for now
+  auto fragParams = pass->getFragmentProgramParameters();
+  fragParams->setNamedConstant("color", Ogre2Conversions::Convert(_color));
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2MarkerBatcher::MaterialKey(Ogre2MaterialPtr _material)
+{
+  std::ostringstream key;
+  key << std::setprecision(std::numeric_limits<double>::max_digits10);
+  key << _material->Ambient() << "|" << _material->Diffuse() << "|"
+      << _material->Specular() << "|" << _material->Emissive() << "|"
+      << _material->Transparency() << "|" << _material->LightingEnabled()
+      << "|" << _material->DepthCheckEnabled() << "|"
+      << _material->DepthWriteEnabled() << "|" << _material->Texture();
+  return key.str();
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2MARKERBATCHER_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2MARKERBATCHER_HH_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <ignition/math/Color.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "ignition/rendering/Marker.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
+
+namespace Ogre
+{
+  class MovableObject;
+}
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    class Ogre2DynamicRenderable;
+
+    /// \brief Merges the point and line markers of a scene that have the
+    /// same material into shared dynamic renderables, so that they take one
+    /// draw call per material instead of one per marker. The markers submit
+    /// their points during PreRender, transformed to world space on the
+    /// CPU, and Flush uploads the batches once all markers were submitted.
+    /// Batches that get no points in a frame are destroyed.
+    class Ogre2MarkerBatcher
+    {
+      /// \brief Constructor
+      /// \param[in] _scene Scene of the markers
+      public: explicit Ogre2MarkerBatcher(Ogre2ScenePtr _scene);
+
+      /// \brief Destructor
+      public: ~Ogre2MarkerBatcher();
+
+      /// \brief Check if a marker type can be batched
+      /// \param[in] _type Marker type
+      /// \return True for points, line lists and line strips
+      public: static bool Batchable(MarkerType _type);
+
+      /// \brief Add the points of a marker to the batch of its material for
+      /// the current frame. Line strips are drawn as line lists.
+      /// \param[in] _type Marker type, must be batchable
+      /// \param[in] _material Material of the marker
+      /// \param[in] _size Point size of point markers
+      /// \param[in] _visibilityFlags Visibility flags of the marker
+      /// \param[in] _pose World pose of the visual of the marker
+      /// \param[in] _scale World scale of the visual of the marker
+      /// \param[in] _points Points of the marker, in the visual frame
+      public: void Submit(MarkerType _type, Ogre2MaterialPtr _material,
+          double _size, uint32_t _visibilityFlags,
+          const math::Pose3d &_pose, const math::Vector3d &_scale,
+          const Ogre2DynamicRenderable &_points);
+
+      /// \brief Upload the points submitted since the last call and destroy
+      /// the batches that got none. Must be called after the markers were
+      /// pre-rendered, before the scene graph is updated.
+      public: void Flush();
+
+      /// \brief Get the number of batches drawn
+      /// \return Number of batches left by the last Flush
+      public: unsigned int BatchCount() const;
+
+      /// \brief Destroy all batches
+      public: void Clear();
+
+      /// \brief Switch the item of a point renderable to the low level point
+      /// material and set its size and color
+      /// \param[in] _object Ogre item of the point renderable
+      /// \param[in] _size Point size
+      /// \param[in] _color Point color
+      public: static void SetPointMaterial(Ogre::MovableObject *_object,
+          double _size, const math::Color &_color);
+
+      /// \brief Get a key identifying the parameters of a material that
+      /// affect how markers are drawn
+      /// \param[in] _material Material
+      /// \return Key, equal for materials drawing markers the same
+      private: static std::string MaterialKey(Ogre2MaterialPtr _material);
+
+      /// \brief A batch of markers drawn with a single renderable
+      private: struct Batch
+      {
+        /// \brief Renderable drawing the batch, attached to the root scene
+        /// node
+        std::unique_ptr<Ogre2DynamicRenderable> renderable;
+
+        /// \brief Diffuse color of the material of the batch
+        math::Color color;
+
+        /// \brief Marker type drawn by the renderable
+        MarkerType type = MT_NONE;
+
+        /// \brief Point size of point batches
+        double size = 1.0;
+
+        /// \brief World positions submitted this frame, three floats per
+        /// vertex
+        std::vector<float> positions;
+      };
+
+      /// \brief Key of a batch: drawn marker type, material key, point size
+      /// and visibility flags
+      private: using BatchKey =
+          std::tuple<MarkerType, std::string, double, uint32_t>;
+
+      /// \brief Scene of the markers, which owns the batcher
+      private: std::weak_ptr<Ogre2Scene> scene;
+
+      /// \brief Batches, by key
+      private: std::map<BatchKey, Batch> batches;
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/Marker.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(Ogre2MarkerBatcherTest, MarkerBatching)
+{
+  Ogre2RenderEngine *engine = Ogre2RenderEngine::Instance();
+  std::map<std::string, std::string> params;
+  params["drawStats"] = "1";
+  if (!engine->Load(params) || !engine->Init())
+  {
+    igndbg << "Engine 'ogre2' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  Ogre2ScenePtr ogreScene = std::dynamic_pointer_cast<Ogre2Scene>(scene);
+  ASSERT_NE(nullptr, ogreScene);
+  EXPECT_FALSE(ogreScene->MarkerBatching());
+  VisualPtr root = scene->RootVisual();
+
+  MaterialPtr red = scene->CreateMaterial();
+  red->SetDiffuse(math::Color::Red);
+  MaterialPtr blue = scene->CreateMaterial();
+  blue->SetDiffuse(math::Color::Blue);
+
+  // point markers of the same color, each with a material of its own, all
+  // in view
+  const unsigned int count = 16u;
+  for (unsigned int i = 0u; i < count; ++i)
+  {
+    MarkerPtr marker = scene->CreateMarker();
+    ASSERT_NE(nullptr, marker);
+    marker->SetType(MarkerType::MT_POINTS);
+    marker->SetMaterial(red);
+    for (unsigned int j = 0u; j < 4u; ++j)
+      marker->AddPoint(math::Vector3d(0.0, j * 0.1, 0.0), math::Color::Red);
+
+    VisualPtr visual = scene->CreateVisual();
+    visual->AddGeometry(marker);
+    visual->SetLocalPosition(5.0, (i % 4u) * 0.5 - 1.0,
+        (i / 4u) * 0.5 - 1.0);
+    root->AddChild(visual);
+  }
+
+  CameraPtr camera = scene->CreateCamera("camera");
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(320);
+  camera->SetImageHeight(240);
+  root->AddChild(camera);
+
+  camera->Update();
+  rendering::DrawStats unbatched = camera->DrawStats();
+  EXPECT_EQ(0u, ogreScene->MarkerBatchCount());
+
+  // the markers are drawn by a single batch, which takes one draw instead
+  // of one per marker
+  ogreScene->SetMarkerBatching(true);
+  EXPECT_TRUE(ogreScene->MarkerBatching());
+  camera->Update();
+  rendering::DrawStats batched = camera->DrawStats();
+  EXPECT_EQ(1u, ogreScene->MarkerBatchCount());
+  EXPECT_EQ(unbatched.drawCallCount - (count - 1u), batched.drawCallCount);
+  EXPECT_LT(batched.batchCount, unbatched.batchCount);
+
+  // markers of another material get a batch of their own. A line strip of
+  // two points is drawn as a line list.
+  MarkerPtr line = scene->CreateMarker();
+  line->SetType(MarkerType::MT_LINE_STRIP);
+  line->SetMaterial(blue);
+  line->AddPoint(math::Vector3d(0.0, -1.0, 0.0), math::Color::Blue);
+  line->AddPoint(math::Vector3d(0.0, 1.0, 0.0), math::Color::Blue);
+  VisualPtr lineVisual = scene->CreateVisual();
+  lineVisual->AddGeometry(line);
+  lineVisual->SetLocalPosition(5.0, 0.0, 1.0);
+  root->AddChild(lineVisual);
+  camera->Update();
+  EXPECT_EQ(2u, ogreScene->MarkerBatchCount());
+  EXPECT_EQ(batched.drawCallCount + 1u, camera->DrawStats().drawCallCount);
+
+  // the batch of a destroyed marker goes away
+  scene->DestroyVisual(lineVisual, true);
+  camera->Update();
+  EXPECT_EQ(1u, ogreScene->MarkerBatchCount());
+  EXPECT_EQ(batched.drawCallCount, camera->DrawStats().drawCallCount);
+
+  // the markers draw themselves again once batching is disabled
+  ogreScene->SetMarkerBatching(false);
+  camera->Update();
+  EXPECT_EQ(0u, ogreScene->MarkerBatchCount());
+  EXPECT_EQ(unbatched.drawCallCount, camera->DrawStats().drawCallCount);
+
+  engine->DestroyScene(scene);
+}
@@ -26,6 +26,7 @@
 #include <Hlms/Unlit/OgreHlmsUnlitDatablock.h>
 #include <OgreHighLevelGpuProgram.h>
 #include <OgreHighLevelGpuProgramManager.h>
+#include <OgreItem.h>
 #include <OgreHlmsManager.h>
 #include <OgreMaterialManager.h>
 #include <OgrePixelFormatGpuUtils.h>
@@ -36,17 +37,31 @@
 #pragma warning(pop)
 #endif
 
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Filesystem.hh>
 #include <ignition/common/Image.hh>
 
+#include "ignition/rendering/PixelFormat.hh"
 #include "ignition/rendering/ShaderParams.hh"
 #include "ignition/rendering/ShaderType.hh"
 #include "ignition/rendering/ogre2/Ogre2Material.hh"
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
+#include "ignition/rendering/ogre2/Ogre2Mesh.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
 
+#include "Ogre2ObjectId.hh"
+#include "Ogre2TextureCompression.hh"
+#include "Ogre2VertexDeformation.hh"
 
 /// \brief Private data for the Ogre2Material class
 class ignition::rendering::Ogre2MaterialPrivate
@@ -66,6 +81,30 @@ class ignition::rendering::Ogre2MaterialPrivate
 
   /// \brief Parameters to be bound to the fragment shader
   public: ShaderParamsPtr fragmentShaderParams;
+
+  /// \brief Definitions of the shader constants, resolved once by name so
+  /// that updating a parameter skips the lookup.
+  /// Key: ogre program parameters, value: map of parameter name to
+  /// definition, null if the program has no such constant
+  public: std::map<const Ogre::GpuProgramParameters *,
+      std::unordered_map<std::string, const Ogre::GpuConstantDefinition *>>
+      constantDefs;
+
+  /// \brief Texture maps being loaded asynchronously.
+  /// Key: texture map type, value: ogre texture name
+  public: std::map<Ogre::PbsTextureTypes, std::string> pendingTextures;
+
+  /// \brief Texture maps loaded from the block compressed texture cache.
+  /// Key: texture map type, value: source texture path and ogre texture name
+  public: std::map<Ogre::PbsTextureTypes,
+      std::pair<std::string, std::string>> cachedTextures;
+
+  /// \brief Content key of the datablock shared with other materials,
+  /// empty if the material owns its datablock
+  public: std::string sharedDatablockKey;
+
+  /// \brief Submeshes whose subitems use the datablock
+  public: std::unordered_set<Ogre2SubMesh *> subMeshUsers;
 };
 
 using namespace ignition;
@@ -92,7 +131,23 @@ void Ogre2Material::Destroy()
   if (!this->ogreDatablock)
     return;
 
-  this->ogreHlmsPbs->destroyDatablock(this->ogreDatablockId);
+  // the ogre texture is looked up before the datablock is destroyed. The
+  // scene destroys it at the end of the frame if it is no longer in use
+  std::string ogreTextureName;
+  Ogre::TextureGpu *texture =
+      this->ogreDatablock->getTexture(Ogre::PBSM_DIFFUSE);
+  if (texture)
+    ogreTextureName = texture->getNameStr();
+
+  if (this->dataPtr->sharedDatablockKey.empty())
+  {
+    this->ogreHlmsPbs->destroyDatablock(this->ogreDatablockId);
+  }
+  else
+  {
+    this->scene->ReleaseSharedDatablock(this->dataPtr->sharedDatablockKey);
+    this->dataPtr->sharedDatablockKey.clear();
+  }
   this->ogreDatablock = nullptr;
 
   if (this->ogreUnlitDatablock)
@@ -105,93 +160,128 @@ void Ogre2Material::Destroy()
   // remove low level ogre material used by render targets
   if (this->ogreMaterial)
   {
+    DestroyDeformedMaterials(this->ogreMaterial->getName());
     Ogre::MaterialManager &matManager = Ogre::MaterialManager::getSingleton();
     matManager.remove(this->ogreMaterial);
     this->ogreMaterial.reset();
   }
 
-  Ogre::Root *root = Ogre2RenderEngine::Instance()->OgreRoot();
-  Ogre::TextureGpuManager *textureManager =
-    root->getRenderSystem()->getTextureGpuManager();
+  if (!this->textureName.empty())
+    this->scene->UnregisterTextureUser(this->textureName, this);
+  this->scene->MaterialDestroyed(this->textureName, ogreTextureName);
+  this->scene->UnregisterPendingTextures(this);
+  this->scene->UnregisterCachedTextures(this);
+  this->dataPtr->pendingTextures.clear();
+  this->dataPtr->cachedTextures.clear();
+  this->dataPtr->subMeshUsers.clear();
+}
 
-  textureManager->setStagingTextureMaxBudgetBytes(
-    8u * 1024u * 1024u);
-  textureManager->setWorkerThreadMaxPreloadBytes(
-    8u * 1024u * 1024u);
-  textureManager->setWorkerThreadMaxPerStagingTextureRequestBytes(
-    4u * 1024u * 1024u);
+//////////////////////////////////////////////////
+MaterialPtr Ogre2Material::Clone(const std::string &_name) const
+{
+  MaterialPtr material = BaseMaterial::Clone(_name);
+  if (this->scene->MaterialSharing())
+  {
+    Ogre2MaterialPtr derived =
+        std::dynamic_pointer_cast<Ogre2Material>(material);
+    if (derived)
+      derived->ShareDatablock();
+  }
+  return material;
+}
 
-  Ogre::TextureGpuManager::BudgetEntryVec budget;
-  textureManager->setWorkerThreadMinimumBudget( budget );
-  Ogre::HlmsManager *hlmsManager = root->getHlmsManager();
+//////////////////////////////////////////////////
+bool Ogre2Material::DatablockShared() const
+{
+  return !this->dataPtr->sharedDatablockKey.empty();
+}
 
-  Ogre::TextureGpu* textureToRemove = nullptr;
-  bool textureIsUse = false;
-  // Check each material from each Hlms (except low level) to see if their
-  // material is currently in use. If it's not, then its textures may be
-  // not either
-  for (size_t i = Ogre::HLMS_PBS; i < Ogre::HLMS_MAX; ++i)
+//////////////////////////////////////////////////
+void Ogre2Material::ShareDatablock()
+{
+  // materials with custom shaders or textures still loading keep their
+  // own datablock
+  if (!this->ogreDatablock || this->DatablockShared() ||
+      !this->dataPtr->vertexShaderPath.empty() ||
+      !this->dataPtr->fragmentShaderPath.empty() ||
+      !this->dataPtr->pendingTextures.empty())
   {
-    Ogre::Hlms *hlms = hlmsManager->getHlms(static_cast<Ogre::HlmsTypes>(i));
+    return;
+  }
 
-    if(hlms)
-    {
-      const Ogre::Hlms::HlmsDatablockMap &datablocks = hlms->getDatablockMap();
+  std::string key = this->DatablockKey();
+  Ogre::HlmsPbsDatablock *shared =
+      this->scene->AcquireSharedDatablock(key, this->ogreDatablock);
+  if (!shared)
+    return;
 
-      Ogre::Hlms::HlmsDatablockMap::const_iterator itor = datablocks.begin();
-      Ogre::Hlms::HlmsDatablockMap::const_iterator end  = datablocks.end();
+  this->ogreHlmsPbs->destroyDatablock(this->ogreDatablockId);
+  this->ogreDatablock = shared;
+  this->dataPtr->sharedDatablockKey = key;
+}
 
-      while (itor != end)
-      {
-        if (i == Ogre::HLMS_PBS)
-        {
-          Ogre::HlmsPbsDatablock *derivedDatablock =
-            static_cast<Ogre::HlmsPbsDatablock*>(itor->second.datablock);
-          for (size_t texUnit = 0; texUnit < Ogre::NUM_PBSM_TEXTURE_TYPES;
-            ++texUnit)
-          {
-            // Check each texture from the material
-            Ogre::TextureGpu *tex = derivedDatablock->getTexture(texUnit);
-            if (tex)
-            {
-              // If getLinkedRenderables is empty, then the material is
-              // not in use, and thus so is potentially the texture
-              if (!itor->second.datablock->getLinkedRenderables().empty())
-              {
-                if (tex->getNameStr() == this->textureName)
-                {
-                  textureIsUse = true;
-                }
-              }
-              else
-              {
-                if (tex->getNameStr() == this->textureName)
-                {
-                  textureToRemove = tex;
-                }
-              }
-            }
-          }
-        }
-        ++itor;
-      }
-    }
-  }
+//////////////////////////////////////////////////
+void Ogre2Material::UnshareDatablock()
+{
+  if (this->dataPtr->sharedDatablockKey.empty())
+    return;
 
-  if (textureToRemove && !textureIsUse)
+  // copy on write
+  Ogre::HlmsPbsDatablock *shared = this->ogreDatablock;
+  this->ogreDatablock = static_cast<Ogre::HlmsPbsDatablock *>(
+      shared->clone(this->ogreDatablockId));
+  SetDatablockObjectId(this->ogreDatablock);
+  for (auto subMesh : this->dataPtr->subMeshUsers)
   {
-    Ogre2ScenePtr s = std::dynamic_pointer_cast<Ogre2Scene>(this->Scene());
-    s->ClearMaterialsCache(this->textureName);
-    this->Scene()->UnregisterMaterial(this->name);
-    textureManager->destroyTexture(textureToRemove);
+    Ogre::SubItem *subItem = subMesh->Ogre2SubItem();
+    if (subItem && subItem->getDatablock() == shared)
+      subItem->setDatablock(this->ogreDatablock);
   }
+  this->scene->ReleaseSharedDatablock(this->dataPtr->sharedDatablockKey);
+  this->dataPtr->sharedDatablockKey.clear();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Material::RegisterSubMeshUser(Ogre2SubMesh *_subMesh)
+{
+  this->dataPtr->subMeshUsers.insert(_subMesh);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Material::UnregisterSubMeshUser(Ogre2SubMesh *_subMesh)
+{
+  this->dataPtr->subMeshUsers.erase(_subMesh);
+}
 
-  Ogre2ScenePtr s = std::dynamic_pointer_cast<Ogre2Scene>(this->Scene());
-  Ogre::SceneManager *sceneManager = s->OgreSceneManager();
-  sceneManager->shrinkToFitMemoryPools();
+//////////////////////////////////////////////////
+std::string Ogre2Material::DatablockKey() const
+{
+  std::ostringstream key;
+  key << std::setprecision(std::numeric_limits<double>::max_digits10);
 
-  Ogre::VaoManager *vaoManager = textureManager->getVaoManager();
-  vaoManager->cleanupEmptyPools();
+  // strings are prefixed with their length so that they can not be
+  // confused with the values around them
+  auto addString = [&key](const std::string &_str)
+  {
+    key << _str.size() << ':' << _str << ';';
+  };
+
+  key << this->Diffuse() << ';' << this->Specular() << ';'
+      << this->Emissive() << ';' << this->transparency << ';'
+      << this->TextureAlphaEnabled() << ';' << this->AlphaThreshold() << ';'
+      << this->TwoSidedEnabled() << ';' << this->RenderOrder() << ';'
+      << this->ReceiveShadows() << ';' << this->Roughness() << ';'
+      << this->Metalness() << ';' << this->DepthCheckEnabled() << ';'
+      << this->DepthWriteEnabled() << ';' << this->lightMapUvSet << ';'
+      << this->ogreDatablock->getUseDiffuseMapAsGrayscale() << ';';
+  addString(this->textureName);
+  addString(this->normalMapName);
+  addString(this->roughnessMapName);
+  addString(this->metalnessMapName);
+  addString(this->environmentMapName);
+  addString(this->emissiveMapName);
+  addString(this->lightMapName);
+  return key.str();
 }
 
 //////////////////////////////////////////////////
@@ -205,6 +295,12 @@ math::Color Ogre2Material::Diffuse() const
 //////////////////////////////////////////////////
 void Ogre2Material::SetDiffuse(const math::Color &_color)
 {
+  // colors animated every frame are often set to the value they already
+  // have, which must not copy a shared datablock
+  if (this->Diffuse() == _color)
+    return;
+
+  this->UnshareDatablock();
   BaseMaterial::SetDiffuse(_color);
   this->ogreDatablock->setDiffuse(
       Ogre::Vector3(_color.R(), _color.G(), _color.B()));
@@ -222,6 +318,10 @@ math::Color Ogre2Material::Specular() const
 //////////////////////////////////////////////////
 void Ogre2Material::SetSpecular(const math::Color &_color)
 {
+  if (this->Specular() == math::Color(_color.R(), _color.G(), _color.B()))
+    return;
+
+  this->UnshareDatablock();
   this->ogreDatablock->setSpecular(
       Ogre::Vector3(_color.R(), _color.G(), _color.B()));
 }
@@ -237,6 +337,10 @@ math::Color Ogre2Material::Emissive() const
 //////////////////////////////////////////////////
 void Ogre2Material::SetEmissive(const math::Color &_color)
 {
+  if (this->Emissive() == math::Color(_color.R(), _color.G(), _color.B()))
+    return;
+
+  this->UnshareDatablock();
   this->ogreDatablock->setEmissive(
       Ogre::Vector3(_color.R(), _color.G(), _color.B()));
 }
@@ -258,6 +362,18 @@ void Ogre2Material::UpdateTransparency()
   else
     mode = Ogre::HlmsPbsDatablock::Transparent;
 
+  // setting the transparency replaces the blendblock and flushes the
+  // shaders of every renderable using the datablock, even if it does not
+  // change. Only the constant buffer is updated by the color setters.
+  if (math::equal(static_cast<double>(
+      this->ogreDatablock->getTransparency()), opacity, 1e-6) &&
+      this->ogreDatablock->getTransparencyMode() == mode)
+  {
+    return;
+  }
+
+  this->UnshareDatablock();
+
   // from ogre documentation: 0 = full transparency and 1 = fully opaque
   this->ogreDatablock->setTransparency(opacity, mode);
 }
@@ -266,6 +382,7 @@ void Ogre2Material::UpdateTransparency()
 void Ogre2Material::SetAlphaFromTexture(bool _enabled,
     double _alpha, bool _twoSided)
 {
+  this->UnshareDatablock();
   BaseMaterial::SetAlphaFromTexture(_enabled, _alpha, _twoSided);
   if (_enabled)
   {
@@ -293,6 +410,7 @@ float Ogre2Material::RenderOrder() const
 //////////////////////////////////////////////////
 void Ogre2Material::SetRenderOrder(const float _renderOrder)
 {
+  this->UnshareDatablock();
   this->renderOrder = _renderOrder;
   Ogre::HlmsMacroblock macroblock(
       *this->ogreDatablock->getMacroblock());
@@ -324,6 +442,7 @@ bool Ogre2Material::ReceiveShadows() const
 //////////////////////////////////////////////////
 void Ogre2Material::SetReceiveShadows(const bool _receiveShadows)
 {
+  this->UnshareDatablock();
   this->ogreDatablock->setReceiveShadows(_receiveShadows);
 }
 
@@ -348,13 +467,19 @@ void Ogre2Material::SetTexture(const std::string &_name)
     return;
   }
 
+  if (!this->textureName.empty())
+    this->scene->UnregisterTextureUser(this->textureName, this);
   this->textureName = _name;
+  this->scene->RegisterTextureUser(this->textureName, this);
   this->SetTextureMapImpl(this->textureName, Ogre::PBSM_DIFFUSE);
 }
 
 //////////////////////////////////////////////////
 void Ogre2Material::ClearTexture()
 {
+  this->UnshareDatablock();
+  if (!this->textureName.empty())
+    this->scene->UnregisterTextureUser(this->textureName, this);
   this->textureName = "";
   this->ogreDatablock->setTexture(Ogre::PBSM_DIFFUSE, this->textureName);
 }
@@ -387,6 +512,7 @@ void Ogre2Material::SetNormalMap(const std::string &_name)
 //////////////////////////////////////////////////
 void Ogre2Material::ClearNormalMap()
 {
+  this->UnshareDatablock();
   this->normalMapName = "";
   this->ogreDatablock->setTexture(Ogre::PBSM_NORMAL, this->normalMapName);
 }
@@ -419,6 +545,7 @@ void Ogre2Material::SetRoughnessMap(const std::string &_name)
 //////////////////////////////////////////////////
 void Ogre2Material::ClearRoughnessMap()
 {
+  this->UnshareDatablock();
   this->roughnessMapName = "";
   this->ogreDatablock->setTexture(Ogre::PBSM_ROUGHNESS, this->roughnessMapName);
 }
@@ -451,6 +578,7 @@ void Ogre2Material::SetMetalnessMap(const std::string &_name)
 //////////////////////////////////////////////////
 void Ogre2Material::ClearMetalnessMap()
 {
+  this->UnshareDatablock();
   this->metalnessMapName = "";
   this->ogreDatablock->setTexture(Ogre::PBSM_METALLIC, this->metalnessMapName);
 }
@@ -483,6 +611,7 @@ void Ogre2Material::SetEnvironmentMap(const std::string &_name)
 //////////////////////////////////////////////////
 void Ogre2Material::ClearEnvironmentMap()
 {
+  this->UnshareDatablock();
   this->environmentMapName = "";
   this->ogreDatablock->setTexture(
     Ogre::PBSM_REFLECTION, this->environmentMapName);
@@ -516,6 +645,7 @@ void Ogre2Material::SetEmissiveMap(const std::string &_name)
 //////////////////////////////////////////////////
 void Ogre2Material::ClearEmissiveMap()
 {
+  this->UnshareDatablock();
   this->emissiveMapName = "";
   this->ogreDatablock->setTexture(Ogre::PBSM_EMISSIVE, this->emissiveMapName);
 }
@@ -547,6 +677,7 @@ void Ogre2Material::SetLightMap(const std::string &_name, unsigned int _uvSet)
     return;
   }
 
+  this->UnshareDatablock();
   this->lightMapName = _name;
   this->lightMapUvSet = _uvSet;
 
@@ -568,6 +699,7 @@ void Ogre2Material::SetLightMap(const std::string &_name, unsigned int _uvSet)
 //////////////////////////////////////////////////
 void Ogre2Material::ClearLightMap()
 {
+  this->UnshareDatablock();
   this->lightMapName = "";
   this->lightMapUvSet = 0u;
 
@@ -580,6 +712,7 @@ void Ogre2Material::ClearLightMap()
 //////////////////////////////////////////////////
 void Ogre2Material::SetRoughness(const float _roughness)
 {
+  this->UnshareDatablock();
   this->ogreDatablock->setRoughness(_roughness);
 }
 
@@ -592,6 +725,7 @@ float Ogre2Material::Roughness() const
 //////////////////////////////////////////////////
 void Ogre2Material::SetMetalness(const float _metalness)
 {
+  this->UnshareDatablock();
   this->ogreDatablock->setMetalness(_metalness);
 }
 
@@ -636,65 +770,72 @@ void Ogre2Material::UpdateShaderParams()
 void Ogre2Material::UpdateShaderParams(ConstShaderParamsPtr _params,
     Ogre::GpuProgramParametersSharedPtr _ogreParams)
 {
-  for (const auto name_param : *_params)
+  auto &constantDefs = this->dataPtr->constantDefs[_ogreParams.get()];
+
+  // only the parameters modified since the last update are written
+  for (const auto &name : _params->DirtyParams())
   {
-    auto *constantDef =
-        Ogre::GpuProgramParameters::getAutoConstantDefinition(name_param.first);
-    if (constantDef)
+    const ShaderParam &param = (*_params)[name];
+
+    auto *autoConstantDef =
+        Ogre::GpuProgramParameters::getAutoConstantDefinition(name);
+    if (autoConstantDef)
     {
-      _ogreParams->setNamedAutoConstant(name_param.first, constantDef->acType);
+      _ogreParams->setNamedAutoConstant(name, autoConstantDef->acType);
       continue;
     }
 
-    if (!_ogreParams->_findNamedConstantDefinition(name_param.first))
+    auto defIt = constantDefs.find(name);
+    if (defIt == constantDefs.end())
+    {
+      defIt = constantDefs.emplace(name,
+          _ogreParams->_findNamedConstantDefinition(name)).first;
+    }
+    const Ogre::GpuConstantDefinition *constantDef = defIt->second;
+    if (!constantDef)
     {
       ignwarn << "Unable to find GPU program parameter: "
-              << name_param.first << std::endl;
+              << name << std::endl;
       continue;
     }
+    size_t maxCount = constantDef->elementSize * constantDef->arraySize;
 
-    if (ShaderParam::PARAM_FLOAT == name_param.second.Type())
+    if (ShaderParam::PARAM_FLOAT == param.Type())
     {
       float value;
-      name_param.second.Value(&value);
-      _ogreParams->setNamedConstant(name_param.first, value);
+      param.Value(&value);
+      _ogreParams->_writeRawConstants(constantDef->physicalIndex, &value, 1u);
     }
-    else if (ShaderParam::PARAM_INT == name_param.second.Type())
+    else if (ShaderParam::PARAM_INT == param.Type())
     {
       int value;
-      name_param.second.Value(&value);
-      _ogreParams->setNamedConstant(name_param.first, value);
+      param.Value(&value);
+      _ogreParams->_writeRawConstants(constantDef->physicalIndex, &value, 1u);
     }
-    else if (ShaderParam::PARAM_FLOAT_BUFFER == name_param.second.Type())
+    else if (ShaderParam::PARAM_FLOAT_BUFFER == param.Type())
     {
       std::shared_ptr<void> buffer;
-      name_param.second.Buffer(buffer);
-      uint32_t count = name_param.second.Count();
-
-      // multiple other than 4 is currently only supported by GLSL
-      uint32_t multiple = 1;
-      _ogreParams->setNamedConstant(name_param.first,
-          reinterpret_cast<float*>(buffer.get()), count, multiple);
+      param.Buffer(buffer);
+      size_t count = std::min<size_t>(param.Count(), maxCount);
+      _ogreParams->_writeRawConstants(constantDef->physicalIndex,
+          reinterpret_cast<float*>(buffer.get()), count);
     }
-    else if (ShaderParam::PARAM_INT_BUFFER == name_param.second.Type())
+    else if (ShaderParam::PARAM_INT_BUFFER == param.Type())
     {
       std::shared_ptr<void> buffer;
-      name_param.second.Buffer(buffer);
-      uint32_t count = name_param.second.Count();
-
-      // multiple other than 4 is currently only supported by GLSL
-      uint32_t multiple = 1;
-      _ogreParams->setNamedConstant(name_param.first,
-        reinterpret_cast<int*>(buffer.get()), count, multiple);
+      param.Buffer(buffer);
+      size_t count = std::min<size_t>(param.Count(), maxCount);
+      _ogreParams->_writeRawConstants(constantDef->physicalIndex,
+          reinterpret_cast<int*>(buffer.get()), count);
     }
-    else if (ShaderParam::PARAM_TEXTURE == name_param.second.Type() ||
-             ShaderParam::PARAM_TEXTURE_CUBE == name_param.second.Type())
+    else if (ShaderParam::PARAM_TEXTURE == param.Type() ||
+             ShaderParam::PARAM_TEXTURE_CUBE == param.Type())
     {
       // add the textures to the resource path
       std::string value;
       uint32_t uvSetIndex = 0;
-      name_param.second.Value(value, uvSetIndex);
-      ShaderParam::ParamType type = name_param.second.Type();
+      param.Value(value, uvSetIndex);
+      ShaderParam::ParamType type = param.Type();
 
       std::string baseName = value;
       std::string dirPath = value;
@@ -723,11 +864,11 @@ void Ogre2Material::UpdateShaderParams(ConstShaderParamsPtr _params,
       // get the material and create the texture unit state it does not exist
       auto mat = this->Material();
       auto pass = mat->getTechnique(0u)->getPass(0);
-      auto texUnit = pass->getTextureUnitState(name_param.first);
+      auto texUnit = pass->getTextureUnitState(name);
       if (!texUnit)
       {
         texUnit = pass->createTextureUnitState();
-        texUnit->setName(name_param.first);
+        texUnit->setName(name);
       }
       // make sure to cast to int before calling setNamedConstant later
       // to set the texture index
@@ -756,11 +897,12 @@ void Ogre2Material::UpdateShaderParams(ConstShaderParamsPtr _params,
       else
       {
         ignerr << "Unrecognized texture type set for shader param: "
-               << name_param.first << std::endl;
+               << name << std::endl;
         continue;
       }
       // set the texture map index
-      _ogreParams->setNamedConstant(name_param.first, &texIndex, 1, 1);
+      _ogreParams->_writeRawConstants(constantDef->physicalIndex, &texIndex,
+          1u);
     }
   }
 }
@@ -789,6 +931,7 @@ Ogre::HlmsPbsDatablock *Ogre2Material::Datablock() const
 void Ogre2Material::SetTextureMapImpl(const std::string &_texture,
   Ogre::PbsTextureTypes _type)
 {
+  this->UnshareDatablock();
   // FIXME(anyone) need to keep baseName = _texture for all meshes. Refer to
   // https://github.com/ignitionrobotics/ign-rendering/issues/139
   // for more details
@@ -830,9 +973,41 @@ void Ogre2Material::SetTextureMapImpl(const std::string &_texture,
   Ogre::TextureGpuManager *textureMgr =
       root->getRenderSystem()->getTextureGpuManager();
 
+  // load a block compressed copy of the texture, converted on first use
+  bool compressed = false;
+  std::string cachePath = this->scene->TextureCachePath();
+  if (!cachePath.empty())
+  {
+    std::string cacheFile = CompressedTexture(_texture, cachePath, _type,
+        this->ogreDatablock->suggestUsingSRGB(_type),
+        this->scene->TextureResolutionCap());
+    if (!cacheFile.empty())
+    {
+      std::string dirPath = common::parentPath(cacheFile);
+      if (!Ogre::ResourceGroupManager::getSingleton().resourceLocationExists(
+          dirPath))
+      {
+        Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
+            dirPath, "FileSystem", "General");
+      }
+      baseName = common::basename(cacheFile);
+      compressed = true;
+    }
+  }
+  if (compressed)
+  {
+    this->dataPtr->cachedTextures[_type] = {_texture, baseName};
+    this->scene->RegisterCachedTextures(this);
+  }
+  else
+  {
+    this->dataPtr->cachedTextures.erase(_type);
+  }
+
   // workaround for grayscale emissive texture
-  // convert to RGB otherwise the emissive map is rendered red
-  if (_type == Ogre::PBSM_EMISSIVE &&
+  // convert to RGB otherwise the emissive map is rendered red. Compressed
+  // textures are always RGB.
+  if (!compressed && _type == Ogre::PBSM_EMISSIVE &&
       !this->ogreDatablock->getUseEmissiveAsLightmap())
   {
     common::Image img(_texture);
@@ -852,19 +1027,13 @@ void Ogre2Material::SetTextureMapImpl(const std::string &_texture,
         unsigned int channels = 4u;
         unsigned int size = img.Width() * img.Height() * channels;
         unsigned char *data = new unsigned char[size];
-        for (unsigned int i = 0; i < img.Height(); ++i)
-        {
-          for (unsigned int j = 0; j < img.Width(); ++j)
-          {
-            // flip Y
-            math::Color c = img.Pixel(j, img.Height() - i - 1u);
-            unsigned int idx = i * img.Width() * channels + j * channels;
-            data[idx] = static_cast<uint8_t>(c.R() * 255u);
-            data[idx + 1u] = static_cast<uint8_t>(c.R() * 255u);
-            data[idx + 2u] = static_cast<uint8_t>(c.R() * 255u);
-            data[idx + 3u] = 255u;
-          }
-        }
+        // the image data is stored top down, so it needs no flip
+        unsigned char *grayData = nullptr;
+        unsigned int grayCount = 0u;
+        img.Data(&grayData, grayCount);
+        PixelUtil::Convert(grayData, PF_L8, data, PF_R8G8B8A8, img.Width(),
+            img.Height(), grayCount / img.Height());
+        delete [] grayData;
 
         // create the gpu texture
         Ogre::uint32 textureFlags = 0;
@@ -902,43 +1071,155 @@ void Ogre2Material::SetTextureMapImpl(const std::string &_texture,
 
   this->ogreDatablock->setTexture(_type, baseName, &samplerBlockRef);
   auto tex = textureMgr->findTextureNoThrow(baseName);
+  if (!tex)
+    return;
 
-  if (tex)
+  // let the texture streaming worker thread load the texture and apply the
+  // texture dependent settings once it is resident
+  if (this->scene->AsyncTextureLoading())
   {
-    tex->waitForMetadata();
-    this->dataPtr->hashName = tex->getName().getFriendlyText();
+    tex->scheduleTransitionTo(Ogre::GpuResidency::Resident);
+    this->dataPtr->pendingTextures[_type] = baseName;
+    this->scene->RegisterPendingTextures(this);
+    return;
   }
 
+  tex->waitForMetadata();
+  this->ApplyTextureMapSettings(tex, _type);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Material::ApplyTextureMapSettings(Ogre::TextureGpu *_texture,
+    Ogre::PbsTextureTypes _type)
+{
+  this->UnshareDatablock();
+  this->dataPtr->hashName = _texture->getName().getFriendlyText();
+
   // disable alpha from texture if texture does not have an alpha channel
   // otherwise this becomes a transparent material
   if (_type == Ogre::PBSM_DIFFUSE)
   {
     bool isGrayscale = (Ogre::PixelFormatGpuUtils::getNumberOfComponents(
-            tex->getPixelFormat()) == 1u);
+            _texture->getPixelFormat()) == 1u);
 
     if (this->TextureAlphaEnabled() || isGrayscale)
     {
-      if (tex)
+      _texture->scheduleTransitionTo(Ogre::GpuResidency::Resident);
+      _texture->waitForData();
+
+      // only enable alpha from texture if texture has alpha component
+      if (this->TextureAlphaEnabled() &&
+          !Ogre::PixelFormatGpuUtils::hasAlpha(_texture->getPixelFormat()))
       {
-        tex->scheduleTransitionTo(Ogre::GpuResidency::Resident);
-        tex->waitForData();
+        this->SetAlphaFromTexture(false, this->AlphaThreshold(),
+            this->TwoSidedEnabled());
+      }
 
-        // only enable alpha from texture if texture has alpha component
-        if (this->TextureAlphaEnabled() &&
-            !Ogre::PixelFormatGpuUtils::hasAlpha(tex->getPixelFormat()))
-        {
-          this->SetAlphaFromTexture(false, this->AlphaThreshold(),
-              this->TwoSidedEnabled());
-        }
+      // treat grayscale texture as RGB
+      if (isGrayscale)
+      {
+        this->ogreDatablock->setUseDiffuseMapAsGrayscale(true);
+      }
+    }
+  }
+}
 
-        // treat grayscale texture as RGB
-        if (isGrayscale)
-        {
-          this->ogreDatablock->setUseDiffuseMapAsGrayscale(true);
-        }
+//////////////////////////////////////////////////
+bool Ogre2Material::UpdatePendingTextures()
+{
+  if (!this->ogreDatablock)
+  {
+    this->dataPtr->pendingTextures.clear();
+    return false;
+  }
+
+  Ogre::Root *root = Ogre2RenderEngine::Instance()->OgreRoot();
+  Ogre::TextureGpuManager *textureMgr =
+      root->getRenderSystem()->getTextureGpuManager();
+
+  auto &pending = this->dataPtr->pendingTextures;
+  for (auto it = pending.begin(); it != pending.end();)
+  {
+    Ogre::TextureGpu *tex = textureMgr->findTextureNoThrow(it->second);
+
+    // drop texture maps that were cleared or replaced in the meantime
+    if (!tex || this->ogreDatablock->getTexture(it->first) != tex)
+    {
+      it = pending.erase(it);
+      continue;
+    }
+
+    if (!tex->isDataReady())
+    {
+      ++it;
+      continue;
+    }
+
+    this->ApplyTextureMapSettings(tex, it->first);
+    it = pending.erase(it);
+  }
+
+  return !pending.empty();
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Material::UpdateCachedTextures(unsigned int _maxResolution,
+    std::unordered_set<std::string> &_replaced,
+    std::unordered_set<std::string> &_used)
+{
+  if (!this->ogreDatablock)
+  {
+    this->dataPtr->cachedTextures.clear();
+    return false;
+  }
+
+  Ogre::Root *root = Ogre2RenderEngine::Instance()->OgreRoot();
+  Ogre::TextureGpuManager *textureMgr =
+      root->getRenderSystem()->getTextureGpuManager();
+  std::string cachePath = this->scene->TextureCachePath();
+
+  auto &cached = this->dataPtr->cachedTextures;
+  for (auto it = cached.begin(); it != cached.end();)
+  {
+    Ogre::TextureGpu *current = this->ogreDatablock->getTexture(it->first);
+    std::string cacheFile;
+    if (current && !cachePath.empty())
+    {
+      cacheFile = CompressedTexture(it->second.first, cachePath, it->first,
+          this->ogreDatablock->suggestUsingSRGB(it->first), _maxResolution);
+    }
+    if (cacheFile.empty())
+    {
+      it = cached.erase(it);
+      continue;
+    }
+
+    std::string name = common::basename(cacheFile);
+    // the texture of a shared datablock may already be updated by another
+    // material, otherwise drop texture maps that were cleared or replaced
+    // in the meantime
+    if (current->getName() != Ogre::IdString(name))
+    {
+      if (current->getName() != Ogre::IdString(it->second.second))
+      {
+        it = cached.erase(it);
+        continue;
       }
+
+      // the datablock is updated in place so that materials sharing it
+      // keep sharing it
+      this->ogreDatablock->setTexture(it->first, name);
+      _replaced.insert(it->second.second);
+      Ogre::TextureGpu *tex = textureMgr->findTextureNoThrow(name);
+      if (tex)
+        tex->scheduleTransitionTo(Ogre::GpuResidency::Resident);
     }
+    it->second.second = name;
+    _used.insert(name);
+    ++it;
   }
+
+  return !cached.empty();
 }
 
 //////////////////////////////////////////////////////
@@ -973,6 +1254,7 @@ void Ogre2Material::Init()
       this->ogreHlmsPbs->createDatablock(
       this->ogreDatablockId, this->name,
       Ogre::HlmsMacroblock(), Ogre::HlmsBlendblock(), Ogre::HlmsParamVec()));
+  SetDatablockObjectId(this->ogreDatablock);
 
   // use metal workflow as default
   this->ogreDatablock->setWorkflow(Ogre::HlmsPbsDatablock::MetallicWorkflow);
@@ -996,6 +1278,7 @@ bool Ogre2Material::DepthCheckEnabled() const
 //////////////////////////////////////////////////
 void Ogre2Material::SetDepthCheckEnabled(bool _enabled)
 {
+  this->UnshareDatablock();
   Ogre::HlmsMacroblock macroblock(
       *this->ogreDatablock->getMacroblock());
   macroblock.mDepthCheck = _enabled;
@@ -1012,6 +1295,7 @@ bool Ogre2Material::DepthWriteEnabled() const
 //////////////////////////////////////////////////
 void Ogre2Material::SetDepthWriteEnabled(bool _enabled)
 {
+  this->UnshareDatablock();
   Ogre::HlmsMacroblock macroblock(
       *this->ogreDatablock->getMacroblock());
   macroblock.mDepthWrite = _enabled;
@@ -1118,6 +1402,7 @@ void Ogre2Material::SetVertexShader(const std::string &_path)
 
   this->dataPtr->vertexShaderPath = _path;
   this->dataPtr->vertexShaderParams.reset(new ShaderParams);
+  this->dataPtr->constantDefs.clear();
 }
 
 //////////////////////////////////////////////////
@@ -1168,6 +1453,7 @@ void Ogre2Material::SetFragmentShader(const std::string &_path)
   mat->load();
   this->dataPtr->fragmentShaderPath = _path;
   this->dataPtr->fragmentShaderParams.reset(new ShaderParams);
+  this->dataPtr->constantDefs.clear();
 }
 
 //////////////////////////////////////////////////
@@ -0,0 +1,558 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "Ogre2MaterialOverride.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <CommandBuffer/OgreCbShaderBuffer.h>
+#include <CommandBuffer/OgreCommandBuffer.h>
+#include <Compositor/Pass/OgreCompositorPass.h>
+#include <Compositor/Pass/OgreCompositorPassDef.h>
+#include <OgreHlms.h>
+#include <OgreRenderable.h>
+#include <OgreSceneManager.h>
+#include <Vao/OgreConstBufferPacked.h>
+#include <Vao/OgreVaoManager.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+#include "Ogre2ObjectId.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Const buffer slot of the override values, after the slots 0 to 3
+/// used by Pbs and Unlit. Must match IgnMaterialOverride_piece_ps.any
+static constexpr size_t kOverrideBufferSlot = 4u;
+
+/// \brief Const buffer slot of the instance colors, after the override
+/// values. Must match IgnInstanceColor_piece_ps.any
+static constexpr size_t kInstanceColorBufferSlot = 5u;
+
+/// \brief Draws per const buffer of the hlms, which is the size of the
+/// arrays in IgnMaterialOverride_piece_ps.any and
+/// IgnInstanceColor_piece_ps.any
+static constexpr size_t kOverrideMaxDraws = 4096u;
+
+/// \brief Size in bytes of an override buffer, one float4 per draw
+static constexpr size_t kOverrideBufferSize =
+    kOverrideMaxDraws * 4u * sizeof(float);
+
+/// \brief Forwards the pass callbacks of an hlms to its listener and
+/// enables the override pieces in the scene passes that override materials,
+/// or the object id pieces in the scene passes that write object ids
+class Ogre2MaterialOverride::HlmsListener final : public Ogre::HlmsListener
+{
+  /// \brief Constructor
+  /// \param[in] _override Material override that selects the pieces
+  public: explicit HlmsListener(const Ogre2MaterialOverride &_override)
+          : materialOverride(_override)
+  {
+  }
+
+  // Documentation inherited.
+  public: virtual void shaderCacheEntryCreated(
+              const Ogre::String &_shaderProfile,
+              const Ogre::HlmsCache *_hlmsCacheEntry,
+              const Ogre::HlmsCache &_passCache,
+              const Ogre::HlmsPropertyVec &_properties,
+              const Ogre::QueuedRenderable &_queuedRenderable) override
+  {
+    if (this->listener)
+    {
+      this->listener->shaderCacheEntryCreated(_shaderProfile,
+          _hlmsCacheEntry, _passCache, _properties, _queuedRenderable);
+    }
+  }
+
+  // Documentation inherited.
+  public: virtual void preparePassHash(
+              const Ogre::CompositorShadowNode *_shadowNode,
+              bool _casterPass, bool _dualParaboloid,
+              Ogre::SceneManager *_sceneManager, Ogre::Hlms *_hlms) override
+  {
+    if (this->listener)
+    {
+      this->listener->preparePassHash(_shadowNode, _casterPass,
+          _dualParaboloid, _sceneManager, _hlms);
+    }
+
+    if (_casterPass)
+      return;
+
+    // a pass either overrides materials or writes object ids, both use the
+    // second color attachment
+    Ogre2MaterialOverrideMode mode = this->materialOverride.Mode();
+    if (mode == Ogre2MaterialOverrideMode::NONE)
+    {
+      const Ogre::CompositorPass *pass =
+          _sceneManager->getCurrentCompositorPass();
+      if (pass &&
+          pass->getDefinition()->mIdentifier == kObjectIdPassIdentifier)
+      {
+        _hlms->_setProperty("ign_object_id", 1);
+      }
+      return;
+    }
+
+    _hlms->_setProperty("ign_material_override", 1);
+    if (mode == Ogre2MaterialOverrideMode::LABEL)
+      _hlms->_setProperty("ign_material_override_label", 1);
+    else if (mode == Ogre2MaterialOverrideMode::THERMAL)
+      _hlms->_setProperty("ign_material_override_thermal", 1);
+  }
+
+  // Documentation inherited.
+  public: virtual Ogre::uint32 getPassBufferSize(
+              const Ogre::CompositorShadowNode *_shadowNode,
+              bool _casterPass, bool _dualParaboloid,
+              Ogre::SceneManager *_sceneManager) const override
+  {
+    if (!this->listener)
+      return 0u;
+    return this->listener->getPassBufferSize(_shadowNode, _casterPass,
+        _dualParaboloid, _sceneManager);
+  }
+
+  // Documentation inherited.
+  public: virtual float *preparePassBuffer(
+              const Ogre::CompositorShadowNode *_shadowNode,
+              bool _casterPass, bool _dualParaboloid,
+              Ogre::SceneManager *_sceneManager,
+              float *_passBufferPtr) override
+  {
+    if (!this->listener)
+      return _passBufferPtr;
+    return this->listener->preparePassBuffer(_shadowNode, _casterPass,
+        _dualParaboloid, _sceneManager, _passBufferPtr);
+  }
+
+  // Documentation inherited.
+  public: virtual void hlmsTypeChanged(bool _casterPass,
+              Ogre::CommandBuffer *_commandBuffer,
+              const Ogre::HlmsDatablock *_datablock) override
+  {
+    if (this->listener)
+      this->listener->hlmsTypeChanged(_casterPass, _commandBuffer, _datablock);
+  }
+
+  /// \brief Listener the callbacks are forwarded to
+  public: Ogre::HlmsListener *listener = nullptr;
+
+  /// \brief Material override that selects the pieces
+  private: const Ogre2MaterialOverride &materialOverride;
+};
+
+//////////////////////////////////////////////////
+Ogre2MaterialOverride::Ogre2MaterialOverride()
+  : pbsListener(new HlmsListener(*this)),
+    unlitListener(new HlmsListener(*this)),
+    terraListener(new HlmsListener(*this))
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2MaterialOverride::~Ogre2MaterialOverride() = default;
+
+//////////////////////////////////////////////////
+size_t Ogre2MaterialOverride::NewParameterIndex()
+{
+  // the low level sensor materials read indices below 16
+  static std::atomic<size_t> nextIndex{16u};
+  return nextIndex++;
+}
+
+//////////////////////////////////////////////////
+size_t Ogre2MaterialOverride::InstanceColorParameterIndex()
+{
+  static const size_t index = NewParameterIndex();
+  return index;
+}
+
+//////////////////////////////////////////////////
+float Ogre2MaterialOverride::PackLabel(const Ogre::Vector4 &_label)
+{
+  auto channel = [](Ogre::Real _value)
+  {
+    return static_cast<uint32_t>(
+        std::lround(std::clamp(_value, Ogre::Real(0), Ogre::Real(1)) * 255));
+  };
+
+  // 24 bits are exactly representable by a float
+  return static_cast<float>(channel(_label.x) |
+      (channel(_label.y) << 8u) | (channel(_label.z) << 16u));
+}
+
+//////////////////////////////////////////////////
+void Ogre2MaterialOverride::Begin(Ogre2MaterialOverrideMode _mode,
+    size_t _parameterIndex, const Ogre::Vector4 &_defaultValue)
+{
+  this->mode = _mode;
+  this->parameterIndex = _parameterIndex;
+  this->defaultValue = _defaultValue;
+}
+
+//////////////////////////////////////////////////
+void Ogre2MaterialOverride::End()
+{
+  this->mode = Ogre2MaterialOverrideMode::NONE;
+}
+
+//////////////////////////////////////////////////
+Ogre2MaterialOverrideMode Ogre2MaterialOverride::Mode() const
+{
+  return this->mode;
+}
+
+//////////////////////////////////////////////////
+const Ogre::Vector4 &Ogre2MaterialOverride::Value(
+    const Ogre::Renderable *_renderable) const
+{
+  if (_renderable->hasCustomParameter(this->parameterIndex))
+    return _renderable->getCustomParameter(this->parameterIndex);
+  return this->defaultValue;
+}
+
+//////////////////////////////////////////////////
+Ogre::HlmsListener *Ogre2MaterialOverride::Listener(Ogre::HlmsTypes _type)
+{
+  if (_type == Ogre::HLMS_PBS)
+    return this->pbsListener.get();
+  if (_type == Ogre::HLMS_UNLIT)
+    return this->unlitListener.get();
+  if (_type == Ogre::HLMS_USER3)
+    return this->terraListener.get();
+  return nullptr;
+}
+
+//////////////////////////////////////////////////
+void Ogre2MaterialOverride::SetListener(Ogre::HlmsTypes _type,
+    Ogre::HlmsListener *_listener)
+{
+  if (_type == Ogre::HLMS_PBS)
+    this->pbsListener->listener = _listener;
+  else if (_type == Ogre::HLMS_UNLIT)
+    this->unlitListener->listener = _listener;
+  else if (_type == Ogre::HLMS_USER3)
+    this->terraListener->listener = _listener;
+}
+
+//////////////////////////////////////////////////
+Ogre::HlmsListener *Ogre2MaterialOverride::ForwardedListener(
+    Ogre::HlmsTypes _type) const
+{
+  if (_type == Ogre::HLMS_PBS)
+    return this->pbsListener->listener;
+  if (_type == Ogre::HLMS_UNLIT)
+    return this->unlitListener->listener;
+  if (_type == Ogre::HLMS_USER3)
+    return this->terraListener->listener;
+  return nullptr;
+}
+
+//////////////////////////////////////////////////
+Ogre2MaterialOverrideBuffer::Ogre2MaterialOverrideBuffer(size_t _slot)
+  : slot(_slot)
+{
+}
+
+//////////////////////////////////////////////////
+void Ogre2MaterialOverrideBuffer::Write(const Ogre::Vector4 *_value,
+    Ogre::uint32 _drawId, const void *_constBuffer, bool _typeChanged,
+    Ogre::CommandBuffer *_commandBuffer, Ogre::VaoManager *_vaoManager)
+{
+  // another hlms may have bound its own buffer to the slot
+  this->bind = this->bind || _typeChanged;
+  if (!_value)
+    return;
+
+  // draw ids restart when the hlms maps its next const buffer, the values
+  // of the following draws go to the next override buffer
+  if (!this->mapped || _constBuffer != this->constBuffer)
+  {
+    this->Unmap();
+    if (this->current >= this->buffers.size())
+    {
+      this->buffers.push_back(_vaoManager->createConstBuffer(
+          kOverrideBufferSize, Ogre::BT_DYNAMIC_PERSISTENT, nullptr, false));
+    }
+    this->mapped = static_cast<float *>(
+        this->buffers[this->current]->map(0u, kOverrideBufferSize));
+    this->constBuffer = _constBuffer;
+    this->bind = true;
+  }
+
+  if (this->bind)
+  {
+    *_commandBuffer->addCommand<Ogre::CbShaderBuffer>() =
+        Ogre::CbShaderBuffer(Ogre::PixelShader,
+        static_cast<Ogre::uint16>(this->slot),
+        this->buffers[this->current], 0u, 0u);
+    this->bind = false;
+  }
+
+  if (_drawId >= kOverrideMaxDraws)
+    return;
+
+  float *dst = this->mapped + _drawId * 4u;
+  dst[0] = static_cast<float>(_value->x);
+  dst[1] = static_cast<float>(_value->y);
+  dst[2] = static_cast<float>(_value->z);
+  dst[3] = static_cast<float>(_value->w);
+  this->drawCount = std::max<size_t>(this->drawCount, _drawId + 1u);
+}
+
+//////////////////////////////////////////////////
+void Ogre2MaterialOverrideBuffer::Unmap()
+{
+  if (!this->mapped)
+    return;
+
+  this->buffers[this->current]->unmap(Ogre::UO_KEEP_PERSISTENT, 0u,
+      this->drawCount * 4u * sizeof(float));
+  this->mapped = nullptr;
+  this->constBuffer = nullptr;
+  this->drawCount = 0u;
+  this->bind = true;
+  ++this->current;
+}
+
+//////////////////////////////////////////////////
+void Ogre2MaterialOverrideBuffer::FrameEnded()
+{
+  this->current = 0u;
+  this->bind = true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2MaterialOverrideBuffer::Destroy(Ogre::VaoManager *_vaoManager)
+{
+  for (Ogre::ConstBufferPacked *buffer : this->buffers)
+  {
+    if (buffer->getMappingState() != Ogre::MS_UNMAPPED)
+      buffer->unmap(Ogre::UO_UNMAP_ALL);
+    _vaoManager->destroyConstBuffer(buffer);
+  }
+  this->buffers.clear();
+  this->mapped = nullptr;
+  this->constBuffer = nullptr;
+  this->drawCount = 0u;
+  this->current = 0u;
+  this->bind = true;
+}
+
+//////////////////////////////////////////////////
+Ogre2IgnHlmsPbs::Ogre2IgnHlmsPbs(Ogre::Archive *_dataFolder,
+    Ogre::ArchiveVec *_libraryFolders, const Ogre2MaterialOverride &_override)
+  : Ogre::HlmsPbs(_dataFolder, _libraryFolders),
+    materialOverride(_override),
+    overrideBuffer(kOverrideBufferSlot),
+    instanceColorBuffer(kInstanceColorBufferSlot)
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2IgnHlmsPbs::~Ogre2IgnHlmsPbs()
+{
+  if (this->mVaoManager)
+  {
+    this->overrideBuffer.Destroy(this->mVaoManager);
+    this->instanceColorBuffer.Destroy(this->mVaoManager);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2IgnHlmsPbs::_changeRenderSystem(Ogre::RenderSystem *_newRs)
+{
+  if (this->mVaoManager)
+  {
+    this->overrideBuffer.Destroy(this->mVaoManager);
+    this->instanceColorBuffer.Destroy(this->mVaoManager);
+  }
+  Ogre::HlmsPbs::_changeRenderSystem(_newRs);
+}
+
+//////////////////////////////////////////////////
+Ogre::uint32 Ogre2IgnHlmsPbs::fillBuffersForV1(const Ogre::HlmsCache *_cache,
+    const Ogre::QueuedRenderable &_queuedRenderable, bool _casterPass,
+    Ogre::uint32 _lastCacheHash, Ogre::CommandBuffer *_commandBuffer)
+{
+  Ogre::uint32 drawId = Ogre::HlmsPbs::fillBuffersForV1(_cache,
+      _queuedRenderable, _casterPass, _lastCacheHash, _commandBuffer);
+  return this->WriteOverride(_queuedRenderable, _casterPass, _lastCacheHash,
+      drawId, _commandBuffer);
+}
+
+//////////////////////////////////////////////////
+Ogre::uint32 Ogre2IgnHlmsPbs::fillBuffersForV2(const Ogre::HlmsCache *_cache,
+    const Ogre::QueuedRenderable &_queuedRenderable, bool _casterPass,
+    Ogre::uint32 _lastCacheHash, Ogre::CommandBuffer *_commandBuffer)
+{
+  Ogre::uint32 drawId = Ogre::HlmsPbs::fillBuffersForV2(_cache,
+      _queuedRenderable, _casterPass, _lastCacheHash, _commandBuffer);
+  return this->WriteOverride(_queuedRenderable, _casterPass, _lastCacheHash,
+      drawId, _commandBuffer);
+}
+
+//////////////////////////////////////////////////
+void Ogre2IgnHlmsPbs::preCommandBufferExecution(
+    Ogre::CommandBuffer *_commandBuffer)
+{
+  this->overrideBuffer.Unmap();
+  this->instanceColorBuffer.Unmap();
+  Ogre::HlmsPbs::preCommandBufferExecution(_commandBuffer);
+}
+
+//////////////////////////////////////////////////
+void Ogre2IgnHlmsPbs::frameEnded()
+{
+  Ogre::HlmsPbs::frameEnded();
+  this->overrideBuffer.FrameEnded();
+  this->instanceColorBuffer.FrameEnded();
+}
+
+//////////////////////////////////////////////////
+void Ogre2IgnHlmsPbs::calculateHashForPreCreate(Ogre::Renderable *_renderable,
+    Ogre::PiecesMap *_inOutPieces)
+{
+  Ogre::HlmsPbs::calculateHashForPreCreate(_renderable, _inOutPieces);
+
+  if (_renderable->hasCustomParameter(
+      Ogre2MaterialOverride::InstanceColorParameterIndex()))
+  {
+    this->setProperty("ign_instance_color", 1);
+  }
+}
+
+//////////////////////////////////////////////////
+Ogre::uint32 Ogre2IgnHlmsPbs::WriteOverride(
+    const Ogre::QueuedRenderable &_queuedRenderable, bool _casterPass,
+    Ogre::uint32 _lastCacheHash, Ogre::uint32 _drawId,
+    Ogre::CommandBuffer *_commandBuffer)
+{
+  if (_casterPass)
+    return _drawId;
+
+  const Ogre::Renderable *renderable = _queuedRenderable.renderable;
+  const bool typeChanged =
+      OGRE_EXTRACT_HLMS_TYPE_FROM_CACHE_HASH(_lastCacheHash) != this->mType;
+
+  const Ogre::Vector4 *value = nullptr;
+  if (this->materialOverride.Mode() != Ogre2MaterialOverrideMode::NONE)
+    value = &this->materialOverride.Value(renderable);
+  this->overrideBuffer.Write(value, _drawId, this->mStartMappedConstBuffer,
+      typeChanged, _commandBuffer, this->mVaoManager);
+
+  const size_t colorIndex =
+      Ogre2MaterialOverride::InstanceColorParameterIndex();
+  const Ogre::Vector4 *color = nullptr;
+  if (renderable->hasCustomParameter(colorIndex))
+    color = &renderable->getCustomParameter(colorIndex);
+  this->instanceColorBuffer.Write(color, _drawId,
+      this->mStartMappedConstBuffer, typeChanged, _commandBuffer,
+      this->mVaoManager);
+  return _drawId;
+}
+
+//////////////////////////////////////////////////
+Ogre2IgnHlmsUnlit::Ogre2IgnHlmsUnlit(Ogre::Archive *_dataFolder,
+    Ogre::ArchiveVec *_libraryFolders, const Ogre2MaterialOverride &_override)
+  : Ogre::HlmsUnlit(_dataFolder, _libraryFolders),
+    materialOverride(_override),
+    overrideBuffer(kOverrideBufferSlot)
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2IgnHlmsUnlit::~Ogre2IgnHlmsUnlit()
+{
+  if (this->mVaoManager)
+    this->overrideBuffer.Destroy(this->mVaoManager);
+}
+
+//////////////////////////////////////////////////
+void Ogre2IgnHlmsUnlit::_changeRenderSystem(Ogre::RenderSystem *_newRs)
+{
+  if (this->mVaoManager)
+    this->overrideBuffer.Destroy(this->mVaoManager);
+  Ogre::HlmsUnlit::_changeRenderSystem(_newRs);
+}
+
+//////////////////////////////////////////////////
+Ogre::uint32 Ogre2IgnHlmsUnlit::fillBuffersForV1(
+    const Ogre::HlmsCache *_cache,
+    const Ogre::QueuedRenderable &_queuedRenderable, bool _casterPass,
+    Ogre::uint32 _lastCacheHash, Ogre::CommandBuffer *_commandBuffer)
+{
+  Ogre::uint32 drawId = Ogre::HlmsUnlit::fillBuffersForV1(_cache,
+      _queuedRenderable, _casterPass, _lastCacheHash, _commandBuffer);
+  return this->WriteOverride(_queuedRenderable, _casterPass, _lastCacheHash,
+      drawId, _commandBuffer);
+}
+
+//////////////////////////////////////////////////
+Ogre::uint32 Ogre2IgnHlmsUnlit::fillBuffersForV2(
+    const Ogre::HlmsCache *_cache,
+    const Ogre::QueuedRenderable &_queuedRenderable, bool _casterPass,
+    Ogre::uint32 _lastCacheHash, Ogre::CommandBuffer *_commandBuffer)
+{
+  Ogre::uint32 drawId = Ogre::HlmsUnlit::fillBuffersForV2(_cache,
+      _queuedRenderable, _casterPass, _lastCacheHash, _commandBuffer);
+  return this->WriteOverride(_queuedRenderable, _casterPass, _lastCacheHash,
+      drawId, _commandBuffer);
+}
+
+//////////////////////////////////////////////////
+void Ogre2IgnHlmsUnlit::preCommandBufferExecution(
+    Ogre::CommandBuffer *_commandBuffer)
+{
+  this->overrideBuffer.Unmap();
+  Ogre::HlmsUnlit::preCommandBufferExecution(_commandBuffer);
+}
+
+//////////////////////////////////////////////////
+void Ogre2IgnHlmsUnlit::frameEnded()
+{
+  Ogre::HlmsUnlit::frameEnded();
+  this->overrideBuffer.FrameEnded();
+}
+
+//////////////////////////////////////////////////
+Ogre::uint32 Ogre2IgnHlmsUnlit::WriteOverride(
+    const Ogre::QueuedRenderable &_queuedRenderable, bool _casterPass,
+    Ogre::uint32 _lastCacheHash, Ogre::uint32 _drawId,
+    Ogre::CommandBuffer *_commandBuffer)
+{
+  if (_casterPass)
+    return _drawId;
+
+  const Ogre::Vector4 *value = nullptr;
+  if (this->materialOverride.Mode() != Ogre2MaterialOverrideMode::NONE)
+    value = &this->materialOverride.Value(_queuedRenderable.renderable);
+  this->overrideBuffer.Write(value, _drawId, this->mStartMappedConstBuffer,
+      OGRE_EXTRACT_HLMS_TYPE_FROM_CACHE_HASH(_lastCacheHash) != this->mType,
+      _commandBuffer, this->mVaoManager);
+  return _drawId;
+}
@@ -0,0 +1,374 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2MATERIALOVERRIDE_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2MATERIALOVERRIDE_HH_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/ogre2/Export.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Hlms/Pbs/OgreHlmsPbs.h>
+#include <Hlms/Unlit/OgreHlmsUnlit.h>
+#include <OgreHlmsListener.h>
+#include <OgreVector4.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief How the Pbs and Unlit hlms draw the items of a scene pass,
+    /// see Ogre2MaterialOverride
+    enum class Ogre2MaterialOverrideMode
+    {
+      /// \brief Items are drawn with their own materials
+      NONE,
+
+      /// \brief Items are drawn with the value of their custom parameter as
+      /// a solid color
+      SOLID,
+
+      /// \brief Same as SOLID with an opaque color, and the label packed in
+      /// the w component of the value, see Ogre2MaterialOverride::PackLabel,
+      /// is written to a second render target. Only supported with OpenGL.
+      LABEL,
+
+      /// \brief Items are drawn with the value of their custom parameter if
+      /// its w component is not negative, and with their unlit color
+      /// otherwise
+      THERMAL
+    };
+
+    /// \brief Draws the items of a scene pass with per item values instead
+    /// of their materials, for sensors that render ids, labels or
+    /// temperatures rather than colors.
+    ///
+    /// Each source of per item values reserves a custom parameter index
+    /// with NewParameterIndex and stores the value of each sub item with
+    /// Ogre::Renderable::setCustomParameter once, and again only when it
+    /// changes. A sensor selects the mode and the parameter of its scene
+    /// pass by calling Begin before the pass and End after it. The Pbs and
+    /// Unlit hlms then write the parameter of each draw to a buffer that
+    /// their pixel shaders read, see
+    /// media/Hlms/Ignition/IgnMaterialOverride_piece_ps.any, so items keep
+    /// their datablocks and the pass does not visit them.
+    ///
+    /// Draws without the parameter use the default value of the pass.
+    /// Sub items with low level materials, see Ogre2Scene::LowLevelSubItems,
+    /// are not drawn by these hlms and still have to be switched to a low
+    /// level material by the sensor.
+    ///
+    /// \internal
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2MaterialOverride
+    {
+      /// \brief Constructor
+      public: Ogre2MaterialOverride();
+
+      /// \brief Destructor
+      public: ~Ogre2MaterialOverride();
+
+      /// \brief Reserve a custom parameter index for a source of per item
+      /// values. Indices are never reused and do not collide with the ones
+      /// the low level sensor materials read.
+      /// \return Custom parameter index
+      public: static size_t NewParameterIndex();
+
+      /// \brief Get the custom parameter holding the diffuse color of an
+      /// instance of an instanced visual. Pbs draws of sub items with this
+      /// parameter take their diffuse color from it if its w component is
+      /// positive, see media/Hlms/Ignition/IgnInstanceColor_piece_ps.any,
+      /// so instances of different colors share a datablock and are still
+      /// drawn with hardware instancing. The parameter must be set before
+      /// the datablock, since it selects the shader.
+      /// \return Custom parameter index
+      public: static size_t InstanceColorParameterIndex();
+
+      /// \brief Pack a label encoded as a color, e.g. the label of a
+      /// segmentation camera, in a float that keeps all its bits
+      /// \param[in] _label Label with 8 bit components in [0, 1]
+      /// \return Label to store in the w component of a LABEL value
+      public: static float PackLabel(const Ogre::Vector4 &_label);
+
+      /// \brief Override the materials of the scene passes rendered until
+      /// End is called
+      /// \param[in] _mode Override mode
+      /// \param[in] _parameterIndex Custom parameter holding the value of
+      /// each sub item
+      /// \param[in] _defaultValue Value of the draws without the parameter
+      public: void Begin(Ogre2MaterialOverrideMode _mode,
+                  size_t _parameterIndex, const Ogre::Vector4 &_defaultValue);
+
+      /// \brief Stop overriding materials
+      public: void End();
+
+      /// \brief Get the override mode of the current scene pass
+      /// \return Override mode, NONE outside of Begin and End
+      public: Ogre2MaterialOverrideMode Mode() const;
+
+      /// \brief Get the value a renderable is drawn with
+      /// \param[in] _renderable Renderable being drawn
+      /// \return Value of its custom parameter, or the default value
+      public: const Ogre::Vector4 &Value(
+                  const Ogre::Renderable *_renderable) const;
+
+      /// \brief Get the listener to set on an hlms. It enables the override
+      /// pieces, or the object id pieces in the scene passes identified by
+      /// kObjectIdPassIdentifier, and forwards to the listener set with
+      /// SetListener, since an hlms has a single listener.
+      /// \param[in] _type Ogre::HLMS_PBS, Ogre::HLMS_UNLIT or
+      /// Ogre::HLMS_USER3, the type of HlmsTerra
+      /// \return Coordinating listener of the hlms
+      public: Ogre::HlmsListener *Listener(Ogre::HlmsTypes _type);
+
+      /// \brief Set the listener an hlms forwards to, e.g. the terra
+      /// shadows of Pbs
+      /// \param[in] _type Ogre::HLMS_PBS, Ogre::HLMS_UNLIT or
+      /// Ogre::HLMS_USER3, the type of HlmsTerra
+      /// \param[in] _listener Listener to forward to, null for none
+      public: void SetListener(Ogre::HlmsTypes _type,
+                  Ogre::HlmsListener *_listener);
+
+      /// \brief Get the listener an hlms forwards to
+      /// \param[in] _type Ogre::HLMS_PBS, Ogre::HLMS_UNLIT or
+      /// Ogre::HLMS_USER3, the type of HlmsTerra
+      /// \return Listener set with SetListener
+      public: Ogre::HlmsListener *ForwardedListener(
+                  Ogre::HlmsTypes _type) const;
+
+      /// \brief Pass listener of one hlms
+      private: class HlmsListener;
+
+      /// \brief Override mode of the current scene pass
+      private: Ogre2MaterialOverrideMode mode =
+          Ogre2MaterialOverrideMode::NONE;
+
+      /// \brief Custom parameter of the current scene pass
+      private: size_t parameterIndex = 0u;
+
+      /// \brief Value of the draws without the custom parameter
+      private: Ogre::Vector4 defaultValue = Ogre::Vector4::ZERO;
+
+      /// \brief Listener of HlmsPbs
+      private: std::unique_ptr<HlmsListener> pbsListener;
+
+      /// \brief Listener of HlmsUnlit
+      private: std::unique_ptr<HlmsListener> unlitListener;
+
+      /// \brief Listener of HlmsTerra
+      private: std::unique_ptr<HlmsListener> terraListener;
+    };
+
+    /// \brief Per draw values of an hlms, written to a const buffer the
+    /// pixel shaders read by draw id
+    class Ogre2MaterialOverrideBuffer
+    {
+      /// \brief Constructor
+      /// \param[in] _slot Const buffer slot the pixel shaders read the
+      /// values from
+      public: explicit Ogre2MaterialOverrideBuffer(size_t _slot);
+
+      /// \brief Write the value of a draw. Called after the hlms filled
+      /// its own buffers for the draw, also for draws without a value so
+      /// the buffer is bound again after another hlms drew.
+      /// \param[in] _value Value of the draw, null if the draw does not
+      /// read the buffer
+      /// \param[in] _drawId Draw id returned by the hlms
+      /// \param[in] _constBuffer Start of the mapped const buffer of the
+      /// hlms. Draw ids restart when it changes.
+      /// \param[in] _typeChanged True if the previous draw was made by
+      /// another hlms, which may have bound its own buffer
+      /// \param[in] _commandBuffer Command buffer to add the binding to
+      /// \param[in] _vaoManager Manager to create the buffers with
+      public: void Write(const Ogre::Vector4 *_value, Ogre::uint32 _drawId,
+                  const void *_constBuffer, bool _typeChanged,
+                  Ogre::CommandBuffer *_commandBuffer,
+                  Ogre::VaoManager *_vaoManager);
+
+      /// \brief Unmap the current buffer before the commands are executed
+      public: void Unmap();
+
+      /// \brief Reuse the buffers from the start in the next frame
+      public: void FrameEnded();
+
+      /// \brief Destroy the buffers
+      /// \param[in] _vaoManager Manager the buffers were created with
+      public: void Destroy(Ogre::VaoManager *_vaoManager);
+
+      /// \brief Const buffer slot of the values
+      private: size_t slot;
+
+      /// \brief True if the current buffer has to be bound before the
+      /// next draw that reads it
+      private: bool bind = true;
+
+      /// \brief Buffers used in the current frame, one per const buffer of
+      /// the hlms
+      private: std::vector<Ogre::ConstBufferPacked *> buffers;
+
+      /// \brief Index of the current buffer
+      private: size_t current = 0u;
+
+      /// \brief Mapped memory of the current buffer, null if unmapped
+      private: float *mapped = nullptr;
+
+      /// \brief Number of draws written to the current buffer
+      private: size_t drawCount = 0u;
+
+      /// \brief Const buffer of the hlms the current buffer matches
+      private: const void *constBuffer = nullptr;
+    };
+
+    /// \brief HlmsPbs that writes the material override value and the
+    /// instance color of its draws
+    class Ogre2IgnHlmsPbs final : public Ogre::HlmsPbs
+    {
+      /// \brief Constructor
+      /// \param[in] _dataFolder Folder of the Pbs templates
+      /// \param[in] _libraryFolders Folders of the piece files
+      /// \param[in] _override Material override to take the values from
+      public: Ogre2IgnHlmsPbs(Ogre::Archive *_dataFolder,
+                  Ogre::ArchiveVec *_libraryFolders,
+                  const Ogre2MaterialOverride &_override);
+
+      /// \brief Destructor
+      public: virtual ~Ogre2IgnHlmsPbs();
+
+      // Documentation inherited.
+      public: virtual void _changeRenderSystem(
+                  Ogre::RenderSystem *_newRs) override;
+
+      // Documentation inherited.
+      public: virtual Ogre::uint32 fillBuffersForV1(
+                  const Ogre::HlmsCache *_cache,
+                  const Ogre::QueuedRenderable &_queuedRenderable,
+                  bool _casterPass, Ogre::uint32 _lastCacheHash,
+                  Ogre::CommandBuffer *_commandBuffer) override;
+
+      // Documentation inherited.
+      public: virtual Ogre::uint32 fillBuffersForV2(
+                  const Ogre::HlmsCache *_cache,
+                  const Ogre::QueuedRenderable &_queuedRenderable,
+                  bool _casterPass, Ogre::uint32 _lastCacheHash,
+                  Ogre::CommandBuffer *_commandBuffer) override;
+
+      // Documentation inherited.
+      public: virtual void preCommandBufferExecution(
+                  Ogre::CommandBuffer *_commandBuffer) override;
+
+      // Documentation inherited.
+      public: virtual void frameEnded() override;
+
+      // Documentation inherited.
+      protected: virtual void calculateHashForPreCreate(
+                  Ogre::Renderable *_renderable,
+                  Ogre::PiecesMap *_inOutPieces) override;
+
+      /// \brief Write the override value and the instance color of a draw
+      /// \param[in] _queuedRenderable Draw
+      /// \param[in] _casterPass True in shadow caster passes
+      /// \param[in] _lastCacheHash Cache hash of the previous draw
+      /// \param[in] _drawId Draw id returned by the base class
+      /// \param[in] _commandBuffer Command buffer of the pass
+      /// \return Draw id
+      private: Ogre::uint32 WriteOverride(
+                  const Ogre::QueuedRenderable &_queuedRenderable,
+                  bool _casterPass, Ogre::uint32 _lastCacheHash,
+                  Ogre::uint32 _drawId, Ogre::CommandBuffer *_commandBuffer);
+
+      /// \brief Material override to take the values from
+      private: const Ogre2MaterialOverride &materialOverride;
+
+      /// \brief Per draw override values
+      private: Ogre2MaterialOverrideBuffer overrideBuffer;
+
+      /// \brief Per draw instance colors
+      private: Ogre2MaterialOverrideBuffer instanceColorBuffer;
+    };
+
+    /// \brief HlmsUnlit that writes the material override value of its
+    /// draws
+    class Ogre2IgnHlmsUnlit final : public Ogre::HlmsUnlit
+    {
+      /// \brief Constructor
+      /// \param[in] _dataFolder Folder of the Unlit templates
+      /// \param[in] _libraryFolders Folders of the piece files
+      /// \param[in] _override Material override to take the values from
+      public: Ogre2IgnHlmsUnlit(Ogre::Archive *_dataFolder,
+                  Ogre::ArchiveVec *_libraryFolders,
+                  const Ogre2MaterialOverride &_override);
+
+      /// \brief Destructor
+      public: virtual ~Ogre2IgnHlmsUnlit();
+
+      // Documentation inherited.
+      public: virtual void _changeRenderSystem(
+                  Ogre::RenderSystem *_newRs) override;
+
+      // Documentation inherited.
+      public: virtual Ogre::uint32 fillBuffersForV1(
+                  const Ogre::HlmsCache *_cache,
+                  const Ogre::QueuedRenderable &_queuedRenderable,
+                  bool _casterPass, Ogre::uint32 _lastCacheHash,
+                  Ogre::CommandBuffer *_commandBuffer) override;
+
+      // Documentation inherited.
+      public: virtual Ogre::uint32 fillBuffersForV2(
+                  const Ogre::HlmsCache *_cache,
+                  const Ogre::QueuedRenderable &_queuedRenderable,
+                  bool _casterPass, Ogre::uint32 _lastCacheHash,
+                  Ogre::CommandBuffer *_commandBuffer) override;
+
+      // Documentation inherited.
+      public: virtual void preCommandBufferExecution(
+                  Ogre::CommandBuffer *_commandBuffer) override;
+
+      // Documentation inherited.
+      public: virtual void frameEnded() override;
+
+      /// \brief Write the override value of a draw
+      /// \param[in] _queuedRenderable Draw
+      /// \param[in] _casterPass True in shadow caster passes
+      /// \param[in] _lastCacheHash Cache hash of the previous draw
+      /// \param[in] _drawId Draw id returned by the base class
+      /// \param[in] _commandBuffer Command buffer of the pass
+      /// \return Draw id
+      private: Ogre::uint32 WriteOverride(
+                  const Ogre::QueuedRenderable &_queuedRenderable,
+                  bool _casterPass, Ogre::uint32 _lastCacheHash,
+                  Ogre::uint32 _drawId, Ogre::CommandBuffer *_commandBuffer);
+
+      /// \brief Material override to take the values from
+      private: const Ogre2MaterialOverride &materialOverride;
+
+      /// \brief Per draw override values
+      private: Ogre2MaterialOverrideBuffer overrideBuffer;
+    };
+    }
+  }
+}
+#endif
@@ -15,11 +15,18 @@
  *
 */
 
+#include <utility>
+
 #include "ignition/common/Console.hh"
+#include "ignition/common/Profiler.hh"
 #include "ignition/rendering/ogre2/Ogre2MaterialSwitcher.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
 #include "ignition/rendering/RenderTypes.hh"
 
+#include "Ogre2MaterialOverride.hh"
+#include "Ogre2VertexDeformation.hh"
+
 #ifdef _MSC_VER
   #pragma warning(push, 0)
 #endif
@@ -36,12 +43,6 @@ using namespace ignition;
 using namespace rendering;
 
 
-/// \brief A map of ogre sub item pointer to their original low level material
-/// \todo(anyone) Added here for ABI compatibity This can be removed once
-/// ign-rendering7 switches to Hlms customization for "switching" materials
-std::map<Ogre2MaterialSwitcher *,
-         std::map<Ogre::SubItem *, Ogre::MaterialPtr>> materialMap;
-
 /////////////////////////////////////////////////
 Ogre2MaterialSwitcher::Ogre2MaterialSwitcher(Ogre2ScenePtr _scene)
 {
@@ -56,22 +57,7 @@ Ogre2MaterialSwitcher::Ogre2MaterialSwitcher(Ogre2ScenePtr _scene)
   this->plainMaterial = res.staticCast<Ogre::Material>();
   this->plainMaterial->load();
 
-  // plain overlay material
-  this->plainOverlayMaterial =
-      this->plainMaterial->clone("plain_color_overlay");
-  if (!this->plainOverlayMaterial->getTechnique(0) ||
-      !this->plainOverlayMaterial->getTechnique(0)->getPass(0))
-  {
-    ignerr << "Problem creating selection buffer overlay material"
-        << std::endl;
-    return;
-  }
-  Ogre::Pass *overlayPass =
-      this->plainOverlayMaterial->getTechnique(0)->getPass(0);
-  Ogre::HlmsMacroblock macroblock(*overlayPass->getMacroblock());
-  macroblock.mDepthCheck = false;
-  macroblock.mDepthWrite = false;
-  overlayPass->setMacroblock(macroblock);
+  this->parameterIndex = Ogre2MaterialOverride::NewParameterIndex();
 }
 
 /////////////////////////////////////////////////
@@ -81,51 +67,33 @@ Ogre2MaterialSwitcher::~Ogre2MaterialSwitcher()
 
 ////////////////////////////////////////////////
 void Ogre2MaterialSwitcher::cameraPreRenderScene(
-    Ogre::Camera * /*_evt*/)
+    Ogre::Camera * /*_cam*/)
 {
-  // swap item to use v1 shader material
-  // Note: keep an eye out for performance impact on switching materials
-  // on the fly. We are not doing this often so should be ok.
-  auto itor = this->scene->OgreSceneManager()->getMovableObjectIterator(
-      Ogre::ItemFactory::FACTORY_TYPE_NAME);
-  while (itor.hasMoreElements())
+  IGN_PROFILE("Ogre2MaterialSwitcher::cameraPreRenderScene");
+  // the colors are stored on the sub items, so the items are only visited
+  // when the scene changes
+  if (!this->assigned ||
+      this->itemsRevision != this->scene->VisibilityLayersRevision())
   {
-    this->NextColor();
-
-    Ogre::MovableObject *object = itor.peekNext();
-    Ogre::Item *item = static_cast<Ogre::Item *>(object);
+    this->AssignColors();
+  }
 
-    this->colorDict[this->currentColor.AsRGBA()] = item->getName();
+  // the Pbs and Unlit hlms draw their items with their unique color.
+  // Items keep their macroblocks, so overlays are still drawn on top
+  auto engine = Ogre2RenderEngine::Instance();
+  engine->MaterialOverride().Begin(Ogre2MaterialOverrideMode::SOLID,
+      this->parameterIndex, Ogre::Vector4(0.0, 0.0, 0.0, 1.0));
 
-    for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
-    {
-      Ogre::SubItem *subItem = item->getSubItem(i);
-      subItem->setCustomParameter(1,
-          Ogre::Vector4(this->currentColor.R(), this->currentColor.G(),
-                        this->currentColor.B(), 1.0));
-
-      // case when item is using low level materials
-      // e.g. shaders
-      if (!subItem->getMaterial().isNull())
-      {
-        materialMap[this][subItem] = subItem->getMaterial();
-        subItem->setMaterial(this->plainMaterial);
-      }
-      // regular Pbs Hlms datablock
-      else
-      {
-        Ogre::HlmsDatablock *datablock = subItem->getDatablock();
-        this->datablockMap[subItem] = datablock;
-        // check if it's an overlay material by assuming the
-        // depth check and depth write properties are off.
-        if (!datablock->getMacroblock()->mDepthWrite &&
-            !datablock->getMacroblock()->mDepthCheck)
-          subItem->setMaterial(this->plainOverlayMaterial);
-        else
-          subItem->setMaterial(this->plainMaterial);
-      }
-    }
-    itor.moveNext();
+  // case when item is using low level materials, e.g. shaders, which those
+  // hlms don't draw. Vertices deformed by the shader are drawn deformed
+  for (Ogre::SubItem *subItem : this->scene->LowLevelSubItems())
+  {
+    if (!subItem->hasCustomParameter(this->parameterIndex))
+      continue;
+    subItem->setCustomParameter(1,
+        subItem->getCustomParameter(this->parameterIndex));
+    this->materialMap[subItem] = subItem->getMaterial();
+    subItem->setMaterial(DeformedMaterial(this->plainMaterial, subItem));
   }
 }
 
@@ -133,30 +101,48 @@ void Ogre2MaterialSwitcher::cameraPreRenderScene(
 void Ogre2MaterialSwitcher::cameraPostRenderScene(
     Ogre::Camera * /*_evt*/)
 {
-  // restore item to use hlms material
-  auto itor = this->scene->OgreSceneManager()->getMovableObjectIterator(
-      Ogre::ItemFactory::FACTORY_TYPE_NAME);
-  while (itor.hasMoreElements())
+  IGN_PROFILE("Ogre2MaterialSwitcher::cameraPostRenderScene");
+  Ogre2RenderEngine::Instance()->MaterialOverride().End();
+
+  // restore the low level materials, only the switched sub items are in
+  // the map
+  for (auto &it : this->materialMap)
+    it.first->setMaterial(it.second);
+  this->materialMap.clear();
+}
+
+/////////////////////////////////////////////////
+void Ogre2MaterialSwitcher::AssignColors()
+{
+  std::map<Ogre::Item *, unsigned int> colors;
+  this->colorDict.clear();
+  for (Ogre::Item *item : this->scene->VisibleItems(IGN_VISIBILITY_ALL))
   {
-    Ogre::MovableObject *object = itor.peekNext();
-    Ogre::Item *item = static_cast<Ogre::Item *>(object);
+    auto it = this->itemColors.find(item);
+    if (it == this->itemColors.end())
+    {
+      this->NextColor();
+      it = this->itemColors.emplace(item,
+          this->currentColor.AsRGBA()).first;
+    }
+    unsigned int rgba = it->second;
+    colors[item] = rgba;
+
+    // an item destroyed and another one created at the same address get the
+    // same color, so the name is always refreshed
+    this->colorDict[rgba] = item->getName();
+
+    ignition::math::Color color;
+    color.SetFromRGBA(rgba);
     for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
     {
-      Ogre::SubItem *subItem = item->getSubItem(i);
-      auto it = this->datablockMap.find(subItem);
-      if (it != this->datablockMap.end())
-        subItem->setDatablock(it->second);
-      else
-      {
-        auto mIt = materialMap[this].find(subItem);
-        if (mIt != materialMap[this].end())
-          subItem->setMaterial(mIt->second);
-      }
+      item->getSubItem(i)->setCustomParameter(this->parameterIndex,
+          Ogre::Vector4(color.R(), color.G(), color.B(), 1.0));
     }
-    itor.moveNext();
   }
-  this->datablockMap.clear();
-  materialMap[this].clear();
+  this->itemColors = std::move(colors);
+  this->assigned = true;
+  this->itemsRevision = this->scene->VisibilityLayersRevision();
 }
 
 /////////////////////////////////////////////////
@@ -185,4 +171,6 @@ void Ogre2MaterialSwitcher::Reset()
   this->currentColor = ignition::math::Color(
       0.0, 0.0, 0.0);
   this->colorDict.clear();
+  this->itemColors.clear();
+  this->assigned = false;
 }
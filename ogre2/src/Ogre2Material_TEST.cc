@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/ogre2/Ogre2Material.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(Ogre2MaterialTest, MaterialSharing)
+{
+  Ogre2RenderEngine *engine = Ogre2RenderEngine::Instance();
+  if (!engine->Load(std::map<std::string, std::string>()) || !engine->Init())
+  {
+    igndbg << "Engine 'ogre2' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  Ogre2ScenePtr ogreScene = std::dynamic_pointer_cast<Ogre2Scene>(scene);
+  ASSERT_NE(nullptr, ogreScene);
+  EXPECT_FALSE(ogreScene->MaterialSharing());
+  ogreScene->SetMaterialSharing(true);
+  EXPECT_TRUE(ogreScene->MaterialSharing());
+  EXPECT_EQ(0u, ogreScene->SharedDatablockCount());
+
+  MaterialPtr material = scene->CreateMaterial();
+  ASSERT_NE(nullptr, material);
+  material->SetDiffuse(math::Color::Red);
+
+  // clones of identical parameters share one datablock
+  Ogre2MaterialPtr first =
+      std::dynamic_pointer_cast<Ogre2Material>(material->Clone());
+  Ogre2MaterialPtr second =
+      std::dynamic_pointer_cast<Ogre2Material>(material->Clone());
+  ASSERT_NE(nullptr, first);
+  ASSERT_NE(nullptr, second);
+  EXPECT_TRUE(first->DatablockShared());
+  EXPECT_TRUE(second->DatablockShared());
+  EXPECT_EQ(first->Datablock(), second->Datablock());
+  EXPECT_EQ(1u, ogreScene->SharedDatablockCount());
+
+  // setting the value a material already has does not split it off
+  second->SetDiffuse(math::Color::Red);
+  EXPECT_TRUE(second->DatablockShared());
+
+  // writing to a material splits its datablock off, the other material
+  // keeps the shared one
+  second->SetDiffuse(math::Color::Blue);
+  EXPECT_FALSE(second->DatablockShared());
+  EXPECT_TRUE(first->DatablockShared());
+  EXPECT_NE(first->Datablock(), second->Datablock());
+  EXPECT_EQ(math::Color::Red, first->Diffuse());
+  EXPECT_EQ(math::Color::Blue, second->Diffuse());
+  EXPECT_EQ(1u, ogreScene->SharedDatablockCount());
+
+  // the count drops once the last material sharing the datablock is gone
+  first->SetDiffuse(math::Color::Green);
+  EXPECT_FALSE(first->DatablockShared());
+  EXPECT_EQ(0u, ogreScene->SharedDatablockCount());
+
+  Ogre2MaterialPtr third =
+      std::dynamic_pointer_cast<Ogre2Material>(material->Clone());
+  ASSERT_NE(nullptr, third);
+  EXPECT_EQ(1u, ogreScene->SharedDatablockCount());
+  scene->DestroyMaterial(third);
+  EXPECT_EQ(0u, ogreScene->SharedDatablockCount());
+
+  // only clones made while sharing is enabled share their datablock
+  ogreScene->SetMaterialSharing(false);
+  Ogre2MaterialPtr fourth =
+      std::dynamic_pointer_cast<Ogre2Material>(material->Clone());
+  ASSERT_NE(nullptr, fourth);
+  EXPECT_FALSE(fourth->DatablockShared());
+  EXPECT_EQ(0u, ogreScene->SharedDatablockCount());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  engine->Fini();
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Hlms/Pbs/OgreHlmsPbsDatablock.h>
+#include <Hlms/Unlit/OgreHlmsUnlitDatablock.h>
+#include <OgreMesh2.h>
+#include <OgreSubMesh2.h>
+#include <Vao/OgreIndexBufferPacked.h>
+#include <Vao/OgreVertexArrayObject.h>
+#include <Vao/OgreVertexBufferPacked.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+#include "Ogre2MemoryStats.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+void Ogre2MemoryStats::AddTexture(Ogre::TextureGpu *_texture,
+    std::unordered_set<const void *> &_seen, MemoryStats &_stats)
+{
+  if (!_texture || !_seen.insert(_texture).second)
+    return;
+
+  if (_texture->getResidencyStatus() != Ogre::GpuResidency::Resident)
+    return;
+
+  uint64_t bytes = Ogre::PixelFormatGpuUtils::calculateSizeBytes(
+      _texture->getWidth(), _texture->getHeight(), _texture->getDepth(),
+      _texture->getNumSlices(), _texture->getPixelFormat(),
+      _texture->getNumMipmaps(), 4u);
+  _stats.textureCount++;
+
+  if (!_texture->isRenderToTexture())
+  {
+    _stats.textureBytes += bytes;
+    return;
+  }
+
+  // shadow node textures are named after their atlas
+  std::string name = _texture->getNameStr();
+  std::transform(name.begin(), name.end(), name.begin(),
+      [](unsigned char _c) {return std::tolower(_c);});
+  if (name.find("atlas") != std::string::npos ||
+      name.find("shadow") != std::string::npos)
+  {
+    _stats.shadowMapBytes += bytes;
+  }
+  else
+  {
+    _stats.renderTargetBytes += bytes;
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2MemoryStats::AddMesh(const Ogre::Mesh *_mesh,
+    std::unordered_set<const void *> &_seen, MemoryStats &_stats)
+{
+  if (!_mesh || !_seen.insert(_mesh).second)
+    return;
+
+  _stats.meshCount++;
+  for (unsigned int i = 0; i < _mesh->getNumSubMeshes(); ++i)
+  {
+    const Ogre::SubMesh *subMesh = _mesh->getSubMesh(i);
+    for (unsigned int pass = 0; pass < Ogre::NumVertexPass; ++pass)
+    {
+      for (const Ogre::VertexArrayObject *vao : subMesh->mVao[pass])
+      {
+        for (const Ogre::VertexBufferPacked *buffer :
+            vao->getVertexBuffers())
+        {
+          if (_seen.insert(buffer).second)
+            _stats.vertexBufferBytes += buffer->getTotalSizeBytes();
+        }
+
+        const Ogre::IndexBufferPacked *indexBuffer = vao->getIndexBuffer();
+        if (indexBuffer && _seen.insert(indexBuffer).second)
+          _stats.indexBufferBytes += indexBuffer->getTotalSizeBytes();
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2MemoryStats::AddDatablock(Ogre::HlmsDatablock *_datablock,
+    std::unordered_set<const void *> &_seen, MemoryStats &_stats)
+{
+  if (!_datablock || !_seen.insert(_datablock).second)
+    return;
+
+  if (auto pbs = dynamic_cast<Ogre::HlmsPbsDatablock *>(_datablock))
+  {
+    for (uint8_t i = 0u; i < Ogre::NUM_PBSM_TEXTURE_TYPES; ++i)
+      AddTexture(pbs->getTexture(i), _seen, _stats);
+  }
+  else if (auto unlit = dynamic_cast<Ogre::HlmsUnlitDatablock *>(_datablock))
+  {
+    for (uint8_t i = 0u; i < Ogre::NUM_UNLIT_TEXTURE_TYPES; ++i)
+      AddTexture(unlit->getTexture(i), _seen, _stats);
+  }
+}
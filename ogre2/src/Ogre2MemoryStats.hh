@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2MEMORYSTATS_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2MEMORYSTATS_HH_
+
+#include <unordered_set>
+
+#include "ignition/rendering/MemoryStats.hh"
+#include "ignition/rendering/ogre2/Ogre2Includes.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Helpers to add up the memory of ogre resources. Each
+    /// resource is counted once, resources already in the seen set are
+    /// skipped.
+    namespace Ogre2MemoryStats
+    {
+      /// \brief Add the memory of a resident texture. Render to texture
+      /// targets count as render targets, or as shadow maps if they belong
+      /// to a shadow atlas.
+      /// \param[in] _texture Texture to add
+      /// \param[in, out] _seen Resources counted so far
+      /// \param[in, out] _stats Stats to add to
+      void AddTexture(Ogre::TextureGpu *_texture,
+          std::unordered_set<const void *> &_seen, MemoryStats &_stats);
+
+      /// \brief Add the memory of the vertex and index buffers of a mesh.
+      /// Buffers shared between submeshes or between the normal and the
+      /// shadow vaos are counted once.
+      /// \param[in] _mesh Mesh to add
+      /// \param[in, out] _seen Resources counted so far
+      /// \param[in, out] _stats Stats to add to
+      void AddMesh(const Ogre::Mesh *_mesh,
+          std::unordered_set<const void *> &_seen, MemoryStats &_stats);
+
+      /// \brief Add the textures bound to a pbs or unlit datablock
+      /// \param[in] _datablock Datablock whose textures are added
+      /// \param[in, out] _seen Resources counted so far
+      /// \param[in, out] _stats Stats to add to
+      void AddDatablock(Ogre::HlmsDatablock *_datablock,
+          std::unordered_set<const void *> &_seen, MemoryStats &_stats);
+    }
+    }
+  }
+}
+#endif
@@ -25,22 +25,52 @@
 #include <OgreItem.h>
 #include <OgreSceneManager.h>
 #include <OgreMeshManager.h>
+#include <OgreMesh2.h>
 #include <OgreMeshManager2.h>
 #include <OgreMaterialManager.h>
+#include <OgreSceneNode.h>
+#include <OgreSubItem.h>
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
 
+#include <algorithm>
+
 #include <ignition/common/Console.hh>
 
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2Mesh.hh"
 #include "ignition/rendering/ogre2/Ogre2Material.hh"
+#include "ignition/rendering/ogre2/Ogre2MeshFactory.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
 #include "ignition/rendering/ogre2/Ogre2Storage.hh"
+#include "ignition/rendering/ogre2/Ogre2Visual.hh"
 
 /// brief Private implementation of the Ogre2Mesh class
 class ignition::rendering::Ogre2MeshPrivate
 {
+  /// \brief Clear the cached bones and animations if the item uses
+  /// another skeleton instance than when they were cached, e.g. after
+  /// sharing the skeleton of another mesh
+  /// \param[in] _skel Current skeleton instance of the item
+  public: void SyncSkeleton(Ogre::SkeletonInstance *_skel);
+
+  /// \brief Skeleton instance the cached bones and animations belong to
+  public: Ogre::SkeletonInstance *skeleton = nullptr;
+
+  /// \brief Names of the bones given to the last SetSkeletonLocalTransforms
+  /// call, in map order
+  public: std::vector<std::string> boneNames;
+
+  /// \brief Bones matching boneNames, null for unknown names
+  public: std::vector<Ogre::Bone *> bones;
+
+  /// \brief All animations of the skeleton
+  public: std::vector<Ogre::SkeletonAnimation *> animations;
+
+  /// \brief Name of the private ogre mesh the item draws once its vertices
+  /// are updated in place, empty until then
+  public: std::string dynamicMeshName;
 };
 
 /// brief Private implementation of the Ogre2SubMesh class
@@ -54,6 +84,20 @@ class ignition::rendering::Ogre2SubMeshPrivate
 using namespace ignition;
 using namespace rendering;
 
+//////////////////////////////////////////////////
+void Ogre2MeshPrivate::SyncSkeleton(Ogre::SkeletonInstance *_skel)
+{
+  if (this->skeleton == _skel)
+    return;
+
+  this->skeleton = _skel;
+  this->boneNames.clear();
+  this->bones.clear();
+  this->animations.clear();
+  for (const auto &anim : _skel->getAnimations())
+    this->animations.push_back(_skel->getAnimation(anim.getName()));
+}
+
 //////////////////////////////////////////////////
 Ogre2Mesh::Ogre2Mesh()
   : dataPtr(new Ogre2MeshPrivate)
@@ -82,8 +126,16 @@ void Ogre2Mesh::Destroy()
   // destroy mesh (ogre item)
   auto ogreScene = std::dynamic_pointer_cast<Ogre2Scene>(this->Scene());
   ogreScene->OgreSceneManager()->destroyItem(this->ogreItem);
+  ogreScene->MarkVisibilityLayersDirty();
   this->ogreItem = nullptr;
 
+  if (!this->dataPtr->dynamicMeshName.empty())
+  {
+    ogreScene->MeshFactory()->DestroyDynamicMesh(
+        this->dataPtr->dynamicMeshName);
+    this->dataPtr->dynamicMeshName.clear();
+  }
+
   // destroy submeshes (ogre subitems)
   this->SubMeshes()->DestroyAll();
 
@@ -129,19 +181,213 @@ void Ogre2Mesh::SetSkeletonLocalTransforms(
     return;
   }
   auto skel = this->ogreItem->getSkeletonInstance();
+  this->dataPtr->SyncSkeleton(skel);
+
+  // the bones are looked up by name only when the set of names changes.
+  // Callers usually pass the same nodes every frame, e.g. from the frames
+  // of one animation
+  std::vector<std::string> &names = this->dataPtr->boneNames;
+  std::vector<Ogre::Bone *> &bones = this->dataPtr->bones;
+  bool sameNames = names.size() == _tfs.size();
+  auto nameIt = names.begin();
+  for (auto tfIt = _tfs.begin(); sameNames && tfIt != _tfs.end();
+      ++tfIt, ++nameIt)
+  {
+    sameNames = *nameIt == tfIt->first;
+  }
 
-  for (auto const &[boneName, tf] : _tfs)
+  if (!sameNames)
   {
-    auto bone = skel->getBone(boneName);
+    names.clear();
+    bones.clear();
+    for (auto const &tf : _tfs)
+    {
+      names.push_back(tf.first);
+      bones.push_back(skel->getBone(tf.first));
+    }
+  }
+
+  std::size_t i = 0u;
+  for (auto const &tf : _tfs)
+  {
+    Ogre::Bone *bone = bones[i++];
     if (bone)
     {
       skel->setManualBone(bone, true);
-      bone->setPosition(Ogre2Conversions::Convert(tf.Translation()));
-      bone->setOrientation(Ogre2Conversions::Convert(tf.Rotation()));
+      bone->setPosition(Ogre2Conversions::Convert(tf.second.Translation()));
+      bone->setOrientation(Ogre2Conversions::Convert(tf.second.Rotation()));
     }
   }
 }
 
+//////////////////////////////////////////////////
+std::vector<std::string> Ogre2Mesh::SkeletonBoneNames() const
+{
+  std::vector<std::string> names;
+  if (!this->ogreItem->hasSkeleton())
+    return names;
+
+  auto skel = this->ogreItem->getSkeletonInstance();
+  names.reserve(skel->getNumBones());
+  for (unsigned int i = 0; i < skel->getNumBones(); ++i)
+    names.push_back(skel->getBone(i)->getName());
+  return names;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Mesh::SetSkeletonBoneTransforms(
+    const std::vector<math::Matrix4d> &_tfs)
+{
+  if (!this->ogreItem->hasSkeleton())
+    return;
+
+  auto skel = this->ogreItem->getSkeletonInstance();
+  std::size_t count = std::min<std::size_t>(_tfs.size(), skel->getNumBones());
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    Ogre::Bone *bone = skel->getBone(i);
+    skel->setManualBone(bone, true);
+    bone->setPosition(Ogre2Conversions::Convert(_tfs[i].Translation()));
+    bone->setOrientation(Ogre2Conversions::Convert(_tfs[i].Rotation()));
+  }
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Mesh::ShareSkeleton(MeshPtr _mesh)
+{
+  if (!this->ogreItem->hasSkeleton())
+    return false;
+
+  if (!_mesh)
+  {
+    if (this->ogreItem->sharesSkeletonInstance())
+      this->ogreItem->stopUsingSkeletonInstanceFromMaster();
+    return true;
+  }
+
+  Ogre2MeshPtr other = std::dynamic_pointer_cast<Ogre2Mesh>(_mesh);
+  if (!other || other.get() == this || !other->ogreItem ||
+      !other->ogreItem->hasSkeleton() ||
+      other->ogreItem->getMesh()->getSkeletonName() !=
+      this->ogreItem->getMesh()->getSkeletonName())
+  {
+    ignerr << "Unable to share the skeleton of mesh [" << _mesh->Name()
+           << "] with mesh [" << this->Name() << "]: the meshes must have "
+           << "the same skeleton" << std::endl;
+    return false;
+  }
+
+  this->ogreItem->useSkeletonInstanceFrom(other->ogreItem);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Mesh::UpdateVertices(const float *_positions, const float *_normals,
+    unsigned int _vertexCount)
+{
+  if (!this->ogreItem)
+    return false;
+
+  if (!this->UseDynamicMesh())
+    return false;
+
+  auto ogreScene = std::dynamic_pointer_cast<Ogre2Scene>(this->Scene());
+  Ogre::Aabb bounds;
+  if (!ogreScene->MeshFactory()->UpdateDynamicMesh(
+      this->dataPtr->dynamicMeshName, _positions, _normals, _vertexCount,
+      bounds))
+  {
+    return false;
+  }
+
+  // the visual the item is attached to caches its bounding box. Its id is
+  // the user data of the item
+  this->ogreItem->setLocalAabb(bounds);
+  const Ogre::Any &any = this->ogreItem->getUserObjectBindings().getUserAny();
+  if (!any.isEmpty() && any.getType() == typeid(unsigned int))
+  {
+    Ogre2VisualPtr visual = std::dynamic_pointer_cast<Ogre2Visual>(
+        ogreScene->VisualById(Ogre::any_cast<unsigned int>(any)));
+    if (visual)
+      visual->MarkBoundsDirty();
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Mesh::UseDynamicMesh()
+{
+  if (!this->dataPtr->dynamicMeshName.empty())
+    return true;
+
+  if (this->ogreItem->hasSkeleton())
+  {
+    ignerr << "Unable to update the vertices of mesh [" << this->Name()
+           << "] in place: meshes with a skeleton are not supported"
+           << std::endl;
+    return false;
+  }
+
+  // the ogre mesh is shared by all the items loaded from the same
+  // descriptor and its buffers are immutable, so the vertices are updated
+  // in a private copy with dynamic position and normal buffers
+  auto ogreScene = std::dynamic_pointer_cast<Ogre2Scene>(this->Scene());
+  std::string name = this->ogreItem->getMesh()->getName() + "::dynamic::" +
+      std::to_string(this->Id());
+  Ogre::Item *item = ogreScene->MeshFactory()->DynamicOgreItem(
+      this->meshDescriptor, name);
+  if (!item)
+    return false;
+
+  if (item->getNumSubItems() != this->ogreItem->getNumSubItems())
+  {
+    ignerr << "Unable to update the vertices of mesh [" << this->Name()
+           << "] in place: the submeshes of its descriptor changed"
+           << std::endl;
+    ogreScene->OgreSceneManager()->destroyItem(item);
+    ogreScene->MeshFactory()->DestroyDynamicMesh(name);
+    return false;
+  }
+
+  // keep the materials and the flags of the item it replaces
+  for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
+  {
+    Ogre::SubItem *oldSubItem = this->ogreItem->getSubItem(i);
+    Ogre::SubItem *subItem = item->getSubItem(i);
+    if (oldSubItem->getMaterial())
+      subItem->setMaterial(oldSubItem->getMaterial());
+    else
+      subItem->setDatablock(oldSubItem->getDatablock());
+  }
+  item->setCastShadows(this->ogreItem->getCastShadows());
+  item->setVisibilityFlags(this->ogreItem->getVisibilityFlags());
+  item->setRenderQueueGroup(this->ogreItem->getRenderQueueGroup());
+  item->getUserObjectBindings().setUserAny(
+      this->ogreItem->getUserObjectBindings().getUserAny());
+  item->setName(this->ogreItem->getName());
+
+  Ogre::SceneNode *node = this->ogreItem->getParentSceneNode();
+  if (node)
+  {
+    node->detachObject(this->ogreItem);
+    node->attachObject(item);
+  }
+  ogreScene->OgreSceneManager()->destroyItem(this->ogreItem);
+  this->ogreItem = item;
+
+  for (unsigned int i = 0; i < this->subMeshes->Size(); ++i)
+  {
+    Ogre2SubMeshPtr subMesh = std::dynamic_pointer_cast<Ogre2SubMesh>(
+        this->subMeshes->GetById(i));
+    if (subMesh)
+      subMesh->ogreSubItem = item->getSubItem(i);
+  }
+
+  ogreScene->MarkVisibilityLayersDirty();
+  this->dataPtr->dynamicMeshName = name;
+  return true;
+}
+
 //////////////////////////////////////////////////
 std::unordered_map<std::string, float> Ogre2Mesh::SkeletonWeights() const
 {
@@ -235,17 +481,15 @@ void Ogre2Mesh::UpdateSkeletonAnimation(
   }
 
   Ogre::SkeletonInstance *skel = this->ogreItem->getSkeletonInstance();
-  auto animations = skel->getAnimations();
-  for (auto &anim : animations)
+  this->dataPtr->SyncSkeleton(skel);
+
+  auto seconds =
+      std::chrono::duration_cast<std::chrono::milliseconds>(_time).count() /
+      1000.0;
+  for (Ogre::SkeletonAnimation *sa : this->dataPtr->animations)
   {
-    Ogre::SkeletonAnimation *sa = skel->getAnimation(anim.getName());
     if (sa->getEnabled())
-    {
-      auto seconds =
-          std::chrono::duration_cast<std::chrono::milliseconds>(_time).count() /
-          1000.0;
       sa->setTime(seconds);
-    }
   }
 }
 
@@ -323,6 +567,12 @@ void Ogre2SubMesh::Destroy()
       ++i;
     }
   }
+
+  Ogre2MaterialPtr derived =
+      std::dynamic_pointer_cast<Ogre2Material>(this->material);
+  if (derived)
+    derived->UnregisterSubMeshUser(this);
+
   BaseSubMesh::Destroy();
 }
 
@@ -335,6 +585,11 @@ Ogre::SubItem *Ogre2SubMesh::Ogre2SubItem() const
 //////////////////////////////////////////////////
 void Ogre2SubMesh::SetMaterialImpl(MaterialPtr _material)
 {
+  Ogre2MaterialPtr origMaterial =
+      std::dynamic_pointer_cast<Ogre2Material>(this->material);
+  if (origMaterial)
+    origMaterial->UnregisterSubMeshUser(this);
+
   Ogre2MaterialPtr derived =
       std::dynamic_pointer_cast<Ogre2Material>(_material);
 
@@ -356,10 +611,15 @@ void Ogre2SubMesh::SetMaterialImpl(MaterialPtr _material)
   {
     this->ogreSubItem->setDatablock(
         static_cast<Ogre::HlmsPbsDatablock *>(derived->Datablock()));
+    derived->RegisterSubMeshUser(this);
   }
 
   // set cast shadows
   this->ogreSubItem->getParent()->setCastShadows(_material->CastShadows());
+
+  auto ogreScene = std::dynamic_pointer_cast<Ogre2Scene>(this->Scene());
+  if (ogreScene)
+    ogreScene->MarkLowLevelSubItemsDirty();
 }
 
 //////////////////////////////////////////////////
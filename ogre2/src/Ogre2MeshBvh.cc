@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+#include "Ogre2MeshBvh.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+void Ogre2MeshBvh::Build(const std::vector<Ogre::Vector3> &_vertices)
+{
+  this->nodes.clear();
+  this->vertices.clear();
+
+  uint32_t triCount = static_cast<uint32_t>(_vertices.size() / 3u);
+  if (triCount == 0u)
+    return;
+
+  std::vector<uint32_t> tris(triCount);
+  std::iota(tris.begin(), tris.end(), 0u);
+
+  std::vector<Ogre::Vector3> centroids(triCount);
+  for (uint32_t i = 0u; i < triCount; ++i)
+  {
+    centroids[i] = (_vertices[i * 3u] + _vertices[i * 3u + 1u] +
+        _vertices[i * 3u + 2u]) / 3.0f;
+  }
+
+  this->nodes.reserve(2u * triCount);
+  this->nodes.emplace_back();
+  this->BuildNode(0u, 0u, triCount, _vertices, centroids, tris);
+
+  // store the triangles in leaf order so each leaf reads a contiguous range
+  this->vertices.reserve(triCount * 3u);
+  for (uint32_t t : tris)
+  {
+    this->vertices.push_back(_vertices[t * 3u]);
+    this->vertices.push_back(_vertices[t * 3u + 1u]);
+    this->vertices.push_back(_vertices[t * 3u + 2u]);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshBvh::BuildNode(uint32_t _node, uint32_t _begin, uint32_t _end,
+    const std::vector<Ogre::Vector3> &_vertices,
+    const std::vector<Ogre::Vector3> &_centroids,
+    std::vector<uint32_t> &_tris)
+{
+  const float inf = std::numeric_limits<float>::infinity();
+  Ogre::Vector3 min(inf, inf, inf);
+  Ogre::Vector3 max(-inf, -inf, -inf);
+  Ogre::Vector3 centroidMin(inf, inf, inf);
+  Ogre::Vector3 centroidMax(-inf, -inf, -inf);
+  for (uint32_t i = _begin; i < _end; ++i)
+  {
+    uint32_t t = _tris[i];
+    for (uint32_t v = 0u; v < 3u; ++v)
+    {
+      min.makeFloor(_vertices[t * 3u + v]);
+      max.makeCeil(_vertices[t * 3u + v]);
+    }
+    centroidMin.makeFloor(_centroids[t]);
+    centroidMax.makeCeil(_centroids[t]);
+  }
+  this->nodes[_node].min = min;
+  this->nodes[_node].max = max;
+
+  uint32_t count = _end - _begin;
+  Ogre::Vector3 extent = centroidMax - centroidMin;
+  size_t axis = 0u;
+  if (extent.y > extent[axis])
+    axis = 1u;
+  if (extent.z > extent[axis])
+    axis = 2u;
+
+  if (count <= kMaxLeafSize || extent[axis] <= 0.0f)
+  {
+    this->nodes[_node].offset = _begin;
+    this->nodes[_node].count = count;
+    return;
+  }
+
+  // split at the median centroid along the longest axis
+  uint32_t mid = _begin + count / 2u;
+  std::nth_element(_tris.begin() + _begin, _tris.begin() + mid,
+      _tris.begin() + _end, [&](uint32_t _a, uint32_t _b)
+      {
+        return _centroids[_a][axis] < _centroids[_b][axis];
+      });
+
+  uint32_t left = static_cast<uint32_t>(this->nodes.size());
+  this->nodes.emplace_back();
+  this->nodes.emplace_back();
+  this->nodes[_node].offset = left;
+  this->nodes[_node].count = 0u;
+
+  this->BuildNode(left, _begin, mid, _vertices, _centroids, _tris);
+  this->BuildNode(left + 1u, mid, _end, _vertices, _centroids, _tris);
+}
+
+//////////////////////////////////////////////////
+const std::vector<Ogre::Vector3> &Ogre2MeshBvh::Vertices() const
+{
+  return this->vertices;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MeshBvh::Intersect(const Ogre::Ray &_ray, double &_distance) const
+{
+  if (this->nodes.empty())
+    return false;
+
+  const Ogre::Vector3 &origin = _ray.getOrigin();
+  const Ogre::Vector3 &dir = _ray.getDirection();
+  Ogre::Vector3 invDir(1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z);
+
+  bool hit = false;
+  Ogre::Real closest = std::numeric_limits<Ogre::Real>::max();
+
+  std::vector<uint32_t> stack;
+  stack.reserve(64u);
+  stack.push_back(0u);
+  while (!stack.empty())
+  {
+    const Node &node = this->nodes[stack.back()];
+    stack.pop_back();
+
+    // slab test against the node bounds, skipping nodes that are entirely
+    // behind the ray origin or farther than the closest hit
+    Ogre::Vector3 t0 = (node.min - origin) * invDir;
+    Ogre::Vector3 t1 = (node.max - origin) * invDir;
+    Ogre::Real tNear = std::max({std::min(t0.x, t1.x),
+        std::min(t0.y, t1.y), std::min(t0.z, t1.z)});
+    Ogre::Real tFar = std::min({std::max(t0.x, t1.x),
+        std::max(t0.y, t1.y), std::max(t0.z, t1.z)});
+    if (tFar < 0.0f || tNear > tFar || tNear > closest)
+      continue;
+
+    if (node.count == 0u)
+    {
+      stack.push_back(node.offset);
+      stack.push_back(node.offset + 1u);
+      continue;
+    }
+
+    for (uint32_t i = node.offset; i < node.offset + node.count; ++i)
+    {
+      std::pair<bool, Ogre::Real> result = Ogre::Math::intersects(_ray,
+          this->vertices[i * 3u], this->vertices[i * 3u + 1u],
+          this->vertices[i * 3u + 2u], true, false);
+      if (result.first && result.second < closest)
+      {
+        closest = result.second;
+        hit = true;
+      }
+    }
+  }
+
+  if (hit)
+    _distance = closest;
+  return hit;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2MESHBVH_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2MESHBVH_HH_
+
+#include <cstdint>
+#include <vector>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/ogre2/Export.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreRay.h>
+#include <OgreVector3.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Bounding volume hierarchy over the triangles of a mesh. The
+    /// triangles are stored in mesh local space so that a single hierarchy can
+    /// be shared by every item instancing the mesh.
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2MeshBvh
+    {
+      /// \brief A node of the hierarchy
+      public: struct Node
+      {
+        /// \brief Minimum corner of the node bounding box
+        Ogre::Vector3 min;
+
+        /// \brief Maximum corner of the node bounding box
+        Ogre::Vector3 max;
+
+        /// \brief Index of the first child for internal nodes, or index of the
+        /// first triangle for leaf nodes. The second child of an internal node
+        /// immediately follows the first one.
+        uint32_t offset = 0u;
+
+        /// \brief Number of triangles in a leaf node, 0 for internal nodes
+        uint32_t count = 0u;
+      };
+
+      /// \brief Build the hierarchy
+      /// \param[in] _vertices Triangle vertices, three per triangle
+      public: void Build(const std::vector<Ogre::Vector3> &_vertices);
+
+      /// \brief Intersect a ray with the triangles
+      /// \param[in] _ray Ray in mesh local space
+      /// \param[out] _distance Ray parameter of the closest hit
+      /// \return True if a triangle was hit
+      public: bool Intersect(const Ogre::Ray &_ray, double &_distance) const;
+
+      /// \brief Get the triangles of the hierarchy
+      /// \return Triangle vertices, three per triangle, in leaf order
+      public: const std::vector<Ogre::Vector3> &Vertices() const;
+
+      /// \brief Recursively build a node
+      /// \param[in] _node Index of the node to build
+      /// \param[in] _begin First entry in _tris covered by the node
+      /// \param[in] _end One past the last entry in _tris covered by the node
+      /// \param[in] _vertices Triangle vertices, three per triangle
+      /// \param[in] _centroids Triangle centroids
+      /// \param[in,out] _tris Triangle indices, reordered so that every node
+      /// covers a contiguous range
+      private: void BuildNode(uint32_t _node, uint32_t _begin, uint32_t _end,
+          const std::vector<Ogre::Vector3> &_vertices,
+          const std::vector<Ogre::Vector3> &_centroids,
+          std::vector<uint32_t> &_tris);
+
+      /// \brief Maximum number of triangles in a leaf node
+      private: static constexpr uint32_t kMaxLeafSize = 4u;
+
+      /// \brief Triangle vertices, three per triangle, in leaf order
+      private: std::vector<Ogre::Vector3> vertices;
+
+      /// \brief Nodes of the hierarchy, the root is the first node
+      private: std::vector<Node> nodes;
+    };
+    }
+  }
+}
+#endif
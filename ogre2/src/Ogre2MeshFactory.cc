@@ -16,51 +16,503 @@
  */
 
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <numeric>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
 #include <ignition/common/Material.hh>
 #include <ignition/common/MeshManager.hh>
 #include <ignition/common/Skeleton.hh>
 #include <ignition/common/SkeletonAnimation.hh>
 #include <ignition/common/SubMesh.hh>
+#include <ignition/common/Util.hh>
 
 #include <ignition/math/Matrix4.hh>
 
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
+#include "ignition/rendering/ogre2/Ogre2Material.hh"
 #include "ignition/rendering/ogre2/Ogre2Mesh.hh"
 #include "ignition/rendering/ogre2/Ogre2MeshFactory.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
 #include "ignition/rendering/ogre2/Ogre2Storage.hh"
+#include "ignition/rendering/Utils.hh"
+
+#include "Ogre2MeshBvh.hh"
+#include "Ogre2SharedMeshes.hh"
 
 #ifdef _MSC_VER
   #pragma warning(push, 0)
 #endif
 #include <OgreHardwareBufferManager.h>
+#include <OgreDataStream.h>
 #include <OgreItem.h>
 #include <OgreKeyFrame.h>
+#include <OgreLodStrategy.h>
+#include <OgreLodStrategyManager.h>
 #include <OgreMesh2.h>
 #include <OgreMeshManager.h>
 #include <OgreMeshManager2.h>
+#include <OgreMeshSerializer.h>
 #include <OgreOldBone.h>
 #include <OgreOldSkeletonManager.h>
+#include <OgreRay.h>
+#include <OgreRoot.h>
 #include <OgreSceneManager.h>
 #include <OgreSkeleton.h>
 #include <OgreSubItem.h>
 #include <OgreSubMesh.h>
 #include <OgreSubMesh2.h>
+#include <Vao/OgreIndexBufferPacked.h>
+#include <Vao/OgreVaoManager.h>
+#include <Vao/OgreVertexBufferPacked.h>
 #ifdef _MSC_VER
   #pragma warning(pop)
 #endif
 
+namespace
+{
+/// \brief Submesh data packed in the layout of the ogre vertex and index
+/// buffers. Packing does not use ogre so it can run on worker threads.
+struct PackedSubMesh
+{
+  /// \brief Constructor
+  /// \param[in] _subMesh Submesh to copy
+  explicit PackedSubMesh(const common::SubMesh &_subMesh)
+    : subMesh(_subMesh)
+  {
+  }
+
+  /// \brief Copy of the submesh, recentered if requested by the descriptor
+  common::SubMesh subMesh;
+
+  /// \brief Interleaved position, normal and texture coordinates of every
+  /// vertex
+  std::vector<float> vertices;
+
+  /// \brief Indices
+  std::vector<uint32_t> indices;
+
+  /// \brief Indices of the reduced levels of detail, indexing the same
+  /// vertices as the full detail indices
+  std::vector<std::vector<uint32_t>> lodIndices;
+
+  /// \brief Index in the submesh of each packed vertex, empty if the
+  /// vertices keep the submesh order
+  std::vector<unsigned int> vertexOrder;
+};
+
+/// \brief Meshes with fewer triangles do not get levels of detail
+const unsigned int kMinLodTriangleCount = 256u;
+
+/// \brief Version of the packed vertex and index layout. It is part of the
+/// mesh cache key so that meshes cached with an older layout are packed
+/// again.
+const unsigned int kPackedMeshVersion = 2u;
+
+/// \brief Packed data of all the submeshes loaded from a mesh descriptor
+using PackedMesh = std::vector<PackedSubMesh>;
+
+//////////////////////////////////////////////////
+void PackMesh(const MeshDescriptor &_desc, unsigned int _lodLevelCount,
+    bool _optimize, PackedMesh &_packed)
+{
+  _packed.clear();
+  _packed.reserve(_desc.mesh->SubMeshCount());
+  for (unsigned int i = 0; i < _desc.mesh->SubMeshCount(); i++)
+  {
+    // if submesh is specified then load only that particular submesh
+    auto s = _desc.mesh->SubMeshByIndex(i).lock();
+    if (!s || (!_desc.subMeshName.empty() && s->Name() != _desc.subMeshName))
+      continue;
+
+    // Copy the original submesh. We may need to modify the vertices, and
+    // we don't want to change the original.
+    _packed.emplace_back(*s.get());
+    PackedSubMesh &packed = _packed.back();
+    common::SubMesh &subMesh = packed.subMesh;
+
+    // Recenter the vertices if requested.
+    if (_desc.centerSubMesh)
+      subMesh.Center(math::Vector3d::Zero);
+
+    std::vector<unsigned int> indices(subMesh.IndexCount());
+    for (unsigned int j = 0; j < subMesh.IndexCount(); ++j)
+      indices[j] = static_cast<unsigned int>(subMesh.Index(j));
+
+    // reorder the triangles for the vertex cache and overdraw, then the
+    // vertices in the order the triangles use them. Bone assignments refer
+    // to the submesh order so the vertices of skinned meshes keep it.
+    if (_optimize &&
+        subMesh.SubMeshPrimitiveType() == common::SubMesh::TRIANGLES)
+    {
+      std::vector<math::Vector3d> positions(subMesh.VertexCount());
+      for (unsigned int j = 0; j < subMesh.VertexCount(); ++j)
+        positions[j] = subMesh.Vertex(j);
+      indices = optimizeOverdraw(positions,
+          optimizeVertexCache(indices, positions.size()));
+
+      if (subMesh.NodeAssignmentsCount() == 0u)
+      {
+        std::vector<unsigned int> remap =
+            optimizeVertexFetch(indices, positions.size());
+        packed.vertexOrder.resize(remap.size());
+        for (unsigned int j = 0; j < remap.size(); ++j)
+          packed.vertexOrder[remap[j]] = j;
+        for (unsigned int &index : indices)
+          index = remap[index];
+      }
+    }
+
+    unsigned int floatsPerVertex = 3u;
+    if (subMesh.NormalCount() > 0)
+      floatsPerVertex += 3u;
+    for (unsigned int k = 0u; k < subMesh.TexCoordSetCount(); ++k)
+    {
+      if (subMesh.TexCoordCountBySet(k) > 0u)
+        floatsPerVertex += 2u;
+    }
+
+    // Add all the vertices
+    packed.vertices.reserve(subMesh.VertexCount() * floatsPerVertex);
+    for (unsigned int j = 0; j < subMesh.VertexCount(); ++j)
+    {
+      unsigned int vertex =
+          packed.vertexOrder.empty() ? j : packed.vertexOrder[j];
+      math::Vector3d v = subMesh.Vertex(vertex);
+      packed.vertices.push_back(static_cast<float>(v.X()));
+      packed.vertices.push_back(static_cast<float>(v.Y()));
+      packed.vertices.push_back(static_cast<float>(v.Z()));
+
+      // Add all normals
+      if (subMesh.NormalCount() > 0)
+      {
+        math::Vector3d n = subMesh.Normal(vertex);
+        packed.vertices.push_back(static_cast<float>(n.X()));
+        packed.vertices.push_back(static_cast<float>(n.Y()));
+        packed.vertices.push_back(static_cast<float>(n.Z()));
+      }
+
+      // Add all texture coordinate sets
+      for (unsigned int k = 0u; k < subMesh.TexCoordSetCount(); ++k)
+      {
+        if (subMesh.TexCoordCountBySet(k) > 0u)
+        {
+          math::Vector2d uv = subMesh.TexCoordBySet(vertex, k);
+          packed.vertices.push_back(static_cast<float>(uv.X()));
+          packed.vertices.push_back(static_cast<float>(uv.Y()));
+        }
+      }
+    }
+
+    // Add all the indices
+    packed.indices.assign(indices.begin(), indices.end());
+  }
+
+  if (_lodLevelCount == 0u)
+    return;
+
+  size_t triangleCount = 0u;
+  for (const PackedSubMesh &packed : _packed)
+  {
+    if (packed.subMesh.SubMeshPrimitiveType() == common::SubMesh::TRIANGLES)
+      triangleCount += packed.indices.size() / 3u;
+  }
+  if (triangleCount < kMinLodTriangleCount)
+    return;
+
+  // each level of detail halves the triangle count of the previous one.
+  // Levels are per mesh so submeshes that cannot be reduced keep their
+  // full detail indices in every level.
+  for (PackedSubMesh &packed : _packed)
+  {
+    const common::SubMesh &subMesh = packed.subMesh;
+    if (subMesh.SubMeshPrimitiveType() != common::SubMesh::TRIANGLES)
+    {
+      packed.lodIndices.assign(_lodLevelCount, packed.indices);
+      continue;
+    }
+
+    std::vector<math::Vector3d> positions(subMesh.VertexCount());
+    for (unsigned int j = 0; j < subMesh.VertexCount(); ++j)
+    {
+      positions[j] = subMesh.Vertex(
+          packed.vertexOrder.empty() ? j : packed.vertexOrder[j]);
+    }
+
+    std::vector<unsigned int> indices(packed.indices.begin(),
+        packed.indices.end());
+    for (unsigned int l = 1u; l <= _lodLevelCount; ++l)
+    {
+      size_t target = std::max<size_t>(1u, (packed.indices.size() / 3u) >> l);
+      indices = simplifyTriangles(positions, indices, target);
+      std::vector<unsigned int> lodIndices = indices;
+      if (_optimize)
+        lodIndices = optimizeVertexCache(indices, positions.size());
+      packed.lodIndices.emplace_back(lodIndices.begin(), lodIndices.end());
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+bool Use16BitIndices(size_t _vertexCount)
+{
+  // 0xFFFF is left out as it is the primitive restart index of some APIs
+  return _vertexCount < std::numeric_limits<uint16_t>::max();
+}
+
+//////////////////////////////////////////////////
+Ogre::v1::HardwareIndexBufferSharedPtr CreateIndexBuffer(
+    const std::vector<uint32_t> &_indices, size_t _vertexCount)
+{
+  // submeshes with few enough vertices get 16 bit indices, which halve the
+  // size of their index buffers without any loss
+  bool use16Bit = Use16BitIndices(_vertexCount);
+  Ogre::v1::HardwareIndexBufferSharedPtr buffer =
+      Ogre::v1::HardwareBufferManager::getSingleton().createIndexBuffer(
+          use16Bit ? Ogre::v1::HardwareIndexBuffer::IT_16BIT :
+          Ogre::v1::HardwareIndexBuffer::IT_32BIT, _indices.size(),
+          Ogre::v1::HardwareBuffer::HBU_STATIC, true);
+
+  void *data = buffer->lock(Ogre::v1::HardwareBuffer::HBL_DISCARD);
+  if (use16Bit)
+  {
+    uint16_t *indices = static_cast<uint16_t *>(data);
+    for (size_t i = 0u; i < _indices.size(); ++i)
+      indices[i] = static_cast<uint16_t>(_indices[i]);
+  }
+  else
+  {
+    std::memcpy(data, _indices.data(), _indices.size() * sizeof(uint32_t));
+  }
+  buffer->unlock();
+  return buffer;
+}
+
+//////////////////////////////////////////////////
+void CreateLodLevels(const PackedMesh &_packedMesh, double _lodDistance,
+    Ogre::v1::Mesh *_ogreMesh)
+{
+  if (_packedMesh.empty() || _packedMesh.front().lodIndices.empty())
+    return;
+
+  // the levels share the vertex buffers of the full detail submeshes, only
+  // their index buffers are reduced
+  size_t lodCount = _packedMesh.front().lodIndices.size();
+  _ogreMesh->_setLodInfo(static_cast<unsigned short>(lodCount + 1u));
+
+  const Ogre::LodStrategy *strategy =
+      Ogre::LodStrategyManager::getSingleton().getDefaultStrategy();
+  for (size_t l = 1u; l <= lodCount; ++l)
+  {
+    Ogre::v1::MeshLodUsage usage;
+    usage.userValue = static_cast<Ogre::Real>(
+        _lodDistance * std::pow(2.0, l - 1u));
+    usage.value = strategy->transformUserValue(usage.userValue);
+    usage.edgeData = nullptr;
+    _ogreMesh->_setLodUsage(static_cast<unsigned short>(l), usage);
+  }
+
+  for (size_t i = 0u; i < _packedMesh.size(); ++i)
+  {
+    Ogre::v1::SubMesh *ogreSubMesh = _ogreMesh->getSubMesh(
+        static_cast<unsigned short>(i));
+    for (size_t l = 0u; l < lodCount; ++l)
+    {
+      const std::vector<uint32_t> &indices = _packedMesh[i].lodIndices[l];
+      Ogre::v1::IndexData *indexData = OGRE_NEW Ogre::v1::IndexData();
+      indexData->indexCount = indices.size();
+      indexData->indexBuffer = CreateIndexBuffer(indices,
+          _packedMesh[i].subMesh.VertexCount());
+
+      ogreSubMesh->mLodFaceList[Ogre::VpNormal][l] = indexData;
+    }
+  }
+}
+
+/// \brief Largest position error of half float positions allowed by
+/// vertex compression, relative to the diagonal of the mesh bounds
+const double kHalfPositionMaxError = 1e-3;
+
+//////////////////////////////////////////////////
+bool HalfPositionsSuffice(const Ogre::AxisAlignedBox &_bounds)
+{
+  if (!_bounds.isFinite())
+    return false;
+
+  // half floats have an 11 bit significand so their rounding error grows
+  // with the largest coordinate of the mesh, and must stay small compared
+  // to the size of the mesh
+  double largest = 0.0;
+  for (size_t i = 0u; i < 3u; ++i)
+  {
+    largest = std::max({largest,
+        std::abs(static_cast<double>(_bounds.getMinimum()[i])),
+        std::abs(static_cast<double>(_bounds.getMaximum()[i]))});
+  }
+  double diagonal = _bounds.getSize().length();
+
+  // half floats overflow past 65504
+  return largest < 65504.0 && diagonal > 0.0 &&
+      largest * std::pow(2.0, -11) <= kHalfPositionMaxError * diagonal;
+}
+
+//////////////////////////////////////////////////
+Ogre::MeshPtr ImportV2Mesh(const std::string &_name, bool _compress)
+{
+  // check if a v2 mesh already exists
+  Ogre::MeshPtr mesh =
+      Ogre::MeshManager::getSingleton().getByName(_name);
+
+  // if not, it probably has not been imported from v1 yet
+  if (!mesh)
+  {
+    Ogre::v1::MeshPtr v1Mesh =
+        Ogre::v1::MeshManager::getSingleton().getByName(_name);
+    if (!v1Mesh)
+      return mesh;
+
+    // create v2 mesh from v1
+    mesh = Ogre::MeshManager::getSingleton().createManual(
+        _name, Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    // normals are always stored as QTangents and texture coordinates as
+    // half floats, positions only if compression is enabled and their
+    // precision suffices
+    bool halfPos = _compress && HalfPositionsSuffice(v1Mesh->getBounds());
+    mesh->importV1(v1Mesh.get(), halfPos, true, true);
+  }
+  return mesh;
+}
+
+//////////////////////////////////////////////////
+std::vector<const common::SubMesh *> DescriptorSubMeshes(
+    const MeshDescriptor &_desc)
+{
+  std::vector<const common::SubMesh *> subMeshes;
+  for (unsigned int i = 0; i < _desc.mesh->SubMeshCount(); ++i)
+  {
+    auto s = _desc.mesh->SubMeshByIndex(i).lock();
+    if (s && (_desc.subMeshName.empty() || s->Name() == _desc.subMeshName))
+      subMeshes.push_back(s.get());
+  }
+  return subMeshes;
+}
+
+}
+
 /// \brief Private data for the Ogre2MeshFactory class
 class ignition::rendering::Ogre2MeshFactoryPrivate
 {
+  /// \brief Build the bounding volume hierarchy of a mesh
+  /// \param[in] _meshName Name of the ogre mesh
+  /// \return The hierarchy or null if the mesh triangles are not available
+  public: std::unique_ptr<Ogre2MeshBvh> CreateBvh(
+      const std::string &_meshName);
+
+  /// \brief Get the cached bounding volume hierarchy of a mesh, building
+  /// it on first use
+  /// \param[in] _meshName Name of the ogre mesh
+  /// \return The hierarchy or null if the mesh triangles are not available
+  public: const Ogre2MeshBvh *Bvh(const std::string &_meshName);
+
   /// \brief Vector with the template materials, we keep the pointer to be
   /// able to remove it when nobody is using it.
   public: std::vector<MaterialPtr> materialCache;
+
+  /// \brief Bounding volume hierarchies used for ray queries of meshes
+  /// not shared with other scenes, built on demand and indexed by ogre
+  /// mesh name. Null entries are meshes whose triangles are not available.
+  public: std::unordered_map<std::string, std::unique_ptr<Ogre2MeshBvh>>
+      bvhs;
+
+  /// \brief Names of the materials of this scene used by the submeshes of
+  /// each ogre mesh, which differ from the ones referenced by the mesh when
+  /// it was loaded by another scene. Key: ogre mesh name
+  public: std::unordered_map<std::string, std::vector<std::string>>
+      subMeshMaterials;
+
+  /// \brief Submesh data packed ahead of time by Preload, consumed when
+  /// the mesh is loaded. Key: ogre mesh name
+  public: std::unordered_map<std::string, PackedMesh> packedMeshes;
+
+  /// \brief A mesh prepared by Prepare, waiting for its ogre mesh
+  public: struct PreparedMesh
+  {
+    /// \brief Loaded mesh descriptor
+    MeshDescriptor desc;
+
+    /// \brief Path to the cache file, empty if the mesh can't be cached
+    std::string cacheFile;
+
+    /// \brief Packed submesh data, empty if the mesh is read from the
+    /// cache
+    PackedMesh packed;
+  };
+
+  /// \brief Protects preparedMeshes and preparedNames
+  public: std::mutex preparedMutex;
+
+  /// \brief Meshes prepared since the last UploadPreparedMeshes
+  public: std::vector<PreparedMesh> preparedMeshes;
+
+  /// \brief Ogre mesh names of preparedMeshes and of the meshes being
+  /// prepared
+  public: std::unordered_set<std::string> preparedNames;
+
+  /// \brief Number of users of the retained meshes, indexed by ogre mesh
+  /// name
+  public: std::unordered_map<std::string, unsigned int> meshUsers;
+
+  /// \brief Buffers and latest vertices of a mesh whose vertices are
+  /// updated in place
+  public: struct DynamicMesh
+  {
+    /// \brief Position buffer of each submesh
+    std::vector<Ogre::VertexBufferPacked *> positionBuffers;
+
+    /// \brief Normal buffer of each submesh, null if it has no normals
+    std::vector<Ogre::VertexBufferPacked *> normalBuffers;
+
+    /// \brief Triangle indices of each submesh, empty for other primitives
+    std::vector<std::vector<uint32_t>> indices;
+
+    /// \brief Latest positions of all vertices, 3 floats per vertex
+    std::vector<float> positions;
+
+    /// \brief Bounding volume hierarchy of the latest positions, null
+    /// until the first ray query after an update
+    std::unique_ptr<Ogre2MeshBvh> bvh;
+  };
+
+  /// \brief Meshes created by DynamicOgreItem, indexed by ogre mesh name
+  public: std::unordered_map<std::string, DynamicMesh> dynamicMeshes;
+
+  /// \brief Directory of the on-disk mesh cache, empty if disabled
+  public: std::string cachePath;
+
+  /// \brief Number of reduced levels of detail generated for each mesh
+  public: unsigned int lodLevelCount = 0u;
+
+  /// \brief Camera distance at which the first reduced level of detail
+  /// is used
+  public: double lodDistance = 10.0;
+
+  /// \brief True to store positions as half floats where their precision
+  /// suffices
+  public: bool vertexCompression = false;
 };
 
 /// \brief Private data for the Ogre2SubMeshStoreFactory class
@@ -85,10 +537,79 @@ Ogre2MeshFactory::~Ogre2MeshFactory()
 //////////////////////////////////////////////////
 void Ogre2MeshFactory::Clear()
 {
+  // meshes still used by other scenes are kept
   for (auto &m : this->ogreMeshes)
-    Ogre::MeshManager::getSingleton().remove(m);
+  {
+    if (Ogre2RenderEngine::Instance()->SharedMeshes().Release(m, this))
+      Ogre::MeshManager::getSingleton().remove(m);
+  }
+
+  std::vector<std::string> dynamicMeshes;
+  for (const auto &dynamic : this->dataPtr->dynamicMeshes)
+    dynamicMeshes.push_back(dynamic.first);
+  for (const auto &name : dynamicMeshes)
+    this->DestroyDynamicMesh(name);
 
   this->ogreMeshes.clear();
+  this->dataPtr->bvhs.clear();
+  this->dataPtr->packedMeshes.clear();
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->preparedMutex);
+    this->dataPtr->preparedMeshes.clear();
+    this->dataPtr->preparedNames.clear();
+  }
+  this->dataPtr->meshUsers.clear();
+  this->dataPtr->subMeshMaterials.clear();
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactory::AcquireMesh(const std::string &_name)
+{
+  if (std::find(this->ogreMeshes.begin(), this->ogreMeshes.end(), _name) !=
+      this->ogreMeshes.end())
+    return;
+
+  this->ogreMeshes.push_back(_name);
+  Ogre2RenderEngine::Instance()->SharedMeshes().Acquire(_name, this);
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactory::RetainMesh(const MeshDescriptor &_desc)
+{
+  ++this->dataPtr->meshUsers[this->MeshName(_desc)];
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactory::ReleaseMesh(const MeshDescriptor &_desc)
+{
+  std::string name = this->MeshName(_desc);
+  auto it = this->dataPtr->meshUsers.find(name);
+  if (it == this->dataPtr->meshUsers.end())
+    return;
+
+  if (--it->second == 0u)
+  {
+    this->dataPtr->meshUsers.erase(it);
+    this->RemoveMesh(name);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactory::RemoveMesh(const std::string &_name)
+{
+  if (Ogre2RenderEngine::Instance()->SharedMeshes().Release(_name, this))
+  {
+    Ogre::MeshManager::getSingleton().remove(_name);
+
+    // the v1 mesh has to go as well for the mesh to be loaded again
+    Ogre::v1::MeshManager::getSingleton().remove(_name);
+  }
+
+  this->ogreMeshes.erase(std::remove(this->ogreMeshes.begin(),
+      this->ogreMeshes.end(), _name), this->ogreMeshes.end());
+  this->dataPtr->bvhs.erase(_name);
+  this->dataPtr->packedMeshes.erase(_name);
+  this->dataPtr->subMeshMaterials.erase(_name);
 }
 
 //////////////////////////////////////////////////
@@ -110,6 +631,139 @@ void Ogre2MeshFactory::ClearMaterialsCache(const std::string &_name)
     this->dataPtr->materialCache.erase(it);
 }
 
+//////////////////////////////////////////////////
+bool Ogre2MeshFactory::Intersect(const std::string &_meshName,
+    const Ogre::Ray &_ray, double &_distance)
+{
+  const Ogre2MeshBvh *bvh = this->dataPtr->Bvh(_meshName);
+  if (!bvh)
+    return false;
+
+  return bvh->Intersect(_ray, _distance);
+}
+
+//////////////////////////////////////////////////
+const std::vector<Ogre::Vector3> *Ogre2MeshFactory::Triangles(
+    const std::string &_meshName)
+{
+  const Ogre2MeshBvh *bvh = this->dataPtr->Bvh(_meshName);
+  if (!bvh)
+    return nullptr;
+
+  return &bvh->Vertices();
+}
+
+//////////////////////////////////////////////////
+const Ogre2MeshBvh *Ogre2MeshFactoryPrivate::Bvh(const std::string &_meshName)
+{
+  // the triangles of meshes updated in place are rebuilt from their latest
+  // vertices
+  auto dynamicIt = this->dynamicMeshes.find(_meshName);
+  if (dynamicIt != this->dynamicMeshes.end())
+  {
+    DynamicMesh &dynamic = dynamicIt->second;
+    if (!dynamic.bvh)
+    {
+      std::vector<Ogre::Vector3> vertices;
+      size_t offset = 0u;
+      for (size_t i = 0u; i < dynamic.positionBuffers.size(); ++i)
+      {
+        for (uint32_t index : dynamic.indices[i])
+        {
+          const float *p = &dynamic.positions[(offset + index) * 3u];
+          vertices.emplace_back(p[0], p[1], p[2]);
+        }
+        offset += dynamic.positionBuffers[i]->getNumElements();
+      }
+      dynamic.bvh = std::make_unique<Ogre2MeshBvh>();
+      dynamic.bvh->Build(vertices);
+    }
+    return dynamic.bvh.get();
+  }
+
+  const Ogre2MeshBvh *bvh = nullptr;
+  if (Ogre2RenderEngine::Instance()->SharedMeshes().Bvh(_meshName,
+      [&]() { return this->CreateBvh(_meshName); }, bvh))
+  {
+    return bvh;
+  }
+
+  auto it = this->bvhs.find(_meshName);
+  if (it == this->bvhs.end())
+    it = this->bvhs.emplace(_meshName, this->CreateBvh(_meshName)).first;
+  return it->second.get();
+}
+
+//////////////////////////////////////////////////
+std::unique_ptr<Ogre2MeshBvh> Ogre2MeshFactoryPrivate::CreateBvh(
+    const std::string &_meshName)
+{
+  // the hierarchy of a shared mesh is built by whichever scene queries it
+  // first, so it is only derived from the mesh name, which follows the
+  // naming convention of Ogre2MeshFactory::MeshName, and never from the
+  // descriptors of this scene
+  MeshDescriptor desc;
+  desc.meshName = _meshName;
+  const size_t centerSep = _meshName.rfind("::");
+  if (centerSep != std::string::npos && centerSep > 0u)
+  {
+    const size_t subMeshSep = _meshName.rfind("::", centerSep - 1u);
+    if (subMeshSep != std::string::npos)
+    {
+      desc.meshName = _meshName.substr(0, subMeshSep);
+      desc.subMeshName = _meshName.substr(subMeshSep + 2u,
+          centerSep - subMeshSep - 2u);
+      desc.centerSubMesh =
+          _meshName.compare(centerSep + 2u, std::string::npos,
+          "CENTERED") == 0;
+    }
+    else
+    {
+      desc.meshName = _meshName.substr(0, centerSep);
+    }
+  }
+
+  // look up the mesh by name rather than holding on to the descriptor's
+  // mesh pointer, which is owned by the common::MeshManager
+  const common::Mesh *mesh = nullptr;
+  {
+    std::lock_guard<std::recursive_mutex> lock(meshManagerMutex());
+    mesh = common::MeshManager::Instance()->MeshByName(desc.meshName);
+  }
+  if (!mesh)
+    return nullptr;
+
+  std::vector<Ogre::Vector3> vertices;
+  for (unsigned int i = 0; i < mesh->SubMeshCount(); ++i)
+  {
+    auto s = mesh->SubMeshByIndex(i).lock();
+    if (!s || s->VertexCount() < 3u)
+      continue;
+
+    if (!desc.subMeshName.empty() && s->Name() != desc.subMeshName)
+      continue;
+
+    // recenter the vertices the same way they were when loading the mesh
+    common::SubMesh subMesh(*s.get());
+    if (desc.centerSubMesh)
+      subMesh.Center(math::Vector3d::Zero);
+
+    unsigned int indexCount = subMesh.IndexCount();
+    for (unsigned int k = 0; k + 2 < indexCount; k += 3)
+    {
+      for (unsigned int v = 0; v < 3u; ++v)
+      {
+        vertices.push_back(Ogre2Conversions::Convert(
+            subMesh.Vertex(subMesh.Index(k + v))));
+      }
+    }
+  }
+
+  std::unique_ptr<Ogre2MeshBvh> bvh = std::make_unique<Ogre2MeshBvh>();
+  bvh->Build(vertices);
+  return bvh;
+}
+
 //////////////////////////////////////////////////
 Ogre2MeshPtr Ogre2MeshFactory::Create(const MeshDescriptor &_desc)
 {
@@ -139,6 +793,142 @@ Ogre2MeshPtr Ogre2MeshFactory::Create(const MeshDescriptor &_desc)
   return mesh;
 }
 
+//////////////////////////////////////////////////
+void Ogre2MeshFactory::Preload(const std::vector<MeshDescriptor> &_descs)
+{
+  // the meshes are resolved on the calling thread, as the lookups in the
+  // common::MeshManager are serialized anyway
+  std::vector<MeshDescriptor> descs;
+  std::vector<std::string> cacheFiles;
+  std::unordered_set<std::string> names;
+  for (const auto &desc : _descs)
+  {
+    MeshDescriptor normDesc = desc;
+    normDesc.Load();
+    if (!this->Validate(normDesc) || this->IsLoaded(normDesc))
+      continue;
+
+    if (!names.insert(this->MeshName(normDesc)).second)
+      continue;
+
+    std::string cacheFile = this->CacheFile(normDesc);
+    if (!cacheFile.empty() && this->LoadFromCache(normDesc, cacheFile))
+      continue;
+
+    descs.push_back(normDesc);
+    cacheFiles.push_back(cacheFile);
+  }
+
+  if (descs.empty())
+    return;
+
+  // pack the vertex and index data of the meshes on worker threads
+  std::vector<PackedMesh> packedMeshes(descs.size());
+  unsigned int lodLevelCount = this->dataPtr->lodLevelCount;
+  std::atomic<size_t> next(0u);
+  auto packMeshes = [&]()
+  {
+    for (size_t i = next++; i < descs.size(); i = next++)
+      PackMesh(descs[i], lodLevelCount, true, packedMeshes[i]);
+  };
+
+  size_t threadCount = std::min<size_t>(descs.size(),
+      std::max(1u, std::thread::hardware_concurrency()));
+  std::vector<std::thread> threads;
+  for (size_t i = 1u; i < threadCount; ++i)
+    threads.emplace_back(packMeshes);
+  packMeshes();
+  for (auto &thread : threads)
+    thread.join();
+
+  // create the ogre meshes from the packed data
+  for (size_t i = 0u; i < descs.size(); ++i)
+  {
+    this->dataPtr->packedMeshes[this->MeshName(descs[i])] =
+        std::move(packedMeshes[i]);
+    this->LoadPacked(descs[i], cacheFiles[i]);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactory::Prepare(const MeshDescriptor &_desc)
+{
+  MeshDescriptor normDesc = _desc;
+  normDesc.Load();
+  if (!this->Validate(normDesc))
+    return;
+
+  // the same mesh prepared by several threads is packed once
+  std::string name = this->MeshName(normDesc);
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->preparedMutex);
+    if (!this->dataPtr->preparedNames.insert(name).second)
+      return;
+  }
+
+  // cached meshes are read by the render thread, there is nothing to pack
+  Ogre2MeshFactoryPrivate::PreparedMesh prepared;
+  prepared.desc = normDesc;
+  prepared.cacheFile = this->CacheFile(normDesc);
+  if (prepared.cacheFile.empty() || !common::isFile(prepared.cacheFile))
+    PackMesh(normDesc, this->dataPtr->lodLevelCount, true, prepared.packed);
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->preparedMutex);
+  this->dataPtr->preparedMeshes.push_back(std::move(prepared));
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2MeshFactory::UploadPreparedMeshes()
+{
+  std::vector<Ogre2MeshFactoryPrivate::PreparedMesh> prepared;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->preparedMutex);
+    if (this->dataPtr->preparedMeshes.empty())
+      return 0u;
+    prepared.swap(this->dataPtr->preparedMeshes);
+    for (const auto &mesh : prepared)
+      this->dataPtr->preparedNames.erase(this->MeshName(mesh.desc));
+  }
+
+  unsigned int count = 0u;
+  for (auto &mesh : prepared)
+  {
+    if (this->IsLoaded(mesh.desc))
+      continue;
+
+    ++count;
+    if (!mesh.cacheFile.empty() &&
+        this->LoadFromCache(mesh.desc, mesh.cacheFile))
+    {
+      continue;
+    }
+
+    // a mesh whose cache file could not be read is packed by LoadImpl
+    if (!mesh.packed.empty())
+    {
+      this->dataPtr->packedMeshes[this->MeshName(mesh.desc)] =
+          std::move(mesh.packed);
+    }
+    this->LoadPacked(mesh.desc, mesh.cacheFile);
+  }
+  return count;
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactory::LoadPacked(const MeshDescriptor &_desc,
+    const std::string &_cacheFile)
+{
+  std::string name = this->MeshName(_desc);
+  if (this->LoadImpl(_desc))
+  {
+    if (!_cacheFile.empty())
+      this->SaveToCache(_desc, _cacheFile);
+    else if (ImportV2Mesh(name, this->dataPtr->vertexCompression))
+      this->AcquireMesh(name);
+  }
+  this->dataPtr->packedMeshes.erase(name);
+}
+
 //////////////////////////////////////////////////
 Ogre::Item *Ogre2MeshFactory::OgreItem(const MeshDescriptor &_desc)
 {
@@ -150,26 +940,307 @@ Ogre::Item *Ogre2MeshFactory::OgreItem(const MeshDescriptor &_desc)
   std::string name = this->MeshName(_desc);
   Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
 
-  // check if a v2 mesh already exists
-  Ogre::MeshPtr mesh =
-      Ogre::MeshManager::getSingleton().getByName(name);
-
-  // if not, it probably has not been imported from v1 yet
+  Ogre::MeshPtr mesh = ImportV2Mesh(name, this->dataPtr->vertexCompression);
   if (!mesh)
+    return nullptr;
+  this->AcquireMesh(name);
+
+  Ogre::Item *item = sceneManager->createItem(mesh, Ogre::SCENE_DYNAMIC);
+
+  // a mesh loaded by another scene refers to the materials of that scene,
+  // the items of this scene use materials created in this scene instead
+  auto matIt = this->dataPtr->subMeshMaterials.find(name);
+  if (matIt == this->dataPtr->subMeshMaterials.end())
   {
-    Ogre::v1::MeshPtr v1Mesh =
-        Ogre::v1::MeshManager::getSingleton().getByName(name);
-    if (!v1Mesh)
+    std::vector<std::string> matNames;
+    bool ownMaterials = true;
+    for (unsigned int i = 0; i < mesh->getNumSubMeshes(); ++i)
+    {
+      matNames.push_back(mesh->getSubMesh(i)->getMaterialName());
+      ownMaterials = ownMaterials &&
+          this->scene->Material(matNames.back()) != nullptr;
+    }
+
+    std::vector<const common::SubMesh *> subMeshes =
+        DescriptorSubMeshes(_desc);
+    if (!ownMaterials && subMeshes.size() == matNames.size())
+    {
+      for (unsigned int i = 0; i < subMeshes.size(); ++i)
+        matNames[i] = this->CreateSubMeshMaterial(_desc, *subMeshes[i]);
+    }
+    matIt = this->dataPtr->subMeshMaterials.emplace(name, matNames).first;
+  }
+
+  for (unsigned int i = 0; i < matIt->second.size() &&
+      i < item->getNumSubItems(); ++i)
+  {
+    if (matIt->second[i] == mesh->getSubMesh(i)->getMaterialName())
+      continue;
+
+    Ogre2MaterialPtr mat = std::dynamic_pointer_cast<Ogre2Material>(
+        this->scene->Material(matIt->second[i]));
+    if (mat)
+      item->getSubItem(i)->setDatablock(mat->Datablock());
+  }
+
+  this->scene->MarkVisibilityLayersDirty();
+  return item;
+}
+
+//////////////////////////////////////////////////
+Ogre::Item *Ogre2MeshFactory::DynamicOgreItem(const MeshDescriptor &_desc,
+    const std::string &_name)
+{
+  MeshDescriptor normDesc = _desc;
+  normDesc.Load();
+  if (!this->Validate(normDesc))
+    return nullptr;
+
+  PackedMesh packedMesh;
+  // the vertices keep their order, updates refer to it
+  PackMesh(normDesc, 0u, false, packedMesh);
+  if (packedMesh.empty())
+    return nullptr;
+
+  for (const PackedSubMesh &packed : packedMesh)
+  {
+    if (packed.subMesh.VertexCount() == 0u)
+    {
+      ignerr << "Unable to update the vertices of mesh [" << _desc.meshName
+             << "] in place, submesh [" << packed.subMesh.Name()
+             << "] has no vertices" << std::endl;
       return nullptr;
+    }
+  }
 
-    // create v2 mesh from v1
-    mesh = Ogre::MeshManager::getSingleton().createManual(
-        name, Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
-    mesh->importV1(v1Mesh.get(), false, true, true);
-    this->ogreMeshes.push_back(name);
+  Ogre::VaoManager *vaoManager =
+      Ogre::Root::getSingleton().getRenderSystem()->getVaoManager();
+  Ogre::MeshPtr mesh = Ogre::MeshManager::getSingleton().createManual(
+      _name, Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+  Ogre2MeshFactoryPrivate::DynamicMesh dynamic;
+  Ogre::Aabb bounds;
+  bool hasBounds = false;
+  for (const PackedSubMesh &packed : packedMesh)
+  {
+    const common::SubMesh &subMesh = packed.subMesh;
+    unsigned int vertexCount = subMesh.VertexCount();
+
+    // positions and normals go in their own buffers so that they can be
+    // uploaded without touching the texture coordinates
+    std::vector<float> positions;
+    std::vector<float> normals;
+    std::vector<float> texCoords;
+    positions.reserve(vertexCount * 3u);
+    for (unsigned int j = 0u; j < vertexCount; ++j)
+    {
+      Ogre::Vector3 v = Ogre2Conversions::Convert(subMesh.Vertex(j));
+      positions.insert(positions.end(), {v.x, v.y, v.z});
+      if (!hasBounds)
+        bounds = Ogre::Aabb(v, Ogre::Vector3::ZERO);
+      else
+        bounds.merge(v);
+      hasBounds = true;
+
+      if (subMesh.NormalCount() > 0u)
+      {
+        math::Vector3d n = subMesh.Normal(j);
+        normals.insert(normals.end(), {static_cast<float>(n.X()),
+            static_cast<float>(n.Y()), static_cast<float>(n.Z())});
+      }
+
+      for (unsigned int k = 0u; k < subMesh.TexCoordSetCount(); ++k)
+      {
+        if (subMesh.TexCoordCountBySet(k) > 0u)
+        {
+          math::Vector2d uv = subMesh.TexCoordBySet(j, k);
+          texCoords.insert(texCoords.end(), {static_cast<float>(uv.X()),
+              static_cast<float>(uv.Y())});
+        }
+      }
+    }
+
+    Ogre::VertexBufferPackedVec vertexBuffers;
+    Ogre::VertexElement2Vec positionElements;
+    positionElements.push_back(
+        Ogre::VertexElement2(Ogre::VET_FLOAT3, Ogre::VES_POSITION));
+    vertexBuffers.push_back(vaoManager->createVertexBuffer(positionElements,
+        vertexCount, Ogre::BT_DEFAULT, positions.data(), false));
+    dynamic.positionBuffers.push_back(vertexBuffers.back());
+
+    Ogre::VertexBufferPacked *normalBuffer = nullptr;
+    if (!normals.empty())
+    {
+      Ogre::VertexElement2Vec normalElements;
+      normalElements.push_back(
+          Ogre::VertexElement2(Ogre::VET_FLOAT3, Ogre::VES_NORMAL));
+      normalBuffer = vaoManager->createVertexBuffer(normalElements,
+          vertexCount, Ogre::BT_DEFAULT, normals.data(), false);
+      vertexBuffers.push_back(normalBuffer);
+    }
+    dynamic.normalBuffers.push_back(normalBuffer);
+
+    if (!texCoords.empty())
+    {
+      Ogre::VertexElement2Vec texCoordElements;
+      for (unsigned int k = 0u; k < subMesh.TexCoordSetCount(); ++k)
+      {
+        if (subMesh.TexCoordCountBySet(k) > 0u)
+        {
+          texCoordElements.push_back(Ogre::VertexElement2(Ogre::VET_FLOAT2,
+              Ogre::VES_TEXTURE_COORDINATES));
+        }
+      }
+      vertexBuffers.push_back(vaoManager->createVertexBuffer(
+          texCoordElements, vertexCount, Ogre::BT_IMMUTABLE,
+          texCoords.data(), false));
+    }
+
+    Ogre::IndexBufferPacked *indexBuffer = nullptr;
+    if (!packed.indices.empty())
+    {
+      if (Use16BitIndices(vertexCount))
+      {
+        std::vector<uint16_t> indices(packed.indices.begin(),
+            packed.indices.end());
+        indexBuffer = vaoManager->createIndexBuffer(
+            Ogre::IndexBufferPacked::IT_16BIT, indices.size(),
+            Ogre::BT_IMMUTABLE, indices.data(), false);
+      }
+      else
+      {
+        indexBuffer = vaoManager->createIndexBuffer(
+            Ogre::IndexBufferPacked::IT_32BIT, packed.indices.size(),
+            Ogre::BT_IMMUTABLE,
+            const_cast<uint32_t *>(packed.indices.data()), false);
+      }
+    }
+
+    Ogre::OperationType operationType = Ogre::OT_TRIANGLE_LIST;
+    switch (subMesh.SubMeshPrimitiveType())
+    {
+      case common::SubMesh::POINTS:
+        operationType = Ogre::OT_POINT_LIST;
+        break;
+      case common::SubMesh::LINES:
+        operationType = Ogre::OT_LINE_LIST;
+        break;
+      case common::SubMesh::LINESTRIPS:
+        operationType = Ogre::OT_LINE_STRIP;
+        break;
+      case common::SubMesh::TRISTRIPS:
+        operationType = Ogre::OT_TRIANGLE_STRIP;
+        break;
+      case common::SubMesh::TRIFANS:
+        operationType = Ogre::OT_TRIANGLE_FAN;
+        break;
+      default:
+        break;
+    }
+
+    Ogre::VertexArrayObject *vao = vaoManager->createVertexArrayObject(
+        vertexBuffers, indexBuffer, operationType);
+    Ogre::SubMesh *ogreSubMesh = mesh->createSubMesh();
+    ogreSubMesh->mVao[Ogre::VpNormal].push_back(vao);
+    // use the same geometry for shadow casting
+    ogreSubMesh->mVao[Ogre::VpShadow].push_back(vao);
+
+    // only triangle lists are hit by ray queries
+    std::vector<uint32_t> triangles;
+    if (operationType == Ogre::OT_TRIANGLE_LIST)
+    {
+      triangles.assign(packed.indices.begin(), packed.indices.begin() +
+          packed.indices.size() / 3u * 3u);
+    }
+    dynamic.indices.push_back(std::move(triangles));
+    dynamic.positions.insert(dynamic.positions.end(), positions.begin(),
+        positions.end());
+  }
+
+  mesh->_setBounds(bounds, false);
+  mesh->_setBoundingSphereRadius(bounds.getRadius());
+
+  this->dataPtr->dynamicMeshes[_name] = std::move(dynamic);
+  Ogre::Item *item = this->scene->OgreSceneManager()->createItem(mesh,
+      Ogre::SCENE_DYNAMIC);
+  this->scene->MarkVisibilityLayersDirty();
+  return item;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MeshFactory::UpdateDynamicMesh(const std::string &_name,
+    const float *_positions, const float *_normals,
+    unsigned int _vertexCount, Ogre::Aabb &_bounds)
+{
+  auto it = this->dataPtr->dynamicMeshes.find(_name);
+  if (it == this->dataPtr->dynamicMeshes.end())
+    return false;
+
+  Ogre2MeshFactoryPrivate::DynamicMesh &dynamic = it->second;
+  if (!_positions || _vertexCount * 3u != dynamic.positions.size())
+  {
+    ignerr << "Unable to update the vertices of mesh [" << _name
+           << "], expected " << dynamic.positions.size() / 3u
+           << " vertices but got " << _vertexCount << std::endl;
+    return false;
   }
 
-  return sceneManager->createItem(mesh, Ogre::SCENE_DYNAMIC);
+  std::copy(_positions, _positions + dynamic.positions.size(),
+      dynamic.positions.begin());
+
+  size_t offset = 0u;
+  for (size_t i = 0u; i < dynamic.positionBuffers.size(); ++i)
+  {
+    size_t count = dynamic.positionBuffers[i]->getNumElements();
+    dynamic.positionBuffers[i]->upload(_positions + offset * 3u, 0u, count);
+    if (_normals && dynamic.normalBuffers[i])
+      dynamic.normalBuffers[i]->upload(_normals + offset * 3u, 0u, count);
+    offset += count;
+  }
+
+  Ogre::Vector3 min(_positions[0], _positions[1], _positions[2]);
+  Ogre::Vector3 max = min;
+  for (unsigned int i = 1u; i < _vertexCount; ++i)
+  {
+    Ogre::Vector3 v(_positions[i * 3u], _positions[i * 3u + 1u],
+        _positions[i * 3u + 2u]);
+    min.makeFloor(v);
+    max.makeCeil(v);
+  }
+  _bounds = Ogre::Aabb::newFromExtents(min, max);
+
+  Ogre::MeshPtr mesh = Ogre::MeshManager::getSingleton().getByName(_name);
+  if (mesh)
+  {
+    mesh->_setBounds(_bounds, false);
+    mesh->_setBoundingSphereRadius(_bounds.getRadius());
+  }
+
+  // rebuilt on the next ray query
+  dynamic.bvh.reset();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactory::DestroyDynamicMesh(const std::string &_name)
+{
+  if (this->dataPtr->dynamicMeshes.erase(_name) == 0u)
+    return;
+
+  Ogre::MeshPtr mesh = Ogre::MeshManager::getSingleton().getByName(_name);
+  if (!mesh)
+    return;
+
+  // the buffers are not shared so they go with the vaos
+  Ogre::VaoManager *vaoManager =
+      Ogre::Root::getSingleton().getRenderSystem()->getVaoManager();
+  for (unsigned int i = 0u; i < mesh->getNumSubMeshes(); ++i)
+  {
+    Ogre::SubMesh *subMesh = mesh->getSubMesh(i);
+    subMesh->destroyVaos(subMesh->mVao[Ogre::VpNormal], vaoManager);
+    subMesh->mVao[Ogre::VpShadow].clear();
+  }
+  Ogre::MeshManager::getSingleton().remove(_name);
 }
 
 //////////////////////////////////////////////////
@@ -185,7 +1256,211 @@ bool Ogre2MeshFactory::Load(const MeshDescriptor &_desc)
     return true;
   }
 
-  return this->LoadImpl(_desc);
+  std::string cacheFile = this->CacheFile(_desc);
+  if (!cacheFile.empty() && this->LoadFromCache(_desc, cacheFile))
+    return true;
+
+  if (!this->LoadImpl(_desc))
+    return false;
+
+  if (!cacheFile.empty())
+    this->SaveToCache(_desc, cacheFile);
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactory::SetCachePath(const std::string &_path)
+{
+  this->dataPtr->cachePath = _path;
+  if (!_path.empty() && !common::exists(_path) &&
+      !common::createDirectories(_path))
+  {
+    ignerr << "Unable to create mesh cache directory [" << _path << "]"
+           << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2MeshFactory::CachePath() const
+{
+  return this->dataPtr->cachePath;
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactory::SetLodLevelCount(unsigned int _count)
+{
+  this->dataPtr->lodLevelCount = _count;
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2MeshFactory::LodLevelCount() const
+{
+  return this->dataPtr->lodLevelCount;
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactory::SetLodDistance(double _distance)
+{
+  this->dataPtr->lodDistance = _distance;
+}
+
+//////////////////////////////////////////////////
+double Ogre2MeshFactory::LodDistance() const
+{
+  return this->dataPtr->lodDistance;
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactory::SetVertexCompression(bool _compress)
+{
+  this->dataPtr->vertexCompression = _compress;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MeshFactory::VertexCompression() const
+{
+  return this->dataPtr->vertexCompression;
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2MeshFactory::CacheFile(const MeshDescriptor &_desc)
+{
+  if (this->dataPtr->cachePath.empty())
+    return std::string();
+
+  // skeletons are not part of the serialized v2 mesh and meshes not loaded
+  // from a file have no source to identify them across runs
+  if (_desc.mesh->HasSkeleton() || !common::isFile(_desc.mesh->Name()))
+    return std::string();
+
+  std::ifstream source(_desc.mesh->Name(), std::ios::binary);
+  std::string content((std::istreambuf_iterator<char>(source)),
+      std::istreambuf_iterator<char>());
+  if (!source.good() && !source.eof())
+    return std::string();
+
+  // the key covers the path, size and digest of the source file, the
+  // descriptor options that change the vertex data and the ogre version
+  // writing the mesh
+  std::stringstream key;
+  key << common::sha1<std::string>(content) << "::" << content.size()
+      << "::" << _desc.mesh->Name() << "::" << this->MeshName(_desc)
+      << "::" << this->dataPtr->lodLevelCount << "::"
+      << this->dataPtr->lodDistance << "::"
+      << this->dataPtr->vertexCompression << "::" << kPackedMeshVersion
+      << "::" << OGRE_VERSION_MAJOR
+      << "." << OGRE_VERSION_MINOR << "." << OGRE_VERSION_PATCH;
+
+  return common::joinPaths(this->dataPtr->cachePath,
+      common::sha1<std::string>(key.str()) + ".mesh");
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MeshFactory::LoadFromCache(const MeshDescriptor &_desc,
+    const std::string &_file)
+{
+  if (!common::isFile(_file))
+    return false;
+
+  std::string name = this->MeshName(_desc);
+  Ogre::MeshPtr mesh;
+  try
+  {
+    std::ifstream stream(_file, std::ios::binary);
+    Ogre::DataStreamPtr dataStream(
+        OGRE_NEW Ogre::FileStreamDataStream(_file, &stream, false));
+
+    mesh = Ogre::MeshManager::getSingleton().createManual(
+        name, Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    Ogre::Root *root = Ogre2RenderEngine::Instance()->OgreRoot();
+    Ogre::MeshSerializer serializer(root->getRenderSystem()->getVaoManager());
+    serializer.importMesh(dataStream, mesh.get());
+  }
+  catch(Ogre::Exception &e)
+  {
+    ignwarn << "Unable to load mesh [" << name << "] from cache file ["
+            << _file << "]: " << e.getDescription() << std::endl;
+    if (mesh)
+      Ogre::MeshManager::getSingleton().remove(mesh);
+    return false;
+  }
+
+  // material names change between runs so the materials are created again
+  // for the submeshes, loaded in the same order as by LoadImpl
+  std::vector<const common::SubMesh *> subMeshes = DescriptorSubMeshes(_desc);
+
+  if (subMeshes.size() != mesh->getNumSubMeshes())
+  {
+    ignwarn << "Mesh cache file [" << _file << "] does not match mesh ["
+            << name << "]" << std::endl;
+    Ogre::MeshManager::getSingleton().remove(mesh);
+    return false;
+  }
+
+  for (unsigned int i = 0; i < subMeshes.size(); ++i)
+  {
+    mesh->getSubMesh(i)->setMaterialName(
+        this->CreateSubMeshMaterial(_desc, *subMeshes[i]));
+  }
+
+  Ogre2RenderEngine::Instance()->AddResourcePath(_desc.mesh->Path());
+  this->AcquireMesh(name);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactory::SaveToCache(const MeshDescriptor &_desc,
+    const std::string &_file)
+{
+  Ogre::MeshPtr mesh = ImportV2Mesh(this->MeshName(_desc),
+      this->dataPtr->vertexCompression);
+  if (!mesh)
+    return;
+  this->AcquireMesh(mesh->getName());
+
+  // concurrent processes sharing the cache never read a partially written
+  // mesh
+  writeFileAtomically(_file, [&](const std::string &_tmpFile)
+  {
+    try
+    {
+      Ogre::Root *root = Ogre2RenderEngine::Instance()->OgreRoot();
+      Ogre::MeshSerializer serializer(
+          root->getRenderSystem()->getVaoManager());
+      serializer.exportMesh(mesh.get(), _tmpFile);
+    }
+    catch(Ogre::Exception &e)
+    {
+      ignwarn << "Unable to save mesh [" << mesh->getName()
+              << "] to cache file [" << _file << "]: " << e.getDescription()
+              << std::endl;
+      return false;
+    }
+    return true;
+  });
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2MeshFactory::CreateSubMeshMaterial(
+    const MeshDescriptor &_desc, const common::SubMesh &_subMesh)
+{
+  common::MaterialPtr material;
+  material = _desc.mesh->MaterialByIndex(_subMesh.MaterialIndex());
+
+  MaterialPtr mat = this->scene->CreateMaterial();
+  if (material)
+  {
+    mat->CopyFrom(*material);
+    this->dataPtr->materialCache.push_back(mat);
+  }
+  else
+  {
+    MaterialPtr defaultMat = this->scene->Material("Default/White");
+    if (defaultMat != nullptr)
+      mat->CopyFrom(defaultMat);
+  }
+  return mat->Name();
 }
 
 //////////////////////////////////////////////////
@@ -293,33 +1568,30 @@ bool Ogre2MeshFactory::LoadImpl(const MeshDescriptor &_desc)
       ogreMesh->setSkeletonName(_desc.mesh->Name() + "_skeleton");
     }
 
-    for (unsigned int i = 0; i < _desc.mesh->SubMeshCount(); i++)
+    // use the submesh data packed by Preload if available
+    PackedMesh packedMesh;
+    auto packedIt = this->dataPtr->packedMeshes.find(name);
+    if (packedIt != this->dataPtr->packedMeshes.end())
     {
-      // if submesh is specified then load only that particular submesh
-      auto s = _desc.mesh->SubMeshByIndex(i).lock();
-      if (!_desc.subMeshName.empty() && s &&
-          s->Name() != _desc.subMeshName)
-      {
-        continue;
-      }
+      packedMesh = std::move(packedIt->second);
+      this->dataPtr->packedMeshes.erase(packedIt);
+    }
+    else
+    {
+      PackMesh(_desc, this->dataPtr->lodLevelCount, true, packedMesh);
+    }
 
+    for (const PackedSubMesh &packed : packedMesh)
+    {
       Ogre::v1::SubMesh *ogreSubMesh;
       Ogre::v1::VertexData *vertexData;
       Ogre::v1::VertexDeclaration* vertexDecl;
       Ogre::v1::HardwareVertexBufferSharedPtr vBuf;
-      Ogre::v1::HardwareIndexBufferSharedPtr iBuf;
       float *vertices;
-      uint32_t *indices;
 
       size_t currOffset = 0;
 
-      // Copy the original submesh. We may need to modify the vertices, and
-      // we don't want to change the original.
-      common::SubMesh subMesh(*s.get());
-
-      // Recenter the vertices if requested.
-      if (_desc.centerSubMesh)
-        subMesh.Center(math::Vector3d::Zero);
+      const common::SubMesh &subMesh = packed.subMesh;
 
       ogreSubMesh = ogreMesh->createSubMesh(subMesh.Name());
       ogreSubMesh->useSharedVertices = false;
@@ -420,30 +1692,8 @@ bool Ogre2MeshFactory::LoadImpl(const MeshDescriptor &_desc)
       }
 
       // Add all the vertices
-      for (unsigned int j = 0; j < subMesh.VertexCount(); ++j)
-      {
-        *vertices++ = subMesh.Vertex(j).X();
-        *vertices++ = subMesh.Vertex(j).Y();
-        *vertices++ = subMesh.Vertex(j).Z();
-
-        // Add all normals
-        if (subMesh.NormalCount() > 0)
-        {
-          *vertices++ = subMesh.Normal(j).X();
-          *vertices++ = subMesh.Normal(j).Y();
-          *vertices++ = subMesh.Normal(j).Z();
-        }
-
-        // Add all texture coordinate sets
-        for (unsigned int k = 0u; k < subMesh.TexCoordSetCount(); ++k)
-        {
-          if (subMesh.TexCoordCountBySet(k) > 0u)
-          {
-            *vertices++ = subMesh.TexCoordBySet(j, k).X();
-            *vertices++ = subMesh.TexCoordBySet(j, k).Y();
-          }
-        }
-      }
+      std::memcpy(vertices, packed.vertices.data(),
+          packed.vertices.size() * sizeof(float));
 
       vBuf->unlock();
 
@@ -452,38 +1702,10 @@ bool Ogre2MeshFactory::LoadImpl(const MeshDescriptor &_desc)
       ogreSubMesh->indexData[Ogre::VpNormal]->indexCount = subMesh.IndexCount();
 
       ogreSubMesh->indexData[Ogre::VpNormal]->indexBuffer =
-        Ogre::v1::HardwareBufferManager::getSingleton().createIndexBuffer(
-            Ogre::v1::HardwareIndexBuffer::IT_32BIT,
-            ogreSubMesh->indexData[Ogre::VpNormal]->indexCount,
-            Ogre::v1::HardwareBuffer::HBU_STATIC,
-            true);
-
-      iBuf = ogreSubMesh->indexData[Ogre::VpNormal]->indexBuffer;
-      indices = static_cast<uint32_t*>(
-          iBuf->lock(Ogre::v1::HardwareBuffer::HBL_DISCARD));
-
-
-      for (unsigned int j = 0; j < subMesh.IndexCount(); ++j)
-        *indices++ = static_cast<uint32_t>(subMesh.Index(j));
-
-      iBuf->unlock();
-
-      common::MaterialPtr material;
-      material = _desc.mesh->MaterialByIndex(subMesh.MaterialIndex());
+          CreateIndexBuffer(packed.indices, subMesh.VertexCount());
 
-      MaterialPtr mat = this->scene->CreateMaterial();
-      if (material)
-      {
-        mat->CopyFrom(*material);
-        this->dataPtr->materialCache.push_back(mat);
-      }
-      else
-      {
-        MaterialPtr defaultMat = this->scene->Material("Default/White");
-        if (defaultMat != nullptr)
-          mat->CopyFrom(defaultMat);
-      }
-      ogreSubMesh->setMaterialName(mat->Name());
+      ogreSubMesh->setMaterialName(
+          this->CreateSubMeshMaterial(_desc, subMesh));
     }
 
     math::Vector3d max = _desc.mesh->Max();
@@ -507,6 +1729,8 @@ bool Ogre2MeshFactory::LoadImpl(const MeshDescriptor &_desc)
       return false;
     }
 
+    CreateLodLevels(packedMesh, this->dataPtr->lodDistance, ogreMesh.get());
+
     if (!ogreMesh->hasValidShadowMappingBuffers())
       ogreMesh->prepareForShadowMapping(false);
 
@@ -618,6 +1842,11 @@ Ogre2SubMeshPtr Ogre2SubMeshStoreFactory::CreateSubMesh(unsigned int _index)
   {
     std::string matName = subMesh->ogreSubItem->getSubMesh()->getMaterialName();
     mat = this->scene->Material(matName);
+
+    // the submesh material belongs to another scene if the mesh was loaded
+    // by it, the item then uses the datablock of this scene's copy
+    if (!mat && ogreDatablock->getNameStr())
+      mat = this->scene->Material(*ogreDatablock->getNameStr());
   }
 
   if (mat)
@@ -15,6 +15,9 @@
  *
  */
 
+#include <algorithm>
+#include <atomic>
+
 #include <ignition/common/Console.hh>
 
 #include "ignition/rendering/ogre2/Ogre2Node.hh"
@@ -33,6 +36,9 @@
 using namespace ignition;
 using namespace rendering;
 
+/// \brief Source of the bounds stamps, shared by the nodes of all scenes
+static std::atomic<uint64_t> gBoundsStamp(0u);
+
 //////////////////////////////////////////////////
 Ogre2Node::Ogre2Node()
 {
@@ -69,13 +75,58 @@ void Ogre2Node::Destroy()
 
   BaseNode::Destroy();
 
-  if (nullptr != this->scene)
+  if (nullptr != this->scene && nullptr != this->scene->OgreSceneManager())
+    this->scene->ReleaseSceneNode(this->ogreNode);
+  this->ogreNode = nullptr;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Node::MarkBoundsDirty()
+{
+  uint64_t stamp = ++gBoundsStamp;
+  for (Ogre2Node *node = this; node; node = node->parent.get())
+    node->subtreeStamp = stamp;
+
+  if (this->scene)
+    this->scene->MarkVisualIndexDirty(this, false);
+}
+
+//////////////////////////////////////////////////
+uint64_t Ogre2Node::BoundsStamp() const
+{
+  // the bounding boxes of a node also depend on its ancestors
+  uint64_t stamp = this->subtreeStamp;
+  for (const Ogre2Node *node = this; node; node = node->parent.get())
+    stamp = std::max(stamp, node->inheritedStamp);
+  return stamp;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Node::MarkSubtreeBoundsDirty()
+{
+  if (this->boundsMarkDeferred)
+    return;
+
+  this->MarkBoundsDirty();
+  this->inheritedStamp = this->subtreeStamp;
+
+  if (this->scene)
+    this->scene->MarkVisualIndexDirty(this, true);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Node::NotifyStaticDirty()
+{
+  if (nullptr == this->ogreNode || !this->ogreNode->isStatic() ||
+      nullptr == this->scene || nullptr == this->scene->OgreSceneManager())
   {
-    Ogre::SceneManager *ogreSceneManager = this->scene->OgreSceneManager();
-    if (nullptr != ogreSceneManager)
-      ogreSceneManager->destroySceneNode(this->ogreNode);
+    return;
   }
-  this->ogreNode = nullptr;
+
+  this->scene->OgreSceneManager()->notifyStaticDirty(this->ogreNode);
+
+  // static objects are the shadow casters of the cached shadow maps
+  this->scene->SetStaticShadowsDirty();
 }
 
 //////////////////////////////////////////////////
@@ -109,7 +160,15 @@ void Ogre2Node::SetRawLocalPosition(const math::Vector3d &_position)
   if (nullptr == this->ogreNode)
     return;
 
-  this->ogreNode->setPosition(Ogre2Conversions::Convert(_position));
+  // setting the pose a static node already has must not invalidate the
+  // static shadow maps
+  Ogre::Vector3 position = Ogre2Conversions::Convert(_position);
+  if (this->ogreNode->isStatic() && this->ogreNode->getPosition() == position)
+    return;
+
+  this->ogreNode->setPosition(position);
+  this->NotifyStaticDirty();
+  this->MarkSubtreeBoundsDirty();
 }
 
 //////////////////////////////////////////////////
@@ -127,7 +186,16 @@ void Ogre2Node::SetRawLocalRotation(const math::Quaterniond &_rotation)
   if (nullptr == this->ogreNode)
     return;
 
-  this->ogreNode->setOrientation(Ogre2Conversions::Convert(_rotation));
+  Ogre::Quaternion orientation = Ogre2Conversions::Convert(_rotation);
+  if (this->ogreNode->isStatic() &&
+      this->ogreNode->getOrientation() == orientation)
+  {
+    return;
+  }
+
+  this->ogreNode->setOrientation(orientation);
+  this->NotifyStaticDirty();
+  this->MarkSubtreeBoundsDirty();
 }
 
 //////////////////////////////////////////////////
@@ -157,7 +225,7 @@ void Ogre2Node::Init()
     return;
   }
 
-  this->ogreNode = sceneManager->createSceneNode();
+  this->ogreNode = this->scene->AcquireSceneNode();
   if (nullptr == this->ogreNode)
   {
     ignerr << "Failed to create Ogre node" << std::endl;
@@ -204,6 +272,11 @@ bool Ogre2Node::AttachChild(NodePtr _child)
 
   derived->SetParent(this->SharedThis());
   this->ogreNode->addChild(derived->Node());
+  derived->MarkSubtreeBoundsDirty();
+
+  // labels are inherited from ancestors, so reparenting can change them
+  if (this->scene)
+    this->scene->MarkLabelsDirty();
   return true;
 }
 
@@ -222,7 +295,12 @@ bool Ogre2Node::DetachChild(NodePtr _child)
     return false;
   }
 
+  // the child still points to this node, so its whole former branch is
+  // marked
+  derived->MarkSubtreeBoundsDirty();
   this->ogreNode->removeChild(derived->Node());
+  if (this->scene)
+    this->scene->MarkLabelsDirty();
 
   return true;
 }
@@ -259,6 +337,8 @@ void Ogre2Node::SetInheritScale(bool _inherit)
     return;
 
   this->ogreNode->setInheritScale(_inherit);
+  this->NotifyStaticDirty();
+  this->MarkSubtreeBoundsDirty();
 }
 
 //////////////////////////////////////////////////
@@ -268,6 +348,8 @@ void Ogre2Node::SetLocalScaleImpl(const math::Vector3d &_scale)
     return;
 
   this->ogreNode->setScale(Ogre2Conversions::Convert(_scale));
+  this->NotifyStaticDirty();
+  this->MarkSubtreeBoundsDirty();
 }
 
 
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <typeinfo>
+
+#include "ignition/rendering/RenderTypes.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+
+#include "Ogre2ObjectId.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Hlms/Pbs/OgreHlmsPbs.h>
+#include <Hlms/Pbs/OgreHlmsPbsDatablock.h>
+#include <OgreHlmsManager.h>
+#include <OgreItem.h>
+#include <OgreRoot.h>
+#include <OgreSubItem.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+namespace ignition
+{
+namespace rendering
+{
+inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+//
+//////////////////////////////////////////////////
+void SetDatablockObjectId(Ogre::HlmsPbsDatablock *_datablock)
+{
+  if (!_datablock)
+    return;
+
+  uint32_t objectId = _datablock->getName().mHash;
+  if (objectId == 0u)
+    objectId = kUnknownObjectId;
+
+  // floats hold 16 bit integers exactly, the shader puts the halves
+  // together again
+  _datablock->setUserValue(0u, Ogre::Vector4(
+      static_cast<Ogre::Real>(objectId & 0xFFFFu),
+      static_cast<Ogre::Real>(objectId >> 16u), 0, 0));
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the Pbs datablock an object id was written by
+/// \param[in] _objectId Object id read from a render target
+/// \return The datablock, null if the object id is unknown
+static Ogre::HlmsDatablock *ObjectIdDatablock(uint32_t _objectId)
+{
+  if (_objectId == 0u || _objectId == kUnknownObjectId)
+    return nullptr;
+
+  Ogre::Root *root = Ogre2RenderEngine::Instance()->OgreRoot();
+  Ogre::Hlms *hlms = root->getHlmsManager()->getHlms(Ogre::HLMS_PBS);
+  if (!hlms)
+    return nullptr;
+
+  Ogre::IdString name;
+  name.mHash = _objectId;
+  return hlms->getDatablockNoDefault(name);
+}
+
+//////////////////////////////////////////////////
+bool ObjectIdVisual(uint32_t _objectId, unsigned int &_visualId)
+{
+  Ogre::HlmsDatablock *datablock = ObjectIdDatablock(_objectId);
+  if (!datablock)
+    return false;
+
+  bool found = false;
+  for (Ogre::Renderable *renderable : datablock->getLinkedRenderables())
+  {
+    Ogre::SubItem *subItem = dynamic_cast<Ogre::SubItem *>(renderable);
+    if (!subItem)
+      return false;
+
+    // the selection buffer sees through geometry that isn't selectable
+    Ogre::Item *item = subItem->getParent();
+    if (!(item->getVisibilityFlags() & IGN_VISIBILITY_SELECTABLE))
+      return false;
+
+    const Ogre::Any &userAny = item->getUserObjectBindings().getUserAny();
+    if (userAny.isEmpty() || userAny.getType() != typeid(unsigned int))
+      return false;
+
+    unsigned int visualId = Ogre::any_cast<unsigned int>(userAny);
+    if (found && visualId != _visualId)
+      return false;
+
+    _visualId = visualId;
+    found = true;
+  }
+  return found;
+}
+
+//////////////////////////////////////////////////
+bool ObjectIdVisuals(uint32_t _objectId,
+    std::vector<unsigned int> &_visualIds)
+{
+  _visualIds.clear();
+  Ogre::HlmsDatablock *datablock = ObjectIdDatablock(_objectId);
+  if (!datablock)
+    return false;
+
+  for (Ogre::Renderable *renderable : datablock->getLinkedRenderables())
+  {
+    Ogre::SubItem *subItem = dynamic_cast<Ogre::SubItem *>(renderable);
+    if (!subItem)
+      return false;
+
+    const Ogre::Any &userAny =
+        subItem->getParent()->getUserObjectBindings().getUserAny();
+    if (userAny.isEmpty() || userAny.getType() != typeid(unsigned int))
+      return false;
+
+    _visualIds.push_back(Ogre::any_cast<unsigned int>(userAny));
+  }
+  return !_visualIds.empty();
+}
+}
+}
+}
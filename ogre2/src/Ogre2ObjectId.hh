@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2OBJECTID_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2OBJECTID_HH_
+
+#include <cstdint>
+#include <vector>
+
+#include "ignition/rendering/config.hh"
+
+namespace Ogre
+{
+  class HlmsPbsDatablock;
+}
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Object id written by geometry whose object can't be told
+    /// from the object id, e.g. unlit or terrain geometry. Picks that hit
+    /// it fall back to the selection buffer.
+    constexpr uint32_t kUnknownObjectId = 0xFFFFFFFFu;
+
+    /// \brief Identifier of the compositor scene passes that write object
+    /// ids, see Ogre::CompositorPassDef::mIdentifier. The hlms only declare
+    /// the object id output in these passes, see
+    /// media/Hlms/Ignition/IgnObjectId_piece_ps.any
+    constexpr uint32_t kObjectIdPassIdentifier = 0x1D0B1D00u;
+
+    /// \brief Store the object id of a Pbs datablock in its first user
+    /// value, from where the scene passes write it to the object id output
+    /// of render targets that have one. The id is the hash of the name of
+    /// the datablock, 0 is left for the background.
+    /// \param[in] _datablock Datablock to set the object id of
+    /// \sa Ogre2RenderTarget::SetObjectIdEnabled
+    void SetDatablockObjectId(Ogre::HlmsPbsDatablock *_datablock);
+
+    /// \brief Get the visual an object id was written by
+    /// \param[in] _objectId Object id read from a render target
+    /// \param[out] _visualId Id of the visual
+    /// \return False if the object id is unknown, its datablock is used by
+    /// more than one visual or by geometry the selection buffer ignores.
+    /// The pick then has to be answered by the selection buffer.
+    bool ObjectIdVisual(uint32_t _objectId, unsigned int &_visualId);
+
+    /// \brief Get all the visuals an object id may have been written by
+    /// \param[in] _objectId Object id read from a render target
+    /// \param[out] _visualIds Ids of the visuals whose geometry uses the
+    /// datablock of the object id, selectable or not
+    /// \return False if the object id is unknown or its datablock is used
+    /// by geometry that doesn't belong to a visual
+    bool ObjectIdVisuals(uint32_t _objectId,
+        std::vector<unsigned int> &_visualIds);
+    }
+  }
+}
+#endif
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "Ogre2OcclusionBuffer.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Depth of pixels not covered by any occluder
+static const float kFarDepth = std::numeric_limits<float>::max();
+
+//////////////////////////////////////////////////
+void Ogre2OcclusionBuffer::Reset(unsigned int _width, unsigned int _height)
+{
+  this->width = _width;
+  this->height = _height;
+  this->levels.resize(1u);
+  this->levels[0].assign(this->width * this->height, kFarDepth);
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2OcclusionBuffer::Width() const
+{
+  return this->width;
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2OcclusionBuffer::Height() const
+{
+  return this->height;
+}
+
+//////////////////////////////////////////////////
+void Ogre2OcclusionBuffer::RasterizeTriangle(const Ogre::Vector3 &_a,
+    const Ogre::Vector3 &_b, const Ogre::Vector3 &_c)
+{
+  auto edge = [](const Ogre::Vector3 &_p0, const Ogre::Vector3 &_p1,
+      float _x, float _y)
+  {
+    return (_p1.x - _p0.x) * (_y - _p0.y) - (_p1.y - _p0.y) * (_x - _p0.x);
+  };
+
+  // both windings occlude, back faces of closed meshes included
+  float area = edge(_a, _b, _c.x, _c.y);
+  if (std::abs(area) < 1e-6f || this->levels.empty())
+    return;
+  const float sign = area > 0.0f ? 1.0f : -1.0f;
+  const float invArea = 1.0f / std::abs(area);
+
+  // normalized device depth is affine in screen space. A pixel gets the
+  // farthest depth of the triangle within it, found at one of its corners,
+  // but no farther than the triangle reaches
+  const float dzdx = sign * invArea * ((_b.y - _c.y) * _a.z +
+      (_c.y - _a.y) * _b.z + (_a.y - _b.y) * _c.z);
+  const float dzdy = sign * invArea * ((_c.x - _b.x) * _a.z +
+      (_a.x - _c.x) * _b.z + (_b.x - _a.x) * _c.z);
+  const float slack = 0.5f * (std::abs(dzdx) + std::abs(dzdy));
+  const float maxZ = std::max({_a.z, _b.z, _c.z});
+
+  int x0 = std::max(0, static_cast<int>(
+      std::floor(std::min({_a.x, _b.x, _c.x}))));
+  int y0 = std::max(0, static_cast<int>(
+      std::floor(std::min({_a.y, _b.y, _c.y}))));
+  int x1 = std::min(static_cast<int>(this->width) - 1, static_cast<int>(
+      std::ceil(std::max({_a.x, _b.x, _c.x}))));
+  int y1 = std::min(static_cast<int>(this->height) - 1, static_cast<int>(
+      std::ceil(std::max({_a.y, _b.y, _c.y}))));
+
+  std::vector<float> &depth = this->levels[0];
+  for (int y = y0; y <= y1; ++y)
+  {
+    const float py = y + 0.5f;
+    for (int x = x0; x <= x1; ++x)
+    {
+      const float px = x + 0.5f;
+      float w0 = sign * edge(_b, _c, px, py);
+      float w1 = sign * edge(_c, _a, px, py);
+      float w2 = sign * edge(_a, _b, px, py);
+      if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+        continue;
+
+      float z = (w0 * _a.z + w1 * _b.z + w2 * _c.z) * invArea;
+      z = std::min(z + slack, maxZ);
+      float &d = depth[y * this->width + x];
+      d = std::min(d, z);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2OcclusionBuffer::Finish()
+{
+  if (this->levels.empty())
+    return;
+  this->levels.resize(1u);
+
+  // pixel centers only tell that a pixel is partly covered. Shrinking the
+  // occluders by a pixel, i.e. taking the farthest depth of the 3x3
+  // neighbourhood, leaves the pixels that are covered entirely
+  const std::vector<float> &covered = this->levels[0];
+  std::vector<float> shrunk(covered.size());
+  const int w = static_cast<int>(this->width);
+  const int h = static_cast<int>(this->height);
+  for (int y = 0; y < h; ++y)
+  {
+    for (int x = 0; x < w; ++x)
+    {
+      float d = 0.0f;
+      for (int ny = std::max(0, y - 1); ny <= std::min(h - 1, y + 1); ++ny)
+      {
+        for (int nx = std::max(0, x - 1); nx <= std::min(w - 1, x + 1);
+            ++nx)
+        {
+          d = std::max(d, covered[ny * w + nx]);
+        }
+      }
+      shrunk[y * w + x] = d;
+    }
+  }
+  this->levels[0] = std::move(shrunk);
+
+  unsigned int lw = this->width;
+  unsigned int lh = this->height;
+  while (lw > 1u || lh > 1u)
+  {
+    unsigned int nw = (lw + 1u) / 2u;
+    unsigned int nh = (lh + 1u) / 2u;
+    const std::vector<float> &src = this->levels.back();
+    std::vector<float> dst(nw * nh);
+    for (unsigned int y = 0u; y < nh; ++y)
+    {
+      unsigned int sy0 = 2u * y;
+      unsigned int sy1 = std::min(sy0 + 1u, lh - 1u);
+      for (unsigned int x = 0u; x < nw; ++x)
+      {
+        unsigned int sx0 = 2u * x;
+        unsigned int sx1 = std::min(sx0 + 1u, lw - 1u);
+        dst[y * nw + x] = std::max({
+            src[sy0 * lw + sx0], src[sy0 * lw + sx1],
+            src[sy1 * lw + sx0], src[sy1 * lw + sx1]});
+      }
+    }
+    this->levels.push_back(std::move(dst));
+    lw = nw;
+    lh = nh;
+  }
+}
+
+//////////////////////////////////////////////////
+bool Ogre2OcclusionBuffer::Occluded(const Bounds &_bounds) const
+{
+  if (this->levels.empty() || this->width == 0u || this->height == 0u)
+    return false;
+
+  int x0 = std::max(0, static_cast<int>(std::floor(_bounds.minX)));
+  int y0 = std::max(0, static_cast<int>(std::floor(_bounds.minY)));
+  int x1 = std::min(static_cast<int>(this->width) - 1,
+      static_cast<int>(std::floor(_bounds.maxX)));
+  int y1 = std::min(static_cast<int>(this->height) - 1,
+      static_cast<int>(std::floor(_bounds.maxY)));
+  if (x0 > x1 || y0 > y1)
+    return false;
+
+  // pick the level where the bounds cover at most 2x2 texels
+  unsigned int level = 0u;
+  while (level + 1u < this->levels.size() &&
+      ((x1 >> level) - (x0 >> level) > 1 ||
+       (y1 >> level) - (y0 >> level) > 1))
+  {
+    ++level;
+  }
+
+  unsigned int levelWidth = this->width;
+  for (unsigned int l = 0u; l < level; ++l)
+    levelWidth = (levelWidth + 1u) / 2u;
+
+  const std::vector<float> &depth = this->levels[level];
+  for (int y = y0 >> level; y <= (y1 >> level); ++y)
+  {
+    for (int x = x0 >> level; x <= (x1 >> level); ++x)
+    {
+      if (depth[y * levelWidth + x] >= _bounds.depth)
+        return false;
+    }
+  }
+  return true;
+}
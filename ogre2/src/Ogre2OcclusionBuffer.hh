@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2OCCLUSIONBUFFER_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2OCCLUSIONBUFFER_HH_
+
+#include <vector>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/ogre2/Export.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreVector3.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Small depth buffer the occlusion culler rasterizes occluders
+    /// into on the CPU, with a hierarchical max depth pyramid to test the
+    /// screen space bounds of items against.
+    ///
+    /// Occluders are made conservative: a pixel only occludes if the
+    /// occluders cover it and its neighbours, and it holds the farthest
+    /// depth they reach around it. Pixels the occluders only partly cover
+    /// therefore never hide what may be seen through them.
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2OcclusionBuffer
+    {
+      /// \brief Screen space bounds of an item
+      public: struct Bounds
+      {
+        /// \brief Minimum pixel coordinates
+        float minX = 0.0f;
+        float minY = 0.0f;
+
+        /// \brief Maximum pixel coordinates
+        float maxX = 0.0f;
+        float maxY = 0.0f;
+
+        /// \brief Nearest normalized device depth
+        float depth = 0.0f;
+      };
+
+      /// \brief Clear the buffer, nothing is occluded until occluders are
+      /// rasterized and Finish is called
+      /// \param[in] _width Width of the buffer in pixels
+      /// \param[in] _height Height of the buffer in pixels
+      public: void Reset(unsigned int _width, unsigned int _height);
+
+      /// \brief Get the width of the buffer
+      /// \return Width in pixels
+      public: unsigned int Width() const;
+
+      /// \brief Get the height of the buffer
+      /// \return Height in pixels
+      public: unsigned int Height() const;
+
+      /// \brief Rasterize a triangle of an occluder. Both windings occlude.
+      /// \param[in] _a First vertex, pixel coordinates and depth
+      /// \param[in] _b Second vertex, pixel coordinates and depth
+      /// \param[in] _c Third vertex, pixel coordinates and depth
+      public: void RasterizeTriangle(const Ogre::Vector3 &_a,
+                  const Ogre::Vector3 &_b, const Ogre::Vector3 &_c);
+
+      /// \brief Shrink the rasterized occluders and build the depth
+      /// pyramid. To be called after the last occluder is rasterized.
+      public: void Finish();
+
+      /// \brief Check if screen space bounds are behind the occluders
+      /// \param[in] _bounds Screen space bounds
+      /// \return True if the bounds are entirely occluded
+      public: bool Occluded(const Bounds &_bounds) const;
+
+      /// \brief Width of the buffer in pixels
+      private: unsigned int width = 0u;
+
+      /// \brief Height of the buffer in pixels
+      private: unsigned int height = 0u;
+
+      /// \brief Depth pyramid, the first level is the depth buffer. Each
+      /// texel of a level holds the farthest depth of the 2x2 texels below.
+      private: std::vector<std::vector<float>> levels;
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "Ogre2OcclusionBuffer.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Rasterize an axis aligned square occluder of two triangles
+/// \param[in] _buffer Buffer to rasterize into
+/// \param[in] _min Minimum pixel coordinates
+/// \param[in] _max Maximum pixel coordinates
+/// \param[in] _depth Depth of the square
+static void RasterizeSquare(Ogre2OcclusionBuffer &_buffer, float _min,
+    float _max, float _depth)
+{
+  Ogre::Vector3 a(_min, _min, _depth);
+  Ogre::Vector3 b(_max, _min, _depth);
+  Ogre::Vector3 c(_max, _max, _depth);
+  Ogre::Vector3 d(_min, _max, _depth);
+  _buffer.RasterizeTriangle(a, b, c);
+  _buffer.RasterizeTriangle(a, c, d);
+}
+
+/// \brief Create screen space bounds
+/// \param[in] _min Minimum pixel coordinates
+/// \param[in] _max Maximum pixel coordinates
+/// \param[in] _depth Nearest depth
+/// \return Bounds
+static Ogre2OcclusionBuffer::Bounds MakeBounds(float _min, float _max,
+    float _depth)
+{
+  Ogre2OcclusionBuffer::Bounds bounds;
+  bounds.minX = bounds.minY = _min;
+  bounds.maxX = bounds.maxY = _max;
+  bounds.depth = _depth;
+  return bounds;
+}
+
+/////////////////////////////////////////////////
+TEST(Ogre2OcclusionBufferTest, Empty)
+{
+  Ogre2OcclusionBuffer buffer;
+  EXPECT_FALSE(buffer.Occluded(MakeBounds(10.0f, 20.0f, 0.5f)));
+
+  buffer.Reset(64u, 32u);
+  EXPECT_EQ(64u, buffer.Width());
+  EXPECT_EQ(32u, buffer.Height());
+  buffer.Finish();
+  EXPECT_FALSE(buffer.Occluded(MakeBounds(10.0f, 20.0f, 0.5f)));
+}
+
+/////////////////////////////////////////////////
+TEST(Ogre2OcclusionBufferTest, Square)
+{
+  Ogre2OcclusionBuffer buffer;
+  buffer.Reset(64u, 64u);
+  RasterizeSquare(buffer, 10.0f, 40.0f, 0.3f);
+  buffer.Finish();
+
+  // behind the square
+  EXPECT_TRUE(buffer.Occluded(MakeBounds(16.0f, 31.5f, 0.5f)));
+  EXPECT_TRUE(buffer.Occluded(MakeBounds(20.0f, 21.0f, 0.31f)));
+
+  // in front of the square
+  EXPECT_FALSE(buffer.Occluded(MakeBounds(12.0f, 38.0f, 0.2f)));
+
+  // partly outside of the square
+  EXPECT_FALSE(buffer.Occluded(MakeBounds(30.0f, 45.0f, 0.5f)));
+  EXPECT_FALSE(buffer.Occluded(MakeBounds(5.0f, 20.0f, 0.5f)));
+
+  // outside of the buffer
+  EXPECT_FALSE(buffer.Occluded(MakeBounds(70.0f, 80.0f, 0.5f)));
+}
+
+/////////////////////////////////////////////////
+TEST(Ogre2OcclusionBufferTest, PartialPixels)
+{
+  Ogre2OcclusionBuffer buffer;
+  buffer.Reset(64u, 64u);
+
+  // the edges cover the centers of pixels 10 and 20, but not the pixels
+  RasterizeSquare(buffer, 10.4f, 20.6f, 0.3f);
+  buffer.Finish();
+
+  // bounds within the uncovered part of the edge pixels
+  Ogre2OcclusionBuffer::Bounds bounds = MakeBounds(15.0f, 16.0f, 0.5f);
+  bounds.minX = 20.65f;
+  bounds.maxX = 20.95f;
+  EXPECT_FALSE(buffer.Occluded(bounds));
+  bounds.minX = 10.05f;
+  bounds.maxX = 10.35f;
+  EXPECT_FALSE(buffer.Occluded(bounds));
+
+  // bounds within the pixels covered entirely
+  EXPECT_TRUE(buffer.Occluded(MakeBounds(12.0f, 18.5f, 0.5f)));
+}
+
+/////////////////////////////////////////////////
+TEST(Ogre2OcclusionBufferTest, Slope)
+{
+  Ogre2OcclusionBuffer buffer;
+  buffer.Reset(64u, 64u);
+
+  // square tilted along x, from depth 0.1 to 0.7, both windings
+  Ogre::Vector3 a(0.0f, 0.0f, 0.1f);
+  Ogre::Vector3 b(60.0f, 0.0f, 0.7f);
+  Ogre::Vector3 c(60.0f, 60.0f, 0.7f);
+  Ogre::Vector3 d(0.0f, 60.0f, 0.1f);
+  buffer.RasterizeTriangle(a, c, b);
+  buffer.RasterizeTriangle(a, d, c);
+  buffer.Finish();
+
+  // the square is at depth 0.4 at x = 30, 0.01 per pixel
+  Ogre2OcclusionBuffer::Bounds bounds = MakeBounds(20.0f, 21.0f, 0.5f);
+  bounds.minX = 30.2f;
+  bounds.maxX = 30.8f;
+  EXPECT_TRUE(buffer.Occluded(bounds));
+
+  // the square reaches past the nearest depth of the bounds within the
+  // pixels, which must not occlude
+  bounds.depth = 0.405f;
+  EXPECT_FALSE(buffer.Occluded(bounds));
+  bounds.depth = 0.3f;
+  EXPECT_FALSE(buffer.Occluded(bounds));
+}
@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "ignition/rendering/ogre2/Ogre2MeshFactory.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+
+#include "Ogre2OcclusionCuller.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreHlmsDatablock.h>
+#include <OgreSubItem.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Width of the occlusion depth buffer in pixels. The height
+/// follows the aspect ratio of the camera.
+static const unsigned int kBufferWidth = 128u;
+
+/// \brief Minimum fraction of the depth buffer an item must cover to be
+/// used as occluder
+static const float kMinOccluderArea = 0.02f;
+
+/// \brief Maximum number of occluders rasterized per pass, nearest first
+static const size_t kMaxOccluders = 16u;
+
+/// \brief Maximum number of triangles of an occluder mesh
+static const size_t kMaxOccluderTriangles = 2048u;
+
+/// \brief Initial bounds of the projection of a box
+static const float kFarDepth = std::numeric_limits<float>::max();
+
+//////////////////////////////////////////////////
+Ogre2OcclusionCuller::Ogre2OcclusionCuller(Ogre2ScenePtr _scene)
+  : scene(_scene)
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2OcclusionCuller::~Ogre2OcclusionCuller()
+{
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2OcclusionCuller::CulledCount() const
+{
+  return this->culledCount;
+}
+
+//////////////////////////////////////////////////
+void Ogre2OcclusionCuller::passPreExecute(Ogre::CompositorPass *_pass)
+{
+  if (_pass->getType() != Ogre::PASS_SCENE ||
+      dynamic_cast<Ogre::CompositorShadowNode *>(_pass->getParentNode()))
+  {
+    return;
+  }
+
+  Ogre::Camera *camera =
+      static_cast<Ogre::CompositorPassScene *>(_pass)->getCamera();
+  Ogre2MeshFactoryPtr meshFactory = this->scene->MeshFactory();
+  if (!camera || !meshFactory)
+    return;
+
+  const Ogre::CompositorPassSceneDef *def =
+      static_cast<const Ogre::CompositorPassSceneDef *>(
+      _pass->getDefinition());
+  const uint32_t visibilityMask = def->mVisibilityMask;
+  const bool shadows = def->mShadowNode != Ogre::IdString();
+
+  unsigned int bufferHeight = static_cast<unsigned int>(std::round(
+      kBufferWidth / std::max(camera->getAspectRatio(), 0.01f)));
+  this->buffer.Reset(kBufferWidth,
+      std::max(1u, std::min(bufferHeight, kBufferWidth)));
+  const float width = static_cast<float>(this->buffer.Width());
+  const float height = static_cast<float>(this->buffer.Height());
+  this->viewProj = camera->getProjectionMatrix() * camera->getViewMatrix(true);
+
+  // gather the items drawn by the pass and pick the occluders among them
+  struct Candidate
+  {
+    Ogre::Item *item;
+    Ogre2OcclusionBuffer::Bounds bounds;
+  };
+  std::vector<Candidate> candidates;
+  std::vector<std::pair<Candidate, const std::vector<Ogre::Vector3> *>>
+      occluders;
+  const float minOccluderArea = kMinOccluderArea * width * height;
+
+  for (Ogre::Item *item : this->scene->VisibleItems(visibilityMask))
+  {
+    if (!item->isVisible() || !item->getParentNode())
+      continue;
+
+    Candidate candidate{item, Ogre2OcclusionBuffer::Bounds()};
+    if (!this->Project(item->getWorldAabbUpdated(), candidate.bounds))
+      continue;
+
+    // items entirely outside of the view are culled by ogre already
+    const Ogre2OcclusionBuffer::Bounds &b = candidate.bounds;
+    if (b.maxX < 0.0f || b.maxY < 0.0f ||
+        b.minX >= width || b.minY >= height)
+    {
+      continue;
+    }
+
+    if (!shadows || !item->getCastShadows())
+      candidates.push_back(candidate);
+
+    float area = (std::min(b.maxX, width) - std::max(b.minX, 0.0f)) *
+        (std::min(b.maxY, height) - std::max(b.minY, 0.0f));
+    if (area < minOccluderArea || item->hasSkeleton())
+      continue;
+
+    bool opaque = true;
+    for (size_t i = 0; i < item->getNumSubItems() && opaque; ++i)
+    {
+      Ogre::HlmsDatablock *datablock = item->getSubItem(i)->getDatablock();
+      opaque = datablock && !datablock->getBlendblock()->mIsTransparent;
+    }
+    if (!opaque)
+      continue;
+
+    const std::vector<Ogre::Vector3> *triangles =
+        meshFactory->Triangles(item->getMesh()->getName());
+    if (!triangles || triangles->empty() ||
+        triangles->size() / 3u > kMaxOccluderTriangles)
+    {
+      continue;
+    }
+    occluders.push_back({candidate, triangles});
+  }
+
+  this->culledCount = 0u;
+  if (occluders.empty() || candidates.empty())
+    return;
+
+  // the nearest occluders hide the most
+  std::sort(occluders.begin(), occluders.end(),
+      [](const auto &_a, const auto &_b)
+      {
+        return _a.first.bounds.depth < _b.first.bounds.depth;
+      });
+  if (occluders.size() > kMaxOccluders)
+    occluders.resize(kMaxOccluders);
+
+  for (const auto &occluder : occluders)
+    this->RasterizeOccluder(occluder.first.item, *occluder.second);
+  this->buffer.Finish();
+
+  // occluders are tested as well, an occluder is never behind itself
+  for (const Candidate &candidate : candidates)
+  {
+    if (this->buffer.Occluded(candidate.bounds))
+    {
+      candidate.item->setVisible(false);
+      this->hiddenItems.push_back(candidate.item);
+    }
+  }
+  this->culledPass = _pass;
+  this->culledCount = static_cast<unsigned int>(this->hiddenItems.size());
+}
+
+//////////////////////////////////////////////////
+void Ogre2OcclusionCuller::passPosExecute(Ogre::CompositorPass *_pass)
+{
+  // shadow passes run within the scene pass and end before it
+  if (_pass != this->culledPass)
+    return;
+
+  for (Ogre::Item *item : this->hiddenItems)
+    item->setVisible(true);
+  this->hiddenItems.clear();
+  this->culledPass = nullptr;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2OcclusionCuller::Project(const Ogre::Aabb &_aabb,
+    Ogre2OcclusionBuffer::Bounds &_bounds) const
+{
+  _bounds.minX = _bounds.minY = _bounds.depth = kFarDepth;
+  _bounds.maxX = _bounds.maxY = -kFarDepth;
+  for (unsigned int i = 0u; i < 8u; ++i)
+  {
+    Ogre::Vector3 corner = _aabb.mCenter + _aabb.mHalfSize * Ogre::Vector3(
+        (i & 1u) ? 1.0f : -1.0f,
+        (i & 2u) ? 1.0f : -1.0f,
+        (i & 4u) ? 1.0f : -1.0f);
+    Ogre::Vector4 clip = this->viewProj * Ogre::Vector4(corner.x, corner.y,
+        corner.z, 1.0f);
+    if (clip.w <= 0.0f || clip.z < -clip.w)
+      return false;
+
+    float x = (clip.x / clip.w * 0.5f + 0.5f) * this->buffer.Width();
+    float y = (0.5f - clip.y / clip.w * 0.5f) * this->buffer.Height();
+    _bounds.minX = std::min(_bounds.minX, x);
+    _bounds.minY = std::min(_bounds.minY, y);
+    _bounds.maxX = std::max(_bounds.maxX, x);
+    _bounds.maxY = std::max(_bounds.maxY, y);
+    _bounds.depth = std::min(_bounds.depth, clip.z / clip.w);
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2OcclusionCuller::RasterizeOccluder(Ogre::Item *_item,
+    const std::vector<Ogre::Vector3> &_triangles)
+{
+  const Ogre::Matrix4 mvp =
+      this->viewProj * _item->getParentNode()->_getFullTransformUpdated();
+
+  Ogre::Vector3 screen[3];
+  for (size_t t = 0u; t + 2u < _triangles.size(); t += 3u)
+  {
+    bool clipped = false;
+    for (unsigned int v = 0u; v < 3u && !clipped; ++v)
+    {
+      const Ogre::Vector3 &p = _triangles[t + v];
+      Ogre::Vector4 clip = mvp * Ogre::Vector4(p.x, p.y, p.z, 1.0f);
+
+      // triangles crossing the near plane are skipped, which can only
+      // make the culling less aggressive
+      clipped = clip.w <= 0.0f || clip.z < -clip.w;
+      screen[v] = Ogre::Vector3(
+          (clip.x / clip.w * 0.5f + 0.5f) * this->buffer.Width(),
+          (0.5f - clip.y / clip.w * 0.5f) * this->buffer.Height(),
+          clip.z / clip.w);
+    }
+    if (!clipped)
+      this->buffer.RasterizeTriangle(screen[0], screen[1], screen[2]);
+  }
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2OCCLUSIONCULLER_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2OCCLUSIONCULLER_HH_
+
+#include <cstdint>
+#include <vector>
+
+#include "ignition/rendering/ogre2/Ogre2Includes.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
+
+#include "Ogre2OcclusionBuffer.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Compositor workspace listener that hides occluded items from
+    /// the scene passes of the workspaces it is added to.
+    ///
+    /// Before a scene pass, the largest opaque meshes in view are
+    /// rasterized on the CPU into a small conservative depth buffer, see
+    /// Ogre2OcclusionBuffer. Every item whose projected
+    /// bounds lie entirely behind the occluders is hidden until the pass
+    /// has executed. Occluders are regular items, so the culling follows
+    /// the scene without any preprocessing. Passes with a shadow node only
+    /// cull items that do not cast shadows, since the shadows of hidden
+    /// items may still be in view.
+    class Ogre2OcclusionCuller : public Ogre::CompositorWorkspaceListener
+    {
+      /// \brief Constructor
+      /// \param[in] _scene Scene of the culled items
+      public: explicit Ogre2OcclusionCuller(Ogre2ScenePtr _scene);
+
+      /// \brief Destructor
+      public: virtual ~Ogre2OcclusionCuller();
+
+      /// \brief Get the number of items hidden from the last scene pass
+      /// \return Number of culled items
+      public: unsigned int CulledCount() const;
+
+      // Documentation inherited.
+      public: virtual void passPreExecute(Ogre::CompositorPass *_pass)
+          override;
+
+      // Documentation inherited.
+      public: virtual void passPosExecute(Ogre::CompositorPass *_pass)
+          override;
+
+      /// \brief Project a world space box to the depth buffer
+      /// \param[in] _aabb World space box
+      /// \param[out] _bounds Screen space bounds of the box
+      /// \return False if the box crosses the near plane
+      private: bool Project(const Ogre::Aabb &_aabb,
+                   Ogre2OcclusionBuffer::Bounds &_bounds) const;
+
+      /// \brief Rasterize the triangles of an occluder
+      /// \param[in] _item Occluder item
+      /// \param[in] _triangles Triangles of the item mesh, three vertices
+      /// per triangle in the mesh's local frame
+      private: void RasterizeOccluder(Ogre::Item *_item,
+                   const std::vector<Ogre::Vector3> &_triangles);
+
+      /// \brief Scene of the culled items
+      private: Ogre2ScenePtr scene;
+
+      /// \brief View projection matrix of the camera of the current pass
+      private: Ogre::Matrix4 viewProj;
+
+      /// \brief Depth buffer the occluders are rasterized into
+      private: Ogre2OcclusionBuffer buffer;
+
+      /// \brief Items hidden from the current pass
+      private: std::vector<Ogre::Item *> hiddenItems;
+
+      /// \brief Scene pass the items are hidden from
+      private: Ogre::CompositorPass *culledPass = nullptr;
+
+      /// \brief Number of items hidden from the last pass
+      private: unsigned int culledCount = 0u;
+    };
+    }
+  }
+}
+#endif
@@ -15,6 +15,16 @@
  *
  */
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 // Note this include is placed in the src file because
 // otherwise ogre produces compile errors
 #ifdef _MSC_VER
@@ -38,11 +48,36 @@ using namespace rendering;
 
 const uint32_t Ogre2ParticleEmitter::kParticleVisibilityFlags = 0x00100000;
 
-class ignition::rendering::Ogre2ParticleEmitterPrivate
+/// \brief Render state shared by all particle emitters of a scene that use
+/// the same material, so fields of identical emitters don't duplicate it
+class Ogre2ParticleTemplate
 {
-  /// \brief Internal material name.
-  public: const std::string kMaterialName = "__particle_emitter_material__";
+  /// \brief Destructor, releases the shared render state
+  public: ~Ogre2ParticleTemplate();
+
+  /// \brief Get the template of a material, created by its first emitter
+  /// \param[in] _scene Scene of the emitter
+  /// \param[in] _material Material of the emitter, null for the default
+  /// \return Template shared with the other emitters of the material
+  public: static std::shared_ptr<Ogre2ParticleTemplate> Shared(
+      Ogre2ScenePtr _scene, const MaterialPtr &_material);
+
+  /// \brief Get the mesh of the particles simulated on the GPU. The mesh
+  /// only holds the quad corners and particle indices so all emitters with
+  /// the same capacity share it
+  /// \param[in] _capacity Number of particles the mesh has room for
+  /// \return Mesh with one quad per particle
+  public: Ogre::MeshPtr GpuMesh(unsigned int _capacity);
+
+  /// \brief Unlit datablock the ogre particle systems are rendered with
+  public: Ogre::HlmsUnlitDatablock *datablock = nullptr;
+
+  /// \brief Meshes of the GPU particles by capacity
+  public: std::map<unsigned int, Ogre::MeshPtr> gpuMeshes;
+};
 
+class ignition::rendering::Ogre2ParticleEmitterPrivate
+{
   /// \brief Ogre particle system.
   public: Ogre::ParticleSystem *ps = nullptr;
 
@@ -58,17 +93,35 @@ class ignition::rendering::Ogre2ParticleEmitterPrivate
   /// \brief Ogre scaler affector.
   public: Ogre::ParticleAffector *scalerAffector = nullptr;
 
-  /// \brief Pointer to the material datablock.
-  public: Ogre::HlmsUnlitDatablock *ogreDatablock = nullptr;
+  /// \brief Render state shared with the emitters of the same material
+  public: std::shared_ptr<Ogre2ParticleTemplate> particleTemplate;
+
+  /// \brief Item rendering the particles simulated on the GPU, one quad per
+  /// particle
+  public: Ogre::Item *gpuItem = nullptr;
+
+  /// \brief Number of particles the GPU particles item has room for
+  public: unsigned int gpuCapacity = 0u;
+
+  /// \brief Material of the particles simulated on the GPU
+  public: Ogre::MaterialPtr gpuMaterial;
+
+  /// \brief Texture currently bound to the GPU particles material
+  public: std::string gpuTexture;
 
-  /// \brief Pointer to the unlit material used by particle emitter.
-  public: MaterialPtr materialUnlit;
+  /// \brief Color image currently bound to the GPU particles material
+  public: std::string gpuColorImage;
 
-  /// \brief Flag to indicate that the emitter is dirty and needs to be
-  /// recreated
-  public: bool emitterDirty = false;
+  /// \brief Time emission was last enabled at
+  public: std::chrono::steady_clock::time_point emitStartTime;
+
+  /// \brief Time emission was last disabled at, max while emitting
+  public: std::chrono::steady_clock::time_point emitStopTime;
 };
 
+/// \brief Maximum number of particles simulated on the GPU per emitter
+static const unsigned int kMaxGpuParticles = 1u << 20;
+
 // Names used in Ogre for the supported emitters.
 static const std::array<std::string, EmitterType::EM_NUM_EMITTERS>
     kOgreEmitterTypes =
@@ -79,6 +132,133 @@ static const std::array<std::string, EmitterType::EM_NUM_EMITTERS>
         "Ellipsoid",
       };
 
+//////////////////////////////////////////////////
+Ogre2ParticleTemplate::~Ogre2ParticleTemplate()
+{
+  Ogre::Root *root = Ogre2RenderEngine::Instance()->OgreRoot();
+  Ogre::VaoManager *vaoManager = root->getRenderSystem()->getVaoManager();
+  for (auto &[capacity, mesh] : this->gpuMeshes)
+  {
+    Ogre::SubMesh *subMesh = mesh->getSubMesh(0);
+    if (vaoManager && !subMesh->mVao[Ogre::VpNormal].empty())
+      subMesh->destroyVaos(subMesh->mVao[Ogre::VpNormal], vaoManager);
+    subMesh->mVao[Ogre::VpShadow].clear();
+
+    std::string meshName = mesh->getName();
+    mesh.reset();
+    if (Ogre::MeshManager::getSingleton().resourceExists(meshName))
+      Ogre::MeshManager::getSingleton().remove(meshName);
+  }
+
+  if (this->datablock)
+    this->datablock->getCreator()->destroyDatablock(this->datablock->getName());
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<Ogre2ParticleTemplate> Ogre2ParticleTemplate::Shared(
+    Ogre2ScenePtr _scene, const MaterialPtr &_material)
+{
+  // templates are released when the last emitter of the material is
+  // destroyed or switches to another material
+  static std::map<std::pair<const Ogre2Scene *, std::string>,
+      std::weak_ptr<Ogre2ParticleTemplate>> sharedTemplates;
+
+  std::string materialName = _material ? _material->Name() : std::string();
+  auto &weak = sharedTemplates[{_scene.get(), materialName}];
+  std::shared_ptr<Ogre2ParticleTemplate> particleTemplate = weak.lock();
+  if (!particleTemplate)
+  {
+    Ogre::HlmsManager *hlmsManager =
+        Ogre2RenderEngine::Instance()->OgreRoot()->getHlmsManager();
+    Ogre::HlmsUnlit *hlmsUnlit = static_cast<Ogre::HlmsUnlit *>(
+        hlmsManager->getHlms(Ogre::HLMS_UNLIT));
+    std::string name = _scene->Name() + "::" + materialName +
+        "::ParticleTemplate";
+
+    particleTemplate = std::make_shared<Ogre2ParticleTemplate>();
+    particleTemplate->datablock = static_cast<Ogre::HlmsUnlitDatablock *>(
+        hlmsUnlit->createDatablock(name, name, Ogre::HlmsMacroblock(),
+        Ogre::HlmsBlendblock(), Ogre::HlmsParamVec()));
+    // same as the default material, white without texture
+    particleTemplate->datablock->setUseColour(true);
+    particleTemplate->datablock->setColour(Ogre::ColourValue::White);
+    weak = particleTemplate;
+  }
+
+  // pick up changes made to the material since it was last set
+  auto ogreMaterial = std::dynamic_pointer_cast<Ogre2Material>(_material);
+  if (ogreMaterial)
+    ogreMaterial->FillUnlitDatablock(particleTemplate->datablock);
+
+  return particleTemplate;
+}
+
+//////////////////////////////////////////////////
+Ogre::MeshPtr Ogre2ParticleTemplate::GpuMesh(unsigned int _capacity)
+{
+  auto it = this->gpuMeshes.find(_capacity);
+  if (it != this->gpuMeshes.end())
+    return it->second;
+
+  // every particle is a quad. The vertices hold the quad corner and the
+  // index of the particle, the vertex shader does the rest
+  const float corners[4][2] =
+      {{-0.5f, -0.5f}, {0.5f, -0.5f}, {0.5f, 0.5f}, {-0.5f, 0.5f}};
+  std::vector<float> vertices(_capacity * 16u);
+  std::vector<uint32_t> indices(_capacity * 6u);
+  for (unsigned int i = 0u; i < _capacity; ++i)
+  {
+    float *v = &vertices[i * 16u];
+    for (unsigned int c = 0u; c < 4u; ++c)
+    {
+      v[c * 4u] = corners[c][0];
+      v[c * 4u + 1u] = corners[c][1];
+      v[c * 4u + 2u] = static_cast<float>(i);
+      v[c * 4u + 3u] = 0.0f;
+    }
+
+    uint32_t *idx = &indices[i * 6u];
+    uint32_t first = i * 4u;
+    idx[0] = first;
+    idx[1] = first + 1u;
+    idx[2] = first + 2u;
+    idx[3] = first;
+    idx[4] = first + 2u;
+    idx[5] = first + 3u;
+  }
+
+  Ogre::Root *root = Ogre2RenderEngine::Instance()->OgreRoot();
+  Ogre::VaoManager *vaoManager = root->getRenderSystem()->getVaoManager();
+
+  static int gpuParticlesId = 0;
+  Ogre::MeshPtr mesh = Ogre::MeshManager::getSingleton().createManual(
+      "gpu_particles_" + std::to_string(gpuParticlesId++),
+      Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+  Ogre::SubMesh *subMesh = mesh->createSubMesh();
+
+  Ogre::VertexElement2Vec elements;
+  elements.push_back(
+      Ogre::VertexElement2(Ogre::VET_FLOAT4, Ogre::VES_POSITION));
+  Ogre::VertexBufferPacked *vertexBuffer = vaoManager->createVertexBuffer(
+      elements, _capacity * 4u, Ogre::BT_IMMUTABLE, vertices.data(), false);
+  Ogre::IndexBufferPacked *indexBuffer = vaoManager->createIndexBuffer(
+      Ogre::IndexBufferPacked::IT_32BIT, _capacity * 6u, Ogre::BT_IMMUTABLE,
+      indices.data(), false);
+
+  Ogre::VertexBufferPackedVec vertexBuffers;
+  vertexBuffers.push_back(vertexBuffer);
+  Ogre::VertexArrayObject *vao = vaoManager->createVertexArrayObject(
+      vertexBuffers, indexBuffer, Ogre::OT_TRIANGLE_LIST);
+  subMesh->mVao[Ogre::VpNormal].push_back(vao);
+  subMesh->mVao[Ogre::VpShadow].push_back(vao);
+
+  // the items set their bounds every frame from the emitter parameters
+  mesh->_setBounds(Ogre::Aabb::BOX_ZERO, false);
+
+  this->gpuMeshes[_capacity] = mesh;
+  return mesh;
+}
+
 //////////////////////////////////////////////////
 Ogre2ParticleEmitter::Ogre2ParticleEmitter()
     : dataPtr(new Ogre2ParticleEmitterPrivate)
@@ -91,6 +271,32 @@ Ogre2ParticleEmitter::~Ogre2ParticleEmitter()
   this->Destroy();
 }
 
+//////////////////////////////////////////////////
+bool Ogre2ParticleEmitter::ParticleBounds(math::AxisAlignedBox &_box) const
+{
+  Ogre::MovableObject *particles = this->dataPtr->ps;
+  if (this->gpuSimulation)
+  {
+    particles = this->dataPtr->gpuItem;
+    if (particles && !particles->getVisible())
+      return false;
+  }
+  if (!particles)
+    return false;
+
+  // the bounds of a particle system without particles are infinite
+  Ogre::Aabb aabb = particles->getWorldAabbUpdated();
+  if (std::isinf(aabb.getMinimum().length()) ||
+      std::isinf(aabb.getMaximum().length()))
+  {
+    return false;
+  }
+
+  _box = math::AxisAlignedBox(Ogre2Conversions::Convert(aabb.getMinimum()),
+      Ogre2Conversions::Convert(aabb.getMaximum()));
+  return true;
+}
+
 //////////////////////////////////////////////////
 void Ogre2ParticleEmitter::Destroy()
 {
@@ -106,11 +312,23 @@ void Ogre2ParticleEmitter::Destroy()
     this->dataPtr->ps = nullptr;
   }
 
-  if (this->dataPtr->materialUnlit)
+  this->DestroyGpuParticles();
+  if (this->dataPtr->gpuMaterial)
   {
-    this->Scene()->DestroyMaterial(this->dataPtr->materialUnlit);
-    this->dataPtr->materialUnlit.reset();
+    Ogre::MaterialManager::getSingleton().remove(
+        this->dataPtr->gpuMaterial->getName());
+    this->dataPtr->gpuMaterial.reset();
+    this->dataPtr->gpuTexture.clear();
+    this->dataPtr->gpuColorImage.clear();
   }
+
+  this->dataPtr->particleTemplate.reset();
+}
+
+//////////////////////////////////////////////////
+Ogre::ParticleSystem *Ogre2ParticleEmitter::OgreParticleSystem() const
+{
+  return this->dataPtr->ps;
 }
 
 //////////////////////////////////////////////////
@@ -128,13 +346,18 @@ void Ogre2ParticleEmitter::SetType(
   if (this->type == _type)
     return;
 
-  this->type = _type;
+  // swap the emitter in place so the particles in flight are kept. The new
+  // emitter takes over the rate, velocity, lifetime and duration
+  Ogre::ParticleEmitter *emitter =
+      this->dataPtr->ps->addEmitter(kOgreEmitterTypes[_type]);
+  this->dataPtr->emitter->copyParametersTo(emitter);
+  emitter->setEnabled(this->dataPtr->emitter->getEnabled());
+  // the previous emitter is the only other one
+  this->dataPtr->ps->removeEmitter(0);
+  this->dataPtr->emitter = emitter;
 
-  this->dataPtr->emitterDirty = true;
-  // todo(anyone) remove this call. We had to do this since we can't override
-  // PreRender() as it breaks ABI. We should rename PreRenderImpl to PreRender()
-  // in next release.
-  this->PreRenderImpl();
+  this->type = _type;
+  this->SetEmitterSize(this->emitterSize);
 }
 
 //////////////////////////////////////////////////
@@ -223,8 +446,22 @@ void Ogre2ParticleEmitter::SetDuration(double _duration)
 //////////////////////////////////////////////////
 void Ogre2ParticleEmitter::SetEmitting(bool _enable)
 {
-  this->dataPtr->emitter->setEnabled(_enable);
-  this->dataPtr->ps->setEmitting(_enable);
+  // the ogre particle system is idle while particles are simulated on the GPU
+  bool cpuEmitting = _enable && !this->gpuSimulation;
+  this->dataPtr->emitter->setEnabled(cpuEmitting);
+  this->dataPtr->ps->setEmitting(cpuEmitting);
+
+  // GPU particles are emitted from the time emission was enabled
+  if (_enable && !this->emitting)
+  {
+    this->dataPtr->emitStartTime = std::chrono::steady_clock::now();
+    this->dataPtr->emitStopTime = std::chrono::steady_clock::time_point::max();
+  }
+  else if (!_enable && this->emitting)
+  {
+    this->dataPtr->emitStopTime = std::chrono::steady_clock::now();
+  }
+
   this->emitting = _enable;
 }
 
@@ -240,13 +477,12 @@ void Ogre2ParticleEmitter::SetParticleSize(
     return;
   }
 
-  this->particleSize = _size;
+  // the particles have no dimensions of their own and follow the default
+  // dimensions of the system, so the particles in flight are resized at
+  // once along with the ones emitted from now on
+  this->dataPtr->ps->setDefaultDimensions(_size[0], _size[1]);
 
-  this->dataPtr->emitterDirty = true;
-  // todo(anyone) remove this call. We had to do this since we can't override
-  // PreRender() as it breaks ABI. We should rename PreRenderImpl to PreRender()
-  // in next release.
-  this->PreRenderImpl();
+  this->particleSize = _size;
 }
 
 //////////////////////////////////////////////////
@@ -275,8 +511,15 @@ void Ogre2ParticleEmitter::SetMaterial(const MaterialPtr &_material)
     return;
   }
 
-  auto ogreMaterial = std::dynamic_pointer_cast<Ogre2Material>(_material);
-  ogreMaterial->FillUnlitDatablock(this->dataPtr->ogreDatablock);
+  // switch to the template of the material before releasing the previous
+  // one, its datablock and meshes may still be in use
+  std::shared_ptr<Ogre2ParticleTemplate> particleTemplate =
+      Ogre2ParticleTemplate::Shared(this->scene, _material);
+  this->dataPtr->ps->setMaterialName(
+      *(particleTemplate->datablock->getNameStr()));
+  if (particleTemplate != this->dataPtr->particleTemplate)
+    this->DestroyGpuParticles();
+  this->dataPtr->particleTemplate = particleTemplate;
 
   this->material = _material;
 }
@@ -427,51 +670,38 @@ void Ogre2ParticleEmitter::SetColorRangeImage(const std::string &_image)
 }
 
 //////////////////////////////////////////////////
-void Ogre2ParticleEmitter::Init()
+void Ogre2ParticleEmitter::SetGpuSimulationEnabled(bool _enabled)
 {
-  Ogre2Visual::Init();
-  this->CreateParticleSystem();
+  if (this->gpuSimulation == _enabled)
+    return;
+
+  this->gpuSimulation = _enabled;
+
+  // the ogre particle system is kept but hidden and idle while particles are
+  // simulated on the GPU
+  if (_enabled)
+    this->dataPtr->ps->clear();
+  else
+    this->DestroyGpuParticles();
+  this->dataPtr->ps->setVisible(!_enabled);
+  this->SetEmitting(this->emitting);
 }
 
 //////////////////////////////////////////////////
-void Ogre2ParticleEmitter::PreRenderImpl()
+void Ogre2ParticleEmitter::PreRender()
 {
-  // todo(anyone) rename this function to PreRender() so it overrides function
-  // from base class. Since this rename breaks ABI, we should rename this
-  // function in the next release
-
-  // recreate the particle system if needed
-  // currently this is needed when user changes type or particle size
-  if (this->dataPtr->emitterDirty)
-  {
-    this->Destroy();
-    this->CreateParticleSystem();
+  BaseParticleEmitter::PreRender();
 
-    // make direct ogre calls here so we don't mark emitter as dirty again
-    this->dataPtr->ps->setDefaultDimensions(
-        this->particleSize[0], this->particleSize[1]);
-
-    this->SetEmitterSize(this->emitterSize);
-
-    // set other properties
-    this->SetDuration(this->duration);
-    this->SetEmitting(this->emitting);
-    this->SetLifetime(this->lifetime);
-    this->SetRate(this->rate);
-    this->SetVelocityRange(this->minVelocity, this->maxVelocity);
-
-    if (this->material)
-      this->SetMaterial(this->material);
-
-    if (!this->colorRangeImage.empty())
-      this->SetColorRangeImage(this->colorRangeImage);
-    else
-      this->SetColorRange(this->colorStart, this->colorEnd);
-
-    this->SetScaleRate(this->scaleRate);
+  // particles simulated on the GPU take all parameters as shader constants
+  if (this->gpuSimulation)
+    this->UpdateGpuParticles();
+}
 
-    this->dataPtr->emitterDirty = false;
-  }
+//////////////////////////////////////////////////
+void Ogre2ParticleEmitter::Init()
+{
+  Ogre2Visual::Init();
+  this->CreateParticleSystem();
 }
 
 //////////////////////////////////////////////////
@@ -499,17 +729,182 @@ void Ogre2ParticleEmitter::CreateParticleSystem()
   this->dataPtr->emitter->setDirection(Ogre::Vector3::UNIT_X);
   this->dataPtr->emitter->setEnabled(true);
 
-  // Instantiate the default material.
-  this->dataPtr->materialUnlit = this->scene->CreateMaterial();
-  auto ogreMat = std::dynamic_pointer_cast<Ogre2Material>(
-      this->dataPtr->materialUnlit);
-  this->dataPtr->ogreDatablock = ogreMat->UnlitDatablock();
-
+  // The default material is shared by all emitters without one
+  this->dataPtr->particleTemplate =
+      Ogre2ParticleTemplate::Shared(this->scene, nullptr);
   this->dataPtr->ps->setMaterialName(
-      *(this->dataPtr->ogreDatablock->getNameStr()));
+      *(this->dataPtr->particleTemplate->datablock->getNameStr()));
 
   this->dataPtr->ps->setDefaultDimensions(1, 1);
 
   this->ogreNode->attachObject(this->dataPtr->ps);
   igndbg << "Particle emitter initialized" << std::endl;
 }
+
+//////////////////////////////////////////////////
+void Ogre2ParticleEmitter::UpdateGpuParticles()
+{
+  if (!this->dataPtr->gpuMaterial)
+  {
+    Ogre::MaterialPtr gpuMaterial =
+        Ogre::MaterialManager::getSingleton().getByName("GpuParticles");
+    this->dataPtr->gpuMaterial = gpuMaterial->clone(
+        this->scene->Name() + "::" + this->Name() + "::GpuParticles");
+    this->dataPtr->gpuMaterial->load();
+  }
+
+  // all particles emitted during one lifetime are alive at the same time
+  double count = std::ceil(this->rate * this->lifetime);
+  if (count > kMaxGpuParticles)
+  {
+    ignwarn << "Particle emitter [" << this->Name() << "] emits "
+            << count << " particles per lifetime, only "
+            << kMaxGpuParticles << " are simulated on the GPU" << std::endl;
+    count = kMaxGpuParticles;
+  }
+  unsigned int particleCount = static_cast<unsigned int>(count);
+
+  // the mesh only grows so rate and lifetime changes rarely rebuild it
+  if (particleCount > this->dataPtr->gpuCapacity)
+  {
+    unsigned int capacity = 1024u;
+    while (capacity < particleCount)
+      capacity *= 2u;
+    this->CreateGpuParticles(capacity);
+  }
+  if (!this->dataPtr->gpuItem)
+    return;
+
+  // times in seconds since emission was enabled
+  using Clock = std::chrono::steady_clock;
+  double time = std::chrono::duration<double>(
+      Clock::now() - this->dataPtr->emitStartTime).count();
+  double emitEnd = this->duration > 0 ? this->duration :
+      std::numeric_limits<float>::max();
+  if (this->dataPtr->emitStopTime != Clock::time_point::max())
+  {
+    emitEnd = std::min(emitEnd, std::chrono::duration<double>(
+        this->dataPtr->emitStopTime - this->dataPtr->emitStartTime).count());
+  }
+
+  // hide the particles once the last ones died
+  bool visible = particleCount > 0u && this->lifetime > 0 &&
+      (this->emitting || time < emitEnd + this->lifetime);
+  this->dataPtr->gpuItem->setVisible(visible);
+  if (!visible)
+    return;
+
+  // bounds of all the particles a lifetime could have emitted
+  double sizeGrowth = std::max(this->scaleRate, 0.0) * this->lifetime;
+  double radius = std::max(this->particleSize.X(), this->particleSize.Y()) +
+      sizeGrowth;
+  math::Vector3d halfSize;
+  if (this->type != EmitterType::EM_POINT)
+  {
+    halfSize.Set(this->emitterSize.Z(), this->emitterSize.X(),
+        this->emitterSize.Y());
+    halfSize *= 0.5;
+  }
+  math::Vector3d minCorner = -halfSize - math::Vector3d(radius, radius, radius);
+  math::Vector3d maxCorner = halfSize + math::Vector3d(radius, radius, radius);
+  minCorner.X() += std::min(this->minVelocity * this->lifetime, 0.0);
+  maxCorner.X() += std::max(this->maxVelocity * this->lifetime, 0.0);
+  Ogre::Aabb aabb;
+  aabb.setExtents(Ogre2Conversions::Convert(minCorner),
+      Ogre2Conversions::Convert(maxCorner));
+  this->dataPtr->gpuItem->setLocalAabb(aabb);
+
+  Ogre::Pass *pass =
+      this->dataPtr->gpuMaterial->getTechnique(0)->getPass(0);
+  Ogre::GpuProgramParametersSharedPtr vsParams =
+      pass->getVertexProgramParameters();
+  vsParams->setNamedConstant("time", static_cast<float>(time));
+  vsParams->setNamedConstant("emitEnd", static_cast<float>(emitEnd));
+  vsParams->setNamedConstant("rate", static_cast<float>(this->rate));
+  vsParams->setNamedConstant("lifetime", static_cast<float>(this->lifetime));
+  vsParams->setNamedConstant("count", static_cast<float>(particleCount));
+  vsParams->setNamedConstant("emitterType", static_cast<int>(this->type));
+  vsParams->setNamedConstant("emitterSize",
+      Ogre2Conversions::Convert(this->emitterSize));
+  vsParams->setNamedConstant("velocityRange", Ogre::Vector2(
+      this->minVelocity, this->maxVelocity));
+  vsParams->setNamedConstant("particleSize", Ogre::Vector2(
+      this->particleSize.X(), this->particleSize.Y()));
+  vsParams->setNamedConstant("scaleRate", static_cast<float>(this->scaleRate));
+  vsParams->setNamedConstant("colorStart",
+      Ogre2Conversions::Convert(this->colorStart));
+  vsParams->setNamedConstant("colorEnd",
+      Ogre2Conversions::Convert(this->colorEnd));
+  vsParams->setNamedConstant("useColorImage",
+      this->colorRangeImage.empty() ? 0 : 1);
+
+  // the color image is looked up in the resource locations registered by
+  // SetColorRangeImage
+  if (this->colorRangeImage != this->dataPtr->gpuColorImage)
+  {
+    if (!this->colorRangeImage.empty())
+    {
+      pass->getTextureUnitState(1)->setTextureName(
+          common::basename(this->colorRangeImage));
+    }
+    this->dataPtr->gpuColorImage = this->colorRangeImage;
+  }
+
+  // take the color and texture of the material, as the unlit datablock of
+  // the ogre particle system does
+  Ogre::GpuProgramParametersSharedPtr psParams =
+      pass->getFragmentProgramParameters();
+  MaterialPtr mat = this->material;
+  psParams->setNamedConstant("diffuse", mat ?
+      Ogre2Conversions::Convert(mat->Diffuse()) : Ogre::ColourValue::White);
+  std::string texture = mat ? mat->Texture() : std::string();
+  if (texture != this->dataPtr->gpuTexture)
+  {
+    if (!texture.empty())
+    {
+      Ogre::TextureGpuManager *textureMgr =
+          Ogre2RenderEngine::Instance()->OgreRoot()->getRenderSystem()->
+          getTextureGpuManager();
+      pass->getTextureUnitState(0)->setTexture(
+          textureMgr->createOrRetrieveTexture(common::basename(texture),
+          Ogre::GpuPageOutStrategy::Discard,
+          Ogre::TextureFlags::ManualTexture,
+          Ogre::TextureTypes::Type2D));
+    }
+    this->dataPtr->gpuTexture = texture;
+  }
+  psParams->setNamedConstant("hasTexture", texture.empty() ? 0 : 1);
+}
+
+//////////////////////////////////////////////////
+void Ogre2ParticleEmitter::CreateGpuParticles(unsigned int _capacity)
+{
+  this->DestroyGpuParticles();
+
+  Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+  this->dataPtr->gpuItem = sceneManager->createItem(
+      this->dataPtr->particleTemplate->GpuMesh(_capacity),
+      Ogre::SCENE_DYNAMIC);
+  this->scene->MarkVisibilityLayersDirty();
+  this->dataPtr->gpuItem->getUserObjectBindings().setUserAny(
+      Ogre::Any(this->Id()));
+  this->dataPtr->gpuItem->setCastShadows(false);
+  this->dataPtr->gpuItem->setVisibilityFlags(kParticleVisibilityFlags);
+  this->dataPtr->gpuItem->getSubItem(0)->setMaterial(
+      this->dataPtr->gpuMaterial);
+  this->ogreNode->attachObject(this->dataPtr->gpuItem);
+  this->dataPtr->gpuCapacity = _capacity;
+}
+
+//////////////////////////////////////////////////
+void Ogre2ParticleEmitter::DestroyGpuParticles()
+{
+  // the mesh belongs to the particle template
+  if (this->dataPtr->gpuItem)
+  {
+    this->scene->OgreSceneManager()->destroyItem(this->dataPtr->gpuItem);
+    this->scene->MarkVisibilityLayersDirty();
+    this->dataPtr->gpuItem = nullptr;
+  }
+  this->dataPtr->gpuCapacity = 0u;
+}
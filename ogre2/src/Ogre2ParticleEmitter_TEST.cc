@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/ogre2/Ogre2ParticleEmitter.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreParticleSystem.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(Ogre2ParticleEmitterTest, UpdateWhileEmitting)
+{
+  Ogre2RenderEngine *engine = Ogre2RenderEngine::Instance();
+  if (!engine->Load(std::map<std::string, std::string>()) || !engine->Init())
+  {
+    igndbg << "Engine 'ogre2' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  auto emitter = std::dynamic_pointer_cast<Ogre2ParticleEmitter>(
+      scene->CreateParticleEmitter());
+  ASSERT_NE(nullptr, emitter);
+  scene->RootVisual()->AddChild(emitter);
+  emitter->SetType(EmitterType::EM_POINT);
+  emitter->SetRate(100);
+  emitter->SetLifetime(100);
+  emitter->SetDuration(0);
+  emitter->SetParticleSize({1, 1, 1});
+  emitter->SetEmitting(true);
+
+  Ogre::ParticleSystem *ps = emitter->OgreParticleSystem();
+  ASSERT_NE(nullptr, ps);
+
+  // simulate one second of emission
+  ps->_update(1.0);
+  size_t count = ps->getNumParticles();
+  EXPECT_GT(count, 0u);
+
+  // the particles in flight follow the new default dimensions
+  emitter->SetParticleSize({2, 3, 1});
+  EXPECT_DOUBLE_EQ(2.0, ps->getDefaultWidth());
+  EXPECT_DOUBLE_EQ(3.0, ps->getDefaultHeight());
+  EXPECT_EQ(count, ps->getNumParticles());
+
+  // the emitter is swapped in place, the particles in flight are kept and
+  // the new emitter keeps emitting
+  emitter->SetType(EmitterType::EM_BOX);
+  EXPECT_EQ(EmitterType::EM_BOX, emitter->Type());
+  EXPECT_EQ(count, ps->getNumParticles());
+  ASSERT_EQ(1u, ps->getNumEmitters());
+  EXPECT_TRUE(ps->getEmitter(0)->getEnabled());
+  EXPECT_DOUBLE_EQ(100.0, ps->getEmitter(0)->getEmissionRate());
+
+  ps->_update(1.0);
+  EXPECT_GT(ps->getNumParticles(), count);
+
+  engine->DestroyScene(scene);
+}
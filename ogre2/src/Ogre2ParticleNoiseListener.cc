@@ -22,8 +22,6 @@
 #include "ignition/rendering/ogre2/Ogre2Includes.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
-#include "ignition/rendering/ogre2/Ogre2Visual.hh"
-#include "ignition/rendering/ogre2/Ogre2ParticleEmitter.hh"
 
 #include "Ogre2ParticleNoiseListener.hh"
 
@@ -50,35 +48,14 @@ void Ogre2ParticleNoiseListener::cameraPreRenderScene(
   // bounding box
   // \todo(anyone) noise std dev is set based on the first particle emitter the
   // sensor sees. Make this scale to multiple particle emitters!
-  auto itor = this->scene->OgreSceneManager()->getMovableObjectIterator(
-      Ogre::ParticleSystemFactory::FACTORY_TYPE_NAME);
-  while (itor.hasMoreElements())
+  // The particle volumes are evaluated once per frame by the scene and
+  // shared by all sensors
+  for (const auto &volume : this->scene->ParticleVolumes())
   {
-    Ogre::MovableObject *object = itor.peekNext();
-    Ogre::ParticleSystem *ps = dynamic_cast<Ogre::ParticleSystem *>(object);
-
-    if (!ps)
-    {
-      itor.moveNext();
-      continue;
-    }
-
-    Ogre::Aabb aabb = ps->getWorldAabbUpdated();
-    if (std::isinf(aabb.getMinimum().length()) ||
-        std::isinf(aabb.getMaximum().length()))
-    {
-      itor.moveNext();
-      continue;
-    }
-
-    Ogre::AxisAlignedBox box = Ogre::AxisAlignedBox(aabb.getMinimum(),
-        aabb.getMaximum());
-
-
-    if (_cam->isVisible(box))
+    if (_cam->isVisible(volume.box))
     {
       // set stddev to half of size of particle emitter aabb
-      auto hs = box.getHalfSize() * 0.5;
+      auto hs = volume.box.getHalfSize() * 0.5;
       double particleStddev = hs.x;
 
       Ogre::Pass *pass = this->ogreMaterial->getTechnique(0)->getPass(0);
@@ -89,31 +66,10 @@ void Ogre2ParticleNoiseListener::cameraPreRenderScene(
       psParams->setNamedConstant("rnd",
           static_cast<float>(ignition::math::Rand::DblUniform(0.0, 1.0)));
 
-      // get particle scatter ratio value from particle emitter user data
-      // and pass that to the shaders
-      float scatterRatio = 0.65f;
-      Ogre::Any userAny = ps->getUserObjectBindings().getUserAny();
-      if (!userAny.isEmpty() && userAny.getType() == typeid(unsigned int))
-      {
-        VisualPtr result;
-        try
-        {
-          result = this->scene->VisualById(
-              Ogre::any_cast<unsigned int>(userAny));
-        }
-        catch(Ogre::Exception &e)
-        {
-          ignerr << "Ogre Error:" << e.getFullDescription() << "\n";
-        }
-        Ogre2ParticleEmitterPtr emitterPtr =
-          std::dynamic_pointer_cast<Ogre2ParticleEmitter>(result);
-        if (emitterPtr)
-          scatterRatio = emitterPtr->ParticleScatterRatio();
-      }
-      psParams->setNamedConstant("particleScatterRatio", scatterRatio);
+      psParams->setNamedConstant("particleScatterRatio",
+          volume.scatterRatio);
 
       return;
     }
-    itor.moveNext();
   }
 }
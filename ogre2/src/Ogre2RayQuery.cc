@@ -16,12 +16,10 @@
  */
 
 #include <ignition/common/Console.hh>
-#include <ignition/common/Mesh.hh>
-#include <ignition/common/MeshManager.hh>
-#include <ignition/common/SubMesh.hh>
 
 #include "ignition/rendering/ogre2/Ogre2Camera.hh"
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
+#include "ignition/rendering/ogre2/Ogre2MeshFactory.hh"
 #include "ignition/rendering/ogre2/Ogre2RayQuery.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
 #include "ignition/rendering/ogre2/Ogre2SelectionBuffer.hh"
@@ -96,7 +94,7 @@ RayQueryResult Ogre2RayQuery::ClosestPoint()
   RayQueryResult result;
 
 #ifdef __APPLE__
-  return this->ClosestPointByIntersection();
+  return this->ClosestPointByIntersection(this->origin, this->direction);
 #else
   if (!this->dataPtr->camera ||
       !this->dataPtr->camera->Parent() ||
@@ -105,7 +103,7 @@ RayQueryResult Ogre2RayQuery::ClosestPoint()
     // use legacy method for backward compatibility if no camera is set or
     // camera is not attached in the scene tree or
     // this function is called from non-rendering thread
-    return this->ClosestPointByIntersection();
+    return this->ClosestPointByIntersection(this->origin, this->direction);
   }
   else
   {
@@ -120,6 +118,24 @@ RayQueryResult Ogre2RayQuery::ClosestPoint()
 #endif
 }
 
+//////////////////////////////////////////////////
+std::vector<RayQueryResult> Ogre2RayQuery::ClosestPoints(
+    const std::vector<math::Line3d> &_rays)
+{
+  // The selection buffer can only resolve rays cast through the camera
+  // pixels so arbitrary rays are always intersected on the CPU, where the
+  // mesh factory's cached bounding volume hierarchies are shared by the
+  // whole batch
+  std::vector<RayQueryResult> results;
+  results.reserve(_rays.size());
+  for (const auto &ray : _rays)
+  {
+    results.push_back(
+        this->ClosestPointByIntersection(ray[0], ray.Direction()));
+  }
+  return results;
+}
+
 //////////////////////////////////////////////////
 RayQueryResult Ogre2RayQuery::ClosestPointBySelectionBuffer()
 {
@@ -155,7 +171,8 @@ RayQueryResult Ogre2RayQuery::ClosestPointBySelectionBuffer()
 }
 
 //////////////////////////////////////////////////
-RayQueryResult Ogre2RayQuery::ClosestPointByIntersection()
+RayQueryResult Ogre2RayQuery::ClosestPointByIntersection(
+    const math::Vector3d &_origin, const math::Vector3d &_direction)
 {
   RayQueryResult result;
   Ogre2ScenePtr ogreScene =
@@ -163,8 +180,8 @@ RayQueryResult Ogre2RayQuery::ClosestPointByIntersection()
   if (!ogreScene)
     return result;
 
-  Ogre::Ray mouseRay(Ogre2Conversions::Convert(this->origin),
-      Ogre2Conversions::Convert(this->direction));
+  Ogre::Ray mouseRay(Ogre2Conversions::Convert(_origin),
+      Ogre2Conversions::Convert(_direction));
 
   if (!this->dataPtr->rayQuery)
   {
@@ -194,66 +211,31 @@ RayQueryResult Ogre2RayQuery::ClosestPointByIntersection()
     {
       Ogre::Item *ogreItem = static_cast<Ogre::Item *>(iter->movable);
 
-      // mesh factory creates name with ::CENTER or ::ORIGINAL depending on
-      // the params passed in the MeshDescriptor when loading the mesh
-      // so strip off the suffix
-      std::string meshName = ogreItem->getMesh()->getName();
-      size_t idx = meshName.find("::");
-      if (idx != std::string::npos)
-        meshName = meshName.substr(0, idx);
-
-      const common::Mesh *mesh =
-           common::MeshManager::Instance()->MeshByName(meshName);
-
-      if (!mesh)
+      // transform the ray into the mesh's local frame so that the triangles
+      // can be tested in place. The ray direction is not normalized so the
+      // ray parameter of a hit is the same in both frames.
+      Ogre::Matrix4 invTransform =
+          ogreItem->_getParentNodeFullTransform().inverseAffine();
+      Ogre::Ray localRay(
+          invTransform.transformAffine(mouseRay.getOrigin()),
+          invTransform.transformDirectionAffine(mouseRay.getDirection()));
+
+      double hitDistance = 0.0;
+      if (!ogreScene->MeshFactory()->Intersect(
+          ogreItem->getMesh()->getName(), localRay, hitDistance))
+      {
         continue;
+      }
 
-      Ogre::Matrix4 transform = ogreItem->_getParentNodeFullTransform();
-
-      // test for hitting individual triangles on the mesh
-      for (unsigned int j = 0; j < mesh->SubMeshCount(); ++j)
+      // if it was a hit check if its the closest
+      if (distance < 0.0 || hitDistance < distance)
       {
-        auto s = mesh->SubMeshByIndex(j);
-        auto submesh = s.lock();
-        if (!submesh || submesh->VertexCount() < 3u)
-          continue;
-        unsigned int indexCount = submesh->IndexCount();
-        for (unsigned int k = 0; k < indexCount; k += 3)
-        {
-          if (indexCount <= k+2)
-            continue;
-
-          ignition::math::Vector3d vertexA =
-            submesh->Vertex(submesh->Index(k));
-          ignition::math::Vector3d vertexB =
-            submesh->Vertex(submesh->Index(k+1));
-          ignition::math::Vector3d vertexC =
-            submesh->Vertex(submesh->Index(k+2));
-
-          Ogre::Vector3 worldVertexA =
-              transform * Ogre2Conversions::Convert(vertexA);
-          Ogre::Vector3 worldVertexB =
-              transform * Ogre2Conversions::Convert(vertexB);
-          Ogre::Vector3 worldVertexC =
-              transform * Ogre2Conversions::Convert(vertexC);
-
-          // check for a hit against this triangle
-          std::pair<bool, Ogre::Real> hit = Ogre::Math::intersects(mouseRay,
-              worldVertexA, worldVertexB, worldVertexC,
-              true, false);
-
-          // if it was a hit check if its the closest
-          if (hit.first &&
-              (distance < 0.0f || hit.second < distance))
-          {
-            // this is the closest so far, save it off
-            distance = hit.second;
-            result.distance = distance;
-            result.point =
-                Ogre2Conversions::Convert(mouseRay.getPoint(distance));
-            result.objectId = Ogre::any_cast<unsigned int>(userAny);
-          }
-        }
+        // this is the closest so far, save it off
+        distance = hitDistance;
+        result.distance = distance;
+        result.point = Ogre2Conversions::Convert(
+            mouseRay.getPoint(static_cast<Ogre::Real>(distance)));
+        result.objectId = Ogre::any_cast<unsigned int>(userAny);
       }
     }
   }
@@ -28,6 +28,17 @@
   // pulled in by anybody (e.g., Boost).
   #include <Winsock2.h>
 #endif
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Filesystem.hh>
 #include <ignition/common/Util.hh>
@@ -41,11 +52,35 @@
 #include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
 #include "ignition/rendering/ogre2/Ogre2Storage.hh"
+#include "ignition/rendering/Utils.hh"
 
 #include "Terra/Hlms/OgreHlmsTerra.h"
 #include "Terra/Hlms/PbsListener/OgreHlmsPbsTerraShadows.h"
 #include "Terra/TerraWorkspaceListener.h"
 #include "Ogre2IgnHlmsCustomizations.hh"
+#include "Ogre2MaterialOverride.hh"
+#include "Ogre2TransientTextures.hh"
+#include "Ogre2MemoryStats.hh"
+#include "Ogre2SharedMeshes.hh"
+#include "Ogre2WorkerPool.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreHlmsDiskCache.h>
+#include <Vao/OgreIndexBufferPacked.h>
+#include <Vao/OgreStagingBuffer.h>
+#include <Vao/OgreVaoManager.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+/// \brief True if the ogre-next version has a Vulkan render system
+#if OGRE_VERSION >= ((2 << 16) | (3 << 8) | 0)
+static constexpr bool kVulkanAvailable = true;
+#else
+static constexpr bool kVulkanAvailable = false;
+#endif
 
 class ignition::rendering::Ogre2RenderEnginePrivate
 {
@@ -65,9 +100,92 @@ class ignition::rendering::Ogre2RenderEnginePrivate
   /// \brief Pbs listener that adds terra shadows
   public: std::unique_ptr<Ogre::HlmsPbsTerraShadows> hlmsPbsTerraShadows;
 
+  /// \brief Per pass material override of Pbs and Unlit, its listeners
+  /// coordinate the other listeners of the two hlms
+  public: ignition::rendering::Ogre2MaterialOverride materialOverride;
+
+  /// \brief Intermediate render textures shared by the workspaces of all
+  /// sensors
+  public: ignition::rendering::Ogre2TransientTextures transientTextures;
+
+  /// \brief Ogre meshes shared by the mesh factories of all scenes
+  public: ignition::rendering::Ogre2SharedMeshes sharedMeshes;
+
+  /// \brief Number of render targets using each shared compositor
+  /// workspace definition
+  public: std::unordered_map<std::string, unsigned int>
+      sharedWorkspaceDefinitions;
+
+  /// \brief Protects sharedWorkspaceDefinitions
+  public: std::mutex sharedWorkspaceDefinitionsMutex;
+
   /// \brief Listener that needs to be in every workspace
   /// that wants terrain to cast shadows from spot and point lights
   public: std::unique_ptr<Ogre::TerraWorkspaceListener> terraWorkspaceListener;
+
+  /// \brief True to time compositor passes on the GPU
+  public: bool gpuTiming = false;
+
+  /// \brief True to count the draw calls of compositor passes
+  public: bool drawStats = false;
+
+  /// \brief True to cull occluded objects in sensor scene passes
+  public: bool occlusionCulling = false;
+
+  /// \brief Scene graph update threads of new scenes, 0 for one per core
+  public: unsigned int sceneThreadCount = 0u;
+
+  /// \brief True to cull instanced entities on the scene threads
+  public: bool sceneThreadedCulling = false;
+
+  /// \brief Cores the threads of new scenes run on, empty for any core
+  public: std::vector<unsigned int> sceneThreadAffinity;
+
+  /// \brief Threads converting sensor readbacks
+  public: ignition::rendering::Ogre2WorkerPool workerPool;
+
+  /// \brief True to keep the compiled shaders on disk across runs
+  public: bool shaderCache = true;
+
+  /// \brief Root directory of the shader cache, empty for the default
+  public: std::string shaderCachePath;
+
+  /// \brief Directory of the shader cache for the current driver, empty
+  /// until the cache is loaded
+  public: std::string shaderCacheDir;
+
+  /// \brief Default sizes of the VaoManager pools in bytes, indexed by
+  /// the render window parameter ogre-next reads them from. Empty for the
+  /// ogre-next defaults.
+  public: std::map<std::string, std::string> vaoPoolSizes;
+
+  /// \brief Bytes the texture manager may keep in staging textures
+  public: size_t textureStagingBudget = 8u * 1024u * 1024u;
+
+  /// \brief Bytes the texture worker thread may load ahead of uploads
+  public: size_t textureWorkerPreload = 8u * 1024u * 1024u;
+
+  /// \brief Bytes the texture worker thread may request per staging
+  /// texture
+  public: size_t textureWorkerRequest = 4u * 1024u * 1024u;
+
+  /// \brief True to allocate the buffer pools when the engine loads
+  /// instead of when the first buffer of each kind is created
+  public: bool preallocateBuffers = false;
+
+  /// \brief Uris already passed to AddResourcePath
+  public: std::unordered_set<std::string> resourceUris;
+
+  /// \brief Paths registered as ogre resource locations
+  public: std::unordered_set<std::string> resourceLocations;
+
+  /// \brief EGL device used in headless mode, given by index or by a part
+  /// of its name. Empty for the default device
+  public: std::string headlessDevice;
+
+  /// \brief Materials of the material scripts that are not parsed yet.
+  /// Key: material name, value: path to the script
+  public: std::unordered_map<std::string, std::string> scriptMaterials;
 };
 
 using namespace ignition;
@@ -127,13 +245,25 @@ void Ogre2RenderEngine::Destroy()
     this->scenes->RemoveAll();
   }
 
+  // the meshes and compositor definitions go with the ogre root, an
+  // engine loaded again starts over
+  this->dataPtr->sharedMeshes.Clear();
+  {
+    std::lock_guard<std::mutex> lock(
+        this->dataPtr->sharedWorkspaceDefinitionsMutex);
+    this->dataPtr->sharedWorkspaceDefinitions.clear();
+  }
+
   delete this->ogreOverlaySystem;
   this->ogreOverlaySystem = nullptr;
 
   this->dataPtr->hlmsPbsTerraShadows.reset();
+  this->dataPtr->workerPool.Stop();
 
   if (this->ogreRoot)
   {
+    this->SaveShaderCache();
+
     // Clean up any textures that may still be in flight.
     Ogre::TextureGpuManager *mgr =
     this->ogreRoot->getRenderSystem()->getTextureGpuManager();
@@ -159,6 +289,11 @@ void Ogre2RenderEngine::Destroy()
   delete this->ogreLogManager;
   this->ogreLogManager = nullptr;
 
+  // the resource locations are gone with the ogre root
+  this->dataPtr->resourceUris.clear();
+  this->dataPtr->resourceLocations.clear();
+  this->dataPtr->scriptMaterials.clear();
+
 #if not (__APPLE__ || _WIN32)
   if (this->dummyDisplay)
   {
@@ -186,12 +321,53 @@ std::string Ogre2RenderEngine::Name() const
   return "ogre2";
 }
 
+/// \brief Get the names of the materials defined by an ogre material
+/// script, without parsing the script. Abstract materials are skipped.
+/// \param[in] _file Path to the material script
+/// \return Names of the materials in the script
+static std::vector<std::string> MaterialScriptNames(const std::string &_file)
+{
+  std::vector<std::string> names;
+  std::ifstream in(_file);
+  std::string line;
+  while (std::getline(in, line))
+  {
+    line = line.substr(0, line.find("//"));
+    std::istringstream tokens(line);
+    std::string keyword;
+    if (!(tokens >> keyword) || keyword != "material")
+      continue;
+
+    // the name may be quoted and is followed by an optional parent
+    std::string name;
+    tokens >> std::ws;
+    if (tokens.peek() == '"')
+    {
+      tokens.get();
+      std::getline(tokens, name, '"');
+    }
+    else
+    {
+      tokens >> name;
+      name = name.substr(0, name.find_first_of(":{"));
+    }
+
+    if (!name.empty())
+      names.push_back(name);
+  }
+  return names;
+}
+
 //////////////////////////////////////////////////
 void Ogre2RenderEngine::AddResourcePath(const std::string &_uri)
 {
   if (_uri == "__default__" || _uri.empty())
     return;
 
+  // meshes of the same model share their path, so most calls are repeats
+  if (this->dataPtr->resourceUris.count(_uri))
+    return;
+
   std::string path = common::findFilePath(_uri);
 
   if (path.empty())
@@ -200,6 +376,10 @@ void Ogre2RenderEngine::AddResourcePath(const std::string &_uri)
     return;
   }
 
+  this->dataPtr->resourceUris.insert(_uri);
+  if (!this->dataPtr->resourceLocations.insert(path).second)
+    return;
+
   this->resourcePaths.push_back(path);
 
   try
@@ -212,7 +392,9 @@ void Ogre2RenderEngine::AddResourcePath(const std::string &_uri)
 
       Ogre::ResourceGroupManager::getSingleton().initialiseResourceGroup(
           "General", false);
-      // Parse all material files in the path if any exist
+
+      // Index the material files in the path if any exist. They are only
+      // parsed when one of their materials is requested, see OgreMaterial
       if (common::isDirectory(path))
       {
         std::vector<std::string> paths;
@@ -224,39 +406,18 @@ void Ogre2RenderEngine::AddResourcePath(const std::string &_uri)
         }
         std::sort(paths.begin(), paths.end());
 
-        // Iterate over all the models in the current ign-rendering path
-        for (auto dIter = paths.begin(); dIter != paths.end(); ++dIter)
+        for (const auto &fullPath : paths)
         {
-          std::string fullPath = *dIter;
-          std::string matExtension = fullPath.substr(fullPath.size()-9);
-          if (matExtension == ".material")
+          if (fullPath.size() < 9u ||
+              fullPath.compare(fullPath.size() - 9u, 9u, ".material") != 0)
           {
-            Ogre::DataStreamPtr stream =
-              Ogre::ResourceGroupManager::getSingleton().openResource(
-                  fullPath, "General");
-
-            // There is a material file under there somewhere, read the thing in
-            try
-            {
-              Ogre::MaterialManager::getSingleton().parseScript(
-                  stream, "General");
-              Ogre::MaterialPtr matPtr =
-                Ogre::MaterialManager::getSingleton().getByName(
-                    fullPath);
-
-              if (!matPtr.isNull())
-              {
-                // is this necessary to do here? Someday try it without
-                matPtr->compile();
-                matPtr->load();
-              }
-            }
-            catch(Ogre::Exception& e)
-            {
-              ignerr << "Unable to parse material file[" << fullPath << "]\n";
-            }
-            stream->close();
+            continue;
           }
+
+          // the first script defining a material wins, as when all scripts
+          // were parsed up front in sorted order
+          for (const auto &name : MaterialScriptNames(fullPath))
+            this->dataPtr->scriptMaterials.emplace(name, fullPath);
         }
       }
     }
@@ -268,6 +429,50 @@ void Ogre2RenderEngine::AddResourcePath(const std::string &_uri)
   }
 }
 
+//////////////////////////////////////////////////
+Ogre::MaterialPtr Ogre2RenderEngine::OgreMaterial(const std::string &_name)
+{
+  Ogre::MaterialManager &matManager = Ogre::MaterialManager::getSingleton();
+  Ogre::MaterialPtr material = matManager.getByName(_name);
+  if (material)
+    return material;
+
+  auto it = this->dataPtr->scriptMaterials.find(_name);
+  if (it == this->dataPtr->scriptMaterials.end())
+    return material;
+
+  // parse the whole script, which defines the other materials indexed for
+  // it as well
+  std::string file = it->second;
+  for (auto mIt = this->dataPtr->scriptMaterials.begin();
+       mIt != this->dataPtr->scriptMaterials.end();)
+  {
+    if (mIt->second == file)
+      mIt = this->dataPtr->scriptMaterials.erase(mIt);
+    else
+      ++mIt;
+  }
+
+  try
+  {
+    Ogre::DataStreamPtr stream =
+        Ogre::ResourceGroupManager::getSingleton().openResource(
+            file, "General");
+    matManager.parseScript(stream, "General");
+    stream->close();
+  }
+  catch(Ogre::Exception &)
+  {
+    ignerr << "Unable to parse material file[" << file << "]\n";
+    return material;
+  }
+
+  material = matManager.getByName(_name);
+  if (material)
+    material->load();
+  return material;
+}
+
 //////////////////////////////////////////////////
 Ogre::Root *Ogre2RenderEngine::OgreRoot() const
 {
@@ -312,9 +517,152 @@ bool Ogre2RenderEngine::LoadImpl(
     bool useMetal;
     std::istringstream(it->second) >> useMetal;
     if(useMetal)
-        this->dataPtr->graphicsAPI = GraphicsAPI::METAL;
+        this->dataPtr->graphicsAPI = rendering::GraphicsAPI::METAL;
+  }
+
+  it = _params.find("vulkan");
+  if (it != _params.end())
+  {
+    bool useVulkan = false;
+    std::istringstream(it->second) >> useVulkan;
+    if (useVulkan && !kVulkanAvailable)
+    {
+      ignerr << "Vulkan requires ogre-next 2.3 or later, rendering with "
+             << "OpenGL instead" << std::endl;
+    }
+    else if (useVulkan)
+    {
+      // sensors drawn with the low level GLSL programs of this library
+      // can't be created under Vulkan, see Ogre2Scene::SensorSupported
+      this->dataPtr->graphicsAPI = rendering::GraphicsAPI::VULKAN;
+    }
+  }
+
+  it = _params.find("gpuTiming");
+  if (it != _params.end())
+  {
+    bool gpuTiming;
+    std::istringstream(it->second) >> gpuTiming;
+    this->SetGpuTimingEnabled(gpuTiming);
+  }
+
+  it = _params.find("drawStats");
+  if (it != _params.end())
+  {
+    bool drawStats;
+    std::istringstream(it->second) >> drawStats;
+    this->SetDrawStatsEnabled(drawStats);
+  }
+
+  it = _params.find("occlusionCulling");
+  if (it != _params.end())
+  {
+    bool occlusionCulling;
+    std::istringstream(it->second) >> occlusionCulling;
+    this->SetOcclusionCullingEnabled(occlusionCulling);
+  }
+
+  it = _params.find("sceneThreads");
+  if (it != _params.end())
+  {
+    unsigned int sceneThreads;
+    std::istringstream(it->second) >> sceneThreads;
+    this->SetSceneThreadCount(sceneThreads);
+  }
+
+  it = _params.find("sceneThreadedCulling");
+  if (it != _params.end())
+  {
+    bool threadedCulling = false;
+    std::istringstream(it->second) >> threadedCulling;
+    this->SetSceneThreadedCulling(threadedCulling);
+  }
+
+  it = _params.find("sceneThreadAffinity");
+  if (it != _params.end())
+  {
+    // comma separated cores and ranges of cores, e.g. "0-7,16"
+    std::vector<unsigned int> cores;
+    std::istringstream list(it->second);
+    std::string item;
+    while (std::getline(list, item, ','))
+    {
+      unsigned int first = 0u;
+      unsigned int last = 0u;
+      char dash = 0;
+      std::istringstream range(item);
+      if (!(range >> first))
+      {
+        ignerr << "Invalid core [" << item << "] in sceneThreadAffinity"
+               << std::endl;
+        continue;
+      }
+      last = first;
+      if (range >> dash && (dash != '-' || !(range >> last) || last < first))
+      {
+        ignerr << "Invalid core range [" << item << "] in "
+               << "sceneThreadAffinity" << std::endl;
+        continue;
+      }
+      for (unsigned int core = first; core <= last; ++core)
+        cores.push_back(core);
+    }
+    this->SetSceneThreadAffinity(cores);
+  }
+
+  it = _params.find("headlessDevice");
+  if (it != _params.end())
+    this->dataPtr->headlessDevice = it->second;
+
+  it = _params.find("shaderCache");
+  if (it != _params.end())
+    std::istringstream(it->second) >> this->dataPtr->shaderCache;
+
+  it = _params.find("shaderCachePath");
+  if (it != _params.end())
+    this->dataPtr->shaderCachePath = it->second;
+
+  // buffer pools, in megabytes
+  const std::map<std::string, std::string> vaoPools = {
+      {"vaoPoolCpuInaccessibleMB", "VaoManager::CPU_INACCESSIBLE"},
+      {"vaoPoolCpuAccessibleMB", "VaoManager::CPU_ACCESSIBLE_DEFAULT"},
+      {"vaoPoolPersistentMB", "VaoManager::CPU_ACCESSIBLE_PERSISTENT"},
+      {"vaoPoolPersistentCoherentMB",
+          "VaoManager::CPU_ACCESSIBLE_PERSISTENT_COHERENT"}};
+  for (const auto &pool : vaoPools)
+  {
+    it = _params.find(pool.first);
+    if (it == _params.end())
+      continue;
+    size_t megabytes = 0u;
+    std::istringstream(it->second) >> megabytes;
+    if (megabytes > 0u)
+    {
+      this->dataPtr->vaoPoolSizes[pool.second] =
+          std::to_string(megabytes * 1024u * 1024u);
+    }
   }
 
+  // texture streaming budgets, in megabytes
+  const std::map<std::string, size_t *> textureBudgets = {
+      {"textureStagingBudgetMB", &this->dataPtr->textureStagingBudget},
+      {"textureWorkerPreloadMB", &this->dataPtr->textureWorkerPreload},
+      {"textureWorkerRequestMB", &this->dataPtr->textureWorkerRequest}};
+  for (const auto &budget : textureBudgets)
+  {
+    it = _params.find(budget.first);
+    if (it == _params.end())
+      continue;
+    size_t megabytes = 0u;
+    std::istringstream(it->second) >> megabytes;
+    if (megabytes > 0u)
+      *budget.second = megabytes * 1024u * 1024u;
+  }
+
+  it = _params.find("preallocateBuffers");
+  if (it != _params.end())
+    std::istringstream(it->second) >> this->dataPtr->preallocateBuffers;
+
   try
   {
     this->LoadAttempt();
@@ -353,7 +701,7 @@ void Ogre2RenderEngine::LoadAttempt()
 {
   this->CreateLogger();
   if (!this->useCurrentGLContext &&
-      this->dataPtr->graphicsAPI == GraphicsAPI::OPENGL)
+      this->dataPtr->graphicsAPI == rendering::GraphicsAPI::OPENGL)
     this->CreateContext();
   this->CreateRoot();
   this->CreateOverlay();
@@ -361,6 +709,8 @@ void Ogre2RenderEngine::LoadAttempt()
   this->CreateRenderSystem();
   this->ogreRoot->initialise(false);
   this->CreateRenderWindow();
+  this->ConfigureGpuMemory();
+  this->LoadShaderCache();
   this->CreateResources();
 }
 
@@ -503,11 +853,16 @@ void Ogre2RenderEngine::LoadPlugins()
     p = common::joinPaths(path, "Plugin_ParticleFX");
     plugins.push_back(p);
 
-    if (this->dataPtr->graphicsAPI == GraphicsAPI::METAL)
+    if (this->dataPtr->graphicsAPI == rendering::GraphicsAPI::METAL)
     {
       p = common::joinPaths(path, "RenderSystem_Metal");
       plugins.push_back(p);
     }
+    else if (this->dataPtr->graphicsAPI == rendering::GraphicsAPI::VULKAN)
+    {
+      p = common::joinPaths(path, "RenderSystem_Vulkan");
+      plugins.push_back(p);
+    }
 
     for (piter = plugins.begin(); piter != plugins.end(); ++piter)
     {
@@ -555,10 +910,14 @@ void Ogre2RenderEngine::CreateRenderSystem()
 
   rsList = &(this->ogreRoot->getAvailableRenderers());
   std::string targetRenderSysName("OpenGL 3+ Rendering Subsystem");
-  if (this->dataPtr->graphicsAPI == GraphicsAPI::METAL)
+  if (this->dataPtr->graphicsAPI == rendering::GraphicsAPI::METAL)
   {
     targetRenderSysName = "Metal Rendering Subsystem";
   }
+  else if (this->dataPtr->graphicsAPI == rendering::GraphicsAPI::VULKAN)
+  {
+    targetRenderSysName = "Vulkan Rendering Subsystem";
+  }
 
   int c = 0;
 
@@ -585,7 +944,14 @@ void Ogre2RenderEngine::CreateRenderSystem()
             "and make sure OpenGL is enabled." << std::endl;
   }
 
-  if (!this->Headless())
+  if (this->dataPtr->graphicsAPI == rendering::GraphicsAPI::VULKAN)
+  {
+    // Vulkan renders off screen without an EGL context, and has none of
+    // the OpenGL options below
+    if (this->Headless() && !this->dataPtr->headlessDevice.empty())
+      this->SelectHeadlessDevice(renderSys);
+  }
+  else if (!this->Headless())
   {
 
     // We operate in windowed mode
@@ -610,6 +976,9 @@ void Ogre2RenderEngine::CreateRenderSystem()
     {
       std::cerr << "Unable to setup EGL (headless mode)" << '\n';
     }
+
+    if (!this->dataPtr->headlessDevice.empty())
+      this->SelectHeadlessDevice(renderSys);
   }
 
   // get all supported fsaa values
@@ -648,6 +1017,43 @@ void Ogre2RenderEngine::CreateRenderSystem()
   this->ogreRoot->setRenderSystem(renderSys);
 }
 
+//////////////////////////////////////////////////
+void Ogre2RenderEngine::SelectHeadlessDevice(Ogre::RenderSystem *_renderSys)
+{
+  const std::string &device = this->dataPtr->headlessDevice;
+  Ogre::ConfigOptionMap configMap = _renderSys->getConfigOptions();
+  auto deviceOption = configMap.find("Device");
+  if (deviceOption == configMap.end())
+  {
+    ignerr << "Unable to select headless device [" << device << "]: "
+           << "the render system does not list EGL devices" << std::endl;
+    return;
+  }
+
+  // the devices are listed as "(#<index>) <name>", select by index if the
+  // parameter is a number and by name otherwise
+  const Ogre::StringVector &devices = deviceOption->second.possibleValues;
+  bool byIndex = device.find_first_not_of("0123456789") == std::string::npos;
+  for (const auto &value : devices)
+  {
+    bool match = byIndex ? value.find("(#" + device + ")") == 0u :
+        value.find(device) != std::string::npos;
+    if (!match)
+      continue;
+
+    _renderSys->setConfigOption("Device", value);
+    ignmsg << "Using headless device [" << value << "]" << std::endl;
+    return;
+  }
+
+  std::stringstream available;
+  for (const auto &value : devices)
+    available << "\n  " << value;
+  ignerr << "Headless device [" << device << "] not found, using the "
+         << "default device. Available devices:" << available.str()
+         << std::endl;
+}
+
 void Ogre2RenderEngine::RegisterHlms()
 {
   const char *env = std::getenv("IGN_RENDERING_RESOURCE_PATH");
@@ -688,7 +1094,7 @@ void Ogre2RenderEngine::RegisterHlms()
   Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
       terraGLSLMaterialFolder, "FileSystem", "General");
 
-  if (this->dataPtr->graphicsAPI == GraphicsAPI::METAL)
+  if (this->dataPtr->graphicsAPI == rendering::GraphicsAPI::METAL)
   {
     Ogre::String commonMetalMaterialFolder = common::joinPaths(
         rootHlmsFolder, "2.0", "scripts", "materials", "Common", "Metal");
@@ -722,7 +1128,7 @@ void Ogre2RenderEngine::RegisterHlms()
       "FileSystem", true);
 
   {
-    Ogre::HlmsUnlit *hlmsUnlit = 0;
+    Ogre2IgnHlmsUnlit *hlmsUnlit = 0;
     // Create & Register HlmsUnlit
     // Get the path to all the subdirectories used by HlmsUnlit
     Ogre::HlmsUnlit::getDefaultPaths(mainFolderPath, libraryFoldersPaths);
@@ -743,17 +1149,20 @@ void Ogre2RenderEngine::RegisterHlms()
     archiveUnlitLibraryFolders.push_back(customizationsArchiveLibrary);
 
     // Create and register the unlit Hlms
-    hlmsUnlit = OGRE_NEW Ogre::HlmsUnlit(archiveUnlit,
-        &archiveUnlitLibraryFolders);
+    hlmsUnlit = OGRE_NEW Ogre2IgnHlmsUnlit(archiveUnlit,
+        &archiveUnlitLibraryFolders, this->dataPtr->materialOverride);
     Ogre::Root::getSingleton().getHlmsManager()->registerHlms(hlmsUnlit);
 
     // disable writting debug output to disk
     hlmsUnlit->setDebugOutputPath(false, false);
-    hlmsUnlit->setListener(&this->dataPtr->hlmsCustomizations);
+    this->dataPtr->materialOverride.SetListener(Ogre::HLMS_UNLIT,
+        &this->dataPtr->hlmsCustomizations);
+    hlmsUnlit->setListener(
+        this->dataPtr->materialOverride.Listener(Ogre::HLMS_UNLIT));
   }
 
   {
-    Ogre::HlmsPbs *hlmsPbs = 0;
+    Ogre2IgnHlmsPbs *hlmsPbs = 0;
     // Create & Register HlmsPbs
     // Do the same for HlmsPbs:
     Ogre::HlmsPbs::getDefaultPaths(mainFolderPath, libraryFoldersPaths);
@@ -782,8 +1191,12 @@ void Ogre2RenderEngine::RegisterHlms()
     }
 
     // Create and register
-    hlmsPbs = OGRE_NEW Ogre::HlmsPbs(archivePbs, &archivePbsLibraryFolders);
-    hlmsPbs->setListener(this->dataPtr->hlmsPbsTerraShadows.get());
+    hlmsPbs = OGRE_NEW Ogre2IgnHlmsPbs(archivePbs, &archivePbsLibraryFolders,
+        this->dataPtr->materialOverride);
+    this->dataPtr->materialOverride.SetListener(Ogre::HLMS_PBS,
+        this->dataPtr->hlmsPbsTerraShadows.get());
+    hlmsPbs->setListener(
+        this->dataPtr->materialOverride.Listener(Ogre::HLMS_PBS));
     Ogre::Root::getSingleton().getHlmsManager()->registerHlms(hlmsPbs);
 
     // disable writting debug output to disk
@@ -830,12 +1243,158 @@ void Ogre2RenderEngine::RegisterHlms()
 
     // disable writting debug output to disk
     hlmsTerra->setDebugOutputPath(false, false);
+    hlmsTerra->setListener(
+        this->dataPtr->materialOverride.Listener(Ogre::HLMS_USER3));
 
     this->dataPtr->terraWorkspaceListener.reset(
       new Ogre::TerraWorkspaceListener(hlmsTerra));
   }
 }
 
+//////////////////////////////////////////////////
+void Ogre2RenderEngine::LoadShaderCache()
+{
+  if (!this->dataPtr->shaderCache || !this->ogreRoot->getRenderSystem())
+    return;
+
+  // program binaries are only valid for the driver that compiled them, and
+  // the hlms templates change with ign-rendering, so each combination gets
+  // a directory of its own
+  Ogre::RenderSystem *renderSystem = this->ogreRoot->getRenderSystem();
+  const Ogre::RenderSystemCapabilities *caps =
+      renderSystem->getCapabilities();
+  std::stringstream key;
+  key << renderSystem->getName()
+      << " " << caps->getDeviceName()
+      << " " << caps->getDriverVersion().toString()
+      << " " << OGRE_VERSION_MAJOR << "." << OGRE_VERSION_MINOR << "."
+      << OGRE_VERSION_PATCH
+      << " " << IGNITION_RENDERING_VERSION_FULL;
+
+  std::string cachePath = this->dataPtr->shaderCachePath;
+  if (cachePath.empty())
+    cachePath = cacheDirectory("ogre2-shader-cache");
+  cachePath = common::joinPaths(cachePath,
+      common::sha1<std::string>(key.str()));
+  if (!common::createDirectories(cachePath))
+  {
+    ignwarn << "Unable to create shader cache directory [" << cachePath
+            << "], shaders will not be cached" << std::endl;
+    return;
+  }
+  this->dataPtr->shaderCacheDir = cachePath;
+
+  // keep the program binaries around so they can be saved on exit
+  Ogre::GpuProgramManager &gpuProgramManager =
+      Ogre::GpuProgramManager::getSingleton();
+  gpuProgramManager.setSaveMicrocodesToCache(true);
+
+  Ogre::ArchiveManager &archiveManager = Ogre::ArchiveManager::getSingleton();
+  Ogre::Archive *archive = nullptr;
+  try
+  {
+    archive = archiveManager.load(cachePath, "FileSystem", false);
+
+    const std::string microcodeFile = "microcodeCodeCache.cache";
+    if (archive->exists(microcodeFile))
+      gpuProgramManager.loadMicrocodeCache(archive->open(microcodeFile));
+
+    // the disk cache holds the hlms properties of every shader compiled
+    // before, applying it compiles them again straight from the binaries
+    Ogre::HlmsManager *hlmsManager = this->ogreRoot->getHlmsManager();
+    Ogre::HlmsDiskCache diskCache(hlmsManager);
+    for (size_t i = Ogre::HLMS_LOW_LEVEL + 1u; i < Ogre::HLMS_MAX; ++i)
+    {
+      Ogre::Hlms *hlms = hlmsManager->getHlms(static_cast<Ogre::HlmsTypes>(i));
+      const std::string hlmsFile = "hlmsDiskCache" + std::to_string(i) +
+          ".bin";
+      if (!hlms || !archive->exists(hlmsFile))
+        continue;
+
+      try
+      {
+        diskCache.loadFrom(archive->open(hlmsFile));
+        diskCache.applyTo(hlms);
+      }
+      catch (Ogre::Exception &_e)
+      {
+        ignwarn << "Unable to load shader cache file [" << hlmsFile
+                << "]: " << _e.getDescription() << std::endl;
+      }
+    }
+  }
+  catch (Ogre::Exception &_e)
+  {
+    ignwarn << "Unable to load shader cache [" << cachePath << "]: "
+            << _e.getDescription() << std::endl;
+  }
+
+  if (archive)
+    archiveManager.unload(archive);
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderEngine::SaveShaderCache()
+{
+  if (this->dataPtr->shaderCacheDir.empty())
+    return;
+
+  // other processes sharing the cache never load a partially written file
+  auto saveFile = [this](const std::string &_name,
+      const std::function<void(Ogre::DataStreamPtr)> &_save)
+  {
+    std::string file =
+        common::joinPaths(this->dataPtr->shaderCacheDir, _name);
+    writeFileAtomically(file, [&](const std::string &_tmpFile)
+    {
+      std::fstream stream(_tmpFile, std::ios::in | std::ios::out |
+          std::ios::binary | std::ios::trunc);
+      try
+      {
+        Ogre::DataStreamPtr dataStream(
+            OGRE_NEW Ogre::FileStreamDataStream(_tmpFile, &stream, false));
+        _save(dataStream);
+      }
+      catch (Ogre::Exception &_e)
+      {
+        ignwarn << "Unable to save shader cache file [" << file << "]: "
+                << _e.getDescription() << std::endl;
+        return false;
+      }
+      stream.close();
+      return static_cast<bool>(stream);
+    });
+  };
+
+  Ogre::HlmsManager *hlmsManager = this->ogreRoot->getHlmsManager();
+  Ogre::HlmsDiskCache diskCache(hlmsManager);
+  for (size_t i = Ogre::HLMS_LOW_LEVEL + 1u; i < Ogre::HLMS_MAX; ++i)
+  {
+    Ogre::Hlms *hlms = hlmsManager->getHlms(static_cast<Ogre::HlmsTypes>(i));
+    if (!hlms)
+      continue;
+
+    diskCache.copyFrom(hlms);
+    saveFile("hlmsDiskCache" + std::to_string(i) + ".bin",
+        [&](Ogre::DataStreamPtr _stream)
+    {
+      diskCache.saveTo(_stream);
+    });
+  }
+
+  Ogre::GpuProgramManager &gpuProgramManager =
+      Ogre::GpuProgramManager::getSingleton();
+  if (gpuProgramManager.isCacheDirty())
+  {
+    saveFile("microcodeCodeCache.cache", [&](Ogre::DataStreamPtr _stream)
+    {
+      gpuProgramManager.saveMicrocodeCache(_stream);
+    });
+  }
+
+  this->dataPtr->shaderCacheDir.clear();
+}
+
 //////////////////////////////////////////////////
 void Ogre2RenderEngine::CreateResources()
 {
@@ -850,6 +1409,15 @@ void Ogre2RenderEngine::CreateResources()
     mediaPath = common::joinPaths(resourcePath, "ogre2", "src", "media");
   }
 
+  // the fonts live in the ogre engine media. They are installed with the
+  // ogre2 media, in the src path they are read from the ogre media
+  std::string fontsPath = common::joinPaths(mediaPath, "fonts");
+  if (!common::exists(fontsPath))
+  {
+    fontsPath =
+        common::joinPaths(resourcePath, "ogre", "src", "media", "fonts");
+  }
+
   // register low level materials (ogre v1 materials)
   std::vector< std::pair<std::string, std::string> > archNames;
   std::string p = mediaPath;
@@ -857,6 +1425,8 @@ void Ogre2RenderEngine::CreateResources()
   {
     archNames.push_back(
         std::make_pair(p, "General"));
+    archNames.push_back(
+        std::make_pair(fontsPath, "General"));
     archNames.push_back(
         std::make_pair(p + "/materials/programs", "General"));
     archNames.push_back(
@@ -905,8 +1475,13 @@ std::string Ogre2RenderEngine::CreateRenderWindow(const std::string &_handle,
   Ogre::NameValuePairList params;
   window = nullptr;
 
-  // if use current gl then don't include window handle params
-  if (!this->useCurrentGLContext)
+  // if use current gl then don't include window handle params. There is no
+  // GL context, and so no dummy window, with Vulkan, which creates the
+  // window itself
+  const bool vulkanDummyWindow =
+      this->dataPtr->graphicsAPI == rendering::GraphicsAPI::VULKAN &&
+      _handle == std::to_string(this->dummyWindowId);
+  if (!this->useCurrentGLContext && !vulkanDummyWindow)
   {
     // Mac and Windows *must* use externalWindow handle.
 #if defined(__APPLE__) || defined(_MSC_VER)
@@ -919,6 +1494,11 @@ std::string Ogre2RenderEngine::CreateRenderWindow(const std::string &_handle,
   params["FSAA"] = std::to_string(_antiAliasing);
   params["stereoMode"] = "Frame Sequential";
 
+  // the VaoManager reads its pool sizes from the parameters of the first
+  // window
+  for (const auto &pool : this->dataPtr->vaoPoolSizes)
+    params[pool.first] = pool.second;
+
   // TODO(anyone): determine api without qt
 
 #if defined(__APPLE__)
@@ -986,6 +1566,54 @@ std::string Ogre2RenderEngine::CreateRenderWindow(const std::string &_handle,
   return stream.str();
 }
 
+//////////////////////////////////////////////////
+void Ogre2RenderEngine::ConfigureGpuMemory()
+{
+  this->ResetTextureBudgets();
+
+  if (!this->dataPtr->preallocateBuffers)
+    return;
+
+  Ogre::VaoManager *vaoManager =
+      this->ogreRoot->getRenderSystem()->getVaoManager();
+
+  // a pool is allocated with the first buffer of its kind and kept once
+  // the buffer is destroyed, so allocating a tiny buffer of each kind
+  // creates the pools now instead of in the middle of a simulation
+  for (auto type : {Ogre::BT_DEFAULT, Ogre::BT_DYNAMIC_DEFAULT,
+      Ogre::BT_DYNAMIC_PERSISTENT, Ogre::BT_DYNAMIC_PERSISTENT_COHERENT})
+  {
+    Ogre::IndexBufferPacked *buffer = vaoManager->createIndexBuffer(
+        Ogre::IndexBufferPacked::IT_16BIT, 1u, type, nullptr, false);
+    vaoManager->destroyIndexBuffer(buffer);
+  }
+
+  // released staging buffers are kept for reuse until their lifetime ends
+  for (bool upload : {true, false})
+  {
+    Ogre::StagingBuffer *staging = vaoManager->getStagingBuffer(
+        this->dataPtr->textureWorkerRequest, upload);
+    staging->removeReferenceCount();
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderEngine::ResetTextureBudgets()
+{
+  Ogre::TextureGpuManager *textureManager =
+      this->ogreRoot->getRenderSystem()->getTextureGpuManager();
+
+  textureManager->setStagingTextureMaxBudgetBytes(
+      this->dataPtr->textureStagingBudget);
+  textureManager->setWorkerThreadMaxPreloadBytes(
+      this->dataPtr->textureWorkerPreload);
+  textureManager->setWorkerThreadMaxPerStagingTextureRequestBytes(
+      this->dataPtr->textureWorkerRequest);
+
+  Ogre::TextureGpuManager::BudgetEntryVec budget;
+  textureManager->setWorkerThreadMinimumBudget(budget);
+}
+
 //////////////////////////////////////////////////
 void Ogre2RenderEngine::InitAttempt()
 {
@@ -1009,6 +1637,47 @@ Ogre2IgnHlmsCustomizations& Ogre2RenderEngine::HlmsCustomizations()
   return this->dataPtr->hlmsCustomizations;
 }
 
+/////////////////////////////////////////////////
+Ogre2MaterialOverride &Ogre2RenderEngine::MaterialOverride()
+{
+  return this->dataPtr->materialOverride;
+}
+
+/////////////////////////////////////////////////
+Ogre2TransientTextures &Ogre2RenderEngine::TransientTextures()
+{
+  return this->dataPtr->transientTextures;
+}
+
+/////////////////////////////////////////////////
+Ogre2SharedMeshes &Ogre2RenderEngine::SharedMeshes()
+{
+  return this->dataPtr->sharedMeshes;
+}
+
+/////////////////////////////////////////////////
+void Ogre2RenderEngine::AcquireWorkspaceDefinition(const std::string &_name)
+{
+  std::lock_guard<std::mutex> lock(
+      this->dataPtr->sharedWorkspaceDefinitionsMutex);
+  ++this->dataPtr->sharedWorkspaceDefinitions[_name];
+}
+
+/////////////////////////////////////////////////
+bool Ogre2RenderEngine::ReleaseWorkspaceDefinition(const std::string &_name)
+{
+  std::lock_guard<std::mutex> lock(
+      this->dataPtr->sharedWorkspaceDefinitionsMutex);
+  auto &definitions = this->dataPtr->sharedWorkspaceDefinitions;
+  auto it = definitions.find(_name);
+  if (it == definitions.end())
+    return true;
+  if (--it->second > 0u)
+    return false;
+  definitions.erase(it);
+  return true;
+}
+
 /////////////////////////////////////////////////
 Ogre::v1::OverlaySystem *Ogre2RenderEngine::OverlaySystem() const
 {
@@ -1028,6 +1697,141 @@ Ogre::CompositorWorkspaceListener *Ogre2RenderEngine::TerraWorkspaceListener()
   return this->dataPtr->terraWorkspaceListener.get();
 }
 
+/////////////////////////////////////////////////
+rendering::MemoryStats Ogre2RenderEngine::MemoryStats() const
+{
+  rendering::MemoryStats stats;
+  if (!this->ogreRoot || !this->ogreRoot->getRenderSystem())
+    return stats;
+
+  std::unordered_set<const void *> seen;
+
+  // textures, render targets and shadow maps of all scenes and sensors
+  Ogre::TextureGpuManager *textureManager =
+      this->ogreRoot->getRenderSystem()->getTextureGpuManager();
+  for (const auto &entry : textureManager->getEntries())
+  {
+    if (!entry.second.destroyRequested)
+    {
+      Ogre2MemoryStats::AddTexture(entry.second.texture, seen, stats);
+    }
+  }
+
+  size_t textureBytesCpu = 0u;
+  size_t textureBytesGpu = 0u;
+  size_t usedStagingBytes = 0u;
+  size_t availableStagingBytes = 0u;
+  textureManager->getMemoryStats(textureBytesCpu, textureBytesGpu,
+      usedStagingBytes, availableStagingBytes);
+  stats.stagingBufferBytes = usedStagingBytes + availableStagingBytes;
+
+  // all loaded meshes, including the ones not used by any visual yet
+  auto it = Ogre::MeshManager::getSingleton().getResourceIterator();
+  while (it.hasMoreElements())
+  {
+    Ogre::MeshPtr mesh = it.getNext().staticCast<Ogre::Mesh>();
+    Ogre2MemoryStats::AddMesh(mesh.get(), seen, stats);
+  }
+  return stats;
+}
+
+/////////////////////////////////////////////////
+void Ogre2RenderEngine::SetGpuTimingEnabled(bool _enabled)
+{
+  if (_enabled &&
+      this->dataPtr->graphicsAPI != rendering::GraphicsAPI::OPENGL)
+  {
+    ignwarn << "GPU timing is only supported with OpenGL" << std::endl;
+    return;
+  }
+  this->dataPtr->gpuTiming = _enabled;
+}
+
+/////////////////////////////////////////////////
+rendering::GraphicsAPI Ogre2RenderEngine::GraphicsAPI() const
+{
+  return this->dataPtr->graphicsAPI;
+}
+
+/////////////////////////////////////////////////
+bool Ogre2RenderEngine::GpuTimingEnabled() const
+{
+  return this->dataPtr->gpuTiming;
+}
+
+/////////////////////////////////////////////////
+void Ogre2RenderEngine::SetDrawStatsEnabled(bool _enabled)
+{
+  this->dataPtr->drawStats = _enabled;
+}
+
+/////////////////////////////////////////////////
+bool Ogre2RenderEngine::DrawStatsEnabled() const
+{
+  return this->dataPtr->drawStats;
+}
+
+/////////////////////////////////////////////////
+void Ogre2RenderEngine::SetOcclusionCullingEnabled(bool _enabled)
+{
+  this->dataPtr->occlusionCulling = _enabled;
+}
+
+/////////////////////////////////////////////////
+bool Ogre2RenderEngine::OcclusionCullingEnabled() const
+{
+  return this->dataPtr->occlusionCulling;
+}
+
+/////////////////////////////////////////////////
+void Ogre2RenderEngine::SetSceneThreadCount(unsigned int _count)
+{
+  this->dataPtr->sceneThreadCount = _count;
+}
+
+/////////////////////////////////////////////////
+unsigned int Ogre2RenderEngine::SceneThreadCount() const
+{
+  if (this->dataPtr->sceneThreadCount > 0u)
+    return this->dataPtr->sceneThreadCount;
+
+  // getNumLogicalCores() may return 0 if couldn't detect
+  return std::max<unsigned int>(1u, static_cast<unsigned int>(
+      Ogre::PlatformInformation::getNumLogicalCores()));
+}
+
+/////////////////////////////////////////////////
+void Ogre2RenderEngine::SetSceneThreadedCulling(bool _enabled)
+{
+  this->dataPtr->sceneThreadedCulling = _enabled;
+}
+
+/////////////////////////////////////////////////
+bool Ogre2RenderEngine::SceneThreadedCulling() const
+{
+  return this->dataPtr->sceneThreadedCulling;
+}
+
+/////////////////////////////////////////////////
+void Ogre2RenderEngine::SetSceneThreadAffinity(
+    const std::vector<unsigned int> &_cores)
+{
+  this->dataPtr->sceneThreadAffinity = _cores;
+}
+
+/////////////////////////////////////////////////
+const std::vector<unsigned int> &Ogre2RenderEngine::SceneThreadAffinity()
+    const
+{
+  return this->dataPtr->sceneThreadAffinity;
+}
+
+//////////////////////////////////////////////////
+Ogre2WorkerPool &Ogre2RenderEngine::WorkerPool()
+{
+  return this->dataPtr->workerPool;
+}
+
 // Register this plugin
 IGNITION_ADD_PLUGIN(ignition::rendering::Ogre2RenderEnginePlugin,
                     ignition::rendering::RenderEnginePlugin)
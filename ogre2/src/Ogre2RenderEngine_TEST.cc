@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/GraphicsAPI.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(Ogre2RenderEngineTest, VulkanSensors)
+{
+  Ogre2RenderEngine *engine = Ogre2RenderEngine::Instance();
+  std::map<std::string, std::string> params;
+  params["vulkan"] = "1";
+  if (!engine->Load(params) || !engine->Init())
+  {
+    igndbg << "Engine 'ogre2' is not supported" << std::endl;
+    return;
+  }
+  if (engine->GraphicsAPI() != GraphicsAPI::VULKAN)
+  {
+    igndbg << "Vulkan is not available" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  // cameras drawn with the high level materials are supported
+  EXPECT_NE(nullptr, scene->CreateCamera());
+
+  // sensors drawn with the low level GLSL programs are refused, and are
+  // not registered with the scene
+  unsigned int sensorCount = scene->SensorCount();
+  EXPECT_EQ(nullptr, scene->CreateDepthCamera());
+  EXPECT_EQ(nullptr, scene->CreateThermalCamera());
+  EXPECT_EQ(nullptr, scene->CreateSegmentationCamera());
+  EXPECT_EQ(nullptr, scene->CreateWideAngleCamera());
+  EXPECT_EQ(nullptr, scene->CreateBoundingBoxCamera());
+  EXPECT_EQ(nullptr, scene->CreateGpuRays());
+  EXPECT_EQ(sensorCount, scene->SensorCount());
+
+  engine->DestroyScene(scene);
+}
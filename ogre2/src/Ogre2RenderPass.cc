@@ -19,6 +19,11 @@
 /// \brief Private data for the Ogre2RenderPass class
 class ignition::rendering::Ogre2RenderPassPrivate
 {
+  /// \brief Render passes applied by this pass's compositor node
+  public: std::vector<std::weak_ptr<Ogre2RenderPass>> fusedPasses;
+
+  /// \brief True if this pass is fused into a previous one
+  public: bool fused = false;
 };
 
 using namespace ignition;
@@ -40,6 +45,12 @@ void Ogre2RenderPass::Destroy()
 {
 }
 
+//////////////////////////////////////////////////
+void Ogre2RenderPass::SetCamera(Ogre::Camera *_camera)
+{
+  this->ogreCamera = _camera;
+}
+
 //////////////////////////////////////////////////
 void Ogre2RenderPass::CreateRenderPass()
 {
@@ -51,3 +62,35 @@ std::string Ogre2RenderPass::OgreCompositorNodeDefinitionName() const
 {
   return this->ogreCompositorNodeDefName;
 }
+
+//////////////////////////////////////////////////
+bool Ogre2RenderPass::CanFuse(const Ogre2RenderPass &/*_pass*/) const
+{
+  return false;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderPass::SetFusedPasses(
+    const std::vector<std::weak_ptr<Ogre2RenderPass>> &_passes)
+{
+  this->dataPtr->fusedPasses = _passes;
+}
+
+//////////////////////////////////////////////////
+const std::vector<std::weak_ptr<Ogre2RenderPass>> &
+    Ogre2RenderPass::FusedPasses() const
+{
+  return this->dataPtr->fusedPasses;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderPass::SetFused(bool _fused)
+{
+  this->dataPtr->fused = _fused;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2RenderPass::IsFused() const
+{
+  return this->dataPtr->fused;
+}
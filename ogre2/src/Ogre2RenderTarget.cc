@@ -15,7 +15,21 @@
  *
  */
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include <ignition/common/Console.hh>
+#include <ignition/common/Profiler.hh>
+#include <ignition/math/Helpers.hh>
 
 #include "ignition/rendering/Material.hh"
 
@@ -27,6 +41,9 @@
 #include "ignition/rendering/ogre2/Ogre2RenderTarget.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
 
+#include "Ogre2ObjectId.hh"
+#include "Ogre2TransientTextures.hh"
+
 namespace ignition
 {
 namespace rendering
@@ -70,6 +87,7 @@ class Ogre2RenderTargetCompositorListener :
   /// \brief Pointer to render target that added this listener
   private: Ogre2RenderTarget *ogreRenderTarget = nullptr;
 };
+
 }
 }
 }
@@ -80,6 +98,10 @@ class ignition::rendering::Ogre2RenderTargetPrivate
   /// \brief Listener for chaning compositor pass properties
   public: Ogre2RenderTargetCompositorListener *rtListener = nullptr;
 
+  /// \brief Extra listeners added to the compositor workspace
+  public: std::vector<Ogre::CompositorWorkspaceListener *>
+      workspaceListeners;
+
   /// \brief Name of sky box material
   public: const std::string kSkyboxMaterialName = "SkyBox";
 
@@ -92,6 +114,36 @@ class ignition::rendering::Ogre2RenderTargetPrivate
   /// \brief Name of shadow compositor node
   public: const std::string kShadowNodeName = "PbsMaterialsShadowNode";
 
+  /// \brief True if the workspace definition is shared with other render
+  /// targets that have the same settings. Shared definitions must not be
+  /// modified, e.g. by the render pass chain.
+  public: bool sharedDefinition = false;
+
+  /// \brief True if the sky pass is left out of the compositor because
+  /// the camera only sees below the horizon
+  /// \sa Ogre2Scene::SetSkyHorizonCulling
+  public: bool skyCulled = false;
+
+  /// \brief Cameras of the views rendered side by side, empty if only
+  /// the render target camera is rendered
+  public: std::vector<Ogre::Camera *> viewCameras;
+
+  /// \brief True if views after the first one reuse its shadow maps
+  public: bool shareViewShadows = false;
+
+  /// \brief Number of columns of the grid of views, 0 for a single row
+  public: unsigned int viewColumns = 0u;
+
+  /// \brief True if the scene passes render shadows
+  public: bool shadowsEnabled = true;
+
+  /// \brief Scale of the resolution the scene passes render at
+  public: double resolutionScale = 1.0;
+
+  /// \brief Static shadows revision the workspace was last updated with
+  /// \sa Ogre2Scene::UpdateStaticShadowMaps
+  public: uint64_t staticShadowsRevision = 0u;
+
   /// \brief Pointer to the internal ogre render texture objects
   /// There's two because we ping pong postprocessing effects
   /// and the final result is always in ogreTexture[1]
@@ -99,11 +151,156 @@ class ignition::rendering::Ogre2RenderTargetPrivate
   /// actual window
   ///
   public: Ogre::TextureGpu *ogreTexture[2] = {nullptr, nullptr};
+
+  /// \brief Multisampled texture the scene passes render to, shared with
+  /// the other targets of the same size and anti-aliasing
+  /// \sa Ogre2TransientTextures
+  public: Ogre::TextureGpu *fsaaTexture = nullptr;
+
+  /// \brief A copy queued by CopyAsync
+  public: struct AsyncCopy
+  {
+    /// \brief Staging buffer the render target is downloaded to
+    Ogre::AsyncTextureTicket *ticket = nullptr;
+
+    /// \brief Image the data is written to
+    Image *image = nullptr;
+
+    /// \brief Function called once the image is written
+    std::function<void()> callback;
+  };
+
+  /// \brief Copies queued by CopyAsync, oldest first
+  public: std::deque<AsyncCopy> asyncCopies;
+
+  /// \brief Staging buffers no longer in use, reused by the next copies
+  public: std::vector<Ogre::AsyncTextureTicket *> freeTickets;
+
+  /// \brief Maximum number of queued copies. Queuing more waits for the
+  /// oldest one, which bounds the memory used by the staging buffers.
+  public: const size_t kMaxAsyncCopies = 4u;
+
+  /// \brief Single channel texture holding the I420 conversion of the
+  /// render target
+  public: Ogre::TextureGpu *i420Texture = nullptr;
+
+  /// \brief Workspace converting the render target to i420Texture
+  public: Ogre::CompositorWorkspace *i420Workspace = nullptr;
+
+  /// \brief Name of the workspace definition of i420Workspace
+  public: std::string i420WorkspaceDefName;
+
+  /// \brief Render target texture i420Workspace converts
+  public: Ogre::TextureGpu *i420Input = nullptr;
+
+  /// \brief True if the scene passes keep their depth for reprojection
+  public: bool reprojectionEnabled = false;
+
+  /// \brief Copy of the last rendered frame
+  public: Ogre::TextureGpu *keyColorTexture = nullptr;
+
+  /// \brief True if keyColorTexture holds a frame rendered by the current
+  /// workspace, whose depth texture still holds the depth of that frame
+  public: bool hasKeyFrame = false;
+
+  /// \brief View matrix of the camera when the last frame was rendered
+  public: Ogre::Matrix4 keyViewMatrix;
+
+  /// \brief Projection parameters A and B of the camera when the last
+  /// frame was rendered
+  public: Ogre::Vector2 keyProjectionParams;
+
+  /// \brief Tangents of half the horizontal and vertical field of view of
+  /// the camera when the last frame was rendered
+  public: Ogre::Vector2 keyTanHalfFov;
+
+  /// \brief Material warping the last rendered frame
+  public: Ogre::MaterialPtr reprojectionMaterial;
+
+  /// \brief Workspace warping keyColorTexture to the render target
+  public: Ogre::CompositorWorkspace *reprojectionWorkspace = nullptr;
+
+  /// \brief Name of the workspace definition of reprojectionWorkspace
+  public: std::string reprojectionWorkspaceDefName;
+
+  /// \brief Depth texture reprojectionWorkspace reads
+  public: Ogre::TextureGpu *reprojectionDepth = nullptr;
+
+  /// \brief Render target texture reprojectionWorkspace writes to
+  public: Ogre::TextureGpu *reprojectionOutput = nullptr;
+
+  /// \brief True if the scene passes write object ids
+  public: bool objectIdEnabled = false;
+
+  /// \brief True if the object id texture holds the ids of a rendered
+  /// frame
+  public: bool hasObjectIds = false;
+
+  /// \brief Staging buffer the object ids around objectIdCenter are
+  /// downloaded to
+  public: Ogre::AsyncTextureTicket *objectIdTicket = nullptr;
+
+  /// \brief True if objectIdTicket holds ids of the last rendered frame
+  public: bool objectIdsDownloaded = false;
+
+  /// \brief Pixel of the object id texture last passed to ObjectIdAt,
+  /// negative if ObjectIdAt has not been called
+  public: int objectIdCenter[2] = {-1, -1};
+
+  /// \brief Top left pixel of the region downloaded to objectIdTicket
+  public: uint32_t objectIdRegion[2] = {0u, 0u};
+
+  /// \brief Width and height of the region downloaded after each frame.
+  /// Small enough for the download to cost next to nothing, large enough
+  /// to cover the cursor motion of a frame.
+  public: const uint32_t kObjectIdRegionSize = 64u;
+
+  /// \brief True if the scene passes keep their depth for DepthAt
+  public: bool depthQueryEnabled = false;
+
+  /// \brief True if the depth texture holds the depth of a frame rendered
+  /// with a perspective camera, which DepthAt can linearize
+  public: bool hasDepth = false;
+
+  /// \brief Projection parameters A and B of the camera when the depth
+  /// texture was rendered
+  public: Ogre::Vector2 depthProjectionParams;
+
+  /// \brief View projection matrix of the camera when the depth texture
+  /// was rendered
+  public: Ogre::Matrix4 depthViewProj;
+
+  /// \brief Scene time when the depth texture was rendered
+  public: std::chrono::steady_clock::duration depthTime;
+
+  /// \brief Staging buffer of the depth texel DepthAt reads
+  public: Ogre::AsyncTextureTicket *depthTicket = nullptr;
 };
 
 using namespace ignition;
 using namespace rendering;
 
+//////////////////////////////////////////////////
+/// \brief Write pixels converted to a padded ogre format to an image,
+/// dropping the padding channels at the end of each pixel
+/// \param[in] _padded Pixels in the padded format, rows tightly packed
+/// \param[in] _paddedBpp Bytes per pixel of the padded format
+/// \param[in] _image Image the pixels are written to
+static void RemovePadding(const std::vector<uint8_t> &_padded,
+    size_t _paddedBpp, Image &_image)
+{
+  size_t bpp = PixelUtil::BytesPerPixel(_image.Format());
+  unsigned int width = _image.Width();
+  unsigned char *dst = _image.Data<unsigned char>();
+  for (unsigned int y = 0; y < _image.Height(); ++y)
+  {
+    const uint8_t *srcRow = _padded.data() + y * width * _paddedBpp;
+    unsigned char *dstRow = dst + y * _image.RowPitch();
+    for (unsigned int x = 0; x < width; ++x)
+      memcpy(dstRow + x * bpp, srcRow + x * _paddedBpp, bpp);
+  }
+}
+
 //////////////////////////////////////////////////
 // Ogre2RenderTarget
 //////////////////////////////////////////////////
@@ -117,6 +314,8 @@ Ogre2RenderTarget::Ogre2RenderTarget()
 //////////////////////////////////////////////////
 Ogre2RenderTarget::~Ogre2RenderTarget()
 {
+  this->DestroyAsyncCopies();
+
   if (this->dataPtr->rtListener)
   {
     delete this->dataPtr->rtListener;
@@ -134,7 +333,8 @@ void Ogre2RenderTarget::BuildCompositor()
   this->UpdateBackgroundMaterial();
 
   bool validBackground = this->backgroundMaterial &&
-      !this->backgroundMaterial->EnvironmentMap().empty();
+      !this->backgroundMaterial->EnvironmentMap().empty() &&
+      !this->dataPtr->skyCulled;
 
   // The function build a similar compositor as the one defined in
   // ogre2/media/2.0/scripts/Compositors/PbsMaterials.compositor
@@ -143,7 +343,61 @@ void Ogre2RenderTarget::BuildCompositor()
   // todo(anyone) Note the definition programmatically created here
   // replaces the one defined in the script so it maybe safe to remove the
   // PbsMaterials.compositor file
-  std::string wsDefName = "PbsMaterialWorkspace_" + this->Name();
+
+  // object ids can't be resolved from multisampled textures, and only the
+  // GLSL hlms pieces write them
+  const bool objectIds = this->dataPtr->objectIdEnabled &&
+      this->TargetFSAA() <= 1u &&
+      Ogre2RenderEngine::Instance()->GraphicsAPI() ==
+      rendering::GraphicsAPI::OPENGL;
+  if (this->dataPtr->objectIdEnabled && !objectIds)
+  {
+    ignwarn << "Object ids are only written by OpenGL without "
+            << "anti-aliasing, picks in [" << this->Name()
+            << "] use the selection buffer instead" << std::endl;
+  }
+
+  // reprojection and depth queries read the depth buffer after the frame
+  const bool keepDepth = this->dataPtr->reprojectionEnabled ||
+      this->dataPtr->depthQueryEnabled;
+
+  // Targets without render passes or views only differ by the settings in
+  // the key below, so they share one definition instead of creating one
+  // each. Render passes and views modify the definition, so targets that
+  // use them get their own.
+  std::string wsDefName;
+  this->dataPtr->sharedDefinition = this->renderPasses.empty() &&
+      this->dataPtr->viewCameras.empty();
+  if (this->dataPtr->sharedDefinition)
+  {
+    std::ostringstream key;
+    key << "PbsMaterialWorkspace_shared"
+        << "_" << static_cast<int>(this->format)
+        << "_" << static_cast<int>(this->TargetFSAA())
+        << "_" << std::hex << this->ogreBackgroundColor.getAsRGBA()
+        << std::dec;
+    if (validBackground)
+      key << "_" << this->SkyboxMaterialName();
+    if (this->IsRenderWindow())
+      key << "_window";
+    if (!this->dataPtr->shadowsEnabled)
+      key << "_noshadows";
+    if (keepDepth)
+      key << "_depth";
+    if (objectIds)
+      key << "_ids";
+    if (this->dataPtr->resolutionScale < 1.0)
+    {
+      key << "_scale" << static_cast<int>(
+          std::round(this->dataPtr->resolutionScale * 1000.0));
+    }
+    wsDefName = key.str();
+    engine->AcquireWorkspaceDefinition(wsDefName);
+  }
+  else
+  {
+    wsDefName = "PbsMaterialWorkspace_" + this->Name();
+  }
   this->ogreCompositorWorkspaceDefName = wsDefName;
   if (!ogreCompMgr->hasWorkspaceDefinition(wsDefName))
   {
@@ -157,6 +411,20 @@ void Ogre2RenderTarget::BuildCompositor()
     nodeDef->addTextureSourceName(
           "rt1", 1u, Ogre::TextureDefinitionBase::TEXTURE_INPUT);
 
+    // at a lower resolution, the scene passes render into a smaller
+    // texture, which is upscaled to rt0 afterwards
+    const float resolutionScale =
+        static_cast<float>(this->dataPtr->resolutionScale);
+    const bool scaled = resolutionScale < 1.0f;
+    if (scaled)
+    {
+      Ogre::TextureDefinitionBase::TextureDefinition *scaledDef =
+          nodeDef->addTextureDefinition("rt_scaled");
+      scaledDef->widthFactor = resolutionScale;
+      scaledDef->heightFactor = resolutionScale;
+      scaledDef->fsaa = "0";
+    }
+
     {
       // Add a manually-defined RTV (based on an automatically generated one)
       // so that we can perform an explicit MSAA resolve.
@@ -166,17 +434,66 @@ void Ogre2RenderTarget::BuildCompositor()
           nodeDef->addRenderTextureView( "rtv" );
 
       *rtvDef = *rt0Def;
+      if (scaled)
+        rtvDef->colourAttachments[0].textureName = "rt_scaled";
 
       const uint8_t fsaa = TargetFSAA();
       if (fsaa > 1u)
       {
-        Ogre::TextureDefinitionBase::TextureDefinition *msaaDef =
-            nodeDef->addTextureDefinition("rt_fsaa");
+        // the multisampled texture is resolved before the node ends, so
+        // targets with the same settings share it, see
+        // Ogre2TransientTextures
+        if (!this->IsRenderWindow())
+        {
+          nodeDef->addTextureSourceName("rt_fsaa", 2u,
+              Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+        }
+        else
+        {
+          Ogre::TextureDefinitionBase::TextureDefinition *msaaDef =
+              nodeDef->addTextureDefinition("rt_fsaa");
 
-        msaaDef->fsaa = std::to_string(fsaa);
+          msaaDef->fsaa = std::to_string(fsaa);
+          msaaDef->widthFactor = resolutionScale;
+          msaaDef->heightFactor = resolutionScale;
+        }
 
         rtvDef->colourAttachments[0].textureName = "rt_fsaa";
-        rtvDef->colourAttachments[0].resolveTextureName = "rt0";
+        rtvDef->colourAttachments[0].resolveTextureName =
+            scaled ? "rt_scaled" : "rt0";
+      }
+
+      // keep the depth buffer in a texture of its own, which Reproject
+      // reads to warp the frame and DepthAt reads to resolve points
+      if (keepDepth)
+      {
+        Ogre::TextureDefinitionBase::TextureDefinition *depthDef =
+            nodeDef->addTextureDefinition("rt_depth");
+        depthDef->format = Ogre::PFG_D32_FLOAT;
+        depthDef->widthFactor = resolutionScale;
+        depthDef->heightFactor = resolutionScale;
+        depthDef->fsaa = fsaa > 1u ? std::to_string(fsaa) : "0";
+        depthDef->depthBufferId = Ogre::DepthBuffer::POOL_NON_SHAREABLE;
+        depthDef->depthBufferFormat = Ogre::PFG_UNKNOWN;
+
+        rtvDef->depthAttachment.textureName = "rt_depth";
+      }
+
+      // the scene passes write object ids to a second color attachment,
+      // which ObjectIdAt reads
+      if (objectIds)
+      {
+        Ogre::TextureDefinitionBase::TextureDefinition *idDef =
+            nodeDef->addTextureDefinition("rt_id");
+        idDef->format = Ogre::PFG_R32_UINT;
+        idDef->widthFactor = resolutionScale;
+        idDef->heightFactor = resolutionScale;
+        idDef->fsaa = "0";
+        idDef->depthBufferId = Ogre::DepthBuffer::POOL_NO_DEPTH;
+
+        Ogre::RenderTargetViewEntry idAttachment;
+        idAttachment.textureName = "rt_id";
+        rtvDef->colourAttachments.push_back(idAttachment);
       }
     }
 
@@ -184,25 +501,75 @@ void Ogre2RenderTarget::BuildCompositor()
     Ogre::CompositorTargetDef *rt0TargetDef =
         nodeDef->addTargetPass("rtv");
 
-    if (validBackground)
-      rt0TargetDef->setNumPasses(3);
-    else
-      rt0TargetDef->setNumPasses(2);
+    // Render each view into its own viewport of the same target. All views
+    // share this workspace, and views after the first one only clear their
+    // shadow maps if they can't reuse the ones of the first view.
+    const std::vector<Ogre::Camera *> &viewCameras =
+        this->dataPtr->viewCameras;
+    const size_t viewCount = std::max<size_t>(1u, viewCameras.size());
+    const size_t columns = this->dataPtr->viewColumns == 0u ? viewCount :
+        std::min<size_t>(viewCount, this->dataPtr->viewColumns);
+    const size_t rows = (viewCount + columns - 1u) / columns;
+    const float viewWidth = 1.0f / static_cast<float>(columns);
+    const float viewHeight = 1.0f / static_cast<float>(rows);
+
+    rt0TargetDef->setNumPasses(
+        static_cast<uint32_t>((validBackground ? 3u : 2u) * viewCount));
+    for (size_t v = 0u; v < viewCount; ++v)
     {
+      // configure a pass to render view v
+      auto setView = [&](Ogre::CompositorPassDef *_passDef)
+      {
+        if (viewCameras.empty())
+          return;
+        _passDef->mVpRect[0].mVpLeft =
+            viewWidth * static_cast<float>(v % columns);
+        _passDef->mVpRect[0].mVpTop =
+            viewHeight * static_cast<float>(v / columns);
+        _passDef->mVpRect[0].mVpWidth = viewWidth;
+        _passDef->mVpRect[0].mVpHeight = viewHeight;
+        _passDef->mVpRect[0].mVpScissorLeft = _passDef->mVpRect[0].mVpLeft;
+        _passDef->mVpRect[0].mVpScissorTop = _passDef->mVpRect[0].mVpTop;
+        _passDef->mVpRect[0].mVpScissorWidth = viewWidth;
+        _passDef->mVpRect[0].mVpScissorHeight = viewHeight;
+        // keep the views rendered before this one
+        if (v > 0u)
+          _passDef->setAllLoadActions(Ogre::LoadAction::Load);
+      };
+      Ogre::IdString cameraName;
+      if (!viewCameras.empty())
+        cameraName = viewCameras[v]->getName();
+
       // scene pass - opaque
       {
         Ogre::CompositorPassSceneDef *passScene =
             static_cast<Ogre::CompositorPassSceneDef *>(
             rt0TargetDef->addPass(Ogre::PASS_SCENE));
-        passScene->mShadowNode = this->dataPtr->kShadowNodeName;
+        if (this->dataPtr->shadowsEnabled)
+          passScene->mShadowNode = this->dataPtr->kShadowNodeName;
         passScene->mIncludeOverlays = false;
         passScene->mFirstRQ = 0u;
         passScene->mLastRQ = 2u;
+        passScene->mCameraName = cameraName;
         if (!validBackground)
         {
           passScene->setAllLoadActions(Ogre::LoadAction::Clear);
           passScene->setAllClearColours(this->ogreBackgroundColor);
         }
+        // object id 0 is the background
+        if (objectIds)
+        {
+          passScene->mLoadActionColour[1] = Ogre::LoadAction::Clear;
+          passScene->mClearColour[1] = Ogre::ColourValue::ZERO;
+          passScene->mIdentifier = kObjectIdPassIdentifier;
+        }
+        if (v > 0u)
+        {
+          passScene->mShadowNodeRecalculation =
+              this->dataPtr->shareViewShadows ?
+              Ogre::SHADOW_NODE_REUSE : Ogre::SHADOW_NODE_RECALCULATE;
+        }
+        setView(passScene);
       }
 
       // render background, e.g. sky, after opaque stuff
@@ -212,13 +579,17 @@ void Ogre2RenderTarget::BuildCompositor()
         Ogre::CompositorPassQuadDef *passQuad =
             static_cast<Ogre::CompositorPassQuadDef *>(
             rt0TargetDef->addPass(Ogre::PASS_QUAD));
-        passQuad->mMaterialName = this->dataPtr->kSkyboxMaterialName + "_"
-            + this->Name();
+        passQuad->mMaterialName = this->SkyboxMaterialName();
         passQuad->mFrustumCorners =
             Ogre::CompositorPassQuadDef::CAMERA_DIRECTION;
+        passQuad->mCameraName = cameraName;
 
         passQuad->setAllLoadActions(Ogre::LoadAction::Clear);
         passQuad->setAllClearColours(this->ogreBackgroundColor);
+        // keep the object ids of the opaque pass
+        if (objectIds)
+          passQuad->mLoadActionColour[1] = Ogre::LoadAction::Load;
+        setView(passQuad);
       }
 
       // scene pass - transparent stuff
@@ -227,11 +598,31 @@ void Ogre2RenderTarget::BuildCompositor()
             static_cast<Ogre::CompositorPassSceneDef *>(
             rt0TargetDef->addPass(Ogre::PASS_SCENE));
         passScene->mIncludeOverlays = true;
-        passScene->mShadowNode = this->dataPtr->kShadowNodeName;
+        if (this->dataPtr->shadowsEnabled)
+          passScene->mShadowNode = this->dataPtr->kShadowNodeName;
         passScene->mFirstRQ = 2u;
+        passScene->mCameraName = cameraName;
+        if (objectIds)
+          passScene->mIdentifier = kObjectIdPassIdentifier;
+        if (v > 0u)
+          passScene->mShadowNodeRecalculation = Ogre::SHADOW_NODE_REUSE;
+        setView(passScene);
       }
     }
 
+    if (scaled)
+    {
+      Ogre::CompositorTargetDef *upscaleTargetDef =
+          nodeDef->addTargetPass("rt0");
+      upscaleTargetDef->setNumPasses(1);
+      Ogre::CompositorPassQuadDef *passQuad =
+          static_cast<Ogre::CompositorPassQuadDef *>(
+          upscaleTargetDef->addPass(Ogre::PASS_QUAD));
+      passQuad->mMaterialName = "ResolutionUpscale";
+      passQuad->addQuadTextureSource(0, "rt_scaled");
+      passQuad->setAllLoadActions(Ogre::LoadAction::DontCare);
+    }
+
     nodeDef->mapOutputChannel(0, "rt0");
     nodeDef->mapOutputChannel(1, "rt1");
 
@@ -257,147 +648,1135 @@ void Ogre2RenderTarget::BuildCompositor()
       passQuad->mMaterialName = "Ogre/Copy/4xFP32";
       passQuad->addQuadTextureSource(0, "rtN");
 
-      // scene pass
-      Ogre::CompositorPassSceneDef *passScene =
-          static_cast<Ogre::CompositorPassSceneDef *>(
-          outTargetDef->addPass(Ogre::PASS_SCENE));
-      passScene->mUpdateLodLists = false;
-      passScene->mIncludeOverlays = true;
-      passScene->mFirstRQ = 254;
-      passScene->mLastRQ = 255;
+      // scene pass
+      Ogre::CompositorPassSceneDef *passScene =
+          static_cast<Ogre::CompositorPassSceneDef *>(
+          outTargetDef->addPass(Ogre::PASS_SCENE));
+      passScene->mUpdateLodLists = false;
+      passScene->mIncludeOverlays = true;
+      passScene->mFirstRQ = 254;
+      passScene->mLastRQ = 255;
+
+    }
+    Ogre::CompositorWorkspaceDef *workDef =
+        ogreCompMgr->addWorkspaceDefinition(wsDefName);
+
+    workDef->connectExternal(0, nodeDefName, 0);
+    workDef->connectExternal(1, nodeDefName, 1);
+
+    if (!this->IsRenderWindow())
+    {
+      workDef->connect(nodeDefName, finalNodeDefName);
+      if (this->TargetFSAA() > 1u)
+        workDef->connectExternal(2, nodeDefName, 2);
+    }
+    else
+    {
+      // connect the last render pass to the final compositor node
+      // but only input, since output goes to the render window
+      workDef->connect(nodeDefName, 0, finalNodeDefName, 0);
+      workDef->connectExternal(2,  finalNodeDefName, 1);
+    }
+  }
+
+  Ogre::CompositorChannelVec externalTargets(2u);
+  for (size_t i = 0u; i < 2u; ++i)
+  {
+    // Connect them in reverse order
+    const size_t srcIdx = 2u - i - 1u;
+    externalTargets[i] = this->dataPtr->ogreTexture[srcIdx];
+  }
+
+  if (this->TargetFSAA() > 1u && !this->IsRenderWindow())
+  {
+    const double scale = this->dataPtr->resolutionScale;
+    this->dataPtr->fsaaTexture = engine->TransientTextures().Acquire(
+        static_cast<uint32_t>(std::ceil(this->width * scale)),
+        static_cast<uint32_t>(std::ceil(this->height * scale)),
+        Ogre::PFG_RGBA8_UNORM_SRGB, this->TargetFSAA());
+    externalTargets.push_back(this->dataPtr->fsaaTexture);
+  }
+
+  this->ogreCompositorWorkspace =
+      ogreCompMgr->addWorkspace(
+        this->scene->OgreSceneManager(),
+        externalTargets,
+        this->ogreCamera,
+        this->ogreCompositorWorkspaceDefName,
+        false);
+
+  this->dataPtr->staticShadowsRevision = 0u;
+
+  this->dataPtr->rtListener = new Ogre2RenderTargetCompositorListener(this);
+  this->ogreCompositorWorkspace->addListener(this->dataPtr->rtListener);
+  this->ogreCompositorWorkspace->addListener(engine->TerraWorkspaceListener());
+  for (auto listener : this->dataPtr->workspaceListeners)
+    this->ogreCompositorWorkspace->addListener(listener);
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::AddWorkspaceListener(
+    Ogre::CompositorWorkspaceListener *_listener)
+{
+  if (!_listener)
+    return;
+
+  if (this->ogreCompositorWorkspace)
+    this->ogreCompositorWorkspace->addListener(_listener);
+  this->dataPtr->workspaceListeners.push_back(_listener);
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::DestroyCompositor()
+{
+  if (!this->ogreCompositorWorkspace)
+    return;
+
+  // reprojection reads the depth texture of the workspace
+  this->DestroyReprojection();
+  this->DestroyObjectIds();
+  this->DestroyDepthQuery();
+
+  // Restore the original order so that this->ogreTexture[1] is the one with
+  // FSAA (which we need for BuildCompositor to connect correctly)
+  const Ogre::CompositorChannelVec &externalTargets =
+      this->ogreCompositorWorkspace->getExternalRenderTargets();
+  for (size_t i = 0u; i < 2u; ++i)
+  {
+    const size_t srcIdx = (2u - i - 1u);
+    this->dataPtr->ogreTexture[srcIdx] = externalTargets[i];
+  }
+
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+  this->ogreCompositorWorkspace->addListener(nullptr);
+  ogreCompMgr->removeWorkspace(this->ogreCompositorWorkspace);
+
+  if (this->dataPtr->fsaaTexture)
+  {
+    engine->TransientTextures().Release(this->dataPtr->fsaaTexture);
+    this->dataPtr->fsaaTexture = nullptr;
+  }
+
+  // only remove shared definitions once the last target releases them
+  bool removeDefinition = !this->dataPtr->sharedDefinition ||
+      engine->ReleaseWorkspaceDefinition(
+      this->ogreCompositorWorkspaceDefName);
+  if (removeDefinition &&
+      ogreCompMgr->hasWorkspaceDefinition(this->ogreCompositorWorkspaceDefName))
+  {
+    ogreCompMgr->removeWorkspaceDefinition(
+        this->ogreCompositorWorkspaceDefName);
+    ogreCompMgr->removeNodeDefinition(this->ogreCompositorWorkspaceDefName +
+        "/" + this->dataPtr->kBaseNodeName);
+    ogreCompMgr->removeNodeDefinition(this->ogreCompositorWorkspaceDefName +
+        "/" + this->dataPtr->kFinalNodeName);
+  }
+
+  this->ogreCompositorWorkspace = nullptr;
+  delete this->dataPtr->rtListener;
+  this->dataPtr->rtListener = nullptr;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::RebuildCompositor()
+{
+  this->DestroyCompositor();
+  this->BuildCompositor();
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::Copy(Image &_image) const
+{
+  IGN_PROFILE("Ogre2RenderTarget::Copy");
+  // TODO(anyone) handle Bayer conversions
+
+  if (_image.Width() != this->width || _image.Height() != this->height)
+  {
+    ignerr << "Invalid image dimensions" << std::endl;
+    return;
+  }
+
+  Ogre::TextureGpu *texture = this->RenderTarget();
+  Ogre::PixelFormatGpu dstOgrePf;
+  std::vector<uint8_t> padded;
+  Ogre::TextureBox dstBox = this->ImageBox(_image, dstOgrePf, padded);
+
+  Ogre::Image2::copyContentsToMemory(texture, texture->getEmptyBox(0u), dstBox,
+                                     dstOgrePf);
+  if (!padded.empty())
+    RemovePadding(padded, dstBox.bytesPerPixel, _image);
+}
+
+//////////////////////////////////////////////////
+bool Ogre2RenderTarget::CopyAsync(Image &_image,
+    std::function<void()> _callback)
+{
+  if (_image.Width() != this->width || _image.Height() != this->height)
+  {
+    ignerr << "Invalid image dimensions" << std::endl;
+    return false;
+  }
+
+  Ogre::TextureGpu *texture = this->RenderTarget();
+  if (!texture)
+  {
+    ignerr << "Render target has not been built" << std::endl;
+    return false;
+  }
+
+  // write the copies that are done, and wait for the oldest ones if too
+  // many are queued
+  this->UpdateAsyncCopies(this->dataPtr->kMaxAsyncCopies - 1u);
+
+  Ogre2RenderTargetPrivate::AsyncCopy copy;
+  if (!this->dataPtr->freeTickets.empty())
+  {
+    copy.ticket = this->dataPtr->freeTickets.back();
+    this->dataPtr->freeTickets.pop_back();
+  }
+  else
+  {
+    Ogre::TextureGpuManager *textureMgr = Ogre2RenderEngine::Instance()->
+        OgreRoot()->getRenderSystem()->getTextureGpuManager();
+    copy.ticket = textureMgr->createAsyncTextureTicket(
+        texture->getWidth(), texture->getHeight(), 1u,
+        texture->getTextureType(),
+        Ogre::PixelFormatGpuUtils::getFamily(texture->getPixelFormat()));
+  }
+  copy.ticket->download(texture, 0u, true);
+  copy.image = &_image;
+  copy.callback = std::move(_callback);
+  this->dataPtr->asyncCopies.push_back(std::move(copy));
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::WaitForAsyncCopies()
+{
+  this->UpdateAsyncCopies(0u);
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::UpdateAsyncCopies(size_t _maxQueued)
+{
+  while (!this->dataPtr->asyncCopies.empty())
+  {
+    Ogre2RenderTargetPrivate::AsyncCopy &front =
+        this->dataPtr->asyncCopies.front();
+
+    // mapping blocks until the download is complete
+    if (this->dataPtr->asyncCopies.size() <= _maxQueued &&
+        !front.ticket->queryIsTransferDone())
+    {
+      break;
+    }
+
+    Ogre2RenderTargetPrivate::AsyncCopy copy = std::move(front);
+    this->dataPtr->asyncCopies.pop_front();
+
+    Ogre::PixelFormatGpu dstOgrePf;
+    std::vector<uint8_t> padded;
+    Ogre::TextureBox dstBox =
+        this->ImageBox(*copy.image, dstOgrePf, padded);
+    const Ogre::TextureBox srcBox = copy.ticket->map(0u);
+    Ogre::PixelFormatGpuUtils::bulkPixelConversion(
+        srcBox, copy.ticket->getPixelFormatFamily(), dstBox,
+        Ogre::PixelFormatGpuUtils::getFamily(dstOgrePf));
+    copy.ticket->unmap();
+    if (!padded.empty())
+      RemovePadding(padded, dstBox.bytesPerPixel, *copy.image);
+    this->dataPtr->freeTickets.push_back(copy.ticket);
+
+    // called last, it may queue new copies
+    if (copy.callback)
+      copy.callback();
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::DestroyAsyncCopies()
+{
+  this->UpdateAsyncCopies(0u);
+
+  if (this->dataPtr->freeTickets.empty())
+    return;
+
+  Ogre::TextureGpuManager *textureMgr = Ogre2RenderEngine::Instance()->
+      OgreRoot()->getRenderSystem()->getTextureGpuManager();
+  for (auto ticket : this->dataPtr->freeTickets)
+    textureMgr->destroyAsyncTextureTicket(ticket);
+  this->dataPtr->freeTickets.clear();
+}
+
+//////////////////////////////////////////////////
+bool Ogre2RenderTarget::CopyI420(Image &_image)
+{
+  IGN_PROFILE("Ogre2RenderTarget::CopyI420");
+  if (_image.Format() != PF_L8 || _image.Width() != this->width ||
+      _image.Height() != this->height * 3u / 2u)
+  {
+    ignerr << "Invalid I420 image dimensions or format" << std::endl;
+    return false;
+  }
+
+  if (!this->ConvertToI420())
+    return false;
+
+  Ogre::TextureGpu *texture = this->dataPtr->i420Texture;
+  Ogre::TextureBox dstBox(texture->getWidth(), texture->getHeight(), 1u, 1u,
+      1u, _image.RowPitch(), _image.RowPitch() * texture->getHeight());
+  dstBox.data = _image.Data();
+  Ogre::Image2::copyContentsToMemory(texture, texture->getEmptyBox(0u), dstBox,
+                                     Ogre::PFG_R8_UNORM);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2RenderTarget::ConvertToI420()
+{
+  Ogre::TextureGpu *input = this->RenderTarget();
+  if (!input)
+  {
+    ignerr << "Render target has not been built" << std::endl;
+    return false;
+  }
+
+  if (input->getWidth() % 2u != 0u || input->getHeight() % 2u != 0u)
+  {
+    ignerr << "I420 conversion requires an even render target width and "
+           << "height" << std::endl;
+    return false;
+  }
+
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+
+  // the render target texture changes when the target is rebuilt
+  if (this->dataPtr->i420Input != input)
+  {
+    this->DestroyI420();
+
+    Ogre::TextureGpuManager *textureMgr =
+        ogreRoot->getRenderSystem()->getTextureGpuManager();
+    this->dataPtr->i420Texture =
+        textureMgr->createTexture(
+          this->name + "_i420",
+          Ogre::GpuPageOutStrategy::Discard,
+          Ogre::TextureFlags::RenderToTexture,
+          Ogre::TextureTypes::Type2D);
+    this->dataPtr->i420Texture->setResolution(input->getWidth(),
+        input->getHeight() * 3u / 2u);
+    this->dataPtr->i420Texture->setNumMipmaps(1u);
+    this->dataPtr->i420Texture->setPixelFormat(Ogre::PFG_R8_UNORM);
+    this->dataPtr->i420Texture->scheduleTransitionTo(
+        Ogre::GpuResidency::Resident);
+
+    // The compositor workspace definition is equivalent to the following:
+    //
+    // compositor_node RgbToI420
+    // {
+    //   in 0 rt_input
+    //   in 1 rt_output
+    //
+    //   target rt_output
+    //   {
+    //     pass render_quad
+    //     {
+    //       material RgbToI420
+    //       input 0 rt_input
+    //     }
+    //   }
+    // }
+    std::string wsDefName = "RgbToI420Workspace_" + this->name;
+    this->dataPtr->i420WorkspaceDefName = wsDefName;
+    if (!ogreCompMgr->hasWorkspaceDefinition(wsDefName))
+    {
+      std::string nodeDefName = wsDefName + "/Node";
+      Ogre::CompositorNodeDef *nodeDef =
+          ogreCompMgr->addNodeDefinition(nodeDefName);
+      nodeDef->addTextureSourceName("rt_input", 0,
+          Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+      nodeDef->addTextureSourceName("rt_output", 1,
+          Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+
+      nodeDef->setNumTargetPass(1);
+      Ogre::CompositorTargetDef *targetDef =
+          nodeDef->addTargetPass("rt_output");
+      targetDef->setNumPasses(1);
+      {
+        Ogre::CompositorPassQuadDef *passQuad =
+            static_cast<Ogre::CompositorPassQuadDef *>(
+            targetDef->addPass(Ogre::PASS_QUAD));
+        passQuad->setAllLoadActions(Ogre::LoadAction::DontCare);
+        passQuad->mMaterialName =
+            Ogre::PixelFormatGpuUtils::isSRgb(input->getPixelFormat()) ?
+            "RgbToI420Srgb" : "RgbToI420";
+        passQuad->addQuadTextureSource(0, "rt_input");
+      }
+
+      Ogre::CompositorWorkspaceDef *workDef =
+          ogreCompMgr->addWorkspaceDefinition(wsDefName);
+      workDef->connectExternal(0, nodeDefName, 0);
+      workDef->connectExternal(1, nodeDefName, 1);
+    }
+
+    Ogre::CompositorChannelVec externalTargets(2u);
+    externalTargets[0] = input;
+    externalTargets[1] = this->dataPtr->i420Texture;
+    this->dataPtr->i420Workspace =
+        ogreCompMgr->addWorkspace(
+            this->scene->OgreSceneManager(),
+            externalTargets,
+            this->ogreCamera,
+            wsDefName,
+            false);
+    this->dataPtr->i420Input = input;
+  }
+
+  Ogre::CompositorWorkspace *workspace = this->dataPtr->i420Workspace;
+  workspace->_validateFinalTarget();
+  workspace->_beginUpdate(false);
+  workspace->_update();
+  workspace->_endUpdate(false);
+
+  Ogre::vector<Ogre::TextureGpu*>::type swappedTargets;
+  workspace->_swapFinalTarget(swappedTargets);
+
+  this->scene->FlushGpuCommandsAndStartNewFrame(1u, false);
+  return true;
+}
+
+//////////////////////////////////////////////////
+Ogre::TextureGpu *Ogre2RenderTarget::I420Texture() const
+{
+  return this->dataPtr->i420Texture;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::DestroyI420()
+{
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+
+  if (this->dataPtr->i420Workspace)
+  {
+    ogreCompMgr->removeWorkspace(this->dataPtr->i420Workspace);
+    this->dataPtr->i420Workspace = nullptr;
+  }
+
+  const std::string &wsDefName = this->dataPtr->i420WorkspaceDefName;
+  if (!wsDefName.empty() && ogreCompMgr->hasWorkspaceDefinition(wsDefName))
+  {
+    ogreCompMgr->removeWorkspaceDefinition(wsDefName);
+    ogreCompMgr->removeNodeDefinition(wsDefName + "/Node");
+  }
+  this->dataPtr->i420WorkspaceDefName.clear();
+
+  if (this->dataPtr->i420Texture)
+  {
+    ogreRoot->getRenderSystem()->getTextureGpuManager()->destroyTexture(
+        this->dataPtr->i420Texture);
+    this->dataPtr->i420Texture = nullptr;
+  }
+  this->dataPtr->i420Input = nullptr;
+}
+
+//////////////////////////////////////////////////
+Ogre::TextureBox Ogre2RenderTarget::ImageBox(Image &_image,
+    Ogre::PixelFormatGpu &_format, std::vector<uint8_t> &_padded) const
+{
+  Ogre::PixelFormatGpu dstOgrePf = Ogre2Conversions::Convert(_image.Format());
+  Ogre::TextureGpu *texture = this->RenderTarget();
+
+  if (Ogre::PixelFormatGpuUtils::isSRgb(dstOgrePf) !=
+      Ogre::PixelFormatGpuUtils::isSRgb(texture->getPixelFormat()))
+  {
+    // Formats are identical except for sRGB-ness.
+    // Force a raw copy by making them match (no conversion!).
+    // We can't change the TextureGpu format now, so we change dstOgrePf
+    if (Ogre::PixelFormatGpuUtils::isSRgb(texture->getPixelFormat()))
+      dstOgrePf = Ogre::PixelFormatGpuUtils::getEquivalentSRGB(dstOgrePf);
+    else
+      dstOgrePf = Ogre::PixelFormatGpuUtils::getEquivalentLinear(dstOgrePf);
+  }
+
+  // ogre has no 3 channel 16 bit formats, these are converted to a 4
+  // channel format in a separate buffer and the padding is dropped after
+  size_t bytesPerPixel =
+      Ogre::PixelFormatGpuUtils::getBytesPerPixel(dstOgrePf);
+  size_t rowPitch = _image.RowPitch();
+  void *data = _image.Data();
+  _padded.clear();
+  if (bytesPerPixel > PixelUtil::BytesPerPixel(_image.Format()))
+  {
+    rowPitch = texture->getWidth() * bytesPerPixel;
+    _padded.resize(rowPitch * texture->getHeight());
+    data = _padded.data();
+  }
+
+  Ogre::TextureBox dstBox(
+    texture->getWidth(), texture->getHeight(),
+    texture->getDepth(), texture->getNumSlices(),
+    static_cast<uint32_t>(bytesPerPixel),
+    rowPitch, rowPitch * texture->getHeight());
+  dstBox.data = data;
+
+  _format = dstOgrePf;
+  return dstBox;
+}
+
+//////////////////////////////////////////////////
+Ogre::Camera *Ogre2RenderTarget::Camera() const
+{
+  return this->ogreCamera;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::SetCamera(Ogre::Camera *_camera)
+{
+  this->ogreCamera = _camera;
+  this->targetDirty = true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::SetShadowsEnabled(bool _enabled)
+{
+  if (this->dataPtr->shadowsEnabled == _enabled)
+    return;
+
+  this->dataPtr->shadowsEnabled = _enabled;
+  this->DestroyCompositor();
+  this->targetDirty = true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::SetResolutionScale(double _scale)
+{
+  if (math::equal(this->dataPtr->resolutionScale, _scale))
+    return;
+
+  this->dataPtr->resolutionScale = _scale;
+  this->DestroyCompositor();
+  this->targetDirty = true;
+}
+
+//////////////////////////////////////////////////
+double Ogre2RenderTarget::ResolutionScale() const
+{
+  return this->dataPtr->resolutionScale;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::SetReprojectionEnabled(bool _enabled)
+{
+  if (this->dataPtr->reprojectionEnabled == _enabled)
+    return;
+
+  this->dataPtr->reprojectionEnabled = _enabled;
+
+  // the scene passes render depth to a texture of their own
+  this->DestroyCompositor();
+  this->targetDirty = true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2RenderTarget::CanReproject() const
+{
+  if (!this->dataPtr->reprojectionEnabled || !this->dataPtr->hasKeyFrame ||
+      !this->ogreCompositorWorkspace || this->IsRenderWindow() ||
+      !this->dataPtr->viewCameras.empty())
+  {
+    return false;
+  }
+
+  // the warp assumes a symmetric perspective frustum
+  if (!this->ogreCamera ||
+      this->ogreCamera->getProjectionType() != Ogre::PT_PERSPECTIVE ||
+      this->ogreCamera->isCustomProjectionMatrixEnabled())
+  {
+    return false;
+  }
+
+  // render passes, e.g. distortion, may move pixels around
+  for (const auto &pass : this->renderPasses)
+  {
+    if (pass->IsEnabled())
+      return false;
+  }
+
+  Ogre::TextureGpu *target = this->RenderTarget();
+  Ogre::TextureGpu *key = this->dataPtr->keyColorTexture;
+  return target && key && target->getWidth() == key->getWidth() &&
+      target->getHeight() == key->getHeight();
+}
+
+//////////////////////////////////////////////////
+bool Ogre2RenderTarget::Reproject()
+{
+  IGN_PROFILE("Ogre2RenderTarget::Reproject");
+  if (!this->CanReproject())
+    return false;
+
+  Ogre::TextureGpu *depth = this->DepthTexture();
+  if (!depth)
+    return false;
+
+  this->UpdateAsyncCopies(this->dataPtr->kMaxAsyncCopies);
+
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+  Ogre::TextureGpu *output = this->RenderTarget();
+
+  // the depth texture changes when the workspace is rebuilt
+  if (this->dataPtr->reprojectionDepth != depth ||
+      this->dataPtr->reprojectionOutput != output)
+  {
+    if (this->dataPtr->reprojectionWorkspace)
+    {
+      ogreCompMgr->removeWorkspace(this->dataPtr->reprojectionWorkspace);
+      this->dataPtr->reprojectionWorkspace = nullptr;
+    }
+
+    // the uniforms differ per render target
+    if (!this->dataPtr->reprojectionMaterial)
+    {
+      std::string baseName =
+          this->TargetFSAA() > 1u ? "ReprojectionMsaa" : "Reprojection";
+      Ogre::MaterialPtr baseMaterial =
+          Ogre::MaterialManager::getSingleton().getByName(baseName);
+      this->dataPtr->reprojectionMaterial =
+          baseMaterial->clone(this->name + "_" + baseName);
+      this->dataPtr->reprojectionMaterial->load();
+    }
+
+    // The compositor workspace definition is equivalent to the following:
+    //
+    // compositor_node Reprojection
+    // {
+    //   in 0 rt_key
+    //   in 1 rt_key_depth
+    //   in 2 rt_output
+    //
+    //   target rt_output
+    //   {
+    //     pass render_quad
+    //     {
+    //       material Reprojection
+    //       input 0 rt_key
+    //       input 1 rt_key_depth
+    //     }
+    //   }
+    // }
+    std::string wsDefName = "ReprojectionWorkspace_" + this->name;
+    this->dataPtr->reprojectionWorkspaceDefName = wsDefName;
+    if (!ogreCompMgr->hasWorkspaceDefinition(wsDefName))
+    {
+      std::string nodeDefName = wsDefName + "/Node";
+      Ogre::CompositorNodeDef *nodeDef =
+          ogreCompMgr->addNodeDefinition(nodeDefName);
+      nodeDef->addTextureSourceName("rt_key", 0,
+          Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+      nodeDef->addTextureSourceName("rt_key_depth", 1,
+          Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+      nodeDef->addTextureSourceName("rt_output", 2,
+          Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+
+      nodeDef->setNumTargetPass(1);
+      Ogre::CompositorTargetDef *targetDef =
+          nodeDef->addTargetPass("rt_output");
+      targetDef->setNumPasses(1);
+      {
+        Ogre::CompositorPassQuadDef *passQuad =
+            static_cast<Ogre::CompositorPassQuadDef *>(
+            targetDef->addPass(Ogre::PASS_QUAD));
+        passQuad->setAllLoadActions(Ogre::LoadAction::DontCare);
+        passQuad->mMaterialName =
+            this->dataPtr->reprojectionMaterial->getName();
+        passQuad->addQuadTextureSource(0, "rt_key");
+        passQuad->addQuadTextureSource(1, "rt_key_depth");
+      }
+
+      Ogre::CompositorWorkspaceDef *workDef =
+          ogreCompMgr->addWorkspaceDefinition(wsDefName);
+      workDef->connectExternal(0, nodeDefName, 0);
+      workDef->connectExternal(1, nodeDefName, 1);
+      workDef->connectExternal(2, nodeDefName, 2);
+    }
+
+    Ogre::CompositorChannelVec externalTargets(3u);
+    externalTargets[0] = this->dataPtr->keyColorTexture;
+    externalTargets[1] = depth;
+    externalTargets[2] = output;
+    this->dataPtr->reprojectionWorkspace =
+        ogreCompMgr->addWorkspace(
+            this->scene->OgreSceneManager(),
+            externalTargets,
+            this->ogreCamera,
+            wsDefName,
+            false);
+    this->dataPtr->reprojectionDepth = depth;
+    this->dataPtr->reprojectionOutput = output;
+  }
+
+  // transform from the view space of the last rendered frame to the
+  // current one
+  Ogre::Matrix4 keyToCurrent = this->ogreCamera->getViewMatrix(true) *
+      this->dataPtr->keyViewMatrix.inverseAffine();
+  Ogre::Real tanHalfFovY =
+      Ogre::Math::Tan(this->ogreCamera->getFOVy() * 0.5f);
+
+  Ogre::Pass *pass =
+      this->dataPtr->reprojectionMaterial->getTechnique(0)->getPass(0);
+  Ogre::GpuProgramParametersSharedPtr psParams =
+      pass->getFragmentProgramParameters();
+  for (size_t i = 0u; i < 3u; ++i)
+  {
+    psParams->setNamedConstant("keyToCurrentRow" + std::to_string(i),
+        Ogre::Vector4(keyToCurrent[i][0], keyToCurrent[i][1],
+        keyToCurrent[i][2], keyToCurrent[i][3]));
+  }
+  psParams->setNamedConstant("keyTanHalfFov", this->dataPtr->keyTanHalfFov);
+  psParams->setNamedConstant("tanHalfFov", Ogre::Vector2(
+      tanHalfFovY * this->ogreCamera->getAspectRatio(), tanHalfFovY));
+  psParams->setNamedConstant("projectionParams",
+      this->dataPtr->keyProjectionParams);
+
+  Ogre::CompositorWorkspace *workspace = this->dataPtr->reprojectionWorkspace;
+  workspace->_validateFinalTarget();
+  workspace->_beginUpdate(false);
+  workspace->_update();
+  workspace->_endUpdate(false);
+
+  Ogre::vector<Ogre::TextureGpu*>::type swappedTargets;
+  workspace->_swapFinalTarget(swappedTargets);
+
+  this->scene->FlushGpuCommandsAndStartNewFrame(1u, false);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::SaveKeyFrame()
+{
+  Ogre::TextureGpu *target = this->RenderTarget();
+  Ogre::TextureGpu *key = this->dataPtr->keyColorTexture;
+  if (key && (key->getWidth() != target->getWidth() ||
+      key->getHeight() != target->getHeight() ||
+      key->getPixelFormat() != target->getPixelFormat()))
+  {
+    this->DestroyReprojection();
+    key = nullptr;
+  }
+
+  if (!key)
+  {
+    Ogre::TextureGpuManager *textureMgr = Ogre2RenderEngine::Instance()->
+        OgreRoot()->getRenderSystem()->getTextureGpuManager();
+    key = textureMgr->createTexture(
+        this->name + "_key",
+        Ogre::GpuPageOutStrategy::Discard,
+        Ogre::TextureFlags::RenderToTexture,
+        Ogre::TextureTypes::Type2D);
+    key->setResolution(target->getWidth(), target->getHeight());
+    key->setNumMipmaps(1u);
+    key->setPixelFormat(target->getPixelFormat());
+    key->scheduleTransitionTo(Ogre::GpuResidency::Resident);
+    this->dataPtr->keyColorTexture = key;
+  }
+
+  target->copyTo(key, key->getEmptyBox(0u), 0u, target->getEmptyBox(0u), 0u);
+
+  Ogre::Real tanHalfFovY =
+      Ogre::Math::Tan(this->ogreCamera->getFOVy() * 0.5f);
+  this->dataPtr->keyViewMatrix = this->ogreCamera->getViewMatrix(true);
+  this->dataPtr->keyProjectionParams =
+      this->ogreCamera->getProjectionParamsAB();
+  this->dataPtr->keyTanHalfFov = Ogre::Vector2(
+      tanHalfFovY * this->ogreCamera->getAspectRatio(), tanHalfFovY);
+  this->dataPtr->hasKeyFrame = true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::DestroyReprojection()
+{
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+
+  if (this->dataPtr->reprojectionWorkspace)
+  {
+    ogreCompMgr->removeWorkspace(this->dataPtr->reprojectionWorkspace);
+    this->dataPtr->reprojectionWorkspace = nullptr;
+  }
+
+  const std::string &wsDefName = this->dataPtr->reprojectionWorkspaceDefName;
+  if (!wsDefName.empty() && ogreCompMgr->hasWorkspaceDefinition(wsDefName))
+  {
+    ogreCompMgr->removeWorkspaceDefinition(wsDefName);
+    ogreCompMgr->removeNodeDefinition(wsDefName + "/Node");
+  }
+  this->dataPtr->reprojectionWorkspaceDefName.clear();
+
+  if (this->dataPtr->reprojectionMaterial)
+  {
+    Ogre::MaterialManager::getSingleton().remove(
+        this->dataPtr->reprojectionMaterial->getName());
+    this->dataPtr->reprojectionMaterial.reset();
+  }
+
+  if (this->dataPtr->keyColorTexture)
+  {
+    ogreRoot->getRenderSystem()->getTextureGpuManager()->destroyTexture(
+        this->dataPtr->keyColorTexture);
+    this->dataPtr->keyColorTexture = nullptr;
+  }
+  this->dataPtr->reprojectionDepth = nullptr;
+  this->dataPtr->reprojectionOutput = nullptr;
+  this->dataPtr->hasKeyFrame = false;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::SetObjectIdEnabled(bool _enabled)
+{
+  if (this->dataPtr->objectIdEnabled == _enabled)
+    return;
+
+  this->dataPtr->objectIdEnabled = _enabled;
 
-    }
-    Ogre::CompositorWorkspaceDef *workDef =
-        ogreCompMgr->addWorkspaceDefinition(wsDefName);
+  // the scene passes get a second color attachment
+  this->DestroyCompositor();
+  this->targetDirty = true;
+}
 
-    workDef->connectExternal(0, nodeDefName, 0);
-    workDef->connectExternal(1, nodeDefName, 1);
+//////////////////////////////////////////////////
+Ogre::TextureGpu *Ogre2RenderTarget::ObjectIdTexture() const
+{
+  if (!this->ogreCompositorWorkspace)
+    return nullptr;
 
-    if (!this->IsRenderWindow())
-    {
-      workDef->connect(nodeDefName, finalNodeDefName);
-    }
-    else
-    {
-      // connect the last render pass to the final compositor node
-      // but only input, since output goes to the render window
-      workDef->connect(nodeDefName, 0, finalNodeDefName, 0);
-      workDef->connectExternal(2,  finalNodeDefName, 1);
-    }
-  }
+  Ogre::CompositorNode *node =
+      this->ogreCompositorWorkspace->findNodeNoThrow(
+      this->ogreCompositorWorkspaceDefName + "/" +
+      this->dataPtr->kBaseNodeName);
+  return node ? node->getDefinedTexture("rt_id") : nullptr;
+}
 
-  Ogre::CompositorChannelVec externalTargets(2u);
-  for (size_t i = 0u; i < 2u; ++i)
+//////////////////////////////////////////////////
+bool Ogre2RenderTarget::ObjectIdAt(int _x, int _y, uint32_t &_objectId)
+{
+  if (!this->dataPtr->objectIdEnabled || !this->dataPtr->hasObjectIds)
+    return false;
+
+  Ogre::TextureGpu *ids = this->ObjectIdTexture();
+  if (!ids || _x < 0 || _y < 0 || _x >= static_cast<int>(this->width) ||
+      _y >= static_cast<int>(this->height))
   {
-    // Connect them in reverse order
-    const size_t srcIdx = 2u - i - 1u;
-    externalTargets[i] = this->dataPtr->ogreTexture[srcIdx];
+    return false;
   }
 
-  this->ogreCompositorWorkspace =
-      ogreCompMgr->addWorkspace(
-        this->scene->OgreSceneManager(),
-        externalTargets,
-        this->ogreCamera,
-        this->ogreCompositorWorkspaceDefName,
-        false);
+  // the ids are rendered at the resolution of the scene passes
+  const uint32_t x = static_cast<uint32_t>(_x) * ids->getWidth() /
+      this->width;
+  const uint32_t y = static_cast<uint32_t>(_y) * ids->getHeight() /
+      this->height;
+  this->dataPtr->objectIdCenter[0] = static_cast<int>(x);
+  this->dataPtr->objectIdCenter[1] = static_cast<int>(y);
+
+  Ogre::AsyncTextureTicket *ticket = this->dataPtr->objectIdTicket;
+  const uint32_t *region = this->dataPtr->objectIdRegion;
+  if (!this->dataPtr->objectIdsDownloaded || x < region[0] || y < region[1] ||
+      x >= region[0] + ticket->getWidth() ||
+      y >= region[1] + ticket->getHeight())
+  {
+    // the pixel is outside of the region downloaded after the last frame,
+    // download the region around it now, which waits for the GPU
+    this->DownloadObjectIds();
+    if (!this->dataPtr->objectIdsDownloaded)
+      return false;
+    ticket = this->dataPtr->objectIdTicket;
+  }
 
-  this->dataPtr->rtListener = new Ogre2RenderTargetCompositorListener(this);
-  this->ogreCompositorWorkspace->addListener(this->dataPtr->rtListener);
-  this->ogreCompositorWorkspace->addListener(engine->TerraWorkspaceListener());
+  Ogre::TextureBox box = ticket->map(0u);
+  const uint8_t *row = static_cast<const uint8_t *>(box.data) +
+      (y - region[1]) * box.bytesPerRow;
+  std::memcpy(&_objectId, row + (x - region[0]) * sizeof(uint32_t),
+      sizeof(uint32_t));
+  ticket->unmap();
+  return true;
 }
 
 //////////////////////////////////////////////////
-void Ogre2RenderTarget::DestroyCompositor()
+void Ogre2RenderTarget::DownloadObjectIds()
 {
-  if (!this->ogreCompositorWorkspace)
+  this->dataPtr->objectIdsDownloaded = false;
+
+  // nothing to download until the first pick
+  const int *center = this->dataPtr->objectIdCenter;
+  if (!this->dataPtr->hasObjectIds || center[0] < 0)
     return;
 
-  // Restore the original order so that this->ogreTexture[1] is the one with
-  // FSAA (which we need for BuildCompositor to connect correctly)
-  const Ogre::CompositorChannelVec &externalTargets =
-      this->ogreCompositorWorkspace->getExternalRenderTargets();
-  for (size_t i = 0u; i < 2u; ++i)
+  Ogre::TextureGpu *ids = this->ObjectIdTexture();
+  if (!ids)
+    return;
+
+  Ogre::TextureGpuManager *textureMgr = Ogre2RenderEngine::Instance()->
+      OgreRoot()->getRenderSystem()->getTextureGpuManager();
+  const uint32_t width =
+      std::min(this->dataPtr->kObjectIdRegionSize, ids->getWidth());
+  const uint32_t height =
+      std::min(this->dataPtr->kObjectIdRegionSize, ids->getHeight());
+  Ogre::AsyncTextureTicket *&ticket = this->dataPtr->objectIdTicket;
+  if (ticket && (ticket->getWidth() != width ||
+      ticket->getHeight() != height))
   {
-    const size_t srcIdx = (2u - i - 1u);
-    this->dataPtr->ogreTexture[srcIdx] = externalTargets[i];
+    textureMgr->destroyAsyncTextureTicket(ticket);
+    ticket = nullptr;
+  }
+  if (!ticket)
+  {
+    ticket = textureMgr->createAsyncTextureTicket(width, height, 1u,
+        Ogre::TextureTypes::Type2D, ids->getPixelFormat());
   }
 
-  auto engine = Ogre2RenderEngine::Instance();
-  auto ogreRoot = engine->OgreRoot();
-  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
-  this->ogreCompositorWorkspace->addListener(nullptr);
-  ogreCompMgr->removeWorkspace(this->ogreCompositorWorkspace);
-  ogreCompMgr->removeWorkspaceDefinition(this->ogreCompositorWorkspaceDefName);
-  ogreCompMgr->removeNodeDefinition(this->ogreCompositorWorkspaceDefName +
-      "/" + this->dataPtr->kBaseNodeName);
-  ogreCompMgr->removeNodeDefinition(this->ogreCompositorWorkspaceDefName +
-      "/" + this->dataPtr->kFinalNodeName);
+  // center the region on the last picked pixel, inside of the texture
+  uint32_t *region = this->dataPtr->objectIdRegion;
+  region[0] = static_cast<uint32_t>(std::max(0, std::min(
+      center[0] - static_cast<int>(width / 2u),
+      static_cast<int>(ids->getWidth() - width))));
+  region[1] = static_cast<uint32_t>(std::max(0, std::min(
+      center[1] - static_cast<int>(height / 2u),
+      static_cast<int>(ids->getHeight() - height))));
+
+  Ogre::TextureBox srcBox = ids->getEmptyBox(0u);
+  srcBox.x = region[0];
+  srcBox.y = region[1];
+  srcBox.width = width;
+  srcBox.height = height;
+  ticket->download(ids, 0u, false, &srcBox);
+  this->dataPtr->objectIdsDownloaded = true;
+}
 
-  this->ogreCompositorWorkspace = nullptr;
-  delete this->dataPtr->rtListener;
-  this->dataPtr->rtListener = nullptr;
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::DestroyObjectIds()
+{
+  if (this->dataPtr->objectIdTicket)
+  {
+    Ogre2RenderEngine::Instance()->OgreRoot()->getRenderSystem()->
+        getTextureGpuManager()->destroyAsyncTextureTicket(
+        this->dataPtr->objectIdTicket);
+    this->dataPtr->objectIdTicket = nullptr;
+  }
+  this->dataPtr->hasObjectIds = false;
+  this->dataPtr->objectIdsDownloaded = false;
 }
 
 //////////////////////////////////////////////////
-void Ogre2RenderTarget::RebuildCompositor()
+void Ogre2RenderTarget::SetDepthQueryEnabled(bool _enabled)
 {
+  if (this->dataPtr->depthQueryEnabled == _enabled)
+    return;
+
+  this->dataPtr->depthQueryEnabled = _enabled;
+
+  // the depth buffer of the scene passes becomes a texture of its own
   this->DestroyCompositor();
-  this->BuildCompositor();
+  this->targetDirty = true;
 }
 
 //////////////////////////////////////////////////
-void Ogre2RenderTarget::Copy(Image &_image) const
+Ogre::TextureGpu *Ogre2RenderTarget::DepthTexture() const
 {
-  // TODO(anyone) handle Bayer conversions
+  if (!this->ogreCompositorWorkspace)
+    return nullptr;
 
-  if (_image.Width() != this->width || _image.Height() != this->height)
+  Ogre::CompositorNode *node =
+      this->ogreCompositorWorkspace->findNodeNoThrow(
+      this->ogreCompositorWorkspaceDefName + "/" +
+      this->dataPtr->kBaseNodeName);
+  return node ? node->getDefinedTexture("rt_depth") : nullptr;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2RenderTarget::DepthAt(int _x, int _y, double &_depth)
+{
+  // multisampled depth can't be downloaded
+  if (!this->dataPtr->depthQueryEnabled || !this->dataPtr->hasDepth ||
+      this->TargetFSAA() > 1u)
   {
-    ignerr << "Invalid image dimensions" << std::endl;
-    return;
+    return false;
   }
 
-  Ogre::PixelFormatGpu dstOgrePf = Ogre2Conversions::Convert(_image.Format());
-  Ogre::TextureGpu *texture = this->RenderTarget();
+  Ogre::TextureGpu *depth = this->DepthTexture();
+  if (!depth || _x < 0 || _y < 0 || _x >= static_cast<int>(this->width) ||
+      _y >= static_cast<int>(this->height))
+  {
+    return false;
+  }
 
-  if (Ogre::PixelFormatGpuUtils::isSRgb(dstOgrePf) !=
-      Ogre::PixelFormatGpuUtils::isSRgb(texture->getPixelFormat()))
+  Ogre::TextureGpuManager *textureMgr = Ogre2RenderEngine::Instance()->
+      OgreRoot()->getRenderSystem()->getTextureGpuManager();
+  Ogre::AsyncTextureTicket *&ticket = this->dataPtr->depthTicket;
+  if (!ticket)
   {
-    // Formats are identical except for sRGB-ness.
-    // Force a raw copy by making them match (no conversion!).
-    // We can't change the TextureGpu format now, so we change dstOgrePf
-    if (Ogre::PixelFormatGpuUtils::isSRgb(texture->getPixelFormat()))
-      dstOgrePf = Ogre::PixelFormatGpuUtils::getEquivalentSRGB(dstOgrePf);
+    ticket = textureMgr->createAsyncTextureTicket(1u, 1u, 1u,
+        Ogre::TextureTypes::Type2D, depth->getPixelFormat());
+  }
+
+  // the depth is rendered at the resolution of the scene passes
+  Ogre::TextureBox srcBox = depth->getEmptyBox(0u);
+  srcBox.x = static_cast<uint32_t>(_x) * depth->getWidth() / this->width;
+  srcBox.y = static_cast<uint32_t>(_y) * depth->getHeight() / this->height;
+  srcBox.width = 1u;
+  srcBox.height = 1u;
+  ticket->download(depth, 0u, false, &srcBox);
+
+  float fDepth = 1.0f;
+  Ogre::TextureBox box = ticket->map(0u);
+  std::memcpy(&fDepth, box.data, sizeof(float));
+  ticket->unmap();
+
+  // nothing was rendered at the pixel
+  if (fDepth >= 1.0f)
+  {
+    _depth = math::INF_D;
+    return true;
+  }
+
+  const Ogre::Vector2 &params = this->dataPtr->depthProjectionParams;
+  _depth = params.y / (fDepth - params.x);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2RenderTarget::CopyDepth(float *_depth)
+{
+  if (!_depth || !this->dataPtr->depthQueryEnabled ||
+      !this->dataPtr->hasDepth || this->TargetFSAA() > 1u)
+  {
+    return false;
+  }
+
+  if (!this->DownloadTexels(this->DepthTexture(), _depth))
+    return false;
+
+  const Ogre::Vector2 &params = this->dataPtr->depthProjectionParams;
+  const unsigned int count = this->width * this->height;
+  for (unsigned int i = 0u; i < count; ++i)
+  {
+    // nothing was rendered at the pixel
+    if (_depth[i] >= 1.0f)
+      _depth[i] = math::INF_F;
     else
-      dstOgrePf = Ogre::PixelFormatGpuUtils::getEquivalentLinear(dstOgrePf);
+      _depth[i] = params.y / (_depth[i] - params.x);
   }
+  return true;
+}
 
-  Ogre::TextureBox dstBox(
-    texture->getWidth(), texture->getHeight(),
-    texture->getDepth(), texture->getNumSlices(),
-    static_cast<uint32_t>(
-      Ogre::PixelFormatGpuUtils::getBytesPerPixel(dstOgrePf)),
-    static_cast<uint32_t>(Ogre::PixelFormatGpuUtils::getSizeBytes(
-      texture->getWidth(), 1u, 1u, 1u, dstOgrePf, 1u)),
-    static_cast<uint32_t>(Ogre::PixelFormatGpuUtils::getSizeBytes(
-      texture->getWidth(), texture->getHeight(), 1u, 1u,
-      dstOgrePf, 1u)));
-  dstBox.data = _image.Data();
+//////////////////////////////////////////////////
+bool Ogre2RenderTarget::CopyObjectIds(uint32_t *_objectIds)
+{
+  if (!_objectIds || !this->dataPtr->objectIdEnabled ||
+      !this->dataPtr->hasObjectIds)
+  {
+    return false;
+  }
 
-  Ogre::Image2::copyContentsToMemory(texture, texture->getEmptyBox(0u), dstBox,
-                                     dstOgrePf);
+  return this->DownloadTexels(this->ObjectIdTexture(), _objectIds);
 }
 
 //////////////////////////////////////////////////
-Ogre::Camera *Ogre2RenderTarget::Camera() const
+Ogre::TextureGpu *Ogre2RenderTarget::DepthTextureFor(
+    const Ogre::Camera *_camera) const
 {
-  return this->ogreCamera;
+  if (!_camera || !this->dataPtr->depthQueryEnabled ||
+      !this->dataPtr->hasDepth || this->TargetFSAA() > 1u ||
+      this->dataPtr->resolutionScale < 1.0)
+  {
+    return nullptr;
+  }
+
+  // the scene may have changed since the frame was rendered
+  if (this->dataPtr->depthTime != this->scene->Time())
+    return nullptr;
+
+  const Ogre::Matrix4 viewProj =
+      _camera->getProjectionMatrix() * _camera->getViewMatrix(true);
+  for (size_t i = 0u; i < 16u; ++i)
+  {
+    const Ogre::Real a = viewProj[i / 4u][i % 4u];
+    const Ogre::Real b = this->dataPtr->depthViewProj[i / 4u][i % 4u];
+    if (std::abs(a - b) > 1e-5f * std::max(Ogre::Real(1), std::abs(b)))
+      return nullptr;
+  }
+
+  return this->DepthTexture();
 }
 
 //////////////////////////////////////////////////
-void Ogre2RenderTarget::SetCamera(Ogre::Camera *_camera)
+bool Ogre2RenderTarget::DownloadTexels(Ogre::TextureGpu *_texture,
+    void *_data) const
 {
-  this->ogreCamera = _camera;
+  if (!_texture || Ogre::PixelFormatGpuUtils::getBytesPerPixel(
+      _texture->getPixelFormat()) != 4u)
+  {
+    return false;
+  }
+
+  Ogre::TextureGpuManager *textureMgr = Ogre2RenderEngine::Instance()->
+      OgreRoot()->getRenderSystem()->getTextureGpuManager();
+  Ogre::AsyncTextureTicket *ticket = textureMgr->createAsyncTextureTicket(
+      _texture->getWidth(), _texture->getHeight(), 1u,
+      Ogre::TextureTypes::Type2D, _texture->getPixelFormat());
+  ticket->download(_texture, 0u, false);
+
+  // the texture is rendered at the resolution of the scene passes, pick
+  // the nearest texel of each pixel of the render target
+  Ogre::TextureBox box = ticket->map(0u);
+  uint8_t *dst = static_cast<uint8_t *>(_data);
+  for (unsigned int y = 0u; y < this->height; ++y)
+  {
+    const uint8_t *row = static_cast<const uint8_t *>(box.data) +
+        (y * _texture->getHeight() / this->height) * box.bytesPerRow;
+    for (unsigned int x = 0u; x < this->width; ++x)
+    {
+      std::memcpy(dst, row + (x * _texture->getWidth() / this->width) * 4u,
+          4u);
+      dst += 4u;
+    }
+  }
+  ticket->unmap();
+  textureMgr->destroyAsyncTextureTicket(ticket);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::DestroyDepthQuery()
+{
+  if (this->dataPtr->depthTicket)
+  {
+    Ogre2RenderEngine::Instance()->OgreRoot()->getRenderSystem()->
+        getTextureGpuManager()->destroyAsyncTextureTicket(
+        this->dataPtr->depthTicket);
+    this->dataPtr->depthTicket = nullptr;
+  }
+  this->dataPtr->hasDepth = false;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::SetViewCameras(
+    const std::vector<Ogre::Camera *> &_cameras, bool _shareShadows,
+    unsigned int _columns)
+{
+  this->dataPtr->viewCameras = _cameras;
+  this->dataPtr->shareViewShadows = _shareShadows;
+  this->dataPtr->viewColumns = _columns;
+
+  // the scene passes of the workspace depend on the views
+  this->DestroyCompositor();
   this->targetDirty = true;
 }
 
@@ -446,6 +1825,7 @@ void Ogre2RenderTarget::PreRender()
 {
   BaseRenderTarget::PreRender();
   this->UpdateBackgroundColor();
+  this->UpdateSkyVisibility();
 
   if (this->material)
   {
@@ -464,7 +1844,12 @@ void Ogre2RenderTarget::PostRender()
 //////////////////////////////////////////////////
 void Ogre2RenderTarget::Render()
 {
+  IGN_PROFILE("Ogre2RenderTarget::Render");
+  this->UpdateAsyncCopies(this->dataPtr->kMaxAsyncCopies);
+
   this->scene->StartRendering(this->ogreCamera);
+  this->scene->UpdateStaticShadowMaps(this->ogreCompositorWorkspace,
+      this->dataPtr->staticShadowsRevision);
 
   this->ogreCompositorWorkspace->_validateFinalTarget();
   this->ogreCompositorWorkspace->_beginUpdate(false);
@@ -475,6 +1860,28 @@ void Ogre2RenderTarget::Render()
   swappedTargets.reserve(2u);
   this->ogreCompositorWorkspace->_swapFinalTarget(swappedTargets);
 
+  if (this->dataPtr->reprojectionEnabled)
+    this->SaveKeyFrame();
+
+  if (this->dataPtr->objectIdEnabled)
+  {
+    this->dataPtr->hasObjectIds = this->ObjectIdTexture() != nullptr;
+    this->DownloadObjectIds();
+  }
+
+  // DepthAt linearizes the depth with the projection of this frame
+  if (this->dataPtr->depthQueryEnabled)
+  {
+    this->dataPtr->hasDepth = this->DepthTexture() != nullptr &&
+        this->ogreCamera->getProjectionType() == Ogre::PT_PERSPECTIVE &&
+        !this->ogreCamera->isCustomProjectionMatrixEnabled();
+    this->dataPtr->depthProjectionParams =
+        this->ogreCamera->getProjectionParamsAB();
+    this->dataPtr->depthViewProj = this->ogreCamera->getProjectionMatrix() *
+        this->ogreCamera->getViewMatrix(true);
+    this->dataPtr->depthTime = this->scene->Time();
+  }
+
   this->scene->FlushGpuCommandsAndStartNewFrame(1u, false);
 }
 
@@ -491,6 +1898,9 @@ void Ogre2RenderTarget::DestroyTargetImpl()
     return;
 
   this->DestroyCompositor();
+  // staging buffers have the size and format of the textures
+  this->DestroyAsyncCopies();
+  this->DestroyI420();
 
   Ogre::Root *root = Ogre2RenderEngine::Instance()->OgreRoot();
 
@@ -539,11 +1949,41 @@ unsigned int Ogre2RenderTarget::GLIdImpl() const
   if (!this->dataPtr->ogreTexture[0])
     return 0;
 
-  unsigned int texId;
-  this->dataPtr->ogreTexture[1]->getCustomAttribute("msFinalTextureBuffer",
-                                                    &texId);
+  return TextureGLId(this->dataPtr->ogreTexture[1]);
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::MetalIdImpl(void *_textureIdPtr) const
+{
+  TextureMetalId(this->dataPtr->ogreTexture[1], _textureIdPtr);
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2RenderTarget::TextureGLId(Ogre::TextureGpu *_texture)
+{
+  if (!_texture || Ogre2RenderEngine::Instance()->GraphicsAPI() !=
+      rendering::GraphicsAPI::OPENGL)
+  {
+    return 0u;
+  }
+
+  unsigned int texId = 0u;
+  _texture->getCustomAttribute("msFinalTextureBuffer", &texId);
+  return texId;
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::TextureMetalId(Ogre::TextureGpu *_texture,
+    void *_textureIdPtr)
+{
+  if (!_texture || !_textureIdPtr ||
+      Ogre2RenderEngine::Instance()->GraphicsAPI() !=
+      rendering::GraphicsAPI::METAL)
+  {
+    return;
+  }
 
-  return static_cast<unsigned int>(texId);
+  _texture->getCustomAttribute("msFinalTextureBuffer", _textureIdPtr);
 }
 
 //////////////////////////////////////////////////
@@ -612,9 +2052,14 @@ void Ogre2RenderTarget::UpdateBackgroundColor()
     auto pass = nodeSeq[0]->_getPasses()[0];
     pass->getRenderPassDesc()->setClearColour(this->ogreBackgroundColor);
 
-    auto passDef = pass->getDefinition();
-    const_cast<Ogre::CompositorPassDef*>(passDef)->setAllClearColours(
-          this->ogreBackgroundColor);
+    // shared definitions keep the color they were created with, targets
+    // with a different color use another definition once they are rebuilt
+    if (!this->dataPtr->sharedDefinition)
+    {
+      auto passDef = pass->getDefinition();
+      const_cast<Ogre::CompositorPassDef*>(passDef)->setAllClearColours(
+            this->ogreBackgroundColor);
+    }
 
     this->colorDirty = false;
   }
@@ -632,8 +2077,7 @@ void Ogre2RenderTarget::UpdateBackgroundMaterial()
   if (validBackground)
   {
     Ogre::MaterialManager &matManager = Ogre::MaterialManager::getSingleton();
-    std::string skyMatName = this->dataPtr->kSkyboxMaterialName + "_"
-        + this->Name();
+    std::string skyMatName = this->SkyboxMaterialName();
     auto mat = matManager.getByName(skyMatName);
     if (!mat)
     {
@@ -655,9 +2099,88 @@ void Ogre2RenderTarget::UpdateBackgroundMaterial()
   this->backgroundMaterialDirty = false;
 }
 
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::UpdateSkyVisibility()
+{
+  bool culled = false;
+  if (this->ogreCamera && this->ogreCamera->getParentSceneNode() &&
+      this->scene->SkyHorizonCulling() &&
+      this->backgroundMaterial &&
+      !this->backgroundMaterial->EnvironmentMap().empty())
+  {
+    // the view rays span the cone of the four frustum edge directions, so
+    // the view is below the horizon if they all point downwards. The node
+    // transform is updated here since the camera may have moved this frame
+    Ogre::Quaternion orientation =
+        this->ogreCamera->getParentSceneNode()->_getDerivedOrientationUpdated()
+        * this->ogreCamera->getOrientation();
+    std::vector<Ogre::Vector3> directions;
+    if (this->ogreCamera->getProjectionType() == Ogre::PT_ORTHOGRAPHIC)
+    {
+      directions.push_back(Ogre::Vector3::NEGATIVE_UNIT_Z);
+    }
+    else
+    {
+      Ogre::Real left, right, top, bottom;
+      this->ogreCamera->getFrustumExtents(left, right, top, bottom);
+      Ogre::Real nearDist = this->ogreCamera->getNearClipDistance();
+      for (Ogre::Real x : {left, right})
+      {
+        for (Ogre::Real y : {top, bottom})
+          directions.push_back(Ogre::Vector3(x, y, -nearDist));
+      }
+    }
+
+    // small margin so that the horizon line itself is still drawn
+    const Ogre::Real kMargin = 0.01;
+    culled = true;
+    for (const auto &dir : directions)
+    {
+      Ogre::Vector3 worldDir = orientation * dir.normalisedCopy();
+      if (worldDir.z > -kMargin)
+      {
+        culled = false;
+        break;
+      }
+    }
+  }
+
+  if (culled == this->dataPtr->skyCulled)
+    return;
+
+  this->dataPtr->skyCulled = culled;
+  if (this->ogreCompositorWorkspace)
+    this->RebuildCompositor();
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2RenderTarget::SkyboxMaterialName() const
+{
+  // the sky material only depends on the environment map, so targets with
+  // the same one share it
+  return this->dataPtr->kSkyboxMaterialName + "_" +
+      this->backgroundMaterial->EnvironmentMap();
+}
+
 //////////////////////////////////////////////////
 void Ogre2RenderTarget::UpdateRenderPassChain()
 {
+  // the render pass chain modifies the workspace definition, move to a
+  // definition of our own before adding render passes
+  if (this->dataPtr->sharedDefinition && !this->renderPasses.empty() &&
+      this->ogreCompositorWorkspace)
+  {
+    this->RebuildCompositor();
+    this->renderPassDirty = true;
+  }
+
+  for (const auto &pass : this->renderPasses)
+  {
+    Ogre2RenderPass *ogre2RenderPass =
+        dynamic_cast<Ogre2RenderPass *>(pass.get());
+    ogre2RenderPass->SetCamera(this->ogreCamera);
+  }
+
   UpdateRenderPassChain(this->ogreCompositorWorkspace,
       this->ogreCompositorWorkspaceDefName,
       this->ogreCompositorWorkspaceDefName + "/" +
@@ -701,6 +2224,11 @@ void Ogre2RenderTarget::UpdateRenderPassChain(
           _workspace->findNodeNoThrow(
           ogre2RenderPass->OgreCompositorNodeDefinitionName());
 
+      // passes fused into a previous one have no node of their own, and
+      // their enabled state is checked when the fused node is rendered
+      if (ogre2RenderPass->IsFused())
+        continue;
+
       // check if we need to create all nodes or just update the connections.
       // if node does not exist then it means it either has not been added to
       // the chain yet or it was removed because it was disabled.
@@ -720,6 +2248,23 @@ void Ogre2RenderTarget::UpdateRenderPassChain(
   if (!_recreateNodes && !updateConnection)
     return;
 
+  // fusing passes changes which nodes exist, so reconnecting the existing
+  // nodes is not enough once any pass is fused
+  if (!_recreateNodes)
+  {
+    for (const auto &pass : _renderPasses)
+    {
+      Ogre2RenderPass *ogre2RenderPass =
+          dynamic_cast<Ogre2RenderPass *>(pass.get());
+      if (ogre2RenderPass->IsFused() ||
+          !ogre2RenderPass->FusedPasses().empty())
+      {
+        _recreateNodes = true;
+        break;
+      }
+    }
+  }
+
   auto engine = Ogre2RenderEngine::Instance();
   auto ogreRoot = engine->OgreRoot();
   Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
@@ -747,25 +2292,54 @@ void Ogre2RenderTarget::UpdateRenderPassChain(
   int numActiveNodes = 0;
 
   // chain the render passes by connecting all the ogre compositor nodes
-  // in between the base scene pass node and the final compositor node
+  // in between the base scene pass node and the final compositor node.
+  // Consecutive passes that the previous connected pass can apply as well
+  // are fused into it instead, which saves a full screen pass each.
+  std::shared_ptr<Ogre2RenderPass> fusingPass;
+  std::vector<std::weak_ptr<Ogre2RenderPass>> fusedPasses;
   for (const auto &pass : _renderPasses)
   {
-    Ogre2RenderPass *ogre2RenderPass =
-        dynamic_cast<Ogre2RenderPass *>(pass.get());
+    auto ogre2RenderPass = std::dynamic_pointer_cast<Ogre2RenderPass>(pass);
     ogre2RenderPass->CreateRenderPass();
-    inNodeDefName = ogre2RenderPass->OgreCompositorNodeDefinitionName();
+    ogre2RenderPass->SetFused(false);
     // only connect passes that are enabled
-    if (!inNodeDefName.empty() && ogre2RenderPass->IsEnabled())
+    inNodeDefName = ogre2RenderPass->OgreCompositorNodeDefinitionName();
+    if (inNodeDefName.empty() || !ogre2RenderPass->IsEnabled())
+    {
+      ogre2RenderPass->SetFusedPasses({});
+      continue;
+    }
+
+    // only fuse when the nodes are recreated, since the node of a fused
+    // pass must not exist in the workspace
+    if (_recreateNodes && fusingPass &&
+        fusingPass->CanFuse(*ogre2RenderPass))
     {
-      workspaceDef->connect(outNodeDefName, inNodeDefName);
-      outNodeDefName = inNodeDefName;
-      ++numActiveNodes;
+      ogre2RenderPass->SetFused(true);
+      ogre2RenderPass->SetFusedPasses({});
+      fusedPasses.push_back(ogre2RenderPass);
+      fusingPass->SetFusedPasses(fusedPasses);
+      continue;
     }
+
+    workspaceDef->connect(outNodeDefName, inNodeDefName);
+    outNodeDefName = inNodeDefName;
+    ++numActiveNodes;
+
+    fusingPass = ogre2RenderPass;
+    fusedPasses.clear();
+    fusingPass->SetFusedPasses(fusedPasses);
   }
 
   workspaceDef->connectExternal(0, _baseNode, 0);
   workspaceDef->connectExternal(1, _baseNode, 1);
 
+  // the shared multisampled texture of the scene passes, if any
+  const Ogre::CompositorNodeDef *baseNodeDef =
+      ogreCompMgr->getNodeDefinition(_baseNode);
+  if (!_isRenderWindow && baseNodeDef->getNumInputChannels() > 2u)
+    workspaceDef->connectExternal(2, _baseNode, 2);
+
   if (!_isRenderWindow)
   {
     // connect the last render pass to the final compositor node
@@ -892,6 +2466,12 @@ unsigned int Ogre2RenderTexture::GLId() const
   return Ogre2RenderTarget::GLIdImpl();
 }
 
+//////////////////////////////////////////////////
+void Ogre2RenderTexture::MetalId(void *_textureIdPtr) const
+{
+  Ogre2RenderTarget::MetalIdImpl(_textureIdPtr);
+}
+
 //////////////////////////////////////////////////
 void Ogre2RenderTexture::PreRender()
 {
@@ -15,11 +15,31 @@
  *
  */
 
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 #include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Profiler.hh>
 
 #include "ignition/rendering/RenderTypes.hh"
 #include "ignition/rendering/ogre2/Ogre2ArrowVisual.hh"
 #include "ignition/rendering/ogre2/Ogre2AxisVisual.hh"
+#include "ignition/rendering/ogre2/Ogre2BoundingBoxCamera.hh"
 #include "ignition/rendering/ogre2/Ogre2Camera.hh"
 #include "ignition/rendering/ogre2/Ogre2Capsule.hh"
 #include "ignition/rendering/ogre2/Ogre2COMVisual.hh"
@@ -30,6 +50,7 @@
 #include "ignition/rendering/ogre2/Ogre2Grid.hh"
 #include "ignition/rendering/ogre2/Ogre2Heightmap.hh"
 #include "ignition/rendering/ogre2/Ogre2InertiaVisual.hh"
+#include "ignition/rendering/ogre2/Ogre2InstancedVisual.hh"
 #include "ignition/rendering/ogre2/Ogre2JointVisual.hh"
 #include "ignition/rendering/ogre2/Ogre2Light.hh"
 #include "ignition/rendering/ogre2/Ogre2LightVisual.hh"
@@ -44,9 +65,11 @@
 #include "ignition/rendering/ogre2/Ogre2RenderTarget.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
+#include "ignition/rendering/ogre2/Ogre2Text.hh"
 #include "ignition/rendering/ogre2/Ogre2ThermalCamera.hh"
 #include "ignition/rendering/ogre2/Ogre2SegmentationCamera.hh"
 #include "ignition/rendering/ogre2/Ogre2Visual.hh"
+#include "ignition/rendering/ogre2/Ogre2WideAngleCamera.hh"
 #include "ignition/rendering/ogre2/Ogre2WireBox.hh"
 
 #ifdef _MSC_VER
@@ -54,12 +77,17 @@
 #endif
 #include <OgreMatrix4.h>
 #include <Compositor/OgreCompositorManager2.h>
+#include <Compositor/OgreCompositorWorkspace.h>
 #include <Compositor/Pass/PassClear/OgreCompositorPassClearDef.h>
 #include <Compositor/Pass/PassQuad/OgreCompositorPassQuadDef.h>
 #include <Compositor/Pass/PassScene/OgreCompositorPassSceneDef.h>
+#include <Hlms/Pbs/OgreHlmsPbsDatablock.h>
 #include <OgreDepthBuffer.h>
+#include <OgreForwardClustered.h>
 #include <OgreRoot.h>
 #include <OgreSceneManager.h>
+#include <OgreTextureGpuManager.h>
+#include <Vao/OgreVaoManager.h>
 #include <Overlay/OgreOverlayManager.h>
 #include <Overlay/OgreOverlaySystem.h>
 #if OGRE_VERSION_MAJOR == 2 && OGRE_VERSION_MINOR == 1
@@ -73,6 +101,11 @@
   #pragma warning(pop)
 #endif
 
+#include "Ogre2MarkerBatcher.hh"
+#include "Ogre2MemoryStats.hh"
+#include "Ogre2ObjectId.hh"
+#include "Ogre2WorkerPool.hh"
+
 /// \brief Private data for the Ogre2Scene class
 class ignition::rendering::Ogre2ScenePrivate
 {
@@ -82,6 +115,9 @@ class ignition::rendering::Ogre2ScenePrivate
   /// \brief Flag to indicate if sky is enabled or not
   public: bool skyEnabled = false;
 
+  /// \brief True if cameras looking below the horizon skip the sky
+  public: bool skyHorizonCulling = false;
+
   /// \brief Flag to alert the user its usage of PreRender/PostRender
   /// is incorrect
   public: bool frameUpdateStarted = false;
@@ -93,8 +129,202 @@ class ignition::rendering::Ogre2ScenePrivate
   /// \brief Flag to indicate if we should flush GPU very often (per camera)
   public: uint8_t cameraPassCountPerGpuFlush = 0u;
 
+  /// \brief True while RenderSensors is recording sensor workspaces.
+  /// GPU flushes are deferred until all sensors have been recorded
+  public: bool batchRendering = false;
+
+  /// \brief Incremented every time the label of a visual changes
+  public: uint64_t labelsRevision = 0u;
+
+  /// \brief Incremented every time the temperature of a visual changes
+  public: uint64_t temperaturesRevision = 0u;
+
+  /// \brief Incremented every time the laser retro value of a visual
+  /// changes
+  public: uint64_t laserRetrosRevision = 0u;
+
+  /// \brief Laser retro values shared by the gpu rays sensors
+  public: std::weak_ptr<Ogre2LaserRetroSources> laserRetroSources;
+
+  /// \brief Groups of gpu rays sensors sharing a cubemap, indexed by group
+  /// name
+  public: std::map<std::string, std::shared_ptr<Ogre2GpuRaysGroup>>
+      gpuRaysGroups;
+
+  /// \brief Batcher of the point and line markers, null if marker
+  /// batching is disabled
+  public: std::unique_ptr<Ogre2MarkerBatcher> markerBatcher;
+
+  /// \brief Segmentation label colors shared by the segmentation cameras,
+  /// one per set of camera settings
+  public: std::vector<std::weak_ptr<Ogre2SegmentationLabelColors>>
+      segmentationLabelColors;
+
+  /// \brief Heat sources shared by the thermal cameras
+  public: std::weak_ptr<Ogre2ThermalHeatSources> thermalHeatSources;
+
+  /// \brief Nodes whose bounding box changed since the visual index was
+  /// last updated. The value is true if the boxes of all the descendants
+  /// of the node changed too.
+  public: std::unordered_map<unsigned int, bool> visualIndexDirty;
+
+  /// \brief Items bucketed per visibility bit
+  public: std::array<std::vector<Ogre::Item *>, 32u> visibilityLayers;
+
+  /// \brief Items matching the masks queried since the layers were
+  /// built, key: visibility mask
+  public: std::unordered_map<uint32_t, std::vector<Ogre::Item *>>
+      maskedItems;
+
+  /// \brief True if the visibility layers need to be rebuilt
+  public: bool visibilityLayersDirty = true;
+
+  /// \brief Incremented every time the visibility layers are marked dirty
+  public: uint64_t visibilityLayersRevision = 0u;
+
+  /// \brief Sub items drawn with low level materials
+  public: std::vector<Ogre::SubItem *> lowLevelSubItems;
+
+  /// \brief True if the low level sub items need to be collected again
+  public: bool lowLevelSubItemsDirty = true;
+
+  /// \brief Visibility layers revision the low level sub items were
+  /// collected for
+  public: uint64_t lowLevelSubItemsRevision = 0u;
+
+  /// \brief Materials using each texture, key: texture name
+  public: std::unordered_map<std::string,
+      std::unordered_set<Ogre2Material *>> textureUsers;
+
+  /// \brief Ogre textures of the materials destroyed since the last cleanup
+  /// Key: texture name, value: ogre texture name
+  public: std::unordered_map<std::string, std::string> destroyedTextures;
+
+  /// \brief True if materials were destroyed since the last cleanup
+  public: bool materialsDestroyed = false;
+
+  /// \brief True to load material textures asynchronously
+  public: bool asyncTextureLoading = false;
+
+  /// \brief Directory of the on-disk cache of block compressed textures,
+  /// empty if disabled
+  public: std::string textureCachePath;
+
+  /// \brief Threads converting sensor readbacks
+  public: unsigned int postProcessThreadCount = 1u;
+
+  /// \brief Materials with textures being loaded asynchronously
+  public: std::unordered_set<Ogre2Material *> pendingTextureMaterials;
+
+  /// \brief True to bound the resolution of the cached textures by the
+  /// cameras
+  public: bool textureResidencyFromCameras = false;
+
+  /// \brief Maximum resolution of the cached textures, 0 if not bound
+  public: unsigned int textureResolutionCap = 0u;
+
+  /// \brief Materials using textures of the texture cache
+  public: std::unordered_set<Ogre2Material *> cachedTextureMaterials;
+
+  /// \brief True if cloned materials share their datablocks
+  public: bool materialSharing = false;
+
+  /// \brief A datablock shared by materials of identical parameters
+  public: struct SharedDatablock
+  {
+    /// \brief Ogre datablock
+    Ogre::HlmsPbsDatablock *datablock = nullptr;
+
+    /// \brief Number of materials using the datablock
+    unsigned int users = 0u;
+  };
+
+  /// \brief Datablocks shared by materials, key: material content key
+  public: std::unordered_map<std::string, SharedDatablock> sharedDatablocks;
+
+  /// \brief Shared datablocks no longer used by any material, destroyed
+  /// once no renderable uses them either
+  public: std::vector<Ogre::HlmsPbsDatablock *> releasedDatablocks;
+
+  /// \brief Used to give the shared datablocks unique names
+  public: uint64_t sharedDatablockCounter = 0u;
+
+  /// \brief A shadow map tied to a light with static shadows
+  public: struct StaticShadowMap
+  {
+    /// \brief Index of the shadow map in the shadow node
+    size_t shadowMapIdx = 0u;
+
+    /// \brief Light the shadow map is tied to
+    std::weak_ptr<Ogre2Light> light;
+
+    /// \brief World pose of the light when the shadow map was last rendered
+    math::Pose3d pose;
+
+    /// \brief Direction of the light when the shadow map was last rendered
+    Ogre::Vector3 direction;
+  };
+
+  /// \brief Shadow maps of the lights with static shadows
+  public: std::vector<StaticShadowMap> staticShadowMaps;
+
+  /// \brief Incremented every time the static shadow maps need to be
+  /// re-rendered. Workspaces start at 0 so that they are always updated
+  /// at least once.
+  public: uint64_t staticShadowsRevision = 1u;
+
+  /// \brief Maximum number of shadow maps
+  public: unsigned int maxShadowMaps = 25u;
+
+  /// \brief Size of the shadow maps in pixels
+  public: unsigned int shadowTextureSize = 2048u;
+
+  /// \brief True to reduce the shadow map resolution of far point and spot
+  /// lights
+  public: bool shadowResolutionByDistance = false;
+
+  /// \brief Number of frames between forced static shadow map updates,
+  /// 0 to disable
+  public: unsigned int staticShadowsUpdateInterval = 0u;
+
+  /// \brief Number of frames since the static shadow maps were last
+  /// marked dirty
+  public: unsigned int staticShadowsAge = 0u;
+
   /// \brief Name of shadow compositor node
   public: const std::string kShadowNodeName = "PbsMaterialsShadowNode";
+
+  /// \brief Particle emitters of the scene
+  public: std::vector<std::weak_ptr<Ogre2ParticleEmitter>> particleEmitters;
+
+  /// \brief Particle volumes shared by the sensors, see ParticleVolumes
+  public: std::vector<Ogre2Scene::ParticleVolume> particleVolumes;
+
+  /// \brief Ogre frame the particle volumes were evaluated for
+  public: unsigned long particleVolumesFrame =
+      std::numeric_limits<unsigned long>::max();
+
+  /// \brief Scene nodes of destroyed ignition nodes, detached and reset,
+  /// handed out again by AcquireSceneNode
+  public: std::vector<Ogre::SceneNode *> sceneNodePool;
+
+  /// \brief Forward+ light clustering parameters
+  public: Ogre2Scene::ForwardClusteringParams forwardClustering;
+
+  /// \brief True to adapt the Forward+ light clustering to the lights
+  public: bool forwardClusteringAuto = false;
+
+  /// \brief True if the Forward+ light clustering needs to be applied to
+  /// the scene manager
+  public: bool forwardClusteringDirty = true;
+
+  /// \brief Number of lights of the scene when the Forward+ light
+  /// clustering was last adapted
+  public: unsigned int forwardClusteringLightCount =
+      std::numeric_limits<unsigned int>::max();
+
+  /// \brief Maximum number of scene nodes kept in sceneNodePool
+  public: static constexpr std::size_t kMaxPooledSceneNodes = 4096u;
 };
 
 using namespace ignition;
@@ -163,12 +393,17 @@ void Ogre2Scene::SetAmbientLight(const math::Color &_color)
 //////////////////////////////////////////////////
 void Ogre2Scene::PreRender()
 {
+  IGN_PROFILE("Ogre2Scene::PreRender");
   IGN_ASSERT((this->LegacyAutoGpuFlush() ||
               this->dataPtr->frameUpdateStarted == false),
              "Scene::PreRender called again before calling Scene::PostRender. "
              "See Scene::SetCameraPassCountPerGpuFlush for details");
   this->dataPtr->frameUpdateStarted = true;
 
+  // run queued commands first, they may add lights or change which ones
+  // cast shadows. BaseScene::PreRender only runs those queued since
+  this->ProcessCommands();
+
   if (this->ShadowsDirty())
   {
     // notify all render targets
@@ -184,9 +419,16 @@ void Ogre2Scene::PreRender()
 
     this->UpdateShadowNode();
   }
+  this->UpdateStaticShadows();
+  this->UpdateForwardClustering();
+  this->UpdateTextureResidency();
 
   BaseScene::PreRender();
 
+  // the markers were pre-rendered, their batches are complete
+  if (this->dataPtr->markerBatcher)
+    this->dataPtr->markerBatcher->Flush();
+
   if (!this->LegacyAutoGpuFlush())
   {
     auto engine = Ogre2RenderEngine::Instance();
@@ -196,9 +438,73 @@ void Ogre2Scene::PreRender()
   }
 }
 
+//////////////////////////////////////////////////
+unsigned int Ogre2Scene::SetLocalPoses(const std::vector<unsigned int> &_ids,
+    const std::vector<math::Pose3d> &_poses)
+{
+  IGN_PROFILE("Ogre2Scene::SetLocalPoses");
+  if (_ids.size() != _poses.size())
+  {
+    ignerr << "Unable to set local poses: got " << _ids.size()
+           << " node ids but " << _poses.size() << " poses" << std::endl;
+    return 0u;
+  }
+
+  // Mark the nodes, their ancestors and the world poses of their
+  // descendants here, so that the pose writes only touch the nodes
+  // themselves and can run in parallel. Marking before
+  // writing is fine since nothing reads the marks in between. Repeated ids
+  // are written afterwards in order, so the last pose wins as if the poses
+  // were set one by one.
+  std::vector<std::pair<Ogre2Node *, const math::Pose3d *>> writes;
+  std::vector<std::pair<NodePtr, const math::Pose3d *>> serialWrites;
+  writes.reserve(_ids.size());
+  for (std::size_t i = 0u; i < _ids.size(); ++i)
+  {
+    NodePtr node = this->NodeById(_ids[i]);
+    if (!node)
+      continue;
+
+    // static nodes notify the scene manager, which isn't thread safe
+    Ogre2Node *ogre2Node = dynamic_cast<Ogre2Node *>(node.get());
+    if (!ogre2Node || ogre2Node->boundsMarkDeferred ||
+        (ogre2Node->ogreNode && ogre2Node->ogreNode->isStatic()))
+    {
+      serialWrites.emplace_back(node, &_poses[i]);
+      continue;
+    }
+
+    node->MarkPreRenderDirty();
+    ogre2Node->MarkSubtreeBoundsDirty();
+    ogre2Node->MarkWorldPoseDirty();
+    ogre2Node->boundsMarkDeferred = true;
+    writes.emplace_back(ogre2Node, &_poses[i]);
+  }
+
+  // ogre keeps the transform of each node in a slot of its own, so writes
+  // to different nodes don't race. A pose write costs about as much as
+  // copying 1KB, which keeps small batches on the calling thread
+  Ogre2RenderEngine *engine = Ogre2RenderEngine::Instance();
+  engine->WorkerPool().ParallelFor(static_cast<unsigned int>(writes.size()),
+      1024u, engine->SceneThreadCount(),
+      [&](unsigned int _begin, unsigned int _end)
+      {
+        for (unsigned int i = _begin; i < _end; ++i)
+          writes[i].first->SetLocalPose(*writes[i].second);
+      });
+
+  for (auto &write : writes)
+    write.first->boundsMarkDeferred = false;
+  for (auto &write : serialWrites)
+    write.first->SetLocalPose(*write.second);
+
+  return static_cast<unsigned int>(writes.size() + serialWrites.size());
+}
+
 //////////////////////////////////////////////////
 void Ogre2Scene::PostRender()
 {
+  IGN_PROFILE("Ogre2Scene::PostRender");
   IGN_ASSERT((this->LegacyAutoGpuFlush() ||
               this->dataPtr->frameUpdateStarted == true),
              "Scene::PostRender called again before calling Scene::PreRender. "
@@ -266,6 +572,12 @@ void Ogre2Scene::StartRendering(Ogre::Camera *_camera)
   if (_camera)
     this->UpdateAllHeightmaps(_camera);
 
+  if (this->dataPtr->batchRendering)
+  {
+    // RenderSensors already started the frame
+    return;
+  }
+
   if (this->LegacyAutoGpuFlush())
   {
     auto engine = Ogre2RenderEngine::Instance();
@@ -287,6 +599,10 @@ void Ogre2Scene::FlushGpuCommandsAndStartNewFrame(uint8_t _numPasses,
 {
   this->dataPtr->currNumCameraPasses += _numPasses;
 
+  // RenderSensors flushes once all sensors have been recorded
+  if (this->dataPtr->batchRendering)
+    return;
+
   if (this->dataPtr->currNumCameraPasses >= dataPtr->cameraPassCountPerGpuFlush
       || _startNewFrame)
   {
@@ -299,6 +615,100 @@ void Ogre2Scene::FlushGpuCommandsAndStartNewFrame(uint8_t _numPasses,
   }
 }
 
+//////////////////////////////////////////////////
+rendering::MemoryStats Ogre2Scene::MemoryStats() const
+{
+  rendering::MemoryStats stats;
+  if (!this->ogreSceneManager)
+    return stats;
+
+  // meshes and material textures of the items in this scene
+  std::unordered_set<const void *> seen;
+  auto it = this->ogreSceneManager->getMovableObjectIterator(
+      Ogre::ItemFactory::FACTORY_TYPE_NAME);
+  while (it.hasMoreElements())
+  {
+    Ogre::Item *item = static_cast<Ogre::Item *>(it.getNext());
+    Ogre2MemoryStats::AddMesh(item->getMesh().get(), seen, stats);
+    for (size_t i = 0; i < item->getNumSubItems(); ++i)
+    {
+      Ogre2MemoryStats::AddDatablock(item->getSubItem(i)->getDatablock(),
+          seen, stats);
+    }
+  }
+  return stats;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::RenderSensors(const std::vector<SensorPtr> &_sensors)
+{
+  std::vector<CameraPtr> cameras;
+  cameras.reserve(_sensors.size());
+  for (const auto &sensor : _sensors)
+  {
+    CameraPtr camera = std::dynamic_pointer_cast<Camera>(sensor);
+    if (camera)
+      cameras.push_back(camera);
+  }
+
+  if (cameras.empty())
+    return;
+
+  this->PreRender();
+
+  // In legacy mode every camera would start its own frame in
+  // StartRendering. Start a single frame for the whole batch instead.
+  bool legacy = this->LegacyAutoGpuFlush();
+  if (legacy)
+  {
+    auto engine = Ogre2RenderEngine::Instance();
+    engine->OgreRoot()->_fireFrameStarted();
+
+    this->ogreSceneManager->updateSceneGraph();
+  }
+
+  // record all sensor workspaces
+  this->dataPtr->batchRendering = true;
+  for (auto &camera : cameras)
+    camera->Render();
+  this->dataPtr->batchRendering = false;
+
+  // submit everything to the GPU at once
+  this->dataPtr->currNumCameraPasses = 0u;
+  this->FlushGpuCommandsOnly();
+
+  // resolve all readbacks
+  for (auto &camera : cameras)
+    camera->PostRender();
+
+  if (legacy)
+    this->EndFrame();
+  else
+    this->PostRender();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::WarmUp()
+{
+  BaseScene::WarmUp();
+
+  // the selection buffer renders the scene with materials of its own. They
+  // are the same for all cameras so warming up one buffer is enough, it is
+  // kept for the camera's later VisualAt queries
+  for (unsigned int i = 0; i < this->SensorCount(); ++i)
+  {
+    Ogre2CameraPtr camera =
+        std::dynamic_pointer_cast<Ogre2Camera>(this->SensorByIndex(i));
+    if (!camera)
+      continue;
+
+    if (!camera->selectionBuffer)
+      camera->SetSelectionBuffer();
+    camera->selectionBuffer->Update();
+    break;
+  }
+}
+
 //////////////////////////////////////////////////
 void Ogre2Scene::FlushGpuCommandsOnly()
 {
@@ -342,6 +752,9 @@ void Ogre2Scene::EndFrame()
   }
 
   ogreRoot->_fireFrameEnded();
+
+  this->CleanupDestroyedMaterials();
+  this->UpdatePendingTextures();
 }
 
 //////////////////////////////////////////////////
@@ -366,13 +779,121 @@ bool Ogre2Scene::LegacyAutoGpuFlush() const
 void Ogre2Scene::Clear()
 {
   this->meshFactory->Clear();
+  if (this->dataPtr->markerBatcher)
+    this->dataPtr->markerBatcher->Clear();
+
+  BaseScene::Clear();
+  this->DestroySceneNodePool();
+}
 
+//////////////////////////////////////////////////
+Ogre::SceneNode *Ogre2Scene::AcquireSceneNode()
+{
+  auto &pool = this->dataPtr->sceneNodePool;
+  if (pool.empty())
+    return this->ogreSceneManager->createSceneNode();
+
+  Ogre::SceneNode *node = pool.back();
+  pool.pop_back();
+  return node;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::ReleaseSceneNode(Ogre::SceneNode *_node)
+{
+  if (!_node)
+    return;
+
+  // pooled nodes are handed out as dynamic nodes
+  if (_node->isStatic() || this->dataPtr->sceneNodePool.size() >=
+      Ogre2ScenePrivate::kMaxPooledSceneNodes)
+  {
+    this->ogreSceneManager->destroySceneNode(_node);
+    return;
+  }
+
+  // put the node back in the state of a newly created one
+  Ogre::SceneNode *parent = _node->getParentSceneNode();
+  if (parent)
+    parent->removeChild(_node);
+  _node->removeAllChildren();
+  _node->detachAllObjects();
+  _node->setPosition(Ogre::Vector3::ZERO);
+  _node->setOrientation(Ogre::Quaternion::IDENTITY);
+  _node->setScale(Ogre::Vector3::UNIT_SCALE);
+  _node->setInheritOrientation(true);
+  _node->setInheritScale(true);
+  _node->setVisible(true);
+  this->dataPtr->sceneNodePool.push_back(_node);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::DestroySceneNodePool()
+{
+  if (this->ogreSceneManager)
+  {
+    for (Ogre::SceneNode *node : this->dataPtr->sceneNodePool)
+      this->ogreSceneManager->destroySceneNode(node);
+  }
+  this->dataPtr->sceneNodePool.clear();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::Reset()
+{
+  // unlike Clear, the meshes of the mesh factory are kept and the textures
+  // of the destroyed materials are not unloaded, the objects created after
+  // the reset are likely to use them again
   BaseScene::Clear();
+  this->dataPtr->destroyedTextures.clear();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::CopySettings(const ScenePtr &_instance) const
+{
+  BaseScene::CopySettings(_instance);
+
+  Ogre2ScenePtr instance = std::dynamic_pointer_cast<Ogre2Scene>(_instance);
+  if (!instance)
+    return;
+
+  // the material sharing mode has to be set before the materials of the
+  // instance are copied
+  instance->SetMaterialSharing(this->MaterialSharing());
+  instance->SetAsyncTextureLoading(this->AsyncTextureLoading());
+  instance->SetTextureCachePath(this->TextureCachePath());
+  instance->SetTextureResidencyFromCameras(
+      this->TextureResidencyFromCameras());
+  instance->SetMeshCachePath(this->MeshCachePath());
+  instance->SetMeshLodLevelCount(this->MeshLodLevelCount());
+  instance->SetMeshLodDistance(this->MeshLodDistance());
+  instance->SetMeshVertexCompression(this->MeshVertexCompression());
+  instance->SetMarkerBatching(this->MarkerBatching());
+  instance->SetMaxShadowMaps(this->MaxShadowMaps());
+  instance->SetShadowTextureSize(this->ShadowTextureSize());
+  instance->SetShadowResolutionByDistance(
+      this->ShadowResolutionByDistance());
+  instance->SetStaticShadowsUpdateInterval(
+      this->StaticShadowsUpdateInterval());
+  instance->SetPostProcessThreadCount(this->PostProcessThreadCount());
+  instance->SetSkyHorizonCulling(this->SkyHorizonCulling());
+  if (this->ForwardClusteringAuto())
+    instance->SetForwardClusteringAuto(true);
+  else
+    instance->SetForwardClustering(this->ForwardClustering());
+  if (!this->LegacyAutoGpuFlush())
+  {
+    instance->SetCameraPassCountPerGpuFlush(
+        this->CameraPassCountPerGpuFlush());
+  }
 }
 
 //////////////////////////////////////////////////
 void Ogre2Scene::Destroy()
 {
+  // the batches own items and materials, destroy them before the scene
+  // destroys all of them
+  this->dataPtr->markerBatcher.reset();
   this->DestroyNodes();
 
   // cleanup any items that were not attached to nodes
@@ -380,8 +901,13 @@ void Ogre2Scene::Destroy()
   // otherwise ogre throws an exception when unlinking a renderable from a
   // hlms datablock
   this->ogreSceneManager->destroyAllItems();
+  this->MarkVisibilityLayersDirty();
 
   BaseScene::Destroy();
+  this->CleanupDestroyedMaterials();
+  this->dataPtr->pendingTextureMaterials.clear();
+  this->dataPtr->cachedTextureMaterials.clear();
+  this->DestroySceneNodePool();
 
   if (this->ogreSceneManager)
   {
@@ -511,13 +1037,17 @@ void Ogre2Scene::UpdateShadowNode()
 
   unsigned int spotPointLightCount = 0;
   unsigned int dirLightCount = 0;
+  std::vector<Ogre2LightPtr> staticLights;
 
   for (unsigned int i = 0; i < this->LightCount(); ++i)
   {
     LightPtr light = this->LightByIndex(i);
     if (light->CastShadows())
     {
-      if (std::dynamic_pointer_cast<DirectionalLight>(light))
+      Ogre2LightPtr ogreLight = std::dynamic_pointer_cast<Ogre2Light>(light);
+      if (ogreLight && ogreLight->StaticShadows())
+        staticLights.push_back(ogreLight);
+      else if (std::dynamic_pointer_cast<DirectionalLight>(light))
         dirLightCount++;
       else
         spotPointLightCount++;
@@ -529,7 +1059,7 @@ void Ogre2Scene::UpdateShadowNode()
   // the number of shadow maps exceeds certain number. The error seems to
   // suggest that the number of uniform variables has exceeded the max number
   // allowed
-  unsigned int maxShadowMaps = 25u;
+  unsigned int maxShadowMaps = this->dataPtr->maxShadowMaps;
   if (dirLightCount * 3 + spotPointLightCount > maxShadowMaps)
   {
     dirLightCount = std::min(static_cast<unsigned int>(maxShadowMaps / 3),
@@ -542,6 +1072,25 @@ void Ogre2Scene::UpdateShadowNode()
             << spotPointLightCount << " point / spot lights" << std::endl;
   }
 
+  // static shadow maps use whatever the dynamic ones left
+  unsigned int shadowMapCount = dirLightCount * 3 + spotPointLightCount;
+  for (auto it = staticLights.begin(); it != staticLights.end();)
+  {
+    unsigned int count =
+        (*it)->Light()->getType() == Ogre::Light::LT_DIRECTIONAL ? 3u : 1u;
+    if (shadowMapCount + count > maxShadowMaps)
+    {
+      ignwarn << "Number of shadow-casting lights exceeds the limit supported "
+              << "by the underlying rendering engine ogre2. Light ["
+              << (*it)->Name() << "] will not cast static shadows"
+              << std::endl;
+      it = staticLights.erase(it);
+      continue;
+    }
+    shadowMapCount += count;
+    ++it;
+  }
+
   auto engine = Ogre2RenderEngine::Instance();
   Ogre::CompositorManager2 *compositorManager =
       engine->OgreRoot()->getCompositorManager2();
@@ -551,7 +1100,7 @@ void Ogre2Scene::UpdateShadowNode()
 
   // directional lights
   unsigned int atlasId = 0u;
-  unsigned int texSize = 2048u;
+  unsigned int texSize = this->dataPtr->shadowTextureSize;
   unsigned int halfTexSize = texSize * 0.5;
   for (unsigned int i = 0; i < dirLightCount; ++i)
   {
@@ -580,17 +1129,41 @@ void Ogre2Scene::UpdateShadowNode()
   unsigned int maxTexSize = 8192u;
   unsigned int rowIdx = 0;
   unsigned int colIdx = 0;
-  unsigned int rowSize = maxTexSize / texSize;
+  unsigned int mapSize = texSize;
+  unsigned int rowSize = maxTexSize / mapSize;
   unsigned int colSize = rowSize;
 
+  // ogre assigns the shadow maps to the lights closest to the camera first
+  unsigned int fullSizeCount = std::max((spotPointLightCount + 3u) / 4u, 1u);
+  unsigned int halfSizeCount =
+      std::max((spotPointLightCount + 1u) / 2u, fullSizeCount);
+
   for (unsigned int i = 0; i < spotPointLightCount; ++i)
   {
+    unsigned int size = texSize;
+    if (this->dataPtr->shadowResolutionByDistance && i >= halfSizeCount)
+      size = texSize / 4u;
+    else if (this->dataPtr->shadowResolutionByDistance && i >= fullSizeCount)
+      size = texSize / 2u;
+
+    // maps of different sizes go to different atlases
+    if (size != mapSize)
+    {
+      if (colIdx > 0u || rowIdx > 0u)
+        atlasId++;
+      colIdx = 0;
+      rowIdx = 0;
+      mapSize = size;
+      rowSize = maxTexSize / mapSize;
+      colSize = rowSize;
+    }
+
     shadowParam.technique = Ogre::SHADOWMAP_FOCUSED;
     shadowParam.atlasId = atlasId;
-    shadowParam.resolution[0].x = texSize;
-    shadowParam.resolution[0].y = texSize;
-    shadowParam.atlasStart[0].x = colIdx * texSize;
-    shadowParam.atlasStart[0].y = rowIdx * texSize;
+    shadowParam.resolution[0].x = mapSize;
+    shadowParam.resolution[0].y = mapSize;
+    shadowParam.atlasStart[0].x = colIdx * mapSize;
+    shadowParam.atlasStart[0].y = rowIdx * mapSize;
 
     shadowParam.supportedLightTypes = 0u;
     shadowParam.addLightType(Ogre::Light::LT_DIRECTIONAL);
@@ -613,12 +1186,61 @@ void Ogre2Scene::UpdateShadowNode()
     }
   }
 
+  // static lights get an atlas each, so that clearing the atlas can be
+  // skipped along with rendering the shadow map
+  if (colIdx > 0u || rowIdx > 0u)
+    atlasId++;
+
+  this->dataPtr->staticShadowMaps.clear();
+  std::vector<size_t> staticParams;
+  size_t shadowMapIdx = dirLightCount * 3u + spotPointLightCount;
+  for (const auto &light : staticLights)
+  {
+    Ogre::Light::LightTypes lightType = light->Light()->getType();
+    shadowParam.atlasId = atlasId++;
+    shadowParam.resolution[0].x = texSize;
+    shadowParam.resolution[0].y = texSize;
+    shadowParam.atlasStart[0].x = 0u;
+    shadowParam.atlasStart[0].y = 0u;
+    if (lightType == Ogre::Light::LT_DIRECTIONAL)
+    {
+      shadowParam.technique = Ogre::SHADOWMAP_PSSM;
+      shadowParam.numPssmSplits = 3u;
+      shadowParam.resolution[1].x = halfTexSize;
+      shadowParam.resolution[1].y = halfTexSize;
+      shadowParam.resolution[2].x = halfTexSize;
+      shadowParam.resolution[2].y = halfTexSize;
+      shadowParam.atlasStart[1].x = 0u;
+      shadowParam.atlasStart[1].y = texSize;
+      shadowParam.atlasStart[2].x = halfTexSize;
+      shadowParam.atlasStart[2].y = texSize;
+    }
+    else
+    {
+      shadowParam.technique = Ogre::SHADOWMAP_FOCUSED;
+    }
+    shadowParam.supportedLightTypes = 0u;
+    shadowParam.addLightType(lightType);
+    shadowParams.push_back(shadowParam);
+    staticParams.push_back(shadowParams.size() - 1u);
+
+    Ogre2ScenePrivate::StaticShadowMap staticShadowMap;
+    staticShadowMap.shadowMapIdx = shadowMapIdx;
+    staticShadowMap.light = light;
+    staticShadowMap.pose = light->WorldPose();
+    staticShadowMap.direction = light->Light()->getDirection();
+    this->dataPtr->staticShadowMaps.push_back(staticShadowMap);
+
+    shadowMapIdx += lightType == Ogre::Light::LT_DIRECTIONAL ? 3u : 1u;
+  }
+  ++this->dataPtr->staticShadowsRevision;
+
   std::string shadowNodeDefName = this->dataPtr->kShadowNodeName;
   if (compositorManager->hasShadowNodeDefinition(shadowNodeDefName))
     compositorManager->removeShadowNodeDefinition(shadowNodeDefName);
 
   this->CreateShadowNodeWithSettings(compositorManager, shadowNodeDefName,
-      shadowParams);
+      shadowParams, staticParams);
 
   this->SetShadowsDirty(false);
 }
@@ -627,7 +1249,8 @@ void Ogre2Scene::UpdateShadowNode()
 void Ogre2Scene::CreateShadowNodeWithSettings(
     Ogre::CompositorManager2 *_compositorManager,
     const std::string &_shadowNodeName,
-    const Ogre::ShadowNodeHelper::ShadowParamVec &_shadowParams)
+    const Ogre::ShadowNodeHelper::ShadowParamVec &_shadowParams,
+    const std::vector<size_t> &_staticParams)
 {
   Ogre::uint32 pointLightCubemapResolution = 1024u;
   Ogre::Real pssmLambda = 0.95f;
@@ -808,6 +1431,24 @@ void Ogre2Scene::CreateShadowNodeWithSettings(
           static_cast<Ogre::CompositorPassClearDef *>(passDef);
       passClear->setAllClearColours(Ogre::ColourValue::White);
       passClear->mClearDepth = 1.0f;
+
+      // tie the clear of a static shadow map atlas to its shadow map so
+      // that it is skipped, together with rendering the shadow map, while
+      // the shadow map is not dirty
+      for (auto paramIdx : _staticParams)
+      {
+        if (_shadowParams[paramIdx].atlasId != atlasId)
+          continue;
+
+        size_t staticShadowMapIdx = 0u;
+        for (size_t i = 0u; i < paramIdx; ++i)
+        {
+          staticShadowMapIdx +=
+              _shadowParams[i].technique == Ogre::SHADOWMAP_PSSM ?
+              _shadowParams[i].numPssmSplits : 1u;
+        }
+        passClear->mShadowMapIdx = staticShadowMapIdx;
+      }
     }
 
     // Pass scene for directional and spot lights first
@@ -900,79 +1541,310 @@ void Ogre2Scene::CreateShadowNodeWithSettings(
 }
 
 //////////////////////////////////////////////////
-LightStorePtr Ogre2Scene::Lights() const
+void Ogre2Scene::UpdateStaticShadows()
 {
-  return this->lights;
+  if (this->dataPtr->staticShadowMaps.empty())
+    return;
+
+  bool dirty = false;
+  for (auto &staticShadowMap : this->dataPtr->staticShadowMaps)
+  {
+    Ogre2LightPtr light = staticShadowMap.light.lock();
+    if (!light)
+      continue;
+
+    math::Pose3d pose = light->WorldPose();
+    Ogre::Vector3 direction = light->Light()->getDirection();
+    if (pose != staticShadowMap.pose || direction != staticShadowMap.direction)
+    {
+      staticShadowMap.pose = pose;
+      staticShadowMap.direction = direction;
+      dirty = true;
+    }
+  }
+
+  if (this->dataPtr->staticShadowsUpdateInterval > 0u &&
+      ++this->dataPtr->staticShadowsAge >=
+      this->dataPtr->staticShadowsUpdateInterval)
+  {
+    dirty = true;
+  }
+
+  if (dirty)
+    this->SetStaticShadowsDirty();
 }
 
 //////////////////////////////////////////////////
-SensorStorePtr Ogre2Scene::Sensors() const
+void Ogre2Scene::SetStaticShadowsDirty()
 {
-  return this->sensors;
+  ++this->dataPtr->staticShadowsRevision;
+  this->dataPtr->staticShadowsAge = 0u;
 }
 
 //////////////////////////////////////////////////
-VisualStorePtr Ogre2Scene::Visuals() const
+void Ogre2Scene::SetStaticShadowsUpdateInterval(unsigned int _frames)
 {
-  return this->visuals;
+  this->dataPtr->staticShadowsUpdateInterval = _frames;
+  this->dataPtr->staticShadowsAge = 0u;
 }
 
 //////////////////////////////////////////////////
-MaterialMapPtr Ogre2Scene::Materials() const
+unsigned int Ogre2Scene::StaticShadowsUpdateInterval() const
 {
-  return this->materials;
+  return this->dataPtr->staticShadowsUpdateInterval;
 }
 
 //////////////////////////////////////////////////
-const std::vector<std::weak_ptr<Ogre2Heightmap>> &Ogre2Scene::Heightmaps() const
+void Ogre2Scene::SetMaxShadowMaps(unsigned int _count)
 {
-  return this->heightmaps;
+  if (_count == this->dataPtr->maxShadowMaps)
+    return;
+
+  this->dataPtr->maxShadowMaps = _count;
+  this->SetShadowsDirty(true);
 }
 
 //////////////////////////////////////////////////
-DirectionalLightPtr Ogre2Scene::CreateDirectionalLightImpl(unsigned int _id,
-    const std::string &_name)
+unsigned int Ogre2Scene::MaxShadowMaps() const
 {
-  Ogre2DirectionalLightPtr light(new Ogre2DirectionalLight);
-  bool result = this->InitObject(light, _id, _name);
-  return (result) ? light : nullptr;
+  return this->dataPtr->maxShadowMaps;
 }
 
 //////////////////////////////////////////////////
-PointLightPtr Ogre2Scene::CreatePointLightImpl(unsigned int _id,
-    const std::string &_name)
+void Ogre2Scene::SetShadowTextureSize(unsigned int _size)
 {
-  Ogre2PointLightPtr light(new Ogre2PointLight);
-  bool result = this->InitObject(light, _id, _name);
-  return (result) ? light : nullptr;
+  if (_size < 256u || _size > 8192u || (_size & (_size - 1u)) != 0u)
+  {
+    ignerr << "Shadow texture size must be a power of two between 256 and "
+           << "8192, got " << _size << std::endl;
+    return;
+  }
+  if (_size == this->dataPtr->shadowTextureSize)
+    return;
+
+  this->dataPtr->shadowTextureSize = _size;
+  this->SetShadowsDirty(true);
 }
 
 //////////////////////////////////////////////////
-SpotLightPtr Ogre2Scene::CreateSpotLightImpl(unsigned int _id,
-    const std::string &_name)
+unsigned int Ogre2Scene::ShadowTextureSize() const
 {
-  Ogre2SpotLightPtr light(new Ogre2SpotLight);
-  bool result = this->InitObject(light, _id, _name);
-  return (result) ? light : nullptr;
+  return this->dataPtr->shadowTextureSize;
 }
 
 //////////////////////////////////////////////////
-CameraPtr Ogre2Scene::CreateCameraImpl(unsigned int _id,
-    const std::string &_name)
+void Ogre2Scene::SetShadowResolutionByDistance(bool _enabled)
 {
-  Ogre2CameraPtr camera(new Ogre2Camera);
-  bool result = this->InitObject(camera, _id, _name);
-  camera->SetBackgroundColor(this->backgroundColor);
-  if (this->backgroundMaterial)
-    camera->SetBackgroundMaterial(this->backgroundMaterial);
-  return (result) ? camera : nullptr;
+  if (_enabled == this->dataPtr->shadowResolutionByDistance)
+    return;
+
+  this->dataPtr->shadowResolutionByDistance = _enabled;
+  this->SetShadowsDirty(true);
 }
 
 //////////////////////////////////////////////////
-DepthCameraPtr Ogre2Scene::CreateDepthCameraImpl(const unsigned int _id,
-    const std::string &_name)
+bool Ogre2Scene::ShadowResolutionByDistance() const
 {
-  Ogre2DepthCameraPtr camera(new Ogre2DepthCamera);
+  return this->dataPtr->shadowResolutionByDistance;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetPostProcessThreadCount(unsigned int _count)
+{
+  if (_count == 0u)
+    _count = std::max(1u, std::thread::hardware_concurrency());
+  this->dataPtr->postProcessThreadCount = _count;
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2Scene::PostProcessThreadCount() const
+{
+  return this->dataPtr->postProcessThreadCount;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetMaterialSharing(bool _enabled)
+{
+  this->dataPtr->materialSharing = _enabled;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Scene::MaterialSharing() const
+{
+  return this->dataPtr->materialSharing;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetMarkerBatching(bool _enabled)
+{
+  if (!_enabled)
+    this->dataPtr->markerBatcher.reset();
+  else if (!this->dataPtr->markerBatcher)
+  {
+    this->dataPtr->markerBatcher =
+        std::make_unique<Ogre2MarkerBatcher>(this->SharedThis());
+  }
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Scene::MarkerBatching() const
+{
+  return this->dataPtr->markerBatcher != nullptr;
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2Scene::MarkerBatchCount() const
+{
+  if (!this->dataPtr->markerBatcher)
+    return 0u;
+  return this->dataPtr->markerBatcher->BatchCount();
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2Scene::SharedDatablockCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->sharedDatablocks.size());
+}
+
+//////////////////////////////////////////////////
+Ogre::HlmsPbsDatablock *Ogre2Scene::AcquireSharedDatablock(
+    const std::string &_key, const Ogre::HlmsPbsDatablock *_datablock)
+{
+  auto &shared = this->dataPtr->sharedDatablocks[_key];
+  if (!shared.datablock)
+  {
+    std::string name = this->Name() + "::SharedDatablock" +
+        std::to_string(this->dataPtr->sharedDatablockCounter++);
+    shared.datablock =
+        static_cast<Ogre::HlmsPbsDatablock *>(_datablock->clone(name));
+    SetDatablockObjectId(shared.datablock);
+  }
+  shared.users++;
+  return shared.datablock;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::ReleaseSharedDatablock(const std::string &_key)
+{
+  auto it = this->dataPtr->sharedDatablocks.find(_key);
+  if (it == this->dataPtr->sharedDatablocks.end())
+    return;
+
+  if (--it->second.users > 0u)
+    return;
+
+  // renderables may still use the datablock until they are destroyed or
+  // switch to the copy of the material that released it
+  this->dataPtr->releasedDatablocks.push_back(it->second.datablock);
+  this->dataPtr->sharedDatablocks.erase(it);
+  this->dataPtr->materialsDestroyed = true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::UpdateStaticShadowMaps(Ogre::CompositorWorkspace *_workspace,
+    uint64_t &_revision)
+{
+  if (_revision == this->dataPtr->staticShadowsRevision)
+    return;
+  _revision = this->dataPtr->staticShadowsRevision;
+
+  if (!_workspace || this->dataPtr->staticShadowMaps.empty())
+    return;
+
+  Ogre::CompositorShadowNode *shadowNode =
+      _workspace->findShadowNode(this->dataPtr->kShadowNodeName);
+  if (!shadowNode)
+    return;
+
+  for (const auto &staticShadowMap : this->dataPtr->staticShadowMaps)
+  {
+    Ogre2LightPtr light = staticShadowMap.light.lock();
+    if (!light)
+      continue;
+
+    shadowNode->setLightFixedToShadowMap(staticShadowMap.shadowMapIdx,
+        light->Light());
+    shadowNode->setStaticShadowMapDirty(staticShadowMap.shadowMapIdx);
+  }
+}
+
+//////////////////////////////////////////////////
+LightStorePtr Ogre2Scene::Lights() const
+{
+  return this->lights;
+}
+
+//////////////////////////////////////////////////
+SensorStorePtr Ogre2Scene::Sensors() const
+{
+  return this->sensors;
+}
+
+//////////////////////////////////////////////////
+VisualStorePtr Ogre2Scene::Visuals() const
+{
+  return this->visuals;
+}
+
+//////////////////////////////////////////////////
+MaterialMapPtr Ogre2Scene::Materials() const
+{
+  return this->materials;
+}
+
+//////////////////////////////////////////////////
+const std::vector<std::weak_ptr<Ogre2Heightmap>> &Ogre2Scene::Heightmaps() const
+{
+  return this->heightmaps;
+}
+
+//////////////////////////////////////////////////
+DirectionalLightPtr Ogre2Scene::CreateDirectionalLightImpl(unsigned int _id,
+    const std::string &_name)
+{
+  Ogre2DirectionalLightPtr light(new Ogre2DirectionalLight);
+  bool result = this->InitObject(light, _id, _name);
+  return (result) ? light : nullptr;
+}
+
+//////////////////////////////////////////////////
+PointLightPtr Ogre2Scene::CreatePointLightImpl(unsigned int _id,
+    const std::string &_name)
+{
+  Ogre2PointLightPtr light(new Ogre2PointLight);
+  bool result = this->InitObject(light, _id, _name);
+  return (result) ? light : nullptr;
+}
+
+//////////////////////////////////////////////////
+SpotLightPtr Ogre2Scene::CreateSpotLightImpl(unsigned int _id,
+    const std::string &_name)
+{
+  Ogre2SpotLightPtr light(new Ogre2SpotLight);
+  bool result = this->InitObject(light, _id, _name);
+  return (result) ? light : nullptr;
+}
+
+//////////////////////////////////////////////////
+CameraPtr Ogre2Scene::CreateCameraImpl(unsigned int _id,
+    const std::string &_name)
+{
+  Ogre2CameraPtr camera(new Ogre2Camera);
+  bool result = this->InitObject(camera, _id, _name);
+  camera->SetBackgroundColor(this->backgroundColor);
+  if (this->backgroundMaterial)
+    camera->SetBackgroundMaterial(this->backgroundMaterial);
+  return (result) ? camera : nullptr;
+}
+
+//////////////////////////////////////////////////
+DepthCameraPtr Ogre2Scene::CreateDepthCameraImpl(const unsigned int _id,
+    const std::string &_name)
+{
+  if (!this->SensorSupported("depth cameras"))
+    return nullptr;
+
+  Ogre2DepthCameraPtr camera(new Ogre2DepthCamera);
   bool result = this->InitObject(camera, _id, _name);
   return (result) ? camera : nullptr;
 }
@@ -981,6 +1853,9 @@ DepthCameraPtr Ogre2Scene::CreateDepthCameraImpl(const unsigned int _id,
 ThermalCameraPtr Ogre2Scene::CreateThermalCameraImpl(const unsigned int _id,
     const std::string &_name)
 {
+  if (!this->SensorSupported("thermal cameras"))
+    return nullptr;
+
   Ogre2ThermalCameraPtr camera(new Ogre2ThermalCamera);
   bool result = this->InitObject(camera, _id, _name);
   return (result) ? camera : nullptr;
@@ -990,20 +1865,62 @@ ThermalCameraPtr Ogre2Scene::CreateThermalCameraImpl(const unsigned int _id,
 SegmentationCameraPtr Ogre2Scene::CreateSegmentationCameraImpl(
   const unsigned int _id, const std::string &_name)
 {
+  if (!this->SensorSupported("segmentation cameras"))
+    return nullptr;
+
   Ogre2SegmentationCameraPtr camera(new Ogre2SegmentationCamera);
   bool result = this->InitObject(camera, _id, _name);
   return (result) ? camera : nullptr;
 }
 
+//////////////////////////////////////////////////
+WideAngleCameraPtr Ogre2Scene::CreateWideAngleCameraImpl(
+  const unsigned int _id, const std::string &_name)
+{
+  if (!this->SensorSupported("wide angle cameras"))
+    return nullptr;
+
+  Ogre2WideAngleCameraPtr camera(new Ogre2WideAngleCamera);
+  bool result = this->InitObject(camera, _id, _name);
+  return (result) ? camera : nullptr;
+}
+
+//////////////////////////////////////////////////
+BoundingBoxCameraPtr Ogre2Scene::CreateBoundingBoxCameraImpl(
+  const unsigned int _id, const std::string &_name)
+{
+  if (!this->SensorSupported("bounding box cameras"))
+    return nullptr;
+
+  Ogre2BoundingBoxCameraPtr camera(new Ogre2BoundingBoxCamera);
+  bool result = this->InitObject(camera, _id, _name);
+  return (result) ? camera : nullptr;
+}
+
 //////////////////////////////////////////////////
 GpuRaysPtr Ogre2Scene::CreateGpuRaysImpl(unsigned int _id,
     const std::string &_name)
 {
+  if (!this->SensorSupported("gpu rays"))
+    return nullptr;
+
   Ogre2GpuRaysPtr gpuRays(new Ogre2GpuRays);
   bool result = this->InitObject(gpuRays, _id, _name);
   return (result) ? gpuRays : nullptr;
 }
 
+//////////////////////////////////////////////////
+bool Ogre2Scene::SensorSupported(const std::string &_type) const
+{
+  if (Ogre2RenderEngine::Instance()->GraphicsAPI() == GraphicsAPI::VULKAN)
+  {
+    ignerr << "Unable to create " << _type << ": their shaders are not "
+           << "available for the Vulkan render system yet" << std::endl;
+    return false;
+  }
+  return true;
+}
+
 //////////////////////////////////////////////////
 VisualPtr Ogre2Scene::CreateVisualImpl(unsigned int _id,
     const std::string &_name)
@@ -1187,11 +2104,30 @@ LidarVisualPtr Ogre2Scene::CreateLidarVisualImpl(unsigned int _id,
 }
 
 //////////////////////////////////////////////////
-TextPtr Ogre2Scene::CreateTextImpl(unsigned int /*_id*/,
-    const std::string &/*_name*/)
+InstancedVisualPtr Ogre2Scene::CreateInstancedVisualImpl(unsigned int _id,
+    const std::string &_name, const MeshDescriptor &_desc,
+    MaterialPtr _material, unsigned int _count)
 {
-  // TODO(anyone)
-  return TextPtr();
+  Ogre2InstancedVisualPtr visual(new Ogre2InstancedVisual);
+  bool result = this->InitObject(visual, _id, _name);
+  if (!result)
+    return nullptr;
+
+  if (!visual->Create(_desc, _material, _count))
+  {
+    visual->Destroy();
+    return nullptr;
+  }
+  return visual;
+}
+
+//////////////////////////////////////////////////
+TextPtr Ogre2Scene::CreateTextImpl(unsigned int _id,
+    const std::string &_name)
+{
+  Ogre2TextPtr text(new Ogre2Text);
+  bool result = this->InitObject(text, _id, _name);
+  return (result) ? text : nullptr;
 }
 
 //////////////////////////////////////////////////
@@ -1229,12 +2165,50 @@ RayQueryPtr Ogre2Scene::CreateRayQueryImpl(unsigned int _id,
   return (result) ? rayQuery : nullptr;
 }
 
+//////////////////////////////////////////////////
+const std::vector<Ogre2Scene::ParticleVolume> &Ogre2Scene::ParticleVolumes()
+{
+  // particles move every frame. Sensors rendered in the same frame share
+  // the volumes
+  unsigned long frame =
+      Ogre2RenderEngine::Instance()->OgreRoot()->getNextFrameNumber();
+  if (frame == this->dataPtr->particleVolumesFrame)
+    return this->dataPtr->particleVolumes;
+  this->dataPtr->particleVolumesFrame = frame;
+
+  this->dataPtr->particleVolumes.clear();
+  auto &emitters = this->dataPtr->particleEmitters;
+  for (auto it = emitters.begin(); it != emitters.end();)
+  {
+    Ogre2ParticleEmitterPtr emitter = it->lock();
+    if (!emitter)
+    {
+      it = emitters.erase(it);
+      continue;
+    }
+    ++it;
+
+    math::AxisAlignedBox box;
+    if (!emitter->ParticleBounds(box))
+      continue;
+
+    ParticleVolume volume;
+    volume.box = Ogre::AxisAlignedBox(Ogre2Conversions::Convert(box.Min()),
+        Ogre2Conversions::Convert(box.Max()));
+    volume.scatterRatio = emitter->ParticleScatterRatio();
+    this->dataPtr->particleVolumes.push_back(volume);
+  }
+  return this->dataPtr->particleVolumes;
+}
+
 //////////////////////////////////////////////////
 ParticleEmitterPtr Ogre2Scene::CreateParticleEmitterImpl(unsigned int _id,
     const std::string &_name)
 {
   Ogre2ParticleEmitterPtr visual(new Ogre2ParticleEmitter);
   bool result = this->InitObject(visual, _id, _name);
+  if (result)
+    this->dataPtr->particleEmitters.push_back(visual);
 
   return (result) ? visual : nullptr;
 }
@@ -1258,19 +2232,62 @@ bool Ogre2Scene::InitObject(Ogre2ObjectPtr _object, unsigned int _id,
 //////////////////////////////////////////////////
 void Ogre2Scene::CreateContext()
 {
-  Ogre::Root *root = Ogre2RenderEngine::Instance()->OgreRoot();
+  Ogre2RenderEngine *engine = Ogre2RenderEngine::Instance();
+  Ogre::Root *root = engine->OgreRoot();
 
-  // getNumLogicalCores() may return 0 if couldn't detect
-  const size_t numThreads = std::max<size_t>(
-      1, Ogre::PlatformInformation::getNumLogicalCores());
+  // the worker threads of the scene manager split the node transform and
+  // bounds updates of updateSceneGraph and the frustum culling of each pass
+  const size_t numThreads = engine->SceneThreadCount();
 
   // See ogre doxygen documentation regarding culling methods.
   // In some cases you may still want to use single thread.
-  // if (numThreads > 1)
-  //   threadedCullingMethod = Ogre::INSTANCING_CULLING_THREADED;
+  Ogre::InstancingThreadedCullingMethod threadedCullingMethod =
+      Ogre::INSTANCING_CULLING_SINGLETHREAD;
+  if (numThreads > 1 && engine->SceneThreadedCulling())
+    threadedCullingMethod = Ogre::INSTANCING_CULLING_THREADED;
+
+  // the worker threads inherit the affinity of the thread creating them
+  const std::vector<unsigned int> &cores = engine->SceneThreadAffinity();
+#if defined(__linux__)
+  cpu_set_t previousCores;
+  bool pinned = false;
+  if (!cores.empty() && pthread_getaffinity_np(pthread_self(),
+      sizeof(previousCores), &previousCores) == 0)
+  {
+    cpu_set_t sceneCores;
+    CPU_ZERO(&sceneCores);
+    for (auto core : cores)
+    {
+      if (core < CPU_SETSIZE)
+        CPU_SET(core, &sceneCores);
+    }
+    pinned = pthread_setaffinity_np(pthread_self(), sizeof(sceneCores),
+        &sceneCores) == 0;
+    if (!pinned)
+    {
+      ignerr << "Unable to set the affinity of the threads of scene ["
+             << this->Name() << "]" << std::endl;
+    }
+  }
+#else
+  if (!cores.empty())
+  {
+    ignwarn << "Scene thread affinity is only supported on Linux"
+            << std::endl;
+  }
+#endif
+
   // Create the SceneManager, in this case a generic one
   this->ogreSceneManager = root->createSceneManager(Ogre::ST_GENERIC,
-                                                    numThreads);
+      numThreads, threadedCullingMethod);
+
+#if defined(__linux__)
+  if (pinned)
+  {
+    pthread_setaffinity_np(pthread_self(), sizeof(previousCores),
+        &previousCores);
+  }
+#endif
 
   this->ogreSceneManager->addRenderQueueListener(
       Ogre2RenderEngine::Instance()->OverlaySystem());
@@ -1286,77 +2303,765 @@ void Ogre2Scene::CreateContext()
   // enable forward plus to support multiple lights
   // this is required for non-shadow-casting point lights and
   // spot lights to work
-  this->ogreSceneManager->setForwardClustered(
-    true, 16, 8, 24, 96, 0, 0, 1, 500);
+  this->dataPtr->forwardClusteringDirty = true;
+  this->UpdateForwardClustering();
 }
 
 //////////////////////////////////////////////////
-void Ogre2Scene::CreateRootVisual()
+void Ogre2Scene::SetForwardClustering(const ForwardClusteringParams &_params)
 {
-  if (this->rootVisual)
+  if (_params.width == 0u || _params.height == 0u || _params.slices == 0u ||
+      _params.lightsPerCell == 0u)
+  {
+    ignerr << "Unable to set the Forward+ clustering: the cluster counts and "
+           << "the lights per cell must be greater than 0" << std::endl;
     return;
-
-  // create unregistered visual
-  this->rootVisual = Ogre2VisualPtr(new Ogre2Visual);
-  unsigned int rootId = this->CreateObjectId();
-  std::string rootName = this->CreateObjectName(rootId, "_ROOT_");
-
-  // check if root visual created successfully
-  if (!this->InitObject(this->rootVisual, rootId, rootName))
+  }
+  if (_params.minDistance <= 0.0f ||
+      _params.maxDistance <= _params.minDistance)
   {
-    ignerr << "Unable to create root visual" << std::endl;
-    this->rootVisual = nullptr;
+    ignerr << "Unable to set the Forward+ clustering: invalid distances ["
+           << _params.minDistance << ", " << _params.maxDistance << "]"
+           << std::endl;
     return;
   }
 
-  // add visual node to actual ogre root
-  Ogre::SceneNode *ogreRootNode = this->rootVisual->Node();
-  this->ogreSceneManager->getRootSceneNode()->addChild(ogreRootNode);
+  this->dataPtr->forwardClustering = _params;
+  this->dataPtr->forwardClusteringDirty = true;
 }
 
 //////////////////////////////////////////////////
-void Ogre2Scene::CreateMeshFactory()
+Ogre2Scene::ForwardClusteringParams Ogre2Scene::ForwardClustering() const
 {
-  Ogre2ScenePtr sharedThis = this->SharedThis();
-  this->meshFactory = Ogre2MeshFactoryPtr(new Ogre2MeshFactory(sharedThis));
+  return this->dataPtr->forwardClustering;
 }
 
 //////////////////////////////////////////////////
-void Ogre2Scene::CreateStores()
+void Ogre2Scene::SetForwardClusteringAuto(bool _enabled)
 {
-  this->lights = Ogre2LightStorePtr(new Ogre2LightStore);
-  this->sensors = Ogre2SensorStorePtr(new Ogre2SensorStore);
-  this->visuals = Ogre2VisualStorePtr(new Ogre2VisualStore);
-  this->materials = Ogre2MaterialMapPtr(new Ogre2MaterialMap);
-}
+  if (this->dataPtr->forwardClusteringAuto == _enabled)
+    return;
 
-//////////////////////////////////////////////////
-Ogre2ScenePtr Ogre2Scene::SharedThis()
-{
-  ScenePtr sharedBase = this->shared_from_this();
-  return std::dynamic_pointer_cast<Ogre2Scene>(sharedBase);
+  this->dataPtr->forwardClusteringAuto = _enabled;
+  this->dataPtr->forwardClusteringDirty = true;
 }
 
 //////////////////////////////////////////////////
-void Ogre2Scene::SetShadowsDirty(bool _dirty)
+bool Ogre2Scene::ForwardClusteringAuto() const
 {
-  this->dataPtr->shadowsDirty = _dirty;
+  return this->dataPtr->forwardClusteringAuto;
 }
 
 //////////////////////////////////////////////////
-bool Ogre2Scene::ShadowsDirty() const
+void Ogre2Scene::UpdateForwardClustering()
 {
-  return this->dataPtr->shadowsDirty;
-}
+  if (!this->ogreSceneManager)
+    return;
 
-//////////////////////////////////////////////////
-void Ogre2Scene::SetSkyEnabled(bool _enabled)
-{
-  MaterialPtr skyboxMat;
-  if (_enabled)
+  const ForwardClusteringParams &params = this->dataPtr->forwardClustering;
+  bool enabled = true;
+  unsigned int lightsPerCell = params.lightsPerCell;
+
+  if (this->dataPtr->forwardClusteringAuto)
   {
-    // get skybox material
-    std::string skyboxMatName = "Default/skybox";
+    // only recount when lights were added or removed
+    if (!this->dataPtr->forwardClusteringDirty &&
+        this->LightCount() == this->dataPtr->forwardClusteringLightCount)
+    {
+      return;
+    }
+    this->dataPtr->forwardClusteringLightCount = this->LightCount();
+
+    unsigned int count = 0u;
+    for (unsigned int i = 0u; i < this->LightCount(); ++i)
+    {
+      Ogre2LightPtr light =
+          std::dynamic_pointer_cast<Ogre2Light>(this->LightByIndex(i));
+      if (light && light->Light() &&
+          light->Light()->getType() != Ogre::Light::LT_DIRECTIONAL)
+      {
+        ++count;
+      }
+    }
+
+    // directional lights do not need clustering. Round the light count up
+    // to a power of two so that adding a few lights does not recompile
+    // the shaders every time
+    enabled = count > 0u;
+    unsigned int rounded = 8u;
+    while (rounded < count && rounded < params.lightsPerCell)
+      rounded <<= 1u;
+    lightsPerCell = std::min(rounded, params.lightsPerCell);
+
+    Ogre::ForwardPlusBase *forwardPlus =
+        this->ogreSceneManager->getForwardPlus();
+    if (!this->dataPtr->forwardClusteringDirty &&
+        (forwardPlus != nullptr) == enabled &&
+        (!forwardPlus || static_cast<Ogre::ForwardClustered *>(
+        forwardPlus)->getLightsPerCell() == lightsPerCell))
+    {
+      return;
+    }
+  }
+  else if (!this->dataPtr->forwardClusteringDirty)
+  {
+    return;
+  }
+  this->dataPtr->forwardClusteringDirty = false;
+
+  this->ogreSceneManager->setForwardClustered(enabled,
+      params.width, params.height, params.slices, lightsPerCell, 0u, 0u,
+      params.minDistance, params.maxDistance);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::CreateRootVisual()
+{
+  if (this->rootVisual)
+    return;
+
+  // create unregistered visual
+  this->rootVisual = Ogre2VisualPtr(new Ogre2Visual);
+  unsigned int rootId = this->CreateObjectId();
+  std::string rootName = this->CreateObjectName(rootId, "_ROOT_");
+
+  // check if root visual created successfully
+  if (!this->InitObject(this->rootVisual, rootId, rootName))
+  {
+    ignerr << "Unable to create root visual" << std::endl;
+    this->rootVisual = nullptr;
+    return;
+  }
+
+  // add visual node to actual ogre root
+  Ogre::SceneNode *ogreRootNode = this->rootVisual->Node();
+  this->ogreSceneManager->getRootSceneNode()->addChild(ogreRootNode);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::CreateMeshFactory()
+{
+  Ogre2ScenePtr sharedThis = this->SharedThis();
+  this->meshFactory = Ogre2MeshFactoryPtr(new Ogre2MeshFactory(sharedThis));
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::CreateStores()
+{
+  this->lights = Ogre2LightStorePtr(new Ogre2LightStore);
+  this->sensors = Ogre2SensorStorePtr(new Ogre2SensorStore);
+  this->visuals = Ogre2VisualStorePtr(new Ogre2VisualStore);
+  this->materials = Ogre2MaterialMapPtr(new Ogre2MaterialMap);
+}
+
+//////////////////////////////////////////////////
+Ogre2ScenePtr Ogre2Scene::SharedThis()
+{
+  ScenePtr sharedBase = this->shared_from_this();
+  return std::dynamic_pointer_cast<Ogre2Scene>(sharedBase);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetShadowsDirty(bool _dirty)
+{
+  this->dataPtr->shadowsDirty = _dirty;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Scene::ShadowsDirty() const
+{
+  return this->dataPtr->shadowsDirty;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::MarkLabelsDirty()
+{
+  ++this->dataPtr->labelsRevision;
+}
+
+//////////////////////////////////////////////////
+uint64_t Ogre2Scene::LabelsRevision() const
+{
+  return this->dataPtr->labelsRevision;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::MarkTemperaturesDirty()
+{
+  ++this->dataPtr->temperaturesRevision;
+}
+
+//////////////////////////////////////////////////
+uint64_t Ogre2Scene::TemperaturesRevision() const
+{
+  return this->dataPtr->temperaturesRevision;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::MarkLaserRetrosDirty()
+{
+  ++this->dataPtr->laserRetrosRevision;
+}
+
+//////////////////////////////////////////////////
+uint64_t Ogre2Scene::LaserRetrosRevision() const
+{
+  return this->dataPtr->laserRetrosRevision;
+}
+
+//////////////////////////////////////////////////
+std::weak_ptr<Ogre2LaserRetroSources> &Ogre2Scene::LaserRetroSources()
+{
+  return this->dataPtr->laserRetroSources;
+}
+
+//////////////////////////////////////////////////
+std::map<std::string, std::shared_ptr<Ogre2GpuRaysGroup>>
+    &Ogre2Scene::GpuRaysGroups()
+{
+  return this->dataPtr->gpuRaysGroups;
+}
+
+//////////////////////////////////////////////////
+Ogre2MarkerBatcher *Ogre2Scene::MarkerBatcher()
+{
+  return this->dataPtr->markerBatcher.get();
+}
+
+//////////////////////////////////////////////////
+std::vector<std::weak_ptr<Ogre2SegmentationLabelColors>> &
+    Ogre2Scene::SegmentationLabelColors()
+{
+  return this->dataPtr->segmentationLabelColors;
+}
+
+//////////////////////////////////////////////////
+std::weak_ptr<Ogre2ThermalHeatSources> &Ogre2Scene::ThermalHeatSources()
+{
+  return this->dataPtr->thermalHeatSources;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::MarkVisualIndexDirty(const Ogre2Node *_node, bool _subtree)
+{
+  if (!this->visualIndexBuilt)
+    return;
+
+  // a node is always marked with all of its ancestors, so the walk up
+  // stops at the first ancestor marked already. The node itself is passed
+  // since it may have been marked under a former parent.
+  auto &dirty = this->dataPtr->visualIndexDirty;
+  auto inserted = dirty.emplace(_node->Id(), _subtree);
+  if (!inserted.second && _subtree)
+    inserted.first->second = true;
+
+  for (const Ogre2Node *node = _node->parent.get(); node;
+      node = node->parent.get())
+  {
+    if (!dirty.emplace(node->Id(), false).second)
+      break;
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::UpdateVisualIndex()
+{
+  // the first query indexes every visual, the following ones only revisit
+  // the nodes marked since
+  if (!this->visualIndexBuilt)
+  {
+    this->dataPtr->visualIndexDirty.clear();
+    BaseScene::UpdateVisualIndex();
+    return;
+  }
+
+  if (this->dataPtr->visualIndexDirty.empty())
+    return;
+
+  IGN_PROFILE("Ogre2Scene::UpdateVisualIndex");
+  std::unordered_map<unsigned int, bool> dirty;
+  std::swap(dirty, this->dataPtr->visualIndexDirty);
+
+  const unsigned int rootId = this->RootVisual()->Id();
+  std::unordered_set<unsigned int> visited;
+  auto refresh = [&](const NodePtr &_node, bool _inGraph)
+  {
+    if (!visited.insert(_node->Id()).second)
+      return false;
+
+    VisualPtr visual = std::dynamic_pointer_cast<Visual>(_node);
+    if (visual && _inGraph)
+      this->visualIndex.Update(visual->Id(), visual->BoundingBox());
+    else if (visual)
+      this->visualIndex.Remove(visual->Id());
+    return true;
+  };
+
+  // a subtree visited before was visited whole, so it is skipped
+  std::function<void(const NodePtr &, bool)> refreshSubtree =
+      [&](const NodePtr &_node, bool _inGraph)
+  {
+    if (!refresh(_node, _inGraph))
+      return;
+
+    bool childrenInGraph = _inGraph || _node->Id() == rootId;
+    for (unsigned int i = 0; i < _node->ChildCount(); ++i)
+      refreshSubtree(_node->ChildByIndex(i), childrenInGraph);
+  };
+
+  // subtrees first, so that single nodes inside them are not revisited
+  for (bool subtree : {true, false})
+  {
+    for (const auto &entry : dirty)
+    {
+      if (entry.second != subtree)
+        continue;
+
+      NodePtr node = this->NodeById(entry.first);
+      if (!node)
+        this->visualIndex.Remove(entry.first);
+      else if (subtree)
+        refreshSubtree(node, this->InSceneGraph(node));
+      else
+        refresh(node, this->InSceneGraph(node));
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::MarkVisibilityLayersDirty()
+{
+  this->dataPtr->visibilityLayersDirty = true;
+  ++this->dataPtr->visibilityLayersRevision;
+}
+
+//////////////////////////////////////////////////
+uint64_t Ogre2Scene::VisibilityLayersRevision() const
+{
+  return this->dataPtr->visibilityLayersRevision;
+}
+
+//////////////////////////////////////////////////
+const std::vector<Ogre::Item *> &Ogre2Scene::VisibleItems(uint32_t _mask)
+{
+  if (this->dataPtr->visibilityLayersDirty)
+  {
+    for (auto &layer : this->dataPtr->visibilityLayers)
+      layer.clear();
+    this->dataPtr->maskedItems.clear();
+
+    auto it = this->ogreSceneManager->getMovableObjectIterator(
+        Ogre::ItemFactory::FACTORY_TYPE_NAME);
+    while (it.hasMoreElements())
+    {
+      Ogre::Item *item = static_cast<Ogre::Item *>(it.getNext());
+      uint32_t flags = item->getVisibilityFlags();
+      for (unsigned int bit = 0u; flags != 0u; ++bit, flags >>= 1u)
+      {
+        if (flags & 1u)
+          this->dataPtr->visibilityLayers[bit].push_back(item);
+      }
+    }
+    this->dataPtr->visibilityLayersDirty = false;
+  }
+
+  auto masked = this->dataPtr->maskedItems.find(_mask);
+  if (masked != this->dataPtr->maskedItems.end())
+    return masked->second;
+
+  // merge the layers of the mask, items on several layers are listed once
+  std::vector<Ogre::Item *> &items = this->dataPtr->maskedItems[_mask];
+  std::unordered_set<Ogre::Item *> seen;
+  for (unsigned int bit = 0u; bit < 32u; ++bit)
+  {
+    if (!(_mask & (1u << bit)))
+      continue;
+    for (Ogre::Item *item : this->dataPtr->visibilityLayers[bit])
+    {
+      if (seen.insert(item).second)
+        items.push_back(item);
+    }
+  }
+  return items;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::MarkLowLevelSubItemsDirty()
+{
+  this->dataPtr->lowLevelSubItemsDirty = true;
+}
+
+//////////////////////////////////////////////////
+const std::vector<Ogre::SubItem *> &Ogre2Scene::LowLevelSubItems()
+{
+  // items created or destroyed also change the list
+  if (!this->dataPtr->lowLevelSubItemsDirty &&
+      this->dataPtr->lowLevelSubItemsRevision ==
+      this->dataPtr->visibilityLayersRevision)
+  {
+    return this->dataPtr->lowLevelSubItems;
+  }
+
+  this->dataPtr->lowLevelSubItems.clear();
+  auto it = this->ogreSceneManager->getMovableObjectIterator(
+      Ogre::ItemFactory::FACTORY_TYPE_NAME);
+  while (it.hasMoreElements())
+  {
+    Ogre::Item *item = static_cast<Ogre::Item *>(it.getNext());
+    for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
+    {
+      Ogre::SubItem *subItem = item->getSubItem(i);
+      if (!subItem->getMaterial().isNull())
+        this->dataPtr->lowLevelSubItems.push_back(subItem);
+    }
+  }
+  this->dataPtr->lowLevelSubItemsDirty = false;
+  this->dataPtr->lowLevelSubItemsRevision =
+      this->dataPtr->visibilityLayersRevision;
+  return this->dataPtr->lowLevelSubItems;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::RegisterTextureUser(const std::string &_texture,
+    Ogre2Material *_material)
+{
+  this->dataPtr->textureUsers[_texture].insert(_material);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::UnregisterTextureUser(const std::string &_texture,
+    Ogre2Material *_material)
+{
+  auto it = this->dataPtr->textureUsers.find(_texture);
+  if (it == this->dataPtr->textureUsers.end())
+    return;
+
+  it->second.erase(_material);
+  if (it->second.empty())
+    this->dataPtr->textureUsers.erase(it);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::MaterialDestroyed(const std::string &_texture,
+    const std::string &_ogreTexture)
+{
+  this->dataPtr->materialsDestroyed = true;
+  if (!_texture.empty() && !_ogreTexture.empty())
+    this->dataPtr->destroyedTextures[_texture] = _ogreTexture;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::PreloadMeshes(const std::vector<MeshDescriptor> &_descs)
+{
+  this->meshFactory->Preload(_descs);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::PrepareMesh(const MeshDescriptor &_desc)
+{
+  BaseScene::PrepareMesh(_desc);
+  this->meshFactory->Prepare(_desc);
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2Scene::ProcessCommands()
+{
+  this->meshFactory->UploadPreparedMeshes();
+  return BaseScene::ProcessCommands();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetMeshCachePath(const std::string &_path)
+{
+  this->meshFactory->SetCachePath(_path);
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2Scene::MeshCachePath() const
+{
+  return this->meshFactory->CachePath();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetMeshLodLevelCount(unsigned int _count)
+{
+  this->meshFactory->SetLodLevelCount(_count);
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2Scene::MeshLodLevelCount() const
+{
+  return this->meshFactory->LodLevelCount();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetMeshLodDistance(double _distance)
+{
+  this->meshFactory->SetLodDistance(_distance);
+}
+
+//////////////////////////////////////////////////
+double Ogre2Scene::MeshLodDistance() const
+{
+  return this->meshFactory->LodDistance();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetMeshVertexCompression(bool _compress)
+{
+  this->meshFactory->SetVertexCompression(_compress);
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Scene::MeshVertexCompression() const
+{
+  return this->meshFactory->VertexCompression();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetAsyncTextureLoading(bool _async)
+{
+  this->dataPtr->asyncTextureLoading = _async;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Scene::AsyncTextureLoading() const
+{
+  return this->dataPtr->asyncTextureLoading;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetTextureCachePath(const std::string &_path)
+{
+  this->dataPtr->textureCachePath = _path;
+  if (!_path.empty() && !common::exists(_path) &&
+      !common::createDirectories(_path))
+  {
+    ignerr << "Unable to create texture cache directory [" << _path << "]"
+           << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2Scene::TextureCachePath() const
+{
+  return this->dataPtr->textureCachePath;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetTextureResidencyFromCameras(bool _enabled)
+{
+  this->dataPtr->textureResidencyFromCameras = _enabled;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Scene::TextureResidencyFromCameras() const
+{
+  return this->dataPtr->textureResidencyFromCameras;
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2Scene::TextureResolutionCap() const
+{
+  return this->dataPtr->textureResolutionCap;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Scene::TexturesPending()
+{
+  if (this->dataPtr->pendingTextureMaterials.empty())
+    return false;
+
+  // process the textures the worker thread finished loading in case no
+  // frame was rendered since
+  Ogre::Root *root = Ogre2RenderEngine::Instance()->OgreRoot();
+  root->getRenderSystem()->getTextureGpuManager()->_update(false);
+
+  this->UpdatePendingTextures();
+  return !this->dataPtr->pendingTextureMaterials.empty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::WaitForTextures()
+{
+  if (this->dataPtr->pendingTextureMaterials.empty())
+    return;
+
+  Ogre::Root *root = Ogre2RenderEngine::Instance()->OgreRoot();
+  root->getRenderSystem()->getTextureGpuManager()->waitForStreamingCompletion();
+
+  this->UpdatePendingTextures();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::RegisterPendingTextures(Ogre2Material *_material)
+{
+  this->dataPtr->pendingTextureMaterials.insert(_material);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::UnregisterPendingTextures(Ogre2Material *_material)
+{
+  this->dataPtr->pendingTextureMaterials.erase(_material);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::RegisterCachedTextures(Ogre2Material *_material)
+{
+  this->dataPtr->cachedTextureMaterials.insert(_material);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::UnregisterCachedTextures(Ogre2Material *_material)
+{
+  this->dataPtr->cachedTextureMaterials.erase(_material);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::UpdateTextureResidency()
+{
+  unsigned int cap = 0u;
+  if (this->dataPtr->textureResidencyFromCameras)
+  {
+    for (unsigned int i = 0; i < this->SensorCount(); ++i)
+    {
+      auto camera = std::dynamic_pointer_cast<Camera>(
+          this->SensorByIndex(i));
+      if (!camera)
+        continue;
+
+      // each unit of bias halves the resolution the camera needs
+      double size = std::max(camera->ImageWidth(), camera->ImageHeight()) *
+          std::pow(0.5, camera->TextureMipBias());
+      if (size <= 0.0)
+        continue;
+      unsigned int resolution = 1u;
+      while (resolution < size)
+        resolution *= 2u;
+      cap = std::max(cap, resolution);
+    }
+  }
+
+  if (cap == this->dataPtr->textureResolutionCap)
+    return;
+  this->dataPtr->textureResolutionCap = cap;
+
+  IGN_PROFILE("Ogre2Scene::UpdateTextureResidency");
+  std::unordered_set<std::string> replaced;
+  std::unordered_set<std::string> used;
+  auto &materials = this->dataPtr->cachedTextureMaterials;
+  for (auto it = materials.begin(); it != materials.end();)
+  {
+    if ((*it)->UpdateCachedTextures(cap, replaced, used))
+      ++it;
+    else
+      it = materials.erase(it);
+  }
+
+  // free the memory of the textures no material uses anymore
+  Ogre::Root *root = Ogre2RenderEngine::Instance()->OgreRoot();
+  Ogre::TextureGpuManager *textureManager =
+    root->getRenderSystem()->getTextureGpuManager();
+  for (const auto &name : replaced)
+  {
+    if (used.count(name) > 0u)
+      continue;
+    Ogre::TextureGpu *tex = textureManager->findTextureNoThrow(name);
+    if (tex)
+      textureManager->destroyTexture(tex);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::UpdatePendingTextures()
+{
+  auto &materials = this->dataPtr->pendingTextureMaterials;
+  for (auto it = materials.begin(); it != materials.end();)
+  {
+    if ((*it)->UpdatePendingTextures())
+      ++it;
+    else
+      it = materials.erase(it);
+  }
+}
+
+//////////////////////////////////////////////////
+Ogre2MeshFactoryPtr Ogre2Scene::MeshFactory() const
+{
+  return this->meshFactory;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::CleanupDestroyedMaterials()
+{
+  if (!this->dataPtr->materialsDestroyed)
+    return;
+
+  Ogre::Root *root = Ogre2RenderEngine::Instance()->OgreRoot();
+  Ogre::TextureGpuManager *textureManager =
+    root->getRenderSystem()->getTextureGpuManager();
+
+  Ogre2RenderEngine::Instance()->ResetTextureBudgets();
+
+  // destroy the released shared datablocks no longer used by a renderable
+  auto &released = this->dataPtr->releasedDatablocks;
+  for (auto it = released.begin(); it != released.end();)
+  {
+    if (!(*it)->getLinkedRenderables().empty())
+    {
+      ++it;
+      continue;
+    }
+    (*it)->getCreator()->destroyDatablock((*it)->getName());
+    it = released.erase(it);
+  }
+
+  for (const auto &[texture, ogreTexture] : this->dataPtr->destroyedTextures)
+  {
+    // keep the texture if a material using it is in use by a renderable
+    bool textureInUse = false;
+    auto it = this->dataPtr->textureUsers.find(texture);
+    if (it != this->dataPtr->textureUsers.end())
+    {
+      for (auto material : it->second)
+      {
+        Ogre::HlmsPbsDatablock *datablock = material->Datablock();
+        if (datablock && !datablock->getLinkedRenderables().empty())
+        {
+          textureInUse = true;
+          break;
+        }
+      }
+    }
+    if (textureInUse)
+      continue;
+
+    Ogre::TextureGpu *tex = textureManager->findTextureNoThrow(ogreTexture);
+    if (tex)
+    {
+      this->ClearMaterialsCache(texture);
+      textureManager->destroyTexture(tex);
+    }
+  }
+  this->dataPtr->destroyedTextures.clear();
+
+  this->ogreSceneManager->shrinkToFitMemoryPools();
+
+  Ogre::VaoManager *vaoManager = textureManager->getVaoManager();
+  vaoManager->cleanupEmptyPools();
+
+  // check the datablocks still in use again at the end of the next frame
+  this->dataPtr->materialsDestroyed = !released.empty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetSkyEnabled(bool _enabled)
+{
+  MaterialPtr skyboxMat;
+  if (_enabled)
+  {
+    // get skybox material
+    std::string skyboxMatName = "Default/skybox";
     skyboxMat = this->Material(skyboxMatName);
     if (!skyboxMat)
     {
@@ -1385,3 +3090,15 @@ bool Ogre2Scene::SkyEnabled() const
 {
   return this->dataPtr->skyEnabled;
 }
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetSkyHorizonCulling(bool _enabled)
+{
+  this->dataPtr->skyHorizonCulling = _enabled;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Scene::SkyHorizonCulling() const
+{
+  return this->dataPtr->skyHorizonCulling;
+}
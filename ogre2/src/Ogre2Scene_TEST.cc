@@ -0,0 +1,861 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Mesh.hh>
+#include <ignition/common/MeshManager.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/DirectionalLight.hh"
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/PixelFormat.hh"
+#include "ignition/rendering/PointLight.hh"
+#include "ignition/rendering/SpotLight.hh"
+#include "ignition/rendering/ogre2/Ogre2Light.hh"
+#include "ignition/rendering/ogre2/Ogre2Material.hh"
+#include "ignition/rendering/ogre2/Ogre2Mesh.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Hlms/Pbs/OgreHlmsPbsDatablock.h>
+#include <Compositor/OgreCompositorManager2.h>
+#include <Compositor/OgreCompositorShadowNodeDef.h>
+#include <OgreBitwise.h>
+#include <OgreForwardClustered.h>
+#include <OgreItem.h>
+#include <OgreMesh2.h>
+#include <OgreMeshManager2.h>
+#include <OgrePixelFormatGpuUtils.h>
+#include <OgreRoot.h>
+#include <OgreSceneManager.h>
+#include <OgreSubMesh2.h>
+#include <OgreTextureGpu.h>
+#include <Vao/OgreVertexArrayObject.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+class Ogre2SceneTest : public testing::Test
+{
+  // Documentation inherited
+  protected: void SetUp() override
+  {
+    common::Console::SetVerbosity(4);
+    Ogre2RenderEngine *instance = Ogre2RenderEngine::Instance();
+    if (instance->Load(std::map<std::string, std::string>()) &&
+        instance->Init())
+    {
+      this->engine = instance;
+    }
+  }
+
+  /// \brief Create an ogre2 scene
+  /// \param[in] _name Name of the scene
+  /// \return The scene
+  protected: Ogre2ScenePtr CreateScene(const std::string &_name)
+  {
+    return std::dynamic_pointer_cast<Ogre2Scene>(
+        this->engine->CreateScene(_name));
+  }
+
+  /// \brief Get the number of vertices of the ogre mesh drawn by a mesh
+  /// \param[in] _mesh Mesh
+  /// \return Number of vertices of all its submeshes
+  protected: static size_t VertexCount(MeshPtr _mesh)
+  {
+    Ogre2MeshPtr ogreMesh = std::dynamic_pointer_cast<Ogre2Mesh>(_mesh);
+    auto item = ogreMesh ?
+        dynamic_cast<Ogre::Item *>(ogreMesh->OgreObject()) : nullptr;
+    if (!item)
+      return 0u;
+
+    size_t count = 0u;
+    for (const Ogre::SubMesh *subMesh : item->getMesh()->getSubMeshes())
+    {
+      for (const Ogre::VertexArrayObject *vao : subMesh->mVao[Ogre::VpNormal])
+        count += vao->getVertexBuffers()[0]->getNumElements();
+    }
+    return count;
+  }
+
+  /// \brief Get the vertex positions of the ogre mesh drawn by a mesh,
+  /// decoding half float positions of compressed meshes
+  /// \param[in] _mesh Mesh
+  /// \param[out] _halfPositions True if the positions are stored as half
+  /// floats
+  /// \return Positions of the vertices of all its submeshes
+  protected: static std::vector<math::Vector3d> VertexPositions(
+      MeshPtr _mesh, bool &_halfPositions)
+  {
+    std::vector<math::Vector3d> positions;
+    _halfPositions = false;
+    Ogre2MeshPtr ogreMesh = std::dynamic_pointer_cast<Ogre2Mesh>(_mesh);
+    auto item = ogreMesh ?
+        dynamic_cast<Ogre::Item *>(ogreMesh->OgreObject()) : nullptr;
+    if (!item)
+      return positions;
+
+    for (const Ogre::SubMesh *subMesh : item->getMesh()->getSubMeshes())
+    {
+      for (Ogre::VertexArrayObject *vao : subMesh->mVao[Ogre::VpNormal])
+      {
+        Ogre::VertexArrayObject::ReadRequestsVec requests;
+        requests.push_back(
+            Ogre::VertexArrayObject::ReadRequests(Ogre::VES_POSITION));
+        vao->readRequests(requests);
+        vao->mapAsyncTickets(requests);
+        Ogre::VertexArrayObject::ReadRequests &request = requests[0];
+        _halfPositions = request.type == Ogre::VET_HALF4;
+        size_t vertexCount = request.vertexBuffer->getNumElements();
+        size_t stride = request.vertexBuffer->getBytesPerElement();
+        for (size_t i = 0u; i < vertexCount; ++i)
+        {
+          const char *data = request.data + i * stride;
+          math::Vector3d p;
+          for (size_t j = 0u; j < 3u; ++j)
+          {
+            if (_halfPositions)
+            {
+              p[j] = Ogre::Bitwise::halfToFloat(
+                  reinterpret_cast<const uint16_t *>(data)[j]);
+            }
+            else
+            {
+              p[j] = reinterpret_cast<const float *>(data)[j];
+            }
+          }
+          positions.push_back(p);
+        }
+        vao->unmapAsyncTickets(requests);
+      }
+    }
+    return positions;
+  }
+
+  /// \brief The ogre2 render engine, null if it failed to load
+  protected: Ogre2RenderEngine *engine = nullptr;
+
+  /// \brief Path to the test media
+  protected: const std::string TEST_MEDIA_PATH =
+      common::joinPaths(std::string(PROJECT_SOURCE_PATH), "test", "media");
+};
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2SceneTest, AsyncTextureLoading)
+{
+  if (!this->engine)
+  {
+    igndbg << "Engine 'ogre2' is not supported" << std::endl;
+    return;
+  }
+
+  Ogre2ScenePtr scene = this->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  EXPECT_FALSE(scene->AsyncTextureLoading());
+  scene->SetAsyncTextureLoading(true);
+  EXPECT_TRUE(scene->AsyncTextureLoading());
+
+  // the texture is only scheduled to be loaded
+  Ogre2MaterialPtr material =
+      std::dynamic_pointer_cast<Ogre2Material>(scene->CreateMaterial());
+  ASSERT_NE(nullptr, material);
+  material->SetTexture(common::joinPaths(TEST_MEDIA_PATH, "materials",
+      "textures", "texture.png"));
+  Ogre::TextureGpu *texture =
+      material->Datablock()->getTexture(Ogre::PBSM_DIFFUSE);
+  ASSERT_NE(nullptr, texture);
+  EXPECT_EQ(Ogre::GpuResidency::Resident, texture->getNextResidencyStatus());
+
+  // and is resident with its data uploaded once the scene waited for it
+  scene->WaitForTextures();
+  EXPECT_FALSE(scene->TexturesPending());
+  EXPECT_EQ(Ogre::GpuResidency::Resident, texture->getResidencyStatus());
+  EXPECT_TRUE(texture->isDataReady());
+  EXPECT_EQ(texture, material->Datablock()->getTexture(Ogre::PBSM_DIFFUSE));
+
+  this->engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2SceneTest, PreloadMeshes)
+{
+  if (!this->engine)
+  {
+    igndbg << "Engine 'ogre2' is not supported" << std::endl;
+    return;
+  }
+
+  Ogre2ScenePtr scene = this->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  common::MeshManager::Instance()->CreateSphere("preload_sphere", 1.0f,
+      16, 16);
+  MeshDescriptor desc("preload_sphere");
+
+  // name the mesh factory gives the ogre mesh of a whole, uncentered mesh
+  const std::string ogreName = "preload_sphere::::ORIGINAL";
+  Ogre::MeshManager &meshMgr = Ogre::MeshManager::getSingleton();
+  EXPECT_FALSE(meshMgr.getByName(ogreName));
+
+  scene->PreloadMeshes({desc});
+  Ogre::MeshPtr ogreMesh = meshMgr.getByName(ogreName);
+  ASSERT_TRUE(ogreMesh);
+  EXPECT_TRUE(ogreMesh->isLoaded());
+  auto countMeshes = [&meshMgr]()
+  {
+    unsigned int count = 0u;
+    auto it = meshMgr.getResourceIterator();
+    for (; it.hasMoreElements(); it.moveNext())
+      ++count;
+    return count;
+  };
+  unsigned int meshCount = countMeshes();
+
+  // the mesh created afterwards uses the preloaded ogre mesh, no mesh is
+  // loaded or created
+  MeshPtr mesh = scene->CreateMesh(desc);
+  ASSERT_NE(nullptr, mesh);
+  auto item = dynamic_cast<Ogre::Item *>(
+      std::dynamic_pointer_cast<Ogre2Mesh>(mesh)->OgreObject());
+  ASSERT_NE(nullptr, item);
+  EXPECT_EQ(ogreMesh.get(), item->getMesh().get());
+  EXPECT_EQ(meshCount, countMeshes());
+
+  this->engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2SceneTest, MeshCache)
+{
+  if (!this->engine)
+  {
+    igndbg << "Engine 'ogre2' is not supported" << std::endl;
+    return;
+  }
+
+  const std::string testDir = common::joinPaths(
+      std::string(PROJECT_BUILD_PATH), "test", "ogre2_mesh_cache");
+  const std::string cacheDir = common::joinPaths(testDir, "cache");
+  common::removeAll(testDir);
+  ASSERT_TRUE(common::createDirectories(cacheDir));
+
+  // a textured quad, written to two files of identical content
+  const std::string quad =
+      "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+      "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\nvn 0 0 1\n"
+      "f 1/1/1 2/2/1 3/3/1\nf 1/1/1 3/3/1 4/4/1\n";
+  const std::string file = common::joinPaths(testDir, "quad.obj");
+  const std::string copy = common::joinPaths(testDir, "quad_copy.obj");
+  std::ofstream(file) << quad;
+  std::ofstream(copy) << quad;
+
+  auto cacheFileCount = [&cacheDir]()
+  {
+    unsigned int count = 0u;
+    for (common::DirIter it(cacheDir); it != common::DirIter(); ++it)
+      ++count;
+    return count;
+  };
+
+  const common::Mesh *commonMesh = common::MeshManager::Instance()->Load(file);
+  ASSERT_NE(nullptr, commonMesh);
+
+  // the first scene converts the mesh and writes it to the cache
+  Ogre2ScenePtr scene = this->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetMeshCachePath(cacheDir);
+  EXPECT_EQ(cacheDir, scene->MeshCachePath());
+  MeshPtr mesh = scene->CreateMesh(MeshDescriptor(commonMesh));
+  ASSERT_NE(nullptr, mesh);
+  size_t vertexCount = VertexCount(mesh);
+  EXPECT_GT(vertexCount, 0u);
+  EXPECT_EQ(1u, cacheFileCount());
+  this->engine->DestroyScene(scene);
+
+  // the second scene loads the mesh from the cache, with the same vertices
+  scene = this->CreateScene("scene2");
+  ASSERT_NE(nullptr, scene);
+  scene->SetMeshCachePath(cacheDir);
+  mesh = scene->CreateMesh(MeshDescriptor(commonMesh));
+  ASSERT_NE(nullptr, mesh);
+  EXPECT_EQ(vertexCount, VertexCount(mesh));
+  EXPECT_EQ(1u, cacheFileCount());
+
+  // the same content at another path has a cache file of its own
+  const common::Mesh *copyMesh = common::MeshManager::Instance()->Load(copy);
+  ASSERT_NE(nullptr, copyMesh);
+  MeshPtr copyOfMesh = scene->CreateMesh(MeshDescriptor(copyMesh));
+  ASSERT_NE(nullptr, copyOfMesh);
+  EXPECT_EQ(vertexCount, VertexCount(copyOfMesh));
+  EXPECT_EQ(2u, cacheFileCount());
+
+  this->engine->DestroyScene(scene);
+  common::removeAll(testDir);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2SceneTest, StaticShadows)
+{
+  if (!this->engine)
+  {
+    igndbg << "Engine 'ogre2' is not supported" << std::endl;
+    return;
+  }
+
+  Ogre2ScenePtr scene = this->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetAmbientLight(0.3, 0.3, 0.3);
+  VisualPtr root = scene->RootVisual();
+
+  // downward looking camera
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(10);
+  camera->SetImageHeight(10);
+  camera->SetLocalRotation(0, 1.57, 0);
+  root->AddChild(camera);
+
+  // downward directional light with a cached shadow map
+  DirectionalLightPtr light = scene->CreateDirectionalLight();
+  light->SetDirection(0.0, 0.0, -1);
+  light->SetDiffuseColor(0.5, 0.5, 0.5);
+  light->SetSpecularColor(0.5, 0.5, 0.5);
+  light->SetCastShadows(true);
+  Ogre2LightPtr ogreLight = std::dynamic_pointer_cast<Ogre2Light>(light);
+  ASSERT_NE(nullptr, ogreLight);
+  ogreLight->SetStaticShadows(true);
+  EXPECT_TRUE(ogreLight->StaticShadows());
+  root->AddChild(light);
+
+  // static box casting a shadow on the left half of the image
+  MaterialPtr white = scene->CreateMaterial();
+  white->SetDiffuse(1.0, 1.0, 1.0);
+  white->SetCastShadows(true);
+  VisualPtr caster = scene->CreateVisual();
+  caster->AddGeometry(scene->CreateBox());
+  caster->SetStatic(true);
+  caster->SetLocalPosition(0.0, 0.5, 0.55);
+  caster->SetMaterial(white, false);
+  root->AddChild(caster);
+
+  // box receiving the shadow
+  MaterialPtr green = scene->CreateMaterial();
+  green->SetDiffuse(0.0, 0.7, 0.0);
+  VisualPtr receiver = scene->CreateVisual();
+  receiver->AddGeometry(scene->CreateBox());
+  receiver->SetLocalPosition(0.0, 0.0, -1.0);
+  receiver->SetMaterial(green);
+  root->AddChild(receiver);
+
+  // sums of the pixel values of the left and right halves of the image
+  Image image = camera->CreateImage();
+  auto capture = [&]()
+  {
+    camera->Capture(image);
+    unsigned int bpp = PixelUtil::BytesPerPixel(camera->ImageFormat());
+    unsigned int step = camera->ImageWidth() * bpp;
+    const unsigned char *data = image.Data<unsigned char>();
+    std::pair<unsigned int, unsigned int> sums(0u, 0u);
+    for (unsigned int i = 0; i < camera->ImageHeight(); ++i)
+    {
+      for (unsigned int j = 0; j < step; j += bpp)
+      {
+        unsigned int idx = i * step + j;
+        unsigned int value = data[idx] + data[idx + 1] + data[idx + 2];
+        if (j < step / 2)
+          sums.first += value;
+        else
+          sums.second += value;
+      }
+    }
+    return sums;
+  };
+
+  auto sums = capture();
+  EXPECT_LT(sums.first, sums.second);
+
+  // the shadow map is not rendered again while nothing marks it dirty, so
+  // the shadow outlives the shadow casting of the box
+  white->SetCastShadows(false);
+  caster->SetMaterial(white, false);
+  sums = capture();
+  EXPECT_LT(sums.first, sums.second);
+  sums = capture();
+  EXPECT_LT(sums.first, sums.second);
+
+  // moving the static box refreshes the shadow map, the shadow moves to
+  // the right half
+  white->SetCastShadows(true);
+  caster->SetMaterial(white, false);
+  caster->SetLocalPosition(0.0, -0.5, 0.55);
+  sums = capture();
+  EXPECT_GT(sums.first, sums.second);
+
+  this->engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2SceneTest, MeshVertexCompression)
+{
+  if (!this->engine)
+  {
+    igndbg << "Engine 'ogre2' is not supported" << std::endl;
+    return;
+  }
+
+  Ogre2ScenePtr scene = this->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  EXPECT_FALSE(scene->MeshVertexCompression());
+
+  // two identical spheres. Compression only applies to the ogre meshes
+  // imported after it is enabled, so each sphere gets a name of its own.
+  common::MeshManager *meshManager = common::MeshManager::Instance();
+  meshManager->CreateSphere("full_sphere", 1.0f, 16, 16);
+  meshManager->CreateSphere("half_sphere", 1.0f, 16, 16);
+
+  MeshPtr full = scene->CreateMesh(MeshDescriptor("full_sphere"));
+  ASSERT_NE(nullptr, full);
+  scene->SetMeshVertexCompression(true);
+  EXPECT_TRUE(scene->MeshVertexCompression());
+  MeshPtr half = scene->CreateMesh(MeshDescriptor("half_sphere"));
+  ASSERT_NE(nullptr, half);
+
+  bool fullHalfPositions = true;
+  std::vector<math::Vector3d> fullPositions =
+      VertexPositions(full, fullHalfPositions);
+  bool halfHalfPositions = false;
+  std::vector<math::Vector3d> halfPositions =
+      VertexPositions(half, halfHalfPositions);
+  EXPECT_FALSE(fullHalfPositions);
+  EXPECT_TRUE(halfHalfPositions);
+
+  // the compressed sphere has the same vertices, up to the precision of
+  // half floats
+  ASSERT_FALSE(fullPositions.empty());
+  ASSERT_EQ(fullPositions.size(), halfPositions.size());
+  const double tol = 1e-3;
+  for (size_t i = 0u; i < fullPositions.size(); ++i)
+  {
+    EXPECT_NEAR(fullPositions[i].X(), halfPositions[i].X(), tol);
+    EXPECT_NEAR(fullPositions[i].Y(), halfPositions[i].Y(), tol);
+    EXPECT_NEAR(fullPositions[i].Z(), halfPositions[i].Z(), tol);
+  }
+
+  // and the same bounds
+  auto fullItem = dynamic_cast<Ogre::Item *>(
+      std::dynamic_pointer_cast<Ogre2Mesh>(full)->OgreObject());
+  auto halfItem = dynamic_cast<Ogre::Item *>(
+      std::dynamic_pointer_cast<Ogre2Mesh>(half)->OgreObject());
+  ASSERT_NE(nullptr, fullItem);
+  ASSERT_NE(nullptr, halfItem);
+  Ogre::Aabb fullBounds = fullItem->getMesh()->getAabb();
+  Ogre::Aabb halfBounds = halfItem->getMesh()->getAabb();
+  for (size_t i = 0u; i < 3u; ++i)
+  {
+    EXPECT_NEAR(fullBounds.getMinimum()[i], halfBounds.getMinimum()[i], tol);
+    EXPECT_NEAR(fullBounds.getMaximum()[i], halfBounds.getMaximum()[i], tol);
+  }
+
+  this->engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2SceneTest, ForwardClustering)
+{
+  if (!this->engine)
+  {
+    igndbg << "Engine 'ogre2' is not supported" << std::endl;
+    return;
+  }
+
+  Ogre2ScenePtr scene = this->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  EXPECT_FALSE(scene->ForwardClusteringAuto());
+
+  auto forwardClustered = [&scene]()
+  {
+    return dynamic_cast<Ogre::ForwardClustered *>(
+        scene->OgreSceneManager()->getForwardPlus());
+  };
+
+  // the scene is created with the default clustering
+  Ogre2Scene::ForwardClusteringParams defaults = scene->ForwardClustering();
+  Ogre::ForwardClustered *clustered = forwardClustered();
+  ASSERT_NE(nullptr, clustered);
+  EXPECT_EQ(defaults.width, clustered->getWidth());
+  EXPECT_EQ(defaults.height, clustered->getHeight());
+  EXPECT_EQ(defaults.slices, clustered->getNumSlices());
+  EXPECT_EQ(defaults.lightsPerCell, clustered->getLightsPerCell());
+  EXPECT_FLOAT_EQ(defaults.minDistance, clustered->getMinDistance());
+  EXPECT_FLOAT_EQ(defaults.maxDistance, clustered->getMaxDistance());
+
+  // invalid parameters are rejected
+  Ogre2Scene::ForwardClusteringParams params;
+  params.slices = 0u;
+  scene->SetForwardClustering(params);
+  EXPECT_EQ(defaults.slices, scene->ForwardClustering().slices);
+  params = Ogre2Scene::ForwardClusteringParams();
+  params.maxDistance = params.minDistance;
+  scene->SetForwardClustering(params);
+  EXPECT_FLOAT_EQ(defaults.maxDistance, scene->ForwardClustering().maxDistance);
+
+  // new parameters apply on the next frame
+  params = Ogre2Scene::ForwardClusteringParams();
+  params.width = 8u;
+  params.height = 4u;
+  params.slices = 32u;
+  params.lightsPerCell = 64u;
+  params.minDistance = 0.5f;
+  params.maxDistance = 2000.0f;
+  scene->SetForwardClustering(params);
+  EXPECT_EQ(params.slices, scene->ForwardClustering().slices);
+  scene->PreRender();
+  clustered = forwardClustered();
+  ASSERT_NE(nullptr, clustered);
+  EXPECT_EQ(params.width, clustered->getWidth());
+  EXPECT_EQ(params.height, clustered->getHeight());
+  EXPECT_EQ(params.slices, clustered->getNumSlices());
+  EXPECT_EQ(params.lightsPerCell, clustered->getLightsPerCell());
+  EXPECT_FLOAT_EQ(params.minDistance, clustered->getMinDistance());
+  EXPECT_FLOAT_EQ(params.maxDistance, clustered->getMaxDistance());
+
+  // automatic clustering turns clustering off without point lights
+  scene->SetForwardClusteringAuto(true);
+  EXPECT_TRUE(scene->ForwardClusteringAuto());
+  scene->CreateDirectionalLight();
+  scene->PreRender();
+  EXPECT_EQ(nullptr, scene->OgreSceneManager()->getForwardPlus());
+
+  // and lists the point lights rounded up to a power of two, at least 8
+  VisualPtr root = scene->RootVisual();
+  auto addPointLights = [&](unsigned int _count)
+  {
+    for (unsigned int i = 0u; i < _count; ++i)
+      root->AddChild(scene->CreatePointLight());
+  };
+  addPointLights(3u);
+  scene->PreRender();
+  clustered = forwardClustered();
+  ASSERT_NE(nullptr, clustered);
+  EXPECT_EQ(8u, clustered->getLightsPerCell());
+  EXPECT_EQ(params.slices, clustered->getNumSlices());
+
+  addPointLights(10u);
+  scene->PreRender();
+  clustered = forwardClustered();
+  ASSERT_NE(nullptr, clustered);
+  EXPECT_EQ(16u, clustered->getLightsPerCell());
+
+  // up to the lights per cell of the parameters
+  addPointLights(100u);
+  scene->PreRender();
+  clustered = forwardClustered();
+  ASSERT_NE(nullptr, clustered);
+  EXPECT_EQ(params.lightsPerCell, clustered->getLightsPerCell());
+
+  // the parameters apply again as is once automatic clustering is off
+  scene->SetForwardClusteringAuto(false);
+  scene->PreRender();
+  clustered = forwardClustered();
+  ASSERT_NE(nullptr, clustered);
+  EXPECT_EQ(params.lightsPerCell, clustered->getLightsPerCell());
+
+  this->engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2SceneTest, MaxShadowMaps)
+{
+  if (!this->engine)
+  {
+    igndbg << "Engine 'ogre2' is not supported" << std::endl;
+    return;
+  }
+
+  Ogre2ScenePtr scene = this->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  EXPECT_EQ(25u, scene->MaxShadowMaps());
+  EXPECT_EQ(2048u, scene->ShadowTextureSize());
+  EXPECT_FALSE(scene->ShadowResolutionByDistance());
+  VisualPtr root = scene->RootVisual();
+
+  // shadow node built by the scene on the next frame
+  auto shadowNode = [&scene]()
+  {
+    scene->PreRender();
+    Ogre::CompositorManager2 *compositorManager =
+        Ogre2RenderEngine::Instance()->OgreRoot()->getCompositorManager2();
+    return compositorManager->getShadowNodeDefinition(
+        "PbsMaterialsShadowNode");
+  };
+
+  // heights of the shadow map atlases
+  auto atlasHeights = [&shadowNode]()
+  {
+    std::vector<unsigned int> heights;
+    for (const auto &texDef : shadowNode()->getTextureDefinitions())
+      heights.push_back(texDef.height);
+    return heights;
+  };
+
+  // spot lights take a shadow map each, up to the limit
+  for (unsigned int i = 0u; i < 12u; ++i)
+  {
+    SpotLightPtr light = scene->CreateSpotLight();
+    ASSERT_NE(nullptr, light);
+    light->SetCastShadows(true);
+    light->SetLocalPosition(i * 1.0, 0.0, 2.0);
+    root->AddChild(light);
+  }
+  EXPECT_EQ(12u, shadowNode()->getNumShadowTextureDefinitions());
+
+  scene->SetMaxShadowMaps(5u);
+  EXPECT_EQ(5u, scene->MaxShadowMaps());
+  EXPECT_EQ(5u, shadowNode()->getNumShadowTextureDefinitions());
+
+  // a directional light takes 3 of them, one per split
+  DirectionalLightPtr sun = scene->CreateDirectionalLight();
+  ASSERT_NE(nullptr, sun);
+  sun->SetCastShadows(true);
+  root->AddChild(sun);
+  EXPECT_EQ(5u, shadowNode()->getNumShadowTextureDefinitions());
+  scene->DestroyLight(sun);
+
+  // raising the limit gives all lights their shadow maps back
+  scene->SetMaxShadowMaps(40u);
+  EXPECT_EQ(12u, shadowNode()->getNumShadowTextureDefinitions());
+
+  // the shadow maps use the texture size, four per row of an atlas of at
+  // most 8192 pixels
+  scene->SetMaxShadowMaps(8u);
+  scene->SetShadowTextureSize(1000u);
+  EXPECT_EQ(2048u, scene->ShadowTextureSize());
+  EXPECT_EQ(std::vector<unsigned int>({4096u}), atlasHeights());
+  scene->SetShadowTextureSize(1024u);
+  EXPECT_EQ(1024u, scene->ShadowTextureSize());
+  EXPECT_EQ(std::vector<unsigned int>({1024u}), atlasHeights());
+
+  // by distance, a quarter of the maps keep the full size, another quarter
+  // gets half of it and the rest a quarter, each size in an atlas of its
+  // own
+  scene->SetShadowTextureSize(2048u);
+  scene->SetShadowResolutionByDistance(true);
+  EXPECT_TRUE(scene->ShadowResolutionByDistance());
+  EXPECT_EQ(8u, shadowNode()->getNumShadowTextureDefinitions());
+  EXPECT_EQ(std::vector<unsigned int>({2048u, 1024u, 512u}),
+      atlasHeights());
+
+  this->engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2SceneTest, TextureCache)
+{
+  if (!this->engine)
+  {
+    igndbg << "Engine 'ogre2' is not supported" << std::endl;
+    return;
+  }
+
+  const std::string testDir = common::joinPaths(
+      std::string(PROJECT_BUILD_PATH), "test", "ogre2_texture_cache");
+  const std::string cacheDir = common::joinPaths(testDir, "cache");
+  common::removeAll(testDir);
+  ASSERT_TRUE(common::createDirectories(cacheDir));
+
+  const std::string texture = common::joinPaths(TEST_MEDIA_PATH,
+      "materials", "textures", "texture.png");
+  const std::string normalMap = common::joinPaths(TEST_MEDIA_PATH,
+      "materials", "textures", "flat_normal.png");
+
+  auto cacheFileCount = [&cacheDir]()
+  {
+    unsigned int count = 0u;
+    for (common::DirIter it(cacheDir); it != common::DirIter(); ++it)
+      ++count;
+    return count;
+  };
+
+  // texture of a material, once its data is loaded
+  auto materialTexture = [](MaterialPtr _material,
+      Ogre::PbsTextureTypes _type)
+  {
+    Ogre2MaterialPtr material =
+        std::dynamic_pointer_cast<Ogre2Material>(_material);
+    Ogre::TextureGpu *tex = material ?
+        material->Datablock()->getTexture(_type) : nullptr;
+    if (tex)
+      tex->waitForData();
+    return tex;
+  };
+
+  // the first scene converts the textures and writes them to the cache,
+  // one file per texture
+  Ogre2ScenePtr scene = this->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  EXPECT_TRUE(scene->TextureCachePath().empty());
+  scene->SetTextureCachePath(cacheDir);
+  EXPECT_EQ(cacheDir, scene->TextureCachePath());
+
+  MaterialPtr material = scene->CreateMaterial();
+  ASSERT_NE(nullptr, material);
+  material->SetTexture(texture);
+  material->SetNormalMap(normalMap);
+  EXPECT_EQ(2u, cacheFileCount());
+
+  // and the material draws them block compressed
+  Ogre::TextureGpu *diffuse =
+      materialTexture(material, Ogre::PBSM_DIFFUSE);
+  ASSERT_NE(nullptr, diffuse);
+  EXPECT_TRUE(Ogre::PixelFormatGpuUtils::isCompressed(
+      diffuse->getPixelFormat()));
+  EXPECT_GT(diffuse->getNumMipmaps(), 1u);
+  Ogre::TextureGpu *normal = materialTexture(material, Ogre::PBSM_NORMAL);
+  ASSERT_NE(nullptr, normal);
+  EXPECT_TRUE(Ogre::PixelFormatGpuUtils::isCompressed(
+      normal->getPixelFormat()));
+  this->engine->DestroyScene(scene);
+
+  // the second scene loads the textures from the cache, the same content
+  // at another path uses the same cache file
+  const std::string copy = common::joinPaths(testDir, "texture_copy.png");
+  ASSERT_TRUE(common::copyFile(texture, copy));
+  scene = this->CreateScene("scene2");
+  ASSERT_NE(nullptr, scene);
+  scene->SetTextureCachePath(cacheDir);
+  material = scene->CreateMaterial();
+  material->SetTexture(copy);
+  EXPECT_EQ(2u, cacheFileCount());
+  diffuse = materialTexture(material, Ogre::PBSM_DIFFUSE);
+  ASSERT_NE(nullptr, diffuse);
+  EXPECT_TRUE(Ogre::PixelFormatGpuUtils::isCompressed(
+      diffuse->getPixelFormat()));
+  this->engine->DestroyScene(scene);
+
+  // without a cache the textures are loaded uncompressed
+  scene = this->CreateScene("scene3");
+  ASSERT_NE(nullptr, scene);
+  material = scene->CreateMaterial();
+  material->SetTexture(texture);
+  diffuse = materialTexture(material, Ogre::PBSM_DIFFUSE);
+  ASSERT_NE(nullptr, diffuse);
+  EXPECT_FALSE(Ogre::PixelFormatGpuUtils::isCompressed(
+      diffuse->getPixelFormat()));
+  EXPECT_EQ(2u, cacheFileCount());
+
+  this->engine->DestroyScene(scene);
+  common::removeAll(testDir);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2SceneTest, SceneThreadedCulling)
+{
+  if (!this->engine)
+  {
+    igndbg << "Engine 'ogre2' is not supported" << std::endl;
+    return;
+  }
+
+  const unsigned int threadCount = this->engine->SceneThreadCount();
+  const bool threadedCulling = this->engine->SceneThreadedCulling();
+  EXPECT_FALSE(threadedCulling);
+
+  // render a grid of boxes, some of them outside of the view, and return
+  // the image
+  auto render = [this](const std::string &_name)
+  {
+    Ogre2ScenePtr scene = this->CreateScene(_name);
+    std::vector<unsigned char> pixels;
+    if (!scene)
+      return pixels;
+    EXPECT_EQ(this->engine->SceneThreadCount(),
+        scene->OgreSceneManager()->getNumWorkerThreads());
+    scene->SetAmbientLight(0.3, 0.3, 0.3);
+    VisualPtr root = scene->RootVisual();
+
+    DirectionalLightPtr light = scene->CreateDirectionalLight();
+    light->SetDirection(0.5, 0.5, -1.0);
+    light->SetDiffuseColor(0.8, 0.8, 0.8);
+    root->AddChild(light);
+
+    MaterialPtr material = scene->CreateMaterial();
+    material->SetDiffuse(0.2, 0.6, 0.9);
+    for (int i = -5; i <= 5; ++i)
+    {
+      for (int j = -5; j <= 5; ++j)
+      {
+        VisualPtr box = scene->CreateVisual();
+        box->AddGeometry(scene->CreateBox());
+        box->SetMaterial(material, false);
+        box->SetLocalPosition(i * 2.0, j * 2.0, 0.0);
+        box->SetLocalScale(0.5 + 0.05 * (i + 5), 0.5, 0.5 + 0.05 * (j + 5));
+        root->AddChild(box);
+      }
+    }
+
+    CameraPtr camera = scene->CreateCamera();
+    camera->SetImageWidth(64);
+    camera->SetImageHeight(48);
+    camera->SetLocalPosition(-4.0, 0.0, 3.0);
+    camera->SetLocalRotation(0.0, 0.4, 0.0);
+    root->AddChild(camera);
+
+    Image image = camera->CreateImage();
+    camera->Capture(image);
+    const unsigned char *data = image.Data<unsigned char>();
+    pixels.assign(data, data + camera->ImageMemorySize());
+    this->engine->DestroyScene(scene);
+    return pixels;
+  };
+
+  // single threaded culling
+  this->engine->SetSceneThreadCount(4u);
+  std::vector<unsigned char> expected = render("scene");
+  ASSERT_FALSE(expected.empty());
+
+  // threaded culling renders the same image
+  this->engine->SetSceneThreadedCulling(true);
+  EXPECT_TRUE(this->engine->SceneThreadedCulling());
+  std::vector<unsigned char> threaded = render("scene2");
+  EXPECT_EQ(expected, threaded);
+
+  // as does a single scene thread, which never culls in parallel
+  this->engine->SetSceneThreadCount(1u);
+  EXPECT_EQ(expected, render("scene3"));
+
+  this->engine->SetSceneThreadedCulling(threadedCulling);
+  this->engine->SetSceneThreadCount(threadCount);
+}
@@ -15,9 +15,11 @@
  *
  */
 
+#include <cstring>
 #include <string>
 
 #include <ignition/common/Console.hh>
+#include <ignition/common/Profiler.hh>
 #include <ignition/math/Color.hh>
 
 #include "ignition/rendering/ogre2/Ogre2Camera.hh"
@@ -32,6 +34,7 @@
 #include "ignition/rendering/RenderTypes.hh"
 #include "ignition/rendering/Utils.hh"
 
+#include "Ogre2OcclusionCuller.hh"
 #include "Ogre2SegmentationMaterialSwitcher.hh"
 
 /// \brief Private data for the Ogre2SegmentationCamera class
@@ -52,6 +55,31 @@ class ignition::rendering::Ogre2SegmentationCameraPrivate
   /// \brief Output texture
   public: Ogre::TextureGpu *ogreSegmentationTexture {nullptr};
 
+  /// \brief Label id map texture, rendered together with the colored map
+  /// in the same scene pass. Only created when colored map is enabled
+  public: Ogre::TextureGpu *ogreLabelTexture {nullptr};
+
+  /// \brief Staging ticket for reading back ogreSegmentationTexture
+  public: Ogre::AsyncTextureTicket *segmentationTicket {nullptr};
+
+  /// \brief Staging ticket for reading back ogreLabelTexture
+  public: Ogre::AsyncTextureTicket *labelTicket {nullptr};
+
+  /// \brief True if the textures were downloaded into the tickets during
+  /// the last render and are waiting to be mapped in PostRender
+  public: bool downloadPending = false;
+
+  /// \brief True if the workspace renders the colored map and the label id
+  /// map
+  public: bool coloredMapWorkspace = false;
+
+  /// \brief Label id map read back from ogreLabelTexture
+  public: uint8_t *labelBuffer {nullptr};
+
+  /// \brief True if labelBuffer holds the label id map of the current
+  /// colored map frame
+  public: bool labelBufferValid = false;
+
   /// \brief Dummy render texture for the depth data
   public: RenderTexturePtr segmentationTexture {nullptr};
 
@@ -108,25 +136,67 @@ void Ogre2SegmentationCamera::Destroy()
     this->dataPtr->buffer = nullptr;
   }
 
+  if (this->dataPtr->labelBuffer)
+  {
+    delete [] this->dataPtr->labelBuffer;
+    this->dataPtr->labelBuffer = nullptr;
+  }
+
   if (!this->ogreCamera)
     return;
 
-  auto engine = Ogre2RenderEngine::Instance();
-  auto ogreRoot = engine->OgreRoot();
-  auto ogreCompMgr = ogreRoot->getCompositorManager2();
+  this->DestroySegmentationTexture();
 
-  if (this->dataPtr->ogreSegmentationTexture)
+  Ogre::SceneManager *ogreSceneManager;
+  ogreSceneManager = this->scene->OgreSceneManager();
+  if (ogreSceneManager == nullptr)
   {
-    ogreRoot->getRenderSystem()->getTextureGpuManager()->destroyTexture(
-      this->dataPtr->ogreSegmentationTexture);
-    this->dataPtr->ogreSegmentationTexture = nullptr;
+    ignerr << "Scene manager cannot be obtained" << std::endl;
+  }
+  else
+  {
+    if (ogreSceneManager->findCameraNoThrow(this->name) != nullptr)
+    {
+      ogreSceneManager->destroyCamera(this->ogreCamera);
+      this->ogreCamera = nullptr;
+    }
+  }
+
+  this->dataPtr->materialSwitcher.reset();
+}
 
+/////////////////////////////////////////////////
+void Ogre2SegmentationCamera::PreRender()
+{
+  IGN_PROFILE("Ogre2SegmentationCamera::PreRender");
+  // the colored map is rendered with a different workspace
+  if (this->dataPtr->ogreSegmentationTexture &&
+      this->dataPtr->coloredMapWorkspace != this->IsColoredMap())
+  {
+    this->DestroySegmentationTexture();
   }
+
+  if (!this->dataPtr->ogreSegmentationTexture)
+    this->CreateSegmentationTexture();
+
+  this->ogreCamera->setLodBias(this->LodBias());
+}
+
+/////////////////////////////////////////////////
+void Ogre2SegmentationCamera::DestroySegmentationTexture()
+{
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  auto ogreCompMgr = ogreRoot->getCompositorManager2();
+  Ogre::TextureGpuManager *textureMgr =
+    ogreRoot->getRenderSystem()->getTextureGpuManager();
+
   if (this->dataPtr->ogreCompositorWorkspace)
   {
     ogreCompMgr->removeWorkspace(
         this->dataPtr->ogreCompositorWorkspace);
     this->dataPtr->ogreCompositorWorkspace = nullptr;
+    this->ogreCamera->removeListener(this->dataPtr->materialSwitcher.get());
   }
 
   if (!this->dataPtr->ogreCompositorWorkspaceDef.empty())
@@ -135,31 +205,36 @@ void Ogre2SegmentationCamera::Destroy()
         this->dataPtr->ogreCompositorWorkspaceDef);
     ogreCompMgr->removeNodeDefinition(
         this->dataPtr->ogreCompositorNodeDef);
+    this->dataPtr->ogreCompositorWorkspaceDef.clear();
+    this->dataPtr->ogreCompositorNodeDef.clear();
   }
 
-  Ogre::SceneManager *ogreSceneManager;
-  ogreSceneManager = this->scene->OgreSceneManager();
-  if (ogreSceneManager == nullptr)
+  if (this->dataPtr->segmentationTicket)
   {
-    ignerr << "Scene manager cannot be obtained" << std::endl;
+    textureMgr->destroyAsyncTextureTicket(this->dataPtr->segmentationTicket);
+    this->dataPtr->segmentationTicket = nullptr;
   }
-  else
+
+  if (this->dataPtr->labelTicket)
   {
-    if (ogreSceneManager->findCameraNoThrow(this->name) != nullptr)
-    {
-      ogreSceneManager->destroyCamera(this->ogreCamera);
-      this->ogreCamera = nullptr;
-    }
+    textureMgr->destroyAsyncTextureTicket(this->dataPtr->labelTicket);
+    this->dataPtr->labelTicket = nullptr;
   }
 
-  this->dataPtr->materialSwitcher.reset();
-}
+  if (this->dataPtr->ogreSegmentationTexture)
+  {
+    textureMgr->destroyTexture(this->dataPtr->ogreSegmentationTexture);
+    this->dataPtr->ogreSegmentationTexture = nullptr;
+  }
 
-/////////////////////////////////////////////////
-void Ogre2SegmentationCamera::PreRender()
-{
-  if (!this->dataPtr->ogreSegmentationTexture)
-    this->CreateSegmentationTexture();
+  if (this->dataPtr->ogreLabelTexture)
+  {
+    textureMgr->destroyTexture(this->dataPtr->ogreLabelTexture);
+    this->dataPtr->ogreLabelTexture = nullptr;
+  }
+
+  this->dataPtr->downloadPending = false;
+  this->dataPtr->labelBufferValid = false;
 }
 
 /////////////////////////////////////////////////
@@ -214,8 +289,71 @@ void Ogre2SegmentationCamera::CreateSegmentationTexture()
   auto backgroundColor_ = Ogre2Conversions::Convert(
       this->backgroundColor);
 
+  this->dataPtr->coloredMapWorkspace = this->IsColoredMap();
+
   std::string wsDefName = "SegmentationCameraWorkspace_" + this->Name();
-  ogreCompMgr->createBasicWorkspaceDef(wsDefName, backgroundColor_);
+  std::string nodeDefName = wsDefName + "/Node";
+  if (this->dataPtr->coloredMapWorkspace)
+  {
+    // Render the colored map and the label id map to two render targets in a
+    // single scene pass, so users that need both don't have to render twice
+    //
+    // compositor_node SegmentationCameraWorkspace_<name>/Node
+    // {
+    //   in 0 rt0
+    //   in 1 rt1
+    //   target mrt (rt0 rt1)
+    //   {
+    //     pass render_scene
+    //     {
+    //       load
+    //       {
+    //         all clear
+    //         clear_colour 0 <background color>
+    //         clear_colour 1 <background label>
+    //       }
+    //     }
+    //   }
+    // }
+    Ogre::CompositorNodeDef *nodeDef =
+        ogreCompMgr->addNodeDefinition(nodeDefName);
+    nodeDef->addTextureSourceName(
+        "rt0", 0u, Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+    nodeDef->addTextureSourceName(
+        "rt1", 1u, Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+
+    Ogre::RenderTargetViewDef *rtv = nodeDef->addRenderTextureView("mrt");
+    rtv->colourAttachments.resize(2u);
+    rtv->colourAttachments[0].textureName = "rt0";
+    rtv->colourAttachments[1].textureName = "rt1";
+    rtv->depthBufferId = Ogre::DepthBuffer::POOL_DEFAULT;
+    rtv->depthBufferFormat = Ogre::PFG_D32_FLOAT;
+
+    nodeDef->setNumTargetPass(1);
+    Ogre::CompositorTargetDef *targetDef = nodeDef->addTargetPass("mrt");
+    targetDef->setNumPasses(1);
+    Ogre::CompositorPassSceneDef *passScene =
+        static_cast<Ogre::CompositorPassSceneDef *>(
+        targetDef->addPass(Ogre::PASS_SCENE));
+    // unlit pass, skip building the Forward+ light clusters
+    passScene->mEnableForwardPlus = false;
+    passScene->setAllLoadActions(Ogre::LoadAction::Clear);
+    passScene->mClearColour[0] = backgroundColor_;
+    float backgroundLabel8bit = (this->backgroundLabel % 256) / 255.0;
+    passScene->mClearColour[1] = Ogre::ColourValue(backgroundLabel8bit,
+        backgroundLabel8bit, backgroundLabel8bit, 1.0);
+
+    Ogre::CompositorWorkspaceDef *wsDef =
+        ogreCompMgr->addWorkspaceDefinition(wsDefName);
+    wsDef->connectExternal(0, nodeDefName, 0);
+    wsDef->connectExternal(1, nodeDefName, 1);
+  }
+  else
+  {
+    ogreCompMgr->createBasicWorkspaceDef(wsDefName, backgroundColor_);
+  }
+  this->dataPtr->ogreCompositorWorkspaceDef = wsDefName;
+  this->dataPtr->ogreCompositorNodeDef = nodeDefName;
 
   Ogre::TextureGpuManager *textureMgr =
     ogreRoot->getRenderSystem()->getTextureGpuManager();
@@ -233,14 +371,51 @@ void Ogre2SegmentationCamera::CreateSegmentationTexture()
   this->dataPtr->ogreSegmentationTexture->scheduleTransitionTo(
     Ogre::GpuResidency::Resident);
 
+  // staging ticket used to read back the segmentation texture without
+  // stalling right after rendering
+  this->dataPtr->segmentationTicket = textureMgr->createAsyncTextureTicket(
+      this->ImageWidth(), this->ImageHeight(), 1u,
+      Ogre::TextureTypes::Type2D, ogrePF);
+
+  Ogre::CompositorChannelVec externalTargets(1u);
+  externalTargets[0] = this->dataPtr->ogreSegmentationTexture;
+
+  if (this->dataPtr->coloredMapWorkspace)
+  {
+    this->dataPtr->ogreLabelTexture =
+      textureMgr->createOrRetrieveTexture(this->Name() + "_segmentation_label",
+        Ogre::GpuPageOutStrategy::SaveToSystemRam,
+        Ogre::TextureFlags::RenderToTexture,
+        Ogre::TextureTypes::Type2D);
+
+    this->dataPtr->ogreLabelTexture->setResolution(
+        this->ImageWidth(), this->ImageHeight());
+    this->dataPtr->ogreLabelTexture->setNumMipmaps(1u);
+    this->dataPtr->ogreLabelTexture->setPixelFormat(ogrePF);
+    this->dataPtr->ogreLabelTexture->scheduleTransitionTo(
+      Ogre::GpuResidency::Resident);
+
+    this->dataPtr->labelTicket = textureMgr->createAsyncTextureTicket(
+        this->ImageWidth(), this->ImageHeight(), 1u,
+        Ogre::TextureTypes::Type2D, ogrePF);
+
+    externalTargets.push_back(this->dataPtr->ogreLabelTexture);
+  }
+
   // create compositor worksspace
   this->dataPtr->ogreCompositorWorkspace =
       ogreCompMgr->addWorkspace(
         this->scene->OgreSceneManager(),
-        this->dataPtr->ogreSegmentationTexture,
+        externalTargets,
         this->ogreCamera,
         wsDefName,
         false);
+  this->AddPassProfilers(this->dataPtr->ogreCompositorWorkspace);
+  if (this->OcclusionCuller())
+  {
+    this->dataPtr->ogreCompositorWorkspace->addListener(
+        this->OcclusionCuller());
+  }
 
   this->ogreCamera->addListener(
     this->dataPtr->materialSwitcher.get());
@@ -249,9 +424,16 @@ void Ogre2SegmentationCamera::CreateSegmentationTexture()
 /////////////////////////////////////////////////
 void Ogre2SegmentationCamera::PostRender()
 {
-  // return if no one is listening to the new frame
-  if (this->dataPtr->newSegmentationFrame.ConnectionCount() == 0)
+  IGN_PROFILE("Ogre2SegmentationCamera::PostRender");
+  // return if no one is listening to the new frame, or if the textures
+  // were not downloaded
+  if (this->dataPtr->newSegmentationFrame.ConnectionCount() == 0 ||
+      !this->dataPtr->downloadPending)
+  {
+    this->RecordFrameDropped();
     return;
+  }
+  this->dataPtr->downloadPending = false;
 
   const auto width = this->ImageWidth();
   const auto height = this->ImageHeight();
@@ -262,39 +444,58 @@ void Ogre2SegmentationCamera::PostRender()
   const auto bytesPerChannel = PixelUtil::BytesPerChannel(format);
   const auto bufferSize = len * channelCount * bytesPerChannel;
 
-  Ogre::Image2 image;
-  image.convertFromTexture(this->dataPtr->ogreSegmentationTexture, 0u, 0u);
-  Ogre::TextureBox box = image.getData(0);
+  // copy the RGBA texture data to an RGB buffer
+  auto copyToBuffer = [&](const Ogre::TextureBox &_box, uint8_t *_buffer)
+  {
+    const uint8_t *bufferTmp = static_cast<const uint8_t *>(_box.data);
+    const auto rawChannelCount = 4u;
+    for (unsigned int row = 0; row < height; ++row)
+    {
+      unsigned int rawDataRowIdx = row * _box.bytesPerRow / bytesPerChannel;
+      for (unsigned int column = 0; column < width; ++column)
+      {
+        unsigned int idx = (row * width * channelCount) +
+            column * channelCount;
+        unsigned int rawIdx = rawDataRowIdx +
+            column * rawChannelCount;
+
+        _buffer[idx] = bufferTmp[rawIdx];
+        _buffer[idx + 1] = bufferTmp[rawIdx + 1];
+        _buffer[idx + 2] = bufferTmp[rawIdx + 2];
+      }
+    }
+  };
 
   if (!this->dataPtr->buffer)
   {
     this->dataPtr->buffer = new uint8_t[bufferSize];
   }
-
-  uint8_t *bufferTmp = static_cast<uint8_t*>(box.data);
-
-  auto rawChannelCount = 4u;
-
-  for (unsigned int row = 0; row < height; ++row)
+  // mapping waits for the GPU to finish the frame and the download
+  Ogre::TextureBox box = this->dataPtr->segmentationTicket->map(0u);
+  this->RecordFrameGpuComplete();
+  copyToBuffer(box, this->dataPtr->buffer);
+  this->dataPtr->segmentationTicket->unmap();
+
+  // the label id map was rendered in the same pass as the colored map
+  this->dataPtr->labelBufferValid = false;
+  if (this->dataPtr->labelTicket)
   {
-    unsigned int rawDataRowIdx = row * box.bytesPerRow / bytesPerChannel;
-    for (unsigned int column = 0; column < width; ++column)
-    {
-      unsigned int idx = (row * width * channelCount) +
-          column * channelCount;
-      unsigned int rawIdx = rawDataRowIdx +
-          column * rawChannelCount;
-
-      this->dataPtr->buffer[idx] = bufferTmp[rawIdx];
-      this->dataPtr->buffer[idx + 1] = bufferTmp[rawIdx + 1];
-      this->dataPtr->buffer[idx + 2] = bufferTmp[rawIdx + 2];
-    }
+    if (!this->dataPtr->labelBuffer)
+      this->dataPtr->labelBuffer = new uint8_t[bufferSize];
+    copyToBuffer(this->dataPtr->labelTicket->map(0u),
+        this->dataPtr->labelBuffer);
+    this->dataPtr->labelTicket->unmap();
+    this->dataPtr->labelBufferValid = true;
   }
 
+  this->RecordFrameReadback();
+  IGN_PROFILE_BEGIN("Dispatch newSegmentationFrame");
   this->dataPtr->newSegmentationFrame(
     this->dataPtr->buffer,
     width, height, channelCount,
     PixelUtil::Name(format));
+  IGN_PROFILE_END();
+  this->RecordFrameDelivered();
 }
 
 /////////////////////////////////////////////////
@@ -309,6 +510,10 @@ ignition::common::ConnectionPtr
 /////////////////////////////////////////////////
 void Ogre2SegmentationCamera::Render()
 {
+  IGN_PROFILE("Ogre2SegmentationCamera::Render");
+  this->RecordFrameSubmit();
+  this->BeginPassProfilers();
+
   // update the compositors
   this->scene->StartRendering(nullptr);
 
@@ -321,6 +526,20 @@ void Ogre2SegmentationCamera::Render()
   swappedTargets.reserve(2u);
   this->dataPtr->ogreCompositorWorkspace->_swapFinalTarget(swappedTargets);
 
+  // queue the readback of both maps right after rendering, so the transfers
+  // overlap and PostRender only waits for them once
+  if (this->dataPtr->newSegmentationFrame.ConnectionCount() > 0u)
+  {
+    this->dataPtr->segmentationTicket->download(
+        this->dataPtr->ogreSegmentationTexture, 0u, true);
+    if (this->dataPtr->labelTicket)
+    {
+      this->dataPtr->labelTicket->download(
+          this->dataPtr->ogreLabelTexture, 0u, true);
+    }
+    this->dataPtr->downloadPending = true;
+  }
+
   this->scene->FlushGpuCommandsAndStartNewFrame(1u, false);
 }
 
@@ -358,11 +577,18 @@ void Ogre2SegmentationCamera::LabelMapFromColoredBuffer(
   if (!this->dataPtr->buffer)
     return;
 
-  auto colorToLabel = this->dataPtr->materialSwitcher->ColorToLabel();
-
   auto width = this->ImageWidth();
   auto height = this->ImageHeight();
 
+  // the label id map was already rendered alongside the colored map
+  if (this->dataPtr->labelBufferValid)
+  {
+    memcpy(_labelBuffer, this->dataPtr->labelBuffer, width * height * 3);
+    return;
+  }
+
+  const auto &colorToLabel = this->dataPtr->materialSwitcher->ColorToLabel();
+
   for (uint32_t i = 0; i < height; ++i)
   {
     for (uint32_t j = 0; j < width; ++j)
@@ -414,3 +640,40 @@ void Ogre2SegmentationCamera::LabelMapFromColoredBuffer(
     }
   }
 }
+
+/////////////////////////////////////////////////
+void Ogre2SegmentationCamera::SemanticLabelMap(uint8_t *_labelBuffer) const
+{
+  if (!this->dataPtr->buffer)
+    return;
+
+  auto width = this->ImageWidth();
+  auto height = this->ImageHeight();
+  auto size = width * height * 3;
+
+  // the label id map of the colored map is converted in place, it is
+  // rendered in the same pass as the colored map so usually just copied
+  const uint8_t *labelMap = this->dataPtr->buffer;
+  if (this->isColoredMap)
+  {
+    this->LabelMapFromColoredBuffer(_labelBuffer);
+    labelMap = _labelBuffer;
+  }
+
+  if (this->type == SegmentationType::ST_SEMANTIC)
+  {
+    if (labelMap != _labelBuffer)
+      memcpy(_labelBuffer, labelMap, size);
+    return;
+  }
+
+  // the panoptic label id map holds the instance count in the first two
+  // channels and the label in the last one
+  for (uint32_t index = 0; index < size; index += 3)
+  {
+    uint8_t label = labelMap[index + 2];
+    _labelBuffer[index] = label;
+    _labelBuffer[index + 1] = label;
+    _labelBuffer[index + 2] = label;
+  }
+}
@@ -18,16 +18,22 @@
 #include "Ogre2SegmentationMaterialSwitcher.hh"
 
 #include <algorithm>
+#include <memory>
 #include <utility>
 #include <vector>
 
 #include <ignition/common/Console.hh>
+#include <ignition/common/Profiler.hh>
 
 #include "ignition/rendering/ogre2/Ogre2Heightmap.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
 #include "ignition/rendering/ogre2/Ogre2Scene.hh"
 #include "ignition/rendering/ogre2/Ogre2Visual.hh"
 #include "ignition/rendering/RenderTypes.hh"
 
+#include "Ogre2MaterialOverride.hh"
+#include "Ogre2VertexDeformation.hh"
+
 #ifdef _MSC_VER
   #pragma warning(push, 0)
 #endif
@@ -58,22 +64,11 @@ Ogre2SegmentationMaterialSwitcher::Ogre2SegmentationMaterialSwitcher(
   this->plainMaterial = res.staticCast<Ogre::Material>();
   this->plainMaterial->load();
 
-  // plain overlay material
-  this->plainOverlayMaterial =
-      this->plainMaterial->clone("plain_color_overlay");
-  if (!this->plainOverlayMaterial->getTechnique(0) ||
-      !this->plainOverlayMaterial->getTechnique(0)->getPass(0))
-  {
-    ignerr << "Problem creating selection buffer overlay material"
-        << std::endl;
-    return;
-  }
-  Ogre::Pass *overlayPass =
-      this->plainOverlayMaterial->getTechnique(0)->getPass(0);
-  Ogre::HlmsMacroblock macroblock(*overlayPass->getMacroblock());
-  macroblock.mDepthCheck = false;
-  macroblock.mDepthWrite = false;
-  overlayPass->setMacroblock(macroblock);
+  // colored map material, writes both the colored and label id maps
+  res = Ogre::MaterialManager::getSingleton().load("SegmentationColoredMap",
+      Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+  this->coloredMapMaterial = res.staticCast<Ogre::Material>();
+  this->coloredMapMaterial->load();
 }
 
 /////////////////////////////////////////////////
@@ -83,7 +78,88 @@ Ogre2SegmentationMaterialSwitcher::~Ogre2SegmentationMaterialSwitcher()
 }
 
 /////////////////////////////////////////////////
-bool Ogre2SegmentationMaterialSwitcher::IsTakenColor(const math::Color &_color)
+Ogre2SegmentationLabelColors::Ogre2SegmentationLabelColors(
+  Ogre2ScenePtr _scene, const SegmentationCamera *_camera)
+{
+  this->scene = _scene;
+  this->segmentationType = _camera->Type();
+  this->coloredMap = _camera->IsColoredMap();
+  this->backgroundLabel = _camera->BackgroundLabel();
+  this->backgroundColor = _camera->BackgroundColor();
+  this->parameterIndex = Ogre2MaterialOverride::NewParameterIndex();
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<Ogre2SegmentationLabelColors>
+Ogre2SegmentationLabelColors::Shared(Ogre2ScenePtr _scene,
+    const SegmentationCamera *_camera)
+{
+  // label colors are released when the last segmentation camera using them
+  // is destroyed or changes its settings
+  auto &sceneLabelColors = _scene->SegmentationLabelColors();
+  std::shared_ptr<Ogre2SegmentationLabelColors> labelColors;
+  for (auto it = sceneLabelColors.begin(); it != sceneLabelColors.end();)
+  {
+    auto colors = it->lock();
+    if (!colors)
+    {
+      it = sceneLabelColors.erase(it);
+      continue;
+    }
+    if (!labelColors && colors->Matches(_camera))
+      labelColors = colors;
+    ++it;
+  }
+
+  if (!labelColors)
+  {
+    labelColors =
+        std::make_shared<Ogre2SegmentationLabelColors>(_scene, _camera);
+    sceneLabelColors.push_back(labelColors);
+  }
+  return labelColors;
+}
+
+/////////////////////////////////////////////////
+bool Ogre2SegmentationLabelColors::Matches(
+    const SegmentationCamera *_camera) const
+{
+  return this->segmentationType == _camera->Type() &&
+      this->coloredMap == _camera->IsColoredMap() &&
+      this->backgroundLabel == _camera->BackgroundLabel() &&
+      this->backgroundColor == _camera->BackgroundColor();
+}
+
+/////////////////////////////////////////////////
+void Ogre2SegmentationLabelColors::Update()
+{
+  if (this->ItemColorsDirty())
+    this->AssignItemColors();
+}
+
+/////////////////////////////////////////////////
+const std::unordered_map<Ogre::Item *,
+    Ogre2SegmentationLabelColors::ItemColor>
+    &Ogre2SegmentationLabelColors::ItemColors() const
+{
+  return this->itemColors;
+}
+
+/////////////////////////////////////////////////
+const std::unordered_map<int64_t, int64_t> &
+Ogre2SegmentationLabelColors::ColorToLabel() const
+{
+  return this->colorToLabel;
+}
+
+/////////////////////////////////////////////////
+size_t Ogre2SegmentationLabelColors::ParameterIndex() const
+{
+  return this->parameterIndex;
+}
+
+/////////////////////////////////////////////////
+bool Ogre2SegmentationLabelColors::IsTakenColor(const math::Color &_color)
 {
   // Get the int value of the 24 bit color
   // Multiply by 255 as color values are normalized
@@ -102,11 +178,11 @@ bool Ogre2SegmentationMaterialSwitcher::IsTakenColor(const math::Color &_color)
 }
 
 /////////////////////////////////////////////////
-math::Color Ogre2SegmentationMaterialSwitcher::LabelToColor(int64_t _label,
+math::Color Ogre2SegmentationLabelColors::LabelToColor(int64_t _label,
   bool _isMultiLink)
 {
-  if (_label == this->segmentationCamera->BackgroundLabel())
-    return this->segmentationCamera->BackgroundColor();
+  if (_label == this->backgroundLabel)
+    return this->backgroundColor;
 
   // use label as seed to generate the same color for the label
   this->generator.seed(_label);
@@ -122,7 +198,7 @@ math::Color Ogre2SegmentationMaterialSwitcher::LabelToColor(int64_t _label,
   // if the label is colored before return the color
   // don't check for taken colors in that case, all items
   // with the same label will have the same color
-  if (this->segmentationCamera->Type() == SegmentationType::ST_SEMANTIC &&
+  if (this->segmentationType == SegmentationType::ST_SEMANTIC &&
     this->coloredLabel.count(_label))
     return color;
 
@@ -143,7 +219,7 @@ math::Color Ogre2SegmentationMaterialSwitcher::LabelToColor(int64_t _label,
 }
 
 ////////////////////////////////////////////////
-VisualPtr Ogre2SegmentationMaterialSwitcher::TopLevelModelVisual(
+VisualPtr Ogre2SegmentationLabelColors::TopLevelModelVisual(
     VisualPtr _visual) const
 {
   if (!_visual)
@@ -155,11 +231,18 @@ VisualPtr Ogre2SegmentationMaterialSwitcher::TopLevelModelVisual(
 }
 
 ////////////////////////////////////////////////
-void Ogre2SegmentationMaterialSwitcher::cameraPreRenderScene(
-    Ogre::Camera * /*_cam*/)
+bool Ogre2SegmentationLabelColors::ItemColorsDirty() const
+{
+  return !this->itemColorsAssigned ||
+      this->labelsRevision != this->scene->LabelsRevision() ||
+      this->itemsRevision != this->scene->VisibilityLayersRevision();
+}
+
+////////////////////////////////////////////////
+void Ogre2SegmentationLabelColors::AssignItemColors()
 {
   this->colorToLabel.clear();
-  this->datablockMap.clear();
+  this->itemColors.clear();
   auto itor = this->scene->OgreSceneManager()->getMovableObjectIterator(
       Ogre::ItemFactory::FACTORY_TYPE_NAME);
 
@@ -218,16 +301,22 @@ void Ogre2SegmentationMaterialSwitcher::cameraPreRenderScene(
       catch(std::bad_variant_access &e)
       {
         // items with no class are considered background
-        label = this->segmentationCamera->BackgroundLabel();
+        label = this->backgroundLabel;
       }
 
       // sub item custom parameter to set the pixel color material
       Ogre::Vector4 customParameter;
 
+      // label id encoded as a color, rendered to the label id map alongside
+      // the colored map. Matches the output of LabelMapFromColoredBuffer
+      Ogre::Vector4 labelParameter;
+      float label8bit = (label % 256) / 255.0;
+      float backgroundLabel8bit = (this->backgroundLabel % 256) / 255.0;
+
       // Material Switching
-      if (this->segmentationCamera->Type() == SegmentationType::ST_SEMANTIC)
+      if (this->segmentationType == SegmentationType::ST_SEMANTIC)
       {
-        if (this->segmentationCamera->IsColoredMap())
+        if (this->coloredMap)
         {
           // semantic material (each pixel has item's color)
           math::Color color = this->LabelToColor(label);
@@ -241,8 +330,9 @@ void Ogre2SegmentationMaterialSwitcher::cameraPreRenderScene(
           customParameter = Ogre::Vector4(
             labelColor, labelColor, labelColor, 1.0);
         }
+        labelParameter = Ogre::Vector4(label8bit, label8bit, label8bit, 1.0);
       }
-      else if (this->segmentationCamera->Type() ==
+      else if (this->segmentationType ==
           SegmentationType::ST_PANOPTIC)
       {
         auto itemName = visual->Name();
@@ -267,13 +357,13 @@ void Ogre2SegmentationMaterialSwitcher::cameraPreRenderScene(
 
         int instanceCount = it->second;
 
-        if (this->segmentationCamera->IsColoredMap())
+        if (this->coloredMap)
         {
           // convert 24 bit number to int64
           int compositeId = label * 256 * 256 + instanceCount;
 
           math::Color color;
-          if (label == this->segmentationCamera->BackgroundLabel())
+          if (label == this->backgroundLabel)
             color = this->LabelToColor(label, isMultiLink);
           else
             color = this->LabelToColor(compositeId, isMultiLink);
@@ -291,26 +381,40 @@ void Ogre2SegmentationMaterialSwitcher::cameraPreRenderScene(
           customParameter = Ogre::Vector4(
             instanceColor2, instanceColor1, labelColor, 1.0);
         }
-      }
-
-      for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
-      {
-        // save subitems material
-        Ogre::SubItem *subItem = item->getSubItem(i);
-        Ogre::HlmsDatablock *datablock = subItem->getDatablock();
-        this->datablockMap[subItem] = datablock;
-
-        // switch the material
-        subItem->setCustomParameter(1, customParameter);
 
-        // check if it's an overlay material by assuming the
-        // depth check and depth write properties are off.
-        if (!datablock->getMacroblock()->mDepthWrite &&
-            !datablock->getMacroblock()->mDepthCheck)
-          subItem->setMaterial(this->plainOverlayMaterial);
+        // unlabeled items have the background color in the colored map,
+        // which doesn't map to any instance
+        if (label == this->backgroundLabel)
+        {
+          labelParameter = Ogre::Vector4(backgroundLabel8bit,
+              backgroundLabel8bit, backgroundLabel8bit, 1.0);
+        }
         else
-          subItem->setMaterial(this->plainMaterial);
+        {
+          int instanceCount16bit = instanceCount % (256 * 256);
+          labelParameter = Ogre::Vector4(
+              (instanceCount16bit % 256) / 255.0,
+              (instanceCount16bit / 256) / 255.0, label8bit, 1.0);
+        }
       }
+
+      ItemColor &itemColor = this->itemColors[item];
+      itemColor.visualId = visualId;
+      itemColor.color = customParameter;
+      itemColor.label = labelParameter;
+
+      // the colored map value carries the label to the label id map
+      Ogre::Vector4 value = customParameter;
+      if (this->coloredMap)
+        value.w = Ogre2MaterialOverride::PackLabel(labelParameter);
+      for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
+        item->getSubItem(i)->setCustomParameter(this->parameterIndex, value);
+    }
+    else
+    {
+      // items that no longer belong to a visual are drawn as background
+      for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
+        item->getSubItem(i)->removeCustomParameter(this->parameterIndex);
     }
   }
 
@@ -319,6 +423,104 @@ void Ogre2SegmentationMaterialSwitcher::cameraPreRenderScene(
   this->takenColors.clear();
   this->coloredLabel.clear();
 
+  this->itemColorsAssigned = true;
+  this->labelsRevision = this->scene->LabelsRevision();
+  this->itemsRevision = this->scene->VisibilityLayersRevision();
+}
+
+////////////////////////////////////////////////
+void Ogre2SegmentationMaterialSwitcher::cameraPreRenderScene(
+    Ogre::Camera * /*_cam*/)
+{
+  IGN_PROFILE("Ogre2SegmentationMaterialSwitcher::cameraPreRenderScene");
+  // get the colors shared by segmentation cameras with the same settings
+  if (!this->labelColors ||
+      !this->labelColors->Matches(this->segmentationCamera))
+  {
+    this->labelColors = Ogre2SegmentationLabelColors::Shared(this->scene,
+        this->segmentationCamera);
+  }
+
+  // only reassign colors if the scene changed, sorting the items and looking
+  // up the label of each visual is expensive in large scenes
+  this->labelColors->Update();
+
+  // the Pbs and Unlit hlms draw their items with the colors stored on the
+  // sub items. Items keep their macroblocks, so overlays are still drawn on
+  // top. The colored map is rendered together with the label id map. Items
+  // without a visual are drawn as background
+  bool coloredMap = this->segmentationCamera->IsColoredMap();
+  math::Color background = this->segmentationCamera->BackgroundColor();
+  Ogre::Vector4 defaultValue(background.R(), background.G(), background.B(),
+      1.0);
+  if (coloredMap)
+  {
+    float backgroundLabel8bit =
+        (this->segmentationCamera->BackgroundLabel() % 256) / 255.0;
+    defaultValue.w = Ogre2MaterialOverride::PackLabel(Ogre::Vector4(
+        backgroundLabel8bit, backgroundLabel8bit, backgroundLabel8bit, 1.0));
+  }
+  // the hlms only write the label id map with OpenGL, other render
+  // systems draw the colored map with the low level material instead
+  auto engine = Ogre2RenderEngine::Instance();
+  const bool hlmsOverride = !coloredMap ||
+      engine->GraphicsAPI() == rendering::GraphicsAPI::OPENGL;
+  if (hlmsOverride)
+  {
+    engine->MaterialOverride().Begin(coloredMap ?
+        Ogre2MaterialOverrideMode::LABEL : Ogre2MaterialOverrideMode::SOLID,
+        this->labelColors->ParameterIndex(), defaultValue);
+  }
+
+  this->materialMap.clear();
+  this->datablockMap.clear();
+  const auto &itemColors = this->labelColors->ItemColors();
+  if (!hlmsOverride)
+  {
+    // every sub item is switched to the colored map material. Vertices
+    // deformed by a custom vertex shader are drawn deformed
+    for (const auto &[item, itemColor] : itemColors)
+    {
+      for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
+      {
+        Ogre::SubItem *subItem = item->getSubItem(i);
+        if (subItem->getMaterial().isNull())
+          this->datablockMap[subItem] = subItem->getDatablock();
+        else
+          this->materialMap[subItem] = subItem->getMaterial();
+        subItem->setCustomParameter(1, itemColor.color);
+        subItem->setCustomParameter(2, itemColor.label);
+        subItem->setMaterial(
+            DeformedMaterial(this->coloredMapMaterial, subItem));
+      }
+    }
+  }
+  else
+  {
+    // sub items with low level materials, which those hlms don't draw, are
+    // switched to the segmentation materials. Vertices deformed by a custom
+    // vertex shader are drawn deformed
+    for (Ogre::SubItem *subItem : this->scene->LowLevelSubItems())
+    {
+      auto it = itemColors.find(subItem->getParent());
+      if (it == itemColors.end())
+        continue;
+
+      this->materialMap[subItem] = subItem->getMaterial();
+      subItem->setCustomParameter(1, it->second.color);
+      if (coloredMap)
+      {
+        subItem->setCustomParameter(2, it->second.label);
+        subItem->setMaterial(
+            DeformedMaterial(this->coloredMapMaterial, subItem));
+      }
+      else
+      {
+        subItem->setMaterial(DeformedMaterial(this->plainMaterial, subItem));
+      }
+    }
+  }
+
   // disable heightmaps in segmentation camera sensor
   // until we support changing its material based on input label
   // TODO(anyone) add support for heightmaps with the segmentation camera
@@ -336,9 +538,14 @@ void Ogre2SegmentationMaterialSwitcher::cameraPreRenderScene(
 void Ogre2SegmentationMaterialSwitcher::cameraPostRenderScene(
     Ogre::Camera * /*_cam*/)
 {
-  // restore item to use pbs hlms material
-  for (const auto &[subItem, dataBlock] : this->datablockMap)
-    subItem->setDatablock(dataBlock);
+  IGN_PROFILE("Ogre2SegmentationMaterialSwitcher::cameraPostRenderScene");
+  Ogre2RenderEngine::Instance()->MaterialOverride().End();
+
+  // restore the low level materials and datablocks
+  for (const auto &[subItem, material] : this->materialMap)
+    subItem->setMaterial(material);
+  for (const auto &[subItem, datablock] : this->datablockMap)
+    subItem->setDatablock(datablock);
 
   // re-enable heightmaps
   auto heightmaps = this->scene->Heightmaps();
@@ -354,5 +561,8 @@ void Ogre2SegmentationMaterialSwitcher::cameraPostRenderScene(
 const std::unordered_map<int64_t, int64_t> &
 Ogre2SegmentationMaterialSwitcher::ColorToLabel() const
 {
-  return this->colorToLabel;
+  static const std::unordered_map<int64_t, int64_t> empty;
+  if (!this->labelColors)
+    return empty;
+  return this->labelColors->ColorToLabel();
 }
@@ -18,6 +18,7 @@
 #ifndef IGNITION_RENDERING_OGRE2_OGRE2SEGMENTATIONMATERIALSWITCHER_HH_
 #define IGNITION_RENDERING_OGRE2_OGRE2SEGMENTATIONMATERIALSWITCHER_HH_
 
+#include <memory>
 #include <string>
 #include <random>
 #include <unordered_map>
@@ -31,37 +32,85 @@
 #include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
 #include "ignition/rendering/SegmentationCamera.hh"
 
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreVector4.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
 namespace ignition
 {
 namespace rendering
 {
 inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
 
-/// \brief Helper class to assign unique colors to renderables
-class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2SegmentationMaterialSwitcher :
-  public Ogre::Camera::Listener
+/// \brief Segmentation colors assigned to the renderables of a scene for
+/// one set of segmentation camera settings. Assigning colors requires
+/// sorting all items, looking up their labels and finding unique colors so
+/// the result is cached until labels change or items are added or removed.
+/// The colors are stored in a custom parameter of each sub item, which the
+/// hlms draw the items with, see Ogre2MaterialOverride. Segmentation
+/// cameras of the same scene that use the same settings share one
+/// instance, see Shared.
+class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2SegmentationLabelColors
 {
+  /// \brief Segmentation colors of an item
+  public: struct ItemColor
+  {
+    /// \brief Id of the visual the item belongs to
+    unsigned int visualId = 0u;
+
+    /// \brief Color of the item in the segmentation map. This is the
+    /// colored map color if colored map is enabled, and the label id
+    /// encoded as a color otherwise
+    Ogre::Vector4 color;
+
+    /// \brief Label id of the item encoded as a color, in the same layout
+    /// as LabelMapFromColoredBuffer produces
+    Ogre::Vector4 label;
+  };
+
   /// \brief Constructor
-  /// \param[in] _scene The scene associated with the material switcher
-  /// \param[in] _camera The canera associated with the material switcher
-  public: Ogre2SegmentationMaterialSwitcher(Ogre2ScenePtr _scene,
-              SegmentationCamera *_camera);
+  /// \param[in] _scene The scene to assign colors in
+  /// \param[in] _camera Segmentation camera to take the settings from
+  public: Ogre2SegmentationLabelColors(Ogre2ScenePtr _scene,
+              const SegmentationCamera *_camera);
 
-  /// \brief Destructor
-  public: ~Ogre2SegmentationMaterialSwitcher();
+  /// \brief Get the label colors for the settings of a segmentation camera,
+  /// shared with other segmentation cameras of the same scene that use the
+  /// same settings
+  /// \param[in] _scene The scene of the segmentation camera
+  /// \param[in] _camera The segmentation camera
+  /// \return Label colors, created if none exist yet for these settings
+  public: static std::shared_ptr<Ogre2SegmentationLabelColors> Shared(
+              Ogre2ScenePtr _scene, const SegmentationCamera *_camera);
 
-  /// \brief Ogre's pre render update callback
-  /// \param[in] _cam Ogre camera
-  public: virtual void cameraPreRenderScene(Ogre::Camera *_cam) override;
+  /// \brief Check if the colors were assigned for the given camera settings
+  /// \param[in] _camera Segmentation camera to compare settings with
+  /// \return True if the segmentation type, colored map, background label
+  /// and background color match
+  public: bool Matches(const SegmentationCamera *_camera) const;
 
-  /// \brief Ogre's postrender update callback
-  /// \param[in] _cam Ogre camera
-  public: virtual void cameraPostRenderScene(Ogre::Camera *_cam) override;
+  /// \brief Reassign the item colors if they are out of date
+  public: void Update();
+
+  /// \brief Get the cached segmentation colors of each ogre item that
+  /// belongs to a visual
+  /// \return Cached item colors
+  public: const std::unordered_map<Ogre::Item *, ItemColor> &ItemColors()
+      const;
 
   /// \brief Get the map between color IDs and label IDs
   /// \return The map between color and label IDs
   public: const std::unordered_map<int64_t, int64_t> &ColorToLabel() const;
 
+  /// \brief Get the custom parameter index holding the color of each sub
+  /// item. With colored map, the label is packed in its w component.
+  /// \return Custom parameter index
+  public: size_t ParameterIndex() const;
+
   /// \brief Convert label of semantic map to a unique color for colored map and
   /// add the color of the label to the taken colors if it doesn't exist
   /// \param[in] _label id of the semantic map or encoded id of panoptic map
@@ -78,28 +127,24 @@ class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2SegmentationMaterialSwitcher :
   /// \return The top level model visual of _visual
   private: VisualPtr TopLevelModelVisual(VisualPtr _visual) const;
 
+  /// \brief Check if the cached item colors are out of date, i.e. if items
+  /// were added or removed, or labels or parents changed since they were
+  /// last assigned. Items added to or removed from visuals change the
+  /// visibility layers revision of the scene, and label or parent changes
+  /// its labels revision.
+  /// \return True if the item colors need to be reassigned
+  private: bool ItemColorsDirty() const;
+
+  /// \brief Assign a segmentation color to every item in the scene and
+  /// cache it so it can be reused until ItemColorsDirty returns true
+  private: void AssignItemColors();
+
   /// \brief Check if the color is already taken and add it to taken colors
   /// if it does not exist
   /// \param[in] _color Color to be checked
   /// \return True if taken, False otherwise
   private: bool IsTakenColor(const math::Color &_color);
 
-  /// \brief A map of ogre sub item pointer to its original hlms maults to 10mK
-  private: double resolution = 0.01;
-
-  /// \brief A map of ogre sub item pointer to their original hlms material
-  private: std::unordered_map<Ogre::SubItem *,
-    Ogre::HlmsDatablock *> datablockMap;
-
-  /// \brief Ogre material consisting of a shader that changes the
-  /// appearance of item to use a unique color for mouse picking
-  private: Ogre::MaterialPtr plainMaterial;
-
-  /// \brief Ogre material consisting of a shader that changes the
-  /// appearance of item to use a unique color for mouse picking. In
-  /// addition, the depth check and depth write properties disabled.
-  private: Ogre::MaterialPtr plainOverlayMaterial;
-
   /// \brief Keep track of num of instances of the same label
   /// Key: label id, value: num of instances
   private: std::unordered_map<unsigned int, unsigned int> instancesCount;
@@ -117,11 +162,92 @@ class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2SegmentationMaterialSwitcher :
   /// or composite id (8 bit label + 16 bit instances) in instance type
   private: std::unordered_map<int64_t, int64_t> colorToLabel;
 
+  /// \brief Cached segmentation colors of each ogre item that belongs to a
+  /// visual
+  private: std::unordered_map<Ogre::Item *, ItemColor> itemColors;
+
+  /// \brief True if itemColors has been assigned at least once
+  private: bool itemColorsAssigned = false;
+
+  /// \brief Scene labels revision the item colors were assigned for
+  private: uint64_t labelsRevision = 0u;
+
+  /// \brief Scene visibility layers revision the item colors were assigned
+  /// for
+  private: uint64_t itemsRevision = 0u;
+
+  /// \brief Custom parameter index of the sub item colors
+  private: size_t parameterIndex = 0u;
+
+  /// \brief Segmentation type to assign colors for
+  private: SegmentationType segmentationType = SegmentationType::ST_SEMANTIC;
+
+  /// \brief True to assign colors for a colored map
+  private: bool coloredMap = false;
+
+  /// \brief Background label to assign colors for
+  private: int backgroundLabel = 0;
+
+  /// \brief Background color to assign colors for
+  private: math::Color backgroundColor;
+
   /// \brief Pseudo num generator to generate colors from label id
   private: std::default_random_engine generator;
 
   /// \brief Ogre2 Scene
   private: Ogre2ScenePtr scene = nullptr;
+};
+
+/// \brief Helper class to assign unique colors to renderables
+class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2SegmentationMaterialSwitcher :
+  public Ogre::Camera::Listener
+{
+  /// \brief Constructor
+  /// \param[in] _scene The scene associated with the material switcher
+  /// \param[in] _camera The canera associated with the material switcher
+  public: Ogre2SegmentationMaterialSwitcher(Ogre2ScenePtr _scene,
+              SegmentationCamera *_camera);
+
+  /// \brief Destructor
+  public: ~Ogre2SegmentationMaterialSwitcher();
+
+  /// \brief Ogre's pre render update callback
+  /// \param[in] _cam Ogre camera
+  public: virtual void cameraPreRenderScene(Ogre::Camera *_cam) override;
+
+  /// \brief Ogre's postrender update callback
+  /// \param[in] _cam Ogre camera
+  public: virtual void cameraPostRenderScene(Ogre::Camera *_cam) override;
+
+  /// \brief Get the map between color IDs and label IDs
+  /// \return The map between color and label IDs
+  public: const std::unordered_map<int64_t, int64_t> &ColorToLabel() const;
+
+  /// \brief A map of ogre sub items with low level materials to their
+  /// original material
+  private: std::unordered_map<Ogre::SubItem *,
+    Ogre::MaterialPtr> materialMap;
+
+  /// \brief A map of ogre sub items drawn by the hlms to their original
+  /// datablock, only used when the colored map can't be written by the
+  /// hlms, see Ogre2MaterialOverrideMode::LABEL
+  private: std::unordered_map<Ogre::SubItem *,
+    Ogre::HlmsDatablock *> datablockMap;
+
+  /// \brief Ogre material consisting of a shader that changes the
+  /// appearance of item to use a unique color for mouse picking
+  private: Ogre::MaterialPtr plainMaterial;
+
+  /// \brief Ogre material that writes the colored map and the label id
+  /// map to two render targets. Used when colored map is enabled
+  private: Ogre::MaterialPtr coloredMapMaterial;
+
+  /// \brief Segmentation colors for the current camera settings, shared
+  /// with other segmentation cameras of the scene
+  private: std::shared_ptr<Ogre2SegmentationLabelColors> labelColors;
+
+  /// \brief Ogre2 Scene
+  private: Ogre2ScenePtr scene = nullptr;
 
   /// \brief Pointer to segmentation camera that gives the material switcher
   /// access to things like the segmentation type, background color, background
@@ -15,10 +15,15 @@
  *
 */
 
+#include <algorithm>
 #include <memory>
+#include <unordered_map>
+#include <vector>
+
 #include <ignition/math/Color.hh>
 
 #include "ignition/common/Console.hh"
+#include "ignition/common/Profiler.hh"
 #include "ignition/rendering/RenderTypes.hh"
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2MaterialSwitcher.hh"
@@ -35,6 +40,7 @@
 #include <Compositor/Pass/PassClear/OgreCompositorPassClearDef.h>
 #include <Compositor/Pass/PassQuad/OgreCompositorPassQuadDef.h>
 #include <Compositor/Pass/PassScene/OgreCompositorPassSceneDef.h>
+#include <OgreAsyncTextureTicket.h>
 #include <OgreCamera.h>
 #include <OgreDepthBuffer.h>
 #include <OgreItem.h>
@@ -93,6 +99,45 @@ class ignition::rendering::Ogre2SelectionBufferPrivate
 
   /// \brief The selection buffer material
   public: Ogre::MaterialPtr selectionMaterial;
+
+  /// \brief Render texture covering the selection buffer, its size rounded
+  /// up to a multiple of kSizeBucket. It is rendered once and read back
+  /// into cachedPixels, which then answers all queries until the camera
+  /// moves or renders a new frame.
+  public: Ogre::TextureGpu *regionTexture = nullptr;
+
+  /// \brief Granularity of the size of regionTexture in pixels. Resizing
+  /// within a bucket, e.g. while dragging the edge of a window, only
+  /// changes the part of the texture that is rendered into.
+  public: static constexpr unsigned int kSizeBucket = 256u;
+
+  /// \brief Round a size up to a multiple of kSizeBucket
+  /// \param[in] _size Size in pixels
+  /// \return Size of the bucket
+  public: static unsigned int BucketSize(unsigned int _size)
+  {
+    return std::max(1u, (_size + kSizeBucket - 1u) / kSizeBucket) *
+        kSizeBucket;
+  }
+
+  /// \brief Compositor workspace that renders into regionTexture
+  public: Ogre::CompositorWorkspace *regionWorkspace = nullptr;
+
+  /// \brief Readback of regionTexture, four floats per pixel in row major
+  /// order
+  public: std::vector<float> cachedPixels;
+
+  /// \brief True if cachedPixels needs to be rendered and read back again
+  public: bool dirty = true;
+
+  /// \brief Camera projection matrix cachedPixels was rendered with
+  public: Ogre::Matrix4 cachedProjection;
+
+  /// \brief Camera position cachedPixels was rendered from
+  public: Ogre::Vector3 cachedPosition;
+
+  /// \brief Camera orientation cachedPixels was rendered from
+  public: Ogre::Quaternion cachedOrientation;
 };
 
 /////////////////////////////////////////////////
@@ -162,10 +207,25 @@ Ogre2SelectionBuffer::~Ogre2SelectionBuffer()
 /////////////////////////////////////////////////
 void Ogre2SelectionBuffer::Update()
 {
+  IGN_PROFILE("Ogre2SelectionBuffer::Update");
   if (!this->dataPtr->renderTexture)
     return;
 
-  this->dataPtr->materialSwitcher->Reset();
+  this->Update(this->dataPtr->ogreCompositorWorkspace);
+}
+
+/////////////////////////////////////////////////
+void Ogre2SelectionBuffer::SetDirty()
+{
+  this->dataPtr->dirty = true;
+}
+
+/////////////////////////////////////////////////
+void Ogre2SelectionBuffer::Update(Ogre::CompositorWorkspace *_workspace)
+{
+  // items keep their colors, but they may have moved, so the cached
+  // readback is stale
+  this->dataPtr->dirty = true;
 
   this->dataPtr->scene->StartForcedRender();
 
@@ -174,14 +234,14 @@ void Ogre2SelectionBuffer::Update()
   // auto engine = Ogre2RenderEngine::Instance();
   // engine->OgreRoot()->renderOneFrame();
   // this->dataPtr->ogreCompositorWorkspace->setEnabled(false);
-  this->dataPtr->ogreCompositorWorkspace->_validateFinalTarget();
-  this->dataPtr->ogreCompositorWorkspace->_beginUpdate(false);
-  this->dataPtr->ogreCompositorWorkspace->_update();
-  this->dataPtr->ogreCompositorWorkspace->_endUpdate(false);
+  _workspace->_validateFinalTarget();
+  _workspace->_beginUpdate(false);
+  _workspace->_update();
+  _workspace->_endUpdate(false);
 
   Ogre::vector<Ogre::TextureGpu *>::type swappedTargets;
   swappedTargets.reserve(2u);
-  this->dataPtr->ogreCompositorWorkspace->_swapFinalTarget(swappedTargets);
+  _workspace->_swapFinalTarget(swappedTargets);
 
   this->dataPtr->scene->FlushGpuCommandsAndStartNewFrame(1u, false);
 
@@ -194,6 +254,13 @@ void Ogre2SelectionBuffer::Update()
 /////////////////////////////////////////////////
 void Ogre2SelectionBuffer::DeleteRTTBuffer()
 {
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::TextureGpuManager *textureMgr =
+      ogreRoot->getRenderSystem()->getTextureGpuManager();
+
+  this->DeleteRegionBuffer();
+
   if (this->dataPtr->ogreCompositorWorkspace)
   {
     // TODO(ahcorde): Remove the workspace. Potential leak here
@@ -207,11 +274,11 @@ void Ogre2SelectionBuffer::DeleteRTTBuffer()
     this->dataPtr->ogreCompositorWorkspace = nullptr;
   }
 
-  auto engine = Ogre2RenderEngine::Instance();
-  auto ogreRoot = engine->OgreRoot();
-  ogreRoot->getRenderSystem()->getTextureGpuManager()->destroyTexture(
-    this->dataPtr->renderTexture);
+  textureMgr->destroyTexture(this->dataPtr->renderTexture);
   this->dataPtr->renderTexture = nullptr;
+
+  this->dataPtr->cachedPixels.clear();
+  this->dataPtr->dirty = true;
 }
 
 /////////////////////////////////////////////////
@@ -337,6 +404,8 @@ void Ogre2SelectionBuffer::CreateRTTBuffer()
     Ogre::CompositorPassSceneDef *passScene =
         static_cast<Ogre::CompositorPassSceneDef *>(
         colorTargetDef->addPass(Ogre::PASS_SCENE));
+    // unlit pass, skip building the Forward+ light clusters
+    passScene->mEnableForwardPlus = false;
     passScene->setAllLoadActions(Ogre::LoadAction::Clear);
     passScene->setAllClearColours(Ogre::ColourValue::Black);
     passScene->mVisibilityMask = IGN_VISIBILITY_SELECTABLE;
@@ -372,6 +441,62 @@ void Ogre2SelectionBuffer::CreateRTTBuffer()
         false);
 }
 
+/////////////////////////////////////////////////
+void Ogre2SelectionBuffer::CreateRegionBuffer()
+{
+  if (this->dataPtr->regionWorkspace)
+    return;
+
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+
+  Ogre::TextureGpuManager *textureMgr =
+    ogreRoot->getRenderSystem()->getTextureGpuManager();
+  this->dataPtr->regionTexture =
+      textureMgr->createTexture(
+        this->dataPtr->camera->getName() + "_SelectionRegionTex",
+        Ogre::GpuPageOutStrategy::SaveToSystemRam,
+        Ogre::TextureFlags::RenderToTexture,
+        Ogre::TextureTypes::Type2D);
+  this->dataPtr->regionTexture->setResolution(
+      Ogre2SelectionBufferPrivate::BucketSize(this->dataPtr->width),
+      Ogre2SelectionBufferPrivate::BucketSize(this->dataPtr->height));
+  this->dataPtr->regionTexture->setNumMipmaps(1u);
+  this->dataPtr->regionTexture->setPixelFormat(Ogre::PFG_RGBA32_FLOAT);
+
+  this->dataPtr->regionTexture->scheduleTransitionTo(
+    Ogre::GpuResidency::Resident);
+
+  // the node textures are sized relative to the final target so the same
+  // workspace definition renders the selection buffer at full resolution
+  this->dataPtr->regionWorkspace =
+      this->dataPtr->ogreCompMgr->addWorkspace(
+        this->dataPtr->scene->OgreSceneManager(),
+        this->dataPtr->regionTexture,
+        this->dataPtr->selectionCamera,
+        this->dataPtr->ogreCompWorkspaceDefName,
+        false);
+}
+
+/////////////////////////////////////////////////
+void Ogre2SelectionBuffer::DeleteRegionBuffer()
+{
+  if (this->dataPtr->regionWorkspace)
+  {
+    this->dataPtr->ogreCompMgr->removeWorkspace(
+        this->dataPtr->regionWorkspace);
+    this->dataPtr->regionWorkspace = nullptr;
+  }
+  if (this->dataPtr->regionTexture)
+  {
+    auto engine = Ogre2RenderEngine::Instance();
+    Ogre::TextureGpuManager *textureMgr =
+        engine->OgreRoot()->getRenderSystem()->getTextureGpuManager();
+    textureMgr->destroyTexture(this->dataPtr->regionTexture);
+    this->dataPtr->regionTexture = nullptr;
+  }
+}
+
 /////////////////////////////////////////////////
 void Ogre2SelectionBuffer::SetDimensions(
   unsigned int _width, unsigned int _height)
@@ -381,9 +506,19 @@ void Ogre2SelectionBuffer::SetDimensions(
 
   this->dataPtr->width = _width;
   this->dataPtr->height = _height;
-
-  this->DeleteRTTBuffer();
-  this->CreateRTTBuffer();
+  this->dataPtr->cachedPixels.clear();
+  this->dataPtr->dirty = true;
+
+  // the workspace definition doesn't depend on the size, and the texture
+  // is only created again when the size leaves its bucket
+  if (this->dataPtr->regionTexture &&
+      (this->dataPtr->regionTexture->getWidth() !=
+      Ogre2SelectionBufferPrivate::BucketSize(_width) ||
+      this->dataPtr->regionTexture->getHeight() !=
+      Ogre2SelectionBufferPrivate::BucketSize(_height)))
+  {
+    this->DeleteRegionBuffer();
+  }
 }
 /////////////////////////////////////////////////
 Ogre::Item *Ogre2SelectionBuffer::OnSelectionClick(const int _x, const int _y)
@@ -395,8 +530,7 @@ Ogre::Item *Ogre2SelectionBuffer::OnSelectionClick(const int _x, const int _y)
 }
 
 /////////////////////////////////////////////////
-bool Ogre2SelectionBuffer::ExecuteQuery(const int _x, const int _y,
-    Ogre::Item *&_item, math::Vector3d &_point)
+bool Ogre2SelectionBuffer::CanExecuteQuery() const
 {
   if (!this->dataPtr->renderTexture)
     return false;
@@ -412,65 +546,40 @@ bool Ogre2SelectionBuffer::ExecuteQuery(const int _x, const int _y,
       projectionMatrix.extractQuaternion().isNaN())
     return false;
 
-   const unsigned int targetWidth = this->dataPtr->width;
-   const unsigned int targetHeight = this->dataPtr->height;
-
-   if (_x < 0 || _y < 0 || _x >= static_cast<int>(targetWidth)
-       || _y >= static_cast<int>(targetHeight))
-     return false;
-
-  // 1x1 selection buffer, adapted from rviz
-  // http://docs.ros.org/indigo/api/rviz/html/c++/selection__manager_8cpp.html
-  unsigned int width = 1;
-  unsigned int height = 1;
-  float x1 = static_cast<float>(_x) /
-      static_cast<float>(targetWidth - 1) - 0.5f;
-  float y1 = static_cast<float>(_y) /
-      static_cast<float>(targetHeight - 1) - 0.5f;
-  float x2 = static_cast<float>(_x+width) /
-      static_cast<float>(targetWidth - 1) - 0.5f;
-  float y2 = static_cast<float>(_y+height) /
-      static_cast<float>(targetHeight - 1) - 0.5f;
-
-  Ogre::Matrix4 scaleMatrix = Ogre::Matrix4::IDENTITY;
-  Ogre::Matrix4 transMatrix = Ogre::Matrix4::IDENTITY;
-  scaleMatrix[0][0] = 1.0 / (x2-x1);
-  scaleMatrix[1][1] = 1.0 / (y2-y1);
-  transMatrix[0][3] -= x1+x2;
-  transMatrix[1][3] += y1+y2;
-  Ogre::Matrix4 customProjectionMatrix =
-      scaleMatrix * transMatrix *
-      this->dataPtr->camera->getProjectionMatrix();
-  this->dataPtr->selectionCamera->setCustomProjectionMatrix(true,
-      customProjectionMatrix);
-
-  this->dataPtr->selectionCamera->setPosition(
-      this->dataPtr->camera->getDerivedPosition());
-  this->dataPtr->selectionCamera->setOrientation(
-      this->dataPtr->camera->getDerivedOrientation());
-
-  // update render texture
-  this->Update();
-
-  Ogre::Image2 image;
-  image.convertFromTexture(this->dataPtr->renderTexture, 0, 0);
-  Ogre::ColourValue pixel = image.getColourAt(0, 0, 0, 0);
+  return true;
+}
 
-  float color = pixel[3];
+/////////////////////////////////////////////////
+bool Ogre2SelectionBuffer::DecodePixel(const Ogre::ColourValue &_pixel,
+    Ogre::Item *&_item, math::Vector3d &_point,
+    std::unordered_map<uint32_t, Ogre::Item *> *_itemCache) const
+{
+  float color = _pixel[3];
   uint32_t *rgba = reinterpret_cast<uint32_t *>(&color);
   unsigned int r = *rgba >> 24 & 0xFF;
   unsigned int g = *rgba >> 16 & 0xFF;
   unsigned int b = *rgba >> 8 & 0xFF;
 
-  math::Vector3d point(pixel[0], pixel[1], pixel[2]);
+  math::Vector3d point(_pixel[0], _pixel[1], _pixel[2]);
 
   auto rot = Ogre2Conversions::Convert(
       this->dataPtr->camera->getParentSceneNode()->_getDerivedOrientation());
   auto pos = Ogre2Conversions::Convert(
       this->dataPtr->camera->getParentSceneNode()->_getDerivedPosition());
-  math::Pose3d p(pos, rot);
   point = rot * point + pos;
 
+  uint32_t colorId = r << 16 | g << 8 | b;
+  if (_itemCache)
+  {
+    auto it = _itemCache->find(colorId);
+    if (it != _itemCache->end())
+    {
+      _item = it->second;
+      _point = point;
+      return _item != nullptr;
+    }
+  }
+
   ignition::math::Color cv;
   cv.A(1.0);
   cv.R(r / 255.0);
@@ -480,21 +589,179 @@ bool Ogre2SelectionBuffer::ExecuteQuery(const int _x, const int _y,
   const std::string &entName =
     this->dataPtr->materialSwitcher->EntityName(cv);
 
-  if (entName.empty())
+  Ogre::Item *item = nullptr;
+  if (!entName.empty())
   {
+    auto collection = this->dataPtr->sceneMgr->findMovableObjects(
+        Ogre::ItemFactory::FACTORY_TYPE_NAME, entName);
+    if (!collection.empty())
+      item = dynamic_cast<Ogre::Item *>(collection[0]);
+  }
+
+  if (_itemCache)
+    (*_itemCache)[colorId] = item;
+
+  if (!item)
     return false;
+
+  _item = item;
+  _point = point;
+  return true;
+}
+
+/////////////////////////////////////////////////
+void Ogre2SelectionBuffer::UpdateCache()
+{
+  const Ogre::Matrix4 &projection =
+      this->dataPtr->camera->getProjectionMatrix();
+  const Ogre::Vector3 &position = this->dataPtr->camera->getDerivedPosition();
+  const Ogre::Quaternion &orientation =
+      this->dataPtr->camera->getDerivedOrientation();
+
+  // reuse the last readback until the camera moves or renders a new frame
+  if (!this->dataPtr->dirty && projection == this->dataPtr->cachedProjection &&
+      position == this->dataPtr->cachedPosition &&
+      orientation == this->dataPtr->cachedOrientation)
+  {
+    return;
   }
-  else
+
+  IGN_PROFILE("Ogre2SelectionBuffer::UpdateCache");
+  this->CreateRegionBuffer();
+
+  // render the whole selection buffer once from the camera's view, into
+  // the top left corner of the texture. The projection is scaled and
+  // offset in clip space so that the view covers width x height pixels.
+  const unsigned int width = this->dataPtr->width;
+  const unsigned int height = this->dataPtr->height;
+  const Ogre::Real sx = static_cast<Ogre::Real>(width) /
+      static_cast<Ogre::Real>(this->dataPtr->regionTexture->getWidth());
+  const Ogre::Real sy = static_cast<Ogre::Real>(height) /
+      static_cast<Ogre::Real>(this->dataPtr->regionTexture->getHeight());
+  const Ogre::Matrix4 viewport(
+      sx, 0, 0, sx - 1,
+      0, sy, 0, 1 - sy,
+      0, 0, 1, 0,
+      0, 0, 0, 1);
+  this->dataPtr->selectionCamera->setCustomProjectionMatrix(true,
+      viewport * projection);
+  this->dataPtr->selectionCamera->setPosition(position);
+  this->dataPtr->selectionCamera->setOrientation(orientation);
+
+  this->Update(this->dataPtr->regionWorkspace);
+
+  // read back the rendered corner of the texture
+  auto engine = Ogre2RenderEngine::Instance();
+  Ogre::TextureGpuManager *textureMgr =
+      engine->OgreRoot()->getRenderSystem()->getTextureGpuManager();
+  Ogre::AsyncTextureTicket *ticket = textureMgr->createAsyncTextureTicket(
+      width, height, 1u, Ogre::TextureTypes::Type2D,
+      this->dataPtr->regionTexture->getPixelFormat());
+  Ogre::TextureBox srcBox = this->dataPtr->regionTexture->getEmptyBox(0u);
+  srcBox.width = width;
+  srcBox.height = height;
+  ticket->download(this->dataPtr->regionTexture, 0u, false, &srcBox);
+
+  const size_t rowSize = width * 4u;
+  this->dataPtr->cachedPixels.resize(rowSize * height);
+  Ogre::TextureBox box = ticket->map(0u);
+  for (unsigned int j = 0u; j < height; ++j)
   {
-    auto collection = this->dataPtr->sceneMgr->findMovableObjects(
-        Ogre::ItemFactory::FACTORY_TYPE_NAME, entName);
-    if (collection.empty())
-      return false;
-    else
+    const float *row = reinterpret_cast<const float *>(
+        static_cast<const uint8_t *>(box.data) + j * box.bytesPerRow);
+    std::copy(row, row + rowSize,
+        this->dataPtr->cachedPixels.begin() + j * rowSize);
+  }
+  ticket->unmap();
+  textureMgr->destroyAsyncTextureTicket(ticket);
+
+  this->dataPtr->cachedProjection = projection;
+  this->dataPtr->cachedPosition = position;
+  this->dataPtr->cachedOrientation = orientation;
+  this->dataPtr->dirty = false;
+}
+
+/////////////////////////////////////////////////
+Ogre::ColourValue Ogre2SelectionBuffer::CachedPixel(const int _x,
+    const int _y) const
+{
+  const float *data = this->dataPtr->cachedPixels.data() +
+      (static_cast<size_t>(_y) * this->dataPtr->width +
+      static_cast<size_t>(_x)) * 4u;
+  return Ogre::ColourValue(data[0], data[1], data[2], data[3]);
+}
+
+/////////////////////////////////////////////////
+bool Ogre2SelectionBuffer::ExecuteQuery(const int _x, const int _y,
+    Ogre::Item *&_item, math::Vector3d &_point)
+{
+  if (!this->CanExecuteQuery())
+    return false;
+
+  const unsigned int targetWidth = this->dataPtr->width;
+  const unsigned int targetHeight = this->dataPtr->height;
+
+  if (_x < 0 || _y < 0 || _x >= static_cast<int>(targetWidth)
+      || _y >= static_cast<int>(targetHeight))
+    return false;
+
+  this->UpdateCache();
+
+  return this->DecodePixel(this->CachedPixel(_x, _y), _item, _point);
+}
+
+/////////////////////////////////////////////////
+bool Ogre2SelectionBuffer::ExecuteQueries(
+    const std::vector<math::Vector2i> &_pixels,
+    std::vector<Ogre::Item *> &_items, std::vector<math::Vector3d> &_points)
+{
+  _items.assign(_pixels.size(), nullptr);
+  _points.assign(_pixels.size(), math::Vector3d::Zero);
+
+  if (!this->CanExecuteQuery())
+    return false;
+
+  const int targetWidth = static_cast<int>(this->dataPtr->width);
+  const int targetHeight = static_cast<int>(this->dataPtr->height);
+  auto inBounds = [&](const math::Vector2i &_pixel)
+  {
+    return _pixel.X() >= 0 && _pixel.Y() >= 0 && _pixel.X() < targetWidth &&
+        _pixel.Y() < targetHeight;
+  };
+  if (std::none_of(_pixels.begin(), _pixels.end(), inBounds))
+    return false;
+
+  this->UpdateCache();
+
+  bool found = false;
+  std::unordered_map<uint32_t, Ogre::Item *> itemCache;
+  for (unsigned int i = 0u; i < _pixels.size(); ++i)
+  {
+    const auto &pixel = _pixels[i];
+    if (!inBounds(pixel))
+      continue;
+
+    found = this->DecodePixel(this->CachedPixel(pixel.X(), pixel.Y()),
+        _items[i], _points[i], &itemCache) || found;
+  }
+
+  return found;
+}
+
+/////////////////////////////////////////////////
+bool Ogre2SelectionBuffer::ExecuteQueries(const int _x, const int _y,
+    unsigned int _width, unsigned int _height,
+    std::vector<Ogre::Item *> &_items, std::vector<math::Vector3d> &_points)
+{
+  std::vector<math::Vector2i> pixels;
+  pixels.reserve(_width * _height);
+  for (unsigned int j = 0u; j < _height; ++j)
+  {
+    for (unsigned int i = 0u; i < _width; ++i)
     {
-      _item = dynamic_cast<Ogre::Item *>(collection[0]);
-      _point = point;
-      return true;
+      pixels.push_back(math::Vector2i(_x + static_cast<int>(i),
+          _y + static_cast<int>(j)));
     }
   }
+  return this->ExecuteQueries(pixels, _items, _points);
 }
@@ -14,7 +14,11 @@
  * limitations under the License.
  *
  */
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
 #include "ignition/rendering/ogre2/Ogre2Sensor.hh"
+#include "Ogre2DrawCounter.hh"
+#include "Ogre2GpuTimer.hh"
+#include "Ogre2OcclusionCuller.hh"
 
 using namespace ignition;
 using namespace rendering;
@@ -28,3 +32,78 @@ Ogre2Sensor::Ogre2Sensor()
 Ogre2Sensor::~Ogre2Sensor()
 {
 }
+
+//////////////////////////////////////////////////
+RenderStats Ogre2Sensor::GpuStats() const
+{
+  if (!this->gpuTimer)
+    return RenderStats();
+  return this->gpuTimer->Stats();
+}
+
+//////////////////////////////////////////////////
+rendering::DrawStats Ogre2Sensor::DrawStats() const
+{
+  if (!this->drawCounter)
+    return rendering::DrawStats();
+  return this->drawCounter->Stats();
+}
+
+//////////////////////////////////////////////////
+Ogre2GpuTimer *Ogre2Sensor::GpuTimer()
+{
+  if (!this->gpuTimerChecked)
+  {
+    this->gpuTimerChecked = true;
+    if (Ogre2RenderEngine::Instance()->GpuTimingEnabled() &&
+        Ogre2GpuTimer::Available())
+    {
+      this->gpuTimer = std::make_unique<Ogre2GpuTimer>();
+    }
+  }
+  return this->gpuTimer.get();
+}
+
+//////////////////////////////////////////////////
+Ogre2DrawCounter *Ogre2Sensor::DrawCounter()
+{
+  if (!this->drawCounterChecked)
+  {
+    this->drawCounterChecked = true;
+    if (Ogre2RenderEngine::Instance()->DrawStatsEnabled())
+      this->drawCounter = std::make_unique<Ogre2DrawCounter>();
+  }
+  return this->drawCounter.get();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Sensor::AddPassProfilers(Ogre::CompositorWorkspace *_workspace)
+{
+  this->AddPassProfilers(_workspace);
+  if (this->DrawCounter())
+    _workspace->addListener(this->DrawCounter());
+}
+
+//////////////////////////////////////////////////
+void Ogre2Sensor::BeginPassProfilers()
+{
+  if (this->GpuTimer())
+    this->GpuTimer()->BeginFrame();
+  if (this->DrawCounter())
+    this->DrawCounter()->BeginFrame();
+}
+
+//////////////////////////////////////////////////
+Ogre2OcclusionCuller *Ogre2Sensor::OcclusionCuller()
+{
+  if (!this->occlusionCullerChecked && this->scene)
+  {
+    this->occlusionCullerChecked = true;
+    if (Ogre2RenderEngine::Instance()->OcclusionCullingEnabled())
+    {
+      this->occlusionCuller =
+          std::make_unique<Ogre2OcclusionCuller>(this->scene);
+    }
+  }
+  return this->occlusionCuller.get();
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cmath>
+#include <memory>
+
+#include <ignition/math/Rand.hh>
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/GaussianNoisePass.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgrePass.h>
+#include <OgreVector3.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+#include "Ogre2ShaderNoise.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+void Ogre2ShaderNoise::Update(const Camera &_camera)
+{
+  // independent Gaussian noises add up to a Gaussian noise with the sum of
+  // their means and variances
+  double variance = 0.0;
+  this->mean = 0.0;
+  for (unsigned int i = 0; i < _camera.RenderPassCount(); ++i)
+  {
+    auto pass = std::dynamic_pointer_cast<GaussianNoisePass>(
+        _camera.RenderPassByIndex(i));
+    if (!pass || !pass->IsEnabled())
+      continue;
+    this->mean += pass->Mean();
+    variance += pass->StdDev() * pass->StdDev();
+  }
+  this->stdDev = std::sqrt(variance);
+
+  this->offsets.Set(math::Rand::DblUniform(0.0, 1.0),
+                    math::Rand::DblUniform(0.0, 1.0),
+                    math::Rand::DblUniform(0.0, 1.0));
+}
+
+//////////////////////////////////////////////////
+void Ogre2ShaderNoise::Apply(Ogre::Pass *_pass) const
+{
+  Ogre::GpuProgramParametersSharedPtr psParams =
+      _pass->getFragmentProgramParameters();
+  psParams->setNamedConstant("noiseOffsets", Ogre::Vector3(
+      static_cast<Ogre::Real>(this->offsets.X()),
+      static_cast<Ogre::Real>(this->offsets.Y()),
+      static_cast<Ogre::Real>(this->offsets.Z())));
+  psParams->setNamedConstant("noiseMean",
+      static_cast<Ogre::Real>(this->mean));
+  psParams->setNamedConstant("noiseStdDev",
+      static_cast<Ogre::Real>(this->stdDev));
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2SHADERNOISE_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2SHADERNOISE_HH_
+
+#include <ignition/math/Vector3.hh>
+
+#include "ignition/rendering/config.hh"
+
+namespace Ogre
+{
+  class Pass;
+}
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    // forward declaration
+    class Camera;
+
+    /// \brief Gaussian noise sampled by the shader that computes the output
+    /// of a sensor, for sensors without a render pass chain. The Gaussian
+    /// noise passes added to the sensor are applied by that shader instead
+    /// of a full screen pass of their own, which also saves adding the
+    /// noise on the CPU after readback.
+    /// The shader declares the noiseOffsets (vec3), noiseMean and
+    /// noiseStdDev (float) uniforms and skips the noise if both noiseMean
+    /// and noiseStdDev are 0.
+    class Ogre2ShaderNoise
+    {
+      /// \brief Combine the enabled Gaussian noise passes of a sensor into
+      /// a single distribution and draw the random offsets the shader
+      /// seeds its generator with. Call once per frame, before Apply.
+      /// \param[in] _camera Sensor the noise passes were added to
+      public: void Update(const Camera &_camera);
+
+      /// \brief Set the noise uniforms of a shader pass. All passes of a
+      /// frame get the same offsets, so that they sample the same noise.
+      /// \param[in] _pass Pass whose fragment program samples the noise
+      public: void Apply(Ogre::Pass *_pass) const;
+
+      /// \brief Random offsets of the current frame
+      private: math::Vector3d offsets;
+
+      /// \brief Mean of the combined noise
+      private: double mean = 0.0;
+
+      /// \brief Standard deviation of the combined noise
+      private: double stdDev = 0.0;
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "Ogre2SharedMeshes.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+void Ogre2SharedMeshes::Acquire(const std::string &_name, const void *_user)
+{
+  this->entries[_name].users.insert(_user);
+}
+
+//////////////////////////////////////////////////
+bool Ogre2SharedMeshes::Release(const std::string &_name, const void *_user)
+{
+  auto it = this->entries.find(_name);
+  if (it == this->entries.end())
+    return true;
+
+  it->second.users.erase(_user);
+  if (!it->second.users.empty())
+    return false;
+
+  this->entries.erase(it);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2SharedMeshes::Bvh(const std::string &_name,
+    const std::function<std::unique_ptr<Ogre2MeshBvh>()> &_create,
+    const Ogre2MeshBvh *&_bvh)
+{
+  auto it = this->entries.find(_name);
+  if (it == this->entries.end())
+    return false;
+
+  if (!it->second.bvhBuilt)
+  {
+    it->second.bvh = _create();
+    it->second.bvhBuilt = true;
+  }
+  _bvh = it->second.bvh.get();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2SharedMeshes::Clear()
+{
+  this->entries.clear();
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2SHAREDMESHES_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2SHAREDMESHES_HH_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/ogre2/Export.hh"
+
+#include "Ogre2MeshBvh.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Ogre meshes shared by the mesh factories of all scenes. The
+    /// ogre mesh managers are engine wide so a mesh loaded by the factory of
+    /// one scene is reused by the others. The factories using each mesh are
+    /// counted so the mesh is only removed once no scene uses it anymore,
+    /// and the bounding volume hierarchy of the mesh is built once for all
+    /// of them. Owned by the render engine, see
+    /// Ogre2RenderEngine::SharedMeshes.
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2SharedMeshes
+    {
+      /// \brief Register a user of a mesh
+      /// \param[in] _name Name of the ogre mesh
+      /// \param[in] _user Mesh factory using the mesh
+      public: void Acquire(const std::string &_name, const void *_user);
+
+      /// \brief Unregister a user of a mesh
+      /// \param[in] _name Name of the ogre mesh
+      /// \param[in] _user Mesh factory that used the mesh
+      /// \return True if the mesh has no users left and can be removed
+      public: bool Release(const std::string &_name, const void *_user);
+
+      /// \brief Get the bounding volume hierarchy of a registered mesh,
+      /// building it on first use. The hierarchy must only depend on the
+      /// mesh name, since any of the users may be the one building it
+      /// \param[in] _name Name of the ogre mesh
+      /// \param[in] _create Function building the hierarchy
+      /// \param[out] _bvh The hierarchy, null if the mesh triangles are not
+      /// available
+      /// \return False if the mesh is not registered
+      public: bool Bvh(const std::string &_name,
+          const std::function<std::unique_ptr<Ogre2MeshBvh>()> &_create,
+          const Ogre2MeshBvh *&_bvh);
+
+      /// \brief Forget all meshes and their hierarchies. Called when the
+      /// engine is destroyed, along with the ogre mesh managers
+      public: void Clear();
+
+      /// \brief Users and derived data of a shared mesh
+      private: struct Entry
+      {
+        /// \brief Mesh factories using the mesh
+        std::unordered_set<const void *> users;
+
+        /// \brief Bounding volume hierarchy of the mesh
+        std::unique_ptr<Ogre2MeshBvh> bvh;
+
+        /// \brief True once the hierarchy was built
+        bool bvhBuilt = false;
+      };
+
+      /// \brief Shared meshes indexed by ogre mesh name
+      private: std::unordered_map<std::string, Entry> entries;
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,383 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/math/Helpers.hh>
+
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+#include "ignition/rendering/ogre2/Ogre2Text.hh"
+#include "ignition/rendering/ogre2/Ogre2Visual.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Hlms/Unlit/OgreHlmsUnlitDatablock.h>
+#include <OgreItem.h>
+#include <OgreMaterialManager.h>
+#include <OgreMesh2.h>
+#include <OgreMeshManager2.h>
+#include <OgrePass.h>
+#include <OgreSceneManager.h>
+#include <OgreSubMesh2.h>
+#include <OgreTechnique.h>
+#include <Overlay/OgreFont.h>
+#include <Overlay/OgreFontManager.h>
+#include <Vao/OgreVaoManager.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+/// \brief Private data for the Ogre2Text class
+class ignition::rendering::Ogre2TextPrivate
+{
+  /// \brief Text material, only its diffuse color is used
+  public: MaterialPtr material;
+
+  /// \brief Font of the text, null if the font is not found
+  public: Ogre::Font *font = nullptr;
+
+  /// \brief Name of the font the font pointer was looked up with
+  public: std::string fontName;
+
+  /// \brief Ogre item drawing the glyphs
+  public: Ogre::Item *ogreItem = nullptr;
+
+  /// \brief Ogre submesh holding the glyphs vao
+  public: Ogre::SubMesh *subMesh = nullptr;
+
+  /// \brief Bounding box of the glyphs in the billboard plane
+  public: math::AxisAlignedBox aabb{math::Vector3d::Zero,
+      math::Vector3d::Zero};
+};
+
+using namespace ignition;
+using namespace rendering;
+
+namespace
+{
+/// \brief Number of floats per glyph vertex: position, atlas texture
+/// coordinates and color
+const unsigned int kTextVertexSize = 9u;
+
+/// \brief Get the low level material drawing the glyphs of a font. The
+/// material samples the glyph atlas of the font, so it is shared by all texts
+/// using the font and kept for the lifetime of the render engine.
+/// \param[in] _font Font of the text
+/// \param[in] _onTop True for text drawn on top of the scene
+/// \return The material, null if the text material is not available
+Ogre::MaterialPtr TextMaterial(Ogre::Font *_font, bool _onTop)
+{
+  Ogre::MaterialManager &materialManager =
+      Ogre::MaterialManager::getSingleton();
+  std::string name = "Ignition/Text/" + _font->getName();
+  if (_onTop)
+    name += "/OnTop";
+
+  Ogre::MaterialPtr material = materialManager.getByName(name);
+  if (!material.isNull())
+    return material;
+
+  Ogre::MaterialPtr textMaterial = materialManager.getByName("Text");
+  if (textMaterial.isNull())
+  {
+    ignerr << "Text material not found" << std::endl;
+    return material;
+  }
+
+  material = textMaterial->clone(name);
+  material->load();
+
+  // the font rasterizes its glyphs to an atlas texture bound to its unlit
+  // datablock
+  Ogre::Pass *pass = material->getTechnique(0)->getPass(0);
+  auto datablock =
+      static_cast<Ogre::HlmsUnlitDatablock *>(_font->getHlmsDatablock());
+  pass->getTextureUnitState(0)->setTexture(datablock->getTexture(0));
+
+  if (_onTop)
+  {
+    Ogre::HlmsMacroblock macroblock(*pass->getMacroblock());
+    macroblock.mDepthCheck = false;
+    pass->setMacroblock(macroblock);
+  }
+  return material;
+}
+}
+
+//////////////////////////////////////////////////
+Ogre2Text::Ogre2Text()
+  : dataPtr(new Ogre2TextPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2Text::~Ogre2Text()
+{
+}
+
+//////////////////////////////////////////////////
+void Ogre2Text::Init()
+{
+  Ogre::MeshPtr mesh = Ogre::MeshManager::getSingleton().createManual(
+      this->scene->Name() + "::" + this->Name() + "::Text",
+      Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+  this->dataPtr->subMesh = mesh->createSubMesh();
+  this->Update();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Text::Destroy()
+{
+  if (this->dataPtr->subMesh)
+  {
+    Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+    if (this->dataPtr->ogreItem)
+    {
+      sceneManager->destroyItem(this->dataPtr->ogreItem);
+      this->scene->MarkVisibilityLayersDirty();
+      this->dataPtr->ogreItem = nullptr;
+    }
+
+    Ogre::VaoManager *vaoManager =
+        sceneManager->getDestinationRenderSystem()->getVaoManager();
+    if (vaoManager && !this->dataPtr->subMesh->mVao[Ogre::VpNormal].empty())
+    {
+      this->dataPtr->subMesh->destroyVaos(
+          this->dataPtr->subMesh->mVao[Ogre::VpNormal], vaoManager);
+    }
+    this->dataPtr->subMesh->mVao[Ogre::VpShadow].clear();
+
+    std::string meshName = this->dataPtr->subMesh->mParent->getName();
+    if (Ogre::MeshManager::getSingleton().resourceExists(meshName))
+      Ogre::MeshManager::getSingleton().remove(meshName);
+    this->dataPtr->subMesh = nullptr;
+  }
+
+  BaseText::Destroy();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Text::PreRender()
+{
+  BaseText::PreRender();
+  if (this->textDirty)
+    this->Update();
+}
+
+//////////////////////////////////////////////////
+Ogre::MovableObject *Ogre2Text::OgreObject() const
+{
+  return this->dataPtr->ogreItem;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Text::SetMaterial(MaterialPtr _material, bool _unique)
+{
+  _material = (_unique) ? _material->Clone() : _material;
+
+  // only colors are supported for now
+  this->SetColor(_material->Diffuse());
+  this->dataPtr->material = _material;
+}
+
+//////////////////////////////////////////////////
+MaterialPtr Ogre2Text::Material() const
+{
+  return this->dataPtr->material;
+}
+
+//////////////////////////////////////////////////
+math::AxisAlignedBox Ogre2Text::AABB() const
+{
+  return this->dataPtr->aabb;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Text::Update()
+{
+  this->textDirty = false;
+  if (!this->dataPtr->subMesh)
+    return;
+
+  if (!this->dataPtr->font || this->dataPtr->fontName != this->fontName)
+  {
+    this->dataPtr->fontName = this->fontName;
+    this->dataPtr->font = static_cast<Ogre::Font *>(
+        Ogre::FontManager::getSingleton().getByName(this->fontName,
+        Ogre::ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME).get());
+    if (!this->dataPtr->font)
+    {
+      ignerr << "Could not find font " << this->fontName << std::endl;
+      return;
+    }
+    this->dataPtr->font->load();
+  }
+  Ogre::Font *font = this->dataPtr->font;
+
+  // split the text in lines and measure them
+  float height = this->charHeight;
+  float spaceWidth = this->spaceWidth > 0.0f ? this->spaceWidth :
+      font->getGlyphAspectRatio('A') * height;
+  std::vector<std::string> lines(1u);
+  std::vector<float> lineWidths(1u, 0.0f);
+  for (char c : this->text)
+  {
+    if (c == '\n')
+    {
+      lines.emplace_back();
+      lineWidths.push_back(0.0f);
+      continue;
+    }
+    lines.back().push_back(c);
+    lineWidths.back() += (c == ' ') ? spaceWidth :
+        font->getGlyphAspectRatio(static_cast<unsigned char>(c)) * height;
+  }
+
+  // top of the first line relative to the origin of the text
+  float top = this->baseline;
+  float blockHeight = height * lines.size();
+  if (this->verticalAlign == TextVerticalAlign::BOTTOM)
+    top += blockHeight;
+  else if (this->verticalAlign == TextVerticalAlign::CENTER)
+    top += blockHeight * 0.5f;
+
+  // two triangles per glyph, each vertex is (x, y, z, u, v, r, g, b, a)
+  std::vector<float> vertices;
+  vertices.reserve(this->text.size() * 6u * kTextVertexSize);
+  math::Color color = this->color;
+  math::Vector3d min(math::MAX_D, math::MAX_D, 0.0);
+  math::Vector3d max(math::LOW_D, math::LOW_D, 0.0);
+  auto addVertex = [&](float _x, float _y, Ogre::Real _u, Ogre::Real _v)
+  {
+    vertices.insert(vertices.end(), {_x, _y, 0.0f, _u, _v,
+        color.R(), color.G(), color.B(), color.A()});
+    min.X(std::min(min.X(), static_cast<double>(_x)));
+    min.Y(std::min(min.Y(), static_cast<double>(_y)));
+    max.X(std::max(max.X(), static_cast<double>(_x)));
+    max.Y(std::max(max.Y(), static_cast<double>(_y)));
+  };
+
+  for (unsigned int l = 0u; l < lines.size(); ++l)
+  {
+    float left = 0.0f;
+    if (this->horizontalAlign == TextHorizontalAlign::CENTER)
+      left = -lineWidths[l] * 0.5f;
+    else if (this->horizontalAlign == TextHorizontalAlign::RIGHT)
+      left = -lineWidths[l];
+    float bottom = top - height;
+
+    for (char c : lines[l])
+    {
+      if (c == ' ')
+      {
+        left += spaceWidth;
+        continue;
+      }
+
+      Ogre::Font::CodePoint codePoint = static_cast<unsigned char>(c);
+      float right = left + font->getGlyphAspectRatio(codePoint) * height;
+      const Ogre::Font::UVRect &uv = font->getGlyphTexCoords(codePoint);
+      addVertex(left, top, uv.left, uv.top);
+      addVertex(left, bottom, uv.left, uv.bottom);
+      addVertex(right, top, uv.right, uv.top);
+      addVertex(right, top, uv.right, uv.top);
+      addVertex(left, bottom, uv.left, uv.bottom);
+      addVertex(right, bottom, uv.right, uv.bottom);
+      left = right;
+    }
+    top = bottom;
+  }
+
+  if (vertices.empty())
+  {
+    // ogre does not accept empty vertex buffers, draw a degenerate glyph
+    vertices.assign(6u * kTextVertexSize, 0.0f);
+    this->dataPtr->aabb = math::AxisAlignedBox(math::Vector3d::Zero,
+        math::Vector3d::Zero);
+  }
+  else
+  {
+    this->dataPtr->aabb = math::AxisAlignedBox(min, max);
+  }
+
+  // the glyphs only change with the text properties, so they are uploaded
+  // to an immutable buffer which is replaced on change
+  Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+  Ogre::VaoManager *vaoManager =
+      sceneManager->getDestinationRenderSystem()->getVaoManager();
+  Ogre::SubMesh *subMesh = this->dataPtr->subMesh;
+  if (!subMesh->mVao[Ogre::VpNormal].empty())
+    subMesh->destroyVaos(subMesh->mVao[Ogre::VpNormal], vaoManager);
+  subMesh->mVao[Ogre::VpShadow].clear();
+
+  Ogre::VertexElement2Vec vertexElements;
+  vertexElements.push_back(
+      Ogre::VertexElement2(Ogre::VET_FLOAT3, Ogre::VES_POSITION));
+  vertexElements.push_back(
+      Ogre::VertexElement2(Ogre::VET_FLOAT2, Ogre::VES_TEXTURE_COORDINATES));
+  vertexElements.push_back(
+      Ogre::VertexElement2(Ogre::VET_FLOAT4, Ogre::VES_DIFFUSE));
+  Ogre::VertexBufferPacked *vertexBuffer = vaoManager->createVertexBuffer(
+      vertexElements, vertices.size() / kTextVertexSize,
+      Ogre::BT_IMMUTABLE, vertices.data(), false);
+
+  Ogre::VertexBufferPackedVec vertexBuffers;
+  vertexBuffers.push_back(vertexBuffer);
+  Ogre::VertexArrayObject *vao = vaoManager->createVertexArrayObject(
+      vertexBuffers, nullptr, Ogre::OT_TRIANGLE_LIST);
+  subMesh->mVao[Ogre::VpNormal].push_back(vao);
+  subMesh->mVao[Ogre::VpShadow].push_back(vao);
+
+  // the glyphs turn around the origin of the text to face the camera
+  const math::AxisAlignedBox &box = this->dataPtr->aabb;
+  math::Vector3d corner(
+      std::max(std::abs(box.Min().X()), std::abs(box.Max().X())),
+      std::max(std::abs(box.Min().Y()), std::abs(box.Max().Y())), 0.0);
+  subMesh->mParent->_setBounds(Ogre::Aabb(Ogre::Vector3::ZERO,
+      Ogre::Vector3(static_cast<Ogre::Real>(corner.Length()))), true);
+
+  if (!this->dataPtr->ogreItem)
+  {
+    this->dataPtr->ogreItem = sceneManager->createItem(
+        subMesh->mParent->getName(),
+        Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+        Ogre::SCENE_DYNAMIC);
+    this->scene->MarkVisibilityLayersDirty();
+  }
+  else
+  {
+    // rebuild the sub item since the vao was replaced. This resets the item
+    // properties set below
+    this->dataPtr->ogreItem->_initialise(true);
+  }
+  this->dataPtr->ogreItem->setCastShadows(false);
+
+  Ogre::MaterialPtr material = TextMaterial(font, this->onTop);
+  if (!material.isNull())
+    this->dataPtr->ogreItem->getSubItem(0)->setMaterial(material);
+
+  // the visual caches its bounding box
+  Ogre2VisualPtr visual = std::dynamic_pointer_cast<Ogre2Visual>(
+      this->Parent());
+  if (visual)
+    visual->MarkBoundsDirty();
+}
@@ -0,0 +1,713 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Profiler.hh>
+#include <ignition/common/Util.hh>
+
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+#include "ignition/rendering/Utils.hh"
+
+#include "Ogre2TextureCompression.hh"
+#include "Ogre2WorkerPool.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreDataStream.h>
+#include <OgreImage2.h>
+#include <OgrePixelFormatGpuUtils.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+namespace ignition
+{
+namespace rendering
+{
+inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+//
+/// \brief Version of the cache files, bump it when the conversion changes
+static const unsigned int kTextureCacheVersion = 1u;
+
+/// \brief Block compression formats written to the cache
+enum class BlockFormat
+{
+  BC1,
+  BC3,
+  BC5
+};
+
+/// \brief How mip levels are filtered
+enum class MipFilter
+{
+  /// \brief Average the encoded values
+  LINEAR,
+
+  /// \brief Average the colors in linear space
+  SRGB,
+
+  /// \brief Average the normals and normalize them
+  NORMAL
+};
+
+//////////////////////////////////////////////////
+/// \brief Table converting sRGB encoded values to linear ones
+static const float *SrgbToLinear()
+{
+  static const std::vector<float> table = []()
+  {
+    std::vector<float> values(256u);
+    for (unsigned int i = 0; i < 256u; ++i)
+    {
+      float c = i / 255.0f;
+      values[i] = c <= 0.04045f ? c / 12.92f :
+          std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+    return values;
+  }();
+  return table.data();
+}
+
+//////////////////////////////////////////////////
+/// \brief Convert a linear value to an sRGB encoded one
+static uint8_t LinearToSrgb(float _value)
+{
+  float c = _value <= 0.0031308f ? _value * 12.92f :
+      1.055f * std::pow(_value, 1.0f / 2.4f) - 0.055f;
+  return static_cast<uint8_t>(
+      std::min(std::max(c * 255.0f + 0.5f, 0.0f), 255.0f));
+}
+
+//////////////////////////////////////////////////
+/// \brief Compute the next mip level of an RGBA image, averaging blocks of
+/// 2x2 pixels
+/// \param[in] _src Pixels of the level
+/// \param[in] _width Width of the level
+/// \param[in] _height Height of the level
+/// \param[in] _filter How pixels are averaged
+/// \return Pixels of the next level, half the size rounded down
+static std::vector<uint8_t> NextMipLevel(const std::vector<uint8_t> &_src,
+    unsigned int _width, unsigned int _height, MipFilter _filter)
+{
+  unsigned int width = std::max(_width / 2u, 1u);
+  unsigned int height = std::max(_height / 2u, 1u);
+  std::vector<uint8_t> dst(width * height * 4u);
+  const float *srgbToLinear = SrgbToLinear();
+
+  for (unsigned int y = 0; y < height; ++y)
+  {
+    for (unsigned int x = 0; x < width; ++x)
+    {
+      float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+      unsigned int count = 0u;
+      for (unsigned int sy = y * 2u; sy < std::min(y * 2u + 2u, _height);
+          ++sy)
+      {
+        for (unsigned int sx = x * 2u; sx < std::min(x * 2u + 2u, _width);
+            ++sx)
+        {
+          const uint8_t *p = &_src[(sy * _width + sx) * 4u];
+          for (unsigned int c = 0; c < 4u; ++c)
+          {
+            if (_filter == MipFilter::SRGB && c < 3u)
+              sum[c] += srgbToLinear[p[c]];
+            else if (_filter == MipFilter::NORMAL && c < 3u)
+              sum[c] += p[c] / 127.5f - 1.0f;
+            else
+              sum[c] += p[c];
+          }
+          ++count;
+        }
+      }
+
+      uint8_t *p = &dst[(y * width + x) * 4u];
+      if (_filter == MipFilter::NORMAL)
+      {
+        float length = std::sqrt(sum[0] * sum[0] + sum[1] * sum[1] +
+            sum[2] * sum[2]);
+        for (unsigned int c = 0; c < 3u; ++c)
+        {
+          float n = length > 0.0f ? sum[c] / length : (c == 2u ? 1.0f : 0.0f);
+          p[c] = static_cast<uint8_t>((n + 1.0f) * 127.5f + 0.5f);
+        }
+      }
+      for (unsigned int c = 0; c < 4u; ++c)
+      {
+        if (_filter == MipFilter::SRGB && c < 3u)
+          p[c] = LinearToSrgb(sum[c] / count);
+        else if (_filter == MipFilter::LINEAR || c == 3u)
+          p[c] = static_cast<uint8_t>(sum[c] / count + 0.5f);
+      }
+    }
+  }
+  return dst;
+}
+
+//////////////////////////////////////////////////
+/// \brief Append a little endian 32 bit value to a buffer
+static void Append(std::string &_buffer, uint32_t _value)
+{
+  for (unsigned int i = 0; i < 4u; ++i)
+    _buffer.push_back(static_cast<char>((_value >> (8u * i)) & 0xFF));
+}
+
+//////////////////////////////////////////////////
+/// \brief Create the header of a DDS file with a DX10 extension
+/// \param[in] _width Width of the first mip level
+/// \param[in] _height Height of the first mip level
+/// \param[in] _mipCount Number of mip levels
+/// \param[in] _dxgiFormat DXGI format of the data
+/// \param[in] _topLevelSize Size in bytes of the first mip level
+/// \return Header
+static std::string DdsHeader(unsigned int _width, unsigned int _height,
+    unsigned int _mipCount, uint32_t _dxgiFormat, uint32_t _topLevelSize)
+{
+  std::string header("DDS ");
+  Append(header, 124u);
+  // caps, height, width, pixel format, mipmap count and linear size
+  Append(header, 0x1u | 0x2u | 0x4u | 0x1000u | 0x20000u | 0x80000u);
+  Append(header, _height);
+  Append(header, _width);
+  Append(header, _topLevelSize);
+  Append(header, 0u);
+  Append(header, _mipCount);
+  for (unsigned int i = 0; i < 11u; ++i)
+    Append(header, 0u);
+
+  // pixel format, the actual format is in the DX10 extension
+  Append(header, 32u);
+  Append(header, 0x4u);
+  header += "DX10";
+  for (unsigned int i = 0; i < 5u; ++i)
+    Append(header, 0u);
+
+  // complex texture with mipmaps
+  Append(header, 0x8u | 0x1000u | 0x400000u);
+  for (unsigned int i = 0; i < 4u; ++i)
+    Append(header, 0u);
+
+  // DX10 extension: format, 2D texture, no flags, one slice
+  Append(header, _dxgiFormat);
+  Append(header, 3u);
+  Append(header, 0u);
+  Append(header, 1u);
+  Append(header, 0u);
+  return header;
+}
+
+//////////////////////////////////////////////////
+/// \brief Load an image and convert it to 8 bit RGBA
+/// \param[in] _texture Path of the image
+/// \param[out] _width Image width
+/// \param[out] _height Image height
+/// \param[out] _pixels RGBA pixels, in rows
+/// \return False if the image could not be loaded or converted
+static bool LoadRgba(const std::string &_texture, unsigned int &_width,
+    unsigned int &_height, std::vector<uint8_t> &_pixels)
+{
+  Ogre::Image2 image;
+  try
+  {
+    std::ifstream stream(_texture, std::ios::binary);
+    Ogre::DataStreamPtr dataStream(
+        OGRE_NEW Ogre::FileStreamDataStream(_texture, &stream, false));
+    std::string ext = _texture.substr(_texture.rfind('.') + 1u);
+    image.load(dataStream, ext);
+  }
+  catch(Ogre::Exception &e)
+  {
+    ignwarn << "Unable to load texture [" << _texture << "] to compress it: "
+            << e.getDescription() << std::endl;
+    return false;
+  }
+
+  Ogre::PixelFormatGpu format = image.getPixelFormat();
+  size_t components = Ogre::PixelFormatGpuUtils::getNumberOfComponents(format);
+  if (image.getTextureType() != Ogre::TextureTypes::Type2D ||
+      Ogre::PixelFormatGpuUtils::isCompressed(format) || components == 2u)
+  {
+    return false;
+  }
+
+  _width = image.getWidth();
+  _height = image.getHeight();
+  _pixels.resize(_width * _height * 4u);
+  Ogre::TextureBox dstBox(_width, _height, 1u, 1u, 4u, _width * 4u,
+      _width * _height * 4u);
+  dstBox.data = _pixels.data();
+  Ogre::PixelFormatGpuUtils::bulkPixelConversion(image.getData(0u), format,
+      dstBox, Ogre::PFG_RGBA8_UNORM);
+
+  // grayscale images are converted to red only
+  if (components == 1u)
+  {
+    for (size_t i = 0; i < _pixels.size(); i += 4u)
+      _pixels[i + 1u] = _pixels[i + 2u] = _pixels[i];
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the name of the cache file of a texture
+/// \param[in] _texture Path of the source image
+/// \param[in] _cachePath Cache directory
+/// \param[in] _type Texture unit of the material using the texture
+/// \param[in] _srgb True if the texture holds sRGB encoded colors
+/// \return Path of the cache file, empty if the image can not be read
+static std::string CacheFile(const std::string &_texture,
+    const std::string &_cachePath, Ogre::PbsTextureTypes _type, bool _srgb)
+{
+  std::ifstream source(_texture, std::ios::binary);
+  std::string content((std::istreambuf_iterator<char>(source)),
+      std::istreambuf_iterator<char>());
+  if (content.empty())
+    return std::string();
+
+  std::stringstream key;
+  key << common::sha1<std::string>(content) << "::" << content.size() << "::"
+      << (_type == Ogre::PBSM_NORMAL) << "::" << _srgb << "::"
+      << kTextureCacheVersion;
+
+  return common::joinPaths(_cachePath,
+      common::sha1<std::string>(key.str()) + ".dds");
+}
+
+//////////////////////////////////////////////////
+/// \brief Write a file of the cache. Concurrent processes sharing the
+/// cache never read a partially written file.
+/// \param[in] _file Path of the cache file
+/// \param[in] _header File header
+/// \param[in] _data File data
+/// \param[in] _size Size of the data in bytes
+/// \return True if the file exists afterwards
+static bool WriteCacheFile(const std::string &_file,
+    const std::string &_header, const char *_data, size_t _size)
+{
+  bool written = writeFileAtomically(_file,
+      [&](const std::string &_tmpFile)
+  {
+    std::ofstream file(_tmpFile, std::ios::binary);
+    file.write(_header.data(), _header.size());
+    file.write(_data, _size);
+    file.close();
+    return static_cast<bool>(file);
+  });
+  if (!written)
+  {
+    ignwarn << "Unable to write texture cache file [" << _file << "]"
+            << std::endl;
+  }
+  return written;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get a copy of a cached texture without the mip levels larger
+/// than a resolution, creating it from the full texture if needed
+/// \param[in] _cacheFile Path of the full texture in the cache
+/// \param[in] _maxResolution Maximum width and height of the first level
+/// \return Path of the copy, the full texture if no level is dropped,
+/// empty on error
+static std::string ReducedTexture(const std::string &_cacheFile,
+    unsigned int _maxResolution)
+{
+  std::ifstream stream(_cacheFile, std::ios::binary);
+  std::string content((std::istreambuf_iterator<char>(stream)),
+      std::istreambuf_iterator<char>());
+
+  // the files are written by CompressedTexture, the header has a known
+  // size and layout
+  const size_t headerSize = 148u;
+  if (content.size() < headerSize || content.compare(0u, 4u, "DDS ") != 0)
+    return std::string();
+  auto read = [&content](size_t _offset)
+  {
+    uint32_t value = 0u;
+    for (unsigned int i = 0; i < 4u; ++i)
+    {
+      value |= static_cast<uint32_t>(
+          static_cast<uint8_t>(content[_offset + i])) << (8u * i);
+    }
+    return value;
+  };
+  unsigned int height = read(12u);
+  unsigned int width = read(16u);
+  unsigned int mipCount = read(28u);
+  uint32_t dxgiFormat = read(128u);
+  unsigned int blockBytes = (dxgiFormat == 71u || dxgiFormat == 72u) ?
+      8u : 16u;
+
+  // skip the levels larger than the maximum resolution
+  size_t offset = headerSize;
+  unsigned int level = 0u;
+  while (level + 1u < mipCount &&
+      std::max(width >> level, height >> level) > _maxResolution)
+  {
+    offset += static_cast<size_t>((std::max(width >> level, 1u) + 3u) / 4u) *
+        ((std::max(height >> level, 1u) + 3u) / 4u) * blockBytes;
+    ++level;
+  }
+  if (level == 0u)
+    return _cacheFile;
+  if (offset >= content.size())
+    return std::string();
+
+  std::stringstream file;
+  file << _cacheFile.substr(0u, _cacheFile.size() - 4u) << "_"
+       << _maxResolution << ".dds";
+  if (common::isFile(file.str()))
+    return file.str();
+
+  unsigned int levelWidth = std::max(width >> level, 1u);
+  unsigned int levelHeight = std::max(height >> level, 1u);
+  uint32_t topLevelSize = static_cast<uint32_t>(
+      ((levelWidth + 3u) / 4u) * ((levelHeight + 3u) / 4u) * blockBytes);
+  std::string header = DdsHeader(levelWidth, levelHeight, mipCount - level,
+      dxgiFormat, topLevelSize);
+  if (!WriteCacheFile(file.str(), header, content.data() + offset,
+      content.size() - offset))
+  {
+    return std::string();
+  }
+  return file.str();
+}
+
+//////////////////////////////////////////////////
+std::string CompressedTexture(const std::string &_texture,
+    const std::string &_cachePath, Ogre::PbsTextureTypes _type, bool _srgb,
+    unsigned int _maxResolution)
+{
+  IGN_PROFILE("CompressedTexture");
+  // cube maps are not supported
+  if (_type == Ogre::PBSM_REFLECTION || !common::isFile(_texture))
+    return std::string();
+
+  std::string cacheFile = CacheFile(_texture, _cachePath, _type, _srgb);
+  if (cacheFile.empty())
+    return cacheFile;
+  if (common::isFile(cacheFile))
+  {
+    return _maxResolution > 0u ?
+        ReducedTexture(cacheFile, _maxResolution) : cacheFile;
+  }
+
+  unsigned int width = 0u;
+  unsigned int height = 0u;
+  std::vector<uint8_t> pixels;
+  if (!LoadRgba(_texture, width, height, pixels))
+    return std::string();
+
+  BlockFormat format = BlockFormat::BC1;
+  MipFilter filter = _srgb ? MipFilter::SRGB : MipFilter::LINEAR;
+  if (_type == Ogre::PBSM_NORMAL)
+  {
+    format = BlockFormat::BC5;
+    filter = MipFilter::NORMAL;
+  }
+  else
+  {
+    for (size_t i = 3u; i < pixels.size(); i += 4u)
+    {
+      if (pixels[i] != 255u)
+      {
+        format = BlockFormat::BC3;
+        break;
+      }
+    }
+  }
+
+  // DXGI formats: BC1 71, BC3 77, BC5 83, the sRGB ones follow the linear
+  // ones
+  uint32_t dxgiFormat = format == BlockFormat::BC1 ? 71u :
+      (format == BlockFormat::BC3 ? 77u : 83u);
+  if (_srgb && format != BlockFormat::BC5)
+    ++dxgiFormat;
+  unsigned int blockBytes = format == BlockFormat::BC1 ? 8u : 16u;
+
+  unsigned int mipCount = 1u;
+  while ((std::max(width, height) >> mipCount) > 0u)
+    ++mipCount;
+
+  // encode the mip levels, block rows are split over the worker threads
+  Ogre2WorkerPool &workerPool = Ogre2RenderEngine::Instance()->WorkerPool();
+  unsigned int threadCount =
+      std::max(std::thread::hardware_concurrency(), 1u);
+  std::string data;
+  uint32_t topLevelSize = 0u;
+  unsigned int levelWidth = width;
+  unsigned int levelHeight = height;
+  for (unsigned int level = 0; level < mipCount; ++level)
+  {
+    if (level > 0u)
+    {
+      pixels = NextMipLevel(pixels, levelWidth, levelHeight, filter);
+      levelWidth = std::max(levelWidth / 2u, 1u);
+      levelHeight = std::max(levelHeight / 2u, 1u);
+    }
+
+    unsigned int blocksX = (levelWidth + 3u) / 4u;
+    unsigned int blocksY = (levelHeight + 3u) / 4u;
+    size_t levelSize = static_cast<size_t>(blocksX) * blocksY * blockBytes;
+    if (level == 0u)
+      topLevelSize = static_cast<uint32_t>(levelSize);
+
+    size_t offset = data.size();
+    data.resize(offset + levelSize);
+    uint8_t *dst = reinterpret_cast<uint8_t *>(&data[offset]);
+    const std::vector<uint8_t> &src = pixels;
+    unsigned int w = levelWidth;
+    unsigned int h = levelHeight;
+    workerPool.ParallelFor(blocksY, blocksX * blockBytes, threadCount,
+        [&](unsigned int _begin, unsigned int _end)
+        {
+          uint8_t block[64];
+          for (unsigned int by = _begin; by < _end; ++by)
+          {
+            for (unsigned int bx = 0; bx < blocksX; ++bx)
+            {
+              // blocks on the edges repeat the last row and column
+              for (unsigned int i = 0; i < 16u; ++i)
+              {
+                unsigned int x = std::min(bx * 4u + i % 4u, w - 1u);
+                unsigned int y = std::min(by * 4u + i / 4u, h - 1u);
+                std::copy_n(&src[(y * w + x) * 4u], 4u, &block[i * 4u]);
+              }
+
+              uint8_t *out = dst + (by * blocksX + bx) * blockBytes;
+              if (format == BlockFormat::BC1)
+                Ogre2BlockEncoders::EncodeBc1(block, out);
+              else if (format == BlockFormat::BC3)
+                Ogre2BlockEncoders::EncodeBc3(block, out);
+              else
+                Ogre2BlockEncoders::EncodeBc5(block, out);
+            }
+          }
+        });
+  }
+
+  std::string header = DdsHeader(width, height, mipCount, dxgiFormat,
+      topLevelSize);
+  if (!WriteCacheFile(cacheFile, header, data.data(), data.size()))
+    return std::string();
+  return _maxResolution > 0u ?
+      ReducedTexture(cacheFile, _maxResolution) : cacheFile;
+}
+
+//////////////////////////////////////////////////
+/// \brief Pack a color to 5:6:5 bits
+static uint16_t PackRgb565(const float *_color)
+{
+  auto quantize = [](float _value, unsigned int _max)
+  {
+    float v = std::min(std::max(_value, 0.0f), 255.0f);
+    return static_cast<unsigned int>(v * _max / 255.0f + 0.5f);
+  };
+  return static_cast<uint16_t>((quantize(_color[0], 31u) << 11u) |
+      (quantize(_color[1], 63u) << 5u) | quantize(_color[2], 31u));
+}
+
+//////////////////////////////////////////////////
+/// \brief Unpack a 5:6:5 color to 8 bit channels
+static void UnpackRgb565(uint16_t _packed, int *_color)
+{
+  int r = (_packed >> 11u) & 31;
+  int g = (_packed >> 5u) & 63;
+  int b = _packed & 31;
+  _color[0] = (r << 3) | (r >> 2);
+  _color[1] = (g << 2) | (g >> 4);
+  _color[2] = (b << 3) | (b >> 2);
+}
+
+//////////////////////////////////////////////////
+void Ogre2BlockEncoders::EncodeBc1(const uint8_t *_rgba, uint8_t *_dst)
+{
+  // fit the endpoints to the principal axis of the colors
+  float mean[3] = {0.0f, 0.0f, 0.0f};
+  for (unsigned int i = 0; i < 16u; ++i)
+  {
+    for (unsigned int c = 0; c < 3u; ++c)
+      mean[c] += _rgba[i * 4u + c] / 16.0f;
+  }
+
+  float cov[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+  for (unsigned int i = 0; i < 16u; ++i)
+  {
+    float r = _rgba[i * 4u] - mean[0];
+    float g = _rgba[i * 4u + 1u] - mean[1];
+    float b = _rgba[i * 4u + 2u] - mean[2];
+    cov[0] += r * r;
+    cov[1] += r * g;
+    cov[2] += r * b;
+    cov[3] += g * g;
+    cov[4] += g * b;
+    cov[5] += b * b;
+  }
+
+  float axis[3] = {1.0f, 1.0f, 1.0f};
+  for (unsigned int iter = 0; iter < 8u; ++iter)
+  {
+    float next[3] = {
+        cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2],
+        cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2],
+        cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2]};
+    float length = std::max(std::max(std::fabs(next[0]),
+        std::fabs(next[1])), std::fabs(next[2]));
+    if (length <= 0.0f)
+      break;
+    for (unsigned int c = 0; c < 3u; ++c)
+      axis[c] = next[c] / length;
+  }
+
+  float minProj = 0.0f;
+  float maxProj = 0.0f;
+  for (unsigned int i = 0; i < 16u; ++i)
+  {
+    float proj = 0.0f;
+    for (unsigned int c = 0; c < 3u; ++c)
+      proj += (_rgba[i * 4u + c] - mean[c]) * axis[c];
+    minProj = i == 0u ? proj : std::min(minProj, proj);
+    maxProj = i == 0u ? proj : std::max(maxProj, proj);
+  }
+
+  // project the extremes back on the axis, inset slightly so the
+  // interpolated colors cover the range better
+  float axisLength2 = axis[0] * axis[0] + axis[1] * axis[1] +
+      axis[2] * axis[2];
+  float inset = (maxProj - minProj) / 32.0f;
+  float maxColor[3];
+  float minColor[3];
+  for (unsigned int c = 0; c < 3u; ++c)
+  {
+    float scale = axisLength2 > 0.0f ? axis[c] / axisLength2 : 0.0f;
+    maxColor[c] = mean[c] + (maxProj - inset) * scale;
+    minColor[c] = mean[c] + (minProj + inset) * scale;
+  }
+
+  uint16_t c0 = PackRgb565(maxColor);
+  uint16_t c1 = PackRgb565(minColor);
+  // the four color mode needs c0 > c1
+  if (c0 < c1)
+    std::swap(c0, c1);
+
+  int palette[4][3];
+  UnpackRgb565(c0, palette[0]);
+  UnpackRgb565(c1, palette[1]);
+  for (unsigned int c = 0; c < 3u; ++c)
+  {
+    palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+    palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+  }
+
+  uint32_t indices = 0u;
+  if (c0 != c1)
+  {
+    for (unsigned int i = 0; i < 16u; ++i)
+    {
+      int best = 0;
+      int bestDist = 0;
+      for (int p = 0; p < 4; ++p)
+      {
+        int dist = 0;
+        for (unsigned int c = 0; c < 3u; ++c)
+        {
+          int d = _rgba[i * 4u + c] - palette[p][c];
+          dist += d * d;
+        }
+        if (p == 0 || dist < bestDist)
+        {
+          best = p;
+          bestDist = dist;
+        }
+      }
+      indices |= static_cast<uint32_t>(best) << (2u * i);
+    }
+  }
+
+  _dst[0] = static_cast<uint8_t>(c0 & 0xFF);
+  _dst[1] = static_cast<uint8_t>(c0 >> 8u);
+  _dst[2] = static_cast<uint8_t>(c1 & 0xFF);
+  _dst[3] = static_cast<uint8_t>(c1 >> 8u);
+  for (unsigned int i = 0; i < 4u; ++i)
+    _dst[4u + i] = static_cast<uint8_t>((indices >> (8u * i)) & 0xFF);
+}
+
+//////////////////////////////////////////////////
+void Ogre2BlockEncoders::EncodeBc4(const uint8_t *_rgba,
+    unsigned int _channel, uint8_t *_dst)
+{
+  int minValue = 255;
+  int maxValue = 0;
+  for (unsigned int i = 0; i < 16u; ++i)
+  {
+    minValue = std::min<int>(minValue, _rgba[i * 4u + _channel]);
+    maxValue = std::max<int>(maxValue, _rgba[i * 4u + _channel]);
+  }
+
+  // eight value mode: the endpoints and six interpolated values
+  int palette[8];
+  palette[0] = maxValue;
+  palette[1] = minValue;
+  for (int p = 2; p < 8; ++p)
+    palette[p] = ((8 - p) * maxValue + (p - 1) * minValue + 3) / 7;
+
+  uint64_t indices = 0u;
+  if (maxValue != minValue)
+  {
+    for (unsigned int i = 0; i < 16u; ++i)
+    {
+      int value = _rgba[i * 4u + _channel];
+      int best = 0;
+      for (int p = 1; p < 8; ++p)
+      {
+        if (std::abs(value - palette[p]) < std::abs(value - palette[best]))
+          best = p;
+      }
+      indices |= static_cast<uint64_t>(best) << (3u * i);
+    }
+  }
+
+  _dst[0] = static_cast<uint8_t>(maxValue);
+  _dst[1] = static_cast<uint8_t>(minValue);
+  for (unsigned int i = 0; i < 6u; ++i)
+    _dst[2u + i] = static_cast<uint8_t>((indices >> (8u * i)) & 0xFF);
+}
+
+//////////////////////////////////////////////////
+void Ogre2BlockEncoders::EncodeBc3(const uint8_t *_rgba, uint8_t *_dst)
+{
+  EncodeBc4(_rgba, 3u, _dst);
+  EncodeBc1(_rgba, _dst + 8u);
+}
+
+//////////////////////////////////////////////////
+void Ogre2BlockEncoders::EncodeBc5(const uint8_t *_rgba, uint8_t *_dst)
+{
+  EncodeBc4(_rgba, 0u, _dst);
+  EncodeBc4(_rgba, 1u, _dst + 8u);
+}
+}
+}
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2TEXTURECOMPRESSION_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2TEXTURECOMPRESSION_HH_
+
+#include <cstdint>
+#include <string>
+
+#include "ignition/rendering/config.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreHlmsPbsPrerequisites.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Get a block compressed copy of a material texture from an
+    /// on-disk cache, converting the texture on first use.
+    ///
+    /// The copy holds the full mip chain in a DDS file, so the texture is
+    /// uploaded as is instead of being decoded, converted and mipmapped on
+    /// every load, and takes 4 to 8 times less GPU memory than 8 bit RGBA.
+    /// The format depends on the use of the texture: BC5 for normal maps,
+    /// BC3 for color maps with transparent pixels and BC1 otherwise. Color
+    /// maps keep their sRGB encoding, their mip levels are filtered in
+    /// linear space.
+    ///
+    /// Cache files are named after a hash of the content of the source
+    /// image and the conversion settings, so editing the image creates a
+    /// new entry and several processes can share the cache.
+    ///
+    /// A maximum resolution drops the mip levels larger than it, so that
+    /// textures are only resident up to the level the cameras need. The
+    /// reduced copy is derived from the full one and cached too.
+    /// \param[in] _texture Path of the source image
+    /// \param[in] _cachePath Cache directory
+    /// \param[in] _type Texture unit of the material using the texture
+    /// \param[in] _srgb True if the texture holds sRGB encoded colors
+    /// \param[in] _maxResolution Maximum width and height of the first mip
+    /// level, 0 to keep all levels
+    /// \return Path of the compressed copy, empty if the texture can not
+    /// be compressed, e.g. a cube map or a luminance alpha image, in which
+    /// case the source image should be loaded instead
+    std::string CompressedTexture(const std::string &_texture,
+        const std::string &_cachePath, Ogre::PbsTextureTypes _type,
+        bool _srgb, unsigned int _maxResolution = 0u);
+
+    /// \brief Block encoders of the texture cache. They encode a block of
+    /// 4x4 pixels of 8 bit RGBA, pixels in rows, into 8 or 16 bytes.
+    namespace Ogre2BlockEncoders
+    {
+      /// \brief Encode the RGB channels of a block as BC1
+      /// \param[in] _rgba 16 RGBA pixels
+      /// \param[out] _dst 8 bytes
+      void EncodeBc1(const uint8_t *_rgba, uint8_t *_dst);
+
+      /// \brief Encode the RGBA channels of a block as BC3
+      /// \param[in] _rgba 16 RGBA pixels
+      /// \param[out] _dst 16 bytes
+      void EncodeBc3(const uint8_t *_rgba, uint8_t *_dst);
+
+      /// \brief Encode the red and green channels of a block as BC5
+      /// \param[in] _rgba 16 RGBA pixels
+      /// \param[out] _dst 16 bytes
+      void EncodeBc5(const uint8_t *_rgba, uint8_t *_dst);
+
+      /// \brief Encode one channel of a block as BC4
+      /// \param[in] _rgba 16 RGBA pixels
+      /// \param[in] _channel Index of the channel
+      /// \param[out] _dst 8 bytes
+      void EncodeBc4(const uint8_t *_rgba, unsigned int _channel,
+          uint8_t *_dst);
+    }
+    }
+  }
+}
+#endif
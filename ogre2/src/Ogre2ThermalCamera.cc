@@ -36,9 +36,11 @@
 
 #include <algorithm>
 #include <limits>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
 #ifdef _MSC_VER
 #pragma warning(push, 0)
@@ -54,6 +56,7 @@
 #include <ignition/math/Helpers.hh>
 
 #include "ignition/rendering/RenderTypes.hh"
+#include "ignition/rendering/ogre2/Ogre2Camera.hh"
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2Includes.hh"
 #include "ignition/rendering/ogre2/Ogre2Material.hh"
@@ -66,7 +69,13 @@
 #include "ignition/rendering/ogre2/Ogre2ThermalCamera.hh"
 #include "ignition/rendering/ogre2/Ogre2Visual.hh"
 
+#include "Ogre2MaterialOverride.hh"
+#include "Ogre2ShaderNoise.hh"
+#include "Ogre2VertexDeformation.hh"
+#include "Ogre2WorkerPool.hh"
+
 #include <ignition/common/Image.hh>
+#include <ignition/common/Profiler.hh>
 
 namespace ignition
 {
@@ -74,6 +83,94 @@ namespace rendering
 {
 inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
 //
+/// \brief Heat sources of the ogre items in a scene, resolved from the
+/// temperature user data of their visuals. Resolving them requires a
+/// visual lookup and parsing the user data of every item so the result is
+/// cached until visual temperatures change or items are added or removed,
+/// and shared by all thermal cameras in the same scene.
+/// Items added to or removed from visuals change the visibility layers
+/// revision of the scene.
+class Ogre2ThermalHeatSources
+{
+  /// \brief Type of heat source of an item
+  public: enum class HeatSourceType
+  {
+    /// \brief Not a heat source, temperature is derived from item color
+    NONE,
+
+    /// \brief Uniform temperature
+    TEMPERATURE,
+
+    /// \brief Heat signature texture
+    HEAT_SIGNATURE
+  };
+
+  /// \brief Resolved heat source of an item
+  public: struct HeatSource
+  {
+    /// \brief Id of the visual the item belongs to
+    unsigned int visualId = 0u;
+
+    /// \brief Visual the item belongs to
+    std::weak_ptr<Ogre2Visual> visual;
+
+    /// \brief Type of heat source
+    HeatSourceType type = HeatSourceType::NONE;
+
+    /// \brief Temperature in kelvin, used by TEMPERATURE heat sources
+    float temperature = 0.0f;
+
+    /// \brief Heat signature texture, used by HEAT_SIGNATURE heat sources
+    std::string heatSignature;
+
+    /// \brief True if minTemp and maxTemp are set for the heat signature
+    bool hasTemperatureRange = false;
+
+    /// \brief Min temperature of the heat signature
+    float minTemp = 0.0f;
+
+    /// \brief Max temperature of the heat signature
+    float maxTemp = 0.0f;
+  };
+
+  /// \brief Get the heat sources shared by thermal cameras of a scene
+  /// \param[in] _scene Scene the heat sources belong to
+  /// \return Heat sources of the scene, created if none exist yet
+  public: static std::shared_ptr<Ogre2ThermalHeatSources> Shared(
+              Ogre2ScenePtr _scene);
+
+  /// \brief Re-resolve the heat sources if they are out of date
+  /// \param[in] _scene Scene to resolve the heat sources from
+  public: void Update(Ogre2ScenePtr _scene);
+
+  /// \brief Check if the heat sources are out of date, i.e. if items were
+  /// added or removed, or visual temperatures changed since they were last
+  /// resolved
+  /// \param[in] _scene Scene to check
+  /// \return True if the heat sources need to be resolved again
+  private: bool Dirty(Ogre2ScenePtr _scene) const;
+
+  /// \brief Resolve the heat source of every item in the scene
+  /// \param[in] _scene Scene to resolve the heat sources from
+  private: void Resolve(Ogre2ScenePtr _scene);
+
+  /// \brief Heat source of each ogre item that belongs to a visual
+  public: std::unordered_map<Ogre::Item *, HeatSource> items;
+
+  /// \brief Incremented every time the heat sources are resolved
+  public: uint64_t revision = 0u;
+
+  /// \brief True if the heat sources have been resolved at least once
+  private: bool resolved = false;
+
+  /// \brief Scene temperatures revision the heat sources were resolved for
+  private: uint64_t temperaturesRevision = 0u;
+
+  /// \brief Scene visibility layers revision the heat sources were resolved
+  /// for
+  private: uint64_t itemsRevision = 0u;
+};
+
 /// \brief Helper class for switching the ogre item's material to heat source
 /// material when a thermal camera is being rendered.
 class Ogre2ThermalCameraMaterialSwitcher : public Ogre::Camera::Listener
@@ -105,9 +202,16 @@ class Ogre2ThermalCameraMaterialSwitcher : public Ogre::Camera::Listener
   private: virtual void cameraPostRenderScene(
     Ogre::Camera * _cam) override;
 
+  /// \brief Store the normalized temperature of the heat sources with a
+  /// uniform temperature on their sub items
+  private: void AssignTemperatures();
+
   /// \brief Scene manager
   private: Ogre2ScenePtr scene = nullptr;
 
+  /// \brief Heat sources of the scene, shared with other thermal cameras
+  private: std::shared_ptr<Ogre2ThermalHeatSources> heatSources;
+
   /// \brief Pointer to the heat source material
   private: Ogre::MaterialPtr heatSourceMaterial;
 
@@ -134,10 +238,32 @@ class Ogre2ThermalCameraMaterialSwitcher : public Ogre::Camera::Listener
   /// script in media/materials/scripts/thermal_camera.material
   private: const unsigned int customParamIdx = 10u;
 
+  /// \brief Custom parameter index of the normalized temperatures of the
+  /// sub items, which the hlms draw the items with, see
+  /// Ogre2MaterialOverride. They depend on the format and resolution of the
+  /// camera so each camera has its own.
+  private: size_t temperatureParamIdx = 0u;
+
+  /// \brief True if the temperatures need to be stored again because the
+  /// format or resolution changed
+  private: bool temperaturesDirty = true;
+
+  /// \brief Heat sources revision the temperatures were stored for
+  private: uint64_t heatSourcesRevision = 0u;
+
+  /// \brief Items with a heat signature, switched to their heat signature
+  /// material every pass
+  private: std::vector<Ogre::Item *> heatSignatureItems;
+
   /// \brief A map of ogre sub item pointer to their original hlms material
   private: std::unordered_map<Ogre::SubItem *, Ogre::HlmsDatablock *>
       datablockMap;
 
+  /// \brief A map of ogre sub items with low level materials to their
+  /// original material
+  private: std::unordered_map<Ogre::SubItem *, Ogre::MaterialPtr>
+      materialMap;
+
   /// \brief linear temperature resolution. Defaults to 10mK
   private: double resolution = 0.01;
 
@@ -183,11 +309,21 @@ class ignition::rendering::Ogre2ThermalCameraPrivate
   /// \brief The thermal material
   public: Ogre::MaterialPtr thermalMaterial;
 
+  /// \brief Material of the quad pass that primes the depth buffer of the
+  /// scene pass, see ThermalCamera::SetLinkedCamera
+  public: Ogre::MaterialPtr depthPrepassMaterial;
+
   /// \brief Event used to signal thermal image data
   public: ignition::common::EventT<void(const uint16_t *,
               unsigned int, unsigned int, unsigned int,
               const std::string &)> newThermalFrame;
 
+  /// \brief Event used to signal views of the thermal image data in the
+  /// camera image format
+  public: ignition::common::EventT<void(const void *,
+              unsigned int, unsigned int, unsigned int,
+              const std::string &)> newThermalFrameView;
+
   /// \brief Pointer to material switcher
   public: std::unique_ptr<Ogre2ThermalCameraMaterialSwitcher>
       thermalMaterialSwitcher = nullptr;
@@ -199,6 +335,10 @@ class ignition::rendering::Ogre2ThermalCameraPrivate
 
   /// \brief bit depth of each pixel
   public: unsigned int bitDepth = 16u;
+
+  /// \brief Gaussian noise of the render passes, applied by the thermal
+  /// shader
+  public: Ogre2ShaderNoise shaderNoise;
 };
 
 using namespace ignition;
@@ -221,6 +361,9 @@ Ogre2ThermalCameraMaterialSwitcher::Ogre2ThermalCameraMaterialSwitcher(
     getByName("ThermalHeatSignature");
 
   this->ogreCamera = this->scene->OgreSceneManager()->findCamera(this->name);
+
+  this->heatSources = Ogre2ThermalHeatSources::Shared(this->scene);
+  this->temperatureParamIdx = Ogre2MaterialOverride::NewParameterIndex();
 }
 
 //////////////////////////////////////////////////
@@ -228,201 +371,333 @@ void Ogre2ThermalCameraMaterialSwitcher::SetFormat(PixelFormat _format)
 {
   this->format = _format;
   this->bitDepth = 8u * PixelUtil::BytesPerChannel(format);
+  this->temperaturesDirty = true;
 }
 
 //////////////////////////////////////////////////
 void Ogre2ThermalCameraMaterialSwitcher::SetLinearResolution(double _resolution)
 {
   this->resolution = _resolution;
+  this->temperaturesDirty = true;
 }
 //////////////////////////////////////////////////
-void Ogre2ThermalCameraMaterialSwitcher::cameraPreRenderScene(
-    Ogre::Camera * /*_cam*/)
+std::shared_ptr<Ogre2ThermalHeatSources> Ogre2ThermalHeatSources::Shared(
+    Ogre2ScenePtr _scene)
 {
-  // swap item to use v1 shader material
-  // Note: keep an eye out for performance impact on switching materials
-  // on the fly. We are not doing this often so should be ok.
-  this->datablockMap.clear();
-  auto itor = this->scene->OgreSceneManager()->getMovableObjectIterator(
+  // heat sources are released when the last thermal camera of a scene is
+  // destroyed
+  auto &weak = _scene->ThermalHeatSources();
+  std::shared_ptr<Ogre2ThermalHeatSources> heatSources = weak.lock();
+  if (!heatSources)
+  {
+    heatSources = std::make_shared<Ogre2ThermalHeatSources>();
+    weak = heatSources;
+  }
+  return heatSources;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2ThermalHeatSources::Dirty(Ogre2ScenePtr _scene) const
+{
+  return !this->resolved ||
+      this->temperaturesRevision != _scene->TemperaturesRevision() ||
+      this->itemsRevision != _scene->VisibilityLayersRevision();
+}
+
+//////////////////////////////////////////////////
+void Ogre2ThermalHeatSources::Update(Ogre2ScenePtr _scene)
+{
+  if (this->Dirty(_scene))
+    this->Resolve(_scene);
+}
+
+//////////////////////////////////////////////////
+void Ogre2ThermalHeatSources::Resolve(Ogre2ScenePtr _scene)
+{
+  this->items.clear();
+  auto itor = _scene->OgreSceneManager()->getMovableObjectIterator(
       Ogre::ItemFactory::FACTORY_TYPE_NAME);
   while (itor.hasMoreElements())
   {
     Ogre::MovableObject *object = itor.peekNext();
     Ogre::Item *item = static_cast<Ogre::Item *>(object);
+    itor.moveNext();
 
     const std::string tempKey = "temperature";
     // get visual
     Ogre::Any userAny = item->getUserObjectBindings().getUserAny();
-    if (!userAny.isEmpty() && userAny.getType() == typeid(unsigned int))
+    if (userAny.isEmpty() || userAny.getType() != typeid(unsigned int))
+      continue;
+
+    HeatSource heatSource;
+    heatSource.visualId = Ogre::any_cast<unsigned int>(userAny);
+
+    VisualPtr result;
+    try
+    {
+      result = _scene->VisualById(heatSource.visualId);
+    }
+    catch(Ogre::Exception &e)
+    {
+      ignerr << "Ogre Error:" << e.getFullDescription() << "\n";
+    }
+    Ogre2VisualPtr ogreVisual =
+        std::dynamic_pointer_cast<Ogre2Visual>(result);
+    heatSource.visual = ogreVisual;
+
+    if (!ogreVisual)
+    {
+      this->items[item] = heatSource;
+      continue;
+    }
+
+    // get temperature
+    Variant tempAny = ogreVisual->UserData(tempKey);
+    if (tempAny.index() != 0 && !std::holds_alternative<std::string>(tempAny))
     {
-      VisualPtr result;
+      float temp = -1.0;
+      bool foundTemp = true;
       try
       {
-        result = this->scene->VisualById(Ogre::any_cast<unsigned int>(userAny));
-      }
-      catch(Ogre::Exception &e)
-      {
-        ignerr << "Ogre Error:" << e.getFullDescription() << "\n";
+        temp = std::get<float>(tempAny);
       }
-      Ogre2VisualPtr ogreVisual =
-          std::dynamic_pointer_cast<Ogre2Visual>(result);
-
-      // get temperature
-      Variant tempAny = ogreVisual->UserData(tempKey);
-      if (tempAny.index() != 0 && !std::holds_alternative<std::string>(tempAny))
+      catch(...)
       {
-        float temp = -1.0;
-        bool foundTemp = true;
         try
         {
-          temp = std::get<float>(tempAny);
+          temp = std::get<double>(tempAny);
         }
         catch(...)
         {
           try
           {
-            temp = std::get<double>(tempAny);
+            temp = std::get<int>(tempAny);
           }
-          catch(...)
+          catch(std::bad_variant_access &e)
           {
-            try
-            {
-              temp = std::get<int>(tempAny);
-            }
-            catch(std::bad_variant_access &e)
-            {
-              ignerr << "Error casting user data: " << e.what() << "\n";
-              temp = -1.0;
-              foundTemp = false;
-            }
+            ignerr << "Error casting user data: " << e.what() << "\n";
+            temp = -1.0;
+            foundTemp = false;
           }
         }
+      }
 
-        // if a non-positive temperature was given, clamp it to 0
-        if (foundTemp && temp < 0.0)
-        {
-          temp = 0.0;
-          ignwarn << "Unable to set negatve temperature for: "
-              << ogreVisual->Name() << ". Value cannot be lower than absolute "
-              << "zero. Clamping temperature to 0 degrees Kelvin."
-              << std::endl;
-        }
-        for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
-        {
-          Ogre::SubItem *subItem = item->getSubItem(i);
+      // if a non-positive temperature was given, clamp it to 0
+      if (foundTemp && temp < 0.0)
+      {
+        temp = 0.0;
+        ignwarn << "Unable to set negatve temperature for: "
+            << ogreVisual->Name() << ". Value cannot be lower than absolute "
+            << "zero. Clamping temperature to 0 degrees Kelvin."
+            << std::endl;
+      }
+      heatSource.type = HeatSourceType::TEMPERATURE;
+      heatSource.temperature = temp;
+    }
+    // get heat signature and the corresponding min/max temperature values
+    else if (auto heatSignature = std::get_if<std::string>(&tempAny))
+    {
+      heatSource.type = HeatSourceType::HEAT_SIGNATURE;
+      heatSource.heatSignature = *heatSignature;
+
+      auto minTempVariant = ogreVisual->UserData("minTemp");
+      auto maxTempVariant = ogreVisual->UserData("maxTemp");
+      auto minTemperature = std::get_if<float>(&minTempVariant);
+      auto maxTemperature = std::get_if<float>(&maxTempVariant);
+      if (minTemperature && maxTemperature)
+      {
+        heatSource.hasTemperatureRange = true;
+        heatSource.minTemp = *minTemperature;
+        heatSource.maxTemp = *maxTemperature;
+      }
+    }
 
-          // normalize temperature value
-          float color = (temp / this->resolution) / ((1 << bitDepth) - 1.0);
+    this->items[item] = heatSource;
+  }
 
-          // set g, b, a to 0. This will be used by shaders to determine
-          // if particular fragment is a heat source or not
-          // see media/materials/programs/thermal_camera_fs.glsl
-          subItem->setCustomParameter(this->customParamIdx,
-              Ogre::Vector4(color, 0, 0, 0.0));
-          Ogre::HlmsDatablock *datablock = subItem->getDatablock();
-          this->datablockMap[subItem] = datablock;
+  this->resolved = true;
+  this->temperaturesRevision = _scene->TemperaturesRevision();
+  this->itemsRevision = _scene->VisibilityLayersRevision();
+  ++this->revision;
+}
 
-          subItem->setMaterial(this->heatSourceMaterial);
-        }
+//////////////////////////////////////////////////
+void Ogre2ThermalCameraMaterialSwitcher::AssignTemperatures()
+{
+  // normalized temperatures depend on the camera format and resolution
+  float maxValue = (1 << bitDepth) - 1.0;
+  this->heatSignatureItems.clear();
+  for (const auto &[item, heatSource] : this->heatSources->items)
+  {
+    if (heatSource.type ==
+        Ogre2ThermalHeatSources::HeatSourceType::HEAT_SIGNATURE)
+    {
+      this->heatSignatureItems.push_back(item);
+    }
+
+    // set g, b, a to 0. This will be used by shaders to determine
+    // if particular fragment is a heat source or not
+    // see media/materials/programs/thermal_camera_fs.glsl
+    bool temperature = heatSource.type ==
+        Ogre2ThermalHeatSources::HeatSourceType::TEMPERATURE;
+    float color = (heatSource.temperature / this->resolution) / maxValue;
+    for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
+    {
+      Ogre::SubItem *subItem = item->getSubItem(i);
+      if (temperature)
+      {
+        subItem->setCustomParameter(this->temperatureParamIdx,
+            Ogre::Vector4(color, 0, 0, 0.0));
       }
-      // get heat signature and the corresponding min/max temperature values
-      else if (auto heatSignature = std::get_if<std::string>(&tempAny))
+      else
       {
-        // if this is the first time rendering the heat signature,
-        // we need to make sure that the texture is loaded and applied to
-        // the heat signature material before loading the material
-        if (this->heatSignatureMaterials.find(item->getId()) ==
-            this->heatSignatureMaterials.end())
-        {
-          // make sure the texture is in ogre's resource path
-          const auto &texture = *heatSignature;
-          auto engine = Ogre2RenderEngine::Instance();
-          engine->AddResourcePath(texture);
-
-          // create a material for this item, now that the texture has been
-          // searched for. We must clone the base heat signature material since
-          // different items may use different textures. We also append the
-          // item's ID to the end of the new material name to ensure new
-          // material uniqueness in case two items use the same heat signature
-          // texture, but have different temperature ranges
-          std::string baseName = common::basename(texture);
-          auto heatSignatureMaterial = this->baseHeatSigMaterial->clone(
-              this->name + "_" + baseName + "_" +
-              Ogre::StringConverter::toString(item->getId()));
-          auto textureUnitStatePtr = heatSignatureMaterial->
-            getTechnique(0)->getPass(0)->getTextureUnitState(0);
-          Ogre::String textureName = baseName;
-          textureUnitStatePtr->setTextureName(textureName);
-
-          // set temperature range for the heat signature
-          auto minTempVariant = ogreVisual->UserData("minTemp");
-          auto maxTempVariant = ogreVisual->UserData("maxTemp");
-          auto minTemperature = std::get_if<float>(&minTempVariant);
-          auto maxTemperature = std::get_if<float>(&maxTempVariant);
-          if (minTemperature && maxTemperature)
-          {
-            // make sure the temperature range is between [min, max] kelvin
-            // for the given pixel format and camera resolution
-            float maxTemp = ((1 << bitDepth) - 1.0) * this->resolution;
-            Ogre::GpuProgramParametersSharedPtr params =
-              heatSignatureMaterial->getTechnique(0)->getPass(0)->
-              getFragmentProgramParameters();
-            params->setNamedConstant("minTemp",
-                std::max(static_cast<float>(*minTemperature), 0.0f));
-            params->setNamedConstant("maxTemp",
-                std::min(static_cast<float>(*maxTemperature), maxTemp));
-            params->setNamedConstant("bitDepth",
-                static_cast<int>(this->bitDepth));
-            params->setNamedConstant("resolution",
-                static_cast<float>(this->resolution));
-          }
-          heatSignatureMaterial->load();
-          this->heatSignatureMaterials[item->getId()] = heatSignatureMaterial;
-        }
+        subItem->removeCustomParameter(this->temperatureParamIdx);
+      }
+    }
+  }
+  this->temperaturesDirty = false;
+  this->heatSourcesRevision = this->heatSources->revision;
+}
 
-        for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
-        {
-          Ogre::SubItem *subItem = item->getSubItem(i);
+//////////////////////////////////////////////////
+void Ogre2ThermalCameraMaterialSwitcher::cameraPreRenderScene(
+    Ogre::Camera * /*_cam*/)
+{
+  IGN_PROFILE("Ogre2ThermalCameraMaterialSwitcher::cameraPreRenderScene");
+  // only re-resolve heat sources if the scene changed, looking up the
+  // visual and temperature of each item is expensive in large scenes
+  this->heatSources->Update(this->scene);
+  if (this->temperaturesDirty ||
+      this->heatSourcesRevision != this->heatSources->revision)
+  {
+    this->AssignTemperatures();
+  }
 
-          Ogre::HlmsDatablock *datablock = subItem->getDatablock();
-          this->datablockMap[subItem] = datablock;
+  // the Pbs and Unlit hlms draw heat sources with the temperatures stored
+  // on their sub items, and the other items with their unlit color, which
+  // the thermal shader converts to a temperature
+  Ogre2RenderEngine::Instance()->MaterialOverride().Begin(
+      Ogre2MaterialOverrideMode::THERMAL, this->temperatureParamIdx,
+      Ogre::Vector4(0.0, 0.0, 0.0, -1.0));
 
-          subItem->setMaterial(this->heatSignatureMaterials[item->getId()]);
-        }
+  this->datablockMap.clear();
+  this->materialMap.clear();
+  auto save = [this](Ogre::SubItem *_subItem)
+  {
+    if (!_subItem->getMaterial().isNull())
+      this->materialMap[_subItem] = _subItem->getMaterial();
+    else
+      this->datablockMap[_subItem] = _subItem->getDatablock();
+  };
+
+  // sub items with low level materials are not drawn by those hlms and are
+  // still switched. Vertices deformed by a custom vertex shader are drawn
+  // deformed
+  for (Ogre::SubItem *subItem : this->scene->LowLevelSubItems())
+  {
+    auto it = this->heatSources->items.find(subItem->getParent());
+    if (it == this->heatSources->items.end())
+      continue;
+
+    if (it->second.type ==
+        Ogre2ThermalHeatSources::HeatSourceType::TEMPERATURE)
+    {
+      subItem->setCustomParameter(this->customParamIdx,
+          subItem->getCustomParameter(this->temperatureParamIdx));
+      save(subItem);
+      subItem->setMaterial(
+          DeformedMaterial(this->heatSourceMaterial, subItem));
+    }
+    // background objects. Sub items deformed by a custom vertex shader
+    // keep their material, the unlit datablock would undo the deformation
+    else if (it->second.type ==
+        Ogre2ThermalHeatSources::HeatSourceType::NONE &&
+        !DeformingMaterial(subItem))
+    {
+      Ogre2VisualPtr ogreVisual = it->second.visual.lock();
+      if (!ogreVisual || ogreVisual->GeometryCount() == 0u)
+        continue;
+
+      // we will be converting rgb values to temperature values in shaders
+      // but we want to make sure the object rgb values are not affected by
+      // lighting, so disable lighting
+      // Also check if objects are within camera view
+      Ogre::Aabb aabb = subItem->getParent()->getWorldAabbUpdated();
+      if (!this->ogreCamera->isVisible(
+          Ogre::AxisAlignedBox(aabb.getMinimum(), aabb.getMaximum())))
+      {
+        continue;
       }
-      // background objects
-      else
+      auto geom = ogreVisual->GeometryByIndex(0);
+      Ogre2MaterialPtr ogreMat = geom ?
+          std::dynamic_pointer_cast<Ogre2Material>(geom->Material()) :
+          nullptr;
+      if (!ogreMat)
+        continue;
+      save(subItem);
+      subItem->setDatablock(ogreMat->UnlitDatablock());
+    }
+  }
+
+  // heat signatures are textures sampled by a low level material
+  for (Ogre::Item *item : this->heatSignatureItems)
+  {
+    const auto &heatSource = this->heatSources->items.at(item);
+    // if this is the first time rendering the heat signature,
+    // we need to make sure that the texture is loaded and applied to
+    // the heat signature material before loading the material
+    auto heatSigIt = this->heatSignatureMaterials.find(item->getId());
+    if (heatSigIt == this->heatSignatureMaterials.end())
+    {
+      // make sure the texture is in ogre's resource path
+      const auto &texture = heatSource.heatSignature;
+      auto engine = Ogre2RenderEngine::Instance();
+      engine->AddResourcePath(texture);
+
+      // create a material for this item, now that the texture has been
+      // searched for. We must clone the base heat signature material since
+      // different items may use different textures. We also append the
+      // item's ID to the end of the new material name to ensure new
+      // material uniqueness in case two items use the same heat signature
+      // texture, but have different temperature ranges
+      std::string baseName = common::basename(texture);
+      auto heatSignatureMaterial = this->baseHeatSigMaterial->clone(
+          this->name + "_" + baseName + "_" +
+          Ogre::StringConverter::toString(item->getId()));
+      auto textureUnitStatePtr = heatSignatureMaterial->
+        getTechnique(0)->getPass(0)->getTextureUnitState(0);
+      Ogre::String textureName = baseName;
+      textureUnitStatePtr->setTextureName(textureName);
+
+      // set temperature range for the heat signature
+      if (heatSource.hasTemperatureRange)
       {
-        Ogre::Aabb aabb = item->getWorldAabbUpdated();
-        Ogre::AxisAlignedBox box = Ogre::AxisAlignedBox(aabb.getMinimum(),
-            aabb.getMaximum());
-
-        // we will be converting rgb values to temperature values in shaders
-        // but we want to make sure the object rgb values are not affected by
-        // lighting, so disable lighting
-        // Also check if objects are within camera view
-        if (ogreVisual->GeometryCount() > 0u &&
-            this->ogreCamera->isVisible(box))
-        {
-          auto geom = ogreVisual->GeometryByIndex(0);
-          if (geom)
-          {
-            MaterialPtr mat = geom->Material();
-            Ogre2MaterialPtr ogreMat =
-                std::dynamic_pointer_cast<Ogre2Material>(mat);
-            Ogre::HlmsUnlitDatablock *unlit = ogreMat->UnlitDatablock();
-            for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
-            {
-              Ogre::SubItem *subItem = item->getSubItem(i);
-              Ogre::HlmsDatablock *datablock = subItem->getDatablock();
-              this->datablockMap[subItem] = datablock;
-              subItem->setDatablock(unlit);
-            }
-          }
-        }
+        // make sure the temperature range is between [min, max] kelvin
+        // for the given pixel format and camera resolution
+        float maxTemp = ((1 << bitDepth) - 1.0) * this->resolution;
+        Ogre::GpuProgramParametersSharedPtr params =
+          heatSignatureMaterial->getTechnique(0)->getPass(0)->
+          getFragmentProgramParameters();
+        params->setNamedConstant("minTemp",
+            std::max(heatSource.minTemp, 0.0f));
+        params->setNamedConstant("maxTemp",
+            std::min(heatSource.maxTemp, maxTemp));
+        params->setNamedConstant("bitDepth",
+            static_cast<int>(this->bitDepth));
+        params->setNamedConstant("resolution",
+            static_cast<float>(this->resolution));
       }
+      heatSignatureMaterial->load();
+      heatSigIt = this->heatSignatureMaterials.emplace(
+          item->getId(), heatSignatureMaterial).first;
+    }
+
+    for (unsigned int i = 0; i < item->getNumSubItems(); ++i)
+    {
+      Ogre::SubItem *subItem = item->getSubItem(i);
+      save(subItem);
+      subItem->setMaterial(heatSigIt->second);
     }
-    itor.moveNext();
   }
 }
 
@@ -430,12 +705,14 @@ void Ogre2ThermalCameraMaterialSwitcher::cameraPreRenderScene(
 void Ogre2ThermalCameraMaterialSwitcher::cameraPostRenderScene(
     Ogre::Camera * /*_cam*/)
 {
-  // restore item to use pbs hlms material
+  IGN_PROFILE("Ogre2ThermalCameraMaterialSwitcher::cameraPostRenderScene");
+  Ogre2RenderEngine::Instance()->MaterialOverride().End();
+
+  // restore the switched sub items
   for (auto it : this->datablockMap)
-  {
-    Ogre::SubItem *subItem = it.first;
-    subItem->setDatablock(it.second);
-  }
+    it.first->setDatablock(it.second);
+  for (auto &it : this->materialMap)
+    it.first->setMaterial(it.second);
 }
 
 //////////////////////////////////////////////////
@@ -500,6 +777,13 @@ void Ogre2ThermalCamera::Destroy()
         this->dataPtr->thermalMaterial->getName());
   }
 
+  if (this->dataPtr->depthPrepassMaterial)
+  {
+    Ogre::MaterialManager::getSingleton().remove(
+        this->dataPtr->depthPrepassMaterial->getName());
+    this->dataPtr->depthPrepassMaterial.reset();
+  }
+
   if (!this->dataPtr->ogreCompositorWorkspaceDef.empty())
   {
     ogreCompMgr->removeWorkspaceDefinition(
@@ -645,6 +929,14 @@ void Ogre2ThermalCamera::CreateThermalTexture()
   psParams->setNamedConstant("bitDepth",
       static_cast<int>(this->dataPtr->bitDepth));
 
+  // The DepthPrepass material is defined in script (depth_prepass.material).
+  // It is cloned so the linked depth texture can be bound per camera
+  Ogre::MaterialPtr matDepthPrepass =
+      Ogre::MaterialManager::getSingleton().getByName("DepthPrepass");
+  this->dataPtr->depthPrepassMaterial = matDepthPrepass->clone(
+      this->Name() + "_DepthPrepass");
+  this->dataPtr->depthPrepassMaterial->load();
+
   // Create thermal camera compositor
   auto engine = Ogre2RenderEngine::Instance();
   auto ogreRoot = engine->OgreRoot();
@@ -667,12 +959,15 @@ void Ogre2ThermalCamera::CreateThermalTexture()
   //
   //   target colorTexture
   //   {
-  //     pass clear
+  //     pass render_quad
   //     {
-  //       colour_value 0.0 0.0 0.0 1.0
+  //       // writes the depth of the linked camera, or the far plane
+  //       load { all clear colour_value 0.0 0.0 0.0 1.0 }
+  //       material DepthPrepass // Use copy instead of original
   //     }
   //     pass render_scene
   //     {
+  //       load { all load }
   //     }
   //   }
   //   target rt_input
@@ -741,14 +1036,24 @@ void Ogre2ThermalCamera::CreateThermalTexture()
     nodeDef->setNumTargetPass(2);
     Ogre::CompositorTargetDef *colorTargetDef =
         nodeDef->addTargetPass("colorTexture");
-    colorTargetDef->setNumPasses(1);
+    colorTargetDef->setNumPasses(2);
     {
+      // depth prepass. Writes every pixel, which also clears the depth
+      Ogre::CompositorPassQuadDef *passDepth =
+          static_cast<Ogre::CompositorPassQuadDef *>(
+          colorTargetDef->addPass(Ogre::PASS_QUAD));
+      passDepth->setAllLoadActions(Ogre::LoadAction::Clear);
+      passDepth->setAllClearColours(Ogre::ColourValue(0, 0, 0));
+      passDepth->mMaterialName =
+          this->dataPtr->depthPrepassMaterial->getName();
+
       // scene pass
       Ogre::CompositorPassSceneDef *passScene =
           static_cast<Ogre::CompositorPassSceneDef *>(
           colorTargetDef->addPass(Ogre::PASS_SCENE));
-      passScene->setAllLoadActions(Ogre::LoadAction::Clear);
-      passScene->setAllClearColours(Ogre::ColourValue(0, 0, 0));
+      // unlit pass, skip building the Forward+ light clusters
+      passScene->mEnableForwardPlus = false;
+      passScene->setAllLoadActions(Ogre::LoadAction::Load);
       // thermal camera should not see particles
       passScene->mVisibilityMask = IGN_VISIBILITY_ALL &
           ~Ogre2ParticleEmitter::kParticleVisibilityFlags;
@@ -812,6 +1117,7 @@ void Ogre2ThermalCamera::CreateThermalTexture()
         this->ogreCamera,
         wsDefName,
         false);
+  this->AddPassProfilers(this->dataPtr->ogreCompositorWorkspace);
 
   // add thermal material switcher to render target listener
   // so we can switch to use heat material when the camera is being udpated
@@ -837,6 +1143,9 @@ void Ogre2ThermalCamera::CreateThermalTexture()
 //////////////////////////////////////////////////
 void Ogre2ThermalCamera::Render()
 {
+  IGN_PROFILE("Ogre2ThermalCamera::Render");
+  this->RecordFrameSubmit();
+
   // GL_DEPTH_CLAMP is disabled in later version of ogre2.2
   // however our shaders rely on clamped values so enable it for this sensor
   auto engine = Ogre2RenderEngine::Instance();
@@ -848,6 +1157,10 @@ void Ogre2ThermalCamera::Render()
     glEnable(GL_DEPTH_CLAMP);
 #endif
 
+  this->BeginPassProfilers();
+
+  this->UpdateDepthPrepass();
+
   // update the compositors
   this->scene->StartRendering(this->ogreCamera);
 
@@ -868,18 +1181,73 @@ void Ogre2ThermalCamera::Render()
 #endif
 }
 
+//////////////////////////////////////////////////
+void Ogre2ThermalCamera::UpdateDepthPrepass()
+{
+  Ogre::Pass *pass =
+      this->dataPtr->depthPrepassMaterial->getTechnique(0)->getPass(0);
+
+  // the linked camera only hands out its depth if it was rendered from the
+  // same view at the current scene time
+  Ogre::TextureGpu *depthTexture = nullptr;
+  Ogre2CameraPtr linked =
+      std::dynamic_pointer_cast<Ogre2Camera>(this->linkedCamera.lock());
+  if (linked)
+  {
+    depthTexture = linked->DepthTextureFor(this->ogreCamera);
+    if (depthTexture &&
+        (depthTexture->getWidth() != this->ImageWidth() ||
+        depthTexture->getHeight() != this->ImageHeight()))
+    {
+      depthTexture = nullptr;
+    }
+  }
+
+  if (depthTexture)
+    pass->getTextureUnitState(0)->setTexture(depthTexture);
+  pass->getFragmentProgramParameters()->setNamedConstant("useLinkedDepth",
+      depthTexture ? 1 : 0);
+}
+
+//////////////////////////////////////////////////
+void Ogre2ThermalCamera::SetLinkedCamera(const CameraPtr &_camera)
+{
+  this->linkedCamera = _camera;
+
+  // the depth of the linked camera is only kept around with depth picking
+  if (_camera)
+    _camera->SetDepthPickingEnabled(true);
+}
+
 //////////////////////////////////////////////////
 void Ogre2ThermalCamera::PreRender()
 {
+  IGN_PROFILE("Ogre2ThermalCamera::PreRender");
   if (!this->dataPtr->ogreThermalTexture)
     this->CreateThermalTexture();
+
+  // gaussian noise passes are applied by the thermal shader, which samples
+  // new noise each frame
+  this->dataPtr->shaderNoise.Update(*this);
+  this->dataPtr->shaderNoise.Apply(
+      this->dataPtr->thermalMaterial->getTechnique(0)->getPass(0));
+
+  this->ogreCamera->setLodBias(this->LodBias());
 }
 
 //////////////////////////////////////////////////
 void Ogre2ThermalCamera::PostRender()
 {
-  if (this->dataPtr->newThermalFrame.ConnectionCount() <= 0u)
+  IGN_PROFILE("Ogre2ThermalCamera::PostRender");
+  bool frameSubscribers =
+      this->dataPtr->newThermalFrame.ConnectionCount() > 0u;
+  bool viewSubscribers =
+      this->dataPtr->newThermalFrameView.ConnectionCount() > 0u;
+  if (!frameSubscribers && !viewSubscribers)
+  {
+    this->RecordFrameDropped();
     return;
+  }
 
   unsigned int width = this->ImageWidth();
   unsigned int height = this->ImageHeight();
@@ -891,47 +1259,58 @@ void Ogre2ThermalCamera::PostRender()
 
   Ogre::Image2 image;
   image.convertFromTexture(this->dataPtr->ogreThermalTexture, 0u, 0u);
+  Ogre::TextureBox box = image.getData(0u);
+  this->RecordFrameGpuComplete();
 
-  if (!this->dataPtr->thermalImage)
+  if (viewSubscribers)
   {
-    this->dataPtr->thermalImage = new uint16_t[len];
+    this->dataPtr->newThermalFrameView(box.data, width, height,
+        static_cast<unsigned int>(box.bytesPerRow), PixelUtil::Name(format));
   }
 
-  Ogre::TextureBox box = image.getData(0u);
-  if (format == PF_L8)
+  // only widen to 16 bit if someone asked for it
+  if (!frameSubscribers)
   {
-    uint8_t *thermalBuffer = static_cast<uint8_t*>(box.data);
-    for (unsigned int i = 0u; i < height; ++i)
-    {
-      // the texture box step size could be larger than our image buffer step
-      // size
-      unsigned int rawDataRowIdx = i * box.bytesPerRow / bytesPerChannel;
-      for (unsigned int j = 0u; j < width; ++j)
-      {
-        unsigned int idx = (i * width) + j;
-        this->dataPtr->thermalImage[idx] = thermalBuffer[rawDataRowIdx + j];
-      }
-    }
+    this->RecordFrameDelivered();
+    return;
   }
-  else
+
+  if (!this->dataPtr->thermalImage)
   {
-    // fill thermal data
-    // copy data row by row. The texture box may not be a contiguous region of
-    // a texture
-    uint16_t * thermalBuffer = static_cast<uint16_t *>(box.data);
-    for (unsigned int i = 0; i < height; ++i)
-    {
-      unsigned int rawDataRowIdx = i * box.bytesPerRow / bytesPerChannel;
-      unsigned int rowIdx = i * width * channelCount;
-      memcpy(&this->dataPtr->thermalImage[rowIdx],
-          &thermalBuffer[rawDataRowIdx],
-          width * channelCount * bytesPerChannel);
-    }
+    this->dataPtr->thermalImage = new uint16_t[len];
   }
 
+  // convert row by row, split over the post processing threads of the
+  // scene. The texture box step size could be larger than our image buffer
+  // step size
+  uint16_t *thermalImage = this->dataPtr->thermalImage;
+  size_t rowBytes = width * channelCount * sizeof(uint16_t);
+  Ogre2RenderEngine::Instance()->WorkerPool().ParallelFor(height, rowBytes,
+      this->scene->PostProcessThreadCount(),
+      [&](unsigned int _begin, unsigned int _end)
+      {
+        if (format == PF_L8)
+        {
+          // widen 8 bit temperatures to 16 bit
+          Ogre2ReadbackKernels::Widen8To16(
+              static_cast<const uint8_t *>(box.data), box.bytesPerRow,
+              thermalImage, width, _begin, _end);
+        }
+        else
+        {
+          Ogre2ReadbackKernels::CopyRows(box.data, box.bytesPerRow,
+              thermalImage, rowBytes, width * channelCount * bytesPerChannel,
+              _begin, _end);
+        }
+      });
+
+  this->RecordFrameReadback();
+  IGN_PROFILE_BEGIN("Dispatch newThermalFrame");
   this->dataPtr->newThermalFrame(
       this->dataPtr->thermalImage, width, height, 1,
       PixelUtil::Name(format));
+  IGN_PROFILE_END();
+  this->RecordFrameDelivered();
 
   // Uncomment to debug thermal output
   // std::cout << "wxh: " << width << " x " << height << std::endl;
@@ -953,6 +1332,14 @@ common::ConnectionPtr Ogre2ThermalCamera::ConnectNewThermalFrame(
   return this->dataPtr->newThermalFrame.Connect(_subscriber);
 }
 
+//////////////////////////////////////////////////
+common::ConnectionPtr Ogre2ThermalCamera::ConnectNewThermalFrameView(
+    std::function<void(const void *, unsigned int, unsigned int,
+      unsigned int, const std::string &)> _subscriber)
+{
+  return this->dataPtr->newThermalFrameView.Connect(_subscriber);
+}
+
 //////////////////////////////////////////////////
 RenderTargetPtr Ogre2ThermalCamera::RenderTarget() const
 {
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "Ogre2TransientTextures.hh"
+
+#include <string>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreRoot.h>
+#include <OgreTextureGpu.h>
+#include <OgreTextureGpuManager.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+Ogre2TransientTextures::Ogre2TransientTextures() = default;
+
+//////////////////////////////////////////////////
+Ogre2TransientTextures::~Ogre2TransientTextures()
+{
+  // the texture manager is gone by now, the workspaces release their
+  // textures when they are destroyed with their scenes
+  if (!this->textures.empty())
+  {
+    ignwarn << this->textures.size() << " transient textures were not "
+            << "released" << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+Ogre::TextureGpu *Ogre2TransientTextures::Acquire(uint32_t _width,
+    uint32_t _height, Ogre::PixelFormatGpu _format, uint8_t _fsaa)
+{
+  if (_fsaa < 1u)
+    _fsaa = 1u;
+
+  Entry &entry = this->textures[Key(_width, _height, _format, _fsaa)];
+  entry.users++;
+  if (entry.texture)
+    return entry.texture;
+
+  Ogre::TextureGpuManager *textureMgr = Ogre2RenderEngine::Instance()->
+      OgreRoot()->getRenderSystem()->getTextureGpuManager();
+  entry.texture = textureMgr->createTexture(
+      "TransientTexture" + std::to_string(this->textureCounter++),
+      Ogre::GpuPageOutStrategy::Discard,
+      Ogre::TextureFlags::RenderToTexture,
+      Ogre::TextureTypes::Type2D);
+  entry.texture->setResolution(_width, _height);
+  entry.texture->setNumMipmaps(1u);
+  entry.texture->setPixelFormat(_format);
+  entry.texture->setMsaa(_fsaa);
+  entry.texture->scheduleTransitionTo(Ogre::GpuResidency::Resident);
+  return entry.texture;
+}
+
+//////////////////////////////////////////////////
+void Ogre2TransientTextures::Release(Ogre::TextureGpu *_texture)
+{
+  for (auto it = this->textures.begin(); it != this->textures.end(); ++it)
+  {
+    if (it->second.texture != _texture)
+      continue;
+
+    if (--it->second.users == 0u)
+    {
+      Ogre::TextureGpuManager *textureMgr = Ogre2RenderEngine::Instance()->
+          OgreRoot()->getRenderSystem()->getTextureGpuManager();
+      textureMgr->destroyTexture(_texture);
+      this->textures.erase(it);
+    }
+    return;
+  }
+
+  ignerr << "Unable to release a texture that is not a transient texture"
+         << std::endl;
+}
+
+//////////////////////////////////////////////////
+size_t Ogre2TransientTextures::TextureCount() const
+{
+  return this->textures.size();
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2TRANSIENTTEXTURES_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2TRANSIENTTEXTURES_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <tuple>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/ogre2/Export.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgrePixelFormatGpu.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+namespace Ogre
+{
+  class TextureGpu;
+}
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Render textures shared by the compositor workspaces of all
+    /// sensors, for intermediate results that are written and read within
+    /// a single workspace update, e.g. the multisampled color buffer the
+    /// scene passes render to before it is resolved.
+    ///
+    /// Workspaces are updated one after the other, so the content of such
+    /// a texture never has to survive until the next workspace runs, and
+    /// all sensors with the same resolution, format and anti-aliasing can
+    /// render to the same texture instead of allocating one each.
+    /// Textures are reference counted and destroyed once the last
+    /// workspace releases them.
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2TransientTextures
+    {
+      /// \brief Constructor
+      public: Ogre2TransientTextures();
+
+      /// \brief Destructor
+      public: ~Ogre2TransientTextures();
+
+      /// \brief Get a shared render texture, creating it if no workspace
+      /// uses one with the same settings yet. Every call must be matched
+      /// by a call to Release.
+      /// \param[in] _width Width in pixels
+      /// \param[in] _height Height in pixels
+      /// \param[in] _format Pixel format
+      /// \param[in] _fsaa Number of samples, 0 or 1 for none
+      /// \return Shared render texture
+      public: Ogre::TextureGpu *Acquire(uint32_t _width, uint32_t _height,
+                  Ogre::PixelFormatGpu _format, uint8_t _fsaa);
+
+      /// \brief Release a texture returned by Acquire
+      /// \param[in] _texture Texture to release
+      public: void Release(Ogre::TextureGpu *_texture);
+
+      /// \brief Get the number of textures in use
+      /// \return Number of textures
+      public: size_t TextureCount() const;
+
+      /// \brief Settings that identify a shared texture
+      private: using Key = std::tuple<uint32_t, uint32_t,
+                   Ogre::PixelFormatGpu, uint8_t>;
+
+      /// \brief A shared texture
+      private: struct Entry
+      {
+        /// \brief Ogre texture
+        Ogre::TextureGpu *texture = nullptr;
+
+        /// \brief Number of Acquire calls not released yet
+        unsigned int users = 0u;
+      };
+
+      /// \brief Shared textures by settings
+      private: std::map<Key, Entry> textures;
+
+      /// \brief Counter used to name the textures
+      private: unsigned int textureCounter = 0u;
+    };
+    }
+  }
+}
+#endif
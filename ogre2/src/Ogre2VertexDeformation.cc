@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <map>
+#include <vector>
+
+#include "Ogre2VertexDeformation.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreHlms.h>
+#include <OgreHlmsLowLevelDatablock.h>
+#include <OgreMaterialManager.h>
+#include <OgrePass.h>
+#include <OgreSubItem.h>
+#include <OgreTechnique.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+namespace ignition
+{
+namespace rendering
+{
+inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+//
+/// \brief Names of the sensor material copies created for each deforming
+/// material.
+/// Key: name of the deforming material, value: names of the copies
+static std::map<std::string, std::vector<std::string>> &DeformedCopies()
+{
+  static std::map<std::string, std::vector<std::string>> copies;
+  return copies;
+}
+
+//////////////////////////////////////////////////
+Ogre::MaterialPtr DeformingMaterial(Ogre::SubItem *_subItem)
+{
+  Ogre::MaterialPtr material = _subItem->getMaterial();
+
+  // sensors restore switched sub items by datablock, which drops the
+  // material but keeps it as the proxy of the low level datablock
+  Ogre::HlmsDatablock *datablock = _subItem->getDatablock();
+  if (!material && datablock &&
+      datablock->getCreator()->getType() == Ogre::HLMS_LOW_LEVEL)
+  {
+    material =
+        static_cast<Ogre::HlmsLowLevelDatablock *>(datablock)->mProxyMaterial;
+  }
+
+  if (!material || material->getNumTechniques() == 0u ||
+      material->getTechnique(0u)->getNumPasses() == 0u ||
+      !material->getTechnique(0u)->getPass(0u)->hasVertexProgram())
+  {
+    return Ogre::MaterialPtr();
+  }
+  return material;
+}
+
+//////////////////////////////////////////////////
+Ogre::MaterialPtr DeformedMaterial(const Ogre::MaterialPtr &_sensorMaterial,
+    Ogre::SubItem *_subItem)
+{
+  Ogre::MaterialPtr itemMaterial = DeformingMaterial(_subItem);
+  if (!itemMaterial || itemMaterial == _sensorMaterial)
+    return _sensorMaterial;
+
+  Ogre::Pass *itemPass = itemMaterial->getTechnique(0u)->getPass(0u);
+  Ogre::Pass *sensorPass = _sensorMaterial->getTechnique(0u)->getPass(0u);
+
+  // one copy per sensor material and deforming material, shared by all the
+  // sub items and sensors that use them
+  std::string name = _sensorMaterial->getName() + "::" +
+      itemMaterial->getName();
+  Ogre::MaterialManager &matManager = Ogre::MaterialManager::getSingleton();
+  Ogre::MaterialPtr deformed = matManager.getByName(name);
+  if (!deformed)
+  {
+    deformed = _sensorMaterial->clone(name);
+    deformed->getTechnique(0u)->getPass(0u)->setVertexProgram(
+        itemPass->getVertexProgramName());
+    deformed->load();
+    DeformedCopies()[itemMaterial->getName()].push_back(name);
+  }
+
+  // the sensor updates its constants every frame, e.g. the min range of
+  // gpu rays, and the deformation parameters may change every frame too,
+  // e.g. the time of animated waves
+  Ogre::GpuProgramParametersSharedPtr params =
+      deformed->getTechnique(0u)->getPass(0u)->getVertexProgramParameters();
+  params->copyMatchingNamedConstantsFrom(
+      *sensorPass->getVertexProgramParameters());
+  params->copyMatchingNamedConstantsFrom(
+      *itemPass->getVertexProgramParameters());
+
+  return deformed;
+}
+
+//////////////////////////////////////////////////
+void DestroyDeformedMaterials(const std::string &_materialName)
+{
+  auto it = DeformedCopies().find(_materialName);
+  if (it == DeformedCopies().end())
+    return;
+
+  Ogre::MaterialManager &matManager = Ogre::MaterialManager::getSingleton();
+  for (const auto &name : it->second)
+    matManager.remove(name);
+  DeformedCopies().erase(it);
+}
+}
+}
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2VERTEXDEFORMATION_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2VERTEXDEFORMATION_HH_
+
+#include <string>
+
+#include "ignition/rendering/config.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreMaterial.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+namespace Ogre
+{
+  class SubItem;
+}
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Get the material a sensor should switch a sub item to so
+    /// that the vertices stay deformed the way the sub item's own vertex
+    /// shader deforms them, e.g. animated waves.
+    ///
+    /// If the sub item is drawn with a low level material that has a
+    /// vertex program, a copy of the sensor material that runs that vertex
+    /// program instead of its own is returned. The constants of the copy
+    /// are refreshed from the sensor material first and the sub item's
+    /// material second, so the deformation parameters of the current frame
+    /// are used. Otherwise the sensor material is returned as is.
+    /// \param[in] _sensorMaterial Material the sensor draws items with
+    /// \param[in] _subItem Sub item to switch
+    /// \return Material to switch the sub item to
+    Ogre::MaterialPtr DeformedMaterial(
+        const Ogre::MaterialPtr &_sensorMaterial, Ogre::SubItem *_subItem);
+
+    /// \brief Get the low level material a sub item deforms its vertices
+    /// with
+    /// \param[in] _subItem Sub item to check
+    /// \return Low level material of the sub item, null if it is drawn with
+    /// an hlms datablock or its material has no vertex program
+    Ogre::MaterialPtr DeformingMaterial(Ogre::SubItem *_subItem);
+
+    /// \brief Destroy the sensor material copies created for a low level
+    /// material. Called when the material is destroyed.
+    /// \param[in] _materialName Name of the low level material
+    void DestroyDeformedMaterials(const std::string &_materialName);
+    }
+  }
+}
+#endif
@@ -19,8 +19,11 @@
 
 #include "ignition/rendering/ogre2/Ogre2Conversions.hh"
 #include "ignition/rendering/ogre2/Ogre2Geometry.hh"
+#include "ignition/rendering/ogre2/Ogre2Material.hh"
+#include "ignition/rendering/ogre2/Ogre2Mesh.hh"
 #include "ignition/rendering/ogre2/Ogre2ParticleEmitter.hh"
 #include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
 #include "ignition/rendering/ogre2/Ogre2Storage.hh"
 #include "ignition/rendering/ogre2/Ogre2Visual.hh"
 #include "ignition/rendering/Utils.hh"
@@ -29,6 +32,7 @@
   #pragma warning(push, 0)
 #endif
 #include <OgreItem.h>
+#include <OgreLight.h>
 #ifdef _MSC_VER
   #pragma warning(pop)
 #endif
@@ -41,6 +45,25 @@ class ignition::rendering::Ogre2VisualPrivate
 {
   /// \brief True if wireframe mode is enabled
   public: bool wireframe;
+
+  /// \brief Bounding box cached by LocalBoundingBox or BoundingBox
+  public: struct BoundsCache
+  {
+    /// \brief The cached bounding box
+    math::AxisAlignedBox box;
+
+    /// \brief Bounds stamp of the visual when the box was computed
+    uint64_t stamp = 0u;
+
+    /// \brief True if the box was computed
+    bool valid = false;
+  };
+
+  /// \brief Cached local bounding box
+  public: BoundsCache localBounds;
+
+  /// \brief Cached world bounding box
+  public: BoundsCache worldBounds;
 };
 
 //////////////////////////////////////////////////
@@ -65,6 +88,27 @@ void Ogre2Visual::SetWireframe(bool _show)
     return;
 
   this->dataPtr->wireframe = _show;
+
+  // the datablocks are modified directly below so the materials of the
+  // visual need their own copy of any shared datablock
+  for (unsigned int i = 0; i < this->GeometryCount(); ++i)
+  {
+    MeshPtr mesh = std::dynamic_pointer_cast<Mesh>(this->GeometryByIndex(i));
+    if (!mesh)
+      continue;
+
+    for (unsigned int j = 0; j < mesh->SubMeshCount(); ++j)
+    {
+      Ogre2SubMeshPtr subMesh =
+          std::dynamic_pointer_cast<Ogre2SubMesh>(mesh->SubMeshByIndex(j));
+      Ogre2MaterialPtr material = subMesh ?
+          std::dynamic_pointer_cast<Ogre2Material>(subMesh->Material()) :
+          nullptr;
+      if (material)
+        material->UnshareDatablock();
+    }
+  }
+
   for (unsigned int i = 0; i < this->ogreNode->numAttachedObjects();
       i++)
   {
@@ -103,6 +147,10 @@ void Ogre2Visual::SetVisible(bool _visible)
     return;
 
   this->ogreNode->setVisible(_visible);
+
+  // hidden objects are left out of the bounding boxes. Ogre cascades the
+  // visibility to the descendants
+  this->MarkSubtreeBoundsDirty();
 }
 
 //////////////////////////////////////////////////
@@ -118,6 +166,49 @@ void Ogre2Visual::SetVisibilityFlags(uint32_t _flags)
     this->ogreNode->getAttachedObject(i)->setVisibilityFlags(_flags
       & ~Ogre2ParticleEmitter::kParticleVisibilityFlags);
   }
+
+  // gui objects are left out of the bounding boxes
+  this->MarkBoundsDirty();
+  this->scene->MarkVisibilityLayersDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Visual::SetStatic(bool _static)
+{
+  BaseVisual::SetStatic(_static);
+
+  if (!this->ogreNode)
+    return;
+
+  // static nodes and objects live in the static memory managers of Ogre,
+  // whose transforms and bounds are only updated when they are flagged
+  // dirty instead of every frame
+  for (unsigned int i = 0; i < this->ogreNode->numAttachedObjects(); ++i)
+    this->ogreNode->getAttachedObject(i)->setStatic(_static);
+  this->ogreNode->setStatic(_static);
+  if (_static)
+    this->NotifyStaticDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2Visual::SetUserData(const std::string &_key, Variant _value)
+{
+  BaseVisual::SetUserData(_key, _value);
+
+  // segmentation cameras cache the colors assigned to labels
+  if (_key == "label" && this->scene)
+    this->scene->MarkLabelsDirty();
+
+  // thermal cameras cache the heat source of each item
+  if ((_key == "temperature" || _key == "minTemp" || _key == "maxTemp") &&
+      this->scene)
+  {
+    this->scene->MarkTemperaturesDirty();
+  }
+
+  // gpu rays cache the laser retro value of each item
+  if (_key == "laser_retro" && this->scene)
+    this->scene->MarkLaserRetrosDirty();
 }
 
 //////////////////////////////////////////////////
@@ -167,8 +258,15 @@ bool Ogre2Visual::AttachGeometry(GeometryPtr _geometry)
   ogreObj->setVisibilityFlags(this->visibilityFlags
       & ~Ogre2ParticleEmitter::kParticleVisibilityFlags);
 
+  // objects must match the static state of the node they are attached to
+  ogreObj->setStatic(this->ogreNode->isStatic());
+
   derived->SetParent(this->SharedThis());
   this->ogreNode->attachObject(ogreObj);
+  if (this->ogreNode->isStatic())
+    this->NotifyStaticDirty();
+  this->MarkBoundsDirty();
+  this->scene->MarkVisibilityLayersDirty();
 
   return true;
 }
@@ -196,25 +294,74 @@ bool Ogre2Visual::DetachGeometry(GeometryPtr _geometry)
   if (nullptr != derived->OgreObject())
     this->ogreNode->detachObject(derived->OgreObject());
   derived->SetParent(nullptr);
+  this->MarkBoundsDirty();
   return true;
 }
 
 //////////////////////////////////////////////////
 ignition::math::AxisAlignedBox Ogre2Visual::LocalBoundingBox() const
 {
-  ignition::math::AxisAlignedBox box;
-  this->BoundsHelper(box, true /* local frame */);
-  return box;
+  return this->CachedBounds(true /* local frame */);
 }
 
 //////////////////////////////////////////////////
 ignition::math::AxisAlignedBox Ogre2Visual::BoundingBox() const
 {
+  return this->CachedBounds(false /* world frame */);
+}
+
+//////////////////////////////////////////////////
+ignition::math::AxisAlignedBox Ogre2Visual::CachedBounds(bool _local) const
+{
+  Ogre2VisualPrivate::BoundsCache &cache = _local ?
+      this->dataPtr->localBounds : this->dataPtr->worldBounds;
+
+  uint64_t stamp = this->BoundsStamp();
+  if (cache.valid && cache.stamp == stamp)
+    return cache.box;
+
   ignition::math::AxisAlignedBox box;
-  this->BoundsHelper(box, false /* world frame */);
+  this->BoundsHelper(box, _local);
+
+  cache.box = box;
+  cache.stamp = stamp;
+  cache.valid = this->BoundsCacheable();
   return box;
 }
 
+//////////////////////////////////////////////////
+bool Ogre2Visual::BoundsCacheable() const
+{
+  if (!this->ogreNode)
+    return true;
+
+  // items and lights have fixed bounds, or notify the visual when their
+  // bounds change (see Ogre2DynamicRenderable). Other objects, e.g.
+  // particle systems, change their bounds every frame
+  for (size_t i = 0; i < this->ogreNode->numAttachedObjects(); ++i)
+  {
+    const Ogre::String &type =
+        this->ogreNode->getAttachedObject(i)->getMovableType();
+    if (type != Ogre::ItemFactory::FACTORY_TYPE_NAME &&
+        type != Ogre::LightFactory::FACTORY_TYPE_NAME)
+    {
+      return false;
+    }
+  }
+
+  auto childNodes = std::dynamic_pointer_cast<Ogre2NodeStore>(this->Children());
+  if (!childNodes)
+    return true;
+
+  for (auto it = childNodes->Begin(); it != childNodes->End(); ++it)
+  {
+    Ogre2VisualPtr visual = std::dynamic_pointer_cast<Ogre2Visual>(it->second);
+    if (visual && !visual->BoundsCacheable())
+      return false;
+  }
+  return true;
+}
+
 //////////////////////////////////////////////////
 void Ogre2Visual::BoundsHelper(ignition::math::AxisAlignedBox &_box,
     bool _local) const
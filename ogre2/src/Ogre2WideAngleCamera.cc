@@ -0,0 +1,641 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Profiler.hh>
+#include <ignition/math/Helpers.hh>
+
+#include "ignition/rendering/ogre2/Ogre2Conversions.hh"
+#include "ignition/rendering/ogre2/Ogre2Includes.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderEngine.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderTarget.hh"
+#include "ignition/rendering/ogre2/Ogre2RenderTypes.hh"
+#include "ignition/rendering/ogre2/Ogre2Scene.hh"
+#include "ignition/rendering/ogre2/Ogre2WideAngleCamera.hh"
+
+#include "Ogre2Cubemap.hh"
+
+/// \brief Private data for the Ogre2WideAngleCamera class
+class ignition::rendering::Ogre2WideAngleCameraPrivate
+{
+  /// \brief Cameras rendering the cubemap faces, created when first needed
+  public: Ogre::Camera *cubeCam[6] = {};
+
+  /// \brief Render textures of the cubemap faces rendered in the 1st pass
+  public: Ogre::TextureGpu *faceTextures[6] = {};
+
+  /// \brief 1st pass compositor workspaces, one per rendered face
+  public: Ogre::CompositorWorkspace *faceWorkspaces[6] = {};
+
+  /// \brief Cubemap faces sampled by the image
+  public: std::set<unsigned int> cubeFaceIdx;
+
+  /// \brief 1st pass workspace definition name
+  public: std::string faceWorkspaceDef;
+
+  /// \brief Texture with the cubemap face and uv coordinates of each pixel
+  public: Ogre::TextureGpu *cubeUVTexture = nullptr;
+
+  /// \brief 2nd pass material, a copy of WideAngleCamera
+  public: Ogre::MaterialPtr matSecondPass;
+
+  /// \brief 2nd pass workspace definition name
+  public: std::string secondPassWorkspaceDef;
+
+  /// \brief 2nd pass compositor workspace
+  public: Ogre::CompositorWorkspace *secondPassWorkspace = nullptr;
+
+  /// \brief Output texture written by the 2nd pass
+  public: Ogre::TextureGpu *outputTexture = nullptr;
+
+  /// \brief Staging ticket for reading back outputTexture
+  public: Ogre::AsyncTextureTicket *ticket = nullptr;
+
+  /// \brief True if the output was downloaded into the ticket during the
+  /// last render and is waiting to be mapped in PostRender
+  public: bool downloadPending = false;
+
+  /// \brief True if the lens changed since the textures were created
+  public: bool lensDirty = false;
+
+  /// \brief Image width the textures were created for
+  public: unsigned int width = 0u;
+
+  /// \brief Image height the textures were created for
+  public: unsigned int height = 0u;
+
+  /// \brief Horizontal fov the textures were created for
+  public: double hfov = 0.0;
+
+  /// \brief Image read back from the output texture, in RGB
+  public: std::vector<unsigned char> buffer;
+
+  /// \brief Dummy render texture holding the image size
+  public: RenderTexturePtr wideAngleTexture;
+
+  /// \brief New wide angle frame event to notify listeners with new data
+  public: common::EventT<void(const unsigned char *, unsigned int,
+      unsigned int, unsigned int, const std::string &)> newWideAngleFrame;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Smallest size of the cubemap face textures
+static const unsigned int kMinFaceSize = 64u;
+
+/// \brief Largest size of the cubemap face textures
+static const unsigned int kMaxFaceSize = 2048u;
+
+/////////////////////////////////////////////////
+Ogre2WideAngleCamera::Ogre2WideAngleCamera() :
+  dataPtr(new Ogre2WideAngleCameraPrivate())
+{
+}
+
+/////////////////////////////////////////////////
+Ogre2WideAngleCamera::~Ogre2WideAngleCamera()
+{
+  this->Destroy();
+}
+
+/////////////////////////////////////////////////
+void Ogre2WideAngleCamera::Init()
+{
+  BaseCamera::Init();
+
+  this->CreateCamera();
+
+  this->CreateRenderTexture();
+
+  this->SetImageFormat(PixelFormat::PF_R8G8B8);
+}
+
+/////////////////////////////////////////////////
+void Ogre2WideAngleCamera::Destroy()
+{
+  if (!this->ogreCamera)
+    return;
+
+  this->DestroyWideAngleTextures();
+
+  if (!this->dataPtr->faceWorkspaceDef.empty())
+  {
+    Ogre::CompositorManager2 *ogreCompMgr =
+        Ogre2RenderEngine::Instance()->OgreRoot()->getCompositorManager2();
+    ogreCompMgr->removeWorkspaceDefinition(this->dataPtr->faceWorkspaceDef);
+    this->dataPtr->faceWorkspaceDef.clear();
+  }
+
+  Ogre::SceneManager *ogreSceneManager = this->scene->OgreSceneManager();
+  if (ogreSceneManager == nullptr)
+  {
+    ignerr << "Scene manager cannot be obtained" << std::endl;
+  }
+  else
+  {
+    for (auto &cubeCam : this->dataPtr->cubeCam)
+    {
+      if (cubeCam)
+      {
+        ogreSceneManager->destroyCamera(cubeCam);
+        cubeCam = nullptr;
+      }
+    }
+    if (ogreSceneManager->findCameraNoThrow(this->name) != nullptr)
+      ogreSceneManager->destroyCamera(this->ogreCamera);
+  }
+  this->ogreCamera = nullptr;
+}
+
+/////////////////////////////////////////////////
+void Ogre2WideAngleCamera::CreateCamera()
+{
+  auto ogreSceneManager = this->scene->OgreSceneManager();
+  if (ogreSceneManager == nullptr)
+  {
+    ignerr << "Scene manager cannot be obtained" << std::endl;
+    return;
+  }
+
+  // the 2nd pass only draws a quad, but a workspace needs a camera
+  this->ogreCamera = ogreSceneManager->createCamera(this->Name());
+  if (this->ogreCamera == nullptr)
+  {
+    ignerr << "Ogre camera cannot be created" << std::endl;
+    return;
+  }
+
+  this->ogreCamera->detachFromParent();
+  this->ogreNode->attachObject(this->ogreCamera);
+
+  // rotate to ignition gazebo coord.
+  this->ogreCamera->yaw(Ogre::Degree(-90));
+  this->ogreCamera->roll(Ogre::Degree(-90));
+  this->ogreCamera->setFixedYawAxis(false);
+}
+
+/////////////////////////////////////////////////
+void Ogre2WideAngleCamera::CreateRenderTexture()
+{
+  RenderTexturePtr base = this->scene->CreateRenderTexture();
+  this->dataPtr->wideAngleTexture =
+    std::dynamic_pointer_cast<Ogre2RenderTexture>(base);
+  this->dataPtr->wideAngleTexture->SetWidth(1);
+  this->dataPtr->wideAngleTexture->SetHeight(1);
+}
+
+/////////////////////////////////////////////////
+RenderTargetPtr Ogre2WideAngleCamera::RenderTarget() const
+{
+  return this->dataPtr->wideAngleTexture;
+}
+
+/////////////////////////////////////////////////
+void Ogre2WideAngleCamera::SetLens(const CameraLens &_lens)
+{
+  BaseWideAngleCamera::SetLens(_lens);
+  this->dataPtr->lensDirty = true;
+}
+
+/////////////////////////////////////////////////
+void Ogre2WideAngleCamera::CreateSampleTexture()
+{
+  const unsigned int width = this->ImageWidth();
+  const unsigned int height = this->ImageHeight();
+  const double f = this->lens.EffectiveF(this->HFOV().Radian());
+
+  // create an RGBA texture (cubeUVTex) to pack info that tells the 2nd pass
+  // how to sample from the cubemap textures.
+  // Each pixel packs the follow data:
+  //   R: u coordinate on the cubemap face
+  //   G: v coordinate on the cubemap face
+  //   B: cubemap face index
+  //   A: 1 if the lens maps a ray to the pixel, 0 if the pixel is black
+  const size_t dataSize = Ogre::PixelFormatGpuUtils::getSizeBytes(
+    width, height, 1u, 1u, Ogre::PFG_RGBA32_FLOAT, 1u);
+  float *pDest = reinterpret_cast<float*>(
+    OGRE_MALLOC_SIMD(dataSize, Ogre::MEMCATEGORY_RESOURCE));
+
+  this->dataPtr->cubeFaceIdx.clear();
+  int index = 0;
+  for (unsigned int i = 0; i < height; ++i)
+  {
+    for (unsigned int j = 0; j < width; ++j)
+    {
+      // pixel center relative to the image center, in units of half the
+      // image width, x right and y down
+      double x = 2.0 * (j + 0.5) / width - 1.0;
+      double y = (2.0 * (i + 0.5) / height - 1.0) * height / width;
+      double r = std::sqrt(x * x + y * y);
+
+      double theta = 0.0;
+      bool valid = this->lens.Angle(r, f, theta) &&
+          theta <= this->lens.CutOffAngle();
+
+      // direction of the ray in the frame of a standard Y up cubemap
+      // (x right, y up, z forward)
+      math::Vector3d dir(0, 0, 1);
+      if (r > 1e-9)
+      {
+        double s = std::sin(theta) / r;
+        dir.Set(s * x, -s * y, std::cos(theta));
+      }
+
+      unsigned int faceIdx = 0u;
+      math::Vector2d uv = CubemapFaceUv(dir, faceIdx);
+      if (valid)
+        this->dataPtr->cubeFaceIdx.insert(faceIdx);
+
+      pDest[index++] = uv.X();
+      pDest[index++] = uv.Y();
+      pDest[index++] = faceIdx;
+      pDest[index++] = valid ? 1.0 : 0.0;
+    }
+  }
+
+  this->dataPtr->cubeUVTexture = CreateLookupTexture(
+      this->Name() + "_samplerTex", width, height, pDest);
+}
+
+/////////////////////////////////////////////////
+void Ogre2WideAngleCamera::CreateWideAngleTextures()
+{
+  this->dataPtr->width = this->ImageWidth();
+  this->dataPtr->height = this->ImageHeight();
+  this->dataPtr->hfov = this->HFOV().Radian();
+  this->dataPtr->lensDirty = false;
+
+  this->CreateSampleTexture();
+
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+  Ogre::TextureGpuManager *textureMgr =
+    ogreRoot->getRenderSystem()->getTextureGpuManager();
+
+  // the faces are rendered at the angular resolution of the image center,
+  // which is the highest for the predefined lenses
+  unsigned int faceSize = static_cast<unsigned int>(std::ceil(
+      this->dataPtr->width * IGN_PI * 0.5 /
+      std::max(this->dataPtr->hfov, 1e-3)));
+  faceSize = std::clamp(faceSize, kMinFaceSize, kMaxFaceSize);
+
+  // 1st pass: clear to the background color and render the scene
+  std::string faceWsDefName = "WideAngleCameraFaceWorkspace_" + this->Name();
+  this->dataPtr->faceWorkspaceDef = faceWsDefName;
+  if (!ogreCompMgr->hasWorkspaceDefinition(faceWsDefName))
+  {
+    ogreCompMgr->createBasicWorkspaceDef(faceWsDefName,
+        Ogre2Conversions::Convert(this->scene->BackgroundColor()));
+  }
+
+  Ogre::SceneManager *ogreSceneManager = this->scene->OgreSceneManager();
+  for (auto i : this->dataPtr->cubeFaceIdx)
+  {
+    // cameras are kept when the textures are created again
+    if (!this->dataPtr->cubeCam[i])
+    {
+      this->dataPtr->cubeCam[i] = ogreSceneManager->createCamera(
+          this->Name() + "_env" + std::to_string(i));
+      this->dataPtr->cubeCam[i]->detachFromParent();
+      this->ogreNode->attachObject(this->dataPtr->cubeCam[i]);
+      OrientCubemapCamera(this->dataPtr->cubeCam[i], i);
+    }
+    this->dataPtr->cubeCam[i]->setNearClipDistance(this->NearClipPlane());
+    this->dataPtr->cubeCam[i]->setFarClipDistance(this->FarClipPlane());
+
+    Ogre::TextureGpu *texture = textureMgr->createOrRetrieveTexture(
+        this->Name() + "_first_pass_" + std::to_string(i),
+        Ogre::GpuPageOutStrategy::SaveToSystemRam,
+        Ogre::TextureFlags::RenderToTexture,
+        Ogre::TextureTypes::Type2D);
+    texture->setResolution(faceSize, faceSize);
+    texture->setNumMipmaps(1u);
+    texture->setPixelFormat(Ogre::PFG_RGBA8_UNORM_SRGB);
+    texture->scheduleTransitionTo(Ogre::GpuResidency::Resident);
+    this->dataPtr->faceTextures[i] = texture;
+
+    this->dataPtr->faceWorkspaces[i] = ogreCompMgr->addWorkspace(
+        ogreSceneManager, texture, this->dataPtr->cubeCam[i],
+        faceWsDefName, false);
+    this->AddPassProfilers(this->dataPtr->faceWorkspaces[i]);
+  }
+
+  // 2nd pass: resample the cubemap. The WideAngleCamera material is
+  // defined in script (wide_angle_camera.material). Clone it since its
+  // texture units are set to the textures of this camera
+  std::string matName = "WideAngleCamera";
+  Ogre::MaterialPtr mat =
+      Ogre::MaterialManager::getSingleton().getByName(matName);
+  if (!mat)
+  {
+    ignerr << "Wide angle camera material not found: '" << matName << "'"
+           << std::endl;
+    return;
+  }
+  this->dataPtr->matSecondPass = mat->clone(this->Name() + "_" + matName);
+  this->dataPtr->matSecondPass->load();
+  Ogre::Pass *pass = this->dataPtr->matSecondPass->getTechnique(0)->getPass(0);
+  // texture unit indices match the ones in the material script
+  pass->getTextureUnitState(0)->setTexture(this->dataPtr->cubeUVTexture);
+  for (auto i : this->dataPtr->cubeFaceIdx)
+  {
+    pass->getTextureUnitState(1 + i)->setTexture(
+        this->dataPtr->faceTextures[i]);
+  }
+
+  // compositor_node WideAngleCamera2ndPass
+  // {
+  //   in 0 rt_input
+  //   target rt_input
+  //   {
+  //     pass render_quad
+  //     {
+  //       material WideAngleCamera // Use copy instead of original
+  //     }
+  //   }
+  //   out 0 rt_input
+  // }
+  std::string wsDefName = "WideAngleCamera2ndPassWorkspace_" + this->Name();
+  this->dataPtr->secondPassWorkspaceDef = wsDefName;
+  if (!ogreCompMgr->hasWorkspaceDefinition(wsDefName))
+  {
+    Ogre::CompositorNodeDef *nodeDef =
+        ogreCompMgr->addNodeDefinition(wsDefName + "/Node");
+    nodeDef->addTextureSourceName("rt_input", 0,
+        Ogre::TextureDefinitionBase::TEXTURE_INPUT);
+    nodeDef->setNumTargetPass(1);
+    Ogre::CompositorTargetDef *targetDef = nodeDef->addTargetPass("rt_input");
+    targetDef->setNumPasses(1);
+    {
+      Ogre::CompositorPassQuadDef *passQuad =
+          static_cast<Ogre::CompositorPassQuadDef *>(
+          targetDef->addPass(Ogre::PASS_QUAD));
+      passQuad->setAllLoadActions(Ogre::LoadAction::DontCare);
+      passQuad->mMaterialName = this->dataPtr->matSecondPass->getName();
+    }
+    nodeDef->mapOutputChannel(0, "rt_input");
+    Ogre::CompositorWorkspaceDef *workDef =
+        ogreCompMgr->addWorkspaceDefinition(wsDefName);
+    workDef->connectExternal(0, nodeDef->getName(), 0);
+  }
+
+  this->dataPtr->outputTexture = textureMgr->createOrRetrieveTexture(
+      this->Name() + "_second_pass",
+      Ogre::GpuPageOutStrategy::SaveToSystemRam,
+      Ogre::TextureFlags::RenderToTexture,
+      Ogre::TextureTypes::Type2D);
+  this->dataPtr->outputTexture->setResolution(this->dataPtr->width,
+      this->dataPtr->height);
+  this->dataPtr->outputTexture->setNumMipmaps(1u);
+  this->dataPtr->outputTexture->setPixelFormat(Ogre::PFG_RGBA8_UNORM_SRGB);
+  this->dataPtr->outputTexture->scheduleTransitionTo(
+      Ogre::GpuResidency::Resident);
+
+  // staging ticket used to read back the output without stalling right
+  // after rendering
+  this->dataPtr->ticket = textureMgr->createAsyncTextureTicket(
+      this->dataPtr->width, this->dataPtr->height, 1u,
+      Ogre::TextureTypes::Type2D, Ogre::PFG_RGBA8_UNORM_SRGB);
+
+  this->dataPtr->secondPassWorkspace = ogreCompMgr->addWorkspace(
+      ogreSceneManager, this->dataPtr->outputTexture, this->ogreCamera,
+      wsDefName, false);
+  this->AddPassProfilers(this->dataPtr->secondPassWorkspace);
+}
+
+/////////////////////////////////////////////////
+void Ogre2WideAngleCamera::DestroyWideAngleTextures()
+{
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+  Ogre::TextureGpuManager *textureMgr =
+    ogreRoot->getRenderSystem()->getTextureGpuManager();
+
+  if (this->dataPtr->secondPassWorkspace)
+  {
+    ogreCompMgr->removeWorkspace(this->dataPtr->secondPassWorkspace);
+    this->dataPtr->secondPassWorkspace = nullptr;
+  }
+  // the 2nd pass node definition refers to the material of this camera
+  if (!this->dataPtr->secondPassWorkspaceDef.empty())
+  {
+    ogreCompMgr->removeWorkspaceDefinition(
+        this->dataPtr->secondPassWorkspaceDef);
+    ogreCompMgr->removeNodeDefinition(
+        this->dataPtr->secondPassWorkspaceDef + "/Node");
+    this->dataPtr->secondPassWorkspaceDef.clear();
+  }
+
+  for (unsigned int i = 0; i < 6u; ++i)
+  {
+    if (this->dataPtr->faceWorkspaces[i])
+    {
+      ogreCompMgr->removeWorkspace(this->dataPtr->faceWorkspaces[i]);
+      this->dataPtr->faceWorkspaces[i] = nullptr;
+    }
+    if (this->dataPtr->faceTextures[i])
+    {
+      textureMgr->destroyTexture(this->dataPtr->faceTextures[i]);
+      this->dataPtr->faceTextures[i] = nullptr;
+    }
+  }
+  this->dataPtr->cubeFaceIdx.clear();
+
+  if (this->dataPtr->matSecondPass)
+  {
+    Ogre::MaterialManager::getSingleton().remove(
+        this->dataPtr->matSecondPass->getName());
+    this->dataPtr->matSecondPass.reset();
+  }
+
+  if (this->dataPtr->ticket)
+  {
+    textureMgr->destroyAsyncTextureTicket(this->dataPtr->ticket);
+    this->dataPtr->ticket = nullptr;
+  }
+
+  if (this->dataPtr->outputTexture)
+  {
+    textureMgr->destroyTexture(this->dataPtr->outputTexture);
+    this->dataPtr->outputTexture = nullptr;
+  }
+
+  if (this->dataPtr->cubeUVTexture)
+  {
+    textureMgr->destroyTexture(this->dataPtr->cubeUVTexture);
+    this->dataPtr->cubeUVTexture = nullptr;
+  }
+
+  this->dataPtr->downloadPending = false;
+}
+
+/////////////////////////////////////////////////
+void Ogre2WideAngleCamera::PreRender()
+{
+  IGN_PROFILE("Ogre2WideAngleCamera::PreRender");
+  // the lookup texture depends on the lens, fov and image size
+  if (this->dataPtr->cubeUVTexture &&
+      (this->dataPtr->lensDirty ||
+       this->dataPtr->width != this->ImageWidth() ||
+       this->dataPtr->height != this->ImageHeight() ||
+       !math::equal(this->dataPtr->hfov, this->HFOV().Radian())))
+  {
+    this->DestroyWideAngleTextures();
+  }
+
+  if (!this->dataPtr->cubeUVTexture)
+    this->CreateWideAngleTextures();
+
+  for (auto cubeCam : this->dataPtr->cubeCam)
+  {
+    if (cubeCam)
+      cubeCam->setLodBias(this->LodBias());
+  }
+}
+
+/////////////////////////////////////////////////
+void Ogre2WideAngleCamera::Render()
+{
+  IGN_PROFILE("Ogre2WideAngleCamera::Render");
+  if (!this->dataPtr->secondPassWorkspace)
+    return;
+
+  this->RecordFrameSubmit();
+  this->BeginPassProfilers();
+
+  this->scene->StartRendering(nullptr);
+
+  Ogre::vector<Ogre::TextureGpu *>::type swappedTargets;
+  swappedTargets.reserve(2u);
+  auto updateWorkspace = [&](Ogre::CompositorWorkspace *_workspace)
+  {
+    _workspace->setEnabled(true);
+    _workspace->_validateFinalTarget();
+    _workspace->_beginUpdate(false);
+    _workspace->_update();
+    _workspace->_endUpdate(false);
+
+    swappedTargets.clear();
+    _workspace->_swapFinalTarget(swappedTargets);
+    _workspace->setEnabled(false);
+  };
+
+  // only the faces the image samples are rendered
+  for (auto i : this->dataPtr->cubeFaceIdx)
+  {
+    this->scene->UpdateAllHeightmaps(this->dataPtr->cubeCam[i]);
+    updateWorkspace(this->dataPtr->faceWorkspaces[i]);
+  }
+  updateWorkspace(this->dataPtr->secondPassWorkspace);
+
+  // queue the readback right after rendering so PostRender only waits for
+  // the transfer
+  this->dataPtr->ticket->download(this->dataPtr->outputTexture, 0u, true);
+  this->dataPtr->downloadPending = true;
+
+  uint8_t numPasses = static_cast<uint8_t>(
+      this->dataPtr->cubeFaceIdx.size() + 1u);
+  this->scene->FlushGpuCommandsAndStartNewFrame(numPasses, false);
+}
+
+/////////////////////////////////////////////////
+void Ogre2WideAngleCamera::PostRender()
+{
+  IGN_PROFILE("Ogre2WideAngleCamera::PostRender");
+  if (!this->dataPtr->downloadPending)
+  {
+    this->RecordFrameDropped();
+    return;
+  }
+  this->dataPtr->downloadPending = false;
+
+  const unsigned int width = this->dataPtr->width;
+  const unsigned int height = this->dataPtr->height;
+  const unsigned int channelCount = 3u;
+  this->dataPtr->buffer.resize(width * height * channelCount);
+
+  // copy the RGBA texture data to the RGB buffer. Mapping waits for the GPU
+  // to finish the frame and the download
+  Ogre::TextureBox box = this->dataPtr->ticket->map(0u);
+  this->RecordFrameGpuComplete();
+  const unsigned char *src = static_cast<const unsigned char *>(box.data);
+  unsigned char *dst = this->dataPtr->buffer.data();
+  for (unsigned int row = 0; row < height; ++row)
+  {
+    const unsigned char *srcRow = src + row * box.bytesPerRow;
+    for (unsigned int column = 0; column < width; ++column)
+    {
+      *dst++ = srcRow[column * 4u];
+      *dst++ = srcRow[column * 4u + 1u];
+      *dst++ = srcRow[column * 4u + 2u];
+    }
+  }
+  this->dataPtr->ticket->unmap();
+  this->RecordFrameReadback();
+
+  IGN_PROFILE_BEGIN("Dispatch newWideAngleFrame");
+  this->dataPtr->newWideAngleFrame(this->dataPtr->buffer.data(), width,
+      height, channelCount, PixelUtil::Name(PF_R8G8B8));
+  IGN_PROFILE_END();
+  this->RecordFrameDelivered();
+}
+
+/////////////////////////////////////////////////
+void Ogre2WideAngleCamera::Copy(Image &_image) const
+{
+  if (_image.Width() != this->dataPtr->width ||
+      _image.Height() != this->dataPtr->height ||
+      _image.Format() != PF_R8G8B8)
+  {
+    ignerr << "Invalid image dimensions or format" << std::endl;
+    return;
+  }
+
+  if (this->dataPtr->buffer.empty())
+    return;
+
+  std::memcpy(_image.Data(), this->dataPtr->buffer.data(),
+      this->dataPtr->buffer.size());
+}
+
+/////////////////////////////////////////////////
+bool Ogre2WideAngleCamera::CopyAsync(Image &_image,
+    std::function<void()> _callback)
+{
+  this->Copy(_image);
+  if (_callback)
+    _callback();
+  return true;
+}
+
+/////////////////////////////////////////////////
+common::ConnectionPtr Ogre2WideAngleCamera::ConnectNewWideAngleFrame(
+    std::function<void(const unsigned char *, unsigned int, unsigned int,
+    unsigned int, const std::string &)> _subscriber)
+{
+  return this->dataPtr->newWideAngleFrame.Connect(_subscriber);
+}
@@ -0,0 +1,295 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <ignition/common/Profiler.hh>
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreBitwise.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+#include "Ogre2WorkerPool.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Minimum bytes written by a range of rows. Smaller ranges cost
+/// more in synchronization than they save.
+static const std::size_t kMinRangeBytes = 256u * 1024u;
+
+//////////////////////////////////////////////////
+Ogre2WorkerPool::~Ogre2WorkerPool()
+{
+  this->Stop();
+}
+
+//////////////////////////////////////////////////
+void Ogre2WorkerPool::ParallelFor(unsigned int _rows, std::size_t _rowBytes,
+    unsigned int _threadCount, const RowFunction &_function)
+{
+  if (_rows == 0u)
+    return;
+
+  std::size_t minRows = std::max<std::size_t>(1u,
+      kMinRangeBytes / std::max<std::size_t>(_rowBytes, 1u));
+  unsigned int rangeCount = static_cast<unsigned int>(std::min<std::size_t>(
+      _threadCount, (_rows + minRows - 1u) / minRows));
+  if (rangeCount <= 1u)
+  {
+    _function(0u, _rows);
+    return;
+  }
+
+  IGN_PROFILE("Ogre2WorkerPool::ParallelFor");
+  std::lock_guard<std::mutex> jobLock(this->jobMutex);
+  Job job;
+  job.function = &_function;
+  job.rows = _rows;
+  job.rangeCount = rangeCount;
+  job.rowsPerRange = (_rows + rangeCount - 1u) / rangeCount;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    while (this->workers.size() + 1u < rangeCount)
+      this->workers.emplace_back(&Ogre2WorkerPool::Work, this);
+
+    this->job = job;
+    this->nextRange = 0u;
+    this->doneRanges = 0u;
+    this->jobId++;
+  }
+  this->jobCondition.notify_all();
+
+  this->RunRanges(job);
+
+  // wait for the workers to leave the job too, a late worker could
+  // otherwise take a range of the next job with the parameters of this one
+  std::unique_lock<std::mutex> lock(this->mutex);
+  this->doneCondition.wait(lock, [&]()
+  {
+    return this->doneRanges == job.rangeCount && this->activeWorkers == 0u;
+  });
+  this->job = Job();
+}
+
+//////////////////////////////////////////////////
+void Ogre2WorkerPool::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stopping = true;
+  }
+  this->jobCondition.notify_all();
+  for (auto &worker : this->workers)
+    worker.join();
+  this->workers.clear();
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->stopping = false;
+}
+
+//////////////////////////////////////////////////
+void Ogre2WorkerPool::RunRanges(const Job &_job)
+{
+  unsigned int range;
+  while ((range = this->nextRange++) < _job.rangeCount)
+  {
+    unsigned int begin = range * _job.rowsPerRange;
+    unsigned int end = std::min(begin + _job.rowsPerRange, _job.rows);
+    if (begin < end)
+      (*_job.function)(begin, end);
+
+    if (++this->doneRanges == _job.rangeCount)
+    {
+      // lock so the notification can not slip in between the waiting
+      // thread checking the count and going to sleep
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->doneCondition.notify_all();
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2WorkerPool::Work()
+{
+  uint64_t lastJob = 0u;
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    this->jobCondition.wait(lock, [&]()
+    {
+      return this->stopping ||
+          (this->job.function && this->jobId != lastJob);
+    });
+    if (this->stopping)
+      return;
+
+    lastJob = this->jobId;
+    Job job = this->job;
+    ++this->activeWorkers;
+    lock.unlock();
+    this->RunRanges(job);
+    lock.lock();
+    if (--this->activeWorkers == 0u)
+      this->doneCondition.notify_all();
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2ReadbackKernels::CopyRows(const void *_src,
+    std::size_t _srcBytesPerRow, void *_dst, std::size_t _dstBytesPerRow,
+    std::size_t _rowBytes, unsigned int _begin, unsigned int _end)
+{
+  const unsigned char *src = static_cast<const unsigned char *>(_src);
+  unsigned char *dst = static_cast<unsigned char *>(_dst);
+  if (_srcBytesPerRow == _rowBytes && _dstBytesPerRow == _rowBytes)
+  {
+    std::memcpy(dst + _begin * _rowBytes, src + _begin * _rowBytes,
+        (_end - _begin) * _rowBytes);
+    return;
+  }
+
+  for (unsigned int i = _begin; i < _end; ++i)
+  {
+    std::memcpy(dst + i * _dstBytesPerRow, src + i * _srcBytesPerRow,
+        _rowBytes);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2ReadbackKernels::ExtractFirstChannel(const float *_src,
+    std::size_t _srcBytesPerRow, unsigned int _channels, float *_dst,
+    unsigned int _width, unsigned int _begin, unsigned int _end)
+{
+  const unsigned char *src = reinterpret_cast<const unsigned char *>(_src);
+  for (unsigned int i = _begin; i < _end; ++i)
+  {
+    const float *__restrict row =
+        reinterpret_cast<const float *>(src + i * _srcBytesPerRow);
+    float *__restrict out = _dst + static_cast<std::size_t>(i) * _width;
+    if (_channels == 1u)
+    {
+      std::memcpy(out, row, _width * sizeof(float));
+      continue;
+    }
+    for (unsigned int j = 0u; j < _width; ++j)
+      out[j] = row[j * _channels];
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2ReadbackKernels::RgbaToRgb(const float *_src,
+    std::size_t _srcBytesPerRow, float *_dst, unsigned int _width,
+    unsigned int _begin, unsigned int _end)
+{
+  const unsigned char *src = reinterpret_cast<const unsigned char *>(_src);
+  for (unsigned int i = _begin; i < _end; ++i)
+  {
+    const float *__restrict row =
+        reinterpret_cast<const float *>(src + i * _srcBytesPerRow);
+    float *__restrict out = _dst + static_cast<std::size_t>(i) * _width * 3u;
+    for (unsigned int j = 0u; j < _width; ++j)
+    {
+      out[j * 3u] = row[j * 4u];
+      out[j * 3u + 1u] = row[j * 4u + 1u];
+      out[j * 3u + 2u] = row[j * 4u + 2u];
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2ReadbackKernels::Widen8To16(const uint8_t *_src,
+    std::size_t _srcBytesPerRow, uint16_t *_dst, unsigned int _width,
+    unsigned int _begin, unsigned int _end)
+{
+  for (unsigned int i = _begin; i < _end; ++i)
+  {
+    const uint8_t *row = _src + i * _srcBytesPerRow;
+    std::copy(row, row + _width, _dst + static_cast<std::size_t>(i) * _width);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2ReadbackKernels::HalfToFloat(const uint16_t *_src,
+    std::size_t _srcBytesPerRow, float *_dst, unsigned int _values,
+    unsigned int _begin, unsigned int _end)
+{
+  const unsigned char *src = reinterpret_cast<const unsigned char *>(_src);
+  for (unsigned int i = _begin; i < _end; ++i)
+  {
+    const uint16_t *__restrict row =
+        reinterpret_cast<const uint16_t *>(src + i * _srcBytesPerRow);
+    float *__restrict out = _dst + static_cast<std::size_t>(i) * _values;
+    for (unsigned int j = 0u; j < _values; ++j)
+      out[j] = Ogre::Bitwise::halfToFloat(row[j]);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2ReadbackKernels::FloatToHalf(const float *_src, uint16_t *_dst,
+    unsigned int _values, unsigned int _begin, unsigned int _end)
+{
+  std::size_t first = static_cast<std::size_t>(_begin) * _values;
+  std::size_t last = static_cast<std::size_t>(_end) * _values;
+  for (std::size_t i = first; i < last; ++i)
+    _dst[i] = Ogre::Bitwise::floatToHalf(_src[i]);
+}
+
+//////////////////////////////////////////////////
+void Ogre2ReadbackKernels::MillimetersToMeters(const uint16_t *_src,
+    std::size_t _srcBytesPerRow, unsigned int _channels, float *_dst,
+    unsigned int _width, unsigned int _begin, unsigned int _end)
+{
+  const float inf = std::numeric_limits<float>::infinity();
+  const unsigned char *src = reinterpret_cast<const unsigned char *>(_src);
+  for (unsigned int i = _begin; i < _end; ++i)
+  {
+    const uint16_t *__restrict row =
+        reinterpret_cast<const uint16_t *>(src + i * _srcBytesPerRow);
+    float *__restrict out =
+        _dst + static_cast<std::size_t>(i) * _width * _channels;
+    for (unsigned int j = 0u; j < _width * _channels; j += _channels)
+    {
+      out[j] = row[j] == 0u ? inf : row[j] * 0.001f;
+      for (unsigned int c = 1u; c < _channels; ++c)
+        out[j + c] = row[j + c];
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2ReadbackKernels::MetersToMillimeters(const float *_src,
+    uint16_t *_dst, unsigned int _width, unsigned int _begin,
+    unsigned int _end)
+{
+  std::size_t first = static_cast<std::size_t>(_begin) * _width;
+  std::size_t last = static_cast<std::size_t>(_end) * _width;
+  for (std::size_t i = first; i < last; ++i)
+  {
+    // same rounding as the depth camera and gpu rays shaders
+    float mm = std::floor(_src[i] * 1000.0f + 0.5f);
+    _dst[i] = (_src[i] > 0.0f && mm <= 65535.0f) ?
+        static_cast<uint16_t>(mm) : 0u;
+  }
+}
@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OGRE2_OGRE2WORKERPOOL_HH_
+#define IGNITION_RENDERING_OGRE2_OGRE2WORKERPOOL_HH_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ignition/rendering/config.hh"
+#include "ignition/rendering/ogre2/Export.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Worker threads shared by the sensors of the engine to split
+    /// the CPU side conversion of read back images over several cores.
+    /// Work is split in ranges of rows, the calling thread processes one
+    /// of the ranges itself. Threads are started on first use.
+    class IGNITION_RENDERING_OGRE2_VISIBLE Ogre2WorkerPool
+    {
+      /// \brief Function processing the rows [_begin, _end)
+      public: using RowFunction =
+                  std::function<void(unsigned int _begin, unsigned int _end)>;
+
+      /// \brief Constructor
+      public: Ogre2WorkerPool() = default;
+
+      /// \brief Destructor. Joins the worker threads.
+      public: ~Ogre2WorkerPool();
+
+      /// \brief Process rows on up to _threadCount threads, including the
+      /// calling one, and wait for all of them. Rows are processed on the
+      /// calling thread only if _threadCount is 1 or if there are too few
+      /// rows to be worth splitting.
+      /// \param[in] _rows Number of rows
+      /// \param[in] _rowBytes Bytes written per row, used to avoid splitting
+      /// small images
+      /// \param[in] _threadCount Maximum number of threads to use
+      /// \param[in] _function Function processing a range of rows
+      public: void ParallelFor(unsigned int _rows, std::size_t _rowBytes,
+                  unsigned int _threadCount, const RowFunction &_function);
+
+      /// \brief Stop and join the worker threads
+      public: void Stop();
+
+      /// \brief Parameters of a job, copied by the threads that run it
+      private: struct Job
+      {
+        /// \brief Function processing a range of rows
+        const RowFunction *function = nullptr;
+
+        /// \brief Number of rows
+        unsigned int rows = 0u;
+
+        /// \brief Rows per range
+        unsigned int rowsPerRange = 1u;
+
+        /// \brief Number of ranges
+        unsigned int rangeCount = 0u;
+      };
+
+      /// \brief Process ranges of a job until none is left
+      /// \param[in] _job Copy of the job taken under the mutex
+      private: void RunRanges(const Job &_job);
+
+      /// \brief Loop run by the worker threads
+      private: void Work();
+
+      /// \brief Protects the job and the worker list
+      private: std::mutex mutex;
+
+      /// \brief Serializes ParallelFor calls from several threads
+      private: std::mutex jobMutex;
+
+      /// \brief Signaled when a job starts or the pool stops
+      private: std::condition_variable jobCondition;
+
+      /// \brief Signaled when the last range of a job is done
+      private: std::condition_variable doneCondition;
+
+      /// \brief Worker threads
+      private: std::vector<std::thread> workers;
+
+      /// \brief Current job, its function is null if there is none
+      private: Job job;
+
+      /// \brief Number of workers running ranges of the current job.
+      /// ParallelFor returns once it drops to 0, so no worker can touch the
+      /// range counters or the function after the job is over.
+      private: unsigned int activeWorkers = 0u;
+
+      /// \brief Next range to process
+      private: std::atomic<unsigned int> nextRange{0u};
+
+      /// \brief Number of ranges processed
+      private: std::atomic<unsigned int> doneRanges{0u};
+
+      /// \brief Incremented for every job, so workers join each job once
+      private: uint64_t jobId = 0u;
+
+      /// \brief True when the workers should exit
+      private: bool stopping = false;
+    };
+
+    /// \brief Row conversion kernels of sensor readbacks. They work on a
+    /// range of rows so they can be run by Ogre2WorkerPool. The inner loops
+    /// are plain contiguous loops without aliasing that compilers vectorize.
+    namespace Ogre2ReadbackKernels
+    {
+      /// \brief Copy rows between buffers of different row pitch
+      /// \param[in] _src Source buffer
+      /// \param[in] _srcBytesPerRow Row pitch of the source
+      /// \param[out] _dst Destination buffer
+      /// \param[in] _dstBytesPerRow Row pitch of the destination
+      /// \param[in] _rowBytes Bytes to copy per row
+      /// \param[in] _begin First row
+      /// \param[in] _end Row after the last one
+      IGNITION_RENDERING_OGRE2_VISIBLE
+      void CopyRows(const void *_src, std::size_t _srcBytesPerRow,
+          void *_dst, std::size_t _dstBytesPerRow, std::size_t _rowBytes,
+          unsigned int _begin, unsigned int _end);
+
+      /// \brief Copy the first channel of interleaved float pixels to a
+      /// tightly packed single channel image
+      /// \param[in] _src Source buffer
+      /// \param[in] _srcBytesPerRow Row pitch of the source
+      /// \param[in] _channels Number of channels of the source
+      /// \param[out] _dst Destination buffer of _width floats per row
+      /// \param[in] _width Pixels per row
+      /// \param[in] _begin First row
+      /// \param[in] _end Row after the last one
+      IGNITION_RENDERING_OGRE2_VISIBLE
+      void ExtractFirstChannel(const float *_src, std::size_t _srcBytesPerRow,
+          unsigned int _channels, float *_dst, unsigned int _width,
+          unsigned int _begin, unsigned int _end);
+
+      /// \brief Convert RGBA float pixels to tightly packed RGB
+      /// \param[in] _src Source buffer
+      /// \param[in] _srcBytesPerRow Row pitch of the source
+      /// \param[out] _dst Destination buffer of _width * 3 floats per row
+      /// \param[in] _width Pixels per row
+      /// \param[in] _begin First row
+      /// \param[in] _end Row after the last one
+      IGNITION_RENDERING_OGRE2_VISIBLE
+      void RgbaToRgb(const float *_src, std::size_t _srcBytesPerRow,
+          float *_dst, unsigned int _width,
+          unsigned int _begin, unsigned int _end);
+
+      /// \brief Widen 8 bit pixels to 16 bit
+      /// \param[in] _src Source buffer
+      /// \param[in] _srcBytesPerRow Row pitch of the source
+      /// \param[out] _dst Destination buffer of _width values per row
+      /// \param[in] _width Pixels per row
+      /// \param[in] _begin First row
+      /// \param[in] _end Row after the last one
+      IGNITION_RENDERING_OGRE2_VISIBLE
+      void Widen8To16(const uint8_t *_src, std::size_t _srcBytesPerRow,
+          uint16_t *_dst, unsigned int _width,
+          unsigned int _begin, unsigned int _end);
+
+      /// \brief Convert 16 bit float values to 32 bit floats
+      /// \param[in] _src Source buffer
+      /// \param[in] _srcBytesPerRow Row pitch of the source
+      /// \param[out] _dst Destination buffer of _values floats per row
+      /// \param[in] _values Values per row
+      /// \param[in] _begin First row
+      /// \param[in] _end Row after the last one
+      IGNITION_RENDERING_OGRE2_VISIBLE
+      void HalfToFloat(const uint16_t *_src, std::size_t _srcBytesPerRow,
+          float *_dst, unsigned int _values,
+          unsigned int _begin, unsigned int _end);
+
+      /// \brief Convert tightly packed 32 bit floats to 16 bit floats
+      /// \param[in] _src Source buffer of _values floats per row
+      /// \param[out] _dst Destination buffer of _values halfs per row
+      /// \param[in] _values Values per row
+      /// \param[in] _begin First row
+      /// \param[in] _end Row after the last one
+      IGNITION_RENDERING_OGRE2_VISIBLE
+      void FloatToHalf(const float *_src, uint16_t *_dst,
+          unsigned int _values, unsigned int _begin, unsigned int _end);
+
+      /// \brief Decode 16 bit unsigned pixels whose first channel is a
+      /// distance in millimeters, 0 meaning no valid distance, to floats.
+      /// The first channel is converted to meters, +inf if not valid, the
+      /// other channels are copied as is.
+      /// \param[in] _src Source buffer
+      /// \param[in] _srcBytesPerRow Row pitch of the source
+      /// \param[in] _channels Number of channels
+      /// \param[out] _dst Destination buffer of _width * _channels floats
+      /// per row
+      /// \param[in] _width Pixels per row
+      /// \param[in] _begin First row
+      /// \param[in] _end Row after the last one
+      IGNITION_RENDERING_OGRE2_VISIBLE
+      void MillimetersToMeters(const uint16_t *_src,
+          std::size_t _srcBytesPerRow, unsigned int _channels, float *_dst,
+          unsigned int _width, unsigned int _begin, unsigned int _end);
+
+      /// \brief Encode tightly packed distances in meters to 16 bit
+      /// unsigned millimeters. Distances that are not finite, not positive
+      /// or too large to be encoded are 0.
+      /// \param[in] _src Source buffer of _width floats per row
+      /// \param[out] _dst Destination buffer of _width values per row
+      /// \param[in] _width Pixels per row
+      /// \param[in] _begin First row
+      /// \param[in] _end Row after the last one
+      IGNITION_RENDERING_OGRE2_VISIBLE
+      void MetersToMillimeters(const float *_src, uint16_t *_dst,
+          unsigned int _width, unsigned int _begin, unsigned int _end);
+    }
+    }
+  }
+}
+#endif
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "Ogre2WorkerPool.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(Ogre2WorkerPoolTest, ParallelFor)
+{
+  Ogre2WorkerPool pool;
+
+  // rows large enough to be split, every row is processed once
+  const unsigned int rows = 64u;
+  const std::size_t rowBytes = 1024u * 1024u;
+  for (unsigned int threads : {1u, 2u, 3u, 8u})
+  {
+    std::vector<std::atomic<unsigned int>> counts(rows);
+    std::atomic<unsigned int> calls(0u);
+    pool.ParallelFor(rows, rowBytes, threads,
+        [&](unsigned int _begin, unsigned int _end)
+        {
+          ++calls;
+          for (unsigned int i = _begin; i < _end; ++i)
+            ++counts[i];
+        });
+    for (const auto &count : counts)
+      EXPECT_EQ(1u, count);
+    EXPECT_LE(calls, threads);
+  }
+
+  // small images are processed in one call on the calling thread
+  std::thread::id caller = std::this_thread::get_id();
+  unsigned int calls = 0u;
+  pool.ParallelFor(rows, 16u, 8u,
+      [&](unsigned int _begin, unsigned int _end)
+      {
+        ++calls;
+        EXPECT_EQ(0u, _begin);
+        EXPECT_EQ(rows, _end);
+        EXPECT_EQ(caller, std::this_thread::get_id());
+      });
+  EXPECT_EQ(1u, calls);
+
+  // no rows, no call
+  pool.ParallelFor(0u, rowBytes, 8u,
+      [&](unsigned int, unsigned int) {++calls;});
+  EXPECT_EQ(1u, calls);
+
+  // the workers are started again after a stop
+  pool.Stop();
+  std::atomic<unsigned int> processed(0u);
+  pool.ParallelFor(rows, rowBytes, 4u,
+      [&](unsigned int _begin, unsigned int _end)
+      {
+        processed += _end - _begin;
+      });
+  EXPECT_EQ(rows, processed);
+}
+
+/////////////////////////////////////////////////
+TEST(Ogre2WorkerPoolTest, ConsecutiveJobs)
+{
+  // each job uses a function and data that only live for the job, a worker
+  // still running a finished job would write to freed memory or to the
+  // data of the next job
+  Ogre2WorkerPool pool;
+  const unsigned int rows = 16u;
+  const std::size_t rowBytes = 1024u * 1024u;
+  for (unsigned int job = 0u; job < 2000u; ++job)
+  {
+    std::vector<unsigned int> values(rows, 0u);
+    pool.ParallelFor(rows, rowBytes, 4u,
+        [&values, job](unsigned int _begin, unsigned int _end)
+        {
+          for (unsigned int i = _begin; i < _end; ++i)
+            values[i] += job + 1u;
+        });
+    for (unsigned int i = 0u; i < rows; ++i)
+      ASSERT_EQ(job + 1u, values[i]) << "job " << job << " row " << i;
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(Ogre2WorkerPoolTest, ConcurrentCallers)
+{
+  // calls from several threads are serialized
+  Ogre2WorkerPool pool;
+  const unsigned int rows = 32u;
+  const std::size_t rowBytes = 1024u * 1024u;
+  std::vector<std::thread> callers;
+  std::vector<unsigned int> totals(4u, 0u);
+  for (unsigned int t = 0u; t < totals.size(); ++t)
+  {
+    callers.emplace_back([&, t]()
+    {
+      for (unsigned int job = 0u; job < 200u; ++job)
+      {
+        std::atomic<unsigned int> processed(0u);
+        pool.ParallelFor(rows, rowBytes, 4u,
+            [&processed](unsigned int _begin, unsigned int _end)
+            {
+              processed += _end - _begin;
+            });
+        totals[t] += processed;
+      }
+    });
+  }
+  for (auto &caller : callers)
+    caller.join();
+  for (auto total : totals)
+    EXPECT_EQ(200u * rows, total);
+}
+
+/////////////////////////////////////////////////
+TEST(Ogre2WorkerPoolTest, CopyKernels)
+{
+  // 2 rows of 3 bytes, with a source pitch of 4 bytes
+  const uint8_t src[] = {1, 2, 3, 0, 4, 5, 6, 0};
+  uint8_t dst[6] = {};
+  Ogre2ReadbackKernels::CopyRows(src, 4u, dst, 3u, 3u, 0u, 2u);
+  EXPECT_EQ(std::vector<uint8_t>({1, 2, 3, 4, 5, 6}),
+      std::vector<uint8_t>(dst, dst + 6));
+
+  // only the requested rows are written
+  uint8_t partial[6] = {};
+  Ogre2ReadbackKernels::CopyRows(src, 4u, partial, 3u, 3u, 1u, 2u);
+  EXPECT_EQ(std::vector<uint8_t>({0, 0, 0, 4, 5, 6}),
+      std::vector<uint8_t>(partial, partial + 6));
+
+  uint16_t wide[6] = {};
+  Ogre2ReadbackKernels::Widen8To16(src, 4u, wide, 3u, 0u, 2u);
+  EXPECT_EQ(std::vector<uint16_t>({1, 2, 3, 4, 5, 6}),
+      std::vector<uint16_t>(wide, wide + 6));
+}
+
+/////////////////////////////////////////////////
+TEST(Ogre2WorkerPoolTest, FloatKernels)
+{
+  // 2 rows of 2 RGBA pixels
+  const float rgba[] = {
+      1, 2, 3, 4,  5, 6, 7, 8,
+      9, 10, 11, 12,  13, 14, 15, 16};
+  const std::size_t pitch = 8u * sizeof(float);
+
+  float first[4] = {};
+  Ogre2ReadbackKernels::ExtractFirstChannel(rgba, pitch, 4u, first, 2u,
+      0u, 2u);
+  EXPECT_EQ(std::vector<float>({1, 5, 9, 13}),
+      std::vector<float>(first, first + 4));
+
+  float rgb[12] = {};
+  Ogre2ReadbackKernels::RgbaToRgb(rgba, pitch, rgb, 2u, 0u, 2u);
+  EXPECT_EQ(std::vector<float>({1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15}),
+      std::vector<float>(rgb, rgb + 12));
+
+  // values exactly representable as halfs survive a round trip
+  const float values[] = {0.0f, 1.0f, -2.5f, 1024.0f};
+  uint16_t halfs[4] = {};
+  Ogre2ReadbackKernels::FloatToHalf(values, halfs, 2u, 0u, 2u);
+  float floats[4] = {};
+  Ogre2ReadbackKernels::HalfToFloat(halfs, 2u * sizeof(uint16_t), floats,
+      2u, 0u, 2u);
+  for (unsigned int i = 0u; i < 4u; ++i)
+    EXPECT_FLOAT_EQ(values[i], floats[i]);
+}
+
+/////////////////////////////////////////////////
+TEST(Ogre2WorkerPoolTest, MillimeterKernels)
+{
+  const float inf = std::numeric_limits<float>::infinity();
+
+  // invalid, too far, negative and NaN distances encode to 0
+  const float meters[] = {1.2344f, 0.0f, 70.0f, -1.0f, inf,
+      std::numeric_limits<float>::quiet_NaN()};
+  uint16_t mm[6] = {};
+  Ogre2ReadbackKernels::MetersToMillimeters(meters, mm, 3u, 0u, 2u);
+  EXPECT_EQ(std::vector<uint16_t>({1234, 0, 0, 0, 0, 0}),
+      std::vector<uint16_t>(mm, mm + 6));
+
+  // the first channel decodes to meters, 0 to +inf, the others are copied
+  const uint16_t src[] = {1234, 7, 0, 9};
+  float out[4] = {};
+  Ogre2ReadbackKernels::MillimetersToMeters(src, 4u * sizeof(uint16_t), 2u,
+      out, 2u, 0u, 1u);
+  EXPECT_FLOAT_EQ(1.234f, out[0]);
+  EXPECT_FLOAT_EQ(7.0f, out[1]);
+  EXPECT_EQ(inf, out[2]);
+  EXPECT_FLOAT_EQ(9.0f, out[3]);
+}
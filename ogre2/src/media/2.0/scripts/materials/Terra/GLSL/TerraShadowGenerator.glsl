@@ -42,6 +42,10 @@ layout(binding = 1) uniform PerGroupDataBuffer
 //Rendering uniforms
 uniform float heightDelta;
 
+//Index of the first thread group of this dispatch. Lets the CPU update
+//the shadow map a band of thread groups at a time
+uniform int groupOffset;
+
 vec2 calcShadow( ivec2 xyPos, vec2 prevHeight )
 {
 	prevHeight.x -= heightDelta;
@@ -72,13 +76,15 @@ vec2 calcShadow( ivec2 xyPos, vec2 prevHeight )
 void main()
 {
 	vec2 prevHeight = vec2( 0.0, 0.0 );
-	float error = delta.x * 0.5 + perGroupData[gl_WorkGroupID.x].deltaErrorStart;
+	uint groupId = gl_WorkGroupID.x + uint( groupOffset );
+	uint threadId = gl_GlobalInvocationID.x + uint( groupOffset ) * gl_WorkGroupSize.x;
+	float error = delta.x * 0.5 + perGroupData[groupId].deltaErrorStart;
 
 	int x, y;
-	if( gl_GlobalInvocationID.x < 4096u )
+	if( threadId < 4096u )
 	{
-		x = startXY[gl_GlobalInvocationID.x].x;
-		y = startXY[gl_GlobalInvocationID.x].y;
+		x = startXY[threadId].x;
+		y = startXY[threadId].y;
 	}
 	else
 	{
@@ -86,11 +92,11 @@ void main()
 		//we perform startXY[4096] and store the values in .zw instead of .xy
 		//It only gets used if the picture is very big. This branch is coherent as
 		//long as 4096 is multiple of threads_per_group_x.
-		x = startXY[gl_GlobalInvocationID.x - 4096u].z;
-		y = startXY[gl_GlobalInvocationID.x - 4096u].w;
+		x = startXY[threadId - 4096u].z;
+		y = startXY[threadId - 4096u].w;
 	}
 
-	int numIterations = perGroupData[gl_WorkGroupID.x].iterations;
+	int numIterations = perGroupData[groupId].iterations;
 	for( int i=0; i<numIterations; ++i )
 	{
 		if( isSteep != 0 )
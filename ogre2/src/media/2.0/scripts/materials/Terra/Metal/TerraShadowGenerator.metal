@@ -17,6 +17,10 @@ struct Params
 
 	//Rendering uniforms
 	float heightDelta;
+
+	//Index of the first thread group of this dispatch. Lets the CPU update
+	//the shadow map a band of thread groups at a time
+	int groupOffset;
 };
 
 struct PerGroupData
@@ -72,16 +76,19 @@ kernel void main_metal
 
 	, uint3 gl_GlobalInvocationID		[[thread_position_in_grid]]
 	, uint3 gl_WorkGroupID				[[threadgroup_position_in_grid]]
+	, uint3 gl_WorkGroupSize			[[threads_per_threadgroup]]
 )
 {
 	float2 prevHeight = float2( 0.0, 0.0 );
-	float error = p.delta.x * 0.5 + perGroupData[gl_WorkGroupID.x].deltaErrorStart;
+	uint groupId = gl_WorkGroupID.x + uint( p.groupOffset );
+	uint threadId = gl_GlobalInvocationID.x + uint( p.groupOffset ) * gl_WorkGroupSize.x;
+	float error = p.delta.x * 0.5 + perGroupData[groupId].deltaErrorStart;
 
 	int x, y;
-	if( gl_GlobalInvocationID.x < 4096u )
+	if( threadId < 4096u )
 	{
-		x = startXY[gl_GlobalInvocationID.x].x;
-		y = startXY[gl_GlobalInvocationID.x].y;
+		x = startXY[threadId].x;
+		y = startXY[threadId].y;
 	}
 	else
 	{
@@ -89,11 +96,11 @@ kernel void main_metal
 		//we perform startXY[4096] and store the values in .zw instead of .xy
 		//It only gets used if the picture is very big. This branch is coherent as
 		//long as 4096 is multiple of threads_per_group_x.
-		x = startXY[gl_GlobalInvocationID.x - 4096u].z;
-		y = startXY[gl_GlobalInvocationID.x - 4096u].w;
+		x = startXY[threadId - 4096u].z;
+		y = startXY[threadId - 4096u].w;
 	}
 	
-	int numIterations = perGroupData[gl_WorkGroupID.x].iterations;
+	int numIterations = perGroupData[groupId].iterations;
 	for( int i=0; i<numIterations; ++i )
 	{
 		if( p.isSteep )
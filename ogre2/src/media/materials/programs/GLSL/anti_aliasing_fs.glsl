@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+// Fast approximate anti-aliasing (FXAA), after the FXAA 3.11 quality
+// algorithm by Timothy Lottes. Edges are found from the local contrast of
+// the luma of each pixel and its neighbors. Pixels on an edge are blended
+// with the pixel across the edge, by an amount that depends on how far they
+// are from the ends of the edge, found by walking along it. Pixels that are
+// much brighter or darker than their neighbors, e.g. thin lines, are blended
+// with them too (subpixel anti-aliasing).
+
+// The input texture, which is set up by the Ogre Compositor infrastructure.
+uniform sampler2D RT;
+
+// Minimum local contrast, relative to the brightest neighbor, of the pixels
+// that are smoothed
+uniform float edgeThreshold;
+// Minimum absolute local contrast of the pixels that are smoothed
+uniform float edgeThresholdMin;
+// Amount of subpixel aliasing removed
+uniform float subpixelQuality;
+
+// input params from vertex shader
+in block
+{
+  vec2 uv0;
+} inPs;
+
+// final output color
+out vec4 fragColor;
+
+// Number of steps taken along an edge in each direction, and their length
+#define EDGE_STEPS 10
+const float edgeStep[EDGE_STEPS] =
+    float[](1.0, 1.0, 1.0, 1.0, 1.0, 1.5, 2.0, 2.0, 4.0, 8.0);
+
+float luma(vec3 color)
+{
+  return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+float lumaAt(vec2 uv)
+{
+  return luma(textureLod(RT, uv, 0.0).rgb);
+}
+
+void main()
+{
+  vec2 uv = inPs.uv0.xy;
+  vec2 texel = 1.0 / vec2(textureSize(RT, 0));
+  vec4 color = textureLod(RT, uv, 0.0);
+
+  float lumaM = luma(color.rgb);
+  float lumaN = lumaAt(uv + vec2(0.0, -texel.y));
+  float lumaS = lumaAt(uv + vec2(0.0, texel.y));
+  float lumaE = lumaAt(uv + vec2(texel.x, 0.0));
+  float lumaW = lumaAt(uv + vec2(-texel.x, 0.0));
+
+  float lumaMin = min(lumaM, min(min(lumaN, lumaS), min(lumaE, lumaW)));
+  float lumaMax = max(lumaM, max(max(lumaN, lumaS), max(lumaE, lumaW)));
+  float range = lumaMax - lumaMin;
+
+  // most pixels are not on an edge, leave them as they are
+  if (range < max(edgeThresholdMin, lumaMax * edgeThreshold))
+  {
+    fragColor = color;
+    return;
+  }
+
+  float lumaNW = lumaAt(uv + vec2(-texel.x, -texel.y));
+  float lumaNE = lumaAt(uv + vec2(texel.x, -texel.y));
+  float lumaSW = lumaAt(uv + vec2(-texel.x, texel.y));
+  float lumaSE = lumaAt(uv + vec2(texel.x, texel.y));
+
+  // the edge is horizontal if the luma changes more vertically
+  float edgeHorizontal =
+      abs(lumaNW + lumaNE - 2.0 * lumaN) +
+      2.0 * abs(lumaW + lumaE - 2.0 * lumaM) +
+      abs(lumaSW + lumaSE - 2.0 * lumaS);
+  float edgeVertical =
+      abs(lumaNW + lumaSW - 2.0 * lumaW) +
+      2.0 * abs(lumaN + lumaS - 2.0 * lumaM) +
+      abs(lumaNE + lumaSE - 2.0 * lumaE);
+  bool horizontal = edgeHorizontal >= edgeVertical;
+
+  // pick the side of the edge with the largest gradient
+  float luma1 = horizontal ? lumaN : lumaW;
+  float luma2 = horizontal ? lumaS : lumaE;
+  float gradient1 = abs(luma1 - lumaM);
+  float gradient2 = abs(luma2 - lumaM);
+  float stepLength = horizontal ? texel.y : texel.x;
+  float lumaSide;
+  if (gradient1 >= gradient2)
+  {
+    stepLength = -stepLength;
+    lumaSide = luma1;
+  }
+  else
+  {
+    lumaSide = luma2;
+  }
+  float gradientScaled = 0.25 * max(gradient1, gradient2);
+  float lumaEdge = 0.5 * (lumaM + lumaSide);
+
+  // walk along the edge, half a pixel towards the side picked above, until
+  // the luma no longer matches the edge in both directions
+  vec2 edgeUv = uv;
+  vec2 offset;
+  if (horizontal)
+  {
+    edgeUv.y += 0.5 * stepLength;
+    offset = vec2(texel.x, 0.0);
+  }
+  else
+  {
+    edgeUv.x += 0.5 * stepLength;
+    offset = vec2(0.0, texel.y);
+  }
+
+  vec2 uv1 = edgeUv - offset;
+  vec2 uv2 = edgeUv + offset;
+  float lumaEnd1 = lumaAt(uv1) - lumaEdge;
+  float lumaEnd2 = lumaAt(uv2) - lumaEdge;
+  bool reached1 = abs(lumaEnd1) >= gradientScaled;
+  bool reached2 = abs(lumaEnd2) >= gradientScaled;
+  for (int i = 1; i < EDGE_STEPS && !(reached1 && reached2); ++i)
+  {
+    if (!reached1)
+    {
+      uv1 -= offset * edgeStep[i];
+      lumaEnd1 = lumaAt(uv1) - lumaEdge;
+      reached1 = abs(lumaEnd1) >= gradientScaled;
+    }
+    if (!reached2)
+    {
+      uv2 += offset * edgeStep[i];
+      lumaEnd2 = lumaAt(uv2) - lumaEdge;
+      reached2 = abs(lumaEnd2) >= gradientScaled;
+    }
+  }
+
+  float distance1 = horizontal ? (uv.x - uv1.x) : (uv.y - uv1.y);
+  float distance2 = horizontal ? (uv2.x - uv.x) : (uv2.y - uv.y);
+  bool closer1 = distance1 < distance2;
+  float distanceMin = min(distance1, distance2);
+  float edgeLength = distance1 + distance2;
+
+  // blend only if the luma at the closest end varies the same way as the
+  // center, otherwise the pixel is on the other side of the edge
+  bool centerSmaller = lumaM < lumaEdge;
+  bool correctVariation =
+      ((closer1 ? lumaEnd1 : lumaEnd2) < 0.0) != centerSmaller;
+  float edgeOffset = correctVariation ?
+      -distanceMin / edgeLength + 0.5 : 0.0;
+
+  // subpixel blending, from the contrast of the pixel with the average of
+  // its neighbors
+  float lumaAverage = (1.0 / 12.0) *
+      (2.0 * (lumaN + lumaS + lumaE + lumaW) +
+       lumaNW + lumaNE + lumaSW + lumaSE);
+  float subpixel = clamp(abs(lumaAverage - lumaM) / range, 0.0, 1.0);
+  subpixel = (-2.0 * subpixel + 3.0) * subpixel * subpixel;
+  float subpixelOffset = subpixel * subpixel * subpixelQuality;
+
+  float finalOffset = max(edgeOffset, subpixelOffset);
+  vec2 finalUv = uv;
+  if (horizontal)
+    finalUv.y += finalOffset * stepLength;
+  else
+    finalUv.x += finalOffset * stepLength;
+
+  fragColor = vec4(textureLod(RT, finalUv, 0.0).rgb, color.a);
+}
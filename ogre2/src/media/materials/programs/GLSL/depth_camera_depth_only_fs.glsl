@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+in block
+{
+  vec2 uv0;
+} inPs;
+
+// output of depth_camera_final_fs.glsl, i.e. xyz + packed rgba
+uniform sampler2D inputTexture;
+
+out float fragColor;
+
+uniform vec4 texResolution;
+
+// 1 if the target is a 16 bit unorm texture that stores depth in
+// millimeters, in which case depth that can not be encoded is 0
+uniform float encodeMillimeters;
+
+void main()
+{
+  // extract the depth (x) channel only so that the single channel
+  // target can be read back instead of the full xyz + rgba texture
+  vec4 p = texelFetch(inputTexture, ivec2(inPs.uv0 * texResolution.xy), 0);
+  fragColor = p.x;
+
+  if (encodeMillimeters > 0.5)
+  {
+    float mm = floor(p.x * 1000.0 + 0.5);
+    fragColor = (p.x > 0.0 && mm <= 65535.0) ? mm / 65535.0 : 0.0;
+  }
+}
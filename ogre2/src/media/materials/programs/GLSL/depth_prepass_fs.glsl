@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+in block
+{
+  vec2 uv0;
+} inPs;
+
+// depth buffer of a camera that rendered the same view
+uniform sampler2D linkedDepthTexture;
+
+// 0 to write the far plane instead, i.e. clear the depth buffer
+uniform int useLinkedDepth;
+
+// moves the depth back so that surfaces rendered again at the same place
+// pass the depth test despite differences in precision between shaders
+uniform float depthBias;
+
+void main()
+{
+  float fDepth = 1.0;
+  if (useLinkedDepth != 0)
+  {
+    ivec2 size = textureSize(linkedDepthTexture, 0);
+    ivec2 texel = clamp(ivec2(inPs.uv0 * vec2(size)), ivec2(0),
+        size - ivec2(1));
+    fDepth = min(texelFetch(linkedDepthTexture, texel, 0).x + depthBias, 1.0);
+  }
+  gl_FragDepth = fDepth;
+}
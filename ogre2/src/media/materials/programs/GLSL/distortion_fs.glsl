@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+in block
+{
+  vec2 uv0;
+} inPs;
+
+// image rendered by the previous pass
+uniform sampler2D RT;
+
+// radial distortion coefficients k1, k2 and k3
+uniform vec3 radialCoeffs;
+
+// tangential distortion coefficients p1 and p2
+uniform vec2 tangentialCoeffs;
+
+// lens center in texture coordinates
+uniform vec2 center;
+
+// image size over focal length, converts texture coordinates relative to
+// the lens center to normalized camera coordinates
+uniform vec2 invFocal;
+
+// scale of the distorted image, less than 1 to crop the black borders
+// left by barrel distortion
+uniform vec2 scale;
+
+out vec4 fragColor;
+
+void main()
+{
+  const int kIterations = 8;
+
+  // distorted point in normalized camera coordinates
+  vec2 uv = (inPs.uv0 - vec2(0.5)) * scale + vec2(0.5);
+  vec2 d = (uv - center) * invFocal;
+
+  // invert Brown's distortion model by fixed point iteration, starting
+  // from the distorted point itself. Converges in a few iterations for the
+  // distortion of real lenses.
+  vec2 x = d;
+  for (int i = 0; i < kIterations; ++i)
+  {
+    float r2 = dot(x, x);
+    float radial = 1.0 + r2 * (radialCoeffs.x +
+        r2 * (radialCoeffs.y + r2 * radialCoeffs.z));
+    if (radial <= 0.0)
+    {
+      fragColor = vec4(0.0, 0.0, 0.0, 1.0);
+      return;
+    }
+    vec2 tangential = vec2(
+        tangentialCoeffs.y * (r2 + 2.0 * x.x * x.x) +
+        2.0 * tangentialCoeffs.x * x.x * x.y,
+        tangentialCoeffs.x * (r2 + 2.0 * x.y * x.y) +
+        2.0 * tangentialCoeffs.y * x.x * x.y);
+    x = (d - tangential) / radial;
+  }
+
+  // pixels that see past the edges of the undistorted image are black
+  vec2 sourceUv = center + x / invFocal;
+  if (any(lessThan(sourceUv, vec2(0.0))) ||
+      any(greaterThan(sourceUv, vec2(1.0))))
+  {
+    fragColor = vec4(0.0, 0.0, 0.0, 1.0);
+    return;
+  }
+  fragColor = texture(RT, sourceUv);
+}
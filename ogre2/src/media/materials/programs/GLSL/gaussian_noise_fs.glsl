@@ -52,6 +52,11 @@
 //
 // 4. Having produced a Gaussian sample, we add this value to each channel of
 // the input image.
+//
+// Consecutive Gaussian noise render passes are fused into a single pass, see
+// Ogre2GaussianNoisePass. Up to 4 noise layers are applied one after the
+// other, each one with its own offsets, mean and stddev. Layers with a zero
+// mean and stddev are skipped.
 
 // The input texture, which is set up by the Ogre Compositor infrastructure.
 uniform sampler2D RT;
@@ -67,6 +72,17 @@ uniform float mean;
 // Standard deviation of the Gaussian distribution that we want to sample from.
 uniform float stddev;
 
+// Offsets, mean and stddev of the noise passes fused into this one
+uniform vec3 offsets1;
+uniform float mean1;
+uniform float stddev1;
+uniform vec3 offsets2;
+uniform float mean2;
+uniform float stddev2;
+uniform vec3 offsets3;
+uniform float mean3;
+uniform float stddev3;
+
 
 // input params from vertex shader
 in block
@@ -94,7 +110,8 @@ float rand(vec2 co)
     return r;
 }
 
-vec4 gaussrand(vec2 co)
+vec4 gaussrand(vec2 co, vec3 layerOffsets, float layerMean,
+    float layerStddev)
 {
   // Box-Muller method for sampling from the normal distribution
   // http://en.wikipedia.org/wiki/Normal_distribution#Generating_values_from_normal_distribution
@@ -105,9 +122,9 @@ vec4 gaussrand(vec2 co)
   float U, V, R, Z;
   // Add in the CPU-supplied random offsets to generate the 3 random values that
   // we'll use.
-  U = rand(co + vec2(offsets.x, offsets.x));
-  V = rand(co + vec2(offsets.y, offsets.y));
-  R = rand(co + vec2(offsets.z, offsets.z));
+  U = rand(co + vec2(layerOffsets.x, layerOffsets.x));
+  V = rand(co + vec2(layerOffsets.y, layerOffsets.y));
+  R = rand(co + vec2(layerOffsets.z, layerOffsets.z));
   // Switch between the two random outputs.
   if(R < 0.5)
     Z = sqrt(-2.0 * log(U)) * sin(2.0 * PI * V);
@@ -115,21 +132,35 @@ vec4 gaussrand(vec2 co)
     Z = sqrt(-2.0 * log(U)) * cos(2.0 * PI * V);
 
   // Apply the stddev and mean.
-  Z = Z * stddev + mean;
+  Z = Z * layerStddev + layerMean;
 
   // Return it as a vec4, to be added to the input ("true") color.
   return vec4(Z, Z, Z, 0.0);
 }
 
-void main()
+// Add the noise of one layer to a color and clamp the result to a valid range
+vec4 addNoise(vec4 color, vec3 layerOffsets, float layerMean,
+    float layerStddev)
 {
-  // Add the sampled noise to the input color and clamp the result to a valid
-  // range.
   // note that an exponent is added to sampled noise, i.e. pow(noise, x),
   // which produces more consistent result with ogre1.x
-  float z = gaussrand(inPs.uv0.xy).x;
+  float z = gaussrand(inPs.uv0.xy, layerOffsets, layerMean, layerStddev).x;
   float n = pow(abs(z), 2.1);
   if (z < 0)
     n = -n;
-  fragColor = clamp(texture(RT, inPs.uv0.xy) + vec4(n, n, n, 0.0), 0.0, 1.0);
+  return clamp(color + vec4(n, n, n, 0.0), 0.0, 1.0);
+}
+
+void main()
+{
+  // Add the sampled noise of each layer to the input color, clamping the
+  // result after each one like separate passes would
+  vec4 color = addNoise(texture(RT, inPs.uv0.xy), offsets, mean, stddev);
+  if (mean1 != 0.0 || stddev1 != 0.0)
+    color = addNoise(color, offsets1, mean1, stddev1);
+  if (mean2 != 0.0 || stddev2 != 0.0)
+    color = addNoise(color, offsets2, mean2, stddev2);
+  if (mean3 != 0.0 || stddev3 != 0.0)
+    color = addNoise(color, offsets3, mean3, stddev3);
+  fragColor = color;
 }
@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+in block
+{
+  vec2 uv0;
+  vec4 colour;
+} inPs;
+
+uniform sampler2D particleTexture;
+// 1 if the material of the emitter has a texture
+uniform int hasTexture;
+uniform vec4 diffuse;
+
+out vec4 fragColor;
+
+void main()
+{
+  vec4 color = inPs.colour * diffuse;
+  if (hasTexture != 0)
+    color *= texture(particleTexture, inPs.uv0);
+  fragColor = color;
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+// Particles simulated from their index and the time elapsed since emission
+// started, see ParticleEmitter::SetGpuSimulationEnabled. Particle i is born
+// at i / rate and reborn every count / rate seconds after that.
+
+// xy: quad corner in [-0.5, 0.5], z: particle index
+in vec4 vertex;
+
+uniform mat4 worldView;
+uniform mat4 projection;
+
+// time since emission started, in seconds
+uniform float time;
+// time at which emission stopped, in seconds since it started
+uniform float emitEnd;
+// particles per second
+uniform float rate;
+// particle lifetime in seconds
+uniform float lifetime;
+// number of particles alive at most, the mesh may hold more
+uniform float count;
+// 0: point, 1: box, 2: cylinder, 3: ellipsoid
+uniform int emitterType;
+uniform vec3 emitterSize;
+// min and max particle velocity
+uniform vec2 velocityRange;
+// initial particle width and height
+uniform vec2 particleSize;
+// growth of the particle size per second
+uniform float scaleRate;
+uniform vec4 colorStart;
+uniform vec4 colorEnd;
+// 1 to take the colors from colorImage instead of the color range
+uniform int useColorImage;
+uniform sampler2D colorImage;
+
+out gl_PerVertex
+{
+  vec4 gl_Position;
+};
+
+out block
+{
+  vec2 uv0;
+  vec4 colour;
+} outVs;
+
+uint hash(uint x)
+{
+  x ^= x >> 16;
+  x *= 0x7feb352du;
+  x ^= x >> 15;
+  x *= 0x846ca68bu;
+  x ^= x >> 16;
+  return x;
+}
+
+// uniform random number in [0, 1)
+float random(inout uint seed)
+{
+  seed = hash(seed);
+  return float(seed >> 8) * (1.0 / 16777216.0);
+}
+
+void main()
+{
+  const float PI = 3.14159265358979;
+
+  float index = vertex.z;
+  float firstBirth = index / rate;
+  float period = count / rate;
+  float cycle = floor((time - firstBirth) / period);
+  float birth = firstBirth + cycle * period;
+  float age = time - birth;
+
+  outVs.uv0 = vec2(vertex.x + 0.5, 0.5 - vertex.y);
+  // the mesh is shared with emitters that have more particles
+  if (index >= count || time < firstBirth || birth > emitEnd ||
+      age >= lifetime)
+  {
+    // collapse the quad outside of the clip volume
+    gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+    outVs.colour = vec4(0.0);
+    return;
+  }
+
+  // every rebirth gets new random values
+  uint seed = hash(uint(index)) ^ hash(uint(cycle) + 0x9e3779b9u);
+  vec3 r = vec3(random(seed), random(seed), random(seed));
+  float speed = mix(velocityRange.x, velocityRange.y, random(seed));
+
+  // point in [-1, 1] across the emitter. The emitter direction is +x and,
+  // as with ogre's area emitters, the width is along y, the height along z
+  // and the depth along x
+  vec3 p = vec3(0.0);
+  if (emitterType == 1)
+  {
+    p = r * 2.0 - 1.0;
+  }
+  else if (emitterType == 2)
+  {
+    float angle = 2.0 * PI * r.x;
+    p = vec3(sqrt(r.y) * vec2(cos(angle), sin(angle)), r.z * 2.0 - 1.0);
+  }
+  else if (emitterType == 3)
+  {
+    float z = r.x * 2.0 - 1.0;
+    float angle = 2.0 * PI * r.y;
+    p = pow(r.z, 1.0 / 3.0) *
+        vec3(sqrt(1.0 - z * z) * vec2(cos(angle), sin(angle)), z);
+  }
+  vec3 pos = 0.5 * vec3(p.z * emitterSize.z, p.x * emitterSize.x,
+      p.y * emitterSize.y);
+  pos.x += speed * age;
+
+  float life = age / lifetime;
+  if (useColorImage != 0)
+    outVs.colour = textureLod(colorImage, vec2(life, 0.5), 0.0);
+  else
+    outVs.colour = mix(colorStart, colorEnd, life);
+
+  // camera facing quad
+  vec2 size = max(particleSize + vec2(scaleRate * age), vec2(0.0));
+  vec4 viewPos = worldView * vec4(pos, 1.0);
+  viewPos.xy += vertex.xy * size;
+  gl_Position = projection * viewPos;
+}
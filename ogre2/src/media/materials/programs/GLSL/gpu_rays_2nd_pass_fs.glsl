@@ -52,8 +52,63 @@ uniform sampler2D tex4;
 // cube face 5 -x
 uniform sampler2D tex5;
 
+// direction of each ray in the sensor frame, only bound if outputPoints is 1
+uniform sampler2D rayDirTex;
+
+// 1 if the output is a single channel texture 3 times the width of the
+// scan, in which case each texel stores one of the range, retro and
+// unused channels so that data can be read back as tightly packed RGB
+uniform float packRgb;
+
+// 1 if the output is a 16 bit unorm texture that stores the range in
+// millimeters, 0 if it can not be encoded, and the retro rounded to the
+// nearest integer
+uniform float encodeMillimeters;
+
+// range of the output, in uv coordinates, written by this pass. Scans
+// rendered in time segments write the columns of each segment with the
+// cubemap rendered at the pose of that segment
+uniform vec2 columnRange;
+
+// 1 if the output is an RGBA point cloud, i.e. the position of the hit
+// point of each ray in the sensor frame followed by the retro value
+uniform float outputPoints;
+
+// Gaussian noise added to the range, see Ogre2ShaderNoise. Random offsets
+// drawn on the CPU each frame seed the pseudo-random generator
+uniform vec3 noiseOffsets;
+uniform float noiseMean;
+uniform float noiseStdDev;
+
 out vec4 fragColor;
 
+#define PI 3.14159265358979323846264
+
+float rand(vec2 co)
+{
+  // see gaussian_noise_fs.glsl
+  float r = fract(sin(dot(co.xy, vec2(12.9898,78.233))) * 43758.5453);
+
+  // Make sure that we don't return 0.0
+  return clamp(r, 0.001, 1.0);
+}
+
+float gaussrand(vec2 co)
+{
+  // Box-Muller method for sampling from the normal distribution, the 3rd
+  // random value switches between its two outputs
+  float U = rand(co + vec2(noiseOffsets.x, noiseOffsets.x));
+  float V = rand(co + vec2(noiseOffsets.y, noiseOffsets.y));
+  float R = rand(co + vec2(noiseOffsets.z, noiseOffsets.z));
+  float Z;
+  if (R < 0.5)
+    Z = sqrt(-2.0 * log(U)) * sin(2.0 * PI * V);
+  else
+    Z = sqrt(-2.0 * log(U)) * cos(2.0 * PI * V);
+
+  return Z * noiseStdDev + noiseMean;
+}
+
 vec2 getRange(vec2 uv, sampler2D tex)
 {
   vec2 range = texture(tex, uv).xy;
@@ -62,6 +117,9 @@ vec2 getRange(vec2 uv, sampler2D tex)
 
 void main()
 {
+  if (inPs.uv0.x < columnRange.x || inPs.uv0.x >= columnRange.y)
+    discard;
+
   // get face index and uv coorodate data
   vec3 data = texture(cubeUVTex, inPs.uv0).xyz;
 
@@ -90,6 +148,39 @@ void main()
   float range = d.x;
   float retro = d.y;
 
+  // only rays with a return are noisy. The noise is sampled per ray, so
+  // the texels of packed outputs and the point cloud see the same value
+  if ((noiseStdDev > 0.0 || noiseMean != 0.0) && !isinf(range))
+  {
+    vec2 size = vec2(textureSize(cubeUVTex, 0));
+    vec2 ray = (floor(inPs.uv0 * size) + 0.5) / size;
+    range += gaussrand(ray);
+  }
+
+  if (outputPoints > 0.5)
+  {
+    // rays without return are at infinity in all directions, like the
+    // points of depth cameras
+    vec3 dir = texture(rayDirTex, inPs.uv0).xyz;
+    vec3 point = isinf(range) ? vec3(range) : range * dir;
+    fragColor = vec4(point, retro);
+    return;
+  }
+
+  if (encodeMillimeters > 0.5)
+  {
+    float mm = floor(range * 1000.0 + 0.5);
+    range = (range > 0.0 && mm <= 65535.0) ? mm / 65535.0 : 0.0;
+    retro = clamp(floor(retro + 0.5), 0.0, 65535.0) / 65535.0;
+  }
+
+  if (packRgb > 0.5)
+  {
+    vec3 rgb = vec3(range, retro, 0);
+    fragColor = vec4(rgb[int(gl_FragCoord.x) % 3], 0, 0, 1.0);
+    return;
+  }
+
   fragColor = vec4(range, retro, 0, 1.0);
   return;
 }
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+// ray direction
+in vec4 vertex;
+// ray range
+in float uv0;
+
+uniform mat4 worldViewProj;
+uniform float size;
+uniform vec3 origin;
+uniform float maxRange;
+uniform float displayNonHitting;
+
+out gl_PerVertex
+{
+  vec4 gl_Position;
+  float gl_PointSize;
+};
+
+void main()
+{
+  bool noHit = isinf(uv0);
+  if (noHit && displayNonHitting < 0.5)
+  {
+    // move the point outside of the clip volume
+    gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+    gl_PointSize = 1.0;
+    return;
+  }
+
+  // non-hitting rays are displayed at max range
+  float range = noHit ? maxRange : uv0;
+  vec3 point = origin + vertex.xyz * range;
+
+  gl_Position = worldViewProj * vec4(point, 1.0);
+  gl_PointSize = size;
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+in block
+{
+  vec2 gridPos;
+} inPs;
+
+// line color
+uniform vec4 colour;
+// length of a cell
+uniform float cellLength;
+// first and last lines along x and y, in cells
+uniform vec4 bounds;
+
+out vec4 fragColour;
+
+void main()
+{
+  vec2 cell = inPs.gridPos / cellLength;
+
+  // size of the pixel in cells. The lines are one pixel wide at any
+  // distance, their coverage of the pixel is used as alpha
+  vec2 pixel = fwidth(cell);
+  vec2 dist = abs(fract(cell + 0.5) - 0.5) / pixel;
+  float coverage = 1.0 - min(min(dist.x, dist.y), 1.0);
+
+  // the quad has a margin, the lines stop half a pixel past the outer ones
+  vec2 outside = max(bounds.xy - cell, cell - bounds.zw) / pixel;
+  coverage *= clamp(0.5 - max(outside.x, outside.y), 0.0, 1.0);
+
+  // fade cells a few pixels wide out instead of letting them alias
+  coverage *= 1.0 - smoothstep(0.25, 0.5, max(pixel.x, pixel.y));
+
+  float alpha = colour.a * coverage;
+  if (alpha < 0.004)
+    discard;
+
+  fragColour = vec4(colour.rgb, alpha);
+}
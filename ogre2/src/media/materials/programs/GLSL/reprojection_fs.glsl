@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+in block
+{
+  vec2 uv0;
+} inPs;
+
+// last rendered frame
+uniform sampler2D keyColorTexture;
+
+// depth buffer of the last rendered frame, multisampled if the frame was
+// rendered with anti-aliasing
+#ifdef MSAA
+uniform sampler2DMS keyDepthTexture;
+#else
+uniform sampler2D keyDepthTexture;
+#endif
+
+// rows of the transform from the view space of the last rendered frame to
+// the view space of the current camera pose
+uniform vec4 keyToCurrentRow0;
+uniform vec4 keyToCurrentRow1;
+uniform vec4 keyToCurrentRow2;
+
+// tangents of half the horizontal and vertical field of view of the last
+// rendered frame and of the current camera
+uniform vec2 keyTanHalfFov;
+uniform vec2 tanHalfFov;
+
+// projection parameters of the last rendered frame, used to linearize its
+// depth
+uniform vec2 projectionParams;
+
+out vec4 fragColor;
+
+// number of steps searching the pixel of the last rendered frame that lands
+// on this pixel
+const int kIterations = 4;
+
+// get the view space depth of the last rendered frame at a texture coordinate
+float keyDepth(vec2 uv)
+{
+#ifdef MSAA
+  ivec2 size = textureSize(keyDepthTexture);
+#else
+  ivec2 size = textureSize(keyDepthTexture, 0);
+#endif
+  ivec2 texel = clamp(ivec2(uv * vec2(size)), ivec2(0), size - ivec2(1));
+  // the first sample is good enough to find where the pixel lands
+  float fDepth = texelFetch(keyDepthTexture, texel, 0).x;
+  return projectionParams.y / (fDepth - projectionParams.x);
+}
+
+void main()
+{
+  // position of this pixel on the image plane at unit distance, x right and
+  // y up
+  vec2 ndc = vec2(inPs.uv0.x * 2.0 - 1.0, 1.0 - inPs.uv0.y * 2.0);
+  vec2 target = ndc * tanHalfFov;
+
+  // Start at the same pixel of the last rendered frame, move it to the
+  // current pose with its depth and correct it by how far it lands from
+  // this pixel. This converges to the surface seen through this pixel
+  // unless it was hidden in the last rendered frame, in which case the
+  // surface in front of it is stretched over the hole.
+  vec2 key = ndc * keyTanHalfFov;
+  vec2 keyUv = inPs.uv0;
+  for (int i = 0; i < kIterations; ++i)
+  {
+    float d = keyDepth(keyUv);
+    vec4 p = vec4(key * d, -d, 1.0);
+    vec3 q = vec3(dot(keyToCurrentRow0, p), dot(keyToCurrentRow1, p),
+        dot(keyToCurrentRow2, p));
+
+    // behind the current camera
+    if (q.z >= 0.0)
+      break;
+
+    key += target - q.xy / -q.z;
+    keyUv = vec2(1.0 + key.x / keyTanHalfFov.x,
+        1.0 - key.y / keyTanHalfFov.y) * 0.5;
+  }
+
+  fragColor = texture(keyColorTexture, clamp(keyUv, vec2(0.0), vec2(1.0)));
+}
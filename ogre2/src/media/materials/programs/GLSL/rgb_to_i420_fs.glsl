@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+in block
+{
+  vec2 uv0;
+} inPs;
+
+// rendered image
+uniform sampler2D inputTexture;
+
+uniform vec4 texResolution;
+
+// 1 if the input texture is sRGB. Fetching from it decodes the colors, which
+// need to be encoded again to match the bytes a Copy reads back
+uniform float srgbInput;
+
+out float fragColor;
+
+// fetch a pixel as 8 bit rgb values
+vec3 fetchRgb(ivec2 _p)
+{
+  vec3 c = texelFetch(inputTexture, _p, 0).rgb;
+  if (srgbInput > 0.5)
+  {
+    c = mix(c * 12.92, 1.055 * pow(c, vec3(1.0 / 2.4)) - 0.055,
+        step(vec3(0.0031308), c));
+  }
+  return floor(clamp(c, 0.0, 1.0) * 255.0 + 0.5);
+}
+
+void main()
+{
+  // The output is a single channel texture as wide as the input and 3/2 as
+  // tall: the Y plane followed by the U and V planes, which have half the
+  // width and height of the input. The rows of the chroma planes are tightly
+  // packed, so a row of the output may hold several of them.
+  // The integer BT.601 coefficients match PixelUtil::ConvertToI420.
+  int width = int(texResolution.x);
+  int height = int(texResolution.y);
+  ivec2 p = ivec2(inPs.uv0 * vec2(width, height + height / 2));
+
+  float v;
+  if (p.y < height)
+  {
+    vec3 c = fetchRgb(p);
+    v = floor((66.0 * c.r + 129.0 * c.g + 25.0 * c.b + 128.0) / 256.0) + 16.0;
+  }
+  else
+  {
+    int chromaWidth = width / 2;
+    int planeSize = chromaWidth * (height / 2);
+    int index = (p.y - height) * width + p.x;
+    int plane = index / planeSize;
+    index -= plane * planeSize;
+
+    // average of the 2x2 pixel block
+    ivec2 q = 2 * ivec2(index % chromaWidth, index / chromaWidth);
+    vec3 c = floor((fetchRgb(q) + fetchRgb(q + ivec2(1, 0)) +
+        fetchRgb(q + ivec2(0, 1)) + fetchRgb(q + ivec2(1, 1)) + 2.0) / 4.0);
+
+    if (plane == 0)
+      v = floor((-38.0 * c.r - 74.0 * c.g + 112.0 * c.b + 128.0) / 256.0);
+    else
+      v = floor((112.0 * c.r - 94.0 * c.g - 18.0 * c.b + 128.0) / 256.0);
+    v += 128.0;
+  }
+  fragColor = v / 255.0;
+}
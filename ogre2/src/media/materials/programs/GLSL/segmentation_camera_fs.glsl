@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+#version 330
+
+// color of the item in the colored map
+uniform vec4 inColor;
+
+// label id of the item, encoded as a color
+uniform vec4 inLabel;
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec4 fragLabel;
+
+void main()
+{
+  fragColor = inColor;
+  fragLabel = inLabel;
+}
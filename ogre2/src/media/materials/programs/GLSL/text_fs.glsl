@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+uniform sampler2D atlas;
+
+in block
+{
+  vec2 uv0;
+  vec4 colour;
+} inPs;
+
+out vec4 fragColour;
+
+void main()
+{
+  // the font atlas stores the glyph coverage in its second channel
+  float alpha = inPs.colour.a * texture(atlas, inPs.uv0).g;
+  if (alpha < 0.004)
+    discard;
+
+  fragColour = vec4(inPs.colour.rgb, alpha);
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+// glyph corner relative to the origin of the text, in the billboard plane
+in vec4 vertex;
+// glyph corner in the font atlas
+in vec2 uv0;
+in vec4 colour;
+
+uniform mat4 worldView;
+uniform mat4 projection;
+
+out gl_PerVertex
+{
+  vec4 gl_Position;
+};
+
+out block
+{
+  vec2 uv0;
+  vec4 colour;
+} outVs;
+
+void main()
+{
+  // the glyphs are laid out in view space around the origin of the text so
+  // the text always faces the camera
+  vec4 viewPos = worldView * vec4(0.0, 0.0, 0.0, 1.0);
+  viewPos.xy += vertex.xy;
+  gl_Position = projection * viewPos;
+
+  outVs.uv0 = uv0;
+  outVs.colour = colour;
+}
@@ -40,6 +40,39 @@ uniform float ambient;
 uniform int rgbToTemp;
 uniform int bitDepth;
 
+// Gaussian noise added to the temperature, see Ogre2ShaderNoise. Random
+// offsets drawn on the CPU each frame seed the pseudo-random generator
+uniform vec3 noiseOffsets;
+uniform float noiseMean;
+uniform float noiseStdDev;
+
+#define PI 3.14159265358979323846264
+
+float rand(vec2 co)
+{
+  // see gaussian_noise_fs.glsl
+  float r = fract(sin(dot(co.xy, vec2(12.9898,78.233))) * 43758.5453);
+
+  // Make sure that we don't return 0.0
+  return clamp(r, 0.001, 1.0);
+}
+
+float gaussrand(vec2 co)
+{
+  // Box-Muller method for sampling from the normal distribution, the 3rd
+  // random value switches between its two outputs
+  float U = rand(co + vec2(noiseOffsets.x, noiseOffsets.x));
+  float V = rand(co + vec2(noiseOffsets.y, noiseOffsets.y));
+  float R = rand(co + vec2(noiseOffsets.z, noiseOffsets.z));
+  float Z;
+  if (R < 0.5)
+    Z = sqrt(-2.0 * log(U)) * sin(2.0 * PI * V);
+  else
+    Z = sqrt(-2.0 * log(U)) * cos(2.0 * PI * V);
+
+  return Z * noiseStdDev + noiseMean;
+}
+
 float getDepth(vec2 uv)
 {
   float fDepth = texture(depthTexture, uv).x;
@@ -113,6 +146,10 @@ void main()
   temp = temp - heatRange / 2.0 + delta;
   clamp(temp, min, max);
 
+  // noisy temperatures stay within the range of the camera
+  if (noiseStdDev > 0.0 || noiseMean != 0.0)
+    temp = clamp(temp + gaussrand(inPs.uv0), min, max);
+
   // apply resolution factor
   temp /= resolution;
   // normalize
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version 330
+
+in block
+{
+  vec2 uv0;
+} inPs;
+
+// cubeUVTex packs the cubemap face and uv coordinates each pixel samples,
+// and whether the lens maps a ray to the pixel at all
+uniform sampler2D cubeUVTex;
+
+// cubemap faces, see gpu_rays_2nd_pass_fs.glsl for the layout
+uniform sampler2D tex0;
+uniform sampler2D tex1;
+uniform sampler2D tex2;
+uniform sampler2D tex3;
+uniform sampler2D tex4;
+uniform sampler2D tex5;
+
+out vec4 fragColor;
+
+void main()
+{
+  vec4 data = texture(cubeUVTex, inPs.uv0);
+
+  // beyond the cutoff angle of the lens
+  if (data.w < 0.5)
+  {
+    fragColor = vec4(0.0, 0.0, 0.0, 1.0);
+    return;
+  }
+
+  float faceIdx = data.z;
+  vec2 uv = data.xy;
+
+  vec3 color = vec3(0.0);
+  if (faceIdx == 0)
+    color = texture(tex0, uv).xyz;
+  else if (faceIdx == 1)
+    color = texture(tex1, uv).xyz;
+  else if (faceIdx == 2)
+    color = texture(tex2, uv).xyz;
+  else if (faceIdx == 3)
+    color = texture(tex3, uv).xyz;
+  else if (faceIdx == 4)
+    color = texture(tex4, uv).xyz;
+  else if (faceIdx == 5)
+    color = texture(tex5, uv).xyz;
+
+  fragColor = vec4(color, 1.0);
+}
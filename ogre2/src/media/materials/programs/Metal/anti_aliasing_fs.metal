@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// For details and documentation see: anti_aliasing_fs.glsl
+
+#include <metal_stdlib>
+using namespace metal;
+
+struct PS_INPUT
+{
+  float2 uv0;
+};
+
+struct Params
+{
+  // Minimum local contrast, relative to the brightest neighbor, of the
+  // pixels that are smoothed
+  float edgeThreshold;
+  // Minimum absolute local contrast of the pixels that are smoothed
+  float edgeThresholdMin;
+  // Amount of subpixel aliasing removed
+  float subpixelQuality;
+};
+
+// Number of steps taken along an edge in each direction, and their length
+#define EDGE_STEPS 10
+constant float edgeStep[EDGE_STEPS] =
+    {1.0, 1.0, 1.0, 1.0, 1.0, 1.5, 2.0, 2.0, 4.0, 8.0};
+
+float luma(float3 color)
+{
+  return dot(color, float3(0.299, 0.587, 0.114));
+}
+
+float lumaAt(texture2d<float> RT, sampler s, float2 uv)
+{
+  return luma(RT.sample(s, uv, level(0.0)).rgb);
+}
+
+fragment float4 main_metal
+(
+  PS_INPUT inPs [[stage_in]],
+  texture2d<float> RT [[texture(0)]],
+  sampler rtSampler [[sampler(0)]],
+  constant Params &p [[buffer(PARAMETER_SLOT)]]
+)
+{
+  float2 uv = inPs.uv0.xy;
+  float2 texel = 1.0 / float2(RT.get_width(), RT.get_height());
+  float4 color = RT.sample(rtSampler, uv, level(0.0));
+
+  float lumaM = luma(color.rgb);
+  float lumaN = lumaAt(RT, rtSampler, uv + float2(0.0, -texel.y));
+  float lumaS = lumaAt(RT, rtSampler, uv + float2(0.0, texel.y));
+  float lumaE = lumaAt(RT, rtSampler, uv + float2(texel.x, 0.0));
+  float lumaW = lumaAt(RT, rtSampler, uv + float2(-texel.x, 0.0));
+
+  float lumaMin = min(lumaM, min(min(lumaN, lumaS), min(lumaE, lumaW)));
+  float lumaMax = max(lumaM, max(max(lumaN, lumaS), max(lumaE, lumaW)));
+  float range = lumaMax - lumaMin;
+
+  if (range < max(p.edgeThresholdMin, lumaMax * p.edgeThreshold))
+    return color;
+
+  float lumaNW = lumaAt(RT, rtSampler, uv + float2(-texel.x, -texel.y));
+  float lumaNE = lumaAt(RT, rtSampler, uv + float2(texel.x, -texel.y));
+  float lumaSW = lumaAt(RT, rtSampler, uv + float2(-texel.x, texel.y));
+  float lumaSE = lumaAt(RT, rtSampler, uv + float2(texel.x, texel.y));
+
+  float edgeHorizontal =
+      abs(lumaNW + lumaNE - 2.0 * lumaN) +
+      2.0 * abs(lumaW + lumaE - 2.0 * lumaM) +
+      abs(lumaSW + lumaSE - 2.0 * lumaS);
+  float edgeVertical =
+      abs(lumaNW + lumaSW - 2.0 * lumaW) +
+      2.0 * abs(lumaN + lumaS - 2.0 * lumaM) +
+      abs(lumaNE + lumaSE - 2.0 * lumaE);
+  bool horizontal = edgeHorizontal >= edgeVertical;
+
+  float luma1 = horizontal ? lumaN : lumaW;
+  float luma2 = horizontal ? lumaS : lumaE;
+  float gradient1 = abs(luma1 - lumaM);
+  float gradient2 = abs(luma2 - lumaM);
+  float stepLength = horizontal ? texel.y : texel.x;
+  float lumaSide;
+  if (gradient1 >= gradient2)
+  {
+    stepLength = -stepLength;
+    lumaSide = luma1;
+  }
+  else
+  {
+    lumaSide = luma2;
+  }
+  float gradientScaled = 0.25 * max(gradient1, gradient2);
+  float lumaEdge = 0.5 * (lumaM + lumaSide);
+
+  float2 edgeUv = uv;
+  float2 offset;
+  if (horizontal)
+  {
+    edgeUv.y += 0.5 * stepLength;
+    offset = float2(texel.x, 0.0);
+  }
+  else
+  {
+    edgeUv.x += 0.5 * stepLength;
+    offset = float2(0.0, texel.y);
+  }
+
+  float2 uv1 = edgeUv - offset;
+  float2 uv2 = edgeUv + offset;
+  float lumaEnd1 = lumaAt(RT, rtSampler, uv1) - lumaEdge;
+  float lumaEnd2 = lumaAt(RT, rtSampler, uv2) - lumaEdge;
+  bool reached1 = abs(lumaEnd1) >= gradientScaled;
+  bool reached2 = abs(lumaEnd2) >= gradientScaled;
+  for (int i = 1; i < EDGE_STEPS && !(reached1 && reached2); ++i)
+  {
+    if (!reached1)
+    {
+      uv1 -= offset * edgeStep[i];
+      lumaEnd1 = lumaAt(RT, rtSampler, uv1) - lumaEdge;
+      reached1 = abs(lumaEnd1) >= gradientScaled;
+    }
+    if (!reached2)
+    {
+      uv2 += offset * edgeStep[i];
+      lumaEnd2 = lumaAt(RT, rtSampler, uv2) - lumaEdge;
+      reached2 = abs(lumaEnd2) >= gradientScaled;
+    }
+  }
+
+  float distance1 = horizontal ? (uv.x - uv1.x) : (uv.y - uv1.y);
+  float distance2 = horizontal ? (uv2.x - uv.x) : (uv2.y - uv.y);
+  bool closer1 = distance1 < distance2;
+  float distanceMin = min(distance1, distance2);
+  float edgeLength = distance1 + distance2;
+
+  bool centerSmaller = lumaM < lumaEdge;
+  bool correctVariation =
+      ((closer1 ? lumaEnd1 : lumaEnd2) < 0.0) != centerSmaller;
+  float edgeOffset = correctVariation ?
+      -distanceMin / edgeLength + 0.5 : 0.0;
+
+  float lumaAverage = (1.0 / 12.0) *
+      (2.0 * (lumaN + lumaS + lumaE + lumaW) +
+       lumaNW + lumaNE + lumaSW + lumaSE);
+  float subpixel = clamp(abs(lumaAverage - lumaM) / range, 0.0, 1.0);
+  subpixel = (-2.0 * subpixel + 3.0) * subpixel * subpixel;
+  float subpixelOffset = subpixel * subpixel * p.subpixelQuality;
+
+  float finalOffset = max(edgeOffset, subpixelOffset);
+  float2 finalUv = uv;
+  if (horizontal)
+    finalUv.y += finalOffset * stepLength;
+  else
+    finalUv.x += finalOffset * stepLength;
+
+  return float4(RT.sample(rtSampler, finalUv, level(0.0)).rgb, color.a);
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// For details and documentation see: depth_camera_depth_only_fs.glsl
+
+#include <metal_stdlib>
+using namespace metal;
+
+struct PS_INPUT
+{
+  float2 uv0;
+};
+
+struct Params
+{
+  float4 texResolution;
+  float encodeMillimeters;
+};
+
+fragment float main_metal
+(
+  PS_INPUT inPs [[stage_in]],
+  texture2d<float>  inputTexture [[texture(0)]],
+  constant Params &params [[buffer(PARAMETER_SLOT)]]
+)
+{
+  float4 p = inputTexture.read(uint2(inPs.uv0 * params.texResolution.xy), 0);
+
+  if (params.encodeMillimeters > 0.5)
+  {
+    float mm = floor(p.x * 1000.0 + 0.5);
+    return (p.x > 0.0 && mm <= 65535.0) ? mm / 65535.0 : 0.0;
+  }
+  return p.x;
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// For details and documentation see: depth_prepass_fs.glsl
+
+#include <metal_stdlib>
+using namespace metal;
+
+struct PS_INPUT
+{
+  float2 uv0;
+};
+
+struct PS_OUTPUT
+{
+  float depth [[depth(any)]];
+};
+
+struct Params
+{
+  int useLinkedDepth;
+  float depthBias;
+};
+
+fragment PS_OUTPUT main_metal
+(
+  PS_INPUT inPs [[stage_in]],
+  depth2d<float> linkedDepthTexture [[texture(0)]],
+  constant Params &p [[buffer(PARAMETER_SLOT)]]
+)
+{
+  PS_OUTPUT outPs;
+  outPs.depth = 1.0;
+  if (p.useLinkedDepth != 0)
+  {
+    int2 size = int2(linkedDepthTexture.get_width(),
+        linkedDepthTexture.get_height());
+    uint2 texel = uint2(clamp(int2(inPs.uv0 * float2(size)), int2(0),
+        size - 1));
+    outPs.depth = min(linkedDepthTexture.read(texel) + p.depthBias, 1.0);
+  }
+  return outPs;
+}
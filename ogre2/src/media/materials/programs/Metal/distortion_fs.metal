@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// For details and documentation see: distortion_fs.glsl
+
+#include <metal_stdlib>
+using namespace metal;
+
+struct PS_INPUT
+{
+  float2 uv0;
+};
+
+struct Params
+{
+  float3 radialCoeffs;
+  float2 tangentialCoeffs;
+  float2 center;
+  float2 invFocal;
+  float2 scale;
+};
+
+fragment float4 main_metal
+(
+  PS_INPUT inPs [[stage_in]],
+  texture2d<float>  RT [[texture(0)]],
+  sampler           RTSampler [[sampler(0)]],
+  constant Params &p [[buffer(PARAMETER_SLOT)]]
+)
+{
+  const int kIterations = 8;
+
+  float2 uv = (inPs.uv0 - float2(0.5)) * p.scale + float2(0.5);
+  float2 d = (uv - p.center) * p.invFocal;
+
+  float2 x = d;
+  for (int i = 0; i < kIterations; ++i)
+  {
+    float r2 = dot(x, x);
+    float radial = 1.0 + r2 * (p.radialCoeffs.x +
+        r2 * (p.radialCoeffs.y + r2 * p.radialCoeffs.z));
+    if (radial <= 0.0)
+      return float4(0.0, 0.0, 0.0, 1.0);
+    float2 tangential = float2(
+        p.tangentialCoeffs.y * (r2 + 2.0 * x.x * x.x) +
+        2.0 * p.tangentialCoeffs.x * x.x * x.y,
+        p.tangentialCoeffs.x * (r2 + 2.0 * x.y * x.y) +
+        2.0 * p.tangentialCoeffs.y * x.x * x.y);
+    x = (d - tangential) / radial;
+  }
+
+  float2 sourceUv = p.center + x / p.invFocal;
+  if (any(sourceUv < float2(0.0)) || any(sourceUv > float2(1.0)))
+    return float4(0.0, 0.0, 0.0, 1.0);
+  return RT.sample(RTSampler, sourceUv);
+}
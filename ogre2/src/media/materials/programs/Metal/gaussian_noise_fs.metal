@@ -34,6 +34,16 @@ struct Params
   float mean;
   // Standard deviation of the Gaussian distribution that we want to sample from.
   float stddev;
+  // Offsets, mean and stddev of the noise passes fused into this one
+  float3 offsets1;
+  float mean1;
+  float stddev1;
+  float3 offsets2;
+  float mean2;
+  float stddev2;
+  float3 offsets3;
+  float mean3;
+  float stddev3;
 };
 
 #define PI 3.14159265358979323846264
@@ -80,6 +90,19 @@ float4 gaussrand(float2 co, float3 offsets, float mean, float stddev)
   return float4(Z, Z, Z, 0.0);
 }
 
+// Add the noise of one layer to a color and clamp the result to a valid range
+float4 addNoise(float4 color, float2 uv, float3 offsets, float mean,
+    float stddev)
+{
+  // note that an exponent is added to sampled noise, i.e. pow(noise, x),
+  // which produces more consistent result with ogre1.x
+  float z = gaussrand(uv, offsets, mean, stddev).x;
+  float n = pow(abs(z), 2.1);
+  if (z < 0)
+    n = -n;
+  return clamp(color + float4(n, n, n, 0.0), 0.0, 1.0);
+}
+
 fragment float4 main_metal
 (
   PS_INPUT inPs [[stage_in]],
@@ -88,17 +111,17 @@ fragment float4 main_metal
   constant Params &p [[buffer(PARAMETER_SLOT)]]
 )
 {
-  // Add the sampled noise to the input color and clamp the result to a valid
-  // range.
-  // note that an exponent is added to sampled noise, i.e. pow(noise, x),
-  // which produces more consistent result with ogre1.x
-  float z = gaussrand(inPs.uv0.xy, p.offsets, p.mean, p.stddev).x;
-  float n = pow(abs(z), 2.1);
-  if (z < 0)
-    n = -n;
-
-  float4 texColor = RT.sample(rtSampler, inPs.uv0.xy);
-  float4 fragColor = clamp(texColor + float4(n, n, n, 0.0), 0.0, 1.0);
+  // Add the sampled noise of each layer to the input color, clamping the
+  // result after each one like separate passes would
+  float2 uv = inPs.uv0.xy;
+  float4 color = addNoise(RT.sample(rtSampler, uv), uv, p.offsets, p.mean,
+      p.stddev);
+  if (p.mean1 != 0.0 || p.stddev1 != 0.0)
+    color = addNoise(color, uv, p.offsets1, p.mean1, p.stddev1);
+  if (p.mean2 != 0.0 || p.stddev2 != 0.0)
+    color = addNoise(color, uv, p.offsets2, p.mean2, p.stddev2);
+  if (p.mean3 != 0.0 || p.stddev3 != 0.0)
+    color = addNoise(color, uv, p.offsets3, p.mean3, p.stddev3);
 
-  return fragColor;
+  return color;
 }
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// For details and documentation see: gpu_particles_vs.glsl
+
+#include <metal_stdlib>
+using namespace metal;
+
+struct VS_INPUT
+{
+  // xy: quad corner in [-0.5, 0.5], z: particle index
+  float4 position [[attribute(VES_POSITION)]];
+};
+
+struct PS_INPUT
+{
+  float4 gl_Position [[position]];
+  float2 uv0;
+  float4 colour;
+};
+
+struct Params
+{
+  float4x4 worldView;
+  float4x4 projection;
+  float time;
+  float emitEnd;
+  float rate;
+  float lifetime;
+  float count;
+  int emitterType;
+  float3 emitterSize;
+  float2 velocityRange;
+  float2 particleSize;
+  float scaleRate;
+  float4 colorStart;
+  float4 colorEnd;
+  int useColorImage;
+};
+
+uint hash(uint x)
+{
+  x ^= x >> 16;
+  x *= 0x7feb352du;
+  x ^= x >> 15;
+  x *= 0x846ca68bu;
+  x ^= x >> 16;
+  return x;
+}
+
+float random(thread uint &seed)
+{
+  seed = hash(seed);
+  return float(seed >> 8) * (1.0 / 16777216.0);
+}
+
+vertex PS_INPUT main_metal
+(
+  VS_INPUT input [[stage_in]],
+  texture2d<float> colorImage [[texture(1)]],
+  sampler colorImageSampler [[sampler(1)]],
+  constant Params &p [[buffer(PARAMETER_SLOT)]]
+)
+{
+  PS_INPUT outVs;
+
+  float index = input.position.z;
+  float firstBirth = index / p.rate;
+  float period = p.count / p.rate;
+  float cycle = floor((p.time - firstBirth) / period);
+  float birth = firstBirth + cycle * period;
+  float age = p.time - birth;
+
+  outVs.uv0 = float2(input.position.x + 0.5, 0.5 - input.position.y);
+  if (index >= p.count || p.time < firstBirth || birth > p.emitEnd ||
+      age >= p.lifetime)
+  {
+    // collapse the quad outside of the clip volume
+    outVs.gl_Position = float4(2.0, 2.0, 2.0, 1.0);
+    outVs.colour = float4(0.0);
+    return outVs;
+  }
+
+  uint seed = hash(uint(index)) ^ hash(uint(cycle) + 0x9e3779b9u);
+  float3 r = float3(random(seed), random(seed), random(seed));
+  float speed = mix(p.velocityRange.x, p.velocityRange.y, random(seed));
+
+  float3 e = float3(0.0);
+  if (p.emitterType == 1)
+  {
+    e = r * 2.0 - 1.0;
+  }
+  else if (p.emitterType == 2)
+  {
+    float angle = 2.0 * M_PI_F * r.x;
+    e = float3(sqrt(r.y) * float2(cos(angle), sin(angle)), r.z * 2.0 - 1.0);
+  }
+  else if (p.emitterType == 3)
+  {
+    float z = r.x * 2.0 - 1.0;
+    float angle = 2.0 * M_PI_F * r.y;
+    e = pow(r.z, 1.0 / 3.0) *
+        float3(sqrt(1.0 - z * z) * float2(cos(angle), sin(angle)), z);
+  }
+  float3 pos = 0.5 * float3(e.z * p.emitterSize.z, e.x * p.emitterSize.x,
+      e.y * p.emitterSize.y);
+  pos.x += speed * age;
+
+  float life = age / p.lifetime;
+  if (p.useColorImage != 0)
+  {
+    outVs.colour = colorImage.sample(colorImageSampler, float2(life, 0.5),
+        level(0.0));
+  }
+  else
+  {
+    outVs.colour = mix(p.colorStart, p.colorEnd, life);
+  }
+
+  float2 size = max(p.particleSize + float2(p.scaleRate * age), float2(0.0));
+  float4 viewPos = p.worldView * float4(pos, 1.0);
+  viewPos.xy += input.position.xy * size;
+  outVs.gl_Position = p.projection * viewPos;
+
+  return outVs;
+}
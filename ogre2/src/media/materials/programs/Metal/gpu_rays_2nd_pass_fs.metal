@@ -22,13 +22,43 @@ using namespace metal;
 
 struct PS_INPUT
 {
+  float4 gl_FragCoord [[position]];
   float2 uv0;
 };
 
 struct Params
 {
+  float packRgb;
+  float encodeMillimeters;
+  float2 columnRange;
+  float outputPoints;
+  float3 noiseOffsets;
+  float noiseMean;
+  float noiseStdDev;
 };
 
+#define PI 3.14159265358979323846264
+
+float rand(float2 co)
+{
+  float r = fract(sin(dot(co.xy, float2(12.9898,78.233))) * 43758.5453);
+  return clamp(r, 0.001, 1.0);
+}
+
+float gaussrand(float2 co, float3 offsets, float mean, float stddev)
+{
+  float U = rand(co + float2(offsets.x, offsets.x));
+  float V = rand(co + float2(offsets.y, offsets.y));
+  float R = rand(co + float2(offsets.z, offsets.z));
+  float Z;
+  if (R < 0.5)
+    Z = sqrt(-2.0 * log(U)) * sin(2.0 * PI * V);
+  else
+    Z = sqrt(-2.0 * log(U)) * cos(2.0 * PI * V);
+
+  return Z * stddev + mean;
+}
+
 float2 getRange(float2 uv, texture2d<float> tex, sampler texSampler)
 {
   float2 range = tex.sample(texSampler, uv).xy;
@@ -45,6 +75,7 @@ fragment float4 main_metal
   texture2d<float>  tex3      [[texture(4)]],
   texture2d<float>  tex4      [[texture(5)]],
   texture2d<float>  tex5      [[texture(6)]],
+  texture2d<float>  rayDirTex [[texture(7)]],
   sampler cubeUVTexSampler    [[sampler(0)]],
   sampler tex0Sampler         [[sampler(1)]],
   sampler tex1Sampler         [[sampler(2)]],
@@ -52,9 +83,13 @@ fragment float4 main_metal
   sampler tex3Sampler         [[sampler(4)]],
   sampler tex4Sampler         [[sampler(5)]],
   sampler tex5Sampler         [[sampler(6)]],
+  sampler rayDirTexSampler    [[sampler(7)]],
   constant Params &p [[buffer(PARAMETER_SLOT)]]
 )
 {
+  if (inPs.uv0.x < p.columnRange.x || inPs.uv0.x >= p.columnRange.y)
+    discard_fragment();
+
   // get face index and uv coorodate data
   float3 data = cubeUVTex.sample(cubeUVTexSampler, inPs.uv0).xyz;
 
@@ -83,6 +118,34 @@ fragment float4 main_metal
   float range = d.x;
   float retro = d.y;
 
+  if ((p.noiseStdDev > 0.0 || p.noiseMean != 0.0) && !isinf(range))
+  {
+    float2 size = float2(cubeUVTex.get_width(), cubeUVTex.get_height());
+    float2 ray = (floor(inPs.uv0 * size) + 0.5) / size;
+    range += gaussrand(ray, p.noiseOffsets, p.noiseMean, p.noiseStdDev);
+  }
+
+  if (p.outputPoints > 0.5)
+  {
+    float3 dir = rayDirTex.sample(rayDirTexSampler, inPs.uv0).xyz;
+    float3 point = isinf(range) ? float3(range) : range * dir;
+    return float4(point, retro);
+  }
+
+  if (p.encodeMillimeters > 0.5)
+  {
+    float mm = floor(range * 1000.0 + 0.5);
+    range = (range > 0.0 && mm <= 65535.0) ? mm / 65535.0 : 0.0;
+    retro = clamp(floor(retro + 0.5), 0.0, 65535.0) / 65535.0;
+  }
+
+  if (p.packRgb > 0.5)
+  {
+    float3 rgb(range, retro, 0);
+    float4 fragColor(rgb[int(inPs.gl_FragCoord.x) % 3], 0, 0, 1.0);
+    return fragColor;
+  }
+
   float4 fragColor(range, retro, 0, 1.0);
   return fragColor;
 }
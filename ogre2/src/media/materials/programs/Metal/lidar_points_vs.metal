@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <metal_stdlib>
+using namespace metal;
+
+struct VS_INPUT
+{
+  // ray direction
+  float4 position [[attribute(VES_POSITION)]];
+  // ray range
+  float  uv0      [[attribute(VES_TEXTURE_COORDINATES0)]];
+};
+
+struct PS_INPUT
+{
+  float4 gl_Position  [[position]];
+  float  gl_PointSize [[point_size]];
+};
+
+struct Params
+{
+  float4x4 worldViewProj;
+  float size;
+  float3 origin;
+  float maxRange;
+  float displayNonHitting;
+};
+
+vertex PS_INPUT main_metal
+(
+  VS_INPUT input [[stage_in]],
+  constant Params &p [[buffer(PARAMETER_SLOT)]]
+)
+{
+  PS_INPUT outVs;
+
+  bool noHit = isinf(input.uv0);
+  if (noHit && p.displayNonHitting < 0.5)
+  {
+    // move the point outside of the clip volume
+    outVs.gl_Position = float4(2.0, 2.0, 2.0, 1.0);
+    outVs.gl_PointSize = 1.0;
+    return outVs;
+  }
+
+  // non-hitting rays are displayed at max range
+  float range = noHit ? p.maxRange : input.uv0;
+  float3 point = p.origin + input.position.xyz * range;
+
+  outVs.gl_Position  = p.worldViewProj * float4(point, 1.0);
+  outVs.gl_PointSize = p.size;
+
+  return outVs;
+}
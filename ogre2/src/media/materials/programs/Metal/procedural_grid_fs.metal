@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <metal_stdlib>
+using namespace metal;
+
+struct PS_INPUT
+{
+  float2 gridPos;
+};
+
+struct Params
+{
+  // line color
+  float4 colour;
+  // length of a cell
+  float cellLength;
+  // first and last lines along x and y, in cells
+  float4 bounds;
+};
+
+fragment float4 main_metal
+(
+  PS_INPUT inPs [[stage_in]],
+  constant Params &p [[buffer(PARAMETER_SLOT)]]
+)
+{
+  float2 cell = inPs.gridPos / p.cellLength;
+
+  // size of the pixel in cells. The lines are one pixel wide at any
+  // distance, their coverage of the pixel is used as alpha
+  float2 pixel = fwidth(cell);
+  float2 dist = abs(fract(cell + 0.5f) - 0.5f) / pixel;
+  float coverage = 1.0f - min(min(dist.x, dist.y), 1.0f);
+
+  // the quad has a margin, the lines stop half a pixel past the outer ones
+  float2 outside = max(p.bounds.xy - cell, cell - p.bounds.zw) / pixel;
+  coverage *= clamp(0.5f - max(outside.x, outside.y), 0.0f, 1.0f);
+
+  // fade cells a few pixels wide out instead of letting them alias
+  coverage *= 1.0f - smoothstep(0.25f, 0.5f, max(pixel.x, pixel.y));
+
+  float alpha = p.colour.w * coverage;
+  if (alpha < 0.004f)
+    discard_fragment();
+
+  return float4(p.colour.xyz, alpha);
+}
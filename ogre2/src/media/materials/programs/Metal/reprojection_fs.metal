@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// For details and documentation see: reprojection_fs.glsl
+
+#include <metal_stdlib>
+using namespace metal;
+
+struct PS_INPUT
+{
+  float2 uv0;
+};
+
+struct Params
+{
+  float4 keyToCurrentRow0;
+  float4 keyToCurrentRow1;
+  float4 keyToCurrentRow2;
+  float2 keyTanHalfFov;
+  float2 tanHalfFov;
+  float2 projectionParams;
+};
+
+#ifdef MSAA
+  #define DepthTexture depth2d_ms<float>
+#else
+  #define DepthTexture depth2d<float>
+#endif
+
+float keyDepth(DepthTexture keyDepthTexture, float2 uv,
+    constant Params &p)
+{
+  int2 size = int2(keyDepthTexture.get_width(),
+      keyDepthTexture.get_height());
+  uint2 texel = uint2(clamp(int2(uv * float2(size)), int2(0), size - 1));
+#ifdef MSAA
+  float fDepth = keyDepthTexture.read(texel, 0u);
+#else
+  float fDepth = keyDepthTexture.read(texel);
+#endif
+  return p.projectionParams.y / (fDepth - p.projectionParams.x);
+}
+
+fragment float4 main_metal
+(
+  PS_INPUT inPs [[stage_in]],
+  texture2d<float>  keyColorTexture [[texture(0)]],
+  DepthTexture      keyDepthTexture [[texture(1)]],
+  sampler           keyColorSampler [[sampler(0)]],
+  constant Params &p [[buffer(PARAMETER_SLOT)]]
+)
+{
+  const int kIterations = 4;
+
+  float2 ndc = float2(inPs.uv0.x * 2.0 - 1.0, 1.0 - inPs.uv0.y * 2.0);
+  float2 target = ndc * p.tanHalfFov;
+
+  float2 key = ndc * p.keyTanHalfFov;
+  float2 keyUv = inPs.uv0;
+  for (int i = 0; i < kIterations; ++i)
+  {
+    float d = keyDepth(keyDepthTexture, keyUv, p);
+    float4 pos = float4(key * d, -d, 1.0);
+    float3 q = float3(dot(p.keyToCurrentRow0, pos),
+        dot(p.keyToCurrentRow1, pos), dot(p.keyToCurrentRow2, pos));
+
+    if (q.z >= 0.0)
+      break;
+
+    key += target - q.xy / -q.z;
+    keyUv = float2(1.0 + key.x / p.keyTanHalfFov.x,
+        1.0 - key.y / p.keyTanHalfFov.y) * 0.5;
+  }
+
+  return keyColorTexture.sample(keyColorSampler,
+      clamp(keyUv, float2(0.0), float2(1.0)));
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// For details and documentation see: rgb_to_i420_fs.glsl
+
+#include <metal_stdlib>
+using namespace metal;
+
+struct PS_INPUT
+{
+  float4 gl_FragCoord [[position]];
+  float2 uv0;
+};
+
+struct Params
+{
+  float4 texResolution;
+  float srgbInput;
+};
+
+float3 fetchRgb(texture2d<float> inputTexture, int2 p, float srgbInput)
+{
+  float3 c = inputTexture.read(uint2(p), 0).rgb;
+  if (srgbInput > 0.5)
+  {
+    c = mix(c * 12.92, 1.055 * pow(c, float3(1.0 / 2.4)) - 0.055,
+        step(float3(0.0031308), c));
+  }
+  return floor(clamp(c, 0.0, 1.0) * 255.0 + 0.5);
+}
+
+fragment float main_metal
+(
+  PS_INPUT inPs [[stage_in]],
+  texture2d<float>  inputTexture [[texture(0)]],
+  constant Params &params [[buffer(PARAMETER_SLOT)]]
+)
+{
+  int width = int(params.texResolution.x);
+  int height = int(params.texResolution.y);
+  int2 p = int2(inPs.uv0 * float2(width, height + height / 2));
+
+  float v;
+  if (p.y < height)
+  {
+    float3 c = fetchRgb(inputTexture, p, params.srgbInput);
+    v = floor((66.0 * c.r + 129.0 * c.g + 25.0 * c.b + 128.0) / 256.0) + 16.0;
+  }
+  else
+  {
+    int chromaWidth = width / 2;
+    int planeSize = chromaWidth * (height / 2);
+    int index = (p.y - height) * width + p.x;
+    int plane = index / planeSize;
+    index -= plane * planeSize;
+
+    int2 q = 2 * int2(index % chromaWidth, index / chromaWidth);
+    float3 c = floor((fetchRgb(inputTexture, q, params.srgbInput) +
+        fetchRgb(inputTexture, q + int2(1, 0), params.srgbInput) +
+        fetchRgb(inputTexture, q + int2(0, 1), params.srgbInput) +
+        fetchRgb(inputTexture, q + int2(1, 1), params.srgbInput) + 2.0) / 4.0);
+
+    if (plane == 0)
+      v = floor((-38.0 * c.r - 74.0 * c.g + 112.0 * c.b + 128.0) / 256.0);
+    else
+      v = floor((112.0 * c.r - 94.0 * c.g - 18.0 * c.b + 128.0) / 256.0);
+    v += 128.0;
+  }
+  return v / 255.0;
+}
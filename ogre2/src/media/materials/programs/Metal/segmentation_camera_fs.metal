@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <metal_stdlib>
+using namespace metal;
+
+struct PS_INPUT
+{
+};
+
+struct PS_OUTPUT
+{
+  float4 color [[color(0)]];
+  float4 label [[color(1)]];
+};
+
+struct Params
+{
+  float4 inColor;
+  float4 inLabel;
+};
+
+fragment PS_OUTPUT main_metal
+(
+  PS_INPUT inPs [[stage_in]],
+  constant Params &p [[buffer(PARAMETER_SLOT)]]
+)
+{
+  PS_OUTPUT outPs;
+  outPs.color = p.inColor;
+  outPs.label = p.inLabel;
+  return outPs;
+}
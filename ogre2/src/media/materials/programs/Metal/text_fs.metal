@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <metal_stdlib>
+using namespace metal;
+
+struct PS_INPUT
+{
+  float2 uv0;
+  float4 colour;
+};
+
+fragment float4 main_metal
+(
+  PS_INPUT inPs [[stage_in]],
+  texture2d<float> atlas [[texture(0)]],
+  sampler atlasSampler [[sampler(0)]]
+)
+{
+  // the font atlas stores the glyph coverage in its second channel
+  float alpha = inPs.colour.w * atlas.sample(atlasSampler, inPs.uv0).y;
+  if (alpha < 0.004f)
+    discard_fragment();
+
+  return float4(inPs.colour.xyz, alpha);
+}
@@ -39,8 +39,33 @@ struct Params
   float ambient;
   int rgbToTemp;
   int bitDepth;
+  float3 noiseOffsets;
+  float noiseMean;
+  float noiseStdDev;
 };
 
+#define PI 3.14159265358979323846264
+
+float rand(float2 co)
+{
+  float r = fract(sin(dot(co.xy, float2(12.9898,78.233))) * 43758.5453);
+  return clamp(r, 0.001, 1.0);
+}
+
+float gaussrand(float2 co, float3 offsets, float mean, float stddev)
+{
+  float U = rand(co + float2(offsets.x, offsets.x));
+  float V = rand(co + float2(offsets.y, offsets.y));
+  float R = rand(co + float2(offsets.z, offsets.z));
+  float Z;
+  if (R < 0.5)
+    Z = sqrt(-2.0 * log(U)) * sin(2.0 * PI * V);
+  else
+    Z = sqrt(-2.0 * log(U)) * cos(2.0 * PI * V);
+
+  return Z * stddev + mean;
+}
+
 float getDepth(
   float2 uv,
   texture2d<float> depthTexture,
@@ -126,6 +151,12 @@ fragment float4 main_metal
   temp = temp - heatRange / 2.0 + delta;
   clamp(temp, p.min, p.max);
 
+  if (p.noiseStdDev > 0.0 || p.noiseMean != 0.0)
+  {
+    temp = clamp(temp + gaussrand(inPs.uv0, p.noiseOffsets, p.noiseMean,
+        p.noiseStdDev), p.min, p.max);
+  }
+
   // apply resolution factor
   temp /= p.resolution;
   // normalize
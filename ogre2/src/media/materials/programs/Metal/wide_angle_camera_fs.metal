@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// For details and documentation see: wide_angle_camera_fs.glsl
+
+#include <metal_stdlib>
+using namespace metal;
+
+struct PS_INPUT
+{
+  float2 uv0;
+};
+
+fragment float4 main_metal
+(
+  PS_INPUT inPs [[stage_in]],
+  texture2d<float>  cubeUVTex [[texture(0)]],
+  texture2d<float>  tex0      [[texture(1)]],
+  texture2d<float>  tex1      [[texture(2)]],
+  texture2d<float>  tex2      [[texture(3)]],
+  texture2d<float>  tex3      [[texture(4)]],
+  texture2d<float>  tex4      [[texture(5)]],
+  texture2d<float>  tex5      [[texture(6)]],
+  sampler cubeUVTexSampler    [[sampler(0)]],
+  sampler tex0Sampler         [[sampler(1)]],
+  sampler tex1Sampler         [[sampler(2)]],
+  sampler tex2Sampler         [[sampler(3)]],
+  sampler tex3Sampler         [[sampler(4)]],
+  sampler tex4Sampler         [[sampler(5)]],
+  sampler tex5Sampler         [[sampler(6)]]
+)
+{
+  float4 data = cubeUVTex.sample(cubeUVTexSampler, inPs.uv0);
+
+  if (data.w < 0.5)
+    return float4(0.0, 0.0, 0.0, 1.0);
+
+  float faceIdx = data.z;
+  float2 uv = data.xy;
+
+  float3 color = float3(0.0);
+  if (faceIdx == 0)
+    color = tex0.sample(tex0Sampler, uv).xyz;
+  else if (faceIdx == 1)
+    color = tex1.sample(tex1Sampler, uv).xyz;
+  else if (faceIdx == 2)
+    color = tex2.sample(tex2Sampler, uv).xyz;
+  else if (faceIdx == 3)
+    color = tex3.sample(tex3Sampler, uv).xyz;
+  else if (faceIdx == 4)
+    color = tex4.sample(tex4Sampler, uv).xyz;
+  else if (faceIdx == 5)
+    color = tex5.sample(tex5Sampler, uv).xyz;
+
+  return float4(color, 1.0);
+}
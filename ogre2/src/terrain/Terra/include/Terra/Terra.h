@@ -32,6 +32,10 @@ THE SOFTWARE.
 #include "OgrePrerequisites.h"
 #include "OgreMovableObject.h"
 #include "OgreShaderParams.h"
+#include "OgreMatrix4.h"
+#include "OgreQuaternion.h"
+
+#include <map>
 
 #include "Terra/TerrainCell.h"
 
@@ -68,6 +72,28 @@ namespace Ogre
             Camera const *m_camera;
         };
 
+        /// Cell chosen by update(), after merging
+        struct CachedCell
+        {
+            size_t index;
+            GridPoint origin;
+            uint32 sizeX;
+            uint32 sizeZ;
+            uint32 lodLevel;
+        };
+
+        /// Cells chosen by update() for a camera and the camera state they
+        /// were chosen for
+        struct CachedLod
+        {
+            Vector3 cameraPos;
+            Quaternion cameraOrientation;
+            Matrix4 projection;
+            uint32 lodSkip;
+            size_t currentCell;
+            std::vector<CachedCell> cells;
+        };
+
         std::vector<float>          m_heightMap;
         uint32                      m_width;
         uint32                      m_depth; //PNG's Height
@@ -99,6 +125,23 @@ namespace Ogre
         Vector3             m_prevLightDir;
         ShadowMapper        *m_shadowMapper;
 
+        /// Number of update() calls a shadow map update is spread across
+        uint32              m_shadowMapSlices;
+        /// First shadow mapper thread group to dispatch in the next update()
+        uint32              m_shadowMapNextGroup;
+        /// True while a sliced shadow map update has not dispatched all groups
+        bool                m_shadowMapUpdateInProgress;
+        /// True if the light changed again while an update was in progress
+        bool                m_shadowMapUpdatePending;
+
+        /// Cells chosen by update() for each camera, reused while the camera
+        /// stays within the thresholds below
+        std::map<const Camera*, CachedLod> m_lodCache;
+        Real                m_lodCacheDistance;
+        Radian              m_lodCacheAngle;
+        /// Number of LOD levels skipped around the camera
+        uint32              m_lodSkip;
+
         /// When rendering shadows we want to override the data calculated by update
         /// but only temporarily, for later restoring it.
         SavedState m_savedState;
@@ -151,6 +194,12 @@ namespace Ogre
 
         void optimizeCellsAndAdd(void);
 
+        /// Restores the cells chosen for the current camera by a previous
+        /// update(), if the camera is still within the cache thresholds
+        bool restoreCachedLod(void);
+        /// Saves the cells chosen for the current camera
+        void saveCachedLod(void);
+
     public:
         Terra( IdType id, ObjectMemoryManager *objectMemoryManager, SceneManager *sceneManager,
                uint8 renderQueueId, CompositorManager2 *compositorManager, Camera *camera, bool zUp );
@@ -189,6 +238,45 @@ namespace Ogre
         */
         void update( const Vector3 &lightDir, float lightEpsilon=1e-6f );
 
+        /** Spreads each shadow map update across several calls to update(), one band
+            of the heightmap at a time, so the cost doesn't spike in a single frame.
+        @remarks
+            If the light changes again while an update is in progress, the current
+            update finishes with the newest light direction and another full update
+            follows.
+        @param slices
+            Number of update() calls a full shadow map update takes. 1 (default)
+            recomputes the whole shadow map at once.
+        */
+        void setShadowMapUpdateSlices( uint32 slices );
+        uint32 getShadowMapUpdateSlices( void ) const   { return m_shadowMapSlices; }
+
+        /** Reuses the LODs and visible cells chosen by update() for a camera as
+            long as the camera moves and turns less than the given thresholds
+            since they were chosen, so cameras rendering the terrain in turns
+            don't rebuild each other's LODs every frame.
+        @remarks
+            The cells are culled against the frustum of the camera when they are
+            chosen, so with non zero thresholds cells entering the view may
+            appear late. Any change to the projection invalidates the cells.
+        @param distance
+            Distance the camera can move. 0 (default) with an angle of 0 only
+            reuses the cells of cameras that did not move.
+        @param angle
+            Angle the camera can turn
+        */
+        void setLodCacheThreshold( Real distance, Radian angle );
+        Real getLodCacheDistance( void ) const          { return m_lodCacheDistance; }
+        Radian getLodCacheAngle( void ) const           { return m_lodCacheAngle; }
+
+        /** Starts the LODs around the camera that many levels coarser, e.g.
+            for low resolution sensors, which can't resolve the full detail.
+        @param lodSkip
+            Number of LOD levels to skip. 0 (default) keeps full detail.
+        */
+        void setLodSkip( uint32 lodSkip )               { m_lodSkip = std::min( lodSkip, 16u ); }
+        uint32 getLodSkip( void ) const                 { return m_lodSkip; }
+
         void load( const String &texName, const Vector3 &center, const Vector3 &dimensions );
         void load( Image2 &image, Vector3 center, Vector3 dimensions,
                    const String &imageName = BLANKSTRING );
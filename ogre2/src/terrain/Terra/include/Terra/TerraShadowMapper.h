@@ -52,6 +52,7 @@ namespace Ogre
         ShaderParams::Param *m_jobParamXYStep;
         ShaderParams::Param *m_jobParamIsStep;
         ShaderParams::Param *m_jobParamHeightDelta;
+        ShaderParams::Param *m_jobParamGroupOffset;
 
         //Ogre stuff
         SceneManager            *m_sceneManager;
@@ -108,7 +109,24 @@ namespace Ogre
 
         void createShadowMap( IdType id, TextureGpu *heightMapTex );
         void destroyShadowMap(void);
-        void updateShadowMap( const Vector3 &lightDir, const Vector2 &xzDimensions, float heightScale );
+        /** Updates the shadow map for the given light direction.
+        @remarks
+            Each thread group of the shadow job marches a band of lines across the
+            whole heightmap. The update can be spread over several calls by only
+            dispatching some of the bands each time.
+        @param firstGroup
+            First thread group to dispatch.
+        @param numSlices
+            Number of calls a complete update is split into. 1 dispatches everything.
+        @param outNextGroup
+            When not null, receives the firstGroup to pass to the next call, or 0 if
+            this call completed the update.
+        @return
+            True if the last thread group has been dispatched.
+        */
+        bool updateShadowMap( const Vector3 &lightDir, const Vector2 &xzDimensions,
+                              float heightScale, uint32 firstGroup=0u,
+                              uint32 numSlices=1u, uint32 *outNextGroup=0 );
 
         void fillUavDataForCompositorChannel( TextureGpu **outChannel,
                                               ResourceLayoutMap &outInitialLayouts,
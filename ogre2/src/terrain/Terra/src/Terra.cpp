@@ -90,6 +90,13 @@ namespace Ogre
         m_normalMapTex( 0 ),
         m_prevLightDir( Vector3::ZERO ),
         m_shadowMapper( 0 ),
+        m_shadowMapSlices( 1u ),
+        m_shadowMapNextGroup( 0u ),
+        m_shadowMapUpdateInProgress( false ),
+        m_shadowMapUpdatePending( false ),
+        m_lodCacheDistance( 0 ),
+        m_lodCacheAngle( 0 ),
+        m_lodSkip( 0u ),
         m_compositorManager( compositorManager ),
         m_camera( camera ),
         mHlmsTerraIndex( std::numeric_limits<uint32>::max() )
@@ -523,14 +530,38 @@ namespace Ogre
         m_collectedCells[0].clear();
     }
     //-----------------------------------------------------------------------------------
+    void Terra::setShadowMapUpdateSlices( uint32 slices )
+    {
+        m_shadowMapSlices = std::max( slices, 1u );
+    }
+    //-----------------------------------------------------------------------------------
     void Terra::update( const Vector3 &lightDir, float lightEpsilon )
     {
         const float lightCosAngleChange = Math::Clamp(
                     (float)m_prevLightDir.dotProduct( lightDir.normalisedCopy() ), -1.0f, 1.0f );
         if( lightCosAngleChange <= (1.0f - lightEpsilon) )
         {
-            m_shadowMapper->updateShadowMap( toYUp( lightDir ), m_xzDimensions, m_height );
             m_prevLightDir = lightDir.normalisedCopy();
+            if( m_shadowMapUpdateInProgress )
+            {
+                m_shadowMapUpdatePending = true;
+            }
+            else
+            {
+                m_shadowMapUpdateInProgress = true;
+                m_shadowMapNextGroup = 0u;
+            }
+        }
+        if( m_shadowMapUpdateInProgress )
+        {
+            const bool finished = m_shadowMapper->updateShadowMap(
+                        toYUp( m_prevLightDir ), m_xzDimensions, m_height,
+                        m_shadowMapNextGroup, m_shadowMapSlices, &m_shadowMapNextGroup );
+            if( finished )
+            {
+                m_shadowMapUpdateInProgress = m_shadowMapUpdatePending;
+                m_shadowMapUpdatePending = false;
+            }
         }
         //m_shadowMapper->updateShadowMap( Vector3::UNIT_X, m_xzDimensions, m_height );
         //m_shadowMapper->updateShadowMap( Vector3(2048,0,1024), m_xzDimensions, m_height );
@@ -540,10 +571,14 @@ namespace Ogre
         mRenderables.clear();
         m_currentCell = 0;
 
+        if( restoreCachedLod() )
+            return;
+
         const Vector3 camPos = toYUp( m_camera->getDerivedPosition() );
 
-        const uint32 basePixelDimension = m_basePixelDimension;
-        const uint32 vertPixelDimension = static_cast<uint32>(m_basePixelDimension * m_depthWidthRatio);
+        //Skipped LOD levels start with bigger cells of the same vertex count
+        const uint32 basePixelDimension = m_basePixelDimension << m_lodSkip;
+        const uint32 vertPixelDimension = static_cast<uint32>(m_basePixelDimension * m_depthWidthRatio) << m_lodSkip;
 
         GridPoint cellSize;
         cellSize.x = basePixelDimension;
@@ -554,7 +589,7 @@ namespace Ogre
         camCenter.x = (camCenter.x / basePixelDimension) * basePixelDimension;
         camCenter.z = (camCenter.z / vertPixelDimension) * vertPixelDimension;
 
-        uint32 currentLod = 0;
+        uint32 currentLod = m_lodSkip;
 
 //        camCenter.x = 64;
 //        camCenter.z = 64;
@@ -647,6 +682,76 @@ namespace Ogre
 
             optimizeCellsAndAdd();
         }
+
+        saveCachedLod();
+    }
+    //-----------------------------------------------------------------------------------
+    void Terra::setLodCacheThreshold( Real distance, Radian angle )
+    {
+        m_lodCacheDistance = std::max( distance, Real( 0 ) );
+        m_lodCacheAngle = std::max( angle, Radian( 0 ) );
+    }
+    //-----------------------------------------------------------------------------------
+    bool Terra::restoreCachedLod(void)
+    {
+        std::map<const Camera*, CachedLod>::const_iterator itor = m_lodCache.find( m_camera );
+        if( itor == m_lodCache.end() )
+            return false;
+
+        const CachedLod &cached = itor->second;
+        const Quaternion orientation = m_camera->getDerivedOrientation();
+        if( cached.lodSkip != m_lodSkip ||
+            cached.projection != m_camera->getProjectionMatrix() ||
+            cached.cameraPos.squaredDistance( m_camera->getDerivedPosition() ) >
+            m_lodCacheDistance * m_lodCacheDistance ||
+            !( cached.cameraOrientation == orientation ||
+               cached.cameraOrientation.equals( orientation, m_lodCacheAngle ) ) )
+        {
+            return false;
+        }
+
+        std::vector<CachedCell>::const_iterator it = cached.cells.begin();
+        std::vector<CachedCell>::const_iterator en = cached.cells.end();
+        while( it != en )
+        {
+            TerrainCell *cell = &m_terrainCells[0][it->index];
+            cell->setOrigin( it->origin, it->sizeX, it->sizeZ, it->lodLevel );
+            mRenderables.push_back( cell );
+            ++it;
+        }
+        m_currentCell = cached.currentCell;
+        return true;
+    }
+    //-----------------------------------------------------------------------------------
+    void Terra::saveCachedLod(void)
+    {
+        //Cameras are never unregistered, keep the cache bounded
+        if( m_lodCache.size() >= 64u && m_lodCache.find( m_camera ) == m_lodCache.end() )
+            m_lodCache.clear();
+
+        CachedLod &cached = m_lodCache[m_camera];
+        cached.cameraPos = m_camera->getDerivedPosition();
+        cached.cameraOrientation = m_camera->getDerivedOrientation();
+        cached.projection = m_camera->getProjectionMatrix();
+        cached.lodSkip = m_lodSkip;
+        cached.currentCell = m_currentCell;
+        cached.cells.clear();
+
+        const TerrainCell *firstCell = &m_terrainCells[0][0];
+        RenderableArray::const_iterator itor = mRenderables.begin();
+        RenderableArray::const_iterator end  = mRenderables.end();
+        while( itor != end )
+        {
+            const TerrainCell *cell = static_cast<const TerrainCell*>( *itor++ );
+            CachedCell cachedCell;
+            cachedCell.index = static_cast<size_t>( cell - firstCell );
+            cachedCell.origin.x = cell->getGridX();
+            cachedCell.origin.z = cell->getGridZ();
+            cachedCell.sizeX = cell->getSizeX();
+            cachedCell.sizeZ = cell->getSizeZ();
+            cachedCell.lodLevel = cell->getLodLevel();
+            cached.cells.push_back( cachedCell );
+        }
     }
     //-----------------------------------------------------------------------------------
     void Terra::load( const String &texName, const Vector3 &center, const Vector3 &dimensions )
@@ -670,6 +775,7 @@ namespace Ogre
         m_xzInvDimensions = 1.0f / m_xzDimensions;
         m_height = dimensions.y;
         m_basePixelDimension = 64u;
+        m_lodCache.clear();
         createHeightmap( image, imageName );
 
         {
@@ -56,6 +56,7 @@ namespace Ogre
         m_jobParamXYStep( 0 ),
         m_jobParamIsStep( 0 ),
         m_jobParamHeightDelta( 0 ),
+        m_jobParamGroupOffset( 0 ),
         m_sceneManager( sceneManager ),
         m_compositorManager( compositorManager )
     {
@@ -111,6 +112,7 @@ namespace Ogre
         m_jobParamXYStep = shaderParams.findParameter( "xyStep" );
         m_jobParamIsStep = shaderParams.findParameter( "isSteep" );
         m_jobParamHeightDelta = shaderParams.findParameter( "heightDelta" );
+        m_jobParamGroupOffset = shaderParams.findParameter( "groupOffset" );
 
         setGaussianFilterParams( 8, 0.5f );
     }
@@ -176,8 +178,9 @@ namespace Ogre
         return static_cast<float>( newErrorAtX );
     }
     //-----------------------------------------------------------------------------------
-    void ShadowMapper::updateShadowMap( const Vector3 &lightDir, const Vector2 &xzDimensions,
-                                        float heightScale )
+    bool ShadowMapper::updateShadowMap( const Vector3 &lightDir, const Vector2 &xzDimensions,
+                                        float heightScale, uint32 firstGroup,
+                                        uint32 numSlices, uint32 *outNextGroup )
     {
         struct PerGroupData
         {
@@ -356,12 +359,27 @@ namespace Ogre
         texSlot.texture = m_heightMapTex;
         m_shadowJob->setTexture( 0, texSlot );
 
-        m_shadowJob->setNumThreadGroups( totalThreadGroups, 1u, 1u );
+        //Only dispatch this call's share of the thread groups
+        numSlices = std::max( numSlices, 1u );
+        if( firstGroup >= totalThreadGroups )
+            firstGroup = 0u;
+        const uint32 groupsPerSlice = alignToNextMultiple( totalThreadGroups,
+                                                           numSlices ) / numSlices;
+        const uint32 numGroups = std::min( groupsPerSlice, totalThreadGroups - firstGroup );
+        const bool finished = firstGroup + numGroups >= totalThreadGroups;
+        if( outNextGroup )
+            *outNextGroup = finished ? 0u : firstGroup + numGroups;
+
+        if( m_jobParamGroupOffset )
+            m_jobParamGroupOffset->setManualValue( static_cast<int32>( firstGroup ) );
+        m_shadowJob->setNumThreadGroups( numGroups, 1u, 1u );
 
         ShaderParams &shaderParams = m_shadowJob->getShaderParams( "default" );
         shaderParams.setDirty();
 
         m_shadowWorkspace->_update();
+
+        return finished;
     }
     //-----------------------------------------------------------------------------------
     void ShadowMapper::fillUavDataForCompositorChannel( TextureGpu **outChannel,
@@ -19,6 +19,7 @@
 
 #include <string>
 #include "ignition/rendering/base/BaseCamera.hh"
+#include "ignition/rendering/optix/OptixCameraTypes.hh"
 #include "ignition/rendering/optix/OptixRenderTypes.hh"
 #include "ignition/rendering/optix/OptixSensor.hh"
 
@@ -45,6 +46,45 @@ namespace ignition
 
       public: virtual void Render();
 
+      /// \brief Get a CUDA device pointer to the last rendered image, for
+      /// GPU consumers that want to avoid the host round trip of Capture.
+      /// \param[in] _deviceOrdinal OptiX ordinal of the device to query
+      /// \return Device pointer or nullptr on failure
+      /// \sa OptixRenderTarget::DevicePointer
+      public: void *ImageDevicePointer(int _deviceOrdinal = 0) const;
+
+      /// \brief Enable or disable progressive rendering. When enabled, each
+      /// render traces a single jittered sample per pixel and averages it
+      /// with the samples of previous renders. Accumulation restarts
+      /// automatically when the camera or anything in the scene changes.
+      /// \param[in] _enabled True to enable progressive rendering
+      public: void SetProgressive(bool _enabled);
+
+      /// \brief Get whether progressive rendering is enabled
+      /// \return True if progressive rendering is enabled
+      /// \sa SetProgressive
+      public: bool Progressive() const;
+
+      /// \brief Set the number of samples per pixel after which progressive
+      /// rendering stops tracing new rays. Zero, the default, accumulates
+      /// without limit.
+      /// \param[in] _samples Maximum number of accumulated samples
+      public: void SetMaxSamples(unsigned int _samples);
+
+      /// \brief Get the maximum number of accumulated samples per pixel
+      /// \return Maximum number of samples, zero if unlimited
+      public: unsigned int MaxSamples() const;
+
+      /// \brief Get the number of samples per pixel accumulated in the
+      /// current progressive image
+      /// \return Number of accumulated samples
+      public: unsigned int SampleCount() const;
+
+      /// \brief Get whether the progressive image has accumulated the
+      /// maximum number of samples
+      /// \return True if SampleCount has reached MaxSamples
+      public: bool Converged() const;
+
       protected: virtual RenderTargetPtr RenderTarget() const;
 
       protected: virtual void WriteCameraToDevice();
@@ -53,6 +93,14 @@ namespace ignition
 
       protected: virtual void WritePoseToDeviceImpl();
 
+      /// \brief Get the camera parameters used by batched renders
+      /// \return Current eye, image plane, resolution and output buffer
+      /// \sa OptixScene::RenderCameras
+      protected: OptixCameraData CameraData() const;
+
+      // Documentation inherited.
+      protected: virtual bool RenderStateChanged() override;
+
       protected: virtual void Init();
 
       protected: virtual void CreateRenderTexture();
@@ -66,6 +114,9 @@ namespace ignition
 
       protected: virtual void CreateErrorProgram();
 
+      /// \brief Create the buffer that progressive samples are summed into
+      protected: virtual void CreateAccumulationBuffer();
+
       protected: optix::Program optixRenderProgram;
 
       protected: optix::Program optixClearProgram;
@@ -80,6 +131,21 @@ namespace ignition
 
       protected: unsigned int clearId;
 
+      /// \brief Sum of all samples traced in progressive mode
+      protected: optix::Buffer accumulationBuffer;
+
+      /// \brief True if progressive rendering is enabled
+      protected: bool progressive;
+
+      /// \brief Maximum number of accumulated samples, zero if unlimited
+      protected: unsigned int maxSamples;
+
+      /// \brief Number of samples in the accumulation buffer
+      protected: unsigned int sampleCount;
+
+      /// \brief True if the accumulated samples are stale
+      protected: bool accumulationDirty;
+
       private: static const std::string PTX_BASE_NAME;
 
       private: static const std::string PTX_RENDER_FUNCTION;
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OPTIX_OPTIXCAMERATYPES_HH_
+#define IGNITION_RENDERING_OPTIX_OPTIXCAMERATYPES_HH_
+
+#include <optix_math.h>
+
+#ifndef __CUDA_ARCH__
+namespace ignition
+{
+  namespace rendering
+  {
+  inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+  //
+#endif
+
+  // per camera parameters of a batched render
+  struct OptixCameraData
+  {
+    float3 eye;
+    float3 u;
+    float3 v;
+    float3 w;
+    // cppcheck-suppress unusedStructMember
+    unsigned int width;
+    // cppcheck-suppress unusedStructMember
+    unsigned int height;
+    // cppcheck-suppress unusedStructMember
+    unsigned int aa;
+    // id of the camera's output buffer
+    // cppcheck-suppress unusedStructMember
+    int output;
+  };
+
+#ifndef __CUDA_ARCH__
+  }
+  }
+}
+#endif
+
+#endif
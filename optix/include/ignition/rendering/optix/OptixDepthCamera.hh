@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OPTIX_OPTIXDEPTHCAMERA_HH_
+#define IGNITION_RENDERING_OPTIX_OPTIXDEPTHCAMERA_HH_
+
+#include <string>
+#include <vector>
+
+#include <ignition/common/Event.hh>
+
+#include "ignition/rendering/base/BaseDepthCamera.hh"
+#include "ignition/rendering/optix/OptixIncludes.hh"
+#include "ignition/rendering/optix/OptixRenderTypes.hh"
+#include "ignition/rendering/optix/OptixSensor.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Depth camera that traces one range ray per pixel. Depth and
+    /// point cloud data follow the same conventions as the other render
+    /// engines: points are given in the camera frame with x forward, the
+    /// depth image holds the x coordinate and the fourth point cloud channel
+    /// packs the RGBA color of the point.
+    class IGNITION_RENDERING_OPTIX_VISIBLE OptixDepthCamera :
+      public BaseDepthCamera<OptixSensor>
+    {
+      /// \brief Constructor
+      protected: OptixDepthCamera();
+
+      /// \brief Destructor
+      public: virtual ~OptixDepthCamera();
+
+      // Documentation inherited.
+      public: virtual void CreateDepthTexture() override;
+
+      // Documentation inherited.
+      public: virtual const float *DepthData() const override;
+
+      // Documentation inherited.
+      public: virtual ignition::common::ConnectionPtr ConnectNewDepthFrame(
+          std::function<void(const float *, unsigned int, unsigned int,
+          unsigned int, const std::string &)>  _subscriber) override;
+
+      // Documentation inherited.
+      public: virtual ignition::common::ConnectionPtr ConnectNewRGBPointCloud(
+          std::function<void(const float *, unsigned int, unsigned int,
+          unsigned int, const std::string &)>  _subscriber) override;
+
+      // Documentation inherited.
+      public: virtual void PreRender() override;
+
+      // Documentation inherited.
+      public: virtual void Render() override;
+
+      // Documentation inherited.
+      public: virtual void PostRender() override;
+
+      // Documentation inherited.
+      protected: virtual RenderTargetPtr RenderTarget() const override;
+
+      // Documentation inherited.
+      protected: virtual void Init() override;
+
+      /// \brief Write camera pose and projection to the render program
+      protected: virtual void WriteCameraToDevice();
+
+      /// \brief Create the ray generation and exception programs
+      protected: virtual void CreateRenderProgram();
+
+      /// \brief Program tracing the depth rays
+      protected: optix::Program optixRenderProgram;
+
+      /// \brief Program reporting launch errors
+      protected: optix::Program optixErrorProgram;
+
+      /// \brief Device buffer with one XYZ + packed RGBA point per pixel
+      protected: optix::Buffer optixPointBuffer;
+
+      /// \brief Color image, only filled when the point cloud has
+      /// subscribers
+      protected: OptixRenderTexturePtr renderTexture;
+
+      /// \brief Launch entry point of the render program
+      protected: unsigned int traceId = 0u;
+
+      /// \brief Depth image of the last frame
+      protected: std::vector<float> depthImage;
+
+      /// \brief Point cloud of the last frame
+      protected: std::vector<float> pointCloudImage;
+
+      /// \brief Event used to emit depth data
+      protected: ignition::common::EventT<void(const float *,
+          unsigned int, unsigned int, unsigned int,
+          const std::string &)> newDepthFrame;
+
+      /// \brief Event used to emit point cloud data
+      protected: ignition::common::EventT<void(const float *,
+          unsigned int, unsigned int, unsigned int,
+          const std::string &)> newRgbPointCloud;
+
+      /// \brief Name of the ptx file holding the render program
+      private: static const std::string PTX_BASE_NAME;
+
+      /// \brief Name of the render program
+      private: static const std::string PTX_RENDER_FUNCTION;
+
+      /// \brief Only the scene can create a depth camera
+      private: friend class OptixScene;
+    };
+    }
+  }
+}
+#endif
@@ -46,6 +46,9 @@ namespace ignition
 
       protected: OptixVisualPtr parent;
 
+      /// \brief True once a scale has been written to the device
+      protected: bool scaleWritten = false;
+
       private: friend class OptixVisual;
     };
     }
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_RENDERING_OPTIX_OPTIXGPURAYS_HH_
+#define IGNITION_RENDERING_OPTIX_OPTIXGPURAYS_HH_
+
+#include <string>
+#include <vector>
+
+#include <ignition/common/Event.hh>
+
+#include "ignition/rendering/base/BaseGpuRays.hh"
+#include "ignition/rendering/optix/OptixIncludes.hh"
+#include "ignition/rendering/optix/OptixRenderTypes.hh"
+#include "ignition/rendering/optix/OptixSensor.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief GpuRays implementation that traces every configured range
+    /// sample directly in a single launch, without rendering cube maps and
+    /// resampling them. The output has the same layout as other render
+    /// engines: RangeCount() columns by VerticalRangeCount() rows, with the
+    /// first row at the minimum vertical angle, or one row per beam of the
+    /// vertical beam table, and 3 channels per sample holding range, retro
+    /// and an unused value.
+    class IGNITION_RENDERING_OPTIX_VISIBLE OptixGpuRays :
+      public BaseGpuRays<OptixSensor>
+    {
+      /// \brief Constructor
+      protected: OptixGpuRays();
+
+      /// \brief Destructor
+      public: virtual ~OptixGpuRays();
+
+      // Documentation inherited.
+      public: virtual const float *Data() const override;
+
+      // Documentation inherited.
+      public: virtual void Copy(float *_data) override;
+
+      // Documentation inherited.
+      public: virtual common::ConnectionPtr ConnectNewGpuRaysFrame(
+                  std::function<void(const float *_frame, unsigned int _width,
+                  unsigned int _height, unsigned int _depth,
+                  const std::string &_format)> _subscriber) override;
+
+      // Documentation inherited.
+      public: virtual bool SetVerticalBeams(
+                  const std::vector<double> &_elevations,
+                  const std::vector<double> &_azimuthOffsets) override;
+
+      // Documentation inherited.
+      public: virtual void PreRender() override;
+
+      // Documentation inherited.
+      public: virtual void Render() override;
+
+      // Documentation inherited.
+      public: virtual void PostRender() override;
+
+      // Documentation inherited.
+      public: virtual RenderTargetPtr RenderTarget() const override;
+
+      // Documentation inherited.
+      protected: virtual void Init() override;
+
+      /// \brief Write sensor pose and angles to the render program
+      protected: virtual void WriteSensorToDevice();
+
+      /// \brief Create the ray generation and exception programs
+      protected: virtual void CreateRenderProgram();
+
+      /// \brief Program tracing the range rays
+      protected: optix::Program optixRenderProgram;
+
+      /// \brief Program reporting launch errors
+      protected: optix::Program optixErrorProgram;
+
+      /// \brief Device copy of the vertical beam table, elevation and
+      /// azimuth offset of each beam
+      protected: optix::Buffer optixVerticalBeams;
+
+      /// \brief Output target, one float3 sample per ray
+      protected: OptixRenderTexturePtr renderTexture;
+
+      /// \brief Launch entry point of the render program
+      protected: unsigned int traceId = 0u;
+
+      /// \brief True if the vertical beam table needs to be uploaded
+      protected: bool verticalBeamsDirty = false;
+
+      /// \brief Ranges of the last frame
+      protected: std::vector<float> gpuRaysScan;
+
+      /// \brief Event used to emit range data
+      protected: ignition::common::EventT<void(const float *,
+          unsigned int, unsigned int, unsigned int,
+          const std::string &)> newGpuRaysFrame;
+
+      /// \brief Name of the ptx file holding the render program
+      private: static const std::string PTX_BASE_NAME;
+
+      /// \brief Name of the render program
+      private: static const std::string PTX_RENDER_FUNCTION;
+
+      /// \brief Only the scene can create gpu rays
+      private: friend class OptixScene;
+    };
+    }
+  }
+}
+#endif
@@ -53,9 +53,22 @@ namespace ignition
 
       protected: virtual void WriteSpotBuffer();
 
+      /// \brief Write the grid of the point lights whose range reaches
+      /// each cell, used by the material program to shade only the point
+      /// lights near a hit point
+      protected: virtual void WritePointLightGrid();
+
+      /// \brief Write the lights that changed since the previous upload.
+      /// Lights are added again every frame, so a buffer is only written
+      /// if some light changed, and only from the first to the last light
+      /// that changed.
+      /// \param[in] _buffer Buffer to write to
+      /// \param[in] _data Light data of this frame
+      /// \param[in,out] _uploaded Light data of the previous upload
+      /// \return True if the buffer was written
       protected: template <class T>
-                 void WriteBuffer(optix::Buffer _buffer,
-                     const std::vector<T> &_data);
+                 bool WriteBuffer(optix::Buffer _buffer,
+                     const std::vector<T> &_data, std::vector<T> &_uploaded);
 
       private: void CreateBuffers();
 
@@ -70,11 +83,27 @@ namespace ignition
 
       protected: std::vector<OptixSpotLightData> spotData;
 
+      /// \brief Directional light data of the previous upload
+      protected: std::vector<OptixDirectionalLightData> uploadedDirectional;
+
+      /// \brief Point light data of the previous upload
+      protected: std::vector<OptixPointLightData> uploadedPoint;
+
+      /// \brief Spot light data of the previous upload
+      protected: std::vector<OptixSpotLightData> uploadedSpot;
+
       protected: optix::Buffer directionalBuffer;
 
       protected: optix::Buffer pointBuffer;
 
       protected: optix::Buffer spotBuffer;
+
+      /// \brief Offset and count of the point light indices of each grid
+      /// cell
+      protected: optix::Buffer pointCellBuffer;
+
+      /// \brief Indices of the point lights of the grid cells
+      protected: optix::Buffer pointIndexBuffer;
     };
     }
   }
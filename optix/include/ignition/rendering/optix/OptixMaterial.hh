@@ -141,6 +141,8 @@ namespace ignition
 
       private: static const std::string PTX_ANY_HIT_FUNC;
 
+      private: static const std::string PTX_RANGE_HIT_FUNC;
+
       private: friend class OptixScene;
     };
     }
@@ -17,8 +17,10 @@
 #ifndef IGNITION_RENDERING_OPTIX_OPTIXMESH_HH_
 #define IGNITION_RENDERING_OPTIX_OPTIXMESH_HH_
 
+#include <memory>
 #include <string>
 #include <vector>
+#include <ignition/math/Vector3.hh>
 #include "ignition/rendering/base/BaseMesh.hh"
 #include "ignition/rendering/optix/OptixGeometry.hh"
 #include "ignition/rendering/optix/OptixObject.hh"
@@ -30,6 +32,22 @@ namespace ignition
   {
     inline namespace IGNITION_RENDERING_VERSION_NAMESPACE {
     //
+    /// \brief Acceleration structure shared by the meshes created from the
+    /// same mesh descriptor. The bounds of the geometry depend on the scale
+    /// written to its instances, so the structure is only shared by meshes
+    /// with the same scale.
+    struct OptixMeshAccel
+    {
+      /// \brief Shared acceleration structure
+      optix::Acceleration accel;
+
+      /// \brief Scale the structure was built for
+      math::Vector3d scale;
+
+      /// \brief True once the scale of the first mesh is written
+      bool scaleWritten = false;
+    };
+
     class IGNITION_RENDERING_OPTIX_VISIBLE OptixMesh :
       public BaseMesh<OptixGeometry>
     {
@@ -45,12 +63,19 @@ namespace ignition
 
       protected: virtual SubMeshStorePtr SubMeshes() const;
 
+      // Documentation inherited.
+      protected: virtual void SetScale(math::Vector3d _scale) override;
+
       protected: OptixSubMeshStorePtr subMeshes;
 
       protected: optix::GeometryGroup optixGeomGroup;
 
       protected: optix::Acceleration optixAccel;
 
+      /// \brief Acceleration structure shared with the other meshes of the
+      /// same descriptor, null once the mesh has one of its own
+      protected: std::shared_ptr<OptixMeshAccel> sharedAccel;
+
       private: friend class OptixScene;
 
       private: friend class OptixMeshFactory;
@@ -18,6 +18,7 @@
 #define IGNITION_RENDERING_OPTIX_OPTIXMESHFACTORY_HH_
 
 #include <map>
+#include <memory>
 #include <string>
 #include <ignition/common/Mesh.hh>
 
@@ -63,8 +64,20 @@ namespace ignition
 
       protected: virtual OptixMeshPtr Create(OptixSubMeshStorePtr _subMeshes);
 
+      /// \brief Get the acceleration structure shared by the meshes of a
+      /// descriptor, creating it if no mesh uses it anymore
+      /// \param[in] _desc Normalized mesh descriptor
+      /// \return Shared acceleration structure
+      protected: std::shared_ptr<OptixMeshAccel> Accel(
+                     const MeshDescriptor &_desc);
+
       protected: OptixSubMeshStoreFactory subMeshStoreFactory;
 
+      /// \brief Acceleration structures of the meshes created so far,
+      /// indexed by descriptor. They are released with their last mesh.
+      protected: std::map<std::string, std::weak_ptr<OptixMeshAccel>>
+                     accelerations;
+
       protected: OptixScenePtr scene;
     };
 
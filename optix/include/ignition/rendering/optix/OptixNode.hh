@@ -75,6 +75,13 @@ namespace ignition
 
       protected: virtual bool DetachChild(NodePtr _child) override;
 
+      /// \brief Update the acceleration structure of this node's group if
+      /// its children changed. A full rebuild is only done when children
+      /// were added or removed, moved children are handled with a refit.
+      /// An update also marks the parent's acceleration for a refit, so
+      /// the change reaches the root.
+      protected: virtual void UpdateAccel();
+
       protected: OptixNodePtr parent;
 
       protected: optix::Transform optixTransform;
@@ -87,6 +94,17 @@ namespace ignition
 
       protected: bool poseDirty;
 
+      /// \brief True if children were added or removed since the
+      /// acceleration structure was last updated
+      protected: bool accelRebuild = true;
+
+      /// \brief True if the transform or bounds of a child changed since
+      /// the acceleration structure was last updated
+      protected: bool accelRefit = false;
+
+      /// \brief Current value of the acceleration's refit property
+      protected: bool accelRefitEnabled = false;
+
       protected: OptixNodeStorePtr children;
 
       protected: math::Vector3d scale = math::Vector3d::One;
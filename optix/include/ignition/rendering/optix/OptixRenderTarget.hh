@@ -39,6 +39,17 @@ namespace ignition
 
       public: virtual optix::Buffer OptixBuffer() const = 0;
 
+      /// \brief Get a CUDA device pointer to the rendered pixels, so that
+      /// they can be consumed on the GPU without copying them to host
+      /// memory first. Pixels are stored row by row as three 32-bit floats
+      /// per pixel, RGB in [0, 1]. The pointer is only valid until the render
+      /// target is resized and should be read after the camera renders.
+      /// \param[in] _deviceOrdinal OptiX ordinal of the device that holds
+      /// the buffer
+      /// \return Device pointer or nullptr if the buffer is not resident on
+      /// the given device, e.g. when rendering across multiple GPUs
+      public: void *DevicePointer(int _deviceOrdinal = 0) const;
+
       protected: unsigned int MemorySize() const;
 
       protected: float *hostData;
@@ -31,8 +31,10 @@ namespace ignition
     class OptixCamera;
     class OptixCone;
     class OptixCylinder;
+    class OptixDepthCamera;
     class OptixDirectionalLight;
     class OptixGeometry;
+    class OptixGpuRays;
     class OptixGrid;
     class OptixJointVisual;
     class OptixLight;
@@ -70,8 +72,10 @@ namespace ignition
     typedef shared_ptr<OptixCamera>               OptixCameraPtr;
     typedef shared_ptr<OptixCone>                 OptixConePtr;
     typedef shared_ptr<OptixCylinder>             OptixCylinderPtr;
+    typedef shared_ptr<OptixDepthCamera>          OptixDepthCameraPtr;
     typedef shared_ptr<OptixDirectionalLight>     OptixDirectionalLightPtr;
     typedef shared_ptr<OptixGeometry>             OptixGeometryPtr;
+    typedef shared_ptr<OptixGpuRays>              OptixGpuRaysPtr;
     typedef shared_ptr<OptixGrid>                 OptixGridPtr;
     typedef shared_ptr<OptixJointVisual>          OptixJointVisualPtr;
     typedef shared_ptr<OptixLight>                OptixLightPtr;
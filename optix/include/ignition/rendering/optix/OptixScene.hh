@@ -17,7 +17,10 @@
 #ifndef IGNITION_RENDERING_OPTIX_OPTIXSCENE_HH_
 #define IGNITION_RENDERING_OPTIX_OPTIXSCENE_HH_
 
+#include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "ignition/rendering/base/BaseScene.hh"
 
@@ -70,6 +73,26 @@ namespace ignition
       public: virtual optix::Program CreateOptixProgram(
                   const std::string &_fileBase, const std::string &_function);
 
+      /// \brief Store textures loaded after this call as BC1 blocks when
+      /// they are opaque, which uses an eighth of the memory of RGBA8 at
+      /// some loss of quality. Disabled by default.
+      /// \param[in] _enabled True to compress textures
+      public: void SetTextureCompression(bool _enabled);
+
+      /// \brief Get whether textures are block compressed
+      /// \return True if textures are compressed
+      /// \sa SetTextureCompression
+      public: bool TextureCompression() const;
+
+      /// \brief Render several cameras of this scene at once. The cameras
+      /// are traced in a single 3D launch, whose third dimension indexes
+      /// the camera, and each one writes straight into its own render
+      /// target. This amortizes the launch overhead when rendering many
+      /// small cameras, and is equivalent to calling Update on each of
+      /// them. Cameras in progressive mode are rendered individually.
+      /// \param[in] _cameras Cameras to render
+      public: void RenderCameras(const std::vector<CameraPtr> &_cameras);
+
       protected: virtual bool LoadImpl();
 
       protected: virtual bool InitImpl();
@@ -90,6 +113,10 @@ namespace ignition
       protected: virtual DepthCameraPtr CreateDepthCameraImpl(unsigned int _id,
                      const std::string &_name) override;
 
+      // Documentation inherited
+      protected: virtual GpuRaysPtr CreateGpuRaysImpl(unsigned int _id,
+                     const std::string &_name) override;
+
       protected: virtual VisualPtr CreateVisualImpl(unsigned int _id,
                      const std::string &_name);
 
@@ -184,6 +211,23 @@ namespace ignition
 
       protected: optix::Program optixMissProgram;
 
+      /// \brief True if textures are block compressed
+      protected: bool textureCompression = false;
+
+      /// \brief Texture samplers shared between materials, with their
+      /// reference counts, by file and storage format
+      protected: std::map<std::string,
+          std::pair<optix::TextureSampler, unsigned int>> textures;
+
+      /// \brief Ray generation program of batched camera renders
+      protected: optix::Program optixBatchProgram;
+
+      /// \brief Per camera parameters of the current batch
+      protected: optix::Buffer optixBatchBuffer;
+
+      /// \brief Launch entry point of batched camera renders
+      protected: unsigned int batchId = 0u;
+
       protected: optix::Geometry optixBoxGeometry;
 
       protected: optix::Geometry optixConeGeometry;
@@ -195,6 +239,8 @@ namespace ignition
       protected: math::Color ambientLight;
 
       private: friend class OptixRenderEngine;
+
+      private: friend class OptixTextureFactory;
     };
     }
   }
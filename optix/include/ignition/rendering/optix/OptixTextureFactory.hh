@@ -34,11 +34,27 @@ namespace ignition
 
       public: virtual ~OptixTextureFactory();
 
-      public: optix::TextureSampler Create(const std::string &_filename);
+      /// \brief Get a texture sampler for an image file, with a full mip
+      /// chain. Samplers are shared by everyone requesting the same file
+      /// and must be handed back with Release. Mip chains, and BC1 blocks
+      /// if compression is enabled on the scene, are cached on disk.
+      /// \param[in] _filename Image file to load
+      /// \param[in] _allowCompression False to always keep full precision,
+      /// e.g. for normal maps
+      /// \return Texture sampler
+      /// \sa OptixScene::SetTextureCompression
+      public: optix::TextureSampler Create(const std::string &_filename,
+                  bool _allowCompression = true);
 
       public: optix::TextureSampler Create();
 
-      protected: optix::Buffer CreateBuffer(const std::string &_filename);
+      /// \brief Release a texture sampler returned by Create. Shared
+      /// samplers are destroyed once the last user releases them.
+      /// \param[in] _sampler Sampler to release
+      public: void Release(optix::TextureSampler _sampler);
+
+      protected: optix::Buffer CreateBuffer(const std::string &_filename,
+                     bool _compress);
 
       protected: optix::Buffer CreateBuffer();
 
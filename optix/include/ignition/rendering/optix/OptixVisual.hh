@@ -40,6 +40,9 @@ namespace ignition
 
       public: virtual void PreRender();
 
+      // Documentation inherited.
+      protected: virtual bool PreRenderStatic() const;
+
       protected: virtual GeometryStorePtr Geometries() const;
 
       protected: virtual bool AttachGeometry(GeometryPtr _geometry);
@@ -54,6 +57,12 @@ namespace ignition
 
       protected: OptixGeometryStorePtr geometries;
 
+      /// \brief World scale last written to the attached geometries
+      protected: math::Vector3d geometryScale = math::Vector3d::One;
+
+      /// \brief True if the geometry scale needs to be written again
+      protected: bool geometryScaleDirty = true;
+
       private: friend class OptixScene;
     };
     }
@@ -16,6 +16,8 @@
  */
 #include "ignition/rendering/optix/OptixCamera.hh"
 
+#include <algorithm>
+
 #include <ignition/math/Matrix3.hh>
 #include "ignition/rendering/optix/OptixIncludes.hh"
 #include "ignition/rendering/optix/OptixRenderTarget.hh"
@@ -39,7 +41,11 @@ OptixCamera::OptixCamera() :
   optixErrorProgram(nullptr),
   renderTexture(nullptr),
   cameraDirty(true),
-  traceId(0)
+  traceId(0),
+  progressive(false),
+  maxSamples(0u),
+  sampleCount(0u),
+  accumulationDirty(true)
 {
 }
 
@@ -82,8 +88,98 @@ void OptixCamera::Render()
   unsigned int width = this->ImageWidth();
   unsigned int height = this->ImageHeight();
   optix::Context optixContext = this->scene->OptixContext();
-  optixContext->launch(this->clearId, width, height);
+
+  if (!this->progressive)
+  {
+    optixContext->launch(this->clearId, width, height);
+    optixContext->launch(this->traceId, width, height);
+    return;
+  }
+
+  // check for changes here too in case on demand rendering is off
+  this->RenderStateChanged();
+
+  RTsize bufferWidth;
+  RTsize bufferHeight;
+  this->accumulationBuffer->getSize(bufferWidth, bufferHeight);
+  if (bufferWidth != width || bufferHeight != height)
+  {
+    this->accumulationBuffer->setSize(width, height);
+    this->accumulationDirty = true;
+  }
+
+  if (this->accumulationDirty)
+  {
+    this->sampleCount = 0u;
+    this->accumulationDirty = false;
+  }
+
+  // keep the last image once enough samples are accumulated
+  if (this->Converged())
+    return;
+
+  this->optixRenderProgram["sampleIndex"]->setUint(this->sampleCount);
   optixContext->launch(this->traceId, width, height);
+  ++this->sampleCount;
+}
+
+//////////////////////////////////////////////////
+void *OptixCamera::ImageDevicePointer(int _deviceOrdinal) const
+{
+  return this->renderTexture->DevicePointer(_deviceOrdinal);
+}
+
+//////////////////////////////////////////////////
+void OptixCamera::SetProgressive(bool _enabled)
+{
+  if (this->progressive == _enabled)
+    return;
+
+  this->progressive = _enabled;
+  this->accumulationDirty = true;
+  this->optixRenderProgram["progressive"]->setUint(_enabled ? 1u : 0u);
+}
+
+//////////////////////////////////////////////////
+bool OptixCamera::Progressive() const
+{
+  return this->progressive;
+}
+
+//////////////////////////////////////////////////
+void OptixCamera::SetMaxSamples(unsigned int _samples)
+{
+  this->maxSamples = _samples;
+}
+
+//////////////////////////////////////////////////
+unsigned int OptixCamera::MaxSamples() const
+{
+  return this->maxSamples;
+}
+
+//////////////////////////////////////////////////
+unsigned int OptixCamera::SampleCount() const
+{
+  return this->accumulationDirty ? 0u : this->sampleCount;
+}
+
+//////////////////////////////////////////////////
+bool OptixCamera::Converged() const
+{
+  return this->progressive && this->maxSamples > 0u &&
+      this->SampleCount() >= this->maxSamples;
+}
+
+//////////////////////////////////////////////////
+bool OptixCamera::RenderStateChanged()
+{
+  bool changed = BaseCamera::RenderStateChanged();
+  if (changed)
+    this->accumulationDirty = true;
+
+  // with on demand rendering, keep refining until the image converged
+  return changed || (this->progressive && !this->Converged());
 }
 
 //////////////////////////////////////////////////
@@ -113,24 +209,36 @@ void OptixCamera::WritePoseToDeviceImpl()
 {
   BaseCamera::WritePoseToDeviceImpl();
 
+  OptixCameraData data = this->CameraData();
+  this->optixRenderProgram["eye"]->setFloat(data.eye);
+  this->optixRenderProgram["u"]->setFloat(data.u);
+  this->optixRenderProgram["v"]->setFloat(data.v);
+  this->optixRenderProgram["w"]->setFloat(data.w);
+}
+
+//////////////////////////////////////////////////
+OptixCameraData OptixCamera::CameraData() const
+{
   math::Pose3d worldPose = this->WorldPose();
   math::Vector3d pos = worldPose.Pos();
   math::Matrix3d rot(worldPose.Rot());
 
-  float3 eye = make_float3(pos.X(), pos.Y(), pos.Z());
-  float3   u = make_float3(-rot(0, 1), -rot(1, 1), -rot(2, 1));
-  float3   v = make_float3(-rot(0, 2), -rot(1, 2), -rot(2, 2));
-  float3   w = make_float3(rot(0, 0),  rot(1, 0),  rot(2, 0));
+  OptixCameraData data;
+  data.eye = make_float3(pos.X(), pos.Y(), pos.Z());
+  data.u = make_float3(-rot(0, 1), -rot(1, 1), -rot(2, 1));
+  data.v = make_float3(-rot(0, 2), -rot(1, 2), -rot(2, 2));
+  data.w = make_float3(rot(0, 0),  rot(1, 0),  rot(2, 0));
 
   // TODO: handle auto and manual aspect-ratio
   // v *= 1 / this->aspectRatio;
-  v *= static_cast<float>(this->ImageHeight()) / this->ImageWidth();
-  w *= 1 / (2 * tan(this->HFOV().Radian() / 2));
-
-  this->optixRenderProgram["eye"]->setFloat(eye);
-  this->optixRenderProgram["u"]->setFloat(u);
-  this->optixRenderProgram["v"]->setFloat(v);
-  this->optixRenderProgram["w"]->setFloat(w);
+  data.v *= static_cast<float>(this->ImageHeight()) / this->ImageWidth();
+  data.w *= 1 / (2 * tan(this->HFOV().Radian() / 2));
+
+  data.width = this->ImageWidth();
+  data.height = this->ImageHeight();
+  data.aa = std::max(this->AntiAliasing(), 1u);
+  data.output = this->renderTexture->OptixBuffer()->getId();
+  return data;
 }
 
 //////////////////////////////////////////////////
@@ -138,6 +246,7 @@ void OptixCamera::Init()
 {
   BaseCamera::Init();
   this->CreateRenderTexture();
+  this->CreateAccumulationBuffer();
   this->CreateRenderProgram();
   this->CreateClearProgram();
   this->CreateErrorProgram();
@@ -176,6 +285,20 @@ void OptixCamera::CreateRenderProgram()
 
   optix::Buffer optixBuffer = this->renderTexture->OptixBuffer();
   this->optixRenderProgram["buffer"]->setBuffer(optixBuffer);
+  this->optixRenderProgram["accumBuffer"]->setBuffer(
+      this->accumulationBuffer);
+  this->optixRenderProgram["progressive"]->setUint(
+      this->progressive ? 1u : 0u);
+  this->optixRenderProgram["sampleIndex"]->setUint(0u);
+}
+
+//////////////////////////////////////////////////
+void OptixCamera::CreateAccumulationBuffer()
+{
+  optix::Context optixContext = this->scene->OptixContext();
+  this->accumulationBuffer = optixContext->createBuffer(
+      RT_BUFFER_INPUT_OUTPUT | RT_BUFFER_GPU_LOCAL, RT_FORMAT_FLOAT3,
+      this->ImageWidth(), this->ImageHeight());
 }
 
 //////////////////////////////////////////////////
@@ -24,7 +24,10 @@ rtDeclareVariable(float3,   u, , );
 rtDeclareVariable(float3,   v, , );
 rtDeclareVariable(float3,   w, , );
 rtDeclareVariable(uint,    aa, , );
+rtDeclareVariable(uint, progressive, , );
+rtDeclareVariable(uint, sampleIndex, , );
 rtBuffer<float3, 2> buffer;
+rtBuffer<float3, 2> accumBuffer;
 
 // current ray variables
 rtDeclareVariable(uint2, launchIndex, rtLaunchIndex, );
@@ -143,9 +146,64 @@ static __inline__ __device__ void RenderNoAA()
   buffer[launchIndex] = data.color;
 }
 
+// tiny encryption algorithm, used as a cheap per pixel random seed
+static __inline__ __device__ uint Hash(uint _a, uint _b)
+{
+  uint sum = 0;
+
+  for (uint i = 0; i < 4; ++i)
+  {
+    sum += 0x9e3779b9;
+    _a += ((_b << 4) + 0xa341316c) ^ (_b + sum) ^ ((_b >> 5) + 0xc8013ea4);
+    _b += ((_a << 4) + 0xad90777d) ^ (_a + sum) ^ ((_a >> 5) + 0x7e95761e);
+  }
+
+  return _a;
+}
+
+// linear congruential generator returning a float in [0, 1)
+static __inline__ __device__ float Random(uint &_seed)
+{
+  _seed = 1664525u * _seed + 1013904223u;
+  return float(_seed & 0x00FFFFFF) / float(0x01000000);
+}
+
+static __inline__ __device__ void RenderProgressive()
+{
+  // jitter a single sample inside the pixel
+  uint seed = Hash(launchIndex.y * launchDim.x + launchIndex.x, sampleIndex);
+  float2 offset = make_float2(Random(seed), Random(seed));
+
+  // get image plane intersect point
+  float2 pixel = make_float2(launchIndex) + offset;
+  float2 size  = make_float2(launchDim);
+  float2 ratio = pixel / size - 0.5;
+
+  // create ray that traverses through image plane point
+  float3 direction = normalize(ratio.x * u + ratio.y * v + w);
+  optix::Ray ray(eye, direction, RT_RADIANCE, sceneEpsilon);
+
+  // initialize ray payload
+  OptixRadianceRayData data;
+  data.color = make_float3(0, 0, 0);
+  data.importance = 1;
+  data.depth = 0;
+
+  // trace ray, accumulate and write the running average
+  rtTrace(rootGroup, ray, data);
+  float3 sum = (sampleIndex == 0) ? data.color :
+      accumBuffer[launchIndex] + data.color;
+  accumBuffer[launchIndex] = sum;
+  buffer[launchIndex] = sum / float(sampleIndex + 1);
+}
+
 RT_PROGRAM void Render()
 {
-  if (aa > 1)
+  if (progressive)
+  {
+    RenderProgressive();
+  }
+  else if (aa > 1)
   {
     RenderAA();
   }
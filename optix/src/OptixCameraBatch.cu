@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <optix.h>
+#include <optix_math.h>
+#include <ignition/rendering/optix/OptixCameraTypes.hh>
+#include <ignition/rendering/optix/OptixRayTypes.hh>
+
+// cameras of the batch, indexed by the third launch dimension
+rtBuffer<OptixCameraData, 1> cameras;
+
+// current ray variables
+rtDeclareVariable(uint3, launchIndex, rtLaunchIndex, );
+
+// scene variables
+rtDeclareVariable(rtObject, rootGroup, , );
+rtDeclareVariable(float, sceneEpsilon, , );
+
+static __inline__ __device__ float3 TraceRay(const OptixCameraData &_camera,
+    const float2 &_pixel)
+{
+  // get image plane intersect point
+  float2 size  = make_float2(_camera.width, _camera.height);
+  float2 ratio = _pixel / size - 0.5;
+
+  // create ray that traverses through image plane point
+  float3 direction = normalize(ratio.x * _camera.u + ratio.y * _camera.v +
+      _camera.w);
+  optix::Ray ray(_camera.eye, direction, RT_RADIANCE, sceneEpsilon);
+
+  // initialize ray payload
+  OptixRadianceRayData data;
+  data.color = make_float3(0, 0, 0);
+  data.importance = 1;
+  data.depth = 0;
+
+  rtTrace(rootGroup, ray, data);
+  return data.color;
+}
+
+RT_PROGRAM void Render()
+{
+  const OptixCameraData camera = cameras[launchIndex.z];
+
+  // the launch is sized to the largest camera of the batch
+  if (launchIndex.x >= camera.width || launchIndex.y >= camera.height)
+    return;
+
+  float2 pixel = make_float2(launchIndex.x, launchIndex.y);
+  float3 color = make_float3(0, 0, 0);
+
+  // regular grid of aa x aa samples inside the pixel
+  for (uint x = 0; x < camera.aa; ++x)
+  {
+    for (uint y = 0; y < camera.aa; ++y)
+    {
+      float2 offset = (make_float2(x, y) + 0.5) / camera.aa;
+      color += TraceRay(camera, pixel + offset);
+    }
+  }
+
+  rtBufferId<float3, 2> output(camera.output);
+  output[make_uint2(launchIndex.x, launchIndex.y)] =
+      color / (camera.aa * camera.aa);
+}
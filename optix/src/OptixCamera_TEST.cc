@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/optix/OptixCamera.hh"
+#include "ignition/rendering/optix/OptixRenderEngine.hh"
+#include "ignition/rendering/optix/OptixScene.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(OptixCameraTest, Progressive)
+{
+  OptixRenderEngine *engine = OptixRenderEngine::Instance();
+  if (!engine->Load(std::map<std::string, std::string>()) || !engine->Init())
+  {
+    igndbg << "Engine 'optix' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetBackgroundColor(0.0, 0.0, 0.0);
+  scene->SetAmbientLight(1.0, 1.0, 1.0);
+  VisualPtr root = scene->RootVisual();
+
+  MaterialPtr material = scene->CreateMaterial();
+  ASSERT_NE(nullptr, material);
+  material->SetAmbient(1.0, 1.0, 1.0);
+  material->SetDiffuse(1.0, 1.0, 1.0);
+  material->SetEmissive(1.0, 1.0, 1.0);
+
+  VisualPtr box = scene->CreateVisual();
+  ASSERT_NE(nullptr, box);
+  box->AddGeometry(scene->CreateBox());
+  box->SetMaterial(material);
+  box->SetLocalPosition(3.0, 0.0, 0.0);
+  root->AddChild(box);
+
+  OptixCameraPtr camera =
+      std::dynamic_pointer_cast<OptixCamera>(scene->CreateCamera());
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(32u);
+  camera->SetImageHeight(24u);
+  root->AddChild(camera);
+
+  // progressive rendering is disabled by default
+  EXPECT_FALSE(camera->Progressive());
+  EXPECT_EQ(0u, camera->MaxSamples());
+  camera->Update();
+  EXPECT_EQ(0u, camera->SampleCount());
+  EXPECT_FALSE(camera->Converged());
+
+  // every render adds a sample until the maximum is reached
+  const unsigned int maxSamples = 4u;
+  camera->SetProgressive(true);
+  camera->SetMaxSamples(maxSamples);
+  EXPECT_TRUE(camera->Progressive());
+  EXPECT_EQ(maxSamples, camera->MaxSamples());
+  EXPECT_EQ(0u, camera->SampleCount());
+  for (unsigned int i = 1u; i < maxSamples; ++i)
+  {
+    camera->Update();
+    EXPECT_EQ(i, camera->SampleCount());
+    EXPECT_FALSE(camera->Converged());
+  }
+  camera->Update();
+  EXPECT_EQ(maxSamples, camera->SampleCount());
+  EXPECT_TRUE(camera->Converged());
+
+  // a converged image is kept as is
+  camera->Update();
+  EXPECT_EQ(maxSamples, camera->SampleCount());
+  EXPECT_TRUE(camera->Converged());
+
+  // the averaged image shows the box in the center and the background in
+  // the corner
+  Image image = camera->CreateImage();
+  camera->Copy(image);
+  const unsigned char *data = image.Data<unsigned char>();
+  ASSERT_NE(nullptr, data);
+  unsigned int width = camera->ImageWidth();
+  unsigned int height = camera->ImageHeight();
+  unsigned int center = ((height / 2u) * width + width / 2u) * 3u;
+  EXPECT_GT(data[center], 0u);
+  EXPECT_EQ(0u, data[0]);
+
+  // moving the camera restarts the accumulation
+  camera->SetLocalPosition(0.0, 0.1, 0.0);
+  camera->Update();
+  EXPECT_EQ(1u, camera->SampleCount());
+  EXPECT_FALSE(camera->Converged());
+
+  // so does a change to the scene
+  camera->Update();
+  EXPECT_EQ(2u, camera->SampleCount());
+  box->SetLocalPosition(3.0, 0.1, 0.0);
+  camera->Update();
+  EXPECT_EQ(1u, camera->SampleCount());
+
+  // with render on demand the camera stops rendering once converged
+  camera->SetRenderOnDemand(true);
+  for (unsigned int i = 0u; i < 2u * maxSamples; ++i)
+    camera->Update();
+  EXPECT_EQ(maxSamples, camera->SampleCount());
+  EXPECT_TRUE(camera->Converged());
+
+  // an unlimited number of samples never converges
+  camera->SetMaxSamples(0u);
+  camera->Update();
+  EXPECT_EQ(maxSamples + 1u, camera->SampleCount());
+  EXPECT_FALSE(camera->Converged());
+
+  // disabling progressive rendering drops the accumulated samples
+  camera->SetProgressive(false);
+  EXPECT_EQ(0u, camera->SampleCount());
+  EXPECT_FALSE(camera->Converged());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  engine->Fini();
+}
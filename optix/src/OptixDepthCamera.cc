@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cstring>
+
+#include <ignition/math/Matrix3.hh>
+
+#include "ignition/rendering/optix/OptixDepthCamera.hh"
+#include "ignition/rendering/optix/OptixRenderTarget.hh"
+#include "ignition/rendering/optix/OptixScene.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+
+const std::string OptixDepthCamera::PTX_BASE_NAME("OptixDepthCamera");
+
+const std::string OptixDepthCamera::PTX_RENDER_FUNCTION("Render");
+
+//////////////////////////////////////////////////
+OptixDepthCamera::OptixDepthCamera()
+{
+}
+
+//////////////////////////////////////////////////
+OptixDepthCamera::~OptixDepthCamera()
+{
+}
+
+//////////////////////////////////////////////////
+void OptixDepthCamera::Init()
+{
+  BaseDepthCamera::Init();
+
+  RenderTexturePtr base = this->scene->CreateRenderTexture();
+  this->renderTexture = std::dynamic_pointer_cast<OptixRenderTexture>(base);
+  this->renderTexture->SetFormat(PF_R8G8B8);
+
+  this->CreateRenderProgram();
+  this->Reset();
+}
+
+//////////////////////////////////////////////////
+void OptixDepthCamera::CreateDepthTexture()
+{
+  // the point buffer is sized to match the image on each render
+}
+
+//////////////////////////////////////////////////
+void OptixDepthCamera::CreateRenderProgram()
+{
+  optix::Context optixContext = this->scene->OptixContext();
+
+  this->optixPointBuffer = optixContext->createBuffer(RT_BUFFER_OUTPUT,
+      RT_FORMAT_FLOAT4, this->ImageWidth(), this->ImageHeight());
+
+  this->optixRenderProgram =
+      this->scene->CreateOptixProgram(PTX_BASE_NAME, PTX_RENDER_FUNCTION);
+  this->optixRenderProgram["pointBuffer"]->setBuffer(this->optixPointBuffer);
+  this->optixRenderProgram["buffer"]->setBuffer(
+      this->renderTexture->OptixBuffer());
+  optixContext->setRayGenerationProgram(this->traceId,
+      this->optixRenderProgram);
+
+  this->optixErrorProgram =
+      this->scene->CreateOptixProgram("OptixErrorProgram", "Error");
+  this->optixErrorProgram["buffer"]->setBuffer(
+      this->renderTexture->OptixBuffer());
+  optixContext->setExceptionProgram(this->traceId, this->optixErrorProgram);
+}
+
+//////////////////////////////////////////////////
+void OptixDepthCamera::PreRender()
+{
+  BaseDepthCamera::PreRender();
+  this->WriteCameraToDevice();
+}
+
+//////////////////////////////////////////////////
+void OptixDepthCamera::WriteCameraToDevice()
+{
+  math::Pose3d worldPose = this->WorldPose();
+  math::Vector3d pos = worldPose.Pos();
+  math::Matrix3d rot(worldPose.Rot());
+
+  float3 eye = make_float3(pos.X(), pos.Y(), pos.Z());
+  float3 xAxis = make_float3(rot(0, 0), rot(1, 0), rot(2, 0));
+  float3 yAxis = make_float3(rot(0, 1), rot(1, 1), rot(2, 1));
+  float3 zAxis = make_float3(rot(0, 2), rot(1, 2), rot(2, 2));
+
+  // image plane spanned the same way as OptixCamera
+  float3 u = -yAxis;
+  float3 v = -zAxis;
+  float3 w = xAxis;
+  v *= static_cast<float>(this->ImageHeight()) / this->ImageWidth();
+  w *= 1 / (2 * tan(this->HFOV().Radian() / 2));
+
+  this->optixRenderProgram["eye"]->setFloat(eye);
+  this->optixRenderProgram["u"]->setFloat(u);
+  this->optixRenderProgram["v"]->setFloat(v);
+  this->optixRenderProgram["w"]->setFloat(w);
+  this->optixRenderProgram["xAxis"]->setFloat(xAxis);
+  this->optixRenderProgram["yAxis"]->setFloat(yAxis);
+  this->optixRenderProgram["zAxis"]->setFloat(zAxis);
+  this->optixRenderProgram["nearClip"]->setFloat(
+      static_cast<float>(this->NearClipPlane()));
+  this->optixRenderProgram["farClip"]->setFloat(
+      static_cast<float>(this->FarClipPlane()));
+  this->optixRenderProgram["minValue"]->setFloat(-ignition::math::INF_F);
+  this->optixRenderProgram["maxValue"]->setFloat(ignition::math::INF_F);
+}
+
+//////////////////////////////////////////////////
+void OptixDepthCamera::Render()
+{
+  unsigned int width = this->ImageWidth();
+  unsigned int height = this->ImageHeight();
+
+  RTsize bufferWidth;
+  RTsize bufferHeight;
+  this->optixPointBuffer->getSize(bufferWidth, bufferHeight);
+  if (bufferWidth != width || bufferHeight != height)
+    this->optixPointBuffer->setSize(width, height);
+
+  // colors need an extra radiance ray per pixel, skip them if unused
+  bool traceColor = this->newRgbPointCloud.ConnectionCount() > 0u;
+  this->optixRenderProgram["traceColor"]->setUint(traceColor ? 1u : 0u);
+
+  optix::Context optixContext = this->scene->OptixContext();
+  optixContext->launch(this->traceId, width, height);
+}
+
+//////////////////////////////////////////////////
+void OptixDepthCamera::PostRender()
+{
+  BaseDepthCamera::PostRender();
+
+  if (this->newDepthFrame.ConnectionCount() == 0u &&
+      this->newRgbPointCloud.ConnectionCount() == 0u)
+  {
+    return;
+  }
+
+  unsigned int width = this->ImageWidth();
+  unsigned int height = this->ImageHeight();
+  unsigned int len = width * height;
+  unsigned int channelCount = 4u;
+
+  this->pointCloudImage.resize(len * channelCount);
+  this->depthImage.resize(len);
+
+  const float *deviceData =
+      static_cast<const float *>(this->optixPointBuffer->map());
+  memcpy(this->pointCloudImage.data(), deviceData,
+      len * channelCount * sizeof(float));
+  this->optixPointBuffer->unmap();
+
+  for (unsigned int i = 0; i < len; ++i)
+    this->depthImage[i] = this->pointCloudImage[i * channelCount];
+
+  this->newDepthFrame(this->depthImage.data(), width, height, 1, "FLOAT32");
+
+  if (this->newRgbPointCloud.ConnectionCount() > 0u)
+  {
+    this->newRgbPointCloud(this->pointCloudImage.data(), width, height,
+        channelCount, "PF_FLOAT32_RGBA");
+  }
+}
+
+//////////////////////////////////////////////////
+const float *OptixDepthCamera::DepthData() const
+{
+  return this->depthImage.empty() ? nullptr : this->depthImage.data();
+}
+
+//////////////////////////////////////////////////
+common::ConnectionPtr OptixDepthCamera::ConnectNewDepthFrame(
+    std::function<void(const float *, unsigned int, unsigned int,
+    unsigned int, const std::string &)>  _subscriber)
+{
+  return this->newDepthFrame.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+common::ConnectionPtr OptixDepthCamera::ConnectNewRGBPointCloud(
+    std::function<void(const float *, unsigned int, unsigned int,
+    unsigned int, const std::string &)>  _subscriber)
+{
+  return this->newRgbPointCloud.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+RenderTargetPtr OptixDepthCamera::RenderTarget() const
+{
+  return this->renderTexture;
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <optix.h>
+#include <optix_math.h>
+#include <ignition/rendering/optix/OptixRayTypes.hh>
+
+// camera variables
+rtDeclareVariable(float3,   eye, , );
+rtDeclareVariable(float3,     u, , );
+rtDeclareVariable(float3,     v, , );
+rtDeclareVariable(float3,     w, , );
+rtDeclareVariable(float3, xAxis, , );
+rtDeclareVariable(float3, yAxis, , );
+rtDeclareVariable(float3, zAxis, , );
+rtDeclareVariable(float, nearClip, , );
+rtDeclareVariable(float,  farClip, , );
+rtDeclareVariable(float, minValue, , );
+rtDeclareVariable(float, maxValue, , );
+rtDeclareVariable(uint, traceColor, , );
+rtBuffer<float4, 2> pointBuffer;
+rtBuffer<float3, 2> buffer;
+
+// current ray variables
+rtDeclareVariable(uint2, launchIndex, rtLaunchIndex, );
+rtDeclareVariable(uint2, launchDim, rtLaunchDim, );
+
+// scene variables
+rtDeclareVariable(rtObject, rootGroup, , );
+rtDeclareVariable(float, sceneEpsilon, , );
+
+static __inline__ __device__ float PackColor(const float3 &_color)
+{
+  uint r = (uint)fminf(fmaxf(255 * _color.x, 0), 255);
+  uint g = (uint)fminf(fmaxf(255 * _color.y, 0), 255);
+  uint b = (uint)fminf(fmaxf(255 * _color.z, 0), 255);
+  return __uint_as_float((r << 24) | (g << 16) | (b << 8) | 255);
+}
+
+RT_PROGRAM void Render()
+{
+  // get image plane intersect point at the pixel center
+  float2 pixel = make_float2(launchIndex) + 0.5;
+  float2 size  = make_float2(launchDim);
+  float2 ratio = pixel / size - 0.5;
+  float3 direction = normalize(ratio.x * u + ratio.y * v + w);
+
+  // trace range ray
+  optix::Ray ray(eye, direction, RT_RANGE, sceneEpsilon);
+  OptixRangeRayData data;
+  data.range = RT_DEFAULT_MAX;
+  rtTrace(rootGroup, ray, data);
+
+  // point in camera frame, x forward
+  float3 point = data.range * make_float3(dot(direction, xAxis),
+      dot(direction, yAxis), dot(direction, zAxis));
+
+  if (data.range >= RT_DEFAULT_MAX || point.x > farClip)
+    point = make_float3(maxValue);
+  else if (point.x < nearClip)
+    point = make_float3(minValue);
+
+  float color = 0;
+
+  if (traceColor)
+  {
+    optix::Ray colorRay(eye, direction, RT_RADIANCE, sceneEpsilon);
+    OptixRadianceRayData colorData;
+    colorData.color = make_float3(0, 0, 0);
+    colorData.importance = 1;
+    colorData.depth = 0;
+    rtTrace(rootGroup, colorRay, colorData);
+    buffer[launchIndex] = colorData.color;
+    color = PackColor(colorData.color);
+  }
+
+  pointBuffer[launchIndex] = make_float4(point, color);
+}
@@ -62,4 +62,18 @@ void OptixGeometry::SetScale(math::Vector3d _scale)
     optix::GeometryInstance optixGeomInstance = optixGeomGroup->getChild(i);
     optixGeomInstance["scale"]->setFloat(_scale.X(), _scale.Y(), _scale.Z());
   }
+
+  // the first scale is written before the initial build, later changes
+  // deform the geometry in place and only need the bounds refit
+  optix::Acceleration optixAccel = optixGeomGroup->getAcceleration();
+  if (this->scaleWritten)
+  {
+    // Sbvh has no refit support, switch builders once a mesh deforms
+    if (optixAccel->getBuilder() == "Sbvh")
+      optixAccel->setBuilder("Trbvh");
+    optixAccel->setProperty("refit", "1");
+  }
+
+  optixAccel->markDirty();
+  this->scaleWritten = true;
 }
@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include <ignition/math/Matrix3.hh>
+
+#include "ignition/rendering/optix/OptixGpuRays.hh"
+#include "ignition/rendering/optix/OptixRenderTarget.hh"
+#include "ignition/rendering/optix/OptixScene.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+
+const std::string OptixGpuRays::PTX_BASE_NAME("OptixGpuRays");
+
+const std::string OptixGpuRays::PTX_RENDER_FUNCTION("Render");
+
+//////////////////////////////////////////////////
+OptixGpuRays::OptixGpuRays()
+{
+  this->channels = 3u;
+}
+
+//////////////////////////////////////////////////
+OptixGpuRays::~OptixGpuRays()
+{
+}
+
+//////////////////////////////////////////////////
+void OptixGpuRays::Init()
+{
+  BaseGpuRays::Init();
+
+  RenderTexturePtr base = this->scene->CreateRenderTexture();
+  this->renderTexture = std::dynamic_pointer_cast<OptixRenderTexture>(base);
+  this->renderTexture->SetFormat(PF_FLOAT32_RGB);
+
+  this->CreateRenderProgram();
+  this->Reset();
+}
+
+//////////////////////////////////////////////////
+void OptixGpuRays::CreateRenderProgram()
+{
+  optix::Context optixContext = this->scene->OptixContext();
+
+  // optix does not allow binding empty buffers
+  this->optixVerticalBeams = optixContext->createBuffer(RT_BUFFER_INPUT,
+      RT_FORMAT_FLOAT2, 1u);
+
+  this->optixRenderProgram =
+      this->scene->CreateOptixProgram(PTX_BASE_NAME, PTX_RENDER_FUNCTION);
+  this->optixRenderProgram["buffer"]->setBuffer(
+      this->renderTexture->OptixBuffer());
+  this->optixRenderProgram["verticalBeams"]->setBuffer(
+      this->optixVerticalBeams);
+  this->optixRenderProgram["useVerticalBeams"]->setUint(0u);
+  this->verticalBeamsDirty = true;
+  optixContext->setRayGenerationProgram(this->traceId,
+      this->optixRenderProgram);
+
+  this->optixErrorProgram =
+      this->scene->CreateOptixProgram("OptixErrorProgram", "Error");
+  this->optixErrorProgram["buffer"]->setBuffer(
+      this->renderTexture->OptixBuffer());
+  optixContext->setExceptionProgram(this->traceId, this->optixErrorProgram);
+}
+
+//////////////////////////////////////////////////
+bool OptixGpuRays::SetVerticalBeams(const std::vector<double> &_elevations,
+    const std::vector<double> &_azimuthOffsets)
+{
+  if (!BaseGpuRays::SetVerticalBeams(_elevations, _azimuthOffsets))
+    return false;
+
+  this->verticalBeamsDirty = true;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void OptixGpuRays::PreRender()
+{
+  // one output sample per traced ray
+  unsigned int width = std::max(this->RangeCount(), 1);
+  unsigned int height = std::max(this->VerticalRangeCount(), 1);
+  if (this->renderTexture->Width() != width ||
+      this->renderTexture->Height() != height)
+  {
+    this->renderTexture->SetWidth(width);
+    this->renderTexture->SetHeight(height);
+  }
+
+  BaseGpuRays::PreRender();
+  this->WriteSensorToDevice();
+}
+
+//////////////////////////////////////////////////
+void OptixGpuRays::WriteSensorToDevice()
+{
+  math::Pose3d worldPose = this->WorldPose();
+  math::Vector3d pos = worldPose.Pos();
+  math::Matrix3d rot(worldPose.Rot());
+
+  this->optixRenderProgram["eye"]->setFloat(pos.X(), pos.Y(), pos.Z());
+  this->optixRenderProgram["xAxis"]->setFloat(
+      rot(0, 0), rot(1, 0), rot(2, 0));
+  this->optixRenderProgram["yAxis"]->setFloat(
+      rot(0, 1), rot(1, 1), rot(2, 1));
+  this->optixRenderProgram["zAxis"]->setFloat(
+      rot(0, 2), rot(1, 2), rot(2, 2));
+
+  // evenly spaced samples include both angle limits
+  int rangeCount = this->RangeCount();
+  double angleStep = rangeCount > 1 ?
+      (this->maxAngle - this->minAngle) / (rangeCount - 1) : 0.0;
+  int vRangeCount = this->VerticalRangeCount();
+  double vAngleStep = vRangeCount > 1 ?
+      (this->vMaxAngle - this->vMinAngle) / (vRangeCount - 1) : 0.0;
+
+  this->optixRenderProgram["angleMin"]->setFloat(
+      static_cast<float>(this->minAngle));
+  this->optixRenderProgram["angleStep"]->setFloat(
+      static_cast<float>(angleStep));
+  this->optixRenderProgram["verticalAngleMin"]->setFloat(
+      static_cast<float>(this->vMinAngle));
+  this->optixRenderProgram["verticalAngleStep"]->setFloat(
+      static_cast<float>(vAngleStep));
+
+  this->optixRenderProgram["nearClip"]->setFloat(
+      static_cast<float>(this->NearClipPlane()));
+  this->optixRenderProgram["farClip"]->setFloat(
+      static_cast<float>(this->FarClipPlane()));
+  this->optixRenderProgram["minValue"]->setFloat(
+      static_cast<float>(this->dataMinVal));
+  this->optixRenderProgram["maxValue"]->setFloat(
+      static_cast<float>(this->dataMaxVal));
+
+  // each beam is one output row, traced at its elevation with its azimuth
+  // offset added to the horizontal angle
+  if (this->verticalBeamsDirty)
+  {
+    size_t count = std::max<size_t>(this->beamElevations.size(), 1u);
+    this->optixVerticalBeams->setSize(count);
+    float *beams = static_cast<float *>(this->optixVerticalBeams->map());
+    beams[0] = 0.0f;
+    beams[1] = 0.0f;
+    for (size_t i = 0; i < this->beamElevations.size(); ++i)
+    {
+      beams[i * 2u] = static_cast<float>(this->beamElevations[i]);
+      beams[i * 2u + 1u] = this->beamAzimuthOffsets.empty() ? 0.0f :
+          static_cast<float>(this->beamAzimuthOffsets[i]);
+    }
+    this->optixVerticalBeams->unmap();
+
+    this->optixRenderProgram["useVerticalBeams"]->setUint(
+        this->beamElevations.empty() ? 0u : 1u);
+    this->verticalBeamsDirty = false;
+  }
+}
+
+//////////////////////////////////////////////////
+void OptixGpuRays::Render()
+{
+  optix::Context optixContext = this->scene->OptixContext();
+  optixContext->launch(this->traceId, this->renderTexture->Width(),
+      this->renderTexture->Height());
+}
+
+//////////////////////////////////////////////////
+void OptixGpuRays::PostRender()
+{
+  BaseGpuRays::PostRender();
+
+  unsigned int width = this->renderTexture->Width();
+  unsigned int height = this->renderTexture->Height();
+  unsigned int len = width * height * this->Channels();
+  this->gpuRaysScan.resize(len);
+
+  const float *deviceData = static_cast<const float *>(
+      this->renderTexture->OptixBuffer()->map());
+  memcpy(this->gpuRaysScan.data(), deviceData, len * sizeof(float));
+  this->renderTexture->OptixBuffer()->unmap();
+
+  this->newGpuRaysFrame(this->gpuRaysScan.data(), width, height,
+      this->Channels(), "PF_FLOAT32_RGB");
+}
+
+//////////////////////////////////////////////////
+const float *OptixGpuRays::Data() const
+{
+  return this->gpuRaysScan.empty() ? nullptr : this->gpuRaysScan.data();
+}
+
+//////////////////////////////////////////////////
+void OptixGpuRays::Copy(float *_dataDest)
+{
+  memcpy(_dataDest, this->gpuRaysScan.data(),
+      this->gpuRaysScan.size() * sizeof(float));
+}
+
+//////////////////////////////////////////////////
+common::ConnectionPtr OptixGpuRays::ConnectNewGpuRaysFrame(
+    std::function<void(const float *, unsigned int, unsigned int,
+    unsigned int, const std::string &)> _subscriber)
+{
+  return this->newGpuRaysFrame.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+RenderTargetPtr OptixGpuRays::RenderTarget() const
+{
+  return this->renderTexture;
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <optix.h>
+#include <optix_math.h>
+#include <ignition/rendering/optix/OptixRayTypes.hh>
+
+// sensor variables
+rtDeclareVariable(float3,   eye, , );
+rtDeclareVariable(float3, xAxis, , );
+rtDeclareVariable(float3, yAxis, , );
+rtDeclareVariable(float3, zAxis, , );
+rtDeclareVariable(float, angleMin, , );
+rtDeclareVariable(float, angleStep, , );
+rtDeclareVariable(float, verticalAngleMin, , );
+rtDeclareVariable(float, verticalAngleStep, , );
+rtDeclareVariable(uint, useVerticalBeams, , );
+rtDeclareVariable(float, nearClip, , );
+rtDeclareVariable(float,  farClip, , );
+rtDeclareVariable(float, minValue, , );
+rtDeclareVariable(float, maxValue, , );
+rtBuffer<float2, 1> verticalBeams;
+rtBuffer<float3, 2> buffer;
+
+// current ray variables
+rtDeclareVariable(uint2, launchIndex, rtLaunchIndex, );
+
+// scene variables
+rtDeclareVariable(rtObject, rootGroup, , );
+rtDeclareVariable(float, sceneEpsilon, , );
+
+RT_PROGRAM void Render()
+{
+  float h = angleMin + launchIndex.x * angleStep;
+  float v = verticalAngleMin + launchIndex.y * verticalAngleStep;
+  if (useVerticalBeams)
+  {
+    float2 beam = verticalBeams[launchIndex.y];
+    v = beam.x;
+    h += beam.y;
+  }
+
+  // beam direction in the sensor frame, x forward and z up
+  float cosV = cosf(v);
+  float3 direction = cosV * cosf(h) * xAxis + cosV * sinf(h) * yAxis +
+      sinf(v) * zAxis;
+
+  optix::Ray ray(eye, direction, RT_RANGE, sceneEpsilon, farClip);
+  OptixRangeRayData data;
+  data.range = RT_DEFAULT_MAX;
+  rtTrace(rootGroup, ray, data);
+
+  float range = data.range;
+  if (range > farClip)
+    range = maxValue;
+  else if (range < nearClip)
+    range = minValue;
+
+  // retro is not modelled, the third channel is unused
+  buffer[launchIndex] = make_float3(range, 0, 0);
+}
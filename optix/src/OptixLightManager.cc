@@ -14,6 +14,10 @@
  * limitations under the License.
  *
  */
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 #include "ignition/rendering/optix/OptixLightManager.hh"
 
 #include "ignition/rendering/optix/OptixLight.hh"
@@ -73,30 +77,155 @@ void OptixLightManager::Clear()
 void OptixLightManager::WriteDirectionalBuffer()
 {
   this->WriteBuffer<OptixDirectionalLightData>(this->directionalBuffer,
-      this->directionalData);
+      this->directionalData, this->uploadedDirectional);
 }
 
 //////////////////////////////////////////////////
 void OptixLightManager::WritePointBuffer()
 {
-  this->WriteBuffer<OptixPointLightData>(this->pointBuffer, this->pointData);
+  if (this->WriteBuffer<OptixPointLightData>(this->pointBuffer,
+      this->pointData, this->uploadedPoint))
+  {
+    this->WritePointLightGrid();
+  }
 }
 
 //////////////////////////////////////////////////
 void OptixLightManager::WriteSpotBuffer()
 {
-  this->WriteBuffer<OptixSpotLightData>(this->spotBuffer, this->spotData);
+  this->WriteBuffer<OptixSpotLightData>(this->spotBuffer, this->spotData,
+      this->uploadedSpot);
+}
+
+//////////////////////////////////////////////////
+void OptixLightManager::WritePointLightGrid()
+{
+  // the grid covers the spheres lit by the point lights, hit points
+  // outside of it are out of the range of every point light
+  const int kMaxCellsPerAxis = 32;
+  float3 gridMin = make_float3(0.0f);
+  float3 gridMax = make_float3(0.0f);
+  for (size_t i = 0u; i < this->pointData.size(); ++i)
+  {
+    const OptixCommonLightData &light = this->pointData[i].common;
+    float3 range = make_float3(std::max(light.atten.range, 0.0f));
+    float3 lightMin = light.position - range;
+    float3 lightMax = light.position + range;
+    gridMin = i == 0u ? lightMin : fminf(gridMin, lightMin);
+    gridMax = i == 0u ? lightMax : fmaxf(gridMax, lightMax);
+  }
+
+  float3 extent = gridMax - gridMin;
+  float cellSize = fmaxf(extent) / kMaxCellsPerAxis;
+  if (!(cellSize > 0.0f) || !std::isfinite(cellSize))
+    cellSize = 1.0f;
+  int3 gridSize = make_int3(
+      std::clamp(static_cast<int>(std::ceil(extent.x / cellSize)), 1,
+          kMaxCellsPerAxis),
+      std::clamp(static_cast<int>(std::ceil(extent.y / cellSize)), 1,
+          kMaxCellsPerAxis),
+      std::clamp(static_cast<int>(std::ceil(extent.z / cellSize)), 1,
+          kMaxCellsPerAxis));
+
+  // lights are listed in every cell their bounding box overlaps
+  std::vector<std::vector<int>> cells(
+      this->pointData.empty() ? 0u : gridSize.x * gridSize.y * gridSize.z);
+  auto cellCoord = [&](float _value, float _min, int _size)
+  {
+    return std::clamp(static_cast<int>(std::floor((_value - _min) /
+        cellSize)), 0, _size - 1);
+  };
+  for (size_t i = 0u; i < this->pointData.size(); ++i)
+  {
+    const OptixCommonLightData &light = this->pointData[i].common;
+    float range = std::max(light.atten.range, 0.0f);
+    int x0 = cellCoord(light.position.x - range, gridMin.x, gridSize.x);
+    int x1 = cellCoord(light.position.x + range, gridMin.x, gridSize.x);
+    int y0 = cellCoord(light.position.y - range, gridMin.y, gridSize.y);
+    int y1 = cellCoord(light.position.y + range, gridMin.y, gridSize.y);
+    int z0 = cellCoord(light.position.z - range, gridMin.z, gridSize.z);
+    int z1 = cellCoord(light.position.z + range, gridMin.z, gridSize.z);
+    for (int z = z0; z <= z1; ++z)
+    {
+      for (int y = y0; y <= y1; ++y)
+      {
+        for (int x = x0; x <= x1; ++x)
+        {
+          cells[(z * gridSize.y + y) * gridSize.x + x].push_back(
+              static_cast<int>(i));
+        }
+      }
+    }
+  }
+
+  std::vector<int2> ranges;
+  std::vector<int> indices;
+  ranges.reserve(cells.size());
+  for (const auto &cell : cells)
+  {
+    ranges.push_back(make_int2(static_cast<int>(indices.size()),
+        static_cast<int>(cell.size())));
+    indices.insert(indices.end(), cell.begin(), cell.end());
+  }
+
+  this->pointCellBuffer->setSize(ranges.size());
+  if (!ranges.empty())
+  {
+    std::memcpy(this->pointCellBuffer->map(), ranges.data(),
+        ranges.size() * sizeof(int2));
+    this->pointCellBuffer->unmap();
+  }
+  this->pointIndexBuffer->setSize(indices.size());
+  if (!indices.empty())
+  {
+    std::memcpy(this->pointIndexBuffer->map(), indices.data(),
+        indices.size() * sizeof(int));
+    this->pointIndexBuffer->unmap();
+  }
+
+  optix::Context optixContext = this->scene->OptixContext();
+  optixContext["pointLightGridMin"]->setFloat(gridMin);
+  optixContext["pointLightGridCellSize"]->setFloat(cellSize);
+  optixContext["pointLightGridSize"]->setInt(gridSize);
 }
 
 //////////////////////////////////////////////////
 template <class T>
-void OptixLightManager::WriteBuffer(optix::Buffer _buffer,
-    const std::vector<T> &_data)
+bool OptixLightManager::WriteBuffer(optix::Buffer _buffer,
+    const std::vector<T> &_data, std::vector<T> &_uploaded)
 {
-  _buffer->setSize(_data.size());
-  unsigned int memSize = sizeof(T) * _data.size();
-  std::memcpy(_buffer->map(), &_data[0], memSize);
+  if (_data.size() != _uploaded.size())
+  {
+    _buffer->setSize(_data.size());
+    if (!_data.empty())
+    {
+      std::memcpy(_buffer->map(), _data.data(), sizeof(T) * _data.size());
+      _buffer->unmap();
+    }
+    _uploaded = _data;
+    return true;
+  }
+
+  auto changed = [&](size_t _i)
+  {
+    return std::memcmp(&_data[_i], &_uploaded[_i], sizeof(T)) != 0;
+  };
+  size_t first = 0u;
+  while (first < _data.size() && !changed(first))
+    ++first;
+  if (first == _data.size())
+    return false;
+  size_t last = _data.size();
+  while (last > first + 1u && !changed(last - 1u))
+    --last;
+
+  // the lights outside of the changed range keep their mapped values
+  T *mapped = static_cast<T *>(_buffer->map(0u, RT_BUFFER_MAP_WRITE));
+  std::memcpy(mapped + first, &_data[first], sizeof(T) * (last - first));
   _buffer->unmap();
+  std::copy(_data.begin() + first, _data.begin() + last,
+      _uploaded.begin() + first);
+  return true;
 }
 
 //////////////////////////////////////////////////
@@ -107,6 +236,10 @@ void OptixLightManager::CreateBuffers()
 
   this->pointBuffer = this->CreateBuffer<OptixPointLightData>("pointLights");
   this->spotBuffer = this->CreateBuffer<OptixSpotLightData>("spotLights");
+
+  this->pointCellBuffer = this->CreateBuffer<int2>("pointLightCells");
+  this->pointIndexBuffer = this->CreateBuffer<int>("pointLightIndices");
+  this->WritePointLightGrid();
 }
 
 //////////////////////////////////////////////////
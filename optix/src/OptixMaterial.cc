@@ -32,6 +32,8 @@ const std::string OptixMaterial::PTX_CLOSEST_HIT_FUNC("ClosestHit");
 
 const std::string OptixMaterial::PTX_ANY_HIT_FUNC("AnyHit");
 
+const std::string OptixMaterial::PTX_RANGE_HIT_FUNC("RangeHit");
+
 //////////////////////////////////////////////////
 OptixMaterial::OptixMaterial() :
   optixMaterial(nullptr),
@@ -274,13 +276,15 @@ void OptixMaterial::Destroy()
 {
   if (this->optixTexture)
   {
-    this->optixTexture->destroy();
+    OptixTextureFactory texFactory(this->scene);
+    texFactory.Release(this->optixTexture);
     this->optixTexture = 0;
   }
 
   if (this->optixNormalMap)
   {
-    this->optixNormalMap->destroy();
+    OptixTextureFactory texFactory(this->scene);
+    texFactory.Release(this->optixNormalMap);
     this->optixNormalMap = 0;
   }
 
@@ -361,7 +365,8 @@ void OptixMaterial::WriteTextureToDeviceImpl()
 {
   if (this->optixTexture)
   {
-    this->optixTexture->destroy();
+    OptixTextureFactory texFactory(this->scene);
+    texFactory.Release(this->optixTexture);
     this->optixTexture = 0;
   }
 
@@ -383,7 +388,8 @@ void OptixMaterial::WriteNormalMapToDeviceImpl()
 {
   if (this->optixNormalMap)
   {
-    this->optixNormalMap->destroy();
+    OptixTextureFactory texFactory(this->scene);
+    texFactory.Release(this->optixNormalMap);
     this->optixNormalMap = 0;
   }
 
@@ -395,7 +401,7 @@ void OptixMaterial::WriteNormalMapToDeviceImpl()
   else
   {
     OptixTextureFactory texFactory(this->scene);
-    this->optixNormalMap = texFactory.Create(this->normalMapName);
+    this->optixNormalMap = texFactory.Create(this->normalMapName, false);
     this->optixMaterial["normSampler"]->setTextureSampler(this->optixNormalMap);
   }
 }
@@ -412,9 +418,13 @@ void OptixMaterial::Init()
   optix::Program anyHitProgram =
       this->scene->CreateOptixProgram(PTX_FILE_BASE, PTX_ANY_HIT_FUNC);
 
+  optix::Program rangeHitProgram =
+      this->scene->CreateOptixProgram(PTX_FILE_BASE, PTX_RANGE_HIT_FUNC);
+
   this->optixMaterial = optixContext->createMaterial();
   optixMaterial->setClosestHitProgram(RT_RADIANCE, closestHitProgram);
   optixMaterial->setAnyHitProgram(RT_SHADOW, anyHitProgram);
+  optixMaterial->setClosestHitProgram(RT_RANGE, rangeHitProgram);
 
   OptixTextureFactory texFactory(this->scene);
   this->optixEmptyTexture = texFactory.Create();
@@ -29,6 +29,11 @@ rtDeclareVariable(float, sceneEpsilon, , );
 rtDeclareVariable(rtObject, rootGroup, , );
 rtBuffer<OptixDirectionalLightData> directionalLights;
 rtBuffer<OptixPointLightData> pointLights;
+rtBuffer<int2> pointLightCells;
+rtBuffer<int> pointLightIndices;
+rtDeclareVariable(float3, pointLightGridMin, , );
+rtDeclareVariable(float, pointLightGridCellSize, , );
+rtDeclareVariable(int3, pointLightGridSize, , );
 rtTextureSampler<float4, 2> texSampler;
 rtTextureSampler<float4, 2> normSampler;
 rtDeclareVariable(bool, normWorldSpace, , );
@@ -47,6 +52,7 @@ rtDeclareVariable(uint, receiveShadows, , );
 rtDeclareVariable(optix::Ray, ray, rtCurrentRay, );
 rtDeclareVariable(OptixRadianceRayData, radianceData, rtPayload, );
 rtDeclareVariable(OptixShadowRayData, shadowData, rtPayload, );
+rtDeclareVariable(OptixRangeRayData, rangeData, rtPayload, );
 
 // intersect variables
 rtDeclareVariable(float, hitDist, rtIntersectionDistance, );
@@ -91,6 +97,11 @@ RT_PROGRAM void AnyHit()
   }
 }
 
+RT_PROGRAM void RangeHit()
+{
+  rangeData.range = hitDist;
+}
+
 RT_PROGRAM void ClosestHit()
 {
   float  fresnelExp    = 3.0;
@@ -224,9 +235,30 @@ RT_PROGRAM void ClosestHit()
     }
   }
 
-  for (int i = 0; i < pointLights.size() && lightingEnabled; ++i)
+  // only the point lights whose range reaches the grid cell of the hit
+  // point are shaded, cells are offsets and counts in pointLightIndices
+  int2 cell = make_int2(0, 0);
+  if (lightingEnabled && pointLightCells.size() > 0)
   {
-    OptixPointLightData light = pointLights[i];
+    float3 g = (hitPoint - pointLightGridMin) / pointLightGridCellSize;
+    int x = static_cast<int>(floorf(g.x));
+    int y = static_cast<int>(floorf(g.y));
+    int z = static_cast<int>(floorf(g.z));
+    if (x >= 0 && y >= 0 && z >= 0 && x < pointLightGridSize.x &&
+        y < pointLightGridSize.y && z < pointLightGridSize.z)
+    {
+      cell = pointLightCells[
+          (z * pointLightGridSize.y + y) * pointLightGridSize.x + x];
+    }
+  }
+
+  for (int i = 0; i < cell.y; ++i)
+  {
+    OptixPointLightData light = pointLights[pointLightIndices[cell.x + i]];
+    float dist = length(light.common.position - hitPoint);
+    if (dist > light.common.atten.range)
+      continue;
+
     float3 l = normalize(light.common.position - hitPoint);
     float ndl = dot(forwardNormal, l);
 
@@ -234,7 +266,6 @@ RT_PROGRAM void ClosestHit()
     {
       OptixShadowRayData data;
       data.attenuation = make_float3(1);
-      float dist = length(light.common.position - hitPoint);
       optix::Ray shadowRay(hitPoint, l, RT_SHADOW, sceneEpsilon, dist);
       rtTrace(rootGroup, shadowRay, data);
       float3 attenuation = data.attenuation;
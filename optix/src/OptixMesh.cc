@@ -55,6 +55,49 @@ SubMeshStorePtr OptixMesh::SubMeshes() const
   return this->subMeshes;
 }
 
+//////////////////////////////////////////////////
+void OptixMesh::SetScale(math::Vector3d _scale)
+{
+  // a structure no other mesh uses is rebuilt or refit in place
+  if (!this->sharedAccel || this->sharedAccel.use_count() == 1)
+  {
+    OptixGeometry::SetScale(_scale);
+    if (this->sharedAccel)
+    {
+      this->sharedAccel->scale = _scale;
+      this->sharedAccel->scaleWritten = true;
+    }
+    return;
+  }
+
+  unsigned int count = this->optixGeomGroup->getChildCount();
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    optix::GeometryInstance optixGeomInstance =
+        this->optixGeomGroup->getChild(i);
+    optixGeomInstance["scale"]->setFloat(_scale.X(), _scale.Y(), _scale.Z());
+  }
+
+  // the first mesh to be scaled builds the shared structure, the others
+  // only use it if their bounds are the same
+  if (!this->sharedAccel->scaleWritten)
+  {
+    this->sharedAccel->scale = _scale;
+    this->sharedAccel->scaleWritten = true;
+    this->sharedAccel->accel->markDirty();
+  }
+  else if (this->sharedAccel->scale != _scale)
+  {
+    optix::Context optixContext = this->optixGeomGroup->getContext();
+    this->optixAccel = optixContext->createAcceleration("Trbvh", "Bvh");
+    this->optixAccel->markDirty();
+    this->optixGeomGroup->setAcceleration(this->optixAccel);
+    this->sharedAccel.reset();
+  }
+
+  this->scaleWritten = true;
+}
+
 //////////////////////////////////////////////////
 // OptixSubMesh
 //////////////////////////////////////////////////
@@ -52,7 +52,43 @@ OptixMeshPtr OptixMeshFactory::Create(const MeshDescriptor &_desc)
     return nullptr;
   }
 
-  return this->Create(subMeshStore);
+  OptixMeshPtr mesh = this->Create(subMeshStore);
+
+  // the geometries are shared per descriptor already, the meshes of a
+  // descriptor also share the structure built over them
+  mesh->sharedAccel = this->Accel(normDesc);
+  mesh->optixAccel = mesh->sharedAccel->accel;
+  mesh->optixGeomGroup->setAcceleration(mesh->optixAccel);
+  return mesh;
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<OptixMeshAccel> OptixMeshFactory::Accel(
+    const MeshDescriptor &_desc)
+{
+  const std::string tail = (_desc.centerSubMesh) ? "_centered" : "_original";
+  const std::string key = _desc.meshName + "::" + _desc.subMeshName + tail;
+
+  std::shared_ptr<OptixMeshAccel> accel = this->accelerations[key].lock();
+  if (accel)
+    return accel;
+
+  // forget the structures released since
+  for (auto it = this->accelerations.begin();
+      it != this->accelerations.end();)
+  {
+    if (it->second.expired() && it->first != key)
+      it = this->accelerations.erase(it);
+    else
+      ++it;
+  }
+
+  optix::Context optixContext = this->scene->OptixContext();
+  accel = std::make_shared<OptixMeshAccel>();
+  accel->accel = optixContext->createAcceleration("Sbvh", "Bvh");
+  accel->accel->markDirty();
+  this->accelerations[key] = accel;
+  return accel;
 }
 
 //////////////////////////////////////////////////
@@ -51,8 +51,40 @@ NodePtr OptixNode::Parent() const
 void OptixNode::PreRender()
 {
   BaseNode::PreRender();
+
+  // a moved child only changes the bounds seen by the parent's
+  // acceleration, its own subtree stays valid
+  if (this->poseDirty && this->parent)
+    this->parent->accelRefit = true;
+
   this->WritePoseToDevice();
+  this->UpdateAccel();
+}
+
+//////////////////////////////////////////////////
+void OptixNode::UpdateAccel()
+{
+  if (!this->accelRebuild && !this->accelRefit)
+    return;
+
+  // refitting keeps the hierarchy and only recomputes node bounds, which is
+  // much cheaper but requires the same set of children
+  bool refit = !this->accelRebuild;
+  if (refit != this->accelRefitEnabled)
+  {
+    this->optixAccel->setProperty("refit", refit ? "1" : "0");
+    this->accelRefitEnabled = refit;
+  }
+
   this->optixAccel->markDirty();
+  this->accelRebuild = false;
+  this->accelRefit = false;
+
+  // the bounds of this subtree may have changed, and with them the bounds
+  // held by every ancestor's acceleration up to the root. Children are
+  // updated before their parent, so the refit is picked up in this pass
+  if (this->parent)
+    this->parent->accelRefit = true;
 }
 
 //////////////////////////////////////////////////
@@ -131,7 +163,8 @@ void OptixNode::Init()
   this->optixTransform = optixContext->createTransform();
   // this->optixAccel = optixContext->createAcceleration("MedianBvh", "Bvh");
   // this->optixAccel = optixContext->createAcceleration("Lbvh", "Bvh");
-  this->optixAccel = optixContext->createAcceleration("Sbvh", "Bvh");
+  // Sbvh cannot be refit, and its spatial splits only help with triangles
+  this->optixAccel = optixContext->createAcceleration("Trbvh", "Bvh");
   this->optixGroup = optixContext->createGroup();
   this->optixGroup->setAcceleration(this->optixAccel);
   this->optixTransform->setChild(this->optixGroup);
@@ -159,7 +192,8 @@ bool OptixNode::AttachChild(NodePtr _child)
   derived->SetParent(this->SharedThis());
   optix::Transform childTransform = derived->OptixTransform();
   this->optixGroup->addChild(childTransform);
-  this->optixAccel->markDirty();
+  this->accelRebuild = true;
+  this->MarkPreRenderDirty();
   return true;
 }
 
@@ -174,7 +208,8 @@ bool OptixNode::DetachChild(NodePtr _child)
   }
 
   this->optixGroup->removeChild(derived->OptixTransform());
-  this->optixAccel->markDirty();
+  this->accelRebuild = true;
+  this->MarkPreRenderDirty();
   return true;
 }
 
@@ -53,10 +53,14 @@ void OptixRenderTarget::Copy(Image &_image) const
   float3 *deviceData = static_cast<float3 *>(this->OptixBuffer()->map());
   unsigned char *imageData = _image.Data<unsigned char>();
   unsigned int count = this->width * this->height;
+  unsigned int padding = _image.RowPitch() - this->width * 3;
   unsigned int index = 0;
 
   for (unsigned int i = 0; i < count; ++i)
   {
+    if (i > 0 && i % this->width == 0)
+      index += padding;
+
     imageData[index++] =
         (unsigned char)fminf(fmaxf(255 * deviceData[i].x, 0), 255);
     imageData[index++] =
@@ -68,6 +72,21 @@ void OptixRenderTarget::Copy(Image &_image) const
   this->OptixBuffer()->unmap();
 }
 
+//////////////////////////////////////////////////
+void *OptixRenderTarget::DevicePointer(int _deviceOrdinal) const
+{
+  try
+  {
+    return this->OptixBuffer()->getDevicePointer(_deviceOrdinal);
+  }
+  catch (const optix::Exception &_e)
+  {
+    ignerr << "Unable to get device pointer of render target: "
+           << _e.getErrorString() << std::endl;
+    return nullptr;
+  }
+}
+
 //////////////////////////////////////////////////
 unsigned int OptixRenderTarget::MemorySize() const
 {
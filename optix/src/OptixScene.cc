@@ -13,6 +13,8 @@
  *
  */
 
+#include <algorithm>
+
 #include <ignition/common/Console.hh>
 
 #include "ignition/rendering/optix/OptixArrowVisual.hh"
@@ -21,7 +23,9 @@
 #include "ignition/rendering/optix/OptixCamera.hh"
 #include "ignition/rendering/optix/OptixCone.hh"
 #include "ignition/rendering/optix/OptixCylinder.hh"
+#include "ignition/rendering/optix/OptixDepthCamera.hh"
 #include "ignition/rendering/optix/OptixGeometry.hh"
+#include "ignition/rendering/optix/OptixGpuRays.hh"
 #include "ignition/rendering/optix/OptixGrid.hh"
 #include "ignition/rendering/optix/OptixLightManager.hh"
 #include "ignition/rendering/optix/OptixMeshFactory.hh"
@@ -158,6 +162,89 @@ optix::Program OptixScene::CreateOptixProgram(const std::string &_fileBase,
   return this->optixContext->createProgramFromPTXFile(fileName, _function);
 }
 
+//////////////////////////////////////////////////
+void OptixScene::SetTextureCompression(bool _enabled)
+{
+  this->textureCompression = _enabled;
+}
+
+//////////////////////////////////////////////////
+bool OptixScene::TextureCompression() const
+{
+  return this->textureCompression;
+}
+
+//////////////////////////////////////////////////
+void OptixScene::RenderCameras(const std::vector<CameraPtr> &_cameras)
+{
+  std::vector<OptixCameraPtr> batch;
+  std::vector<OptixCameraPtr> progressive;
+  for (const auto &camera : _cameras)
+  {
+    OptixCameraPtr derived = std::dynamic_pointer_cast<OptixCamera>(camera);
+    if (!derived || derived->Scene().get() != this)
+    {
+      ignerr << "Cannot batch render camera that does not belong to this "
+             << "scene" << std::endl;
+      continue;
+    }
+
+    if (derived->Progressive())
+      progressive.push_back(derived);
+    else
+      batch.push_back(derived);
+  }
+
+  if (batch.empty() && progressive.empty())
+    return;
+
+  this->PreRender();
+
+  if (!batch.empty())
+  {
+    if (!this->optixBatchProgram)
+    {
+      this->batchId = this->NextEntryId();
+      this->optixBatchProgram =
+          this->CreateOptixProgram("OptixCameraBatch", "Render");
+      this->optixBatchBuffer =
+          this->optixContext->createBuffer(RT_BUFFER_INPUT);
+      this->optixBatchBuffer->setFormat(RT_FORMAT_USER);
+      this->optixBatchBuffer->setElementSize(sizeof(OptixCameraData));
+      this->optixBatchProgram["cameras"]->setBuffer(this->optixBatchBuffer);
+      this->optixContext->setRayGenerationProgram(this->batchId,
+          this->optixBatchProgram);
+    }
+
+    // the launch covers the largest camera, smaller ones skip the rest
+    unsigned int width = 0u;
+    unsigned int height = 0u;
+    this->optixBatchBuffer->setSize(batch.size());
+    OptixCameraData *data =
+        static_cast<OptixCameraData *>(this->optixBatchBuffer->map());
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+      data[i] = batch[i]->CameraData();
+      width = std::max(width, data[i].width);
+      height = std::max(height, data[i].height);
+    }
+    this->optixBatchBuffer->unmap();
+
+    this->optixContext->launch(this->batchId, width, height, batch.size());
+  }
+
+  for (auto &camera : progressive)
+    camera->Render();
+
+  for (auto &camera : batch)
+    camera->PostRender();
+  for (auto &camera : progressive)
+    camera->PostRender();
+
+  if (!this->LegacyAutoGpuFlush())
+    this->PostRender();
+}
+
 //////////////////////////////////////////////////
 bool OptixScene::LoadImpl()
 {
@@ -238,13 +325,24 @@ CameraPtr OptixScene::CreateCameraImpl(unsigned int _id,
 }
 
 //////////////////////////////////////////////////
-DepthCameraPtr OptixScene::CreateDepthCameraImpl(unsigned int /*_id*/,
-    const std::string &/*_name*/)
+DepthCameraPtr OptixScene::CreateDepthCameraImpl(unsigned int _id,
+    const std::string &_name)
 {
-  // TODO(anyone)
-  return DepthCameraPtr();
+  OptixDepthCameraPtr camera(new OptixDepthCamera);
+  camera->traceId = this->NextEntryId();
+  bool result = this->InitObject(camera, _id, _name);
+  return (result) ? camera : nullptr;
 }
 
+//////////////////////////////////////////////////
+GpuRaysPtr OptixScene::CreateGpuRaysImpl(unsigned int _id,
+    const std::string &_name)
+{
+  OptixGpuRaysPtr gpuRays(new OptixGpuRays);
+  gpuRays->traceId = this->NextEntryId();
+  bool result = this->InitObject(gpuRays, _id, _name);
+  return (result) ? gpuRays : nullptr;
+}
 
 //////////////////////////////////////////////////
 VisualPtr OptixScene::CreateVisualImpl(unsigned int _id,
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/optix/OptixRenderEngine.hh"
+#include "ignition/rendering/optix/OptixScene.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(OptixSceneTest, RenderCameras)
+{
+  OptixRenderEngine *engine = OptixRenderEngine::Instance();
+  if (!engine->Load(std::map<std::string, std::string>()) || !engine->Init())
+  {
+    igndbg << "Engine 'optix' is not supported" << std::endl;
+    return;
+  }
+
+  // the batched program is compiled and installed with the others. A
+  // missing ptx file makes PtxFile return the bare file name.
+  std::string ptx = engine->PtxFile("OptixCameraBatch");
+  EXPECT_TRUE(common::exists(ptx)) << ptx;
+
+  ScenePtr scene = engine->CreateScene("scene");
+  OptixScenePtr optixScene = std::dynamic_pointer_cast<OptixScene>(scene);
+  ASSERT_NE(nullptr, optixScene);
+  scene->SetBackgroundColor(0.0, 0.0, 0.0);
+  scene->SetAmbientLight(1.0, 1.0, 1.0);
+  VisualPtr root = scene->RootVisual();
+
+  MaterialPtr material = scene->CreateMaterial();
+  ASSERT_NE(nullptr, material);
+  material->SetAmbient(1.0, 1.0, 1.0);
+  material->SetDiffuse(1.0, 1.0, 1.0);
+  material->SetEmissive(1.0, 1.0, 1.0);
+
+  VisualPtr box = scene->CreateVisual();
+  ASSERT_NE(nullptr, box);
+  box->AddGeometry(scene->CreateBox());
+  box->SetMaterial(material);
+  box->SetLocalPosition(3.0, 0.0, 0.0);
+  root->AddChild(box);
+
+  // cameras of different sizes share the launch
+  std::vector<CameraPtr> cameras;
+  for (unsigned int width : {64u, 32u})
+  {
+    CameraPtr camera = scene->CreateCamera();
+    ASSERT_NE(nullptr, camera);
+    camera->SetImageWidth(width);
+    camera->SetImageHeight(width * 3u / 4u);
+    camera->SetAntiAliasing(0u);
+    root->AddChild(camera);
+    cameras.push_back(camera);
+  }
+
+  // loading the batched program throws if its ptx is missing
+  ASSERT_NO_THROW(optixScene->RenderCameras(cameras));
+
+  // every camera sees the box in the center and the background in the
+  // corner
+  for (const CameraPtr &camera : cameras)
+  {
+    Image image = camera->CreateImage();
+    camera->Copy(image);
+    const unsigned char *data = image.Data<unsigned char>();
+    ASSERT_NE(nullptr, data);
+    unsigned int width = camera->ImageWidth();
+    unsigned int height = camera->ImageHeight();
+    unsigned int center = ((height / 2u) * width + width / 2u) * 3u;
+    EXPECT_GT(data[center], 0u);
+    EXPECT_EQ(0u, data[0]);
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  engine->Fini();
+}
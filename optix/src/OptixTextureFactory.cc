@@ -15,58 +15,179 @@
  */
 
 #include <FreeImage.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
 #include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Util.hh>
 
 #include "ignition/rendering/config.hh"
 #include "ignition/rendering/optix/OptixTextureFactory.hh"
 #include "ignition/rendering/optix/OptixScene.hh"
+#include "ignition/rendering/Utils.hh"
 
 using namespace ignition;
 using namespace rendering;
 
-// TODO: clone texture sampler, reuse texture buffers
+/// \brief Signature and version of cached texture files
+static const char kTextureCacheMagic[8] = {'I', 'G', 'N', 'T', 'E', 'X',
+    '0', '1'};
 
-OptixTextureFactory::OptixTextureFactory(OptixScenePtr _scene) :
-  scene(_scene)
+/// \brief Header of a cached texture file. It is followed by the data of
+/// each mip level, largest first
+struct TextureCacheHeader
 {
-}
+  /// \brief File signature and format version
+  char magic[8];
+
+  /// \brief 1 if levels are BC1 blocks, 0 if RGBA8 pixels
+  uint32_t compressed;
+
+  /// \brief Width of the first level in pixels
+  uint32_t width;
+
+  /// \brief Height of the first level in pixels
+  uint32_t height;
+
+  /// \brief Number of mip levels
+  uint32_t levels;
+};
+
+/// \brief Decoded texture with its mip chain
+struct TextureData
+{
+  /// \brief True if levels hold BC1 blocks instead of RGBA8 pixels
+  bool compressed = false;
+
+  /// \brief Width of the first level in pixels
+  unsigned int width = 0u;
+
+  /// \brief Height of the first level in pixels
+  unsigned int height = 0u;
+
+  /// \brief Data of each mip level, largest first
+  std::vector<std::vector<unsigned char>> levels;
+};
 
 //////////////////////////////////////////////////
-OptixTextureFactory::~OptixTextureFactory()
+/// \brief Size in bytes of a mip level
+static size_t LevelSize(bool _compressed, unsigned int _width,
+    unsigned int _height)
 {
+  if (_compressed)
+    return static_cast<size_t>((_width + 3) / 4) * ((_height + 3) / 4) * 8u;
+  return static_cast<size_t>(_width) * _height * 4u;
 }
 
 //////////////////////////////////////////////////
-optix::TextureSampler OptixTextureFactory::Create(const std::string &_filename)
+/// \brief Path of the cached mip chain of a texture file, keyed on the
+/// file contents so edited files are picked up
+static std::string TextureCachePath(const std::string &_filename,
+    bool _compress)
 {
-  optix::Buffer buffer = this->CreateBuffer(_filename);
-  return this->CreateSampler(buffer);
+  std::ifstream in(_filename, std::ios::binary);
+  if (!in)
+    return std::string();
+  std::stringstream buffer;
+  buffer << in.rdbuf();
+
+  std::stringstream key;
+  key << common::sha1<std::string>(buffer.str()) << " " << _compress;
+
+  return common::joinPaths(cacheDirectory("optix-texture-cache"),
+      common::sha1<std::string>(key.str()) + ".bin");
 }
 
 //////////////////////////////////////////////////
-optix::TextureSampler OptixTextureFactory::Create()
+/// \brief Load a cached mip chain
+static bool LoadTextureCache(const std::string &_path, TextureData &_data)
 {
-  optix::Buffer buffer = this->CreateBuffer();
-  return this->CreateSampler(buffer);
+  if (_path.empty() || !common::isFile(_path))
+    return false;
+
+  std::ifstream in(_path, std::ios::binary);
+  TextureCacheHeader header;
+  in.read(reinterpret_cast<char *>(&header), sizeof(header));
+  if (!in || std::memcmp(header.magic, kTextureCacheMagic,
+        sizeof(kTextureCacheMagic)) != 0 || header.levels == 0u)
+  {
+    return false;
+  }
+
+  _data.compressed = header.compressed != 0u;
+  _data.width = header.width;
+  _data.height = header.height;
+  _data.levels.resize(header.levels);
+  for (unsigned int i = 0; i < header.levels; ++i)
+  {
+    _data.levels[i].resize(LevelSize(_data.compressed,
+        std::max(_data.width >> i, 1u), std::max(_data.height >> i, 1u)));
+    in.read(reinterpret_cast<char *>(_data.levels[i].data()),
+        _data.levels[i].size());
+  }
+
+  return static_cast<bool>(in);
 }
 
 //////////////////////////////////////////////////
-optix::Buffer OptixTextureFactory::CreateBuffer(const std::string &_filename)
+/// \brief Save a mip chain to the cache
+static void SaveTextureCache(const std::string &_path,
+    const TextureData &_data)
 {
-  if (_filename.empty())
+  if (_path.empty())
+    return;
+
+  const std::string dir = common::parentPath(_path);
+  if (!common::isDirectory(dir) && !common::createDirectories(dir))
   {
-    ignerr << "Cannot load texture from empty filename" << std::endl;
-    return this->CreateBuffer();
+    ignwarn << "Unable to create texture cache directory [" << dir << "]"
+            << std::endl;
+    return;
+  }
+
+  TextureCacheHeader header;
+  std::memcpy(header.magic, kTextureCacheMagic, sizeof(kTextureCacheMagic));
+  header.compressed = _data.compressed ? 1u : 0u;
+  header.width = _data.width;
+  header.height = _data.height;
+  header.levels = static_cast<uint32_t>(_data.levels.size());
+
+  // other processes never read a partially written cache
+  bool written = writeFileAtomically(_path,
+      [&](const std::string &_tmpPath)
+  {
+    std::ofstream out(_tmpPath, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (const auto &level : _data.levels)
+    {
+      out.write(reinterpret_cast<const char *>(level.data()), level.size());
+    }
+    out.close();
+    return static_cast<bool>(out);
+  });
+  if (!written)
+  {
+    ignwarn << "Unable to write texture cache [" << _path << "]"
+            << std::endl;
   }
+}
 
+//////////////////////////////////////////////////
+/// \brief Load an image file as top-down RGBA8 pixels
+static bool LoadImage(const std::string &_filename,
+    std::vector<unsigned char> &_pixels, unsigned int &_width,
+    unsigned int &_height)
+{
   FREE_IMAGE_FORMAT format = FreeImage_GetFileType(_filename.c_str(), 0);
   FIBITMAP *image = FreeImage_Load(format, _filename.c_str());
 
   if (!image)
-  {
-    ignerr << "Unable to load texture: " << _filename << std::endl;
-    return this->CreateBuffer();
-  }
+    return false;
 
   FIBITMAP *temp = image;
   image = FreeImage_ConvertTo32Bits(image);
@@ -93,22 +214,308 @@ optix::Buffer OptixTextureFactory::CreateBuffer(const std::string &_filename)
 
   FreeImage_Unload(temp);
 
-  optix::Context optixContext = this->scene->OptixContext();
-
-  optix::Buffer buffer = optixContext->createBuffer(RT_BUFFER_INPUT);
-  buffer->setFormat(RT_FORMAT_UNSIGNED_BYTE4);
-  buffer->setSize(w, h);
   // get raw bits after flipping vertical axis (last bool arg)
   // as free image stores data upside down in memory
-  FreeImage_ConvertToRawBits(reinterpret_cast<BYTE *>(buffer->map()),
+  _pixels.resize(static_cast<size_t>(w) * h * 4u);
+  FreeImage_ConvertToRawBits(reinterpret_cast<BYTE *>(_pixels.data()),
       image, FreeImage_GetLine(image), FreeImage_GetBPP(image),
       FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, true);
-  buffer->unmap();
   FreeImage_Unload(image);
 
-  return buffer;
+  _width = w;
+  _height = h;
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Downsample RGBA8 pixels by two with a box filter
+static std::vector<unsigned char> Downsample(
+    const std::vector<unsigned char> &_pixels, unsigned int _width,
+    unsigned int _height)
+{
+  unsigned int w = std::max(_width / 2, 1u);
+  unsigned int h = std::max(_height / 2, 1u);
+  std::vector<unsigned char> result(static_cast<size_t>(w) * h * 4u);
+
+  for (unsigned int y = 0; y < h; ++y)
+  {
+    unsigned int y0 = std::min(y * 2, _height - 1);
+    unsigned int y1 = std::min(y * 2 + 1, _height - 1);
+    for (unsigned int x = 0; x < w; ++x)
+    {
+      unsigned int x0 = std::min(x * 2, _width - 1);
+      unsigned int x1 = std::min(x * 2 + 1, _width - 1);
+      for (unsigned int c = 0; c < 4; ++c)
+      {
+        unsigned int sum =
+            _pixels[(y0 * _width + x0) * 4 + c] +
+            _pixels[(y0 * _width + x1) * 4 + c] +
+            _pixels[(y1 * _width + x0) * 4 + c] +
+            _pixels[(y1 * _width + x1) * 4 + c];
+        result[(y * w + x) * 4 + c] = static_cast<unsigned char>(
+            (sum + 2) / 4);
+      }
+    }
+  }
+
+  return result;
+}
+
+//////////////////////////////////////////////////
+/// \brief Convert an 8 bit color to RGB565
+static uint16_t PackRgb565(const unsigned char *_color)
+{
+  return static_cast<uint16_t>(((_color[0] >> 3) << 11) |
+      ((_color[1] >> 2) << 5) | (_color[2] >> 3));
 }
 
+//////////////////////////////////////////////////
+/// \brief Expand an RGB565 color to 8 bits per channel
+static void UnpackRgb565(uint16_t _packed, int *_color)
+{
+  _color[0] = ((_packed >> 11) & 0x1F) * 255 / 31;
+  _color[1] = ((_packed >> 5) & 0x3F) * 255 / 63;
+  _color[2] = (_packed & 0x1F) * 255 / 31;
+}
+
+//////////////////////////////////////////////////
+/// \brief Compress RGBA8 pixels to BC1 blocks. The endpoints are the
+/// corners of each block's color bounding box, which is fast and good
+/// enough for diffuse textures
+static std::vector<unsigned char> CompressBC1(
+    const std::vector<unsigned char> &_pixels, unsigned int _width,
+    unsigned int _height)
+{
+  unsigned int blocksX = (_width + 3) / 4;
+  unsigned int blocksY = (_height + 3) / 4;
+  std::vector<unsigned char> result(
+      static_cast<size_t>(blocksX) * blocksY * 8u);
+
+  for (unsigned int by = 0; by < blocksY; ++by)
+  {
+    for (unsigned int bx = 0; bx < blocksX; ++bx)
+    {
+      // gather the block, repeating edge pixels of partial blocks
+      unsigned char block[16][4];
+      unsigned char minColor[3] = {255, 255, 255};
+      unsigned char maxColor[3] = {0, 0, 0};
+      for (unsigned int i = 0; i < 16; ++i)
+      {
+        unsigned int x = std::min(bx * 4 + i % 4, _width - 1);
+        unsigned int y = std::min(by * 4 + i / 4, _height - 1);
+        std::memcpy(block[i], &_pixels[(y * _width + x) * 4], 4);
+        for (unsigned int c = 0; c < 3; ++c)
+        {
+          minColor[c] = std::min(minColor[c], block[i][c]);
+          maxColor[c] = std::max(maxColor[c], block[i][c]);
+        }
+      }
+
+      uint16_t c0 = PackRgb565(maxColor);
+      uint16_t c1 = PackRgb565(minColor);
+      uint32_t indices = 0u;
+
+      // c0 > c1 selects the 4 color mode
+      if (c0 < c1)
+        std::swap(c0, c1);
+
+      if (c0 != c1)
+      {
+        int palette[4][3];
+        UnpackRgb565(c0, palette[0]);
+        UnpackRgb565(c1, palette[1]);
+        for (unsigned int c = 0; c < 3; ++c)
+        {
+          palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+          palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        for (unsigned int i = 0; i < 16; ++i)
+        {
+          unsigned int best = 0u;
+          int bestDist = -1;
+          for (unsigned int p = 0; p < 4; ++p)
+          {
+            int dist = 0;
+            for (unsigned int c = 0; c < 3; ++c)
+            {
+              int d = block[i][c] - palette[p][c];
+              dist += d * d;
+            }
+            if (bestDist < 0 || dist < bestDist)
+            {
+              bestDist = dist;
+              best = p;
+            }
+          }
+          indices |= best << (i * 2);
+        }
+      }
+
+      unsigned char *out = &result[(static_cast<size_t>(by) * blocksX + bx) *
+          8u];
+      out[0] = c0 & 0xFF;
+      out[1] = c0 >> 8;
+      out[2] = c1 & 0xFF;
+      out[3] = c1 >> 8;
+      out[4] = indices & 0xFF;
+      out[5] = (indices >> 8) & 0xFF;
+      out[6] = (indices >> 16) & 0xFF;
+      out[7] = indices >> 24;
+    }
+  }
+
+  return result;
+}
+
+//////////////////////////////////////////////////
+/// \brief Decode a texture file and build its mip chain
+static bool BuildTexture(const std::string &_filename, bool _compress,
+    TextureData &_data)
+{
+  std::vector<unsigned char> pixels;
+  if (!LoadImage(_filename, pixels, _data.width, _data.height))
+    return false;
+
+  // BC1 only has 1 bit alpha, keep textures with transparency uncompressed
+  bool opaque = true;
+  for (size_t i = 3; i < pixels.size() && opaque; i += 4)
+    opaque = pixels[i] == 255;
+  _data.compressed = _compress && opaque;
+
+  unsigned int w = _data.width;
+  unsigned int h = _data.height;
+  while (true)
+  {
+    _data.levels.push_back(_data.compressed ?
+        CompressBC1(pixels, w, h) : pixels);
+
+    if (w == 1u && h == 1u)
+      break;
+
+    pixels = Downsample(pixels, w, h);
+    w = std::max(w / 2, 1u);
+    h = std::max(h / 2, 1u);
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+OptixTextureFactory::OptixTextureFactory(OptixScenePtr _scene) :
+  scene(_scene)
+{
+}
+
+//////////////////////////////////////////////////
+OptixTextureFactory::~OptixTextureFactory()
+{
+}
+
+//////////////////////////////////////////////////
+optix::TextureSampler OptixTextureFactory::Create(const std::string &_filename,
+    bool _allowCompression)
+{
+  bool compress = _allowCompression && this->scene->TextureCompression();
+  const std::string key = _filename + (compress ? "|bc1" : "|rgba8");
+
+  // samplers are shared by all materials using the same file
+  auto it = this->scene->textures.find(key);
+  if (it != this->scene->textures.end())
+  {
+    ++it->second.second;
+    return it->second.first;
+  }
+
+  optix::Buffer buffer = this->CreateBuffer(_filename, compress);
+  optix::TextureSampler sampler = this->CreateSampler(buffer);
+  this->scene->textures[key] = std::make_pair(sampler, 1u);
+  return sampler;
+}
+
+//////////////////////////////////////////////////
+optix::TextureSampler OptixTextureFactory::Create()
+{
+  optix::Buffer buffer = this->CreateBuffer();
+  return this->CreateSampler(buffer);
+}
+
+//////////////////////////////////////////////////
+void OptixTextureFactory::Release(optix::TextureSampler _sampler)
+{
+  if (!_sampler)
+    return;
+
+  for (auto it = this->scene->textures.begin();
+      it != this->scene->textures.end(); ++it)
+  {
+    if (it->second.first->get() != _sampler->get())
+      continue;
+
+    if (--it->second.second == 0u)
+    {
+      optix::Buffer buffer = _sampler->getBuffer();
+      _sampler->destroy();
+      buffer->destroy();
+      this->scene->textures.erase(it);
+    }
+    return;
+  }
+
+  // not shared, e.g. the empty texture
+  _sampler->destroy();
+}
+
+//////////////////////////////////////////////////
+optix::Buffer OptixTextureFactory::CreateBuffer(const std::string &_filename,
+    bool _compress)
+{
+  if (_filename.empty())
+  {
+    ignerr << "Cannot load texture from empty filename" << std::endl;
+    return this->CreateBuffer();
+  }
+
+  // decoding, filtering and compressing large textures is slow, reuse the
+  // results of previous runs
+  TextureData data;
+  const std::string cachePath = TextureCachePath(_filename, _compress);
+  if (!LoadTextureCache(cachePath, data))
+  {
+    data = TextureData();
+    if (!BuildTexture(_filename, _compress, data))
+    {
+      ignerr << "Unable to load texture: " << _filename << std::endl;
+      return this->CreateBuffer();
+    }
+    SaveTextureCache(cachePath, data);
+  }
+
+  optix::Context optixContext = this->scene->OptixContext();
+
+  optix::Buffer buffer = optixContext->createBuffer(RT_BUFFER_INPUT);
+  if (data.compressed)
+  {
+    // block compressed buffers are sized in blocks
+    buffer->setFormat(RT_FORMAT_UNSIGNED_BC1);
+    buffer->setSize((data.width + 3) / 4, (data.height + 3) / 4);
+  }
+  else
+  {
+    buffer->setFormat(RT_FORMAT_UNSIGNED_BYTE4);
+    buffer->setSize(data.width, data.height);
+  }
+  buffer->setMipLevelCount(static_cast<unsigned int>(data.levels.size()));
+
+  for (unsigned int i = 0; i < data.levels.size(); ++i)
+  {
+    std::memcpy(buffer->map(i, RT_BUFFER_MAP_WRITE_DISCARD),
+        data.levels[i].data(), data.levels[i].size());
+    buffer->unmap(i);
+  }
+
+  return buffer;
+}
 //////////////////////////////////////////////////
 optix::Buffer OptixTextureFactory::CreateBuffer()
 {
@@ -140,12 +547,12 @@ optix::TextureSampler OptixTextureFactory::CreateSampler(optix::Buffer _buffer)
   sampler->setIndexingMode(RT_TEXTURE_INDEX_NORMALIZED_COORDINATES);
   sampler->setReadMode(RT_TEXTURE_READ_NORMALIZED_FLOAT);
   sampler->setMaxAnisotropy(1.0);
-  sampler->setMipLevelCount(1.0);
-  sampler->setArraySize(1);
-  sampler->setBuffer(0, 0, _buffer);
+  sampler->setBuffer(_buffer);
 
-  sampler->setFilteringModes(RT_FILTER_LINEAR, RT_FILTER_LINEAR,
-      RT_FILTER_NONE);
+  // trilinear filtering when the buffer has a mip chain
+  RTfiltermode mipMode = _buffer->getMipLevelCount() > 1u ?
+      RT_FILTER_LINEAR : RT_FILTER_NONE;
+  sampler->setFilteringModes(RT_FILTER_LINEAR, RT_FILTER_LINEAR, mipMode);
 
   return sampler;
 }
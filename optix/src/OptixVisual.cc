@@ -52,14 +52,30 @@ void OptixVisual::PreRender()
 {
   BaseVisual::PreRender();
 
-  // TODO: optimize this funtionality
   math::Vector3d worldScale = this->WorldScale();
+  if (!this->geometryScaleDirty && worldScale == this->geometryScale)
+    return;
 
   for (unsigned int i = 0; i < this->GeometryCount(); ++i)
   {
     OptixGeometryPtr geometry = this->geometries->DerivedByIndex(i);
     geometry->SetScale(worldScale);
   }
+
+  this->geometryScale = worldScale;
+  this->geometryScaleDirty = false;
+
+  // scaled geometry has new bounds, but the same set of children
+  this->accelRefit = true;
+  this->UpdateAccel();
+}
+
+//////////////////////////////////////////////////
+bool OptixVisual::PreRenderStatic() const
+{
+  // geometry scale is derived from the world scale, which can change
+  // without this visual being marked dirty
+  return false;
 }
 
 //////////////////////////////////////////////////
@@ -85,7 +101,8 @@ bool OptixVisual::AttachGeometry(GeometryPtr _geometry)
   derived->SetParent(this->SharedThis());
   optix::GeometryGroup childGeomGroup = derived->OptixGeometryGroup();
   this->optixGroup->addChild(childGeomGroup);
-  this->optixAccel->markDirty();
+  this->accelRebuild = true;
+  this->geometryScaleDirty = true;
   return true;
 }
 
@@ -104,7 +121,7 @@ bool OptixVisual::DetachGeometry(GeometryPtr _geometry)
   }
 
   this->optixGroup->removeChild(derived->OptixGeometryGroup());
-  this->optixAccel->markDirty();
+  this->accelRebuild = true;
   return true;
 }
 
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/rendering/AntiAliasingPass.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/RenderPassSystem.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+class AntiAliasingPassTest : public testing::Test,
+                             public testing::WithParamInterface<const char*>
+{
+  /// \brief Test anti-aliasing pass properties
+  public: void AntiAliasing(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+void AntiAliasingPassTest::AntiAliasing(const std::string &_renderEngine)
+{
+  // Currently, only ogre2 supports anti-aliasing passes
+  if (_renderEngine.compare("ogre2") != 0)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' doesn't support anti-aliasing passes" << std::endl;
+    return;
+  }
+
+  // get engine
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  // get the render pass system
+  RenderPassSystemPtr rpSystem = engine->RenderPassSystem();
+  ASSERT_NE(nullptr, rpSystem);
+  RenderPassPtr pass = rpSystem->Create<AntiAliasingPass>();
+  AntiAliasingPassPtr aaPass =
+      std::dynamic_pointer_cast<AntiAliasingPass>(pass);
+  ASSERT_NE(nullptr, aaPass);
+
+  // verify initial values
+  EXPECT_DOUBLE_EQ(0.125, aaPass->EdgeThreshold());
+  EXPECT_DOUBLE_EQ(0.0312, aaPass->EdgeThresholdMin());
+  EXPECT_DOUBLE_EQ(0.75, aaPass->SubpixelQuality());
+
+  aaPass->SetEdgeThreshold(0.25);
+  EXPECT_DOUBLE_EQ(0.25, aaPass->EdgeThreshold());
+  aaPass->SetEdgeThresholdMin(0.05);
+  EXPECT_DOUBLE_EQ(0.05, aaPass->EdgeThresholdMin());
+  aaPass->SetSubpixelQuality(0.0);
+  EXPECT_DOUBLE_EQ(0.0, aaPass->SubpixelQuality());
+
+  // values are clamped to their valid range
+  aaPass->SetEdgeThreshold(1.0);
+  EXPECT_DOUBLE_EQ(0.333, aaPass->EdgeThreshold());
+  aaPass->SetEdgeThresholdMin(-1.0);
+  EXPECT_DOUBLE_EQ(0.0, aaPass->EdgeThresholdMin());
+  aaPass->SetSubpixelQuality(2.0);
+  EXPECT_DOUBLE_EQ(1.0, aaPass->SubpixelQuality());
+
+  // Clean up
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(AntiAliasingPassTest, AntiAliasing)
+{
+  AntiAliasing(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(AntiAliasing, AntiAliasingPassTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
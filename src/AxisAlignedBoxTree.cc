@@ -0,0 +1,670 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ignition/rendering/AxisAlignedBoxTree.hh"
+
+/// \brief Index of a missing node
+static const int kNullNode = -1;
+
+/// \brief Private data for the AxisAlignedBoxTree class
+class ignition::rendering::AxisAlignedBoxTreePrivate
+{
+  /// \brief Node of the tree. Leaves hold the boxes, internal nodes
+  /// always have two children.
+  public: struct Node
+  {
+    /// \brief Min corner of the box of the node, enlarged by the margin
+    /// for leaves and the union of the children for internal nodes
+    math::Vector3d min;
+
+    /// \brief Max corner of the box of the node
+    math::Vector3d max;
+
+    /// \brief Min corner of the exact box, leaves only
+    math::Vector3d boxMin;
+
+    /// \brief Max corner of the exact box, leaves only
+    math::Vector3d boxMax;
+
+    /// \brief Parent node, or next free node for unused nodes
+    int parent = kNullNode;
+
+    /// \brief First child, kNullNode for leaves
+    int child1 = kNullNode;
+
+    /// \brief Second child, kNullNode for leaves
+    int child2 = kNullNode;
+
+    /// \brief Height of the subtree, 0 for leaves
+    int height = 0;
+
+    /// \brief Id of the box, leaves only
+    unsigned int id = 0u;
+
+    /// \brief Check if the node is a leaf
+    /// \return True for leaves
+    bool IsLeaf() const
+    {
+      return this->child1 == kNullNode;
+    }
+  };
+
+  /// \brief Get an unused node
+  /// \return Index of the node
+  public: int Allocate();
+
+  /// \brief Return a node to the free list
+  /// \param[in] _index Index of the node
+  public: void Free(int _index);
+
+  /// \brief Insert a leaf next to the node that enlarges the tree the
+  /// least, using the surface area heuristic
+  /// \param[in] _leaf Index of the leaf
+  public: void InsertLeaf(int _leaf);
+
+  /// \brief Unlink a leaf from the tree, the leaf node is kept
+  /// \param[in] _leaf Index of the leaf
+  public: void RemoveLeaf(int _leaf);
+
+  /// \brief Update the boxes and heights of a node and its ancestors,
+  /// rebalancing them on the way up
+  /// \param[in] _index Index of the lowest node to update
+  public: void Refit(int _index);
+
+  /// \brief Rotate the taller child of a node up if the heights of its
+  /// children differ by more than one
+  /// \param[in] _index Index of the node
+  /// \return Index of the node now at the position of _index
+  public: int Balance(int _index);
+
+  /// \brief Replace a child of a node's parent, or the root
+  /// \param[in] _parent Parent, kNullNode for the root
+  /// \param[in] _oldChild Child to replace
+  /// \param[in] _newChild New child
+  public: void ReplaceChild(int _parent, int _oldChild, int _newChild);
+
+  /// \brief Set the box of an internal node to the union of its children
+  /// \param[in] _index Index of the node
+  public: void MergeChildren(int _index);
+
+  /// \brief Visit the leaves whose exact box passes a test, descending into
+  /// the nodes whose box passes it
+  /// \param[in] _test Test of a box given its min and max corners
+  /// \return Ids of the leaves that passed
+  public: template <typename Test>
+          std::vector<unsigned int> Query(const Test &_test) const;
+
+  /// \brief Nodes, including unused ones
+  public: std::vector<Node> nodes;
+
+  /// \brief Root node
+  public: int root = kNullNode;
+
+  /// \brief First unused node
+  public: int freeList = kNullNode;
+
+  /// \brief Leaf of each id
+  public: std::unordered_map<unsigned int, int> leaves;
+
+  /// \brief Distance boxes are enlarged by
+  public: double margin = 0.1;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+/// \brief Get half the surface area of a box
+/// \param[in] _min Min corner
+/// \param[in] _max Max corner
+/// \return Half the surface area
+static double HalfArea(const math::Vector3d &_min, const math::Vector3d &_max)
+{
+  math::Vector3d d = _max - _min;
+  return d.X() * d.Y() + d.Y() * d.Z() + d.Z() * d.X();
+}
+
+//////////////////////////////////////////////////
+/// \brief Get half the surface area of the union of two boxes
+/// \param[in] _minA Min corner of the first box
+/// \param[in] _maxA Max corner of the first box
+/// \param[in] _minB Min corner of the second box
+/// \param[in] _maxB Max corner of the second box
+/// \return Half the surface area of the union
+static double HalfAreaOfUnion(const math::Vector3d &_minA,
+    const math::Vector3d &_maxA, const math::Vector3d &_minB,
+    const math::Vector3d &_maxB)
+{
+  return HalfArea(
+      math::Vector3d(std::min(_minA.X(), _minB.X()),
+                     std::min(_minA.Y(), _minB.Y()),
+                     std::min(_minA.Z(), _minB.Z())),
+      math::Vector3d(std::max(_maxA.X(), _maxB.X()),
+                     std::max(_maxA.Y(), _maxB.Y()),
+                     std::max(_maxA.Z(), _maxB.Z())));
+}
+
+//////////////////////////////////////////////////
+/// \brief Check if a box contains another one
+/// \param[in] _outerMin Min corner of the outer box
+/// \param[in] _outerMax Max corner of the outer box
+/// \param[in] _innerMin Min corner of the inner box
+/// \param[in] _innerMax Max corner of the inner box
+/// \return True if the inner box is inside the outer box
+static bool ContainsBox(const math::Vector3d &_outerMin,
+    const math::Vector3d &_outerMax, const math::Vector3d &_innerMin,
+    const math::Vector3d &_innerMax)
+{
+  return _outerMin.X() <= _innerMin.X() && _outerMin.Y() <= _innerMin.Y() &&
+      _outerMin.Z() <= _innerMin.Z() && _outerMax.X() >= _innerMax.X() &&
+      _outerMax.Y() >= _innerMax.Y() && _outerMax.Z() >= _innerMax.Z();
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the squared distance from a point to a box
+/// \param[in] _point Point
+/// \param[in] _min Min corner of the box
+/// \param[in] _max Max corner of the box
+/// \return Squared distance, 0 if the point is inside the box
+static double DistanceSquared(const math::Vector3d &_point,
+    const math::Vector3d &_min, const math::Vector3d &_max)
+{
+  double dist = 0.0;
+  for (int i = 0; i < 3; ++i)
+  {
+    double d = std::max({_min[i] - _point[i], 0.0, _point[i] - _max[i]});
+    dist += d * d;
+  }
+  return dist;
+}
+
+//////////////////////////////////////////////////
+int AxisAlignedBoxTreePrivate::Allocate()
+{
+  if (this->freeList == kNullNode)
+  {
+    this->nodes.emplace_back();
+    return static_cast<int>(this->nodes.size()) - 1;
+  }
+
+  int index = this->freeList;
+  this->freeList = this->nodes[index].parent;
+  this->nodes[index] = Node();
+  return index;
+}
+
+//////////////////////////////////////////////////
+void AxisAlignedBoxTreePrivate::Free(int _index)
+{
+  this->nodes[_index].parent = this->freeList;
+  this->nodes[_index].height = -1;
+  this->freeList = _index;
+}
+
+//////////////////////////////////////////////////
+void AxisAlignedBoxTreePrivate::ReplaceChild(int _parent, int _oldChild,
+    int _newChild)
+{
+  if (_parent == kNullNode)
+  {
+    this->root = _newChild;
+    return;
+  }
+
+  Node &parent = this->nodes[_parent];
+  if (parent.child1 == _oldChild)
+    parent.child1 = _newChild;
+  else
+    parent.child2 = _newChild;
+}
+
+//////////////////////////////////////////////////
+void AxisAlignedBoxTreePrivate::MergeChildren(int _index)
+{
+  Node &node = this->nodes[_index];
+  const Node &child1 = this->nodes[node.child1];
+  const Node &child2 = this->nodes[node.child2];
+  node.min.Set(std::min(child1.min.X(), child2.min.X()),
+               std::min(child1.min.Y(), child2.min.Y()),
+               std::min(child1.min.Z(), child2.min.Z()));
+  node.max.Set(std::max(child1.max.X(), child2.max.X()),
+               std::max(child1.max.Y(), child2.max.Y()),
+               std::max(child1.max.Z(), child2.max.Z()));
+  node.height = 1 + std::max(child1.height, child2.height);
+}
+
+//////////////////////////////////////////////////
+void AxisAlignedBoxTreePrivate::InsertLeaf(int _leaf)
+{
+  if (this->root == kNullNode)
+  {
+    this->root = _leaf;
+    this->nodes[_leaf].parent = kNullNode;
+    return;
+  }
+
+  // descend to the node whose union with the leaf costs the least, where
+  // the cost of a node is the area of its box, which is proportional to
+  // the probability of a query visiting it
+  const math::Vector3d leafMin = this->nodes[_leaf].min;
+  const math::Vector3d leafMax = this->nodes[_leaf].max;
+  int index = this->root;
+  while (!this->nodes[index].IsLeaf())
+  {
+    const Node &node = this->nodes[index];
+    double area = HalfArea(node.min, node.max);
+    double combinedArea =
+        HalfAreaOfUnion(node.min, node.max, leafMin, leafMax);
+
+    // cost of making a new parent for this node and the leaf
+    double cost = 2.0 * combinedArea;
+
+    // minimum cost of pushing the leaf further down the tree
+    double inheritanceCost = 2.0 * (combinedArea - area);
+
+    auto childCost = [&](int _child)
+    {
+      const Node &child = this->nodes[_child];
+      double unionArea =
+          HalfAreaOfUnion(child.min, child.max, leafMin, leafMax);
+      if (child.IsLeaf())
+        return unionArea + inheritanceCost;
+      return unionArea - HalfArea(child.min, child.max) + inheritanceCost;
+    };
+    double cost1 = childCost(node.child1);
+    double cost2 = childCost(node.child2);
+
+    if (cost < cost1 && cost < cost2)
+      break;
+
+    index = cost1 < cost2 ? node.child1 : node.child2;
+  }
+
+  int sibling = index;
+  int oldParent = this->nodes[sibling].parent;
+  int newParent = this->Allocate();
+  this->nodes[newParent].parent = oldParent;
+  this->nodes[newParent].child1 = sibling;
+  this->nodes[newParent].child2 = _leaf;
+  this->nodes[sibling].parent = newParent;
+  this->nodes[_leaf].parent = newParent;
+  this->ReplaceChild(oldParent, sibling, newParent);
+
+  this->Refit(newParent);
+}
+
+//////////////////////////////////////////////////
+void AxisAlignedBoxTreePrivate::RemoveLeaf(int _leaf)
+{
+  if (_leaf == this->root)
+  {
+    this->root = kNullNode;
+    return;
+  }
+
+  int parent = this->nodes[_leaf].parent;
+  int grandParent = this->nodes[parent].parent;
+  int sibling = this->nodes[parent].child1 == _leaf ?
+      this->nodes[parent].child2 : this->nodes[parent].child1;
+
+  // the sibling takes the place of the parent
+  this->ReplaceChild(grandParent, parent, sibling);
+  this->nodes[sibling].parent = grandParent;
+  this->Free(parent);
+
+  if (grandParent != kNullNode)
+    this->Refit(grandParent);
+}
+
+//////////////////////////////////////////////////
+void AxisAlignedBoxTreePrivate::Refit(int _index)
+{
+  int index = _index;
+  while (index != kNullNode)
+  {
+    index = this->Balance(index);
+    this->MergeChildren(index);
+    index = this->nodes[index].parent;
+  }
+}
+
+//////////////////////////////////////////////////
+int AxisAlignedBoxTreePrivate::Balance(int _index)
+{
+  int iA = _index;
+  if (this->nodes[iA].IsLeaf() || this->nodes[iA].height < 2)
+    return iA;
+
+  int iB = this->nodes[iA].child1;
+  int iC = this->nodes[iA].child2;
+  int balance = this->nodes[iC].height - this->nodes[iB].height;
+
+  // a child is taller than the other by more than one, so it has two
+  // children itself. The taller child takes the place of A, and A takes the
+  // place of the shorter grandchild
+  auto rotate = [&](int _up, bool _upIsChild1)
+  {
+    Node &up = this->nodes[_up];
+    int iF = up.child1;
+    int iG = up.child2;
+
+    up.child1 = iA;
+    up.parent = this->nodes[iA].parent;
+    this->nodes[iA].parent = _up;
+    this->ReplaceChild(up.parent, iA, _up);
+
+    // keep the taller grandchild under the rotated node
+    int keep = iF;
+    int move = iG;
+    if (this->nodes[iF].height <= this->nodes[iG].height)
+      std::swap(keep, move);
+    this->nodes[_up].child2 = keep;
+    if (_upIsChild1)
+      this->nodes[iA].child1 = move;
+    else
+      this->nodes[iA].child2 = move;
+    this->nodes[move].parent = iA;
+
+    this->MergeChildren(iA);
+    this->MergeChildren(_up);
+  };
+
+  if (balance > 1)
+  {
+    rotate(iC, false);
+    return iC;
+  }
+
+  if (balance < -1)
+  {
+    rotate(iB, true);
+    return iB;
+  }
+
+  return iA;
+}
+
+//////////////////////////////////////////////////
+template <typename Test>
+std::vector<unsigned int> AxisAlignedBoxTreePrivate::Query(
+    const Test &_test) const
+{
+  std::vector<unsigned int> result;
+  if (this->root == kNullNode)
+    return result;
+
+  std::vector<int> stack;
+  stack.push_back(this->root);
+  while (!stack.empty())
+  {
+    const Node &node = this->nodes[stack.back()];
+    stack.pop_back();
+    if (!_test(node.min, node.max))
+      continue;
+
+    if (node.IsLeaf())
+    {
+      if (_test(node.boxMin, node.boxMax))
+        result.push_back(node.id);
+    }
+    else
+    {
+      stack.push_back(node.child1);
+      stack.push_back(node.child2);
+    }
+  }
+  return result;
+}
+
+//////////////////////////////////////////////////
+AxisAlignedBoxTree::AxisAlignedBoxTree(double _margin)
+  : dataPtr(new AxisAlignedBoxTreePrivate)
+{
+  this->dataPtr->margin = std::max(0.0, _margin);
+}
+
+//////////////////////////////////////////////////
+AxisAlignedBoxTree::~AxisAlignedBoxTree()
+{
+}
+
+//////////////////////////////////////////////////
+void AxisAlignedBoxTree::Update(unsigned int _id,
+    const math::AxisAlignedBox &_box)
+{
+  const math::Vector3d &min = _box.Min();
+  const math::Vector3d &max = _box.Max();
+  if (!min.IsFinite() || !max.IsFinite() || min.X() > max.X() ||
+      min.Y() > max.Y() || min.Z() > max.Z())
+  {
+    this->Remove(_id);
+    return;
+  }
+
+  int leaf = kNullNode;
+  auto it = this->dataPtr->leaves.find(_id);
+  if (it != this->dataPtr->leaves.end())
+  {
+    leaf = it->second;
+    AxisAlignedBoxTreePrivate::Node &node = this->dataPtr->nodes[leaf];
+    node.boxMin = min;
+    node.boxMax = max;
+
+    // the tree only changes when the box leaves its enlarged box, or
+    // shrinks so much that the enlarged box is too loose
+    double m = 4.0 * this->dataPtr->margin;
+    math::Vector3d loose(m, m, m);
+    if (ContainsBox(node.min, node.max, min, max) &&
+        !ContainsBox(node.min, node.max, min - loose, max + loose))
+    {
+      return;
+    }
+    this->dataPtr->RemoveLeaf(leaf);
+  }
+  else
+  {
+    leaf = this->dataPtr->Allocate();
+    this->dataPtr->nodes[leaf].id = _id;
+    this->dataPtr->nodes[leaf].boxMin = min;
+    this->dataPtr->nodes[leaf].boxMax = max;
+    this->dataPtr->leaves[_id] = leaf;
+  }
+
+  double m = this->dataPtr->margin;
+  math::Vector3d margin(m, m, m);
+  this->dataPtr->nodes[leaf].min = min - margin;
+  this->dataPtr->nodes[leaf].max = max + margin;
+  this->dataPtr->InsertLeaf(leaf);
+}
+
+//////////////////////////////////////////////////
+void AxisAlignedBoxTree::Remove(unsigned int _id)
+{
+  auto it = this->dataPtr->leaves.find(_id);
+  if (it == this->dataPtr->leaves.end())
+    return;
+
+  this->dataPtr->RemoveLeaf(it->second);
+  this->dataPtr->Free(it->second);
+  this->dataPtr->leaves.erase(it);
+}
+
+//////////////////////////////////////////////////
+bool AxisAlignedBoxTree::Contains(unsigned int _id) const
+{
+  return this->dataPtr->leaves.find(_id) != this->dataPtr->leaves.end();
+}
+
+//////////////////////////////////////////////////
+math::AxisAlignedBox AxisAlignedBoxTree::Box(unsigned int _id) const
+{
+  auto it = this->dataPtr->leaves.find(_id);
+  if (it == this->dataPtr->leaves.end())
+    return math::AxisAlignedBox();
+
+  const AxisAlignedBoxTreePrivate::Node &node =
+      this->dataPtr->nodes[it->second];
+  return math::AxisAlignedBox(node.boxMin, node.boxMax);
+}
+
+//////////////////////////////////////////////////
+unsigned int AxisAlignedBoxTree::Size() const
+{
+  return static_cast<unsigned int>(this->dataPtr->leaves.size());
+}
+
+//////////////////////////////////////////////////
+void AxisAlignedBoxTree::Clear()
+{
+  this->dataPtr->nodes.clear();
+  this->dataPtr->leaves.clear();
+  this->dataPtr->root = kNullNode;
+  this->dataPtr->freeList = kNullNode;
+}
+
+//////////////////////////////////////////////////
+std::vector<unsigned int> AxisAlignedBoxTree::Intersect(
+    const math::AxisAlignedBox &_box) const
+{
+  const math::Vector3d &boxMin = _box.Min();
+  const math::Vector3d &boxMax = _box.Max();
+  return this->dataPtr->Query(
+      [&](const math::Vector3d &_min, const math::Vector3d &_max)
+      {
+        return _min.X() <= boxMax.X() && _max.X() >= boxMin.X() &&
+            _min.Y() <= boxMax.Y() && _max.Y() >= boxMin.Y() &&
+            _min.Z() <= boxMax.Z() && _max.Z() >= boxMin.Z();
+      });
+}
+
+//////////////////////////////////////////////////
+std::vector<unsigned int> AxisAlignedBoxTree::Intersect(
+    const math::Vector3d &_center, double _radius) const
+{
+  if (_radius < 0.0)
+    return {};
+
+  double radiusSquared = _radius * _radius;
+  return this->dataPtr->Query(
+      [&](const math::Vector3d &_min, const math::Vector3d &_max)
+      {
+        return DistanceSquared(_center, _min, _max) <= radiusSquared;
+      });
+}
+
+//////////////////////////////////////////////////
+std::vector<unsigned int> AxisAlignedBoxTree::Intersect(
+    const math::Frustum &_frustum) const
+{
+  // same test as math::Frustum::Contains, without building a box per node
+  std::vector<math::Planed> planes;
+  for (int i = math::FRUSTUM_PLANE_NEAR; i <= math::FRUSTUM_PLANE_BOTTOM; ++i)
+    planes.push_back(_frustum.Plane(static_cast<math::FrustumPlane>(i)));
+
+  return this->dataPtr->Query(
+      [&](const math::Vector3d &_min, const math::Vector3d &_max)
+      {
+        math::Vector3d center = (_min + _max) * 0.5;
+        math::Vector3d halfSize = (_max - _min) * 0.5;
+        for (const auto &plane : planes)
+        {
+          const math::Vector3d &normal = plane.Normal();
+          double dist = normal.Dot(center) - plane.Offset();
+          double extent = std::abs(normal.X()) * halfSize.X() +
+              std::abs(normal.Y()) * halfSize.Y() +
+              std::abs(normal.Z()) * halfSize.Z();
+          if (dist < -extent)
+            return false;
+        }
+        return true;
+      });
+}
+
+//////////////////////////////////////////////////
+std::vector<unsigned int> AxisAlignedBoxTree::Nearest(
+    const math::Vector3d &_point, unsigned int _count) const
+{
+  std::vector<unsigned int> result;
+  if (this->dataPtr->root == kNullNode || _count == 0u)
+    return result;
+
+  // best first search: nodes are visited by increasing distance to their
+  // box, which is never more than the distance to the boxes below them
+  using Entry = std::pair<double, int>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+  // closest boxes found so far, the farthest on top
+  std::priority_queue<std::pair<double, unsigned int>> closest;
+
+  const auto &nodes = this->dataPtr->nodes;
+  int root = this->dataPtr->root;
+  queue.emplace(DistanceSquared(_point, nodes[root].min, nodes[root].max),
+      root);
+  while (!queue.empty())
+  {
+    Entry entry = queue.top();
+    queue.pop();
+    if (closest.size() == _count && entry.first > closest.top().first)
+      break;
+
+    const AxisAlignedBoxTreePrivate::Node &node = nodes[entry.second];
+    if (node.IsLeaf())
+    {
+      double dist = DistanceSquared(_point, node.boxMin, node.boxMax);
+      if (closest.size() < _count)
+      {
+        closest.emplace(dist, node.id);
+      }
+      else if (dist < closest.top().first)
+      {
+        closest.pop();
+        closest.emplace(dist, node.id);
+      }
+      continue;
+    }
+
+    for (int child : {node.child1, node.child2})
+    {
+      queue.emplace(
+          DistanceSquared(_point, nodes[child].min, nodes[child].max), child);
+    }
+  }
+
+  result.resize(closest.size());
+  for (auto it = result.rbegin(); it != result.rend(); ++it)
+  {
+    *it = closest.top().second;
+    closest.pop();
+  }
+  return result;
+}
+
+//////////////////////////////////////////////////
+unsigned int AxisAlignedBoxTree::Height() const
+{
+  if (this->dataPtr->root == kNullNode)
+    return 0u;
+  return static_cast<unsigned int>(
+      this->dataPtr->nodes[this->dataPtr->root].height + 1);
+}
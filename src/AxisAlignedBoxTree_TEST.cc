@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Pose3.hh>
+
+#include "ignition/rendering/AxisAlignedBoxTree.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(AxisAlignedBoxTree, UpdateRemove)
+{
+  AxisAlignedBoxTree tree;
+  EXPECT_EQ(0u, tree.Size());
+  EXPECT_EQ(0u, tree.Height());
+  EXPECT_TRUE(tree.Intersect(math::AxisAlignedBox(
+      math::Vector3d(-1, -1, -1), math::Vector3d(1, 1, 1))).empty());
+
+  math::AxisAlignedBox box(math::Vector3d(0, 0, 0), math::Vector3d(1, 1, 1));
+  tree.Update(3u, box);
+  EXPECT_EQ(1u, tree.Size());
+  EXPECT_TRUE(tree.Contains(3u));
+  EXPECT_EQ(box, tree.Box(3u));
+
+  // moving a box keeps a single entry
+  math::AxisAlignedBox moved(math::Vector3d(5, 0, 0), math::Vector3d(6, 1, 1));
+  tree.Update(3u, moved);
+  EXPECT_EQ(1u, tree.Size());
+  EXPECT_EQ(moved, tree.Box(3u));
+
+  // empty boxes can not be located
+  tree.Update(4u, math::AxisAlignedBox());
+  EXPECT_FALSE(tree.Contains(4u));
+  tree.Update(3u, math::AxisAlignedBox());
+  EXPECT_FALSE(tree.Contains(3u));
+  EXPECT_EQ(0u, tree.Size());
+
+  tree.Update(1u, box);
+  tree.Update(2u, moved);
+  tree.Remove(1u);
+  tree.Remove(7u);
+  EXPECT_EQ(1u, tree.Size());
+  EXPECT_TRUE(tree.Contains(2u));
+
+  tree.Clear();
+  EXPECT_EQ(0u, tree.Size());
+  EXPECT_FALSE(tree.Contains(2u));
+}
+
+/////////////////////////////////////////////////
+TEST(AxisAlignedBoxTree, Queries)
+{
+  AxisAlignedBoxTree tree;
+
+  // unit boxes centered on a line along x, 2m apart
+  for (unsigned int i = 0; i < 10u; ++i)
+  {
+    math::Vector3d center(i * 2.0, 0, 0);
+    tree.Update(i, math::AxisAlignedBox(center - math::Vector3d(0.5, 0.5, 0.5),
+        center + math::Vector3d(0.5, 0.5, 0.5)));
+  }
+
+  std::vector<unsigned int> ids = tree.Intersect(math::AxisAlignedBox(
+      math::Vector3d(1.0, -1.0, -1.0), math::Vector3d(4.5, 1.0, 1.0)));
+  std::sort(ids.begin(), ids.end());
+  EXPECT_EQ(std::vector<unsigned int>({1u, 2u}), ids);
+
+  // boxes touching the query are included
+  ids = tree.Intersect(math::AxisAlignedBox(
+      math::Vector3d(2.5, -1.0, -1.0), math::Vector3d(3.5, 1.0, 1.0)));
+  std::sort(ids.begin(), ids.end());
+  EXPECT_EQ(std::vector<unsigned int>({1u, 2u}), ids);
+
+  ids = tree.Intersect(math::Vector3d(10.0, 1.0, 0.0), 2.0);
+  std::sort(ids.begin(), ids.end());
+  EXPECT_EQ(std::vector<unsigned int>({4u, 5u, 6u}), ids);
+
+  ids = tree.Nearest(math::Vector3d(7.2, 3.0, 0.0), 3u);
+  EXPECT_EQ(std::vector<unsigned int>({4u, 3u, 5u}), ids);
+  EXPECT_EQ(10u, tree.Nearest(math::Vector3d::Zero, 20u).size());
+  EXPECT_TRUE(tree.Nearest(math::Vector3d::Zero, 0u).empty());
+
+  // 90 degree frustum at the origin looking along +x, 5m to 9m deep
+  math::Frustum frustum(5.0, 9.0, math::Angle(IGN_PI * 0.5), 1.0,
+      math::Pose3d::Zero);
+  ids = tree.Intersect(frustum);
+  std::sort(ids.begin(), ids.end());
+  EXPECT_EQ(std::vector<unsigned int>({3u, 4u}), ids);
+
+  // turned around, nothing is in view
+  frustum.SetPose(math::Pose3d(0, 0, 0, 0, 0, IGN_PI));
+  EXPECT_TRUE(tree.Intersect(frustum).empty());
+}
+
+/////////////////////////////////////////////////
+TEST(AxisAlignedBoxTree, MatchesBruteForce)
+{
+  std::mt19937 gen(42u);
+  std::uniform_real_distribution<double> pos(-50.0, 50.0);
+  std::uniform_real_distribution<double> size(0.1, 3.0);
+  auto randomBox = [&]()
+  {
+    math::Vector3d min(pos(gen), pos(gen), pos(gen));
+    return math::AxisAlignedBox(min,
+        min + math::Vector3d(size(gen), size(gen), size(gen)));
+  };
+
+  const unsigned int count = 1000u;
+  AxisAlignedBoxTree tree;
+  std::vector<math::AxisAlignedBox> boxes(count);
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    boxes[i] = randomBox();
+    tree.Update(i, boxes[i]);
+  }
+
+  // move and remove boxes the way a changing scene does
+  std::vector<bool> present(count, true);
+  std::uniform_int_distribution<unsigned int> pick(0u, count - 1u);
+  std::uniform_real_distribution<double> step(-0.5, 0.5);
+  for (unsigned int n = 0; n < 5000u; ++n)
+  {
+    unsigned int i = pick(gen);
+    if (n % 10u == 0u)
+    {
+      present[i] = !present[i];
+      if (present[i])
+        tree.Update(i, boxes[i]);
+      else
+        tree.Remove(i);
+      continue;
+    }
+    if (!present[i])
+      continue;
+    math::Vector3d offset(step(gen), step(gen), step(gen));
+    if (n % 7u == 0u)
+      offset *= 40.0;
+    boxes[i] = math::AxisAlignedBox(boxes[i].Min() + offset,
+        boxes[i].Max() + offset);
+    tree.Update(i, boxes[i]);
+  }
+
+  unsigned int presentCount = static_cast<unsigned int>(
+      std::count(present.begin(), present.end(), true));
+  EXPECT_EQ(presentCount, tree.Size());
+
+  // the tree stays balanced
+  EXPECT_LE(tree.Height(), 4u * static_cast<unsigned int>(
+      std::ceil(std::log2(presentCount))));
+
+  for (unsigned int q = 0; q < 20u; ++q)
+  {
+    math::AxisAlignedBox query = randomBox();
+    query.Max() += math::Vector3d(10, 10, 10);
+    std::vector<unsigned int> expected;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      if (present[i] && boxes[i].Intersects(query))
+        expected.push_back(i);
+    }
+    std::vector<unsigned int> ids = tree.Intersect(query);
+    std::sort(ids.begin(), ids.end());
+    EXPECT_EQ(expected, ids);
+
+    // distance to the nearest box
+    math::Vector3d point(pos(gen), pos(gen), pos(gen));
+    auto distance = [&](unsigned int _i)
+    {
+      math::Vector3d closest = point;
+      closest.Max(boxes[_i].Min());
+      closest.Min(boxes[_i].Max());
+      return closest.Distance(point);
+    };
+    std::vector<unsigned int> nearest = tree.Nearest(point, 5u);
+    ASSERT_EQ(5u, nearest.size());
+    std::vector<double> distances;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      if (present[i])
+        distances.push_back(distance(i));
+    }
+    std::sort(distances.begin(), distances.end());
+    for (unsigned int k = 0; k < 5u; ++k)
+      EXPECT_NEAR(distances[k], distance(nearest[k]), 1e-9);
+  }
+}
@@ -87,6 +87,32 @@ void AxisVisualTest::AxisVisual(const std::string &_renderEngine)
     EXPECT_EQ(1u, child->GeometryCount());
   }
 
+  // each axis visual has its own copies of the default materials
+  AxisVisualPtr other = scene->CreateAxisVisual();
+  ASSERT_NE(nullptr, other);
+  for (unsigned int i = 0; i < 3u; ++i)
+  {
+    VisualPtr arrow = std::dynamic_pointer_cast<Visual>(
+        visual->ChildByIndex(i));
+    VisualPtr otherArrow = std::dynamic_pointer_cast<Visual>(
+        other->ChildByIndex(i));
+    ASSERT_NE(nullptr, arrow);
+    ASSERT_NE(nullptr, otherArrow);
+    EXPECT_NE(nullptr, arrow->Material());
+    EXPECT_NE(arrow->Material(), otherArrow->Material());
+  }
+  EXPECT_NE(scene->Material("Default/TransRed"),
+      std::dynamic_pointer_cast<Visual>(visual->ChildByIndex(0u))->Material());
+
+  // the copies are destroyed with the visual
+  MaterialPtr otherMaterial = std::dynamic_pointer_cast<Visual>(
+      other->ChildByIndex(0u))->Material();
+  ASSERT_NE(nullptr, otherMaterial);
+  std::string otherMaterialName = otherMaterial->Name();
+  EXPECT_TRUE(scene->MaterialRegistered(otherMaterialName));
+  scene->DestroyVisual(other);
+  EXPECT_FALSE(scene->MaterialRegistered(otherMaterialName));
+
   // Clean up
   engine->DestroyScene(scene);
   rendering::unloadEngine(engine->Name());
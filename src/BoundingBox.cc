@@ -24,6 +24,20 @@ using namespace rendering;
 //////////////////////////////////////////////////
 class ignition::rendering::BoundingBoxPrivate
 {
+  /// \brief Center of the box
+  public: math::Vector3d center;
+
+  /// \brief Size of the box
+  public: math::Vector3d size;
+
+  /// \brief Orientation of the box
+  public: math::Quaterniond orientation;
+
+  /// \brief Label of the object in the box
+  public: uint32_t label = 0u;
+
+  /// \brief Fraction of the object that is visible
+  public: double visibleRatio = 1.0;
 };
 
 //////////////////////////////////////////////////
@@ -63,3 +77,62 @@ BoundingBox &BoundingBox::operator=(BoundingBox &&_texture)
   return *this;
 }
 
+//////////////////////////////////////////////////
+void BoundingBox::SetCenter(const math::Vector3d &_center)
+{
+  this->dataPtr->center = _center;
+}
+
+//////////////////////////////////////////////////
+const math::Vector3d &BoundingBox::Center() const
+{
+  return this->dataPtr->center;
+}
+
+//////////////////////////////////////////////////
+void BoundingBox::SetSize(const math::Vector3d &_size)
+{
+  this->dataPtr->size = _size;
+}
+
+//////////////////////////////////////////////////
+const math::Vector3d &BoundingBox::Size() const
+{
+  return this->dataPtr->size;
+}
+
+//////////////////////////////////////////////////
+void BoundingBox::SetOrientation(const math::Quaterniond &_orientation)
+{
+  this->dataPtr->orientation = _orientation;
+}
+
+//////////////////////////////////////////////////
+const math::Quaterniond &BoundingBox::Orientation() const
+{
+  return this->dataPtr->orientation;
+}
+
+//////////////////////////////////////////////////
+void BoundingBox::SetLabel(uint32_t _label)
+{
+  this->dataPtr->label = _label;
+}
+
+//////////////////////////////////////////////////
+uint32_t BoundingBox::Label() const
+{
+  return this->dataPtr->label;
+}
+
+//////////////////////////////////////////////////
+void BoundingBox::SetVisibleRatio(double _ratio)
+{
+  this->dataPtr->visibleRatio = _ratio;
+}
+
+//////////////////////////////////////////////////
+double BoundingBox::VisibleRatio() const
+{
+  return this->dataPtr->visibleRatio;
+}
@@ -31,6 +31,38 @@ class BoundingBoxTest : public testing::Test
 TEST(BoundingBoxTest, BoundingBox)
 {
   BoundingBox box;
+  EXPECT_EQ(math::Vector3d::Zero, box.Center());
+  EXPECT_EQ(math::Vector3d::Zero, box.Size());
+  EXPECT_EQ(math::Quaterniond::Identity, box.Orientation());
+  EXPECT_EQ(0u, box.Label());
+  EXPECT_DOUBLE_EQ(1.0, box.VisibleRatio());
+
+  box.SetCenter(math::Vector3d(1, 2, 3));
+  box.SetSize(math::Vector3d(4, 5, 6));
+  box.SetOrientation(math::Quaterniond(0.1, 0.2, 0.3));
+  box.SetLabel(7u);
+  box.SetVisibleRatio(0.5);
+  EXPECT_EQ(math::Vector3d(1, 2, 3), box.Center());
+  EXPECT_EQ(math::Vector3d(4, 5, 6), box.Size());
+  EXPECT_EQ(math::Quaterniond(0.1, 0.2, 0.3), box.Orientation());
+  EXPECT_EQ(7u, box.Label());
+  EXPECT_DOUBLE_EQ(0.5, box.VisibleRatio());
+
+  // copy
+  BoundingBox copy(box);
+  EXPECT_EQ(box.Center(), copy.Center());
+  EXPECT_EQ(box.Size(), copy.Size());
+  EXPECT_EQ(box.Label(), copy.Label());
+
+  // assignment
+  BoundingBox assigned;
+  assigned = box;
+  EXPECT_EQ(box.Orientation(), assigned.Orientation());
+  EXPECT_DOUBLE_EQ(box.VisibleRatio(), assigned.VisibleRatio());
+
+  // move
+  BoundingBox moved(std::move(copy));
+  EXPECT_EQ(7u, moved.Label());
 }
 
 /////////////////////////////////////////////////
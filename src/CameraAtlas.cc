@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Profiler.hh>
+#include <ignition/math/Helpers.hh>
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/CameraAtlas.hh"
+#include "ignition/rendering/PixelFormat.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Private data for the CameraAtlas class
+class ignition::rendering::CameraAtlasPrivate
+{
+  /// \brief Configure the atlas camera for the current cameras
+  public: void UpdateLayout();
+
+  /// \brief Get the number of columns of tiles for the current cameras
+  /// \return Number of columns, about as many as there are rows
+  public: unsigned int Columns() const;
+
+  /// \brief Get the byte offset of a tile in the atlas image
+  /// \param[in] _index Index of the tile
+  /// \return Offset of the first pixel of the tile
+  public: unsigned int TileOffset(unsigned int _index) const;
+
+  /// \brief Scene the cameras belong to
+  public: Scene *scene = nullptr;
+
+  /// \brief Cameras in the order of their tiles
+  public: std::vector<CameraPtr> cameras;
+
+  /// \brief Camera rendering all tiles as its views
+  public: CameraPtr atlasCamera;
+
+  /// \brief Image the tiles are rendered to
+  public: Image image;
+
+  /// \brief True if cameras were added or removed since the last Update
+  public: bool layoutDirty = true;
+
+  /// \brief Poses of the views, kept to reuse their memory
+  public: std::vector<math::Pose3d> poses;
+
+  /// \brief Event emitted for the tile of each camera
+  public: common::EventT<void(const CameraPtr &, const unsigned char *,
+      unsigned int, unsigned int, unsigned int)> newTileEvent;
+};
+
+//////////////////////////////////////////////////
+void CameraAtlasPrivate::UpdateLayout()
+{
+  const CameraPtr &first = this->cameras.front();
+  const unsigned int count = static_cast<unsigned int>(this->cameras.size());
+  const unsigned int columns = this->Columns();
+  const unsigned int rows = (count + columns - 1u) / columns;
+
+  // the tiles keep the aspect ratio and vertical field of view of the
+  // cameras, whatever the shape of the grid
+  CameraPtr atlas = this->atlasCamera;
+  atlas->SetImageWidth(first->ImageWidth() * columns);
+  atlas->SetImageHeight(first->ImageHeight() * rows);
+  atlas->SetImageFormat(PF_R8G8B8);
+  atlas->SetAspectRatio(static_cast<double>(first->ImageWidth()) /
+      static_cast<double>(first->ImageHeight()));
+  atlas->SetHFOV(first->HFOV());
+  atlas->SetNearClipPlane(first->NearClipPlane());
+  atlas->SetFarClipPlane(first->FarClipPlane());
+  atlas->SetViewColumns(columns);
+  this->image = atlas->CreateImage();
+  this->layoutDirty = false;
+}
+
+//////////////////////////////////////////////////
+unsigned int CameraAtlasPrivate::Columns() const
+{
+  return static_cast<unsigned int>(
+      std::ceil(std::sqrt(static_cast<double>(this->cameras.size()))));
+}
+
+//////////////////////////////////////////////////
+unsigned int CameraAtlasPrivate::TileOffset(unsigned int _index) const
+{
+  const unsigned int columns = this->Columns();
+  const unsigned int width = this->cameras.front()->ImageWidth();
+  const unsigned int height = this->cameras.front()->ImageHeight();
+  const unsigned int depth = PixelUtil::BytesPerPixel(PF_R8G8B8);
+  return ((_index / columns) * height * width * columns +
+      (_index % columns) * width) * depth;
+}
+
+//////////////////////////////////////////////////
+CameraAtlas::CameraAtlas(Scene *_scene)
+  : dataPtr(new CameraAtlasPrivate)
+{
+  this->dataPtr->scene = _scene;
+}
+
+//////////////////////////////////////////////////
+CameraAtlas::~CameraAtlas()
+{
+  auto &atlasCamera = this->dataPtr->atlasCamera;
+  if (atlasCamera && this->dataPtr->scene->HasSensor(atlasCamera))
+    this->dataPtr->scene->DestroySensor(atlasCamera);
+}
+
+//////////////////////////////////////////////////
+bool CameraAtlas::AddCamera(const CameraPtr &_camera)
+{
+  if (!_camera || !this->dataPtr->scene->HasSensor(_camera))
+  {
+    ignerr << "Unable to add a camera that is not in scene: "
+           << this->dataPtr->scene->Name() << std::endl;
+    return false;
+  }
+
+  if (this->HasCamera(_camera))
+  {
+    ignerr << "Camera: " << _camera->Name() << " is already in the atlas"
+           << std::endl;
+    return false;
+  }
+
+  if (!this->dataPtr->cameras.empty())
+  {
+    const CameraPtr &first = this->dataPtr->cameras.front();
+    if (_camera->ImageWidth() != first->ImageWidth() ||
+        _camera->ImageHeight() != first->ImageHeight() ||
+        !math::equal(_camera->HFOV().Radian(), first->HFOV().Radian()) ||
+        !math::equal(_camera->NearClipPlane(), first->NearClipPlane()) ||
+        !math::equal(_camera->FarClipPlane(), first->FarClipPlane()))
+    {
+      ignerr << "Unable to add camera: " << _camera->Name()
+             << ". Its image size, field of view and clip distances must "
+             << "match the ones of camera: " << first->Name() << std::endl;
+      return false;
+    }
+  }
+
+  if (!this->dataPtr->atlasCamera)
+  {
+    this->dataPtr->atlasCamera = this->dataPtr->scene->CreateCamera();
+    if (!this->dataPtr->atlasCamera)
+      return false;
+    // the views are placed at the world poses of the cameras
+    this->dataPtr->scene->RootVisual()->AddChild(
+        this->dataPtr->atlasCamera);
+  }
+
+  this->dataPtr->cameras.push_back(_camera);
+  this->dataPtr->layoutDirty = true;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool CameraAtlas::RemoveCamera(const CameraPtr &_camera)
+{
+  auto &cameras = this->dataPtr->cameras;
+  auto it = std::find(cameras.begin(), cameras.end(), _camera);
+  if (it == cameras.end())
+    return false;
+
+  cameras.erase(it);
+  this->dataPtr->layoutDirty = true;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool CameraAtlas::HasCamera(const CameraPtr &_camera) const
+{
+  const auto &cameras = this->dataPtr->cameras;
+  return std::find(cameras.begin(), cameras.end(), _camera) != cameras.end();
+}
+
+//////////////////////////////////////////////////
+unsigned int CameraAtlas::CameraCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->cameras.size());
+}
+
+//////////////////////////////////////////////////
+unsigned int CameraAtlas::TileOffset(const CameraPtr &_camera) const
+{
+  const auto &cameras = this->dataPtr->cameras;
+  auto it = std::find(cameras.begin(), cameras.end(), _camera);
+  if (it == cameras.end())
+    return 0u;
+
+  return this->dataPtr->TileOffset(
+      static_cast<unsigned int>(it - cameras.begin()));
+}
+
+//////////////////////////////////////////////////
+bool CameraAtlas::Update()
+{
+  IGN_PROFILE("CameraAtlas::Update");
+
+  // forget the cameras destroyed in the scene
+  auto &cameras = this->dataPtr->cameras;
+  Scene *scene = this->dataPtr->scene;
+  auto removed = std::remove_if(cameras.begin(), cameras.end(),
+      [scene](const CameraPtr &_camera) {return !scene->HasSensor(_camera);});
+  if (removed != cameras.end())
+  {
+    cameras.erase(removed, cameras.end());
+    this->dataPtr->layoutDirty = true;
+  }
+
+  if (cameras.empty())
+    return false;
+
+  if (this->dataPtr->layoutDirty)
+    this->dataPtr->UpdateLayout();
+
+  // the atlas camera is at the origin, so the views are the world poses
+  auto &poses = this->dataPtr->poses;
+  poses.clear();
+  for (const auto &camera : cameras)
+    poses.push_back(camera->WorldPose());
+
+  CameraPtr atlas = this->dataPtr->atlasCamera;
+  atlas->SetWorldPose(math::Pose3d::Zero);
+  atlas->SetViewPoses(poses);
+  if (atlas->ViewPoses().size() != poses.size())
+  {
+    ignerr << "Unable to render a camera atlas, multiple views are not "
+           << "supported by the render engine" << std::endl;
+    return false;
+  }
+
+  atlas->Capture(this->dataPtr->image);
+
+  const unsigned char *data = this->dataPtr->image.Data<unsigned char>();
+  const unsigned int width = cameras.front()->ImageWidth();
+  const unsigned int height = cameras.front()->ImageHeight();
+  const unsigned int stride = atlas->ImageWidth() *
+      PixelUtil::BytesPerPixel(PF_R8G8B8);
+  for (unsigned int i = 0u; i < cameras.size(); ++i)
+  {
+    this->dataPtr->newTileEvent(cameras[i],
+        data + this->dataPtr->TileOffset(i), width, height, stride);
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+const Image &CameraAtlas::AtlasImage() const
+{
+  return this->dataPtr->image;
+}
+
+//////////////////////////////////////////////////
+CameraPtr CameraAtlas::AtlasCamera() const
+{
+  return this->dataPtr->atlasCamera;
+}
+
+//////////////////////////////////////////////////
+common::ConnectionPtr CameraAtlas::ConnectNewTile(NewTileListener _listener)
+{
+  return this->dataPtr->newTileEvent.Connect(_listener);
+}
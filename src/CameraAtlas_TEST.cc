@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/CameraAtlas.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+class CameraAtlasTest : public testing::Test,
+                        public testing::WithParamInterface<const char*>
+{
+  /// \brief Test rendering cameras into the tiles of an atlas
+  public: void Tiles(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+void CameraAtlasTest::Tiles(const std::string &_renderEngine)
+{
+  if (_renderEngine != "ogre2")
+  {
+    igndbg << "Camera atlases are not supported yet in rendering engine: "
+           << _renderEngine << std::endl;
+    return;
+  }
+
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetBackgroundColor(1.0, 0.0, 0.0);
+
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(3.0, 0.0, 0.0);
+  scene->RootVisual()->AddChild(box);
+
+  // the first camera looks at the box, the second one away from it
+  CameraPtr cameraA = scene->CreateCamera();
+  CameraPtr cameraB = scene->CreateCamera();
+  CameraPtr cameraC = scene->CreateCamera();
+  for (auto camera : {cameraA, cameraB, cameraC})
+  {
+    ASSERT_NE(nullptr, camera);
+    camera->SetImageWidth(16);
+    camera->SetImageHeight(16);
+    scene->RootVisual()->AddChild(camera);
+  }
+  cameraB->SetLocalRotation(0.0, 0.0, IGN_PI);
+  cameraC->SetImageWidth(32);
+
+  auto atlasPtr = std::make_unique<CameraAtlas>(scene.get());
+  CameraAtlas &atlas = *atlasPtr;
+  EXPECT_EQ(nullptr, atlas.AtlasCamera());
+  EXPECT_FALSE(atlas.Update());
+
+  EXPECT_TRUE(atlas.AddCamera(cameraA));
+  EXPECT_TRUE(atlas.AddCamera(cameraB));
+  EXPECT_FALSE(atlas.AddCamera(cameraA));
+  EXPECT_FALSE(atlas.AddCamera(nullptr));
+  // the image size must match the one of the first camera
+  EXPECT_FALSE(atlas.AddCamera(cameraC));
+  EXPECT_EQ(2u, atlas.CameraCount());
+  EXPECT_TRUE(atlas.HasCamera(cameraB));
+  EXPECT_FALSE(atlas.HasCamera(cameraC));
+  EXPECT_NE(nullptr, atlas.AtlasCamera());
+
+  // two tiles side by side
+  EXPECT_EQ(0u, atlas.TileOffset(cameraA));
+  EXPECT_EQ(16u * 3u, atlas.TileOffset(cameraB));
+
+  std::map<CameraPtr, bool> tileRed;
+  auto connection = atlas.ConnectNewTile(
+      [&](const CameraPtr &_camera, const unsigned char *_data,
+          unsigned int _width, unsigned int _height, unsigned int _stride)
+      {
+        EXPECT_EQ(16u, _width);
+        EXPECT_EQ(16u, _height);
+        EXPECT_EQ(32u * 3u, _stride);
+        const unsigned char *center = _data + 8u * _stride + 8u * 3u;
+        tileRed[_camera] = center[0] == 255u && center[1] == 0u &&
+            center[2] == 0u;
+      });
+
+  EXPECT_TRUE(atlas.Update());
+  EXPECT_EQ(32u, atlas.AtlasImage().Width());
+  EXPECT_EQ(16u, atlas.AtlasImage().Height());
+  ASSERT_EQ(2u, tileRed.size());
+  EXPECT_FALSE(tileRed[cameraA]);
+  EXPECT_TRUE(tileRed[cameraB]);
+
+  // the tiles follow the cameras
+  cameraA->SetLocalRotation(0.0, 0.0, IGN_PI);
+  EXPECT_TRUE(atlas.Update());
+  EXPECT_TRUE(tileRed[cameraA]);
+
+  // removing a camera moves the following tiles up
+  EXPECT_TRUE(atlas.RemoveCamera(cameraA));
+  EXPECT_FALSE(atlas.RemoveCamera(cameraA));
+  EXPECT_EQ(0u, atlas.TileOffset(cameraB));
+
+  // cameras destroyed in the scene are removed
+  scene->DestroySensor(cameraB);
+  tileRed.clear();
+  EXPECT_FALSE(atlas.Update());
+  EXPECT_EQ(0u, atlas.CameraCount());
+  EXPECT_TRUE(tileRed.empty());
+
+  // the atlas camera is destroyed with the atlas
+  CameraPtr atlasCamera = atlas.AtlasCamera();
+  connection.reset();
+  atlasPtr.reset();
+  EXPECT_FALSE(scene->HasSensor(atlasCamera));
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraAtlasTest, Tiles)
+{
+  Tiles(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(CameraAtlas, CameraAtlasTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cmath>
+
+#include <ignition/math/Helpers.hh>
+
+#include "ignition/rendering/CameraLens.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+class ignition::rendering::CameraLensPrivate
+{
+  /// \brief Linear scaling constant
+  public: double c1{1.0};
+
+  /// \brief Angle scaling constant
+  public: double c2{1.0};
+
+  /// \brief Angle shift constant
+  public: double c3{0.0};
+
+  /// \brief Focal length
+  public: double f{1.0};
+
+  /// \brief Angle function
+  public: AngleFunctionType fun{AFT_IDENTITY};
+
+  /// \brief Cut off angle
+  public: double cutOffAngle{IGN_PI};
+
+  /// \brief True to scale the focal length to the field of view
+  public: bool scaleToHFOV{true};
+};
+
+/// \brief Coefficients of a predefined mapping function
+struct MappingFunction
+{
+  /// \brief Mapping function type
+  MappingFunctionType type;
+
+  /// \brief Linear scaling constant
+  double c1;
+
+  /// \brief Angle scaling constant
+  double c2;
+
+  /// \brief Angle function
+  AngleFunctionType fun;
+};
+
+/// \brief Predefined mapping functions, with f = 1 and c3 = 0
+static const MappingFunction kMappingFunctions[] =
+{
+  {MFT_GNOMONICAL, 1.0, 1.0, AFT_TAN},
+  {MFT_STEREOGRAPHIC, 2.0, 2.0, AFT_TAN},
+  {MFT_EQUIDISTANT, 1.0, 1.0, AFT_IDENTITY},
+  {MFT_EQUISOLID_ANGLE, 2.0, 2.0, AFT_SIN},
+  {MFT_ORTHOGRAPHIC, 1.0, 1.0, AFT_SIN},
+};
+
+/// \brief Evaluate an angle function
+/// \param[in] _fun Angle function
+/// \param[in] _x Angle in radians
+/// \return Function value
+static double Evaluate(AngleFunctionType _fun, double _x)
+{
+  switch (_fun)
+  {
+    case AFT_SIN:
+      return std::sin(_x);
+    case AFT_TAN:
+      return std::tan(_x);
+    case AFT_IDENTITY:
+    default:
+      return _x;
+  }
+}
+
+//////////////////////////////////////////////////
+CameraLens::CameraLens() :
+    dataPtr(std::make_unique<CameraLensPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+CameraLens::CameraLens(const CameraLens &_lens)
+  : dataPtr(new CameraLensPrivate(*_lens.dataPtr))
+{
+}
+
+//////////////////////////////////////////////////
+CameraLens::~CameraLens()
+{
+}
+
+//////////////////////////////////////////////////
+CameraLens &CameraLens::operator=(const CameraLens &_lens)
+{
+  *this->dataPtr = *_lens.dataPtr;
+  return *this;
+}
+
+//////////////////////////////////////////////////
+void CameraLens::SetType(MappingFunctionType _type)
+{
+  for (const auto &mapping : kMappingFunctions)
+  {
+    if (mapping.type == _type)
+    {
+      this->SetCustomMappingFunction(mapping.c1, mapping.c2, mapping.fun,
+          1.0, 0.0);
+      return;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+MappingFunctionType CameraLens::Type() const
+{
+  for (const auto &mapping : kMappingFunctions)
+  {
+    if (math::equal(mapping.c1, this->dataPtr->c1) &&
+        math::equal(mapping.c2, this->dataPtr->c2) &&
+        mapping.fun == this->dataPtr->fun &&
+        math::equal(1.0, this->dataPtr->f) &&
+        math::equal(0.0, this->dataPtr->c3))
+    {
+      return mapping.type;
+    }
+  }
+  return MFT_CUSTOM;
+}
+
+//////////////////////////////////////////////////
+void CameraLens::SetCustomMappingFunction(double _c1, double _c2,
+    AngleFunctionType _fun, double _f, double _c3)
+{
+  this->dataPtr->c1 = _c1;
+  this->dataPtr->c2 = _c2;
+  this->dataPtr->fun = _fun;
+  this->dataPtr->f = _f;
+  this->dataPtr->c3 = _c3;
+}
+
+//////////////////////////////////////////////////
+double CameraLens::C1() const
+{
+  return this->dataPtr->c1;
+}
+
+//////////////////////////////////////////////////
+double CameraLens::C2() const
+{
+  return this->dataPtr->c2;
+}
+
+//////////////////////////////////////////////////
+double CameraLens::C3() const
+{
+  return this->dataPtr->c3;
+}
+
+//////////////////////////////////////////////////
+double CameraLens::F() const
+{
+  return this->dataPtr->f;
+}
+
+//////////////////////////////////////////////////
+AngleFunctionType CameraLens::AngleFunction() const
+{
+  return this->dataPtr->fun;
+}
+
+//////////////////////////////////////////////////
+double CameraLens::CutOffAngle() const
+{
+  return this->dataPtr->cutOffAngle;
+}
+
+//////////////////////////////////////////////////
+void CameraLens::SetCutOffAngle(double _angle)
+{
+  this->dataPtr->cutOffAngle = _angle;
+}
+
+//////////////////////////////////////////////////
+bool CameraLens::ScaleToHFOV() const
+{
+  return this->dataPtr->scaleToHFOV;
+}
+
+//////////////////////////////////////////////////
+void CameraLens::SetScaleToHFOV(bool _scale)
+{
+  this->dataPtr->scaleToHFOV = _scale;
+}
+
+//////////////////////////////////////////////////
+double CameraLens::EffectiveF(double _hfov) const
+{
+  if (!this->dataPtr->scaleToHFOV)
+    return this->dataPtr->f;
+
+  // half of the fov maps to the image border, i.e. r = 1
+  double r = this->dataPtr->c1 * Evaluate(this->dataPtr->fun,
+      _hfov * 0.5 / this->dataPtr->c2 + this->dataPtr->c3);
+  if (math::equal(r, 0.0))
+    return this->dataPtr->f;
+  return 1.0 / r;
+}
+
+//////////////////////////////////////////////////
+bool CameraLens::Angle(double _r, double _f, double &_theta) const
+{
+  double scale = this->dataPtr->c1 * _f;
+  if (math::equal(scale, 0.0))
+    return false;
+
+  double x = _r / scale;
+  double param = 0.0;
+  switch (this->dataPtr->fun)
+  {
+    case AFT_SIN:
+      if (x > 1.0 || x < -1.0)
+        return false;
+      param = std::asin(x);
+      break;
+    case AFT_TAN:
+      param = std::atan(x);
+      break;
+    case AFT_IDENTITY:
+    default:
+      param = x;
+      break;
+  }
+  _theta = this->dataPtr->c2 * (param - this->dataPtr->c3);
+  return true;
+}
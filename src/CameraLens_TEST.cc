@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <ignition/math/Helpers.hh>
+
+#include "ignition/rendering/CameraLens.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(CameraLens, Type)
+{
+  CameraLens lens;
+  EXPECT_EQ(MFT_EQUIDISTANT, lens.Type());
+  EXPECT_DOUBLE_EQ(1.0, lens.C1());
+  EXPECT_DOUBLE_EQ(1.0, lens.C2());
+  EXPECT_DOUBLE_EQ(0.0, lens.C3());
+  EXPECT_DOUBLE_EQ(1.0, lens.F());
+  EXPECT_EQ(AFT_IDENTITY, lens.AngleFunction());
+
+  lens.SetType(MFT_STEREOGRAPHIC);
+  EXPECT_EQ(MFT_STEREOGRAPHIC, lens.Type());
+  EXPECT_DOUBLE_EQ(2.0, lens.C1());
+  EXPECT_DOUBLE_EQ(2.0, lens.C2());
+  EXPECT_EQ(AFT_TAN, lens.AngleFunction());
+
+  lens.SetCustomMappingFunction(1.5, 2.0, AFT_SIN, 1.0, 0.0);
+  EXPECT_EQ(MFT_CUSTOM, lens.Type());
+  EXPECT_DOUBLE_EQ(1.5, lens.C1());
+
+  // a custom function matching a predefined one is reported as such
+  lens.SetCustomMappingFunction(1.0, 1.0, AFT_TAN, 1.0, 0.0);
+  EXPECT_EQ(MFT_GNOMONICAL, lens.Type());
+
+  // copies are independent
+  CameraLens copy(lens);
+  lens.SetType(MFT_ORTHOGRAPHIC);
+  EXPECT_EQ(MFT_GNOMONICAL, copy.Type());
+  copy = lens;
+  EXPECT_EQ(MFT_ORTHOGRAPHIC, copy.Type());
+}
+
+/////////////////////////////////////////////////
+TEST(CameraLens, Angle)
+{
+  CameraLens lens;
+  lens.SetType(MFT_EQUIDISTANT);
+  EXPECT_TRUE(lens.ScaleToHFOV());
+
+  // half of the fov maps to the image border
+  double f = lens.EffectiveF(IGN_PI);
+  double theta = 0.0;
+  EXPECT_TRUE(lens.Angle(1.0, f, theta));
+  EXPECT_NEAR(IGN_PI * 0.5, theta, 1e-9);
+  EXPECT_TRUE(lens.Angle(0.5, f, theta));
+  EXPECT_NEAR(IGN_PI * 0.25, theta, 1e-9);
+
+  lens.SetType(MFT_GNOMONICAL);
+  f = lens.EffectiveF(IGN_PI * 0.5);
+  EXPECT_TRUE(lens.Angle(1.0, f, theta));
+  EXPECT_NEAR(IGN_PI * 0.25, theta, 1e-9);
+
+  // orthographic lenses do not map rays beyond 90 degrees
+  lens.SetType(MFT_ORTHOGRAPHIC);
+  lens.SetScaleToHFOV(false);
+  EXPECT_DOUBLE_EQ(1.0, lens.EffectiveF(IGN_PI));
+  EXPECT_TRUE(lens.Angle(1.0, 1.0, theta));
+  EXPECT_NEAR(IGN_PI * 0.5, theta, 1e-9);
+  EXPECT_FALSE(lens.Angle(1.5, 1.0, theta));
+
+  lens.SetCutOffAngle(1.0);
+  EXPECT_DOUBLE_EQ(1.0, lens.CutOffAngle());
+}
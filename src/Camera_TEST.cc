@@ -17,15 +17,28 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
 
 #include "test_config.h"  // NOLINT(build/include)
 #include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/DepthCamera.hh"
+#include "ignition/rendering/FrameRecorder.hh"
 #include "ignition/rendering/GaussianNoisePass.hh"
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/ImagePool.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderingIface.hh"
 #include "ignition/rendering/RenderPassSystem.hh"
 #include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
 
 using namespace ignition;
 using namespace rendering;
@@ -47,6 +60,33 @@ class CameraTest : public testing::Test,
 
   /// \brief Test setting visibility mask
   public: void VisibilityMask(const std::string &_renderEngine);
+
+  /// \brief Test rendering only when the scene changed
+  public: void RenderOnDemand(const std::string &_renderEngine);
+
+  /// \brief Test rendering several views side by side
+  public: void ViewPoses(const std::string &_renderEngine);
+
+  /// \brief Test creating images from a pool
+  public: void ImagePool(const std::string &_renderEngine);
+
+  /// \brief Test saving frames to files
+  public: void SaveFrame(const std::string &_renderEngine);
+
+  /// \brief Test timestamps of captured frames
+  public: void FrameTimings(const std::string &_renderEngine);
+
+  /// \brief Test disabling shadows
+  public: void ShadowsEnabled(const std::string &_renderEngine);
+
+  /// \brief Test rendering at a lower resolution
+  public: void ResolutionScale(const std::string &_renderEngine);
+
+  /// \brief Test reprojecting frames instead of rendering them
+  public: void Reprojection(const std::string &_renderEngine);
+
+  /// \brief Test releasing the GPU resources of idle sensors
+  public: void IdleTimeout(const std::string &_renderEngine);
 };
 
 /////////////////////////////////////////////////
@@ -89,6 +129,18 @@ void CameraTest::ViewProjectionMatrix(const std::string &_renderEngine)
   camera->SetFarClipPlane(800);
   EXPECT_DOUBLE_EQ(800, camera->FarClipPlane());
 
+  EXPECT_DOUBLE_EQ(1.0, camera->LodBias());
+  camera->SetLodBias(0.25);
+  EXPECT_DOUBLE_EQ(0.25, camera->LodBias());
+  camera->SetLodBias(0.0);
+  EXPECT_DOUBLE_EQ(0.25, camera->LodBias());
+
+  EXPECT_DOUBLE_EQ(0.0, camera->TextureMipBias());
+  camera->SetTextureMipBias(2.0);
+  EXPECT_DOUBLE_EQ(2.0, camera->TextureMipBias());
+  camera->SetTextureMipBias(-1.0);
+  EXPECT_DOUBLE_EQ(0.0, camera->TextureMipBias());
+
   EXPECT_NE(projMatrix, camera->ProjectionMatrix());
 
   // view matrix
@@ -190,6 +242,11 @@ void CameraTest::RenderTexture(const std::string &_renderEngine)
   // PreRender - creates the render texture
   camera->PreRender();
   EXPECT_NE(0u, camera->RenderTextureGLId());
+
+  // there is no Metal texture, the id is left unchanged
+  void *metalId = nullptr;
+  camera->RenderTextureMetalId(&metalId);
+  EXPECT_EQ(nullptr, metalId);
 #endif
 
   // Clean up
@@ -356,6 +413,599 @@ void CameraTest::VisibilityMask(const std::string &_renderEngine)
   rendering::unloadEngine(engine->Name());
 }
 
+/////////////////////////////////////////////////
+void CameraTest::RenderOnDemand(const std::string &_renderEngine)
+{
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetBackgroundColor(1.0, 0.0, 0.0);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(16);
+  camera->SetImageHeight(16);
+  camera->SetImageFormat(PF_R8G8B8);
+  scene->RootVisual()->AddChild(camera);
+
+  // off by default
+  EXPECT_FALSE(camera->RenderOnDemand());
+  camera->SetRenderOnDemand(true);
+  EXPECT_TRUE(camera->RenderOnDemand());
+
+  Image image = camera->CreateImage();
+  unsigned int center = (8u * 16u + 8u) * 3u;
+
+  // the first frame is always rendered
+  camera->Capture(image);
+  unsigned char *data = image.Data<unsigned char>();
+  EXPECT_EQ(255u, data[center]);
+  EXPECT_EQ(0u, data[center + 1]);
+
+  // background color changes are not detected, the previous frame is kept
+  scene->SetBackgroundColor(0.0, 1.0, 0.0);
+  camera->Capture(image);
+  EXPECT_EQ(255u, data[center]);
+  EXPECT_EQ(0u, data[center + 1]);
+
+  // until the camera is marked dirty
+  camera->SetRenderDirty();
+  camera->Capture(image);
+  EXPECT_EQ(0u, data[center]);
+  EXPECT_EQ(255u, data[center + 1]);
+
+  // adding a visual in front of the camera renders a new frame
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(2.0, 0.0, 0.0);
+  scene->RootVisual()->AddChild(box);
+  camera->Capture(image);
+  EXPECT_FALSE(data[center] == 0u && data[center + 1] == 255u &&
+      data[center + 2] == 0u);
+
+  // moving it out of view does too
+  box->SetLocalPosition(-2.0, 0.0, 0.0);
+  camera->Capture(image);
+  EXPECT_EQ(0u, data[center]);
+  EXPECT_EQ(255u, data[center + 1]);
+
+  camera->SetRenderOnDemand(false);
+  EXPECT_FALSE(camera->RenderOnDemand());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void CameraTest::ViewPoses(const std::string &_renderEngine)
+{
+  if (_renderEngine != "ogre2")
+  {
+    igndbg << "Multiple views are not supported yet in rendering engine: "
+           << _renderEngine << std::endl;
+    return;
+  }
+
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetBackgroundColor(1.0, 0.0, 0.0);
+
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(3.0, 0.0, 0.0);
+  scene->RootVisual()->AddChild(box);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(32);
+  camera->SetImageHeight(16);
+  camera->SetImageFormat(PF_R8G8B8);
+  scene->RootVisual()->AddChild(camera);
+  EXPECT_TRUE(camera->ViewPoses().empty());
+
+  // the left view looks at the box, the right view looks away from it
+  std::vector<math::Pose3d> poses = {
+      math::Pose3d::Zero, math::Pose3d(0, 0, 0, 0, 0, IGN_PI)};
+  camera->SetViewPoses(poses);
+  EXPECT_EQ(poses, camera->ViewPoses());
+
+  Image image = camera->CreateImage();
+  camera->Capture(image);
+  unsigned char *data = image.Data<unsigned char>();
+  unsigned int left = (8u * 32u + 8u) * 3u;
+  unsigned int right = (8u * 32u + 24u) * 3u;
+  EXPECT_FALSE(data[left] == 255u && data[left + 1] == 0u &&
+      data[left + 2] == 0u);
+  EXPECT_EQ(255u, data[right]);
+  EXPECT_EQ(0u, data[right + 1]);
+  EXPECT_EQ(0u, data[right + 2]);
+
+  // back to a single view, the box is in the center
+  camera->SetViewPoses({});
+  EXPECT_TRUE(camera->ViewPoses().empty());
+  camera->Capture(image);
+  unsigned int center = (8u * 32u + 16u) * 3u;
+  EXPECT_FALSE(data[center] == 255u && data[center + 1] == 0u &&
+      data[center + 2] == 0u);
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void CameraTest::ImagePool(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(32);
+  camera->SetImageHeight(16);
+  camera->SetImageFormat(PF_R8G8B8);
+  scene->RootVisual()->AddChild(camera);
+  EXPECT_EQ(nullptr, camera->ImagePool());
+
+  auto pool = std::make_shared<rendering::ImagePool>();
+  camera->SetImagePool(pool);
+  EXPECT_EQ(pool, camera->ImagePool());
+
+  // capturing in a loop reuses the same buffer
+  const void *data = nullptr;
+  for (unsigned int i = 0u; i < 3u; ++i)
+  {
+    Image image = camera->CreateImage();
+    EXPECT_EQ(32u, image.Width());
+    EXPECT_EQ(16u, image.Height());
+    camera->Capture(image);
+    if (data)
+    {
+      EXPECT_EQ(data, image.Data());
+    }
+    data = image.Data();
+  }
+  EXPECT_EQ(1u, pool->AllocationCount());
+
+  camera->SetImagePool(nullptr);
+  EXPECT_EQ(nullptr, camera->ImagePool());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void CameraTest::SaveFrame(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(32);
+  camera->SetImageHeight(16);
+  camera->SetImageFormat(PF_R8G8B8);
+  scene->RootVisual()->AddChild(camera);
+  EXPECT_EQ(nullptr, camera->FrameRecorder());
+
+  auto recorder = std::make_shared<rendering::FrameRecorder>(1u, 2u);
+  recorder->SetBlockWhenFull(true);
+  camera->SetFrameRecorder(recorder);
+  EXPECT_EQ(recorder, camera->FrameRecorder());
+
+  // formats that can not hold the image are rejected right away
+  camera->Update();
+  EXPECT_FALSE(camera->SaveFrame("frame.exr"));
+  EXPECT_FALSE(camera->SaveFrame("frame.unknown"));
+
+  std::string name = common::joinPaths(PROJECT_BUILD_PATH,
+      "camera_frame.raw");
+  for (unsigned int i = 0u; i < 3u; ++i)
+  {
+    camera->Update();
+    EXPECT_TRUE(camera->SaveFrame(name));
+  }
+  camera->WaitForAsyncCopies();
+  recorder->Flush();
+  EXPECT_EQ(3u, recorder->WrittenCount());
+  EXPECT_EQ(0u, recorder->DroppedCount());
+  EXPECT_TRUE(common::exists(name));
+  common::removeFile(name);
+
+  camera->SetFrameRecorder(nullptr);
+  EXPECT_EQ(nullptr, camera->FrameRecorder());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void CameraTest::FrameTimings(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(32);
+  camera->SetImageHeight(16);
+  scene->RootVisual()->AddChild(camera);
+  EXPECT_EQ(0u, camera->FrameTimings().frameId);
+  EXPECT_EQ(0u, camera->FrameTimings().frameCount);
+
+  Image image = camera->CreateImage();
+  for (unsigned int i = 1u; i <= 3u; ++i)
+  {
+    camera->Capture(image);
+    rendering::FrameTimings timings = camera->FrameTimings();
+    EXPECT_EQ(i, timings.frameId);
+    EXPECT_EQ(i, timings.frameCount);
+    EXPECT_LE(timings.submitTime, timings.gpuCompleteTime);
+    EXPECT_LE(timings.gpuCompleteTime, timings.readbackCompleteTime);
+    EXPECT_LE(timings.readbackCompleteTime, timings.callbackCompleteTime);
+    EXPECT_GE(timings.LatencyMs(), 0.0);
+    EXPECT_GE(timings.maxLatencyMs, timings.LatencyMs());
+    EXPECT_GE(timings.maxLatencyMs, timings.averageLatencyMs);
+  }
+
+  // capturing a sensor that records its own frames counts each frame once
+  DepthCameraPtr depthCamera = scene->CreateDepthCamera();
+  if (depthCamera)
+  {
+    depthCamera->SetImageWidth(32);
+    depthCamera->SetImageHeight(16);
+    depthCamera->SetNearClipPlane(0.1);
+    depthCamera->SetFarClipPlane(10.0);
+    scene->RootVisual()->AddChild(depthCamera);
+    depthCamera->CreateDepthTexture();
+    unsigned int depthFrames = 0u;
+    common::ConnectionPtr connection = depthCamera->ConnectNewDepthFrame(
+        [&depthFrames](const float *, unsigned int, unsigned int,
+        unsigned int, const std::string &)
+        {
+          ++depthFrames;
+        });
+
+    Image depthImage = depthCamera->CreateImage();
+    for (unsigned int i = 1u; i <= 3u; ++i)
+    {
+      depthCamera->Capture(depthImage);
+      EXPECT_EQ(i, depthFrames);
+      EXPECT_EQ(i, depthCamera->FrameTimings().frameId);
+      EXPECT_EQ(i, depthCamera->FrameTimings().frameCount);
+    }
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void CameraTest::ShadowsEnabled(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(32u);
+  camera->SetImageHeight(32u);
+
+  EXPECT_TRUE(camera->ShadowsEnabled());
+  camera->Update();
+
+  // the camera keeps rendering without shadows
+  camera->SetShadowsEnabled(false);
+  EXPECT_FALSE(camera->ShadowsEnabled());
+  EXPECT_NO_THROW(camera->Update());
+
+  camera->SetShadowsEnabled(true);
+  EXPECT_TRUE(camera->ShadowsEnabled());
+  EXPECT_NO_THROW(camera->Update());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void CameraTest::ResolutionScale(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(32u);
+  camera->SetImageHeight(32u);
+
+  // cameras render at full resolution by default
+  EXPECT_DOUBLE_EQ(1.0, camera->ResolutionScale());
+  EXPECT_DOUBLE_EQ(1.0, camera->MinResolutionScale());
+  camera->SetResolutionScale(0.5);
+  EXPECT_DOUBLE_EQ(1.0, camera->ResolutionScale());
+
+  // invalid bounds are ignored
+  camera->SetMinResolutionScale(0.0);
+  EXPECT_DOUBLE_EQ(1.0, camera->MinResolutionScale());
+  camera->SetMinResolutionScale(1.5);
+  EXPECT_DOUBLE_EQ(1.0, camera->MinResolutionScale());
+
+  camera->SetMinResolutionScale(0.25);
+  EXPECT_DOUBLE_EQ(0.25, camera->MinResolutionScale());
+
+  EXPECT_DOUBLE_EQ(0.0, scene->FrameBudget());
+  scene->SetFrameBudget(5.0);
+  EXPECT_DOUBLE_EQ(5.0, scene->FrameBudget());
+
+  if (_renderEngine == "ogre2")
+  {
+    camera->SetResolutionScale(0.1);
+    EXPECT_DOUBLE_EQ(0.25, camera->ResolutionScale());
+    camera->SetResolutionScale(0.5);
+    EXPECT_DOUBLE_EQ(0.5, camera->ResolutionScale());
+
+    // images keep their size
+    Image image = camera->CreateImage();
+    camera->Capture(image);
+    EXPECT_EQ(32u, image.Width());
+    EXPECT_EQ(32u, image.Height());
+
+    // disabling the budget restores full resolution
+    scene->SetFrameBudget(0.0);
+    EXPECT_DOUBLE_EQ(1.0, camera->ResolutionScale());
+    EXPECT_NO_THROW(camera->Update());
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void CameraTest::Reprojection(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(32u);
+  camera->SetImageHeight(32u);
+  scene->RootVisual()->AddChild(camera);
+
+  // every frame is rendered by default
+  EXPECT_EQ(1u, camera->ReprojectionInterval());
+
+  if (_renderEngine == "ogre2")
+  {
+    camera->SetReprojectionInterval(0u);
+    EXPECT_EQ(1u, camera->ReprojectionInterval());
+    camera->SetReprojectionInterval(3u);
+    EXPECT_EQ(3u, camera->ReprojectionInterval());
+
+    // one frame out of three is rendered, the other two are reprojected
+    // while the camera moves
+    Image image = camera->CreateImage();
+    std::vector<bool> reprojected;
+    for (unsigned int i = 0u; i < 6u; ++i)
+    {
+      camera->SetLocalPosition(0.01 * i, 0.0, 0.0);
+      camera->Capture(image);
+      reprojected.push_back(camera->FrameTimings().reprojected);
+    }
+    EXPECT_EQ(std::vector<bool>({false, true, true, false, true, true}),
+        reprojected);
+
+    // a custom projection can't be reprojected
+    camera->SetProjectionMatrix(camera->ProjectionMatrix());
+    for (unsigned int i = 0u; i < 3u; ++i)
+    {
+      camera->Capture(image);
+      EXPECT_FALSE(camera->FrameTimings().reprojected);
+    }
+    camera->SetProjectionType(CPT_PERSPECTIVE);
+
+    camera->SetReprojectionInterval(1u);
+    camera->Capture(image);
+    EXPECT_FALSE(camera->FrameTimings().reprojected);
+
+    // the depth of a reprojected frame is that of the points of the key
+    // frame seen from the new pose: a box in front of a wall, 1 m closer
+    VisualPtr wall = scene->CreateVisual();
+    ASSERT_NE(nullptr, wall);
+    wall->AddGeometry(scene->CreateBox());
+    wall->SetLocalPosition(5.5, 0.0, 0.0);
+    wall->SetLocalScale(1.0, 20.0, 20.0);
+    scene->RootVisual()->AddChild(wall);
+
+    VisualPtr box = scene->CreateVisual();
+    ASSERT_NE(nullptr, box);
+    box->AddGeometry(scene->CreateBox());
+    box->SetLocalPosition(3.0, 0.0, 0.0);
+    scene->RootVisual()->AddChild(box);
+
+    const unsigned int size = 32u;
+    DepthCameraPtr depthCamera = scene->CreateDepthCamera();
+    ASSERT_NE(nullptr, depthCamera);
+    depthCamera->SetImageWidth(size);
+    depthCamera->SetImageHeight(size);
+    depthCamera->SetAspectRatio(1.0);
+    depthCamera->SetHFOV(IGN_PI * 0.5);
+    depthCamera->SetNearClipPlane(0.1);
+    depthCamera->SetFarClipPlane(20.0);
+    depthCamera->SetReprojectionInterval(2u);
+    scene->RootVisual()->AddChild(depthCamera);
+
+    std::vector<float> depth;
+    common::ConnectionPtr connection = depthCamera->ConnectNewDepthFrame(
+        [&depth](const float *_depth, unsigned int _width,
+        unsigned int _height, unsigned int, const std::string &)
+        {
+          depth.assign(_depth, _depth + _width * _height);
+        });
+
+    // key frame
+    depthCamera->SetLocalPosition(0.0, 0.0, 0.0);
+    scene->PreRender();
+    depthCamera->Update();
+    EXPECT_FALSE(depthCamera->FrameTimings().reprojected);
+    ASSERT_EQ(size * size, depth.size());
+    const unsigned int center = size / 2u * size + size / 2u;
+    EXPECT_NEAR(2.5, depth[center], 0.01);
+    EXPECT_NEAR(5.0, depth[0], 0.01);
+
+    // reprojected after moving towards the box and to the side
+    depthCamera->SetLocalPosition(1.0, 0.25, 0.0);
+    scene->PreRender();
+    depthCamera->Update();
+    EXPECT_TRUE(depthCamera->FrameTimings().reprojected);
+    ASSERT_EQ(size * size, depth.size());
+    std::vector<float> reprojectedDepth = depth;
+    EXPECT_NEAR(1.5, reprojectedDepth[center], 0.01);
+    EXPECT_NEAR(4.0, reprojectedDepth[0], 0.01);
+
+    // and rendered from the same pose. Only the pixels around the edges of
+    // the box, which the key frame did not see, may differ
+    depthCamera->SetReprojectionInterval(1u);
+    scene->PreRender();
+    depthCamera->Update();
+    EXPECT_FALSE(depthCamera->FrameTimings().reprojected);
+    ASSERT_EQ(size * size, depth.size());
+    unsigned int matching = 0u;
+    for (unsigned int i = 0u; i < depth.size(); ++i)
+    {
+      if (std::abs(depth[i] - reprojectedDepth[i]) < 0.01f)
+        ++matching;
+    }
+    EXPECT_GT(matching, depth.size() * 9u / 10u);
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void CameraTest::IdleTimeout(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+
+  // resources are kept by default
+  EXPECT_DOUBLE_EQ(0.0, camera->IdleTimeout());
+  camera->SetIdleTimeout(-1.0);
+  EXPECT_DOUBLE_EQ(0.0, camera->IdleTimeout());
+  camera->SetIdleTimeout(2.5);
+  EXPECT_DOUBLE_EQ(2.5, camera->IdleTimeout());
+
+  if (_renderEngine == "ogre2")
+  {
+    DepthCameraPtr depthCamera = scene->CreateDepthCamera();
+    ASSERT_NE(nullptr, depthCamera);
+    depthCamera->SetImageWidth(16u);
+    depthCamera->SetImageHeight(16u);
+    depthCamera->SetNearClipPlane(0.1);
+    depthCamera->SetFarClipPlane(10.0);
+    scene->RootVisual()->AddChild(depthCamera);
+
+    unsigned int frameCount = 0u;
+    common::ConnectionPtr connection = depthCamera->ConnectNewDepthFrame(
+        [&frameCount](const float *, unsigned int, unsigned int,
+        unsigned int, const std::string &)
+        {
+          ++frameCount;
+        });
+
+    // the resources are allocated on the first update
+    depthCamera->SetIdleTimeout(0.01);
+    scene->PreRender();
+    depthCamera->Update();
+    EXPECT_EQ(1u, frameCount);
+
+    // and released once idle, then allocated again
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    scene->PreRender();
+    depthCamera->Update();
+    EXPECT_EQ(2u, frameCount);
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
 /////////////////////////////////////////////////
 TEST_P(CameraTest, ViewProjectionMatrix)
 {
@@ -386,6 +1036,60 @@ TEST_P(CameraTest, VisibilityMask)
   VisibilityMask(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(CameraTest, RenderOnDemand)
+{
+  RenderOnDemand(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraTest, ViewPoses)
+{
+  ViewPoses(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraTest, ImagePool)
+{
+  ImagePool(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraTest, SaveFrame)
+{
+  SaveFrame(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraTest, FrameTimings)
+{
+  FrameTimings(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraTest, ShadowsEnabled)
+{
+  ShadowsEnabled(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraTest, ResolutionScale)
+{
+  ResolutionScale(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraTest, Reprojection)
+{
+  Reprojection(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraTest, IdleTimeout)
+{
+  IdleTimeout(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(Camera, CameraTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
@@ -24,8 +24,11 @@
 #include "test_config.h"  // NOLINT(build/include)
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Camera.hh"
 #include "ignition/rendering/Capsule.hh"
+#include "ignition/rendering/Image.hh"
 #include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
 
 using namespace ignition;
 using namespace rendering;
@@ -34,6 +37,9 @@ class CapsuleTest : public testing::Test,
                  public testing::WithParamInterface<const char *>
 {
   public: void Capsule(const std::string &_renderEngine);
+
+  /// \brief Test rendering capsules that share their mesh
+  public: void SharedMesh(const std::string &_renderEngine);
 };
 
 /////////////////////////////////////////////////
@@ -109,12 +115,113 @@ void CapsuleTest::Capsule(const std::string &_renderEngine)
   rendering::unloadEngine(engine->Name());
 }
 
+/////////////////////////////////////////////////
+void CapsuleTest::SharedMesh(const std::string &_renderEngine)
+{
+  if (_renderEngine != "ogre2")
+  {
+    igndbg << "Shared capsule meshes not supported in rendering engine: "
+            << _renderEngine << std::endl;
+    return;
+  }
+
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+           << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetBackgroundColor(0.0, 1.0, 0.0);
+  VisualPtr root = scene->RootVisual();
+
+  const unsigned int width = 64u;
+  const unsigned int height = 64u;
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(width);
+  camera->SetImageHeight(height);
+  camera->SetImageFormat(PF_R8G8B8);
+  root->AddChild(camera);
+
+  // two capsules of the same size, left and right of the image center
+  auto createCapsule = [&](double _y, double _radius, double _length)
+  {
+    VisualPtr visual = scene->CreateVisual();
+    CapsulePtr capsule = scene->CreateCapsule();
+    capsule->SetRadius(_radius);
+    capsule->SetLength(_length);
+    visual->AddGeometry(capsule);
+    visual->SetLocalPosition(3.0, _y, 0.0);
+    root->AddChild(visual);
+    return visual;
+  };
+  VisualPtr left = createCapsule(0.8, 0.3, 0.6);
+  VisualPtr right = createCapsule(-0.8, 0.3, 0.6);
+
+  // number of pixels that are not background in a range of columns
+  Image image = camera->CreateImage();
+  auto countPixels = [&](unsigned int _begin, unsigned int _end)
+  {
+    const unsigned char *data = image.Data<unsigned char>();
+    unsigned int count = 0u;
+    for (unsigned int y = 0u; y < height; ++y)
+    {
+      for (unsigned int x = _begin; x < _end; ++x)
+      {
+        const unsigned char *pixel = data + (y * width + x) * 3u;
+        if (pixel[0] != 0u || pixel[1] != 255u || pixel[2] != 0u)
+          ++count;
+      }
+    }
+    return count;
+  };
+
+  camera->Capture(image);
+  unsigned int leftCount = countPixels(0u, width / 2u);
+  unsigned int rightCount = countPixels(width / 2u, width);
+  EXPECT_GT(leftCount, 0u);
+  EXPECT_NEAR(leftCount, rightCount, 4u);
+
+  // resizing one capsule gives it its own mesh, the other one is unchanged
+  CapsulePtr rightCapsule =
+      std::dynamic_pointer_cast<rendering::Capsule>(right->GeometryByIndex(0));
+  ASSERT_NE(nullptr, rightCapsule);
+  rightCapsule->SetRadius(0.4);
+  camera->Capture(image);
+  EXPECT_EQ(leftCount, countPixels(0u, width / 2u));
+  EXPECT_GT(countPixels(width / 2u, width), rightCount);
+
+  // destroying the last user of a mesh releases it, a new capsule of the
+  // same size creates it again
+  scene->DestroyVisual(left);
+  camera->Capture(image);
+  EXPECT_EQ(0u, countPixels(0u, width / 2u));
+
+  left = createCapsule(0.8, 0.3, 0.6);
+  camera->Capture(image);
+  EXPECT_EQ(leftCount, countPixels(0u, width / 2u));
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
 /////////////////////////////////////////////////
 TEST_P(CapsuleTest, Capsule)
 {
   Capsule(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(CapsuleTest, SharedMesh)
+{
+  SharedMesh(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(Capsule, CapsuleTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
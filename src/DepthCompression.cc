@@ -0,0 +1,364 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "ignition/rendering/DepthCompression.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+constexpr uint8_t DepthCompression::kVersion;
+constexpr unsigned int DepthCompression::kBandRows;
+
+namespace
+{
+/// \brief Size of the version, width and height at the start of the data
+const size_t kHeaderSize = 9u;
+
+/// \brief Largest number of pixels of an image that is decompressed, to
+/// reject malformed data before allocating memory
+const uint64_t kMaxPixelCount = 1ull << 30u;
+
+/// \brief Writes nibbles, low nibble of each byte first
+class NibbleWriter
+{
+  /// \brief Constructor
+  /// \param[in] _data Memory large enough for all nibbles written
+  public: explicit NibbleWriter(uint8_t *_data)
+    : data(_data)
+  {
+  }
+
+  /// \brief Write a nibble
+  /// \param[in] _nibble Nibble in the low 4 bits
+  public: void Write(uint8_t _nibble)
+  {
+    if (this->half)
+      this->data[this->size - 1u] |= static_cast<uint8_t>(_nibble << 4u);
+    else
+      this->data[this->size++] = _nibble;
+    this->half = !this->half;
+  }
+
+  /// \brief Write a value in groups of 3 bits, least significant first.
+  /// The fourth bit of a nibble is set if more groups follow.
+  /// \param[in] _value Value to write
+  public: void WriteVle(uint32_t _value)
+  {
+    do
+    {
+      uint8_t nibble = static_cast<uint8_t>(_value & 0x7u);
+      _value >>= 3u;
+      if (_value)
+        nibble |= 0x8u;
+      this->Write(nibble);
+    } while (_value);
+  }
+
+  /// \brief Data written to
+  public: uint8_t *data;
+
+  /// \brief Number of bytes written
+  public: size_t size = 0u;
+
+  /// \brief True if the last byte only holds its low nibble
+  public: bool half = false;
+};
+
+/// \brief Reads nibbles written by NibbleWriter
+class NibbleReader
+{
+  /// \brief Constructor
+  /// \param[in] _data Data to read
+  /// \param[in] _size Size of the data in bytes
+  public: NibbleReader(const uint8_t *_data, size_t _size)
+    : data(_data), nibbleCount(_size * 2u)
+  {
+  }
+
+  /// \brief Read a value written by NibbleWriter::WriteVle
+  /// \param[out] _value Value read
+  /// \return False if the data ends first or the value is too large
+  public: bool ReadVle(uint32_t &_value)
+  {
+    _value = 0u;
+    unsigned int shift = 0u;
+    uint8_t nibble = 0u;
+    do
+    {
+      if (this->position >= this->nibbleCount || shift > 30u)
+        return false;
+      uint8_t byte = this->data[this->position / 2u];
+      nibble = (this->position % 2u) ? (byte >> 4u) : (byte & 0xFu);
+      ++this->position;
+
+      _value |= static_cast<uint32_t>(nibble & 0x7u) << shift;
+      shift += 3u;
+    } while (nibble & 0x8u);
+    return true;
+  }
+
+  /// \brief Data read
+  private: const uint8_t *data;
+
+  /// \brief Number of nibbles in the data
+  private: size_t nibbleCount;
+
+  /// \brief Index of the next nibble
+  private: size_t position = 0u;
+};
+
+//////////////////////////////////////////////////
+void WriteUint32(uint8_t *_data, uint32_t _value)
+{
+  for (unsigned int i = 0u; i < 4u; ++i)
+    _data[i] = static_cast<uint8_t>(_value >> (8u * i));
+}
+
+//////////////////////////////////////////////////
+uint32_t ReadUint32(const uint8_t *_data)
+{
+  uint32_t value = 0u;
+  for (unsigned int i = 0u; i < 4u; ++i)
+    value |= static_cast<uint32_t>(_data[i]) << (8u * i);
+  return value;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the number of bands of an image
+/// \param[in] _height Image height
+/// \return Number of bands
+unsigned int BandCount(unsigned int _height)
+{
+  return (_height + DepthCompression::kBandRows - 1u) /
+      DepthCompression::kBandRows;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the largest compressed size of a band
+/// \param[in] _pixelCount Number of pixels of the band
+/// \return Size in bytes
+size_t MaxBandSize(size_t _pixelCount)
+{
+  // a valid pixel takes up to 8 nibbles: a delta of up to 6 nibbles and,
+  // when it starts a run, one nibble for each run length. The run lengths
+  // of longer runs take fewer nibbles than the runs have pixels
+  return _pixelCount * 4u + 16u;
+}
+
+//////////////////////////////////////////////////
+/// \brief Compress the pixels of a band
+/// \param[in] _pixels Contiguous pixels of the band
+/// \param[in] _count Number of pixels
+/// \param[out] _data Compressed band, at least MaxBandSize bytes
+/// \return Size of the compressed band in bytes
+size_t CompressBand(const uint16_t *_pixels, size_t _count, uint8_t *_data)
+{
+  NibbleWriter writer(_data);
+  uint16_t previous = 0u;
+  size_t i = 0u;
+  while (i < _count)
+  {
+    size_t zeros = i;
+    while (i < _count && _pixels[i] == 0u)
+      ++i;
+    zeros = i - zeros;
+
+    size_t begin = i;
+    while (i < _count && _pixels[i] != 0u)
+      ++i;
+
+    writer.WriteVle(static_cast<uint32_t>(zeros));
+    writer.WriteVle(static_cast<uint32_t>(i - begin));
+    for (size_t j = begin; j < i; ++j)
+    {
+      // zigzag encoding keeps small negative deltas small
+      int32_t delta = static_cast<int32_t>(_pixels[j]) -
+          static_cast<int32_t>(previous);
+      writer.WriteVle((static_cast<uint32_t>(delta) << 1u) ^
+          static_cast<uint32_t>(delta >> 31));
+      previous = _pixels[j];
+    }
+  }
+  return writer.size;
+}
+
+//////////////////////////////////////////////////
+/// \brief Decompress the pixels of a band
+/// \param[in] _data Compressed band
+/// \param[in] _size Size of the compressed band in bytes
+/// \param[out] _pixels Contiguous pixels of the band
+/// \param[in] _count Number of pixels
+/// \return False if the data is malformed
+bool DecompressBand(const uint8_t *_data, size_t _size, uint16_t *_pixels,
+    size_t _count)
+{
+  NibbleReader reader(_data, _size);
+  uint16_t previous = 0u;
+  size_t i = 0u;
+  while (i < _count)
+  {
+    uint32_t zeros = 0u;
+    uint32_t nonZeros = 0u;
+    if (!reader.ReadVle(zeros) || !reader.ReadVle(nonZeros) ||
+        (zeros == 0u && nonZeros == 0u) || zeros > _count - i)
+    {
+      return false;
+    }
+    std::fill(_pixels + i, _pixels + i + zeros, 0u);
+    i += zeros;
+
+    if (nonZeros > _count - i)
+      return false;
+    for (uint32_t j = 0u; j < nonZeros; ++j)
+    {
+      uint32_t value = 0u;
+      if (!reader.ReadVle(value))
+        return false;
+      int32_t delta = static_cast<int32_t>(value >> 1u) ^
+          -static_cast<int32_t>(value & 1u);
+      previous = static_cast<uint16_t>(previous + delta);
+      _pixels[i++] = previous;
+    }
+  }
+  return true;
+}
+}
+
+//////////////////////////////////////////////////
+void DepthCompression::Compress(const uint16_t *_data, unsigned int _width,
+    unsigned int _height, unsigned int _rowPitch,
+    std::vector<uint8_t> &_compressed, const ParallelFor &_parallelFor)
+{
+  unsigned int bandCount = _width > 0u ? BandCount(_height) : 0u;
+  size_t tableSize = kHeaderSize + bandCount * 4u;
+  size_t maxBandSize = MaxBandSize(
+      static_cast<size_t>(_width) * kBandRows);
+
+  // bands are compressed to fixed slots and packed afterwards
+  _compressed.resize(tableSize + bandCount * maxBandSize);
+  uint8_t *compressed = _compressed.data();
+  compressed[0] = kVersion;
+  WriteUint32(compressed + 1u, _width);
+  WriteUint32(compressed + 5u, _height);
+
+  const uint8_t *rows = reinterpret_cast<const uint8_t *>(_data);
+  bool contiguous = _rowPitch == _width * sizeof(uint16_t);
+  auto compressBands = [&](unsigned int _begin, unsigned int _end)
+  {
+    std::vector<uint16_t> packed;
+    for (unsigned int band = _begin; band < _end; ++band)
+    {
+      unsigned int firstRow = band * kBandRows;
+      unsigned int rowCount = std::min(kBandRows, _height - firstRow);
+      size_t count = static_cast<size_t>(_width) * rowCount;
+
+      const uint16_t *pixels = reinterpret_cast<const uint16_t *>(
+          rows + static_cast<size_t>(firstRow) * _rowPitch);
+      if (!contiguous)
+      {
+        packed.resize(count);
+        for (unsigned int y = 0u; y < rowCount; ++y)
+        {
+          std::memcpy(packed.data() + static_cast<size_t>(y) * _width,
+              rows + static_cast<size_t>(firstRow + y) * _rowPitch,
+              _width * sizeof(uint16_t));
+        }
+        pixels = packed.data();
+      }
+
+      size_t size = CompressBand(pixels, count,
+          compressed + tableSize + band * maxBandSize);
+      WriteUint32(compressed + kHeaderSize + band * 4u,
+          static_cast<uint32_t>(size));
+    }
+  };
+  if (_parallelFor && bandCount > 1u)
+    _parallelFor(bandCount, compressBands);
+  else
+    compressBands(0u, bandCount);
+
+  size_t offset = tableSize;
+  for (unsigned int band = 0u; band < bandCount; ++band)
+  {
+    size_t size = ReadUint32(compressed + kHeaderSize + band * 4u);
+    size_t slot = tableSize + band * maxBandSize;
+    if (offset != slot)
+      std::memmove(compressed + offset, compressed + slot, size);
+    offset += size;
+  }
+  _compressed.resize(offset);
+}
+
+//////////////////////////////////////////////////
+bool DepthCompression::Decompress(const uint8_t *_data, size_t _size,
+    std::vector<uint16_t> &_depth, unsigned int &_width,
+    unsigned int &_height, const ParallelFor &_parallelFor)
+{
+  if (!_data || _size < kHeaderSize || _data[0] != kVersion)
+    return false;
+
+  unsigned int width = ReadUint32(_data + 1u);
+  unsigned int height = ReadUint32(_data + 5u);
+  if (static_cast<uint64_t>(width) * height > kMaxPixelCount)
+    return false;
+
+  unsigned int bandCount = width > 0u ? BandCount(height) : 0u;
+  size_t tableSize = kHeaderSize + bandCount * 4u;
+  if (_size < tableSize)
+    return false;
+
+  // the bands start where the previous one ends
+  std::vector<size_t> offsets(bandCount + 1u);
+  offsets[0] = tableSize;
+  for (unsigned int band = 0u; band < bandCount; ++band)
+  {
+    offsets[band + 1u] = offsets[band] +
+        ReadUint32(_data + kHeaderSize + band * 4u);
+    if (offsets[band + 1u] > _size)
+      return false;
+  }
+
+  _depth.resize(static_cast<size_t>(width) * height);
+  std::vector<uint8_t> valid(bandCount, 0u);
+  auto decompressBands = [&](unsigned int _begin, unsigned int _end)
+  {
+    for (unsigned int band = _begin; band < _end; ++band)
+    {
+      unsigned int firstRow = band * kBandRows;
+      unsigned int rowCount = std::min(kBandRows, height - firstRow);
+      valid[band] = DecompressBand(_data + offsets[band],
+          offsets[band + 1u] - offsets[band],
+          _depth.data() + static_cast<size_t>(firstRow) * width,
+          static_cast<size_t>(width) * rowCount);
+    }
+  };
+  if (_parallelFor && bandCount > 1u)
+    _parallelFor(bandCount, decompressBands);
+  else
+    decompressBands(0u, bandCount);
+
+  if (std::find(valid.begin(), valid.end(), 0u) != valid.end())
+    return false;
+
+  _width = width;
+  _height = height;
+  return true;
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <vector>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/DepthCompression.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(DepthCompressionTest, RoundTrip)
+{
+  // a slanted plane with a hole of invalid depth, on padded rows
+  const unsigned int width = 50u;
+  const unsigned int height = 70u;
+  const unsigned int stride = width + 3u;
+  std::vector<uint16_t> depth(stride * height, 0xFFFFu);
+  for (unsigned int y = 0u; y < height; ++y)
+  {
+    for (unsigned int x = 0u; x < width; ++x)
+    {
+      bool hole = x > 10u && x < 20u && y > 30u && y < 40u;
+      depth[y * stride + x] = hole ? 0u : static_cast<uint16_t>(
+          2000u + 3u * x - 2u * y);
+    }
+  }
+
+  std::vector<uint8_t> compressed;
+  DepthCompression::Compress(depth.data(), width, height,
+      stride * sizeof(uint16_t), compressed);
+  ASSERT_FALSE(compressed.empty());
+  EXPECT_EQ(DepthCompression::kVersion, compressed[0]);
+  EXPECT_LT(compressed.size(), width * height * sizeof(uint16_t) / 2u);
+
+  // bands compressed in parallel give the same data
+  unsigned int calls = 0u;
+  DepthCompression::ParallelFor parallelFor =
+      [&](unsigned int _count,
+          const std::function<void(unsigned int, unsigned int)> &_function)
+      {
+        ++calls;
+        _function(0u, _count / 2u);
+        _function(_count / 2u, _count);
+      };
+  std::vector<uint8_t> parallelCompressed;
+  DepthCompression::Compress(depth.data(), width, height,
+      stride * sizeof(uint16_t), parallelCompressed, parallelFor);
+  EXPECT_EQ(1u, calls);
+  EXPECT_EQ(compressed, parallelCompressed);
+
+  std::vector<uint16_t> decompressed;
+  unsigned int decompressedWidth = 0u;
+  unsigned int decompressedHeight = 0u;
+  ASSERT_TRUE(DepthCompression::Decompress(compressed.data(),
+      compressed.size(), decompressed, decompressedWidth,
+      decompressedHeight, parallelFor));
+  EXPECT_EQ(width, decompressedWidth);
+  EXPECT_EQ(height, decompressedHeight);
+  ASSERT_EQ(width * height, decompressed.size());
+  for (unsigned int y = 0u; y < height; ++y)
+  {
+    for (unsigned int x = 0u; x < width; ++x)
+      EXPECT_EQ(depth[y * stride + x], decompressed[y * width + x]);
+  }
+
+  // large jumps between valid depth values are kept too
+  std::vector<uint16_t> edges = {0u, 65535u, 1u, 65535u, 0u, 0u, 300u, 2u};
+  DepthCompression::Compress(edges.data(), 4u, 2u, 4u * sizeof(uint16_t),
+      compressed);
+  ASSERT_TRUE(DepthCompression::Decompress(compressed.data(),
+      compressed.size(), decompressed, decompressedWidth,
+      decompressedHeight));
+  EXPECT_EQ(edges, decompressed);
+}
+
+/////////////////////////////////////////////////
+TEST(DepthCompressionTest, Malformed)
+{
+  std::vector<uint16_t> depth(16u * 16u, 1234u);
+  std::vector<uint8_t> compressed;
+  DepthCompression::Compress(depth.data(), 16u, 16u, 16u * sizeof(uint16_t),
+      compressed);
+
+  std::vector<uint16_t> decompressed;
+  unsigned int width = 0u;
+  unsigned int height = 0u;
+  EXPECT_FALSE(DepthCompression::Decompress(nullptr, 0u, decompressed,
+      width, height));
+  EXPECT_FALSE(DepthCompression::Decompress(compressed.data(),
+      compressed.size() - 1u, decompressed, width, height));
+
+  compressed[0] = 0u;
+  EXPECT_FALSE(DepthCompression::Decompress(compressed.data(),
+      compressed.size(), decompressed, width, height));
+  EXPECT_EQ(0u, width);
+  EXPECT_EQ(0u, height);
+}
@@ -0,0 +1,550 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Image.hh>
+#include <ignition/common/Profiler.hh>
+
+#include "ignition/rendering/FrameRecorder.hh"
+#include "ignition/rendering/PixelFormat.hh"
+
+/// \brief Private data for the FrameRecorder class
+class ignition::rendering::FrameRecorderPrivate
+{
+  /// \brief A frame waiting to be written
+  public: struct Frame
+  {
+    /// \brief Image to write
+    Image image;
+
+    /// \brief Name of the file
+    std::string filename;
+  };
+
+  /// \brief Write queued frames until stopped
+  public: void Run();
+
+  /// \brief Protects the members below
+  public: mutable std::mutex mutex;
+
+  /// \brief Signaled when a frame is queued or the recorder is stopped
+  public: std::condition_variable queued;
+
+  /// \brief Signaled when a frame is written or dropped
+  public: std::condition_variable done;
+
+  /// \brief Frames waiting to be written, oldest first
+  public: std::deque<Frame> frames;
+
+  /// \brief Maximum number of frames waiting to be written
+  public: unsigned int queueSize = 8u;
+
+  /// \brief Number of frames queued or being written
+  public: unsigned int pending = 0u;
+
+  /// \brief Number of frames written so far
+  public: uint64_t written = 0u;
+
+  /// \brief Number of frames dropped so far
+  public: uint64_t dropped = 0u;
+
+  /// \brief True to block Save when the queue is full
+  public: bool blockWhenFull = false;
+
+  /// \brief True once the recorder is destroyed
+  public: bool stopping = false;
+
+  /// \brief Writer threads
+  public: std::vector<std::thread> threads;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+namespace
+{
+  /// \brief File formats written by the recorder
+  enum class FileFormat
+  {
+    UNKNOWN,
+    PNG,
+    EXR,
+    NPY,
+    RAW
+  };
+
+  //////////////////////////////////////////////////
+  FileFormat FileFormatOf(const std::string &_filename)
+  {
+    std::string::size_type dot = _filename.rfind('.');
+    if (dot == std::string::npos)
+      return FileFormat::UNKNOWN;
+
+    std::string ext = _filename.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    if (ext == "png")
+      return FileFormat::PNG;
+    if (ext == "exr")
+      return FileFormat::EXR;
+    if (ext == "npy")
+      return FileFormat::NPY;
+    if (ext == "raw")
+      return FileFormat::RAW;
+    return FileFormat::UNKNOWN;
+  }
+
+  //////////////////////////////////////////////////
+  bool IsBayer(PixelFormat _format)
+  {
+    return _format == PF_BAYER_RGGB8 || _format == PF_BAYER_BGGR8 ||
+        _format == PF_BAYER_GBGR8 || _format == PF_BAYER_GRGB8;
+  }
+
+  //////////////////////////////////////////////////
+  bool IsFloat(PixelFormat _format)
+  {
+    return _format == PF_FLOAT32_R || _format == PF_FLOAT32_RGB ||
+        _format == PF_FLOAT32_RGBA || _format == PF_FLOAT16_R ||
+        _format == PF_FLOAT16_RGB;
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Append a little endian integer to a buffer
+  template <typename T>
+  void Append(std::string &_buffer, T _value)
+  {
+    for (unsigned int i = 0; i < sizeof(T); ++i)
+      _buffer.push_back(static_cast<char>((_value >> (8u * i)) & 0xFF));
+  }
+
+  //////////////////////////////////////////////////
+  bool WriteFile(const std::string &_filename, const std::string &_header,
+      const char *_data, std::size_t _size)
+  {
+    std::ofstream file(_filename, std::ios::binary);
+    if (!file)
+      return false;
+    file.write(_header.data(), _header.size());
+    file.write(_data, _size);
+    return static_cast<bool>(file);
+  }
+
+  //////////////////////////////////////////////////
+  bool WritePng(const Image &_image, const std::string &_filename)
+  {
+    PixelFormat format = _image.Format();
+    unsigned int width = _image.Width();
+    unsigned int height = _image.Height();
+    const unsigned char *data = _image.Data<unsigned char>();
+
+    common::Image out;
+    if (format == PF_L8 || IsBayer(format))
+    {
+      out.SetFromData(data, width, height, common::Image::L_INT8);
+    }
+    else if (format == PF_R8G8B8)
+    {
+      out.SetFromData(data, width, height, common::Image::RGB_INT8);
+    }
+    else if (format == PF_R8G8B8A8)
+    {
+      out.SetFromData(data, width, height, common::Image::RGBA_INT8);
+    }
+    else if (format == PF_B8G8R8)
+    {
+      std::vector<unsigned char> rgb(_image.MemorySize());
+      PixelUtil::Convert(data, format, rgb.data(), PF_R8G8B8, width,
+          height);
+      out.SetFromData(rgb.data(), width, height, common::Image::RGB_INT8);
+    }
+    else
+    {
+      return false;
+    }
+    out.SavePNG(_filename);
+    return true;
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Write an uncompressed single part scanline OpenEXR file
+  bool WriteExr(const Image &_image, const std::string &_filename)
+  {
+    PixelFormat format = _image.Format();
+    unsigned int width = _image.Width();
+    unsigned int height = _image.Height();
+    unsigned int channels = PixelUtil::ChannelCount(format);
+    unsigned int channelBytes = PixelUtil::BytesPerChannel(format);
+
+    // channels are stored in alphabetical order, single channel images as
+    // luminance
+    static const char *rgbaNames[] = {"R", "G", "B", "A"};
+    std::vector<std::pair<std::string, unsigned int>> names;
+    if (channels == 1u)
+      names.push_back({"Y", 0u});
+    else
+    {
+      for (unsigned int c = 0; c < channels; ++c)
+        names.push_back({rgbaNames[c], c});
+    }
+    std::sort(names.begin(), names.end());
+
+    // pixel types: 1 half, 2 float
+    int pixelType = channelBytes == 2u ? 1 : 2;
+
+    std::string header;
+    Append<uint32_t>(header, 20000630u);
+    Append<uint32_t>(header, 2u);
+
+    auto attribute = [&header](const std::string &_name,
+        const std::string &_type, uint32_t _size)
+    {
+      header += _name;
+      header.push_back('\0');
+      header += _type;
+      header.push_back('\0');
+      Append<uint32_t>(header, _size);
+    };
+
+    attribute("channels", "chlist",
+        static_cast<uint32_t>(names.size() * 18u + 1u));
+    for (const auto &name : names)
+    {
+      header += name.first;
+      header.push_back('\0');
+      Append<int32_t>(header, pixelType);
+      // linear flag and reserved bytes
+      Append<uint32_t>(header, 0u);
+      // x and y sampling
+      Append<int32_t>(header, 1);
+      Append<int32_t>(header, 1);
+    }
+    header.push_back('\0');
+
+    attribute("compression", "compression", 1u);
+    header.push_back('\0');
+
+    for (const char *window : {"dataWindow", "displayWindow"})
+    {
+      attribute(window, "box2i", 16u);
+      Append<int32_t>(header, 0);
+      Append<int32_t>(header, 0);
+      Append<int32_t>(header, static_cast<int32_t>(width) - 1);
+      Append<int32_t>(header, static_cast<int32_t>(height) - 1);
+    }
+
+    attribute("lineOrder", "lineOrder", 1u);
+    header.push_back('\0');
+
+    uint32_t one;
+    float oneFloat = 1.0f;
+    std::memcpy(&one, &oneFloat, sizeof(one));
+    attribute("pixelAspectRatio", "float", 4u);
+    Append<uint32_t>(header, one);
+    attribute("screenWindowCenter", "v2f", 8u);
+    Append<uint32_t>(header, 0u);
+    Append<uint32_t>(header, 0u);
+    attribute("screenWindowWidth", "float", 4u);
+    Append<uint32_t>(header, one);
+    header.push_back('\0');
+
+    // offset table, one scanline per block
+    uint64_t lineBytes = static_cast<uint64_t>(width) * channels *
+        channelBytes;
+    uint64_t offset = header.size() + height * sizeof(uint64_t);
+    for (unsigned int y = 0; y < height; ++y)
+    {
+      Append<uint64_t>(header, offset);
+      offset += 8u + lineBytes;
+    }
+
+    // scanlines store the channels one after the other
+    std::string body;
+    body.reserve(height * (8u + lineBytes));
+    const char *data = static_cast<const char *>(_image.Data());
+    for (unsigned int y = 0; y < height; ++y)
+    {
+      Append<int32_t>(body, static_cast<int32_t>(y));
+      Append<uint32_t>(body, static_cast<uint32_t>(lineBytes));
+      const char *row = data + y * lineBytes;
+      for (const auto &name : names)
+      {
+        for (unsigned int x = 0; x < width; ++x)
+        {
+          body.append(row + (x * channels + name.second) * channelBytes,
+              channelBytes);
+        }
+      }
+    }
+    return WriteFile(_filename, header, body.data(), body.size());
+  }
+
+  //////////////////////////////////////////////////
+  bool WriteNpy(const Image &_image, const std::string &_filename)
+  {
+    PixelFormat format = _image.Format();
+    unsigned int channels = PixelUtil::ChannelCount(format);
+    unsigned int channelBytes = PixelUtil::BytesPerChannel(format);
+
+    std::string descr;
+    if (IsFloat(format))
+      descr = channelBytes == 2u ? "<f2" : "<f4";
+    else
+      descr = channelBytes == 2u ? "<u2" : "|u1";
+
+    std::stringstream dict;
+    dict << "{'descr': '" << descr << "', 'fortran_order': False, "
+         << "'shape': (" << _image.Height() << ", " << _image.Width();
+    if (channels > 1u)
+      dict << ", " << channels;
+    dict << "), }";
+
+    // pad the header with spaces so the data is 64 byte aligned
+    std::string text = dict.str();
+    std::size_t size = 10u + text.size() + 1u;
+    text.append((64u - size % 64u) % 64u, ' ');
+    text.push_back('\n');
+
+    std::string header("\x93NUMPY\x01\x00", 8u);
+    Append<uint16_t>(header, static_cast<uint16_t>(text.size()));
+    header += text;
+    return WriteFile(_filename, header,
+        static_cast<const char *>(_image.Data()),
+        _image.MemorySize());
+  }
+}
+
+//////////////////////////////////////////////////
+void FrameRecorderPrivate::Run()
+{
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    this->queued.wait(lock, [this]()
+    {
+      return this->stopping || !this->frames.empty();
+    });
+
+    // write the frames already queued before stopping
+    if (this->frames.empty())
+      break;
+
+    Frame frame = std::move(this->frames.front());
+    this->frames.pop_front();
+    // a slot is free
+    this->done.notify_all();
+
+    lock.unlock();
+    bool result = FrameRecorder::Write(frame.image, frame.filename);
+    // release the buffer before waking up Flush
+    frame.image = Image();
+    lock.lock();
+
+    if (result)
+      ++this->written;
+    else
+      ++this->dropped;
+    --this->pending;
+    this->done.notify_all();
+  }
+}
+
+//////////////////////////////////////////////////
+FrameRecorder::FrameRecorder(unsigned int _threadCount,
+    unsigned int _queueSize)
+  : dataPtr(new FrameRecorderPrivate)
+{
+  this->dataPtr->queueSize = std::max(_queueSize, 1u);
+  for (unsigned int i = 0; i < std::max(_threadCount, 1u); ++i)
+  {
+    this->dataPtr->threads.emplace_back(&FrameRecorderPrivate::Run,
+        this->dataPtr.get());
+  }
+}
+
+//////////////////////////////////////////////////
+FrameRecorder::~FrameRecorder()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stopping = true;
+  }
+  this->dataPtr->queued.notify_all();
+  this->dataPtr->done.notify_all();
+
+  for (auto &thread : this->dataPtr->threads)
+  {
+    if (thread.joinable())
+      thread.join();
+  }
+}
+
+//////////////////////////////////////////////////
+bool FrameRecorder::Save(const Image &_image, const std::string &_filename)
+{
+  if (!IsSupported(_image.Format(), _filename))
+  {
+    ignerr << "Unable to save a " << PixelUtil::Name(_image.Format())
+           << " image to [" << _filename << "]" << std::endl;
+    return false;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+    auto full = [this]()
+    {
+      return this->dataPtr->frames.size() >= this->dataPtr->queueSize;
+    };
+
+    if (full() && this->dataPtr->blockWhenFull)
+    {
+      this->dataPtr->done.wait(lock, [this, &full]()
+      {
+        return this->dataPtr->stopping || !full();
+      });
+    }
+
+    if (full() || this->dataPtr->stopping)
+    {
+      ++this->dataPtr->dropped;
+      return false;
+    }
+
+    this->dataPtr->frames.push_back({_image, _filename});
+    ++this->dataPtr->pending;
+  }
+  this->dataPtr->queued.notify_one();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void FrameRecorder::Flush()
+{
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->done.wait(lock, [this]()
+  {
+    return this->dataPtr->pending == 0u;
+  });
+}
+
+//////////////////////////////////////////////////
+void FrameRecorder::SetBlockWhenFull(bool _block)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->blockWhenFull = _block;
+}
+
+//////////////////////////////////////////////////
+bool FrameRecorder::BlockWhenFull() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->blockWhenFull;
+}
+
+//////////////////////////////////////////////////
+unsigned int FrameRecorder::QueueSize() const
+{
+  return this->dataPtr->queueSize;
+}
+
+//////////////////////////////////////////////////
+unsigned int FrameRecorder::PendingCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->pending;
+}
+
+//////////////////////////////////////////////////
+uint64_t FrameRecorder::WrittenCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->written;
+}
+
+//////////////////////////////////////////////////
+uint64_t FrameRecorder::DroppedCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->dropped;
+}
+
+//////////////////////////////////////////////////
+bool FrameRecorder::IsSupported(PixelFormat _format,
+    const std::string &_filename)
+{
+  if (!PixelUtil::IsValid(_format) || _format == PF_UNKNOWN)
+    return false;
+
+  switch (FileFormatOf(_filename))
+  {
+    case FileFormat::PNG:
+      return _format == PF_L8 || _format == PF_R8G8B8 ||
+          _format == PF_B8G8R8 || _format == PF_R8G8B8A8 ||
+          IsBayer(_format);
+    case FileFormat::EXR:
+      return IsFloat(_format);
+    case FileFormat::NPY:
+    case FileFormat::RAW:
+      return true;
+    default:
+      return false;
+  }
+}
+
+//////////////////////////////////////////////////
+bool FrameRecorder::Write(const Image &_image, const std::string &_filename)
+{
+  IGN_PROFILE("FrameRecorder::Write");
+  if (!IsSupported(_image.Format(), _filename) || !_image.Data())
+    return false;
+
+  bool result = false;
+  switch (FileFormatOf(_filename))
+  {
+    case FileFormat::PNG:
+      result = WritePng(_image, _filename);
+      break;
+    case FileFormat::EXR:
+      result = WriteExr(_image, _filename);
+      break;
+    case FileFormat::NPY:
+      result = WriteNpy(_image, _filename);
+      break;
+    case FileFormat::RAW:
+      result = WriteFile(_filename, std::string(),
+          static_cast<const char *>(_image.Data()),
+          _image.MemorySize());
+      break;
+    default:
+      break;
+  }
+
+  if (!result)
+    ignerr << "Unable to write [" << _filename << "]" << std::endl;
+  return result;
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <ignition/common/Filesystem.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/FrameRecorder.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+/// \brief Read a whole file
+std::string ReadFile(const std::string &_filename)
+{
+  std::ifstream file(_filename, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file),
+      std::istreambuf_iterator<char>());
+}
+
+/////////////////////////////////////////////////
+TEST(FrameRecorderTest, IsSupported)
+{
+  EXPECT_TRUE(FrameRecorder::IsSupported(PF_R8G8B8, "a.png"));
+  EXPECT_TRUE(FrameRecorder::IsSupported(PF_B8G8R8, "a.PNG"));
+  EXPECT_TRUE(FrameRecorder::IsSupported(PF_BAYER_RGGB8, "a.png"));
+  EXPECT_FALSE(FrameRecorder::IsSupported(PF_FLOAT32_R, "a.png"));
+  EXPECT_FALSE(FrameRecorder::IsSupported(PF_L16, "a.png"));
+
+  EXPECT_TRUE(FrameRecorder::IsSupported(PF_FLOAT32_R, "a.exr"));
+  EXPECT_TRUE(FrameRecorder::IsSupported(PF_FLOAT16_RGB, "a.exr"));
+  EXPECT_FALSE(FrameRecorder::IsSupported(PF_R8G8B8, "a.exr"));
+
+  EXPECT_TRUE(FrameRecorder::IsSupported(PF_L16, "a.npy"));
+  EXPECT_TRUE(FrameRecorder::IsSupported(PF_FLOAT32_RGBA, "a.raw"));
+
+  EXPECT_FALSE(FrameRecorder::IsSupported(PF_R8G8B8, "a.jpg"));
+  EXPECT_FALSE(FrameRecorder::IsSupported(PF_R8G8B8, "a"));
+  EXPECT_FALSE(FrameRecorder::IsSupported(PF_UNKNOWN, "a.raw"));
+}
+
+/////////////////////////////////////////////////
+TEST(FrameRecorderTest, Write)
+{
+  Image image(4, 3, PF_L16);
+  uint16_t *data = static_cast<uint16_t *>(image.Data());
+  for (unsigned int i = 0; i < 12u; ++i)
+    data[i] = static_cast<uint16_t>(i * 1000u);
+
+  // raw files hold the buffer as is
+  std::string raw = common::joinPaths(PROJECT_BUILD_PATH, "frame.raw");
+  EXPECT_TRUE(FrameRecorder::Write(image, raw));
+  std::string content = ReadFile(raw);
+  ASSERT_EQ(image.MemorySize(), content.size());
+  EXPECT_EQ(0, std::memcmp(content.data(), image.Data(), content.size()));
+  common::removeFile(raw);
+
+  // npy files have a 64 byte aligned header followed by the buffer
+  std::string npy = common::joinPaths(PROJECT_BUILD_PATH, "frame.npy");
+  EXPECT_TRUE(FrameRecorder::Write(image, npy));
+  content = ReadFile(npy);
+  ASSERT_GT(content.size(), 10u);
+  EXPECT_EQ(std::string("\x93NUMPY", 6u), content.substr(0, 6u));
+  std::size_t headerSize = 10u +
+      static_cast<unsigned char>(content[8]) +
+      static_cast<unsigned char>(content[9]) * 256u;
+  EXPECT_EQ(0u, headerSize % 64u);
+  ASSERT_EQ(headerSize + image.MemorySize(), content.size());
+  EXPECT_NE(std::string::npos, content.find("'descr': '<u2'"));
+  EXPECT_NE(std::string::npos, content.find("'shape': (3, 4)"));
+  EXPECT_EQ('\n', content[headerSize - 1u]);
+  EXPECT_EQ(0, std::memcmp(content.data() + headerSize, image.Data(),
+      image.MemorySize()));
+  common::removeFile(npy);
+
+  // exr files start with the magic number and end with the scanlines
+  Image depth(4, 3, PF_FLOAT32_R);
+  float *depthData = static_cast<float *>(depth.Data());
+  for (unsigned int i = 0; i < 12u; ++i)
+    depthData[i] = i * 0.5f;
+  std::string exr = common::joinPaths(PROJECT_BUILD_PATH, "frame.exr");
+  EXPECT_TRUE(FrameRecorder::Write(depth, exr));
+  content = ReadFile(exr);
+  ASSERT_GT(content.size(), depth.MemorySize());
+  EXPECT_EQ(std::string("\x76\x2f\x31\x01", 4u), content.substr(0, 4u));
+  EXPECT_NE(std::string::npos, content.find("dataWindow"));
+  // each scanline is its y, its size and its pixels
+  std::size_t lines = content.size() - 3u * (8u + 16u);
+  EXPECT_EQ(0, std::memcmp(content.data() + lines + 8u, depthData, 16u));
+  common::removeFile(exr);
+
+  // unsupported
+  EXPECT_FALSE(FrameRecorder::Write(image, "frame.exr"));
+  EXPECT_FALSE(FrameRecorder::Write(Image(), "frame.raw"));
+}
+
+/////////////////////////////////////////////////
+TEST(FrameRecorderTest, Save)
+{
+  FrameRecorder recorder(2u, 4u);
+  EXPECT_EQ(4u, recorder.QueueSize());
+  EXPECT_FALSE(recorder.BlockWhenFull());
+  recorder.SetBlockWhenFull(true);
+  EXPECT_TRUE(recorder.BlockWhenFull());
+
+  Image image(16, 16, PF_FLOAT32_RGB);
+  std::memset(image.Data(), 0, image.MemorySize());
+
+  // blocking never drops frames
+  const unsigned int count = 20u;
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    std::string name = common::joinPaths(PROJECT_BUILD_PATH,
+        "frame_" + std::to_string(i) + ".raw");
+    EXPECT_TRUE(recorder.Save(image, name));
+  }
+  recorder.Flush();
+  EXPECT_EQ(0u, recorder.PendingCount());
+  EXPECT_EQ(count, recorder.WrittenCount());
+  EXPECT_EQ(0u, recorder.DroppedCount());
+
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    std::string name = common::joinPaths(PROJECT_BUILD_PATH,
+        "frame_" + std::to_string(i) + ".raw");
+    EXPECT_EQ(image.MemorySize(), ReadFile(name).size());
+    common::removeFile(name);
+  }
+
+  // unsupported formats are rejected right away
+  EXPECT_FALSE(recorder.Save(image, "frame.png"));
+  EXPECT_EQ(0u, recorder.PendingCount());
+
+  // files that can not be written count as dropped
+  EXPECT_TRUE(recorder.Save(image,
+      common::joinPaths(PROJECT_BUILD_PATH, "missing", "dir", "frame.raw")));
+  recorder.Flush();
+  EXPECT_EQ(count, recorder.WrittenCount());
+  EXPECT_EQ(1u, recorder.DroppedCount());
+}
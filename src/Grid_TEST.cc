@@ -70,6 +70,10 @@ void GridTest::Grid(const std::string &_renderEngine)
   grid->SetVerticalCellCount(2u);
   EXPECT_EQ(2u, grid->VerticalCellCount());
 
+  EXPECT_FALSE(grid->Procedural());
+  grid->SetProcedural(true);
+  EXPECT_TRUE(grid->Procedural());
+
   // create material
   MaterialPtr mat = scene->CreateMaterial();
   mat->SetAmbient(0.6, 0.7, 0.8);
@@ -62,6 +62,12 @@ class ignition::rendering::HeightmapDescriptorPrivate
   /// \brief Flag that enables/disables the terrain paging
   public: bool useTerrainPaging{false};
 
+  /// \brief Number of samples along each edge of a terrain tile.
+  public: unsigned int tileSize{256u};
+
+  /// \brief Maximum number of terrain tiles loaded at the same time.
+  public: unsigned int maxResidentTiles{16u};
+
   /// \brief Number of samples per heightmap datum.
   public: unsigned int sampling{1u};
 
@@ -305,6 +311,30 @@ void HeightmapDescriptor::SetUseTerrainPaging(bool _useTerrainPaging)
   this->dataPtr->useTerrainPaging = _useTerrainPaging;
 }
 
+//////////////////////////////////////////////////
+unsigned int HeightmapDescriptor::TileSize() const
+{
+  return this->dataPtr->tileSize;
+}
+
+//////////////////////////////////////////////////
+void HeightmapDescriptor::SetTileSize(unsigned int _size)
+{
+  this->dataPtr->tileSize = _size;
+}
+
+//////////////////////////////////////////////////
+unsigned int HeightmapDescriptor::MaxResidentTiles() const
+{
+  return this->dataPtr->maxResidentTiles;
+}
+
+//////////////////////////////////////////////////
+void HeightmapDescriptor::SetMaxResidentTiles(unsigned int _count)
+{
+  this->dataPtr->maxResidentTiles = _count;
+}
+
 //////////////////////////////////////////////////
 unsigned int HeightmapDescriptor::Sampling() const
 {
@@ -172,12 +172,16 @@ TEST_P(HeightmapTest, MoveConstructor)
   descriptor.SetPosition({0.5, 0.6, 0.7});
   descriptor.SetUseTerrainPaging(true);
   descriptor.SetSampling(123u);
+  descriptor.SetTileSize(64u);
+  descriptor.SetMaxResidentTiles(9u);
 
   HeightmapDescriptor descriptor2(std::move(descriptor));
   EXPECT_EQ(ignition::math::Vector3d(0.1, 0.2, 0.3), descriptor2.Size());
   EXPECT_EQ(ignition::math::Vector3d(0.5, 0.6, 0.7), descriptor2.Position());
   EXPECT_TRUE(descriptor2.UseTerrainPaging());
   EXPECT_EQ(123u, descriptor2.Sampling());
+  EXPECT_EQ(64u, descriptor2.TileSize());
+  EXPECT_EQ(9u, descriptor2.MaxResidentTiles());
 
   HeightmapTexture texture;
   texture.SetSize(123.456);
@@ -206,12 +210,16 @@ TEST_P(HeightmapTest, CopyConstructor)
   descriptor.SetPosition({0.5, 0.6, 0.7});
   descriptor.SetUseTerrainPaging(true);
   descriptor.SetSampling(123u);
+  descriptor.SetTileSize(64u);
+  descriptor.SetMaxResidentTiles(9u);
 
   HeightmapDescriptor descriptor2(descriptor);
   EXPECT_EQ(ignition::math::Vector3d(0.1, 0.2, 0.3), descriptor2.Size());
   EXPECT_EQ(ignition::math::Vector3d(0.5, 0.6, 0.7), descriptor2.Position());
   EXPECT_TRUE(descriptor2.UseTerrainPaging());
   EXPECT_EQ(123u, descriptor2.Sampling());
+  EXPECT_EQ(64u, descriptor2.TileSize());
+  EXPECT_EQ(9u, descriptor2.MaxResidentTiles());
 
   HeightmapTexture texture;
   texture.SetSize(123.456);
@@ -240,6 +248,8 @@ TEST_P(HeightmapTest, CopyAssignmentOperator)
   descriptor.SetPosition({0.5, 0.6, 0.7});
   descriptor.SetUseTerrainPaging(true);
   descriptor.SetSampling(123u);
+  descriptor.SetTileSize(64u);
+  descriptor.SetMaxResidentTiles(9u);
 
   HeightmapDescriptor descriptor2;
   descriptor2 = descriptor;
@@ -247,6 +257,8 @@ TEST_P(HeightmapTest, CopyAssignmentOperator)
   EXPECT_EQ(ignition::math::Vector3d(0.5, 0.6, 0.7), descriptor2.Position());
   EXPECT_TRUE(descriptor2.UseTerrainPaging());
   EXPECT_EQ(123u, descriptor2.Sampling());
+  EXPECT_EQ(64u, descriptor2.TileSize());
+  EXPECT_EQ(9u, descriptor2.MaxResidentTiles());
 
   HeightmapTexture texture;
   texture.SetSize(123.456);
@@ -277,6 +289,8 @@ TEST_P(HeightmapTest, MoveAssignmentOperator)
   descriptor.SetPosition({0.5, 0.6, 0.7});
   descriptor.SetUseTerrainPaging(true);
   descriptor.SetSampling(123u);
+  descriptor.SetTileSize(64u);
+  descriptor.SetMaxResidentTiles(9u);
 
   HeightmapDescriptor descriptor2;
   descriptor2 = std::move(descriptor);
@@ -284,6 +298,8 @@ TEST_P(HeightmapTest, MoveAssignmentOperator)
   EXPECT_EQ(ignition::math::Vector3d(0.5, 0.6, 0.7), descriptor2.Position());
   EXPECT_TRUE(descriptor2.UseTerrainPaging());
   EXPECT_EQ(123u, descriptor2.Sampling());
+  EXPECT_EQ(64u, descriptor2.TileSize());
+  EXPECT_EQ(9u, descriptor2.MaxResidentTiles());
 
   HeightmapTexture texture;
   texture.SetSize(123.456);
@@ -14,6 +14,10 @@
  * limitations under the License.
  *
  */
+#include <utility>
+
+#include <ignition/common/Console.hh>
+
 #include "ignition/rendering/Image.hh"
 
 using namespace ignition;
@@ -40,6 +44,45 @@ Image::Image(unsigned int _width, unsigned int _height,
   this->data = DataPtr(new unsigned char[size], ArrayDeleter<unsigned char>());
 }
 
+//////////////////////////////////////////////////
+Image::Image(unsigned int _width, unsigned int _height,
+  PixelFormat _format, DataPtr _data, unsigned int _rowPitch) :
+  width(_width),
+  height(_height),
+  data(std::move(_data))
+{
+  this->format = PixelUtil::Sanitize(_format);
+  unsigned int rowSize = this->width * PixelUtil::BytesPerPixel(this->format);
+  if (_rowPitch < rowSize)
+  {
+    if (_rowPitch != 0u)
+    {
+      ignerr << "Row pitch [" << _rowPitch << "] is smaller than a row ["
+             << rowSize << "], rows are assumed to have no padding"
+             << std::endl;
+    }
+  }
+  else if (_rowPitch != rowSize)
+  {
+    this->rowPitch = _rowPitch;
+  }
+}
+
+//////////////////////////////////////////////////
+Image::Image(unsigned int _width, unsigned int _height,
+  PixelFormat _format, void *_data, std::function<void(void *)> _deleter,
+  unsigned int _rowPitch) :
+  Image(_width, _height, _format,
+      DataPtr(static_cast<unsigned char *>(_data),
+          [_deleter = std::move(_deleter)](unsigned char *_p)
+          {
+            if (_deleter)
+              _deleter(_p);
+          }),
+      _rowPitch)
+{
+}
+
 //////////////////////////////////////////////////
 Image::~Image()
 {
@@ -75,6 +118,14 @@ unsigned int Image::MemorySize() const
   return PixelUtil::MemorySize(this->format, this->width, this->height);
 }
 
+//////////////////////////////////////////////////
+unsigned int Image::RowPitch() const
+{
+  if (this->rowPitch != 0u)
+    return this->rowPitch;
+  return this->width * PixelUtil::BytesPerPixel(this->format);
+}
+
 //////////////////////////////////////////////////
 const void *Image::Data() const
 {
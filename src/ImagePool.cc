@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include "ignition/rendering/ImagePool.hh"
+
+/// \brief Private data for the ImagePool class
+class ignition::rendering::ImagePoolPrivate
+{
+  /// \brief Allocator of a buffer, kept with the buffer so that it is
+  /// freed by the allocator that made it
+  public: struct Allocator
+  {
+    /// \brief Allocation function
+    ImagePool::AllocateFunction allocate;
+
+    /// \brief Deallocation function
+    ImagePool::DeallocateFunction deallocate;
+  };
+
+  /// \brief Destructor. Frees the buffers released after the pool
+  /// was cleared.
+  public: ~ImagePoolPrivate();
+
+  /// \brief Take an unused buffer of at least the given size
+  /// \param[in] _size Required size in bytes
+  /// \param[out] _buffer Buffer taken
+  /// \return True if a buffer was found
+  public: bool Take(std::size_t _size,
+              std::pair<std::size_t, void *> &_buffer);
+
+  /// \brief Hand a released buffer back, or free it if the pool is full
+  /// or the allocator changed
+  /// \param[in] _buffer Buffer data
+  /// \param[in] _size Buffer size in bytes
+  /// \param[in] _allocator Allocator that made the buffer
+  public: void Release(void *_buffer, std::size_t _size,
+              const std::shared_ptr<Allocator> &_allocator);
+
+  /// \brief Protects all members
+  public: mutable std::mutex mutex;
+
+  /// \brief Current allocator
+  public: std::shared_ptr<Allocator> allocator;
+
+  /// \brief Unused buffers, key: buffer size in bytes
+  public: std::multimap<std::size_t, void *> freeBuffers;
+
+  /// \brief Maximum number of unused buffers
+  public: unsigned int maxFreeBuffers = 4u;
+
+  /// \brief Number of buffers allocated
+  public: unsigned int allocationCount = 0u;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+static std::shared_ptr<ImagePoolPrivate::Allocator> defaultAllocator()
+{
+  auto allocator = std::make_shared<ImagePoolPrivate::Allocator>();
+  allocator->allocate = [](std::size_t _size) -> void *
+  {
+    return new unsigned char[_size];
+  };
+  allocator->deallocate = [](void *_buffer, std::size_t)
+  {
+    delete [] static_cast<unsigned char *>(_buffer);
+  };
+  return allocator;
+}
+
+//////////////////////////////////////////////////
+ImagePoolPrivate::~ImagePoolPrivate()
+{
+  for (const auto &buffer : this->freeBuffers)
+    this->allocator->deallocate(buffer.second, buffer.first);
+}
+
+//////////////////////////////////////////////////
+bool ImagePoolPrivate::Take(std::size_t _size,
+    std::pair<std::size_t, void *> &_buffer)
+{
+  // accept larger buffers as long as not more than half of it is wasted
+  auto it = this->freeBuffers.lower_bound(_size);
+  if (it == this->freeBuffers.end() || it->first / 2u > _size)
+    return false;
+
+  _buffer = *it;
+  this->freeBuffers.erase(it);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void ImagePoolPrivate::Release(void *_buffer, std::size_t _size,
+    const std::shared_ptr<Allocator> &_allocator)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (_allocator == this->allocator &&
+        this->freeBuffers.size() < this->maxFreeBuffers)
+    {
+      this->freeBuffers.emplace(_size, _buffer);
+      return;
+    }
+  }
+  _allocator->deallocate(_buffer, _size);
+}
+
+//////////////////////////////////////////////////
+ImagePool::ImagePool(unsigned int _maxFreeBuffers)
+  : dataPtr(std::make_shared<ImagePoolPrivate>())
+{
+  this->dataPtr->allocator = defaultAllocator();
+  this->dataPtr->maxFreeBuffers = _maxFreeBuffers;
+}
+
+//////////////////////////////////////////////////
+ImagePool::~ImagePool()
+{
+}
+
+//////////////////////////////////////////////////
+Image ImagePool::CreateImage(unsigned int _width, unsigned int _height,
+    PixelFormat _format)
+{
+  PixelFormat format = PixelUtil::Sanitize(_format);
+  std::size_t size = PixelUtil::MemorySize(format, _width, _height);
+
+  std::pair<std::size_t, void *> buffer(size, nullptr);
+  std::shared_ptr<ImagePoolPrivate::Allocator> allocator;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    allocator = this->dataPtr->allocator;
+    if (!this->dataPtr->Take(size, buffer))
+      this->dataPtr->allocationCount++;
+  }
+
+  if (!buffer.second)
+    buffer.second = allocator->allocate(size);
+
+  // the buffer goes back to the pool if it still exists
+  std::weak_ptr<ImagePoolPrivate> pool = this->dataPtr;
+  std::size_t bufferSize = buffer.first;
+  Image::DataPtr data(static_cast<unsigned char *>(buffer.second),
+      [pool, bufferSize, allocator](unsigned char *_buffer)
+      {
+        if (auto p = pool.lock())
+          p->Release(_buffer, bufferSize, allocator);
+        else
+          allocator->deallocate(_buffer, bufferSize);
+      });
+
+  return Image(_width, _height, format, data);
+}
+
+//////////////////////////////////////////////////
+void ImagePool::SetAllocator(const AllocateFunction &_allocate,
+    const DeallocateFunction &_deallocate)
+{
+  auto allocator = std::make_shared<ImagePoolPrivate::Allocator>();
+  allocator->allocate = _allocate;
+  allocator->deallocate = _deallocate;
+
+  // the free buffers are taken and the allocator is swapped at once, so
+  // that a buffer released in between is not pooled with the old allocator
+  std::multimap<std::size_t, void *> buffers;
+  std::shared_ptr<ImagePoolPrivate::Allocator> oldAllocator;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    buffers.swap(this->dataPtr->freeBuffers);
+    oldAllocator = this->dataPtr->allocator;
+    this->dataPtr->allocator = allocator;
+  }
+
+  for (const auto &buffer : buffers)
+    oldAllocator->deallocate(buffer.second, buffer.first);
+}
+
+//////////////////////////////////////////////////
+void ImagePool::SetMaxFreeBuffers(unsigned int _count)
+{
+  std::multimap<std::size_t, void *> excess;
+  std::shared_ptr<ImagePoolPrivate::Allocator> allocator;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->maxFreeBuffers = _count;
+    allocator = this->dataPtr->allocator;
+    // free the largest buffers first
+    while (this->dataPtr->freeBuffers.size() > _count)
+    {
+      auto it = std::prev(this->dataPtr->freeBuffers.end());
+      excess.insert(*it);
+      this->dataPtr->freeBuffers.erase(it);
+    }
+  }
+
+  for (const auto &buffer : excess)
+    allocator->deallocate(buffer.second, buffer.first);
+}
+
+//////////////////////////////////////////////////
+unsigned int ImagePool::MaxFreeBuffers() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->maxFreeBuffers;
+}
+
+//////////////////////////////////////////////////
+unsigned int ImagePool::FreeBufferCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return static_cast<unsigned int>(this->dataPtr->freeBuffers.size());
+}
+
+//////////////////////////////////////////////////
+unsigned int ImagePool::AllocationCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->allocationCount;
+}
+
+//////////////////////////////////////////////////
+void ImagePool::Clear()
+{
+  std::multimap<std::size_t, void *> buffers;
+  std::shared_ptr<ImagePoolPrivate::Allocator> allocator;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    buffers.swap(this->dataPtr->freeBuffers);
+    allocator = this->dataPtr->allocator;
+  }
+
+  for (const auto &buffer : buffers)
+    allocator->deallocate(buffer.second, buffer.first);
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/ImagePool.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(ImagePoolTest, Reuse)
+{
+  ImagePool pool(2u);
+  EXPECT_EQ(2u, pool.MaxFreeBuffers());
+  EXPECT_EQ(0u, pool.FreeBufferCount());
+
+  const void *data = nullptr;
+  {
+    Image image = pool.CreateImage(32, 16, PF_R8G8B8);
+    EXPECT_EQ(32u, image.Width());
+    EXPECT_EQ(16u, image.Height());
+    EXPECT_EQ(PF_R8G8B8, image.Format());
+    ASSERT_NE(nullptr, image.Data());
+    data = image.Data();
+
+    // copies share the buffer, it is only released with the last one
+    Image copy = image;
+    EXPECT_EQ(data, copy.Data());
+    EXPECT_EQ(0u, pool.FreeBufferCount());
+  }
+  EXPECT_EQ(1u, pool.FreeBufferCount());
+  EXPECT_EQ(1u, pool.AllocationCount());
+
+  // same size reuses the buffer
+  {
+    Image image = pool.CreateImage(32, 16, PF_R8G8B8);
+    EXPECT_EQ(data, image.Data());
+    EXPECT_EQ(0u, pool.FreeBufferCount());
+  }
+  EXPECT_EQ(1u, pool.AllocationCount());
+
+  // a buffer more than twice as large is not used
+  {
+    Image image = pool.CreateImage(4, 4, PF_R8G8B8);
+    EXPECT_NE(data, image.Data());
+    EXPECT_EQ(1u, pool.FreeBufferCount());
+  }
+  EXPECT_EQ(2u, pool.AllocationCount());
+  EXPECT_EQ(2u, pool.FreeBufferCount());
+
+  // only up to the max number of buffers are kept
+  {
+    Image a = pool.CreateImage(64, 64, PF_R8G8B8);
+    Image b = pool.CreateImage(64, 64, PF_R8G8B8);
+    Image c = pool.CreateImage(64, 64, PF_R8G8B8);
+  }
+  EXPECT_EQ(2u, pool.FreeBufferCount());
+
+  pool.SetMaxFreeBuffers(1u);
+  EXPECT_EQ(1u, pool.FreeBufferCount());
+
+  pool.Clear();
+  EXPECT_EQ(0u, pool.FreeBufferCount());
+}
+
+/////////////////////////////////////////////////
+TEST(ImagePoolTest, Allocator)
+{
+  auto allocated = std::make_shared<int>(0);
+
+  auto pool = std::make_unique<ImagePool>();
+  pool->SetAllocator(
+      [allocated](std::size_t _size) -> void *
+      {
+        ++(*allocated);
+        return new unsigned char[_size];
+      },
+      [allocated](void *_buffer, std::size_t)
+      {
+        --(*allocated);
+        delete [] static_cast<unsigned char *>(_buffer);
+      });
+
+  {
+    Image image = pool->CreateImage(8, 8, PF_FLOAT32_R);
+    EXPECT_EQ(1, *allocated);
+  }
+  // kept for reuse
+  EXPECT_EQ(1, *allocated);
+
+  // images may outlive the pool
+  Image image = pool->CreateImage(16, 8, PF_FLOAT32_R);
+  EXPECT_EQ(2, *allocated);
+  pool.reset();
+  EXPECT_EQ(1, *allocated);
+  image = Image();
+  EXPECT_EQ(0, *allocated);
+}
+
+/////////////////////////////////////////////////
+TEST(ImagePoolTest, SetAllocatorWhileReleasing)
+{
+  // buffers made by each allocator, and the number of buffers freed by
+  // an allocator that did not make them
+  struct Tracker
+  {
+    std::mutex mutex;
+    std::set<void *> buffers;
+  };
+  std::atomic<int> wrongAllocator{0};
+
+  auto setAllocator = [&wrongAllocator](ImagePool &_pool,
+      const std::shared_ptr<Tracker> &_tracker)
+  {
+    _pool.SetAllocator(
+        [_tracker](std::size_t _size) -> void *
+        {
+          void *buffer = new unsigned char[_size];
+          std::lock_guard<std::mutex> lock(_tracker->mutex);
+          _tracker->buffers.insert(buffer);
+          return buffer;
+        },
+        [_tracker, &wrongAllocator](void *_buffer, std::size_t)
+        {
+          {
+            std::lock_guard<std::mutex> lock(_tracker->mutex);
+            if (_tracker->buffers.erase(_buffer) == 0u)
+              ++wrongAllocator;
+          }
+          delete [] static_cast<unsigned char *>(_buffer);
+        });
+  };
+
+  std::vector<std::shared_ptr<Tracker>> trackers;
+  {
+    ImagePool pool(8u);
+    trackers.push_back(std::make_shared<Tracker>());
+    setAllocator(pool, trackers.back());
+
+    std::atomic<bool> done{false};
+    std::thread worker([&pool, &done]()
+    {
+      while (!done)
+      {
+        Image a = pool.CreateImage(8, 8, PF_L8);
+        Image b = pool.CreateImage(8, 8, PF_L8);
+      }
+    });
+
+    for (unsigned int i = 0; i < 200u; ++i)
+    {
+      trackers.push_back(std::make_shared<Tracker>());
+      setAllocator(pool, trackers.back());
+    }
+    done = true;
+    worker.join();
+  }
+
+  // every buffer was freed by the allocator that made it
+  EXPECT_EQ(0, wrongAllocator.load());
+  for (const auto &tracker : trackers)
+    EXPECT_TRUE(tracker->buffers.empty());
+}
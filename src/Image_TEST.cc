@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <utility>
+#include <vector>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/Image.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(ImageTest, Allocate)
+{
+  Image image(8, 4, PF_R8G8B8);
+  EXPECT_EQ(8u, image.Width());
+  EXPECT_EQ(4u, image.Height());
+  EXPECT_EQ(8u * 4u * 3u, image.MemorySize());
+  EXPECT_EQ(8u * 3u, image.RowPitch());
+  EXPECT_NE(nullptr, image.Data());
+
+  Image empty;
+  EXPECT_EQ(0u, empty.RowPitch());
+  EXPECT_EQ(nullptr, empty.Data());
+}
+
+/////////////////////////////////////////////////
+TEST(ImageTest, ExternalMemory)
+{
+  std::vector<unsigned char> buffer(32u * 4u);
+  unsigned int deleted = 0u;
+  {
+    Image image(8, 4, PF_R8G8B8, buffer.data(),
+        [&](void *_data)
+        {
+          EXPECT_EQ(buffer.data(), _data);
+          ++deleted;
+        }, 32u);
+    EXPECT_EQ(buffer.data(), image.Data());
+    EXPECT_EQ(32u, image.RowPitch());
+    EXPECT_EQ(8u * 4u * 3u, image.MemorySize());
+
+    // copies share the memory, moves hand it over
+    Image copy = image;
+    EXPECT_EQ(buffer.data(), copy.Data());
+    EXPECT_EQ(32u, copy.RowPitch());
+    Image moved = std::move(copy);
+    EXPECT_EQ(buffer.data(), moved.Data());
+    EXPECT_EQ(nullptr, copy.Data());  // NOLINT(bugprone-use-after-move)
+    EXPECT_EQ(0u, deleted);
+  }
+  EXPECT_EQ(1u, deleted);
+
+  // no deleter, the memory stays with the caller
+  {
+    Image image(8, 4, PF_L8, buffer.data(), nullptr);
+    EXPECT_EQ(8u, image.RowPitch());
+  }
+
+  // a pitch smaller than a row is ignored
+  Image image(8, 4, PF_L16, buffer.data(), nullptr, 8u);
+  EXPECT_EQ(16u, image.RowPitch());
+}
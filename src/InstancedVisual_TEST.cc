@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/rendering/InstancedVisual.hh"
+#include "ignition/rendering/Material.hh"
+#include "ignition/rendering/MeshDescriptor.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+class InstancedVisualTest : public testing::Test,
+                            public testing::WithParamInterface<const char *>
+{
+  public: void InstancedVisual(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+void InstancedVisualTest::InstancedVisual(const std::string &_renderEngine)
+{
+  if (_renderEngine == "optix")
+  {
+    igndbg << "InstancedVisual not supported yet in rendering engine: "
+            << _renderEngine << std::endl;
+    return;
+  }
+
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+           << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  VisualPtr root = scene->RootVisual();
+
+  MaterialPtr material = scene->CreateMaterial();
+  material->SetDiffuse(math::Color::Red);
+
+  // check instanced visual creation
+  InstancedVisualPtr visual = scene->CreateInstancedVisual(
+      MeshDescriptor("unit_box"), material, 3u);
+  ASSERT_NE(nullptr, visual);
+  root->AddChild(visual);
+  EXPECT_EQ(3u, visual->InstanceCount());
+  EXPECT_EQ(material, visual->Material());
+
+  // check defaults
+  for (unsigned int i = 0; i < visual->InstanceCount(); ++i)
+  {
+    EXPECT_EQ(math::Pose3d::Zero, visual->InstancePose(i));
+    EXPECT_EQ(math::Vector3d::One, visual->InstanceScale(i));
+    EXPECT_EQ(math::Color::Red, visual->InstanceColor(i));
+    EXPECT_TRUE(visual->InstanceVisible(i));
+  }
+
+  // check API
+  math::Pose3d pose(1, 2, 3, 0, 0, 1.57);
+  visual->SetInstancePose(1u, pose);
+  EXPECT_EQ(pose, visual->InstancePose(1u));
+  EXPECT_EQ(math::Pose3d::Zero, visual->InstancePose(0u));
+
+  visual->SetInstanceScale(1u, math::Vector3d(2, 3, 4));
+  EXPECT_EQ(math::Vector3d(2, 3, 4), visual->InstanceScale(1u));
+
+  visual->SetInstanceColor(2u, math::Color::Blue);
+  EXPECT_EQ(math::Color::Blue, visual->InstanceColor(2u));
+  EXPECT_EQ(math::Color::Red, visual->InstanceColor(1u));
+
+  visual->SetInstanceVisible(0u, false);
+  EXPECT_FALSE(visual->InstanceVisible(0u));
+
+  // animations are stored even if the mesh has no skeleton
+  EXPECT_TRUE(visual->InstanceAnimation(0u).empty());
+  visual->SetInstanceAnimation(0u, "walk", std::chrono::milliseconds(250));
+  EXPECT_EQ("walk", visual->InstanceAnimation(0u));
+  EXPECT_EQ(std::chrono::milliseconds(250),
+      visual->InstanceAnimationTimeOffset(0u));
+  EXPECT_EQ(16u, visual->AnimationPhaseCount());
+  visual->SetAnimationPhaseCount(0u);
+  EXPECT_EQ(1u, visual->AnimationPhaseCount());
+  visual->SetAnimationPhaseCount(8u);
+  EXPECT_EQ(8u, visual->AnimationPhaseCount());
+  visual->UpdateAnimations(std::chrono::seconds(1));
+  visual->PreRender();
+  visual->SetInstanceAnimation(0u, "");
+  EXPECT_TRUE(visual->InstanceAnimation(0u).empty());
+
+  // out of range instances are ignored
+  visual->SetInstanceAnimation(3u, "walk");
+  EXPECT_TRUE(visual->InstanceAnimation(3u).empty());
+  visual->SetInstancePose(3u, pose);
+  EXPECT_EQ(math::Pose3d::Zero, visual->InstancePose(3u));
+  EXPECT_EQ(math::Vector3d::One, visual->InstanceScale(3u));
+  EXPECT_FALSE(visual->InstanceVisible(3u));
+
+  // visual without material
+  InstancedVisualPtr plain = scene->CreateInstancedVisual(
+      MeshDescriptor("unit_sphere"), nullptr, 2u);
+  ASSERT_NE(nullptr, plain);
+  EXPECT_EQ(2u, plain->InstanceCount());
+  EXPECT_EQ(math::Color::White, plain->InstanceColor(0u));
+
+  // invalid mesh
+  EXPECT_EQ(nullptr, scene->CreateInstancedVisual(
+      MeshDescriptor("not_a_mesh"), material, 2u));
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(InstancedVisualTest, InstancedVisual)
+{
+  InstancedVisual(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(InstancedVisual, InstancedVisualTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -109,6 +109,14 @@ void MarkerTest::Marker(const std::string &_renderEngine)
   EXPECT_NO_THROW(marker->SetPoint(0, math::Vector3d(3, 1, 2)));
   EXPECT_NO_THROW(marker->ClearPoints());
 
+  // exercise bulk point api
+  const float xyz[] = {0, 1, 2, 3, 4, 5};
+  const uint8_t rgba[] = {255, 0, 0, 255, 0, 255, 0, 255};
+  EXPECT_NO_THROW(marker->SetPoints(xyz, rgba, 2u));
+  EXPECT_NO_THROW(marker->SetPoints(xyz, nullptr, 2u));
+  EXPECT_NO_THROW(marker->SetPoints(nullptr, nullptr, 0u));
+  EXPECT_NO_THROW(marker->ClearPoints());
+
   EXPECT_DOUBLE_EQ(1.0, marker->Size());
   marker->SetSize(3.0);
   EXPECT_DOUBLE_EQ(3.0, marker->Size());
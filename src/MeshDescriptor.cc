@@ -20,6 +20,7 @@
 #include <ignition/common/MeshManager.hh>
 
 #include "ignition/rendering/MeshDescriptor.hh"
+#include "ignition/rendering/Utils.hh"
 
 using namespace ignition;
 using namespace rendering;
@@ -50,6 +51,7 @@ void MeshDescriptor::Load()
   }
   else if (!this->meshName.empty())
   {
+    std::lock_guard<std::recursive_mutex> lock(meshManagerMutex());
     this->mesh = common::MeshManager::Instance()->MeshByName(this->meshName);
     if (!this->mesh)
     {
@@ -18,11 +18,14 @@
 #include <gtest/gtest.h>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <ignition/common/Console.hh>
+#include <ignition/common/Mesh.hh>
 #include <ignition/common/MeshManager.hh>
 #include <ignition/common/Skeleton.hh>
 #include <ignition/common/SkeletonAnimation.hh>
+#include <ignition/common/SubMesh.hh>
 
 #include "test_config.h"  // NOLINT(build/include)
 #include "ignition/rendering/Camera.hh"
@@ -30,6 +33,7 @@
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderingIface.hh"
 #include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
 
 using namespace ignition;
 using namespace rendering;
@@ -46,6 +50,12 @@ class MeshTest : public testing::Test,
   /// \brief Test mesh clone API
   public: void MeshClone(const std::string &_renderEngine);
 
+  /// \brief Test meshes shared by the scenes of an engine
+  public: void MeshSharedAcrossScenes(const std::string &_renderEngine);
+
+  /// \brief Test updating the vertices of a mesh in place
+  public: void MeshUpdateVertices(const std::string &_renderEngine);
+
   public: const std::string TEST_MEDIA_PATH =
         common::joinPaths(std::string(PROJECT_SOURCE_PATH),
         "test", "media", "meshes");
@@ -195,6 +205,47 @@ void MeshTest::MeshSkeletonAnimation(const std::string &_renderEngine)
     }
   }
 
+  // set the bone transforms by index
+  std::vector<std::string> boneNames = mesh->SkeletonBoneNames();
+  EXPECT_EQ(skel->NodeCount(), boneNames.size());
+  EXPECT_TRUE(boxMesh->SkeletonBoneNames().empty());
+
+  std::vector<math::Matrix4d> boneTfs;
+  for (unsigned int i = 0; i < boneNames.size(); ++i)
+  {
+    math::Matrix4d tf(math::Quaterniond::Identity);
+    tf.SetTranslation(math::Vector3d(0.0, 0.0, i * 0.1));
+    boneTfs.push_back(tf);
+  }
+  mesh->SetSkeletonBoneTransforms(boneTfs);
+  auto localTfs = mesh->SkeletonLocalTransforms();
+  for (unsigned int i = 0; i < boneNames.size(); ++i)
+  {
+    ASSERT_EQ(1u, localTfs.count(boneNames[i]));
+    EXPECT_EQ(boneTfs[i].Translation(),
+        localTfs[boneNames[i]].Translation());
+  }
+
+  // setting the same bones by name again gives the same result
+  mesh->SetSkeletonLocalTransforms(localTfs);
+  mesh->SetSkeletonLocalTransforms(localTfs);
+  EXPECT_EQ(localTfs.size(), mesh->SkeletonLocalTransforms().size());
+
+  // share the skeleton between meshes
+  MeshPtr mesh2 = scene->CreateMesh(descriptor);
+  ASSERT_NE(nullptr, mesh2);
+  EXPECT_FALSE(mesh2->ShareSkeleton(boxMesh));
+  EXPECT_FALSE(boxMesh->ShareSkeleton(mesh));
+  if (_renderEngine == "ogre2")
+  {
+    EXPECT_TRUE(mesh2->ShareSkeleton(mesh));
+    EXPECT_TRUE(mesh2->SkeletonAnimationEnabled(animName));
+    mesh->UpdateSkeletonAnimation(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(0.5)));
+    EXPECT_TRUE(mesh2->ShareSkeleton(nullptr));
+  }
+
   // Clean up
   engine->DestroyScene(scene);
   rendering::unloadEngine(engine->Name());
@@ -291,6 +342,127 @@ TEST_P(MeshTest, MeshClone)
   MeshClone(GetParam());
 }
 
+/////////////////////////////////////////////////
+void MeshTest::MeshSharedAcrossScenes(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+  ScenePtr scene2 = engine->CreateScene("scene2");
+  ASSERT_TRUE(scene2 != nullptr);
+
+  MeshDescriptor descriptor("unit_box");
+  MeshPtr mesh = scene->CreateMesh(descriptor);
+  ASSERT_TRUE(mesh != nullptr);
+  MeshPtr mesh2 = scene2->CreateMesh(descriptor);
+  ASSERT_TRUE(mesh2 != nullptr);
+
+  // each scene uses its own submesh materials
+  ASSERT_EQ(1u, mesh2->SubMeshCount());
+  MaterialPtr mat2 = mesh2->SubMeshByIndex(0u)->Material();
+  ASSERT_TRUE(mat2 != nullptr);
+  EXPECT_EQ(mat2, scene2->Material(mat2->Name()));
+
+  // the mesh is kept for the other scene when the scene that loaded it is
+  // destroyed
+  engine->DestroyScene(scene);
+  MeshPtr mesh3 = scene2->CreateMesh(descriptor);
+  ASSERT_TRUE(mesh3 != nullptr);
+  EXPECT_EQ(1u, mesh3->SubMeshCount());
+  EXPECT_TRUE(mesh3->SubMeshByIndex(0u)->Material() != nullptr);
+
+  // Clean up
+  engine->DestroyScene(scene2);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(MeshTest, MeshSharedAcrossScenes)
+{
+  MeshSharedAcrossScenes(GetParam());
+}
+
+/////////////////////////////////////////////////
+void MeshTest::MeshUpdateVertices(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  MeshDescriptor descriptor("unit_box");
+  MeshPtr mesh = scene->CreateMesh(descriptor);
+  ASSERT_TRUE(mesh != nullptr);
+  VisualPtr visual = scene->CreateVisual();
+  visual->AddGeometry(mesh);
+  scene->RootVisual()->AddChild(visual);
+
+  const common::Mesh *commonMesh =
+      common::MeshManager::Instance()->MeshByName("unit_box");
+  ASSERT_NE(nullptr, commonMesh);
+  unsigned int vertexCount = commonMesh->VertexCount();
+  ASSERT_GT(vertexCount, 0u);
+
+  // scale the box up
+  std::vector<float> positions;
+  for (unsigned int i = 0; i < commonMesh->SubMeshCount(); ++i)
+  {
+    auto subMesh = commonMesh->SubMeshByIndex(i).lock();
+    for (unsigned int j = 0; j < subMesh->VertexCount(); ++j)
+    {
+      math::Vector3d v = subMesh->Vertex(j) * 2.0;
+      positions.push_back(static_cast<float>(v.X()));
+      positions.push_back(static_cast<float>(v.Y()));
+      positions.push_back(static_cast<float>(v.Z()));
+    }
+  }
+
+  // the vertex count must match
+  EXPECT_FALSE(mesh->UpdateVertices(positions.data(), nullptr,
+      vertexCount - 1u));
+
+  if (_renderEngine == "ogre2")
+  {
+    EXPECT_TRUE(mesh->UpdateVertices(positions.data(), nullptr,
+        vertexCount));
+    EXPECT_EQ(1u, mesh->SubMeshCount());
+    EXPECT_TRUE(mesh->SubMeshByIndex(0u)->Material() != nullptr);
+    EXPECT_EQ(math::Vector3d(2, 2, 2), visual->LocalBoundingBox().Size());
+
+    // updating again reuses the same buffers
+    EXPECT_TRUE(mesh->UpdateVertices(positions.data(), nullptr,
+        vertexCount));
+  }
+  else
+  {
+    EXPECT_FALSE(mesh->UpdateVertices(positions.data(), nullptr,
+        vertexCount));
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(MeshTest, MeshUpdateVertices)
+{
+  MeshUpdateVertices(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(Mesh, MeshTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
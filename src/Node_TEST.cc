@@ -36,6 +36,9 @@ class NodeTest : public testing::Test,
 {
   /// \brief Test visual material
   public: void Pose(const std::string &_renderEngine);
+
+  /// \brief Test world poses of nested nodes after they move
+  public: void WorldPose(const std::string &_renderEngine);
 };
 
 /////////////////////////////////////////////////
@@ -130,6 +133,72 @@ TEST_P(NodeTest, Pose)
   Pose(GetParam());
 }
 
+/////////////////////////////////////////////////
+void NodeTest::WorldPose(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+
+  NodePtr parent = scene->CreateVisual();
+  NodePtr child = scene->CreateVisual();
+  NodePtr grandChild = scene->CreateVisual();
+  ASSERT_NE(nullptr, parent);
+  ASSERT_NE(nullptr, child);
+  ASSERT_NE(nullptr, grandChild);
+  parent->AddChild(child);
+  child->AddChild(grandChild);
+
+  math::Pose3d parentPose(1, 2, 3, 0, 0, 1.57);
+  math::Pose3d childPose(1, 0, 0, 0, 0.5, 0);
+  math::Pose3d grandChildPose(0, 0, 2, 0.3, 0, 0);
+  parent->SetLocalPose(parentPose);
+  child->SetLocalPose(childPose);
+  grandChild->SetLocalPose(grandChildPose);
+  EXPECT_EQ(grandChildPose + childPose + parentPose, grandChild->WorldPose());
+
+  // moving an ancestor moves the descendants whose world poses were read
+  math::Pose3d newParentPose(-1, 0, 0.5, 0.1, 0, 0);
+  parent->SetLocalPose(newParentPose);
+  EXPECT_EQ(childPose + newParentPose, child->WorldPose());
+  EXPECT_EQ(grandChildPose + childPose + newParentPose,
+      grandChild->WorldPose());
+
+  math::Pose3d newChildPose(0, 3, 0, 0, 0, 0.2);
+  child->SetLocalPose(newChildPose);
+  EXPECT_EQ(newParentPose, parent->WorldPose());
+  EXPECT_EQ(grandChildPose + newChildPose + newParentPose,
+      grandChild->WorldPose());
+
+  // changing the origin changes the local pose
+  child->SetOrigin(math::Vector3d(0, 0, 1));
+  EXPECT_EQ(grandChild->LocalPose() + child->LocalPose() + newParentPose,
+      grandChild->WorldPose());
+
+  // reparented nodes follow their new parent
+  parent->RemoveChild(child);
+  EXPECT_EQ(grandChildPose + child->LocalPose(), grandChild->WorldPose());
+  parent->AddChild(child);
+  EXPECT_EQ(grandChildPose + child->LocalPose() + newParentPose,
+      grandChild->WorldPose());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(NodeTest, WorldPose)
+{
+  WorldPose(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(Node, NodeTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
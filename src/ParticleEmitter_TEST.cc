@@ -160,6 +160,42 @@ void ParticleEmitterTest::CheckBasicAPI()
   EXPECT_EQ(expectedColorRangeImage,  particleEmitter->ColorRangeImage());
   EXPECT_FLOAT_EQ(expectedScatterRatio,
       particleEmitter->ParticleScatterRatio());
+
+  // GPU simulation keeps all parameters and can be switched off again
+  EXPECT_FALSE(particleEmitter->GpuSimulationEnabled());
+  if (this->engine->Name() == "ogre2")
+  {
+    particleEmitter->SetGpuSimulationEnabled(true);
+    EXPECT_TRUE(particleEmitter->GpuSimulationEnabled());
+    particleEmitter->SetType(EmitterType::EM_CYLINDER);
+    particleEmitter->SetRate(1000.0);
+    particleEmitter->SetParticleSize({2, 2, 2});
+    EXPECT_EQ(EmitterType::EM_CYLINDER, particleEmitter->Type());
+    EXPECT_DOUBLE_EQ(1000.0, particleEmitter->Rate());
+    EXPECT_EQ(math::Vector3d(2, 2, 2), particleEmitter->ParticleSize());
+    EXPECT_EQ(expectedEmitterSize, particleEmitter->EmitterSize());
+    this->scene->PreRender();
+    this->scene->PostRender();
+
+    particleEmitter->SetGpuSimulationEnabled(false);
+    EXPECT_FALSE(particleEmitter->GpuSimulationEnabled());
+    EXPECT_EQ(EmitterType::EM_CYLINDER, particleEmitter->Type());
+    EXPECT_EQ(expectedEmitterSize, particleEmitter->EmitterSize());
+
+    // emitters of the same material share their render state, which
+    // outlives any one of them
+    MaterialPtr material = this->scene->CreateMaterial();
+    ParticleEmitterPtr other = this->scene->CreateParticleEmitter();
+    particleEmitter->SetMaterial(material);
+    other->SetMaterial(material);
+    other->SetGpuSimulationEnabled(true);
+    this->scene->PreRender();
+    this->scene->PostRender();
+    this->scene->DestroyVisual(other);
+    EXPECT_EQ(material, particleEmitter->Material());
+    this->scene->PreRender();
+    this->scene->PostRender();
+  }
 }
 
 /////////////////////////////////////////////////
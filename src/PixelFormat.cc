@@ -15,6 +15,8 @@
  *
  */
 
+#include <cstring>
+
 #include <ignition/common/Console.hh>
 
 #include "ignition/rendering/PixelFormat.hh"
@@ -22,6 +24,92 @@
 using namespace ignition;
 using namespace rendering;
 
+namespace
+{
+  /// \brief Index of the red, green, blue and alpha channels of an 8 bit
+  /// pixel format, -1 for missing channels.
+  /// \param[in] _format Pixel format
+  /// \param[out] _channels Channel indices
+  /// \return False if the format is not an 8 bit color format
+  bool ChannelIndices(PixelFormat _format, int _channels[4])
+  {
+    switch (_format)
+    {
+      case PF_L8:
+        _channels[0] = 0; _channels[1] = 0; _channels[2] = 0;
+        _channels[3] = -1;
+        return true;
+      case PF_R8G8B8:
+        _channels[0] = 0; _channels[1] = 1; _channels[2] = 2;
+        _channels[3] = -1;
+        return true;
+      case PF_B8G8R8:
+        _channels[0] = 2; _channels[1] = 1; _channels[2] = 0;
+        _channels[3] = -1;
+        return true;
+      case PF_R8G8B8A8:
+        _channels[0] = 0; _channels[1] = 1; _channels[2] = 2;
+        _channels[3] = 3;
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  /// \brief Reorder the channels of a row of 8 bit pixels. The channel
+  /// counts are template parameters so the compiler can unroll and
+  /// vectorize the loop.
+  /// \param[in] _src Source row
+  /// \param[out] _dst Destination row
+  /// \param[in] _width Number of pixels in the row
+  /// \param[in] _map Source channel of each destination channel, -1 to
+  /// write 255
+  template <unsigned int SrcChannels, unsigned int DstChannels>
+  void SwizzleRow(const unsigned char *_src, unsigned char *_dst,
+      unsigned int _width, const int _map[4])
+  {
+    for (unsigned int i = 0; i < _width; ++i)
+    {
+      const unsigned char *s = _src + i * SrcChannels;
+      unsigned char *d = _dst + i * DstChannels;
+      for (unsigned int c = 0; c < DstChannels; ++c)
+        d[c] = _map[c] < 0 ? 255u : s[_map[c]];
+    }
+  }
+
+  /// \brief Function type of the SwizzleRow instances
+  using SwizzleRowFunc = void (*)(const unsigned char *, unsigned char *,
+      unsigned int, const int[4]);
+
+  /// \brief Get the SwizzleRow instance for the given channel counts
+  /// \param[in] _srcChannels Number of source channels, 1, 3 or 4
+  /// \param[in] _dstChannels Number of destination channels, 3 or 4
+  /// \return The row function, null for other channel counts
+  SwizzleRowFunc SwizzleRowFor(unsigned int _srcChannels,
+      unsigned int _dstChannels)
+  {
+    if (_dstChannels == 3u)
+    {
+      if (_srcChannels == 1u)
+        return &SwizzleRow<1, 3>;
+      if (_srcChannels == 3u)
+        return &SwizzleRow<3, 3>;
+      if (_srcChannels == 4u)
+        return &SwizzleRow<4, 3>;
+    }
+    else if (_dstChannels == 4u)
+    {
+      if (_srcChannels == 1u)
+        return &SwizzleRow<1, 4>;
+      if (_srcChannels == 3u)
+        return &SwizzleRow<3, 4>;
+      if (_srcChannels == 4u)
+        return &SwizzleRow<4, 4>;
+    }
+    return nullptr;
+  }
+}
+
 //////////////////////////////////////////////////
 const char *PixelUtil::names[PF_COUNT] =
     {
@@ -37,7 +125,10 @@ const char *PixelUtil::names[PF_COUNT] =
       "FLOAT32_RGBA",
       "FLOAT32_RGB",
       "L16",
-      "R8G8B8A8"
+      "R8G8B8A8",
+      "FLOAT16_R",
+      "FLOAT16_RGB",
+      "UINT16_RGB"
     };
 
 //////////////////////////////////////////////////
@@ -68,7 +159,13 @@ const unsigned char PixelUtil::channelCounts[PF_COUNT] =
       // PF_L16
       1,
       // PG_R8G8B8A8
-      4
+      4,
+      // PF_FLOAT16_R
+      1,
+      // PF_FLOAT16_RGB
+      3,
+      // PF_UINT16_RGB
+      3
     };
 
 //////////////////////////////////////////////////
@@ -99,7 +196,13 @@ const unsigned char PixelUtil::channelByteCounts[PF_COUNT] =
       // PF_L16
       2,
       // PF_R8G8B8A8
-      1
+      1,
+      // PF_FLOAT16_R
+      2,
+      // PF_FLOAT16_RGB
+      2,
+      // PF_UINT16_RGB
+      2
     };
 
 //////////////////////////////////////////////////
@@ -177,3 +280,162 @@ PixelFormat PixelUtil::Enum(const std::string &_name)
   // no match found
   return PF_UNKNOWN;
 }
+
+//////////////////////////////////////////////////
+bool PixelUtil::Convert(const unsigned char *_src, PixelFormat _srcFormat,
+    unsigned char *_dst, PixelFormat _dstFormat, unsigned int _width,
+    unsigned int _height, unsigned int _srcPitch)
+{
+  if (!_src || !_dst)
+    return false;
+
+  _srcFormat = PixelUtil::Sanitize(_srcFormat);
+  _dstFormat = PixelUtil::Sanitize(_dstFormat);
+  if (_srcFormat == PF_UNKNOWN || _dstFormat == PF_UNKNOWN)
+    return false;
+
+  unsigned int srcRowBytes = _width * PixelUtil::BytesPerPixel(_srcFormat);
+  unsigned int dstRowBytes = _width * PixelUtil::BytesPerPixel(_dstFormat);
+  if (_srcPitch == 0u)
+    _srcPitch = srcRowBytes;
+  if (_srcPitch < srcRowBytes)
+  {
+    ignerr << "Source pitch " << _srcPitch << " is smaller than a row of "
+           << _width << " " << PixelUtil::Name(_srcFormat) << " pixels"
+           << std::endl;
+    return false;
+  }
+
+  if (_srcFormat == _dstFormat)
+  {
+    if (_srcPitch == dstRowBytes)
+    {
+      std::memcpy(_dst, _src, static_cast<std::size_t>(dstRowBytes) * _height);
+      return true;
+    }
+    for (unsigned int y = 0; y < _height; ++y)
+    {
+      std::memcpy(_dst + static_cast<std::size_t>(y) * dstRowBytes,
+          _src + static_cast<std::size_t>(y) * _srcPitch, dstRowBytes);
+    }
+    return true;
+  }
+
+  int srcChannels[4];
+  int dstChannels[4];
+  SwizzleRowFunc swizzleRow = nullptr;
+  if (ChannelIndices(_srcFormat, srcChannels) &&
+      ChannelIndices(_dstFormat, dstChannels))
+  {
+    swizzleRow = SwizzleRowFor(PixelUtil::ChannelCount(_srcFormat),
+        PixelUtil::ChannelCount(_dstFormat));
+  }
+  if (!swizzleRow)
+  {
+    ignerr << "Unsupported pixel format conversion from "
+           << PixelUtil::Name(_srcFormat) << " to "
+           << PixelUtil::Name(_dstFormat) << std::endl;
+    return false;
+  }
+
+  // source channel of each destination channel
+  int map[4] = {-1, -1, -1, -1};
+  for (unsigned int c = 0; c < 4u; ++c)
+  {
+    if (dstChannels[c] >= 0)
+      map[dstChannels[c]] = srcChannels[c];
+  }
+
+  for (unsigned int y = 0; y < _height; ++y)
+  {
+    swizzleRow(_src + static_cast<std::size_t>(y) * _srcPitch,
+        _dst + static_cast<std::size_t>(y) * dstRowBytes, _width, map);
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool PixelUtil::ConvertToI420(const unsigned char *_src,
+    PixelFormat _srcFormat, unsigned char *_dst, unsigned int _width,
+    unsigned int _height, unsigned int _srcPitch)
+{
+  if (!_src || !_dst)
+    return false;
+
+  int channels[4];
+  if (_srcFormat == PF_L8 || !ChannelIndices(_srcFormat, channels))
+  {
+    ignerr << "Unsupported pixel format conversion from "
+           << PixelUtil::Name(_srcFormat) << " to I420" << std::endl;
+    return false;
+  }
+
+  if (_width % 2u != 0u || _height % 2u != 0u)
+  {
+    ignerr << "I420 images must have an even width and height" << std::endl;
+    return false;
+  }
+
+  unsigned int bytesPerPixel = PixelUtil::BytesPerPixel(_srcFormat);
+  if (_srcPitch == 0u)
+    _srcPitch = _width * bytesPerPixel;
+  if (_srcPitch < _width * bytesPerPixel)
+  {
+    ignerr << "Source pitch " << _srcPitch << " is smaller than a row of "
+           << _width << " " << PixelUtil::Name(_srcFormat) << " pixels"
+           << std::endl;
+    return false;
+  }
+
+  const int r = channels[0];
+  const int g = channels[1];
+  const int b = channels[2];
+  const std::size_t ySize = static_cast<std::size_t>(_width) * _height;
+  unsigned char *uPlane = _dst + ySize;
+  unsigned char *vPlane = uPlane + ySize / 4u;
+
+  // integer BT.601 limited range approximation, see also rgb_to_i420_fs
+  for (unsigned int y = 0; y < _height; ++y)
+  {
+    const unsigned char *row = _src + static_cast<std::size_t>(y) * _srcPitch;
+    unsigned char *yRow = _dst + static_cast<std::size_t>(y) * _width;
+    for (unsigned int x = 0; x < _width; ++x)
+    {
+      const unsigned char *p = row + x * bytesPerPixel;
+      yRow[x] = static_cast<unsigned char>(
+          ((66 * p[r] + 129 * p[g] + 25 * p[b] + 128) >> 8) + 16);
+    }
+  }
+
+  const unsigned int chromaWidth = _width / 2u;
+  for (unsigned int y = 0; y < _height / 2u; ++y)
+  {
+    const unsigned char *row0 =
+        _src + static_cast<std::size_t>(2u * y) * _srcPitch;
+    const unsigned char *row1 = row0 + _srcPitch;
+    unsigned char *uRow = uPlane + static_cast<std::size_t>(y) * chromaWidth;
+    unsigned char *vRow = vPlane + static_cast<std::size_t>(y) * chromaWidth;
+    for (unsigned int x = 0; x < chromaWidth; ++x)
+    {
+      const unsigned char *p0 = row0 + 2u * x * bytesPerPixel;
+      const unsigned char *p1 = row1 + 2u * x * bytesPerPixel;
+      const unsigned char *p2 = p0 + bytesPerPixel;
+      const unsigned char *p3 = p1 + bytesPerPixel;
+      int red = (p0[r] + p1[r] + p2[r] + p3[r] + 2) >> 2;
+      int green = (p0[g] + p1[g] + p2[g] + p3[g] + 2) >> 2;
+      int blue = (p0[b] + p1[b] + p2[b] + p3[b] + 2) >> 2;
+      uRow[x] = static_cast<unsigned char>(
+          ((-38 * red - 74 * green + 112 * blue + 128) >> 8) + 128);
+      vRow[x] = static_cast<unsigned char>(
+          ((112 * red - 94 * green - 18 * blue + 128) >> 8) + 128);
+    }
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+unsigned int PixelUtil::I420MemorySize(unsigned int _width,
+    unsigned int _height)
+{
+  return _width * _height * 3u / 2u;
+}
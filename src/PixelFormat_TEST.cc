@@ -56,6 +56,103 @@ TEST(PixelFormatTest, PixelUtil)
   EXPECT_EQ(4u, PixelUtil::BytesPerPixel(format));
   EXPECT_EQ(1u, PixelUtil::BytesPerChannel(format));
   EXPECT_EQ(4096u, PixelUtil::MemorySize(format, 32, 32));
+
+  format = PF_FLOAT16_R;
+  EXPECT_EQ(2u, PixelUtil::BytesPerPixel(format));
+  EXPECT_EQ(2u, PixelUtil::BytesPerChannel(format));
+  EXPECT_EQ(2048u, PixelUtil::MemorySize(format, 32, 32));
+  EXPECT_EQ(format, PixelUtil::Enum("FLOAT16_R"));
+
+  format = PF_FLOAT16_RGB;
+  EXPECT_EQ(6u, PixelUtil::BytesPerPixel(format));
+  EXPECT_EQ(2u, PixelUtil::BytesPerChannel(format));
+  EXPECT_EQ(6144u, PixelUtil::MemorySize(format, 32, 32));
+  EXPECT_EQ(format, PixelUtil::Enum("FLOAT16_RGB"));
+
+  format = PF_UINT16_RGB;
+  EXPECT_EQ(6u, PixelUtil::BytesPerPixel(format));
+  EXPECT_EQ(2u, PixelUtil::BytesPerChannel(format));
+  EXPECT_EQ(6144u, PixelUtil::MemorySize(format, 32, 32));
+  EXPECT_EQ(format, PixelUtil::Enum("UINT16_RGB"));
+}
+
+/////////////////////////////////////////////////
+TEST(PixelFormatTest, Convert)
+{
+  // 2x2 grayscale image with rows padded to 3 bytes
+  const unsigned char gray[] = {10, 20, 0, 30, 40, 0};
+  unsigned char rgba[16];
+  EXPECT_TRUE(PixelUtil::Convert(gray, PF_L8, rgba, PF_R8G8B8A8, 2, 2, 3));
+  const unsigned char expectedRgba[] =
+      {10, 10, 10, 255, 20, 20, 20, 255, 30, 30, 30, 255, 40, 40, 40, 255};
+  for (unsigned int i = 0; i < 16u; ++i)
+    EXPECT_EQ(expectedRgba[i], rgba[i]);
+
+  const unsigned char color[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  unsigned char bgr[6];
+  EXPECT_TRUE(PixelUtil::Convert(color, PF_R8G8B8A8, bgr, PF_B8G8R8, 2, 1));
+  const unsigned char expectedBgr[] = {3, 2, 1, 7, 6, 5};
+  for (unsigned int i = 0; i < 6u; ++i)
+    EXPECT_EQ(expectedBgr[i], bgr[i]);
+
+  unsigned char rgb[6];
+  EXPECT_TRUE(PixelUtil::Convert(bgr, PF_B8G8R8, rgb, PF_R8G8B8, 2, 1));
+  const unsigned char expectedRgb[] = {1, 2, 3, 5, 6, 7};
+  for (unsigned int i = 0; i < 6u; ++i)
+    EXPECT_EQ(expectedRgb[i], rgb[i]);
+
+  // same format with padded rows
+  const float depth[] = {1.5f, 2.5f, 0.0f, 3.5f, 4.5f, 0.0f};
+  float depthCopy[4];
+  EXPECT_TRUE(PixelUtil::Convert(
+      reinterpret_cast<const unsigned char *>(depth), PF_FLOAT32_R,
+      reinterpret_cast<unsigned char *>(depthCopy), PF_FLOAT32_R, 2, 2,
+      3 * sizeof(float)));
+  EXPECT_FLOAT_EQ(1.5f, depthCopy[0]);
+  EXPECT_FLOAT_EQ(2.5f, depthCopy[1]);
+  EXPECT_FLOAT_EQ(3.5f, depthCopy[2]);
+  EXPECT_FLOAT_EQ(4.5f, depthCopy[3]);
+
+  // unsupported conversions and invalid arguments
+  unsigned char out[16];
+  EXPECT_FALSE(PixelUtil::Convert(color, PF_R8G8B8A8, out, PF_L8, 2, 1));
+  EXPECT_FALSE(PixelUtil::Convert(color, PF_R8G8B8, out, PF_FLOAT32_R, 1, 1));
+  EXPECT_FALSE(PixelUtil::Convert(color, PF_R8G8B8, out, PF_R8G8B8A8, 2, 1,
+      3));
+  EXPECT_FALSE(PixelUtil::Convert(nullptr, PF_R8G8B8, out, PF_R8G8B8, 1, 1));
+}
+
+/////////////////////////////////////////////////
+TEST(PixelFormatTest, ConvertToI420)
+{
+  // 2x2 blocks of white, black, red and blue in a 4x2 BGR image
+  const unsigned char bgr[] =
+      {255, 255, 255,  255, 255, 255,  0, 0, 255,  0, 0, 255,
+       0, 0, 0,        0, 0, 0,        0, 0, 255,  0, 0, 255};
+  EXPECT_EQ(12u, PixelUtil::I420MemorySize(4, 2));
+  unsigned char yuv[12];
+  EXPECT_TRUE(PixelUtil::ConvertToI420(bgr, PF_B8G8R8, yuv, 4, 2));
+
+  // Y plane, limited range
+  EXPECT_EQ(235u, yuv[0]);
+  EXPECT_EQ(235u, yuv[1]);
+  EXPECT_EQ(82u, yuv[2]);
+  EXPECT_EQ(82u, yuv[3]);
+  EXPECT_EQ(16u, yuv[4]);
+  EXPECT_EQ(16u, yuv[5]);
+  EXPECT_EQ(82u, yuv[6]);
+  EXPECT_EQ(82u, yuv[7]);
+
+  // U and V of the gray and red blocks
+  EXPECT_EQ(128u, yuv[8]);
+  EXPECT_EQ(90u, yuv[9]);
+  EXPECT_EQ(128u, yuv[10]);
+  EXPECT_EQ(240u, yuv[11]);
+
+  // odd sizes and formats without color are rejected
+  EXPECT_FALSE(PixelUtil::ConvertToI420(bgr, PF_B8G8R8, yuv, 3, 2));
+  EXPECT_FALSE(PixelUtil::ConvertToI420(bgr, PF_L8, yuv, 4, 2));
+  EXPECT_FALSE(PixelUtil::ConvertToI420(bgr, PF_FLOAT32_R, yuv, 4, 2));
 }
 
 int main(int argc, char **argv)
@@ -16,6 +16,8 @@
 */
 
 #include <gtest/gtest.h>
+#include <string>
+#include <vector>
 
 #include <ignition/common/Console.hh>
 
@@ -35,6 +37,9 @@ class RayQueryTest : public testing::Test,
 {
   /// \brief Test ray query basic API
   public: void RayQuery(const std::string &_renderEngine);
+
+  /// \brief Test the closest points of a batch of rays
+  public: void ClosestPoints(const std::string &_renderEngine);
 };
 
 /////////////////////////////////////////////////
@@ -100,6 +105,129 @@ void RayQueryTest::RayQuery(const std::string &_renderEngine)
   EXPECT_EQ(0u, result.objectId);
   EXPECT_FALSE((result));
 
+  // batch of rays in an empty scene
+  math::Vector3d prevOrigin = rayQuery->Origin();
+  math::Vector3d prevDirection = rayQuery->Direction();
+  std::vector<math::Line3d> rays;
+  rays.push_back(math::Line3d(o0, o0 + d0));
+  rays.push_back(math::Line3d(o1, o1 + d1));
+  rays.push_back(math::Line3d(o2, o2 + d2));
+  std::vector<RayQueryResult> results = rayQuery->ClosestPoints(rays);
+  ASSERT_EQ(rays.size(), results.size());
+  for (const auto &r : results)
+  {
+    EXPECT_LT(r.distance, 0.0);
+    EXPECT_EQ(0u, r.objectId);
+    EXPECT_FALSE((r));
+  }
+  EXPECT_TRUE(rayQuery->ClosestPoints({}).empty());
+
+  // the ray set on the ray query is not modified by batch queries
+  EXPECT_EQ(prevOrigin, rayQuery->Origin());
+  EXPECT_EQ(prevDirection, rayQuery->Direction());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void RayQueryTest::ClosestPoints(const std::string &_renderEngine)
+{
+  if (_renderEngine == "optix")
+  {
+    igndbg << "RayQuery not supported yet in rendering engine: "
+            << _renderEngine << std::endl;
+    return;
+  }
+
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  VisualPtr root = scene->RootVisual();
+
+  auto createBox = [&](const math::Vector3d &_pos, double _size)
+  {
+    VisualPtr box = scene->CreateVisual();
+    box->AddGeometry(scene->CreateBox());
+    box->SetLocalPosition(_pos);
+    box->SetLocalScale(_size, _size, _size);
+    root->AddChild(box);
+    return box;
+  };
+
+  // boxes around the origin, one behind the other along the x axis
+  VisualPtr nearBox = createBox(math::Vector3d(3, 0, 0), 1.0);
+  VisualPtr farBox = createBox(math::Vector3d(6, 0, 0), 1.0);
+  VisualPtr sideBox = createBox(math::Vector3d(0, 4, 0), 1.0);
+  VisualPtr belowBox = createBox(math::Vector3d(0, 0, -5), 2.0);
+
+  // render a frame so that the poses of the boxes are up to date
+  CameraPtr camera = scene->CreateCamera("camera");
+  ASSERT_NE(nullptr, camera);
+  root->AddChild(camera);
+  camera->Update();
+
+  // the second point of a ray only sets its direction
+  const math::Vector3d o = math::Vector3d::Zero;
+  std::vector<math::Line3d> rays;
+  rays.push_back(math::Line3d(o, o + math::Vector3d::UnitX));
+  rays.push_back(math::Line3d(o, o + math::Vector3d::UnitY));
+  rays.push_back(math::Line3d(o, o - 0.1 * math::Vector3d::UnitZ));
+  rays.push_back(math::Line3d(o, o - math::Vector3d::UnitX));
+  rays.push_back(math::Line3d(math::Vector3d(10, 0, 0),
+      math::Vector3d(9, 0, 0)));
+
+  RayQueryPtr rayQuery = scene->CreateRayQuery();
+  ASSERT_NE(nullptr, rayQuery);
+  std::vector<RayQueryResult> results = rayQuery->ClosestPoints(rays);
+  ASSERT_EQ(rays.size(), results.size());
+
+  // each ray hits the closest box in its direction, in the order of the
+  // rays
+  const double tol = 1e-3;
+  EXPECT_TRUE((results[0]));
+  EXPECT_EQ(nearBox->Id(), results[0].objectId);
+  EXPECT_NEAR(2.5, results[0].distance, tol);
+  EXPECT_TRUE(results[0].point.Equal(math::Vector3d(2.5, 0, 0), tol));
+
+  EXPECT_TRUE((results[1]));
+  EXPECT_EQ(sideBox->Id(), results[1].objectId);
+  EXPECT_NEAR(3.5, results[1].distance, tol);
+  EXPECT_TRUE(results[1].point.Equal(math::Vector3d(0, 3.5, 0), tol));
+
+  EXPECT_TRUE((results[2]));
+  EXPECT_EQ(belowBox->Id(), results[2].objectId);
+  EXPECT_NEAR(4.0, results[2].distance, tol);
+  EXPECT_TRUE(results[2].point.Equal(math::Vector3d(0, 0, -4), tol));
+
+  // nothing behind the origin
+  EXPECT_FALSE((results[3]));
+  EXPECT_LT(results[3].distance, 0.0);
+  EXPECT_EQ(0u, results[3].objectId);
+
+  // from the other side the far box is the closest
+  EXPECT_TRUE((results[4]));
+  EXPECT_EQ(farBox->Id(), results[4].objectId);
+  EXPECT_NEAR(3.5, results[4].distance, tol);
+  EXPECT_TRUE(results[4].point.Equal(math::Vector3d(6.5, 0, 0), tol));
+
+  // a batch gives the same results as querying the rays one by one
+  for (size_t i = 0u; i < rays.size(); ++i)
+  {
+    rayQuery->SetOrigin(rays[i][0]);
+    rayQuery->SetDirection(rays[i].Direction());
+    RayQueryResult result = rayQuery->ClosestPoint();
+    EXPECT_EQ(results[i].objectId, result.objectId) << i;
+    EXPECT_NEAR(results[i].distance, result.distance, tol) << i;
+  }
+
   // Clean up
   engine->DestroyScene(scene);
   rendering::unloadEngine(engine->Name());
@@ -111,6 +239,12 @@ TEST_P(RayQueryTest, RayQuery)
   RayQuery(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(RayQueryTest, ClosestPoints)
+{
+  ClosestPoints(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(RayQuery, RayQueryTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
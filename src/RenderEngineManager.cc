@@ -15,11 +15,16 @@
  *
  */
 
+#include <fstream>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <sstream>
 
 #include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
 #include <ignition/common/SystemPaths.hh>
+#include <ignition/common/Util.hh>
 
 #include <ignition/plugin/Loader.hh>
 
@@ -27,6 +32,8 @@
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderEngineManager.hh"
 #include "ignition/rendering/RenderEnginePlugin.hh"
+#include "ignition/rendering/RenderThread.hh"
+#include "ignition/rendering/Utils.hh"
 
 /// \brief Holds information about an engine
 struct EngineInfo
@@ -78,6 +85,28 @@ class ignition::rendering::RenderEngineManagerPrivate
   public: bool LoadEnginePlugin(const std::string &_filename,
               const std::string &_path);
 
+  /// \brief Load the plugin of a render engine unless it's loaded already,
+  /// without initializing the engine.
+  /// \param[in] _name Name of the engine or of its shared library
+  /// \param[in] _path Another search path for rendering engine plugin.
+  /// \return True if the plugin is loaded
+  public: bool PreloadEnginePlugin(const std::string &_name,
+              const std::string &_path);
+
+  /// \brief Find the shared library of a render engine plugin, looking it
+  /// up in the plugin manifest before searching the plugin paths.
+  /// \param[in] _filename Filename of plugin shared library
+  /// \param[in] _path Another search path for rendering engine plugin.
+  /// \return Path to the shared library, empty if not found
+  public: std::string FindEngineLibrary(const std::string &_filename,
+              const std::string &_path);
+
+  /// \brief Read the plugin manifest into the library path cache
+  public: void ReadManifest();
+
+  /// \brief Write the library path cache to the plugin manifest
+  public: void WriteManifest() const;
+
   /// \brief Unload a render engine plugin.
   /// \param[in] _engineName Name of engine associated with this plugin
   /// \return True if the plugin is unloaded successfully
@@ -101,8 +130,24 @@ class ignition::rendering::RenderEngineManagerPrivate
   /// \brief List which holds paths to look for engine plugins.
   public: std::list<std::string> pluginPaths;
 
+  /// \brief Environment variable which holds the plugin manifest file
+  public: std::string manifestEnv = "IGN_RENDERING_PLUGIN_MANIFEST";
+
+  /// \brief Path to the plugin manifest file, empty if disabled
+  public: std::string manifestFile;
+
+  /// \brief Paths to the shared libraries of the plugins found so far.
+  /// Key: filename of plugin shared library and the plugin paths it was
+  /// searched for in, separated by a tab
+  public: std::map<std::string, std::string> libraryPaths;
+
   /// \brief Mutex to protect the engines map.
   public: std::recursive_mutex enginesMutex;
+
+  /// \brief Mutex serializing the loading and unloading of engines and of
+  /// their plugins, which may happen on preload threads. It is locked
+  /// before enginesMutex when both are needed.
+  public: std::recursive_mutex loadMutex;
 };
 
 using namespace ignition;
@@ -115,6 +160,10 @@ RenderEngineManager::RenderEngineManager() :
   dataPtr(new RenderEngineManagerPrivate)
 {
   this->dataPtr->RegisterDefaultEngines();
+
+  std::string manifest;
+  if (common::env(this->dataPtr->manifestEnv, manifest) && !manifest.empty())
+    this->SetPluginManifest(manifest);
 }
 
 //////////////////////////////////////////////////
@@ -205,13 +254,16 @@ RenderEngine *RenderEngineManager::Engine(const std::string &_name,
     const std::string &_path)
 {
   EngineInfo info{_name, nullptr};
-  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->enginesMutex);
-  // check in the list of available engines
-  auto iter = this->dataPtr->engines.find(_name);
-  if (iter != this->dataPtr->engines.end())
+  std::lock_guard<std::recursive_mutex> loadLock(this->dataPtr->loadMutex);
   {
-    info.name = iter->first;
-    info.engine = iter->second;
+    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->enginesMutex);
+    // check in the list of available engines
+    auto iter = this->dataPtr->engines.find(_name);
+    if (iter != this->dataPtr->engines.end())
+    {
+      info.name = iter->first;
+      info.engine = iter->second;
+    }
   }
 
   return this->dataPtr->Engine(info, _params, _path);
@@ -228,15 +280,40 @@ RenderEngine *RenderEngineManager::EngineAt(unsigned int _index,
     return nullptr;
   }
 
-  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->enginesMutex);
-  auto iter = this->dataPtr->engines.begin();
-  std::advance(iter, _index);
-  return this->dataPtr->Engine({iter->first, iter->second}, _params, _path);
+  std::lock_guard<std::recursive_mutex> loadLock(this->dataPtr->loadMutex);
+  EngineInfo info;
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->enginesMutex);
+    auto iter = this->dataPtr->engines.begin();
+    std::advance(iter, _index);
+    info = {iter->first, iter->second};
+  }
+  return this->dataPtr->Engine(info, _params, _path);
+}
+
+//////////////////////////////////////////////////
+std::shared_future<bool> RenderEngineManager::PreloadEngine(
+    const std::string &_name,
+    const std::map<std::string, std::string> &_params,
+    const std::string &_path)
+{
+  auto it = _params.find("renderThread");
+  bool initialize =
+      it != _params.end() && (it->second == "1" || it->second == "true");
+
+  return std::async(std::launch::async,
+      [this, _name, _params, _path, initialize]()
+      {
+        if (initialize)
+          return this->Engine(_name, _params, _path) != nullptr;
+        return this->dataPtr->PreloadEnginePlugin(_name, _path);
+      }).share();
 }
 
 //////////////////////////////////////////////////
 bool RenderEngineManager::UnloadEngine(const std::string &_name)
 {
+  std::lock_guard<std::recursive_mutex> loadLock(this->dataPtr->loadMutex);
   std::lock_guard<std::recursive_mutex> lock(this->dataPtr->enginesMutex);
   // check in the list of available engines
   auto iter = this->dataPtr->engines.find(_name);
@@ -268,6 +345,7 @@ bool RenderEngineManager::UnloadEngineAt(unsigned int _index)
     return false;
   }
 
+  std::lock_guard<std::recursive_mutex> loadLock(this->dataPtr->loadMutex);
   std::lock_guard<std::recursive_mutex> lock(this->dataPtr->enginesMutex);
   auto iter = this->dataPtr->engines.begin();
   std::advance(iter, _index);
@@ -349,6 +427,21 @@ void RenderEngineManager::SetPluginPaths(const std::list<std::string> &_paths)
   this->dataPtr->pluginPaths = _paths;
 }
 
+//////////////////////////////////////////////////
+void RenderEngineManager::SetPluginManifest(const std::string &_file)
+{
+  std::lock_guard<std::recursive_mutex> loadLock(this->dataPtr->loadMutex);
+  this->dataPtr->manifestFile = _file;
+  this->dataPtr->ReadManifest();
+}
+
+//////////////////////////////////////////////////
+std::string RenderEngineManager::PluginManifest() const
+{
+  std::lock_guard<std::recursive_mutex> loadLock(this->dataPtr->loadMutex);
+  return this->dataPtr->manifestFile;
+}
+
 //////////////////////////////////////////////////
 // RenderEngineManagerPrivate
 //////////////////////////////////////////////////
@@ -358,7 +451,7 @@ RenderEngine *RenderEngineManagerPrivate::Engine(EngineInfo _info,
 {
   RenderEngine *engine = _info.engine;
 
-  if (!engine)
+  if (!engine && this->PreloadEnginePlugin(_info.name, _path))
   {
     std::string libName = _info.name;
 
@@ -368,14 +461,10 @@ RenderEngine *RenderEngineManagerPrivate::Engine(EngineInfo _info,
     if (defaultIt != this->defaultEngines.end())
       libName = defaultIt->second;
 
-    // Load the engine plugin
-    if (this->LoadEnginePlugin(libName, _path))
-    {
-      std::lock_guard<std::recursive_mutex> lock(this->enginesMutex);
-      auto engineIt = this->engines.find(libName);
-      if (engineIt != this->engines.end())
-        engine = engineIt->second;
-    }
+    std::lock_guard<std::recursive_mutex> lock(this->enginesMutex);
+    auto engineIt = this->engines.find(libName);
+    if (engineIt != this->engines.end())
+      engine = engineIt->second;
   }
 
   if (!engine)
@@ -383,8 +472,24 @@ RenderEngine *RenderEngineManagerPrivate::Engine(EngineInfo _info,
 
   if (!engine->IsInitialized())
   {
-    engine->Load(_params);
-    engine->Init();
+    auto it = _params.find("renderThread");
+    if (it != _params.end() && (it->second == "1" || it->second == "true"))
+    {
+      // graphics contexts are bound to the thread that created them, so
+      // the whole engine lives on its own thread from now on
+      auto thread = std::make_shared<RenderThread>();
+      thread->Post([&]()
+      {
+        engine->Load(_params);
+        engine->Init();
+      }).get();
+      engine->SetRenderThread(thread);
+    }
+    else
+    {
+      engine->Load(_params);
+      engine->Init();
+    }
   }
 
   return engine;
@@ -398,7 +503,17 @@ bool RenderEngineManagerPrivate::UnloadEngine(EngineIter _iter)
   if (!engine)
     return false;
 
-  engine->Destroy();
+  RenderThreadPtr thread = engine->RenderThread();
+  if (thread && thread->IsRunning())
+  {
+    thread->Post([engine]() {engine->Destroy();}).get();
+    engine->SetRenderThread(nullptr);
+    thread->Stop();
+  }
+  else
+  {
+    engine->Destroy();
+  }
 
   return this->UnloadEnginePlugin(_iter->first);
 }
@@ -436,11 +551,31 @@ void RenderEngineManagerPrivate::RegisterDefaultEngines()
 }
 
 //////////////////////////////////////////////////
-bool RenderEngineManagerPrivate::LoadEnginePlugin(
-    const std::string &_filename, const std::string &_path)
+bool RenderEngineManagerPrivate::PreloadEnginePlugin(const std::string &_name,
+    const std::string &_path)
 {
-  ignmsg << "Loading plugin [" << _filename << "]" << std::endl;
+  std::lock_guard<std::recursive_mutex> loadLock(this->loadMutex);
+
+  std::string libName = _name;
+  auto defaultIt = this->defaultEngines.find(_name);
+  if (defaultIt != this->defaultEngines.end())
+    libName = defaultIt->second;
+
+  // the plugin may have been loaded by another thread in the meantime
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->enginesMutex);
+    auto engineIt = this->engines.find(libName);
+    if (engineIt != this->engines.end() && nullptr != engineIt->second)
+      return true;
+  }
 
+  return this->LoadEnginePlugin(libName, _path);
+}
+
+//////////////////////////////////////////////////
+std::string RenderEngineManagerPrivate::FindEngineLibrary(
+    const std::string &_filename, const std::string &_path)
+{
   ignition::common::SystemPaths systemPaths;
   systemPaths.SetPluginPathEnv(this->pluginPathEnv);
 
@@ -455,7 +590,85 @@ bool RenderEngineManagerPrivate::LoadEnginePlugin(
   // Add extra search path.
   systemPaths.AddPluginPaths(_path);
 
-  auto pathToLib = systemPaths.FindSharedLibrary(_filename);
+  // other plugin paths may resolve the filename to another library, so
+  // they are part of the key
+  std::stringstream key;
+  key << _filename << "\t";
+  for (const auto &path : systemPaths.PluginPaths())
+    key << path << common::SystemPaths::Delimiter();
+
+  // a single file check is much cheaper than searching all plugin paths
+  auto cachedIt = this->libraryPaths.find(key.str());
+  if (cachedIt != this->libraryPaths.end())
+  {
+    if (common::isFile(cachedIt->second))
+      return cachedIt->second;
+    this->libraryPaths.erase(cachedIt);
+  }
+
+  std::string pathToLib = systemPaths.FindSharedLibrary(_filename);
+  if (!pathToLib.empty())
+  {
+    this->libraryPaths[key.str()] = pathToLib;
+    this->WriteManifest();
+  }
+  return pathToLib;
+}
+
+//////////////////////////////////////////////////
+void RenderEngineManagerPrivate::ReadManifest()
+{
+  if (this->manifestFile.empty() || !common::isFile(this->manifestFile))
+    return;
+
+  // one plugin per line: filename of the shared library, the plugin paths
+  // it was searched for in and the path to it, separated by tabs
+  std::ifstream in(this->manifestFile);
+  std::string line;
+  while (std::getline(in, line))
+  {
+    auto first = line.find('\t');
+    auto last = line.rfind('\t');
+    if (first == std::string::npos || first == 0u || first == last ||
+        last + 1u == line.size())
+    {
+      continue;
+    }
+    this->libraryPaths[line.substr(0, last)] = line.substr(last + 1u);
+  }
+}
+
+//////////////////////////////////////////////////
+void RenderEngineManagerPrivate::WriteManifest() const
+{
+  if (this->manifestFile.empty())
+    return;
+
+  // concurrent processes sharing the manifest never read a partially
+  // written one
+  bool written = writeFileAtomically(this->manifestFile,
+      [this](const std::string &_tmpFile)
+  {
+    std::ofstream out(_tmpFile);
+    for (const auto &[filename, path] : this->libraryPaths)
+      out << filename << "\t" << path << "\n";
+    out.close();
+    return static_cast<bool>(out);
+  });
+  if (!written)
+  {
+    ignwarn << "Unable to write plugin manifest [" << this->manifestFile
+            << "]" << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+bool RenderEngineManagerPrivate::LoadEnginePlugin(
+    const std::string &_filename, const std::string &_path)
+{
+  ignmsg << "Loading plugin [" << _filename << "]" << std::endl;
+
+  std::string pathToLib = this->FindEngineLibrary(_filename, _path);
   if (pathToLib.empty())
   {
     ignerr << "Failed to load plugin [" << _filename <<
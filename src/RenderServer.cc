@@ -0,0 +1,564 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cstring>
+#include <map>
+#include <string>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Profiler.hh>
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/Material.hh"
+#include "ignition/rendering/RenderServer.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/SceneDelta.hh"
+#include "ignition/rendering/Visual.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+namespace
+{
+  /// \brief Largest frame accepted in a reply, in bytes. Bounds the memory
+  /// allocated for a malformed reply
+  const uint64_t kMaxFrameSize = 1ull << 30;
+
+  /// \brief Reads the little endian values written by SceneDelta
+  class Reader
+  {
+    /// \brief Constructor
+    /// \param[in] _data Data to read
+    /// \param[in] _size Size of the data in bytes
+    public: Reader(const uint8_t *_data, size_t _size)
+      : data(_data), size(_size)
+    {
+    }
+
+    /// \brief Check if all data was read
+    /// \return True if there is nothing left to read
+    public: bool End() const
+    {
+      return this->offset >= this->size;
+    }
+
+    /// \brief Read a byte
+    /// \param[out] _value Value read
+    /// \return False if the data ends before the value
+    public: bool Read(uint8_t &_value)
+    {
+      if (this->size - this->offset < 1u)
+        return false;
+      _value = this->data[this->offset++];
+      return true;
+    }
+
+    /// \brief Read an unsigned integer
+    /// \param[out] _value Value read
+    /// \return False if the data ends before the value
+    public: bool Read(uint32_t &_value)
+    {
+      if (this->size - this->offset < 4u)
+        return false;
+      _value = 0u;
+      for (unsigned int i = 0u; i < 4u; ++i)
+        _value |= static_cast<uint32_t>(this->data[this->offset++]) << (8u * i);
+      return true;
+    }
+
+    /// \brief Read a double
+    /// \param[out] _value Value read
+    /// \return False if the data ends before the value
+    public: bool Read(double &_value)
+    {
+      if (this->size - this->offset < 8u)
+        return false;
+      uint64_t bits = 0u;
+      for (unsigned int i = 0u; i < 8u; ++i)
+        bits |= static_cast<uint64_t>(this->data[this->offset++]) << (8u * i);
+      std::memcpy(&_value, &bits, sizeof(_value));
+      return true;
+    }
+
+    /// \brief Read a string
+    /// \param[out] _value Value read
+    /// \return False if the data ends before the value
+    public: bool Read(std::string &_value)
+    {
+      uint32_t length = 0u;
+      if (!this->Read(length) || this->size - this->offset < length)
+        return false;
+      _value.assign(reinterpret_cast<const char *>(this->data + this->offset),
+          length);
+      this->offset += length;
+      return true;
+    }
+
+    /// \brief Get the data at the current position and skip it
+    /// \param[in] _length Number of bytes to skip
+    /// \return Data at the current position, null if the data ends before
+    public: const uint8_t *Skip(size_t _length)
+    {
+      if (this->size - this->offset < _length)
+        return nullptr;
+      const uint8_t *current = this->data + this->offset;
+      this->offset += _length;
+      return current;
+    }
+
+    /// \brief Data to read
+    private: const uint8_t *data;
+
+    /// \brief Size of the data in bytes
+    private: size_t size;
+
+    /// \brief Position of the next value
+    private: size_t offset = 0u;
+  };
+
+  //////////////////////////////////////////////////
+  /// \brief Append a little endian unsigned integer
+  /// \param[in] _value Value to append
+  /// \param[in,out] _data Data to append to
+  void Write(uint32_t _value, std::vector<uint8_t> &_data)
+  {
+    for (unsigned int i = 0u; i < 4u; ++i)
+      _data.push_back(static_cast<uint8_t>(_value >> (8u * i)));
+  }
+}
+
+/// \brief Private data for the RenderServer class
+class ignition::rendering::RenderServerPrivate
+{
+  /// \brief Apply a command
+  /// \param[in] _command Command to apply
+  /// \param[in] _reader Reader of its arguments
+  /// \param[out] _reply Reply the frames are appended to
+  /// \return False if the command is malformed or invalid
+  public: bool Apply(SceneDelta::Command _command, Reader &_reader,
+              std::vector<uint8_t> &_reply);
+
+  /// \brief Get a node created by the server, or the root visual
+  /// \param[in] _id Id of the node, 0 for the root visual
+  /// \return Node, null if there is none with the id
+  public: NodePtr Node(uint32_t _id) const;
+
+  /// \brief Get a visual created by the server
+  /// \param[in] _id Id of the visual
+  /// \return Visual, null if there is no visual with the id
+  public: VisualPtr Visual(uint32_t _id) const;
+
+  /// \brief Scene the changes are applied to
+  public: Scene *scene = nullptr;
+
+  /// \brief Nodes created by the server by id
+  public: std::map<uint32_t, NodePtr> nodes;
+
+  /// \brief Materials of the visuals given a color by id
+  public: std::map<uint32_t, MaterialPtr> materials;
+};
+
+//////////////////////////////////////////////////
+NodePtr RenderServerPrivate::Node(uint32_t _id) const
+{
+  if (_id == 0u)
+    return this->scene->RootVisual();
+
+  auto it = this->nodes.find(_id);
+  if (it == this->nodes.end())
+  {
+    ignerr << "Unknown node id: " << _id << std::endl;
+    return nullptr;
+  }
+  return it->second;
+}
+
+//////////////////////////////////////////////////
+VisualPtr RenderServerPrivate::Visual(uint32_t _id) const
+{
+  auto visual = std::dynamic_pointer_cast<rendering::Visual>(this->Node(_id));
+  if (!visual)
+    ignerr << "Node id: " << _id << " is not a visual" << std::endl;
+  return visual;
+}
+
+//////////////////////////////////////////////////
+bool RenderServerPrivate::Apply(SceneDelta::Command _command,
+    Reader &_reader, std::vector<uint8_t> &_reply)
+{
+  switch (_command)
+  {
+    case SceneDelta::Command::CREATE_VISUAL:
+    case SceneDelta::Command::CREATE_CAMERA:
+    {
+      uint32_t id = 0u;
+      uint32_t parentId = 0u;
+      if (!_reader.Read(id) || !_reader.Read(parentId))
+        return false;
+
+      NodePtr node;
+      if (_command == SceneDelta::Command::CREATE_VISUAL)
+      {
+        node = this->scene->CreateVisual();
+      }
+      else
+      {
+        uint32_t width = 0u;
+        uint32_t height = 0u;
+        double hfov = 0.0;
+        double nearClip = 0.0;
+        double farClip = 0.0;
+        if (!_reader.Read(width) || !_reader.Read(height) ||
+            !_reader.Read(hfov) || !_reader.Read(nearClip) ||
+            !_reader.Read(farClip) || width == 0u || height == 0u)
+        {
+          return false;
+        }
+        CameraPtr camera = this->scene->CreateCamera();
+        if (camera)
+        {
+          camera->SetImageWidth(width);
+          camera->SetImageHeight(height);
+          camera->SetImageFormat(PF_R8G8B8);
+          camera->SetAspectRatio(static_cast<double>(width) / height);
+          camera->SetHFOV(hfov);
+          camera->SetNearClipPlane(nearClip);
+          camera->SetFarClipPlane(farClip);
+        }
+        node = camera;
+      }
+
+      NodePtr parent = this->Node(parentId);
+      if (id == 0u || this->nodes.count(id) || !node || !parent)
+      {
+        ignerr << "Unable to create node id: " << id << std::endl;
+        if (node)
+          this->scene->DestroyNode(node);
+        return false;
+      }
+      parent->AddChild(node);
+      this->nodes[id] = node;
+      return true;
+    }
+    case SceneDelta::Command::ADD_GEOMETRY:
+    {
+      uint32_t id = 0u;
+      uint8_t type = 0u;
+      std::string meshName;
+      if (!_reader.Read(id) || !_reader.Read(type) || !_reader.Read(meshName))
+        return false;
+
+      VisualPtr visual = this->Visual(id);
+      if (!visual)
+        return false;
+
+      GeometryPtr geometry;
+      switch (static_cast<SceneDelta::Geometry>(type))
+      {
+        case SceneDelta::Geometry::BOX:
+          geometry = this->scene->CreateBox();
+          break;
+        case SceneDelta::Geometry::CYLINDER:
+          geometry = this->scene->CreateCylinder();
+          break;
+        case SceneDelta::Geometry::PLANE:
+          geometry = this->scene->CreatePlane();
+          break;
+        case SceneDelta::Geometry::SPHERE:
+          geometry = this->scene->CreateSphere();
+          break;
+        case SceneDelta::Geometry::MESH:
+          geometry = this->scene->CreateMesh(meshName);
+          break;
+        default:
+          ignerr << "Unknown geometry type: " << static_cast<int>(type)
+                 << std::endl;
+          return false;
+      }
+      if (!geometry)
+        return false;
+      visual->AddGeometry(geometry);
+      return true;
+    }
+    case SceneDelta::Command::SET_POSE:
+    {
+      uint32_t id = 0u;
+      double values[7];
+      if (!_reader.Read(id))
+        return false;
+      for (double &value : values)
+      {
+        if (!_reader.Read(value))
+          return false;
+      }
+
+      NodePtr node = this->Node(id);
+      if (!node)
+        return false;
+      node->SetLocalPose(math::Pose3d(
+          math::Vector3d(values[0], values[1], values[2]),
+          math::Quaterniond(values[3], values[4], values[5], values[6])));
+      return true;
+    }
+    case SceneDelta::Command::SET_SCALE:
+    {
+      uint32_t id = 0u;
+      math::Vector3d scale;
+      if (!_reader.Read(id) || !_reader.Read(scale.X()) ||
+          !_reader.Read(scale.Y()) || !_reader.Read(scale.Z()))
+      {
+        return false;
+      }
+
+      NodePtr node = this->Node(id);
+      if (!node)
+        return false;
+      node->SetLocalScale(scale);
+      return true;
+    }
+    case SceneDelta::Command::SET_VISIBLE:
+    {
+      uint32_t id = 0u;
+      uint8_t visible = 0u;
+      if (!_reader.Read(id) || !_reader.Read(visible))
+        return false;
+
+      VisualPtr visual = this->Visual(id);
+      if (!visual)
+        return false;
+      visual->SetVisible(visible != 0u);
+      return true;
+    }
+    case SceneDelta::Command::SET_COLOR:
+    case SceneDelta::Command::SET_BACKGROUND_COLOR:
+    {
+      uint32_t id = 0u;
+      uint32_t rgba = 0u;
+      if (_command == SceneDelta::Command::SET_COLOR && !_reader.Read(id))
+        return false;
+      if (!_reader.Read(rgba))
+        return false;
+
+      math::Color color;
+      color.SetFromRGBA(rgba);
+      if (_command == SceneDelta::Command::SET_BACKGROUND_COLOR)
+      {
+        this->scene->SetBackgroundColor(color);
+        return true;
+      }
+
+      VisualPtr visual = this->Visual(id);
+      if (!visual)
+        return false;
+      MaterialPtr &material = this->materials[id];
+      if (!material)
+        material = this->scene->CreateMaterial();
+      material->SetAmbient(color);
+      material->SetDiffuse(color);
+      visual->SetMaterial(material, false);
+      return true;
+    }
+    case SceneDelta::Command::DESTROY:
+    {
+      uint32_t id = 0u;
+      if (!_reader.Read(id))
+        return false;
+
+      NodePtr node = this->Node(id);
+      if (!node || id == 0u)
+        return false;
+      this->scene->DestroyNode(node, true);
+
+      // the children were destroyed with it
+      for (auto it = this->nodes.begin(); it != this->nodes.end();)
+      {
+        if (this->scene->HasNode(it->second))
+        {
+          ++it;
+          continue;
+        }
+        auto material = this->materials.find(it->first);
+        if (material != this->materials.end())
+        {
+          this->scene->DestroyMaterial(material->second);
+          this->materials.erase(material);
+        }
+        it = this->nodes.erase(it);
+      }
+      return true;
+    }
+    case SceneDelta::Command::RENDER:
+    {
+      uint32_t count = 0u;
+      if (!_reader.Read(count))
+        return false;
+
+      std::vector<uint32_t> ids;
+      std::vector<CameraPtr> cameras;
+      std::vector<SensorPtr> sensors;
+      for (uint32_t i = 0u; i < count; ++i)
+      {
+        uint32_t id = 0u;
+        if (!_reader.Read(id))
+          return false;
+        auto camera = std::dynamic_pointer_cast<Camera>(this->Node(id));
+        if (!camera)
+        {
+          ignerr << "Node id: " << id << " is not a camera" << std::endl;
+          return false;
+        }
+        ids.push_back(id);
+        cameras.push_back(camera);
+        sensors.push_back(camera);
+      }
+
+      // one scene update and one GPU flush for all cameras
+      this->scene->RenderSensors(sensors);
+
+      if (_reply.empty())
+      {
+        _reply.push_back(static_cast<uint8_t>(SceneDelta::kVersion));
+        Write(0u, _reply);
+      }
+      for (size_t i = 0u; i < cameras.size(); ++i)
+      {
+        Image image = cameras[i]->CreateImage();
+        cameras[i]->Copy(image);
+        const unsigned int size = image.MemorySize();
+        Write(ids[i], _reply);
+        Write(image.Width(), _reply);
+        Write(image.Height(), _reply);
+        Write(static_cast<uint32_t>(image.Format()), _reply);
+        Write(size, _reply);
+        const uint8_t *data = image.Data<uint8_t>();
+        _reply.insert(_reply.end(), data, data + size);
+      }
+
+      // the replies of all render commands of a delta are merged into one
+      uint32_t frames = 0u;
+      Reader(_reply.data() + 1u, 4u).Read(frames);
+      frames += count;
+      for (unsigned int i = 0u; i < 4u; ++i)
+        _reply[1u + i] = static_cast<uint8_t>(frames >> (8u * i));
+      return true;
+    }
+    default:
+      ignerr << "Unknown command: " << static_cast<int>(_command)
+             << std::endl;
+      return false;
+  }
+}
+
+//////////////////////////////////////////////////
+RenderServer::RenderServer(Scene *_scene)
+  : dataPtr(new RenderServerPrivate)
+{
+  this->dataPtr->scene = _scene;
+}
+
+//////////////////////////////////////////////////
+RenderServer::~RenderServer()
+{
+  Scene *scene = this->dataPtr->scene;
+  for (auto &node : this->dataPtr->nodes)
+  {
+    if (scene->HasNode(node.second))
+      scene->DestroyNode(node.second, true);
+  }
+  for (auto &material : this->dataPtr->materials)
+    scene->DestroyMaterial(material.second);
+}
+
+//////////////////////////////////////////////////
+bool RenderServer::Apply(const uint8_t *_data, size_t _size,
+    std::vector<uint8_t> &_reply)
+{
+  IGN_PROFILE("RenderServer::Apply");
+  _reply.clear();
+
+  Reader reader(_data, _size);
+  uint8_t version = 0u;
+  if (!reader.Read(version) || version != SceneDelta::kVersion)
+  {
+    ignerr << "Unsupported scene delta version: "
+           << static_cast<int>(version) << std::endl;
+    return false;
+  }
+
+  while (!reader.End())
+  {
+    uint8_t command = 0u;
+    reader.Read(command);
+    if (!this->dataPtr->Apply(static_cast<SceneDelta::Command>(command),
+        reader, _reply))
+    {
+      ignerr << "Invalid scene delta command: " << static_cast<int>(command)
+             << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+unsigned int RenderServer::NodeCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->nodes.size());
+}
+
+//////////////////////////////////////////////////
+bool RenderServer::ParseReply(const uint8_t *_data, size_t _size,
+    std::vector<Frame> &_frames)
+{
+  _frames.clear();
+  Reader reader(_data, _size);
+  uint8_t version = 0u;
+  uint32_t count = 0u;
+  if (!reader.Read(version) || version != SceneDelta::kVersion ||
+      !reader.Read(count))
+  {
+    return false;
+  }
+
+  for (uint32_t i = 0u; i < count; ++i)
+  {
+    Frame frame;
+    uint32_t width = 0u;
+    uint32_t height = 0u;
+    uint32_t format = 0u;
+    uint32_t size = 0u;
+    if (!reader.Read(frame.cameraId) || !reader.Read(width) ||
+        !reader.Read(height) || !reader.Read(format) || !reader.Read(size) ||
+        format >= PF_COUNT)
+    {
+      return false;
+    }
+
+    // check the size before allocating, width * height may overflow
+    PixelFormat pixelFormat =
+        PixelUtil::Sanitize(static_cast<PixelFormat>(format));
+    uint64_t imageSize = static_cast<uint64_t>(width) * height *
+        PixelUtil::BytesPerPixel(pixelFormat);
+    const uint8_t *data = reader.Skip(size);
+    if (!data || imageSize != size || imageSize > kMaxFrameSize)
+      return false;
+    frame.image = Image(width, height, pixelFormat);
+    std::memcpy(frame.image.Data(), data, size);
+    _frames.push_back(frame);
+  }
+  return reader.End();
+}
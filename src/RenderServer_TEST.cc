@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderServer.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/SceneDelta.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+class RenderServerTest : public testing::Test,
+                         public testing::WithParamInterface<const char*>
+{
+  /// \brief Test rendering a scene described by scene deltas
+  public: void Render(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+TEST(SceneDeltaTest, Encoding)
+{
+  SceneDelta delta;
+  ASSERT_EQ(1u, delta.Data().size());
+  EXPECT_EQ(SceneDelta::kVersion, delta.Data()[0]);
+
+  // command, id and seven doubles
+  delta.SetPose(7u, math::Pose3d(1, 2, 3, 0, 0, 0));
+  EXPECT_EQ(1u + 1u + 4u + 7u * 8u, delta.Data().size());
+  EXPECT_EQ(static_cast<uint8_t>(SceneDelta::Command::SET_POSE),
+      delta.Data()[1]);
+  // little endian id
+  EXPECT_EQ(7u, delta.Data()[2]);
+  EXPECT_EQ(0u, delta.Data()[5]);
+
+  delta.Clear();
+  EXPECT_EQ(1u, delta.Data().size());
+}
+
+/////////////////////////////////////////////////
+TEST(SceneDeltaTest, MalformedReply)
+{
+  std::vector<RenderServer::Frame> frames;
+  EXPECT_FALSE(RenderServer::ParseReply(nullptr, 0u, frames));
+
+  // one frame announced, none in the data
+  std::vector<uint8_t> reply = {SceneDelta::kVersion, 1u, 0u, 0u, 0u};
+  EXPECT_FALSE(RenderServer::ParseReply(reply.data(), reply.size(), frames));
+
+  reply[1] = 0u;
+  EXPECT_TRUE(RenderServer::ParseReply(reply.data(), reply.size(), frames));
+  EXPECT_TRUE(frames.empty());
+
+  // one empty frame whose width * height * 3 wraps to 0 in 32 bits
+  auto appendUint = [&reply](uint32_t _value)
+  {
+    for (unsigned int i = 0u; i < 4u; ++i)
+      reply.push_back(static_cast<uint8_t>(_value >> (8u * i)));
+  };
+  reply = {SceneDelta::kVersion};
+  appendUint(1u);
+  appendUint(3u);
+  appendUint(1u << 16);
+  appendUint(1u << 16);
+  appendUint(PF_R8G8B8);
+  appendUint(0u);
+  EXPECT_FALSE(RenderServer::ParseReply(reply.data(), reply.size(), frames));
+  EXPECT_TRUE(frames.empty());
+}
+
+/////////////////////////////////////////////////
+void RenderServerTest::Render(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  std::vector<uint8_t> reply;
+  std::vector<RenderServer::Frame> frames;
+  {
+    RenderServer server(scene.get());
+
+    // a green box in front of a camera, on a red background
+    SceneDelta delta;
+    delta.SetBackgroundColor(math::Color::Red);
+    delta.CreateVisual(1u, 0u);
+    delta.AddGeometry(1u, SceneDelta::Geometry::BOX);
+    delta.SetPose(1u, math::Pose3d(3, 0, 0, 0, 0, 0));
+    delta.SetColor(1u, math::Color::Green);
+    delta.CreateCamera(2u, 0u, 16u, 16u, IGN_PI / 2.0, 0.1, 100.0);
+    delta.Render({2u});
+    EXPECT_TRUE(server.Apply(delta.Data().data(), delta.Data().size(),
+        reply));
+    EXPECT_EQ(2u, server.NodeCount());
+
+    ASSERT_TRUE(RenderServer::ParseReply(reply.data(), reply.size(),
+        frames));
+    ASSERT_EQ(1u, frames.size());
+    EXPECT_EQ(2u, frames[0].cameraId);
+    EXPECT_EQ(16u, frames[0].image.Width());
+    EXPECT_EQ(16u, frames[0].image.Height());
+    EXPECT_EQ(PF_R8G8B8, frames[0].image.Format());
+    unsigned int center = (8u * 16u + 8u) * 3u;
+    const unsigned char *data = frames[0].image.Data<unsigned char>();
+    EXPECT_FALSE(data[center] == 255u && data[center + 1] == 0u &&
+        data[center + 2] == 0u);
+
+    // only the new pose is sent, the box moves out of view
+    delta.Clear();
+    delta.SetPose(1u, math::Pose3d(-3, 0, 0, 0, 0, 0));
+    delta.Render({2u, 2u});
+    EXPECT_TRUE(server.Apply(delta.Data().data(), delta.Data().size(),
+        reply));
+    ASSERT_TRUE(RenderServer::ParseReply(reply.data(), reply.size(),
+        frames));
+    ASSERT_EQ(2u, frames.size());
+    data = frames[1].image.Data<unsigned char>();
+    EXPECT_EQ(255u, data[center]);
+    EXPECT_EQ(0u, data[center + 1]);
+
+    // unknown nodes and versions are rejected
+    delta.Clear();
+    delta.SetVisible(5u, false);
+    EXPECT_FALSE(server.Apply(delta.Data().data(), delta.Data().size(),
+        reply));
+    std::vector<uint8_t> version = {0u};
+    EXPECT_FALSE(server.Apply(version.data(), version.size(), reply));
+
+    delta.Clear();
+    delta.Destroy(1u);
+    EXPECT_TRUE(server.Apply(delta.Data().data(), delta.Data().size(),
+        reply));
+    EXPECT_TRUE(reply.empty());
+    EXPECT_EQ(1u, server.NodeCount());
+  }
+
+  // the server destroys its nodes
+  EXPECT_EQ(0u, scene->SensorCount());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(RenderServerTest, Render)
+{
+  Render(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(RenderServer, RenderServerTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
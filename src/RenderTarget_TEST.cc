@@ -23,6 +23,7 @@
 
 #include "ignition/rendering/Camera.hh"
 #include "ignition/rendering/GaussianNoisePass.hh"
+#include "ignition/rendering/Image.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderingIface.hh"
 #include "ignition/rendering/RenderPassSystem.hh"
@@ -43,6 +44,9 @@ class RenderTargetTest : public testing::Test,
 
   /// \brief test adding and removing render passes
   public: void AddRemoveRenderPass(const std::string &_renderEngine);
+
+  /// \brief test render targets that share a compositor definition
+  public: void SharedCompositor(const std::string &_renderEngine);
 };
 
 /////////////////////////////////////////////////
@@ -185,6 +189,87 @@ void RenderTargetTest::AddRemoveRenderPass(const std::string &_renderEngine)
   rendering::unloadEngine(engine->Name());
 }
 
+/////////////////////////////////////////////////
+void RenderTargetTest::SharedCompositor(const std::string &_renderEngine)
+{
+  if (_renderEngine != "ogre2")
+  {
+    igndbg << "Shared compositors not used in rendering engine: "
+            << _renderEngine << std::endl;
+    return;
+  }
+
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetBackgroundColor(1.0, 0.0, 0.0);
+
+  // check that the center pixel of a camera image is the given color
+  auto checkColor = [](CameraPtr _camera, unsigned char _r, unsigned char _g,
+      unsigned char _b)
+  {
+    Image image = _camera->CreateImage();
+    _camera->Capture(image);
+    unsigned char *data = image.Data<unsigned char>();
+    unsigned int center = (8u * 16u + 8u) * 3u;
+    EXPECT_EQ(_r, data[center]);
+    EXPECT_EQ(_g, data[center + 1]);
+    EXPECT_EQ(_b, data[center + 2]);
+  };
+
+  // cameras with the same settings share a compositor definition
+  std::vector<CameraPtr> cameras;
+  for (unsigned int i = 0u; i < 3u; ++i)
+  {
+    CameraPtr camera = scene->CreateCamera();
+    ASSERT_NE(nullptr, camera);
+    camera->SetImageWidth(16);
+    camera->SetImageHeight(16);
+    camera->SetImageFormat(PF_R8G8B8);
+    scene->RootVisual()->AddChild(camera);
+    cameras.push_back(camera);
+  }
+  for (auto camera : cameras)
+    checkColor(camera, 255u, 0u, 0u);
+
+  // a camera with another background uses another definition
+  scene->SetBackgroundColor(0.0, 0.0, 1.0);
+  CameraPtr blueCamera = scene->CreateCamera();
+  ASSERT_NE(nullptr, blueCamera);
+  blueCamera->SetImageWidth(16);
+  blueCamera->SetImageHeight(16);
+  blueCamera->SetImageFormat(PF_R8G8B8);
+  scene->RootVisual()->AddChild(blueCamera);
+  checkColor(blueCamera, 0u, 0u, 255u);
+
+  // destroying a camera keeps the definition for the others
+  scene->DestroySensor(cameras[0]);
+  checkColor(cameras[1], 255u, 0u, 0u);
+
+  // render passes move the camera to a definition of its own
+  RenderPassSystemPtr rpSystem = engine->RenderPassSystem();
+  if (rpSystem)
+  {
+    RenderPassPtr pass = rpSystem->Create<GaussianNoisePass>();
+    ASSERT_NE(nullptr, pass);
+    pass->SetEnabled(false);
+    cameras[1]->AddRenderPass(pass);
+    checkColor(cameras[1], 255u, 0u, 0u);
+  }
+  checkColor(cameras[2], 255u, 0u, 0u);
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
 /////////////////////////////////////////////////
 TEST_P(RenderTargetTest, RenderTexture)
 {
@@ -203,6 +288,12 @@ TEST_P(RenderTargetTest, AddRemoveRenderPass)
   AddRemoveRenderPass(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(RenderTargetTest, SharedCompositor)
+{
+  SharedCompositor(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(RenderTarget, RenderTargetTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/RenderThread.hh"
+
+/// \brief Private data for the RenderThread class
+class ignition::rendering::RenderThreadPrivate
+{
+  /// \brief Run tasks until stopped
+  public: void Run();
+
+  /// \brief Protects the members below
+  public: mutable std::mutex mutex;
+
+  /// \brief Signaled when a task is posted or the thread is stopped
+  public: std::condition_variable condition;
+
+  /// \brief Tasks waiting to run, oldest first
+  public: std::deque<std::function<void()>> tasks;
+
+  /// \brief True once the thread was asked to stop
+  public: bool stopping = false;
+
+  /// \brief The render thread
+  public: std::thread thread;
+};
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+void RenderThreadPrivate::Run()
+{
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    this->condition.wait(lock, [this]()
+    {
+      return this->stopping || !this->tasks.empty();
+    });
+
+    // finish the tasks already posted before stopping
+    if (this->tasks.empty())
+      break;
+
+    std::function<void()> task = std::move(this->tasks.front());
+    this->tasks.pop_front();
+
+    lock.unlock();
+    task();
+    lock.lock();
+  }
+}
+
+//////////////////////////////////////////////////
+RenderThread::RenderThread()
+  : dataPtr(new RenderThreadPrivate)
+{
+  this->dataPtr->thread = std::thread(&RenderThreadPrivate::Run,
+      this->dataPtr.get());
+}
+
+//////////////////////////////////////////////////
+RenderThread::~RenderThread()
+{
+  if (this->IsRenderThread())
+  {
+    ignerr << "Render thread destroyed by one of its own tasks, "
+           << "detaching it" << std::endl;
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+      this->dataPtr->stopping = true;
+    }
+    this->dataPtr->thread.detach();
+    // the thread still uses the private data
+    this->dataPtr.release();
+    return;
+  }
+  this->Stop();
+}
+
+//////////////////////////////////////////////////
+bool RenderThread::PostTask(std::function<void()> _task)
+{
+  if (!_task)
+    return false;
+
+  if (this->IsRenderThread())
+  {
+    _task();
+    return true;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    if (this->dataPtr->stopping)
+      return false;
+    this->dataPtr->tasks.push_back(std::move(_task));
+  }
+  this->dataPtr->condition.notify_one();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void RenderThread::Stop()
+{
+  if (this->IsRenderThread())
+  {
+    ignerr << "A render thread can not be stopped from one of its own "
+           << "tasks" << std::endl;
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stopping = true;
+  }
+  this->dataPtr->condition.notify_one();
+
+  if (this->dataPtr->thread.joinable())
+    this->dataPtr->thread.join();
+}
+
+//////////////////////////////////////////////////
+bool RenderThread::IsRunning() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return !this->dataPtr->stopping;
+}
+
+//////////////////////////////////////////////////
+bool RenderThread::IsRenderThread() const
+{
+  return std::this_thread::get_id() == this->dataPtr->thread.get_id();
+}
+
+//////////////////////////////////////////////////
+std::thread::id RenderThread::Id() const
+{
+  return this->dataPtr->thread.get_id();
+}
+
+//////////////////////////////////////////////////
+unsigned int RenderThread::PendingTaskCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return static_cast<unsigned int>(this->dataPtr->tasks.size());
+}
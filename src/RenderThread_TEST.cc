@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/RenderThread.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(RenderThreadTest, Post)
+{
+  RenderThread thread;
+  EXPECT_TRUE(thread.IsRunning());
+  EXPECT_FALSE(thread.IsRenderThread());
+  EXPECT_NE(std::this_thread::get_id(), thread.Id());
+
+  // tasks run on the render thread and return their result
+  std::future<std::thread::id> id = thread.Post([]()
+  {
+    return std::this_thread::get_id();
+  });
+  EXPECT_EQ(thread.Id(), id.get());
+
+  std::future<bool> isRenderThread = thread.Post([&thread]()
+  {
+    return thread.IsRenderThread();
+  });
+  EXPECT_TRUE(isRenderThread.get());
+
+  // exceptions are passed through the future
+  std::future<void> error = thread.Post([]()
+  {
+    throw std::runtime_error("error");
+  });
+  EXPECT_THROW(error.get(), std::runtime_error);
+
+  // tasks posted from the render thread run right away
+  std::future<int> nested = thread.Post([&thread]()
+  {
+    return thread.Post([]() {return 2;}).get() + 1;
+  });
+  EXPECT_EQ(3, nested.get());
+}
+
+/////////////////////////////////////////////////
+TEST(RenderThreadTest, Order)
+{
+  RenderThread thread;
+
+  // tasks run one at a time in the order they were posted
+  std::vector<int> order;
+  std::vector<std::future<void>> results;
+  for (int i = 0; i < 100; ++i)
+    results.push_back(thread.Post([&order, i]() {order.push_back(i);}));
+  results.back().wait();
+
+  ASSERT_EQ(100u, order.size());
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(i, order[i]);
+  EXPECT_EQ(0u, thread.PendingTaskCount());
+}
+
+/////////////////////////////////////////////////
+TEST(RenderThreadTest, Stop)
+{
+  std::atomic<int> count{0};
+  RenderThread thread;
+
+  // tasks already posted still run when stopping
+  for (int i = 0; i < 10; ++i)
+    EXPECT_TRUE(thread.PostTask([&count]() {count++;}));
+  thread.Stop();
+  EXPECT_FALSE(thread.IsRunning());
+  EXPECT_EQ(10, count);
+
+  // tasks posted afterwards are discarded
+  EXPECT_FALSE(thread.PostTask([&count]() {count++;}));
+  std::future<void> discarded = thread.Post([&count]() {count++;});
+  EXPECT_THROW(discarded.get(), std::future_error);
+  EXPECT_EQ(10, count);
+
+  EXPECT_FALSE(thread.PostTask(nullptr));
+}
@@ -126,6 +126,21 @@ void setPluginPaths(const std::list<std::string> &_paths)
   RenderEngineManager::Instance()->SetPluginPaths(_paths);
 }
 
+//////////////////////////////////////////////////
+void setPluginManifest(const std::string &_file)
+{
+  RenderEngineManager::Instance()->SetPluginManifest(_file);
+}
+
+//////////////////////////////////////////////////
+std::shared_future<bool> preloadEngine(const std::string &_name,
+    const std::map<std::string, std::string> &_params,
+    const std::string &_path)
+{
+  return RenderEngineManager::Instance()->PreloadEngine(_name, _params,
+      _path);
+}
+
 //////////////////////////////////////////////////
 ScenePtr sceneFromFirstRenderEngine()
 {
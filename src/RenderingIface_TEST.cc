@@ -19,7 +19,11 @@
 
 #include "test_config.h"  // NOLINT(build/include)
 
+#include <fstream>
+#include <sstream>
+
 #include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
 
 #include "ignition/rendering/config.hh"
 #include "ignition/rendering/RenderEngine.hh"
@@ -104,6 +108,66 @@ TEST(RenderingIfaceTest, GetEngine)
   EXPECT_EQ(nullptr, engine(1000000));
 }
 
+/////////////////////////////////////////////////
+TEST(RenderingIfaceTest, PreloadEngine)
+{
+  common::Console::SetVerbosity(4);
+
+  if (defaultEnginesForTest() == 0)
+    return;
+
+  std::string manifest = common::joinPaths(PROJECT_BUILD_PATH,
+      "test_plugin_manifest.txt");
+  common::removeFile(manifest);
+  setPluginManifest(manifest);
+
+  // non-existent engine
+  EXPECT_FALSE(preloadEngine("no_such_engine").get());
+
+  std::string name;
+#if HAVE_OGRE2
+  name = "ogre2";
+#elif HAVE_OGRE
+  name = "ogre";
+#else
+  name = "optix";
+#endif
+
+  // the plugin is loaded but the engine is not initialized
+  std::shared_future<bool> preload = preloadEngine(name, {},
+      IGN_RENDERING_TEST_PLUGIN_PATH);
+  EXPECT_TRUE(preload.get());
+  EXPECT_TRUE(isEngineLoaded(name));
+
+  // the path of the plugin library is saved in the manifest
+  ASSERT_TRUE(common::isFile(manifest));
+  std::ifstream in(manifest);
+  std::stringstream content;
+  content << in.rdbuf();
+  EXPECT_NE(std::string::npos,
+      content.str().find("ignition-rendering-" + name));
+
+  RenderEngine *eng = engine(name);
+  ASSERT_NE(nullptr, eng);
+  EXPECT_TRUE(eng->IsInitialized());
+
+  // preloading a loaded engine is a no op
+  EXPECT_TRUE(preloadEngine(name).get());
+  EXPECT_EQ(eng, engine(name));
+
+  rendering::unloadEngine(name);
+  EXPECT_FALSE(isEngineLoaded(name));
+
+  // loading again with the same plugin path uses the manifest
+  EXPECT_TRUE(preloadEngine(name, {}, IGN_RENDERING_TEST_PLUGIN_PATH).get());
+  eng = engine(name);
+  ASSERT_NE(nullptr, eng);
+  rendering::unloadEngine(name);
+
+  setPluginManifest("");
+  common::removeFile(manifest);
+}
+
 /////////////////////////////////////////////////
 TEST(RenderingIfaceTest, RegisterEngine)
 {
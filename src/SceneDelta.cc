@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cstring>
+
+#include "ignition/rendering/SceneDelta.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+constexpr uint8_t SceneDelta::kVersion;
+
+/// \brief Private data for the SceneDelta class
+class ignition::rendering::SceneDeltaPrivate
+{
+  /// \brief Append a command
+  /// \param[in] _command Command to append
+  public: void Write(SceneDelta::Command _command);
+
+  /// \brief Append an unsigned integer, little endian
+  /// \param[in] _value Value to append
+  public: void Write(uint32_t _value);
+
+  /// \brief Append a double, little endian
+  /// \param[in] _value Value to append
+  public: void Write(double _value);
+
+  /// \brief Append a string, its size followed by its characters
+  /// \param[in] _value Value to append
+  public: void Write(const std::string &_value);
+
+  /// \brief Encoded commands
+  public: std::vector<uint8_t> data;
+};
+
+//////////////////////////////////////////////////
+void SceneDeltaPrivate::Write(SceneDelta::Command _command)
+{
+  this->data.push_back(static_cast<uint8_t>(_command));
+}
+
+//////////////////////////////////////////////////
+void SceneDeltaPrivate::Write(uint32_t _value)
+{
+  for (unsigned int i = 0u; i < 4u; ++i)
+    this->data.push_back(static_cast<uint8_t>(_value >> (8u * i)));
+}
+
+//////////////////////////////////////////////////
+void SceneDeltaPrivate::Write(double _value)
+{
+  uint64_t bits = 0u;
+  std::memcpy(&bits, &_value, sizeof(bits));
+  for (unsigned int i = 0u; i < 8u; ++i)
+    this->data.push_back(static_cast<uint8_t>(bits >> (8u * i)));
+}
+
+//////////////////////////////////////////////////
+void SceneDeltaPrivate::Write(const std::string &_value)
+{
+  this->Write(static_cast<uint32_t>(_value.size()));
+  this->data.insert(this->data.end(), _value.begin(), _value.end());
+}
+
+//////////////////////////////////////////////////
+SceneDelta::SceneDelta()
+  : dataPtr(new SceneDeltaPrivate)
+{
+  this->Clear();
+}
+
+//////////////////////////////////////////////////
+SceneDelta::~SceneDelta() = default;
+
+//////////////////////////////////////////////////
+void SceneDelta::CreateVisual(uint32_t _id, uint32_t _parentId)
+{
+  this->dataPtr->Write(Command::CREATE_VISUAL);
+  this->dataPtr->Write(_id);
+  this->dataPtr->Write(_parentId);
+}
+
+//////////////////////////////////////////////////
+void SceneDelta::AddGeometry(uint32_t _id, Geometry _geometry,
+    const std::string &_meshName)
+{
+  this->dataPtr->Write(Command::ADD_GEOMETRY);
+  this->dataPtr->Write(_id);
+  this->dataPtr->data.push_back(static_cast<uint8_t>(_geometry));
+  this->dataPtr->Write(_meshName);
+}
+
+//////////////////////////////////////////////////
+void SceneDelta::CreateCamera(uint32_t _id, uint32_t _parentId,
+    uint32_t _width, uint32_t _height, double _hfov, double _near,
+    double _far)
+{
+  this->dataPtr->Write(Command::CREATE_CAMERA);
+  this->dataPtr->Write(_id);
+  this->dataPtr->Write(_parentId);
+  this->dataPtr->Write(_width);
+  this->dataPtr->Write(_height);
+  this->dataPtr->Write(_hfov);
+  this->dataPtr->Write(_near);
+  this->dataPtr->Write(_far);
+}
+
+//////////////////////////////////////////////////
+void SceneDelta::SetPose(uint32_t _id, const math::Pose3d &_pose)
+{
+  this->dataPtr->Write(Command::SET_POSE);
+  this->dataPtr->Write(_id);
+  this->dataPtr->Write(_pose.Pos().X());
+  this->dataPtr->Write(_pose.Pos().Y());
+  this->dataPtr->Write(_pose.Pos().Z());
+  this->dataPtr->Write(_pose.Rot().W());
+  this->dataPtr->Write(_pose.Rot().X());
+  this->dataPtr->Write(_pose.Rot().Y());
+  this->dataPtr->Write(_pose.Rot().Z());
+}
+
+//////////////////////////////////////////////////
+void SceneDelta::SetScale(uint32_t _id, const math::Vector3d &_scale)
+{
+  this->dataPtr->Write(Command::SET_SCALE);
+  this->dataPtr->Write(_id);
+  this->dataPtr->Write(_scale.X());
+  this->dataPtr->Write(_scale.Y());
+  this->dataPtr->Write(_scale.Z());
+}
+
+//////////////////////////////////////////////////
+void SceneDelta::SetVisible(uint32_t _id, bool _visible)
+{
+  this->dataPtr->Write(Command::SET_VISIBLE);
+  this->dataPtr->Write(_id);
+  this->dataPtr->data.push_back(_visible ? 1u : 0u);
+}
+
+//////////////////////////////////////////////////
+void SceneDelta::SetColor(uint32_t _id, const math::Color &_color)
+{
+  this->dataPtr->Write(Command::SET_COLOR);
+  this->dataPtr->Write(_id);
+  this->dataPtr->Write(_color.AsRGBA());
+}
+
+//////////////////////////////////////////////////
+void SceneDelta::SetBackgroundColor(const math::Color &_color)
+{
+  this->dataPtr->Write(Command::SET_BACKGROUND_COLOR);
+  this->dataPtr->Write(_color.AsRGBA());
+}
+
+//////////////////////////////////////////////////
+void SceneDelta::Destroy(uint32_t _id)
+{
+  this->dataPtr->Write(Command::DESTROY);
+  this->dataPtr->Write(_id);
+}
+
+//////////////////////////////////////////////////
+void SceneDelta::Render(const std::vector<uint32_t> &_ids)
+{
+  this->dataPtr->Write(Command::RENDER);
+  this->dataPtr->Write(static_cast<uint32_t>(_ids.size()));
+  for (auto id : _ids)
+    this->dataPtr->Write(id);
+}
+
+//////////////////////////////////////////////////
+const std::vector<uint8_t> &SceneDelta::Data() const
+{
+  return this->dataPtr->data;
+}
+
+//////////////////////////////////////////////////
+void SceneDelta::Clear()
+{
+  this->dataPtr->data.clear();
+  this->dataPtr->data.push_back(static_cast<uint8_t>(kVersion));
+}
@@ -17,9 +17,18 @@
 
 #include <gtest/gtest.h>
 
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
 #include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
 
 #include "test_config.h"  // NOLINT(build/include)
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/Light.hh"
+#include "ignition/rendering/Mesh.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderTarget.hh"
 #include "ignition/rendering/RenderingIface.hh"
@@ -60,6 +69,18 @@ class SceneTest : public testing::Test,
 
   /// \brief Test enablng sky
   public: void Sky(const std::string &_renderEngine);
+
+  /// \brief Test setting the poses of many nodes at once
+  public: void SetLocalPoses(const std::string &_renderEngine);
+
+  /// \brief Test creating instances of a scene
+  public: void CreateInstance(const std::string &_renderEngine);
+
+  /// \brief Test saving and loading scene snapshots
+  public: void Snapshot(const std::string &_renderEngine);
+
+  /// \brief Test baking static visuals
+  public: void BakeStatic(const std::string &_renderEngine);
 };
 
 /////////////////////////////////////////////////
@@ -772,6 +793,371 @@ void SceneTest::Sky(const std::string &_renderEngine)
   rendering::unloadEngine(engine->Name());
 }
 
+/////////////////////////////////////////////////
+void SceneTest::SetLocalPoses(const std::string &_renderEngine)
+{
+  auto engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine << "' is not supported" << std::endl;
+    return;
+  }
+
+  auto scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  auto visA = scene->CreateVisual();
+  ASSERT_NE(nullptr, visA);
+  auto visB = scene->CreateVisual();
+  ASSERT_NE(nullptr, visB);
+  visB->SetOrigin(0, 0, 1);
+  scene->RootVisual()->AddChild(visA);
+  visA->AddChild(visB);
+
+  math::Pose3d poseA(1, 2, 3, 0, 0, 1.57);
+  math::Pose3d poseB(-1, 0, 0, 0.2, 0, 0);
+
+  // mismatched sizes
+  EXPECT_EQ(0u, scene->SetLocalPoses({visA->Id(), visB->Id()}, {poseA}));
+  EXPECT_EQ(math::Pose3d::Zero, visA->LocalPose());
+
+  // unknown ids are skipped
+  EXPECT_EQ(2u, scene->SetLocalPoses({visA->Id(), 987654u, visB->Id()},
+      {poseA, math::Pose3d(9, 9, 9, 0, 0, 0), poseB}));
+  EXPECT_EQ(poseA, visA->LocalPose());
+  EXPECT_EQ(poseB, visB->LocalPose());
+
+  // same result as setting the poses one by one
+  auto visC = scene->CreateVisual();
+  ASSERT_NE(nullptr, visC);
+  visC->SetOrigin(0, 0, 1);
+  visC->SetLocalPose(poseB);
+  EXPECT_EQ(visC->LocalPose(), visB->LocalPose());
+
+  // repeated ids get the last pose
+  EXPECT_EQ(2u, scene->SetLocalPoses({visA->Id(), visA->Id()},
+      {poseB, poseA}));
+  EXPECT_EQ(poseA, visA->LocalPose());
+
+  // large batches, which render engines may split over several threads
+  std::vector<unsigned int> ids;
+  std::vector<math::Pose3d> poses;
+  for (unsigned int i = 0; i < 5000u; ++i)
+  {
+    auto vis = scene->CreateVisual();
+    ASSERT_NE(nullptr, vis);
+    visA->AddChild(vis);
+    ids.push_back(vis->Id());
+    poses.push_back(math::Pose3d(i * 0.01, 1, 2, 0, 0, i * 0.001));
+  }
+  EXPECT_EQ(5000u, scene->SetLocalPoses(ids, poses));
+  for (unsigned int i = 0; i < 5000u; ++i)
+  {
+    NodePtr node = scene->NodeById(ids[i]);
+    ASSERT_NE(nullptr, node);
+    EXPECT_EQ(poses[i], node->LocalPose());
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::CreateInstance(const std::string &_renderEngine)
+{
+  auto engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine << "' is not supported" << std::endl;
+    return;
+  }
+
+  auto scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetAmbientLight(0.3, 0.2, 0.1);
+  scene->SetBackgroundColor(0.1, 0.2, 0.3);
+
+  auto light = scene->CreateDirectionalLight("sun");
+  ASSERT_NE(nullptr, light);
+  light->SetDirection(0.5, 0.5, -1);
+  light->SetDiffuseColor(0.8, 0.7, 0.6);
+  scene->RootVisual()->AddChild(light);
+
+  auto red = scene->CreateMaterial("red");
+  red->SetDiffuse(1.0, 0.0, 0.0);
+
+  auto parent = scene->CreateVisual("parent");
+  parent->SetLocalPose(math::Pose3d(1, 2, 3, 0, 0, 0.5));
+  parent->AddGeometry(scene->CreateBox());
+  parent->SetMaterial(red, false);
+  scene->RootVisual()->AddChild(parent);
+
+  auto child = scene->CreateVisual("child");
+  child->SetLocalPosition(0, 0, 1);
+  child->SetLocalScale(0.5, 0.5, 0.5);
+  child->AddGeometry(scene->CreateSphere());
+  child->SetMaterial(red, false);
+  parent->AddChild(child);
+
+  // sensors are not copied
+  auto camera = scene->CreateCamera("camera");
+  scene->RootVisual()->AddChild(camera);
+
+  auto instance = scene->CreateInstance("instance");
+  ASSERT_NE(nullptr, instance);
+  EXPECT_NE(scene, instance);
+  EXPECT_EQ("instance", instance->Name());
+  EXPECT_EQ(scene->AmbientLight(), instance->AmbientLight());
+  EXPECT_EQ(scene->BackgroundColor(), instance->BackgroundColor());
+  EXPECT_EQ(0u, instance->SensorCount());
+
+  auto instanceLight = std::dynamic_pointer_cast<DirectionalLight>(
+      instance->LightByName("sun"));
+  ASSERT_NE(nullptr, instanceLight);
+  EXPECT_EQ(light->Direction(), instanceLight->Direction());
+  EXPECT_EQ(light->DiffuseColor(), instanceLight->DiffuseColor());
+
+  auto instanceParent = instance->VisualByName("parent");
+  ASSERT_NE(nullptr, instanceParent);
+  EXPECT_NE(parent, instanceParent);
+  EXPECT_EQ(parent->LocalPose(), instanceParent->LocalPose());
+  EXPECT_EQ(1u, instanceParent->GeometryCount());
+  ASSERT_EQ(1u, instanceParent->ChildCount());
+
+  auto instanceChild = instance->VisualByName("child");
+  ASSERT_NE(nullptr, instanceChild);
+  EXPECT_EQ(instanceParent, instanceChild->Parent());
+  EXPECT_EQ(child->LocalPose(), instanceChild->LocalPose());
+  EXPECT_EQ(child->LocalScale(), instanceChild->LocalScale());
+  EXPECT_EQ(1u, instanceChild->GeometryCount());
+
+  // visuals sharing a material share its copy
+  auto instanceRed = instance->Material("red");
+  ASSERT_NE(nullptr, instanceRed);
+  EXPECT_NE(red, instanceRed);
+  EXPECT_EQ(red->Diffuse(), instanceRed->Diffuse());
+  EXPECT_EQ(instanceRed, instanceParent->Material());
+  EXPECT_EQ(instanceRed, instanceChild->Material());
+
+  // the instance is independent of the scene
+  instanceParent->SetLocalPosition(5, 5, 5);
+  instanceRed->SetDiffuse(0.0, 1.0, 0.0);
+  EXPECT_EQ(math::Vector3d(1, 2, 3), parent->LocalPosition());
+  EXPECT_EQ(math::Color(1.0f, 0.0f, 0.0f), red->Diffuse());
+
+  // destroying the scene leaves the instance usable
+  engine->DestroyScene(scene);
+  auto box = instance->CreateVisual();
+  box->AddGeometry(instance->CreateBox());
+  instance->RootVisual()->AddChild(box);
+  auto mesh = std::dynamic_pointer_cast<Mesh>(
+      instanceParent->GeometryByIndex(0u));
+  ASSERT_NE(nullptr, mesh);
+  EXPECT_EQ(1u, mesh->SubMeshCount());
+
+  // Clean up
+  engine->DestroyScene(instance);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::Snapshot(const std::string &_renderEngine)
+{
+  auto engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine << "' is not supported" << std::endl;
+    return;
+  }
+
+  auto scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  auto red = scene->CreateMaterial("red");
+  red->SetDiffuse(1.0, 0.0, 0.0);
+  red->SetRoughness(0.25f);
+  red->SetCastShadows(false);
+
+  auto parent = scene->CreateVisual("parent");
+  parent->SetLocalPose(math::Pose3d(1, 2, 3, 0, 0, 0.5));
+  parent->AddGeometry(scene->CreateBox());
+  parent->SetMaterial(red, false);
+  parent->SetVisibilityFlags(0x2u);
+  scene->RootVisual()->AddChild(parent);
+
+  auto child = scene->CreateVisual("child");
+  child->SetLocalPosition(0, 0, 1);
+  child->SetLocalScale(0.5, 0.5, 0.5);
+  child->AddGeometry(scene->CreateSphere());
+  child->SetMaterial(red, false);
+  parent->AddChild(child);
+
+  // sensors are not saved
+  auto camera = scene->CreateCamera("camera");
+  scene->RootVisual()->AddChild(camera);
+
+  std::string filename =
+      common::joinPaths(PROJECT_BUILD_PATH, "scene_snapshot.bin");
+  EXPECT_TRUE(scene->SaveSnapshot(filename));
+
+  auto other = engine->CreateScene("other");
+  ASSERT_NE(nullptr, other);
+  EXPECT_TRUE(other->LoadSnapshot(filename));
+  EXPECT_EQ(2u, other->VisualCount());
+  EXPECT_EQ(0u, other->SensorCount());
+
+  auto loadedParent = other->VisualByName("parent");
+  ASSERT_NE(nullptr, loadedParent);
+  EXPECT_EQ(other->RootVisual(), loadedParent->Parent());
+  EXPECT_EQ(parent->LocalPose(), loadedParent->LocalPose());
+  EXPECT_EQ(0x2u, loadedParent->VisibilityFlags());
+  ASSERT_EQ(1u, loadedParent->GeometryCount());
+  auto mesh = std::dynamic_pointer_cast<Mesh>(
+      loadedParent->GeometryByIndex(0u));
+  ASSERT_NE(nullptr, mesh);
+  EXPECT_EQ("unit_box", mesh->Descriptor().meshName);
+
+  auto loadedChild = other->VisualByName("child");
+  ASSERT_NE(nullptr, loadedChild);
+  EXPECT_EQ(loadedParent, loadedChild->Parent());
+  EXPECT_EQ(child->LocalPose(), loadedChild->LocalPose());
+  EXPECT_EQ(child->LocalScale(), loadedChild->LocalScale());
+
+  // visuals sharing a material share the loaded material
+  auto loadedRed = other->Material("red");
+  ASSERT_NE(nullptr, loadedRed);
+  EXPECT_EQ(red->Diffuse(), loadedRed->Diffuse());
+  EXPECT_FLOAT_EQ(0.25f, loadedRed->Roughness());
+  EXPECT_FALSE(loadedRed->CastShadows());
+  EXPECT_EQ(loadedRed, loadedParent->Material());
+  EXPECT_EQ(loadedRed, loadedChild->Material());
+
+  // loading again renames the visuals whose name is taken
+  EXPECT_TRUE(other->LoadSnapshot(filename));
+  EXPECT_EQ(4u, other->VisualCount());
+
+  // truncated and missing files leave the scene unchanged
+  std::string truncated =
+      common::joinPaths(PROJECT_BUILD_PATH, "scene_snapshot_truncated.bin");
+  {
+    std::ifstream in(filename, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(in)),
+        std::istreambuf_iterator<char>());
+    std::ofstream out(truncated, std::ios::binary);
+    out << data.substr(0u, data.size() - 4u);
+  }
+  EXPECT_FALSE(other->LoadSnapshot(truncated));
+  EXPECT_FALSE(other->LoadSnapshot(filename + ".missing"));
+  EXPECT_EQ(4u, other->VisualCount());
+
+  common::removeFile(filename);
+  common::removeFile(truncated);
+
+  // Clean up
+  engine->DestroyScene(other);
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::BakeStatic(const std::string &_renderEngine)
+{
+  auto engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine << "' is not supported" << std::endl;
+    return;
+  }
+
+  auto scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  auto red = scene->CreateMaterial("red");
+  red->SetDiffuse(1.0, 0.0, 0.0);
+  auto green = scene->CreateMaterial("green");
+  green->SetDiffuse(0.0, 1.0, 0.0);
+
+  // two boxes with distinct copies of the same material and a sphere with
+  // another material, in the same chunk
+  auto parent = scene->CreateVisual("parent");
+  parent->AddGeometry(scene->CreateBox());
+  parent->SetMaterial(red);
+  scene->RootVisual()->AddChild(parent);
+
+  auto child = scene->CreateVisual("child");
+  child->SetLocalPosition(1, 0, 0);
+  child->AddGeometry(scene->CreateBox());
+  child->SetMaterial(red);
+  parent->AddChild(child);
+
+  auto sphere = scene->CreateVisual("sphere");
+  sphere->SetLocalPosition(0, 2, 0);
+  sphere->AddGeometry(scene->CreateSphere());
+  sphere->SetMaterial(green);
+  scene->RootVisual()->AddChild(sphere);
+
+  // a labeled box, and a box in another chunk
+  auto labeled = scene->CreateVisual("labeled");
+  labeled->SetLocalPosition(0, -2, 0);
+  labeled->AddGeometry(scene->CreateBox());
+  labeled->SetMaterial(red);
+  labeled->SetUserData("label", 5);
+  scene->RootVisual()->AddChild(labeled);
+
+  auto distant = scene->CreateVisual("distant");
+  distant->SetLocalPosition(200, 0, 0);
+  distant->AddGeometry(scene->CreateBox());
+  distant->SetMaterial(red);
+  scene->RootVisual()->AddChild(distant);
+
+  EXPECT_EQ(nullptr, scene->BakeStatic({}));
+  EXPECT_EQ(nullptr, scene->BakeStatic({parent}, 0.0));
+
+  VisualPtr baked =
+      scene->BakeStatic({parent, sphere, labeled, distant, child});
+  ASSERT_NE(nullptr, baked);
+  EXPECT_EQ(scene->RootVisual(), baked->Parent());
+  ASSERT_EQ(3u, baked->ChildCount());
+
+  // the visuals are kept without their geometries
+  EXPECT_EQ(0u, parent->GeometryCount());
+  EXPECT_EQ(0u, child->GeometryCount());
+  EXPECT_EQ(0u, sphere->GeometryCount());
+  EXPECT_EQ(1u, parent->ChildCount());
+
+  unsigned int labeledCount = 0u;
+  unsigned int subMeshCount = 0u;
+  for (unsigned int i = 0; i < baked->ChildCount(); ++i)
+  {
+    auto chunk = std::dynamic_pointer_cast<Visual>(baked->ChildByIndex(i));
+    ASSERT_NE(nullptr, chunk);
+    ASSERT_EQ(1u, chunk->GeometryCount());
+    auto mesh = std::dynamic_pointer_cast<Mesh>(chunk->GeometryByIndex(0));
+    ASSERT_NE(nullptr, mesh);
+    subMeshCount += mesh->SubMeshCount();
+    for (unsigned int j = 0; j < mesh->SubMeshCount(); ++j)
+      EXPECT_NE(nullptr, mesh->SubMeshByIndex(j)->Material());
+
+    Variant label = chunk->UserData("label");
+    if (std::holds_alternative<int>(label))
+    {
+      EXPECT_EQ(5, std::get<int>(label));
+      ++labeledCount;
+    }
+  }
+  EXPECT_EQ(1u, labeledCount);
+  // the boxes near the origin share a submesh, the sphere has its own
+  EXPECT_EQ(4u, subMeshCount);
+
+  // nothing left to bake
+  EXPECT_EQ(nullptr, scene->BakeStatic({parent}));
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
 /////////////////////////////////////////////////
 TEST_P(SceneTest, Scene)
 {
@@ -826,6 +1212,30 @@ TEST_P(SceneTest, Sky)
   Sky(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(SceneTest, SetLocalPoses)
+{
+  SetLocalPoses(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, CreateInstance)
+{
+  CreateInstance(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, Snapshot)
+{
+  Snapshot(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, BakeStatic)
+{
+  BakeStatic(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(Scene, SceneTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
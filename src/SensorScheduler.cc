@@ -0,0 +1,300 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Profiler.hh>
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/SensorScheduler.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Private data for the SensorScheduler class
+class ignition::rendering::SensorSchedulerPrivate
+{
+  /// \brief A scheduled sensor
+  public: struct Entry
+  {
+    /// \brief Scheduled sensor
+    SensorPtr sensor;
+
+    /// \brief Update rate in Hz, 0 to render on every Update
+    double rate = 0.0;
+
+    /// \brief Time between two renders, zero to render on every Update
+    std::chrono::steady_clock::duration period =
+        std::chrono::steady_clock::duration::zero();
+
+    /// \brief Time the sensor is due next
+    std::chrono::steady_clock::duration next =
+        std::chrono::steady_clock::duration::zero();
+
+    /// \brief Time the sensor was last rendered
+    std::chrono::steady_clock::duration rendered =
+        std::chrono::steady_clock::duration::zero();
+
+    /// \brief True until the sensor is rendered for the first time
+    bool pending = true;
+
+    /// \brief Rank of the kind of sensor, sensors of the same kind are
+    /// rendered next to each other
+    size_t kind = 0u;
+  };
+
+  /// \brief Find the entry of a sensor
+  /// \param[in] _sensor Sensor to find
+  /// \return Iterator to the entry, entries.end() if not scheduled
+  public: std::vector<Entry>::iterator Find(const SensorPtr &_sensor);
+
+  /// \brief Scene the sensors belong to
+  public: Scene *scene = nullptr;
+
+  /// \brief Scheduled sensors in the order they were added
+  public: std::vector<Entry> entries;
+
+  /// \brief Kinds of sensors in the order they were first added
+  public: std::vector<std::type_index> kinds;
+
+  /// \brief Maximum number of sensors rendered by an Update, 0 for no
+  /// limit
+  public: unsigned int maxSensorsPerUpdate = 0u;
+
+  /// \brief Time of the last Update
+  public: std::chrono::steady_clock::duration time =
+      std::chrono::steady_clock::duration::zero();
+
+  /// \brief Sensors due in the current Update, kept to reuse its memory
+  public: std::vector<SensorPtr> due;
+};
+
+//////////////////////////////////////////////////
+std::vector<SensorSchedulerPrivate::Entry>::iterator
+    SensorSchedulerPrivate::Find(const SensorPtr &_sensor)
+{
+  return std::find_if(this->entries.begin(), this->entries.end(),
+      [&_sensor](const Entry &_entry) {return _entry.sensor == _sensor;});
+}
+
+//////////////////////////////////////////////////
+SensorScheduler::SensorScheduler(Scene *_scene)
+  : dataPtr(new SensorSchedulerPrivate)
+{
+  this->dataPtr->scene = _scene;
+}
+
+//////////////////////////////////////////////////
+SensorScheduler::~SensorScheduler() = default;
+
+//////////////////////////////////////////////////
+bool SensorScheduler::AddSensor(const SensorPtr &_sensor, double _rate)
+{
+  if (!_sensor || !this->dataPtr->scene->HasSensor(_sensor))
+  {
+    ignerr << "Unable to schedule a sensor that is not in scene: "
+           << this->dataPtr->scene->Name() << std::endl;
+    return false;
+  }
+
+  if (!std::dynamic_pointer_cast<Camera>(_sensor))
+  {
+    ignerr << "Unable to schedule sensor: " << _sensor->Name()
+           << ". Only cameras can be scheduled." << std::endl;
+    return false;
+  }
+
+  if (_rate < 0.0)
+  {
+    ignerr << "Invalid update rate for sensor: " << _sensor->Name()
+           << ". The rate must not be negative." << std::endl;
+    return false;
+  }
+
+  auto it = this->dataPtr->Find(_sensor);
+  if (it == this->dataPtr->entries.end())
+  {
+    SensorSchedulerPrivate::Entry entry;
+    entry.sensor = _sensor;
+
+    const Sensor &sensor = *_sensor;
+    std::type_index kind(typeid(sensor));
+    auto &kinds = this->dataPtr->kinds;
+    entry.kind = std::find(kinds.begin(), kinds.end(), kind) - kinds.begin();
+    if (entry.kind == kinds.size())
+      kinds.push_back(kind);
+
+    this->dataPtr->entries.push_back(entry);
+    it = this->dataPtr->entries.end() - 1;
+  }
+
+  it->rate = _rate;
+  it->period = std::chrono::steady_clock::duration::zero();
+  if (_rate > 0.0)
+  {
+    it->period = std::chrono::duration_cast<
+        std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / _rate));
+  }
+  it->pending = true;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool SensorScheduler::RemoveSensor(const SensorPtr &_sensor)
+{
+  auto it = this->dataPtr->Find(_sensor);
+  if (it == this->dataPtr->entries.end())
+    return false;
+
+  this->dataPtr->entries.erase(it);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool SensorScheduler::HasSensor(const SensorPtr &_sensor) const
+{
+  return this->dataPtr->Find(_sensor) != this->dataPtr->entries.end();
+}
+
+//////////////////////////////////////////////////
+unsigned int SensorScheduler::SensorCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->entries.size());
+}
+
+//////////////////////////////////////////////////
+double SensorScheduler::UpdateRate(const SensorPtr &_sensor) const
+{
+  auto it = this->dataPtr->Find(_sensor);
+  if (it == this->dataPtr->entries.end())
+    return 0.0;
+  return it->rate;
+}
+
+//////////////////////////////////////////////////
+void SensorScheduler::SetMaxSensorsPerUpdate(unsigned int _count)
+{
+  this->dataPtr->maxSensorsPerUpdate = _count;
+}
+
+//////////////////////////////////////////////////
+unsigned int SensorScheduler::MaxSensorsPerUpdate() const
+{
+  return this->dataPtr->maxSensorsPerUpdate;
+}
+
+//////////////////////////////////////////////////
+unsigned int SensorScheduler::Update(
+    const std::chrono::steady_clock::duration &_time)
+{
+  IGN_PROFILE("SensorScheduler::Update");
+  auto &entries = this->dataPtr->entries;
+
+  // time went back, e.g. the simulation was reset
+  bool reset = _time < this->dataPtr->time;
+  this->dataPtr->time = _time;
+
+  // forget the sensors destroyed in the scene
+  Scene *scene = this->dataPtr->scene;
+  entries.erase(std::remove_if(entries.begin(), entries.end(),
+      [scene](const SensorSchedulerPrivate::Entry &_entry)
+      {
+        return !scene->HasSensor(_entry.sensor);
+      }), entries.end());
+
+  // all sensors are due after going back in time, including the ones
+  // deferred by the limit of an earlier Update
+  if (reset)
+  {
+    for (auto &entry : entries)
+      entry.pending = true;
+  }
+
+  std::vector<size_t> dueIndices;
+  for (size_t i = 0u; i < entries.size(); ++i)
+  {
+    if (entries[i].pending || _time >= entries[i].next)
+      dueIndices.push_back(i);
+  }
+
+  // render the sensors that waited the longest when there are too many,
+  // the others are rendered by the next Update
+  unsigned int maxCount = this->dataPtr->maxSensorsPerUpdate;
+  if (maxCount > 0u && dueIndices.size() > maxCount)
+  {
+    std::stable_sort(dueIndices.begin(), dueIndices.end(),
+        [&entries](size_t _a, size_t _b)
+        {
+          if (entries[_a].pending != entries[_b].pending)
+            return entries[_a].pending;
+          return entries[_a].rendered < entries[_b].rendered;
+        });
+    dueIndices.resize(maxCount);
+  }
+
+  // group the due sensors by kind so that the passes of the same
+  // compositor workspaces and shaders follow each other
+  std::vector<std::pair<size_t, size_t>> dueEntries;
+  for (size_t i : dueIndices)
+  {
+    auto &entry = entries[i];
+    dueEntries.emplace_back(entry.kind, i);
+
+    // skip the frames missed by more than one period
+    entry.next = entry.pending ? _time : entry.next + entry.period;
+    if (entry.next <= _time)
+      entry.next = _time + entry.period;
+    entry.rendered = _time;
+    entry.pending = false;
+  }
+
+  if (dueEntries.empty())
+    return 0u;
+
+  std::sort(dueEntries.begin(), dueEntries.end());
+  auto &due = this->dataPtr->due;
+  due.clear();
+  for (const auto &dueEntry : dueEntries)
+    due.push_back(entries[dueEntry.second].sensor);
+
+  // one scene update and one GPU flush for all of them
+  scene->RenderSensors(due);
+
+  // do not keep the sensors alive
+  due.clear();
+  return static_cast<unsigned int>(dueEntries.size());
+}
+
+//////////////////////////////////////////////////
+std::chrono::steady_clock::duration SensorScheduler::NextUpdateTime() const
+{
+  auto next = std::chrono::steady_clock::duration::max();
+  for (const auto &entry : this->dataPtr->entries)
+  {
+    if (entry.pending || entry.period.count() == 0)
+      return this->dataPtr->time;
+    next = std::min(next, entry.next);
+  }
+  return next;
+}
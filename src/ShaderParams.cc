@@ -29,6 +29,9 @@ class ignition::rendering::ShaderParamsPrivate
 
   /// \brief true if the parameters have been modified since last cleared
   public: bool isDirty = false;
+
+  /// \brief Names of the parameters modified since last cleared
+  public: std::unordered_set<std::string> dirtyParams;
 };
 
 
@@ -128,6 +131,7 @@ ShaderParams::~ShaderParams()
 ShaderParam &ShaderParams::operator[](const std::string &_name)
 {
   this->dataPtr->isDirty = true;
+  this->dataPtr->dirtyParams.insert(_name);
   return this->dataPtr->parameters[_name];
 }
 
@@ -159,8 +163,15 @@ bool ShaderParams::IsDirty() const
   return this->dataPtr->isDirty;
 }
 
+//////////////////////////////////////////////////
+const std::unordered_set<std::string> &ShaderParams::DirtyParams() const
+{
+  return this->dataPtr->dirtyParams;
+}
+
 //////////////////////////////////////////////////
 void ShaderParams::ClearDirty()
 {
   this->dataPtr->isDirty = false;
+  this->dataPtr->dirtyParams.clear();
 }
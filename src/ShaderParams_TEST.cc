@@ -73,6 +73,21 @@ TEST(ShaderParams, ConstRangeForLoopDoesNotDirty)
   EXPECT_FALSE(params.IsDirty());
 }
 
+/////////////////////////////////////////////////
+TEST(ShaderParams, DirtyParams)
+{
+  ShaderParams params;
+  params["a"] = 1.0f;
+  params["b"] = 2.0f;
+  EXPECT_EQ(2u, params.DirtyParams().size());
+  params.ClearDirty();
+  EXPECT_TRUE(params.DirtyParams().empty());
+
+  params["b"] = 3.0f;
+  ASSERT_EQ(1u, params.DirtyParams().size());
+  EXPECT_EQ(1u, params.DirtyParams().count("b"));
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -36,7 +36,7 @@ class TextTest : public testing::Test,
 /////////////////////////////////////////////////
 void TextTest::Text(const std::string &_renderEngine)
 {
-  if (_renderEngine != "ogre")
+  if (_renderEngine != "ogre" && _renderEngine != "ogre2")
   {
     igndbg << "Text not supported yet in rendering engine: "
             << _renderEngine << std::endl;
@@ -72,6 +72,9 @@ void ThermalCameraTest::ThermalCamera(const std::string &_renderEngine)
   camera->SetLinearResolution(resolution);
   EXPECT_FLOAT_EQ(resolution, camera->LinearResolution());
 
+  // thermal cameras default to a lower level of detail
+  EXPECT_DOUBLE_EQ(0.5, camera->LodBias());
+
   // Clean up
   engine->DestroyScene(scene);
   rendering::unloadEngine(engine->Name());
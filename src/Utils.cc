@@ -20,6 +20,28 @@
 #include <X11/Xresource.h>
 #endif
 
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+#include <set>
+#include <sstream>
+#include <tuple>
+#include <utility>
+
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Util.hh>
+
 #include "ignition/math/Plane.hh"
 #include "ignition/math/Vector2.hh"
 #include "ignition/math/Vector3.hh"
@@ -28,6 +50,116 @@
 #include "ignition/rendering/RayQuery.hh"
 #include "ignition/rendering/Utils.hh"
 
+namespace
+{
+/// \brief Quadric error metric of a vertex: the sum of the squared
+/// distances to a set of planes, stored as the upper triangle of a
+/// symmetric 4x4 matrix
+struct Quadric
+{
+  /// \brief Default constructor, no planes
+  Quadric() = default;
+
+  /// \brief Quadric of a single plane
+  /// \param[in] _normal Unit normal of the plane
+  /// \param[in] _d Offset of the plane, _normal.Dot(p) + _d = 0 on it
+  /// \param[in] _weight Weight of the plane
+  Quadric(const ignition::math::Vector3d &_normal, double _d, double _weight)
+  {
+    double a = _normal.X();
+    double b = _normal.Y();
+    double c = _normal.Z();
+    this->m = {a * a, a * b, a * c, a * _d, b * b, b * c, b * _d,
+               c * c, c * _d, _d * _d};
+    for (double &v : this->m)
+      v *= _weight;
+  }
+
+  /// \brief Add the planes of another quadric
+  /// \param[in] _other Quadric to add
+  /// \return This quadric
+  Quadric &operator+=(const Quadric &_other)
+  {
+    for (unsigned int i = 0; i < this->m.size(); ++i)
+      this->m[i] += _other.m[i];
+    return *this;
+  }
+
+  /// \brief Error of a point
+  /// \param[in] _p Point
+  /// \return Weighted sum of the squared distances of the point to the
+  /// planes
+  double Error(const ignition::math::Vector3d &_p) const
+  {
+    double x = _p.X();
+    double y = _p.Y();
+    double z = _p.Z();
+    return this->m[0] * x * x + 2 * this->m[1] * x * y +
+        2 * this->m[2] * x * z + 2 * this->m[3] * x + this->m[4] * y * y +
+        2 * this->m[5] * y * z + 2 * this->m[6] * y + this->m[7] * z * z +
+        2 * this->m[8] * z + this->m[9];
+  }
+
+  /// \brief Upper triangle of the matrix, row by row
+  std::array<double, 10> m{};
+};
+
+/// \brief Candidate collapse of a vertex onto another
+struct Collapse
+{
+  /// \brief Error introduced by the collapse
+  double cost;
+
+  /// \brief Vertex removed by the collapse
+  unsigned int from;
+
+  /// \brief Vertex the removed vertex is collapsed onto
+  unsigned int to;
+
+  /// \brief Versions of the two vertices when the cost was computed. The
+  /// collapse is stale if either vertex changed since.
+  unsigned int fromVersion;
+
+  /// \brief Version of the target vertex, see fromVersion
+  unsigned int toVersion;
+
+  /// \brief Order collapses by cost for a min heap
+  bool operator>(const Collapse &_other) const
+  {
+    return this->cost > _other.cost;
+  }
+};
+
+/// \brief Weight of the planes preserving the open borders of a mesh
+const double kBorderWeight = 1000.0;
+
+/// \brief Number of vertices of the simulated post transform cache used
+/// to order triangles
+const std::size_t kVertexCacheSize = 16u;
+
+/// \brief Largest number of triangles of a cluster reordered by
+/// optimizeOverdraw
+const std::size_t kMaxOverdrawClusterSize = 256u;
+
+/// \brief Check whether an index list is a triangle list
+/// \param[in] _indices Index list
+/// \param[in] _vertexCount Number of vertices the list may index
+/// \return True if the list is made of triangles indexing existing
+/// vertices
+bool isTriangleList(const std::vector<unsigned int> &_indices,
+    std::size_t _vertexCount)
+{
+  if (_indices.size() % 3u != 0u)
+    return false;
+  for (unsigned int index : _indices)
+  {
+    if (index >= _vertexCount)
+      return false;
+  }
+  return true;
+}
+}
+
 namespace ignition
 {
 namespace rendering
@@ -53,7 +185,29 @@ math::Vector3d screenToScene(
   _rayQuery->SetFromCamera(
       _camera, math::Vector2d(nx, ny));
 
-  _rayResult = _rayQuery->ClosestPoint();
+  // resolve the point from the depth of the last rendered frame if the
+  // camera keeps it, which costs a texel read instead of a scene query
+  double depth = 0.0;
+  if (_camera->DepthPickingEnabled() && _camera->DepthAt(_screenPos, depth))
+  {
+    _rayResult = RayQueryResult();
+    const math::Vector3d direction = _rayQuery->Direction();
+    const double cosAngle = direction.Dot(
+        _camera->WorldRotation() * math::Vector3d::UnitX);
+    if (std::isfinite(depth) && cosAngle > 0.0)
+    {
+      // the depth is measured along the view direction from the camera
+      _rayResult.point = _camera->WorldPosition() +
+          direction * (depth / cosAngle);
+      _rayResult.distance = _rayResult.point.Distance(_rayQuery->Origin());
+      return _rayResult.point;
+    }
+  }
+  else
+  {
+    _rayResult = _rayQuery->ClosestPoint();
+  }
+
   if (_rayResult)
     return _rayResult.point;
 
@@ -229,6 +383,483 @@ ignition::math::AxisAlignedBox transformAxisAlignedBox(
   }
   return ignition::math::AxisAlignedBox(min, max);
 }
+
+/////////////////////////////////////////////////
+std::vector<unsigned int> simplifyTriangles(
+    const std::vector<math::Vector3d> &_positions,
+    const std::vector<unsigned int> &_indices,
+    std::size_t _targetTriangleCount)
+{
+  if (_indices.size() % 3u != 0u ||
+      _indices.size() / 3u <= _targetTriangleCount)
+  {
+    return _indices;
+  }
+
+  for (unsigned int index : _indices)
+  {
+    if (index >= _positions.size())
+      return _indices;
+  }
+
+  // weld the vertices at the same position, collapses work on the welded
+  // vertices and the triangles keep the original vertex of each corner
+  std::vector<math::Vector3d> points;
+  std::vector<unsigned int> welded(_positions.size());
+  std::vector<unsigned int> representative;
+  std::map<std::tuple<double, double, double>, unsigned int> pointIds;
+  for (unsigned int i = 0; i < _positions.size(); ++i)
+  {
+    const math::Vector3d &p = _positions[i];
+    auto it = pointIds.emplace(std::make_tuple(p.X(), p.Y(), p.Z()),
+        static_cast<unsigned int>(points.size())).first;
+    if (it->second == points.size())
+    {
+      points.push_back(p);
+      representative.push_back(i);
+    }
+    welded[i] = it->second;
+  }
+
+  std::vector<std::array<unsigned int, 3>> triangles;
+  std::vector<std::array<unsigned int, 3>> corners;
+  for (std::size_t i = 0; i < _indices.size(); i += 3u)
+  {
+    std::array<unsigned int, 3> t = {welded[_indices[i]],
+        welded[_indices[i + 1]], welded[_indices[i + 2]]};
+    // triangles that are already degenerate are dropped
+    if (t[0] == t[1] || t[1] == t[2] || t[2] == t[0])
+      continue;
+    triangles.push_back(t);
+    corners.push_back({_indices[i], _indices[i + 1], _indices[i + 2]});
+  }
+
+  auto triangleNormal = [&points](const std::array<unsigned int, 3> &_t)
+  {
+    return (points[_t[1]] - points[_t[0]]).Cross(
+        points[_t[2]] - points[_t[0]]);
+  };
+
+  // accumulate the planes of the triangles around each vertex and count
+  // the triangles of each edge to find the open borders
+  std::vector<Quadric> quadrics(points.size());
+  std::vector<std::vector<unsigned int>> vertexTriangles(points.size());
+  std::map<std::pair<unsigned int, unsigned int>, unsigned int> edgeUsers;
+  for (unsigned int i = 0; i < triangles.size(); ++i)
+  {
+    const auto &t = triangles[i];
+    math::Vector3d n = triangleNormal(t);
+    double length = n.Length();
+    if (length > 0)
+    {
+      n /= length;
+      Quadric q(n, -n.Dot(points[t[0]]), length * 0.5);
+      for (unsigned int k = 0; k < 3u; ++k)
+        quadrics[t[k]] += q;
+    }
+
+    for (unsigned int k = 0; k < 3u; ++k)
+    {
+      vertexTriangles[t[k]].push_back(i);
+      unsigned int a = t[k];
+      unsigned int b = t[(k + 1) % 3];
+      ++edgeUsers[std::make_pair(std::min(a, b), std::max(a, b))];
+    }
+  }
+
+  // planes perpendicular to the triangles along the open borders keep the
+  // border vertices on the border
+  for (const auto &t : triangles)
+  {
+    math::Vector3d n = triangleNormal(t).Normalized();
+    for (unsigned int k = 0; k < 3u; ++k)
+    {
+      unsigned int a = t[k];
+      unsigned int b = t[(k + 1) % 3];
+      if (edgeUsers[std::make_pair(std::min(a, b), std::max(a, b))] != 1u)
+        continue;
+
+      math::Vector3d edge = points[b] - points[a];
+      math::Vector3d borderNormal = edge.Cross(n).Normalized();
+      Quadric q(borderNormal, -borderNormal.Dot(points[a]),
+          kBorderWeight * edge.SquaredLength());
+      quadrics[a] += q;
+      quadrics[b] += q;
+    }
+  }
+
+  std::vector<unsigned int> versions(points.size(), 0u);
+  std::vector<bool> alive(points.size(), true);
+  std::vector<bool> removed(triangles.size(), false);
+  std::priority_queue<Collapse, std::vector<Collapse>,
+      std::greater<Collapse>> collapses;
+  auto addCollapses = [&](unsigned int _a, unsigned int _b)
+  {
+    Quadric q = quadrics[_a];
+    q += quadrics[_b];
+    collapses.push({q.Error(points[_b]), _a, _b, versions[_a], versions[_b]});
+    collapses.push({q.Error(points[_a]), _b, _a, versions[_b], versions[_a]});
+  };
+  for (const auto &edge : edgeUsers)
+    addCollapses(edge.first.first, edge.first.second);
+
+  std::size_t triangleCount = triangles.size();
+  while (triangleCount > _targetTriangleCount && !collapses.empty())
+  {
+    Collapse c = collapses.top();
+    collapses.pop();
+    if (!alive[c.from] || !alive[c.to] ||
+        versions[c.from] != c.fromVersion || versions[c.to] != c.toVersion)
+    {
+      continue;
+    }
+
+    // reject collapses that would flip the remaining triangles
+    bool flips = false;
+    for (unsigned int i : vertexTriangles[c.from])
+    {
+      const auto &t = triangles[i];
+      if (removed[i] || t[0] == c.to || t[1] == c.to || t[2] == c.to)
+        continue;
+
+      auto moved = t;
+      for (unsigned int &v : moved)
+        v = (v == c.from) ? c.to : v;
+      math::Vector3d before = triangleNormal(t);
+      math::Vector3d after = triangleNormal(moved);
+      if (after == math::Vector3d::Zero || before.Dot(after) <= 0)
+      {
+        flips = true;
+        break;
+      }
+    }
+    if (flips)
+      continue;
+
+    // remove the triangles of the collapsed edge, remembering which
+    // original vertex replaces the removed one on each side of a seam
+    std::map<unsigned int, unsigned int> replacements;
+    for (unsigned int i : vertexTriangles[c.from])
+    {
+      const auto &t = triangles[i];
+      if (removed[i] || (t[0] != c.to && t[1] != c.to && t[2] != c.to))
+        continue;
+
+      removed[i] = true;
+      --triangleCount;
+      unsigned int fromCorner = 0u;
+      unsigned int toCorner = 0u;
+      for (unsigned int k = 0; k < 3u; ++k)
+      {
+        if (t[k] == c.from)
+          fromCorner = corners[i][k];
+        else if (t[k] == c.to)
+          toCorner = corners[i][k];
+      }
+      replacements[fromCorner] = toCorner;
+    }
+
+    for (unsigned int i : vertexTriangles[c.from])
+    {
+      if (removed[i])
+        continue;
+
+      for (unsigned int k = 0; k < 3u; ++k)
+      {
+        if (triangles[i][k] != c.from)
+          continue;
+        triangles[i][k] = c.to;
+        auto it = replacements.find(corners[i][k]);
+        corners[i][k] = (it != replacements.end()) ?
+            it->second : representative[c.to];
+      }
+      vertexTriangles[c.to].push_back(i);
+    }
+
+    quadrics[c.to] += quadrics[c.from];
+    alive[c.from] = false;
+    vertexTriangles[c.from].clear();
+    ++versions[c.to];
+
+    // the costs of the edges around the target vertex changed
+    std::set<unsigned int> neighbors;
+    for (unsigned int i : vertexTriangles[c.to])
+    {
+      if (removed[i])
+        continue;
+      for (unsigned int v : triangles[i])
+      {
+        if (v != c.to)
+          neighbors.insert(v);
+      }
+    }
+    for (unsigned int v : neighbors)
+      addCollapses(c.to, v);
+  }
+
+  std::vector<unsigned int> result;
+  result.reserve(triangleCount * 3u);
+  for (unsigned int i = 0; i < triangles.size(); ++i)
+  {
+    if (!removed[i])
+      result.insert(result.end(), corners[i].begin(), corners[i].end());
+  }
+  return result;
+}
+
+/////////////////////////////////////////////////
+std::vector<unsigned int> optimizeVertexCache(
+    const std::vector<unsigned int> &_indices, std::size_t _vertexCount)
+{
+  if (!isTriangleList(_indices, _vertexCount))
+    return _indices;
+
+  // triangles using each vertex, the ones of vertex v are stored from
+  // offsets[v] to offsets[v + 1]
+  std::vector<std::size_t> offsets(_vertexCount + 1u, 0u);
+  for (unsigned int index : _indices)
+    ++offsets[index + 1u];
+  for (std::size_t v = 0u; v < _vertexCount; ++v)
+    offsets[v + 1u] += offsets[v];
+  std::vector<std::size_t> triangles(_indices.size());
+  std::vector<std::size_t> fill(offsets.begin(), offsets.end() - 1);
+  for (std::size_t i = 0u; i < _indices.size(); ++i)
+    triangles[fill[_indices[i]]++] = i / 3u;
+
+  // number of triangles of each vertex not emitted yet
+  std::vector<std::size_t> live(_vertexCount);
+  for (std::size_t v = 0u; v < _vertexCount; ++v)
+    live[v] = offsets[v + 1u] - offsets[v];
+
+  // a vertex is in the cache if it entered it less than kVertexCacheSize
+  // insertions ago
+  std::vector<std::size_t> cacheTime(_vertexCount, 0u);
+  std::size_t time = kVertexCacheSize + 1u;
+
+  const std::size_t kNone = std::numeric_limits<std::size_t>::max();
+  std::vector<bool> emitted(_indices.size() / 3u, false);
+  std::vector<unsigned int> deadEnds;
+  std::vector<unsigned int> candidates;
+  std::size_t nextInput = 0u;
+  std::vector<unsigned int> result;
+  result.reserve(_indices.size());
+
+  std::size_t fan = 0u;
+  while (fan != kNone)
+  {
+    // emit the remaining triangles around the fanning vertex
+    candidates.clear();
+    for (std::size_t i = offsets[fan]; i < offsets[fan + 1u]; ++i)
+    {
+      std::size_t t = triangles[i];
+      if (emitted[t])
+        continue;
+      emitted[t] = true;
+      for (std::size_t c = 0u; c < 3u; ++c)
+      {
+        unsigned int v = _indices[t * 3u + c];
+        result.push_back(v);
+        deadEnds.push_back(v);
+        candidates.push_back(v);
+        --live[v];
+        if (time - cacheTime[v] > kVertexCacheSize)
+          cacheTime[v] = time++;
+      }
+    }
+
+    // fan next around the oldest vertex that stays in the cache while its
+    // remaining triangles are emitted, or any vertex with triangles left
+    fan = kNone;
+    std::size_t bestPriority = 0u;
+    for (unsigned int v : candidates)
+    {
+      if (live[v] == 0u)
+        continue;
+      std::size_t priority = 0u;
+      if (time - cacheTime[v] + 2u * live[v] <= kVertexCacheSize)
+        priority = time - cacheTime[v];
+      if (fan == kNone || priority > bestPriority)
+      {
+        fan = v;
+        bestPriority = priority;
+      }
+    }
+
+    // dead end, restart from a recently used vertex, or from the next
+    // vertex in input order that has triangles left
+    while (fan == kNone && !deadEnds.empty())
+    {
+      unsigned int v = deadEnds.back();
+      deadEnds.pop_back();
+      if (live[v] > 0u)
+        fan = v;
+    }
+    for (; fan == kNone && nextInput < _vertexCount; ++nextInput)
+    {
+      if (live[nextInput] > 0u)
+        fan = nextInput;
+    }
+  }
+  return result;
+}
+
+/////////////////////////////////////////////////
+std::vector<unsigned int> optimizeOverdraw(
+    const std::vector<math::Vector3d> &_positions,
+    const std::vector<unsigned int> &_indices)
+{
+  if (!isTriangleList(_indices, _positions.size()) || _indices.empty())
+    return _indices;
+
+  // split the list where a triangle misses the cache for all its vertices,
+  // reordering the clusters then costs no additional vertex transforms
+  std::vector<std::size_t> cacheTime(_positions.size(), 0u);
+  std::size_t time = kVertexCacheSize + 1u;
+  std::vector<std::size_t> clusterStarts;
+  std::size_t triangleCount = _indices.size() / 3u;
+  for (std::size_t t = 0u; t < triangleCount; ++t)
+  {
+    unsigned int misses = 0u;
+    for (std::size_t c = 0u; c < 3u; ++c)
+    {
+      unsigned int v = _indices[t * 3u + c];
+      if (time - cacheTime[v] > kVertexCacheSize)
+      {
+        cacheTime[v] = time++;
+        ++misses;
+      }
+    }
+    if (clusterStarts.empty() || misses == 3u ||
+        t - clusterStarts.back() >= kMaxOverdrawClusterSize)
+    {
+      clusterStarts.push_back(t);
+    }
+  }
+  clusterStarts.push_back(triangleCount);
+
+  // area weighted centroid and normal of each cluster
+  std::size_t clusterCount = clusterStarts.size() - 1u;
+  std::vector<math::Vector3d> centroids(clusterCount);
+  std::vector<math::Vector3d> normals(clusterCount);
+  math::Vector3d meshCentroid;
+  double meshArea = 0.0;
+  for (std::size_t k = 0u; k < clusterCount; ++k)
+  {
+    double area = 0.0;
+    for (std::size_t t = clusterStarts[k]; t < clusterStarts[k + 1u]; ++t)
+    {
+      const math::Vector3d &p0 = _positions[_indices[t * 3u]];
+      const math::Vector3d &p1 = _positions[_indices[t * 3u + 1u]];
+      const math::Vector3d &p2 = _positions[_indices[t * 3u + 2u]];
+      math::Vector3d normal = (p1 - p0).Cross(p2 - p0);
+      double triangleArea = 0.5 * normal.Length();
+      centroids[k] += (p0 + p1 + p2) / 3.0 * triangleArea;
+      normals[k] += normal;
+      area += triangleArea;
+    }
+    meshCentroid += centroids[k];
+    meshArea += area;
+    if (area > 0.0)
+      centroids[k] /= area;
+    normals[k].Normalize();
+  }
+  if (meshArea <= 0.0)
+    return _indices;
+  meshCentroid /= meshArea;
+
+  // clusters facing away from the center are on the outside of the mesh
+  // and occlude the others
+  std::vector<double> outwardness(clusterCount);
+  for (std::size_t k = 0u; k < clusterCount; ++k)
+    outwardness[k] = (centroids[k] - meshCentroid).Dot(normals[k]);
+  std::vector<std::size_t> order(clusterCount);
+  for (std::size_t k = 0u; k < clusterCount; ++k)
+    order[k] = k;
+  std::stable_sort(order.begin(), order.end(),
+      [&outwardness](std::size_t _a, std::size_t _b)
+      {
+        return outwardness[_a] > outwardness[_b];
+      });
+
+  std::vector<unsigned int> result;
+  result.reserve(_indices.size());
+  for (std::size_t k : order)
+  {
+    result.insert(result.end(), _indices.begin() + clusterStarts[k] * 3u,
+        _indices.begin() + clusterStarts[k + 1u] * 3u);
+  }
+  return result;
+}
+
+/////////////////////////////////////////////////
+std::vector<unsigned int> optimizeVertexFetch(
+    const std::vector<unsigned int> &_indices, std::size_t _vertexCount)
+{
+  const unsigned int kUnused = std::numeric_limits<unsigned int>::max();
+  std::vector<unsigned int> remap(_vertexCount, kUnused);
+  unsigned int next = 0u;
+  for (unsigned int index : _indices)
+  {
+    if (index >= _vertexCount)
+    {
+      for (std::size_t v = 0u; v < _vertexCount; ++v)
+        remap[v] = static_cast<unsigned int>(v);
+      return remap;
+    }
+    if (remap[index] == kUnused)
+      remap[index] = next++;
+  }
+  for (unsigned int &r : remap)
+  {
+    if (r == kUnused)
+      r = next++;
+  }
+  return remap;
+}
+
+/////////////////////////////////////////////////
+std::string cacheDirectory(const std::string &_name)
+{
+  std::string home;
+  common::env(IGN_HOMEDIR, home);
+  return common::joinPaths(home, ".ignition", "rendering", _name);
+}
+
+/////////////////////////////////////////////////
+bool writeFileAtomically(const std::string &_file,
+    const std::function<bool(const std::string &)> &_write)
+{
+  // the process id keeps the name unique across processes and the counter
+  // across the threads of this process
+  static std::atomic<unsigned int> counter{0u};
+#ifdef _WIN32
+  const int pid = _getpid();
+#else
+  const int pid = getpid();
+#endif
+  std::stringstream tmpFile;
+  tmpFile << _file << "." << pid << "." << counter++ << ".tmp";
+
+  if (!_write(tmpFile.str()))
+  {
+    common::removeFile(tmpFile.str());
+    return false;
+  }
+
+  if (!common::moveFile(tmpFile.str(), _file))
+  {
+    common::removeFile(tmpFile.str());
+    return common::isFile(_file);
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::recursive_mutex &meshManagerMutex()
+{
+  static std::recursive_mutex mutex;
+  return mutex;
+}
 }
 }
 }
@@ -15,7 +15,16 @@
 */
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
 
 #include "ignition/rendering/Camera.hh"
 #include "ignition/rendering/RayQuery.hh"
@@ -164,6 +173,29 @@ void UtilTest::ClickToScene(const std::string &_renderEngine)
   EXPECT_TRUE(rayResult);
   EXPECT_NEAR(6.5 - camera->NearClipPlane(), rayResult.distance, 1e-4);
   EXPECT_EQ(box->Id(), rayResult.objectId);
+
+  // resolve the point from the depth of the last rendered frame
+  EXPECT_FALSE(camera->DepthPickingEnabled());
+  if (_renderEngine == "ogre2")
+  {
+    camera->SetAntiAliasing(0);
+    camera->SetDepthPickingEnabled(true);
+    EXPECT_TRUE(camera->DepthPickingEnabled());
+    camera->Update();
+
+    result = screenToScene(centerClick, camera, rayQuery, rayResult);
+
+    EXPECT_NEAR(0.5, result.Z(), 1e-3);
+    EXPECT_NEAR(0.0, result.X(), 1e-3);
+    EXPECT_NEAR(0.0, result.Y(), 1e-3);
+    EXPECT_TRUE(rayResult);
+    EXPECT_NEAR(6.5 - camera->NearClipPlane(), rayResult.distance, 1e-3);
+
+    // nothing is rendered at the corner of the image
+    result = screenToScene(math::Vector2i(0, 0), camera, rayQuery,
+        rayResult);
+    EXPECT_FALSE(rayResult);
+  }
 }
 
 /////////////////////////////////////////////////
@@ -176,6 +208,211 @@ INSTANTIATE_TEST_CASE_P(ClickToScene, UtilTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
 
+/////////////////////////////////////////////////
+TEST(UtilsTest, SimplifyTriangles)
+{
+  // flat 10x10 grid of quads
+  const unsigned int size = 10u;
+  std::vector<math::Vector3d> positions;
+  std::vector<unsigned int> indices;
+  for (unsigned int i = 0; i <= size; ++i)
+  {
+    for (unsigned int j = 0; j <= size; ++j)
+      positions.push_back(math::Vector3d(i, j, 0));
+  }
+  for (unsigned int i = 0; i < size; ++i)
+  {
+    for (unsigned int j = 0; j < size; ++j)
+    {
+      unsigned int a = i * (size + 1) + j;
+      unsigned int b = a + 1;
+      unsigned int c = a + size + 1;
+      unsigned int d = c + 1;
+      indices.insert(indices.end(), {a, c, b, b, c, d});
+    }
+  }
+
+  // nothing to reduce
+  EXPECT_EQ(indices, simplifyTriangles(positions, indices, 200u));
+
+  // invalid triangle lists are returned as is
+  std::vector<unsigned int> invalid = {0u, 1u};
+  EXPECT_EQ(invalid, simplifyTriangles(positions, invalid, 0u));
+
+  // the grid is flat and its border is preserved so it reduces to two
+  // triangles covering the same area
+  std::vector<unsigned int> simplified =
+      simplifyTriangles(positions, indices, 2u);
+  ASSERT_EQ(6u, simplified.size());
+  double area = 0;
+  for (unsigned int i = 0; i < simplified.size(); i += 3u)
+  {
+    math::Vector3d p0 = positions[simplified[i]];
+    math::Vector3d p1 = positions[simplified[i + 1]];
+    math::Vector3d p2 = positions[simplified[i + 2]];
+    area += 0.5 * (p1 - p0).Cross(p2 - p0).Z();
+  }
+  EXPECT_DOUBLE_EQ(size * size, area);
+
+  // intermediate target
+  simplified = simplifyTriangles(positions, indices, 50u);
+  EXPECT_EQ(150u, simplified.size());
+}
+
+/////////////////////////////////////////////////
+/// \brief Compute the average number of vertex transforms per triangle of
+/// a triangle list with a 16 vertex FIFO post transform cache
+double transformsPerTriangle(const std::vector<unsigned int> &_indices,
+    std::size_t _vertexCount)
+{
+  std::vector<std::size_t> cacheTime(_vertexCount, 0u);
+  std::size_t time = 17u;
+  std::size_t misses = 0u;
+  for (unsigned int index : _indices)
+  {
+    if (time - cacheTime[index] > 16u)
+    {
+      cacheTime[index] = time++;
+      ++misses;
+    }
+  }
+  return static_cast<double>(misses) / (_indices.size() / 3u);
+}
+
+/////////////////////////////////////////////////
+TEST(UtilsTest, OptimizeVertexCache)
+{
+  // flat 30x30 grid of quads with its triangles shuffled
+  const unsigned int size = 30u;
+  std::vector<math::Vector3d> positions;
+  for (unsigned int i = 0; i <= size; ++i)
+  {
+    for (unsigned int j = 0; j <= size; ++j)
+      positions.push_back(math::Vector3d(i, j, 0));
+  }
+  std::vector<std::array<unsigned int, 3>> triangles;
+  for (unsigned int i = 0; i < size; ++i)
+  {
+    for (unsigned int j = 0; j < size; ++j)
+    {
+      unsigned int a = i * (size + 1) + j;
+      unsigned int b = a + 1;
+      unsigned int c = a + size + 1;
+      unsigned int d = c + 1;
+      triangles.push_back({a, c, b});
+      triangles.push_back({b, c, d});
+    }
+  }
+  std::shuffle(triangles.begin(), triangles.end(), std::mt19937(1u));
+  std::vector<unsigned int> indices;
+  for (const auto &t : triangles)
+    indices.insert(indices.end(), t.begin(), t.end());
+
+  // invalid triangle lists are returned as is
+  std::vector<unsigned int> invalid = {0u, 1u};
+  EXPECT_EQ(invalid, optimizeVertexCache(invalid, positions.size()));
+  invalid = {0u, 1u, 5000u};
+  EXPECT_EQ(invalid, optimizeVertexCache(invalid, positions.size()));
+
+  std::vector<unsigned int> optimized =
+      optimizeVertexCache(indices, positions.size());
+  ASSERT_EQ(indices.size(), optimized.size());
+  EXPECT_LT(transformsPerTriangle(optimized, positions.size()),
+      0.5 * transformsPerTriangle(indices, positions.size()));
+
+  // same triangles with the same winding, in a different order
+  auto sortedTriangles = [](const std::vector<unsigned int> &_list)
+  {
+    std::vector<std::array<unsigned int, 3>> result;
+    for (unsigned int i = 0; i < _list.size(); i += 3u)
+    {
+      std::array<unsigned int, 3> t = {_list[i], _list[i + 1], _list[i + 2]};
+      std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+      result.push_back(t);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  };
+  EXPECT_EQ(sortedTriangles(indices), sortedTriangles(optimized));
+
+  std::vector<unsigned int> overdraw = optimizeOverdraw(positions, optimized);
+  EXPECT_EQ(sortedTriangles(indices), sortedTriangles(overdraw));
+  EXPECT_LT(transformsPerTriangle(overdraw, positions.size()),
+      0.5 * transformsPerTriangle(indices, positions.size()));
+
+  // vertices are numbered in order of first use
+  std::vector<unsigned int> remap =
+      optimizeVertexFetch(overdraw, positions.size() + 1u);
+  ASSERT_EQ(positions.size() + 1u, remap.size());
+  EXPECT_EQ(0u, remap[overdraw[0]]);
+  EXPECT_EQ(1u, remap[overdraw[1]]);
+  EXPECT_EQ(2u, remap[overdraw[2]]);
+  // the unused vertex is last
+  EXPECT_EQ(positions.size(), remap.back());
+  std::vector<unsigned int> sortedRemap = remap;
+  std::sort(sortedRemap.begin(), sortedRemap.end());
+  for (unsigned int i = 0; i < sortedRemap.size(); ++i)
+    EXPECT_EQ(i, sortedRemap[i]);
+}
+
+/////////////////////////////////////////////////
+TEST(UtilsTest, WriteFileAtomically)
+{
+  std::string dir = common::joinPaths(PROJECT_BUILD_PATH, "write_atomically");
+  common::removeAll(dir);
+  ASSERT_TRUE(common::createDirectories(dir));
+  std::string file = common::joinPaths(dir, "file.txt");
+
+  auto readFile = [](const std::string &_file)
+  {
+    std::ifstream in(_file);
+    std::stringstream content;
+    content << in.rdbuf();
+    return content.str();
+  };
+
+  // the content is written to a temporary file next to the file
+  std::string tmpFile;
+  EXPECT_TRUE(writeFileAtomically(file, [&](const std::string &_tmpFile)
+  {
+    tmpFile = _tmpFile;
+    std::ofstream out(_tmpFile);
+    out << "first";
+    out.close();
+    return static_cast<bool>(out);
+  }));
+  EXPECT_EQ(dir, common::parentPath(tmpFile));
+  EXPECT_NE(file, tmpFile);
+  EXPECT_EQ("first", readFile(file));
+  EXPECT_FALSE(common::exists(tmpFile));
+
+  // each write uses another temporary file
+  std::string otherTmpFile;
+  EXPECT_TRUE(writeFileAtomically(file, [&](const std::string &_tmpFile)
+  {
+    otherTmpFile = _tmpFile;
+    std::ofstream out(_tmpFile);
+    out << "second";
+    out.close();
+    return static_cast<bool>(out);
+  }));
+  EXPECT_NE(tmpFile, otherTmpFile);
+  EXPECT_EQ("second", readFile(file));
+
+  // a failed write leaves the file as it was and no temporary file behind
+  EXPECT_FALSE(writeFileAtomically(file, [&](const std::string &_tmpFile)
+  {
+    tmpFile = _tmpFile;
+    std::ofstream out(_tmpFile);
+    out << "partial";
+    return false;
+  }));
+  EXPECT_EQ("second", readFile(file));
+  EXPECT_FALSE(common::exists(tmpFile));
+
+  common::removeAll(dir);
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -61,6 +61,12 @@ class VisualTest : public testing::Test,
 
   /// \brief Test cloning visuals
   public: void Clone(const std::string &_renderEngine);
+
+  /// \brief Test skipping unchanged visuals in PreRender
+  public: void PreRenderDirty(const std::string &_renderEngine);
+
+  /// \brief Test static visuals
+  public: void Static(const std::string &_renderEngine);
 };
 
 /////////////////////////////////////////////////
@@ -579,6 +585,59 @@ void VisualTest::BoundingBox(const std::string &_renderEngine)
   EXPECT_EQ(ignition::math::Vector3d(0.5, 1.5, 2.5), boundingBox.Min());
   EXPECT_EQ(ignition::math::Vector3d(1.5, 2.5, 3.5), boundingBox.Max());
 
+  // the bounding boxes follow changes made after they were last queried
+  visual->SetWorldPosition(0.0, 0.0, 1.0);
+  boundingBox = visual->BoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(-0.5, -0.5, 0.5), boundingBox.Min());
+  EXPECT_EQ(ignition::math::Vector3d(0.5, 0.5, 1.5), boundingBox.Max());
+
+  // child visual
+  VisualPtr child = scene->CreateVisual();
+  ASSERT_NE(nullptr, child);
+  child->AddGeometry(scene->CreateBox());
+  child->SetLocalPosition(2.0, 0.0, 0.0);
+  visual->AddChild(child);
+
+  localBoundingBox = visual->LocalBoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(-0.5, -0.5, -0.5), localBoundingBox.Min());
+  EXPECT_EQ(ignition::math::Vector3d(2.5, 0.5, 0.5), localBoundingBox.Max());
+
+  // moving the child changes the bounds of the parent
+  child->SetLocalPosition(0.0, 2.0, 0.0);
+  localBoundingBox = visual->LocalBoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(-0.5, -0.5, -0.5), localBoundingBox.Min());
+  EXPECT_EQ(ignition::math::Vector3d(0.5, 2.5, 0.5), localBoundingBox.Max());
+
+  // moving the parent changes the world bounds of the child
+  boundingBox = child->BoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(-0.5, 1.5, 0.5), boundingBox.Min());
+  EXPECT_EQ(ignition::math::Vector3d(0.5, 2.5, 1.5), boundingBox.Max());
+  visual->SetWorldPosition(0.0, 0.0, 2.0);
+  boundingBox = child->BoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(-0.5, 1.5, 1.5), boundingBox.Min());
+  EXPECT_EQ(ignition::math::Vector3d(0.5, 2.5, 2.5), boundingBox.Max());
+
+  // hidden and removed children are left out
+  child->SetVisible(false);
+  localBoundingBox = visual->LocalBoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(0.5, 0.5, 0.5), localBoundingBox.Max());
+  child->SetVisible(true);
+  localBoundingBox = visual->LocalBoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(0.5, 2.5, 0.5), localBoundingBox.Max());
+  visual->RemoveChild(child);
+  localBoundingBox = visual->LocalBoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(0.5, 0.5, 0.5), localBoundingBox.Max());
+
+  // scale
+  visual->SetLocalScale(2.0);
+  localBoundingBox = visual->LocalBoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(-1.0, -1.0, -1.0), localBoundingBox.Min());
+  EXPECT_EQ(ignition::math::Vector3d(1.0, 1.0, 1.0), localBoundingBox.Max());
+
+  // geometry
+  visual->RemoveGeometries();
+  EXPECT_EQ(ignition::math::AxisAlignedBox(), visual->LocalBoundingBox());
+
   // Clean up
   engine->DestroyScene(scene);
   rendering::unloadEngine(engine->Name());
@@ -763,6 +822,131 @@ TEST_P(VisualTest, Clone)
   Clone(GetParam());
 }
 
+/////////////////////////////////////////////////
+void VisualTest::PreRenderDirty(const std::string &_renderEngine)
+{
+  if (_renderEngine == "optix")
+  {
+    igndbg << "PreRender dirty tracking not supported yet in rendering "
+           << "engine: " << _renderEngine << std::endl;
+    return;
+  }
+
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+
+  VisualPtr parent = scene->CreateVisual();
+  ASSERT_NE(nullptr, parent);
+  VisualPtr child = scene->CreateVisual();
+  ASSERT_NE(nullptr, child);
+  child->AddGeometry(scene->CreateBox());
+  parent->AddChild(child);
+  scene->RootVisual()->AddChild(parent);
+
+  // new visuals are updated by the next PreRender
+  EXPECT_TRUE(parent->PreRenderDirty());
+  EXPECT_TRUE(child->PreRenderDirty());
+
+  // visuals with only meshes and no custom shaders are clean afterwards
+  scene->PreRender();
+  EXPECT_FALSE(parent->PreRenderDirty());
+  EXPECT_FALSE(child->PreRenderDirty());
+
+  // changing a child marks its ancestors dirty too
+  child->SetLocalPosition(1, 2, 3);
+  EXPECT_TRUE(child->PreRenderDirty());
+  EXPECT_TRUE(parent->PreRenderDirty());
+  EXPECT_TRUE(scene->RootVisual()->PreRenderDirty());
+
+  scene->PreRender();
+  EXPECT_FALSE(parent->PreRenderDirty());
+  EXPECT_FALSE(child->PreRenderDirty());
+
+  // explicitly marking a visual dirty
+  child->MarkPreRenderDirty();
+  EXPECT_TRUE(parent->PreRenderDirty());
+  scene->PreRender();
+  EXPECT_FALSE(parent->PreRenderDirty());
+
+  // visuals with other geometries are updated every frame
+  VisualPtr capsuleVis = scene->CreateVisual();
+  ASSERT_NE(nullptr, capsuleVis);
+  capsuleVis->AddGeometry(scene->CreateCapsule());
+  parent->AddChild(capsuleVis);
+  scene->PreRender();
+  EXPECT_TRUE(capsuleVis->PreRenderDirty());
+  EXPECT_TRUE(parent->PreRenderDirty());
+  EXPECT_FALSE(child->PreRenderDirty());
+
+  // clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(VisualTest, PreRenderDirty)
+{
+  PreRenderDirty(GetParam());
+}
+
+/////////////////////////////////////////////////
+void VisualTest::Static(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene10");
+
+  VisualPtr visual = scene->CreateVisual();
+  ASSERT_NE(nullptr, visual);
+  EXPECT_FALSE(visual->Static());
+
+  // geometries added before and after the visual is made static
+  visual->AddGeometry(scene->CreateBox());
+  visual->SetStatic(true);
+  EXPECT_TRUE(visual->Static());
+  visual->AddGeometry(scene->CreateBox());
+  EXPECT_EQ(2u, visual->GeometryCount());
+
+  // a static visual can still be moved
+  visual->SetWorldPosition(1.0, 2.0, 3.0);
+  EXPECT_EQ(ignition::math::Vector3d(1.0, 2.0, 3.0), visual->WorldPosition());
+  ignition::math::AxisAlignedBox boundingBox = visual->BoundingBox();
+  EXPECT_EQ(ignition::math::Vector3d(0.5, 1.5, 2.5), boundingBox.Min());
+  EXPECT_EQ(ignition::math::Vector3d(1.5, 2.5, 3.5), boundingBox.Max());
+
+  // clones keep the static state
+  VisualPtr clone = visual->Clone("", scene->RootVisual());
+  ASSERT_NE(nullptr, clone);
+  EXPECT_TRUE(clone->Static());
+
+  visual->SetStatic(false);
+  EXPECT_FALSE(visual->Static());
+  visual->SetWorldPosition(0.0, 0.0, 0.0);
+  EXPECT_EQ(ignition::math::Vector3d::Zero, visual->WorldPosition());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(VisualTest, Static)
+{
+  Static(GetParam());
+}
 
 INSTANTIATE_TEST_CASE_P(Visual, VisualTest,
     RENDER_ENGINE_VALUES,
@@ -286,3 +286,29 @@ RenderPassSystemPtr BaseRenderEngine::RenderPassSystem() const
   }
   return this->renderPassSystem;
 }
+
+//////////////////////////////////////////////////
+rendering::MemoryStats BaseRenderEngine::MemoryStats() const
+{
+  rendering::MemoryStats stats;
+  unsigned int count = this->SceneCount();
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    ScenePtr scene = this->SceneByIndex(i);
+    if (scene)
+      stats += scene->MemoryStats();
+  }
+  return stats;
+}
+
+//////////////////////////////////////////////////
+RenderThreadPtr BaseRenderEngine::RenderThread() const
+{
+  return this->renderThread;
+}
+
+//////////////////////////////////////////////////
+void BaseRenderEngine::SetRenderThread(RenderThreadPtr _thread)
+{
+  this->renderThread = _thread;
+}
@@ -15,13 +15,31 @@
  *
  */
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <set>
 #include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
+#include <ignition/math/Frustum.hh>
 #include <ignition/math/Helpers.hh>
+#include <ignition/math/Matrix3.hh>
+#include <ignition/math/Matrix4.hh>
 
 #include <ignition/common/Console.hh>
 #include <ignition/common/Mesh.hh>
 #include <ignition/common/MeshManager.hh>
+#include <ignition/common/Profiler.hh>
+#include <ignition/common/SubMesh.hh>
 
 #include "ignition/common/Time.hh"
 
@@ -30,8 +48,10 @@
 #include "ignition/rendering/BoundingBoxCamera.hh"
 #include "ignition/rendering/COMVisual.hh"
 #include "ignition/rendering/InertiaVisual.hh"
+#include "ignition/rendering/InstancedVisual.hh"
 #include "ignition/rendering/JointVisual.hh"
 #include "ignition/rendering/LidarVisual.hh"
+#include "ignition/rendering/Light.hh"
 #include "ignition/rendering/LightVisual.hh"
 #include "ignition/rendering/Camera.hh"
 #include "ignition/rendering/Capsule.hh"
@@ -39,12 +59,17 @@
 #include "ignition/rendering/GizmoVisual.hh"
 #include "ignition/rendering/GpuRays.hh"
 #include "ignition/rendering/Grid.hh"
+#include "ignition/rendering/Mesh.hh"
 #include "ignition/rendering/ParticleEmitter.hh"
 #include "ignition/rendering/RayQuery.hh"
+#include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderTarget.hh"
 #include "ignition/rendering/Text.hh"
 #include "ignition/rendering/ThermalCamera.hh"
+#include "ignition/rendering/Utils.hh"
+#include "ignition/rendering/WideAngleCamera.hh"
 #include "ignition/rendering/SegmentationCamera.hh"
+#include "ignition/rendering/SensorScheduler.hh"
 #include "ignition/rendering/Visual.hh"
 #include "ignition/rendering/base/BaseStorage.hh"
 #include "ignition/rendering/base/BaseScene.hh"
@@ -52,6 +77,18 @@
 using namespace ignition;
 using namespace rendering;
 
+/// \brief Number of measured frames the frame budget averages the GPU time
+/// over before adjusting the resolution scales
+static const unsigned int kFrameBudgetSamples = 8u;
+
+/// \brief Fraction of the frame budget the GPU time must stay below for
+/// the resolution scales to go up again
+static const double kFrameBudgetHeadroom = 0.8;
+
+/// \brief Step the resolution scales are rounded to, so that small changes
+/// of the GPU time don't rebuild the render targets
+static const double kResolutionScaleStep = 1.0 / 16.0;
+
 // Prevent deprecation warnings for simTime
 #ifndef _WIN32
 # pragma GCC diagnostic push
@@ -71,6 +108,7 @@ BaseScene::BaseScene(unsigned int _id, const std::string &_name) :
 //////////////////////////////////////////////////
 BaseScene::~BaseScene()
 {
+  this->DiscardCommands();
 }
 #ifndef _WIN32
 # pragma GCC diagnostic pop
@@ -192,6 +230,118 @@ VisualPtr BaseScene::VisualAt(const CameraPtr &_camera,
   return visual;
 }
 
+//////////////////////////////////////////////////
+std::vector<VisualPtr> BaseScene::VisualsInBox(
+    const math::AxisAlignedBox &_box)
+{
+  IGN_PROFILE("BaseScene::VisualsInBox");
+  this->UpdateVisualIndex();
+  return this->IndexedVisuals(this->visualIndex.Intersect(_box));
+}
+
+//////////////////////////////////////////////////
+std::vector<VisualPtr> BaseScene::VisualsInSphere(
+    const math::Vector3d &_center, double _radius)
+{
+  IGN_PROFILE("BaseScene::VisualsInSphere");
+  this->UpdateVisualIndex();
+  return this->IndexedVisuals(this->visualIndex.Intersect(_center, _radius));
+}
+
+//////////////////////////////////////////////////
+std::vector<VisualPtr> BaseScene::VisualsInFrustum(const CameraPtr &_camera)
+{
+  if (!_camera)
+  {
+    ignerr << "Unable to get the visuals in the frustum of a null camera"
+           << std::endl;
+    return {};
+  }
+
+  IGN_PROFILE("BaseScene::VisualsInFrustum");
+  this->UpdateVisualIndex();
+
+  // both cameras and math::Frustum look along +x
+  math::Frustum frustum(_camera->NearClipPlane(), _camera->FarClipPlane(),
+      _camera->HFOV(), _camera->AspectRatio(), _camera->WorldPose());
+  return this->IndexedVisuals(this->visualIndex.Intersect(frustum));
+}
+
+//////////////////////////////////////////////////
+std::vector<VisualPtr> BaseScene::NearestVisuals(
+    const math::Vector3d &_point, unsigned int _count)
+{
+  IGN_PROFILE("BaseScene::NearestVisuals");
+  this->UpdateVisualIndex();
+  return this->IndexedVisuals(this->visualIndex.Nearest(_point, _count));
+}
+
+//////////////////////////////////////////////////
+std::vector<VisualPtr> BaseScene::IndexedVisuals(
+    const std::vector<unsigned int> &_ids)
+{
+  std::vector<VisualPtr> visuals;
+  visuals.reserve(_ids.size());
+  for (auto id : _ids)
+  {
+    VisualPtr visual = this->Visuals()->GetById(id);
+    if (visual)
+      visuals.push_back(visual);
+    else
+      this->visualIndex.Remove(id);
+  }
+  return visuals;
+}
+
+//////////////////////////////////////////////////
+void BaseScene::UpdateVisualIndex()
+{
+  // moving a visual by less than the margin of the index only updates its
+  // box, so refreshing every visual is cheap compared to the queries it
+  // speeds up
+  unsigned int indexed = 0u;
+  auto refresh = [&]()
+  {
+    indexed = 0u;
+    for (unsigned int i = 0; i < this->Visuals()->Size(); ++i)
+    {
+      VisualPtr visual = this->Visuals()->GetByIndex(i);
+      if (!this->InSceneGraph(visual))
+      {
+        this->visualIndex.Remove(visual->Id());
+        continue;
+      }
+      this->visualIndex.Update(visual->Id(), visual->BoundingBox());
+      if (this->visualIndex.Contains(visual->Id()))
+        ++indexed;
+    }
+  };
+  refresh();
+
+  // visuals destroyed since the last query are still indexed, start over
+  if (indexed != this->visualIndex.Size())
+  {
+    this->visualIndex.Clear();
+    refresh();
+  }
+  this->visualIndexBuilt = true;
+}
+
+//////////////////////////////////////////////////
+bool BaseScene::InSceneGraph(const NodePtr &_node) const
+{
+  VisualPtr root = this->RootVisual();
+  if (!_node || !root || _node->Id() == root->Id())
+    return false;
+
+  for (NodePtr node = _node->Parent(); node; node = node->Parent())
+  {
+    if (node->Id() == root->Id())
+      return true;
+  }
+  return false;
+}
+
 //////////////////////////////////////////////////
 void BaseScene::SetAmbientLight(double _r, double _g, double _b, double _a)
 {
@@ -355,6 +505,30 @@ void BaseScene::DestroyNodeByIndex(unsigned int _index)
   this->nodes->DestroyByIndex(_index);
 }
 
+//////////////////////////////////////////////////
+unsigned int BaseScene::SetLocalPoses(const std::vector<unsigned int> &_ids,
+    const std::vector<math::Pose3d> &_poses)
+{
+  if (_ids.size() != _poses.size())
+  {
+    ignerr << "Unable to set local poses: got " << _ids.size()
+           << " node ids but " << _poses.size() << " poses" << std::endl;
+    return 0u;
+  }
+
+  unsigned int count = 0u;
+  for (std::size_t i = 0u; i < _ids.size(); ++i)
+  {
+    NodePtr node = this->nodes->GetById(_ids[i]);
+    if (!node)
+      continue;
+
+    node->SetLocalPose(_poses[i]);
+    ++count;
+  }
+  return count;
+}
+
 //////////////////////////////////////////////////
 void BaseScene::DestroyNodes()
 {
@@ -876,6 +1050,36 @@ SegmentationCameraPtr BaseScene::CreateSegmentationCamera(
   return (result) ? camera : nullptr;
 }
 
+//////////////////////////////////////////////////
+WideAngleCameraPtr BaseScene::CreateWideAngleCamera()
+{
+  unsigned int objId = this->CreateObjectId();
+  return this->CreateWideAngleCamera(objId);
+}
+
+//////////////////////////////////////////////////
+WideAngleCameraPtr BaseScene::CreateWideAngleCamera(const unsigned int _id)
+{
+  std::string objName = this->CreateObjectName(_id, "WideAngleCamera");
+  return this->CreateWideAngleCamera(_id, objName);
+}
+
+//////////////////////////////////////////////////
+WideAngleCameraPtr BaseScene::CreateWideAngleCamera(const std::string &_name)
+{
+  unsigned int objId = this->CreateObjectId();
+  return this->CreateWideAngleCamera(objId, _name);
+}
+
+//////////////////////////////////////////////////
+WideAngleCameraPtr BaseScene::CreateWideAngleCamera(const unsigned int _id,
+    const std::string &_name)
+{
+  WideAngleCameraPtr camera = this->CreateWideAngleCameraImpl(_id, _name);
+  bool result = this->RegisterSensor(camera);
+  return (result) ? camera : nullptr;
+}
+
 //////////////////////////////////////////////////
 GpuRaysPtr BaseScene::CreateGpuRays()
 {
@@ -1259,6 +1463,18 @@ LidarVisualPtr BaseScene::CreateLidarVisual(unsigned int _id,
   return (result) ? lidar : nullptr;
 }
 
+//////////////////////////////////////////////////
+InstancedVisualPtr BaseScene::CreateInstancedVisual(
+    const MeshDescriptor &_desc, MaterialPtr _material, unsigned int _count)
+{
+  unsigned int objId = this->CreateObjectId();
+  std::string objName = this->CreateObjectName(objId, "InstancedVisual");
+  InstancedVisualPtr visual = this->CreateInstancedVisualImpl(objId, objName,
+      _desc, _material, _count);
+  bool result = this->RegisterVisual(visual);
+  return (result) ? visual : nullptr;
+}
+
 //////////////////////////////////////////////////
 WireBoxPtr BaseScene::CreateWireBox()
 {
@@ -1386,9 +1602,174 @@ bool BaseScene::SkyEnabled() const
 //////////////////////////////////////////////////
 void BaseScene::PreRender()
 {
+  IGN_PROFILE("BaseScene::PreRender");
+  this->ProcessCommands();
+  this->UpdateResolutionScales();
   this->RootVisual()->PreRender();
 }
 
+//////////////////////////////////////////////////
+void BaseScene::SetFrameBudget(double _ms)
+{
+  this->frameBudget = std::max(0.0, _ms);
+  this->frameBudgetTimeSum = 0.0;
+  this->frameBudgetSamples = 0u;
+
+  if (this->frameBudget <= 0.0)
+    this->ScaleResolutions(0.0);
+}
+
+//////////////////////////////////////////////////
+double BaseScene::FrameBudget() const
+{
+  return this->frameBudget;
+}
+
+//////////////////////////////////////////////////
+void BaseScene::UpdateResolutionScales()
+{
+  if (this->frameBudget <= 0.0)
+    return;
+
+  RenderStats stats = this->GpuStats();
+  if (stats.frameCount == 0u)
+  {
+    if (!this->frameBudgetWarned && this->SensorCount() > 0u)
+    {
+      ignwarn << "Frame budget of scene [" << this->Name() << "] has no "
+              << "effect without GPU timings, see Scene::GpuStats"
+              << std::endl;
+      this->frameBudgetWarned = true;
+    }
+    return;
+  }
+
+  // GPU results arrive a few frames late, so only new measurements are
+  // added, and they are averaged to smooth out single slow frames
+  if (stats.frameCount == this->frameBudgetFrameCount)
+    return;
+  this->frameBudgetFrameCount = stats.frameCount;
+  this->frameBudgetTimeSum += stats.lastMs;
+  if (++this->frameBudgetSamples < kFrameBudgetSamples)
+    return;
+
+  double averageMs = this->frameBudgetTimeSum / this->frameBudgetSamples;
+  this->frameBudgetTimeSum = 0.0;
+  this->frameBudgetSamples = 0u;
+  if (averageMs <= 0.0)
+    return;
+
+  // the GPU time grows with the number of pixels, i.e. with the square of
+  // the scale. Limit the change per step, not all of the time scales.
+  double ratio = this->frameBudget / averageMs;
+  if (ratio >= 1.0 && ratio * kFrameBudgetHeadroom < 1.0)
+    return;
+  double factor = std::sqrt(ratio < 1.0 ? ratio : ratio * kFrameBudgetHeadroom);
+  this->ScaleResolutions(math::clamp(factor, 0.75, 1.25));
+}
+
+//////////////////////////////////////////////////
+void BaseScene::ScaleResolutions(double _factor)
+{
+  unsigned int count = this->SensorCount();
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    CameraPtr camera =
+        std::dynamic_pointer_cast<Camera>(this->SensorByIndex(i));
+    if (!camera || camera->MinResolutionScale() >= 1.0)
+      continue;
+
+    // a factor of 0 restores full resolution. Otherwise the scale moves at
+    // least one step in the direction of the factor
+    double scale = 1.0;
+    if (_factor > 0.0)
+    {
+      double steps = camera->ResolutionScale() * _factor /
+          kResolutionScaleStep;
+      steps = _factor < 1.0 ? std::floor(steps) : std::ceil(steps);
+      scale = math::clamp(steps * kResolutionScaleStep,
+          camera->MinResolutionScale(), 1.0);
+    }
+    if (!math::equal(scale, camera->ResolutionScale()))
+      camera->SetResolutionScale(scale);
+  }
+}
+
+//////////////////////////////////////////////////
+void BaseScene::QueueCommand(std::function<void()> _command)
+{
+  if (!_command)
+    return;
+
+  Command *command = new Command;
+  command->function = std::move(_command);
+  command->next = this->commands.load(std::memory_order_relaxed);
+  while (!this->commands.compare_exchange_weak(command->next, command,
+      std::memory_order_release, std::memory_order_relaxed))
+  {
+  }
+}
+
+//////////////////////////////////////////////////
+void BaseScene::PrepareMesh(const MeshDescriptor &_desc)
+{
+  // a mesh file is read into the mesh manager, where CreateMesh finds it
+  // later. The mesh manager is not thread safe, so the files of
+  // concurrent loader threads are read one at a time.
+  if (_desc.mesh || _desc.meshName.empty())
+    return;
+
+  std::lock_guard<std::recursive_mutex> lock(meshManagerMutex());
+  common::MeshManager *meshMgr = common::MeshManager::Instance();
+  if (!meshMgr->HasMesh(_desc.meshName))
+    meshMgr->Load(_desc.meshName);
+}
+
+//////////////////////////////////////////////////
+unsigned int BaseScene::ProcessCommands()
+{
+  Command *last = this->commands.exchange(nullptr, std::memory_order_acquire);
+  if (!last)
+    return 0u;
+
+  IGN_PROFILE("BaseScene::ProcessCommands");
+
+  // the list is linked from the last queued command, reverse it to run
+  // commands in the order they were queued
+  Command *first = nullptr;
+  while (last)
+  {
+    Command *next = last->next;
+    last->next = first;
+    first = last;
+    last = next;
+  }
+
+  unsigned int count = 0u;
+  while (first)
+  {
+    Command *next = first->next;
+    first->function();
+    delete first;
+    first = next;
+    ++count;
+  }
+  return count;
+}
+
+//////////////////////////////////////////////////
+void BaseScene::DiscardCommands()
+{
+  Command *command = this->commands.exchange(nullptr,
+      std::memory_order_acquire);
+  while (command)
+  {
+    Command *next = command->next;
+    delete command;
+    command = next;
+  }
+}
+
 //////////////////////////////////////////////////
 void BaseScene::PostRender()
 {
@@ -1411,19 +1792,1236 @@ bool BaseScene::LegacyAutoGpuFlush() const
   return true;
 }
 
+//////////////////////////////////////////////////
+void BaseScene::RenderSensors(const std::vector<SensorPtr> &_sensors)
+{
+  std::vector<CameraPtr> cameras;
+  cameras.reserve(_sensors.size());
+  for (const auto &sensor : _sensors)
+  {
+    CameraPtr camera = std::dynamic_pointer_cast<Camera>(sensor);
+    if (camera)
+      cameras.push_back(camera);
+  }
+
+  if (cameras.empty())
+    return;
+
+  this->PreRender();
+  for (auto &camera : cameras)
+    camera->Render();
+  for (auto &camera : cameras)
+    camera->PostRender();
+  if (!this->LegacyAutoGpuFlush())
+    this->PostRender();
+}
+
+//////////////////////////////////////////////////
+void BaseScene::WarmUp()
+{
+  std::vector<SensorPtr> sensors;
+  unsigned int count = this->SensorCount();
+  for (unsigned int i = 0; i < count; ++i)
+    sensors.push_back(this->SensorByIndex(i));
+  this->RenderSensors(sensors);
+}
+
+//////////////////////////////////////////////////
+SensorSchedulerPtr BaseScene::Scheduler()
+{
+  if (!this->scheduler)
+    this->scheduler = std::make_shared<SensorScheduler>(this);
+  return this->scheduler;
+}
+
+//////////////////////////////////////////////////
+RenderStats BaseScene::GpuStats() const
+{
+  RenderStats stats;
+  unsigned int count = this->SensorCount();
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    SensorPtr sensor = this->SensorByIndex(i);
+    if (!sensor)
+      continue;
+
+    RenderStats sensorStats = sensor->GpuStats();
+    if (sensorStats.frameCount == 0u)
+      continue;
+
+    stats.lastMs += sensorStats.lastMs;
+    stats.averageMs += sensorStats.averageMs;
+    stats.frameCount = std::max(stats.frameCount, sensorStats.frameCount);
+    for (const auto &pass : sensorStats.passes)
+    {
+      auto it = std::find_if(stats.passes.begin(), stats.passes.end(),
+          [&pass](const RenderPassStats &_p) {return _p.name == pass.name;});
+      if (it == stats.passes.end())
+      {
+        stats.passes.push_back(pass);
+      }
+      else
+      {
+        it->lastMs += pass.lastMs;
+        it->averageMs += pass.averageMs;
+      }
+    }
+  }
+  return stats;
+}
+
+//////////////////////////////////////////////////
+rendering::MemoryStats BaseScene::MemoryStats() const
+{
+  return rendering::MemoryStats();
+}
+
 //////////////////////////////////////////////////
 void BaseScene::Clear()
 {
   this->nodes->DestroyAll();
   this->DestroyMaterials();
+  this->visualIndex.Clear();
+  this->visualIndexBuilt = false;
   this->nextObjectId = ignition::math::MAX_UI16;
 }
 
+//////////////////////////////////////////////////
+void BaseScene::Reset()
+{
+  this->Clear();
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the copy of a material in a scene instance, creating it on
+/// first use so that objects sharing a material share its copy
+/// \param[in] _material Material to copy
+/// \param[in] _instance Scene instance
+/// \param[in,out] _copies Copies made so far, indexed by material
+/// \return Copy of the material
+static MaterialPtr copyMaterial(const MaterialPtr &_material,
+    const ScenePtr &_instance, std::map<MaterialPtr, MaterialPtr> &_copies)
+{
+  auto it = _copies.find(_material);
+  if (it != _copies.end())
+    return it->second;
+
+  // materials registered by the engine, e.g. "Default/White", exist in all
+  // scenes
+  MaterialPtr copy = _instance->Material(_material->Name());
+  if (!copy)
+  {
+    copy = _instance->CreateMaterial(_material->Name());
+    copy->CopyFrom(_material);
+  }
+  _copies[_material] = copy;
+  return copy;
+}
+
+//////////////////////////////////////////////////
+/// \brief Copy a light to a scene instance
+/// \param[in] _light Light to copy
+/// \param[in] _instance Scene instance
+/// \return Copy of the light, null if the light type is not supported
+static LightPtr copyLight(const LightPtr &_light, const ScenePtr &_instance)
+{
+  LightPtr result;
+  if (auto dir = std::dynamic_pointer_cast<DirectionalLight>(_light))
+  {
+    DirectionalLightPtr light =
+        _instance->CreateDirectionalLight(_light->Name());
+    light->SetDirection(dir->Direction());
+    result = light;
+  }
+  else if (auto spot = std::dynamic_pointer_cast<SpotLight>(_light))
+  {
+    SpotLightPtr light = _instance->CreateSpotLight(_light->Name());
+    light->SetDirection(spot->Direction());
+    light->SetInnerAngle(spot->InnerAngle());
+    light->SetOuterAngle(spot->OuterAngle());
+    light->SetFalloff(spot->Falloff());
+    result = light;
+  }
+  else if (std::dynamic_pointer_cast<PointLight>(_light))
+  {
+    result = _instance->CreatePointLight(_light->Name());
+  }
+
+  if (!result)
+    return result;
+
+  result->SetDiffuseColor(_light->DiffuseColor());
+  result->SetSpecularColor(_light->SpecularColor());
+  result->SetAttenuationConstant(_light->AttenuationConstant());
+  result->SetAttenuationLinear(_light->AttenuationLinear());
+  result->SetAttenuationQuadratic(_light->AttenuationQuadratic());
+  result->SetAttenuationRange(_light->AttenuationRange());
+  result->SetCastShadows(_light->CastShadows());
+  result->SetIntensity(_light->Intensity());
+  result->SetLocalPose(_light->LocalPose());
+  return result;
+}
+
+//////////////////////////////////////////////////
+/// \brief Copy a visual, its geometries and its children to a scene
+/// instance. Sensors attached to the visual are not copied.
+/// \param[in] _visual Visual to copy
+/// \param[in] _instance Scene instance
+/// \param[in,out] _copies Materials copied so far
+/// \return Copy of the visual
+static VisualPtr copyVisual(const VisualPtr &_visual,
+    const ScenePtr &_instance, std::map<MaterialPtr, MaterialPtr> &_copies)
+{
+  VisualPtr result = _instance->CreateVisual(_visual->Name());
+  result->SetOrigin(_visual->Origin());
+  result->SetInheritScale(_visual->InheritScale());
+  result->SetLocalScale(_visual->LocalScale());
+  result->SetLocalPose(_visual->LocalPose());
+  result->SetVisibilityFlags(_visual->VisibilityFlags());
+  result->SetWireframe(_visual->Wireframe());
+
+  // the visual has no geometries nor children yet, so this only sets the
+  // material of the visual. The geometries and children get their own.
+  if (_visual->Material())
+    result->SetMaterial(copyMaterial(_visual->Material(), _instance, _copies),
+        false);
+
+  for (unsigned int i = 0; i < _visual->GeometryCount(); ++i)
+  {
+    MeshPtr mesh =
+        std::dynamic_pointer_cast<Mesh>(_visual->GeometryByIndex(i));
+    if (!mesh)
+    {
+      ignwarn << "Geometry of visual [" << _visual->Name() << "] is not a "
+              << "mesh and can't be copied to scene instance ["
+              << _instance->Name() << "]" << std::endl;
+      continue;
+    }
+
+    MeshPtr meshCopy = _instance->CreateMesh(mesh->Descriptor());
+    if (!meshCopy)
+      continue;
+
+    if (mesh->Material())
+    {
+      meshCopy->SetMaterial(
+          copyMaterial(mesh->Material(), _instance, _copies), false);
+    }
+    else
+    {
+      for (unsigned int j = 0; j < mesh->SubMeshCount() &&
+          j < meshCopy->SubMeshCount(); ++j)
+      {
+        MaterialPtr mat = mesh->SubMeshByIndex(j)->Material();
+        if (mat)
+        {
+          meshCopy->SubMeshByIndex(j)->SetMaterial(
+              copyMaterial(mat, _instance, _copies), false);
+        }
+      }
+    }
+    result->AddGeometry(meshCopy);
+  }
+
+  for (unsigned int i = 0; i < _visual->ChildCount(); ++i)
+  {
+    NodePtr child = _visual->ChildByIndex(i);
+    if (auto light = std::dynamic_pointer_cast<Light>(child))
+    {
+      LightPtr lightCopy = copyLight(light, _instance);
+      if (lightCopy)
+        result->AddChild(lightCopy);
+    }
+    else if (std::dynamic_pointer_cast<Sensor>(child))
+    {
+      continue;
+    }
+    else if (auto visual = std::dynamic_pointer_cast<Visual>(child))
+    {
+      result->AddChild(copyVisual(visual, _instance, _copies));
+    }
+  }
+  return result;
+}
+
+//////////////////////////////////////////////////
+ScenePtr BaseScene::CreateInstance(const std::string &_name)
+{
+  ScenePtr instance = this->Engine()->CreateScene(_name);
+  if (!instance)
+  {
+    ignerr << "Unable to create instance [" << _name << "] of scene ["
+           << this->Name() << "]" << std::endl;
+    return instance;
+  }
+
+  this->CopySettings(instance);
+
+  std::map<MaterialPtr, MaterialPtr> copies;
+  VisualPtr root = this->RootVisual();
+  VisualPtr instanceRoot = instance->RootVisual();
+  for (unsigned int i = 0; i < root->ChildCount(); ++i)
+  {
+    NodePtr child = root->ChildByIndex(i);
+    if (auto light = std::dynamic_pointer_cast<Light>(child))
+    {
+      LightPtr lightCopy = copyLight(light, instance);
+      if (lightCopy)
+        instanceRoot->AddChild(lightCopy);
+    }
+    else if (std::dynamic_pointer_cast<Sensor>(child))
+    {
+      continue;
+    }
+    else if (auto visual = std::dynamic_pointer_cast<Visual>(child))
+    {
+      instanceRoot->AddChild(copyVisual(visual, instance, copies));
+    }
+  }
+  return instance;
+}
+
+//////////////////////////////////////////////////
+void BaseScene::CopySettings(const ScenePtr &_instance) const
+{
+  _instance->SetAmbientLight(this->AmbientLight());
+  _instance->SetBackgroundColor(this->BackgroundColor());
+  if (this->IsGradientBackgroundColor())
+    _instance->SetGradientBackgroundColor(this->GradientBackgroundColor());
+  if (this->SkyEnabled())
+    _instance->SetSkyEnabled(true);
+}
+
+//////////////////////////////////////////////////
+/// \brief First bytes of a scene snapshot file
+static const char kSnapshotMagic[4] = {'I', 'G', 'N', 'S'};
+
+/// \brief Version of the scene snapshot format
+static const uint32_t kSnapshotVersion = 1u;
+
+/// \brief Index written in place of a missing parent or material
+static const uint32_t kSnapshotNone = 0xFFFFFFFFu;
+
+namespace
+{
+  /// \brief Appends little endian values to a scene snapshot
+  class SnapshotWriter
+  {
+    /// \brief Append a byte
+    /// \param[in] _value Value to append
+    public: void Write(uint8_t _value)
+    {
+      this->data.push_back(static_cast<char>(_value));
+    }
+
+    /// \brief Append an unsigned integer
+    /// \param[in] _value Value to append
+    public: void Write(uint32_t _value)
+    {
+      for (unsigned int i = 0u; i < 4u; ++i)
+        this->Write(static_cast<uint8_t>(_value >> (8u * i)));
+    }
+
+    /// \brief Append a double
+    /// \param[in] _value Value to append
+    public: void Write(double _value)
+    {
+      uint64_t bits = 0u;
+      std::memcpy(&bits, &_value, sizeof(bits));
+      for (unsigned int i = 0u; i < 8u; ++i)
+        this->Write(static_cast<uint8_t>(bits >> (8u * i)));
+    }
+
+    /// \brief Append a string, its size followed by its characters
+    /// \param[in] _value Value to append
+    public: void Write(const std::string &_value)
+    {
+      this->Write(static_cast<uint32_t>(_value.size()));
+      this->data.append(_value);
+    }
+
+    /// \brief Append a color as four doubles
+    /// \param[in] _value Value to append
+    public: void Write(const math::Color &_value)
+    {
+      for (unsigned int i = 0u; i < 4u; ++i)
+        this->Write(static_cast<double>(_value[i]));
+    }
+
+    /// \brief Append a vector as three doubles
+    /// \param[in] _value Value to append
+    public: void Write(const math::Vector3d &_value)
+    {
+      for (unsigned int i = 0u; i < 3u; ++i)
+        this->Write(_value[i]);
+    }
+
+    /// \brief Append a pose as its position and quaternion
+    /// \param[in] _value Value to append
+    public: void Write(const math::Pose3d &_value)
+    {
+      this->Write(_value.Pos());
+      this->Write(_value.Rot().W());
+      this->Write(_value.Rot().X());
+      this->Write(_value.Rot().Y());
+      this->Write(_value.Rot().Z());
+    }
+
+    /// \brief Snapshot data
+    public: std::string data;
+  };
+
+  /// \brief Reads the little endian values of a scene snapshot. Reading
+  /// past the end of the data fails, and all reads after a failure return
+  /// default values.
+  class SnapshotReader
+  {
+    /// \brief Constructor
+    /// \param[in] _data Snapshot data
+    public: explicit SnapshotReader(const std::string &_data)
+      : data(_data)
+    {
+    }
+
+    /// \brief Read bytes
+    /// \param[in] _size Number of bytes
+    /// \return Pointer to the bytes, null if there are not enough left
+    public: const char *Read(size_t _size)
+    {
+      if (!this->ok || this->data.size() - this->offset < _size)
+      {
+        this->ok = false;
+        return nullptr;
+      }
+      const char *result = this->data.data() + this->offset;
+      this->offset += _size;
+      return result;
+    }
+
+    /// \brief Read a byte
+    /// \return Value read
+    public: uint8_t Byte()
+    {
+      const char *bytes = this->Read(1u);
+      return bytes ? static_cast<uint8_t>(bytes[0]) : 0u;
+    }
+
+    /// \brief Read an unsigned integer
+    /// \return Value read
+    public: uint32_t UInt()
+    {
+      const char *bytes = this->Read(4u);
+      uint32_t result = 0u;
+      for (unsigned int i = 0u; bytes && i < 4u; ++i)
+      {
+        result |= static_cast<uint32_t>(static_cast<uint8_t>(bytes[i]))
+            << (8u * i);
+      }
+      return result;
+    }
+
+    /// \brief Read a double
+    /// \return Value read
+    public: double Double()
+    {
+      const char *bytes = this->Read(8u);
+      uint64_t bits = 0u;
+      for (unsigned int i = 0u; bytes && i < 8u; ++i)
+      {
+        bits |= static_cast<uint64_t>(static_cast<uint8_t>(bytes[i]))
+            << (8u * i);
+      }
+      double result = 0.0;
+      std::memcpy(&result, &bits, sizeof(result));
+      return result;
+    }
+
+    /// \brief Read a string
+    /// \return Value read
+    public: std::string String()
+    {
+      uint32_t size = this->UInt();
+      const char *bytes = this->Read(size);
+      return bytes ? std::string(bytes, size) : std::string();
+    }
+
+    /// \brief Read a color
+    /// \return Value read
+    public: math::Color Color()
+    {
+      math::Color result;
+      result.R(static_cast<float>(this->Double()));
+      result.G(static_cast<float>(this->Double()));
+      result.B(static_cast<float>(this->Double()));
+      result.A(static_cast<float>(this->Double()));
+      return result;
+    }
+
+    /// \brief Read a vector
+    /// \return Value read
+    public: math::Vector3d Vector()
+    {
+      double x = this->Double();
+      double y = this->Double();
+      double z = this->Double();
+      return math::Vector3d(x, y, z);
+    }
+
+    /// \brief Read a pose
+    /// \return Value read
+    public: math::Pose3d Pose()
+    {
+      math::Vector3d pos = this->Vector();
+      double w = this->Double();
+      double x = this->Double();
+      double y = this->Double();
+      double z = this->Double();
+      return math::Pose3d(pos, math::Quaterniond(w, x, y, z));
+    }
+
+    /// \brief Check that all reads so far succeeded
+    /// \return True if no read went past the end of the data
+    public: bool Ok() const
+    {
+      return this->ok;
+    }
+
+    /// \brief Snapshot data
+    private: const std::string &data;
+
+    /// \brief Offset of the next read
+    private: size_t offset = 0u;
+
+    /// \brief False once a read went past the end of the data
+    private: bool ok = true;
+  };
+
+  /// \brief Material of a scene snapshot
+  struct SnapshotMaterial
+  {
+    /// \brief Material name
+    std::string name;
+
+    /// \brief Ambient, diffuse, specular and emissive colors
+    math::Color colors[4];
+
+    /// \brief Shininess, transparency, reflectivity, roughness and
+    /// metalness
+    double values[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+
+    /// \brief Lighting, shadow casting, shadow receiving, depth check and
+    /// depth write flags
+    uint8_t flags[5] = {0u, 0u, 0u, 0u, 0u};
+
+    /// \brief Texture, normal, roughness, metalness, environment, emissive
+    /// and light maps
+    std::string maps[7];
+
+    /// \brief Texture coordinate set of the light map
+    uint32_t lightMapTexCoordSet = 0u;
+  };
+
+  /// \brief Mesh of a visual of a scene snapshot
+  struct SnapshotMesh
+  {
+    /// \brief Descriptor of the mesh in the mesh cache
+    MeshDescriptor descriptor;
+
+    /// \brief Index of the material of the mesh
+    uint32_t material = kSnapshotNone;
+
+    /// \brief Indices of the materials of the submeshes, when the mesh has
+    /// no material of its own
+    std::vector<uint32_t> subMeshMaterials;
+  };
+
+  /// \brief Visual of a scene snapshot
+  struct SnapshotVisual
+  {
+    /// \brief Index of the parent visual, kSnapshotNone for the root
+    uint32_t parent = kSnapshotNone;
+
+    /// \brief Visual name
+    std::string name;
+
+    /// \brief Local origin
+    math::Vector3d origin;
+
+    /// \brief True to inherit the scale of the parent
+    bool inheritScale = true;
+
+    /// \brief Local scale
+    math::Vector3d scale;
+
+    /// \brief Local pose
+    math::Pose3d pose;
+
+    /// \brief Visibility flags
+    uint32_t visibilityFlags = 0u;
+
+    /// \brief True to show the wireframe
+    bool wireframe = false;
+
+    /// \brief Index of the material of the visual
+    uint32_t material = kSnapshotNone;
+
+    /// \brief Meshes of the visual
+    std::vector<SnapshotMesh> meshes;
+  };
+}
+
+//////////////////////////////////////////////////
+/// \brief Write the parameters of a material, all but its name
+/// \param[in] _material Material to write
+/// \param[in,out] _writer Writer to append to
+static void writeMaterialParameters(const MaterialPtr &_material,
+    SnapshotWriter &_writer)
+{
+  _writer.Write(_material->Ambient());
+  _writer.Write(_material->Diffuse());
+  _writer.Write(_material->Specular());
+  _writer.Write(_material->Emissive());
+  _writer.Write(_material->Shininess());
+  _writer.Write(_material->Transparency());
+  _writer.Write(_material->Reflectivity());
+  _writer.Write(static_cast<double>(_material->Roughness()));
+  _writer.Write(static_cast<double>(_material->Metalness()));
+  _writer.Write(static_cast<uint8_t>(_material->LightingEnabled()));
+  _writer.Write(static_cast<uint8_t>(_material->CastShadows()));
+  _writer.Write(static_cast<uint8_t>(_material->ReceiveShadows()));
+  _writer.Write(static_cast<uint8_t>(_material->DepthCheckEnabled()));
+  _writer.Write(static_cast<uint8_t>(_material->DepthWriteEnabled()));
+  _writer.Write(_material->Texture());
+  _writer.Write(_material->NormalMap());
+  _writer.Write(_material->RoughnessMap());
+  _writer.Write(_material->MetalnessMap());
+  _writer.Write(_material->EnvironmentMap());
+  _writer.Write(_material->EmissiveMap());
+  _writer.Write(_material->LightMap());
+  _writer.Write(_material->LightMapTexCoordSet());
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the index of a material in a snapshot, appending it to the
+/// snapshot on first use
+/// \param[in] _material Material, may be null
+/// \param[in,out] _writer Material table of the snapshot
+/// \param[in,out] _indices Indices of the materials written so far
+/// \return Index of the material, kSnapshotNone if null
+static uint32_t snapshotMaterial(const MaterialPtr &_material,
+    SnapshotWriter &_writer, std::map<MaterialPtr, uint32_t> &_indices)
+{
+  if (!_material)
+    return kSnapshotNone;
+
+  auto it = _indices.find(_material);
+  if (it != _indices.end())
+    return it->second;
+
+  uint32_t index = static_cast<uint32_t>(_indices.size());
+  _indices[_material] = index;
+
+  _writer.Write(_material->Name());
+  writeMaterialParameters(_material, _writer);
+  return index;
+}
+
+//////////////////////////////////////////////////
+/// \brief Write a visual and its descendant visuals to a snapshot, parents
+/// before their children
+/// \param[in] _visual Visual to write
+/// \param[in] _parent Index of the parent visual, kSnapshotNone for the
+/// root visual
+/// \param[in,out] _visuals Visual table of the snapshot
+/// \param[in,out] _visualCount Number of visuals written so far
+/// \param[in,out] _materials Material table of the snapshot
+/// \param[in,out] _indices Indices of the materials written so far
+static void snapshotVisual(const VisualPtr &_visual, uint32_t _parent,
+    SnapshotWriter &_visuals, uint32_t &_visualCount,
+    SnapshotWriter &_materials, std::map<MaterialPtr, uint32_t> &_indices)
+{
+  uint32_t index = _visualCount++;
+  _visuals.Write(_parent);
+  _visuals.Write(_visual->Name());
+  _visuals.Write(_visual->Origin());
+  _visuals.Write(static_cast<uint8_t>(_visual->InheritScale()));
+  _visuals.Write(_visual->LocalScale());
+  _visuals.Write(_visual->LocalPose());
+  _visuals.Write(_visual->VisibilityFlags());
+  _visuals.Write(static_cast<uint8_t>(_visual->Wireframe()));
+  _visuals.Write(snapshotMaterial(_visual->Material(), _materials,
+      _indices));
+
+  std::vector<MeshPtr> meshes;
+  for (unsigned int i = 0; i < _visual->GeometryCount(); ++i)
+  {
+    MeshPtr mesh =
+        std::dynamic_pointer_cast<Mesh>(_visual->GeometryByIndex(i));
+    if (!mesh || mesh->Descriptor().meshName.empty())
+    {
+      ignwarn << "Geometry of visual [" << _visual->Name() << "] is not a "
+              << "mesh of the mesh cache and is left out of the snapshot"
+              << std::endl;
+      continue;
+    }
+    meshes.push_back(mesh);
+  }
+
+  _visuals.Write(static_cast<uint32_t>(meshes.size()));
+  for (const auto &mesh : meshes)
+  {
+    const MeshDescriptor &desc = mesh->Descriptor();
+    _visuals.Write(desc.meshName);
+    _visuals.Write(desc.subMeshName);
+    _visuals.Write(static_cast<uint8_t>(desc.centerSubMesh));
+    _visuals.Write(snapshotMaterial(mesh->Material(), _materials,
+        _indices));
+
+    std::vector<uint32_t> subMeshMaterials;
+    if (!mesh->Material())
+    {
+      for (unsigned int j = 0; j < mesh->SubMeshCount(); ++j)
+      {
+        subMeshMaterials.push_back(snapshotMaterial(
+            mesh->SubMeshByIndex(j)->Material(), _materials, _indices));
+      }
+    }
+    _visuals.Write(static_cast<uint32_t>(subMeshMaterials.size()));
+    for (auto material : subMeshMaterials)
+      _visuals.Write(material);
+  }
+
+  for (unsigned int i = 0; i < _visual->ChildCount(); ++i)
+  {
+    NodePtr child = _visual->ChildByIndex(i);
+    if (std::dynamic_pointer_cast<Light>(child) ||
+        std::dynamic_pointer_cast<Sensor>(child))
+    {
+      continue;
+    }
+    if (auto visual = std::dynamic_pointer_cast<Visual>(child))
+    {
+      snapshotVisual(visual, index, _visuals, _visualCount, _materials,
+          _indices);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+bool BaseScene::SaveSnapshot(const std::string &_filename)
+{
+  SnapshotWriter materials;
+  SnapshotWriter visuals;
+  std::map<MaterialPtr, uint32_t> indices;
+  uint32_t visualCount = 0u;
+
+  VisualPtr root = this->RootVisual();
+  for (unsigned int i = 0; i < root->ChildCount(); ++i)
+  {
+    NodePtr child = root->ChildByIndex(i);
+    if (std::dynamic_pointer_cast<Light>(child) ||
+        std::dynamic_pointer_cast<Sensor>(child))
+    {
+      continue;
+    }
+    if (auto visual = std::dynamic_pointer_cast<Visual>(child))
+    {
+      snapshotVisual(visual, kSnapshotNone, visuals, visualCount, materials,
+          indices);
+    }
+  }
+
+  SnapshotWriter header;
+  header.data.append(kSnapshotMagic, sizeof(kSnapshotMagic));
+  header.Write(kSnapshotVersion);
+  header.Write(static_cast<uint32_t>(indices.size()));
+
+  SnapshotWriter count;
+  count.Write(visualCount);
+
+  std::ofstream file(_filename, std::ios::binary);
+  file << header.data << materials.data << count.data << visuals.data;
+  if (!file)
+  {
+    ignerr << "Unable to write scene snapshot [" << _filename << "]"
+           << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool BaseScene::LoadSnapshot(const std::string &_filename)
+{
+  // the whole file is read at once and parsed before anything is created,
+  // so a truncated or corrupt file leaves the scene untouched
+  std::ifstream file(_filename, std::ios::binary);
+  if (!file)
+  {
+    ignerr << "Unable to read scene snapshot [" << _filename << "]"
+           << std::endl;
+    return false;
+  }
+  std::string data((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+
+  SnapshotReader reader(data);
+  const char *magic = reader.Read(sizeof(kSnapshotMagic));
+  if (!magic ||
+      std::memcmp(magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ||
+      reader.UInt() != kSnapshotVersion)
+  {
+    ignerr << "[" << _filename << "] is not a scene snapshot of version "
+           << kSnapshotVersion << std::endl;
+    return false;
+  }
+
+  std::vector<SnapshotMaterial> materials(reader.UInt());
+  for (auto &material : materials)
+  {
+    if (!reader.Ok())
+      break;
+    material.name = reader.String();
+    for (auto &color : material.colors)
+      color = reader.Color();
+    for (auto &value : material.values)
+      value = reader.Double();
+    for (auto &flag : material.flags)
+      flag = reader.Byte();
+    for (auto &map : material.maps)
+      map = reader.String();
+    material.lightMapTexCoordSet = reader.UInt();
+  }
+
+  auto validMaterial = [&](uint32_t _index)
+  {
+    return _index == kSnapshotNone || _index < materials.size();
+  };
+
+  std::vector<SnapshotVisual> visuals(reader.UInt());
+  for (size_t i = 0; i < visuals.size() && reader.Ok(); ++i)
+  {
+    SnapshotVisual &visual = visuals[i];
+    visual.parent = reader.UInt();
+    visual.name = reader.String();
+    visual.origin = reader.Vector();
+    visual.inheritScale = reader.Byte() != 0u;
+    visual.scale = reader.Vector();
+    visual.pose = reader.Pose();
+    visual.visibilityFlags = reader.UInt();
+    visual.wireframe = reader.Byte() != 0u;
+    visual.material = reader.UInt();
+    bool valid = (visual.parent == kSnapshotNone || visual.parent < i) &&
+        validMaterial(visual.material);
+
+    visual.meshes.resize(reader.UInt());
+    for (auto &mesh : visual.meshes)
+    {
+      if (!reader.Ok())
+        break;
+      mesh.descriptor.meshName = reader.String();
+      mesh.descriptor.subMeshName = reader.String();
+      mesh.descriptor.centerSubMesh = reader.Byte() != 0u;
+      mesh.material = reader.UInt();
+      valid = valid && validMaterial(mesh.material);
+      mesh.subMeshMaterials.resize(reader.UInt());
+      for (auto &material : mesh.subMeshMaterials)
+      {
+        if (!reader.Ok())
+          break;
+        material = reader.UInt();
+        valid = valid && validMaterial(material);
+      }
+    }
+
+    if (!valid)
+    {
+      ignerr << "Scene snapshot [" << _filename << "] refers to unknown "
+             << "visuals or materials" << std::endl;
+      return false;
+    }
+  }
+
+  if (!reader.Ok())
+  {
+    ignerr << "Scene snapshot [" << _filename << "] is truncated"
+           << std::endl;
+    return false;
+  }
+
+  // materials registered by the engine, e.g. "Default/White", and the
+  // ones loaded before are reused, like CreateInstance does
+  std::vector<MaterialPtr> sceneMaterials;
+  sceneMaterials.reserve(materials.size());
+  for (const auto &material : materials)
+  {
+    MaterialPtr result = this->Material(material.name);
+    if (!result)
+    {
+      result = this->CreateMaterial(material.name);
+      result->SetAmbient(material.colors[0]);
+      result->SetDiffuse(material.colors[1]);
+      result->SetSpecular(material.colors[2]);
+      result->SetEmissive(material.colors[3]);
+      result->SetShininess(material.values[0]);
+      result->SetTransparency(material.values[1]);
+      result->SetReflectivity(material.values[2]);
+      result->SetRoughness(static_cast<float>(material.values[3]));
+      result->SetMetalness(static_cast<float>(material.values[4]));
+      result->SetLightingEnabled(material.flags[0] != 0u);
+      result->SetCastShadows(material.flags[1] != 0u);
+      result->SetReceiveShadows(material.flags[2] != 0u);
+      result->SetDepthCheckEnabled(material.flags[3] != 0u);
+      result->SetDepthWriteEnabled(material.flags[4] != 0u);
+      if (!material.maps[0].empty())
+        result->SetTexture(material.maps[0]);
+      if (!material.maps[1].empty())
+        result->SetNormalMap(material.maps[1]);
+      if (!material.maps[2].empty())
+        result->SetRoughnessMap(material.maps[2]);
+      if (!material.maps[3].empty())
+        result->SetMetalnessMap(material.maps[3]);
+      if (!material.maps[4].empty())
+        result->SetEnvironmentMap(material.maps[4]);
+      if (!material.maps[5].empty())
+        result->SetEmissiveMap(material.maps[5]);
+      if (!material.maps[6].empty())
+        result->SetLightMap(material.maps[6], material.lightMapTexCoordSet);
+    }
+    sceneMaterials.push_back(result);
+  }
+
+  auto sceneMaterial = [&](uint32_t _index)
+  {
+    return _index == kSnapshotNone ? MaterialPtr() : sceneMaterials[_index];
+  };
+
+  bool result = true;
+  std::vector<VisualPtr> sceneVisuals;
+  sceneVisuals.reserve(visuals.size());
+  for (const auto &visual : visuals)
+  {
+    // names already taken, e.g. by a previous load of the snapshot, get a
+    // generated name instead
+    VisualPtr created = this->HasVisualName(visual.name) ?
+        this->CreateVisual() : this->CreateVisual(visual.name);
+    created->SetOrigin(visual.origin);
+    created->SetInheritScale(visual.inheritScale);
+    created->SetLocalScale(visual.scale);
+    created->SetLocalPose(visual.pose);
+    created->SetVisibilityFlags(visual.visibilityFlags);
+    created->SetWireframe(visual.wireframe);
+    if (visual.material != kSnapshotNone)
+      created->SetMaterial(sceneMaterial(visual.material), false);
+
+    for (const auto &mesh : visual.meshes)
+    {
+      MeshPtr sceneMesh = this->CreateMesh(mesh.descriptor);
+      if (!sceneMesh)
+      {
+        result = false;
+        continue;
+      }
+
+      if (mesh.material != kSnapshotNone)
+      {
+        sceneMesh->SetMaterial(sceneMaterial(mesh.material), false);
+      }
+      else
+      {
+        for (unsigned int j = 0; j < mesh.subMeshMaterials.size() &&
+            j < sceneMesh->SubMeshCount(); ++j)
+        {
+          MaterialPtr material = sceneMaterial(mesh.subMeshMaterials[j]);
+          if (material)
+            sceneMesh->SubMeshByIndex(j)->SetMaterial(material, false);
+        }
+      }
+      created->AddGeometry(sceneMesh);
+    }
+
+    if (visual.parent == kSnapshotNone)
+      this->RootVisual()->AddChild(created);
+    else
+      sceneVisuals[visual.parent]->AddChild(created);
+    sceneVisuals.push_back(created);
+  }
+  return result;
+}
+
+/// \brief Chunk and label of baked geometries: whether they have a label,
+/// the label, and the integer coordinates of the chunk
+using BakeKey = std::tuple<bool, int, int64_t, int64_t, int64_t>;
+
+/// \brief Merged submeshes of a chunk and label, indexed by the parameters
+/// of their material written by writeMaterialParameters. Each submesh is
+/// paired with one of the materials it was merged from.
+using BakeChunk = std::map<std::string,
+    std::pair<MaterialPtr, common::SubMesh>>;
+
+//////////////////////////////////////////////////
+/// \brief Get the transform from the geometry coordinates of a node to
+/// world coordinates
+/// \param[in] _node Node
+/// \return Transform including the origins and scales of the node and of
+/// its ancestors
+static math::Matrix4d bakeTransform(const NodePtr &_node)
+{
+  // geometries are attached at the raw pose of the node, which is offset
+  // by its origin
+  math::Pose3d pose = _node->LocalPose();
+  pose.Pos() -= pose.Rot() * _node->Origin();
+  math::Matrix4d scale = math::Matrix4d::Identity;
+  scale.Scale(_node->LocalScale());
+  math::Matrix4d transform = math::Matrix4d(pose) * scale;
+
+  NodePtr parent = _node->Parent();
+  if (parent)
+    transform = bakeTransform(parent) * transform;
+  return transform;
+}
+
+//////////////////////////////////////////////////
+/// \brief Append the triangles of the mesh geometries of a visual and of
+/// its descendant visuals to the chunks they fall in
+/// \param[in] _visual Visual to bake
+/// \param[in] _chunkSize Edge length of the chunks
+/// \param[in,out] _visited Ids of the visuals baked so far
+/// \param[in,out] _chunks Merged submeshes of each chunk and label
+/// \param[in,out] _baked Visuals and their geometries that were baked
+static void bakeVisual(const VisualPtr &_visual, double _chunkSize,
+    std::set<unsigned int> &_visited, std::map<BakeKey, BakeChunk> &_chunks,
+    std::vector<std::pair<VisualPtr, GeometryPtr>> &_baked)
+{
+  if (!_visited.insert(_visual->Id()).second)
+    return;
+
+  math::Matrix4d transform = bakeTransform(_visual);
+  math::Matrix3d linear(
+      transform(0, 0), transform(0, 1), transform(0, 2),
+      transform(1, 0), transform(1, 1), transform(1, 2),
+      transform(2, 0), transform(2, 1), transform(2, 2));
+  math::Matrix3d normalTransform = linear.Inverse().Transposed();
+  // mirroring transforms reverse the winding of the triangles
+  bool flip = linear.Determinant() < 0.0;
+
+  Variant labelAny = _visual->UserData("label");
+  const int *label = std::get_if<int>(&labelAny);
+
+  for (unsigned int i = 0; i < _visual->GeometryCount(); ++i)
+  {
+    GeometryPtr geometry = _visual->GeometryByIndex(i);
+    MeshPtr mesh = std::dynamic_pointer_cast<Mesh>(geometry);
+    if (!mesh)
+      continue;
+
+    MeshDescriptor desc = mesh->Descriptor();
+    if (!desc.mesh)
+    {
+      std::lock_guard<std::recursive_mutex> lock(meshManagerMutex());
+      desc.mesh = common::MeshManager::Instance()->MeshByName(
+          desc.meshName);
+    }
+    if (!desc.mesh || desc.mesh->HasSkeleton())
+      continue;
+
+    // the submeshes of the descriptor, in the order of the submeshes of
+    // the geometry
+    std::vector<std::shared_ptr<common::SubMesh>> subMeshes;
+    for (unsigned int j = 0; j < desc.mesh->SubMeshCount(); ++j)
+    {
+      auto s = desc.mesh->SubMeshByIndex(j).lock();
+      if (s && (desc.subMeshName.empty() || s->Name() == desc.subMeshName))
+        subMeshes.push_back(s);
+    }
+
+    bool bakeable = !subMeshes.empty() &&
+        subMeshes.size() == mesh->SubMeshCount();
+    std::vector<MaterialPtr> materials;
+    for (unsigned int j = 0; bakeable && j < subMeshes.size(); ++j)
+    {
+      const common::SubMesh &subMesh = *subMeshes[j];
+      MaterialPtr material = mesh->Material() ? mesh->Material() :
+          mesh->SubMeshByIndex(j)->Material();
+      bakeable = material &&
+          subMesh.SubMeshPrimitiveType() == common::SubMesh::TRIANGLES &&
+          subMesh.IndexCount() % 3u == 0u;
+      for (unsigned int k = 0; bakeable && k < subMesh.IndexCount(); ++k)
+      {
+        int index = subMesh.Index(k);
+        bakeable = index >= 0 &&
+            static_cast<unsigned int>(index) < subMesh.VertexCount();
+      }
+      materials.push_back(material);
+    }
+    if (!bakeable)
+      continue;
+
+    for (unsigned int j = 0; j < subMeshes.size(); ++j)
+    {
+      common::SubMesh subMesh(*subMeshes[j]);
+      if (desc.centerSubMesh)
+        subMesh.Center(math::Vector3d::Zero);
+
+      // submeshes without normals get the normals of their triangles
+      std::vector<math::Vector3d> normals(subMesh.VertexCount());
+      if (subMesh.NormalCount() >= subMesh.VertexCount())
+      {
+        for (unsigned int k = 0; k < subMesh.VertexCount(); ++k)
+          normals[k] = subMesh.Normal(k);
+      }
+      else
+      {
+        for (unsigned int k = 0; k < subMesh.IndexCount(); k += 3u)
+        {
+          unsigned int a = subMesh.Index(k);
+          unsigned int b = subMesh.Index(k + 1u);
+          unsigned int c = subMesh.Index(k + 2u);
+          math::Vector3d n = (subMesh.Vertex(b) - subMesh.Vertex(a)).Cross(
+              subMesh.Vertex(c) - subMesh.Vertex(a));
+          normals[a] += n;
+          normals[b] += n;
+          normals[c] += n;
+        }
+      }
+
+      std::vector<math::Vector3d> positions(subMesh.VertexCount());
+      math::Vector3d center;
+      for (unsigned int k = 0; k < subMesh.VertexCount(); ++k)
+      {
+        positions[k] = transform * subMesh.Vertex(k);
+        center += positions[k];
+      }
+      if (!positions.empty())
+        center /= static_cast<double>(positions.size());
+
+      BakeKey key(label != nullptr, label ? *label : 0,
+          static_cast<int64_t>(std::floor(center.X() / _chunkSize)),
+          static_cast<int64_t>(std::floor(center.Y() / _chunkSize)),
+          static_cast<int64_t>(std::floor(center.Z() / _chunkSize)));
+      SnapshotWriter parameters;
+      writeMaterialParameters(materials[j], parameters);
+      auto &merged = _chunks[key][parameters.data];
+      if (!merged.first)
+      {
+        merged.first = materials[j];
+        merged.second.SetPrimitiveType(common::SubMesh::TRIANGLES);
+      }
+
+      bool hasTexCoords = subMesh.TexCoordSetCount() > 0u &&
+          subMesh.TexCoordCountBySet(0u) >= subMesh.VertexCount();
+      unsigned int offset = merged.second.VertexCount();
+      for (unsigned int k = 0; k < subMesh.VertexCount(); ++k)
+      {
+        math::Vector3d normal = normalTransform * normals[k];
+        merged.second.AddVertex(positions[k]);
+        merged.second.AddNormal(normal.Normalize());
+        merged.second.AddTexCoord(hasTexCoords ?
+            subMesh.TexCoordBySet(k, 0u) : math::Vector2d::Zero);
+      }
+      for (unsigned int k = 0; k < subMesh.IndexCount(); k += 3u)
+      {
+        unsigned int b = flip ? k + 2u : k + 1u;
+        unsigned int c = flip ? k + 1u : k + 2u;
+        merged.second.AddIndex(offset + subMesh.Index(k));
+        merged.second.AddIndex(offset + subMesh.Index(b));
+        merged.second.AddIndex(offset + subMesh.Index(c));
+      }
+    }
+    _baked.emplace_back(_visual, geometry);
+  }
+
+  for (unsigned int i = 0; i < _visual->ChildCount(); ++i)
+  {
+    NodePtr child = _visual->ChildByIndex(i);
+    if (std::dynamic_pointer_cast<Light>(child) ||
+        std::dynamic_pointer_cast<Sensor>(child))
+    {
+      continue;
+    }
+    if (auto visual = std::dynamic_pointer_cast<Visual>(child))
+      bakeVisual(visual, _chunkSize, _visited, _chunks, _baked);
+  }
+}
+
+//////////////////////////////////////////////////
+VisualPtr BaseScene::BakeStatic(const std::vector<VisualPtr> &_visuals,
+    double _chunkSize)
+{
+  if (!(_chunkSize > 0.0))
+  {
+    ignerr << "Unable to bake static visuals, chunk size [" << _chunkSize
+           << "] is not positive" << std::endl;
+    return nullptr;
+  }
+
+  std::set<unsigned int> visited;
+  std::map<BakeKey, BakeChunk> chunks;
+  std::vector<std::pair<VisualPtr, GeometryPtr>> baked;
+  for (const auto &visual : _visuals)
+  {
+    if (visual)
+      bakeVisual(visual, _chunkSize, visited, chunks, baked);
+  }
+  if (chunks.empty())
+    return nullptr;
+
+  VisualPtr result = this->CreateVisual();
+  for (auto &chunk : chunks)
+  {
+    VisualPtr chunkVisual = this->CreateVisual();
+
+    // the mesh manager is shared by all scenes
+    common::Mesh *mesh = new common::Mesh();
+    mesh->SetName(this->Name() + "::" + chunkVisual->Name());
+    std::vector<MaterialPtr> materials;
+    for (auto &merged : chunk.second)
+    {
+      merged.second.second.SetName(
+          mesh->Name() + "::" + std::to_string(materials.size()));
+      mesh->AddSubMesh(merged.second.second);
+      materials.push_back(merged.second.first);
+    }
+    {
+      std::lock_guard<std::recursive_mutex> lock(meshManagerMutex());
+      common::MeshManager::Instance()->AddMesh(mesh);
+    }
+
+    MeshPtr chunkMesh = this->CreateMesh(MeshDescriptor(mesh));
+    if (!chunkMesh)
+    {
+      this->DestroyVisual(chunkVisual);
+      continue;
+    }
+    // the materials are copied as the ones of the baked geometries may be
+    // destroyed with them
+    for (unsigned int i = 0; i < materials.size() &&
+        i < chunkMesh->SubMeshCount(); ++i)
+    {
+      chunkMesh->SubMeshByIndex(i)->SetMaterial(materials[i], true);
+    }
+    chunkVisual->AddGeometry(chunkMesh);
+    if (std::get<0>(chunk.first))
+      chunkVisual->SetUserData("label", std::get<1>(chunk.first));
+    result->AddChild(chunkVisual);
+  }
+  this->RootVisual()->AddChild(result);
+
+  for (auto &entry : baked)
+  {
+    entry.first->RemoveGeometry(entry.second);
+    entry.second->Destroy();
+  }
+  return result;
+}
+
 //////////////////////////////////////////////////
 void BaseScene::Destroy()
 {
   // TODO(anyone): destroy context
+  this->DiscardCommands();
   this->Clear();
+  this->scheduler.reset();
   this->loaded = false;
   this->initialized = false;
 }
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_RENDERING_TEST_BENCHMARK_UTILS_HH_
+#define IGNITION_RENDERING_TEST_BENCHMARK_UTILS_HH_
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/rendering/base/BaseNode.hh"
+#include "ignition/rendering/base/BaseObject.hh"
+#include "ignition/rendering/base/BaseStorage.hh"
+
+namespace ignition
+{
+  namespace rendering
+  {
+    namespace benchmark
+    {
+      /// \brief Time a function called repeatedly, report the time per call
+      /// and record it as a property of the running test in the gtest XML
+      /// output. Functions that can be called again with the same index
+      /// should be warmed up by the caller.
+      /// \param[in] _name Name of the measurement
+      /// \param[in] _count Number of calls
+      /// \param[in] _function Function to time, called with the index of
+      /// the call
+      /// \return Time per call in nanoseconds
+      inline double Measure(const std::string &_name, unsigned int _count,
+          const std::function<void(unsigned int)> &_function)
+      {
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < _count; ++i)
+          _function(i);
+        std::chrono::duration<double, std::nano> elapsed =
+            std::chrono::steady_clock::now() - start;
+        double ns = elapsed.count() / _count;
+
+        ignmsg << _name << ": " << ns << " ns per call" << std::endl;
+        testing::Test::RecordProperty(_name + "_ns", std::to_string(ns));
+        return ns;
+      }
+
+      /// \brief Object without a render engine or a scene
+      class BenchObject : public BaseObject
+      {
+        // Documentation inherited.
+        public: virtual ScenePtr Scene() const override
+        {
+          return nullptr;
+        }
+      };
+
+      class BenchNode;
+      typedef std::shared_ptr<BenchNode> BenchNodePtr;
+      typedef BaseNodeStore<BenchNode> BenchNodeStore;
+
+      /// \brief Node without a render engine, keeping its pose and its
+      /// children in memory, so that the code of BaseNode and BaseStore
+      /// can be measured without a GPU
+      class BenchNode : public BaseNode<BenchObject>
+      {
+        /// \brief Constructor
+        /// \param[in] _id Unique id of the node
+        public: explicit BenchNode(unsigned int _id)
+        {
+          this->id = _id;
+          this->name = "node_" + std::to_string(_id);
+        }
+
+        // Documentation inherited.
+        public: virtual bool HasParent() const override
+        {
+          return !this->parent.expired();
+        }
+
+        // Documentation inherited.
+        public: virtual NodePtr Parent() const override
+        {
+          return this->parent.lock();
+        }
+
+        // Documentation inherited.
+        public: virtual math::Vector3d LocalScale() const override
+        {
+          return this->scale;
+        }
+
+        // Documentation inherited.
+        public: virtual bool InheritScale() const override
+        {
+          return true;
+        }
+
+        // Documentation inherited.
+        public: virtual void SetInheritScale(bool) override
+        {
+        }
+
+        // Documentation inherited.
+        protected: virtual void SetLocalScaleImpl(
+            const math::Vector3d &_scale) override
+        {
+          this->scale = _scale;
+        }
+
+        // Documentation inherited.
+        protected: virtual NodeStorePtr Children() const override
+        {
+          return this->children;
+        }
+
+        // Documentation inherited.
+        protected: virtual bool AttachChild(NodePtr _child) override
+        {
+          BenchNodePtr child = std::dynamic_pointer_cast<BenchNode>(_child);
+          if (!child)
+            return false;
+          child->parent = std::dynamic_pointer_cast<BenchNode>(
+              this->shared_from_this());
+          return true;
+        }
+
+        // Documentation inherited.
+        protected: virtual bool DetachChild(NodePtr _child) override
+        {
+          BenchNodePtr child = std::dynamic_pointer_cast<BenchNode>(_child);
+          if (!child)
+            return false;
+          child->parent.reset();
+          return true;
+        }
+
+        // Documentation inherited.
+        protected: virtual math::Pose3d RawLocalPose() const override
+        {
+          return this->pose;
+        }
+
+        // Documentation inherited.
+        protected: virtual void SetRawLocalPose(const math::Pose3d &_pose)
+            override
+        {
+          this->pose = _pose;
+        }
+
+        /// \brief Parent node
+        private: std::weak_ptr<BenchNode> parent;
+
+        /// \brief Child nodes
+        private: std::shared_ptr<BenchNodeStore> children =
+            std::make_shared<BenchNodeStore>();
+
+        /// \brief Local pose
+        private: math::Pose3d pose;
+
+        /// \brief Local scale
+        private: math::Vector3d scale = math::Vector3d::One;
+      };
+    }
+  }
+}
+#endif
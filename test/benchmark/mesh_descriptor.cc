@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Mesh.hh>
+#include <ignition/common/MeshManager.hh>
+#include <ignition/common/SubMesh.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "benchmark_utils.hh"
+
+#include "ignition/rendering/MeshDescriptor.hh"
+
+using namespace ignition;
+using namespace rendering;
+using namespace benchmark;
+
+/// \brief Measure the loading of a mesh file and the lookups of loaded
+/// meshes by the descriptors passed to Scene::CreateMesh
+class MeshDescriptorTest : public testing::Test
+{
+  // Documentation inherited
+  public: void SetUp() override
+  {
+    ignition::common::Console::SetVerbosity(3);
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_F(MeshDescriptorTest, Load)
+{
+  const std::string path = common::joinPaths(PROJECT_SOURCE_PATH, "test",
+      "media", "meshes", "walk.dae");
+  common::MeshManager *meshManager = common::MeshManager::Instance();
+
+  // the first load parses the file, the next ones return the cached mesh
+  const common::Mesh *mesh = nullptr;
+  Measure("mesh_file_load", 1u, [&](unsigned int)
+  {
+    mesh = meshManager->Load(path);
+  });
+  ASSERT_NE(nullptr, mesh);
+  Measure("mesh_file_load_cached", 1000u, [&](unsigned int)
+  {
+    meshManager->Load(path);
+  });
+
+  Measure("mesh_descriptor_load_by_name", 10000u, [&](unsigned int)
+  {
+    MeshDescriptor descriptor(path);
+    descriptor.Load();
+  });
+  Measure("mesh_descriptor_load_by_mesh", 10000u, [&](unsigned int)
+  {
+    MeshDescriptor descriptor(mesh);
+    descriptor.Load();
+  });
+
+  // read all the vertices, as render engines do to build their buffers
+  double sum = 0.0;
+  Measure("mesh_read_vertices", 100u, [&](unsigned int)
+  {
+    for (unsigned int i = 0; i < mesh->SubMeshCount(); ++i)
+    {
+      auto subMesh = mesh->SubMeshByIndex(i).lock();
+      for (unsigned int v = 0; v < subMesh->VertexCount(); ++v)
+        sum += subMesh->Vertex(v).X();
+    }
+  });
+  EXPECT_GT(mesh->VertexCount(), 0u);
+  EXPECT_TRUE(std::isfinite(sum));
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
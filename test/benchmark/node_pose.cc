@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark_utils.hh"
+
+using namespace ignition;
+using namespace rendering;
+using namespace benchmark;
+
+/// \brief Measure how the cost of the world pose of a node scales with its
+/// depth in the scene graph, when an ancestor moved, when the node itself
+/// moved and when nothing moved
+class NodePoseTest : public testing::Test,
+                     public testing::WithParamInterface<unsigned int>
+{
+  // Documentation inherited
+  public: void SetUp() override
+  {
+    ignition::common::Console::SetVerbosity(3);
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_P(NodePoseTest, WorldPose)
+{
+  const unsigned int depth = GetParam();
+  const std::string prefix = "depth_" + std::to_string(depth) + "_";
+
+  // a chain of nodes, each offset and rotated from its parent
+  std::vector<BenchNodePtr> chain;
+  for (unsigned int i = 0; i < depth; ++i)
+  {
+    BenchNodePtr node = std::make_shared<BenchNode>(i);
+    node->SetLocalPose(math::Pose3d(0.1, 0.0, 0.0, 0.0, 0.0, 0.01));
+    if (!chain.empty())
+      chain.back()->AddChild(node);
+    chain.push_back(node);
+  }
+  BenchNodePtr root = chain.front();
+  BenchNodePtr leaf = chain.back();
+
+  const unsigned int count = 10000u;
+  double x = 0.0;
+  Measure(prefix + "root_moved", count, [&](unsigned int _i)
+  {
+    root->SetLocalPosition(_i * 1e-3, 0.0, 0.0);
+    x += leaf->WorldPose().Pos().X();
+  });
+  Measure(prefix + "leaf_moved", count, [&](unsigned int _i)
+  {
+    leaf->SetLocalPosition(_i * 1e-3, 0.0, 0.0);
+    x += leaf->WorldPose().Pos().X();
+  });
+  Measure(prefix + "unchanged", count, [&](unsigned int)
+  {
+    x += leaf->WorldPose().Pos().X();
+  });
+  Measure(prefix + "set_world_pose", count, [&](unsigned int _i)
+  {
+    leaf->SetWorldPose(math::Pose3d(_i * 1e-3, 0.0, 0.0, 0.0, 0.0, 0.0));
+  });
+  EXPECT_NEAR((count - 1u) * 1e-3, leaf->WorldPose().Pos().X(), 1e-6);
+  EXPECT_TRUE(std::isfinite(x));
+}
+
+INSTANTIATE_TEST_CASE_P(NodePose, NodePoseTest,
+    ::testing::Values(1u, 4u, 16u, 64u, 256u));
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "benchmark_utils.hh"
+
+#include "ignition/rendering/PixelFormat.hh"
+
+using namespace ignition;
+using namespace rendering;
+using namespace benchmark;
+
+/// \brief Measure the conversions of camera images between pixel formats,
+/// done on every frame by sensors publishing images, at VGA and 1080p
+class PixelFormatTest : public testing::Test,
+    public testing::WithParamInterface<std::tuple<unsigned int, unsigned int>>
+{
+  // Documentation inherited
+  public: void SetUp() override
+  {
+    ignition::common::Console::SetVerbosity(3);
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_P(PixelFormatTest, Convert)
+{
+  const unsigned int width = std::get<0>(GetParam());
+  const unsigned int height = std::get<1>(GetParam());
+  const std::string prefix = "pixels_" + std::to_string(width) + "x" +
+      std::to_string(height) + "_";
+  const unsigned int count = 20u;
+
+  std::vector<unsigned char> src(
+      PixelUtil::MemorySize(PF_R8G8B8A8, width, height));
+  for (unsigned int i = 0; i < src.size(); ++i)
+    src[i] = static_cast<unsigned char>(i * 7u);
+  std::vector<unsigned char> dst(src.size());
+
+  const std::vector<std::tuple<PixelFormat, PixelFormat>> conversions = {
+      {PF_R8G8B8, PF_B8G8R8},
+      {PF_R8G8B8A8, PF_R8G8B8},
+      {PF_R8G8B8, PF_R8G8B8A8},
+      {PF_L8, PF_R8G8B8},
+      {PF_R8G8B8, PF_R8G8B8}};
+  for (const auto &conversion : conversions)
+  {
+    PixelFormat srcFormat = std::get<0>(conversion);
+    PixelFormat dstFormat = std::get<1>(conversion);
+    bool result = true;
+    Measure(prefix + PixelUtil::Name(srcFormat) + "_to_" +
+        PixelUtil::Name(dstFormat), count, [&](unsigned int)
+    {
+      result &= PixelUtil::Convert(src.data(), srcFormat, dst.data(),
+          dstFormat, width, height);
+    });
+    EXPECT_TRUE(result);
+  }
+
+  // rows padded to a multiple of 256 bytes, as read back from a GPU
+  unsigned int pitch = (width * 3u + 255u) / 256u * 256u;
+  std::vector<unsigned char> padded(pitch * height);
+  bool result = true;
+  Measure(prefix + "PF_R8G8B8_padded_to_PF_B8G8R8", count, [&](unsigned int)
+  {
+    result &= PixelUtil::Convert(padded.data(), PF_R8G8B8, dst.data(),
+        PF_B8G8R8, width, height, pitch);
+  });
+  EXPECT_TRUE(result);
+
+  std::vector<unsigned char> yuv(PixelUtil::I420MemorySize(width, height));
+  for (PixelFormat format : {PF_R8G8B8, PF_R8G8B8A8})
+  {
+    Measure(prefix + PixelUtil::Name(format) + "_to_I420", count,
+        [&](unsigned int)
+    {
+      result &= PixelUtil::ConvertToI420(src.data(), format, yuv.data(),
+          width, height);
+    });
+    EXPECT_TRUE(result);
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(PixelFormat, PixelFormatTest,
+    ::testing::Values(std::make_tuple(640u, 480u),
+                      std::make_tuple(1920u, 1080u)));
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
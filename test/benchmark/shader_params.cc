@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "benchmark_utils.hh"
+
+#include "ignition/rendering/ShaderParams.hh"
+
+using namespace ignition;
+using namespace rendering;
+using namespace benchmark;
+
+/// \brief Measure the iteration and the updates of the shader parameters
+/// of a material, as done every frame by render engines and by
+/// applications animating shader uniforms
+class ShaderParamsTest : public testing::Test,
+                         public testing::WithParamInterface<unsigned int>
+{
+  // Documentation inherited
+  public: void SetUp() override
+  {
+    ignition::common::Console::SetVerbosity(3);
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_P(ShaderParamsTest, IterateAndUpdate)
+{
+  const unsigned int size = GetParam();
+  const std::string prefix = "params_" + std::to_string(size) + "_";
+
+  std::vector<std::string> names;
+  ShaderParams params;
+  for (unsigned int i = 0; i < size; ++i)
+  {
+    names.push_back("param_" + std::to_string(i));
+    if (i % 4u == 0u)
+    {
+      float buffer[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+      params[names.back()].InitializeBuffer(4u);
+      params[names.back()].UpdateBuffer(buffer);
+    }
+    else
+    {
+      params[names.back()] = static_cast<float>(i);
+    }
+  }
+  params.ClearDirty();
+
+  const unsigned int count = 1000u;
+  float sum = 0.0f;
+  Measure(prefix + "iterate", count, [&](unsigned int)
+  {
+    for (const auto &name_param : params)
+    {
+      float value = 0.0f;
+      if (name_param.second.Value(&value))
+        sum += value;
+    }
+  });
+
+  // update one parameter per frame, then all of them
+  Measure(prefix + "update_one", count, [&](unsigned int _i)
+  {
+    params[names[(_i * 4u + 1u) % size]] = static_cast<float>(_i);
+    params.ClearDirty();
+  });
+  Measure(prefix + "update_all", count / 10u, [&](unsigned int _i)
+  {
+    for (const auto &name : names)
+      params[name] = static_cast<float>(_i);
+    params.ClearDirty();
+  });
+
+  Measure(prefix + "copy", count / 10u, [&](unsigned int)
+  {
+    ShaderParams copy;
+    for (const auto &name_param : params)
+      copy[name_param.first] = name_param.second;
+    sum += copy.IsDirty() ? 1.0f : 0.0f;
+  });
+  EXPECT_GT(sum, 0.0f);
+}
+
+INSTANTIATE_TEST_CASE_P(ShaderParams, ShaderParamsTest,
+    ::testing::Values(8u, 64u, 512u));
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
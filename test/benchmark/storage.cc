@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark_utils.hh"
+
+using namespace ignition;
+using namespace rendering;
+using namespace benchmark;
+
+/// \brief Measure the lookups of objects in a store by id, name and index,
+/// and the time to fill and empty a store, at sizes from 1k to 1M objects.
+/// Stores of 100k and more objects are disabled by default, run them with
+/// --gtest_also_run_disabled_tests
+class StorageTest : public testing::Test,
+                    public testing::WithParamInterface<unsigned int>
+{
+  // Documentation inherited
+  public: void SetUp() override
+  {
+    ignition::common::Console::SetVerbosity(3);
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_P(StorageTest, Lookups)
+{
+  const unsigned int size = GetParam();
+  const std::string prefix = "store_" + std::to_string(size) + "_";
+
+  std::vector<BenchNodePtr> objects;
+  objects.reserve(size);
+  for (unsigned int i = 0; i < size; ++i)
+    objects.push_back(std::make_shared<BenchNode>(i));
+
+  BenchNodeStore store;
+  Measure(prefix + "add", size, [&](unsigned int _i)
+  {
+    store.Add(objects[_i]);
+  });
+  ASSERT_EQ(size, store.Size());
+
+  // spread the lookups over the store with a stride coprime with its size.
+  // Lookups by id and index may be linear in the size of the store, so
+  // they are kept few.
+  const unsigned int lookups = 200u;
+  const unsigned int stride = 7919u;
+  unsigned int found = 0u;
+  Measure(prefix + "get_by_id", lookups, [&](unsigned int _i)
+  {
+    found += store.GetById((_i * stride) % size) != nullptr;
+  });
+  Measure(prefix + "get_by_name", lookups, [&](unsigned int _i)
+  {
+    found += store.GetByName(objects[(_i * stride) % size]->Name()) !=
+        nullptr;
+  });
+  Measure(prefix + "get_by_index", lookups, [&](unsigned int _i)
+  {
+    found += store.GetByIndex((_i * stride) % size) != nullptr;
+  });
+  Measure(prefix + "contains_id", lookups, [&](unsigned int _i)
+  {
+    found += store.ContainsId((_i * stride) % size);
+  });
+  EXPECT_EQ(4u * lookups, found);
+
+  Measure(prefix + "remove_by_id", size, [&](unsigned int _i)
+  {
+    store.RemoveById(_i);
+  });
+  EXPECT_EQ(0u, store.Size());
+}
+
+INSTANTIATE_TEST_CASE_P(Storage, StorageTest,
+    ::testing::Values(1000u, 10000u));
+
+INSTANTIATE_TEST_CASE_P(DISABLED_StorageLarge, StorageTest,
+    ::testing::Values(100000u, 1000000u));
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Event.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/BoundingBoxCamera.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+class BoundingBoxCameraTest: public testing::Test,
+  public testing::WithParamInterface<const char *>
+{
+  public: void BoundingBoxCameraBoxes(const std::string &_renderEngine);
+
+  // Documentation inherited
+  protected: void SetUp() override
+  {
+    ignition::common::Console::SetVerbosity(4);
+  }
+};
+
+/// \brief Received bounding boxes
+std::vector<BoundingBox> g_boxes;
+
+/// \brief counter of received bounding box msgs
+int g_counter = 0;
+
+//////////////////////////////////////////////////
+/// \brief callback to get the bounding boxes
+void OnNewBoundingBoxes(const std::vector<BoundingBox> &_boxes)
+{
+  g_boxes = _boxes;
+  g_counter++;
+}
+
+//////////////////////////////////////////////////
+/// \brief Build the scene with an unlabeled box and 2 labeled boxes
+/// besides each other
+void BuildScene(rendering::ScenePtr scene)
+{
+  rendering::VisualPtr root = scene->RootVisual();
+
+  rendering::VisualPtr box = scene->CreateVisual("box_left");
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(3, 1.5, 0);
+  box->SetUserData("label", 1);
+  root->AddChild(box);
+
+  rendering::VisualPtr box1 = scene->CreateVisual("box_right");
+  box1->AddGeometry(scene->CreateBox());
+  box1->SetLocalPosition(3, -1.5, 0);
+  box1->SetUserData("label", 2);
+  root->AddChild(box1);
+
+  // unlabeled boxes don't produce bounding boxes
+  rendering::VisualPtr box2 = scene->CreateVisual("box_mid");
+  box2->AddGeometry(scene->CreateBox());
+  box2->SetLocalPosition(3, 0, 0);
+  root->AddChild(box2);
+}
+
+//////////////////////////////////////////////////
+void BoundingBoxCameraTest::BoundingBoxCameraBoxes(
+  const std::string &_renderEngine)
+{
+  // Currently, only ogre2 supports bounding box cameras
+  if (_renderEngine.compare("ogre2") != 0)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' doesn't support bounding box cameras" << std::endl;
+    return;
+  }
+
+  // Setup ign-rendering with an empty scene
+  auto *engine = ignition::rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    ignerr << "Engine '" << _renderEngine
+              << "' was unable to be retrieved" << std::endl;
+    return;
+  }
+  ignition::rendering::ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  BuildScene(scene);
+
+  auto camera = scene->CreateBoundingBoxCamera("BoundingBoxCamera");
+  ASSERT_NE(camera, nullptr);
+
+  camera->SetLocalPosition(0.0, 0.0, 0.0);
+  camera->SetLocalRotation(0.0, 0.0, 0.0);
+
+  unsigned int width = 320;
+  unsigned int height = 240;
+  camera->SetAspectRatio(static_cast<double>(width) / height);
+  camera->SetImageWidth(width);
+  camera->SetImageHeight(height);
+  camera->SetHFOV(IGN_PI / 2);
+  scene->RootVisual()->AddChild(camera);
+
+  ignition::common::ConnectionPtr connection =
+      camera->ConnectNewBoundingBoxes(
+          std::bind(OnNewBoundingBoxes, std::placeholders::_1));
+  ASSERT_NE(nullptr, connection);
+
+  // visible 2d boxes
+  camera->SetBoundingBoxType(BoundingBoxType::BBT_VISIBLEBOX2D);
+  camera->Update();
+  EXPECT_EQ(1, g_counter);
+  ASSERT_EQ(2u, g_boxes.size());
+
+  // the left box is in the left half of the image
+  const BoundingBox *left = &g_boxes[0];
+  const BoundingBox *right = &g_boxes[1];
+  if (left->Label() != 1u)
+    std::swap(left, right);
+  EXPECT_EQ(1u, left->Label());
+  EXPECT_EQ(2u, right->Label());
+  EXPECT_LT(left->Center().X(), width * 0.5);
+  EXPECT_GT(right->Center().X(), width * 0.5);
+  EXPECT_NEAR(height * 0.5, left->Center().Y(), 2.0);
+  EXPECT_GT(left->Size().X(), 0.0);
+  EXPECT_GT(left->Size().Y(), 0.0);
+  // nothing hides the left box
+  EXPECT_NEAR(1.0, left->VisibleRatio(), 0.1);
+
+  // full 2d boxes contain the visible boxes
+  BoundingBox visibleLeft = *left;
+  camera->SetBoundingBoxType(BoundingBoxType::BBT_FULLBOX2D);
+  camera->Update();
+  EXPECT_EQ(2, g_counter);
+  ASSERT_EQ(2u, g_boxes.size());
+  left = g_boxes[0].Label() == 1u ? &g_boxes[0] : &g_boxes[1];
+  EXPECT_GE(left->Size().X() + 1.0, visibleLeft.Size().X());
+  EXPECT_GE(left->Size().Y() + 1.0, visibleLeft.Size().Y());
+
+  // 3d boxes are in the camera frame
+  camera->SetBoundingBoxType(BoundingBoxType::BBT_BOX3D);
+  camera->Update();
+  EXPECT_EQ(3, g_counter);
+  ASSERT_EQ(2u, g_boxes.size());
+  left = g_boxes[0].Label() == 1u ? &g_boxes[0] : &g_boxes[1];
+  EXPECT_EQ(math::Vector3d(3, 1.5, 0), left->Center());
+  EXPECT_EQ(math::Vector3d::One, left->Size());
+
+  // an unlabeled occluder in front of the lower half of the left box
+  rendering::VisualPtr occluder = scene->CreateVisual("occluder");
+  occluder->AddGeometry(scene->CreateBox());
+  occluder->SetLocalPosition(1.5, 1.5, -0.5);
+  occluder->SetLocalScale(0.1, 3.0, 1.0);
+  scene->RootVisual()->AddChild(occluder);
+  camera->SetBoundingBoxType(BoundingBoxType::BBT_VISIBLEBOX2D);
+  camera->Update();
+  EXPECT_EQ(4, g_counter);
+  ASSERT_EQ(2u, g_boxes.size());
+  left = g_boxes[0].Label() == 1u ? &g_boxes[0] : &g_boxes[1];
+  right = g_boxes[0].Label() == 1u ? &g_boxes[1] : &g_boxes[0];
+  EXPECT_NEAR(0.5, left->VisibleRatio(), 0.15);
+  EXPECT_NEAR(1.0, right->VisibleRatio(), 0.1);
+
+  // an unoccluded sphere is fully visible, even though it covers only part
+  // of its projected box
+  rendering::VisualPtr sphere = scene->CreateVisual("sphere");
+  sphere->AddGeometry(scene->CreateSphere());
+  sphere->SetLocalPosition(3, 0, 1.2);
+  sphere->SetUserData("label", 3);
+  scene->RootVisual()->AddChild(sphere);
+  camera->Update();
+  EXPECT_EQ(5, g_counter);
+  ASSERT_EQ(3u, g_boxes.size());
+  const BoundingBox *sphereBox = nullptr;
+  for (const auto &box : g_boxes)
+  {
+    if (box.Label() == 3u)
+      sphereBox = &box;
+  }
+  ASSERT_NE(nullptr, sphereBox);
+  EXPECT_NEAR(1.0, sphereBox->VisibleRatio(), 0.05);
+
+  // Clean up
+  connection.reset();
+  engine->DestroyScene(scene);
+  ignition::rendering::unloadEngine(engine->Name());
+}
+
+TEST_P(BoundingBoxCameraTest, BoundingBoxCameraBoxes)
+{
+  BoundingBoxCameraBoxes(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(BoundingBoxCamera, BoundingBoxCameraTest,
+    RENDER_ENGINE_VALUES, ignition::rendering::PrintToStringParam());
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -17,11 +17,17 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 
 #include "test_config.h"  // NOLINT(build/include)
 
 #include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/PixelFormat.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderingIface.hh"
 #include "ignition/rendering/Scene.hh"
@@ -54,6 +60,21 @@ class CameraTest: public testing::Test,
   // Test selecting visual with custom shader
   public: void ShaderSelection(const std::string &_renderEngine);
 
+  // Test capturing images asynchronously
+  public: void CaptureAsync(const std::string &_renderEngine);
+
+  // Test capturing images from a batch of poses
+  public: void CaptureBatch(const std::string &_renderEngine);
+
+  // Test copying depth and labels written by the color scene pass
+  public: void CopyDepthAndLabels(const std::string &_renderEngine);
+
+  // Test copying images as I420
+  public: void CopyI420(const std::string &_renderEngine);
+
+  // Test capturing regions of the camera image
+  public: void CaptureRegion(const std::string &_renderEngine);
+
   // Path to test media directory
   public: const std::string TEST_MEDIA_PATH =
           ignition::common::joinPaths(std::string(PROJECT_SOURCE_PATH),
@@ -286,6 +307,21 @@ void CameraTest::VisualAt(const std::string &_renderEngine)
     }
   }
 
+  // batched queries should return the same visuals as single queries
+  {
+    std::vector<math::Vector2i> positions;
+    for (auto x = 0u; x < camera->ImageWidth(); x = x + 100)
+      positions.push_back(math::Vector2i(x, camera->ImageHeight() / 2));
+
+    std::vector<VisualPtr> visuals = camera->VisualsAt(positions);
+    ASSERT_EQ(positions.size(), visuals.size());
+    for (unsigned int i = 0; i < positions.size(); ++i)
+    {
+      auto vis = camera->VisualAt(positions[i]);
+      EXPECT_EQ(vis, visuals[i]) << "X: " << positions[i].X();
+    }
+  }
+
   // change camera size
   camera->SetImageWidth(1200);
   camera->SetImageHeight(800);
@@ -307,6 +343,49 @@ void CameraTest::VisualAt(const std::string &_renderEngine)
     }
   }
 
+  // picks from object ids should return the same visuals as the
+  // selection buffer
+  EXPECT_FALSE(camera->ObjectIdPickingEnabled());
+  if (_renderEngine == "ogre2")
+  {
+    // object ids only tell visuals apart by their materials, the labels
+    // show which visual wrote the object id of a pixel
+    box->SetMaterial(scene->CreateMaterial());
+    box->SetUserData("label", 1);
+    sphere->SetMaterial(scene->CreateMaterial());
+    sphere->SetUserData("label", 2);
+    camera->SetAntiAliasing(0);
+    camera->Update();
+
+    std::vector<VisualPtr> expected;
+    for (auto x = 0u; x < camera->ImageWidth(); x = x + 100)
+    {
+      expected.push_back(
+          camera->VisualAt(math::Vector2i(x, camera->ImageHeight() / 2)));
+    }
+
+    camera->SetObjectIdPickingEnabled(true);
+    EXPECT_TRUE(camera->ObjectIdPickingEnabled());
+    camera->Update();
+
+    // the scene passes wrote object ids, not only the selection buffer
+    std::vector<int> labels(camera->ImageWidth() * camera->ImageHeight());
+    ASSERT_TRUE(camera->CopyLabels(labels.data(), 0));
+
+    unsigned int i = 0u;
+    const unsigned int y = camera->ImageHeight() / 2;
+    for (auto x = 0u; x < camera->ImageWidth(); x = x + 100, ++i)
+    {
+      auto vis = camera->VisualAt(math::Vector2i(x, y));
+      EXPECT_EQ(expected[i], vis) << "X: " << x;
+
+      int label = 0;
+      if (expected[i])
+        label = expected[i] == box ? 1 : 2;
+      EXPECT_EQ(label, labels[y * camera->ImageWidth() + x]) << "X: " << x;
+    }
+  }
+
   // Clean up
   engine->DestroyScene(scene);
   rendering::unloadEngine(engine->Name());
@@ -724,6 +803,358 @@ void CameraTest::ShaderSelection(const std::string &_renderEngine)
   rendering::unloadEngine(engine->Name());
 }
 
+/////////////////////////////////////////////////
+void CameraTest::CaptureAsync(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+  scene->SetBackgroundColor(0, 0, 0);
+  scene->SetAmbientLight(1, 1, 1);
+
+  VisualPtr root = scene->RootVisual();
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_TRUE(camera != nullptr);
+  camera->SetWorldPosition(-1, 0, 0);
+  root->AddChild(camera);
+
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  MaterialPtr green = scene->CreateMaterial();
+  green->SetAmbient(0.0, 1.0, 0.0);
+  green->SetDiffuse(0.0, 1.0, 0.0);
+  box->SetMaterial(green);
+  root->AddChild(box);
+
+  Image expected = camera->CreateImage();
+  camera->Capture(expected);
+
+  // queue more copies than are kept in flight
+  const unsigned int count = 6u;
+  std::vector<Image> images;
+  for (unsigned int i = 0; i < count; ++i)
+    images.push_back(camera->CreateImage());
+
+  std::vector<unsigned int> written;
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    EXPECT_TRUE(camera->CaptureAsync(images[i],
+        [&written, i]() { written.push_back(i); }));
+  }
+  camera->WaitForAsyncCopies();
+
+  // callbacks are called once each, in order
+  ASSERT_EQ(count, written.size());
+  for (unsigned int i = 0; i < count; ++i)
+    EXPECT_EQ(i, written[i]);
+
+  unsigned int size = expected.MemorySize();
+  for (const auto &image : images)
+  {
+    EXPECT_EQ(0, memcmp(expected.Data<unsigned char>(),
+        image.Data<unsigned char>(), size));
+  }
+
+  // images of the wrong size are rejected
+  Image wrongSize(1u, 1u, camera->ImageFormat());
+  bool called = false;
+  EXPECT_FALSE(camera->CopyAsync(wrongSize, [&called]() { called = true; }));
+  camera->WaitForAsyncCopies();
+  EXPECT_FALSE(called);
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void CameraTest::CaptureBatch(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+  scene->SetBackgroundColor(0, 0, 0);
+  scene->SetAmbientLight(1, 1, 1);
+
+  VisualPtr root = scene->RootVisual();
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_TRUE(camera != nullptr);
+  camera->SetWorldPosition(-1, 0, 0);
+  root->AddChild(camera);
+
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  MaterialPtr green = scene->CreateMaterial();
+  green->SetAmbient(0.0, 1.0, 0.0);
+  green->SetDiffuse(0.0, 1.0, 0.0);
+  box->SetMaterial(green);
+  root->AddChild(box);
+
+  // alternate between looking at the box and away from it
+  const math::Pose3d toBox(-1, 0, 0, 0, 0, 0);
+  const math::Pose3d awayFromBox(-1, 0, 0, 0, 0, IGN_PI);
+  Image boxImage = camera->CreateImage();
+  camera->SetWorldPose(toBox);
+  camera->Capture(boxImage);
+  Image awayImage = camera->CreateImage();
+  camera->SetWorldPose(awayFromBox);
+  camera->Capture(awayImage);
+  camera->SetWorldPosition(0, 0, 5);
+
+  // more poses than images in the ring
+  std::vector<math::Pose3d> poses;
+  for (unsigned int i = 0; i < 20u; ++i)
+    poses.push_back(i % 2u == 0u ? toBox : awayFromBox);
+
+  unsigned int size = boxImage.MemorySize();
+  std::vector<unsigned int> written;
+  EXPECT_TRUE(camera->CaptureBatch(poses,
+      [&](unsigned int _index, const Image &_image)
+      {
+        written.push_back(_index);
+        const Image &expected = _index % 2u == 0u ? boxImage : awayImage;
+        EXPECT_EQ(0, memcmp(expected.Data<unsigned char>(),
+            _image.Data<unsigned char>(), size)) << "Index: " << _index;
+      }));
+
+  // callbacks are called once each, in order
+  ASSERT_EQ(poses.size(), written.size());
+  for (unsigned int i = 0; i < written.size(); ++i)
+    EXPECT_EQ(i, written[i]);
+
+  // the camera is moved back
+  EXPECT_EQ(math::Vector3d(0, 0, 5), camera->WorldPosition());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void CameraTest::CopyDepthAndLabels(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  VisualPtr root = scene->RootVisual();
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_TRUE(camera != nullptr);
+  camera->SetWorldPosition(-2, 0, 0);
+  camera->SetImageWidth(320);
+  camera->SetImageHeight(240);
+  camera->SetAntiAliasing(0);
+  root->AddChild(camera);
+
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetMaterial(scene->CreateMaterial());
+  box->SetUserData("label", 5);
+  root->AddChild(box);
+
+  const unsigned int count = camera->ImageWidth() * camera->ImageHeight();
+  std::vector<float> depth(count);
+  std::vector<int> labels(count);
+
+  // the outputs are not kept unless enabled
+  Image image = camera->CreateImage();
+  camera->Capture(image);
+  EXPECT_FALSE(camera->CopyDepth(depth.data()));
+  EXPECT_FALSE(camera->CopyLabels(labels.data(), 0));
+
+  if (_renderEngine != "ogre2")
+  {
+    engine->DestroyScene(scene);
+    rendering::unloadEngine(engine->Name());
+    return;
+  }
+
+  camera->SetDepthPickingEnabled(true);
+  camera->SetObjectIdPickingEnabled(true);
+  camera->Capture(image);
+  ASSERT_TRUE(camera->CopyDepth(depth.data()));
+  ASSERT_TRUE(camera->CopyLabels(labels.data(), 0));
+
+  // the box face is 1.5 m in front of the camera
+  unsigned int center = camera->ImageHeight() / 2u * camera->ImageWidth() +
+      camera->ImageWidth() / 2u;
+  EXPECT_NEAR(1.5, depth[center], 1e-3);
+  EXPECT_EQ(5, labels[center]);
+
+  // nothing is rendered at the corner
+  EXPECT_TRUE(std::isinf(depth[0]));
+  EXPECT_EQ(0, labels[0]);
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void CameraTest::CopyI420(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+  scene->SetBackgroundColor(0.2, 0.4, 0.6);
+  scene->SetAmbientLight(1, 1, 1);
+
+  VisualPtr root = scene->RootVisual();
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_TRUE(camera != nullptr);
+  camera->SetWorldPosition(-1, 0, 0);
+  camera->SetImageWidth(64);
+  camera->SetImageHeight(48);
+  camera->SetImageFormat(PF_R8G8B8);
+  root->AddChild(camera);
+
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  MaterialPtr green = scene->CreateMaterial();
+  green->SetAmbient(0.0, 1.0, 0.0);
+  green->SetDiffuse(0.0, 1.0, 0.0);
+  box->SetMaterial(green);
+  root->AddChild(box);
+
+  Image rgb = camera->CreateImage();
+  camera->Capture(rgb);
+
+  // the conversion must match the one done on the CPU, up to rounding
+  unsigned int size = PixelUtil::I420MemorySize(64u, 48u);
+  std::vector<unsigned char> expected(size);
+  ASSERT_TRUE(PixelUtil::ConvertToI420(rgb.Data<unsigned char>(), PF_R8G8B8,
+      expected.data(), 64u, 48u));
+
+  Image yuv(64u, 72u, PF_L8);
+  ASSERT_TRUE(camera->CopyI420(yuv));
+  const unsigned char *data = yuv.Data<unsigned char>();
+  for (unsigned int i = 0; i < size; ++i)
+    EXPECT_NEAR(expected[i], data[i], 1) << i;
+
+  // images of the wrong size or format are rejected
+  Image wrongSize(64u, 48u, PF_L8);
+  EXPECT_FALSE(camera->CopyI420(wrongSize));
+  Image wrongFormat(64u, 72u, PF_R8G8B8);
+  EXPECT_FALSE(camera->CopyI420(wrongFormat));
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void CameraTest::CaptureRegion(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+  scene->SetBackgroundColor(0.2, 0.4, 0.6);
+  scene->SetAmbientLight(1, 1, 1);
+
+  VisualPtr root = scene->RootVisual();
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_TRUE(camera != nullptr);
+  camera->SetWorldPosition(-2, 0, 0);
+  camera->SetImageWidth(64);
+  camera->SetImageHeight(48);
+  camera->SetImageFormat(PF_R8G8B8);
+  root->AddChild(camera);
+
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  MaterialPtr green = scene->CreateMaterial();
+  green->SetAmbient(0.0, 1.0, 0.0);
+  green->SetDiffuse(0.0, 1.0, 0.0);
+  box->SetMaterial(green);
+  root->AddChild(box);
+
+  Image full = camera->CreateImage();
+  camera->Capture(full);
+
+  // the region must match the same pixels of the full frame, up to the
+  // rasterization of the box edges
+  const unsigned int x = 8u;
+  const unsigned int y = 20u;
+  Image region(32u, 16u, PF_R8G8B8);
+  ASSERT_TRUE(camera->CaptureRegion(x, y, region));
+
+  const unsigned char *fullData = full.Data<unsigned char>();
+  const unsigned char *regionData = region.Data<unsigned char>();
+  unsigned int mismatches = 0u;
+  for (unsigned int row = 0u; row < region.Height(); ++row)
+  {
+    for (unsigned int col = 0u; col < region.Width() * 3u; ++col)
+    {
+      int expected = fullData[((y + row) * 64u + x) * 3u + col];
+      int actual = regionData[row * region.Width() * 3u + col];
+      if (std::abs(expected - actual) > 2)
+        ++mismatches;
+    }
+  }
+  EXPECT_LT(mismatches, region.Width() * 3u * 2u);
+
+  // the box is in the middle of the region
+  const unsigned char *center = regionData + (8u * 32u + 16u) * 3u;
+  EXPECT_GT(center[1], center[0]);
+  EXPECT_GT(center[1], center[2]);
+
+  // the camera renders the full frame as before
+  Image after = camera->CreateImage();
+  camera->Capture(after);
+  for (unsigned int i = 0; i < 64u * 48u * 3u; ++i)
+    EXPECT_EQ(fullData[i], after.Data<unsigned char>()[i]) << i;
+
+  // regions outside of the image or of another format are rejected
+  EXPECT_FALSE(camera->CaptureRegion(40u, 0u, region));
+  EXPECT_FALSE(camera->CaptureRegion(0u, 40u, region));
+  Image wrongFormat(32u, 16u, PF_L8);
+  EXPECT_FALSE(camera->CaptureRegion(0u, 0u, wrongFormat));
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
 /////////////////////////////////////////////////
 TEST_P(CameraTest, Track)
 {
@@ -754,6 +1185,36 @@ TEST_P(CameraTest, ShaderSelection)
   ShaderSelection(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(CameraTest, CaptureAsync)
+{
+  CaptureAsync(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraTest, CaptureBatch)
+{
+  CaptureBatch(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraTest, CopyDepthAndLabels)
+{
+  CopyDepthAndLabels(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraTest, CopyI420)
+{
+  CopyI420(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(CameraTest, CaptureRegion)
+{
+  CaptureRegion(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(Camera, CameraTest,
     RENDER_ENGINE_VALUES,
     ignition::rendering::PrintToStringParam());
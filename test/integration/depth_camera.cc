@@ -17,6 +17,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Filesystem.hh>
 #include <ignition/common/Event.hh>
@@ -24,6 +27,7 @@
 #include "test_config.h"  // NOLINT(build/include)
 
 #include "ignition/rendering/DepthCamera.hh"
+#include "ignition/rendering/DepthCompression.hh"
 #include "ignition/rendering/ParticleEmitter.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderingIface.hh"
@@ -78,14 +82,6 @@ void DepthCameraTest::DepthCameraBoxes(
   double unitBoxSize = 1.0;
   ignition::math::Vector3d boxPosition(1.8, 0.0, 0.0);
 
-  // Optix is not supported
-  if (_renderEngine.compare("optix") == 0)
-  {
-    igndbg << "Engine '" << _renderEngine
-              << "' doesn't support depth cameras" << std::endl;
-    return;
-  }
-
   // Setup ign-rendering with an empty scene
   auto *engine = ignition::rendering::engine(_renderEngine);
   if (!engine)
@@ -465,6 +461,158 @@ void DepthCameraTest::DepthCameraBoxes(
       }
     }
 
+    // Verify async readback delivers the same data, one or more frames late
+    depthCamera->SetAsyncReadback(true);
+    if (_renderEngine.compare("ogre2") == 0 ||
+        _renderEngine.compare("ogre") == 0)
+    {
+      EXPECT_TRUE(depthCamera->AsyncReadback());
+
+      std::fill(scan, scan + imgHeight_ * imgWidth_, 0.0f);
+      g_depthCounter = 0u;
+      g_pointCloudCounter = 0u;
+      depthCamera->Update();
+      EXPECT_EQ(0u, g_depthCounter);
+      EXPECT_EQ(0u, g_pointCloudCounter);
+
+      depthCamera->Update();
+      depthCamera->Update();
+      EXPECT_GE(g_depthCounter, 1u);
+      EXPECT_LE(g_depthCounter, 2u);
+      EXPECT_EQ(g_depthCounter, g_pointCloudCounter);
+      EXPECT_FLOAT_EQ(expectedRange, scan[mid]);
+      EXPECT_FLOAT_EQ(expectedRange, scan[left]);
+      EXPECT_FLOAT_EQ(expectedRange, scan[right]);
+
+      // switching back to sync mode delivers data immediately again
+      depthCamera->SetAsyncReadback(false);
+      EXPECT_FALSE(depthCamera->AsyncReadback());
+      g_depthCounter = 0u;
+      depthCamera->Update();
+      EXPECT_EQ(1u, g_depthCounter);
+    }
+    else
+    {
+      EXPECT_FALSE(depthCamera->AsyncReadback());
+    }
+
+    // Verify zero-copy views and depth only readback
+    unsigned int viewCounter = 0u;
+    unsigned int viewChannels = 0u;
+    float viewDepth = 0.0f;
+    auto onDepthFrameView = [&](const float *_data, unsigned int _width,
+        unsigned int, unsigned int _channels, unsigned int _rowPitch,
+        const std::string &)
+    {
+      viewCounter++;
+      viewChannels = _channels;
+      const float *row = reinterpret_cast<const float *>(
+          reinterpret_cast<const unsigned char *>(_data) +
+          (_rowPitch * (mid / _width)));
+      viewDepth = row[(mid % _width) * _channels];
+    };
+    ignition::common::ConnectionPtr viewConnection =
+        depthCamera->ConnectNewDepthFrameView(onDepthFrameView);
+    if (_renderEngine.compare("ogre2") == 0)
+    {
+      ASSERT_NE(nullptr, viewConnection);
+      depthCamera->Update();
+      EXPECT_EQ(1u, viewCounter);
+      EXPECT_EQ(4u, viewChannels);
+      EXPECT_FLOAT_EQ(expectedRange, viewDepth);
+
+      // depth only readback kicks in once no point cloud subscribers remain
+      depthCamera->SetDepthOnlyReadback(true);
+      EXPECT_TRUE(depthCamera->DepthOnlyReadback());
+      connection2.reset();
+      g_depthCounter = 0u;
+      std::fill(scan, scan + imgHeight_ * imgWidth_, 0.0f);
+      depthCamera->Update();
+      EXPECT_EQ(2u, viewCounter);
+      EXPECT_EQ(1u, viewChannels);
+      EXPECT_FLOAT_EQ(expectedRange, viewDepth);
+      EXPECT_EQ(1u, g_depthCounter);
+      EXPECT_FLOAT_EQ(expectedRange, scan[mid]);
+      EXPECT_FLOAT_EQ(expectedRange, scan[left]);
+      EXPECT_FLOAT_EQ(expectedRange, scan[right]);
+
+      depthCamera->SetDepthOnlyReadback(false);
+      EXPECT_FALSE(depthCamera->DepthOnlyReadback());
+
+      // Verify depth encoded on the GPU
+      unsigned int encodedCounter = 0u;
+      std::string encodedFormat;
+      uint16_t encodedDepth = 0u;
+      auto onEncodedDepthFrame = [&](const void *_data, unsigned int _width,
+          unsigned int, unsigned int _rowPitch, const std::string &_format)
+      {
+        encodedCounter++;
+        encodedFormat = _format;
+        const uint16_t *row = reinterpret_cast<const uint16_t *>(
+            static_cast<const unsigned char *>(_data) +
+            (_rowPitch * (mid / _width)));
+        encodedDepth = row[mid % _width];
+      };
+      ignition::common::ConnectionPtr encodedConnection =
+          depthCamera->ConnectNewEncodedDepthFrame(onEncodedDepthFrame);
+      ASSERT_NE(nullptr, encodedConnection);
+
+      // Verify compressed millimeter depth
+      std::vector<uint16_t> decompressedDepth;
+      auto onCompressedDepthFrame = [&](const uint8_t *_data, size_t _size)
+      {
+        unsigned int width = 0u;
+        unsigned int height = 0u;
+        EXPECT_TRUE(ignition::rendering::DepthCompression::Decompress(_data,
+            _size, decompressedDepth, width, height));
+        EXPECT_EQ(static_cast<unsigned int>(imgWidth_), width);
+        EXPECT_EQ(static_cast<unsigned int>(imgHeight_), height);
+      };
+      ignition::common::ConnectionPtr compressedConnection =
+          depthCamera->ConnectNewCompressedDepthFrame(onCompressedDepthFrame);
+      ASSERT_NE(nullptr, compressedConnection);
+      EXPECT_FALSE(depthCamera->SetDepthOutputFormat(
+          ignition::rendering::PF_R8G8B8));
+      EXPECT_EQ(ignition::rendering::PF_FLOAT32_R,
+          depthCamera->DepthOutputFormat());
+
+      EXPECT_TRUE(depthCamera->SetDepthOutputFormat(
+          ignition::rendering::PF_L16));
+      EXPECT_EQ(ignition::rendering::PF_L16,
+          depthCamera->DepthOutputFormat());
+      g_depthCounter = 0u;
+      std::fill(scan, scan + imgHeight_ * imgWidth_, 0.0f);
+      depthCamera->Update();
+      EXPECT_EQ(1u, encodedCounter);
+      EXPECT_EQ("L16", encodedFormat);
+      EXPECT_NEAR(expectedRange * 1000.0, encodedDepth, 1.0);
+      ASSERT_EQ(static_cast<size_t>(imgWidth_ * imgHeight_),
+          decompressedDepth.size());
+      EXPECT_EQ(encodedDepth, decompressedDepth[mid]);
+      EXPECT_EQ(1u, viewChannels);
+      EXPECT_EQ(1u, g_depthCounter);
+      EXPECT_FLOAT_EQ(encodedDepth * 0.001f, scan[mid]);
+      EXPECT_NEAR(expectedRange, scan[mid], 0.001);
+
+      EXPECT_TRUE(depthCamera->SetDepthOutputFormat(
+          ignition::rendering::PF_FLOAT16_R));
+      depthCamera->Update();
+      EXPECT_EQ(2u, encodedCounter);
+      EXPECT_EQ("FLOAT16_R", encodedFormat);
+      EXPECT_NEAR(expectedRange, scan[mid], expectedRange / 1024.0);
+
+      EXPECT_TRUE(depthCamera->SetDepthOutputFormat(
+          ignition::rendering::PF_FLOAT32_R));
+      encodedConnection.reset();
+      compressedConnection.reset();
+    }
+    else
+    {
+      EXPECT_EQ(nullptr, viewConnection);
+      EXPECT_FALSE(depthCamera->DepthOnlyReadback());
+    }
+    viewConnection.reset();
+
     // Clean up
     connection.reset();
     delete [] scan;
@@ -17,6 +17,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Image.hh>
 #include <ignition/common/Filesystem.hh>
@@ -67,19 +71,41 @@ class GpuRaysTest: public testing::Test,
 
   // Test single ray box intersection
   public: void SingleRay(const std::string &_renderEngine);
+
+  // Test gpu rays sharing a cubemap in a ray group
+  public: void RayGroup(const std::string &_renderEngine);
+
+  // Test rays with a non-uniform vertical beam table
+  public: void VerticalBeams(const std::string &_renderEngine);
+
+  // Test rays rendered in time segments while the sensor moves
+  public: void ScanSegments(const std::string &_renderEngine);
+
+  // Test rays with an arbitrary ray pattern
+  public: void RayPattern(const std::string &_renderEngine);
+
+  // Test point clouds computed by the gpu rays
+  public: void PointCloud(const std::string &_renderEngine);
+
+  // Create a wall facing rays cast along +x from the origin, with its face
+  // at the given distance
+  protected: void CreateWall(ScenePtr _scene, double _distance);
 };
 
+/////////////////////////////////////////////////
+void GpuRaysTest::CreateWall(ScenePtr _scene, double _distance)
+{
+  VisualPtr wall = _scene->CreateVisual("wall");
+  wall->AddGeometry(_scene->CreateBox());
+  wall->SetLocalScale(0.2, 40, 40);
+  wall->SetWorldPosition(_distance + 0.1, 0, 0);
+  _scene->RootVisual()->AddChild(wall);
+}
+
 /////////////////////////////////////////////////
 /// \brief Test GPU rays configuraions
 void GpuRaysTest::Configure(const std::string &_renderEngine)
 {
-  if (_renderEngine == "optix")
-  {
-    igndbg << "GpuRays not supported yet in rendering engine: "
-            << _renderEngine << std::endl;
-    return;
-  }
-
   // create and populate scene
   RenderEngine *engine = rendering::engine(_renderEngine);
   if (!engine)
@@ -170,13 +196,6 @@ void GpuRaysTest::RaysUnitBox(const std::string &_renderEngine)
   return;
 #endif
 
-  if (_renderEngine == "optix")
-  {
-    igndbg << "GpuRays not supported yet in rendering engine: "
-            << _renderEngine << std::endl;
-    return;
-  }
-
   // Test GPU rays with 3 boxes in the world.
   // First GPU rays at identity orientation, second at 90 degree roll
   // First place 2 of 3 boxes within range and verify range values.
@@ -302,6 +321,45 @@ void GpuRaysTest::RaysUnitBox(const std::string &_renderEngine)
     EXPECT_NEAR(scan[mid+1], laserRetro1, 5.0);
     EXPECT_NEAR(scan[0+1], laserRetro2, 5.0);
     EXPECT_FLOAT_EQ(scan[last+1], 0.0);
+
+    // verify data encoded to 16 bit millimeters on the gpu
+    EXPECT_FALSE(gpuRays->SetOutputFormat(PF_FLOAT32_RGBA));
+    EXPECT_EQ(PF_FLOAT32_RGB, gpuRays->OutputFormat());
+    EXPECT_TRUE(gpuRays->SetOutputFormat(PF_UINT16_RGB));
+    EXPECT_EQ(PF_UINT16_RGB, gpuRays->OutputFormat());
+
+    std::vector<uint16_t> encoded;
+    std::string encodedFormat;
+    common::ConnectionPtr encodedConnection =
+        gpuRays->ConnectNewEncodedGpuRaysFrame(
+        [&](const void *_frame, unsigned int _width, unsigned int,
+            unsigned int, const std::string &_format)
+        {
+          const uint16_t *frame = static_cast<const uint16_t *>(_frame);
+          encoded.assign(frame, frame + _width * 3u);
+          encodedFormat = _format;
+        });
+    gpuRays->Update();
+    ASSERT_EQ(hRayCount * 3u, encoded.size());
+    EXPECT_EQ("UINT16_RGB", encodedFormat);
+    EXPECT_NEAR(expectedRangeAtMidPointBox1 * 1000.0, encoded[mid],
+        LASER_TOL * 1000.0 + 1.0);
+    EXPECT_NEAR(laserRetro1, encoded[mid+1], 5.0);
+    EXPECT_EQ(0u, encoded[last]);
+
+    // float subscribers get the decoded data
+    EXPECT_NEAR(scan[mid], expectedRangeAtMidPointBox1, LASER_TOL + 0.001);
+    EXPECT_FLOAT_EQ(encoded[mid] * 0.001f, scan[mid]);
+    EXPECT_FLOAT_EQ(scan[last], ignition::math::INF_F);
+
+    EXPECT_TRUE(gpuRays->SetOutputFormat(PF_FLOAT16_RGB));
+    gpuRays->Update();
+    EXPECT_EQ("FLOAT16_RGB", encodedFormat);
+    EXPECT_NEAR(scan[mid], expectedRangeAtMidPointBox1, LASER_TOL + 0.01);
+    EXPECT_FLOAT_EQ(scan[last], ignition::math::INF_F);
+
+    EXPECT_TRUE(gpuRays->SetOutputFormat(PF_FLOAT32_RGB));
+    encodedConnection.reset();
   }
 
   // Verify rays caster 2 range readings
@@ -317,6 +375,28 @@ void GpuRaysTest::RaysUnitBox(const std::string &_renderEngine)
   EXPECT_NEAR(scan2[mid], expectedRangeAtMidPointBox1, LASER_TOL);
   EXPECT_FLOAT_EQ(scan2[last], maxRange);
 
+  // Verify async readback delivers the same data one frame late
+  gpuRays->SetAsyncReadback(true);
+  if (_renderEngine == "ogre")
+  {
+    EXPECT_TRUE(gpuRays->AsyncReadback());
+
+    std::fill(scan, scan + hRayCount * vRayCount * channels, 0.0f);
+    gpuRays->Update();
+    EXPECT_FLOAT_EQ(0.0f, scan[mid]);
+
+    gpuRays->Update();
+    EXPECT_NEAR(scan[mid], expectedRangeAtMidPointBox1, LASER_TOL);
+    EXPECT_NEAR(scan[0], expectedRangeAtMidPointBox2, LASER_TOL);
+    EXPECT_FLOAT_EQ(scan[last], ignition::math::INF_F);
+  }
+  else
+  {
+    EXPECT_FALSE(gpuRays->AsyncReadback());
+  }
+  gpuRays->SetAsyncReadback(false);
+  EXPECT_FALSE(gpuRays->AsyncReadback());
+
   // Move all boxes out of range
   visualBox1->SetWorldPosition(
       ignition::math::Vector3d(maxRange + 1, 0, 0));
@@ -357,13 +437,6 @@ void GpuRaysTest::LaserVertical(const std::string &_renderEngine)
   return;
 #endif
 
-  if (_renderEngine == "optix")
-  {
-    igndbg << "GpuRays not supported yet in rendering engine: "
-            << _renderEngine << std::endl;
-    return;
-  }
-
   // Test a rays that has a vertical range component.
   // Place a box within range and verify range values,
   // then move the box out of range and verify range values
@@ -712,13 +785,6 @@ void GpuRaysTest::SingleRay(const std::string &_renderEngine)
   return;
 #endif
 
-  if (_renderEngine == "optix")
-  {
-    igndbg << "GpuRays not supported yet in rendering engine: "
-            << _renderEngine << std::endl;
-    return;
-  }
-
   // Test GPU single ray box intersection.
   // Place GPU above box looking downwards
   // ray should intersect with center of box
@@ -800,6 +866,491 @@ void GpuRaysTest::SingleRay(const std::string &_renderEngine)
   rendering::unloadEngine(engine->Name());
 }
 
+/////////////////////////////////////////////////
+void GpuRaysTest::RayGroup(const std::string &_renderEngine)
+{
+#ifdef __APPLE__
+  ignerr << "Skipping test for apple, see issue #35." << std::endl;
+  return;
+#endif
+
+  const double hMinAngle = -IGN_PI/2.0;
+  const double hMaxAngle = IGN_PI/2.0;
+  const double minRange = 0.1;
+  const double maxRange = 10.0;
+  const int hRayCount = 320;
+  const int vRayCount = 1;
+
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  VisualPtr root = scene->RootVisual();
+
+  // Create two co-located ray casters, the second one rotated
+  ignition::math::Pose3d testPose(ignition::math::Vector3d(0, 0, 0.1),
+      ignition::math::Quaterniond::Identity);
+  ignition::math::Pose3d testPose2(ignition::math::Vector3d(0, 0, 0.1),
+      ignition::math::Quaterniond(0, 0, IGN_PI/2.0));
+
+  std::vector<GpuRaysPtr> rays;
+  for (const auto &pose : {testPose, testPose2})
+  {
+    GpuRaysPtr gpuRays = scene->CreateGpuRays();
+    gpuRays->SetWorldPosition(pose.Pos());
+    gpuRays->SetWorldRotation(pose.Rot());
+    gpuRays->SetNearClipPlane(minRange);
+    gpuRays->SetFarClipPlane(maxRange);
+    gpuRays->SetAngleMin(hMinAngle);
+    gpuRays->SetAngleMax(hMaxAngle);
+    gpuRays->SetRayCount(hRayCount);
+    gpuRays->SetVerticalRayCount(vRayCount);
+    gpuRays->SetRayGroup("group");
+    root->AddChild(gpuRays);
+    rays.push_back(gpuRays);
+  }
+
+  if (_renderEngine != "ogre2")
+  {
+    EXPECT_TRUE(rays[0]->RayGroup().empty());
+    engine->DestroyScene(scene);
+    rendering::unloadEngine(engine->Name());
+    return;
+  }
+  EXPECT_EQ("group", rays[0]->RayGroup());
+  EXPECT_EQ("group", rays[1]->RayGroup());
+
+  // box in front of the first ray caster
+  VisualPtr visualBox1 = scene->CreateVisual();
+  visualBox1->AddGeometry(scene->CreateBox());
+  visualBox1->SetWorldPosition(3, 0, 0.5);
+  root->AddChild(visualBox1);
+
+  // box in front of the second ray caster
+  VisualPtr visualBox2 = scene->CreateVisual();
+  visualBox2->AddGeometry(scene->CreateBox());
+  visualBox2->SetWorldPosition(0, 5, 0.5);
+  root->AddChild(visualBox2);
+
+  unsigned int channels = rays[0]->Channels();
+  unsigned int len = hRayCount * vRayCount * channels;
+  std::vector<float> scan(len);
+  std::vector<float> scan2(len);
+
+  // the first ray caster renders the shared cubemap
+  rays[0]->Update();
+  rays[1]->Update();
+  rays[0]->Copy(scan.data());
+  rays[1]->Copy(scan2.data());
+
+  int mid = static_cast<int>(hRayCount/2) * channels;
+  int last = (hRayCount - 1) * channels;
+  double unitBoxSize = 1.0;
+  double expectedRangeBox1 = 3.0 - unitBoxSize/2;
+  double expectedRangeBox2 = 5.0 - unitBoxSize/2;
+
+  EXPECT_FLOAT_EQ(scan[0], ignition::math::INF_F);
+  EXPECT_NEAR(scan[mid], expectedRangeBox1, LASER_TOL);
+  EXPECT_NEAR(scan[last], expectedRangeBox2, LASER_TOL);
+
+  // the second ray caster samples the cubemap in its own frame
+  EXPECT_NEAR(scan2[0], expectedRangeBox1, LASER_TOL);
+  EXPECT_NEAR(scan2[mid], expectedRangeBox2, LASER_TOL);
+  EXPECT_FLOAT_EQ(scan2[last], ignition::math::INF_F);
+
+  // leaving the group renders its own cubemap with the same result
+  std::vector<float> scan3(len);
+  rays[1]->SetRayGroup("");
+  EXPECT_TRUE(rays[1]->RayGroup().empty());
+  rays[1]->Update();
+  rays[1]->Copy(scan3.data());
+  for (unsigned int i = 0; i < len; i += channels)
+    EXPECT_NEAR(scan2[i], scan3[i], LASER_TOL);
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void GpuRaysTest::VerticalBeams(const std::string &_renderEngine)
+{
+#ifdef __APPLE__
+  ignerr << "Skipping test for apple, see issue #35." << std::endl;
+  return;
+#endif
+
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  VisualPtr root = scene->RootVisual();
+
+  // single column of rays looking at a wall along +x
+  GpuRaysPtr gpuRays = scene->CreateGpuRays("gpu_rays");
+  gpuRays->SetNearClipPlane(0.05);
+  gpuRays->SetFarClipPlane(40.0);
+  gpuRays->SetAngleMin(0.0);
+  gpuRays->SetAngleMax(0.0);
+  gpuRays->SetRayCount(1);
+  gpuRays->SetVerticalRayCount(1);
+
+  // beams packed densely around the horizon, with some offset in azimuth
+  const std::vector<double> elevations = {-0.3, -0.05, 0.0, 0.25};
+  const std::vector<double> offsets = {0.0, 0.1, 0.0, -0.2};
+
+  // the offsets must match the elevations
+  EXPECT_FALSE(gpuRays->SetVerticalBeams(elevations, {0.0, 0.1}));
+  EXPECT_TRUE(gpuRays->VerticalBeamElevations().empty());
+
+  EXPECT_TRUE(gpuRays->SetVerticalBeams(elevations, offsets));
+  EXPECT_EQ(elevations, gpuRays->VerticalBeamElevations());
+  EXPECT_EQ(offsets, gpuRays->VerticalBeamAzimuthOffsets());
+  EXPECT_EQ(elevations.size(), gpuRays->VerticalRangeCount());
+  EXPECT_DOUBLE_EQ(-0.3, gpuRays->VerticalAngleMin().Radian());
+  EXPECT_DOUBLE_EQ(0.25, gpuRays->VerticalAngleMax().Radian());
+  root->AddChild(gpuRays);
+
+  const double wallDist = 5.0;
+  this->CreateWall(scene, wallDist);
+
+  gpuRays->Update();
+
+  unsigned int channels = gpuRays->Channels();
+  std::vector<float> scan(
+      gpuRays->RayCount() * gpuRays->VerticalRayCount() * channels);
+  gpuRays->Copy(scan.data());
+
+  // each row of the output is one beam of the table
+  for (unsigned int i = 0; i < elevations.size(); ++i)
+  {
+    double expectedRange = wallDist /
+        (std::cos(elevations[i]) * std::cos(offsets[i]));
+    EXPECT_NEAR(scan[i * channels], expectedRange, 1e-2) << "beam " << i;
+  }
+
+  // an empty table restores uniform spacing
+  EXPECT_TRUE(gpuRays->SetVerticalBeams({}, {}));
+  EXPECT_TRUE(gpuRays->VerticalBeamElevations().empty());
+  EXPECT_EQ(1u, gpuRays->VerticalRangeCount());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void GpuRaysTest::ScanSegments(const std::string &_renderEngine)
+{
+#ifdef __APPLE__
+  ignerr << "Skipping test for apple, see issue #35." << std::endl;
+  return;
+#endif
+
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  VisualPtr root = scene->RootVisual();
+
+  const double hMinAngle = -0.4;
+  const double hMaxAngle = 0.4;
+  const unsigned int hRayCount = 100u;
+
+  GpuRaysPtr gpuRays = scene->CreateGpuRays("gpu_rays");
+  gpuRays->SetNearClipPlane(0.05);
+  gpuRays->SetFarClipPlane(40.0);
+  gpuRays->SetAngleMin(hMinAngle);
+  gpuRays->SetAngleMax(hMaxAngle);
+  gpuRays->SetRayCount(hRayCount);
+  gpuRays->SetVerticalRayCount(1);
+  root->AddChild(gpuRays);
+
+  // the whole scan is rendered at the current pose by default
+  EXPECT_EQ(1u, gpuRays->ScanSegmentCount());
+  EXPECT_EQ(gpuRays->WorldPose(), gpuRays->ScanStartPose());
+  gpuRays->SetScanSegmentCount(0u);
+  EXPECT_EQ(1u, gpuRays->ScanSegmentCount());
+
+  const double wallDist = 5.0;
+  this->CreateWall(scene, wallDist);
+
+  unsigned int channels = gpuRays->Channels();
+  std::vector<float> scan(hRayCount * channels);
+  gpuRays->Update();
+  gpuRays->Copy(scan.data());
+
+  double hStep = (hMaxAngle - hMinAngle) / (hRayCount - 1u);
+  for (unsigned int j = 0; j < hRayCount; j += 33u)
+  {
+    double expectedRange = wallDist / std::cos(hMinAngle + j * hStep);
+    EXPECT_NEAR(scan[j * channels], expectedRange, 1e-2) << "ray " << j;
+  }
+
+  // only ogre2 renders scans in time segments
+  if (_renderEngine != "ogre2")
+  {
+    engine->DestroyScene(scene);
+    rendering::unloadEngine(engine->Name());
+    return;
+  }
+
+  // the sensor moved 1m towards the wall during the scan
+  const unsigned int segmentCount = 4u;
+  math::Pose3d startPose(-1, 0, 0, 0, 0, 0);
+  gpuRays->SetScanSegmentCount(segmentCount);
+  gpuRays->SetScanStartPose(startPose);
+  EXPECT_EQ(segmentCount, gpuRays->ScanSegmentCount());
+  EXPECT_EQ(startPose, gpuRays->ScanStartPose());
+
+  gpuRays->Update();
+  gpuRays->Copy(scan.data());
+
+  // rays of each segment are cast from the sensor position in the middle
+  // of the segment
+  const unsigned int segmentSize = hRayCount / segmentCount;
+  for (unsigned int k = 0; k < segmentCount; ++k)
+  {
+    double t = (k * segmentSize + 0.5 * (segmentSize - 1u)) /
+        (hRayCount - 1u);
+    double x = startPose.Pos().X() * (1.0 - t);
+    for (unsigned int j = k * segmentSize; j < (k + 1u) * segmentSize;
+        j += segmentSize - 1u)
+    {
+      double expectedRange = (wallDist - x) / std::cos(hMinAngle + j * hStep);
+      EXPECT_NEAR(scan[j * channels], expectedRange, 1e-2)
+          << "segment " << k << " ray " << j;
+    }
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void GpuRaysTest::RayPattern(const std::string &_renderEngine)
+{
+#ifdef __APPLE__
+  ignerr << "Skipping test for apple, see issue #35." << std::endl;
+  return;
+#endif
+
+  // only ogre2 supports ray patterns
+  if (_renderEngine != "ogre2")
+  {
+    igndbg << "Ray patterns not supported yet in rendering engine: "
+            << _renderEngine << std::endl;
+    return;
+  }
+
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  VisualPtr root = scene->RootVisual();
+
+  GpuRaysPtr gpuRays = scene->CreateGpuRays("gpu_rays");
+  gpuRays->SetNearClipPlane(0.05);
+  gpuRays->SetFarClipPlane(40.0);
+  gpuRays->SetAngleMin(-1.0);
+  gpuRays->SetAngleMax(1.0);
+  gpuRays->SetRayCount(640);
+  gpuRays->SetVerticalRayCount(1);
+
+  // scattered rays, in 2 rows of 3 rays
+  const std::vector<math::Vector2d> rays = {
+      {0.0, 0.0}, {0.3, -0.1}, {-0.2, 0.25},
+      {0.05, 0.4}, {-0.45, -0.3}, {0.6, 0.1}};
+
+  // the number of rays must be a multiple of the width
+  EXPECT_FALSE(gpuRays->SetRayPattern(rays, 4u));
+  EXPECT_TRUE(gpuRays->RayPattern().empty());
+  EXPECT_EQ(640, gpuRays->RayCount());
+
+  EXPECT_TRUE(gpuRays->SetRayPattern(rays, 3u));
+  EXPECT_EQ(rays, gpuRays->RayPattern());
+  EXPECT_EQ(3, gpuRays->RayCount());
+  EXPECT_EQ(3, gpuRays->RangeCount());
+  EXPECT_EQ(2, gpuRays->VerticalRayCount());
+  EXPECT_EQ(2, gpuRays->VerticalRangeCount());
+  root->AddChild(gpuRays);
+
+  const double wallDist = 5.0;
+  this->CreateWall(scene, wallDist);
+
+  gpuRays->Update();
+
+  unsigned int channels = gpuRays->Channels();
+  std::vector<float> scan(rays.size() * channels);
+  gpuRays->Copy(scan.data());
+
+  // reading i is ray i of the pattern
+  for (unsigned int i = 0; i < rays.size(); ++i)
+  {
+    double expectedRange = wallDist /
+        (std::cos(rays[i].X()) * std::cos(rays[i].Y()));
+    EXPECT_NEAR(scan[i * channels], expectedRange, 1e-2) << "ray " << i;
+  }
+
+  // an empty pattern restores the grid of rays
+  EXPECT_TRUE(gpuRays->SetRayPattern({}));
+  EXPECT_EQ(640, gpuRays->RayCount());
+  EXPECT_EQ(1, gpuRays->VerticalRayCount());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void GpuRaysTest::PointCloud(const std::string &_renderEngine)
+{
+#ifdef __APPLE__
+  ignerr << "Skipping test for apple, see issue #35." << std::endl;
+  return;
+#endif
+
+  // only ogre2 computes point clouds
+  if (_renderEngine != "ogre2")
+  {
+    igndbg << "Point clouds not supported yet in rendering engine: "
+            << _renderEngine << std::endl;
+    return;
+  }
+
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  VisualPtr root = scene->RootVisual();
+
+  const double hMinAngle = -0.6;
+  const double hMaxAngle = 0.6;
+  const double vMinAngle = -0.3;
+  const double vMaxAngle = 0.3;
+  const unsigned int hRayCount = 60;
+  const unsigned int vRayCount = 7;
+
+  GpuRaysPtr gpuRays = scene->CreateGpuRays("gpu_rays");
+  gpuRays->SetNearClipPlane(0.05);
+  gpuRays->SetFarClipPlane(40.0);
+  gpuRays->SetAngleMin(hMinAngle);
+  gpuRays->SetAngleMax(hMaxAngle);
+  gpuRays->SetRayCount(hRayCount);
+  gpuRays->SetVerticalAngleMin(vMinAngle);
+  gpuRays->SetVerticalAngleMax(vMaxAngle);
+  gpuRays->SetVerticalRayCount(vRayCount);
+  root->AddChild(gpuRays);
+
+  const double wallDist = 5.0;
+  this->CreateWall(scene, wallDist);
+
+  // render once before subscribing to check that the sensor sets up the
+  // point cloud pass for a late subscriber
+  gpuRays->Update();
+
+  std::vector<float> points;
+  unsigned int cloudWidth = 0u;
+  unsigned int cloudHeight = 0u;
+  unsigned int cloudChannels = 0u;
+  std::string cloudFormat;
+  common::ConnectionPtr c = gpuRays->ConnectNewGpuRaysPointCloud(
+      [&](const float *_pointCloud, unsigned int _width,
+          unsigned int _height, unsigned int _channels,
+          const std::string &_format)
+      {
+        points.assign(_pointCloud,
+            _pointCloud + _width * _height * _channels);
+        cloudWidth = _width;
+        cloudHeight = _height;
+        cloudChannels = _channels;
+        cloudFormat = _format;
+      });
+  ASSERT_NE(nullptr, c);
+
+  gpuRays->Update();
+
+  EXPECT_EQ(hRayCount, cloudWidth);
+  EXPECT_EQ(vRayCount, cloudHeight);
+  EXPECT_EQ(4u, cloudChannels);
+  EXPECT_EQ("PF_FLOAT32_RGBA", cloudFormat);
+  ASSERT_EQ(hRayCount * vRayCount * 4u, points.size());
+
+  unsigned int channels = gpuRays->Channels();
+  std::vector<float> scan(hRayCount * vRayCount * channels);
+  gpuRays->Copy(scan.data());
+
+  // all points lie on the wall, in the direction of their ray
+  double hStep = (hMaxAngle - hMinAngle) / (hRayCount - 1);
+  double vStep = (vMaxAngle - vMinAngle) / (vRayCount - 1);
+  for (unsigned int j = 0; j < vRayCount; ++j)
+  {
+    for (unsigned int i = 0; i < hRayCount; ++i)
+    {
+      unsigned int idx = j * hRayCount + i;
+      double azimuth = hMinAngle + i * hStep;
+      double elevation = vMinAngle + j * vStep;
+      const float *point = &points[idx * 4u];
+      EXPECT_NEAR(wallDist, point[0], 1e-2) << "ray " << i << ", " << j;
+      EXPECT_NEAR(wallDist * std::tan(azimuth), point[1], 2e-2)
+          << "ray " << i << ", " << j;
+      EXPECT_NEAR(wallDist * std::tan(elevation) / std::cos(azimuth),
+          point[2], 2e-2) << "ray " << i << ", " << j;
+
+      // the point is at the range of the ray, with its retro value
+      math::Vector3d p(point[0], point[1], point[2]);
+      EXPECT_NEAR(scan[idx * channels], p.Length(), 1e-2);
+      EXPECT_FLOAT_EQ(scan[idx * channels + 1], point[3]);
+    }
+  }
+
+  // Clean up
+  c.reset();
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
 /////////////////////////////////////////////////
 TEST_P(GpuRaysTest, Configure)
 {
@@ -830,6 +1381,36 @@ TEST_P(GpuRaysTest, SingleRay)
   SingleRay(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(GpuRaysTest, RayGroup)
+{
+  RayGroup(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(GpuRaysTest, VerticalBeams)
+{
+  VerticalBeams(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(GpuRaysTest, ScanSegments)
+{
+  ScanSegments(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(GpuRaysTest, RayPattern)
+{
+  RayPattern(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(GpuRaysTest, PointCloud)
+{
+  PointCloud(GetParam());
+}
+
 
 INSTANTIATE_TEST_CASE_P(GpuRays, GpuRaysTest,
     RENDER_ENGINE_VALUES,
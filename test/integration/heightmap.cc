@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/ImageHeightmap.hh>
+#include <ignition/common/Util.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/Heightmap.hh"
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/PixelFormat.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+class HeightmapTest: public testing::Test,
+                     public testing::WithParamInterface<const char *>
+{
+  // Documentation inherited
+  public: void SetUp() override
+  {
+    ignition::common::Console::SetVerbosity(4);
+  }
+
+  // Test that terrain tiles are streamed in around the camera
+  public: void TerrainPaging(const std::string &_renderEngine);
+
+  // Test that resampled heights are cached on disk and reused
+  public: void TerrainCache(const std::string &_renderEngine);
+};
+
+/////////////////////////////////////////////////
+void HeightmapTest::TerrainPaging(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  if (_renderEngine != "ogre2")
+  {
+    igndbg << "Tiled terrain paging not supported yet in rendering engine: "
+            << _renderEngine << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+  scene->SetAmbientLight(0.3, 0.3, 0.3);
+  scene->SetBackgroundColor(1.0, 0.0, 0.0);
+
+  VisualPtr root = scene->RootVisual();
+
+  DirectionalLightPtr light = scene->CreateDirectionalLight();
+  light->SetDirection(0.0, 0.0, -1.0);
+  light->SetDiffuseColor(0.8, 0.8, 0.8);
+  root->AddChild(light);
+
+  // 17x17 image sampled 8 times, cropped to 128x128 samples and split in
+  // 4x4 tiles of 32x32 samples. Only 4 of them can be loaded at once
+  auto data = std::make_shared<common::ImageHeightmap>();
+  data->Load(common::joinPaths(std::string(PROJECT_SOURCE_PATH),
+      "test", "media", "heightmap_bowl.png"));
+
+  HeightmapDescriptor desc;
+  desc.SetData(data);
+  desc.SetSize({128, 128, 10});
+  desc.SetSampling(8u);
+  desc.SetUseTerrainPaging(true);
+  desc.SetTileSize(32u);
+  desc.SetMaxResidentTiles(4u);
+
+  HeightmapTexture texture;
+  texture.SetSize(1.0);
+  texture.SetDiffuse(common::joinPaths(std::string(PROJECT_SOURCE_PATH),
+      "test", "media", "materials", "textures", "texture.png"));
+  desc.AddTexture(texture);
+
+  auto heightmap = scene->CreateHeightmap(desc);
+  ASSERT_NE(nullptr, heightmap);
+
+  VisualPtr vis = scene->CreateVisual();
+  vis->AddGeometry(heightmap);
+  root->AddChild(vis);
+
+  // camera looking straight down at a corner of the terrain, far from the
+  // tile loaded at the center
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_TRUE(camera != nullptr);
+  camera->SetImageWidth(50);
+  camera->SetImageHeight(50);
+  camera->SetLocalPosition(-56.0, -56.0, 30.0);
+  camera->SetLocalRotation(math::Quaterniond(0, IGN_PI/2.0, 0));
+  root->AddChild(camera);
+
+  auto centerIsTerrain = [&camera]()
+  {
+    Image image = camera->CreateImage();
+    // give tiles a few frames to stream in
+    for (unsigned int i = 0u; i < 3u; ++i)
+      camera->Capture(image);
+
+    unsigned char *data = image.Data<unsigned char>();
+    unsigned int channelCount =
+        PixelUtil::ChannelCount(camera->ImageFormat());
+    unsigned int idx = (camera->ImageHeight() / 2u * camera->ImageWidth() +
+        camera->ImageWidth() / 2u) * channelCount;
+    return !(data[idx] == 255u && data[idx + 1] == 0u && data[idx + 2] == 0u);
+  };
+
+  EXPECT_TRUE(centerIsTerrain());
+
+  // move to the opposite corner, the tiles there replace the old ones
+  camera->SetLocalPosition(56.0, 56.0, 30.0);
+  EXPECT_TRUE(centerIsTerrain());
+
+  // and back again
+  camera->SetLocalPosition(-56.0, -56.0, 30.0);
+  EXPECT_TRUE(centerIsTerrain());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void HeightmapTest::TerrainCache(const std::string &_renderEngine)
+{
+  if (_renderEngine != "ogre2")
+  {
+    igndbg << "Heightmap cache not supported yet in rendering engine: "
+            << _renderEngine << std::endl;
+    return;
+  }
+
+  // keep the cache out of the user's home directory
+  std::string home;
+  common::env(IGN_HOMEDIR, home);
+  const std::string testHome = common::joinPaths(
+      std::string(PROJECT_BUILD_PATH), "test", "heightmap_cache_home");
+  common::removeAll(testHome);
+  common::createDirectories(testHome);
+  common::setenv(IGN_HOMEDIR, testHome);
+  const std::string cacheDir = common::joinPaths(testHome, ".ignition",
+      "rendering", "ogre2-terrain-cache");
+
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    common::setenv(IGN_HOMEDIR, home);
+    return;
+  }
+
+  auto data = std::make_shared<common::ImageHeightmap>();
+  data->Load(common::joinPaths(std::string(PROJECT_SOURCE_PATH),
+      "test", "media", "heightmap_bowl.png"));
+
+  HeightmapDescriptor desc;
+  desc.SetData(data);
+  desc.SetSize({17, 17, 10});
+  desc.SetSampling(4u);
+
+  // render the heightmap from above and return the center pixel
+  auto renderCenter = [&](const std::string &_sceneName)
+  {
+    ScenePtr scene = engine->CreateScene(_sceneName);
+    scene->SetBackgroundColor(1.0, 0.0, 0.0);
+    scene->SetAmbientLight(0.3, 0.3, 0.3);
+    VisualPtr root = scene->RootVisual();
+
+    auto heightmap = scene->CreateHeightmap(desc);
+    VisualPtr vis = scene->CreateVisual();
+    vis->AddGeometry(heightmap);
+    root->AddChild(vis);
+
+    CameraPtr camera = scene->CreateCamera();
+    camera->SetImageWidth(50);
+    camera->SetImageHeight(50);
+    camera->SetLocalPosition(0.0, 0.0, 20.0);
+    camera->SetLocalRotation(math::Quaterniond(0, IGN_PI/2.0, 0));
+    root->AddChild(camera);
+
+    Image image = camera->CreateImage();
+    camera->Capture(image);
+    unsigned char *pixels = image.Data<unsigned char>();
+    unsigned int channelCount =
+        PixelUtil::ChannelCount(camera->ImageFormat());
+    unsigned int idx = (camera->ImageHeight() / 2u * camera->ImageWidth() +
+        camera->ImageWidth() / 2u) * channelCount;
+    math::Color color(pixels[idx] / 255.0f, pixels[idx + 1] / 255.0f,
+        pixels[idx + 2] / 255.0f);
+    engine->DestroyScene(scene);
+    return color;
+  };
+
+  // first load samples the heights and writes the cache
+  math::Color sampled = renderCenter("scene");
+  ASSERT_TRUE(common::isDirectory(cacheDir));
+  unsigned int cacheFiles = 0u;
+  for (common::DirIter file(cacheDir); file != common::DirIter(); ++file)
+    ++cacheFiles;
+  EXPECT_EQ(1u, cacheFiles);
+
+  // second load maps the cache and renders the same terrain
+  math::Color cached = renderCenter("scene2");
+  EXPECT_EQ(sampled, cached);
+  EXPECT_NE(math::Color::Red, cached);
+
+  // Clean up
+  rendering::unloadEngine(engine->Name());
+  common::removeAll(testHome);
+  common::setenv(IGN_HOMEDIR, home);
+}
+
+/////////////////////////////////////////////////
+TEST_P(HeightmapTest, TerrainPaging)
+{
+  TerrainPaging(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(HeightmapTest, TerrainCache)
+{
+  TerrainCache(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(Heightmap, HeightmapTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
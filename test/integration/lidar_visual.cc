@@ -321,6 +321,15 @@ void LidarVisualTest::RaysUnitBox(const std::string &_renderEngine)
   EXPECT_NEAR(pts_back[0], expectedRangeAtMidPointBox2, LASER_TOL);
   EXPECT_FLOAT_EQ(pts_back[last], ignition::math::INF_F);
 
+  // set the ranges directly from the gpu rays data and draw them as points
+  lidarVis->SetType(LidarVisualType::LVT_POINTS);
+  lidarVis->SetRanges(scan, channels);
+  lidarVis->Update();
+  std::vector<double> ranges_back = lidarVis->Points();
+  ASSERT_EQ(pts_back.size(), ranges_back.size());
+  for (unsigned int i = 0; i < pts_back.size(); ++i)
+    EXPECT_DOUBLE_EQ(pts_back[i], ranges_back[i]);
+
   // Verify rays caster 2 range readings
   // listen to new gpu rays frames
   float *scan2 = new float[hRayCount * vRayCount * 3];
@@ -17,6 +17,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Image.hh>
 
@@ -26,6 +29,7 @@
 #include "ignition/rendering/DepthCamera.hh"
 #include "ignition/rendering/DistortionPass.hh"
 #include "ignition/rendering/GaussianNoisePass.hh"
+#include "ignition/rendering/GpuRays.hh"
 #include "ignition/rendering/Image.hh"
 #include "ignition/rendering/PixelFormat.hh"
 #include "ignition/rendering/RenderEngine.hh"
@@ -58,6 +62,9 @@ class RenderPassTest: public testing::Test,
   // Test and verify Gaussian noise pass is applied to a depth camera
   public: void DepthGaussianNoise(const std::string &_renderEngine);
 
+  // Test and verify Gaussian noise pass is applied to gpu rays
+  public: void GpuRaysGaussianNoise(const std::string &_renderEngine);
+
   // Test and verify Distortion pass is applied to a camera
   public: void Distortion(const std::string &_renderEngine);
 };
@@ -173,6 +180,32 @@ void RenderPassTest::GaussianNoise(const std::string &_renderEngine)
   // We expect that the average difference will be well within 3-sigma.
   EXPECT_NEAR(diffAvg/255., noiseMean, 3*noiseStdDev);
 
+  // add a second noise pass, which adds more noise. Consecutive noise passes
+  // may be fused into a single compositor pass by the render engine.
+  RenderPassPtr pass2 = rpSystem->Create<GaussianNoisePass>();
+  GaussianNoisePassPtr noisePass2 =
+      std::dynamic_pointer_cast<GaussianNoisePass>(pass2);
+  noisePass2->SetMean(noiseMean);
+  noisePass2->SetStdDev(noiseStdDev);
+  camera->AddRenderPass(noisePass2);
+  EXPECT_EQ(2u, camera->RenderPassCount());
+
+  Image imageNoise2 = camera->CreateImage();
+  camera->Capture(imageNoise2);
+  unsigned char *dataNoise2 = imageNoise2.Data<unsigned char>();
+  unsigned int diffSum2 = 0;
+  for (unsigned int i = 0; i < height * step; ++i)
+    diffSum2 += std::abs(static_cast<int>(data[i]) - dataNoise2[i]);
+  EXPECT_GT(diffSum2, diffSum);
+
+  // disabling the second pass removes its noise again
+  noisePass2->SetEnabled(false);
+  camera->Capture(imageNoise2);
+  unsigned int diffSum3 = 0;
+  for (unsigned int i = 0; i < height * step; ++i)
+    diffSum3 += std::abs(static_cast<int>(data[i]) - dataNoise2[i]);
+  EXPECT_LT(diffSum3, diffSum2);
+
   // Clean up
   engine->DestroyScene(scene);
   rendering::unloadEngine(engine->Name());
@@ -403,10 +436,22 @@ void RenderPassTest::DepthGaussianNoise(const std::string &_renderEngine)
   ignition::rendering::unloadEngine(engine->Name());
 }
 
-void RenderPassTest::Distortion(const std::string &_renderEngine)
+/////////////////////////////////////////////////
+void RenderPassTest::GpuRaysGaussianNoise(const std::string &_renderEngine)
 {
-  // create and populate scene
-  RenderEngine *engine = rendering::engine(_renderEngine);
+#ifdef __APPLE__
+  ignerr << "Skipping test for apple, see issue #35." << std::endl;
+  return;
+#endif
+
+  if (_renderEngine != "ogre2")
+  {
+    igndbg << "Engine '" << _renderEngine
+           << "' doesn't support render pass for gpu rays " << std::endl;
+    return;
+  }
+
+  auto *engine = ignition::rendering::engine(_renderEngine);
   if (!engine)
   {
     igndbg << "Engine '" << _renderEngine
@@ -414,11 +459,89 @@ void RenderPassTest::Distortion(const std::string &_renderEngine)
     return;
   }
 
-  if (_renderEngine == "ogre2")
+  ScenePtr scene = engine->CreateScene("scene");
+  VisualPtr root = scene->RootVisual();
+
+  // wall facing the rays at a distance of 5m
+  const double wallDist = 5.0;
+  VisualPtr wall = scene->CreateVisual("wall");
+  wall->AddGeometry(scene->CreateBox());
+  wall->SetLocalScale(0.2, 40, 40);
+  wall->SetWorldPosition(wallDist + 0.1, 0, 0);
+  root->AddChild(wall);
+
+  const unsigned int rayCount = 400u;
+  GpuRaysPtr gpuRays = scene->CreateGpuRays("gpu_rays");
+  gpuRays->SetNearClipPlane(0.05);
+  gpuRays->SetFarClipPlane(40.0);
+  gpuRays->SetAngleMin(-0.5);
+  gpuRays->SetAngleMax(0.5);
+  gpuRays->SetRayCount(rayCount);
+  gpuRays->SetVerticalRayCount(1);
+  root->AddChild(gpuRays);
+
+  gpuRays->Update();
+  unsigned int channels = gpuRays->Channels();
+  std::vector<float> scan(rayCount * channels);
+  gpuRays->Copy(scan.data());
+
+  // add Gaussian noise
+  double noiseMean = 0.1;
+  double noiseStdDev = 0.01;
+  RenderPassSystemPtr rpSystem = engine->RenderPassSystem();
+  ASSERT_NE(nullptr, rpSystem);
+  RenderPassPtr pass = rpSystem->Create<GaussianNoisePass>();
+  GaussianNoisePassPtr noisePass =
+      std::dynamic_pointer_cast<GaussianNoisePass>(pass);
+  noisePass->SetMean(noiseMean);
+  noisePass->SetStdDev(noiseStdDev);
+  gpuRays->AddRenderPass(noisePass);
+
+  gpuRays->Update();
+  std::vector<float> noisyScan(rayCount * channels);
+  gpuRays->Copy(noisyScan.data());
+
+  // noise is sampled on the GPU for each ray
+  double errorSum = 0.0;
+  unsigned int changed = 0u;
+  for (unsigned int i = 0; i < rayCount; ++i)
   {
-    igndbg << "Distortion is currently not supported in OGRE2" << std::endl;
-    return;
+    double error = noisyScan[i * channels] - scan[i * channels];
+    EXPECT_NEAR(noiseMean, error, noiseStdDev * 6.0) << "ray " << i;
+    errorSum += error;
+    if (std::abs(error - noiseMean) > 1e-4)
+      ++changed;
+  }
+  EXPECT_NEAR(noiseMean, errorSum / rayCount, noiseStdDev);
+  EXPECT_GT(changed, rayCount / 2u);
+
+  // noise is sampled again for each frame
+  gpuRays->Update();
+  std::vector<float> noisyScan2(rayCount * channels);
+  gpuRays->Copy(noisyScan2.data());
+  EXPECT_NE(noisyScan, noisyScan2);
+
+  // disabled passes do not add noise
+  noisePass->SetEnabled(false);
+  gpuRays->Update();
+  gpuRays->Copy(noisyScan.data());
+  for (unsigned int i = 0; i < rayCount; ++i)
+    EXPECT_FLOAT_EQ(scan[i * channels], noisyScan[i * channels]);
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
 
+void RenderPassTest::Distortion(const std::string &_renderEngine)
+{
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
   }
 
   // add resources in build dir
@@ -557,6 +680,12 @@ TEST_P(RenderPassTest, DepthGaussianNoise)
   DepthGaussianNoise(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(RenderPassTest, GpuRaysGaussianNoise)
+{
+  GpuRaysGaussianNoise(GetParam());
+}
+
 /////////////////////////////////////////////////
 TEST_P(RenderPassTest, Distortion)
 {
@@ -17,14 +17,31 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/MeshManager.hh>
 
 #include "test_config.h"  // NOLINT(build/include)
 
 #include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/DepthCamera.hh"
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/InstancedVisual.hh"
+#include "ignition/rendering/Material.hh"
+#include "ignition/rendering/Mesh.hh"
+#include "ignition/rendering/MeshDescriptor.hh"
 #include "ignition/rendering/RenderEngine.hh"
 #include "ignition/rendering/RenderingIface.hh"
 #include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/SensorScheduler.hh"
+#include "ignition/rendering/Visual.hh"
 
 using namespace ignition;
 using namespace rendering;
@@ -45,6 +62,47 @@ class SceneTest: public testing::Test,
 
   // Test and verify camera tracking
   public: void VisualAt(const std::string &_renderEngine);
+
+  // Test rendering a batch of sensors
+  public: void RenderSensors(const std::string &_renderEngine);
+
+  // Test GPU timings of sensors and scenes
+  public: void GpuStats(const std::string &_renderEngine);
+
+  // Test draw counts of sensors
+  public: void DrawStats(const std::string &_renderEngine);
+
+  // Test draw counts of instanced visuals
+  public: void InstancedDrawStats(const std::string &_renderEngine);
+
+  // Test memory accounting of scenes and engines
+  public: void MemoryStats(const std::string &_renderEngine);
+
+  // Test commands queued from other threads
+  public: void QueueCommand(const std::string &_renderEngine);
+
+  // Test preparing meshes from loader threads
+  public: void PrepareMesh(const std::string &_renderEngine);
+
+  // Test occlusion culling of sensors
+  public: void OcclusionCulling(const std::string &_renderEngine);
+
+  // Test warming up the shaders of a scene
+  public: void WarmUp(const std::string &_renderEngine);
+
+  // Test rendering sensors at their update rates
+  public: void Scheduler(const std::string &_renderEngine);
+
+  // Test resetting a scene and building it again
+  public: void Reset(const std::string &_renderEngine);
+
+  // Test region and nearest neighbor queries of visuals
+  public: void SpatialQueries(const std::string &_renderEngine);
+
+  // Path to test media directory
+  public: const std::string TEST_MEDIA_PATH =
+          common::joinPaths(std::string(PROJECT_SOURCE_PATH),
+                "test", "media");
 };
 
 /////////////////////////////////////////////////
@@ -226,6 +284,881 @@ void SceneTest::VisualAt(const std::string &_renderEngine)
   rendering::unloadEngine(engine->Name());
 }
 
+/////////////////////////////////////////////////
+void SceneTest::RenderSensors(const std::string &_renderEngine)
+{
+  // create and populate scene
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+  scene->SetBackgroundColor(0.2, 0.2, 0.2);
+
+  VisualPtr root = scene->RootVisual();
+
+  // create box visual
+  VisualPtr box = scene->CreateVisual("box");
+  ASSERT_TRUE(box != nullptr);
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(3, 0, 0);
+  box->SetMaterial(scene->Material("Default/TransRed"));
+  root->AddChild(box);
+
+  // create two cameras with the same pose
+  std::vector<SensorPtr> sensors;
+  std::vector<CameraPtr> cameras;
+  for (unsigned int i = 0u; i < 2u; ++i)
+  {
+    CameraPtr camera = scene->CreateCamera("camera" + std::to_string(i));
+    ASSERT_TRUE(camera != nullptr);
+    camera->SetImageWidth(320);
+    camera->SetImageHeight(240);
+    camera->SetHFOV(IGN_PI / 2);
+    root->AddChild(camera);
+    cameras.push_back(camera);
+    sensors.push_back(camera);
+  }
+
+  // non-camera sensors and empty batches are ignored
+  scene->RenderSensors({});
+  sensors.push_back(nullptr);
+
+  for (unsigned int passCount : {0u, 6u})
+  {
+    scene->SetCameraPassCountPerGpuFlush(static_cast<uint8_t>(passCount));
+
+    // render the batch and verify both cameras produce the same image
+    scene->RenderSensors(sensors);
+
+    Image image0 = cameras[0]->CreateImage();
+    Image image1 = cameras[1]->CreateImage();
+    cameras[0]->Copy(image0);
+    cameras[1]->Copy(image1);
+    ASSERT_EQ(image0.MemorySize(), image1.MemorySize());
+    EXPECT_EQ(0, memcmp(image0.Data(), image1.Data(), image0.MemorySize()));
+
+    // the result must match a regular camera update
+    Image image2 = cameras[0]->CreateImage();
+    cameras[0]->Capture(image2);
+    EXPECT_EQ(0, memcmp(image0.Data(), image2.Data(), image0.MemorySize()));
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::GpuStats(const std::string &_renderEngine)
+{
+  // only ogre2 measures gpu timings, and only when asked to
+  std::map<std::string, std::string> params;
+  params["gpuTiming"] = "1";
+  RenderEngine *engine = rendering::engine(_renderEngine, params);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+  EXPECT_EQ(0u, scene->GpuStats().frameCount);
+
+  VisualPtr root = scene->RootVisual();
+  VisualPtr box = scene->CreateVisual("box");
+  ASSERT_TRUE(box != nullptr);
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(3, 0, 0);
+  root->AddChild(box);
+
+  CameraPtr camera = scene->CreateCamera("camera");
+  ASSERT_TRUE(camera != nullptr);
+  camera->SetImageWidth(320);
+  camera->SetImageHeight(240);
+  root->AddChild(camera);
+  EXPECT_EQ(0u, camera->GpuStats().frameCount);
+
+  // render a frame, its results arrive a few frames late
+  camera->Update();
+  for (unsigned int i = 0u; i < 30u && camera->GpuStats().frameCount == 0u;
+      ++i)
+  {
+    camera->Update();
+  }
+
+  RenderStats stats = camera->GpuStats();
+  if (_renderEngine != "ogre2")
+  {
+    igndbg << "GPU timing is not available in " << _renderEngine
+           << std::endl;
+    EXPECT_EQ(0u, stats.frameCount);
+    EXPECT_TRUE(stats.passes.empty());
+  }
+  else
+  {
+    ASSERT_GT(stats.frameCount, 0u);
+    EXPECT_FALSE(stats.passes.empty());
+    EXPECT_GE(stats.lastMs, 0.0);
+    double sum = 0.0;
+    for (const auto &pass : stats.passes)
+    {
+      EXPECT_FALSE(pass.name.empty());
+      EXPECT_GE(pass.lastMs, 0.0);
+      sum += pass.lastMs;
+    }
+    EXPECT_NEAR(stats.lastMs, sum, 1e-6);
+
+    // the scene sums up its sensors
+    RenderStats sceneStats = scene->GpuStats();
+    EXPECT_EQ(stats.frameCount, sceneStats.frameCount);
+    EXPECT_DOUBLE_EQ(stats.lastMs, sceneStats.lastMs);
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::DrawStats(const std::string &_renderEngine)
+{
+  // ogre2 only counts draws when asked to
+  std::map<std::string, std::string> params;
+  params["drawStats"] = "1";
+  RenderEngine *engine = rendering::engine(_renderEngine, params);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  VisualPtr root = scene->RootVisual();
+  VisualPtr box = scene->CreateVisual("box");
+  ASSERT_TRUE(box != nullptr);
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(3, 0, 0);
+  root->AddChild(box);
+
+  CameraPtr camera = scene->CreateCamera("camera");
+  ASSERT_TRUE(camera != nullptr);
+  camera->SetImageWidth(320);
+  camera->SetImageHeight(240);
+  root->AddChild(camera);
+  EXPECT_EQ(0u, camera->DrawStats().frameCount);
+
+  camera->Update();
+  rendering::DrawStats stats = camera->DrawStats();
+  if (_renderEngine != "ogre" && _renderEngine != "ogre2")
+  {
+    EXPECT_EQ(0u, stats.frameCount);
+  }
+  else
+  {
+    EXPECT_EQ(1u, stats.frameCount);
+    EXPECT_GT(stats.passCount, 0u);
+    EXPECT_GT(stats.drawCallCount, 0u);
+    // the box is in view
+    EXPECT_GE(stats.triangleCount, 2u);
+
+    // the counts are per frame, not accumulated
+    camera->Update();
+    rendering::DrawStats next = camera->DrawStats();
+    EXPECT_EQ(2u, next.frameCount);
+    EXPECT_EQ(stats.passCount, next.passCount);
+    EXPECT_EQ(stats.triangleCount, next.triangleCount);
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::InstancedDrawStats(const std::string &_renderEngine)
+{
+  // only ogre2 draws instances of different colors in the same batch
+  if (_renderEngine != "ogre2")
+  {
+    igndbg << "Instanced draw counts not supported yet in rendering engine: "
+            << _renderEngine << std::endl;
+    return;
+  }
+
+  std::map<std::string, std::string> params;
+  params["drawStats"] = "1";
+  RenderEngine *engine = rendering::engine(_renderEngine, params);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+  VisualPtr root = scene->RootVisual();
+
+  MaterialPtr material = scene->CreateMaterial();
+  ASSERT_NE(nullptr, material);
+  material->SetDiffuse(math::Color::Red);
+
+  InstancedVisualPtr single = scene->CreateInstancedVisual(
+      MeshDescriptor("unit_box"), material, 1u);
+  ASSERT_NE(nullptr, single);
+  single->SetLocalPosition(6.0, 0.0, 0.0);
+  root->AddChild(single);
+
+  CameraPtr camera = scene->CreateCamera("camera");
+  ASSERT_TRUE(camera != nullptr);
+  camera->SetImageWidth(320);
+  camera->SetImageHeight(240);
+  root->AddChild(camera);
+
+  camera->Update();
+  rendering::DrawStats singleStats = camera->DrawStats();
+  EXPECT_GT(singleStats.drawCallCount, 0u);
+  EXPECT_GE(singleStats.instanceCount, 1u);
+
+  // a grid of instances of two colors, all in view
+  const unsigned int count = 64u;
+  InstancedVisualPtr grid = scene->CreateInstancedVisual(
+      MeshDescriptor("unit_box"), material, count);
+  ASSERT_NE(nullptr, grid);
+  grid->SetLocalPosition(6.0, 0.0, 0.0);
+  root->AddChild(grid);
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    grid->SetInstancePose(i, math::Pose3d(0.0, (i % 8u) * 0.5 - 1.75,
+        (i / 8u) * 0.5 - 1.75, 0.0, 0.0, 0.0));
+    grid->SetInstanceScale(i, math::Vector3d(0.4, 0.4, 0.4));
+    grid->SetInstanceColor(i,
+        (i % 2u) ? math::Color::Green : math::Color::Blue);
+  }
+  single->SetVisible(false);
+
+  // the instances share the datablock of the visual whatever their color,
+  // so they take as many draws and batches as a single instance
+  camera->Update();
+  rendering::DrawStats gridStats = camera->DrawStats();
+  EXPECT_EQ(singleStats.drawCallCount, gridStats.drawCallCount);
+  EXPECT_EQ(singleStats.batchCount, gridStats.batchCount);
+  EXPECT_GE(gridStats.instanceCount, singleStats.instanceCount + count - 1u);
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::MemoryStats(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  VisualPtr root = scene->RootVisual();
+  VisualPtr box = scene->CreateVisual("box");
+  ASSERT_TRUE(box != nullptr);
+  box->AddGeometry(scene->CreateBox());
+  root->AddChild(box);
+
+  CameraPtr camera = scene->CreateCamera("camera");
+  ASSERT_TRUE(camera != nullptr);
+  camera->SetImageWidth(320);
+  camera->SetImageHeight(240);
+  root->AddChild(camera);
+  camera->Update();
+
+  rendering::MemoryStats sceneStats = scene->MemoryStats();
+  rendering::MemoryStats engineStats = engine->MemoryStats();
+  EXPECT_EQ(sceneStats.textureBytes + sceneStats.renderTargetBytes +
+      sceneStats.shadowMapBytes + sceneStats.vertexBufferBytes +
+      sceneStats.indexBufferBytes + sceneStats.stagingBufferBytes,
+      sceneStats.TotalBytes());
+
+  if (_renderEngine == "ogre" || _renderEngine == "ogre2")
+  {
+    EXPECT_LT(0u, sceneStats.meshCount);
+    EXPECT_LT(0u, sceneStats.vertexBufferBytes);
+    EXPECT_LT(0u, sceneStats.indexBufferBytes);
+
+    // the camera render target is only known to the engine
+    EXPECT_LT(0u, engineStats.renderTargetBytes);
+    EXPECT_GE(engineStats.meshCount, sceneStats.meshCount);
+    EXPECT_GE(engineStats.vertexBufferBytes, sceneStats.vertexBufferBytes);
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::QueueCommand(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  VisualPtr box = scene->CreateVisual("box");
+  ASSERT_TRUE(box != nullptr);
+  scene->RootVisual()->AddChild(box);
+
+  // commands of each thread run in the order they were queued
+  const unsigned int threadCount = 4u;
+  const unsigned int commandCount = 1000u;
+  std::vector<std::vector<unsigned int>> results(threadCount);
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0u; t < threadCount; ++t)
+  {
+    threads.emplace_back([&, t]()
+    {
+      for (unsigned int i = 0u; i < commandCount; ++i)
+        scene->QueueCommand([&results, t, i]() {results[t].push_back(i);});
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  // nothing runs until the render thread processes the queue
+  for (const auto &result : results)
+    EXPECT_TRUE(result.empty());
+
+  scene->PreRender();
+  for (const auto &result : results)
+  {
+    ASSERT_EQ(commandCount, result.size());
+    for (unsigned int i = 0u; i < commandCount; ++i)
+      EXPECT_EQ(i, result[i]);
+  }
+  EXPECT_EQ(0u, scene->ProcessCommands());
+
+  // commands update the scene on the render thread
+  std::thread producer([&]()
+  {
+    scene->QueueCommand([box]()
+    {
+      box->SetLocalPosition(1.0, 2.0, 3.0);
+    });
+  });
+  producer.join();
+  EXPECT_EQ(math::Vector3d::Zero, box->LocalPosition());
+  EXPECT_EQ(1u, scene->ProcessCommands());
+  EXPECT_EQ(math::Vector3d(1.0, 2.0, 3.0), box->LocalPosition());
+
+  // commands queued by a command run on the next call
+  bool nested = false;
+  scene->QueueCommand([&]()
+  {
+    scene->QueueCommand([&nested]() {nested = true;});
+  });
+  EXPECT_EQ(1u, scene->ProcessCommands());
+  EXPECT_FALSE(nested);
+  EXPECT_EQ(1u, scene->ProcessCommands());
+  EXPECT_TRUE(nested);
+
+  // pending commands are discarded with the scene
+  bool discarded = true;
+  scene->QueueCommand([&discarded]() {discarded = false;});
+
+  // Clean up
+  engine->DestroyScene(scene);
+  EXPECT_TRUE(discarded);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::PrepareMesh(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  // loader threads prepare the same meshes and queue the creation of
+  // visuals using them
+  const unsigned int threadCount = 4u;
+  const std::vector<std::string> meshes =
+      {"unit_box", "unit_sphere", "unit_cylinder"};
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0u; t < threadCount; ++t)
+  {
+    threads.emplace_back([&, t]()
+    {
+      for (const auto &name : meshes)
+      {
+        scene->PrepareMesh(MeshDescriptor(name));
+        scene->QueueCommand([scene, name, t]()
+        {
+          VisualPtr visual = scene->CreateVisual(
+              name + "_" + std::to_string(t));
+          visual->AddGeometry(scene->CreateMesh(name));
+          scene->RootVisual()->AddChild(visual);
+        });
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  EXPECT_EQ(0u, scene->VisualCount());
+  scene->PreRender();
+  scene->PostRender();
+  ASSERT_EQ(threadCount * meshes.size(), scene->VisualCount());
+  for (unsigned int i = 0u; i < scene->VisualCount(); ++i)
+  {
+    VisualPtr visual = scene->VisualByIndex(i);
+    ASSERT_EQ(1u, visual->GeometryCount());
+    EXPECT_NE(nullptr,
+        std::dynamic_pointer_cast<Mesh>(visual->GeometryByIndex(0u)));
+  }
+
+  // a mesh file is read by the loader thread, the render thread finds it
+  // in the mesh manager
+  const std::string meshFile =
+      common::joinPaths(TEST_MEDIA_PATH, "meshes", "walk.dae");
+  EXPECT_FALSE(common::MeshManager::Instance()->HasMesh(meshFile));
+  std::thread loader([&]()
+  {
+    scene->PrepareMesh(MeshDescriptor(meshFile));
+  });
+  loader.join();
+  EXPECT_TRUE(common::MeshManager::Instance()->HasMesh(meshFile));
+
+  MeshPtr fileMesh = scene->CreateMesh(meshFile);
+  ASSERT_NE(nullptr, fileMesh);
+  EXPECT_LT(0u, fileMesh->SubMeshCount());
+
+  // invalid meshes are ignored
+  scene->PrepareMesh(MeshDescriptor());
+  scene->PrepareMesh(MeshDescriptor("no_such_mesh"));
+  EXPECT_EQ(0u, scene->ProcessCommands());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::OcclusionCulling(const std::string &_renderEngine)
+{
+  // only ogre2 culls occluded objects, and only when asked to
+  std::map<std::string, std::string> params;
+  params["occlusionCulling"] = "1";
+  params["drawStats"] = "1";
+  RenderEngine *engine = rendering::engine(_renderEngine, params);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+  scene->SetAmbientLight(1.0, 1.0, 1.0);
+  VisualPtr root = scene->RootVisual();
+
+  // a wall in front of the camera, a box behind it and a box next to it
+  VisualPtr wall = scene->CreateVisual("wall");
+  ASSERT_TRUE(wall != nullptr);
+  wall->AddGeometry(scene->CreateBox());
+  wall->SetLocalPosition(3.0, 1.0, 0.0);
+  wall->SetLocalScale(0.2, 2.0, 2.0);
+  root->AddChild(wall);
+
+  VisualPtr hidden = scene->CreateVisual("hidden");
+  ASSERT_TRUE(hidden != nullptr);
+  hidden->AddGeometry(scene->CreateBox());
+  hidden->SetLocalPosition(6.0, 1.0, 0.0);
+  root->AddChild(hidden);
+
+  VisualPtr visible = scene->CreateVisual("visible");
+  ASSERT_TRUE(visible != nullptr);
+  visible->AddGeometry(scene->CreateBox());
+  visible->SetLocalPosition(3.0, -1.5, 0.0);
+  root->AddChild(visible);
+
+  // passes with shadows only cull items that do not cast shadows
+  MaterialPtr material = scene->CreateMaterial();
+  ASSERT_NE(nullptr, material);
+  material->SetCastShadows(false);
+  hidden->SetMaterial(material);
+  visible->SetMaterial(material);
+
+  CameraPtr camera = scene->CreateCamera("camera");
+  ASSERT_TRUE(camera != nullptr);
+  camera->SetImageWidth(320);
+  camera->SetImageHeight(240);
+  root->AddChild(camera);
+
+  Image image = camera->CreateImage();
+  camera->Capture(image);
+  rendering::DrawStats stats = camera->DrawStats();
+
+  // removing the occluded box must not change the image
+  hidden->SetVisible(false);
+  Image withoutHidden = camera->CreateImage();
+  camera->Capture(withoutHidden);
+  rendering::DrawStats withoutHiddenStats = camera->DrawStats();
+  ASSERT_EQ(image.MemorySize(), withoutHidden.MemorySize());
+  EXPECT_EQ(0, memcmp(image.Data(), withoutHidden.Data(),
+      image.MemorySize()));
+
+  // while the box next to the wall must still be drawn
+  visible->SetVisible(false);
+  Image withoutVisible = camera->CreateImage();
+  camera->Capture(withoutVisible);
+  rendering::DrawStats withoutVisibleStats = camera->DrawStats();
+  EXPECT_NE(0, memcmp(image.Data(), withoutVisible.Data(),
+      image.MemorySize()));
+
+  if (_renderEngine == "ogre2")
+  {
+    // the occluded box was culled, so it drew nothing before it was
+    // removed
+    EXPECT_GT(stats.frameCount, 0u);
+    EXPECT_EQ(withoutHiddenStats.drawCallCount, stats.drawCallCount);
+    EXPECT_EQ(withoutHiddenStats.triangleCount, stats.triangleCount);
+
+    // the box next to the wall was not culled
+    EXPECT_LT(withoutVisibleStats.triangleCount,
+        withoutHiddenStats.triangleCount);
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::WarmUp(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+  VisualPtr root = scene->RootVisual();
+
+  // warming up an empty scene does nothing
+  scene->WarmUp();
+
+  VisualPtr box = scene->CreateVisual("box");
+  ASSERT_TRUE(box != nullptr);
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(3, 0, 0);
+  box->SetMaterial(scene->Material("Default/TransRed"));
+  root->AddChild(box);
+
+  CameraPtr camera = scene->CreateCamera("camera");
+  ASSERT_TRUE(camera != nullptr);
+  camera->SetImageWidth(320);
+  camera->SetImageHeight(240);
+  root->AddChild(camera);
+
+  DepthCameraPtr depthCamera = scene->CreateDepthCamera("depth_camera");
+  ASSERT_TRUE(depthCamera != nullptr);
+  depthCamera->SetImageWidth(320);
+  depthCamera->SetImageHeight(240);
+  depthCamera->CreateDepthTexture();
+  root->AddChild(depthCamera);
+
+  scene->WarmUp();
+
+  // the warmed up sensors and selection buffer keep working
+  Image image = camera->CreateImage();
+  camera->Capture(image);
+  depthCamera->Update();
+  EXPECT_EQ(box, camera->VisualAt(math::Vector2i(160, 120)));
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::Scheduler(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+  VisualPtr root = scene->RootVisual();
+
+  SensorSchedulerPtr scheduler = scene->Scheduler();
+  ASSERT_NE(nullptr, scheduler);
+  EXPECT_EQ(scheduler, scene->Scheduler());
+  EXPECT_EQ(0u, scheduler->SensorCount());
+  EXPECT_EQ(std::chrono::steady_clock::duration::max(),
+      scheduler->NextUpdateTime());
+
+  CameraPtr fastCamera = scene->CreateCamera("fast_camera");
+  ASSERT_TRUE(fastCamera != nullptr);
+  fastCamera->SetImageWidth(80);
+  fastCamera->SetImageHeight(60);
+  root->AddChild(fastCamera);
+
+  DepthCameraPtr slowCamera = scene->CreateDepthCamera("slow_camera");
+  ASSERT_TRUE(slowCamera != nullptr);
+  slowCamera->SetImageWidth(80);
+  slowCamera->SetImageHeight(60);
+  slowCamera->CreateDepthTexture();
+  root->AddChild(slowCamera);
+
+  // the frames rendered are delivered to the sensor callbacks
+  unsigned int slowFrames = 0u;
+  common::ConnectionPtr slowConnection = slowCamera->ConnectNewDepthFrame(
+      [&slowFrames](const float *, unsigned int, unsigned int, unsigned int,
+          const std::string &) {++slowFrames;});
+
+  // invalid sensors and rates are rejected
+  EXPECT_FALSE(scheduler->AddSensor(nullptr, 10.0));
+  EXPECT_FALSE(scheduler->AddSensor(fastCamera, -1.0));
+  EXPECT_TRUE(scheduler->AddSensor(fastCamera, 0.0));
+  EXPECT_TRUE(scheduler->AddSensor(slowCamera, 10.0));
+  EXPECT_EQ(2u, scheduler->SensorCount());
+  EXPECT_DOUBLE_EQ(10.0, scheduler->UpdateRate(slowCamera));
+
+  // both render on the first update, then the slow camera every 100 ms
+  using std::chrono::milliseconds;
+  EXPECT_EQ(2u, scheduler->Update(milliseconds(0)));
+  EXPECT_EQ(1u, scheduler->Update(milliseconds(50)));
+  EXPECT_EQ(2u, scheduler->Update(milliseconds(100)));
+  EXPECT_EQ(std::chrono::steady_clock::duration(milliseconds(100)),
+      scheduler->NextUpdateTime());
+  EXPECT_EQ(2u, slowFrames);
+
+  // missed frames are skipped
+  EXPECT_EQ(2u, scheduler->Update(milliseconds(1000)));
+  EXPECT_EQ(1u, scheduler->Update(milliseconds(1050)));
+  EXPECT_EQ(2u, scheduler->Update(milliseconds(1100)));
+
+  // going back in time makes all sensors due
+  EXPECT_EQ(2u, scheduler->Update(milliseconds(0)));
+
+  // a limit spreads the due sensors over consecutive updates, the one
+  // deferred is rendered by the next update and keeps its rate
+  EXPECT_EQ(0u, scheduler->MaxSensorsPerUpdate());
+  scheduler->SetMaxSensorsPerUpdate(1u);
+  EXPECT_EQ(1u, scheduler->MaxSensorsPerUpdate());
+  unsigned int frames = slowFrames;
+  EXPECT_EQ(1u, scheduler->Update(milliseconds(100)));
+  EXPECT_EQ(frames, slowFrames);
+  EXPECT_EQ(1u, scheduler->Update(milliseconds(110)));
+  EXPECT_EQ(frames + 1u, slowFrames);
+  EXPECT_EQ(1u, scheduler->Update(milliseconds(120)));
+  EXPECT_EQ(frames + 1u, slowFrames);
+  scheduler->SetMaxSensorsPerUpdate(0u);
+  EXPECT_EQ(2u, scheduler->Update(milliseconds(200)));
+  EXPECT_EQ(frames + 2u, slowFrames);
+
+  // removed and destroyed sensors are no longer rendered
+  EXPECT_TRUE(scheduler->RemoveSensor(fastCamera));
+  EXPECT_FALSE(scheduler->RemoveSensor(fastCamera));
+  EXPECT_FALSE(scheduler->HasSensor(fastCamera));
+  scene->DestroySensor(slowCamera);
+  EXPECT_EQ(0u, scheduler->Update(milliseconds(200)));
+  EXPECT_EQ(0u, scheduler->SensorCount());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::Reset(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+
+  // build the same scene a few times, as episodic workloads do
+  for (unsigned int episode = 0u; episode < 3u; ++episode)
+  {
+    VisualPtr root = scene->RootVisual();
+    ASSERT_TRUE(root != nullptr);
+
+    MaterialPtr red = scene->CreateMaterial("red");
+    ASSERT_TRUE(red != nullptr);
+    red->SetDiffuse(1.0, 0.0, 0.0);
+
+    VisualPtr box = scene->CreateVisual("box");
+    ASSERT_TRUE(box != nullptr);
+    box->AddGeometry(scene->CreateBox());
+    box->SetLocalPosition(3, 0, 0);
+    box->SetMaterial(red);
+    root->AddChild(box);
+
+    CameraPtr camera = scene->CreateCamera("camera");
+    ASSERT_TRUE(camera != nullptr);
+    camera->SetImageWidth(320);
+    camera->SetImageHeight(240);
+    root->AddChild(camera);
+
+    Image image = camera->CreateImage();
+    camera->Capture(image);
+    EXPECT_EQ(box, camera->VisualAt(math::Vector2i(160, 120)));
+
+    scene->Reset();
+    EXPECT_EQ(0u, scene->VisualCount());
+    EXPECT_EQ(0u, scene->SensorCount());
+    EXPECT_FALSE(scene->MaterialRegistered("red"));
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+void SceneTest::SpatialQueries(const std::string &_renderEngine)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_TRUE(scene != nullptr);
+  VisualPtr root = scene->RootVisual();
+
+  // unit boxes along the x axis, 2m apart
+  std::vector<VisualPtr> boxes;
+  for (unsigned int i = 0; i < 10u; ++i)
+  {
+    VisualPtr box = scene->CreateVisual("box" + std::to_string(i));
+    box->AddGeometry(scene->CreateBox());
+    box->SetLocalPosition(i * 2.0, 0.0, 0.0);
+    root->AddChild(box);
+    boxes.push_back(box);
+  }
+
+  // visuals that are not in the scene graph are left out
+  VisualPtr detached = scene->CreateVisual("detached");
+  detached->AddGeometry(scene->CreateBox());
+
+  auto names = [](const std::vector<VisualPtr> &_visuals)
+  {
+    std::vector<std::string> result;
+    for (const auto &visual : _visuals)
+      result.push_back(visual->Name());
+    std::sort(result.begin(), result.end());
+    return result;
+  };
+
+  math::AxisAlignedBox region(math::Vector3d(1.0, -1.0, -1.0),
+      math::Vector3d(4.4, 1.0, 1.0));
+  EXPECT_EQ(std::vector<std::string>({"box1", "box2"}),
+      names(scene->VisualsInBox(region)));
+
+  EXPECT_EQ(std::vector<std::string>({"box4", "box5", "box6"}),
+      names(scene->VisualsInSphere(math::Vector3d(10.0, 1.0, 0.0), 2.0)));
+
+  std::vector<VisualPtr> nearest =
+      scene->NearestVisuals(math::Vector3d(7.2, 3.0, 0.0), 3u);
+  ASSERT_EQ(3u, nearest.size());
+  EXPECT_EQ(boxes[4], nearest[0]);
+  EXPECT_EQ(boxes[3], nearest[1]);
+  EXPECT_EQ(boxes[5], nearest[2]);
+
+  // the index follows visuals that move, are detached or destroyed
+  boxes[8]->SetLocalPosition(3.0, 0.0, 0.0);
+  root->RemoveChild(boxes[1]);
+  root->AddChild(detached);
+  detached->SetLocalPosition(2.0, 0.0, 5.0);
+  EXPECT_EQ(std::vector<std::string>({"box2", "box8"}),
+      names(scene->VisualsInBox(region)));
+
+  // children move with their parent, which includes them
+  root->RemoveChild(detached);
+  boxes[2]->AddChild(detached);
+  detached->SetLocalPosition(0.0, 0.0, 0.0);
+  boxes[2]->SetLocalPosition(20.0, 0.0, 0.0);
+  EXPECT_EQ(std::vector<std::string>({"box8"}),
+      names(scene->VisualsInBox(region)));
+  EXPECT_EQ(std::vector<std::string>({"box2", "detached"}),
+      names(scene->VisualsInSphere(math::Vector3d(20.0, 0.0, 0.0), 0.1)));
+
+  scene->DestroyVisual(boxes[8]);
+  EXPECT_TRUE(scene->VisualsInBox(region).empty());
+
+  // camera behind the first box looking along +x, seeing up to 12m
+  CameraPtr camera = scene->CreateCamera("camera");
+  ASSERT_TRUE(camera != nullptr);
+  camera->SetImageWidth(320);
+  camera->SetImageHeight(240);
+  camera->SetAspectRatio(320.0 / 240.0);
+  camera->SetHFOV(IGN_PI / 2);
+  camera->SetNearClipPlane(0.1);
+  camera->SetFarClipPlane(12.0);
+  camera->SetLocalPosition(-3.0, 0.0, 0.0);
+  root->AddChild(camera);
+  EXPECT_EQ(std::vector<std::string>({"box0", "box3", "box4"}),
+      names(scene->VisualsInFrustum(camera)));
+
+  camera->SetLocalRotation(0.0, 0.0, IGN_PI);
+  EXPECT_TRUE(scene->VisualsInFrustum(camera).empty());
+  EXPECT_TRUE(scene->VisualsInFrustum(nullptr).empty());
+
+  // Clean up
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
 /////////////////////////////////////////////////
 TEST_P(SceneTest, AddRemoveVisuals)
 {
@@ -238,6 +1171,78 @@ TEST_P(SceneTest, VisualAt)
   VisualAt(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(SceneTest, RenderSensors)
+{
+  RenderSensors(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, GpuStats)
+{
+  GpuStats(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, DrawStats)
+{
+  DrawStats(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, MemoryStats)
+{
+  MemoryStats(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, QueueCommand)
+{
+  QueueCommand(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, PrepareMesh)
+{
+  PrepareMesh(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, InstancedDrawStats)
+{
+  InstancedDrawStats(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, OcclusionCulling)
+{
+  OcclusionCulling(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, WarmUp)
+{
+  WarmUp(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, Scheduler)
+{
+  Scheduler(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, Reset)
+{
+  Reset(GetParam());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneTest, SpatialQueries)
+{
+  SpatialQueries(GetParam());
+}
+
 // It doesn't suppot optix just yet
 INSTANTIATE_TEST_CASE_P(Scene, SceneTest,
     RENDER_ENGINE_VALUES,
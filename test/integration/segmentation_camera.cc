@@ -237,6 +237,76 @@ void SegmentationCameraTest::SegmentationCameraBoxes(
   EXPECT_EQ(1, rightCount);
   EXPECT_EQ(2, leftCount);
 
+  // the semantic label map comes from the same panoptic render
+  uint8_t *semanticBuffer = new uint8_t[width * height * 3];
+  camera->SemanticLabelMap(semanticBuffer);
+  for (unsigned int i = 0; i < 3u; ++i)
+  {
+    EXPECT_EQ(1, semanticBuffer[leftIndex + i]);
+    EXPECT_EQ(2, semanticBuffer[middleIndex + i]);
+    EXPECT_EQ(1, semanticBuffer[rightIndex + i]);
+    EXPECT_EQ(backgroundLabel, semanticBuffer[i]);
+  }
+
+  // Colored map test, the label id map is rendered together with the colored
+  // map and should match the panoptic label map above
+  camera->EnableColoredMap(true);
+  g_counter = 0;
+  camera->Update();
+  EXPECT_EQ(1, g_counter);
+
+  // the two boxes with the same label are different instances
+  EXPECT_FALSE(g_buffer[leftIndex] == g_buffer[rightIndex] &&
+      g_buffer[leftIndex + 1] == g_buffer[rightIndex + 1] &&
+      g_buffer[leftIndex + 2] == g_buffer[rightIndex + 2]);
+
+  uint8_t *labelBuffer = new uint8_t[width * height * 3];
+  camera->LabelMapFromColoredBuffer(labelBuffer);
+
+  EXPECT_EQ(1, labelBuffer[leftIndex + 2]);
+  EXPECT_EQ(2, labelBuffer[middleIndex + 2]);
+  EXPECT_EQ(1, labelBuffer[rightIndex + 2]);
+  EXPECT_EQ(1, labelBuffer[middleIndex]);
+  EXPECT_EQ(1, labelBuffer[rightIndex]);
+  EXPECT_EQ(2, labelBuffer[leftIndex]);
+  EXPECT_EQ(backgroundLabel, labelBuffer[0]);
+  delete [] labelBuffer;
+
+  // colored map, instance ids and semantic ids all come from one render
+  memset(semanticBuffer, 0, width * height * 3);
+  camera->SemanticLabelMap(semanticBuffer);
+  for (unsigned int i = 0; i < 3u; ++i)
+  {
+    EXPECT_EQ(1, semanticBuffer[leftIndex + i]);
+    EXPECT_EQ(2, semanticBuffer[middleIndex + i]);
+    EXPECT_EQ(1, semanticBuffer[rightIndex + i]);
+    EXPECT_EQ(backgroundLabel, semanticBuffer[i]);
+  }
+  delete [] semanticBuffer;
+
+  // moving the middle box into the left box model makes the left box a link
+  // of the model the middle box is the first item of, so the left box
+  // takes the instance of the right box instead of a new one. Reparenting
+  // alone has to refresh the cached colors.
+  camera->EnableColoredMap(false);
+  VisualPtr boxLeft = scene->VisualByName("box_left");
+  VisualPtr boxMid = scene->VisualByName("box_mid");
+  ASSERT_NE(nullptr, boxLeft);
+  ASSERT_NE(nullptr, boxMid);
+  scene->RootVisual()->RemoveChild(boxMid);
+  boxLeft->AddChild(boxMid);
+  boxMid->SetLocalPosition(0, -1.5, 0);
+  g_counter = 0;
+  camera->Update();
+  EXPECT_EQ(1, g_counter);
+
+  EXPECT_EQ(1, g_buffer[leftIndex + 2]);
+  EXPECT_EQ(2, g_buffer[middleIndex + 2]);
+  EXPECT_EQ(1, g_buffer[rightIndex + 2]);
+  EXPECT_EQ(1, g_buffer[middleIndex]);
+  EXPECT_EQ(1, g_buffer[rightIndex]);
+  EXPECT_EQ(1, g_buffer[leftIndex]);
+
   // Clean up
   engine->DestroyScene(scene);
   ignition::rendering::unloadEngine(engine->Name());
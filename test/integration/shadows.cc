@@ -192,6 +192,43 @@ void ShadowsTest::Shadows(const std::string &_renderEngine)
 #endif
   }
 
+  // a light added by a queued command casts shadows in the first frame
+  // rendered after it is added
+  white->SetCastShadows(true);
+  boxTop->SetMaterial(white);
+  scene->DestroyLight(light);
+  camera->Capture(image);
+  scene->QueueCommand([&]()
+  {
+    light = scene->CreateDirectionalLight();
+    light->SetDirection(0.0, 0.0, -1);
+    light->SetDiffuseColor(0.5, 0.5, 0.5);
+    light->SetSpecularColor(0.5, 0.5, 0.5);
+    root->AddChild(light);
+  });
+  camera->Capture(image);
+  {
+    unsigned shaded = 0;
+    unsigned unshaded = 0;
+    unsigned char *data = image.Data<unsigned char>();
+    for (unsigned int i = 0; i < height; ++i)
+    {
+      for (unsigned int j = 0; j < step; j+=bpp)
+      {
+        unsigned int idx = i * step + j;
+        unsigned int sum = data[idx] + data[idx+1] + data[idx+2];
+        if (j < step /2)
+          shaded += sum;
+        else
+          unshaded += sum;
+      }
+    }
+    // Test currently fails on macOS
+#ifndef __APPLE__
+    EXPECT_LT(shaded, unshaded);
+#endif
+  }
+
   // Clean up materials
   scene->DestroyMaterial(white);
   scene->DestroyMaterial(green);
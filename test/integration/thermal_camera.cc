@@ -53,6 +53,22 @@ void OnNewThermalFrame(uint16_t *_scanDest, const uint16_t *_scan,
   memcpy(_scanDest, _scan, size * sizeof(u));
 }
 
+//////////////////////////////////////////////////
+void OnNewThermalFrameView(uint8_t *_scanDest, const void *_scan,
+                  unsigned int _width, unsigned int _height,
+                  unsigned int _rowPitch,
+                  const std::string &_format)
+{
+  EXPECT_EQ("L8", _format);
+  EXPECT_EQ(50u, _width);
+  EXPECT_EQ(50u, _height);
+  EXPECT_GE(_rowPitch, _width);
+
+  const uint8_t *src = static_cast<const uint8_t *>(_scan);
+  for (unsigned int i = 0; i < _height; ++i)
+    memcpy(_scanDest + i * _width, src + i * _rowPitch, _width);
+}
+
 //////////////////////////////////////////////////
 class ThermalCameraTest: public testing::Test,
   public testing::WithParamInterface<const char *>
@@ -69,6 +85,11 @@ class ThermalCameraTest: public testing::Test,
   // Test that particles do not appear in thermal camera image
   public: void ThermalCameraParticles(const std::string &_renderEngine);
 
+  // Test that temperature changes reach thermal cameras, including ones
+  // created later and ones in a new scene
+  public: void ThermalCameraTemperatureChange(
+              const std::string &_renderEngine);
+
   // Path to test textures
   public: const std::string TEST_MEDIA_PATH =
           ignition::common::joinPaths(std::string(PROJECT_SOURCE_PATH),
@@ -260,6 +281,42 @@ void ThermalCameraTest::ThermalCameraBoxes(
       }
     }
 
+    // link a camera with the same view and verify the thermal image is the
+    // same when its depth is reused
+    EXPECT_EQ(nullptr, thermalCamera->LinkedCamera());
+    if (_renderEngine.compare("ogre2") == 0 && !_useHeatSignature)
+    {
+      box->SetLocalPosition(boxPosition);
+
+      auto camera = scene->CreateCamera("LinkedCamera");
+      ASSERT_NE(camera, nullptr);
+      camera->SetLocalPose(testPose);
+      camera->SetImageWidth(imgWidth);
+      camera->SetImageHeight(imgHeight);
+      camera->SetFarClipPlane(farDist);
+      camera->SetNearClipPlane(nearDist);
+      camera->SetAspectRatio(aspectRatio);
+      camera->SetHFOV(hfov);
+      camera->SetAntiAliasing(0);
+      scene->RootVisual()->AddChild(camera);
+
+      thermalCamera->SetLinkedCamera(camera);
+      EXPECT_EQ(camera, thermalCamera->LinkedCamera());
+      EXPECT_TRUE(camera->DepthPickingEnabled());
+
+      camera->Update();
+      thermalCamera->Update();
+      EXPECT_NEAR(ambientTemp, thermalData[left] * linearResolution,
+          ambientTempRange);
+      EXPECT_NEAR(ambientTemp, thermalData[right] * linearResolution,
+          ambientTempRange);
+      EXPECT_NEAR(boxTemp, thermalData[mid] * linearResolution,
+          boxTempRange);
+
+      thermalCamera->SetLinkedCamera(nullptr);
+      EXPECT_EQ(nullptr, thermalCamera->LinkedCamera());
+    }
+
     // Clean up
     connection.reset();
     delete [] thermalData;
@@ -394,6 +451,15 @@ void ThermalCameraTest::ThermalCameraBoxes8Bit(
             std::placeholders::_4, std::placeholders::_5));
     EXPECT_NE(nullptr, connection);
 
+    // Also get the packed 8 bit view of the same frame
+    uint8_t *thermalView = new uint8_t[imgHeight * imgWidth];
+    ignition::common::ConnectionPtr viewConnection =
+      thermalCamera->ConnectNewThermalFrameView(
+          std::bind(&::OnNewThermalFrameView, thermalView,
+            std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
+            std::placeholders::_4, std::placeholders::_5));
+    EXPECT_NE(nullptr, viewConnection);
+
     // Update once to create image
     thermalCamera->Update();
 
@@ -414,6 +480,10 @@ void ThermalCameraTest::ThermalCameraBoxes8Bit(
     EXPECT_FLOAT_EQ(thermalData[right], thermalData[left]);
     EXPECT_NEAR(boxTemp, thermalData[mid] * linearResolution, boxTempRange);
 
+    // the packed view should hold the same values as the 16 bit frame
+    for (int i = 0; i < imgHeight * imgWidth; ++i)
+      EXPECT_EQ(thermalData[i], thermalView[i]);
+
     // move box in front of near clip plane and verify the thermal
     // image returns all box temperature values
     ignition::math::Vector3d boxPositionNear(
@@ -448,9 +518,27 @@ void ThermalCameraTest::ThermalCameraBoxes8Bit(
       }
     }
 
-    // Clean up
+    // disconnect the 16 bit frame, move the box back in front of the near
+    // clip plane and verify the view still updates without the widened
+    // buffer
     connection.reset();
+    box->SetLocalPosition(boxPositionNear);
+    thermalCamera->Update();
+
+    for (unsigned int i = 0; i < thermalCamera->ImageHeight(); ++i)
+    {
+      unsigned int step = i * thermalCamera->ImageWidth();
+      for (unsigned int j = 0; j < thermalCamera->ImageWidth(); ++j)
+      {
+        float temp = thermalView[step + j] * linearResolution;
+        EXPECT_NEAR(boxTemp, temp, boxTempRange);
+      }
+    }
+
+    // Clean up
+    viewConnection.reset();
     delete [] thermalData;
+    delete [] thermalView;
   }
 
   engine->DestroyScene(scene);
@@ -628,6 +716,108 @@ void ThermalCameraTest::ThermalCameraParticles(
   ignition::rendering::unloadEngine(engine->Name());
 }
 
+//////////////////////////////////////////////////
+void ThermalCameraTest::ThermalCameraTemperatureChange(
+    const std::string &_renderEngine)
+{
+  // Optix is not supported
+  if (_renderEngine.compare("optix") == 0)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' doesn't support thermal cameras" << std::endl;
+    return;
+  }
+
+  auto *engine = ignition::rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  const unsigned int imgWidth = 50u;
+  const unsigned int imgHeight = 50u;
+  const float boxTempRange = 3.0f;
+  const float linearResolution = 0.01f;
+  const unsigned int mid = imgHeight / 2u * imgWidth + imgWidth / 2u - 1u;
+  uint16_t *thermalData = new uint16_t[imgHeight * imgWidth];
+
+  // scene with a box in front of the cameras it creates
+  auto createScene = [&](float _boxTemp)
+  {
+    ignition::rendering::ScenePtr scene = engine->CreateScene("scene");
+    ignition::rendering::VisualPtr box = scene->CreateVisual("box");
+    box->AddGeometry(scene->CreateBox());
+    box->SetLocalPosition(1.8, 0.0, 0.0);
+    box->SetUserData("temperature", _boxTemp);
+    scene->RootVisual()->AddChild(box);
+    return scene;
+  };
+
+  auto createCamera = [&](ignition::rendering::ScenePtr _scene,
+      const std::string &_name)
+  {
+    auto camera = _scene->CreateThermalCamera(_name);
+    camera->SetImageWidth(imgWidth);
+    camera->SetImageHeight(imgHeight);
+    camera->SetNearClipPlane(0.15);
+    camera->SetFarClipPlane(10.0);
+    camera->SetAspectRatio(1.0);
+    camera->SetHFOV(1.05);
+    camera->SetAmbientTemperature(296.0f);
+    camera->SetLinearResolution(linearResolution);
+    camera->SetHeatSourceTemperatureRange(boxTempRange);
+    _scene->RootVisual()->AddChild(camera);
+    return camera;
+  };
+
+  auto onFrame = std::bind(&::OnNewThermalFrame, thermalData,
+      std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
+      std::placeholders::_4, std::placeholders::_5);
+
+  {
+    ignition::rendering::ScenePtr scene = createScene(310.0f);
+    auto camera = createCamera(scene, "ThermalCamera");
+    ASSERT_NE(nullptr, camera);
+    auto connection = camera->ConnectNewThermalFrame(onFrame);
+    camera->Update();
+    EXPECT_NEAR(310.0f, thermalData[mid] * linearResolution, boxTempRange);
+
+    // the cached heat sources are resolved again after a change
+    scene->VisualByName("box")->SetUserData("temperature", 320.0f);
+    camera->Update();
+    EXPECT_NEAR(320.0f, thermalData[mid] * linearResolution, boxTempRange);
+
+    // a camera created later shares the up to date heat sources
+    auto camera2 = createCamera(scene, "ThermalCamera2");
+    ASSERT_NE(nullptr, camera2);
+    auto connection2 = camera2->ConnectNewThermalFrame(onFrame);
+    camera2->Update();
+    EXPECT_NEAR(320.0f, thermalData[mid] * linearResolution, boxTempRange);
+
+    connection.reset();
+    connection2.reset();
+    engine->DestroyScene(scene);
+  }
+
+  // heat sources of a destroyed scene are not reused by a new one
+  {
+    ignition::rendering::ScenePtr scene = createScene(330.0f);
+    auto camera = createCamera(scene, "ThermalCamera");
+    ASSERT_NE(nullptr, camera);
+    auto connection = camera->ConnectNewThermalFrame(onFrame);
+    camera->Update();
+    EXPECT_NEAR(330.0f, thermalData[mid] * linearResolution, boxTempRange);
+
+    connection.reset();
+    engine->DestroyScene(scene);
+  }
+
+  delete [] thermalData;
+  ignition::rendering::unloadEngine(engine->Name());
+}
+
 TEST_P(ThermalCameraTest, ThermalCameraBoxesUniformTemp)
 {
   ThermalCameraBoxes(GetParam(), false);
@@ -648,6 +838,11 @@ TEST_P(ThermalCameraTest, ThermalCameraParticles)
   ThermalCameraParticles(GetParam());
 }
 
+TEST_P(ThermalCameraTest, ThermalCameraTemperatureChange)
+{
+  ThermalCameraTemperatureChange(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(ThermalCamera, ThermalCameraTest,
     RENDER_ENGINE_VALUES, ignition::rendering::PrintToStringParam());
 
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Event.hh>
+
+#include <ignition/math/Color.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/CameraLens.hh"
+#include "ignition/rendering/Material.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
+#include "ignition/rendering/WideAngleCamera.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+class WideAngleCameraTest: public testing::Test,
+  public testing::WithParamInterface<const char *>
+{
+  public: void WideAngleCameraFisheye(const std::string &_renderEngine);
+
+  // Documentation inherited
+  protected: void SetUp() override
+  {
+    ignition::common::Console::SetVerbosity(4);
+  }
+};
+
+/// \brief mutex for thread safety
+std::mutex g_mutex;
+
+/// \brief Wide angle image buffer
+std::vector<unsigned char> g_buffer;
+
+/// \brief counter of received wide angle frames
+int g_counter = 0;
+
+//////////////////////////////////////////////////
+/// \brief callback to get the wide angle image
+void OnNewWideAngleFrame(const unsigned char *_data,
+                    unsigned int _width, unsigned int _height,
+                    unsigned int _channels,
+                    const std::string &/*_format*/)
+{
+  std::lock_guard<std::mutex> lock(g_mutex);
+  g_buffer.assign(_data, _data + _width * _height * _channels);
+  g_counter++;
+}
+
+//////////////////////////////////////////////////
+void WideAngleCameraTest::WideAngleCameraFisheye(
+  const std::string &_renderEngine)
+{
+  // Currently, only ogre2 supports wide angle cameras
+  if (_renderEngine.compare("ogre2") != 0)
+  {
+    ignerr << "Engine '" << _renderEngine
+              << "' doesn't support wide angle cameras" << std::endl;
+    return;
+  }
+
+  auto *engine = ignition::rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    ignerr << "Engine '" << _renderEngine
+              << "' was unable to be retrieved" << std::endl;
+    return;
+  }
+  ignition::rendering::ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetBackgroundColor(0.0, 0.0, 1.0);
+  scene->SetAmbientLight(1.0, 1.0, 1.0);
+
+  // red box in front of the camera
+  rendering::VisualPtr root = scene->RootVisual();
+  MaterialPtr red = scene->CreateMaterial();
+  red->SetAmbient(1.0, 0.0, 0.0);
+  red->SetDiffuse(1.0, 0.0, 0.0);
+  red->SetEmissive(1.0, 0.0, 0.0);
+  rendering::VisualPtr box = scene->CreateVisual("box");
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(2.0, 0.0, 0.0);
+  box->SetMaterial(red);
+  root->AddChild(box);
+
+  auto camera = scene->CreateWideAngleCamera("WideAngleCamera");
+  ASSERT_NE(nullptr, camera);
+
+  // 180 degree equidistant fisheye, the image circle touches the left and
+  // right borders of the image
+  CameraLens lens;
+  lens.SetType(MFT_EQUIDISTANT);
+  lens.SetCutOffAngle(IGN_PI * 0.5);
+  camera->SetLens(lens);
+  EXPECT_EQ(MFT_EQUIDISTANT, camera->Lens().Type());
+  EXPECT_DOUBLE_EQ(IGN_PI * 0.5, camera->Lens().CutOffAngle());
+
+  unsigned int width = 320u;
+  unsigned int height = 240u;
+  camera->SetImageWidth(width);
+  camera->SetImageHeight(height);
+  camera->SetAspectRatio(static_cast<double>(width) / height);
+  camera->SetHFOV(IGN_PI);
+  camera->SetLocalPosition(0.0, 0.0, 0.0);
+  root->AddChild(camera);
+
+  ignition::common::ConnectionPtr connection =
+      camera->ConnectNewWideAngleFrame(
+          std::bind(OnNewWideAngleFrame,
+          std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
+          std::placeholders::_4, std::placeholders::_5));
+  ASSERT_NE(nullptr, connection);
+
+  camera->Update();
+  EXPECT_EQ(1, g_counter);
+  ASSERT_EQ(width * height * 3u, g_buffer.size());
+
+  auto pixel = [&](unsigned int _x, unsigned int _y)
+  {
+    return &g_buffer[(_y * width + _x) * 3u];
+  };
+
+  // the box is in the center of the image
+  const unsigned char *center = pixel(width / 2u, height / 2u);
+  EXPECT_GT(center[0], 200u);
+  EXPECT_LT(center[1], 50u);
+  EXPECT_LT(center[2], 50u);
+
+  // close to 90 degrees to the left of the camera is background
+  const unsigned char *left = pixel(2u, height / 2u);
+  EXPECT_LT(left[0], 50u);
+  EXPECT_GT(left[2], 200u);
+
+  // the corners are outside the image circle
+  for (auto corner : {pixel(0u, 0u), pixel(width - 1u, 0u),
+      pixel(0u, height - 1u), pixel(width - 1u, height - 1u)})
+  {
+    EXPECT_EQ(0u, corner[0]);
+    EXPECT_EQ(0u, corner[1]);
+    EXPECT_EQ(0u, corner[2]);
+  }
+
+  // a narrower fov magnifies the box so it covers most of the width
+  camera->SetHFOV(IGN_PI * 0.25);
+  camera->Update();
+  EXPECT_EQ(2, g_counter);
+  ASSERT_EQ(width * height * 3u, g_buffer.size());
+  left = pixel(width / 4u, height / 2u);
+  EXPECT_GT(left[0], 200u);
+  EXPECT_LT(left[2], 50u);
+
+  // Clean up
+  connection.reset();
+  engine->DestroyScene(scene);
+  ignition::rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(WideAngleCameraTest, WideAngleCameraFisheye)
+{
+  WideAngleCameraFisheye(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(WideAngleCamera, WideAngleCameraTest,
+    RENDER_ENGINE_VALUES, ignition::rendering::PrintToStringParam());
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/Material.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Measure the cost of changing material properties every frame,
+/// e.g. to animate highlight or status colors.
+///
+/// Every frame the properties of all the materials are changed and the
+/// scene is rendered. The time per frame minus the time of a frame that
+/// changes nothing, divided by the number of materials, is reported as the
+/// cost per changed material and recorded as a property of each test in
+/// the gtest XML output.
+class MaterialUpdateTest: public testing::Test,
+                          public testing::WithParamInterface<const char *>
+{
+  // Documentation inherited
+  public: void SetUp() override
+  {
+    ignition::common::Console::SetVerbosity(3);
+  }
+
+  /// \brief Benchmark one kind of material change on an engine
+  /// \param[in] _renderEngine Render engine name
+  /// \param[in] _property Name of the changed property, for the results
+  /// \param[in] _update Function that changes a material for a frame
+  public: void Benchmark(const std::string &_renderEngine,
+      const std::string &_property,
+      const std::function<void(MaterialPtr, unsigned int)> &_update);
+};
+
+/////////////////////////////////////////////////
+void MaterialUpdateTest::Benchmark(const std::string &_renderEngine,
+    const std::string &_property,
+    const std::function<void(MaterialPtr, unsigned int)> &_update)
+{
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  const unsigned int materialCount = 1000u;
+  const unsigned int frames = 30u;
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  VisualPtr root = scene->RootVisual();
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(320u);
+  camera->SetImageHeight(240u);
+  camera->SetLocalPosition(-5.0, 0.0, 0.0);
+  root->AddChild(camera);
+
+  // one box with its own material per material, in front of the camera
+  std::vector<MaterialPtr> materials;
+  for (unsigned int i = 0; i < materialCount; ++i)
+  {
+    MaterialPtr material = scene->CreateMaterial();
+    material->SetDiffuse(0.7, 0.7, 0.7);
+    materials.push_back(material);
+
+    VisualPtr box = scene->CreateVisual();
+    box->AddGeometry(scene->CreateBox());
+    box->SetLocalScale(0.2);
+    box->SetLocalPosition(0.0, (i % 32) * 0.25 - 4.0, (i / 32) * 0.25 - 4.0);
+    box->SetMaterial(material, false);
+    root->AddChild(box);
+  }
+
+  auto timeFrames = [&](bool _change)
+  {
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int f = 0; f < frames; ++f)
+    {
+      if (_change)
+      {
+        for (auto &material : materials)
+          _update(material, f);
+      }
+      camera->Update();
+    }
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / frames;
+  };
+
+  // warm up, then time frames without and with changes
+  timeFrames(true);
+  double baseMs = timeFrames(false);
+  double changedMs = timeFrames(true);
+  double perMaterialUs =
+      std::max(changedMs - baseMs, 0.0) * 1000.0 / materialCount;
+
+  ignmsg << _renderEngine << " " << _property << ": " << changedMs
+         << " ms per frame, " << baseMs << " ms without changes, "
+         << perMaterialUs << " us per changed material" << std::endl;
+  testing::Test::RecordProperty(_property + "_frame_ms",
+      std::to_string(changedMs));
+  testing::Test::RecordProperty(_property + "_per_material_us",
+      std::to_string(perMaterialUs));
+  EXPECT_GT(changedMs, 0.0);
+
+  engine->DestroyScene(scene);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(MaterialUpdateTest, Diffuse)
+{
+  Benchmark(GetParam(), "diffuse", [](MaterialPtr _material, unsigned int _f)
+  {
+    _material->SetDiffuse(math::Color((_f % 10) * 0.1f, 0.5f, 0.5f));
+  });
+}
+
+/////////////////////////////////////////////////
+TEST_P(MaterialUpdateTest, Emissive)
+{
+  Benchmark(GetParam(), "emissive", [](MaterialPtr _material, unsigned int _f)
+  {
+    _material->SetEmissive(math::Color((_f % 10) * 0.1f, 0.0f, 0.0f));
+  });
+}
+
+/////////////////////////////////////////////////
+TEST_P(MaterialUpdateTest, UnchangedDiffuse)
+{
+  Benchmark(GetParam(), "unchanged_diffuse",
+      [](MaterialPtr _material, unsigned int)
+  {
+    _material->SetDiffuse(math::Color(0.7f, 0.7f, 0.7f));
+  });
+}
+
+/////////////////////////////////////////////////
+TEST_P(MaterialUpdateTest, Transparency)
+{
+  Benchmark(GetParam(), "transparency",
+      [](MaterialPtr _material, unsigned int _f)
+  {
+    _material->SetTransparency((_f % 2) * 0.5);
+  });
+}
+
+INSTANTIATE_TEST_CASE_P(MaterialUpdate, MaterialUpdateTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,439 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifdef __linux__
+# include <unistd.h>
+#endif  // __linux__
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/StringUtils.hh>
+#include <ignition/common/Util.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/Light.hh"
+#include "ignition/rendering/Material.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/Visual.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Grow a scene along one axis at a time, the number of visuals,
+/// lights or sensors, and measure the CPU time of each phase of a frame
+/// (Scene::PreRender, Camera::Render, Camera::PostRender and
+/// Scene::PostRender), the GPU time and the resident memory, to find the
+/// size of the scenes an engine can render at a given rate.
+///
+/// By default each axis only runs a few small scenes so the test stays
+/// quick when run with the other tests. Setting the
+/// IGN_RENDERING_BENCHMARK_FULL environment variable to 1 runs the full
+/// sweep, up to 100000 visuals, 1000 lights and 64 sensors.
+///
+/// The axes not being grown keep 100 visuals, or 1000 in the full sweep,
+/// 1 light and 1 sensor.
+/// Results are appended as one JSON object per line to the file given by
+/// the IGN_RENDERING_BENCHMARK_OUTPUT environment variable, or to
+/// test/scene_scaling.jsonl in the build directory, and each axis prints
+/// a table of the timings relative to its smallest scene. GPU times are
+/// only reported by engines supporting the "gpuTiming" parameter.
+///
+/// The IGN_RENDERING_STRESS_VISUALS, IGN_RENDERING_STRESS_LIGHTS and
+/// IGN_RENDERING_STRESS_SENSORS environment variables override the comma
+/// separated list of sizes of each axis, IGN_RENDERING_BENCHMARK_FRAMES
+/// the number of timed frames.
+class SceneScalingTest: public testing::Test,
+                        public testing::WithParamInterface<const char *>
+{
+  // Documentation inherited
+  public: void SetUp() override
+  {
+    ignition::common::Console::SetVerbosity(3);
+  }
+
+  /// \brief Grow a scene along one axis and measure its frames
+  /// \param[in] _renderEngine Render engine name
+  /// \param[in] _axis One of visuals, lights or sensors
+  /// \param[in] _sizes Sizes of the axis to measure
+  public: void Scale(const std::string &_renderEngine,
+      const std::string &_axis, const std::vector<unsigned int> &_sizes);
+};
+
+/// \brief Measurements of one scene size
+struct ScalingResult
+{
+  unsigned int visuals = 0u;
+  unsigned int lights = 0u;
+  unsigned int sensors = 0u;
+  double preRenderMs = 0.0;
+  double renderMs = 0.0;
+  double postRenderMs = 0.0;
+  double scenePostRenderMs = 0.0;
+  double gpuMs = 0.0;
+  double frameMs = 0.0;
+  double residentMb = 0.0;
+  uint64_t drawCalls = 0u;
+  uint64_t triangles = 0u;
+};
+
+/////////////////////////////////////////////////
+/// \brief Get a list of unsigned values from an environment variable
+std::vector<unsigned int> envValues(const std::string &_name,
+    const std::vector<unsigned int> &_default)
+{
+  std::string str;
+  if (!common::env(_name, str) || str.empty())
+    return _default;
+
+  std::vector<unsigned int> values;
+  for (const auto &token : common::split(str, ","))
+    values.push_back(static_cast<unsigned int>(std::stoul(token)));
+  return values.empty() ? _default : values;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get whether the full sweep was requested
+/// \return True if IGN_RENDERING_BENCHMARK_FULL is set to 1
+bool fullSweep()
+{
+  std::string str;
+  return common::env("IGN_RENDERING_BENCHMARK_FULL", str) && str == "1";
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the resident memory of the process
+/// \return Resident memory in MB, 0 if not available
+double residentMemory()
+{
+#ifdef __linux__
+  int64_t totalPages = 0;
+  int64_t residentPages = 0;
+  std::ifstream buffer("/proc/self/statm");
+  buffer >> totalPages >> residentPages;
+  return residentPages * (sysconf(_SC_PAGE_SIZE) / 1024.0) / 1024.0;
+#else
+  return 0.0;
+#endif
+}
+
+/////////////////////////////////////////////////
+/// \brief Fill the scene with a grid of boxes in front of the sensors
+void addVisuals(ScenePtr _scene, unsigned int _count)
+{
+  MaterialPtr material = _scene->CreateMaterial();
+  material->SetDiffuse(0.7, 0.7, 0.7);
+
+  VisualPtr parent = _scene->CreateVisual();
+  _scene->RootVisual()->AddChild(parent);
+
+  unsigned int side = static_cast<unsigned int>(
+      std::ceil(std::sqrt(static_cast<double>(_count))));
+  double spacing = 10.0 / side;
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    VisualPtr box = _scene->CreateVisual();
+    box->AddGeometry(_scene->CreateBox());
+    box->SetLocalScale(spacing * 0.8);
+    box->SetLocalPosition(3.0 + (i % 3) * spacing,
+        (static_cast<double>(i % side) - side / 2.0) * spacing,
+        (static_cast<double>(i / side) - side / 2.0) * spacing);
+    box->SetMaterial(material);
+    parent->AddChild(box);
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Add a directional light casting shadows, then point and spot
+/// lights without shadows spread over the visuals
+void addLights(ScenePtr _scene, unsigned int _count)
+{
+  DirectionalLightPtr sun = _scene->CreateDirectionalLight();
+  sun->SetDirection(0.5, 0.5, -1.0);
+  sun->SetCastShadows(true);
+  _scene->RootVisual()->AddChild(sun);
+
+  for (unsigned int i = 1; i < _count; ++i)
+  {
+    LightPtr light;
+    if (i % 2u == 0u)
+    {
+      light = _scene->CreatePointLight();
+    }
+    else
+    {
+      SpotLightPtr spot = _scene->CreateSpotLight();
+      spot->SetDirection(1.0, 0.0, 0.0);
+      light = spot;
+    }
+    light->SetDiffuseColor(0.2, 0.2, 0.2);
+    light->SetAttenuationRange(2.0);
+    light->SetCastShadows(false);
+    light->SetLocalPosition(2.0 + (i % 5) * 0.5,
+        -5.0 + (i % 20) * 0.5, -5.0 + ((i / 20) % 20) * 0.5);
+    _scene->RootVisual()->AddChild(light);
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Print a table of the results of an axis, with the frame time
+/// relative to the smallest scene
+void printCurve(const std::string &_engine, const std::string &_axis,
+    const std::vector<ScalingResult> &_results)
+{
+  if (_results.empty())
+    return;
+
+  std::stringstream table;
+  table << _engine << " " << _axis << " scaling\n"
+        << "    size  pre ms  render ms  post ms  gpu ms  frame ms  "
+        << "x first  rss MB\n";
+  for (const auto &result : _results)
+  {
+    unsigned int size = _axis == "visuals" ? result.visuals :
+        _axis == "lights" ? result.lights : result.sensors;
+    double ratio = _results.front().frameMs > 0.0 ?
+        result.frameMs / _results.front().frameMs : 0.0;
+    table << std::fixed;
+    table.precision(2);
+    table.width(8);
+    table << size;
+    table.width(8);
+    table << result.preRenderMs;
+    table.width(11);
+    table << result.renderMs;
+    table.width(9);
+    table << result.postRenderMs + result.scenePostRenderMs;
+    table.width(8);
+    table << result.gpuMs;
+    table.width(10);
+    table << result.frameMs;
+    table.width(9);
+    table << ratio;
+    table.width(8);
+    table << result.residentMb << "\n";
+  }
+  ignmsg << table.str() << std::flush;
+}
+
+/////////////////////////////////////////////////
+/// \brief Append a result to the machine readable output
+void writeResult(const std::string &_engine, const std::string &_axis,
+    const ScalingResult &_result)
+{
+  std::string path;
+  if (!common::env("IGN_RENDERING_BENCHMARK_OUTPUT", path) || path.empty())
+  {
+    path = common::joinPaths(std::string(PROJECT_BUILD_PATH), "test",
+        "scene_scaling.jsonl");
+  }
+
+  std::stringstream json;
+  json << "{\"engine\": \"" << _engine << "\""
+       << ", \"axis\": \"" << _axis << "\""
+       << ", \"visuals\": " << _result.visuals
+       << ", \"lights\": " << _result.lights
+       << ", \"sensors\": " << _result.sensors
+       << ", \"pre_render_ms\": " << _result.preRenderMs
+       << ", \"render_ms\": " << _result.renderMs
+       << ", \"post_render_ms\": " << _result.postRenderMs
+       << ", \"scene_post_render_ms\": " << _result.scenePostRenderMs
+       << ", \"gpu_ms\": " << _result.gpuMs
+       << ", \"frame_ms\": " << _result.frameMs
+       << ", \"resident_mb\": " << _result.residentMb
+       << ", \"draw_calls\": " << _result.drawCalls
+       << ", \"triangles\": " << _result.triangles << "}";
+
+  std::ofstream out(path, std::ios::app);
+  out << json.str() << std::endl;
+
+  std::stringstream key;
+  key << _axis << "_" << _result.visuals << "_" << _result.lights << "_"
+      << _result.sensors;
+  testing::Test::RecordProperty(key.str() + "_frame_ms",
+      std::to_string(_result.frameMs));
+  testing::Test::RecordProperty(key.str() + "_gpu_ms",
+      std::to_string(_result.gpuMs));
+}
+
+/////////////////////////////////////////////////
+void SceneScalingTest::Scale(const std::string &_renderEngine,
+    const std::string &_axis, const std::vector<unsigned int> &_sizes)
+{
+  if (_renderEngine != "ogre" && _renderEngine != "ogre2")
+  {
+    igndbg << "Scene scaling is only measured for ogre and ogre2, skipping "
+           << _renderEngine << std::endl;
+    return;
+  }
+
+  std::map<std::string, std::string> params;
+  params["gpuTiming"] = "1";
+  params["drawStats"] = "1";
+  RenderEngine *engine = rendering::engine(_renderEngine, params);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  const unsigned int frames =
+      envValues("IGN_RENDERING_BENCHMARK_FRAMES", {30u}).front();
+  const unsigned int warmupFrames = 5u;
+
+  std::vector<ScalingResult> results;
+  for (unsigned int size : _sizes)
+  {
+    ScalingResult result;
+    result.visuals = _axis == "visuals" ? size :
+        (fullSweep() ? 1000u : 100u);
+    result.lights = _axis == "lights" ? size : 1u;
+    result.sensors = _axis == "sensors" ? size : 1u;
+
+    double residentStart = residentMemory();
+    ScenePtr scene = engine->CreateScene("scene");
+    ASSERT_NE(nullptr, scene);
+    scene->SetAmbientLight(0.3, 0.3, 0.3);
+    addVisuals(scene, result.visuals);
+    addLights(scene, result.lights);
+
+    // cameras looking at the boxes, read back every frame
+    std::vector<CameraPtr> cameras;
+    std::vector<common::ConnectionPtr> connections;
+    for (unsigned int i = 0; i < result.sensors; ++i)
+    {
+      CameraPtr camera = scene->CreateCamera();
+      ASSERT_NE(nullptr, camera);
+      camera->SetImageWidth(320u);
+      camera->SetImageHeight(240u);
+      camera->SetNearClipPlane(0.1);
+      camera->SetFarClipPlane(100.0);
+      camera->SetLocalPosition(0.0, 0.0, -1.0 + (i % 8) * 0.25);
+      scene->RootVisual()->AddChild(camera);
+      connections.push_back(camera->ConnectNewImageFrame(
+          [](const unsigned char *, unsigned int, unsigned int,
+          unsigned int, const std::string &) {}));
+      cameras.push_back(camera);
+    }
+
+    using Clock = std::chrono::steady_clock;
+    auto ms = [](Clock::time_point _start, Clock::time_point _end)
+    {
+      return std::chrono::duration<double, std::milli>(_end - _start)
+          .count();
+    };
+    auto renderFrame = [&](bool _timed)
+    {
+      auto t0 = Clock::now();
+      scene->PreRender();
+      auto t1 = Clock::now();
+      for (auto &camera : cameras)
+        camera->Render();
+      auto t2 = Clock::now();
+      for (auto &camera : cameras)
+        camera->PostRender();
+      auto t3 = Clock::now();
+      scene->PostRender();
+      auto t4 = Clock::now();
+      if (_timed)
+      {
+        result.preRenderMs += ms(t0, t1);
+        result.renderMs += ms(t1, t2);
+        result.postRenderMs += ms(t2, t3);
+        result.scenePostRenderMs += ms(t3, t4);
+        result.frameMs += ms(t0, t4);
+      }
+    };
+
+    for (unsigned int i = 0; i < warmupFrames; ++i)
+      renderFrame(false);
+    for (unsigned int i = 0; i < frames; ++i)
+      renderFrame(true);
+
+    result.preRenderMs /= frames;
+    result.renderMs /= frames;
+    result.postRenderMs /= frames;
+    result.scenePostRenderMs /= frames;
+    result.frameMs /= frames;
+    result.gpuMs = scene->GpuStats().averageMs;
+    result.residentMb = residentMemory() - residentStart;
+    for (auto &camera : cameras)
+    {
+      auto drawStats = camera->DrawStats();
+      result.drawCalls += drawStats.drawCallCount;
+      result.triangles += drawStats.triangleCount;
+    }
+    writeResult(_renderEngine, _axis, result);
+    results.push_back(result);
+    EXPECT_GT(result.frameMs, 0.0);
+
+    connections.clear();
+    cameras.clear();
+    engine->DestroyScene(scene);
+  }
+
+  printCurve(_renderEngine, _axis, results);
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneScalingTest, Visuals)
+{
+  Scale(GetParam(), "visuals", envValues("IGN_RENDERING_STRESS_VISUALS",
+      fullSweep() ? std::vector<unsigned int>{100u, 1000u, 10000u, 100000u} :
+      std::vector<unsigned int>{10u, 100u}));
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneScalingTest, Lights)
+{
+  Scale(GetParam(), "lights", envValues("IGN_RENDERING_STRESS_LIGHTS",
+      fullSweep() ? std::vector<unsigned int>{1u, 10u, 100u, 1000u} :
+      std::vector<unsigned int>{1u, 4u}));
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneScalingTest, Sensors)
+{
+  Scale(GetParam(), "sensors", envValues("IGN_RENDERING_STRESS_SENSORS",
+      fullSweep() ? std::vector<unsigned int>{1u, 4u, 16u, 64u} :
+      std::vector<unsigned int>{1u, 2u}));
+}
+
+INSTANTIATE_TEST_CASE_P(SceneScaling, SceneScalingTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
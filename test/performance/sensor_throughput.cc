@@ -0,0 +1,440 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/StringUtils.hh>
+#include <ignition/common/Util.hh>
+#include <ignition/math/Helpers.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/rendering/Camera.hh"
+#include "ignition/rendering/DepthCamera.hh"
+#include "ignition/rendering/GpuRays.hh"
+#include "ignition/rendering/Image.hh"
+#include "ignition/rendering/RenderEngine.hh"
+#include "ignition/rendering/RenderingIface.hh"
+#include "ignition/rendering/Scene.hh"
+#include "ignition/rendering/SegmentationCamera.hh"
+#include "ignition/rendering/ThermalCamera.hh"
+
+using namespace ignition;
+using namespace rendering;
+
+/// \brief Measure frame rate and latency of the sensors for different
+/// resolutions, sensor counts and scene sizes.
+///
+/// Results are appended as one JSON object per line to the file given by
+/// the IGN_RENDERING_BENCHMARK_OUTPUT environment variable, or to
+/// test/sensor_throughput.jsonl in the build directory. They are also
+/// recorded as properties of each test in the gtest XML output.
+///
+/// By default only a small scene of 100 visuals is measured with one and
+/// two sensors at 320x240, so the test stays quick when run with the other
+/// tests. Setting the IGN_RENDERING_BENCHMARK_FULL environment variable to
+/// 1 measures scenes of up to 100000 visuals, 4 sensors and 1280x720.
+///
+/// The IGN_RENDERING_BENCHMARK_VISUALS and IGN_RENDERING_BENCHMARK_FRAMES
+/// environment variables override the comma separated list of scene sizes
+/// and the number of timed frames.
+class SensorThroughputTest: public testing::Test,
+                            public testing::WithParamInterface<const char *>
+{
+  // Documentation inherited
+  public: void SetUp() override
+  {
+    ignition::common::Console::SetVerbosity(3);
+  }
+
+  /// \brief Benchmark one sensor type on an engine
+  /// \param[in] _renderEngine Render engine name
+  /// \param[in] _sensorType One of camera, depth, thermal, segmentation
+  /// or gpu_rays
+  public: void Benchmark(const std::string &_renderEngine,
+      const std::string &_sensorType);
+};
+
+/// \brief Result of a single benchmark configuration
+struct BenchmarkResult
+{
+  std::string engine;
+  std::string sensor;
+  unsigned int width = 0u;
+  unsigned int height = 0u;
+  unsigned int sensors = 0u;
+  unsigned int visuals = 0u;
+  unsigned int frames = 0u;
+  double meanMs = 0.0;
+  double p95Ms = 0.0;
+  double fps = 0.0;
+};
+
+/////////////////////////////////////////////////
+/// \brief Get a list of unsigned values from an environment variable
+std::vector<unsigned int> envValues(const std::string &_name,
+    const std::vector<unsigned int> &_default)
+{
+  std::string str;
+  if (!common::env(_name, str) || str.empty())
+    return _default;
+
+  std::vector<unsigned int> values;
+  for (const auto &token : common::split(str, ","))
+    values.push_back(static_cast<unsigned int>(std::stoul(token)));
+  return values.empty() ? _default : values;
+}
+
+/////////////////////////////////////////////////
+/// \brief Append a result to the machine readable output
+void writeResult(const BenchmarkResult &_result)
+{
+  std::string path;
+  if (!common::env("IGN_RENDERING_BENCHMARK_OUTPUT", path) || path.empty())
+  {
+    path = common::joinPaths(std::string(PROJECT_BUILD_PATH), "test",
+        "sensor_throughput.jsonl");
+  }
+
+  std::stringstream json;
+  json << "{\"engine\": \"" << _result.engine << "\""
+       << ", \"sensor\": \"" << _result.sensor << "\""
+       << ", \"width\": " << _result.width
+       << ", \"height\": " << _result.height
+       << ", \"sensors\": " << _result.sensors
+       << ", \"visuals\": " << _result.visuals
+       << ", \"frames\": " << _result.frames
+       << ", \"mean_ms\": " << _result.meanMs
+       << ", \"p95_ms\": " << _result.p95Ms
+       << ", \"fps\": " << _result.fps << "}";
+
+  std::ofstream out(path, std::ios::app);
+  out << json.str() << std::endl;
+  ignmsg << json.str() << std::endl;
+
+  std::stringstream key;
+  key << _result.sensor << "_" << _result.width << "x" << _result.height
+      << "_" << _result.sensors << "_" << _result.visuals;
+  testing::Test::RecordProperty(key.str() + "_mean_ms",
+      std::to_string(_result.meanMs));
+  testing::Test::RecordProperty(key.str() + "_fps",
+      std::to_string(_result.fps));
+}
+
+/////////////////////////////////////////////////
+/// \brief Fill the scene with boxes in front of the sensors
+void populateScene(ScenePtr _scene, unsigned int _count)
+{
+  VisualPtr root = _scene->RootVisual();
+  MaterialPtr material = _scene->CreateMaterial();
+  material->SetDiffuse(0.7, 0.7, 0.7);
+
+  VisualPtr parent = _scene->CreateVisual();
+  root->AddChild(parent);
+
+  // square grid of boxes facing the sensors, 3 m in front of them
+  unsigned int side = static_cast<unsigned int>(
+      std::ceil(std::sqrt(static_cast<double>(_count))));
+  double spacing = 10.0 / side;
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    VisualPtr box = _scene->CreateVisual();
+    box->AddGeometry(_scene->CreateBox());
+    box->SetLocalScale(spacing * 0.8);
+    box->SetLocalPosition(3.0 + (i % 3) * spacing,
+        (static_cast<double>(i % side) - side / 2.0) * spacing,
+        (static_cast<double>(i / side) - side / 2.0) * spacing);
+    box->SetMaterial(material);
+    box->SetUserData("label", static_cast<int>(i % 255));
+    box->SetUserData("temperature", 300.0f + (i % 50));
+    parent->AddChild(box);
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Create a sensor of the given type and subscribe to its output so
+/// that its data is read back every frame
+CameraPtr createSensor(ScenePtr _scene, const std::string &_type,
+    unsigned int _width, unsigned int _height,
+    std::vector<common::ConnectionPtr> &_connections)
+{
+  CameraPtr sensor;
+  if (_type == "camera")
+  {
+    sensor = _scene->CreateCamera();
+  }
+  else if (_type == "depth")
+  {
+    DepthCameraPtr depth = _scene->CreateDepthCamera();
+    if (depth)
+    {
+      depth->SetImageWidth(_width);
+      depth->SetImageHeight(_height);
+      depth->CreateDepthTexture();
+      _connections.push_back(depth->ConnectNewDepthFrame(
+          [](const float *, unsigned int, unsigned int, unsigned int,
+          const std::string &) {}));
+    }
+    sensor = depth;
+  }
+  else if (_type == "thermal")
+  {
+    ThermalCameraPtr thermal = _scene->CreateThermalCamera();
+    if (thermal)
+    {
+      thermal->SetImageWidth(_width);
+      thermal->SetImageHeight(_height);
+      thermal->SetAmbientTemperature(296.0f);
+      thermal->CreateThermalTexture();
+      _connections.push_back(thermal->ConnectNewThermalFrame(
+          [](const uint16_t *, unsigned int, unsigned int, unsigned int,
+          const std::string &) {}));
+    }
+    sensor = thermal;
+  }
+  else if (_type == "segmentation")
+  {
+    SegmentationCameraPtr segmentation = _scene->CreateSegmentationCamera();
+    if (segmentation)
+    {
+      segmentation->SetImageWidth(_width);
+      segmentation->SetImageHeight(_height);
+      segmentation->CreateSegmentationTexture();
+      _connections.push_back(segmentation->ConnectNewSegmentationFrame(
+          [](const uint8_t *, unsigned int, unsigned int, unsigned int,
+          const std::string &) {}));
+    }
+    sensor = segmentation;
+  }
+  else if (_type == "gpu_rays")
+  {
+    GpuRaysPtr rays = _scene->CreateGpuRays();
+    if (rays)
+    {
+      // width x height beams over a typical 3D lidar field of view
+      rays->SetAngleMin(-IGN_PI);
+      rays->SetAngleMax(IGN_PI);
+      rays->SetRayCount(_width);
+      rays->SetVerticalAngleMin(-0.26);
+      rays->SetVerticalAngleMax(0.26);
+      rays->SetVerticalRayCount(_height);
+      rays->CreateRenderTexture();
+      _connections.push_back(rays->ConnectNewGpuRaysFrame(
+          [](const float *, unsigned int, unsigned int, unsigned int,
+          const std::string &) {}));
+    }
+    sensor = rays;
+  }
+
+  if (!sensor)
+    return sensor;
+
+  if (_type == "camera")
+  {
+    sensor->SetImageWidth(_width);
+    sensor->SetImageHeight(_height);
+  }
+  sensor->SetNearClipPlane(0.1);
+  sensor->SetFarClipPlane(100.0);
+  sensor->SetLocalPosition(0.0, 0.0, 0.0);
+  _scene->RootVisual()->AddChild(sensor);
+  return sensor;
+}
+
+/////////////////////////////////////////////////
+void SensorThroughputTest::Benchmark(const std::string &_renderEngine,
+    const std::string &_sensorType)
+{
+  if (_renderEngine != "ogre" && _renderEngine != "ogre2")
+  {
+    igndbg << "Sensor benchmarks are only run for ogre and ogre2, skipping "
+           << _renderEngine << std::endl;
+    return;
+  }
+
+  RenderEngine *engine = rendering::engine(_renderEngine);
+  if (!engine)
+  {
+    igndbg << "Engine '" << _renderEngine
+              << "' is not supported" << std::endl;
+    return;
+  }
+
+  std::string fullStr;
+  const bool full = common::env("IGN_RENDERING_BENCHMARK_FULL", fullStr) &&
+      fullStr == "1";
+  const std::vector<unsigned int> visualCounts =
+      envValues("IGN_RENDERING_BENCHMARK_VISUALS",
+      full ? std::vector<unsigned int>{1000u, 10000u, 100000u} :
+      std::vector<unsigned int>{100u});
+  const unsigned int frames =
+      envValues("IGN_RENDERING_BENCHMARK_FRAMES", {full ? 30u : 10u}).front();
+  const unsigned int warmupFrames = 5u;
+  std::vector<std::pair<unsigned int, unsigned int>> resolutions =
+      {{320u, 240u}};
+  if (full)
+    resolutions.emplace_back(1280u, 720u);
+  const std::vector<unsigned int> sensorCounts =
+      full ? std::vector<unsigned int>{1u, 4u} :
+      std::vector<unsigned int>{1u, 2u};
+
+  for (unsigned int visuals : visualCounts)
+  {
+    ScenePtr scene = engine->CreateScene("scene");
+    ASSERT_NE(nullptr, scene);
+    scene->SetAmbientLight(0.3, 0.3, 0.3);
+    DirectionalLightPtr light = scene->CreateDirectionalLight();
+    light->SetDirection(0.5, 0.5, -1.0);
+    scene->RootVisual()->AddChild(light);
+    populateScene(scene, visuals);
+
+    for (const auto &resolution : resolutions)
+    {
+      for (unsigned int count : sensorCounts)
+      {
+        std::vector<common::ConnectionPtr> connections;
+        std::vector<CameraPtr> sensors;
+        for (unsigned int i = 0; i < count; ++i)
+        {
+          CameraPtr sensor = createSensor(scene, _sensorType,
+              resolution.first, resolution.second, connections);
+          if (!sensor)
+            break;
+          sensors.push_back(sensor);
+        }
+
+        if (sensors.size() != count)
+        {
+          igndbg << "Sensor type '" << _sensorType
+                 << "' is not supported by " << _renderEngine << std::endl;
+          for (auto &sensor : sensors)
+            scene->DestroySensor(sensor);
+          engine->DestroyScene(scene);
+          rendering::unloadEngine(engine->Name());
+          return;
+        }
+
+        // plain cameras only read back when asked to
+        std::vector<Image> images;
+        if (_sensorType == "camera")
+        {
+          for (auto &sensor : sensors)
+            images.push_back(sensor->CreateImage());
+        }
+
+        auto renderFrame = [&]()
+        {
+          for (unsigned int i = 0; i < sensors.size(); ++i)
+          {
+            sensors[i]->Update();
+            if (!images.empty())
+              sensors[i]->Copy(images[i]);
+          }
+        };
+
+        for (unsigned int i = 0; i < warmupFrames; ++i)
+          renderFrame();
+
+        std::vector<double> latencies;
+        for (unsigned int i = 0; i < frames; ++i)
+        {
+          auto start = std::chrono::steady_clock::now();
+          renderFrame();
+          std::chrono::duration<double, std::milli> elapsed =
+              std::chrono::steady_clock::now() - start;
+          latencies.push_back(elapsed.count());
+        }
+
+        BenchmarkResult result;
+        result.engine = _renderEngine;
+        result.sensor = _sensorType;
+        result.width = resolution.first;
+        result.height = resolution.second;
+        result.sensors = count;
+        result.visuals = visuals;
+        result.frames = frames;
+        for (double latency : latencies)
+          result.meanMs += latency;
+        result.meanMs /= latencies.size();
+        std::sort(latencies.begin(), latencies.end());
+        result.p95Ms = latencies[std::min(latencies.size() - 1,
+            static_cast<size_t>(latencies.size() * 0.95))];
+        result.fps = result.meanMs > 0.0 ? 1000.0 / result.meanMs : 0.0;
+        writeResult(result);
+        EXPECT_GT(result.fps, 0.0);
+
+        connections.clear();
+        for (auto &sensor : sensors)
+          scene->DestroySensor(sensor);
+      }
+    }
+
+    engine->DestroyScene(scene);
+  }
+
+  rendering::unloadEngine(engine->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SensorThroughputTest, Camera)
+{
+  Benchmark(GetParam(), "camera");
+}
+
+/////////////////////////////////////////////////
+TEST_P(SensorThroughputTest, DepthCamera)
+{
+  Benchmark(GetParam(), "depth");
+}
+
+/////////////////////////////////////////////////
+TEST_P(SensorThroughputTest, ThermalCamera)
+{
+  Benchmark(GetParam(), "thermal");
+}
+
+/////////////////////////////////////////////////
+TEST_P(SensorThroughputTest, SegmentationCamera)
+{
+  Benchmark(GetParam(), "segmentation");
+}
+
+/////////////////////////////////////////////////
+TEST_P(SensorThroughputTest, GpuRays)
+{
+  Benchmark(GetParam(), "gpu_rays");
+}
+
+INSTANTIATE_TEST_CASE_P(SensorThroughput, SensorThroughputTest,
+    RENDER_ENGINE_VALUES,
+    ignition::rendering::PrintToStringParam());
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}